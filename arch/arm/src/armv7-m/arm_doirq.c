@@ -35,6 +35,7 @@
 
 #include "arm_internal.h"
 #include "exc_return.h"
+#include "mpu.h"
 
 /****************************************************************************
  * Public Functions
@@ -72,6 +73,17 @@ uint32_t *arm_doirq(int irq, uint32_t *regs)
 
       if (regs != CURRENT_REGS)
         {
+#ifdef CONFIG_ARCH_LAZYFPU
+          /* The outgoing thread had its FP registers saved only if it has
+           * used the FPU, i.e. if it was interrupted with an extended frame.
+           */
+
+          if ((regs[REG_EXC_RETURN] & EXC_RETURN_STD_CONTEXT) == 0)
+            {
+              g_running_tasks[this_cpu()]->fpu_saves++;
+            }
+#endif
+
           /* Record the new "running" task when context switch occurred.
            * g_running_tasks[] is only used by assertion logic for reporting
            * crashes.
@@ -79,6 +91,11 @@ uint32_t *arm_doirq(int irq, uint32_t *regs)
 
           g_running_tasks[this_cpu()] = this_task();
 
+#ifdef CONFIG_ARMV7M_STACKGUARD
+          mpu_stackguard((uintptr_t)this_task()->stack_base_ptr,
+                         this_task()->adj_stack_size);
+#endif
+
           restore_critical_section();
           regs = (uint32_t *)CURRENT_REGS;
         }
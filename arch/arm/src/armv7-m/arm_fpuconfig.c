@@ -58,6 +58,26 @@ void arm_fpuconfig(void)
 {
   uint32_t regval;
 
+#ifdef CONFIG_ARCH_LAZYFPU
+  /* Leave CONTROL.FPCA clear and let the hardware set it (FPCCR.ASPEN)
+   * on the first FP instruction of each context.  Exceptions taken from
+   * threads that never touched the FPU then stack the basic frame only,
+   * and the S16-S31 save in exception_common is skipped for them.
+   *
+   * FPCCR.LSPEN makes the hardware only reserve room for S0-S15/FPSCR
+   * when an FP context is interrupted.  The registers are stored only if
+   * the handler itself executes an FP instruction, which is the case when
+   * exception_common saves S16-S31 for such a context.
+   */
+
+  regval = getcontrol();
+  regval &= ~CONTROL_FPCA;
+  setcontrol(regval);
+
+  regval = getreg32(NVIC_FPCCR);
+  regval |= NVIC_FPCCR_ASPEN | NVIC_FPCCR_LSPEN;
+  putreg32(regval, NVIC_FPCCR);
+#else
   /* Set CONTROL.FPCA so that we always get the extended context frame
    * with the volatile FP registers stacked above the basic context.
    */
@@ -74,6 +94,7 @@ void arm_fpuconfig(void)
   regval = getreg32(NVIC_FPCCR);
   regval &= ~(NVIC_FPCCR_ASPEN | NVIC_FPCCR_LSPEN);
   putreg32(regval, NVIC_FPCCR);
+#endif
 
   /* Enable full access to CP10 and CP11 */
 
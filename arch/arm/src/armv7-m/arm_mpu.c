@@ -40,6 +40,18 @@
 #  define CONFIG_ARM_MPU_NREGIONS 8
 #endif
 
+/* The stack guard is read-only normal memory, write-back cached like the
+ * default memory map of the SRAM.
+ */
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+#  define STACKGUARD_RASR \
+     (MPU_RASR_ENABLE | \
+      MPU_RASR_SIZE_LOG2(__builtin_ctz(CONFIG_ARMV7M_STACKGUARD_SIZE)) | \
+      MPU_RASR_TEX_NOR | MPU_RASR_C | MPU_RASR_B | MPU_RASR_AP_RORO | \
+      MPU_RASR_XN)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -223,7 +235,7 @@ static void mpu_reset_internal()
 
 unsigned int mpu_allocregion(void)
 {
-  DEBUGASSERT(g_region < CONFIG_ARM_MPU_NREGIONS);
+  DEBUGASSERT(g_region < MPU_NREGIONS);
   return (unsigned int)g_region++;
 }
 
@@ -444,3 +456,42 @@ void mpu_early_reset()
   mpu_reset_internal();
 }
 #endif
+
+/****************************************************************************
+ * Name: mpu_stackguard
+ *
+ * Description:
+ *   Make the lowest CONFIG_ARMV7M_STACKGUARD_SIZE bytes of the stack that
+ *   is about to run read-only.  The guard starts at the first suitably
+ *   aligned address of the stack; a stack too small to spare it runs
+ *   unguarded.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+void mpu_stackguard(uintptr_t stackbase, size_t stacksize)
+{
+  uintptr_t base;
+
+  /* The MPU may not have been enabled by the chip logic */
+
+  if ((getreg32(MPU_CTRL) & MPU_CTRL_ENABLE) == 0)
+    {
+      mpu_control(true, false, true);
+    }
+
+  base = (stackbase + CONFIG_ARMV7M_STACKGUARD_SIZE - 1) &
+         ~(CONFIG_ARMV7M_STACKGUARD_SIZE - 1);
+
+  putreg32(MPU_STACKGUARD_REGION, MPU_RNR);
+
+  if (base + 2 * CONFIG_ARMV7M_STACKGUARD_SIZE > stackbase + stacksize)
+    {
+      putreg32(0, MPU_RASR);
+      return;
+    }
+
+  putreg32(base | MPU_STACKGUARD_REGION | MPU_RBAR_VALID, MPU_RBAR);
+  putreg32(STACKGUARD_RASR, MPU_RASR);
+}
+#endif
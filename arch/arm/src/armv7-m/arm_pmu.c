@@ -0,0 +1,75 @@
+/****************************************************************************
+ * arch/arm/src/armv7-m/arm_pmu.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/perfcount.h>
+
+#include "arm_internal.h"
+#include "dwt.h"
+#include "itm.h"
+#include "nvic.h"
+
+#ifdef CONFIG_SCHED_PERFCOUNT
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_pmu_start
+ *
+ * Description:
+ *   Start the DWT cycle counter.  The other DWT profiling counters are only
+ *   8 bits wide and the DWT has no instruction, cache or branch events, so
+ *   only the cycles are counted.
+ *
+ ****************************************************************************/
+
+uint32_t up_pmu_start(void)
+{
+  modifyreg32(NVIC_DEMCR, 0, NVIC_DEMCR_TRCENA);
+
+  putreg32(0xc5acce55, ITM_LAR);
+  modifyreg32(DWT_CTRL, 0, DWT_CTRL_CYCCNTENA_MASK);
+
+  return 1 << PERFCOUNT_CYCLES;
+}
+
+/****************************************************************************
+ * Name: up_pmu_read
+ *
+ * Description:
+ *   Read the DWT cycle counter.
+ *
+ ****************************************************************************/
+
+void up_pmu_read(FAR uint32_t *counts)
+{
+  counts[PERFCOUNT_CYCLES] = getreg32(DWT_CYCCNT);
+}
+#endif
@@ -77,7 +77,11 @@
 
 #define EXC_RETURN_HANDLER       0xfffffff1
 
-#ifdef CONFIG_ARCH_FPU
+/* With lazy FPU, threads start with the basic frame and the hardware
+ * switches them to the extended frame upon their first FP instruction.
+ */
+
+#if defined(CONFIG_ARCH_FPU) && !defined(CONFIG_ARCH_LAZYFPU)
 #  define EXC_RETURN_FPU         0
 #else
 #  define EXC_RETURN_FPU         EXC_RETURN_STD_CONTEXT
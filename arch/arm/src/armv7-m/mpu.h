@@ -130,6 +130,17 @@
 #    define MPU_RASR_AP_RORO    (6 << MPU_RASR_AP_SHIFT)  /* P:RO   U:RO   */
 #  define MPU_RASR_XN           (1 << 28)                 /* Bit 28: Instruction access disable */
 
+/* The stack guard takes the highest numbered region, which has priority
+ * over all others where they overlap.
+ */
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+#  define MPU_STACKGUARD_REGION (CONFIG_ARM_MPU_NREGIONS - 1)
+#  define MPU_NREGIONS          (CONFIG_ARM_MPU_NREGIONS - 1)
+#else
+#  define MPU_NREGIONS          CONFIG_ARM_MPU_NREGIONS
+#endif
+
 /****************************************************************************
  * Name: mpu_reset
  *
@@ -249,6 +260,21 @@ void mpu_control(bool enable, bool hfnmiena, bool privdefena);
 void mpu_configure_region(uintptr_t base, size_t size,
                                         uint32_t flags);
 
+/****************************************************************************
+ * Name: mpu_stackguard
+ *
+ * Description:
+ *   Make the lowest CONFIG_ARMV7M_STACKGUARD_SIZE bytes of the stack that
+ *   is about to run read-only, so that a stack overflow raises a
+ *   MemManage fault instead of corrupting the memory below the stack.
+ *   Called on each context switch.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARMV7M_STACKGUARD
+void mpu_stackguard(uintptr_t stackbase, size_t stacksize);
+#endif
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
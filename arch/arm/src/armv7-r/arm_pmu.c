@@ -0,0 +1,120 @@
+/****************************************************************************
+ * arch/arm/src/armv7-r/arm_pmu.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/perfcount.h>
+
+#include "sctlr.h"
+
+#ifdef CONFIG_SCHED_PERFCOUNT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Event counter n counts PERFCOUNT_INSTRUCTIONS + n, PMCCNTR the cycles */
+
+#define PMU_NEVENTS (PERFCOUNT_NEVENTS - PERFCOUNT_INSTRUCTIONS)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint8_t g_pmu_events[PMU_NEVENTS] =
+{
+  PMETSR_INSTARCHEXEC,              /* PERFCOUNT_INSTRUCTIONS */
+  PMETSR_L1_DC_FILL,                /* PERFCOUNT_CACHE_MISSES */
+  PMETSR_MISPREDICTEDBRANCHEXEC     /* PERFCOUNT_BRANCH_MISSES */
+};
+
+/* The number of event counters used, the same on all CPUs */
+
+static unsigned int g_pmu_ncounters;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_pmu_start
+ *
+ * Description:
+ *   Program the event counters of this CPU and start them together with
+ *   the cycle counter.
+ *
+ ****************************************************************************/
+
+uint32_t up_pmu_start(void)
+{
+  unsigned int ncounters;
+  unsigned int enable = PMCESR_CCES;
+  uint32_t valid = 1 << PERFCOUNT_CYCLES;
+  unsigned int i;
+
+  ncounters = (cp15_pmu_rdpmcr() & PMCR_N_MASK) >> PMCR_N_SHIFT;
+  if (ncounters > PMU_NEVENTS)
+    {
+      ncounters = PMU_NEVENTS;
+    }
+
+  for (i = 0; i < ncounters; i++)
+    {
+      cp15_pmu_wrecsr(i);
+      cp15_pmu_wretsr(g_pmu_events[i]);
+      enable |= 1 << i;
+      valid  |= 1 << (PERFCOUNT_INSTRUCTIONS + i);
+    }
+
+  g_pmu_ncounters = ncounters;
+
+  cp15_pmu_pmcr(PMCR_E);
+  cp15_pmu_cesr(enable);
+  return valid;
+}
+
+/****************************************************************************
+ * Name: up_pmu_read
+ *
+ * Description:
+ *   Read the counters of this CPU.
+ *
+ ****************************************************************************/
+
+void up_pmu_read(FAR uint32_t *counts)
+{
+  unsigned int i;
+
+  counts[PERFCOUNT_CYCLES] = cp15_pmu_rdccr();
+
+  for (i = 0; i < g_pmu_ncounters; i++)
+    {
+      cp15_pmu_wrecsr(i);
+      counts[PERFCOUNT_INSTRUCTIONS + i] = cp15_pmu_rdecr();
+    }
+}
+#endif
@@ -121,6 +121,17 @@ uint32_t *arm_doirq(int irq, uint32_t *regs)
 
       if (regs != CURRENT_REGS)
         {
+#ifdef CONFIG_ARCH_LAZYFPU
+          /* The outgoing thread had its FP registers saved only if it has
+           * used the FPU, i.e. if it was interrupted with an extended frame.
+           */
+
+          if ((regs[REG_EXC_RETURN] & EXC_RETURN_STD_CONTEXT) == 0)
+            {
+              g_running_tasks[this_cpu()]->fpu_saves++;
+            }
+#endif
+
           /* Record the new "running" task when context switch occurred.
            * g_running_tasks[] is only used by assertion logic for reporting
            * crashes.
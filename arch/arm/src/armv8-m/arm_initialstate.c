@@ -104,9 +104,12 @@ void up_initial_state(struct tcb_s *tcb)
 #endif
 
 #ifdef CONFIG_ARMV8M_STACKCHECK_HARDWARE
-  /* Save the stack limit value, will be used in context switch. */
+  /* Save the stack limit value, will be used in context switch.  The
+   * limit is above the TLS data at the bottom of the stack, so that an
+   * overflow faults before it can corrupt them.
+   */
 
-  xcp->regs[REG_SPLIM]   = (uint32_t)tcb->stack_alloc_ptr;
+  xcp->regs[REG_SPLIM]   = (uint32_t)tcb->stack_base_ptr;
 #endif
 
   /* Save the task entry point (stripping off the thumb bit) */
@@ -104,7 +104,11 @@
 #define EXC_RETURN_HANDLER       (EXC_RETURN_BASE | EXC_RETURN_DEF_STACKING | \
                                   EXC_RETURN_STD_CONTEXT)
 
-#ifdef CONFIG_ARCH_FPU
+/* With lazy FPU, threads start with the basic frame and the hardware
+ * switches them to the extended frame upon their first FP instruction.
+ */
+
+#if defined(CONFIG_ARCH_FPU) && !defined(CONFIG_ARCH_LAZYFPU)
 #  define EXC_RETURN_FPU         0
 #else
 #  define EXC_RETURN_FPU         EXC_RETURN_STD_CONTEXT
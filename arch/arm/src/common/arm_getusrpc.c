@@ -0,0 +1,68 @@
+/****************************************************************************
+ * arch/arm/src/common/arm_getusrpc.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <arch/irq.h>
+
+#include "arm_internal.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_getusrpc
+ *
+ * Description:
+ *   Return the program counter saved in a register context.
+ *
+ * Input Parameters:
+ *   regs - The register context, or NULL for the context interrupted by
+ *          the interrupt being handled on this CPU
+ *
+ * Returned Value:
+ *   The saved program counter; zero if 'regs' is NULL and the CPU is not
+ *   handling an interrupt.
+ *
+ ****************************************************************************/
+
+uintptr_t up_getusrpc(FAR void *regs)
+{
+  FAR volatile uint32_t *xcp = regs;
+
+  if (xcp == NULL)
+    {
+      xcp = CURRENT_REGS;
+      if (xcp == NULL)
+        {
+          return 0;
+        }
+    }
+
+  return xcp[REG_PC];
+}
@@ -34,9 +34,11 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/cache.h>
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/nx/nxaccel.h>
 #include <nuttx/video/fb.h>
 
 #include <arch/board/board.h>
@@ -226,6 +228,24 @@ static int stm32_dma2d_blend(struct stm32_dma2d_overlay_s *doverlay,
                              uint32_t forexpos, uint32_t foreypos,
                              struct stm32_dma2d_overlay_s *boverlay,
                              const struct fb_area_s *barea);
+#ifdef CONFIG_NX_ACCEL
+static int stm32_dma2d_accelfill(FAR const struct nxgl_accel_s *accel,
+                                 FAR struct fb_planeinfo_s *pinfo,
+                                 FAR const struct nxgl_rect_s *rect,
+                                 nxgl_mxpixel_t color);
+static int stm32_dma2d_accelcopy(FAR const struct nxgl_accel_s *accel,
+                                 FAR struct fb_planeinfo_s *pinfo,
+                                 FAR const struct nxgl_rect_s *dest,
+                                 FAR const void *src,
+                                 FAR const struct nxgl_point_s *origin,
+                                 unsigned int srcstride);
+static int stm32_dma2d_accelblend(FAR const struct nxgl_accel_s *accel,
+                                  FAR struct fb_planeinfo_s *pinfo,
+                                  FAR const struct nxgl_rect_s *dest,
+                                  FAR const void *src,
+                                  FAR const struct nxgl_point_s *origin,
+                                  unsigned int srcstride, uint8_t alpha);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -281,6 +301,17 @@ static struct stm32_dma2d_s g_dma2ddev =
   .lock = &g_lock
 };
 
+#ifdef CONFIG_NX_ACCEL
+/* The DMA2D as 2D accelerator of the NX framebuffer planes */
+
+static const struct nxgl_accel_s g_dma2daccel =
+{
+  .fillrectangle  = stm32_dma2d_accelfill,
+  .copyrectangle  = stm32_dma2d_accelcopy,
+  .blendrectangle = stm32_dma2d_accelblend
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -722,6 +753,266 @@ static void stm32_dma2d_lpfc(int lid, uint32_t blendmode, uint8_t alpha,
   putreg32(pfccrreg, stm32_pfccr_layer_t[lid]);
 }
 
+#ifdef CONFIG_NX_ACCEL
+/****************************************************************************
+ * Name: stm32_dma2d_acceloverlay
+ *
+ * Description:
+ *   Describe framebuffer memory as an overlay for the DMA2D operations.
+ *
+ * Input Parameters:
+ *   overlay - The overlay to initialize
+ *   oinfo   - The overlay information referenced by the overlay
+ *   mem     - Start of the memory
+ *   stride  - Length of a line in bytes
+ *   bpp     - Bits per pixel
+ *   yres    - Number of lines
+ *
+ * Returned Value:
+ *    OK      - On success
+ *   -ENOSYS  - The pixel format or the stride cannot be used by the DMA2D
+ *
+ ****************************************************************************/
+
+static int stm32_dma2d_acceloverlay(struct stm32_dma2d_overlay_s *overlay,
+                                    struct fb_overlayinfo_s *oinfo,
+                                    FAR void *mem, uint32_t stride,
+                                    uint8_t bpp, fb_coord_t yres)
+{
+  switch (bpp)
+    {
+      case 16:
+        overlay->fmt = DMA2D_PF_RGB565;
+        break;
+
+      case 24:
+        overlay->fmt = DMA2D_PF_RGB888;
+        break;
+
+      case 32:
+        overlay->fmt = DMA2D_PF_ARGB8888;
+        break;
+
+      default:
+        return -ENOSYS;
+    }
+
+  /* The line offset of the DMA2D is a whole number of pixels */
+
+  if (stride % DMA2D_PF_BYPP(bpp) != 0)
+    {
+      return -ENOSYS;
+    }
+
+  memset(oinfo, 0, sizeof(*oinfo));
+  oinfo->fbmem         = mem;
+  oinfo->stride        = stride;
+  oinfo->bpp           = bpp;
+
+  overlay->transp_mode = STM32_DMA2D_PFCCR_AM_NONE;
+  overlay->xres        = stride / DMA2D_PF_BYPP(bpp);
+  overlay->yres        = yres;
+  overlay->oinfo       = oinfo;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stm32_dma2d_accelarea
+ *
+ * Description:
+ *   Convert an NX rectangle to the area of the DMA2D operations.
+ *
+ ****************************************************************************/
+
+static void stm32_dma2d_accelarea(FAR const struct nxgl_rect_s *rect,
+                                  struct fb_area_s *area)
+{
+  area->x = rect->pt1.x;
+  area->y = rect->pt1.y;
+  area->w = rect->pt2.x - rect->pt1.x + 1;
+  area->h = rect->pt2.y - rect->pt1.y + 1;
+}
+
+/****************************************************************************
+ * Name: stm32_dma2d_accelcache
+ *
+ * Description:
+ *   Write back the data cache lines of an area before the DMA2D reads it.
+ *   The lines of an area that the DMA2D writes are invalidated as well, so
+ *   that the CPU reads the result afterwards.
+ *
+ ****************************************************************************/
+
+static void stm32_dma2d_accelcache(struct stm32_dma2d_overlay_s *overlay,
+                                   const struct fb_area_s *area,
+                                   bool output)
+{
+  uintptr_t start;
+  uintptr_t end;
+
+  start = stm32_dma2d_memaddress(overlay, area->x, area->y);
+  end   = stm32_dma2d_memaddress(overlay, area->x + area->w,
+                                 area->y + area->h - 1);
+
+  if (output)
+    {
+      up_flush_dcache(start, end);
+    }
+  else
+    {
+      up_clean_dcache(start, end);
+    }
+}
+
+/****************************************************************************
+ * Name: stm32_dma2d_accelfill
+ *
+ * Description:
+ *   nxgl_accel_s fillrectangle method, fill a rectangle of the plane with
+ *   a color in the pixel format of the plane.
+ *
+ ****************************************************************************/
+
+static int stm32_dma2d_accelfill(FAR const struct nxgl_accel_s *accel,
+                                 FAR struct fb_planeinfo_s *pinfo,
+                                 FAR const struct nxgl_rect_s *rect,
+                                 nxgl_mxpixel_t color)
+{
+  struct stm32_dma2d_overlay_s doverlay;
+  struct fb_overlayinfo_s dinfo;
+  struct fb_area_s area;
+  int ret;
+
+  ret = stm32_dma2d_acceloverlay(&doverlay, &dinfo, pinfo->fbmem,
+                                 pinfo->stride, pinfo->bpp,
+                                 pinfo->yres_virtual);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  stm32_dma2d_accelarea(rect, &area);
+  stm32_dma2d_accelcache(&doverlay, &area, true);
+
+  /* The output color register takes the pixel in the output format */
+
+  return stm32_dma2d_fillcolor(&doverlay, &area, color);
+}
+
+/****************************************************************************
+ * Name: stm32_dma2d_accelcopy
+ *
+ * Description:
+ *   nxgl_accel_s copyrectangle method, copy a part of an image in the
+ *   pixel format of the plane to a rectangle of the plane.
+ *
+ ****************************************************************************/
+
+static int stm32_dma2d_accelcopy(FAR const struct nxgl_accel_s *accel,
+                                 FAR struct fb_planeinfo_s *pinfo,
+                                 FAR const struct nxgl_rect_s *dest,
+                                 FAR const void *src,
+                                 FAR const struct nxgl_point_s *origin,
+                                 unsigned int srcstride)
+{
+  struct stm32_dma2d_overlay_s doverlay;
+  struct stm32_dma2d_overlay_s soverlay;
+  struct fb_overlayinfo_s dinfo;
+  struct fb_overlayinfo_s sinfo;
+  struct fb_area_s darea;
+  struct fb_area_s sarea;
+  int ret;
+
+  ret = stm32_dma2d_acceloverlay(&doverlay, &dinfo, pinfo->fbmem,
+                                 pinfo->stride, pinfo->bpp,
+                                 pinfo->yres_virtual);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  stm32_dma2d_accelarea(dest, &darea);
+
+  ret = stm32_dma2d_acceloverlay(&soverlay, &sinfo, (FAR void *)src,
+                                 srcstride, pinfo->bpp,
+                                 dest->pt2.y - origin->y + 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  sarea.x = dest->pt1.x - origin->x;
+  sarea.y = dest->pt1.y - origin->y;
+  sarea.w = darea.w;
+  sarea.h = darea.h;
+
+  stm32_dma2d_accelcache(&soverlay, &sarea, false);
+  stm32_dma2d_accelcache(&doverlay, &darea, true);
+
+  return stm32_dma2d_blit(&doverlay, darea.x, darea.y, &soverlay, &sarea);
+}
+
+/****************************************************************************
+ * Name: stm32_dma2d_accelblend
+ *
+ * Description:
+ *   nxgl_accel_s blendrectangle method, blend a part of an image in the
+ *   pixel format of the plane over a rectangle of the plane.  The image is
+ *   the foreground with the constant opacity alpha, the plane is the
+ *   background and the output.
+ *
+ ****************************************************************************/
+
+static int stm32_dma2d_accelblend(FAR const struct nxgl_accel_s *accel,
+                                  FAR struct fb_planeinfo_s *pinfo,
+                                  FAR const struct nxgl_rect_s *dest,
+                                  FAR const void *src,
+                                  FAR const struct nxgl_point_s *origin,
+                                  unsigned int srcstride, uint8_t alpha)
+{
+  struct stm32_dma2d_overlay_s doverlay;
+  struct stm32_dma2d_overlay_s foverlay;
+  struct fb_overlayinfo_s dinfo;
+  struct fb_overlayinfo_s finfo;
+  struct fb_area_s darea;
+  struct fb_area_s farea;
+  int ret;
+
+  ret = stm32_dma2d_acceloverlay(&doverlay, &dinfo, pinfo->fbmem,
+                                 pinfo->stride, pinfo->bpp,
+                                 pinfo->yres_virtual);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  stm32_dma2d_accelarea(dest, &darea);
+
+  ret = stm32_dma2d_acceloverlay(&foverlay, &finfo, (FAR void *)src,
+                                 srcstride, pinfo->bpp,
+                                 dest->pt2.y - origin->y + 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  foverlay.transp_mode = STM32_DMA2D_PFCCR_AM_CONST;
+  finfo.transp.transp  = alpha;
+
+  farea.x = dest->pt1.x - origin->x;
+  farea.y = dest->pt1.y - origin->y;
+  farea.w = darea.w;
+  farea.h = darea.h;
+
+  stm32_dma2d_accelcache(&foverlay, &farea, false);
+  stm32_dma2d_accelcache(&doverlay, &darea, true);
+
+  return stm32_dma2d_blend(&doverlay, darea.x, darea.y,
+                           &foverlay, farea.x, farea.y,
+                           &doverlay, &darea);
+}
+#endif /* CONFIG_NX_ACCEL */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1117,6 +1408,12 @@ int stm32_dma2dinitialize(void)
       up_enable_irq(g_interrupt.irq);
 
       g_initialized = true;
+
+#ifdef CONFIG_NX_ACCEL
+      /* Draw the fills and copies of NX with the DMA2D */
+
+      nxgl_accel_register(&g_dma2daccel);
+#endif
     }
 
   return OK;
@@ -1132,6 +1429,10 @@ int stm32_dma2dinitialize(void)
 
 void stm32_dma2duninitialize(void)
 {
+#ifdef CONFIG_NX_ACCEL
+  nxgl_accel_register(NULL);
+#endif
+
   /* Disable DMA2D interrupts */
 
   up_disable_irq(g_interrupt.irq);
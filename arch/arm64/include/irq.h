@@ -243,6 +243,14 @@ struct xcptcontext
 
   uint64_t *saved_reg;
 
+#ifdef CONFIG_SMP_CALL
+  /* Set while the signal context is to be set up by the CPU that runs the
+   * task (see up_schedule_sigaction()).
+   */
+
+  uint8_t sigremote;
+#endif
+
 #ifdef CONFIG_ARCH_FPU
   uint64_t *fpu_regs;
   uint64_t *saved_fpu_regs;
@@ -347,6 +355,23 @@ static inline void up_irq_restore(irqstate_t flags)
   __asm__ __volatile__("msr daif, %0" :: "r" (flags): "memory");
 }
 
+/* Return the TLS information of the running thread.  TPIDR_EL0 holds the
+ * address just past it and is readable from EL0, so no syscall or stack
+ * alignment is needed.
+ */
+
+static inline uintptr_t up_gettp(void)
+{
+  uintptr_t tp;
+
+  __asm__ __volatile__("mrs %0, tpidr_el0" : "=r" (tp));
+
+  return tp;
+}
+
+#define up_tls_info() \
+  ((FAR struct tls_info_s *)(up_gettp() - sizeof(struct tls_info_s)))
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
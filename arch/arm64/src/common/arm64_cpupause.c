@@ -345,3 +345,25 @@ int up_cpu_resume(int cpu)
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: up_send_smp_call
+ *
+ * Description:
+ *   Raise SGI3 on each CPU in 'cpuset'.  The SGI3 handler is
+ *   nxsched_smp_call_handler().
+ *
+ * Input Parameters:
+ *   cpuset - The set of CPUs to interrupt
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+void up_send_smp_call(cpu_set_t cpuset)
+{
+  arm64_gic_raise_sgi(GIC_IRQ_SGI3, (uint16_t)cpuset);
+}
+#endif
@@ -31,6 +31,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/sched_note.h>
+#include <nuttx/tls.h>
 #include <sched/sched.h>
 #include <nuttx/cache.h>
 #include <arch/spinlock.h>
@@ -131,7 +132,8 @@ static void arm64_smp_init_top(void *arg)
 
   write_sysreg(0, tpidrro_el0);
   write_sysreg(tcb, tpidr_el1);
-  write_sysreg(tcb, tpidr_el0);
+  write_sysreg((uint64_t)tcb->stack_alloc_ptr + sizeof(struct tls_info_s),
+               tpidr_el0);
 
   cpu_boot_params.cpu_ready_flag = 1;
   SP_SEV();
@@ -33,6 +33,7 @@
 
 #include <nuttx/sched.h>
 #include <nuttx/arch.h>
+#include <nuttx/tls.h>
 #include <arch/irq.h>
 #include "sched/sched.h"
 
@@ -236,7 +237,8 @@ pid_t arm64_fork(const struct fork_s *context)
   pforkctx->exe_depth       = 0;
   pforkctx->sp_elx          = (uint64_t)pforkctx;
   pforkctx->sp_el0          = (uint64_t)pforkctx;
-  pforkctx->tpidr_el0       = (uint64_t)(&child->cmn);
+  pforkctx->tpidr_el0       = (uint64_t)child->cmn.stack_alloc_ptr +
+                              sizeof(struct tls_info_s);
   pforkctx->tpidr_el1       = (uint64_t)(&child->cmn);
 
   child->cmn.xcp.regs = (uint64_t *)pforkctx;
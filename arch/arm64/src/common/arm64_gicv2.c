@@ -584,7 +584,7 @@
  * registers, not the priority set by the sending Cortex-A9 processor.
  *
  * NOTE: If CONFIG_SMP is enabled then SGI1 and SGI2 are used for inter-CPU
- * task management.
+ * task management and SGI3 for cross-CPU calls (CONFIG_SMP_CALL).
  */
 
 #define GIC_IRQ_SGI0              0 /* Software Generated Interrupt (SGI) 0 */
@@ -891,6 +891,9 @@ static void arm_gic0_initialize(void)
   /* Attach SGI interrupt handlers. This attaches the handler to all CPUs. */
 
   DEBUGVERIFY(irq_attach(GIC_IRQ_SGI2, arm64_pause_handler, NULL));
+#ifdef CONFIG_SMP_CALL
+  DEBUGVERIFY(irq_attach(GIC_IRQ_SGI3, nxsched_smp_call_handler, NULL));
+#endif
 #endif
 }
 
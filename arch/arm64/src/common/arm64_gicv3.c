@@ -560,6 +560,9 @@ static void gicv3_dist_init(void)
   /* Attach SGI interrupt handlers. This attaches the handler to all CPUs. */
 
   DEBUGVERIFY(irq_attach(GIC_IRQ_SGI2, arm64_pause_handler, NULL));
+#ifdef CONFIG_SMP_CALL
+  DEBUGVERIFY(irq_attach(GIC_IRQ_SGI3, nxsched_smp_call_handler, NULL));
+#endif
 #endif
 }
 
@@ -805,6 +808,9 @@ static void arm64_gic_init(void)
 
 #ifdef CONFIG_SMP
   up_enable_irq(GIC_IRQ_SGI2);
+#ifdef CONFIG_SMP_CALL
+  up_enable_irq(GIC_IRQ_SGI3);
+#endif
 #endif
 }
 
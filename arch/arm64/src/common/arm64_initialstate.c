@@ -28,6 +28,7 @@
 #include <arch/limits.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/tls.h>
 #include <nuttx/board.h>
 #include <nuttx/drivers/drivers.h>
 #include <nuttx/fs/loop.h>
@@ -85,7 +86,8 @@ void arm64_new_task(struct tcb_s * tcb)
   pinitctx->sp_elx    = (uint64_t)stack_ptr;
   pinitctx->sp_el0    = (uint64_t)pinitctx;
   pinitctx->exe_depth = 0;
-  pinitctx->tpidr_el0 = (uint64_t)tcb;
+  pinitctx->tpidr_el0 = (uint64_t)tcb->stack_alloc_ptr +
+                        sizeof(struct tls_info_s);
   pinitctx->tpidr_el1 = (uint64_t)tcb;
 
   tcb->xcp.regs       = (uint64_t *)pinitctx;
@@ -133,7 +135,8 @@ void up_initial_state(struct tcb_s *tcb)
 
       write_sysreg(0, tpidrro_el0);
       write_sysreg(tcb, tpidr_el1);
-      write_sysreg(tcb, tpidr_el0);
+      write_sysreg((uint64_t)tcb->stack_alloc_ptr +
+                   sizeof(struct tls_info_s), tpidr_el0);
 
 #ifdef CONFIG_STACK_COLORATION
 
@@ -260,7 +260,10 @@ void arm64_switchcontext(uint64_t **saveregs, uint64_t *restoreregs);
 
 /* Signal handling **********************************************************/
 
+struct regs_context;
+
 void arm64_sigdeliver(void);
+void arm64_init_signal_process(struct tcb_s *tcb, struct regs_context *regs);
 
 /* Power management *********************************************************/
 
@@ -0,0 +1,120 @@
+/****************************************************************************
+ * arch/arm64/src/common/arm64_pmu.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/perfcount.h>
+
+#include "arm64_pmu.h"
+
+#ifdef CONFIG_SCHED_PERFCOUNT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Event counter n counts PERFCOUNT_INSTRUCTIONS + n, PMCCNTR the cycles */
+
+#define PMU_NEVENTS (PERFCOUNT_NEVENTS - PERFCOUNT_INSTRUCTIONS)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint8_t g_pmu_events[PMU_NEVENTS] =
+{
+  PMU_EVENT_INST_RETIRED,           /* PERFCOUNT_INSTRUCTIONS */
+  PMU_EVENT_L1D_CACHE_REFILL,       /* PERFCOUNT_CACHE_MISSES */
+  PMU_EVENT_BR_MIS_PRED             /* PERFCOUNT_BRANCH_MISSES */
+};
+
+/* The number of event counters used, the same on all CPUs */
+
+static unsigned int g_pmu_ncounters;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_pmu_start
+ *
+ * Description:
+ *   Program the event counters of this CPU to count at EL0 and EL1 and
+ *   start them together with the cycle counter.
+ *
+ ****************************************************************************/
+
+uint32_t up_pmu_start(void)
+{
+  uint64_t ncounters;
+  uint64_t enable = PMCNTENSET_EL0_C;
+  uint32_t valid = 1 << PERFCOUNT_CYCLES;
+  unsigned int i;
+
+  ncounters = (read_sysreg(pmcr_el0) & PMCR_EL0_N_MASK) >> PMCR_EL0_N_SHIFT;
+  if (ncounters > PMU_NEVENTS)
+    {
+      ncounters = PMU_NEVENTS;
+    }
+
+  for (i = 0; i < ncounters; i++)
+    {
+      pmu_cntr_select(i);
+      write_sysreg(g_pmu_events[i], pmxevtyper_el0);
+      enable |= 1ul << i;
+      valid  |= 1 << (PERFCOUNT_INSTRUCTIONS + i);
+    }
+
+  g_pmu_ncounters = ncounters;
+
+  pmu_cntr_control_config(read_sysreg(pmcr_el0) | PMCR_EL0_E);
+  pmu_cntr_enable(enable);
+  return valid;
+}
+
+/****************************************************************************
+ * Name: up_pmu_read
+ *
+ * Description:
+ *   Read the counters of this CPU.
+ *
+ ****************************************************************************/
+
+void up_pmu_read(FAR uint32_t *counts)
+{
+  unsigned int i;
+
+  counts[PERFCOUNT_CYCLES] = pmu_get_ccntr();
+
+  for (i = 0; i < g_pmu_ncounters; i++)
+    {
+      pmu_cntr_select(i);
+      counts[PERFCOUNT_INSTRUCTIONS + i] = read_sysreg(pmxevcntr_el0);
+    }
+}
+#endif
@@ -54,6 +54,8 @@
 
 /* PMCR_EL0 */
 
+#define PMCR_EL0_N_SHIFT         (11)         /* Number of event counters */
+#define PMCR_EL0_N_MASK          (0x1ful << PMCR_EL0_N_SHIFT)
 #define PMCR_EL0_LC              (1ul << 6)   /* Long cycle counter enable */
 #define PMCR_EL0_DP              (1ul << 5)   /* Disable cycle counter when event counting is prohibited */
 #define PMCR_EL0_X               (1ul << 4)   /* Enable export of events */
@@ -78,6 +80,12 @@
 
 #define PMSELR_EL0_SEL_C         (0x1ful << 0) /* When PMSELR_EL0.SEL is 0b11111, it selects the cycle counter */
 
+/* Common architectural and microarchitectural event numbers */
+
+#define PMU_EVENT_L1D_CACHE_REFILL (0x03)      /* Level 1 data cache refill */
+#define PMU_EVENT_INST_RETIRED     (0x08)      /* Instruction architecturally executed */
+#define PMU_EVENT_BR_MIS_PRED      (0x10)      /* Mispredicted or not predicted branch */
+
 /* PMUSERENR_EL0 */
 
 #define PMUSERENR_EL0_ER         (1ul << 3)    /* Event counter read trap control */
@@ -31,6 +31,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/tls.h>
 
 #include "sched/sched.h"
 #include "arm64_internal.h"
@@ -42,6 +43,126 @@
 #include "arm64_fpu.h"
 #endif
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+/* The per-CPU requests to set up signal contexts and the number of tasks
+ * whose signal context is still to be set up (xcp.sigremote).  The count
+ * is protected by the critical section.
+ */
+
+static struct smp_call_data_s g_sigcall[CONFIG_SMP_NCPUS];
+static int g_sigremote;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+static int arm64_sigremote_handler(void *arg);
+
+/****************************************************************************
+ * Name: arm64_sigremote_send
+ *
+ * Description:
+ *   Ask 'cpu' to set up the signal contexts of the tasks marked with
+ *   xcp.sigremote.  A request that is already queued covers all of them.
+ *
+ ****************************************************************************/
+
+static void arm64_sigremote_send(int cpu)
+{
+  cpu_set_t cpuset;
+
+  if (g_sigcall[cpu].func == NULL)
+    {
+      nxsched_smp_call_init(&g_sigcall[cpu], arm64_sigremote_handler, NULL);
+    }
+
+  CPU_ZERO(&cpuset);
+  CPU_SET(cpu, &cpuset);
+  nxsched_smp_call_async(cpuset, &g_sigcall[cpu]);
+}
+
+/****************************************************************************
+ * Name: arm64_sigremote_setup
+ *
+ * Description:
+ *   Set up the signal context of 'tcb' if that was left to this CPU.  If
+ *   the task is still running here, the interrupted context is modified.
+ *   If it is not running any more, its saved context is modified.  If it
+ *   has moved on to yet another CPU, the request is passed on.
+ *
+ ****************************************************************************/
+
+static void arm64_sigremote_setup(struct tcb_s *tcb, void *arg)
+{
+  if (!tcb->xcp.sigremote)
+    {
+      return;
+    }
+
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      if (tcb->cpu != this_cpu())
+        {
+          arm64_sigremote_send(tcb->cpu);
+          return;
+        }
+
+      tcb->xcp.saved_reg = (uint64_t *)CURRENT_REGS;
+#ifdef CONFIG_ARCH_FPU
+      tcb->xcp.saved_fpu_regs = tcb->xcp.fpu_regs;
+#endif
+      arm64_init_signal_process(tcb, (struct regs_context *)CURRENT_REGS);
+
+      /* trigger switch to signal process */
+
+      CURRENT_REGS = tcb->xcp.regs;
+    }
+  else
+    {
+#ifdef CONFIG_ARCH_FPU
+      tcb->xcp.saved_fpu_regs = tcb->xcp.fpu_regs;
+#endif
+      tcb->xcp.saved_reg = tcb->xcp.regs;
+      arm64_init_signal_process(tcb, NULL);
+    }
+
+  tcb->xcp.sigremote = 0;
+  g_sigremote--;
+}
+
+/****************************************************************************
+ * Name: arm64_sigremote_handler
+ *
+ * Description:
+ *   The cross-CPU call made by up_schedule_sigaction() in place of pausing
+ *   the CPU that runs the signaled task.  Usually that task is still
+ *   running here; all tasks are only searched if some marked task was not.
+ *
+ ****************************************************************************/
+
+static int arm64_sigremote_handler(void *arg)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  arm64_sigremote_setup(this_task(), NULL);
+  if (g_sigremote > 0)
+    {
+      nxsched_foreach(arm64_sigremote_setup, NULL);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+#endif /* CONFIG_SMP_CALL */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -78,7 +199,8 @@ void arm64_init_signal_process(struct tcb_s *tcb, struct regs_context *regs)
   psigctx->sp_elx    = (uint64_t)stack_ptr;
   psigctx->sp_el0    = (uint64_t)psigctx;
   psigctx->exe_depth = 1;
-  psigctx->tpidr_el0 = (uint64_t)tcb;
+  psigctx->tpidr_el0 = (uint64_t)tcb->stack_alloc_ptr +
+                       sizeof(struct tls_info_s);
   psigctx->tpidr_el1 = (uint64_t)tcb;
   tcb->xcp.regs      = (uint64_t *)psigctx;
 }
@@ -261,6 +383,15 @@ void up_schedule_sigaction(struct tcb_s *tcb, sig_deliver_t sigdeliver)
 
               if (cpu != me)
                 {
+#ifdef CONFIG_SMP_CALL
+                  /* Do not pause the other CPU.  Let it set up the signal
+                   * context from its cross-CPU call handler instead.
+                   */
+
+                  tcb->xcp.sigremote = 1;
+                  g_sigremote++;
+                  arm64_sigremote_send(cpu);
+#else
                   /* Pause the CPU */
 
                   up_cpu_pause(cpu);
@@ -285,6 +416,7 @@ void up_schedule_sigaction(struct tcb_s *tcb, sig_deliver_t sigdeliver)
 
                   tcb->xcp.saved_reg = tcb->xcp.regs;
                   arm64_init_signal_process(tcb, NULL);
+#endif
                 }
               else
                 {
@@ -317,12 +449,14 @@ void up_schedule_sigaction(struct tcb_s *tcb, sig_deliver_t sigdeliver)
                * because this CPU already took a critical section
                */
 
+#ifndef CONFIG_SMP_CALL
               /* RESUME the other CPU if it was PAUSED */
 
               if (cpu != me)
                 {
                   up_cpu_resume(cpu);
                 }
+#endif
             }
         }
 
@@ -88,6 +88,12 @@ struct arch_addrenv_s
 
   uintptr_t textvbase;
 
+  /* Size of the .text mapped from another address environment by
+   * up_addrenv_share_text().  Those pages are not freed with this one.
+   */
+
+  size_t    textshared;
+
   /* For convenience store the data base here */
 
   uintptr_t datavbase;
@@ -106,6 +112,49 @@ typedef struct arch_addrenv_s arch_addrenv_t;
 #endif /* __ASSEMBLY__ */
 #endif /* CONFIG_ARCH_ADDRENV */
 
+/****************************************************************************
+ * Inline functions
+ ****************************************************************************/
+
+#if defined(CONFIG_ARCH_HAVE_VDSO_COUNTER) && !defined(__ASSEMBLY__)
+
+/****************************************************************************
+ * Name: up_vdso_counter
+ *
+ * Description:
+ *   Read the time CSR.  The kernel enables it for U-mode through the
+ *   counter enable register, so this works from user space as well.
+ *
+ ****************************************************************************/
+
+static inline uint64_t up_vdso_counter(void)
+{
+#ifdef CONFIG_ARCH_RV64
+  uint64_t time;
+
+  __asm__ __volatile__("rdtime %0" : "=r" (time));
+  return time;
+#else
+  uint32_t hi;
+  uint32_t lo;
+  uint32_t tmp;
+
+  /* Re-read if the low word wrapped between the two reads */
+
+  do
+    {
+      __asm__ __volatile__("rdtimeh %0" : "=r" (hi));
+      __asm__ __volatile__("rdtime %0" : "=r" (lo));
+      __asm__ __volatile__("rdtimeh %0" : "=r" (tmp));
+    }
+  while (hi != tmp);
+
+  return ((uint64_t)hi << 32) | lo;
+#endif
+}
+
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
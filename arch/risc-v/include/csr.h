@@ -383,6 +383,12 @@
 #define PMPCFG_A_MASK       (3 << 3)  /* address-matching mode mask */
 #define PMPCFG_L            (1 << 7)  /* locked ? */
 
+/* In [m|s]counteren register: counters readable at the lower privilege */
+
+#define COUNTEREN_CY        (1 << 0)  /* cycle */
+#define COUNTEREN_TM        (1 << 1)  /* time */
+#define COUNTEREN_IR        (1 << 2)  /* instret */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -606,6 +606,28 @@ static inline uintptr_t up_getsp(void)
   return sp;
 }
 
+/* Return the current value of the thread pointer */
+
+static inline uintptr_t up_gettp(void)
+{
+  register uintptr_t tp;
+  __asm__
+  (
+    "\tadd  %0, x0, x4\n"
+    : "=r"(tp)
+  );
+  return tp;
+}
+
+/* With compiler TLS, the thread pointer holds the address just past the
+ * TLS information of the running thread, where its .tdata begins.
+ */
+
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+#  define up_tls_info() \
+     ((FAR struct tls_info_s *)(up_gettp() - sizeof(struct tls_info_s)))
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
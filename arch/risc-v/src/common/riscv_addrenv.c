@@ -549,6 +549,16 @@ int up_addrenv_destroy(arch_addrenv_t *addrenv)
 
               for (j = 0; j < ENTRIES_PER_PGT; j++)
                 {
+                  uintptr_t pgvaddr = vaddr + j * MM_PGSIZE;
+
+                  /* Do not free .text shared with another environment */
+
+                  if (pgvaddr >= addrenv->textvbase &&
+                      pgvaddr - addrenv->textvbase < addrenv->textshared)
+                    {
+                      continue;
+                    }
+
                   paddr = mmu_pte_to_paddr(ptlast[j]);
                   if (paddr)
                     {
@@ -766,6 +776,73 @@ int up_addrenv_clone(const arch_addrenv_t *src,
   return OK;
 }
 
+/****************************************************************************
+ * Name: up_addrenv_share_text
+ *
+ * Description:
+ *   Replace the .text pages of an address environment with those of
+ *   another one, so that both run the same physical copy of the program.
+ *   Both must have been created by up_addrenv_create() with the same
+ *   textsize.  The shared pages are mapped read/execute only and are not
+ *   freed by up_addrenv_destroy(addrenv); 'src' must outlive 'addrenv'.
+ *
+ * Input Parameters:
+ *   src      - The address environment that owns the .text pages.
+ *   addrenv  - The address environment that will share them.
+ *   textsize - The size of the .text region in bytes.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int up_addrenv_share_text(const arch_addrenv_t *src,
+                          arch_addrenv_t *addrenv, size_t textsize)
+{
+  uintptr_t ptprev;
+  uintptr_t ptlast;
+  uintptr_t paddr;
+  uintptr_t spaddr;
+  uintptr_t vaddr;
+  size_t    npages;
+  size_t    i;
+
+  DEBUGASSERT(src && addrenv && src->textvbase == addrenv->textvbase);
+
+  ptprev = riscv_pgvaddr(addrenv->spgtables[ARCH_SPGTS - 1]);
+  vaddr  = addrenv->textvbase;
+  npages = MM_NPAGES(textsize);
+
+  for (i = 0; i < npages; i++, vaddr += MM_PGSIZE)
+    {
+      spaddr = up_addrenv_find_page((arch_addrenv_t *)src, vaddr);
+      ptlast = riscv_pgvaddr(mmu_pte_to_paddr(mmu_ln_getentry(ARCH_SPGTS,
+                                                              ptprev,
+                                                              vaddr)));
+      if (spaddr == 0 || ptlast == 0)
+        {
+          return -EINVAL;
+        }
+
+      /* Drop the private page and map the shared one in its place */
+
+      paddr = mmu_pte_to_paddr(mmu_ln_getentry(ARCH_SPGTS + 1, ptlast,
+                                               vaddr));
+      mmu_ln_setentry(ARCH_SPGTS + 1, ptlast, spaddr, vaddr,
+                      MMU_UTEXT_FLAGS);
+
+      if (paddr != 0)
+        {
+          mm_pgfree(paddr, 1);
+        }
+
+      addrenv->textshared = (i + 1) << MM_PGSHIFT;
+    }
+
+  __DMB();
+  return OK;
+}
+
 /****************************************************************************
  * Name: up_addrenv_attach
  *
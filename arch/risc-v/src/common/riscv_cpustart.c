@@ -34,6 +34,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched_note.h>
+#include <nuttx/tls.h>
 
 #include "sched/sched.h"
 #include "init/init.h"
@@ -77,6 +78,18 @@ void riscv_cpu_boot(int cpu)
 
   asm("WFI");
 
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+  /* Set the thread pointer of the idle thread */
+
+  __asm__ __volatile__
+  (
+    "mv tp, %0\n"
+    :
+    : "r"((uintptr_t)this_task()->stack_alloc_ptr +
+          sizeof(struct tls_info_s))
+  );
+#endif
+
 #ifdef CONFIG_BUILD_KERNEL
   /* Initialize the per CPU areas */
 
@@ -88,6 +101,12 @@ void riscv_cpu_boot(int cpu)
   mmu_enable(g_kernel_pgt_pbase, 0);
 #endif
 
+#ifdef CONFIG_CLOCK_VDSO
+  /* Let user space read the time CSR, as on the boot hart */
+
+  SET_CSR(CSR_COUNTEREN, COUNTEREN_TM);
+#endif
+
   _info("CPU%d Started\n", this_cpu());
 
 #ifdef CONFIG_STACK_COLORATION
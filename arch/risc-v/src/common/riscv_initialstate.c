@@ -84,6 +84,19 @@ void up_initial_state(struct tcb_s *tcb)
       riscv_stack_color(tcb->stack_alloc_ptr, 0);
 #endif /* CONFIG_STACK_COLORATION */
 
+#ifdef CONFIG_SCHED_THREAD_LOCAL
+      /* The idle thread of CPU0 is the caller.  Set its thread pointer
+       * now; it does not start from a saved context.
+       */
+
+      __asm__ __volatile__
+      (
+        "mv tp, %0\n"
+        :
+        : "r"((uintptr_t)tcb->stack_alloc_ptr + sizeof(struct tls_info_s))
+      );
+#endif
+
       /* Set idle process' initial interrupt context */
 
       riscv_set_idleintctx();
@@ -235,6 +235,15 @@ static inline void riscv_savecontext(struct tcb_s *tcb)
   tcb->xcp.regs = (uintptr_t *)CURRENT_REGS;
 
 #ifdef CONFIG_ARCH_FPU
+#  ifdef CONFIG_ARCH_LAZYFPU
+  /* riscv_savefpu() only stores a dirty FPU state */
+
+  if ((tcb->xcp.regs[REG_INT_CTX] & MSTATUS_FS) == MSTATUS_FS_DIRTY)
+    {
+      tcb->fpu_saves++;
+    }
+#  endif
+
   /* Save current process FPU state to TCB */
 
   riscv_savefpu(tcb->xcp.regs, riscv_fpuregs(tcb));
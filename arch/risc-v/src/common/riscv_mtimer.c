@@ -76,6 +76,10 @@ static const struct oneshot_operations_s g_riscv_mtimer_ops =
   .current   = riscv_mtimer_current,
 };
 
+#ifdef CONFIG_CLOCK_VDSO
+static uint32_t g_mtimer_freq;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -332,7 +336,21 @@ riscv_mtimer_initialize(uintptr_t mtime, uintptr_t mtimecmp,
       riscv_mtimer_set_mtimecmp(priv, UINT64_MAX);
       irq_attach(irq, riscv_mtimer_interrupt, priv);
       up_enable_irq(irq);
+
+#ifdef CONFIG_CLOCK_VDSO
+      /* Let user space read the time CSR for clock_gettime() */
+
+      g_mtimer_freq = freq;
+      SET_CSR(CSR_COUNTEREN, COUNTEREN_TM);
+#endif
     }
 
   return (struct oneshot_lowerhalf_s *)priv;
 }
+
+#ifdef CONFIG_CLOCK_VDSO
+uint32_t up_vdso_getfreq(void)
+{
+  return g_mtimer_freq;
+}
+#endif
@@ -0,0 +1,70 @@
+/****************************************************************************
+ * arch/risc-v/src/common/riscv_pmu.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/perfcount.h>
+#include <arch/csr.h>
+
+#include "riscv_internal.h"
+
+#ifdef CONFIG_SCHED_PERFCOUNT
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_pmu_start
+ *
+ * Description:
+ *   The cycle and instret counters always run.  The events of the
+ *   mhpmcounter registers are implementation defined, so the cache and
+ *   branch misses are not counted.  In S-mode the SBI firmware must have
+ *   granted access to the counters in mcounteren.
+ *
+ ****************************************************************************/
+
+uint32_t up_pmu_start(void)
+{
+  return (1 << PERFCOUNT_CYCLES) | (1 << PERFCOUNT_INSTRUCTIONS);
+}
+
+/****************************************************************************
+ * Name: up_pmu_read
+ *
+ * Description:
+ *   Read the cycle and instret counters of this hart.
+ *
+ ****************************************************************************/
+
+void up_pmu_read(FAR uint32_t *counts)
+{
+  counts[PERFCOUNT_CYCLES]       = READ_CSR(CSR_CYCLE);
+  counts[PERFCOUNT_INSTRUCTIONS] = READ_CSR(CSR_INSTRET);
+}
+#endif
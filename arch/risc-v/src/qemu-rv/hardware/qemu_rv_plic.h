@@ -46,4 +46,15 @@
 #  define QEMU_RV_PLIC_CLAIM     (QEMU_RV_PLIC_BASE + 0x200004)
 #endif
 
+/* Each hart has an M-mode and an S-mode context, so the registers of the
+ * same mode on consecutive harts are two contexts apart.
+ */
+
+#define QEMU_RV_PLIC_ENABLE_CPU(n) \
+  ((uintptr_t)QEMU_RV_PLIC_ENABLE1 + 0x100 * (n))
+#define QEMU_RV_PLIC_THRESHOLD_CPU(n) \
+  ((uintptr_t)QEMU_RV_PLIC_THRESHOLD + 0x2000 * (n))
+#define QEMU_RV_PLIC_CLAIM_CPU(n) \
+  ((uintptr_t)QEMU_RV_PLIC_CLAIM + 0x2000 * (n))
+
 #endif /* __ARCH_RISCV_SRC_QEMU_RV_HARDWARE_QEMU_RV_PLIC_H */
@@ -35,6 +35,89 @@
 #include "riscv_internal.h"
 #include "chip.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define QEMU_RV_PLIC_NEXTIRQS 64
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+/* The CPUs each external interrupt is routed to, see up_affinity_irq().
+ * An empty set means CPU0 only.  g_plic_enabled records which external
+ * interrupts are enabled, so that changing the routing of an enabled one
+ * takes effect at once.
+ */
+
+static cpu_set_t g_plic_affinity[QEMU_RV_PLIC_NEXTIRQS];
+static uint64_t g_plic_enabled;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qemu_rv_plic_route
+ *
+ * Description:
+ *   Set or clear the enable bit of an external interrupt in the PLIC
+ *   context of every CPU, according to its affinity.
+ *
+ ****************************************************************************/
+
+static void qemu_rv_plic_route(int extirq, bool enable)
+{
+  uint32_t bit = 1 << (extirq % 32);
+  uintptr_t offset = 4 * (extirq / 32);
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset = g_plic_affinity[extirq];
+  irqstate_t flags;
+  int cpu;
+
+  if (cpuset == 0)
+    {
+      cpuset = 1;
+    }
+
+  flags = enter_critical_section();
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (enable && (cpuset & (1 << cpu)) != 0)
+        {
+          modifyreg32(QEMU_RV_PLIC_ENABLE_CPU(cpu) + offset, 0, bit);
+        }
+      else
+        {
+          modifyreg32(QEMU_RV_PLIC_ENABLE_CPU(cpu) + offset, bit, 0);
+        }
+    }
+
+  if (enable)
+    {
+      g_plic_enabled |= UINT64_C(1) << extirq;
+    }
+  else
+    {
+      g_plic_enabled &= ~(UINT64_C(1) << extirq);
+    }
+
+  leave_critical_section(flags);
+#else
+  if (enable)
+    {
+      modifyreg32(QEMU_RV_PLIC_ENABLE1 + offset, 0, bit);
+    }
+  else
+    {
+      modifyreg32(QEMU_RV_PLIC_ENABLE1 + offset, bit, 0);
+    }
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -45,14 +128,19 @@
 
 void up_irqinitialize(void)
 {
+  int id;
+
   /* Disable Machine interrupts */
 
   up_irq_save();
 
   /* Disable all global interrupts */
 
-  putreg32(0x0, QEMU_RV_PLIC_ENABLE1);
-  putreg32(0x0, QEMU_RV_PLIC_ENABLE2);
+  for (id = 0; id < CONFIG_SMP_NCPUS; id++)
+    {
+      putreg32(0x0, QEMU_RV_PLIC_ENABLE_CPU(id));
+      putreg32(0x0, QEMU_RV_PLIC_ENABLE_CPU(id) + 4);
+    }
 
   /* Colorize the interrupt stack for debug purposes */
 
@@ -63,8 +151,6 @@ void up_irqinitialize(void)
 
   /* Set priority for all global interrupts to 1 (lowest) */
 
-  int id;
-
   for (id = 1; id <= 52; id++)
     {
       putreg32(1, (uintptr_t)(QEMU_RV_PLIC_PRIORITY + 4 * id));
@@ -72,7 +158,10 @@ void up_irqinitialize(void)
 
   /* Set irq threshold to 0 (permits all global interrupts) */
 
-  putreg32(0, QEMU_RV_PLIC_THRESHOLD);
+  for (id = 0; id < CONFIG_SMP_NCPUS; id++)
+    {
+      putreg32(0, QEMU_RV_PLIC_THRESHOLD_CPU(id));
+    }
 
   /* Attach the common interrupt handler */
 
@@ -124,10 +213,9 @@ void up_disable_irq(int irq)
 
       /* Clear enable bit for the irq */
 
-      if (0 <= extirq && extirq <= 63)
+      if (0 <= extirq && extirq < QEMU_RV_PLIC_NEXTIRQS)
         {
-          modifyreg32(QEMU_RV_PLIC_ENABLE1 + (4 * (extirq / 32)),
-                      1 << (extirq % 32), 0);
+          qemu_rv_plic_route(extirq, false);
         }
       else
         {
@@ -174,10 +262,9 @@ void up_enable_irq(int irq)
 
       /* Set enable bit for the irq */
 
-      if (0 <= extirq && extirq <= 63)
+      if (0 <= extirq && extirq < QEMU_RV_PLIC_NEXTIRQS)
         {
-          modifyreg32(QEMU_RV_PLIC_ENABLE1 + (4 * (extirq / 32)),
-                      0, 1 << (extirq % 32));
+          qemu_rv_plic_route(extirq, true);
         }
       else
         {
@@ -186,6 +273,38 @@ void up_enable_irq(int irq)
     }
 }
 
+/****************************************************************************
+ * Name: up_affinity_irq
+ *
+ * Description:
+ *   Route the external interrupt 'irq' to the CPUs in 'cpuset'.  The PLIC
+ *   offers it to the context of each of them and the first to claim it
+ *   handles it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+void up_affinity_irq(int irq, cpu_set_t cpuset)
+{
+  irqstate_t flags;
+  int extirq = irq - RISCV_IRQ_EXT;
+
+  if (extirq <= 0 || extirq >= QEMU_RV_PLIC_NEXTIRQS)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  g_plic_affinity[extirq] = cpuset;
+  if ((g_plic_enabled & (UINT64_C(1) << extirq)) != 0)
+    {
+      qemu_rv_plic_route(extirq, true);
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
 irqstate_t up_irq_enable(void)
 {
   irqstate_t oldstat;
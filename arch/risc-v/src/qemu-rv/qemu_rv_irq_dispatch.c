@@ -61,7 +61,7 @@ void *riscv_dispatch_irq(uintptr_t vector, uintptr_t *regs)
 
   if (RISCV_IRQ_EXT == irq)
     {
-      uintptr_t val = getreg32(QEMU_RV_PLIC_CLAIM);
+      uintptr_t val = getreg32(QEMU_RV_PLIC_CLAIM_CPU(up_cpu_index()));
 
       /* Add the value to nuttx irq which is offset to the mext */
 
@@ -81,7 +81,7 @@ void *riscv_dispatch_irq(uintptr_t vector, uintptr_t *regs)
     {
       /* Then write PLIC_CLAIM to clear pending in PLIC */
 
-      putreg32(irq - RISCV_IRQ_EXT, QEMU_RV_PLIC_CLAIM);
+      putreg32(irq - RISCV_IRQ_EXT, QEMU_RV_PLIC_CLAIM_CPU(up_cpu_index()));
     }
 
   return regs;
@@ -26,10 +26,16 @@
 #include <signal.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
 
+#ifdef __linux__
+#  include <linux/perf_event.h>
+#  include <sys/syscall.h>
+#endif
+
 #include "sim_internal.h"
 
 /****************************************************************************
@@ -130,3 +136,47 @@ int host_timerirq(void)
 {
   return SIGALRM;
 }
+
+/****************************************************************************
+ * Name: host_instructions
+ *
+ * Description:
+ *   Get the number of user mode instructions retired by the calling host
+ *   thread.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The instruction count, zero if the host cannot count instructions.
+ *
+ ****************************************************************************/
+
+uint64_t host_instructions(void)
+{
+#ifdef __linux__
+  static int fd = -2;
+  uint64_t count;
+
+  if (fd == -2)
+    {
+      struct perf_event_attr attr;
+
+      memset(&attr, 0, sizeof(attr));
+      attr.type           = PERF_TYPE_HARDWARE;
+      attr.size           = sizeof(attr);
+      attr.config         = PERF_COUNT_HW_INSTRUCTIONS;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv     = 1;
+
+      fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+  if (fd >= 0 && read(fd, &count, sizeof(count)) == sizeof(count))
+    {
+      return count;
+    }
+#endif
+
+  return 0;
+}
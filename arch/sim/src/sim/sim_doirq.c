@@ -55,6 +55,8 @@ void *sim_doirq(int irq, void *context)
     {
       CURRENT_REGS = regs;
 
+      sim_vclock_charge(CONFIG_SIM_VCLOCK_IRQ_NS);
+
       /* Deliver the IRQ */
 
       irq_dispatch(irq, regs);
@@ -209,6 +209,7 @@ void host_sleep(uint64_t nsec);
 void host_sleepuntil(uint64_t nsec);
 int host_timerirq(void);
 int host_settimer(uint64_t nsec);
+uint64_t host_instructions(void);
 
 /* sim_sigdeliver.c *********************************************************/
 
@@ -235,6 +236,16 @@ int sim_init_ipi(int irq);
 void sim_timer_update(void);
 #endif
 
+/* sim_vclock.c *************************************************************/
+
+#ifdef CONFIG_SIM_VIRTUAL_TIME
+uint64_t sim_vclock_gettime(void);
+void sim_vclock_charge(uint64_t nsec);
+uint64_t sim_vclock_advance(uint64_t nsec);
+#else
+#  define sim_vclock_charge(nsec)
+#endif
+
 /* sim_uart.c ***************************************************************/
 
 void sim_uartinit(void);
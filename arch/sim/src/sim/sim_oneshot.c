@@ -105,7 +105,7 @@ static const struct oneshot_operations_s g_oneshot_ops =
  * Name: sim_timer_current
  *
  * Description:
- *   Get current time from host.
+ *   Get current time from host, or from the virtual clock.
  *
  ****************************************************************************/
 
@@ -114,7 +114,11 @@ static inline void sim_timer_current(struct timespec *ts)
   uint64_t nsec;
   time_t sec;
 
+#ifdef CONFIG_SIM_VIRTUAL_TIME
+  nsec  = sim_vclock_gettime();
+#else
   nsec  = host_gettime(false);
+#endif
   sec   = nsec / NSEC_PER_SEC;
   nsec -= sec * NSEC_PER_SEC;
 
@@ -137,21 +141,18 @@ static inline void sim_reset_alarm(struct timespec *alarm)
 }
 
 /****************************************************************************
- * Name: sim_update_hosttimer
+ * Name: sim_next_alarm
  *
  * Description:
- *   Ths function is called periodically to deliver the tick events to the
- *   NuttX simulation.
+ *   Return the earliest alarm of all oneshot timers.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_SIM_WALLTIME_SIGNAL
-static void sim_update_hosttimer(void)
+#if defined(CONFIG_SIM_WALLTIME_SIGNAL) || defined(CONFIG_SIM_VIRTUAL_TIME)
+static struct timespec *sim_next_alarm(void)
 {
   struct timespec *next = NULL;
-  struct timespec current;
   sq_entry_t *entry;
-  uint64_t nsec;
 
   for (entry = sq_peek(&g_oneshot_list); entry; entry = sq_next(entry))
     {
@@ -170,6 +171,26 @@ static void sim_update_hosttimer(void)
         }
     }
 
+  return next;
+}
+#endif
+
+/****************************************************************************
+ * Name: sim_update_hosttimer
+ *
+ * Description:
+ *   Ths function is called periodically to deliver the tick events to the
+ *   NuttX simulation.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SIM_WALLTIME_SIGNAL
+static void sim_update_hosttimer(void)
+{
+  struct timespec *next = sim_next_alarm();
+  struct timespec current;
+  uint64_t nsec;
+
   sim_timer_current(&current);
   clock_timespec_subtract(next, &current, &current);
 
@@ -507,7 +528,8 @@ void up_timer_initialize(void)
  * Name: sim_timer_update
  *
  * Description:
- *   Called from the IDLE loop to fake one timer tick.
+ *   Called from the IDLE loop to fake one timer tick.  On the virtual
+ *   clock, jump to the next alarm instead.
  *
  * Input Parameters:
  *   None
@@ -519,6 +541,39 @@ void up_timer_initialize(void)
 
 void sim_timer_update(void)
 {
+#ifdef CONFIG_SIM_VIRTUAL_TIME
+  struct timespec *next;
+  irqstate_t flags;
+  uint64_t nsec = 0;
+
+  /* Nothing is ready to run, so nothing happens before the next alarm:
+   * move the virtual clock straight to it.
+   */
+
+  flags = enter_critical_section();
+
+  next = sim_next_alarm();
+  if (next != NULL && next->tv_sec != UINT_MAX)
+    {
+      nsec = sim_vclock_advance(next->tv_sec * NSEC_PER_SEC +
+                                next->tv_nsec);
+    }
+
+  leave_critical_section(flags);
+
+  /* Without any alarm only the host can wake us up, wait for it */
+
+#ifdef CONFIG_SIM_VCLOCK_IDLE_SLEEP
+  host_sleep(nsec != 0 ? nsec : NSEC_PER_TICK);
+#else
+  if (nsec == 0)
+    {
+      host_sleep(NSEC_PER_TICK);
+    }
+#endif
+
+  sim_timer_update_internal();
+#else
   static uint64_t until;
 
   /* Wait a bit so that the timing is close to the correct rate. */
@@ -529,4 +584,5 @@ void sim_timer_update(void)
 #ifdef CONFIG_SIM_WALLTIME_SLEEP
   sim_timer_update_internal();
 #endif
+#endif
 }
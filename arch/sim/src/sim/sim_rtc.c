@@ -63,13 +63,31 @@ static int64_t g_sim_delta;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: sim_rtc_gettime
+ *
+ * Description:
+ *   Get the host wall time.  The virtual clock starts at the epoch instead,
+ *   so that the dates seen by the simulation do not depend on the host.
+ *
+ ****************************************************************************/
+
+static uint64_t sim_rtc_gettime(void)
+{
+#ifdef CONFIG_SIM_VIRTUAL_TIME
+  return sim_vclock_gettime();
+#else
+  return host_gettime(true);
+#endif
+}
+
 static int sim_rtc_rdtime(struct rtc_lowerhalf_s *lower,
                           struct rtc_time *rtctime)
 {
   uint64_t nsec;
   time_t sec;
 
-  nsec  = host_gettime(true);
+  nsec  = sim_rtc_gettime();
   nsec += g_sim_delta;
   sec   = nsec / NSEC_PER_SEC;
   nsec -= sec * NSEC_PER_SEC;
@@ -86,7 +104,7 @@ static int sim_rtc_settime(struct rtc_lowerhalf_s *lower,
   g_sim_delta = timegm((struct tm *)rtctime);
   g_sim_delta *= NSEC_PER_SEC;
   g_sim_delta += rtctime->tm_nsec;
-  g_sim_delta -= host_gettime(true);
+  g_sim_delta -= sim_rtc_gettime();
 
   return OK;
 }
@@ -57,6 +57,8 @@ void up_switch_context(struct tcb_s *tcb, struct tcb_s *rtcb)
 
   sinfo("Unblocking TCB=%p\n", tcb);
 
+  sim_vclock_charge(CONFIG_SIM_VCLOCK_SWITCH_NS);
+
   /* Update scheduler parameters */
 
   nxsched_suspend_scheduler(rtcb);
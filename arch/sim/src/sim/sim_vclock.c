@@ -0,0 +1,149 @@
+/****************************************************************************
+ * arch/sim/src/sim/sim_vclock.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+
+#include "sim_internal.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The virtual time is g_vclock_charged plus the host instructions retired
+ * since g_vclock_insn0, at CONFIG_SIM_VCLOCK_INSN_PS each.
+ */
+
+static uint64_t g_vclock_charged;   /* Fixed costs and idle jumps */
+static uint64_t g_vclock_insn0;     /* Instruction count at the first read */
+static bool g_vclock_started;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sim_vclock_now
+ *
+ * Description:
+ *   Return the virtual time without charging a clock read.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static uint64_t sim_vclock_now(void)
+{
+  uint64_t insn = host_instructions();
+
+  if (!g_vclock_started)
+    {
+      g_vclock_insn0   = insn;
+      g_vclock_started = true;
+    }
+
+  return g_vclock_charged +
+         (insn - g_vclock_insn0) * CONFIG_SIM_VCLOCK_INSN_PS / 1000;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sim_vclock_gettime
+ *
+ * Description:
+ *   Read the virtual clock, in nanoseconds since the start of the
+ *   simulation.  Each read costs CONFIG_SIM_VCLOCK_READ_NS.
+ *
+ ****************************************************************************/
+
+uint64_t sim_vclock_gettime(void)
+{
+  irqstate_t flags;
+  uint64_t now;
+
+  flags = up_irq_save();
+
+  g_vclock_charged += CONFIG_SIM_VCLOCK_READ_NS;
+  now = sim_vclock_now();
+
+  up_irq_restore(flags);
+  return now;
+}
+
+/****************************************************************************
+ * Name: sim_vclock_charge
+ *
+ * Description:
+ *   Charge the fixed cost of a kernel operation to the virtual clock.
+ *
+ ****************************************************************************/
+
+void sim_vclock_charge(uint64_t nsec)
+{
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  g_vclock_charged += nsec;
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: sim_vclock_advance
+ *
+ * Description:
+ *   Move the virtual clock forward to 'nsec' if it is behind.  Called when
+ *   the simulation is idle to jump to the next timer event.
+ *
+ * Returned Value:
+ *   The number of nanoseconds skipped.
+ *
+ ****************************************************************************/
+
+uint64_t sim_vclock_advance(uint64_t nsec)
+{
+  uint64_t skipped = 0;
+  irqstate_t flags;
+  uint64_t now;
+
+  flags = up_irq_save();
+
+  now = sim_vclock_now();
+  if (nsec > now)
+    {
+      skipped           = nsec - now;
+      g_vclock_charged += skipped;
+    }
+
+  up_irq_restore(flags);
+  return skipped;
+}
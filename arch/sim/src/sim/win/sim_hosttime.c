@@ -157,3 +157,17 @@ int host_timerirq(void)
 {
   return 0;
 }
+
+/****************************************************************************
+ * Name: host_instructions
+ *
+ * Description:
+ *   Get the number of user mode instructions retired by the calling host
+ *   thread.  Not supported on Windows.
+ *
+ ****************************************************************************/
+
+uint64_t host_instructions(void)
+{
+  return 0;
+}
@@ -137,11 +137,17 @@
 
 #define X86_64_CPUID_CAP         0x01
 #  define X86_64_CPUID_01_SSE3   (1 << 0)
+#  define X86_64_CPUID_01_PCLMUL (1 << 1)
+#  define X86_64_CPUID_01_SSSE3  (1 << 9)
 #  define X86_64_CPUID_01_PCID   (1 << 17)
+#  define X86_64_CPUID_01_SSE41  (1 << 19)
 #  define X86_64_CPUID_01_X2APIC (1 << 21)
 #  define X86_64_CPUID_01_TSCDEA (1 << 24)
+#  define X86_64_CPUID_01_AESNI  (1 << 25)
 #  define X86_64_CPUID_01_XSAVE  (1 << 26)
 #  define X86_64_CPUID_01_RDRAND (1 << 30)
+#define X86_64_CPUID_EXTCAP      0x07
+#  define X86_64_CPUID_07_SHA    (1 << 29)
 #define X86_64_CPUID_TSC         0x15
 
 /* MSR Definitions */
@@ -32,10 +32,12 @@
 #include <unistd.h>
 #include <string.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mqueue.h>
 #include <nuttx/arch.h>
@@ -76,6 +78,10 @@ struct audio_upperhalf_s
   mutex_t           lock;             /* Supports mutual exclusion */
   FAR struct audio_lowerhalf_s *dev;  /* lower-half state */
   struct file      *usermq;           /* User mode app's message queue */
+#ifdef CONFIG_AUDIO_MMAP
+  FAR struct audio_ring_s *ring;      /* Ring buffer of the mmap() mode */
+  FAR struct pollfd *fds[CONFIG_AUDIO_NPOLLWAITERS];
+#endif
 };
 
 /****************************************************************************
@@ -93,6 +99,13 @@ static ssize_t  audio_write(FAR struct file *filep,
 static int      audio_ioctl(FAR struct file *filep,
                             int cmd,
                             unsigned long arg);
+#ifdef CONFIG_AUDIO_MMAP
+static int      audio_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+static int      audio_poll(FAR struct file *filep,
+                           FAR struct pollfd *fds,
+                           bool setup);
+#endif
 #ifdef CONFIG_AUDIO_MULTI_SESSION
 static int      audio_start(FAR struct audio_upperhalf_s *upper,
                             FAR void *session);
@@ -121,6 +134,11 @@ static const struct file_operations g_audioops =
   audio_write, /* write */
   NULL,        /* seek */
   audio_ioctl, /* ioctl */
+#ifdef CONFIG_AUDIO_MMAP
+  audio_mmap,  /* mmap */
+  NULL,        /* truncate */
+  audio_poll,  /* poll */
+#endif
 };
 
 /****************************************************************************
@@ -655,6 +673,15 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           audinfo("Forwarding unrecognized cmd: %d arg: %ld\n", cmd, arg);
           DEBUGASSERT(lower->ops->ioctl != NULL);
           ret = lower->ops->ioctl(lower, cmd, arg);
+
+#ifdef CONFIG_AUDIO_MMAP
+          /* New buffer sizes give the ring back to the lower half */
+
+          if (cmd == AUDIOIOC_SETBUFFERINFO && ret >= 0)
+            {
+              upper->ring = NULL;
+            }
+#endif
         }
         break;
     }
@@ -663,6 +690,217 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+#ifdef CONFIG_AUDIO_MMAP
+/****************************************************************************
+ * Name: audio_ringavail
+ *
+ * Description:
+ *   Return the bytes the application may write (playback) or read
+ *   (capture) in the ring buffer.
+ *
+ ****************************************************************************/
+
+static uint32_t audio_ringavail(FAR struct audio_ring_s *ring)
+{
+  uint32_t hw_ptr = ring->hw_ptr;
+  uint32_t appl_ptr = ring->appl_ptr;
+
+  if (ring->playback)
+    {
+      return ring->buffer_size - (appl_ptr - hw_ptr);
+    }
+
+  return hw_ptr - appl_ptr;
+}
+
+/****************************************************************************
+ * Name: audio_ringclean
+ *
+ * Description:
+ *   Write the samples of the ring buffer that the application wrote but
+ *   the device has not played yet back to the memory.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_DCACHE
+static void audio_ringclean(FAR struct audio_ring_s *ring)
+{
+  uintptr_t data = (uintptr_t)ring + AUDIO_RING_DATA;
+  uint32_t start = ring->hw_ptr % ring->buffer_size;
+  uint32_t end = ring->appl_ptr % ring->buffer_size;
+
+  if (ring->appl_ptr - ring->hw_ptr >= ring->buffer_size)
+    {
+      up_clean_dcache(data, data + ring->buffer_size);
+    }
+  else if (start <= end)
+    {
+      up_clean_dcache(data + start, data + end);
+    }
+  else
+    {
+      up_clean_dcache(data + start, data + ring->buffer_size);
+      up_clean_dcache(data, data + end);
+    }
+}
+#else
+#  define audio_ringclean(ring)
+#endif
+
+/****************************************************************************
+ * Name: audio_mmap
+ *
+ * Description:
+ *   Map the ring buffer of the device.  The mapping starts with the
+ *   audio_ring_s header, the samples follow at AUDIO_RING_DATA.
+ *
+ ****************************************************************************/
+
+static int audio_mmap(FAR struct file *filep,
+                      FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  size_t size;
+  int ret;
+
+  ret = nxmutex_lock(&upper->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (upper->ring == NULL)
+    {
+      DEBUGASSERT(lower->ops->ioctl != NULL);
+      ret = lower->ops->ioctl(lower, AUDIOIOC_GETRING,
+                              (unsigned long)((uintptr_t)&upper->ring));
+      if (ret < 0)
+        {
+          upper->ring = NULL;
+          goto out;
+        }
+    }
+
+  size = AUDIO_RING_DATA + upper->ring->buffer_size;
+  if (map->offset >= 0 && map->offset < size &&
+      map->length && map->offset + map->length <= size)
+    {
+      map->vaddr = (FAR char *)upper->ring + map->offset;
+      ret = OK;
+    }
+  else
+    {
+      ret = -EINVAL;
+    }
+
+out:
+  nxmutex_unlock(&upper->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_poll
+ *
+ * Description:
+ *   Wait for a period of the ring buffer to be writable (playback) or
+ *   readable (capture).  The samples the application wrote before it
+ *   waits are cleaned from the data cache here, so they reach the memory
+ *   before the DMA reads them.
+ *
+ ****************************************************************************/
+
+static int audio_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                      bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  FAR struct audio_ring_s *ring;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&upper->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ring = upper->ring;
+  if (!setup)
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      if (slot != NULL)
+        {
+          *slot     = NULL;
+          fds->priv = NULL;
+        }
+
+      goto out;
+    }
+
+  for (i = 0; i < CONFIG_AUDIO_NPOLLWAITERS; i++)
+    {
+      if (upper->fds[i] == NULL)
+        {
+          upper->fds[i] = fds;
+          fds->priv     = &upper->fds[i];
+          break;
+        }
+    }
+
+  if (i >= CONFIG_AUDIO_NPOLLWAITERS)
+    {
+      ret = -EBUSY;
+      goto out;
+    }
+
+  if (ring == NULL)
+    {
+      goto out;
+    }
+
+  if (ring->playback)
+    {
+      audio_ringclean(ring);
+    }
+
+  flags = enter_critical_section();
+  if (audio_ringavail(ring) >= ring->period_size)
+    {
+      poll_notify(&fds, 1, ring->playback ? POLLOUT : POLLIN);
+    }
+
+  leave_critical_section(flags);
+
+out:
+  nxmutex_unlock(&upper->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_period
+ *
+ * Description:
+ *   The lower half moved the hardware pointer of the ring buffer on by one
+ *   period, wake up the poll() waiters if a period is ready for them.
+ *
+ ****************************************************************************/
+
+static void audio_period(FAR struct audio_upperhalf_s *upper)
+{
+  FAR struct audio_ring_s *ring = upper->ring;
+
+  if (ring != NULL && audio_ringavail(ring) >= ring->period_size)
+    {
+      poll_notify(upper->fds, CONFIG_AUDIO_NPOLLWAITERS,
+                  ring->playback ? POLLOUT : POLLIN);
+    }
+}
+#endif /* CONFIG_AUDIO_MMAP */
+
 /****************************************************************************
  * Name: audio_dequeuebuffer
  *
@@ -878,6 +1116,16 @@ static void audio_callback(FAR void *handle, uint16_t reason,
         }
         break;
 
+#ifdef CONFIG_AUDIO_MMAP
+      /* Lower-half driver has completed a period of the ring buffer */
+
+      case AUDIO_CALLBACK_PERIOD:
+        {
+          audio_period(upper);
+        }
+        break;
+#endif
+
       default:
         {
           auderr("ERROR: Unknown callback reason code %d\n", reason);
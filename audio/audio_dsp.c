@@ -0,0 +1,407 @@
+/****************************************************************************
+ * audio/audio_dsp.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/audio/audio_mixer.h>
+
+/* The vector kernels are picked by the compiler flags of the target:
+ * Helium (M-profile vector extension) and NEON share the intrinsics used
+ * here.  Without them the DSP extension of the Cortex-M4/M7/M33 gives the
+ * saturating and dual 16-bit multiply instructions.
+ */
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+#  include <arm_mve.h>
+#  define AUDIO_DSP_VECTOR 1
+#elif defined(__ARM_NEON)
+#  include <arm_neon.h>
+#  define AUDIO_DSP_VECTOR 1
+#endif
+
+#if defined(__ARM_FEATURE_SAT) || defined(__ARM_FEATURE_SIMD32)
+#  include <arm_acle.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define AUDIO_SRC_PHASE(pos) ((pos) / (AUDIO_SRC_ONE / AUDIO_SRC_NPHASES))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Kaiser windowed (beta 5) sinc at 0.9 of the input Nyquist frequency, one
+ * row per phase, each row sums to AUDIO_GAIN_UNITY.
+ */
+
+static const int16_t g_audio_src_coef[AUDIO_SRC_NPHASES][AUDIO_SRC_NTAPS]
+aligned_data(16) =
+{
+  {   646,  -1688,   2786,  29370,   2786,  -1688,    646,    -91},
+  {   574,  -1425,   1940,  29338,   3680,  -1955,    718,   -103},
+  {   503,  -1168,   1142,  29223,   4616,  -2222,    789,   -116},
+  {   433,   -918,    394,  29024,   5593,  -2489,    858,   -128},
+  {   366,   -677,   -303,  28740,   6607,  -2751,    925,   -140},
+  {   301,   -446,   -947,  28379,   7652,  -3007,    987,   -152},
+  {   238,   -227,  -1537,  27935,   8727,  -3252,   1045,   -162},
+  {   180,    -22,  -2072,  27417,   9824,  -3485,   1097,   -172},
+  {   125,    169,  -2551,  26823,  10940,  -3701,   1142,   -180},
+  {    75,    345,  -2976,  26160,  12070,  -3899,   1179,   -187},
+  {    28,    506,  -3346,  25429,  13208,  -4074,   1207,   -191},
+  {   -13,    650,  -3662,  24634,  14349,  -4223,   1225,   -193},
+  {   -51,    778,  -3924,  23783,  15486,  -4344,   1231,   -192},
+  {   -83,    889,  -4136,  22877,  16615,  -4433,   1225,   -187},
+  {  -111,    984,  -4297,  21923,  17729,  -4487,   1206,   -180},
+  {  -135,   1063,  -4411,  20926,  18823,  -4503,   1173,   -169},
+  {  -154,   1126,  -4478,  19890,  19889,  -4478,   1126,   -154},
+  {  -169,   1173,  -4503,  18823,  20926,  -4411,   1063,   -135},
+  {  -180,   1206,  -4487,  17729,  21923,  -4297,    984,   -111},
+  {  -187,   1225,  -4433,  16615,  22877,  -4136,    889,    -83},
+  {  -192,   1231,  -4344,  15486,  23783,  -3924,    778,    -51},
+  {  -193,   1225,  -4223,  14349,  24634,  -3662,    650,    -13},
+  {  -191,   1207,  -4074,  13208,  25429,  -3346,    506,     28},
+  {  -187,   1179,  -3899,  12070,  26160,  -2976,    345,     75},
+  {  -180,   1142,  -3701,  10940,  26823,  -2551,    169,    125},
+  {  -172,   1097,  -3485,   9824,  27417,  -2072,    -22,    180},
+  {  -162,   1045,  -3252,   8727,  27935,  -1537,   -227,    238},
+  {  -152,    987,  -3007,   7652,  28379,   -947,   -446,    301},
+  {  -140,    925,  -2751,   6607,  28740,   -303,   -677,    366},
+  {  -128,    858,  -2489,   5593,  29024,    394,   -918,    433},
+  {  -116,    789,  -2222,   4616,  29223,   1142,  -1168,    503},
+  {  -103,    718,  -1955,   3680,  29338,   1940,  -1425,    574},
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline int16_t audio_dsp_sat16(int32_t value)
+{
+#ifdef __ARM_FEATURE_SAT
+  return __ssat(value, 16);
+#else
+  if (value > INT16_MAX)
+    {
+      return INT16_MAX;
+    }
+  else if (value < INT16_MIN)
+    {
+      return INT16_MIN;
+    }
+
+  return value;
+#endif
+}
+
+/* Rounded Q15 product, as the vector vqrdmulh instructions do it */
+
+static inline int32_t audio_dsp_scale(int16_t sample, int16_t gain)
+{
+  return ((int32_t)sample * gain + 0x4000) >> 15;
+}
+
+/* The dot product of the history of a channel with a row of coefficients,
+ * rounded back to 16 bits.
+ */
+
+static inline int16_t audio_dsp_fir(FAR const int16_t *hist,
+                                    FAR const int16_t *coef)
+{
+  int32_t acc;
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+  acc = vmladavq_s16(vld1q_s16(hist), vld1q_s16(coef));
+#elif defined(__ARM_NEON)
+  int16x8_t h = vld1q_s16(hist);
+  int16x8_t c = vld1q_s16(coef);
+  int32x4_t v = vmull_s16(vget_low_s16(h), vget_low_s16(c));
+  int32x2_t s;
+
+  v   = vmlal_s16(v, vget_high_s16(h), vget_high_s16(c));
+  s   = vadd_s32(vget_low_s32(v), vget_high_s32(v));
+  s   = vpadd_s32(s, s);
+  acc = vget_lane_s32(s, 0);
+#elif defined(__ARM_FEATURE_SIMD32)
+  FAR const int16x2_t *h = (FAR const int16x2_t *)hist;
+  FAR const int16x2_t *c = (FAR const int16x2_t *)coef;
+
+  acc = __smuad(h[0], c[0]);
+  acc = __smlad(h[1], c[1], acc);
+  acc = __smlad(h[2], c[2], acc);
+  acc = __smlad(h[3], c[3], acc);
+#else
+  int i;
+
+  for (acc = 0, i = 0; i < AUDIO_SRC_NTAPS; i++)
+    {
+      acc += (int32_t)hist[i] * coef[i];
+    }
+#endif
+
+  return audio_dsp_sat16((acc + 0x4000) >> 15);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_dsp_mix
+ *
+ * Description:
+ *   Add 'nsamples' 16-bit samples of 'src' scaled by the Q15 'gain' to
+ *   'dst', saturating the sums.
+ *
+ ****************************************************************************/
+
+void audio_dsp_mix(FAR int16_t *dst, FAR const int16_t *src,
+                   size_t nsamples, int16_t gain)
+{
+  size_t i = 0;
+
+#ifdef AUDIO_DSP_VECTOR
+  for (; i + 8 <= nsamples; i += 8)
+    {
+      int16x8_t s = vld1q_s16(&src[i]);
+
+      if (gain != AUDIO_GAIN_UNITY)
+        {
+          s = vqrdmulhq_n_s16(s, gain);
+        }
+
+      vst1q_s16(&dst[i], vqaddq_s16(vld1q_s16(&dst[i]), s));
+    }
+#elif defined(__ARM_FEATURE_SIMD32)
+  if (gain == AUDIO_GAIN_UNITY && ((uintptr_t)dst & 3) == 0 &&
+      ((uintptr_t)src & 3) == 0)
+    {
+      FAR int16x2_t *d = (FAR int16x2_t *)dst;
+      FAR const int16x2_t *s = (FAR const int16x2_t *)src;
+
+      for (; i + 2 <= nsamples; i += 2)
+        {
+          *d = __qadd16(*d, *s++);
+          d++;
+        }
+    }
+#endif
+
+  for (; i < nsamples; i++)
+    {
+      if (gain == AUDIO_GAIN_UNITY)
+        {
+          dst[i] = audio_dsp_sat16((int32_t)dst[i] + src[i]);
+        }
+      else
+        {
+          dst[i] = audio_dsp_sat16((int32_t)dst[i] +
+                                   audio_dsp_scale(src[i], gain));
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: audio_dsp_volume
+ *
+ * Description:
+ *   Scale 'nsamples' 16-bit samples by the Q15 'gain' in place.
+ *
+ ****************************************************************************/
+
+void audio_dsp_volume(FAR int16_t *buf, size_t nsamples, int16_t gain)
+{
+  size_t i = 0;
+
+  if (gain == AUDIO_GAIN_UNITY)
+    {
+      return;
+    }
+
+#ifdef AUDIO_DSP_VECTOR
+  for (; i + 8 <= nsamples; i += 8)
+    {
+      vst1q_s16(&buf[i], vqrdmulhq_n_s16(vld1q_s16(&buf[i]), gain));
+    }
+#endif
+
+  for (; i < nsamples; i++)
+    {
+      buf[i] = audio_dsp_sat16(audio_dsp_scale(buf[i], gain));
+    }
+}
+
+/****************************************************************************
+ * Name: audio_dsp_convert
+ *
+ * Description:
+ *   Convert 'nframes' PCM frames of 'nchannels' samples of 'bpsamp' bits
+ *   to interleaved 16-bit stereo frames.  8-bit samples are unsigned as in
+ *   WAV files, wider ones are signed little endian, mono is duplicated.
+ *
+ * Returned Value:
+ *   Zero on success; -EINVAL if the format is not supported.
+ *
+ ****************************************************************************/
+
+int audio_dsp_convert(FAR int16_t *dst, FAR const uint8_t *src,
+                      uint8_t bpsamp, uint8_t nchannels, size_t nframes)
+{
+  size_t nsamples = nframes * nchannels;
+  size_t bypsamp = bpsamp / 8;
+  size_t i;
+
+  if ((nchannels != 1 && nchannels != 2) ||
+      (bpsamp != 8 && bpsamp != 16 && bpsamp != 24 && bpsamp != 32))
+    {
+      return -EINVAL;
+    }
+
+  if (bpsamp == 16 && nchannels == 2)
+    {
+      memcpy(dst, src, nsamples * sizeof(int16_t));
+      return OK;
+    }
+
+  /* Mono is written to the upper half of the output first, then spread
+   * from the start so that no input is overwritten before it is read.
+   */
+
+  if (nchannels == 1)
+    {
+      dst += nframes;
+    }
+
+  for (i = 0; i < nsamples; i++, src += bypsamp)
+    {
+      switch (bpsamp)
+        {
+          case 8:
+            dst[i] = (int16_t)((src[0] - 128) << 8);
+            break;
+
+          default:
+
+            /* Keep the two most significant bytes */
+
+            dst[i] = (int16_t)(src[bypsamp - 1] << 8 | src[bypsamp - 2]);
+            break;
+        }
+    }
+
+  if (nchannels == 1)
+    {
+      FAR int16_t *mono = dst;
+
+      dst -= nframes;
+      for (i = 0; i < nframes; i++)
+        {
+          int16_t sample = mono[i];
+
+          dst[2 * i]     = sample;
+          dst[2 * i + 1] = sample;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_src_init
+ *
+ * Description:
+ *   Set a sample rate converter up from 'inrate' to 'outrate'.
+ *
+ ****************************************************************************/
+
+void audio_src_init(FAR struct audio_src_s *src, uint32_t inrate,
+                    uint32_t outrate, uint8_t nchannels)
+{
+  memset(src, 0, sizeof(*src));
+  src->step      = (uint32_t)(((uint64_t)inrate * AUDIO_SRC_ONE) / outrate);
+  src->pos       = AUDIO_SRC_ONE;
+  src->nchannels = nchannels;
+}
+
+/****************************************************************************
+ * Name: audio_src_process
+ *
+ * Description:
+ *   Convert input frames to at most 'nout' output frames.
+ *
+ ****************************************************************************/
+
+size_t audio_src_process(FAR struct audio_src_s *src, FAR int16_t *out,
+                         size_t nout, FAR const int16_t *in,
+                         FAR size_t *nin)
+{
+  FAR const int16_t *coef;
+  size_t used = 0;
+  size_t done = 0;
+  int ch;
+
+  while (done < nout)
+    {
+      /* Shift the input samples in until the output falls between the two
+       * samples in the middle of the history.
+       */
+
+      while (src->pos >= AUDIO_SRC_ONE)
+        {
+          if (used >= *nin)
+            {
+              goto out;
+            }
+
+          for (ch = 0; ch < src->nchannels; ch++)
+            {
+              memmove(&src->hist[ch][0], &src->hist[ch][1],
+                      (AUDIO_SRC_NTAPS - 1) * sizeof(int16_t));
+              src->hist[ch][AUDIO_SRC_NTAPS - 1] =
+                in[used * src->nchannels + ch];
+            }
+
+          src->pos -= AUDIO_SRC_ONE;
+          used++;
+        }
+
+      coef = g_audio_src_coef[AUDIO_SRC_PHASE(src->pos)];
+      for (ch = 0; ch < src->nchannels; ch++)
+        {
+          *out++ = audio_dsp_fir(src->hist[ch], coef);
+        }
+
+      src->pos += src->step;
+      done++;
+    }
+
+out:
+  *nin = used;
+  return done;
+}
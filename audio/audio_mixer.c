@@ -0,0 +1,924 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <debug.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_LPWORK)
+#  define AUDIO_MIXER_WORK        LPWORK
+#elif defined(CONFIG_SCHED_HPWORK)
+#  define AUDIO_MIXER_WORK        HPWORK
+#else
+#  error Work queue support is required
+#endif
+
+/* The mixed output: 16-bit stereo frames */
+
+#define AUDIO_MIXER_FRAMEBYTES    4
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct audio_mixer_s;
+
+/* This structure describes the state of one input stream of the mixer */
+
+struct audio_mixer_stream_s
+{
+  /* This is our appearance to the outside world.  This *MUST* be the first
+   * element of the structure so that we can freely cast between types
+   * struct audio_lowerhalf and struct audio_mixer_stream_s.
+   */
+
+  struct audio_lowerhalf_s export;
+
+  FAR struct audio_mixer_s *mixer;
+  struct dq_queue_s pendq;         /* Buffers waiting to be mixed */
+  struct audio_src_s src;          /* Rate conversion to the output */
+  uint32_t samprate;               /* 8000, 44100, ... */
+  uint8_t  bpsamp;                 /* Bits per sample: 8, 16, 24 or 32 */
+  uint8_t  nchannels;              /* Mono=1, Stereo=2 */
+  int16_t  gain;                   /* Q15 volume */
+  bool     active;                 /* Started and not completed */
+  bool     paused;                 /* Paused, mixed as silence */
+};
+
+/* This structure describes the state of the mixer */
+
+struct audio_mixer_s
+{
+  FAR struct audio_lowerhalf_s *lower;
+  mutex_t lock;                    /* Protects the streams */
+  struct work_s work;              /* Mixes the buffers of the lower */
+  struct dq_queue_s freeq;         /* Buffers the lower gave back */
+  apb_samp_t bufsize;              /* Size of the output buffers */
+  uint8_t  nbuffers;               /* Number of the output buffers */
+  bool     running;                /* The lower is started */
+  int      nstreams;
+
+  /* The input of a stream converted to 16-bit stereo, then resampled */
+
+  int16_t  conv[2 * CONFIG_AUDIO_MIXER_NFRAMES];
+  int16_t  rsmp[2 * CONFIG_AUDIO_MIXER_NFRAMES];
+
+  struct audio_mixer_stream_s streams[1];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR void *session,
+                                 FAR const struct audio_caps_s *caps);
+#else
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps);
+#endif
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session);
+#else
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session);
+#else
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                              FAR void *session);
+#else
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb);
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                               FAR void **session);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session);
+#else
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev);
+#endif
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status, FAR void *session);
+#else
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_audio_mixer_ops =
+{
+  audio_mixer_getcaps,       /* getcaps        */
+  audio_mixer_configure,     /* configure      */
+  audio_mixer_shutdown,      /* shutdown       */
+  audio_mixer_start,         /* start          */
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  audio_mixer_stop,          /* stop           */
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  audio_mixer_pause,         /* pause          */
+  audio_mixer_resume,        /* resume         */
+#endif
+  NULL,                      /* allocbuffer    */
+  NULL,                      /* freebuffer     */
+  audio_mixer_enqueuebuffer, /* enqueue_buffer */
+  NULL,                      /* cancel_buffer  */
+  audio_mixer_ioctl,         /* ioctl          */
+  NULL,                      /* read           */
+  NULL,                      /* write          */
+  audio_mixer_reserve,       /* reserve        */
+  audio_mixer_release        /* release        */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_upper
+ *
+ * Description: Call the upper half of a stream back.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_upper(FAR struct audio_mixer_stream_s *stream,
+                              uint16_t reason, FAR struct ap_buffer_s *apb)
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  stream->export.upper(stream->export.priv, reason, apb, OK, NULL);
+#else
+  stream->export.upper(stream->export.priv, reason, apb, OK);
+#endif
+}
+
+/****************************************************************************
+ * Name: audio_mixer_dequeue
+ *
+ * Description:
+ *   Give a mixed buffer back to the upper half of its stream, and complete
+ *   the stream if it was the last one.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_dequeue(FAR struct audio_mixer_stream_s *stream,
+                                FAR struct ap_buffer_s *apb)
+{
+  bool final = (apb->flags & AUDIO_APB_FINAL) != 0;
+
+  dq_rem(&apb->dq_entry, &stream->pendq);
+  audio_mixer_upper(stream, AUDIO_CALLBACK_DEQUEUE, apb);
+
+  if (final)
+    {
+      stream->active = false;
+      audio_mixer_upper(stream, AUDIO_CALLBACK_COMPLETE, NULL);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_flush
+ *
+ * Description: Give all the buffers of a stream back and complete it.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_flush(FAR struct audio_mixer_stream_s *stream)
+{
+  FAR struct ap_buffer_s *apb;
+
+  while ((apb = (FAR struct ap_buffer_s *)dq_peek(&stream->pendq)) != NULL)
+    {
+      dq_rem(&apb->dq_entry, &stream->pendq);
+      audio_mixer_upper(stream, AUDIO_CALLBACK_DEQUEUE, apb);
+    }
+
+  if (stream->active)
+    {
+      stream->active = false;
+      audio_mixer_upper(stream, AUDIO_CALLBACK_COMPLETE, NULL);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stream
+ *
+ * Description:
+ *   Mix up to 'nframes' output frames of a stream into 'out'.  The input
+ *   is converted and resampled in chunks of CONFIG_AUDIO_MIXER_NFRAMES,
+ *   the frames a stream is short of are left as they are, i.e. silent.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_stream(FAR struct audio_mixer_s *mixer,
+                               FAR struct audio_mixer_stream_s *stream,
+                               FAR int16_t *out, size_t nframes)
+{
+  FAR struct ap_buffer_s *apb;
+  FAR const int16_t *frames;
+  size_t framebytes = stream->nchannels * stream->bpsamp / 8;
+  size_t done = 0;
+  size_t avail;
+  size_t used;
+  size_t n;
+
+  while (done < nframes && stream->active && !stream->paused)
+    {
+      apb = (FAR struct ap_buffer_s *)dq_peek(&stream->pendq);
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      avail = (apb->nbytes - apb->curbyte) / framebytes;
+      if (apb->curbyte >= apb->nbytes || avail == 0)
+        {
+          audio_mixer_dequeue(stream, apb);
+          continue;
+        }
+
+      used = MIN(avail, CONFIG_AUDIO_MIXER_NFRAMES);
+      n    = MIN(nframes - done, CONFIG_AUDIO_MIXER_NFRAMES);
+
+      audio_dsp_convert(mixer->conv, &apb->samp[apb->curbyte],
+                        stream->bpsamp, stream->nchannels, used);
+
+      if (stream->samprate == CONFIG_AUDIO_MIXER_SAMPRATE)
+        {
+          n      = MIN(n, used);
+          used   = n;
+          frames = mixer->conv;
+        }
+      else
+        {
+          n      = audio_src_process(&stream->src, mixer->rsmp, n,
+                                     mixer->conv, &used);
+          frames = mixer->rsmp;
+        }
+
+      audio_dsp_mix(&out[2 * done], frames, 2 * n, stream->gain);
+
+      done         += n;
+      apb->curbyte += used * framebytes;
+      if (apb->nbytes - apb->curbyte < framebytes)
+        {
+          audio_mixer_dequeue(stream, apb);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_worker
+ *
+ * Description:
+ *   Mix the streams into every buffer the lower half gave back, and hand
+ *   them to it again.  Stop the lower half once no stream is active.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_worker(FAR void *arg)
+{
+  FAR struct audio_mixer_s *mixer = arg;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  bool active = false;
+  int ret;
+  int i;
+
+  nxmutex_lock(&mixer->lock);
+
+  for (i = 0; i < mixer->nstreams; i++)
+    {
+      active |= mixer->streams[i].active;
+    }
+
+  if (!active)
+    {
+      if (mixer->running)
+        {
+          mixer->running = false;
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+          lower->ops->stop(lower, NULL);
+#else
+          lower->ops->stop(lower);
+#endif
+#endif
+        }
+
+      nxmutex_unlock(&mixer->lock);
+      return;
+    }
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&mixer->freeq);
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      memset(apb->samp, 0, mixer->bufsize);
+      for (i = 0; i < mixer->nstreams; i++)
+        {
+          audio_mixer_stream(mixer, &mixer->streams[i],
+                             (FAR int16_t *)apb->samp,
+                             mixer->bufsize / AUDIO_MIXER_FRAMEBYTES);
+        }
+
+      apb->nbytes  = mixer->bufsize;
+      apb->curbyte = 0;
+      apb->flags  &= ~AUDIO_APB_FINAL;
+
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          auderr("ERROR: enqueuebuffer failed: %d\n", ret);
+
+          flags = enter_critical_section();
+          dq_addfirst(&apb->dq_entry, &mixer->freeq);
+          leave_critical_section(flags);
+          break;
+        }
+    }
+
+  if (!mixer->running)
+    {
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      ret = lower->ops->start(lower, NULL);
+#else
+      ret = lower->ops->start(lower);
+#endif
+      mixer->running = ret >= 0;
+    }
+
+  nxmutex_unlock(&mixer->lock);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_prepare
+ *
+ * Description:
+ *   Configure the lower half for the mixed output and allocate its
+ *   buffers the first time.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_prepare(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  struct ap_buffer_info_s bufinfo;
+  struct audio_buf_desc_s desc;
+  struct audio_caps_s caps;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  memset(&caps, 0, sizeof(caps));
+  caps.ac_len            = sizeof(struct audio_caps_s);
+  caps.ac_type           = AUDIO_TYPE_OUTPUT;
+  caps.ac_channels       = 2;
+  caps.ac_controls.hw[0] = CONFIG_AUDIO_MIXER_SAMPRATE;
+  caps.ac_controls.b[2]  = 16;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->configure(lower, NULL, &caps);
+#else
+  ret = lower->ops->configure(lower, &caps);
+#endif
+  if (ret < 0)
+    {
+      auderr("ERROR: Failed to configure the output: %d\n", ret);
+      return ret;
+    }
+
+  if (mixer->nbuffers > 0)
+    {
+      return OK;
+    }
+
+  bufinfo.nbuffers    = CONFIG_AUDIO_NUM_BUFFERS;
+  bufinfo.buffer_size = CONFIG_AUDIO_BUFFER_NUMBYTES;
+  if (lower->ops->ioctl != NULL)
+    {
+      lower->ops->ioctl(lower, AUDIOIOC_GETBUFFERINFO,
+                        (unsigned long)((uintptr_t)&bufinfo));
+    }
+
+  mixer->bufsize = bufinfo.buffer_size & ~(AUDIO_MIXER_FRAMEBYTES - 1);
+
+  for (i = 0; i < bufinfo.nbuffers; i++)
+    {
+      memset(&desc, 0, sizeof(desc));
+      desc.numbytes  = bufinfo.buffer_size;
+      desc.u.pbuffer = &apb;
+
+      if (lower->ops->allocbuffer != NULL)
+        {
+          ret = lower->ops->allocbuffer(lower, &desc);
+        }
+      else
+        {
+          ret = apb_alloc(&desc);
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      flags = enter_critical_section();
+      dq_addlast(&apb->dq_entry, &mixer->freeq);
+      leave_critical_section(flags);
+      mixer->nbuffers++;
+    }
+
+  return mixer->nbuffers > 0 ? OK : -ENOMEM;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_getcaps
+ *
+ * Description: Get the audio device capabilities
+ *
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps)
+{
+  DEBUGASSERT(caps && caps->ac_len >= sizeof(struct audio_caps_s));
+
+  caps->ac_format.hw  = 0;
+  caps->ac_controls.w = 0;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_QUERY:
+        caps->ac_channels = 2;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.b[0] = AUDIO_TYPE_OUTPUT | AUDIO_TYPE_FEATURE;
+            caps->ac_format.hw     = 1 << (AUDIO_FMT_PCM - 1);
+          }
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        caps->ac_channels = 2;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.hw[0] = AUDIO_SAMP_RATE_DEF_ALL;
+          }
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_subtype == AUDIO_FU_UNDEF)
+          {
+            caps->ac_controls.b[0] = AUDIO_FU_VOLUME;
+          }
+        break;
+
+      default:
+        caps->ac_subtype  = 0;
+        caps->ac_channels = 0;
+        break;
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_configure
+ *
+ * Description:
+ *   Configure the format of a stream, or its volume.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR void *session,
+                                 FAR const struct audio_caps_s *caps)
+#else
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  int ret = -ENOTTY;
+
+  nxmutex_lock(&mixer->lock);
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_FEATURE:
+#ifndef CONFIG_AUDIO_EXCLUDE_VOLUME
+        if (caps->ac_format.hw == AUDIO_FU_VOLUME)
+          {
+            uint16_t volume = caps->ac_controls.hw[0];
+
+            if (volume <= 1000)
+              {
+                stream->gain = (int32_t)AUDIO_GAIN_UNITY * volume / 1000;
+                ret = OK;
+              }
+            else
+              {
+                ret = -EDOM;
+              }
+          }
+#endif
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+        if ((caps->ac_channels != 1 && caps->ac_channels != 2) ||
+            caps->ac_controls.hw[0] == 0 ||
+            (caps->ac_controls.b[2] != 8 && caps->ac_controls.b[2] != 16 &&
+             caps->ac_controls.b[2] != 24 && caps->ac_controls.b[2] != 32))
+          {
+            ret = -ERANGE;
+            break;
+          }
+
+        stream->nchannels = caps->ac_channels;
+        stream->samprate  = caps->ac_controls.hw[0];
+        stream->bpsamp    = caps->ac_controls.b[2];
+        audio_src_init(&stream->src, stream->samprate,
+                       CONFIG_AUDIO_MIXER_SAMPRATE, 2);
+        ret = OK;
+        break;
+
+      default:
+        break;
+    }
+
+  nxmutex_unlock(&mixer->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_shutdown
+ *
+ * Description: Stop a stream and give its buffers back.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+
+  nxmutex_lock(&mixer->lock);
+  audio_mixer_flush(stream);
+  nxmutex_unlock(&mixer->lock);
+
+  work_queue(AUDIO_MIXER_WORK, &mixer->work, audio_mixer_worker, mixer, 0);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_start
+ *
+ * Description:
+ *   Start mixing a stream, and start the output if it is the first one.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session)
+#else
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+  int ret = OK;
+
+  nxmutex_lock(&mixer->lock);
+
+  if (!mixer->running)
+    {
+      ret = audio_mixer_prepare(mixer);
+    }
+
+  if (ret >= 0)
+    {
+      stream->active = true;
+      stream->paused = false;
+    }
+
+  nxmutex_unlock(&mixer->lock);
+
+  if (ret >= 0)
+    {
+      work_queue(AUDIO_MIXER_WORK, &mixer->work, audio_mixer_worker,
+                 mixer, 0);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stop
+ *
+ * Description: Stop a stream, the output goes on for the others.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session)
+#else
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  return audio_mixer_shutdown(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_pause
+ *
+ * Description: Pause a stream, it is mixed as silence meanwhile.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session)
+#else
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  stream->paused = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_resume
+ *
+ * Description: Resume a paused stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                              FAR void *session)
+#else
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+
+  stream->paused = false;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_enqueuebuffer
+ *
+ * Description: Queue a buffer of a stream to be mixed.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_stream_s *stream =
+    (FAR struct audio_mixer_stream_s *)dev;
+  FAR struct audio_mixer_s *mixer = stream->mixer;
+
+  nxmutex_lock(&mixer->lock);
+  apb->flags |= AUDIO_APB_OUTPUT_ENQUEUED;
+  dq_addlast(&apb->dq_entry, &stream->pendq);
+  nxmutex_unlock(&mixer->lock);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_ioctl
+ *
+ * Description: Perform a device ioctl
+ *
+ ****************************************************************************/
+
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg)
+{
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_reserve
+ *
+ * Description: Reserve a session, there is one per stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                               FAR void **session)
+#else
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_release
+ *
+ * Description: Release a session.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session)
+#else
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_callback
+ *
+ * Description:
+ *   The lower half gave a buffer back, possibly from its interrupt
+ *   handler: mix the next one on the work queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status, FAR void *session)
+#else
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status)
+#endif
+{
+  FAR struct audio_mixer_s *mixer = arg;
+  irqstate_t flags;
+
+  if (reason == AUDIO_CALLBACK_DEQUEUE && apb != NULL)
+    {
+      flags = enter_critical_section();
+      dq_addlast(&apb->dq_entry, &mixer->freeq);
+      leave_critical_section(flags);
+
+      if (work_available(&mixer->work))
+        {
+          work_queue(AUDIO_MIXER_WORK, &mixer->work, audio_mixer_worker,
+                     mixer, 0);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Create a mixer of 'nstreams' streams over a lower half output device.
+ *
+ * Input Parameters:
+ *   lower    - The output device
+ *   nstreams - The number of streams
+ *   streams  - Receives the lower half of each stream
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR struct audio_lowerhalf_s *lower,
+                           int nstreams,
+                           FAR struct audio_lowerhalf_s **streams)
+{
+  FAR struct audio_mixer_s *mixer;
+  FAR struct audio_mixer_stream_s *stream;
+  int i;
+
+  if (lower == NULL || nstreams < 1 || streams == NULL)
+    {
+      return -EINVAL;
+    }
+
+  mixer = kmm_zalloc(sizeof(struct audio_mixer_s) +
+                     (nstreams - 1) * sizeof(struct audio_mixer_stream_s));
+  if (mixer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&mixer->lock);
+  dq_init(&mixer->freeq);
+  mixer->lower    = lower;
+  mixer->nstreams = nstreams;
+
+  lower->upper = audio_mixer_callback;
+  lower->priv  = mixer;
+
+  for (i = 0; i < nstreams; i++)
+    {
+      stream             = &mixer->streams[i];
+      stream->export.ops = &g_audio_mixer_ops;
+      stream->mixer      = mixer;
+      stream->samprate   = CONFIG_AUDIO_MIXER_SAMPRATE;
+      stream->bpsamp     = 16;
+      stream->nchannels  = 2;
+      stream->gain       = AUDIO_GAIN_UNITY;
+      dq_init(&stream->pendq);
+
+      streams[i] = &stream->export;
+    }
+
+  return OK;
+}
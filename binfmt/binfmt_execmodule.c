@@ -34,7 +34,6 @@
 
 #include <nuttx/addrenv.h>
 #include <nuttx/arch.h>
-#include <nuttx/kmalloc.h>
 #include <nuttx/sched.h>
 #include <nuttx/spawn.h>
 #include <nuttx/binfmt/binfmt.h>
@@ -140,7 +139,8 @@ int exec_module(FAR struct binary_s *binp,
 
   /* Allocate a TCB for the new task. */
 
-  tcb = kmm_zalloc(sizeof(struct task_tcb_s));
+  tcb = (FAR struct task_tcb_s *)
+        nxsched_alloc_tcb(TCB_FLAG_TTYPE_TASK, binp->stacksize);
   if (!tcb)
     {
       return -ENOMEM;
@@ -329,7 +329,7 @@ errout_with_envp:
 errout_with_args:
   binfmt_freeargv(argv);
 errout_with_tcb:
-  kmm_free(tcb);
+  nxsched_free_tcb(&tcb->cmn, TCB_FLAG_TTYPE_TASK);
   return ret;
 }
 
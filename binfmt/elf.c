@@ -242,6 +242,16 @@ static int elf_loadbinary(FAR struct binary_s *binp,
 
   binfo("Loading file: %s\n", filename);
 
+#ifdef CONFIG_ELF_SHARETEXT
+  /* Start a new instance of the program if it is already loaded */
+
+  ret = elf_sharetext_load(binp, filename, exports, nexports);
+  if (ret != -ENOENT)
+    {
+      return ret;
+    }
+#endif
+
   /* Initialize the ELF library to load the program binary. */
 
   ret = elf_init(filename, &loadinfo);
@@ -344,6 +354,13 @@ static int elf_loadbinary(FAR struct binary_s *binp,
 #endif
 
   elf_dumpentrypt(binp, &loadinfo);
+
+#ifdef CONFIG_ELF_SHARETEXT
+  /* Keep the loaded program so that later instances can share its .text */
+
+  elf_sharetext_add(binp, filename, exports, nexports, &loadinfo);
+#endif
+
   elf_uninit(&loadinfo);
   return OK;
 
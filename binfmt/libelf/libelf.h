@@ -25,8 +25,27 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/binfmt/binfmt.h>
 #include <nuttx/binfmt/elf.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The initial heap size of an ELF program.  It is ignored if there is no
+ * address environment because the heap is a shared resource in that case.
+ * If there is no dynamic stack then it must at least as big as the fixed
+ * stack size since the stack will be allocated from the heap in that case.
+ */
+
+#if !defined(CONFIG_ARCH_ADDRENV)
+#  define ELF_HEAPSIZE 0
+#elif defined(CONFIG_ARCH_STACK_DYNAMIC)
+#  define ELF_HEAPSIZE ARCH_HEAP_SIZE
+#else
+#  define ELF_HEAPSIZE MAX(ARCH_HEAP_SIZE, CONFIG_ELF_STACKSIZE)
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -340,4 +359,57 @@ int elf_addrenv_restore(FAR struct elf_loadinfo_s *loadinfo);
 
 void elf_addrenv_free(FAR struct elf_loadinfo_s *loadinfo);
 
+/****************************************************************************
+ * Name: elf_sharetext_load
+ *
+ * Description:
+ *   Create a new instance of a program that is in the shared text cache.
+ *   The new instance maps the .text pages of the cached copy and gets a
+ *   private copy of its initialized .data/.bss.
+ *
+ * Input Parameters:
+ *   binp     - The binary to initialize
+ *   filename - The full path to the ELF file
+ *   exports  - The symbol table the program was bound to
+ *   nexports - The number of symbols in 'exports'
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  -ENOENT if the program is not in the cache or
+ *   the file has changed since it was cached; another negated errno value
+ *   on any other failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_SHARETEXT
+int elf_sharetext_load(FAR struct binary_s *binp, FAR const char *filename,
+                       FAR const struct symtab_s *exports, int nexports);
+#endif
+
+/****************************************************************************
+ * Name: elf_sharetext_add
+ *
+ * Description:
+ *   Add a program that has just been loaded to the shared text cache.  The
+ *   address environment of 'binp' becomes the cached copy, which is never
+ *   run, and 'binp' receives a new instance made from it.  On failure
+ *   'binp' is left as it was and the program is simply not cached.
+ *
+ * Input Parameters:
+ *   binp     - The binary that was loaded
+ *   filename - The full path to the ELF file
+ *   exports  - The symbol table the program was bound to
+ *   nexports - The number of symbols in 'exports'
+ *   loadinfo - The load information of the program
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_SHARETEXT
+void elf_sharetext_add(FAR struct binary_s *binp, FAR const char *filename,
+                       FAR const struct symtab_s *exports, int nexports,
+                       FAR const struct elf_loadinfo_s *loadinfo);
+#endif
+
 #endif /* __BINFMT_LIBELF_LIBELF_H */
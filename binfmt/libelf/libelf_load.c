@@ -310,20 +310,7 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
 
 int elf_load(FAR struct elf_loadinfo_s *loadinfo)
 {
-  /* Determine the heapsize to allocate.  heapsize is ignored if there is
-   * no address environment because the heap is a shared resource in that
-   * case.  If there is no dynamic stack then heapsize must at least as big
-   * as the fixed stack size since the stack will be allocated from the heap
-   * in that case.
-   */
-
-#if !defined(CONFIG_ARCH_ADDRENV)
-  size_t heapsize = 0;
-#elif defined(CONFIG_ARCH_STACK_DYNAMIC)
-  size_t heapsize = ARCH_HEAP_SIZE;
-#else
-  size_t heapsize = MAX(ARCH_HEAP_SIZE, CONFIG_ELF_STACKSIZE);
-#endif
+  size_t heapsize = ELF_HEAPSIZE;
 #ifdef CONFIG_ELF_EXIDX_SECTNAME
   int exidx;
 #endif
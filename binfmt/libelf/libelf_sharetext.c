@@ -0,0 +1,371 @@
+/****************************************************************************
+ * binfmt/libelf/libelf_sharetext.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/addrenv.h>
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/pgalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/lib/lib.h>
+
+#include "libelf.h"
+
+#ifdef CONFIG_ELF_SHARETEXT
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached program.  'bin' holds what elf_loadbinary() returned for the
+ * program; its address environment is never run, so that its .data/.bss
+ * keep their initial contents and can be copied into each new instance.
+ */
+
+struct elf_sharetext_s
+{
+  FAR struct elf_sharetext_s *flink;  /* Next entry, most recently used first */
+  FAR char *filename;                 /* The full path to the ELF file */
+  off_t filesize;                     /* File size when it was cached */
+  struct timespec filemtime;          /* File mtime when it was cached */
+  FAR const struct symtab_s *exports; /* Symbol table it was bound to */
+  int nexports;                       /* Number of symbols in 'exports' */
+  size_t textsize;                    /* Size of the .text region */
+  size_t datasize;                    /* Size of the .data/.bss region */
+  struct binary_s bin;                /* The cached copy */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct elf_sharetext_s *g_sharetext;
+static mutex_t g_sharetext_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_sharetext_free
+ *
+ * Description:
+ *   Release a cache entry.  The cached address environment lives on until
+ *   the last instance that shares its .text has exited.
+ *
+ ****************************************************************************/
+
+static void elf_sharetext_free(FAR struct elf_sharetext_s *entry)
+{
+  addrenv_drop(entry->bin.addrenv, false);
+  lib_free(entry->filename);
+  kmm_free(entry);
+}
+
+/****************************************************************************
+ * Name: elf_sharetext_instance
+ *
+ * Description:
+ *   Create a new instance of a cached program in 'binp'.  Called with
+ *   g_sharetext_lock held.
+ *
+ ****************************************************************************/
+
+static int elf_sharetext_instance(FAR struct elf_sharetext_s *entry,
+                                  FAR struct binary_s *binp)
+{
+  FAR addrenv_t *tmpl = entry->bin.addrenv;
+  FAR addrenv_t *addrenv;
+  FAR void *vdata;
+  uintptr_t vaddr;
+  uintptr_t src;
+  uintptr_t dest;
+  size_t npages;
+  size_t i;
+  int ret;
+
+  addrenv = addrenv_allocate();
+  if (addrenv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = up_addrenv_create(entry->textsize, entry->datasize, ELF_HEAPSIZE,
+                          &addrenv->addrenv);
+  if (ret < 0)
+    {
+      berr("ERROR: up_addrenv_create failed: %d\n", ret);
+      goto errout_with_addrenv;
+    }
+
+  /* Map the cached .text.  The cached copy must outlive the new address
+   * environment, which releases it when it is destroyed.
+   */
+
+  addrenv_take(tmpl);
+  addrenv->textenv = tmpl;
+
+  ret = up_addrenv_share_text(&tmpl->addrenv, &addrenv->addrenv,
+                              entry->textsize);
+  if (ret < 0)
+    {
+      berr("ERROR: up_addrenv_share_text failed: %d\n", ret);
+      goto errout_with_addrenv;
+    }
+
+  /* Copy the initialized .data/.bss page by page */
+
+  ret = up_addrenv_vdata(&addrenv->addrenv, entry->textsize, &vdata);
+  if (ret < 0)
+    {
+      berr("ERROR: up_addrenv_vdata failed: %d\n", ret);
+      goto errout_with_addrenv;
+    }
+
+  npages = MM_NPAGES(entry->datasize);
+  vaddr  = (uintptr_t)vdata;
+
+  for (i = 0; i < npages; i++, vaddr += MM_PGSIZE)
+    {
+      src  = up_addrenv_find_page(&tmpl->addrenv, vaddr);
+      dest = up_addrenv_find_page(&addrenv->addrenv, vaddr);
+      if (src == 0 || dest == 0)
+        {
+          ret = -EFAULT;
+          goto errout_with_addrenv;
+        }
+
+      memcpy((FAR void *)up_addrenv_page_vaddr(dest),
+             (FAR const void *)up_addrenv_page_vaddr(src), MM_PGSIZE);
+    }
+
+  ret = up_addrenv_coherent(&addrenv->addrenv);
+  if (ret < 0)
+    {
+      berr("ERROR: up_addrenv_coherent failed: %d\n", ret);
+      goto errout_with_addrenv;
+    }
+
+  binp->entrypt   = entry->bin.entrypt;
+  binp->stacksize = entry->bin.stacksize;
+  binp->addrenv   = addrenv;
+
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+  binp->ctors     = entry->bin.ctors;
+  binp->nctors    = entry->bin.nctors;
+  binp->dtors     = entry->bin.dtors;
+  binp->ndtors    = entry->bin.ndtors;
+#endif
+
+#ifdef CONFIG_SCHED_USER_IDENTITY
+  binp->uid       = entry->bin.uid;
+  binp->gid       = entry->bin.gid;
+  binp->mode      = entry->bin.mode;
+#endif
+
+  return OK;
+
+errout_with_addrenv:
+  addrenv_drop(addrenv, false);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_sharetext_load
+ *
+ * Description:
+ *   Create a new instance of a program that is in the shared text cache.
+ *
+ ****************************************************************************/
+
+int elf_sharetext_load(FAR struct binary_s *binp, FAR const char *filename,
+                       FAR const struct symtab_s *exports, int nexports)
+{
+  FAR struct elf_sharetext_s *entry;
+  FAR struct elf_sharetext_s *prev = NULL;
+  struct stat buf;
+  int ret;
+
+  ret = nx_stat(filename, &buf, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nxmutex_lock(&g_sharetext_lock);
+
+  for (entry = g_sharetext; entry != NULL; entry = entry->flink)
+    {
+      if (strcmp(entry->filename, filename) == 0 &&
+          entry->exports == exports && entry->nexports == nexports)
+        {
+          break;
+        }
+
+      prev = entry;
+    }
+
+  if (entry == NULL)
+    {
+      ret = -ENOENT;
+      goto out;
+    }
+
+  /* Unlink the entry; it goes back at the head if it is still valid */
+
+  if (prev != NULL)
+    {
+      prev->flink = entry->flink;
+    }
+  else
+    {
+      g_sharetext = entry->flink;
+    }
+
+  if (entry->filesize != buf.st_size ||
+      entry->filemtime.tv_sec != buf.st_mtim.tv_sec ||
+      entry->filemtime.tv_nsec != buf.st_mtim.tv_nsec)
+    {
+      binfo("%s has changed, dropping it from the cache\n", filename);
+      elf_sharetext_free(entry);
+      ret = -ENOENT;
+      goto out;
+    }
+
+  entry->flink = g_sharetext;
+  g_sharetext  = entry;
+
+  binfo("Sharing the text of %s\n", filename);
+  ret = elf_sharetext_instance(entry, binp);
+
+out:
+  nxmutex_unlock(&g_sharetext_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: elf_sharetext_add
+ *
+ * Description:
+ *   Add a program that has just been loaded to the shared text cache.
+ *
+ ****************************************************************************/
+
+void elf_sharetext_add(FAR struct binary_s *binp, FAR const char *filename,
+                       FAR const struct symtab_s *exports, int nexports,
+                       FAR const struct elf_loadinfo_s *loadinfo)
+{
+  FAR struct elf_sharetext_s *entry;
+  FAR struct elf_sharetext_s *prev;
+  struct stat buf;
+  int count;
+  int ret;
+
+  /* Constructor tables copied out of the file are allocated outside of the
+   * address environment and cannot be shared.
+   */
+
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+  if (loadinfo->ctoralloc != NULL || loadinfo->dtoralloc != NULL)
+    {
+      return;
+    }
+#endif
+
+  if (nx_stat(filename, &buf, 1) < 0)
+    {
+      return;
+    }
+
+  entry = kmm_zalloc(sizeof(struct elf_sharetext_s));
+  if (entry == NULL)
+    {
+      return;
+    }
+
+  entry->filename = strdup(filename);
+  if (entry->filename == NULL)
+    {
+      kmm_free(entry);
+      return;
+    }
+
+  entry->filesize  = buf.st_size;
+  entry->filemtime = buf.st_mtim;
+  entry->exports   = exports;
+  entry->nexports  = nexports;
+  entry->textsize  = loadinfo->textsize;
+  entry->datasize  = loadinfo->datasize;
+  entry->bin       = *binp;
+
+  nxmutex_lock(&g_sharetext_lock);
+
+  ret = elf_sharetext_instance(entry, binp);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_sharetext_lock);
+      berr("ERROR: Failed to cache %s: %d\n", filename, ret);
+
+      /* 'binp' still owns the address environment */
+
+      lib_free(entry->filename);
+      kmm_free(entry);
+      return;
+    }
+
+  entry->flink = g_sharetext;
+  g_sharetext  = entry;
+
+  /* Evict the least recently used entries beyond the limit */
+
+  for (prev = entry, count = 1; prev->flink != NULL; count++)
+    {
+      if (count < CONFIG_ELF_SHARETEXT_NENTRIES)
+        {
+          prev = prev->flink;
+        }
+      else
+        {
+          entry       = prev->flink;
+          prev->flink = entry->flink;
+          elf_sharetext_free(entry);
+        }
+    }
+
+  nxmutex_unlock(&g_sharetext_lock);
+}
+
+#endif /* CONFIG_ELF_SHARETEXT */
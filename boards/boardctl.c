@@ -31,6 +31,7 @@
 #include <assert.h>
 
 #include <nuttx/board.h>
+#include <nuttx/init.h>
 #include <nuttx/lib/modlib.h>
 #include <nuttx/binfmt/symtab.h>
 #include <nuttx/drivers/ramdisk.h>
@@ -366,7 +367,9 @@ int boardctl(unsigned int cmd, uintptr_t arg)
 
       case BOARDIOC_INIT:
         {
+          boottime_begin("board_app_initialize");
           ret = board_app_initialize(arg);
+          boottime_end("board_app_initialize");
         }
         break;
 
@@ -159,7 +159,7 @@ int sim_bringup(void)
 #ifdef CONFIG_RAMMTD
   /* Create a RAM MTD device if configured */
 
-  ramstart = kmm_malloc(128 * 1024);
+  ramstart = kmm_malloc(CONFIG_SIM_RAMMTD_SIZE);
   if (ramstart == NULL)
     {
       syslog(LOG_ERR, "ERROR: Allocation for RAM MTD failed\n");
@@ -168,7 +168,8 @@ int sim_bringup(void)
     {
       /* Initialized the RAM MTD */
 
-      struct mtd_dev_s *mtd = rammtd_initialize(ramstart, 128 * 1024);
+      struct mtd_dev_s *mtd = rammtd_initialize(ramstart,
+                                                CONFIG_SIM_RAMMTD_SIZE);
       if (mtd == NULL)
         {
           syslog(LOG_ERR, "ERROR: rammtd_initialize failed\n");
@@ -125,7 +125,8 @@ endfunction()
 #
 # Parameters: - NAME: determines the name of target (cromfs_${NAME}) - PATH: the
 # directory that will be used to create the CROMFS - FILES: paths to files to
-# copy into CROMFS - DEPENDS: list of targets that should be depended on
+# copy into CROMFS - DEPENDS: list of targets that should be depended on -
+# OPTIONS: gencromfs options, e.g. -z lz4 -b 4096
 
 function(nuttx_add_cromfs)
   nuttx_parse_function_args(
@@ -155,7 +156,8 @@ function(nuttx_add_cromfs)
             copy_directory ${PATH} cromfs_${NAME} \; fi
     COMMAND if \[ \"${FILES}\" != \"\" \]; then ${CMAKE_COMMAND} -E copy
             ${FILES} cromfs_${NAME} \; fi
-    COMMAND ${CMAKE_BINARY_DIR}/bin/gencromfs cromfs_${NAME} cromfs_${NAME}.c
+    COMMAND ${CMAKE_BINARY_DIR}/bin/gencromfs ${OPTIONS} cromfs_${NAME}
+            cromfs_${NAME}.c
     DEPENDS ${DEPENDS})
 
   add_library(cromfs_${NAME} OBJECT cromfs_${NAME}.c)
@@ -0,0 +1,88 @@
+/****************************************************************************
+ * crypto/accel.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __CRYPTO_ACCEL_H
+#define __CRYPTO_ACCEL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <crypto/gmac.h>
+
+#ifdef CONFIG_CRYPTO_ACCEL
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The AES instructions of the CPU.  The round keys are the FIPS-197 ones,
+ * round key r at rk[4 * r] in the byte order of the state, which is what
+ * aes_keysched_base() gives on a little-endian CPU.  The decryption
+ * schedule is the one of the equivalent inverse cipher, made by invkey()
+ * from the encryption schedule.
+ */
+
+struct aes_accel_s
+{
+  CODE void (*invkey)(FAR uint32_t *dk, FAR const uint32_t *ek, int nr);
+  CODE void (*encrypt)(FAR const uint32_t *rk, int nr,
+                       FAR const uint8_t *src, FAR uint8_t *dst,
+                       size_t nblocks);
+  CODE void (*decrypt)(FAR const uint32_t *dk, int nr,
+                       FAR const uint8_t *src, FAR uint8_t *dst,
+                       size_t nblocks);
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The AES instructions, NULL for the constant time C implementation */
+
+extern FAR const struct aes_accel_s *aes_accel;
+
+/* The SHA-256 compression function of sha2.c */
+
+extern CODE void (*sha256transform)(FAR uint32_t *, FAR const uint8_t *);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crypto_accel_init
+ *
+ * Description:
+ *   Probe the crypto instructions of the CPU and install the matching
+ *   implementations of AES, GHASH and SHA-256.  Called once from
+ *   up_cryptoinitialize(), before any session is set up.
+ *
+ ****************************************************************************/
+
+void crypto_accel_init(void);
+
+#endif /* CONFIG_CRYPTO_ACCEL */
+#endif /* __CRYPTO_ACCEL_H */
@@ -0,0 +1,344 @@
+/****************************************************************************
+ * crypto/accel_arm64.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <crypto/gmac.h>
+
+#include "accel.h"
+
+/* The crypto extensions are only enabled for the functions that use them;
+ * the rest of the kernel is still built for the baseline CPU.
+ */
+
+#pragma GCC push_options
+#pragma GCC target("+crypto")
+#include <arm_neon.h>
+#pragma GCC pop_options
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ACCEL_CE  __attribute__((target("+crypto")))
+
+/* ID_AA64ISAR0_EL1 fields */
+
+#define ID_AA64ISAR0_AES_SHIFT   4
+#define ID_AA64ISAR0_AES_MASK    0xf
+#  define ID_AA64ISAR0_AES       1  /* AESE, AESD, AESMC, AESIMC */
+#  define ID_AA64ISAR0_PMULL     2  /* As above plus PMULL */
+#define ID_AA64ISAR0_SHA2_SHIFT  12
+#define ID_AA64ISAR0_SHA2_MASK   0xf
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint32_t g_k256[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ce_invkey
+ *
+ * Description:
+ *   Make the schedule of the equivalent inverse cipher: the round keys in
+ *   reverse order, all but the outer ones through InvMixColumns.
+ *
+ ****************************************************************************/
+
+ACCEL_CE static void ce_invkey(FAR uint32_t *dk,
+                               FAR const uint32_t *ek, int nr)
+{
+  FAR const uint8_t *e = (FAR const uint8_t *)ek;
+  FAR uint8_t *d = (FAR uint8_t *)dk;
+  int i;
+
+  vst1q_u8(d, vld1q_u8(e + 16 * nr));
+  for (i = 1; i < nr; i++)
+    {
+      vst1q_u8(d + 16 * i, vaesimcq_u8(vld1q_u8(e + 16 * (nr - i))));
+    }
+
+  vst1q_u8(d + 16 * nr, vld1q_u8(e));
+}
+
+/* AESE and AESD add the round key before the S-box, so that the last round
+ * key is a separate XOR.
+ */
+
+ACCEL_CE static void ce_encrypt(FAR const uint32_t *rk, int nr,
+                                FAR const uint8_t *src,
+                                FAR uint8_t *dst, size_t nblocks)
+{
+  FAR const uint8_t *k = (FAR const uint8_t *)rk;
+  uint8x16_t x;
+  int i;
+
+  while (nblocks-- > 0)
+    {
+      x = vld1q_u8(src);
+      for (i = 0; i < nr - 1; i++)
+        {
+          x = vaesmcq_u8(vaeseq_u8(x, vld1q_u8(k + 16 * i)));
+        }
+
+      x = vaeseq_u8(x, vld1q_u8(k + 16 * (nr - 1)));
+      x = veorq_u8(x, vld1q_u8(k + 16 * nr));
+      vst1q_u8(dst, x);
+
+      src += 16;
+      dst += 16;
+    }
+}
+
+ACCEL_CE static void ce_decrypt(FAR const uint32_t *dk, int nr,
+                                FAR const uint8_t *src,
+                                FAR uint8_t *dst, size_t nblocks)
+{
+  FAR const uint8_t *k = (FAR const uint8_t *)dk;
+  uint8x16_t x;
+  int i;
+
+  while (nblocks-- > 0)
+    {
+      x = vld1q_u8(src);
+      for (i = 0; i < nr - 1; i++)
+        {
+          x = vaesimcq_u8(vaesdq_u8(x, vld1q_u8(k + 16 * i)));
+        }
+
+      x = vaesdq_u8(x, vld1q_u8(k + 16 * (nr - 1)));
+      x = veorq_u8(x, vld1q_u8(k + 16 * nr));
+      vst1q_u8(dst, x);
+
+      src += 16;
+      dst += 16;
+    }
+}
+
+/****************************************************************************
+ * Name: pmull_gfmul
+ *
+ * Description:
+ *   Multiply in GF(2^128) with the GCM bit order, the operands byte
+ *   reversed.  This is the algorithm of the PCLMULQDQ implementation in
+ *   accel_x86_64.c: a 256 bit carry-less product, shifted left by one bit
+ *   for the reflected bits and reduced modulo x^128 + x^7 + x^2 + x + 1.
+ *
+ ****************************************************************************/
+
+ACCEL_CE static uint32x4_t pmull_mul(poly64_t a, poly64_t b)
+{
+  return vreinterpretq_u32_p128(vmull_p64(a, b));
+}
+
+ACCEL_CE static uint8x16_t pmull_gfmul(uint8x16_t x, uint8x16_t y)
+{
+  const uint32x4_t zero = vdupq_n_u32(0);
+  poly64_t a0 = (poly64_t)vgetq_lane_u64(vreinterpretq_u64_u8(x), 0);
+  poly64_t a1 = (poly64_t)vgetq_lane_u64(vreinterpretq_u64_u8(x), 1);
+  poly64_t b0 = (poly64_t)vgetq_lane_u64(vreinterpretq_u64_u8(y), 0);
+  poly64_t b1 = (poly64_t)vgetq_lane_u64(vreinterpretq_u64_u8(y), 1);
+  uint32x4_t lo;
+  uint32x4_t hi;
+  uint32x4_t mid;
+  uint32x4_t t1;
+  uint32x4_t t2;
+  uint32x4_t t3;
+
+  /* vextq_u32(zero, v, 4 - n) shifts v up by n words, vextq_u32(v, zero,
+   * n) shifts it down.
+   */
+
+  lo  = pmull_mul(a0, b0);
+  hi  = pmull_mul(a1, b1);
+  mid = veorq_u32(pmull_mul(a0, b1), pmull_mul(a1, b0));
+  lo  = veorq_u32(lo, vextq_u32(zero, mid, 2));
+  hi  = veorq_u32(hi, vextq_u32(mid, zero, 2));
+
+  /* Shift <hi:lo> left by one bit */
+
+  t1  = vshrq_n_u32(lo, 31);
+  t2  = vshrq_n_u32(hi, 31);
+  lo  = vshlq_n_u32(lo, 1);
+  hi  = vshlq_n_u32(hi, 1);
+  t3  = vextq_u32(t1, zero, 3);
+  t2  = vextq_u32(zero, t2, 3);
+  t1  = vextq_u32(zero, t1, 3);
+  lo  = vorrq_u32(lo, t1);
+  hi  = vorrq_u32(hi, t2);
+  hi  = vorrq_u32(hi, t3);
+
+  /* Reduce */
+
+  t1  = veorq_u32(vshlq_n_u32(lo, 31), vshlq_n_u32(lo, 30));
+  t1  = veorq_u32(t1, vshlq_n_u32(lo, 25));
+  t2  = vextq_u32(t1, zero, 1);
+  lo  = veorq_u32(lo, vextq_u32(zero, t1, 1));
+  t1  = veorq_u32(vshrq_n_u32(lo, 1), vshrq_n_u32(lo, 2));
+  t1  = veorq_u32(t1, vshrq_n_u32(lo, 7));
+  t1  = veorq_u32(t1, t2);
+  lo  = veorq_u32(lo, t1);
+
+  return vreinterpretq_u8_u32(veorq_u32(hi, lo));
+}
+
+ACCEL_CE static uint8x16_t pmull_bswap(uint8x16_t x)
+{
+  x = vrev64q_u8(x);
+  return vextq_u8(x, x, 8);
+}
+
+ACCEL_CE static void pmull_ghash_update(FAR GHASH_CTX *ctx,
+                                        FAR uint8_t *x, size_t len)
+{
+  uint8x16_t h;
+  uint8x16_t y;
+
+  h = pmull_bswap(vld1q_u8(ctx->H));
+  y = pmull_bswap(vld1q_u8(ctx->Z));
+
+  for (; len >= GMAC_BLOCK_LEN; len -= GMAC_BLOCK_LEN)
+    {
+      y = veorq_u8(y, pmull_bswap(vld1q_u8(x)));
+      y = pmull_gfmul(y, h);
+      x += GMAC_BLOCK_LEN;
+    }
+
+  y = pmull_bswap(y);
+  vst1q_u8(ctx->S, y);
+  vst1q_u8(ctx->Z, y);
+}
+
+/****************************************************************************
+ * Name: ce_sha256_transform
+ *
+ * Description:
+ *   One block of SHA-256 with the SHA-256 instructions, four rounds and
+ *   four words of the message schedule at a time.
+ *
+ ****************************************************************************/
+
+ACCEL_CE static void ce_sha256_transform(FAR uint32_t *state,
+                                         FAR const uint8_t *data)
+{
+  uint32x4_t msg[4];
+  uint32x4_t abcd;
+  uint32x4_t efgh;
+  uint32x4_t save;
+  uint32x4_t wk;
+  int i;
+
+  abcd = vld1q_u32(&state[0]);
+  efgh = vld1q_u32(&state[4]);
+
+  for (i = 0; i < 4; i++)
+    {
+      msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+    }
+
+  for (i = 0; i < 16; i++)
+    {
+      wk = vaddq_u32(msg[i & 3], vld1q_u32(&g_k256[4 * i]));
+
+      /* W[4i + 16..4i + 19] replaces W[4i..4i + 3] */
+
+      if (i < 12)
+        {
+          msg[i & 3] = vsha256su1q_u32(vsha256su0q_u32(msg[i & 3],
+                                                       msg[(i + 1) & 3]),
+                                       msg[(i + 2) & 3], msg[(i + 3) & 3]);
+        }
+
+      save = abcd;
+      abcd = vsha256hq_u32(abcd, efgh, wk);
+      efgh = vsha256h2q_u32(efgh, save, wk);
+    }
+
+  vst1q_u32(&state[0], vaddq_u32(abcd, vld1q_u32(&state[0])));
+  vst1q_u32(&state[4], vaddq_u32(efgh, vld1q_u32(&state[4])));
+}
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct aes_accel_s g_aes_ce =
+{
+  ce_invkey,
+  ce_encrypt,
+  ce_decrypt,
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void crypto_accel_init(void)
+{
+  uint64_t isar0;
+  unsigned int aes;
+
+  __asm__ volatile ("mrs %0, id_aa64isar0_el1" : "=r" (isar0));
+
+  aes = (isar0 >> ID_AA64ISAR0_AES_SHIFT) & ID_AA64ISAR0_AES_MASK;
+  if (aes >= ID_AA64ISAR0_AES)
+    {
+      aes_accel = &g_aes_ce;
+    }
+
+  if (aes >= ID_AA64ISAR0_PMULL)
+    {
+      ghash_update = pmull_ghash_update;
+    }
+
+  if (((isar0 >> ID_AA64ISAR0_SHA2_SHIFT) & ID_AA64ISAR0_SHA2_MASK) != 0)
+    {
+      sha256transform = ce_sha256_transform;
+    }
+}
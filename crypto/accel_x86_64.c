@@ -0,0 +1,356 @@
+/****************************************************************************
+ * crypto/accel_x86_64.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <immintrin.h>
+
+#include <arch/arch.h>
+#include <crypto/gmac.h>
+
+#include "accel.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The instructions are only enabled for the functions that use them; the
+ * rest of the kernel is still built for the baseline CPU.
+ */
+
+#define ACCEL_AES  __attribute__((target("aes")))
+#define ACCEL_GCM  __attribute__((target("pclmul,ssse3")))
+#define ACCEL_SHA  __attribute__((target("sha,sse4.1")))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint32_t g_k256[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void accel_cpuid(uint32_t leaf, FAR uint32_t *ebx,
+                        FAR uint32_t *ecx)
+{
+  uint32_t eax;
+  uint32_t edx;
+
+  asm volatile("cpuid"
+               : "=a" (eax), "=b" (*ebx), "=c" (*ecx), "=d" (edx)
+               : "a" (leaf), "c" (0));
+}
+
+/****************************************************************************
+ * Name: aesni_invkey
+ *
+ * Description:
+ *   Make the schedule of the equivalent inverse cipher: the round keys in
+ *   reverse order, all but the outer ones through InvMixColumns.
+ *
+ ****************************************************************************/
+
+ACCEL_AES static void aesni_invkey(FAR uint32_t *dk,
+                                   FAR const uint32_t *ek, int nr)
+{
+  FAR const __m128i *e = (FAR const __m128i *)ek;
+  FAR __m128i *d = (FAR __m128i *)dk;
+  int i;
+
+  _mm_storeu_si128(&d[0], _mm_loadu_si128(&e[nr]));
+  for (i = 1; i < nr; i++)
+    {
+      _mm_storeu_si128(&d[i],
+                       _mm_aesimc_si128(_mm_loadu_si128(&e[nr - i])));
+    }
+
+  _mm_storeu_si128(&d[nr], _mm_loadu_si128(&e[0]));
+}
+
+ACCEL_AES static void aesni_encrypt(FAR const uint32_t *rk, int nr,
+                                    FAR const uint8_t *src,
+                                    FAR uint8_t *dst, size_t nblocks)
+{
+  FAR const __m128i *k = (FAR const __m128i *)rk;
+  __m128i x;
+  int i;
+
+  while (nblocks-- > 0)
+    {
+      x = _mm_loadu_si128((FAR const __m128i *)src);
+      x = _mm_xor_si128(x, _mm_loadu_si128(&k[0]));
+      for (i = 1; i < nr; i++)
+        {
+          x = _mm_aesenc_si128(x, _mm_loadu_si128(&k[i]));
+        }
+
+      x = _mm_aesenclast_si128(x, _mm_loadu_si128(&k[nr]));
+      _mm_storeu_si128((FAR __m128i *)dst, x);
+
+      src += 16;
+      dst += 16;
+    }
+}
+
+ACCEL_AES static void aesni_decrypt(FAR const uint32_t *dk, int nr,
+                                    FAR const uint8_t *src,
+                                    FAR uint8_t *dst, size_t nblocks)
+{
+  FAR const __m128i *k = (FAR const __m128i *)dk;
+  __m128i x;
+  int i;
+
+  while (nblocks-- > 0)
+    {
+      x = _mm_loadu_si128((FAR const __m128i *)src);
+      x = _mm_xor_si128(x, _mm_loadu_si128(&k[0]));
+      for (i = 1; i < nr; i++)
+        {
+          x = _mm_aesdec_si128(x, _mm_loadu_si128(&k[i]));
+        }
+
+      x = _mm_aesdeclast_si128(x, _mm_loadu_si128(&k[nr]));
+      _mm_storeu_si128((FAR __m128i *)dst, x);
+
+      src += 16;
+      dst += 16;
+    }
+}
+
+/****************************************************************************
+ * Name: clmul_gfmul
+ *
+ * Description:
+ *   Multiply in GF(2^128) with the GCM bit order, the operands byte
+ *   reversed.  The 256 bit carry-less product is shifted left by one bit
+ *   to account for the reflected bits and reduced modulo
+ *   x^128 + x^7 + x^2 + x + 1 (Intel, "Intel Carry-Less Multiplication
+ *   Instruction and its Usage for Computing the GCM Mode").
+ *
+ ****************************************************************************/
+
+ACCEL_GCM static __m128i clmul_gfmul(__m128i a, __m128i b)
+{
+  __m128i lo;
+  __m128i hi;
+  __m128i mid;
+  __m128i t1;
+  __m128i t2;
+  __m128i t3;
+
+  lo  = _mm_clmulepi64_si128(a, b, 0x00);
+  hi  = _mm_clmulepi64_si128(a, b, 0x11);
+  mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10),
+                      _mm_clmulepi64_si128(a, b, 0x01));
+  lo  = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+  hi  = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+  /* Shift <hi:lo> left by one bit */
+
+  t1  = _mm_srli_epi32(lo, 31);
+  t2  = _mm_srli_epi32(hi, 31);
+  lo  = _mm_slli_epi32(lo, 1);
+  hi  = _mm_slli_epi32(hi, 1);
+  t3  = _mm_srli_si128(t1, 12);
+  t2  = _mm_slli_si128(t2, 4);
+  t1  = _mm_slli_si128(t1, 4);
+  lo  = _mm_or_si128(lo, t1);
+  hi  = _mm_or_si128(hi, t2);
+  hi  = _mm_or_si128(hi, t3);
+
+  /* Reduce */
+
+  t1  = _mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30));
+  t1  = _mm_xor_si128(t1, _mm_slli_epi32(lo, 25));
+  t2  = _mm_srli_si128(t1, 4);
+  lo  = _mm_xor_si128(lo, _mm_slli_si128(t1, 12));
+  t1  = _mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2));
+  t1  = _mm_xor_si128(t1, _mm_srli_epi32(lo, 7));
+  t1  = _mm_xor_si128(t1, t2);
+  lo  = _mm_xor_si128(lo, t1);
+
+  return _mm_xor_si128(hi, lo);
+}
+
+ACCEL_GCM static void clmul_ghash_update(FAR GHASH_CTX *ctx,
+                                         FAR uint8_t *x, size_t len)
+{
+  const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                     8, 9, 10, 11, 12, 13, 14, 15);
+  __m128i h;
+  __m128i y;
+
+  h = _mm_shuffle_epi8(_mm_loadu_si128((FAR __m128i *)ctx->H), bswap);
+  y = _mm_shuffle_epi8(_mm_loadu_si128((FAR __m128i *)ctx->Z), bswap);
+
+  for (; len >= GMAC_BLOCK_LEN; len -= GMAC_BLOCK_LEN)
+    {
+      y = _mm_xor_si128(y, _mm_shuffle_epi8(
+                        _mm_loadu_si128((FAR __m128i *)x), bswap));
+      y = clmul_gfmul(y, h);
+      x += GMAC_BLOCK_LEN;
+    }
+
+  y = _mm_shuffle_epi8(y, bswap);
+  _mm_storeu_si128((FAR __m128i *)ctx->S, y);
+  _mm_storeu_si128((FAR __m128i *)ctx->Z, y);
+}
+
+/****************************************************************************
+ * Name: shani_transform
+ *
+ * Description:
+ *   One block of SHA-256 with the SHA extensions.  The instructions keep
+ *   the state as ABEF and CDGH and do two rounds at a time; the message
+ *   schedule is four words of W at a time in msg[].
+ *
+ ****************************************************************************/
+
+ACCEL_SHA static void shani_transform(FAR uint32_t *state,
+                                      FAR const uint8_t *data)
+{
+  const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bull,
+                                       0x0405060700010203ull);
+  __m128i msg[4];
+  __m128i abef;
+  __m128i cdgh;
+  __m128i save0;
+  __m128i save1;
+  __m128i wk;
+  __m128i tmp;
+  int i;
+
+  tmp   = _mm_shuffle_epi32(_mm_loadu_si128((FAR __m128i *)&state[0]),
+                            0xb1);
+  cdgh  = _mm_shuffle_epi32(_mm_loadu_si128((FAR __m128i *)&state[4]),
+                            0x1b);
+  abef  = _mm_alignr_epi8(tmp, cdgh, 8);
+  cdgh  = _mm_blend_epi16(cdgh, tmp, 0xf0);
+  save0 = abef;
+  save1 = cdgh;
+
+  for (i = 0; i < 16; i++)
+    {
+      if (i < 4)
+        {
+          msg[i] = _mm_shuffle_epi8(
+                   _mm_loadu_si128((FAR const __m128i *)(data + 16 * i)),
+                   bswap);
+        }
+
+      wk   = _mm_add_epi32(msg[i & 3],
+                           _mm_loadu_si128((FAR __m128i *)&g_k256[4 * i]));
+      cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+
+      /* W[4i + 4..4i + 7] from msg1() of W[4i - 12..4i - 5] */
+
+      if (i >= 3 && i < 15)
+        {
+          tmp = _mm_alignr_epi8(msg[i & 3], msg[(i - 1) & 3], 4);
+          msg[(i + 1) & 3] = _mm_add_epi32(msg[(i + 1) & 3], tmp);
+          msg[(i + 1) & 3] = _mm_sha256msg2_epu32(msg[(i + 1) & 3],
+                                                  msg[i & 3]);
+        }
+
+      wk   = _mm_shuffle_epi32(wk, 0x0e);
+      abef = _mm_sha256rnds2_epu32(abef, cdgh, wk);
+
+      if (i >= 1 && i < 13)
+        {
+          msg[(i - 1) & 3] = _mm_sha256msg1_epu32(msg[(i - 1) & 3],
+                                                  msg[i & 3]);
+        }
+    }
+
+  abef = _mm_add_epi32(abef, save0);
+  cdgh = _mm_add_epi32(cdgh, save1);
+
+  tmp  = _mm_shuffle_epi32(abef, 0x1b);
+  cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+  _mm_storeu_si128((FAR __m128i *)&state[0],
+                   _mm_blend_epi16(tmp, cdgh, 0xf0));
+  _mm_storeu_si128((FAR __m128i *)&state[4],
+                   _mm_alignr_epi8(cdgh, tmp, 8));
+}
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct aes_accel_s g_aesni =
+{
+  aesni_invkey,
+  aesni_encrypt,
+  aesni_decrypt,
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void crypto_accel_init(void)
+{
+  uint32_t ebx;
+  uint32_t ecx;
+  uint32_t unused;
+
+  accel_cpuid(X86_64_CPUID_EXTCAP, &ebx, &unused);
+  accel_cpuid(X86_64_CPUID_CAP, &unused, &ecx);
+
+  if (ecx & X86_64_CPUID_01_AESNI)
+    {
+      aes_accel = &g_aesni;
+    }
+
+  if ((ecx & X86_64_CPUID_01_PCLMUL) && (ecx & X86_64_CPUID_01_SSSE3))
+    {
+      ghash_update = clmul_ghash_update;
+    }
+
+  if ((ebx & X86_64_CPUID_07_SHA) && (ecx & X86_64_CPUID_01_SSE41))
+    {
+      sha256transform = shani_transform;
+    }
+}
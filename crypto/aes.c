@@ -35,6 +35,16 @@
 #include <sys/types.h>
 #include <crypto/aes.h>
 
+#include "accel.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_ACCEL
+FAR const struct aes_accel_s *aes_accel;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -844,6 +854,24 @@ void aes_ct_bitslice_decrypt(unsigned num_rounds,
 
 int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
 {
+#ifdef CONFIG_CRYPTO_ACCEL
+  if (aes_accel != NULL)
+    {
+      /* The instructions take the plain schedule: the encryption round
+       * keys in sk_exp[0..59] and the decryption ones after them.
+       */
+
+      ctx->num_rounds = aes_keysched_base(ctx->sk_exp, key, len);
+      if (ctx->num_rounds == 0)
+        {
+          return -1;
+        }
+
+      aes_accel->invkey(ctx->sk_exp + 60, ctx->sk_exp, ctx->num_rounds);
+      return 0;
+    }
+#endif
+
   ctx->num_rounds = aes_ct_keysched(ctx->sk, key, len);
   if (ctx->num_rounds == 0)
     {
@@ -857,6 +885,15 @@ int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
 void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
                      FAR uint8_t *dst, size_t num_blocks)
 {
+#ifdef CONFIG_CRYPTO_ACCEL
+  if (aes_accel != NULL)
+    {
+      aes_accel->encrypt(ctx->sk_exp, ctx->num_rounds, src, dst,
+                         num_blocks);
+      return;
+    }
+#endif
+
   while (num_blocks > 0)
     {
       uint32_t q[8];
@@ -907,6 +944,15 @@ void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
 void aes_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
                      FAR uint8_t *dst, size_t num_blocks)
 {
+#ifdef CONFIG_CRYPTO_ACCEL
+  if (aes_accel != NULL)
+    {
+      aes_accel->decrypt(ctx->sk_exp + 60, ctx->num_rounds, src, dst,
+                         num_blocks);
+      return;
+    }
+#endif
+
   while (num_blocks > 0)
     {
       uint32_t q[8];
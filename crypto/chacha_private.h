@@ -11,9 +11,21 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <string.h>
 #include <sys/types.h>
 
+/* With CONFIG_CRYPTO_ACCEL whole groups of four blocks are computed with
+ * GCC vectors, which are SSE2 or NEON registers on the CPUs that have the
+ * crypto instructions.
+ */
+
+#if defined(CONFIG_CRYPTO_ACCEL) && defined(__GNUC__) && \
+    !defined(__clang__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  define CHACHA_VECTOR
+#endif
+
 typedef struct
 {
   uint32_t input[16]; /* could be compressed */
@@ -146,6 +158,130 @@ static void chacha_ivsetup(FAR chacha_ctx *x,
   x->input[15] = U8TO32_LITTLE(iv + 4);
 }
 
+#ifdef CHACHA_VECTOR
+typedef uint32_t chacha_v4_t __attribute__((vector_size(16)));
+
+#define VROTATE(v, c) (((v) << (c)) | ((v) >> (32 - (c))))
+
+#define VQUARTERROUND(a, b, c, d)                     \
+  do                                                  \
+    {                                                 \
+      a += b; d = VROTATE(d ^ a, 16);                 \
+      c += d; b = VROTATE(b ^ c, 12);                 \
+      a += b; d = VROTATE(d ^ a, 8);                  \
+      c += d; b = VROTATE(b ^ c, 7);                  \
+    }                                                 \
+  while (0)
+
+/* Four blocks at a time: lane n of v[i] is word i of block n, so that the
+ * quarter rounds need no shuffles.  The blocks are transposed back to
+ * bytes four words at a time.
+ */
+
+static void chacha_encrypt_4blocks(FAR chacha_ctx *x,
+                                   FAR const uint8_t *m,
+                                   FAR uint8_t *c)
+{
+  const chacha_v4_t lane =
+  {
+    0, 1, 2, 3
+  };
+
+  /* Shuffle masks to transpose four 4x4 word blocks */
+
+  const chacha_v4_t interlo =
+  {
+    0, 4, 1, 5
+  };
+
+  const chacha_v4_t interhi =
+  {
+    2, 6, 3, 7
+  };
+
+  const chacha_v4_t pairlo =
+  {
+    0, 1, 4, 5
+  };
+
+  const chacha_v4_t pairhi =
+  {
+    2, 3, 6, 7
+  };
+
+  const chacha_v4_t zero =
+  {
+    0, 0, 0, 0
+  };
+
+  chacha_v4_t j[16];
+  chacha_v4_t v[16];
+  chacha_v4_t t[4];
+  chacha_v4_t r[4];
+  u_int i;
+  u_int n;
+
+  for (i = 0; i < 16; i++)
+    {
+      j[i] = zero + x->input[i];
+    }
+
+  /* Carry the block counter into the high word, lane by lane */
+
+  j[12] += lane;
+  j[13] -= (chacha_v4_t)(j[12] < lane);
+
+  for (i = 0; i < 16; i++)
+    {
+      v[i] = j[i];
+    }
+
+  for (i = 20; i > 0; i -= 2)
+    {
+      VQUARTERROUND(v[0], v[4], v[8], v[12]);
+      VQUARTERROUND(v[1], v[5], v[9], v[13]);
+      VQUARTERROUND(v[2], v[6], v[10], v[14]);
+      VQUARTERROUND(v[3], v[7], v[11], v[15]);
+      VQUARTERROUND(v[0], v[5], v[10], v[15]);
+      VQUARTERROUND(v[1], v[6], v[11], v[12]);
+      VQUARTERROUND(v[2], v[7], v[8], v[13]);
+      VQUARTERROUND(v[3], v[4], v[9], v[14]);
+    }
+
+  for (i = 0; i < 16; i++)
+    {
+      v[i] += j[i];
+    }
+
+  for (i = 0; i < 16; i += 4)
+    {
+      t[0] = __builtin_shuffle(v[i], v[i + 1], interlo);
+      t[1] = __builtin_shuffle(v[i + 2], v[i + 3], interlo);
+      t[2] = __builtin_shuffle(v[i], v[i + 1], interhi);
+      t[3] = __builtin_shuffle(v[i + 2], v[i + 3], interhi);
+      r[0] = __builtin_shuffle(t[0], t[1], pairlo);
+      r[1] = __builtin_shuffle(t[0], t[1], pairhi);
+      r[2] = __builtin_shuffle(t[2], t[3], pairlo);
+      r[3] = __builtin_shuffle(t[2], t[3], pairhi);
+
+      for (n = 0; n < 4; n++)
+        {
+#ifndef KEYSTREAM_ONLY
+          memcpy(&t[n], m + 64 * n + 4 * i, sizeof(t[n]));
+          r[n] ^= t[n];
+#endif
+          memcpy(c + 64 * n + 4 * i, &r[n], sizeof(r[n]));
+        }
+    }
+
+  x->input[12] += 4;
+  if (x->input[12] < 4)
+    {
+      x->input[13]++;
+    }
+}
+#endif
+
 static void chacha_encrypt_bytes(FAR chacha_ctx *x,
                                  FAR const uint8_t *m,
                                  FAR uint8_t *c,
@@ -187,6 +323,17 @@ static void chacha_encrypt_bytes(FAR chacha_ctx *x,
   uint8_t tmp[64];
   u_int i;
 
+#ifdef CHACHA_VECTOR
+  for (; bytes >= 256; bytes -= 256)
+    {
+      chacha_encrypt_4blocks(x, m, c);
+      c += 256;
+#ifndef KEYSTREAM_ONLY
+      m += 256;
+#endif
+    }
+#endif
+
   if (!bytes)
     {
       return;
@@ -28,8 +28,10 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <string.h>
 #include <poll.h>
 #include <debug.h>
@@ -40,6 +42,16 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
 
+#include "accel.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Words of the bitmap of the drivers tried for a session */
+
+#define CRYPTO_TRIED_WORDS ((CRYPTO_DRIVERS_MAX + 31) / 32)
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -51,159 +63,178 @@ int crypto_drivers_num = 0;
  * Private Data
  ****************************************************************************/
 
-static mutex_t g_crypto_lock = NXMUTEX_INITIALIZER;
+/* Recursive, as the dispatch may have to free and create sessions */
+
+static rmutex_t g_crypto_lock = NXRMUTEX_INITIALIZER;
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
-/* Create a new session. */
+/* Get the priority with which a driver claimed an algorithm, or -1 if it
+ * does not support it.  Drivers that registered the algorithm without a
+ * priority get the default of their kind, so hardware is preferred.
+ */
 
-int crypto_newsession(FAR uint64_t *sid,
-                      FAR struct cryptoini *cri,
-                      int hard)
+static int crypto_alg_prio(FAR struct cryptocap *cpc, int alg)
 {
-  uint32_t hid;
-  uint32_t lid;
-  uint32_t hid2 = -1;
-  FAR struct cryptocap *cpc;
-  FAR struct cryptoini *cr;
-  int turn = 0;
-  int err;
+  int flags;
+  int prio;
 
-  if (crypto_drivers == NULL)
+  if (alg < 0 || alg > CRYPTO_ALGORITHM_MAX)
     {
-      return -EINVAL;
+      return -1;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  flags = cpc->cc_alg[alg];
+  if ((flags & CRYPTO_ALG_FLAG_SUPPORTED) == 0)
+    {
+      return -1;
+    }
 
-  /* The algorithm we use here is pretty stupid; just use the
-   * first driver that supports all the algorithms we need. Do
-   * a double-pass over all the drivers, ignoring software ones
-   * at first, to deal with cases of drivers that register after
-   * the software one(s) --- e.g., PCMCIA crypto cards.
-   *
-   * XXX We need more smarts here (in real life too, but that's
-   * XXX another story altogether).
-   */
+  prio = CRYPTO_ALG_PRIO(flags);
+  if (prio == 0)
+    {
+      prio = (cpc->cc_flags & CRYPTOCAP_F_SOFTWARE) ?
+             CRYPTO_PRIO_SOFTWARE : CRYPTO_PRIO_HARDWARE;
+    }
+
+  return prio;
+}
 
-  do
+/* Pick the driver for a new session: among the drivers that support all
+ * the algorithms of cri and have not been tried yet, the one whose lowest
+ * priority for them is the highest.  Ties go to the driver with the fewest
+ * sessions.
+ */
+
+static int crypto_select(FAR struct cryptoini *cri, int hard,
+                         FAR const uint32_t *tried)
+{
+  FAR struct cryptocap *cpc;
+  FAR struct cryptoini *cr;
+  int best = -1;
+  int bestprio = -1;
+  int prio;
+  int hid;
+  int p;
+
+  for (hid = 0; hid < crypto_drivers_num; hid++)
     {
-      for (hid = 0; hid < crypto_drivers_num; hid++)
-        {
-          cpc = &crypto_drivers[hid];
+      cpc = &crypto_drivers[hid];
 
-          /* If it's not initialized or has remaining sessions
-           * referencing it, skip.
-           */
+      /* If it's not initialized or has remaining sessions
+       * referencing it, skip.
+       */
 
-          if (cpc->cc_newsession == NULL ||
-              (cpc->cc_flags & CRYPTOCAP_F_CLEANUP))
-            {
-              continue;
-            }
+      if (cpc->cc_newsession == NULL ||
+          (cpc->cc_flags & CRYPTOCAP_F_CLEANUP))
+        {
+          continue;
+        }
 
-          if (cpc->cc_flags & CRYPTOCAP_F_SOFTWARE)
-            {
-              /* First round of search, ignore
-               * software drivers.
-               */
-
-              if (turn == 0)
-                {
-                  continue;
-                }
-            }
-          else
-            {
-              /* !CRYPTOCAP_F_SOFTWARE
-               * Second round of search, only software.
-               */
-
-              if (turn == 1)
-                {
-                  continue;
-                }
-            }
+      /* If we only want hardware drivers, skip the software ones. */
 
-          /* See if all the algorithms are supported. */
+      if (hard != 0 && (cpc->cc_flags & CRYPTOCAP_F_SOFTWARE))
+        {
+          continue;
+        }
 
-          for (cr = cri; cr; cr = cr->cri_next)
-            {
-              if (cpc->cc_alg[cr->cri_alg] == 0)
-                {
-                  break;
-                }
-            }
+      if (tried[hid / 32] & (1u << (hid % 32)))
+        {
+          continue;
+        }
 
-          /* If even one algorithm is not supported,
-           * keep searching.
-           */
+      /* See if all the algorithms are supported. */
 
-          if (cr != NULL)
+      prio = INT_MAX;
+      for (cr = cri; cr; cr = cr->cri_next)
+        {
+          p = crypto_alg_prio(cpc, cr->cri_alg);
+          if (p < 0)
             {
-              continue;
+              break;
             }
 
-          /* If we had a previous match, see how it compares
-           * to this one. Keep "remembering" whichever is
-           * the best of the two.
-           */
+          prio = MIN(prio, p);
+        }
 
-          if (hid2 != -1)
-            {
-              /* Compare session numbers, pick the one
-               * with the lowest.
-               * XXX Need better metrics, this will
-               * XXX just do un-weighted round-robin.
-               */
-
-              if (crypto_drivers[hid].cc_sessions <=
-                  crypto_drivers[hid2].cc_sessions)
-                {
-                  hid2 = hid;
-                }
-            }
-          else
-            {
-              /* Remember this one, for future
-               * comparisons.
-               */
+      if (cr != NULL)
+        {
+          continue;
+        }
 
-              hid2 = hid;
-            }
+      if (prio > bestprio ||
+          (prio == bestprio &&
+           cpc->cc_sessions <= crypto_drivers[best].cc_sessions))
+        {
+          best = hid;
+          bestprio = prio;
         }
+    }
 
-      /* If we found something worth remembering, leave. The
-       * side-effect is that we will always prefer a hardware
-       * driver over the software one.
-       */
+  return best;
+}
 
-      if (hid2 != -1)
+/* Create a new session on the best driver, falling back to the next best
+ * one as long as drivers refuse the session.  The bits of tried mark the
+ * drivers not to use and are set for the drivers that refused.
+ */
+
+static int crypto_newsession_tried(FAR uint64_t *sid,
+                                   FAR struct cryptoini *cri, int hard,
+                                   FAR uint32_t *tried)
+{
+  int err = -EINVAL;
+  int hid;
+
+  for (; ; )
+    {
+      hid = crypto_select(cri, hard, tried);
+      if (hid < 0)
         {
           break;
         }
 
-      turn++;
+      err = crypto_driver_newsession(hid, sid, cri);
+      if (err == 0)
+        {
+          break;
+        }
 
-      /* If we only want hardware drivers, don't do second pass. */
+      cryptinfo("driver %d refused session: %d\n", hid, err);
+      tried[hid / 32] |= 1u << (hid % 32);
     }
-  while (turn <= 2 && hard == 0);
 
-  hid = hid2;
+  return err;
+}
 
-  /* Can't do everything in one session.
-   * XXX Fix this. We need to inject a "virtual" session
-   * XXX layer right about here.
-   */
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-  if (hid == -1)
+/* Create a new session on a given driver. */
+
+int crypto_driver_newsession(uint32_t hid, FAR uint64_t *sid,
+                             FAR struct cryptoini *cri)
+{
+  uint32_t lid;
+  int err;
+
+  if (crypto_drivers == NULL || hid >= crypto_drivers_num)
     {
-      nxmutex_unlock(&g_crypto_lock);
       return -EINVAL;
     }
 
+  nxrmutex_lock(&g_crypto_lock);
+
+  if (crypto_drivers[hid].cc_newsession == NULL ||
+      (crypto_drivers[hid].cc_flags & CRYPTOCAP_F_CLEANUP))
+    {
+      nxrmutex_unlock(&g_crypto_lock);
+      return -ENODEV;
+    }
+
   /* Call the driver initialization routine. */
 
   lid = hid; /* Pass the driver ID. */
@@ -216,7 +247,34 @@ int crypto_newsession(FAR uint64_t *sid,
       crypto_drivers[hid].cc_sessions++;
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  nxrmutex_unlock(&g_crypto_lock);
+  return err;
+}
+
+/* Create a new session on the driver that claimed the algorithms with the
+ * highest priority.  If that driver refuses the session, e.g. for a key
+ * length its engine does not support, the next one is tried, down to the
+ * software driver unless only hardware was asked for.
+ */
+
+int crypto_newsession(FAR uint64_t *sid,
+                      FAR struct cryptoini *cri,
+                      int hard)
+{
+  uint32_t tried[CRYPTO_TRIED_WORDS];
+  int err;
+
+  if (crypto_drivers == NULL)
+    {
+      return -EINVAL;
+    }
+
+  memset(tried, 0, sizeof(tried));
+
+  nxrmutex_lock(&g_crypto_lock);
+  err = crypto_newsession_tried(sid, cri, hard, tried);
+  nxrmutex_unlock(&g_crypto_lock);
+
   return err;
 }
 
@@ -243,7 +301,7 @@ int crypto_freesession(uint64_t sid)
       return -ENOENT;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  nxrmutex_lock(&g_crypto_lock);
 
   if (crypto_drivers[hid].cc_sessions)
     {
@@ -267,7 +325,7 @@ int crypto_freesession(uint64_t sid)
       explicit_bzero(&crypto_drivers[hid], sizeof(struct cryptocap));
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  nxrmutex_unlock(&g_crypto_lock);
   return err;
 }
 
@@ -278,7 +336,7 @@ int crypto_get_driverid(uint8_t flags)
   FAR struct cryptocap *newdrv;
   int i;
 
-  nxmutex_lock(&g_crypto_lock);
+  nxrmutex_lock(&g_crypto_lock);
 
   if (crypto_drivers_num == 0)
     {
@@ -288,7 +346,7 @@ int crypto_get_driverid(uint8_t flags)
       if (crypto_drivers == NULL)
         {
           crypto_drivers_num = 0;
-          nxmutex_unlock(&g_crypto_lock);
+          nxrmutex_unlock(&g_crypto_lock);
           return -1;
         }
 
@@ -304,7 +362,7 @@ int crypto_get_driverid(uint8_t flags)
         {
           crypto_drivers[i].cc_sessions = 1; /* Mark */
           crypto_drivers[i].cc_flags = flags;
-          nxmutex_unlock(&g_crypto_lock);
+          nxrmutex_unlock(&g_crypto_lock);
           return i;
         }
     }
@@ -315,7 +373,7 @@ int crypto_get_driverid(uint8_t flags)
     {
       if (crypto_drivers_num >= CRYPTO_DRIVERS_MAX)
         {
-          nxmutex_unlock(&g_crypto_lock);
+          nxrmutex_unlock(&g_crypto_lock);
           return -1;
         }
 
@@ -323,7 +381,7 @@ int crypto_get_driverid(uint8_t flags)
                           sizeof(struct cryptocap));
       if (newdrv == NULL)
         {
-          nxmutex_unlock(&g_crypto_lock);
+          nxrmutex_unlock(&g_crypto_lock);
           return -1;
         }
 
@@ -338,13 +396,13 @@ int crypto_get_driverid(uint8_t flags)
 
       kmm_free(crypto_drivers);
       crypto_drivers = newdrv;
-      nxmutex_unlock(&g_crypto_lock);
+      nxrmutex_unlock(&g_crypto_lock);
       return i;
     }
 
   /* Shouldn't really get here... */
 
-  nxmutex_unlock(&g_crypto_lock);
+  nxrmutex_unlock(&g_crypto_lock);
   return -1;
 }
 
@@ -363,7 +421,7 @@ int crypto_kregister(uint32_t driverid, FAR int *kalg,
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  nxrmutex_lock(&g_crypto_lock);
 
   for (i = 0; i <= CRK_ALGORITHM_MAX; i++)
     {
@@ -377,7 +435,7 @@ int crypto_kregister(uint32_t driverid, FAR int *kalg,
 
   crypto_drivers[driverid].cc_kprocess = kprocess;
 
-  nxmutex_unlock(&g_crypto_lock);
+  nxrmutex_unlock(&g_crypto_lock);
   return 0;
 }
 
@@ -397,7 +455,7 @@ int crypto_register(uint32_t driverid, FAR int *alg,
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  nxrmutex_lock(&g_crypto_lock);
 
   for (i = 0; i <= CRYPTO_ALGORITHM_MAX; i++)
     {
@@ -414,7 +472,7 @@ int crypto_register(uint32_t driverid, FAR int *alg,
   crypto_drivers[driverid].cc_freesession = freeses;
   crypto_drivers[driverid].cc_sessions = 0; /* Unmark */
 
-  nxmutex_unlock(&g_crypto_lock);
+  nxrmutex_unlock(&g_crypto_lock);
 
   return 0;
 }
@@ -430,14 +488,14 @@ int crypto_unregister(uint32_t driverid, int alg)
   int i = CRYPTO_ALGORITHM_MAX + 1;
   uint32_t ses;
 
-  nxmutex_lock(&g_crypto_lock);
+  nxrmutex_lock(&g_crypto_lock);
 
   /* Sanity checks. */
 
   if (driverid >= crypto_drivers_num || crypto_drivers == NULL ||
       alg <= 0 || alg > (CRYPTO_ALGORITHM_MAX + 1))
     {
-      nxmutex_unlock(&g_crypto_lock);
+      nxrmutex_unlock(&g_crypto_lock);
       return -EINVAL;
     }
 
@@ -445,7 +503,7 @@ int crypto_unregister(uint32_t driverid, int alg)
     {
       if (crypto_drivers[driverid].cc_alg[alg] == 0)
         {
-          nxmutex_unlock(&g_crypto_lock);
+          nxrmutex_unlock(&g_crypto_lock);
           return -EINVAL;
         }
 
@@ -479,7 +537,7 @@ int crypto_unregister(uint32_t driverid, int alg)
         }
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  nxrmutex_unlock(&g_crypto_lock);
   return 0;
 }
 
@@ -498,7 +556,7 @@ int crypto_kinvoke(FAR struct cryptkop *krp)
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  nxrmutex_lock(&g_crypto_lock);
   for (hid = 0; hid < crypto_drivers_num; hid++)
     {
       if ((crypto_drivers[hid].cc_flags & CRYPTOCAP_F_SOFTWARE) &&
@@ -524,7 +582,7 @@ int crypto_kinvoke(FAR struct cryptkop *krp)
   if (hid == crypto_drivers_num)
     {
       krp->krp_status = -ENODEV;
-      nxmutex_unlock(&g_crypto_lock);
+      nxrmutex_unlock(&g_crypto_lock);
       return 0;
     }
 
@@ -538,14 +596,19 @@ int crypto_kinvoke(FAR struct cryptkop *krp)
       krp->krp_status = error;
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  nxrmutex_unlock(&g_crypto_lock);
   return 0;
 }
 
-/* Dispatch a crypto request to the appropriate crypto devices. */
+/* Dispatch a crypto request to the appropriate crypto devices.  If the
+ * driver of the session has gone (-ERESTART) or cannot handle the request
+ * (-ENOTSUP), the session moves to the next best driver and the request
+ * is retried there; crp_sid is then the new session.
+ */
 
 int crypto_invoke(FAR struct cryptop *crp)
 {
+  uint32_t tried[CRYPTO_TRIED_WORDS];
   FAR struct cryptodesc *crd;
   uint64_t nid;
   uint32_t hid;
@@ -558,14 +621,17 @@ int crypto_invoke(FAR struct cryptop *crp)
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  nxrmutex_lock(&g_crypto_lock);
   if (crp->crp_desc == NULL || crypto_drivers == NULL)
     {
       crp->crp_etype = -EINVAL;
-      nxmutex_unlock(&g_crypto_lock);
+      nxrmutex_unlock(&g_crypto_lock);
       return 0;
     }
 
+  memset(tried, 0, sizeof(tried));
+
+again:
   hid = (crp->crp_sid >> 32) & 0xffffffff;
   if (hid >= crypto_drivers_num)
     {
@@ -580,6 +646,7 @@ int crypto_invoke(FAR struct cryptop *crp)
 
   if (crypto_drivers[hid].cc_process == NULL)
     {
+      tried[hid / 32] |= 1u << (hid % 32);
       goto migrate;
     }
 
@@ -587,22 +654,34 @@ int crypto_invoke(FAR struct cryptop *crp)
   crypto_drivers[hid].cc_bytes += crp->crp_ilen;
 
   error = crypto_drivers[hid].cc_process(crp);
-  if (error)
+  if (error == 0)
     {
-      if (error == -ERESTART)
-        {
-          /* Unregister driver and migrate session. */
+      error = crp->crp_etype;
+    }
 
-          crypto_unregister(hid, CRYPTO_ALGORITHM_MAX + 1);
-          goto migrate;
-        }
-      else
-        {
-          crp->crp_etype = error;
-        }
+  if (error == -ERESTART)
+    {
+      /* Unregister driver and migrate session. */
+
+      crp->crp_etype = 0;
+      crypto_unregister(hid, CRYPTO_ALGORITHM_MAX + 1);
+      goto migrate;
+    }
+  else if (error == -ENOTSUP)
+    {
+      /* Leave this driver to the requests it can handle. */
+
+      crp->crp_etype = 0;
+      tried[hid / 32] |= 1u << (hid % 32);
+      crypto_freesession(crp->crp_sid);
+      goto migrate;
+    }
+  else if (error)
+    {
+      crp->crp_etype = error;
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  nxrmutex_unlock(&g_crypto_lock);
   return 0;
 
 migrate:
@@ -614,13 +693,15 @@ migrate:
       crd->CRD_INI.cri_next = &(crd->crd_next->CRD_INI);
     }
 
-  if (crypto_newsession(&nid, &(crp->crp_desc->CRD_INI), 0) == 0)
+  if (crypto_newsession_tried(&nid, &(crp->crp_desc->CRD_INI), 0,
+                              tried) == 0)
     {
       crp->crp_sid = nid;
+      goto again;
     }
 
   crp->crp_etype = -EAGAIN;
-  nxmutex_unlock(&g_crypto_lock);
+  nxrmutex_unlock(&g_crypto_lock);
   return 0;
 }
 
@@ -635,7 +716,7 @@ void crypto_freereq(FAR struct cryptop *crp)
       return;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  nxrmutex_lock(&g_crypto_lock);
 
   while ((crd = crp->crp_desc) != NULL)
     {
@@ -644,7 +725,7 @@ void crypto_freereq(FAR struct cryptop *crp)
     }
 
   kmm_free(crp);
-  nxmutex_unlock(&g_crypto_lock);
+  nxrmutex_unlock(&g_crypto_lock);
 }
 
 /* Acquire a set of crypto descriptors. */
@@ -654,12 +735,12 @@ FAR struct cryptop *crypto_getreq(int num)
   FAR struct cryptodesc *crd;
   FAR struct cryptop *crp;
 
-  nxmutex_lock(&g_crypto_lock);
+  nxrmutex_lock(&g_crypto_lock);
 
   crp = kmm_malloc(sizeof(struct cryptop));
   if (crp == NULL)
     {
-      nxmutex_unlock(&g_crypto_lock);
+      nxrmutex_unlock(&g_crypto_lock);
       return NULL;
     }
 
@@ -670,7 +751,7 @@ FAR struct cryptop *crypto_getreq(int num)
       crd = kmm_calloc(1, sizeof(struct cryptodesc));
       if (crd == NULL)
         {
-          nxmutex_unlock(&g_crypto_lock);
+          nxrmutex_unlock(&g_crypto_lock);
           crypto_freereq(crp);
           return NULL;
         }
@@ -679,7 +760,7 @@ FAR struct cryptop *crypto_getreq(int num)
       crp->crp_desc = crd;
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  nxrmutex_unlock(&g_crypto_lock);
   return crp;
 }
 
@@ -727,7 +808,17 @@ out:
 int up_cryptoinitialize(void)
 {
 #ifdef CONFIG_CRYPTO_ALGTEST
-  int ret = crypto_test();
+  int ret;
+#endif
+
+#ifdef CONFIG_CRYPTO_ACCEL
+  /* Before the self tests, so that they check the accelerated code */
+
+  crypto_accel_init();
+#endif
+
+#ifdef CONFIG_CRYPTO_ALGTEST
+  ret = crypto_test();
   if (ret)
     {
       crypterr("ERROR: crypto test failed\n");
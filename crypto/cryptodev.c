@@ -44,6 +44,9 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/drivers/drivers.h>
 
@@ -71,9 +74,29 @@ int cryptodevallowsoft = 0;
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+
+/* An operation queued with CIOCASYNCCRYPT */
+
+struct cryptodev_aop
+{
+  TAILQ_ENTRY(cryptodev_aop) next;
+  struct crypt_op cop;      /* Copy of the operation of the caller */
+  int error;                /* Result, once done */
+};
+
+TAILQ_HEAD(cryptodev_aoplist, cryptodev_aop);
+#endif
+
 struct csession
 {
   TAILQ_ENTRY(csession) next;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  TAILQ_ENTRY(csession) rnext;      /* In the ready list of the fcrypt */
+  struct cryptodev_aoplist todo;    /* Queued, in order */
+  unsigned npending;                /* Queued or being processed */
+  bool ready;
+#endif
   uint64_t sid;
   uint32_t ses;
 
@@ -95,6 +118,18 @@ struct fcrypt
 {
   TAILQ_HEAD(csessionlist, csession) csessions;
   int sesn;
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  mutex_t lock;                     /* Protects the fields below */
+  TAILQ_HEAD(, csession) ready;     /* Sessions with queued operations */
+  struct cryptodev_aoplist done;    /* Finished, not fetched yet */
+  unsigned nqueued;                 /* Queued or finished, not fetched */
+  struct work_s work;
+  bool busy;                        /* The worker is queued or running */
+  bool closing;
+  sem_t idle;                       /* Posted when a closing worker ends */
+  FAR struct pollfd *fds[CONFIG_CRYPTO_CRYPTODEV_ASYNC_NPOLLWAITERS];
+#endif
 };
 
 /****************************************************************************
@@ -178,6 +213,15 @@ int cryptodev_dokey(FAR struct crypt_kop *kop, FAR struct crparam *kvp);
 int cryptodev_cb(FAR struct cryptop *);
 int cryptodevkey_cb(FAR struct cryptkop *);
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static int cryptodev_async_submit(FAR struct fcrypt *fcr,
+                                  FAR const struct crypt_op *cop);
+static void cryptodev_async_kick(FAR struct fcrypt *fcr);
+static int cryptodev_async_fetch(FAR struct fcrypt *fcr,
+                                 FAR struct crypt_op *cop);
+static void cryptodev_async_close(FAR struct fcrypt *fcr);
+#endif
+
 /* ARGSUSED */
 
 static ssize_t cryptof_read(FAR struct file *filep,
@@ -344,6 +388,15 @@ bail:
             return -EINVAL;
           }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+        /* The worker may still be using the session */
+
+        if (cse->npending > 0)
+          {
+            return -EBUSY;
+          }
+#endif
+
         csedelete(fcr, cse);
         error = csefree(cse);
         break;
@@ -357,6 +410,67 @@ bail:
 
         error = cryptodev_op(cse, cop);
         break;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      case CIOCASYNCCRYPT:
+        error = cryptodev_async_submit(fcr, (FAR struct crypt_op *)arg);
+        cryptodev_async_kick(fcr);
+        break;
+      case CIOCASYNCCRYPTM:
+        {
+          FAR struct crypt_mop *mop = (FAR struct crypt_mop *)arg;
+          unsigned i;
+
+          /* Queue the whole batch before the worker starts on it.  If
+           * some of it was queued, that part is done and mop->count says
+           * how much.
+           */
+
+          for (i = 0; i < mop->count; i++)
+            {
+              error = cryptodev_async_submit(fcr, &mop->ops[i]);
+              if (error < 0)
+                {
+                  break;
+                }
+            }
+
+          cryptodev_async_kick(fcr);
+          if (i > 0)
+            {
+              mop->count = i;
+              error = 0;
+            }
+        }
+        break;
+      case CIOCASYNCFETCH:
+        error = cryptodev_async_fetch(fcr, (FAR struct crypt_op *)arg);
+        break;
+      case CIOCASYNCFETCHM:
+        {
+          FAR struct crypt_mop *mop = (FAR struct crypt_mop *)arg;
+          unsigned i;
+
+          if (mop->status == NULL)
+            {
+              return -EINVAL;
+            }
+
+          for (i = 0; i < mop->count; i++)
+            {
+              error = cryptodev_async_fetch(fcr, &mop->ops[i]);
+              if (error == -EAGAIN)
+                {
+                  break;
+                }
+
+              mop->status[i] = error;
+            }
+
+          mop->count = i;
+          error = i > 0 ? 0 : -EAGAIN;
+        }
+        break;
+#endif
       case CIOCKEY:
         error = cryptodev_key((FAR struct crypt_kop *)arg);
         break;
@@ -527,6 +641,10 @@ int cryptodev_op(FAR struct csession *cse,
 dispatch:
   crp->crp_flags = CRYPTO_F_IOV;
   crypto_invoke(crp);
+
+  /* The request may have moved the session to another driver */
+
+  cse->sid = crp->crp_sid;
 processed:
 
   if (crde && (cop->flags & COP_FLAG_UPDATE) == 0)
@@ -681,7 +799,59 @@ fail:
 static int cryptof_poll(FAR struct file *filep,
                         struct pollfd *fds, bool setup)
 {
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct fcrypt *fcr = filep->f_priv;
+  FAR struct pollfd **slot;
+  pollevent_t eventset = 0;
+  int ret = OK;
+  int i;
+
+  nxmutex_lock(&fcr->lock);
+
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_ASYNC_NPOLLWAITERS; i++)
+        {
+          if (fcr->fds[i] == NULL)
+            {
+              fcr->fds[i] = fds;
+              fds->priv   = &fcr->fds[i];
+              break;
+            }
+        }
+
+      if (i >= CONFIG_CRYPTO_CRYPTODEV_ASYNC_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+          goto out;
+        }
+
+      if (!TAILQ_EMPTY(&fcr->done))
+        {
+          eventset |= POLLIN;
+        }
+
+      if (fcr->nqueued < CONFIG_CRYPTO_CRYPTODEV_ASYNC_DEPTH)
+        {
+          eventset |= POLLOUT;
+        }
+
+      poll_notify(&fds, 1, eventset);
+    }
+  else if (fds->priv != NULL)
+    {
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
+
+out:
+  nxmutex_unlock(&fcr->lock);
+  return ret;
+#else
   return 0;
+#endif
 }
 
 /* ARGSUSED */
@@ -691,6 +861,10 @@ static int cryptof_close(FAR struct file *filep)
   FAR struct fcrypt *fcr = filep->f_priv;
   FAR struct csession *cse;
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  cryptodev_async_close(fcr);
+#endif
+
   while ((cse = TAILQ_FIRST(&fcr->csessions)))
     {
       TAILQ_REMOVE(&fcr->csessions, cse, next);
@@ -739,13 +913,28 @@ static int cryptoioctl(FAR struct file *filep, int cmd, unsigned long arg)
   switch (cmd)
     {
       case CRIOGET:
-        fcr = kmm_malloc(sizeof(struct fcrypt));
+        fcr = kmm_zalloc(sizeof(struct fcrypt));
+        if (fcr == NULL)
+          {
+            return -ENOMEM;
+          }
+
         TAILQ_INIT(&fcr->csessions);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+        nxmutex_init(&fcr->lock);
+        nxsem_init(&fcr->idle, 0, 0);
+        TAILQ_INIT(&fcr->ready);
+        TAILQ_INIT(&fcr->done);
+#endif
 
         fd = file_allocate(&g_cryptoinode, 0,
                            0, fcr, 0, true);
         if (fd < 0)
           {
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+            nxsem_destroy(&fcr->idle);
+            nxmutex_destroy(&fcr->lock);
+#endif
             kmm_free(fcr);
             return fd;
           }
@@ -819,6 +1008,11 @@ FAR struct csession *csecreate(FAR struct fcrypt *fcr, uint64_t sid,
       cse->txform = txform;
       cse->thash = thash;
       cse->error = 0;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      TAILQ_INIT(&cse->todo);
+      cse->npending = 0;
+      cse->ready = false;
+#endif
       cseadd(fcr, cse);
     }
 
@@ -844,6 +1038,228 @@ int csefree(FAR struct csession *cse)
   return error;
 }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+
+/****************************************************************************
+ * Name: cryptodev_async_worker
+ *
+ * Description:
+ *   Run the queued operations of an fcrypt on the low priority work queue.
+ *   The sessions take turns: each one has all the operations that it has
+ *   queued so far done as one batch, so that a driver with several
+ *   requests in flight sees them back to back.
+ *
+ ****************************************************************************/
+
+static void cryptodev_async_worker(FAR void *arg)
+{
+  FAR struct fcrypt *fcr = arg;
+  struct cryptodev_aoplist batch;
+  FAR struct cryptodev_aop *aop;
+  FAR struct csession *cse;
+  unsigned n;
+
+  nxmutex_lock(&fcr->lock);
+
+  while (!fcr->closing && (cse = TAILQ_FIRST(&fcr->ready)) != NULL)
+    {
+      TAILQ_REMOVE(&fcr->ready, cse, rnext);
+      cse->ready = false;
+
+      TAILQ_INIT(&batch);
+      TAILQ_CONCAT(&batch, &cse->todo, next);
+      nxmutex_unlock(&fcr->lock);
+
+      n = 0;
+      TAILQ_FOREACH(aop, &batch, next)
+        {
+          aop->error = cryptodev_op(cse, &aop->cop);
+          n++;
+        }
+
+      nxmutex_lock(&fcr->lock);
+
+      TAILQ_CONCAT(&fcr->done, &batch, next);
+      cse->npending -= n;
+      poll_notify(fcr->fds, CONFIG_CRYPTO_CRYPTODEV_ASYNC_NPOLLWAITERS,
+                  POLLIN);
+    }
+
+  fcr->busy = false;
+  if (fcr->closing)
+    {
+      nxsem_post(&fcr->idle);
+    }
+
+  nxmutex_unlock(&fcr->lock);
+}
+
+/****************************************************************************
+ * Name: cryptodev_async_submit
+ *
+ * Description:
+ *   Queue a copy of an operation on its session.  The worker is not
+ *   started, see cryptodev_async_kick().
+ *
+ ****************************************************************************/
+
+static int cryptodev_async_submit(FAR struct fcrypt *fcr,
+                                  FAR const struct crypt_op *cop)
+{
+  FAR struct cryptodev_aop *aop;
+  FAR struct csession *cse;
+
+  cse = csefind(fcr, cop->ses);
+  if (cse == NULL)
+    {
+      return -EINVAL;
+    }
+
+  aop = kmm_malloc(sizeof(*aop));
+  if (aop == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  aop->cop   = *cop;
+  aop->error = 0;
+
+  nxmutex_lock(&fcr->lock);
+
+  if (fcr->nqueued >= CONFIG_CRYPTO_CRYPTODEV_ASYNC_DEPTH)
+    {
+      nxmutex_unlock(&fcr->lock);
+      kmm_free(aop);
+      return -EAGAIN;
+    }
+
+  fcr->nqueued++;
+  cse->npending++;
+  TAILQ_INSERT_TAIL(&cse->todo, aop, next);
+
+  if (!cse->ready)
+    {
+      TAILQ_INSERT_TAIL(&fcr->ready, cse, rnext);
+      cse->ready = true;
+    }
+
+  nxmutex_unlock(&fcr->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_async_kick
+ *
+ * Description:
+ *   Start the worker if there is queued work and it is not running yet.
+ *
+ ****************************************************************************/
+
+static void cryptodev_async_kick(FAR struct fcrypt *fcr)
+{
+  nxmutex_lock(&fcr->lock);
+
+  if (!fcr->busy && !TAILQ_EMPTY(&fcr->ready))
+    {
+      fcr->busy = true;
+      work_queue(LPWORK, &fcr->work, cryptodev_async_worker, fcr, 0);
+    }
+
+  nxmutex_unlock(&fcr->lock);
+}
+
+/****************************************************************************
+ * Name: cryptodev_async_fetch
+ *
+ * Description:
+ *   Take back the oldest finished operation.
+ *
+ * Returned Value:
+ *   The result of the operation, or -EAGAIN if none has finished.
+ *
+ ****************************************************************************/
+
+static int cryptodev_async_fetch(FAR struct fcrypt *fcr,
+                                 FAR struct crypt_op *cop)
+{
+  FAR struct cryptodev_aop *aop;
+  int error;
+
+  nxmutex_lock(&fcr->lock);
+
+  aop = TAILQ_FIRST(&fcr->done);
+  if (aop == NULL)
+    {
+      nxmutex_unlock(&fcr->lock);
+      return -EAGAIN;
+    }
+
+  TAILQ_REMOVE(&fcr->done, aop, next);
+  fcr->nqueued--;
+  poll_notify(fcr->fds, CONFIG_CRYPTO_CRYPTODEV_ASYNC_NPOLLWAITERS,
+              POLLOUT);
+
+  nxmutex_unlock(&fcr->lock);
+
+  *cop  = aop->cop;
+  error = aop->error;
+  kmm_free(aop);
+  return error;
+}
+
+/****************************************************************************
+ * Name: cryptodev_async_close
+ *
+ * Description:
+ *   Stop the worker of a closing fcrypt and drop the operations that are
+ *   still queued or not fetched.
+ *
+ ****************************************************************************/
+
+static void cryptodev_async_close(FAR struct fcrypt *fcr)
+{
+  FAR struct cryptodev_aop *aop;
+  FAR struct csession *cse;
+
+  nxmutex_lock(&fcr->lock);
+
+  fcr->closing = true;
+  if (fcr->busy && work_cancel(LPWORK, &fcr->work) == OK)
+    {
+      fcr->busy = false;
+    }
+
+  /* The worker is running, it stops after the batch at hand */
+
+  while (fcr->busy)
+    {
+      nxmutex_unlock(&fcr->lock);
+      nxsem_wait_uninterruptible(&fcr->idle);
+      nxmutex_lock(&fcr->lock);
+    }
+
+  nxmutex_unlock(&fcr->lock);
+
+  TAILQ_FOREACH(cse, &fcr->csessions, next)
+    {
+      while ((aop = TAILQ_FIRST(&cse->todo)) != NULL)
+        {
+          TAILQ_REMOVE(&cse->todo, aop, next);
+          kmm_free(aop);
+        }
+    }
+
+  while ((aop = TAILQ_FIRST(&fcr->done)) != NULL)
+    {
+      TAILQ_REMOVE(&fcr->done, aop, next);
+      kmm_free(aop);
+    }
+
+  nxsem_destroy(&fcr->idle);
+  nxmutex_destroy(&fcr->lock);
+}
+#endif /* CONFIG_CRYPTO_CRYPTODEV_ASYNC */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -859,4 +1275,8 @@ void devcrypto_register(void)
 #ifdef CONFIG_CRYPTO_CRYPTODEV_HARDWARE
   hwcr_init();
 #endif
+
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCH
+  crypto_bench();
+#endif
 }
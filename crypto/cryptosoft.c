@@ -1113,6 +1113,7 @@ void swcr_init(void)
       PANIC();
     }
 
+  bzero(algs, sizeof(algs));
   algs[CRYPTO_3DES_CBC] = CRYPTO_ALG_FLAG_SUPPORTED;
   algs[CRYPTO_BLF_CBC] = CRYPTO_ALG_FLAG_SUPPORTED;
   algs[CRYPTO_CAST_CBC] = CRYPTO_ALG_FLAG_SUPPORTED;
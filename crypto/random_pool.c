@@ -35,9 +35,17 @@
 #include <nuttx/random.h>
 #include <nuttx/board.h>
 #include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/mutex.h>
 #include <nuttx/crypto/blake2s.h>
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+#  include <sched.h>
+
+#  define KEYSTREAM_ONLY
+#  include "chacha_private.h"
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -45,6 +53,13 @@
 #define ROTL_32(x,n) (((x) << (n)) | ((x) >> (32 - (n))))
 #define ROTR_32(x,n) (((x) >> (n)) | ((x) << (32 - (n))))
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+#  define RNG_CPU_KEYSZ   32
+#  define RNG_CPU_IVSZ    8
+#  define RNG_CPU_SEEDSZ  (RNG_CPU_KEYSZ + RNG_CPU_IVSZ)
+#  define RNG_CPU_BUFSZ   (16 * 64)   /* Sixteen ChaCha20 blocks */
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -69,10 +84,27 @@ struct rng_s
   volatile uint8_t rd_rotate;
   volatile uint8_t rd_prev_time;
   volatile uint16_t rd_prev_irq;
+  volatile uint32_t rd_generation; /* Incremented on every reseed */
   bool output_initialized;
   struct blake2xs_rng_s blake2xs;
 };
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+/* Output generator of one CPU.  Only the task running on that CPU with the
+ * scheduler locked touches it, so no lock is needed.
+ */
+
+struct rng_cpu_s
+{
+  chacha_ctx ctx;                /* Current key and IV */
+  uint32_t generation;           /* rd_generation at the last reseed */
+  size_t count;                  /* Bytes left before the next reseed */
+  size_t have;                   /* Unused bytes at the end of buf */
+  bool seeded;
+  uint8_t buf[RNG_CPU_BUFSZ];    /* Keystream, the key comes off the front */
+};
+#endif
+
 enum
 {
   POOL_SIZE = ENTROPY_POOL_SIZE,
@@ -91,6 +123,10 @@ static struct rng_s g_rng =
   NXMUTEX_INITIALIZER,
 };
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+static struct rng_cpu_s g_rng_cpu[CONFIG_SMP_NCPUS];
+#endif
+
 #ifdef CONFIG_BOARD_ENTROPY_POOL
 /* Entropy pool structure can be provided by board source. Use for this is,
  * for example, allocate entropy pool from special area of RAM which content
@@ -304,6 +340,7 @@ static void rng_reseed(void)
   g_rng.blake2xs.param.node_depth = 0;
 
   g_rng.output_initialized = true;
+  g_rng.rd_generation++;
 }
 
 static void rng_buf_internal(FAR uint8_t *bytes, size_t nbytes)
@@ -357,6 +394,153 @@ static void rng_buf_internal(FAR uint8_t *bytes, size_t nbytes)
     }
 }
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+/* Per-CPU output generators.
+ *
+ * Each CPU runs its own ChaCha20 keystream generator seeded from the
+ * BLAKE2Xs output above, so that arc4random_buf() does not serialize all
+ * callers on rd_lock.  The key is replaced from the front of every new
+ * buffer of keystream ("fast key erasure", as in OpenBSD arc4random), and
+ * handed-out bytes are wiped from the buffer, so a later compromise of the
+ * state does not reveal earlier output.
+ */
+
+static void rng_cpu_rekey(FAR struct rng_cpu_s *rng,
+                          FAR const uint8_t *seed)
+{
+  int i;
+
+  chacha_encrypt_bytes(&rng->ctx, NULL, rng->buf, sizeof(rng->buf));
+
+  /* Mix in new seed material, if any */
+
+  if (seed != NULL)
+    {
+      for (i = 0; i < RNG_CPU_SEEDSZ; i++)
+        {
+          rng->buf[i] ^= seed[i];
+        }
+    }
+
+  /* Immediately reinitialize for backtracking resistance */
+
+  chacha_keysetup(&rng->ctx, rng->buf, RNG_CPU_KEYSZ * 8);
+  chacha_ivsetup(&rng->ctx, rng->buf + RNG_CPU_KEYSZ, NULL);
+  explicit_bzero(rng->buf, RNG_CPU_SEEDSZ);
+  rng->have = sizeof(rng->buf) - RNG_CPU_SEEDSZ;
+}
+
+static void rng_cpu_seed(FAR struct rng_cpu_s *rng,
+                         FAR const uint8_t *seed, uint32_t generation)
+{
+  if (!rng->seeded)
+    {
+      chacha_keysetup(&rng->ctx, seed, RNG_CPU_KEYSZ * 8);
+      chacha_ivsetup(&rng->ctx, seed + RNG_CPU_KEYSZ, NULL);
+      rng->seeded = true;
+    }
+
+  rng_cpu_rekey(rng, seed);
+  rng->generation = generation;
+  rng->count = CONFIG_CRYPTO_RANDOM_POOL_PERCPU_RESEED;
+}
+
+/****************************************************************************
+ * Name: rng_cpu_get
+ *
+ * Description:
+ *   Lock the scheduler and return the generator of the current CPU, ready
+ *   to produce output.  The caller calls sched_unlock() when done with it.
+ *
+ *   The entropy pool is only waited for the first time a CPU produces
+ *   output.  Later reseeds, when the generator has given out
+ *   CONFIG_CRYPTO_RANDOM_POOL_PERCPU_RESEED bytes or the pool has been
+ *   reseeded since, only try the pool lock; if another CPU holds it, the
+ *   current key keeps being used and the reseed is retried on the next
+ *   call.
+ *
+ ****************************************************************************/
+
+static FAR struct rng_cpu_s *rng_cpu_get(void)
+{
+  FAR struct rng_cpu_s *rng;
+  uint8_t seed[RNG_CPU_SEEDSZ];
+  uint32_t generation;
+
+  sched_lock();
+  rng = &g_rng_cpu[up_cpu_index()];
+
+  if (!rng->seeded)
+    {
+      /* Blocking on the mutex may move us to another CPU, seed whichever
+       * one we are on afterwards.
+       */
+
+      sched_unlock();
+
+      nxmutex_lock(&g_rng.rd_lock);
+      rng_buf_internal(seed, sizeof(seed));
+      generation = g_rng.rd_generation;
+      nxmutex_unlock(&g_rng.rd_lock);
+
+      sched_lock();
+      rng = &g_rng_cpu[up_cpu_index()];
+      rng_cpu_seed(rng, seed, generation);
+      explicit_bzero(seed, sizeof(seed));
+    }
+  else if ((rng->count == 0 || rng->generation != g_rng.rd_generation ||
+            g_rng.rd_newentr >= MAX_SEED_NEW_ENTROPY_WORDS) &&
+           nxmutex_trylock(&g_rng.rd_lock) >= 0)
+    {
+      rng_buf_internal(seed, sizeof(seed));
+      generation = g_rng.rd_generation;
+      nxmutex_unlock(&g_rng.rd_lock);
+
+      rng_cpu_seed(rng, seed, generation);
+      explicit_bzero(seed, sizeof(seed));
+    }
+
+  return rng;
+}
+
+static void rng_cpu_buf(FAR uint8_t *bytes, size_t nbytes)
+{
+  FAR struct rng_cpu_s *rng;
+  FAR uint8_t *keystream;
+  size_t chunk;
+  size_t n;
+
+  /* Give the scheduler a chance after every buffer of keystream */
+
+  while (nbytes > 0)
+    {
+      rng   = rng_cpu_get();
+      chunk = MIN(nbytes, RNG_CPU_BUFSZ - RNG_CPU_SEEDSZ);
+      nbytes -= chunk;
+
+      while (chunk > 0)
+        {
+          if (rng->have == 0)
+            {
+              rng_cpu_rekey(rng, NULL);
+            }
+
+          n = MIN(chunk, rng->have);
+          keystream = rng->buf + sizeof(rng->buf) - rng->have;
+          memcpy(bytes, keystream, n);
+          explicit_bzero(keystream, n);
+
+          rng->have -= n;
+          rng->count = rng->count > n ? rng->count - n : 0;
+          bytes += n;
+          chunk -= n;
+        }
+
+      sched_unlock();
+    }
+}
+#endif /* CONFIG_CRYPTO_RANDOM_POOL_PERCPU */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -529,9 +713,13 @@ void up_randompool_initialize(void)
 
 void arc4random_buf(FAR void *bytes, size_t nbytes)
 {
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_PERCPU
+  rng_cpu_buf(bytes, nbytes);
+#else
   nxmutex_lock(&g_rng.rd_lock);
   rng_buf_internal(bytes, nbytes);
   nxmutex_unlock(&g_rng.rd_lock);
+#endif
 }
 
 /****************************************************************************
@@ -170,7 +170,7 @@
  */
 
 void sha512last(FAR SHA2_CTX *);
-void sha256transform(FAR uint32_t *, FAR const uint8_t *);
+void sha256transform_c(FAR uint32_t *, FAR const uint8_t *);
 void sha512transform(FAR uint64_t *, FAR const uint8_t *);
 
 /* SHA-XYZ INITIAL HASH VALUES AND CONSTANTS */
@@ -348,7 +348,7 @@ void sha256init(FAR SHA2_CTX *context)
     }                                                              \
 while(0)
 
-void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
+void sha256transform_c(FAR uint32_t *state, FAR const uint8_t *data)
 {
   uint32_t a;
   uint32_t b;
@@ -424,7 +424,7 @@ void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
 
 #else /* SHA2_UNROLL_TRANSFORM */
 
-void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
+void sha256transform_c(FAR uint32_t *state, FAR const uint8_t *data)
 {
   uint32_t a;
   uint32_t b;
@@ -521,6 +521,11 @@ void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
 
 #endif /* SHA2_UNROLL_TRANSFORM */
 
+/* Allow overriding with optimized transform function */
+
+CODE void (*sha256transform)(FAR uint32_t *,
+                             FAR const uint8_t *) = sha256transform_c;
+
 void sha256update(FAR SHA2_CTX *context,
                   FAR const void *dataptr,
                   size_t len)
@@ -33,14 +33,60 @@
 
 #include <sys/param.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
 
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCH
+#  include <inttypes.h>
+#  include <syslog.h>
+#  include <crypto/cryptodev.h>
+#endif
+
 #ifdef CONFIG_CRYPTO_ALGTEST
 
 #include "testmngr.h"
 
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCH
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct crypto_bench_s
+{
+  FAR const char *name;
+  int alg;
+  int klen;                  /* Key length in bits, 0 for hashes */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct crypto_bench_s g_crypto_bench[] =
+{
+  { "aes-128-cbc", CRYPTO_AES_CBC,  128 },
+  { "aes-256-cbc", CRYPTO_AES_CBC,  256 },
+  { "aes-128-ctr", CRYPTO_AES_CTR,  128 + 32 },
+  { "sha1",        CRYPTO_SHA1,     0 },
+  { "sha256",      CRYPTO_SHA2_256, 0 },
+};
+
+static const uint8_t g_crypto_bench_key[36] =
+{
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+  0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+  0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+  0x20, 0x21, 0x22, 0x23,
+};
+
+extern FAR struct cryptocap *crypto_drivers;
+extern int crypto_drivers_num;
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -118,6 +164,181 @@ int crypto_test(void)
   return OK;
 }
 
+#ifdef CONFIG_CRYPTO_ALGTEST_BENCH
+
+/****************************************************************************
+ * Name: crypto_bench_run
+ *
+ * Description:
+ *   Time CONFIG_CRYPTO_ALGTEST_BENCH_ITERATIONS requests of
+ *   CONFIG_CRYPTO_ALGTEST_BENCH_SIZE bytes of one algorithm on one driver.
+ *
+ * Returned Value:
+ *   The throughput in KiB/s, or a negated errno value.
+ *
+ ****************************************************************************/
+
+static int crypto_bench_run(uint32_t hid,
+                            FAR const struct crypto_bench_s *bench,
+                            FAR uint8_t *buf)
+{
+  uint8_t mac[AALG_MAX_RESULT_LEN];
+  uint8_t iv[EALG_MAX_BLOCK_LEN];
+  FAR struct cryptodesc *crd;
+  FAR struct cryptop *crp;
+  struct cryptoini cri;
+  struct timespec start;
+  struct timespec end;
+  uint64_t bytes;
+  uint64_t usec;
+  uint64_t sid;
+  int ret;
+  int i;
+
+  memset(&cri, 0, sizeof(cri));
+  memset(iv, 0x5a, sizeof(iv));
+  cri.cri_alg  = bench->alg;
+  cri.cri_klen = bench->klen;
+  cri.cri_key  = (caddr_t)g_crypto_bench_key;
+
+  ret = crypto_driver_newsession(hid, &sid, &cri);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  crp = crypto_getreq(1);
+  if (crp == NULL)
+    {
+      crypto_freesession(sid);
+      return -ENOMEM;
+    }
+
+  crd            = crp->crp_desc;
+  crd->CRD_INI   = cri;
+  crd->crd_len   = CONFIG_CRYPTO_ALGTEST_BENCH_SIZE;
+  crd->crd_flags = bench->klen ? CRD_F_ENCRYPT : CRD_F_UPDATE;
+
+  crp->crp_sid   = sid;
+  crp->crp_ilen  = CONFIG_CRYPTO_ALGTEST_BENCH_SIZE;
+  crp->crp_flags = CRYPTO_F_IOV;
+  crp->crp_buf   = (caddr_t)buf;
+  crp->crp_iv    = bench->klen ? (caddr_t)iv : NULL;
+  crp->crp_mac   = (caddr_t)mac;
+
+  clock_systime_timespec(&start);
+
+  for (i = 0; i < CONFIG_CRYPTO_ALGTEST_BENCH_ITERATIONS; i++)
+    {
+      crypto_invoke(crp);
+      if (crp->crp_etype != 0 || crp->crp_sid != sid)
+        {
+          break;
+        }
+    }
+
+  if (i == CONFIG_CRYPTO_ALGTEST_BENCH_ITERATIONS && bench->klen == 0)
+    {
+      /* Finish the hash */
+
+      crd->crd_flags = 0;
+      crypto_invoke(crp);
+    }
+
+  clock_systime_timespec(&end);
+
+  ret = crp->crp_etype;
+  if (ret == 0 && crp->crp_sid != sid)
+    {
+      /* The driver passed the session on to another one */
+
+      ret = -ENOTSUP;
+    }
+
+  crypto_freesession(crp->crp_sid);
+  crypto_freereq(crp);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  clock_timespec_subtract(&end, &start, &end);
+  usec  = (uint64_t)end.tv_sec * USEC_PER_SEC + end.tv_nsec / NSEC_PER_USEC;
+  bytes = (uint64_t)CONFIG_CRYPTO_ALGTEST_BENCH_SIZE *
+          CONFIG_CRYPTO_ALGTEST_BENCH_ITERATIONS;
+
+  return (int)(bytes * USEC_PER_SEC / 1024 / MAX(usec, 1));
+}
+
+/****************************************************************************
+ * Name: crypto_bench
+ *
+ * Description:
+ *   Report the throughput of each registered driver for the algorithms of
+ *   g_crypto_bench that it supports, along with the priority with which it
+ *   claimed them.
+ *
+ ****************************************************************************/
+
+void crypto_bench(void)
+{
+  FAR const struct crypto_bench_s *bench;
+  FAR struct cryptocap *cpc;
+  FAR uint8_t *buf;
+  uint32_t hid;
+  int prio;
+  int ret;
+  int i;
+
+  buf = kmm_zalloc(CONFIG_CRYPTO_ALGTEST_BENCH_SIZE);
+  if (buf == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < nitems(g_crypto_bench); i++)
+    {
+      bench = &g_crypto_bench[i];
+
+      for (hid = 0; hid < crypto_drivers_num; hid++)
+        {
+          cpc = &crypto_drivers[hid];
+          if (cpc->cc_process == NULL ||
+              (cpc->cc_alg[bench->alg] & CRYPTO_ALG_FLAG_SUPPORTED) == 0)
+            {
+              continue;
+            }
+
+          prio = CRYPTO_ALG_PRIO(cpc->cc_alg[bench->alg]);
+          if (prio == 0)
+            {
+              prio = (cpc->cc_flags & CRYPTOCAP_F_SOFTWARE) ?
+                     CRYPTO_PRIO_SOFTWARE : CRYPTO_PRIO_HARDWARE;
+            }
+
+          ret = crypto_bench_run(hid, bench, buf);
+          if (ret < 0)
+            {
+              syslog(LOG_INFO, "crypto: %-12s driver %" PRIu32
+                     " (%s): failed: %d\n", bench->name, hid,
+                     cpc->cc_flags & CRYPTOCAP_F_SOFTWARE ? "sw" : "hw",
+                     ret);
+            }
+          else
+            {
+              syslog(LOG_INFO, "crypto: %-12s driver %" PRIu32
+                     " (%s, prio %d): %d KiB/s\n", bench->name, hid,
+                     cpc->cc_flags & CRYPTOCAP_F_SOFTWARE ? "sw" : "hw",
+                     prio, ret);
+            }
+        }
+    }
+
+  kmm_free(buf);
+}
+#endif /* CONFIG_CRYPTO_ALGTEST_BENCH */
+
 #else /* CONFIG_CRYPTO_ALGTEST */
 
 int crypto_test(void)
@@ -24,10 +24,12 @@
 
 #include <nuttx/config.h>
 #include <nuttx/audio/audio_dma.h>
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/queue.h>
 
 #include <debug.h>
+#include <string.h>
 
 /****************************************************************************
  * Private Types
@@ -47,6 +49,9 @@ struct audio_dma_s
   struct dq_queue_s pendq;
   apb_samp_t buffer_size;
   apb_samp_t buffer_num;
+#ifdef CONFIG_AUDIO_MMAP
+  struct audio_ring_s *ring;
+#endif
 };
 
 /****************************************************************************
@@ -99,6 +104,11 @@ static int audio_dma_ioctl(struct audio_lowerhalf_s *dev, int cmd,
                            unsigned long arg);
 static void audio_dma_callback(struct dma_chan_s *chan, void *arg,
                                ssize_t len);
+#ifdef CONFIG_AUDIO_MMAP
+static int audio_dma_getring(struct audio_dma_s *audio_dma,
+                             struct audio_ring_s **ring);
+static void audio_dma_period(struct audio_dma_s *audio_dma);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -280,6 +290,17 @@ static int audio_dma_start(struct audio_lowerhalf_s *dev)
 {
   struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
 
+#ifdef CONFIG_AUDIO_MMAP
+  /* Write back what the application put in the ring before the start */
+
+  if (audio_dma->ring && audio_dma->playback)
+    {
+      up_clean_dcache((uintptr_t)audio_dma->ring + AUDIO_RING_DATA,
+                      (uintptr_t)audio_dma->ring + AUDIO_RING_DATA +
+                      audio_dma->ring->buffer_size);
+    }
+#endif
+
   return DMA_START_CYCLIC(audio_dma->chan, audio_dma_callback, audio_dma,
                           audio_dma->dst_addr, audio_dma->src_addr,
                           audio_dma->buffer_num * audio_dma->buffer_size,
@@ -318,6 +339,15 @@ static int audio_dma_stop(struct audio_lowerhalf_s *dev)
                        NULL, OK);
 #endif
   audio_dma->xrun = false;
+
+#ifdef CONFIG_AUDIO_MMAP
+  if (audio_dma->ring)
+    {
+      audio_dma->ring->hw_ptr   = 0;
+      audio_dma->ring->appl_ptr = 0;
+    }
+#endif
+
   return OK;
 }
 #endif
@@ -342,6 +372,13 @@ static int audio_dma_resume(struct audio_lowerhalf_s *dev)
 {
   struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
 
+#ifdef CONFIG_AUDIO_MMAP
+  if (audio_dma->ring)
+    {
+      return DMA_RESUME(audio_dma->chan);
+    }
+#endif
+
   if (dq_empty(&audio_dma->pendq))
     {
       return -EINVAL;
@@ -357,6 +394,15 @@ static int audio_dma_allocbuffer(struct audio_lowerhalf_s *dev,
   struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
   struct ap_buffer_s *apb;
 
+#ifdef CONFIG_AUDIO_MMAP
+  /* The buffers are part of the ring in the mmap() mode */
+
+  if (audio_dma->ring)
+    {
+      return -EBUSY;
+    }
+#endif
+
   if (bufdesc->numbytes != audio_dma->buffer_size)
     {
       return -EINVAL;
@@ -478,8 +524,17 @@ static int audio_dma_ioctl(struct audio_lowerhalf_s *dev, int cmd,
         kumm_free(audio_dma->alloc_addr);
         audio_dma->alloc_addr = NULL;
         audio_dma->alloc_index = 0;
+#ifdef CONFIG_AUDIO_MMAP
+        audio_dma->ring = NULL;
+#endif
 
         return OK;
+
+#ifdef CONFIG_AUDIO_MMAP
+      case AUDIOIOC_GETRING:
+        audinfo("AUDIOIOC_GETRING:\n");
+        return audio_dma_getring(audio_dma, (struct audio_ring_s **)arg);
+#endif
     }
 
   return -ENOTTY;
@@ -510,6 +565,14 @@ static void audio_dma_callback(struct dma_chan_s *chan,
   struct ap_buffer_s *apb;
   bool final = false;
 
+#ifdef CONFIG_AUDIO_MMAP
+  if (audio_dma->ring)
+    {
+      audio_dma_period(audio_dma);
+      return;
+    }
+#endif
+
   apb = (struct ap_buffer_s *)dq_remfirst(&audio_dma->pendq);
   if (!apb)
     {
@@ -551,6 +614,110 @@ static void audio_dma_callback(struct dma_chan_s *chan,
     }
 }
 
+#ifdef CONFIG_AUDIO_MMAP
+/* Give the ring buffer of the mmap() mode, allocating it along with the
+ * samples the first time.  The DMA then runs over the samples of the ring
+ * and moves its hardware pointer on at each period, instead of dequeuing
+ * an ap_buffer_s.
+ */
+
+static int audio_dma_getring(struct audio_dma_s *audio_dma,
+                             struct audio_ring_s **ring)
+{
+  uint32_t size = audio_dma->buffer_num * audio_dma->buffer_size;
+  uintptr_t addr;
+
+  if (audio_dma->ring == NULL)
+    {
+      /* The buffers of ap_buffer_s mode are in use */
+
+      if (audio_dma->alloc_index != 0)
+        {
+          return -EBUSY;
+        }
+
+      kumm_free(audio_dma->alloc_addr);
+      audio_dma->alloc_addr = kumm_memalign(AUDIO_RING_DATA,
+                                            AUDIO_RING_DATA + size);
+      if (!audio_dma->alloc_addr)
+        {
+          return -ENOMEM;
+        }
+
+      memset(audio_dma->alloc_addr, 0, AUDIO_RING_DATA + size);
+      up_flush_dcache((uintptr_t)audio_dma->alloc_addr,
+                      (uintptr_t)audio_dma->alloc_addr +
+                      AUDIO_RING_DATA + size);
+
+      audio_dma->ring = (struct audio_ring_s *)audio_dma->alloc_addr;
+      audio_dma->ring->buffer_size = size;
+      audio_dma->ring->period_size = audio_dma->buffer_size;
+      audio_dma->ring->playback    = audio_dma->playback;
+
+      addr = up_addrenv_va_to_pa(audio_dma->alloc_addr + AUDIO_RING_DATA);
+      if (audio_dma->playback)
+        audio_dma->src_addr = addr;
+      else
+        audio_dma->dst_addr = addr;
+    }
+
+  *ring = audio_dma->ring;
+  return OK;
+}
+
+/* A period of the ring is done, called from the DMA interrupt */
+
+static void audio_dma_period(struct audio_dma_s *audio_dma)
+{
+  struct audio_ring_s *ring = audio_dma->ring;
+  uint8_t *data = audio_dma->alloc_addr + AUDIO_RING_DATA;
+  uint32_t period = ring->period_size;
+  uint32_t next;
+
+  ring->hw_ptr += period;
+
+  if (audio_dma->playback)
+    {
+      /* The DMA plays the period at hw_ptr now and the next one once this
+       * one is over.  If the application has not even written the current
+       * one it is behind, play silence next rather than the samples of the
+       * last round.
+       */
+
+      if ((int32_t)(ring->appl_ptr - ring->hw_ptr) < (int32_t)period)
+        {
+          ring->xruns++;
+
+          next = (ring->hw_ptr + period) % ring->buffer_size;
+          memset(data + next, 0, period);
+          up_clean_dcache((uintptr_t)data + next,
+                          (uintptr_t)data + next + period);
+        }
+    }
+  else
+    {
+      /* Drop the stale lines of the period the DMA just wrote */
+
+      next = (ring->hw_ptr - period) % ring->buffer_size;
+      up_invalidate_dcache((uintptr_t)data + next,
+                           (uintptr_t)data + next + period);
+
+      if (ring->hw_ptr - ring->appl_ptr > ring->buffer_size)
+        {
+          ring->xruns++;
+        }
+    }
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  audio_dma->dev.upper(audio_dma->dev.priv, AUDIO_CALLBACK_PERIOD,
+                       NULL, OK, NULL);
+#else
+  audio_dma->dev.upper(audio_dma->dev.priv, AUDIO_CALLBACK_PERIOD,
+                       NULL, OK);
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
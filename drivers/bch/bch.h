@@ -40,6 +40,16 @@
 
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+/* The buffered sectors: a window of up to CONFIG_BCH_CACHE_NSECTORS
+ * consecutive sectors starting at bch->sector.
+ */
+
+#define BCH_BUFFERED(b, s) \
+  ((b)->sector != (size_t)-1 && (s) >= (b)->sector && \
+   (s) < (b)->sector + (b)->nbuffered)
+#define BCH_SECTBUF(b, s) \
+  (&(b)->buffer[((s) - (b)->sector) * (b)->sectsize])
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -49,13 +59,17 @@ struct bchlib_s
   FAR struct inode *inode; /* I-node of the block driver */
   uint32_t sectsize;       /* The size of one sector on the device */
   size_t nsectors;         /* Number of sectors supported by the device */
-  size_t sector;           /* The current sector in the buffer */
+  size_t sector;           /* The first sector in the buffer */
+  size_t nbuffered;        /* Number of sectors in the buffer */
+  size_t dirtyfirst;       /* First modified sector in the buffer */
+  size_t dirtylast;        /* Last modified sector in the buffer */
+  size_t readahead;        /* Number of sectors to read on the next miss */
   mutex_t lock;            /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
   bool dirty;              /* true: Data has been written to the buffer */
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* CONFIG_BCH_CACHE_NSECTORS sector buffer */
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -83,6 +97,8 @@ EXTERN const struct file_operations g_bch_fops;
 
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch, bool discard);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_allocsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN void bchlib_dirtysector(FAR struct bchlib_s *bch, size_t sector);
 
 #undef EXTERN
 #if defined(__cplusplus)
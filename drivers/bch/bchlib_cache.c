@@ -59,10 +59,10 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, size_t sector, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)BCH_SECTBUF(bch, sector);
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -70,7 +70,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -86,6 +86,19 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: bch_cypher_range
+ ****************************************************************************/
+
+static void bch_cypher_range(FAR struct bchlib_s *bch, size_t sector,
+                             size_t nsectors, int encrypt)
+{
+  while (nsectors-- > 0)
+    {
+      bch_cypher(bch, sector++, encrypt);
+    }
+}
 #endif
 
 /****************************************************************************
@@ -96,7 +109,8 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
  * Name: bchlib_flushsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Flush the modified sectors of the sector buffer (if dirty) with one
+ *   write, and optionally empty the buffer.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -106,6 +120,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 {
   FAR struct inode *inode;
+  size_t nsectors;
   ssize_t ret = OK;
 
   /* Check if the sector has been modified and is out of synch with the
@@ -114,39 +129,42 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 
   if (bch->dirty)
     {
-      inode = bch->inode;
+      inode    = bch->inode;
+      nsectors = bch->dirtylast - bch->dirtyfirst + 1;
 
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      bch_cypher_range(bch, bch->dirtyfirst, nsectors, CYPHER_ENCRYPT);
 #endif
 
-      /* Write the sector to the media */
-
-      ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
-      if (ret < 0)
-        {
-          ferr("Write failed: %zd\n", ret);
-          return (int)ret;
-        }
+      /* Write the sectors to the media */
 
+      ret = inode->u.i_bops->write(inode, BCH_SECTBUF(bch, bch->dirtyfirst),
+                                   bch->dirtyfirst, nsectors);
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Computation overhead to save memory for extra sector buffer
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher_range(bch, bch->dirtyfirst, nsectors, CYPHER_DECRYPT);
 #endif
 
-      /* The sector is now in sync with the media */
+      if (ret < 0)
+        {
+          ferr("Write failed: %zd\n", ret);
+          return (int)ret;
+        }
+
+      /* The sectors are now in sync with the media */
 
       bch->dirty = false;
     }
 
   if (discard)
     {
-      bch->sector = (size_t)-1;
+      bch->sector    = (size_t)-1;
+      bch->nbuffered = 0;
     }
 
   return (int)ret;
@@ -156,7 +174,10 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
  * Name: bchlib_readsector
  *
  * Description:
- *   Read the current sector contents into buffer
+ *   Make sure that a sector is in the sector buffer, reading it if it is
+ *   not.  A miss right after the buffered sectors is taken for sequential
+ *   access and doubles the number of sectors read ahead, any other miss
+ *   resets it to one.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -166,12 +187,27 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
   FAR struct inode *inode;
+  size_t nsectors;
   ssize_t ret = OK;
 
-  if (bch->sector != sector)
+  if (!BCH_BUFFERED(bch, sector))
     {
       inode = bch->inode;
 
+      if (bch->sector != (size_t)-1 &&
+          sector == bch->sector + bch->nbuffered)
+        {
+          bch->readahead *= 2;
+          if (bch->readahead > CONFIG_BCH_CACHE_NSECTORS)
+            {
+              bch->readahead = CONFIG_BCH_CACHE_NSECTORS;
+            }
+        }
+      else
+        {
+          bch->readahead = 1;
+        }
+
       ret = bchlib_flushsector(bch, true);
       if (ret < 0)
         {
@@ -179,18 +215,106 @@ int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
           return (int)ret;
         }
 
-      ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+      nsectors = bch->readahead;
+      if (nsectors > bch->nsectors - sector)
+        {
+          nsectors = bch->nsectors - sector;
+        }
+
+      ret = inode->u.i_bops->read(inode, bch->buffer, sector, nsectors);
       if (ret < 0)
         {
           ferr("Read failed: %zd\n", ret);
           return (int)ret;
         }
 
-      bch->sector = sector;
+      /* The driver may return fewer sectors than requested */
+
+      if (ret == 0)
+        {
+          return -EIO;
+        }
+
+      bch->sector    = sector;
+      bch->nbuffered = ret;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher_range(bch, sector, ret, CYPHER_DECRYPT);
 #endif
     }
 
   return (int)ret;
 }
+
+/****************************************************************************
+ * Name: bchlib_allocsector
+ *
+ * Description:
+ *   Make room in the sector buffer for a sector that is about to be
+ *   completely overwritten, without reading it.  The sector right after
+ *   the buffered ones is appended while the buffer has room, so that a
+ *   sequence of sector writes is coalesced.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_allocsector(FAR struct bchlib_s *bch, size_t sector)
+{
+  int ret;
+
+  if (BCH_BUFFERED(bch, sector))
+    {
+      return OK;
+    }
+
+  if (bch->sector != (size_t)-1 &&
+      sector == bch->sector + bch->nbuffered &&
+      bch->nbuffered < CONFIG_BCH_CACHE_NSECTORS)
+    {
+      bch->nbuffered++;
+      return OK;
+    }
+
+  ret = bchlib_flushsector(bch, true);
+  if (ret < 0)
+    {
+      ferr("Flush failed: %d\n", ret);
+      return ret;
+    }
+
+  bch->sector    = sector;
+  bch->nbuffered = 1;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_dirtysector
+ *
+ * Description:
+ *   Record that a buffered sector has been modified.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+void bchlib_dirtysector(FAR struct bchlib_s *bch, size_t sector)
+{
+  DEBUGASSERT(BCH_BUFFERED(bch, sector));
+
+  if (!bch->dirty)
+    {
+      bch->dirty      = true;
+      bch->dirtyfirst = sector;
+      bch->dirtylast  = sector;
+    }
+  else if (sector < bch->dirtyfirst)
+    {
+      bch->dirtyfirst = sector;
+    }
+  else if (sector > bch->dirtylast)
+    {
+      bch->dirtylast = sector;
+    }
+}
@@ -94,100 +94,75 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, size_t offset,
       return 0;
     }
 
-  /* Read the initial partial sector */
-
   bytesread = 0;
-  if (sectoffset > 0)
+  while (len > 0 && sector < bch->nsectors)
     {
-      /* Read the sector into the sector buffer */
-
-      ret = bchlib_readsector(bch, sector);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
-      /* Copy the tail end of the sector to the user buffer */
+      /* Read runs of whole sectors at least as long as the sector buffer
+       * directly into the user buffer.
+       */
 
-      if (sectoffset + len > bch->sectsize)
+      if (sectoffset == 0 && !BCH_BUFFERED(bch, sector) &&
+          len >= bch->sectsize * CONFIG_BCH_CACHE_NSECTORS)
         {
-          nbytes = bch->sectsize - sectoffset;
+          nsectors = len / bch->sectsize;
+          if (sector + nsectors > bch->nsectors)
+            {
+              nsectors = bch->nsectors - sector;
+            }
+
+          /* Buffered sectors in that range may be newer than the media */
+
+          if (bch->dirty && bch->dirtyfirst < sector + nsectors &&
+              sector <= bch->dirtylast)
+            {
+              ret = bchlib_flushsector(bch, false);
+              if (ret < 0)
+                {
+                  return bytesread > 0 ? bytesread : ret;
+                }
+            }
+
+          ret = bch->inode->u.i_bops->read(bch->inode,
+                                           (FAR uint8_t *)buffer,
+                                           sector, nsectors);
+          if (ret < 0)
+            {
+              ferr("ERROR: Read failed: %d\n", ret);
+              return bytesread > 0 ? bytesread : ret;
+            }
+
+          nbytes = nsectors * bch->sectsize;
         }
       else
         {
-          nbytes = len;
+          /* Read the sector into the sector buffer, along with whatever
+           * is read ahead, and copy as much as it holds.
+           */
+
+          ret = bchlib_readsector(bch, sector);
+          if (ret < 0)
+            {
+              return bytesread > 0 ? bytesread : ret;
+            }
+
+          nsectors = bch->sector + bch->nbuffered - sector;
+          nbytes   = nsectors * bch->sectsize - sectoffset;
+          if (nbytes > len)
+            {
+              nbytes   = len;
+              nsectors = (sectoffset + len) / bch->sectsize;
+            }
+
+          memcpy(buffer, BCH_SECTBUF(bch, sector) + sectoffset, nbytes);
         }
 
-      memcpy(buffer, &bch->buffer[sectoffset], nbytes);
-
       /* Adjust pointers and counts */
 
-      sector++;
-
-      if (sector >= bch->nsectors)
-        {
-          return nbytes;
-        }
-
-      bytesread  = nbytes;
-      buffer    += nbytes;
-      len       -= nbytes;
-    }
-
-  /* Then read all of the full sectors following the partial sector directly
-   * into the user buffer.
-   */
-
-  if (len >= bch->sectsize)
-    {
-      nsectors = len / bch->sectsize;
-      if (sector + nsectors > bch->nsectors)
-        {
-          nsectors = bch->nsectors - sector;
-        }
-
-      ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
-                                       sector, nsectors);
-      if (ret < 0)
-        {
-          ferr("ERROR: Read failed: %d\n", ret);
-          return ret;
-        }
-
-      /* Adjust pointers and counts */
-
-      sector    += nsectors;
-      nbytes     = nsectors * bch->sectsize;
-      bytesread += nbytes;
-
-      if (sector >= bch->nsectors)
-        {
-          return bytesread;
-        }
-
-      buffer    += nbytes;
-      len       -= nbytes;
-    }
-
-  /* Then read any partial final sector */
-
-  if (len > 0)
-    {
-      /* Read the sector into the sector buffer */
-
-      ret = bchlib_readsector(bch, sector);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
-      /* Copy the head end of the sector to the user buffer */
-
-      memcpy(buffer, bch->buffer, len);
-
-      /* Adjust counts */
-
-      bytesread += len;
+      sector     += nsectors;
+      sectoffset  = 0;
+      bytesread  += nbytes;
+      buffer     += nbytes;
+      len        -= nbytes;
     }
 
   return bytesread;
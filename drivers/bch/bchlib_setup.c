@@ -111,12 +111,17 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
   bch->sector   = (size_t)-1;
   bch->readonly = readonly;
 
+  /* Sequential reads grow the read-ahead from a single sector */
+
+  bch->readahead = 1;
+
   /* Allocate the sector I/O buffer */
 
 #if CONFIG_BCH_BUFFER_ALIGNMENT != 0
-  bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT, bch->sectsize);
+  bch->buffer = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT,
+                             bch->sectsize * CONFIG_BCH_CACHE_NSECTORS);
 #else
-  bch->buffer = kmm_malloc(bch->sectsize);
+  bch->buffer = kmm_malloc(bch->sectsize * CONFIG_BCH_CACHE_NSECTORS);
 #endif
   if (!bch->buffer)
     {
@@ -78,114 +78,86 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
       return -EFBIG;
     }
 
-  /* Write the initial partial sector */
-
   byteswritten = 0;
-  if (sectoffset > 0)
+  while (len > 0 && sector < bch->nsectors)
     {
-      /* Read the full sector into the sector buffer */
-
-      ret = bchlib_readsector(bch, sector);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
-      /* Copy the tail end of the sector from the user buffer */
+      /* Write runs of whole sectors at least as long as the sector buffer
+       * directly from the user buffer.
+       */
 
-      if (sectoffset + len > bch->sectsize)
+      if (sectoffset == 0 &&
+          len >= bch->sectsize * CONFIG_BCH_CACHE_NSECTORS)
         {
-          nbytes = bch->sectsize - sectoffset;
+          nsectors = len / bch->sectsize;
+          if (sector + nsectors > bch->nsectors)
+            {
+              nsectors = bch->nsectors - sector;
+            }
+
+          /* Flush the dirty sectors to keep the sector sequence, and drop
+           * the buffered ones if they are about to be overwritten.
+           */
+
+          ret = bchlib_flushsector(bch, bch->sector != (size_t)-1 &&
+                                   bch->sector < sector + nsectors &&
+                                   sector < bch->sector + bch->nbuffered);
+          if (ret < 0)
+            {
+              ferr("ERROR: Flush failed: %d\n", ret);
+              return byteswritten > 0 ? byteswritten : ret;
+            }
+
+          /* Write the contiguous sectors */
+
+          ret = bch->inode->u.i_bops->write(bch->inode,
+                                            (FAR uint8_t *)buffer,
+                                            sector, nsectors);
+          if (ret < 0)
+            {
+              ferr("ERROR: Write failed: %d\n", ret);
+              return byteswritten > 0 ? byteswritten : ret;
+            }
+
+          nbytes = nsectors * bch->sectsize;
         }
       else
         {
-          nbytes = len;
-        }
-
-      memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
-
-      /* Adjust pointers and counts */
-
-      sector++;
-
-      if (sector >= bch->nsectors)
-        {
-          return nbytes;
-        }
-
-      byteswritten  = nbytes;
-      buffer       += nbytes;
-      len          -= nbytes;
-    }
-
-  /* Then write all of the full sectors following the partial sector
-   * directly from the user buffer.
-   */
-
-  if (len >= bch->sectsize)
-    {
-      nsectors = len / bch->sectsize;
-      if (sector + nsectors > bch->nsectors)
-        {
-          nsectors = bch->nsectors - sector;
-        }
-
-      /* Flush the dirty sector to keep the sector sequence */
-
-      ret = bchlib_flushsector(bch, sector <= bch->sector &&
-                               bch->sector < (sector + nsectors));
-      if (ret < 0)
-        {
-          ferr("ERROR: Flush failed: %d\n", ret);
-          return ret;
-        }
-
-      /* Write the contiguous sectors */
-
-      ret = bch->inode->u.i_bops->write(bch->inode, (FAR uint8_t *)buffer,
-                                        sector, nsectors);
-      if (ret < 0)
-        {
-          ferr("ERROR: Write failed: %d\n", ret);
-          return ret;
+          /* A whole sector is buffered without reading it first, a
+           * partial one needs the rest of its content.
+           */
+
+          nsectors = 1;
+          nbytes   = bch->sectsize - sectoffset;
+          if (nbytes > len)
+            {
+              nbytes = len;
+            }
+
+          if (nbytes == bch->sectsize)
+            {
+              ret = bchlib_allocsector(bch, sector);
+            }
+          else
+            {
+              ret = bchlib_readsector(bch, sector);
+            }
+
+          if (ret < 0)
+            {
+              return byteswritten > 0 ? byteswritten : ret;
+            }
+
+          memcpy(BCH_SECTBUF(bch, sector) + sectoffset, buffer, nbytes);
+          bchlib_dirtysector(bch, sector);
         }
 
       /* Adjust pointers and counts */
 
       sector       += nsectors;
-      nbytes        = nsectors * bch->sectsize;
+      sectoffset    = 0;
       byteswritten += nbytes;
-
-      if (sector >= bch->nsectors)
-        {
-          return byteswritten;
-        }
-
-      buffer    += nbytes;
-      len       -= nbytes;
-    }
-
-  /* Then write any partial final sector */
-
-  if (len > 0)
-    {
-      /* Read the sector into the sector buffer */
-
-      ret = bchlib_readsector(bch, sector);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
-      /* Copy the head end of the sector from the user buffer */
-
-      memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
-
-      /* Adjust counts */
-
-      byteswritten += len;
+      buffer       += nbytes;
+      len          -= nbytes;
     }
 
   return byteswritten;
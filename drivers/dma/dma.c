@@ -0,0 +1,193 @@
+/****************************************************************************
+ * drivers/dma/dma.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/dma/dma.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct dma_dev_s *g_dma_devices[CONFIG_DMA_NDEVICES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_sg_callback
+ *
+ * Description:
+ *   Start the next segment of a scatter-gather transfer once the previous
+ *   one finished, or report the end of the transfer.
+ *
+ ****************************************************************************/
+
+static void dma_sg_callback(FAR struct dma_chan_s *chan, FAR void *arg,
+                            ssize_t len)
+{
+  FAR struct dma_sgxfer_s *xfer = arg;
+  FAR const struct dma_sg_s *sg;
+  int ret;
+
+  if (len < 0)
+    {
+      xfer->callback(chan, xfer->arg, len);
+      return;
+    }
+
+  xfer->done += len;
+  if (++xfer->next >= xfer->nsg)
+    {
+      xfer->callback(chan, xfer->arg, xfer->done);
+      return;
+    }
+
+  sg  = &xfer->sg[xfer->next];
+  ret = DMA_START(chan, dma_sg_callback, xfer, sg->dst, sg->src, sg->len);
+  if (ret < 0)
+    {
+      xfer->callback(chan, xfer->arg, ret);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_register
+ *
+ * Description:
+ *   Register a DMA controller, so that drivers which are not aware of it
+ *   can find it by its index.
+ *
+ * Input Parameters:
+ *   index - The index of the controller, from 0
+ *   dev   - The controller
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the index is out of range or -EEXIST
+ *   if a controller is already registered at it.
+ *
+ ****************************************************************************/
+
+int dma_register(unsigned int index, FAR struct dma_dev_s *dev)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  if (index >= CONFIG_DMA_NDEVICES || dev == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  if (g_dma_devices[index] != NULL)
+    {
+      ret = -EEXIST;
+    }
+  else
+    {
+      g_dma_devices[index] = dev;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dma_unregister
+ *
+ * Description:
+ *   Remove a DMA controller registered by dma_register().
+ *
+ ****************************************************************************/
+
+void dma_unregister(unsigned int index)
+{
+  if (index < CONFIG_DMA_NDEVICES)
+    {
+      g_dma_devices[index] = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: dma_get_device
+ *
+ * Description:
+ *   Return the DMA controller registered at an index, or NULL if none is.
+ *
+ ****************************************************************************/
+
+FAR struct dma_dev_s *dma_get_device(unsigned int index)
+{
+  return index < CONFIG_DMA_NDEVICES ? g_dma_devices[index] : NULL;
+}
+
+/****************************************************************************
+ * Name: dma_start_sg
+ *
+ * Description:
+ *   Start a scatter-gather transfer on a channel configured by
+ *   DMA_CONFIG().  The controller chains the segments itself if it
+ *   provides start_sg(), otherwise each segment is started by the
+ *   completion callback of the previous one.
+ *
+ * Input Parameters:
+ *   chan - The channel to start
+ *   xfer - Describes the segments and the callback
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_start_sg(FAR struct dma_chan_s *chan, FAR struct dma_sgxfer_s *xfer)
+{
+  FAR const struct dma_sg_s *sg;
+
+  DEBUGASSERT(chan != NULL && xfer != NULL && xfer->callback != NULL);
+
+  if (xfer->nsg == 0 || xfer->sg == NULL)
+    {
+      return -EINVAL;
+    }
+
+  xfer->next = 0;
+  xfer->done = 0;
+
+  if (chan->ops->start_sg != NULL)
+    {
+      return chan->ops->start_sg(chan, xfer);
+    }
+
+  sg = &xfer->sg[0];
+  return DMA_START(chan, dma_sg_callback, xfer, sg->dst, sg->src, sg->len);
+}
@@ -36,6 +36,7 @@
 #include <nuttx/net/tun.h>
 #include <nuttx/net/telnet.h>
 #include <nuttx/note/note_driver.h>
+#include <nuttx/perfcount.h>
 #include <nuttx/power/pm.h>
 #include <nuttx/power/regulator.h>
 #include <nuttx/segger/rtt.h>
@@ -100,6 +101,14 @@ void drivers_initialize(void)
   devascii_register();  /* Non-standard /dev/ascii */
 #endif
 
+#if defined(CONFIG_DEV_STATS)
+  devstats_register();  /* Non-standard /dev/stats */
+#endif
+
+#if defined(CONFIG_DEV_PERF)
+  devperf_register();   /* Non-standard /dev/perf */
+#endif
+
 #if defined(CONFIG_DRIVERS_NOTE)
   note_initialize();    /* Non-standard /dev/note */
 #endif
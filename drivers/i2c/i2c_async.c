@@ -0,0 +1,201 @@
+/****************************************************************************
+ * drivers/i2c/i2c_async.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/i2c/i2c_master.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+
+#ifdef CONFIG_I2C_ASYNC
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define I2C_ASYNC_WORK LPWORK
+#else
+#  define I2C_ASYNC_WORK HPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The queue of asynchronous transfers of one I2C bus */
+
+struct i2c_async_bus_s
+{
+  FAR struct i2c_async_bus_s *flink;  /* Next bus with a queue */
+  FAR struct i2c_master_s *dev;       /* The bus */
+  FAR struct i2c_async_s *head;       /* Transfers waiting for the bus */
+  FAR struct i2c_async_s *tail;
+  struct work_s work;                 /* Runs the queue */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct i2c_async_bus_s *g_i2c_async_buses;
+static mutex_t g_i2c_async_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_async_worker
+ *
+ * Description:
+ *   Perform the queued transfers of a bus one after the other and report
+ *   the completion of each.
+ *
+ ****************************************************************************/
+
+static void i2c_async_worker(FAR void *arg)
+{
+  FAR struct i2c_async_bus_s *bus = arg;
+  FAR struct i2c_async_s *req;
+
+  for (; ; )
+    {
+      nxmutex_lock(&g_i2c_async_lock);
+      req = bus->head;
+      if (req != NULL)
+        {
+          bus->head = req->flink;
+          if (bus->head == NULL)
+            {
+              bus->tail = NULL;
+            }
+        }
+
+      nxmutex_unlock(&g_i2c_async_lock);
+
+      if (req == NULL)
+        {
+          break;
+        }
+
+      req->result = I2C_TRANSFER(bus->dev, req->msgv, req->msgc);
+      req->callback(req);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_async_submit
+ *
+ * Description:
+ *   Queue a transfer and return without waiting for it.  The queued
+ *   transfers of a bus are performed in order, and req->callback() is
+ *   called with req->result set once a transfer is done.
+ *
+ *   When the lower half provides the submit() method, the request goes to
+ *   it: it may use DMA and call the callback from its interrupt handler.
+ *   Otherwise the transfers are performed by the work queue, where the
+ *   callback is called too.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - Describes the transfer and the callback.  It belongs to the I2C
+ *         bus until the callback is called.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int i2c_async_submit(FAR struct i2c_master_s *dev,
+                     FAR struct i2c_async_s *req)
+{
+  FAR struct i2c_async_bus_s *bus;
+  bool idle;
+
+  DEBUGASSERT(dev != NULL && req != NULL && req->msgv != NULL &&
+              req->callback != NULL);
+
+  req->flink = NULL;
+  if (dev->ops->submit != NULL)
+    {
+      return dev->ops->submit(dev, req);
+    }
+
+  nxmutex_lock(&g_i2c_async_lock);
+
+  for (bus = g_i2c_async_buses; bus != NULL; bus = bus->flink)
+    {
+      if (bus->dev == dev)
+        {
+          break;
+        }
+    }
+
+  if (bus == NULL)
+    {
+      bus = kmm_zalloc(sizeof(*bus));
+      if (bus == NULL)
+        {
+          nxmutex_unlock(&g_i2c_async_lock);
+          return -ENOMEM;
+        }
+
+      bus->dev          = dev;
+      bus->flink        = g_i2c_async_buses;
+      g_i2c_async_buses = bus;
+    }
+
+  idle = bus->head == NULL;
+  if (idle)
+    {
+      bus->head = req;
+    }
+  else
+    {
+      bus->tail->flink = req;
+    }
+
+  bus->tail = req;
+
+  /* Start the worker unless the queue already had requests for it */
+
+  if (idle)
+    {
+      work_queue(I2C_ASYNC_WORK, &bus->work, i2c_async_worker, bus, 0);
+    }
+
+  nxmutex_unlock(&g_i2c_async_lock);
+  return OK;
+}
+
+#endif /* CONFIG_I2C_ASYNC */
@@ -207,6 +207,15 @@ static ssize_t mouse_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
+  /* Return all the whole reports that fit, so that a reader can process
+   * them in one go.
+   */
+
+  if (len >= sizeof(struct mouse_report_s))
+    {
+      len -= len % sizeof(struct mouse_report_s);
+    }
+
   ret = circbuf_read(&openpriv->circbuf, buffer, len);
 
 out:
@@ -273,6 +282,7 @@ void mouse_event(FAR void *priv, FAR const struct mouse_report_s *sample)
 {
   FAR struct mouse_upperhalf_s *upper = priv;
   FAR struct mouse_openpriv_s  *openpriv;
+  bool empty;
   int semcount;
 
   if (nxmutex_lock(&upper->lock) < 0)
@@ -282,19 +292,34 @@ void mouse_event(FAR void *priv, FAR const struct mouse_report_s *sample)
 
   list_for_every_entry(&upper->head, openpriv, struct mouse_openpriv_s, node)
     {
+      if (nxmutex_lock(&openpriv->lock) < 0)
+        {
+          continue;
+        }
+
+      empty = circbuf_is_empty(&openpriv->circbuf);
       circbuf_overwrite(&openpriv->circbuf, sample,
                         sizeof(struct mouse_report_s));
 
-      nxsem_get_value(&openpriv->waitsem, &semcount);
-      if (semcount < 1)
-        {
-          nxsem_post(&openpriv->waitsem);
-        }
+      /* The reader is only woken when data becomes available, not for
+       * each report.
+       */
 
-      if (openpriv->fds && openpriv->fds->fd >= 0)
+      if (empty)
         {
-          poll_notify(&openpriv->fds, 1, POLLIN);
+          nxsem_get_value(&openpriv->waitsem, &semcount);
+          if (semcount < 1)
+            {
+              nxsem_post(&openpriv->waitsem);
+            }
+
+          if (openpriv->fds && openpriv->fds->fd >= 0)
+            {
+              poll_notify(&openpriv->fds, 1, POLLIN);
+            }
         }
+
+      nxmutex_unlock(&openpriv->lock);
     }
 
   nxmutex_unlock(&upper->lock);
@@ -34,6 +34,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/input/touchscreen.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
@@ -51,6 +52,13 @@ struct touch_openpriv_s
   FAR struct pollfd *fds;     /* Polling structure of waiting thread */
   sem_t              waitsem; /* Used to wait for the availability of data */
   mutex_t            lock;    /* Manages exclusive access to this structure */
+#ifdef CONFIG_INPUT_COALESCE
+  bool               pending; /* True if motion holds an unqueued sample */
+
+  /* The latest sample that only moves contacts, not queued yet */
+
+  FAR struct touch_sample_s *motion;
+#endif
 };
 
 /* This structure is for touchscreen upper half driver */
@@ -58,9 +66,11 @@ struct touch_openpriv_s
 struct touch_upperhalf_s
 {
   uint8_t          nums;               /* Number of touch point structure */
+  uint8_t          maxpoint;           /* Number of points in one sample */
   mutex_t          lock;               /* Manages exclusive access to this structure */
   struct list_node head;               /* Opened file buffer chain header node */
   FAR struct touch_lowerhalf_s *lower; /* A pointer of lower half instance */
+  FAR struct touch_sample_s *sample;   /* The timestamped copy of a sample */
 };
 
 /****************************************************************************
@@ -99,6 +109,127 @@ static const struct file_operations g_touch_fops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: touch_push
+ *
+ * Description:
+ *   Queue a sample.  When the buffer is full, the oldest samples are
+ *   dropped as a whole, so that a reader never gets a partial sample.
+ *
+ ****************************************************************************/
+
+static void touch_push(FAR struct circbuf_s *circbuf,
+                       FAR const struct touch_sample_s *sample)
+{
+  size_t size = SIZEOF_TOUCH_SAMPLE_S(sample->npoints);
+  int npoints;
+
+  while (circbuf_space(circbuf) < size &&
+         circbuf_peek(circbuf, &npoints, sizeof(npoints)) > 0)
+    {
+      circbuf_skip(circbuf, SIZEOF_TOUCH_SAMPLE_S(npoints));
+    }
+
+  circbuf_write(circbuf, sample, size);
+}
+
+#ifdef CONFIG_INPUT_COALESCE
+/****************************************************************************
+ * Name: touch_is_motion
+ *
+ * Description:
+ *   Return true if the sample only moves contacts that are already down.
+ *
+ ****************************************************************************/
+
+static bool touch_is_motion(FAR const struct touch_sample_s *sample)
+{
+  int i;
+
+  if (sample->npoints == 0)
+    {
+      return false;
+    }
+
+  for (i = 0; i < sample->npoints; i++)
+    {
+      uint8_t flags = sample->point[i].flags;
+
+      if ((flags & TOUCH_MOVE) == 0 ||
+          (flags & (TOUCH_DOWN | TOUCH_UP | TOUCH_GESTURE_VALID)) != 0)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: touch_same_contacts
+ *
+ * Description:
+ *   Return true if both samples report the same contacts, so that the
+ *   newer one can replace the older one.  Some controllers only report
+ *   the contacts that moved.
+ *
+ ****************************************************************************/
+
+static bool touch_same_contacts(FAR const struct touch_sample_s *a,
+                                FAR const struct touch_sample_s *b)
+{
+  int i;
+
+  if (a->npoints != b->npoints)
+    {
+      return false;
+    }
+
+  for (i = 0; i < a->npoints; i++)
+    {
+      if (a->point[i].id != b->point[i].id)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: touch_flush
+ *
+ * Description:
+ *   Queue the pending motion sample, if any.
+ *
+ ****************************************************************************/
+
+static void touch_flush(FAR struct touch_openpriv_s *openpriv)
+{
+  if (openpriv->pending)
+    {
+      touch_push(&openpriv->circbuf, openpriv->motion);
+      openpriv->pending = false;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: touch_is_empty
+ ****************************************************************************/
+
+static bool touch_is_empty(FAR struct touch_openpriv_s *openpriv)
+{
+#ifdef CONFIG_INPUT_COALESCE
+  if (openpriv->pending)
+    {
+      return false;
+    }
+#endif
+
+  return circbuf_is_empty(&openpriv->circbuf);
+}
+
 /****************************************************************************
  * Name: touch_open
  ****************************************************************************/
@@ -108,7 +239,6 @@ static int touch_open(FAR struct file *filep)
   FAR struct touch_openpriv_s  *openpriv;
   FAR struct inode             *inode = filep->f_inode;
   FAR struct touch_upperhalf_s *upper = inode->i_private;
-  FAR struct touch_lowerhalf_s *lower = upper->lower;
   int ret;
 
   openpriv = kmm_zalloc(sizeof(struct touch_openpriv_s));
@@ -117,20 +247,27 @@ static int touch_open(FAR struct file *filep)
       return -ENOMEM;
     }
 
+#ifdef CONFIG_INPUT_COALESCE
+  openpriv->motion = kmm_malloc(SIZEOF_TOUCH_SAMPLE_S(upper->maxpoint));
+  if (openpriv->motion == NULL)
+    {
+      kmm_free(openpriv);
+      return -ENOMEM;
+    }
+#endif
+
   ret = circbuf_init(&openpriv->circbuf, NULL,
-                     upper->nums * SIZEOF_TOUCH_SAMPLE_S(lower->maxpoint));
+                     upper->nums * SIZEOF_TOUCH_SAMPLE_S(upper->maxpoint));
   if (ret < 0)
     {
-      kmm_free(openpriv);
-      return ret;
+      goto errout;
     }
 
   ret = nxmutex_lock(&upper->lock);
   if (ret < 0)
     {
       circbuf_uninit(&openpriv->circbuf);
-      kmm_free(openpriv);
-      return ret;
+      goto errout;
     }
 
   nxsem_init(&openpriv->waitsem, 0, 0);
@@ -144,6 +281,13 @@ static int touch_open(FAR struct file *filep)
   filep->f_priv = openpriv;
   nxmutex_unlock(&upper->lock);
   return ret;
+
+errout:
+#ifdef CONFIG_INPUT_COALESCE
+  kmm_free(openpriv->motion);
+#endif
+  kmm_free(openpriv);
+  return ret;
 }
 
 /****************************************************************************
@@ -167,6 +311,9 @@ static int touch_close(FAR struct file *filep)
   circbuf_uninit(&openpriv->circbuf);
   nxsem_destroy(&openpriv->waitsem);
   nxmutex_destroy(&openpriv->lock);
+#ifdef CONFIG_INPUT_COALESCE
+  kmm_free(openpriv->motion);
+#endif
   kmm_free(openpriv);
 
   nxmutex_unlock(&upper->lock);
@@ -200,6 +347,8 @@ static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
                           size_t len)
 {
   FAR struct touch_openpriv_s *openpriv = filep->f_priv;
+  size_t size;
+  int npoints;
   int ret;
 
   if (!buffer || !len)
@@ -213,7 +362,7 @@ static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
-  while (circbuf_is_empty(&openpriv->circbuf))
+  while (touch_is_empty(openpriv))
     {
       if (filep->f_oflags & O_NONBLOCK)
         {
@@ -237,7 +386,32 @@ static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
-  ret = circbuf_read(&openpriv->circbuf, buffer, len);
+#ifdef CONFIG_INPUT_COALESCE
+  touch_flush(openpriv);
+#endif
+
+  /* Return all the whole samples that fit, so that a reader can process
+   * them in one go.
+   */
+
+  ret = 0;
+  while (circbuf_peek(&openpriv->circbuf, &npoints, sizeof(npoints)) > 0)
+    {
+      size = SIZEOF_TOUCH_SAMPLE_S(npoints);
+      if (ret + size > len)
+        {
+          break;
+        }
+
+      ret += circbuf_read(&openpriv->circbuf, buffer + ret, size);
+    }
+
+  if (ret == 0)
+    {
+      /* The buffer is too small for one sample */
+
+      ret = circbuf_read(&openpriv->circbuf, buffer, len);
+    }
 
 out:
   nxmutex_unlock(&openpriv->lock);
@@ -303,7 +477,7 @@ static int touch_poll(FAR struct file *filep, struct pollfd *fds, bool setup)
           goto errout;
         }
 
-      if (!circbuf_is_empty(&openpriv->circbuf))
+      if (!touch_is_empty(openpriv))
         {
           eventset |= POLLIN;
         }
@@ -333,25 +507,85 @@ void touch_event(FAR void *priv, FAR const struct touch_sample_s *sample)
 {
   FAR struct touch_upperhalf_s *upper = priv;
   FAR struct touch_openpriv_s  *openpriv;
+  struct timespec ts;
+  uint64_t now;
+  int npoints;
+  bool empty;
   int semcount;
+  int i;
 
   if (nxmutex_lock(&upper->lock) < 0)
     {
       return;
     }
 
+  /* Timestamp the points that the lower half did not */
+
+  npoints = sample->npoints;
+  if (npoints > upper->maxpoint)
+    {
+      npoints = upper->maxpoint;
+    }
+
+  memcpy(upper->sample, sample, SIZEOF_TOUCH_SAMPLE_S(npoints));
+  upper->sample->npoints = npoints;
+
+  clock_systime_timespec(&ts);
+  now = (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+  for (i = 0; i < npoints; i++)
+    {
+      if (upper->sample->point[i].timestamp == 0)
+        {
+          upper->sample->point[i].timestamp = now;
+        }
+    }
+
   list_for_every_entry(&upper->head, openpriv, struct touch_openpriv_s, node)
     {
-      circbuf_overwrite(&openpriv->circbuf, sample,
-                        SIZEOF_TOUCH_SAMPLE_S(sample->npoints));
+      if (nxmutex_lock(&openpriv->lock) < 0)
+        {
+          continue;
+        }
+
+      empty = touch_is_empty(openpriv);
 
-      nxsem_get_value(&openpriv->waitsem, &semcount);
-      if (semcount < 1)
+#ifdef CONFIG_INPUT_COALESCE
+      /* Motion only replaces the unread motion of the same contacts */
+
+      if (!touch_is_motion(upper->sample) || !openpriv->pending ||
+          !touch_same_contacts(openpriv->motion, upper->sample))
         {
-          nxsem_post(&openpriv->waitsem);
+          touch_flush(openpriv);
         }
 
-      poll_notify(&openpriv->fds, 1, POLLIN);
+      if (touch_is_motion(upper->sample))
+        {
+          memcpy(openpriv->motion, upper->sample,
+                 SIZEOF_TOUCH_SAMPLE_S(npoints));
+          openpriv->pending = true;
+        }
+      else
+#endif
+        {
+          touch_push(&openpriv->circbuf, upper->sample);
+        }
+
+      /* The reader is only woken when data becomes available, not for
+       * each sample.
+       */
+
+      if (empty)
+        {
+          nxsem_get_value(&openpriv->waitsem, &semcount);
+          if (semcount < 1)
+            {
+              nxsem_post(&openpriv->waitsem);
+            }
+
+          poll_notify(&openpriv->fds, 1, POLLIN);
+        }
+
+      nxmutex_unlock(&openpriv->lock);
     }
 
   nxmutex_unlock(&upper->lock);
@@ -382,6 +616,14 @@ int touch_register(FAR struct touch_lowerhalf_s *lower,
       return -ENOMEM;
     }
 
+  upper->maxpoint = lower->maxpoint > 0 ? lower->maxpoint : 1;
+  upper->sample   = kmm_malloc(SIZEOF_TOUCH_SAMPLE_S(upper->maxpoint));
+  if (upper->sample == NULL)
+    {
+      kmm_free(upper);
+      return -ENOMEM;
+    }
+
   lower->priv  = upper;
   upper->lower = lower;
   upper->nums  = nums;
@@ -392,6 +634,7 @@ int touch_register(FAR struct touch_lowerhalf_s *lower,
   if (ret < 0)
     {
       nxmutex_destroy(&upper->lock);
+      kmm_free(upper->sample);
       kmm_free(upper);
       return ret;
     }
@@ -416,5 +659,6 @@ void touch_unregister(FAR struct touch_lowerhalf_s *lower,
   unregister_driver(path);
 
   nxmutex_destroy(&upper->lock);
+  kmm_free(upper->sample);
   kmm_free(upper);
 }
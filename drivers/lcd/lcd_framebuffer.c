@@ -26,14 +26,18 @@
 
 #include <stdint.h>
 #include <string.h>
+#include <sys/param.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/board.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/lcd/lcd.h>
 #include <nuttx/video/fb.h>
+#include <nuttx/wqueue.h>
 
 #ifdef CONFIG_LCD_FRAMEBUFFER
 
@@ -45,6 +49,17 @@
 
 #define VIDEO_PLANE 0
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+#  ifdef CONFIG_SCHED_LPWORK
+#    define LCDFB_WORK LPWORK
+#  else
+#    define LCDFB_WORK HPWORK
+#  endif
+
+#  define LCDFB_DELAY   MSEC2TICK(1000 / CONFIG_LCD_FRAMEBUFFER_FPS)
+#  define LCDFB_NDAMAGE CONFIG_LCD_FRAMEBUFFER_NDAMAGE
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -63,6 +78,14 @@ struct lcdfb_dev_s
   fb_coord_t yres;                  /* Vertical resolution in pixel rows */
   fb_coord_t stride;                /* Width of a row in bytes */
   uint8_t display;                  /* Display number */
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+  uint8_t ndamage;                  /* Number of damaged areas */
+  struct work_s work;               /* Sends them once per frame */
+
+  /* The damaged areas not sent yet */
+
+  struct fb_area_s damage[LCDFB_NDAMAGE];
+#endif
 };
 
 /****************************************************************************
@@ -152,17 +175,16 @@ static FAR struct lcdfb_dev_s *lcdfb_find(int display)
 }
 
 /****************************************************************************
- * Name: lcdfb_updateearea
+ * Name: lcdfb_putarea
  *
  * Description:
- * Update the LCD when there is a change to the framebuffer.
+ *   Send an area of the framebuffer to the LCD.
  *
  ****************************************************************************/
 
-static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
-                             FAR const struct fb_area_s *area)
+static int lcdfb_putarea(FAR struct lcdfb_dev_s *priv,
+                         FAR const struct fb_area_s *area)
 {
-  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
   FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
   FAR uint8_t *run = priv->fbmem;
   fb_coord_t row;
@@ -263,6 +285,205 @@ static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
   return OK;
 }
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+/****************************************************************************
+ * Name: lcdfb_touch
+ *
+ * Description:
+ *   Return true if two areas overlap or are adjacent.
+ *
+ ****************************************************************************/
+
+static bool lcdfb_touch(FAR const struct fb_area_s *a,
+                        FAR const struct fb_area_s *b)
+{
+  return a->x <= b->x + b->w && b->x <= a->x + a->w &&
+         a->y <= b->y + b->h && b->y <= a->y + a->h;
+}
+
+/****************************************************************************
+ * Name: lcdfb_union
+ *
+ * Description:
+ *   Grow an area to the bounding box of itself and another one.
+ *
+ ****************************************************************************/
+
+static void lcdfb_union(FAR struct fb_area_s *dst,
+                        FAR const struct fb_area_s *src)
+{
+  fb_coord_t endx = MAX(dst->x + dst->w, src->x + src->w);
+  fb_coord_t endy = MAX(dst->y + dst->h, src->y + src->h);
+
+  dst->x = MIN(dst->x, src->x);
+  dst->y = MIN(dst->y, src->y);
+  dst->w = endx - dst->x;
+  dst->h = endy - dst->y;
+}
+
+/****************************************************************************
+ * Name: lcdfb_growth
+ *
+ * Description:
+ *   Return the number of pixels an area gains if it absorbs another one.
+ *
+ ****************************************************************************/
+
+static uint32_t lcdfb_growth(FAR const struct fb_area_s *dst,
+                             FAR const struct fb_area_s *src)
+{
+  struct fb_area_s area = *dst;
+
+  lcdfb_union(&area, src);
+  return (uint32_t)area.w * area.h - (uint32_t)dst->w * dst->h;
+}
+
+/****************************************************************************
+ * Name: lcdfb_adddamage
+ *
+ * Description:
+ *   Add an area to the damaged ones.  The areas that touch are merged,
+ *   and when none is left free, the new area is merged with the one that
+ *   grows the least.
+ *
+ * Assumptions:
+ *   Called in a critical section.
+ *
+ ****************************************************************************/
+
+static void lcdfb_adddamage(FAR struct lcdfb_dev_s *priv,
+                            FAR const struct fb_area_s *area)
+{
+  struct fb_area_s damage = *area;
+  uint32_t growth;
+  uint32_t best;
+  int found;
+  int i;
+
+  for (; ; )
+    {
+      for (i = 0; i < priv->ndamage; i++)
+        {
+          if (lcdfb_touch(&priv->damage[i], &damage))
+            {
+              break;
+            }
+        }
+
+      if (i == priv->ndamage)
+        {
+          if (priv->ndamage < LCDFB_NDAMAGE)
+            {
+              break;
+            }
+
+          for (i = 0, found = 0, best = UINT32_MAX; i < priv->ndamage; i++)
+            {
+              growth = lcdfb_growth(&priv->damage[i], &damage);
+              if (growth < best)
+                {
+                  best  = growth;
+                  found = i;
+                }
+            }
+
+          i = found;
+        }
+
+      /* Absorb the area and look again, the result may touch others */
+
+      lcdfb_union(&damage, &priv->damage[i]);
+      priv->damage[i] = priv->damage[--priv->ndamage];
+    }
+
+  priv->damage[priv->ndamage++] = damage;
+}
+
+/****************************************************************************
+ * Name: lcdfb_worker
+ *
+ * Description:
+ *   Send the areas damaged during the last frame, each in one transfer.
+ *
+ ****************************************************************************/
+
+static void lcdfb_worker(FAR void *arg)
+{
+  FAR struct lcdfb_dev_s *priv = arg;
+  struct fb_area_s damage[LCDFB_NDAMAGE];
+  irqstate_t flags;
+  int ndamage;
+  int i;
+
+  flags = enter_critical_section();
+  ndamage = priv->ndamage;
+  memcpy(damage, priv->damage, ndamage * sizeof(struct fb_area_s));
+  priv->ndamage = 0;
+  leave_critical_section(flags);
+
+  for (i = 0; i < ndamage; i++)
+    {
+      lcdfb_putarea(priv, &damage[i]);
+    }
+
+  /* The framebuffer may be written again for the next frame */
+
+  fb_pollnotify(&priv->vtable);
+}
+#endif
+
+/****************************************************************************
+ * Name: lcdfb_updateearea
+ *
+ * Description:
+ * Update the LCD when there is a change to the framebuffer.
+ *
+ ****************************************************************************/
+
+static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
+                             FAR const struct fb_area_s *area)
+{
+  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+  struct fb_area_s damage;
+  irqstate_t flags;
+
+  /* Clip the area and keep it for the next frame */
+
+  if (area != NULL)
+    {
+      if (area->w == 0 || area->h == 0 ||
+          area->x >= priv->xres || area->y >= priv->yres)
+        {
+          return OK;
+        }
+
+      damage   = *area;
+      damage.w = MIN(area->w, priv->xres - area->x);
+      damage.h = MIN(area->h, priv->yres - area->y);
+    }
+  else
+    {
+      damage.x = 0;
+      damage.y = 0;
+      damage.w = priv->xres;
+      damage.h = priv->yres;
+    }
+
+  flags = enter_critical_section();
+  lcdfb_adddamage(priv, &damage);
+  if (work_available(&priv->work))
+    {
+      work_queue(LCDFB_WORK, &priv->work, lcdfb_worker, priv, LCDFB_DELAY);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+#else
+  return lcdfb_putarea(priv, area);
+#endif
+}
+
 /****************************************************************************
  * Name: lcdfb_getvideoinfo
  ****************************************************************************/
@@ -661,7 +882,7 @@ int up_fbinitialize(int display)
   area.w = priv->xres;
   area.h = priv->yres;
 
-  ret = lcdfb_updateearea(&priv->vtable, &area);
+  ret = lcdfb_putarea(priv, &area);
   if (ret < 0)
     {
       lcderr("FB update failed: %d\n", ret);
@@ -761,6 +982,10 @@ void up_fbuninitialize(int display)
               g_lcdfb = priv->flink;
             }
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+          work_cancel(LCDFB_WORK, &priv->work);
+#endif
+
 #ifndef CONFIG_LCD_EXTERNINIT
           /* Uninitialize the LCD */
 
@@ -0,0 +1,656 @@
+/****************************************************************************
+ * drivers/misc/blkqueue.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/drivers/blkqueue.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One read or write waiting for the lower half block driver.  Requests
+ * live on the stack of the task that issued them.
+ */
+
+struct blkqueue_req_s
+{
+  dq_entry_t            node;     /* Entry in the queue or in a merged batch */
+  FAR uint8_t          *buffer;   /* Caller buffer */
+  blkcnt_t              start;    /* First sector */
+  unsigned int          nsectors; /* Number of sectors */
+  bool                  write;    /* True: write, false: read */
+  bool                  dispatch; /* True: woken up to dispatch */
+  uint8_t               prio;     /* Priority of the issuing task */
+#ifdef CONFIG_BLK_QUEUE_DEADLINE
+  clock_t               deadline; /* Time by which it must be dispatched */
+#endif
+  ssize_t               result;   /* Sectors transferred or negated errno */
+  sem_t                 done;     /* Posted when completed or to dispatch */
+};
+
+struct blkqueue_dev_s
+{
+  FAR struct inode     *blkdev;   /* The lower half block driver */
+  mutex_t               lock;     /* Protects the fields below */
+  dq_queue_t            queue;    /* Requests waiting for the driver */
+  bool                  busy;     /* A task is dispatching */
+  bool                  unlinked; /* The driver has been unlinked */
+  uint8_t               refs;     /* Number of references */
+  uint16_t              sectorsize;
+#if CONFIG_BLK_QUEUE_MERGE_NSECTORS > 0
+  FAR uint8_t          *mergebuf; /* Buffer for merged transfers */
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     blkqueue_open(FAR struct inode *inode);
+static int     blkqueue_close(FAR struct inode *inode);
+static ssize_t blkqueue_read(FAR struct inode *inode,
+                             FAR unsigned char *buffer,
+                             blkcnt_t start_sector, unsigned int nsectors);
+static ssize_t blkqueue_write(FAR struct inode *inode,
+                              FAR const unsigned char *buffer,
+                              blkcnt_t start_sector,
+                              unsigned int nsectors);
+static int     blkqueue_geometry(FAR struct inode *inode,
+                                 FAR struct geometry *geometry);
+static int     blkqueue_ioctl(FAR struct inode *inode, int cmd,
+                              unsigned long arg);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     blkqueue_unlink(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_blkqueue_bops =
+{
+  blkqueue_open,     /* open     */
+  blkqueue_close,    /* close    */
+  blkqueue_read,     /* read     */
+  blkqueue_write,    /* write    */
+  blkqueue_geometry, /* geometry */
+  blkqueue_ioctl     /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , blkqueue_unlink  /* unlink   */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkqueue_free
+ ****************************************************************************/
+
+static void blkqueue_free(FAR struct blkqueue_dev_s *dev)
+{
+  close_blockdriver(dev->blkdev);
+  nxmutex_destroy(&dev->lock);
+#if CONFIG_BLK_QUEUE_MERGE_NSECTORS > 0
+  kmm_free(dev->mergebuf);
+#endif
+  kmm_free(dev);
+}
+
+/****************************************************************************
+ * Name: blkqueue_pick
+ *
+ * Description:
+ *   Select the next request to dispatch:  the request of the highest
+ *   priority task, the oldest first among equals.  With the deadline
+ *   scheduler, a request past its deadline goes first.  Called with the
+ *   device locked.
+ *
+ ****************************************************************************/
+
+static FAR struct blkqueue_req_s *
+blkqueue_pick(FAR struct blkqueue_dev_s *dev)
+{
+  FAR struct blkqueue_req_s *best = NULL;
+  FAR struct blkqueue_req_s *req;
+  FAR dq_entry_t *entry;
+#ifdef CONFIG_BLK_QUEUE_DEADLINE
+  clock_t now = clock_systime_ticks();
+
+  for (entry = dq_peek(&dev->queue); entry != NULL; entry = dq_next(entry))
+    {
+      req = (FAR struct blkqueue_req_s *)entry;
+      if ((sclock_t)(now - req->deadline) >= 0 &&
+          (best == NULL || (sclock_t)(req->deadline - best->deadline) < 0))
+        {
+          best = req;
+        }
+    }
+
+  if (best != NULL)
+    {
+      return best;
+    }
+#endif
+
+  for (entry = dq_peek(&dev->queue); entry != NULL; entry = dq_next(entry))
+    {
+      req = (FAR struct blkqueue_req_s *)entry;
+      if (best == NULL || req->prio > best->prio)
+        {
+          best = req;
+        }
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: blkqueue_merge
+ *
+ * Description:
+ *   Move the queued requests that continue the batch, in the same
+ *   direction, from the queue into the batch, keeping the batch sorted by
+ *   sector.  Returns the number of sectors in the batch.  Called with the
+ *   device locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_BLK_QUEUE_MERGE_NSECTORS > 0
+static unsigned int blkqueue_merge(FAR struct blkqueue_dev_s *dev,
+                                   FAR dq_queue_t *batch,
+                                   FAR struct blkqueue_req_s *first)
+{
+  FAR struct blkqueue_req_s *req;
+  FAR dq_entry_t *entry;
+  unsigned int total = first->nsectors;
+  blkcnt_t start = first->start;
+  bool merged = true;
+
+  while (merged)
+    {
+      merged = false;
+      for (entry = dq_peek(&dev->queue); entry != NULL;
+           entry = dq_next(entry))
+        {
+          req = (FAR struct blkqueue_req_s *)entry;
+          if (req->write != first->write ||
+              total + req->nsectors > CONFIG_BLK_QUEUE_MERGE_NSECTORS)
+            {
+              continue;
+            }
+
+          if (req->start == start + total)
+            {
+              dq_rem(entry, &dev->queue);
+              dq_addlast(entry, batch);
+            }
+          else if (req->start + req->nsectors == start)
+            {
+              dq_rem(entry, &dev->queue);
+              dq_addfirst(entry, batch);
+              start = req->start;
+            }
+          else
+            {
+              continue;
+            }
+
+          total += req->nsectors;
+          merged = true;
+          break;
+        }
+    }
+
+  return total;
+}
+#endif
+
+/****************************************************************************
+ * Name: blkqueue_transfer
+ *
+ * Description:
+ *   Pass a batch of contiguous requests to the lower half driver and set
+ *   the result of each.  A batch of more than one request goes through
+ *   the merge buffer as a single transfer.  Called with the device
+ *   unlocked; the requests are no longer queued.
+ *
+ ****************************************************************************/
+
+static void blkqueue_transfer(FAR struct blkqueue_dev_s *dev,
+                              FAR dq_queue_t *batch, unsigned int total)
+{
+  FAR const struct block_operations *ops = dev->blkdev->u.i_bops;
+  FAR struct blkqueue_req_s *first;
+#if CONFIG_BLK_QUEUE_MERGE_NSECTORS > 0
+  FAR struct blkqueue_req_s *req;
+  FAR dq_entry_t *entry;
+  FAR uint8_t *buffer;
+  ssize_t ret;
+#endif
+
+  first = (FAR struct blkqueue_req_s *)dq_peek(batch);
+  if (dq_next(&first->node) == NULL)
+    {
+      if (first->write)
+        {
+          first->result = ops->write(dev->blkdev, first->buffer,
+                                     first->start, first->nsectors);
+        }
+      else
+        {
+          first->result = ops->read(dev->blkdev, first->buffer,
+                                    first->start, first->nsectors);
+        }
+
+      return;
+    }
+
+#if CONFIG_BLK_QUEUE_MERGE_NSECTORS > 0
+  if (first->write)
+    {
+      buffer = dev->mergebuf;
+      for (entry = dq_peek(batch); entry != NULL; entry = dq_next(entry))
+        {
+          req = (FAR struct blkqueue_req_s *)entry;
+          memcpy(buffer, req->buffer, req->nsectors * dev->sectorsize);
+          buffer += req->nsectors * dev->sectorsize;
+        }
+
+      ret = ops->write(dev->blkdev, dev->mergebuf, first->start, total);
+    }
+  else
+    {
+      ret = ops->read(dev->blkdev, dev->mergebuf, first->start, total);
+    }
+
+  /* Hand out the sectors transferred in sector order */
+
+  buffer = dev->mergebuf;
+  for (entry = dq_peek(batch); entry != NULL; entry = dq_next(entry))
+    {
+      req = (FAR struct blkqueue_req_s *)entry;
+      if (ret < 0)
+        {
+          req->result = ret;
+          continue;
+        }
+
+      req->result = MIN(ret, (ssize_t)req->nsectors);
+      if (req->result == 0)
+        {
+          req->result = -EIO;
+          continue;
+        }
+
+      if (!req->write)
+        {
+          memcpy(req->buffer, buffer, req->result * dev->sectorsize);
+        }
+
+      buffer += req->result * dev->sectorsize;
+      ret    -= req->result;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: blkqueue_submit
+ *
+ * Description:
+ *   Queue a request and wait for it.  The task that finds the driver idle
+ *   dispatches its own request, then wakes up the owner of the request
+ *   picked next to dispatch that one.  So each transfer runs in the
+ *   context, and at the priority, of one of the tasks waiting for it.
+ *
+ ****************************************************************************/
+
+static ssize_t blkqueue_submit(FAR struct blkqueue_dev_s *dev,
+                               FAR struct blkqueue_req_s *req)
+{
+  FAR struct blkqueue_req_s *next;
+  FAR dq_entry_t *entry;
+  dq_queue_t batch;
+  unsigned int total;
+  int ret;
+
+  req->dispatch = false;
+  req->prio     = nxsched_self()->sched_priority;
+#ifdef CONFIG_BLK_QUEUE_DEADLINE
+  req->deadline = clock_systime_ticks() +
+                  MSEC2TICK(req->write ? CONFIG_BLK_QUEUE_WRITE_EXPIRE :
+                                         CONFIG_BLK_QUEUE_READ_EXPIRE);
+#endif
+
+  nxsem_init(&req->done, 0, 0);
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      nxsem_destroy(&req->done);
+      return ret;
+    }
+
+  dq_addlast(&req->node, &dev->queue);
+  if (dev->busy)
+    {
+      /* Wait until the request was transferred as part of another batch,
+       * or until it is its turn to be dispatched.
+       */
+
+      nxmutex_unlock(&dev->lock);
+      nxsem_wait_uninterruptible(&req->done);
+      if (!req->dispatch)
+        {
+          nxsem_destroy(&req->done);
+          return req->result;
+        }
+
+      nxmutex_lock(&dev->lock);
+    }
+  else
+    {
+      dev->busy = true;
+    }
+
+  /* Take the request and the queued requests it can be merged with */
+
+  dq_init(&batch);
+  dq_rem(&req->node, &dev->queue);
+  dq_addlast(&req->node, &batch);
+
+#if CONFIG_BLK_QUEUE_MERGE_NSECTORS > 0
+  total = blkqueue_merge(dev, &batch, req);
+#else
+  total = req->nsectors;
+#endif
+
+  nxmutex_unlock(&dev->lock);
+  blkqueue_transfer(dev, &batch, total);
+  nxmutex_lock(&dev->lock);
+
+  /* Complete the requests merged into this one */
+
+  while ((entry = dq_remfirst(&batch)) != NULL)
+    {
+      if (entry != &req->node)
+        {
+          nxsem_post(&((FAR struct blkqueue_req_s *)entry)->done);
+        }
+    }
+
+  /* Hand the driver over to the next request */
+
+  next = blkqueue_pick(dev);
+  if (next != NULL)
+    {
+      next->dispatch = true;
+      nxsem_post(&next->done);
+    }
+  else
+    {
+      dev->busy = false;
+    }
+
+  nxmutex_unlock(&dev->lock);
+  nxsem_destroy(&req->done);
+  return req->result;
+}
+
+/****************************************************************************
+ * Name: blkqueue_open
+ ****************************************************************************/
+
+static int blkqueue_open(FAR struct inode *inode)
+{
+  FAR struct blkqueue_dev_s *dev = inode->i_private;
+  int ret;
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  dev->refs++;
+  nxmutex_unlock(&dev->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blkqueue_close
+ ****************************************************************************/
+
+static int blkqueue_close(FAR struct inode *inode)
+{
+  FAR struct blkqueue_dev_s *dev = inode->i_private;
+  int ret;
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (dev->refs > 0)
+    {
+      dev->refs--;
+    }
+
+  if (dev->refs == 0 && dev->unlinked)
+    {
+      nxmutex_unlock(&dev->lock);
+      blkqueue_free(dev);
+      return OK;
+    }
+
+  nxmutex_unlock(&dev->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: blkqueue_read
+ ****************************************************************************/
+
+static ssize_t blkqueue_read(FAR struct inode *inode,
+                             FAR unsigned char *buffer,
+                             blkcnt_t start_sector, unsigned int nsectors)
+{
+  struct blkqueue_req_s req;
+
+  req.buffer   = buffer;
+  req.start    = start_sector;
+  req.nsectors = nsectors;
+  req.write    = false;
+
+  return blkqueue_submit(inode->i_private, &req);
+}
+
+/****************************************************************************
+ * Name: blkqueue_write
+ ****************************************************************************/
+
+static ssize_t blkqueue_write(FAR struct inode *inode,
+                              FAR const unsigned char *buffer,
+                              blkcnt_t start_sector,
+                              unsigned int nsectors)
+{
+  struct blkqueue_req_s req;
+
+  req.buffer   = (FAR uint8_t *)buffer;
+  req.start    = start_sector;
+  req.nsectors = nsectors;
+  req.write    = true;
+
+  return blkqueue_submit(inode->i_private, &req);
+}
+
+/****************************************************************************
+ * Name: blkqueue_geometry
+ ****************************************************************************/
+
+static int blkqueue_geometry(FAR struct inode *inode,
+                             FAR struct geometry *geometry)
+{
+  FAR struct blkqueue_dev_s *dev = inode->i_private;
+
+  return dev->blkdev->u.i_bops->geometry(dev->blkdev, geometry);
+}
+
+/****************************************************************************
+ * Name: blkqueue_ioctl
+ ****************************************************************************/
+
+static int blkqueue_ioctl(FAR struct inode *inode, int cmd,
+                          unsigned long arg)
+{
+  FAR struct blkqueue_dev_s *dev = inode->i_private;
+
+  if (dev->blkdev->u.i_bops->ioctl == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  return dev->blkdev->u.i_bops->ioctl(dev->blkdev, cmd, arg);
+}
+
+/****************************************************************************
+ * Name: blkqueue_unlink
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int blkqueue_unlink(FAR struct inode *inode)
+{
+  FAR struct blkqueue_dev_s *dev = inode->i_private;
+  int ret;
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  dev->unlinked = true;
+  if (dev->refs == 0)
+    {
+      nxmutex_unlock(&dev->lock);
+      blkqueue_free(dev);
+      return OK;
+    }
+
+  nxmutex_unlock(&dev->lock);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: blkqueue_register
+ ****************************************************************************/
+
+int blkqueue_register(FAR const char *blkdev, FAR const char *path)
+{
+  FAR struct blkqueue_dev_s *dev;
+  struct geometry geo;
+  int ret;
+
+  DEBUGASSERT(blkdev != NULL && path != NULL);
+
+  dev = kmm_zalloc(sizeof(struct blkqueue_dev_s));
+  if (dev == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&dev->lock);
+  dq_init(&dev->queue);
+
+  ret = open_blockdriver(blkdev, 0, &dev->blkdev);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to open %s: %d\n", blkdev, ret);
+      nxmutex_destroy(&dev->lock);
+      kmm_free(dev);
+      return ret;
+    }
+
+  if (dev->blkdev->u.i_bops->read == NULL ||
+      dev->blkdev->u.i_bops->write == NULL ||
+      dev->blkdev->u.i_bops->geometry == NULL)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = dev->blkdev->u.i_bops->geometry(dev->blkdev, &geo);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  dev->sectorsize = geo.geo_sectorsize;
+
+#if CONFIG_BLK_QUEUE_MERGE_NSECTORS > 0
+  dev->mergebuf = kmm_malloc(CONFIG_BLK_QUEUE_MERGE_NSECTORS *
+                             dev->sectorsize);
+  if (dev->mergebuf == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+#endif
+
+  ret = register_blockdriver(path, &g_blkqueue_bops, 0660, dev);
+  if (ret < 0)
+    {
+      ferr("ERROR: register_blockdriver %s failed: %d\n", path, ret);
+      goto errout;
+    }
+
+  return OK;
+
+errout:
+  blkqueue_free(dev);
+  return ret;
+}
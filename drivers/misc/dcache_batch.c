@@ -0,0 +1,197 @@
+/****************************************************************************
+ * drivers/misc/dcache_batch.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+
+#include <nuttx/cache.h>
+
+#ifdef CONFIG_ARCH_DCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Whole-cache operations only reach the caches of this CPU */
+
+#if CONFIG_ARCH_DCACHE_BATCH_THRESHOLD > 0 && !defined(CONFIG_SMP)
+#  define DCACHE_BATCH_WHOLE 1
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dcache_batch_range
+ *
+ * Description:
+ *   Apply the operation of a batch to one region.
+ *
+ ****************************************************************************/
+
+static void dcache_batch_range(int op, uintptr_t start, uintptr_t end)
+{
+  switch (op)
+    {
+      case DCACHE_BATCH_CLEAN:
+        up_clean_dcache(start, end);
+        break;
+
+      case DCACHE_BATCH_INVALIDATE:
+        up_invalidate_dcache(start, end);
+        break;
+
+      default:
+        up_flush_dcache(start, end);
+        break;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dcache_batch_init
+ *
+ * Description:
+ *   Start an empty batch of D-cache maintenance.
+ *
+ ****************************************************************************/
+
+void dcache_batch_init(FAR struct dcache_batch_s *batch, int op)
+{
+  batch->op      = op;
+  batch->nranges = 0;
+}
+
+/****************************************************************************
+ * Name: dcache_batch_add
+ *
+ * Description:
+ *   Add a region to a batch, merging it with the regions that it overlaps
+ *   or touches.  If the batch is full, the pending regions are applied
+ *   first.
+ *
+ ****************************************************************************/
+
+void dcache_batch_add(FAR struct dcache_batch_s *batch,
+                      uintptr_t start, uintptr_t end)
+{
+  int i = 0;
+
+  if (start >= end)
+    {
+      return;
+    }
+
+  /* Absorb the pending regions that overlap or touch the new one.  The
+   * grown region may now reach regions that were already passed, so start
+   * over after each merge.
+   */
+
+  while (i < batch->nranges)
+    {
+      if (batch->start[i] <= end && batch->end[i] >= start)
+        {
+          start = MIN(start, batch->start[i]);
+          end   = MAX(end, batch->end[i]);
+
+          batch->nranges--;
+          batch->start[i] = batch->start[batch->nranges];
+          batch->end[i]   = batch->end[batch->nranges];
+          i = 0;
+        }
+      else
+        {
+          i++;
+        }
+    }
+
+  if (batch->nranges >= CONFIG_ARCH_DCACHE_BATCH_NRANGES)
+    {
+      dcache_batch_commit(batch);
+    }
+
+  batch->start[batch->nranges] = start;
+  batch->end[batch->nranges]   = end;
+  batch->nranges++;
+}
+
+/****************************************************************************
+ * Name: dcache_batch_commit
+ *
+ * Description:
+ *   Apply the operation of a batch to its pending regions and empty it.
+ *
+ ****************************************************************************/
+
+void dcache_batch_commit(FAR struct dcache_batch_s *batch)
+{
+  int i;
+
+#ifdef DCACHE_BATCH_WHOLE
+  /* Walking more lines than the cache holds costs more than visiting
+   * every line of the cache once.  Never do that to invalidate:  it would
+   * write back the stale lines over what a DMA wrote.
+   */
+
+  if (batch->op != DCACHE_BATCH_INVALIDATE)
+    {
+      size_t total = 0;
+
+      for (i = 0; i < batch->nranges; i++)
+        {
+          total += batch->end[i] - batch->start[i];
+        }
+
+      if (total >= (size_t)CONFIG_ARCH_DCACHE_BATCH_THRESHOLD)
+        {
+          if (batch->op == DCACHE_BATCH_CLEAN)
+            {
+              up_clean_dcache_all();
+            }
+          else
+            {
+              up_flush_dcache_all();
+            }
+
+          batch->nranges = 0;
+          return;
+        }
+    }
+#endif
+
+  for (i = 0; i < batch->nranges; i++)
+    {
+      dcache_batch_range(batch->op, batch->start[i], batch->end[i]);
+    }
+
+  batch->nranges = 0;
+}
+
+#endif /* CONFIG_ARCH_DCACHE */
@@ -0,0 +1,102 @@
+/****************************************************************************
+ * drivers/misc/dev_perf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/perfcount.h>
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int devperf_ioctl(FAR struct file *filep, int cmd,
+                         unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_devperf_fops =
+{
+  NULL,           /* open */
+  NULL,           /* close */
+  NULL,           /* read */
+  NULL,           /* write */
+  NULL,           /* seek */
+  devperf_ioctl   /* ioctl */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devperf_ioctl
+ ****************************************************************************/
+
+static int devperf_ioctl(FAR struct file *filep, int cmd,
+                         unsigned long arg)
+{
+  FAR struct perfcount_s *perf;
+
+  switch (cmd)
+    {
+      case PERFIOC_READ:
+        perf = (FAR struct perfcount_s *)((uintptr_t)arg);
+        if (perf == NULL)
+          {
+            return -EINVAL;
+          }
+
+        return perfcount_read(perf);
+
+      case PERFIOC_RESET:
+        return perfcount_reset((pid_t)arg);
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devperf_register
+ *
+ * Description:
+ *   Register /dev/perf
+ *
+ ****************************************************************************/
+
+void devperf_register(void)
+{
+  register_driver("/dev/perf", &g_devperf_fops, 0666, NULL);
+}
@@ -0,0 +1,349 @@
+/****************************************************************************
+ * drivers/misc/dev_stats.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <malloc.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/mempool.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/drivers/drivers.h>
+#include <nuttx/drivers/devstats.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+#  define DEVSTATS_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define DEVSTATS_NCPUS 1
+#endif
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
+#  define DEVSTATS_HAVE_MEMPOOL 1
+#endif
+
+#define devstats_proto(d,s) \
+  do \
+    { \
+      (d).recv = (s).recv; \
+      (d).sent = (s).sent; \
+      (d).drop = (s).drop; \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of the walk of the mempools */
+
+#ifdef DEVSTATS_HAVE_MEMPOOL
+struct devstats_pools_s
+{
+  FAR struct stats_mempool_s *pools; /* The array to fill in */
+  size_t maxpools;                   /* Size of pools[] */
+  size_t npools;                     /* Entries filled in */
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int devstats_ioctl(FAR struct file *filep, int cmd,
+                          unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_devstats_fops =
+{
+  NULL,           /* open */
+  NULL,           /* close */
+  NULL,           /* read */
+  NULL,           /* write */
+  NULL,           /* seek */
+  devstats_ioctl  /* ioctl */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devstats_system
+ *
+ * Description:
+ *   Fill in the system wide counters.
+ *
+ ****************************************************************************/
+
+static void devstats_system(FAR struct stats_system_s *sys)
+{
+#ifdef CONFIG_SCHED_CPULOAD
+  struct cpuload_s cpuload;
+  int i;
+#endif
+  struct mallinfo info;
+#ifdef CONFIG_MM_IOB
+  struct iob_stats_s iob;
+#endif
+
+  memset(sys, 0, sizeof(struct stats_system_s));
+  sys->version = STATS_VERSION;
+  sys->ncpus   = DEVSTATS_NCPUS;
+  sys->uptime  = clock_systime_ticks();
+
+#ifdef CONFIG_SCHED_CPULOAD
+  /* The IDLE threads have the PIDs 0 to ncpus - 1 */
+
+  for (i = 0; i < DEVSTATS_NCPUS; i++)
+    {
+      if (clock_cpuload(i, &cpuload) >= 0)
+        {
+          sys->cpu_idle += cpuload.active;
+          if (i == 0)
+            {
+              sys->cpu_total = cpuload.total;
+            }
+        }
+    }
+
+  sys->flags |= STATS_FLAG_CPULOAD;
+#endif
+
+  info = kmm_mallinfo();
+  sys->heap_size    = info.arena;
+  sys->heap_used    = info.uordblks;
+  sys->heap_free    = info.fordblks;
+  sys->heap_largest = info.mxordblk;
+  sys->heap_nused   = info.aordblks;
+  sys->heap_nfree   = info.ordblks;
+  sys->flags       |= STATS_FLAG_HEAP;
+
+#ifdef CONFIG_MM_IOB
+  iob_getstats(&iob);
+  sys->iob_total    = iob.ntotal;
+  sys->iob_free     = iob.nfree;
+  sys->iob_wait     = iob.nwait;
+  sys->iob_throttle = iob.nthrottle;
+  sys->flags       |= STATS_FLAG_IOB;
+#endif
+
+#ifdef CONFIG_NET_STATISTICS
+#  ifdef CONFIG_NET_IPv4
+  devstats_proto(sys->ipv4, g_netstats.ipv4);
+#  endif
+#  ifdef CONFIG_NET_IPv6
+  devstats_proto(sys->ipv6, g_netstats.ipv6);
+#  endif
+#  ifdef CONFIG_NET_ICMP
+  devstats_proto(sys->icmp, g_netstats.icmp);
+#  endif
+#  ifdef CONFIG_NET_ICMPv6
+  devstats_proto(sys->icmpv6, g_netstats.icmpv6);
+#  endif
+#  ifdef CONFIG_NET_TCP
+  devstats_proto(sys->tcp, g_netstats.tcp);
+#  endif
+#  ifdef CONFIG_NET_UDP
+  devstats_proto(sys->udp, g_netstats.udp);
+#  endif
+  sys->flags |= STATS_FLAG_NET;
+#endif
+
+#ifdef CONFIG_STACK_COLORATION
+  sys->flags |= STATS_FLAG_STACK;
+#endif
+}
+
+/****************************************************************************
+ * Name: devstats_task
+ *
+ * Description:
+ *   nxsched_foreach() callback: fill in the counters of one task.
+ *
+ ****************************************************************************/
+
+static void devstats_task(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct stats_request_s *req = arg;
+  FAR struct stats_task_s *task;
+#ifdef CONFIG_SCHED_CPULOAD
+  struct cpuload_s cpuload;
+#endif
+
+  if (req->tasks != NULL && req->system.ntasks < req->ntasks)
+    {
+      task = &req->tasks[req->system.ntasks];
+      memset(task, 0, sizeof(struct stats_task_s));
+
+      task->pid        = tcb->pid;
+      task->priority   = tcb->sched_priority;
+      task->state      = tcb->task_state;
+      task->flags      = tcb->flags;
+      task->stack_size = tcb->adj_stack_size;
+#ifdef CONFIG_STACK_COLORATION
+      task->stack_used = up_check_tcbstack(tcb);
+#endif
+#ifdef CONFIG_SCHED_CPULOAD
+      if (clock_cpuload(tcb->pid, &cpuload) >= 0)
+        {
+          task->cpu_active = cpuload.active;
+        }
+
+#endif
+#if CONFIG_TASK_NAME_SIZE > 0
+      strlcpy(task->name, tcb->name, STATS_NAME_SIZE);
+#endif
+    }
+
+  req->system.ntasks++;
+}
+
+/****************************************************************************
+ * Name: devstats_mempool
+ *
+ * Description:
+ *   mempool_procfs_foreach() callback: fill in the counters of one pool.
+ *
+ ****************************************************************************/
+
+#ifdef DEVSTATS_HAVE_MEMPOOL
+static void devstats_mempool(FAR struct mempool_s *pool, FAR void *arg)
+{
+  FAR struct devstats_pools_s *pools = arg;
+  FAR struct stats_mempool_s *stats;
+  struct mempoolinfo_s info;
+
+  if (pools->npools >= pools->maxpools)
+    {
+      return;
+    }
+
+  stats = &pools->pools[pools->npools++];
+  memset(stats, 0, sizeof(struct stats_mempool_s));
+  if (mempool_info(pool, &info) >= 0)
+    {
+      stats->blocksize = info.sizeblks;
+      stats->arena     = info.arena;
+      stats->nused     = info.aordblks;
+      stats->nfree     = info.ordblks;
+      stats->nifree    = info.iordblks;
+      stats->nwaiter   = info.nwaiter;
+    }
+
+  if (pool->procfs.name != NULL)
+    {
+      strlcpy(stats->name, pool->procfs.name, STATS_NAME_SIZE);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: devstats_ioctl
+ ****************************************************************************/
+
+static int devstats_ioctl(FAR struct file *filep, int cmd,
+                          unsigned long arg)
+{
+  FAR struct stats_request_s *req =
+    (FAR struct stats_request_s *)((uintptr_t)arg);
+
+  if (cmd != STATSIOC_GET)
+    {
+      return -ENOTTY;
+    }
+
+  if (req == NULL)
+    {
+      return -EINVAL;
+    }
+
+  devstats_system(&req->system);
+
+  /* system.ntasks counts all of the tasks, ntasks those returned */
+
+  nxsched_foreach(devstats_task, req);
+  if (req->tasks == NULL)
+    {
+      req->ntasks = 0;
+    }
+  else if (req->ntasks > req->system.ntasks)
+    {
+      req->ntasks = req->system.ntasks;
+    }
+
+  if (req->pools == NULL)
+    {
+      req->npools = 0;
+    }
+  else
+    {
+#ifdef DEVSTATS_HAVE_MEMPOOL
+      struct devstats_pools_s pools;
+
+      pools.pools    = req->pools;
+      pools.maxpools = req->npools;
+      pools.npools   = 0;
+
+      mempool_procfs_foreach(devstats_mempool, &pools);
+      req->npools = pools.npools;
+#else
+      req->npools = 0;
+#endif
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devstats_register
+ *
+ * Description:
+ *   Register /dev/stats
+ *
+ ****************************************************************************/
+
+void devstats_register(void)
+{
+  register_driver("/dev/stats", &g_devstats_fops, 0444, NULL);
+}
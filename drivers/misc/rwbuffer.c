@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <inttypes.h>
 #include <stdint.h>
@@ -766,6 +767,96 @@ int rwb_invalidate_readahead(FAR struct rwbuffer_s *rwb,
 }
 #endif
 
+/****************************************************************************
+ * Name: rwb_readpartial
+ *
+ * Description:
+ *   Read 'nbytes' bytes at 'blkoffset' within one block.  The bytes come
+ *   from the write buffer if it holds the block, else from the read-ahead
+ *   buffer, which is reloaded if needed.  Without read-ahead buffering the
+ *   block is read into a temporary buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_READBYTES
+static int rwb_readpartial(FAR struct rwbuffer_s *rwb, off_t block,
+                           size_t blkoffset, size_t nbytes,
+                           FAR uint8_t *buffer)
+{
+  FAR uint8_t *blkbuffer;
+  int ret = OK;
+
+#ifdef CONFIG_DRVR_READAHEAD
+  if (rwb->rhmaxblocks > 0)
+    {
+#ifdef CONFIG_DRVR_WRITEBUFFER
+      if (rwb->wrmaxblocks > 0)
+        {
+          ret = rwb_lock(&rwb->wrlock);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          if (rwb_overlap(rwb->wrblockstart, rwb->wrnblocks, block, 1))
+            {
+              blkbuffer = rwb->wrbuffer +
+                          (block - rwb->wrblockstart) * rwb->blocksize;
+              memcpy(buffer, blkbuffer + blkoffset, nbytes);
+              rwb_unlock(&rwb->wrlock);
+              return OK;
+            }
+        }
+#endif
+
+      ret = rwb_lock(&rwb->rhlock);
+      if (ret >= 0)
+        {
+          if (!rwb_overlap(rwb->rhblockstart, rwb->rhnblocks, block, 1))
+            {
+              ret = rwb_rhreload(rwb, block);
+            }
+
+          if (ret >= 0)
+            {
+              blkbuffer = rwb->rhbuffer +
+                          (block - rwb->rhblockstart) * rwb->blocksize;
+              memcpy(buffer, blkbuffer + blkoffset, nbytes);
+              ret = OK;
+            }
+
+          rwb_unlock(&rwb->rhlock);
+        }
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+      if (rwb->wrmaxblocks > 0)
+        {
+          rwb_unlock(&rwb->wrlock);
+        }
+#endif
+
+      return ret;
+    }
+#endif
+
+  blkbuffer = kmm_malloc(rwb->blocksize);
+  if (blkbuffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = rwb_read(rwb, block, 1, blkbuffer);
+  if (ret >= 0)
+    {
+      memcpy(buffer, blkbuffer + blkoffset, nbytes);
+      ret = OK;
+    }
+
+  kmm_free(blkbuffer);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -956,6 +1047,23 @@ static ssize_t rwb_read_(FAR struct rwbuffer_s *rwb, off_t startblock,
                 }
             }
 
+          /* A request that would not fit the read-ahead buffer anyway is
+           * read in one transfer straight into the caller's buffer.  That
+           * saves a copy and lets the driver stream the whole range.
+           */
+
+          if (remaining >= rwb->rhmaxblocks)
+            {
+              ret = rwb->rhreload(rwb->dev, rdbuffer, startblock, remaining);
+              rwb_unlock(&rwb->rhlock);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              return nblocks - remaining + ret;
+            }
+
           /* If we did not get all of the data from the buffer, then we have
            * to refill the buffer and try again.
            */
@@ -1161,23 +1269,61 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb, off_t startblock,
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_READBYTES
-ssize_t rwb_readbytes(FAR struct rwbuffer_s *dev, off_t offset,
+ssize_t rwb_readbytes(FAR struct rwbuffer_s *rwb, off_t offset,
                       size_t nbytes, FAR uint8_t *buffer)
 {
+  size_t remaining = nbytes;
+  ssize_t ret;
+
+  finfo("offset=%" PRIdOFF " nbytes=%zu buffer=%p\n",
+        offset, nbytes, buffer);
+
   /* Loop while there are bytes still be be read */
 
-  /* Make sure that the sector containing the next bytes to transfer is in
-   * memory.
-   */
+  while (remaining > 0)
+    {
+      off_t  block     = offset / rwb->blocksize;
+      size_t blkoffset = offset % rwb->blocksize;
+      size_t nread;
+
+      if (block >= rwb->nblocks)
+        {
+          break;
+        }
+
+      if (blkoffset == 0 && remaining >= rwb->blocksize)
+        {
+          /* Whole blocks go through the normal block read */
+
+          nread = MIN(remaining / rwb->blocksize, rwb->nblocks - block);
+          ret   = rwb_read(rwb, block, nread, buffer);
+          if (ret <= 0)
+            {
+              return ret;
+            }
 
-  /* How many bytes can be transfer from the in-memory data? */
+          nread = ret * rwb->blocksize;
+        }
+      else
+        {
+          /* Transfer the bytes of a partial block */
 
-  /* Transfer the bytes */
+          nread = MIN(rwb->blocksize - blkoffset, remaining);
+          ret   = rwb_readpartial(rwb, block, blkoffset, nread, buffer);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
 
-  /* Adjust counts and offsets for the next time through the loop */
+      /* Adjust counts and offsets for the next time through the loop */
+
+      offset    += nread;
+      buffer    += nread;
+      remaining -= nread;
+    }
 
-#warning Not Implemented
-  return -ENOSYS;
+  return nbytes - remaining;
 }
 #endif
 
@@ -119,6 +119,9 @@ struct mmcsd_state_s
   uint8_t wrprotect:1;             /* true: Card is write protected (from CSD) */
   uint8_t locked:1;                /* true: Media is locked (from R1) */
   uint8_t dsrimp:1;                /* true: card supports CMD4/DSR setting (from CSD) */
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+  uint8_t blkcount:1;              /* true: card supports CMD23, SET_BLOCK_COUNT */
+#endif
 #ifdef CONFIG_SDIO_DMA
   uint8_t dma:1;                   /* true: hardware supports DMA */
 #endif
@@ -179,6 +182,10 @@ static int     mmcsd_eventwait(FAR struct mmcsd_state_s *priv,
 static int     mmcsd_transferready(FAR struct mmcsd_state_s *priv);
 #if MMCSD_MULTIBLOCK_LIMIT != 1
 static int     mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv);
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+static int     mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                                   uint32_t nblocks);
+#endif
 #endif
 static int     mmcsd_setblocklen(FAR struct mmcsd_state_s *priv,
                                  uint32_t blocklen);
@@ -588,6 +595,15 @@ static void mmcsd_decode_csd(FAR struct mmcsd_state_s *priv, uint32_t csd[4])
   decoded.transpeed.transferrateunit =  csd[0]        & 7;
 #endif
 
+#if defined(CONFIG_MMCSD_SETBLOCKCOUNT) && defined(CONFIG_MMCSD_MMCSUPPORT)
+  /* MMC supports CMD23 from version 3.1 of the spec (SPEC_VERS 3) */
+
+  if (IS_MMC(priv->type))
+    {
+      priv->blkcount = ((csd[0] >> 26) & 0x0f) >= 3;
+    }
+#endif
+
   /* Word 2: Bits 64:95
    *   CCC                95:84 Card command classes
    *   READ_BL_LEN        83:80 Max. read data block length
@@ -995,6 +1011,16 @@ static void mmcsd_decode_scr(FAR struct mmcsd_state_s *priv, uint32_t scr[2])
   priv->buswidth     = (scr[0] >> 8) & 15;
 #endif
 
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+  /* CMD_SUPPORT 35:32 (SD 3.0 and later), bit 33 is CMD23 support */
+
+#ifdef CONFIG_ENDIAN_BIG
+  priv->blkcount     = (scr[0] >> 1) & 1;
+#else
+  priv->blkcount     = (scr[0] >> 25) & 1;
+#endif
+#endif
+
 #ifdef CONFIG_DEBUG_FS_INFO
 #ifdef CONFIG_ENDIAN_BIG
   /* Card SCR is big-endian order / CPU also big-endian
@@ -1323,6 +1349,32 @@ static int mmcsd_stoptransmission(FAR struct mmcsd_state_s *priv)
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: mmcsd_setblockcount
+ *
+ * Description:
+ *   Send CMD23, SET_BLOCK_COUNT, so that the following multiple block
+ *   transfer ends by itself after nblocks and no CMD12 is needed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+static int mmcsd_setblockcount(FAR struct mmcsd_state_s *priv,
+                               uint32_t nblocks)
+{
+  int ret;
+
+  mmcsd_sendcmdpoll(priv, MMCSD_CMD23, nblocks);
+  ret = mmcsd_recv_r1(priv, MMCSD_CMD23);
+  if (ret != OK)
+    {
+      ferr("ERROR: mmcsd_recv_r1 for CMD23 failed: %d\n", ret);
+    }
+
+  return ret;
+}
+#endif
 #endif
 
 /****************************************************************************
@@ -1601,6 +1653,20 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       SDIO_RECVSETUP(priv->dev, buffer, nbytes);
     }
 
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+  /* Pre-define the number of blocks if the card supports it */
+
+  if (priv->blkcount)
+    {
+      ret = mmcsd_setblockcount(priv, nblocks);
+      if (ret != OK)
+        {
+          SDIO_CANCEL(priv->dev);
+          return ret;
+        }
+    }
+#endif
+
   /* Send CMD18, READ_MULT_BLOCK: Read a block of the size selected by
    * the mmcsd_setblocklen() and verify that good R1 status is returned
    */
@@ -1623,6 +1689,15 @@ static ssize_t mmcsd_readmultiple(FAR struct mmcsd_state_s *priv,
       return ret;
     }
 
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+  /* The transfer already ended after the pre-defined block count */
+
+  if (priv->blkcount)
+    {
+      return nblocks;
+    }
+#endif
+
   /* Send STOP_TRANSMISSION */
 
   ret = mmcsd_stoptransmission(priv);
@@ -1928,6 +2003,19 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
 
   if ((priv->caps & SDIO_CAPS_DMABEFOREWRITE) == 0)
     {
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+      /* Pre-define the number of blocks if the card supports it */
+
+      if (priv->blkcount)
+        {
+          ret = mmcsd_setblockcount(priv, nblocks);
+          if (ret != OK)
+            {
+              return ret;
+            }
+        }
+#endif
+
       /* Send CMD25, WRITE_MULTIPLE_BLOCK, and verify that good R1 status
        * is returned
        */
@@ -1969,6 +2057,18 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
 
   if ((priv->caps & SDIO_CAPS_DMABEFOREWRITE) != 0)
     {
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+      if (priv->blkcount)
+        {
+          ret = mmcsd_setblockcount(priv, nblocks);
+          if (ret != OK)
+            {
+              SDIO_CANCEL(priv->dev);
+              return ret;
+            }
+        }
+#endif
+
       /* Send CMD25, WRITE_MULTIPLE_BLOCK, and verify that good R1 status
        * is returned
        */
@@ -1997,9 +2097,21 @@ static ssize_t mmcsd_writemultiple(FAR struct mmcsd_state_s *priv,
        */
     }
 
-  /* Send STOP_TRANSMISSION */
+  /* Send STOP_TRANSMISSION.  With a pre-defined block count the transfer
+   * already ended, unless it failed.
+   */
+
+#ifdef CONFIG_MMCSD_SETBLOCKCOUNT
+  if (priv->blkcount && evret == OK)
+    {
+      ret = OK;
+    }
+  else
+#endif
+    {
+      ret = mmcsd_stoptransmission(priv);
+    }
 
-  ret = mmcsd_stoptransmission(priv);
   if (evret != OK)
     {
       return evret;
@@ -97,6 +97,9 @@ static int     dhara_geometry(FAR struct inode *inode,
 static int     dhara_ioctl(FAR struct inode *inode,
                            int cmd,
                            unsigned long arg);
+static int     dhara_read_pages(FAR dhara_dev_t *dev, dhara_page_t page,
+                                size_t count, FAR uint8_t *buffer,
+                                FAR dhara_error_t *err);
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 static int     dhara_unlink(FAR struct inode *inode);
 #endif
@@ -285,6 +288,49 @@ static void dhara_update_readcache(FAR dhara_dev_t *dev,
     }
 }
 
+/****************************************************************************
+ * Name: dhara_read_pages
+ *
+ * Description:
+ *   Read consecutive pages holding user data.  Runs of more than one page
+ *   bypass the page cache kept for the map metadata and go to the MTD
+ *   driver in one request, letting it stream the pages.
+ *
+ ****************************************************************************/
+
+static int dhara_read_pages(FAR dhara_dev_t *dev, dhara_page_t page,
+                            size_t count, FAR uint8_t *buffer,
+                            FAR dhara_error_t *err)
+{
+  ssize_t nread;
+  int ret;
+
+  if (count > 1)
+    {
+      nread = MTD_BREAD(dev->mtd, page, count, buffer);
+      if (nread == (ssize_t)count || nread == -EUCLEAN)
+        {
+          return 0;
+        }
+    }
+
+  /* Read page by page to find the one that fails */
+
+  while (count-- > 0)
+    {
+      ret = dhara_nand_read(&dev->nand, page++, 0, dev->geo.blocksize,
+                            buffer, err);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      buffer += dev->geo.blocksize;
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Name: dhara_open
  *
@@ -346,34 +392,80 @@ static ssize_t dhara_read(FAR struct inode *inode,
                           unsigned int nsectors)
 {
   FAR dhara_dev_t *dev;
+  dhara_page_t page = DHARA_PAGE_NONE;
+  dhara_page_t next = DHARA_PAGE_NONE;
+  dhara_error_t err;
   size_t nread = 0;
+  size_t count;
   int ret = 0;
 
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
   nxmutex_lock(&dev->lock);
-  while (nsectors-- > 0)
+  while (nread < nsectors)
     {
-      dhara_error_t err;
-      ret = dhara_map_read(&dev->map,
-                           start_sector,
-                           buffer,
-                           &err);
-      if (ret < 0)
+      /* Find the page holding the sector, unless the lookup ahead for the
+       * previous run already did.
+       */
+
+      count = 1;
+      if (page == DHARA_PAGE_NONE &&
+          dhara_map_find(&dev->map, start_sector, &page, &err) < 0)
         {
-          ret = dhara_convert_result(err);
-          ferr("Read startblock %lld failed nread %zd err: %s\n",
-               (long long)start_sector, nread, dhara_strerror(err));
-          break;
+          if (err != DHARA_E_NOT_FOUND)
+            {
+              goto errout;
+            }
+
+          /* Never written, reads back as erased */
+
+          memset(buffer, 0xff, dev->geo.blocksize);
+          page = DHARA_PAGE_NONE;
+        }
+      else
+        {
+          /* The journal puts sectors written in sequence in consecutive
+           * pages, so gather those into a single multi-page MTD read.
+           */
+
+          for (; nread + count < nsectors; count++)
+            {
+              if (dhara_map_find(&dev->map, start_sector + count,
+                                 &next, &err) < 0)
+                {
+                  next = DHARA_PAGE_NONE;
+                  break;
+                }
+
+              if (next != page + count)
+                {
+                  break;
+                }
+            }
+
+          ret = dhara_read_pages(dev, page, count, buffer, &err);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          page = next;
         }
 
-      nread++;
-      start_sector++;
-      buffer += dev->geo.blocksize;
+      nread        += count;
+      start_sector += count;
+      buffer       += count * dev->geo.blocksize;
     }
 
   nxmutex_unlock(&dev->lock);
+  return nread;
+
+errout:
+  ret = dhara_convert_result(err);
+  ferr("Read startblock %lld failed nread %zd err: %s\n",
+       (long long)start_sector, nread, dhara_strerror(err));
+  nxmutex_unlock(&dev->lock);
   return nread ? nread : ret;
 }
 
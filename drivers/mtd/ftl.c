@@ -75,6 +75,9 @@ struct ftl_struct_s
   uint16_t              refs;     /* Number of references */
   bool                  unlinked; /* The driver has been unlinked */
   FAR uint8_t          *eblock;   /* One, in-memory erase block */
+#ifdef CONFIG_FTL_SKIP_ERASED
+  int16_t               erasestate; /* Erased byte value, -1 if unknown */
+#endif
 
   /* The nand block map between logic block and physical block */
 
@@ -452,6 +455,38 @@ static ssize_t ftl_read(FAR struct inode *inode, unsigned char *buffer,
 #endif
 }
 
+/****************************************************************************
+ * Name: ftl_erased
+ *
+ * Description:
+ *   Check if a region read back from FLASH is still in the erased state, so
+ *   that the data may be programmed without erasing the erase block first.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_SKIP_ERASED
+static bool ftl_erased(FAR struct ftl_struct_s *dev,
+                       FAR const uint8_t *buffer, size_t nbytes)
+{
+  if (dev->erasestate < 0)
+    {
+      return false;
+    }
+
+  while (nbytes-- > 0)
+    {
+      if (*buffer++ != dev->erasestate)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#else
+#  define ftl_erased(dev, buffer, nbytes) false
+#endif
+
 /****************************************************************************
  * Name: ftl_flush
  *
@@ -484,6 +519,9 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
   size_t nxfrd;
   int    nbytes;
   int    ret;
+#ifdef CONFIG_FTL_SKIP_ERASED
+  bool   erased;
+#endif
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
@@ -518,18 +556,10 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
           return -EIO;
         }
 
-      /* Then erase the erase block */
+      /* Get the location of the user data in the buffered erase block */
 
+      offset     = (startblock & mask) * dev->geo.blocksize;
       eraseblock = rwblock / dev->blkper;
-      ret        = ftl_mtd_erase(dev, eraseblock);
-      if (ret < 0)
-        {
-          return ret;
-        }
-
-      /* Copy the user data at the end of the buffered erase block */
-
-      offset = (startblock & mask) * dev->geo.blocksize;
 
       if (short_write)
         {
@@ -540,17 +570,44 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
           nbytes = dev->geo.erasesize - offset;
         }
 
-      finfo("Copy %d bytes into erase block=%" PRIdOFF
-            " at offset=%" PRIdOFF "\n", nbytes, eraseblock, offset);
-
-      memcpy(dev->eblock + offset, buffer, nbytes);
+      if (ftl_erased(dev, dev->eblock + offset, nbytes))
+        {
+          /* The target blocks are still erased:  Just program them */
 
-      /* And write the erase block back to flash */
+          finfo("Program %d bytes into erased block=%" PRIdOFF
+                " at offset=%" PRIdOFF "\n", nbytes, eraseblock, offset);
 
-      nxfrd = ftl_mtd_bwrite(dev, rwblock, dev->eblock);
-      if (nxfrd != dev->blkper)
+          nxfrd = MTD_BWRITE(dev->mtd, startblock,
+                             nbytes / dev->geo.blocksize, buffer);
+          if (nxfrd != nbytes / dev->geo.blocksize)
+            {
+              return -EIO;
+            }
+        }
+      else
         {
-          return -EIO;
+          /* Then erase the erase block */
+
+          ret = ftl_mtd_erase(dev, eraseblock);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          /* Copy the user data at the end of the buffered erase block */
+
+          finfo("Copy %d bytes into erase block=%" PRIdOFF
+                " at offset=%" PRIdOFF "\n", nbytes, eraseblock, offset);
+
+          memcpy(dev->eblock + offset, buffer, nbytes);
+
+          /* And write the erase block back to flash */
+
+          nxfrd = ftl_mtd_bwrite(dev, rwblock, dev->eblock);
+          if (nxfrd != dev->blkper)
+            {
+              return -EIO;
+            }
         }
 
       /* Then update for amount written */
@@ -571,13 +628,32 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
 
   while (remaining >= dev->blkper)
     {
-      /* Erase the erase block */
-
       eraseblock = alignedblock / dev->blkper;
-      ret        = ftl_mtd_erase(dev, eraseblock);
-      if (ret < 0)
+
+#ifdef CONFIG_FTL_SKIP_ERASED
+      /* Reading the erase block back is much cheaper than erasing it, so
+       * check first if the erase can be skipped.
+       */
+
+      erased = false;
+      if (dev->erasestate >= 0 && ftl_alloc_eblock(dev) >= 0)
         {
-          return ret;
+          nxfrd = ftl_mtd_bread(dev, alignedblock, dev->blkper,
+                                dev->eblock);
+          erased = nxfrd == dev->blkper &&
+                   ftl_erased(dev, dev->eblock, dev->geo.erasesize);
+        }
+
+      if (!erased)
+#endif
+        {
+          /* Erase the erase block */
+
+          ret = ftl_mtd_erase(dev, eraseblock);
+          if (ret < 0)
+            {
+              return ret;
+            }
         }
 
       /* Write a full erase back to flash */
@@ -617,28 +693,45 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
           return -EIO;
         }
 
-      /* Then erase the erase block */
-
       eraseblock = alignedblock / dev->blkper;
-      ret        = ftl_mtd_erase(dev, eraseblock);
-      if (ret < 0)
+      nbytes     = remaining * dev->geo.blocksize;
+
+      if (ftl_erased(dev, dev->eblock, nbytes))
         {
-          return ret;
+          /* The target blocks are still erased:  Just program them */
+
+          finfo("Program %d bytes into erased block=%" PRIdOFF
+                " at offset=0\n", nbytes, eraseblock);
+
+          nxfrd = MTD_BWRITE(dev->mtd, alignedblock, remaining, buffer);
+          if (nxfrd != remaining)
+            {
+              return -EIO;
+            }
         }
+      else
+        {
+          /* Then erase the erase block */
 
-      /* Copy the user data at the beginning the buffered erase block */
+          ret = ftl_mtd_erase(dev, eraseblock);
+          if (ret < 0)
+            {
+              return ret;
+            }
 
-      nbytes = remaining * dev->geo.blocksize;
-      finfo("Copy %d bytes into erase block=%" PRIdOFF " at offset=0\n",
-             nbytes, alignedblock);
-      memcpy(dev->eblock, buffer, nbytes);
+          /* Copy the user data at the beginning the buffered erase block */
 
-      /* And write the erase back to flash */
+          finfo("Copy %d bytes into erase block=%" PRIdOFF
+                " at offset=0\n", nbytes, alignedblock);
+          memcpy(dev->eblock, buffer, nbytes);
 
-      nxfrd = ftl_mtd_bwrite(dev, alignedblock, dev->eblock);
-      if (nxfrd != dev->blkper)
-        {
-          return -EIO;
+          /* And write the erase back to flash */
+
+          nxfrd = ftl_mtd_bwrite(dev, alignedblock, dev->eblock);
+          if (nxfrd != dev->blkper)
+            {
+              return -EIO;
+            }
         }
     }
 
@@ -871,6 +964,24 @@ int ftl_initialize_by_path(FAR const char *path, FAR struct mtd_dev_s *mtd)
             }
         }
 
+#ifdef CONFIG_FTL_SKIP_ERASED
+      /* Writes can only skip the erase on devices without a bad block map,
+       * the pages of a NAND erase block must be programmed in order.
+       */
+
+      dev->erasestate = -1;
+      if (dev->lptable == NULL)
+        {
+          uint8_t erasestate;
+
+          if (MTD_IOCTL(mtd, MTDIOC_ERASESTATE,
+                        (unsigned long)((uintptr_t)&erasestate)) >= 0)
+            {
+              dev->erasestate = erasestate;
+            }
+        }
+#endif
+
       /* Inode private data is a reference to the FTL device structure */
 
       ret = register_blockdriver(path, &g_bops, 0, dev);
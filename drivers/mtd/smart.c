@@ -43,6 +43,8 @@
 #include <nuttx/crc16.h>
 #include <nuttx/crc32.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -57,6 +59,21 @@
 #  define CONFIG_SMART_LOCAL_CHECKFREE
 #endif
 
+/* With background garbage collection, the device is shared with the LPWORK
+ * worker and every access must hold the device lock.
+ */
+
+#ifdef CONFIG_MTD_SMART_BGGC
+#  define smart_lock(dev)         nxmutex_lock(&(dev)->lock)
+#  define smart_unlock(dev)       nxmutex_unlock(&(dev)->lock)
+#  define SMART_BGGC_WATERMARK(dev) \
+     (CONFIG_MTD_SMART_BGGC_WATERMARK * (dev)->availsectperblk)
+#else
+#  define smart_lock(dev)         OK
+#  define smart_unlock(dev)
+#  define smart_bggc_schedule(dev)
+#endif
+
 #define SMART_STATUS_COMMITTED    0x80
 #define SMART_STATUS_RELEASED     0x40
 #define SMART_STATUS_CRC          0x20
@@ -297,6 +314,12 @@ struct smart_struct_s
   size_t                bytesalloc;
   struct smart_alloc_s  alloc[SMART_MAX_ALLOCS];   /* Array of memory allocations */
 #endif
+#ifdef CONFIG_MTD_SMART_BGGC
+  mutex_t               lock;             /* Serializes access with the GC worker */
+  struct work_s         gcwork;           /* Background garbage collection work */
+  bool                  gcpending;        /* Erase of an empty block was deferred */
+  uint16_t              gcreleased;       /* Released sectors when the GC went idle */
+#endif
 };
 
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
@@ -450,6 +473,10 @@ static int     smart_relocate_sector(FAR struct smart_struct_s *dev,
 static int     smart_fsck(FAR struct smart_struct_s *dev);
 #endif
 
+#ifdef CONFIG_MTD_SMART_BGGC
+static void    smart_bggc_schedule(FAR struct smart_struct_s *dev);
+#endif
+
 #ifdef CONFIG_SMART_DEV_LOOP
 static ssize_t smart_loop_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
@@ -899,6 +926,7 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
                           blkcnt_t start_sector, unsigned int nsectors)
 {
   FAR struct smart_struct_s *dev;
+  ssize_t ret;
 
   finfo("SMART: sector: %" PRIuOFF " nsectors: %u\n",
         start_sector, nsectors);
@@ -909,7 +937,16 @@ static ssize_t smart_read(FAR struct inode *inode, unsigned char *buffer,
 #else
   dev = inode->i_private;
 #endif
-  return smart_reload(dev, buffer, start_sector, nsectors);
+
+  ret = smart_lock(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = smart_reload(dev, buffer, start_sector, nsectors);
+  smart_unlock(dev);
+  return ret;
 }
 
 /****************************************************************************
@@ -946,7 +983,11 @@ static ssize_t smart_write(FAR struct inode *inode,
   dev = inode->i_private;
 #endif
 
-  /* I think maybe we need to lock on a mutex here */
+  ret = smart_lock(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
@@ -988,8 +1029,7 @@ static ssize_t smart_write(FAR struct inode *inode,
               ferr("ERROR: Erase block=%" PRIdOFF " failed: %d\n",
                    eraseblock, ret);
 
-              /* Unlock the mutex if we add one */
-
+              smart_unlock(dev);
               return ret;
             }
         }
@@ -1019,8 +1059,7 @@ static ssize_t smart_write(FAR struct inode *inode,
           ferr("ERROR: Write block %" PRIdOFF " failed: %zd.\n",
                nextblock, nxfrd);
 
-          /* Unlock the mutex if we add one */
-
+          smart_unlock(dev);
           return -EIO;
         }
 
@@ -1032,6 +1071,7 @@ static ssize_t smart_write(FAR struct inode *inode,
       alignedblock += mtdblkspererase;
     }
 
+  smart_unlock(dev);
   return nsectors;
 }
 
@@ -4902,7 +4942,11 @@ static int smart_writesector(FAR struct smart_struct_s *dev,
 
       /* Test if releasing the sector created an empty erase block */
 
+#ifdef CONFIG_MTD_SMART_BGGC
+      dev->gcpending = true;
+#else
       smart_erase_block_if_empty(dev, block, FALSE);
+#endif
 
       /* Since we performed a relocation, do garbage collection to
        * ensure we don't fill up our flash with released blocks.
@@ -5458,13 +5502,180 @@ static inline int smart_freesector(FAR struct smart_struct_s *dev,
 
   /* If this block has only released blocks, then erase it */
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  dev->gcpending = true;
+#else
   smart_erase_block_if_empty(dev, block, FALSE);
+#endif
   ret = OK;
 
 errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_bggc_findblock
+ *
+ * Description:  Find the next erase block for the garbage collection
+ *               worker:  a block holding only released sectors if erasing
+ *               one was deferred, otherwise the block with the most
+ *               released sectors.  Returns 0xffff if no block is worth
+ *               collecting.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static uint16_t smart_bggc_findblock(FAR struct smart_struct_s *dev,
+                                     FAR bool *empty)
+{
+  uint16_t collectblock = 0xffff;
+  uint16_t releasemax = 0;
+  uint16_t releasecount;
+  uint16_t freecount;
+  int x;
+
+  *empty = false;
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      releasecount = smart_get_count(dev, dev->releasecount, x);
+      freecount = smart_get_count(dev, dev->freecount, x);
+#else
+      releasecount = dev->releasecount[x];
+      freecount = dev->freecount[x];
+#endif
+
+      if (dev->gcpending && freecount < 1 &&
+          freecount + releasecount == dev->availsectperblk)
+        {
+          *empty = true;
+          return x;
+        }
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      /* Don't collect blocks that have been worn completely */
+
+      if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
+        {
+          continue;
+        }
+#endif
+
+      if (releasecount > releasemax)
+        {
+          releasemax = releasecount;
+          collectblock = x;
+        }
+    }
+
+  /* Moving the live sectors of a mostly live block costs more than it
+   * frees, leave those to the garbage collection on the write path.
+   */
+
+  if (releasemax == 0 || releasemax < dev->availsectperblk / 4)
+    {
+      return 0xffff;
+    }
+
+  return collectblock;
+}
+
+/****************************************************************************
+ * Name: smart_bggc_worker
+ *
+ * Description:  Erase one empty erase block, or relocate the one with the
+ *               most released sectors while the free sectors are below the
+ *               watermark.  Runs on the low priority work queue and queues
+ *               itself again until there is nothing left to do.
+ *
+ ****************************************************************************/
+
+static void smart_bggc_worker(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = arg;
+  uint16_t block;
+  bool empty;
+
+  if (smart_lock(dev) < 0)
+    {
+      return;
+    }
+
+  if (dev->formatstatus == SMART_FMT_STAT_FORMATTED)
+    {
+      block = smart_bggc_findblock(dev, &empty);
+      if (empty)
+        {
+          smart_erase_block_if_empty(dev, block, FALSE);
+        }
+      else
+        {
+          dev->gcpending = false;
+          if (block != 0xffff &&
+              dev->freesectors < SMART_BGGC_WATERMARK(dev))
+            {
+              finfo("Collecting block %d, totalfree=%d totalrelease=%d\n",
+                    block, dev->freesectors, dev->releasesectors);
+
+              if (smart_relocate_block(dev, block) != OK)
+                {
+                  block = 0xffff;
+                }
+            }
+          else
+            {
+              block = 0xffff;
+            }
+
+          if (block == 0xffff)
+            {
+              /* Go idle until more sectors are released */
+
+              dev->gcreleased = dev->releasesectors;
+            }
+        }
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+        {
+          /* Write new wear status bits to the device */
+
+          smart_write_wearstatus(dev);
+        }
+#endif
+
+      smart_bggc_schedule(dev);
+    }
+
+  smart_unlock(dev);
+}
+
+/****************************************************************************
+ * Name: smart_bggc_schedule
+ *
+ * Description:  Queue the garbage collection worker if an erase was
+ *               deferred, or if the free sectors are below the watermark
+ *               and sectors were released since it last went idle.  Called
+ *               with the device locked.
+ *
+ ****************************************************************************/
+
+static void smart_bggc_schedule(FAR struct smart_struct_s *dev)
+{
+  if (!work_available(&dev->gcwork))
+    {
+      return;
+    }
+
+  if (dev->gcpending ||
+      (dev->freesectors < SMART_BGGC_WATERMARK(dev) &&
+       dev->releasesectors != dev->gcreleased))
+    {
+      work_queue(LPWORK, &dev->gcwork, smart_bggc_worker, dev, 0);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: smart_ioctl
  *
@@ -5490,6 +5701,12 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   dev = inode->i_private;
 #endif
 
+  ret = smart_lock(dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* Process the ioctl's we care about first, pass any we don't respond
    * to directly to the underlying MTD device.
    */
@@ -5629,6 +5846,8 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     }
 
 ok_out:
+  smart_bggc_schedule(dev);
+  smart_unlock(dev);
   return ret;
 }
 
@@ -6169,6 +6388,9 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd,
       /* Initialize the SMART device structure */
 
       dev->mtd = mtd;
+#ifdef CONFIG_MTD_SMART_BGGC
+      nxmutex_init(&dev->lock);
+#endif
 
       /* Get the device geometry. (casting to uintptr_t first eliminates
        * complaints on some architectures where the sizeof long is different
@@ -6316,6 +6538,9 @@ errout:
     }
 #endif
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  nxmutex_destroy(&dev->lock);
+#endif
   kmm_free(dev);
   return ret;
 }
@@ -6447,6 +6672,15 @@ static int smart_loteardown(FAR const char *devname)
 
   /* Now teardown the filemtd */
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  /* Stop the garbage collection before the MTD goes away */
+
+  nxmutex_lock(&dev->lock);
+  work_cancel(LPWORK, &dev->gcwork);
+  nxmutex_unlock(&dev->lock);
+  nxmutex_destroy(&dev->lock);
+#endif
+
   filemtd_teardown(dev->mtd);
   unregister_blockdriver(devname);
 
@@ -24,19 +24,27 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
+
 #include <debug.h>
 #include <errno.h>
+#include <sched.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 
+#include <nuttx/cache.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/mutex.h>
 #include <nuttx/net/can.h>
+#include <nuttx/net/ip.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#include <nuttx/net/tcp.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 
@@ -58,11 +66,28 @@
  * Private Types
  ****************************************************************************/
 
-/* This structure describes the state of the upper half driver */
+/* This structure describes a TX/RX queue pair of the upper half driver */
 
-struct netdev_upperhalf_s
+struct netdev_upperhalf_s;
+struct netdev_upper_queue_s
 {
-  FAR struct netdev_lowerhalf_s *lower;
+  FAR struct netdev_upperhalf_s *upper;
+  int index;
+
+  /* Serializes the calls into the lower half for this queue.  It may be
+   * taken with the network locked, but the network is never locked with it
+   * held.
+   */
+
+  mutex_t lock;
+
+  /* Frames taken from the stack, not yet handed to the lower half */
+
+  FAR netpkt_t *txq[CONFIG_NETDEV_BATCH_PACKETS];
+#ifdef CONFIG_NETDEV_OFFLOAD
+  uint16_t txgso[CONFIG_NETDEV_BATCH_PACKETS]; /* TSO segment sizes */
+#endif
+  int txqlen;
 
   /* Deferring poll work to work queue or thread */
 
@@ -75,6 +100,45 @@ struct netdev_upperhalf_s
 #endif
 };
 
+/* This structure describes the state of the upper half driver */
+
+struct netdev_upperhalf_s
+{
+  FAR struct netdev_lowerhalf_s *lower;
+
+  /* Frames taken from the stack by the running devif_poll() */
+
+  int txpolled;
+
+  /* The queue pairs.  The calls into the lower half which are not bound to
+   * a queue take the locks of all queues.
+   */
+
+  int nqueues;
+  struct netdev_upper_queue_s queue[CONFIG_NETDEV_MAX_QUEUES];
+};
+
+/* A received TCP segment that may be merged with the next ones */
+
+#ifdef CONFIG_NETDEV_GRO
+struct netdev_upper_gro_s
+{
+  FAR uint8_t          *ip;      /* The IP header */
+  FAR struct tcp_hdr_s *tcp;     /* The TCP header */
+  uint16_t              iplen;   /* Size of the IP header */
+  uint16_t              hdrlen;  /* Size of the IP and TCP headers */
+  uint16_t              datalen; /* Size of the TCP payload */
+  uint32_t              seqno;   /* Sequence number of the payload */
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static inline void
+netdev_upper_queue_work(FAR struct netdev_upper_queue_s *queue);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -195,6 +259,8 @@ netdev_upper_alloc(FAR struct netdev_lowerhalf_s *dev)
   /* Allocate the upper-half data structure */
 
   FAR struct netdev_upperhalf_s *upper;
+  FAR struct netdev_upper_queue_s *queue;
+  int i;
 
   DEBUGASSERT(dev != NULL && dev->netdev.d_private == NULL);
 
@@ -205,12 +271,170 @@ netdev_upper_alloc(FAR struct netdev_lowerhalf_s *dev)
       return NULL;
     }
 
-  upper->lower = dev;
+  upper->lower   = dev;
+  upper->nqueues = 1;
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+  if (dev->nqueues > 1)
+    {
+      upper->nqueues = MIN(dev->nqueues, CONFIG_NETDEV_MAX_QUEUES);
+    }
+#endif
+
+  for (i = 0; i < upper->nqueues; i++)
+    {
+      queue        = &upper->queue[i];
+      queue->upper = upper;
+      queue->index = i;
+      nxmutex_init(&queue->lock);
+#ifdef CONFIG_NETDEV_WORK_THREAD
+      nxsem_init(&queue->sem, 0, 0);
+      nxsem_init(&queue->sem_exit, 0, 0);
+#endif
+    }
+
   dev->netdev.d_private = upper;
 
   return upper;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_free
+ *
+ * Description:
+ *   Release the upper half structure.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_free(FAR struct netdev_upperhalf_s *upper)
+{
+  int i;
+
+  for (i = 0; i < upper->nqueues; i++)
+    {
+      nxmutex_destroy(&upper->queue[i].lock);
+#ifdef CONFIG_NETDEV_WORK_THREAD
+      nxsem_destroy(&upper->queue[i].sem);
+      nxsem_destroy(&upper->queue[i].sem_exit);
+#endif
+    }
+
+  upper->lower->netdev.d_private = NULL;
+  kmm_free(upper);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_lock/unlock
+ *
+ * Description:
+ *   Take or release the locks of all queues, around the calls into the
+ *   lower half which are not bound to a queue.  They are taken in index
+ *   order.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_lock(FAR struct netdev_upperhalf_s *upper)
+{
+  int i;
+
+  for (i = 0; i < upper->nqueues; i++)
+    {
+      nxmutex_lock(&upper->queue[i].lock);
+    }
+}
+
+static void netdev_upper_unlock(FAR struct netdev_upperhalf_s *upper)
+{
+  int i;
+
+  for (i = upper->nqueues - 1; i >= 0; i--)
+    {
+      nxmutex_unlock(&upper->queue[i].lock);
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_upper_txqueue
+ *
+ * Description:
+ *   Select the TX queue of an outgoing frame.  The addresses and, for TCP
+ *   and UDP, the ports are hashed so that the frames of a flow keep their
+ *   order on one queue.  Fragments are hashed on the addresses alone,
+ *   since only the first one holds the ports.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_txqueue(FAR struct netdev_upperhalf_s *upper,
+                                FAR netpkt_t *pkt)
+{
+#if CONFIG_NETDEV_MAX_QUEUES > 1 && \
+    (defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6))
+  FAR const uint8_t *ip = IOB_DATA(pkt);
+  FAR const uint8_t *key;
+  uint32_t hash = 2166136261u;
+  int keylen;
+  int hdrlen;
+  int proto;
+  int i;
+
+  if (upper->nqueues <= 1)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_NET_CAN
+  if (upper->lower->netdev.d_lltype == NET_LL_CAN)
+    {
+      return 0;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  if ((ip[0] >> 4) == 4 && pkt->io_len >= IPv4_HDRLEN)
+    {
+      hdrlen = (ip[0] & 0x0f) << 2;
+      proto  = (ip[6] & 0x3f) == 0 && ip[7] == 0 ? ip[9] : 0;
+      key    = ip + 12;
+      keylen = 8;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((ip[0] >> 4) == 6 && pkt->io_len >= IPv6_HDRLEN)
+    {
+      hdrlen = IPv6_HDRLEN;
+      proto  = ip[6];
+      key    = ip + 8;
+      keylen = 32;
+    }
+  else
+#endif
+    {
+      return 0;
+    }
+
+  for (i = 0; i < keylen; i++)
+    {
+      hash = (hash ^ key[i]) * 16777619u;
+    }
+
+  if ((proto == IP_PROTO_TCP || proto == IP_PROTO_UDP) &&
+      pkt->io_len >= hdrlen + 4)
+    {
+      for (i = 0; i < 4; i++)
+        {
+          hash = (hash ^ ip[hdrlen + i]) * 16777619u;
+        }
+    }
+
+  return hash % upper->nqueues;
+#else
+  return 0;
+#endif
+}
+
 /****************************************************************************
  * Name: netdev_upper_can_tx
  *
@@ -227,6 +451,118 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
   return netdev_lower_quota_load(upper->lower, NETPKT_TX) > 0;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_transmit_sg
+ *
+ * Description:
+ *   Hand a packet to a scatter-gather capable lower half.  A chain with
+ *   more entries than descriptors is packed first.  The head entry is left
+ *   alone since its offset holds the link layer header.  The segments are
+ *   written back from the D-cache in one batch:  the IOBs of a chain are
+ *   often neighbours in the pool and share cache lines.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_SCATTER_GATHER
+static int netdev_upper_transmit_sg(FAR struct netdev_lowerhalf_s *lower,
+                                    FAR netpkt_t *pkt)
+{
+  struct iovec iov[CONFIG_NETDEV_SG_MAXSEGS];
+  struct dcache_batch_s batch;
+  int iovcnt;
+  int i;
+
+  if (iob_count(pkt) > CONFIG_NETDEV_SG_MAXSEGS && pkt->io_flink != NULL)
+    {
+      pkt->io_flink = iob_pack(pkt->io_flink);
+      if (iob_count(pkt) > CONFIG_NETDEV_SG_MAXSEGS)
+        {
+          return -E2BIG;
+        }
+    }
+
+  iovcnt = netpkt_to_iov(lower, pkt, iov, CONFIG_NETDEV_SG_MAXSEGS);
+
+  dcache_batch_init(&batch, DCACHE_BATCH_CLEAN);
+  for (i = 0; i < iovcnt; i++)
+    {
+      dcache_batch_add(&batch, (uintptr_t)iov[i].iov_base,
+                       (uintptr_t)iov[i].iov_base + iov[i].iov_len);
+    }
+
+  dcache_batch_commit(&batch);
+
+  return lower->ops->transmit_sg(lower, pkt, iov, iovcnt);
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_txflush
+ *
+ * Description:
+ *   Hand the queued frames to the lower half.  A frame that the lower half
+ *   refuses is dropped, the protocols above recover from the loss.
+ *
+ * Assumptions:
+ *   Called with queue->lock held.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_txflush(FAR struct netdev_upper_queue_s *queue)
+{
+  FAR struct netdev_lowerhalf_s *lower = queue->upper->lower;
+  FAR netpkt_t                  *pkt;
+  int                            ret;
+  int                            i;
+
+  for (i = 0; i < queue->txqlen; i++)
+    {
+      pkt = queue->txq[i];
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+      if (queue->upper->nqueues > 1)
+        {
+#ifdef CONFIG_NETDEV_OFFLOAD
+          if (queue->txgso[i] > 0)
+            {
+              ret = lower->ops->transmitq_tso(lower, pkt, queue->index,
+                                              queue->txgso[i]);
+            }
+          else
+#endif
+            {
+              ret = lower->ops->transmitq(lower, pkt, queue->index);
+            }
+        }
+      else
+#endif
+#ifdef CONFIG_NETDEV_OFFLOAD
+      if (queue->txgso[i] > 0)
+        {
+          ret = lower->ops->transmit_tso(lower, pkt, queue->txgso[i]);
+        }
+      else
+#endif
+#ifdef CONFIG_NETDEV_SCATTER_GATHER
+      if (lower->ops->transmit_sg != NULL)
+        {
+          ret = netdev_upper_transmit_sg(lower, pkt);
+        }
+      else
+#endif
+        {
+          ret = lower->ops->transmit(lower, pkt);
+        }
+
+      if (ret != OK)
+        {
+          NETDEV_TXERRORS(&lower->netdev);
+          netpkt_free(lower, pkt, NETPKT_TX);
+        }
+    }
+
+  queue->txqlen = 0;
+}
+
 /****************************************************************************
  * Name: netdev_upper_txpoll
  *
@@ -255,9 +591,8 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
 static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
-  FAR struct netdev_lowerhalf_s *lower = upper->lower;
-  FAR netpkt_t                  *pkt;
-  int                            ret;
+  FAR struct netdev_upper_queue_s *queue;
+  FAR netpkt_t *pkt;
 
   DEBUGASSERT(dev->d_len > 0);
 
@@ -269,23 +604,71 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
   pkt_input(dev);
 #endif
 
-  pkt = netpkt_get(dev, NETPKT_TX);
-  ret = lower->ops->transmit(lower, pkt);
+  /* Queue the frame, it is transmitted once the network is unlocked.  A
+   * full queue is handed to the lower half right away.
+   */
 
-  if (ret != OK)
-    {
-      /* Stop polling on any error
-       * REVISIT: maybe store the pkt in upper half and retry later?
-       */
+  pkt   = netpkt_get(dev, NETPKT_TX);
+  queue = &upper->queue[netdev_upper_txqueue(upper, pkt)];
+  upper->txpolled++;
 
-      NETDEV_TXERRORS(dev);
-      netpkt_put(dev, pkt, NETPKT_TX);
-      return ret;
+  nxmutex_lock(&queue->lock);
+  if (queue->txqlen == CONFIG_NETDEV_BATCH_PACKETS)
+    {
+      netdev_upper_txflush(queue);
     }
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  queue->txgso[queue->txqlen] = dev->d_gsosize;
+  dev->d_gsosize = 0;
+#endif
+  queue->txq[queue->txqlen++] = pkt;
+  nxmutex_unlock(&queue->lock);
+
   return NETDEV_TX_CONTINUE;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_xmit
+ *
+ * Description:
+ *   Transmit the frame in d_iob right away, for the IP forwarding fast
+ *   path.  The frame is queued as by a TX poll and its queue is handed to
+ *   the lower half.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   OK if the frame was taken, -EBUSY if the device cannot transmit now.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+static int netdev_upper_xmit(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR struct netdev_upper_queue_s *queue;
+
+  if (!IFF_IS_UP(dev->d_flags) || !netdev_upper_can_tx(upper))
+    {
+      return -EBUSY;
+    }
+
+  queue = &upper->queue[netdev_upper_txqueue(upper, dev->d_iob)];
+  netdev_upper_txpoll(dev);
+
+  nxmutex_lock(&queue->lock);
+  netdev_upper_txflush(queue);
+  nxmutex_unlock(&queue->lock);
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_upper_txavail_work
  *
@@ -308,8 +691,14 @@ static void netdev_upper_txavail_work(FAR struct netdev_upperhalf_s *upper)
 
   if (IFF_IS_UP(dev->d_flags))
     {
+      /* Stop once a batch is queued, so that it is transmitted without
+       * the network lock.
+       */
+
       DEBUGASSERT(dev->d_buf == NULL); /* Make sure: IOB only. */
+      upper->txpolled = 0;
       while (netdev_upper_can_tx(upper) &&
+             upper->txpolled < CONFIG_NETDEV_BATCH_PACKETS &&
              devif_poll(dev, netdev_upper_txpoll) == NETDEV_TX_CONTINUE);
     }
 }
@@ -367,129 +756,516 @@ static void eth_input(FAR struct net_driver_s *dev)
 #ifdef CONFIG_NET_ARP
   if (eth_hdr->type == HTONS(ETHTYPE_ARP))
     {
-      ninfo("ARP frame\n");
-      NETDEV_RXARP(dev);
+      ninfo("ARP frame\n");
+      NETDEV_RXARP(dev);
+
+      /* Handle ARP packet */
+
+      arp_input(dev);
+    }
+  else
+#endif
+    {
+      ninfo("INFO: Dropped, Unknown type: %04x\n", eth_hdr->type);
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+    }
+
+  /* If the above function invocation resulted in data
+   * that should be sent out on the network,
+   * the field d_len will set to a value > 0.
+   */
+
+  if (dev->d_len > 0)
+    {
+      /* And send the packet */
+
+      netdev_upper_txpoll(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Function: netdev_upper_receive
+ *
+ * Description:
+ *   Take up to 'max' received frames from the lower half.  The network is
+ *   not locked, so the stack keeps serving other devices and sockets
+ *   meanwhile.
+ *
+ * Input Parameters:
+ *   queue - Reference to the queue of the upper half driver
+ *   rxq   - Where to return the frames
+ *   max   - The number of frames at most, CONFIG_NETDEV_BATCH_PACKETS or
+ *           less
+ *
+ * Returned Value:
+ *   The number of frames returned.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_receive(FAR struct netdev_upper_queue_s *queue,
+                                FAR netpkt_t **rxq, int max)
+{
+  FAR struct netdev_lowerhalf_s *lower = queue->upper->lower;
+  int                            nrx   = 0;
+
+  nxmutex_lock(&queue->lock);
+  while (nrx < max)
+    {
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+      if (queue->upper->nqueues > 1)
+        {
+          rxq[nrx] = lower->ops->receiveq(lower, queue->index);
+        }
+      else
+#endif
+        {
+          rxq[nrx] = lower->ops->receive(lower);
+        }
+
+      if (rxq[nrx] == NULL)
+        {
+          break;
+        }
+
+      nrx++;
+    }
+
+  nxmutex_unlock(&queue->lock);
+  return nrx;
+}
+
+/****************************************************************************
+ * Function: netdev_upper_rxint
+ *
+ * Description:
+ *   Enable the RX interrupt of a queue again, if the lower half disables
+ *   it while the queue is polled.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_rxint(FAR struct netdev_upper_queue_s *queue)
+{
+  FAR struct netdev_lowerhalf_s *lower = queue->upper->lower;
+
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+  if (queue->upper->nqueues > 1)
+    {
+      if (lower->ops->rxintq != NULL)
+        {
+          nxmutex_lock(&queue->lock);
+          lower->ops->rxintq(lower, queue->index, true);
+          nxmutex_unlock(&queue->lock);
+        }
+
+      return;
+    }
+#endif
+
+  if (lower->ops->rxint != NULL)
+    {
+      nxmutex_lock(&queue->lock);
+      lower->ops->rxint(lower, true);
+      nxmutex_unlock(&queue->lock);
+    }
+}
+
+/****************************************************************************
+ * Function: netdev_upper_input
+ *
+ * Description:
+ *   Pass a received packet into the IP stack.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   pkt   - The received packet
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_input(FAR struct netdev_upperhalf_s *upper,
+                               FAR netpkt_t *pkt)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct net_driver_s       *dev   = &lower->netdev;
+
+  NETDEV_RXPACKETS(dev);
+
+  if (!IFF_IS_UP(dev->d_flags))
+    {
+      /* Interface down, drop frame */
+
+      NETDEV_RXDROPPED(dev);
+      netpkt_free(lower, pkt, NETPKT_RX);
+      return;
+    }
+
+  netpkt_put(dev, pkt, NETPKT_RX);
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#endif
+
+  switch (dev->d_lltype)
+    {
+#ifdef CONFIG_NET_LOOPBACK
+    case NET_LL_LOOPBACK:
+#endif
+#ifdef CONFIG_NET_ETHERNET
+    case NET_LL_ETHERNET:
+#endif
+#ifdef CONFIG_DRIVERS_IEEE80211
+    case NET_LL_IEEE80211:
+#endif
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+      eth_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_CAN
+    case NET_LL_CAN:
+      ninfo("CAN frame");
+      can_input(dev);
+      break;
+#endif
+    default:
+      nerr("Unknown link type %d\n", dev->d_lltype);
+      break;
+    }
+}
+
+/****************************************************************************
+ * Function: netdev_upper_gro_parse
+ *
+ * Description:
+ *   Check if a received frame is a TCP data segment that may be merged,
+ *   and locate its headers.  Only IP packets without options or extension
+ *   headers, which are not fragmented, are taken.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+static bool netdev_upper_gro_parse(FAR struct net_driver_s *dev,
+                                   FAR netpkt_t *pkt,
+                                   FAR struct netdev_upper_gro_s *seg)
+{
+  FAR struct eth_hdr_s *eth;
+  unsigned int totlen;
+
+  if (dev->d_lltype != NET_LL_ETHERNET)
+    {
+      return false;
+    }
+
+  eth     = (FAR struct eth_hdr_s *)(IOB_DATA(pkt) - ETH_HDRLEN);
+  seg->ip = IOB_DATA(pkt);
+
+#ifdef CONFIG_NET_IPv4
+  if (eth->type == HTONS(ETHTYPE_IP))
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)seg->ip;
+
+      if (pkt->io_len < IPv4_HDRLEN + TCP_HDRLEN || ipv4->vhl != 0x45 ||
+          ipv4->proto != IP_PROTO_TCP ||
+          (ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0)
+        {
+          return false;
+        }
+
+      seg->iplen = IPv4_HDRLEN;
+      totlen     = ((uint16_t)ipv4->len[0] << 8) + ipv4->len[1];
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (eth->type == HTONS(ETHTYPE_IP6))
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)seg->ip;
+
+      if (pkt->io_len < IPv6_HDRLEN + TCP_HDRLEN ||
+          ipv6->proto != IP_PROTO_TCP)
+        {
+          return false;
+        }
+
+      seg->iplen = IPv6_HDRLEN;
+      totlen     = IPv6_HDRLEN + ((uint16_t)ipv6->len[0] << 8) +
+                   ipv6->len[1];
+    }
+  else
+#endif
+    {
+      return false;
+    }
+
+  /* Only ACK, and PSH that ends the merge, are allowed.  The frame must
+   * not be padded, which rules out the short ones.
+   */
+
+  seg->tcp    = (FAR struct tcp_hdr_s *)(seg->ip + seg->iplen);
+  seg->hdrlen = seg->iplen + ((seg->tcp->tcpoffset >> 4) << 2);
+
+  if ((seg->tcp->flags & TCP_CTL & ~TCP_PSH) != TCP_ACK ||
+      seg->hdrlen < seg->iplen + TCP_HDRLEN || seg->hdrlen > pkt->io_len ||
+      totlen != pkt->io_pktlen || totlen <= seg->hdrlen)
+    {
+      return false;
+    }
+
+  seg->datalen = totlen - seg->hdrlen;
+  seg->seqno   = ((uint32_t)seg->tcp->seqno[0] << 24) |
+                 ((uint32_t)seg->tcp->seqno[1] << 16) |
+                 ((uint32_t)seg->tcp->seqno[2] << 8) |
+                 (uint32_t)seg->tcp->seqno[3];
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Function: netdev_upper_gro_merge
+ *
+ * Description:
+ *   Append the payload of 'pkt' to 'head' if it is the next segment of the
+ *   same flow, and fix up the headers of 'head'.
+ *
+ * Returned Value:
+ *   True if 'pkt' was merged and no longer exists.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+static bool netdev_upper_gro_merge(FAR struct netdev_upperhalf_s *upper,
+                                   FAR netpkt_t *head,
+                                   FAR struct netdev_upper_gro_s *hseg,
+                                   FAR netpkt_t *pkt,
+                                   FAR struct netdev_upper_gro_s *seg)
+{
+  unsigned int totlen = hseg->hdrlen + hseg->datalen + seg->datalen;
+  unsigned int iplen = totlen;
+
+  /* Same flow: the addresses, with the IPv4 TOS or the IPv6 traffic class
+   * and flow label, the ports, the acknowledgment and the options.
+   */
+
+  if (hseg->iplen != seg->iplen || hseg->hdrlen != seg->hdrlen ||
+      (hseg->tcp->flags & TCP_PSH) != 0 ||
+      seg->seqno != hseg->seqno + hseg->datalen)
+    {
+      return false;
+    }
 
-      /* Handle ARP packet */
+  /* The IPv6 length field excludes the IPv6 header */
 
-      arp_input(dev);
+#ifdef CONFIG_NET_IPv6
+  if (hseg->iplen == IPv6_HDRLEN)
+    {
+      iplen -= IPv6_HDRLEN;
     }
-  else
 #endif
+
+  if (iplen > UINT16_MAX)
     {
-      ninfo("INFO: Dropped, Unknown type: %04x\n", eth_hdr->type);
-      NETDEV_RXDROPPED(dev);
-      dev->d_len = 0;
+      return false;
     }
 
-  /* If the above function invocation resulted in data
-   * that should be sent out on the network,
-   * the field d_len will set to a value > 0.
-   */
+  if (hseg->iplen == IPv4_HDRLEN)
+    {
+      if (hseg->ip[1] != seg->ip[1] ||
+          memcmp(hseg->ip + 12, seg->ip + 12, 8) != 0)
+        {
+          return false;
+        }
+    }
+  else if (memcmp(hseg->ip, seg->ip, 4) != 0 ||
+           memcmp(hseg->ip + 8, seg->ip + 8, 32) != 0)
+    {
+      return false;
+    }
 
-  if (dev->d_len > 0)
+  if (memcmp(&hseg->tcp->srcport, &seg->tcp->srcport, 4) != 0 ||
+      memcmp(hseg->tcp->ackno, seg->tcp->ackno, 4) != 0 ||
+      memcmp(hseg->tcp->optdata, seg->tcp->optdata,
+             hseg->hdrlen - hseg->iplen - TCP_HDRLEN) != 0)
     {
-      /* And send the packet */
+      return false;
+    }
 
-      netdev_upper_txpoll(dev);
+  /* Take the window and PSH of the newer segment */
+
+  hseg->tcp->flags  |= seg->tcp->flags;
+  hseg->tcp->wnd[0]  = seg->tcp->wnd[0];
+  hseg->tcp->wnd[1]  = seg->tcp->wnd[1];
+  hseg->datalen     += seg->datalen;
+
+#ifdef CONFIG_NET_IPv4
+  if (hseg->iplen == IPv4_HDRLEN)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)hseg->ip;
+
+      ipv4->len[0]   = iplen >> 8;
+      ipv4->len[1]   = iplen & 0xff;
+      ipv4->ipchksum = 0;
+      ipv4->ipchksum = ~ipv4_chksum(ipv4);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (hseg->iplen == IPv6_HDRLEN)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)hseg->ip;
+
+      ipv6->len[0] = iplen >> 8;
+      ipv6->len[1] = iplen & 0xff;
     }
+#endif
+
+  /* The merged frame no longer holds a driver buffer of its own */
+
+  iob_concat(head, iob_trimhead(pkt, seg->hdrlen));
+  quota_fetch_inc(upper->lower, NETPKT_RX);
+  return true;
 }
 #endif
 
 /****************************************************************************
- * Function: netdev_upper_rxpoll_work
+ * Function: netdev_upper_gro
  *
  * Description:
- *   Try to receive packets from device and pass packets into IP
- *   stack and send packets which is from IP stack if necessary.
+ *   Merge the consecutive segments of each TCP flow in a batch of received
+ *   frames, so that the stack processes and acknowledges them as one.  Only
+ *   done on devices that verify the checksums, since the checksum of a
+ *   merged segment is not recomputed.
  *
- * Input Parameters:
- *   upper - Reference to the upper half driver structure
- *
- * Assumptions:
- *   Called with the network locked.
+ * Returned Value:
+ *   The number of frames left in the batch.
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+#ifdef CONFIG_NETDEV_GRO
+static int netdev_upper_gro(FAR struct netdev_upperhalf_s *upper,
+                            FAR netpkt_t **rxq, int nrx)
 {
-  FAR struct netdev_lowerhalf_s *lower = upper->lower;
-  FAR struct net_driver_s       *dev   = &lower->netdev;
-  FAR netpkt_t                  *pkt;
-
-  /* Loop while receive() successfully retrieves valid Ethernet frames. */
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+  struct netdev_upper_gro_s hseg;
+  struct netdev_upper_gro_s seg;
+  bool hvalid;
+  int n = 0;
+  int i;
 
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  if (nrx < 2 || !NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_RXCSUM))
     {
-      NETDEV_RXPACKETS(dev);
+      return nrx;
+    }
 
-      if (!IFF_IS_UP(dev->d_flags))
+  hvalid = netdev_upper_gro_parse(dev, rxq[0], &hseg);
+  for (i = 1; i < nrx; i++)
+    {
+      if (netdev_upper_gro_parse(dev, rxq[i], &seg))
         {
-          /* Interface down, drop frame */
-
-          NETDEV_RXDROPPED(dev);
-          netpkt_free(lower, pkt, NETPKT_RX);
-          continue;
+          if (hvalid &&
+              netdev_upper_gro_merge(upper, rxq[n], &hseg, rxq[i], &seg))
+            {
+              continue;
+            }
+
+          hseg   = seg;
+          hvalid = true;
         }
-
-      netpkt_put(dev, pkt, NETPKT_RX);
-
-#ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
-
-      pkt_input(dev);
-#endif
-
-      switch (dev->d_lltype)
+      else
         {
-#ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
-#endif
-#ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
-#endif
-#ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
-#endif
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
-#endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
+          hvalid = false;
         }
+
+      rxq[++n] = rxq[i];
     }
+
+  return n + 1;
 }
+#else
+#  define netdev_upper_gro(upper, rxq, nrx) (nrx)
+#endif
 
 /****************************************************************************
- * Name: netdev_upper_txavail_work
+ * Name: netdev_upper_work
  *
  * Description:
- *   Perform an out-of-cycle poll on a dedicated thread or the worker thread.
+ *   Perform an out-of-cycle poll of a queue on a dedicated thread or the
+ *   worker thread.  The network is only locked while the stack processes a
+ *   batch of frames; the lower half is called under the lock of this queue
+ *   alone.
+ *
+ *   At most CONFIG_NETDEV_RX_BUDGET frames are received per run.  Once the
+ *   lower half has no more frames, its RX interrupt is enabled again.  If
+ *   the budget is used up first, the interrupt is left disabled and the
+ *   work is queued again behind the work that became pending meanwhile, so
+ *   a flood of frames can not starve the rest of the system.
  *
  * Input Parameters:
- *   arg - Reference to the upper half driver structure (cast to void *)
+ *   arg - Reference to the queue of the upper half (cast to void *)
  *
  ****************************************************************************/
 
 static void netdev_upper_work(FAR void *arg)
 {
-  FAR struct netdev_upperhalf_s *upper = arg;
+  FAR struct netdev_upper_queue_s *queue = arg;
+  FAR struct netdev_upperhalf_s *upper = queue->upper;
+  FAR netpkt_t *rxq[CONFIG_NETDEV_BATCH_PACKETS];
+  int budget = CONFIG_NETDEV_RX_BUDGET;
+  bool drained;
+  int max;
+  int nrx;
+  int i;
+
+  NETDEV_RXPOLLS(&upper->lower->netdev);
+
+  do
+    {
+      max     = MIN(budget, CONFIG_NETDEV_BATCH_PACKETS);
+      nrx     = netdev_upper_receive(queue, rxq, max);
+      drained = nrx < max;
+      budget -= nrx;
+      nrx     = netdev_upper_gro(upper, rxq, nrx);
+
+      /* RX may release quota and driver buffer, so do RX first. */
+
+      net_lock();
+      for (i = 0; i < nrx; i++)
+        {
+          netdev_upper_input(upper, rxq[i]);
+        }
+
+      netdev_upper_txavail_work(upper);
+      net_unlock();
+
+      /* Now transmit what the stack queued, replies included.  The frames
+       * were spread over the TX queues by flow, flush all of them.
+       */
+
+      for (i = 0; i < upper->nqueues; i++)
+        {
+          nxmutex_lock(&upper->queue[i].lock);
+          netdev_upper_txflush(&upper->queue[i]);
+          nxmutex_unlock(&upper->queue[i].lock);
+        }
+    }
+  while (!drained && budget > 0);
 
-  /* RX may release quota and driver buffer, so do RX first. */
+  if (drained)
+    {
+      netdev_upper_rxint(queue);
+    }
+  else
+    {
+      /* Out of budget, the RX interrupt stays disabled until we are back */
 
-  net_lock();
-  netdev_upper_rxpoll_work(upper);
-  netdev_upper_txavail_work(upper);
-  net_unlock();
+      NETDEV_RXEXHAUSTED(&upper->lower->netdev);
+      netdev_upper_queue_work(queue);
+    }
 }
 
 /****************************************************************************
@@ -503,16 +1279,18 @@ static void netdev_upper_work(FAR void *arg)
 #ifdef CONFIG_NETDEV_WORK_THREAD
 static int netdev_upper_loop(int argc, FAR char *argv[])
 {
-  FAR struct netdev_upperhalf_s *upper =
-    (FAR struct netdev_upperhalf_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+  FAR struct netdev_upper_queue_s *queue;
+
+  queue = (FAR struct netdev_upper_queue_s *)
+          ((uintptr_t)strtoul(argv[1], NULL, 16));
 
-  while (nxsem_wait(&upper->sem) == OK && upper->tid != INVALID_PROCESS_ID)
+  while (nxsem_wait(&queue->sem) == OK && queue->tid != INVALID_PROCESS_ID)
     {
-      netdev_upper_work(upper);
+      netdev_upper_work(queue);
     }
 
   nwarn("WARNING: Netdev work thread quitting.");
-  nxsem_post(&upper->sem_exit);
+  nxsem_post(&queue->sem_exit);
   return 0;
 }
 #endif
@@ -521,33 +1299,51 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
  * Name: netdev_upper_queue_work
  *
  * Description:
- *   Called when there is any work to do.
+ *   Called when there is any work to do on a queue.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
+ *   queue - Reference to the queue of the upper half
  *
  ****************************************************************************/
 
-static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
+static inline void
+netdev_upper_queue_work(FAR struct netdev_upper_queue_s *queue)
 {
-  FAR struct netdev_upperhalf_s *upper = dev->d_private;
-
 #ifdef CONFIG_NETDEV_WORK_THREAD
   int semcount;
-  if (nxsem_get_value(&upper->sem, &semcount) == OK && semcount <= 0)
+  if (nxsem_get_value(&queue->sem, &semcount) == OK && semcount <= 0)
     {
-      nxsem_post(&upper->sem);
+      nxsem_post(&queue->sem);
     }
 #else
-  if (work_available(&upper->work))
+  if (work_available(&queue->work))
     {
       /* Schedule to serialize the poll on the worker thread. */
 
-      work_queue(NETDEV_WORK, &upper->work, netdev_upper_work, upper, 0);
+      work_queue(NETDEV_WORK, &queue->work, netdev_upper_work, queue, 0);
     }
 #endif
 }
 
+/****************************************************************************
+ * Name: netdev_upper_this_queue
+ *
+ * Description:
+ *   Return the queue that belongs to the calling CPU.  The stack is polled
+ *   for TX by the worker of this queue.
+ *
+ ****************************************************************************/
+
+static inline FAR struct netdev_upper_queue_s *
+netdev_upper_this_queue(FAR struct netdev_upperhalf_s *upper)
+{
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+  return &upper->queue[up_cpu_index() % upper->nqueues];
+#else
+  return &upper->queue[0];
+#endif
+}
+
 /****************************************************************************
  * Name: netdev_upper_txavail
  *
@@ -561,7 +1357,7 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
 
 static int netdev_upper_txavail(FAR struct net_driver_s *dev)
 {
-  netdev_upper_queue_work(dev);
+  netdev_upper_queue_work(netdev_upper_this_queue(dev->d_private));
   return OK;
 }
 
@@ -819,34 +1615,66 @@ int netdev_upper_wireless_ioctl(FAR struct netdev_lowerhalf_s *lower,
 static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
 
 #ifdef CONFIG_NETDEV_WORK_THREAD
-  /* Try to bring up a dedicated thread for work. */
+  FAR struct netdev_upper_queue_s *queue;
+  int i;
 
-  if (upper->tid <= 0)
+  /* Try to bring up a dedicated thread for the work of each queue.  With
+   * several queues, the thread of a queue runs on a CPU of its own.
+   */
+
+  for (i = 0; i < upper->nqueues; i++)
     {
       FAR char *argv[2];
       char      arg1[32];
       char      name[32];
 
-      snprintf(arg1, sizeof(arg1), "%p", upper);
+      queue = &upper->queue[i];
+      if (queue->tid > 0)
+        {
+          continue;
+        }
+
+      snprintf(arg1, sizeof(arg1), "%p", queue);
       snprintf(name, sizeof(name), NETDEV_THREAD_NAME_FMT, dev->d_ifname);
+      if (i > 0)
+        {
+          snprintf(name + strlen(name), sizeof(name) - strlen(name),
+                   "-%d", i);
+        }
+
       argv[0] = arg1;
       argv[1] = NULL;
 
-      upper->tid = kthread_create(name, CONFIG_NETDEV_WORK_THREAD_PRIORITY,
+      queue->tid = kthread_create(name, CONFIG_NETDEV_WORK_THREAD_PRIORITY,
                                   CONFIG_DEFAULT_TASK_STACKSIZE,
                                   netdev_upper_loop, argv);
-      if (upper->tid < 0)
+      if (queue->tid < 0)
+        {
+          return queue->tid;
+        }
+
+#ifdef CONFIG_SMP
+      if (upper->nqueues > 1)
         {
-          return upper->tid;
+          cpu_set_t cpuset;
+
+          CPU_ZERO(&cpuset);
+          CPU_SET(i % CONFIG_SMP_NCPUS, &cpuset);
+          nxsched_set_affinity(queue->tid, sizeof(cpuset), &cpuset);
         }
+#endif
     }
 #endif
 
   if (upper->lower->ops->ifup)
     {
-      return upper->lower->ops->ifup(upper->lower);
+      netdev_upper_lock(upper);
+      ret = upper->lower->ops->ifup(upper->lower);
+      netdev_upper_unlock(upper);
+      return ret;
     }
 
   return -ENOSYS;
@@ -855,14 +1683,23 @@ static int netdev_upper_ifup(FAR struct net_driver_s *dev)
 static int netdev_upper_ifdown(FAR struct net_driver_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
 
 #ifndef CONFIG_NETDEV_WORK_THREAD
-  work_cancel(NETDEV_WORK, &upper->work);
+  int i;
+
+  for (i = 0; i < upper->nqueues; i++)
+    {
+      work_cancel(NETDEV_WORK, &upper->queue[i].work);
+    }
 #endif
 
   if (upper->lower->ops->ifdown)
     {
-      return upper->lower->ops->ifdown(upper->lower);
+      netdev_upper_lock(upper);
+      ret = upper->lower->ops->ifdown(upper->lower);
+      netdev_upper_unlock(upper);
+      return ret;
     }
 
   return -ENOSYS;
@@ -873,10 +1710,14 @@ static int netdev_upper_addmac(FAR struct net_driver_s *dev,
                                FAR const uint8_t *mac)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
 
   if (upper->lower->ops->addmac)
     {
-      return upper->lower->ops->addmac(upper->lower, mac);
+      netdev_upper_lock(upper);
+      ret = upper->lower->ops->addmac(upper->lower, mac);
+      netdev_upper_unlock(upper);
+      return ret;
     }
 
   return -ENOSYS;
@@ -888,10 +1729,14 @@ static int netdev_upper_rmmac(FAR struct net_driver_s *dev,
                               FAR const uint8_t *mac)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int ret;
 
   if (upper->lower->ops->rmmac)
     {
-      return upper->lower->ops->rmmac(upper->lower, mac);
+      netdev_upper_lock(upper);
+      ret = upper->lower->ops->rmmac(upper->lower, mac);
+      netdev_upper_unlock(upper);
+      return ret;
     }
 
   return -ENOSYS;
@@ -904,24 +1749,24 @@ static int netdev_upper_ioctl(FAR struct net_driver_s *dev, int cmd,
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  int ret = -ENOTTY;
+
+  netdev_upper_lock(upper);
 
 #ifdef CONFIG_NETDEV_WIRELESS_HANDLER
   if (lower->iw_ops)
     {
-      int ret = netdev_upper_wireless_ioctl(lower, cmd, arg);
-      if (ret != -ENOTTY)
-        {
-          return ret;
-        }
+      ret = netdev_upper_wireless_ioctl(lower, cmd, arg);
     }
 #endif
 
-  if (lower->ops->ioctl)
+  if (ret == -ENOTTY && lower->ops->ioctl)
     {
-      return lower->ops->ioctl(lower, cmd, arg);
+      ret = lower->ops->ioctl(lower, cmd, arg);
     }
 
-  return -ENOTTY;
+  netdev_upper_unlock(upper);
+  return ret;
 }
 #endif
 
@@ -958,6 +1803,28 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
       return -EINVAL;
     }
 
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+  if (dev->nqueues > 1 &&
+      (dev->ops->transmitq == NULL || dev->ops->receiveq == NULL))
+    {
+      return -EINVAL;
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* TSO needs transmit_tso, or transmitq_tso with several queues */
+
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+  if (dev->nqueues > 1 ? dev->ops->transmitq_tso == NULL :
+                         dev->ops->transmit_tso == NULL)
+#else
+  if (dev->ops->transmit_tso == NULL)
+#endif
+    {
+      dev->netdev.d_features &= ~NETDEV_FEATURE_TSO;
+    }
+#endif
+
   if ((upper = netdev_upper_alloc(dev)) == NULL)
     {
       return -ENOMEM;
@@ -969,6 +1836,9 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
   dev->netdev.d_ifup    = netdev_upper_ifup;
   dev->netdev.d_ifdown  = netdev_upper_ifdown;
   dev->netdev.d_txavail = netdev_upper_txavail;
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+  dev->netdev.d_xmit    = netdev_upper_xmit;
+#endif
 #ifdef CONFIG_NET_MCASTGROUP
   dev->netdev.d_addmac  = netdev_upper_addmac;
   dev->netdev.d_rmmac   = netdev_upper_rmmac;
@@ -981,15 +1851,9 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
   ret = netdev_register(&dev->netdev, lltype);
   if (ret < 0)
     {
-      kmm_free(upper);
-      dev->netdev.d_private = NULL;
+      netdev_upper_free(upper);
     }
 
-#ifdef CONFIG_NETDEV_WORK_THREAD
-  nxsem_init(&upper->sem, 0, 0);
-  nxsem_init(&upper->sem_exit, 0, 0);
-#endif
-
   return ret;
 }
 
@@ -1011,6 +1875,9 @@ int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct netdev_upperhalf_s *upper;
   int ret;
+#ifdef CONFIG_NETDEV_WORK_THREAD
+  int i;
+#endif
 
   if (dev == NULL || dev->netdev.d_private == NULL)
     {
@@ -1025,22 +1892,22 @@ int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
     }
 
 #ifdef CONFIG_NETDEV_WORK_THREAD
-  if (upper->tid > 0)
+  for (i = 0; i < upper->nqueues; i++)
     {
-      /* Try to tear down the dedicated thread for work. */
+      FAR struct netdev_upper_queue_s *queue = &upper->queue[i];
 
-      upper->tid = INVALID_PROCESS_ID;
-      nxsem_post(&upper->sem);
-      nxsem_wait(&upper->sem_exit);
-    }
+      if (queue->tid > 0)
+        {
+          /* Try to tear down the dedicated thread for work. */
 
-  nxsem_destroy(&upper->sem);
-  nxsem_destroy(&upper->sem_exit);
+          queue->tid = INVALID_PROCESS_ID;
+          nxsem_post(&queue->sem);
+          nxsem_wait(&queue->sem_exit);
+        }
+    }
 #endif
 
-  kmm_free(upper);
-  dev->netdev.d_private = NULL;
-
+  netdev_upper_free(upper);
   return OK;
 }
 
@@ -1097,7 +1964,13 @@ int netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev)
 
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 {
-  netdev_upper_queue_work(&dev->netdev);
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+  int i;
+
+  for (i = 0; i < upper->nqueues; i++)
+    {
+      netdev_upper_queue_work(&upper->queue[i]);
+    }
 }
 
 /****************************************************************************
@@ -1114,8 +1987,54 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev)
 {
   NETDEV_TXDONE(&dev->netdev);
-  netdev_upper_queue_work(&dev->netdev);
+  netdev_upper_queue_work(netdev_upper_this_queue(dev->netdev.d_private));
+}
+
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read on
+ *   one queue.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The index of the queue
+ *
+ ****************************************************************************/
+
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+
+  DEBUGASSERT(queue >= 0 && queue < upper->nqueues);
+  netdev_upper_queue_work(&upper->queue[queue]);
+}
+
+/****************************************************************************
+ * Name: netdev_lower_txdone_queue
+ *
+ * Description:
+ *   Notifies the networking layer about a TX packet is sent on one queue.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The index of the queue
+ *
+ ****************************************************************************/
+
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev,
+                               int queue)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->netdev.d_private;
+
+  DEBUGASSERT(queue >= 0 && queue < upper->nqueues);
+  NETDEV_TXDONE(&dev->netdev);
+  netdev_upper_queue_work(&upper->queue[queue]);
 }
+#endif
 
 /****************************************************************************
  * Name: netdev_lower_quota_load
@@ -1179,6 +2098,57 @@ FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
   return pkt;
 }
 
+/****************************************************************************
+ * Name: netpkt_alloc_extbuf
+ *
+ * Description:
+ *   Wrap a frame that the hardware placed in an external buffer in a
+ *   netpkt without copying.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   type   - Whether used for TX or RX
+ *   ext    - The external buffer holding the frame
+ *   offset - The offset of the frame in the buffer
+ *   len    - The length of the frame, including the link layer header
+ *
+ * Returned Value:
+ *   Pointer to the packet, NULL on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_EXTBUF
+FAR netpkt_t *netpkt_alloc_extbuf(FAR struct netdev_lowerhalf_s *dev,
+                                  enum netpkt_type_e type,
+                                  FAR struct iob_extbuf_s *ext,
+                                  uint16_t offset, uint16_t len)
+{
+  uint8_t llhdrlen = NET_LL_HDRLEN(&dev->netdev);
+  FAR netpkt_t *pkt;
+
+  if (len < llhdrlen)
+    {
+      return NULL;
+    }
+
+  if (quota_fetch_dec(dev, type) <= 0)
+    {
+      quota_fetch_inc(dev, type);
+      return NULL;
+    }
+
+  /* The link layer header is in front of IOB_DATA() as usual */
+
+  pkt = iob_tryalloc_extbuf(false, ext, offset + llhdrlen, len - llhdrlen);
+  if (pkt == NULL)
+    {
+      quota_fetch_inc(dev, type);
+    }
+
+  return pkt;
+}
+#endif
+
 /****************************************************************************
  * Name: netpkt_free
  *
@@ -1199,6 +2169,41 @@ void netpkt_free(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
   iob_free_chain(pkt);
 }
 
+/****************************************************************************
+ * Name: netpkt_concat
+ *
+ * Description:
+ *   Append a buffer received as part of a frame to the netpkt holding the
+ *   start of the frame, for devices that spread a frame over several
+ *   receive buffers.  'next' has a single buffer, whose 'len' bytes of
+ *   data start at 'data'.  It no longer counts as a buffer held by the
+ *   driver.
+ *
+ * Input Parameters:
+ *   dev  - The lower half device driver structure
+ *   pkt  - The packet holding the start of the frame
+ *   next - The packet to append
+ *   data - The start of the data in the buffer of 'next'
+ *   len  - The length of the data
+ *   type - Whether used for TX or RX
+ *
+ ****************************************************************************/
+
+void netpkt_concat(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                   FAR netpkt_t *next, FAR uint8_t *data, unsigned int len,
+                   enum netpkt_type_e type)
+{
+  DEBUGASSERT(next->io_flink == NULL && data >= next->io_data &&
+              data - next->io_data + len <= IOB_BUFSIZE(next));
+
+  next->io_offset = data - next->io_data;
+  next->io_len    = len;
+  next->io_pktlen = len;
+  iob_concat(pkt, next);
+
+  quota_fetch_inc(dev, type);
+}
+
 /****************************************************************************
  * Name: netpkt_copyin
  *
@@ -45,7 +45,8 @@
 
 #if defined(CONFIG_DRIVERS_NOTERAM) +  defined(CONFIG_DRIVERS_NOTELOG) + \
     defined(CONFIG_DRIVERS_NOTESNAP) + defined(CONFIG_DRIVERS_NOTERTT) + \
-    defined(CONFIG_SEGGER_SYSVIEW) > CONFIG_DRIVERS_NOTE_MAX
+    defined(CONFIG_SEGGER_SYSVIEW) + defined(CONFIG_DRIVERS_NOTECTF) > \
+    CONFIG_DRIVERS_NOTE_MAX
 #  error "Maximum channel number exceeds. "
 #endif
 
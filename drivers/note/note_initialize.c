@@ -27,6 +27,7 @@
 #include <nuttx/note/note_driver.h>
 #include <nuttx/note/noteram_driver.h>
 #include <nuttx/note/notectl_driver.h>
+#include <nuttx/note/notectf_driver.h>
 #include <nuttx/note/notesnap_driver.h>
 #include <nuttx/segger/note_rtt.h>
 #include <nuttx/segger/sysview.h>
@@ -81,6 +82,15 @@ int note_initialize(void)
     }
 #endif
 
+#ifdef CONFIG_DRIVERS_NOTECTF
+  ret = notectf_register();
+  if (ret < 0)
+    {
+      serr("notectf_register failed %d\n", ret);
+      return ret;
+    }
+#endif
+
 #ifdef CONFIG_SEGGER_SYSVIEW
   ret = note_sysview_initialize();
   if (ret < 0)
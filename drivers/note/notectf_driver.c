@@ -0,0 +1,670 @@
+/****************************************************************************
+ * drivers/note/notectf_driver.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/note/note_driver.h>
+#include <nuttx/note/notectf_driver.h>
+
+#ifdef CONFIG_DRIVERS_NOTECTF_RTT
+#  include <nuttx/segger/rtt.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CTF_MAGIC              0xc1fc1fc1
+
+/* Size of the packet header and context, see the metadata below */
+
+#define CTF_PACKET_HDRSIZE     44
+
+/* Size of the event header and context plus the largest expansion of a
+ * note payload when it is re-encoded without padding.
+ */
+
+#define CTF_EVENT_OVERHEAD     (15 + 2 * sizeof(uintptr_t))
+
+#if UINTPTR_MAX > UINT32_MAX
+#  define CTF_PTR_BITS         "64"
+#else
+#  define CTF_PTR_BITS         "32"
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct notectf_s
+{
+  struct note_driver_s driver;
+  FAR struct lib_outstream_s *stream;  /* The transport */
+  spinlock_t lock;                     /* Protects the fields below */
+  uint32_t discarded;                  /* Notes that did not fit */
+  uint64_t begin;                      /* Time of the first event (ns) */
+  uint64_t end;                        /* Time of the last event (ns) */
+  clock_t flushed;                     /* Tick of the last flush */
+  size_t len;                          /* Bytes used in packet */
+  uint8_t packet[CONFIG_DRIVERS_NOTECTF_PACKETSIZE];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void notectf_add(FAR struct note_driver_s *drv,
+                        FAR const void *note, size_t notelen);
+static ssize_t notectf_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct note_driver_ops_s g_notectf_ops =
+{
+  notectf_add
+};
+
+static struct notectf_s g_notectf =
+{
+  {
+    &g_notectf_ops
+  }
+};
+
+#ifdef CONFIG_DRIVERS_NOTECTF_RTT
+static struct lib_rttoutstream_s g_notectf_rtt;
+#endif
+
+static const struct file_operations g_notectf_fops =
+{
+  NULL,          /* open */
+  NULL,          /* close */
+  notectf_read,  /* read */
+};
+
+/* The CTF 1.8 metadata describing the data stream.  Event IDs are the
+ * note types, so only the notes enabled in this configuration appear.
+ * All fields are byte aligned and little endian, matching the flattened
+ * notes.
+ */
+
+static const char g_notectf_metadata[] =
+  "/* CTF 1.8 */\n"
+  "typealias integer { size = 8; align = 8; signed = false; } := uint8_t;\n"
+  "typealias integer { size = 16; align = 8; signed = false; } := "
+  "uint16_t;\n"
+  "typealias integer { size = 32; align = 8; signed = false; } := "
+  "uint32_t;\n"
+  "typealias integer { size = 32; align = 8; signed = true; } := int32_t;\n"
+  "typealias integer { size = 64; align = 8; signed = false; } := "
+  "uint64_t;\n"
+  "typealias integer { size = " CTF_PTR_BITS "; align = 8; signed = false; "
+  "base = hex; } := ptr_t;\n"
+  "trace {\n"
+  "  major = 1;\n"
+  "  minor = 8;\n"
+  "  byte_order = le;\n"
+  "  packet.header := struct { uint32_t magic; uint32_t stream_id; };\n"
+  "};\n"
+  "env { domain = \"kernel\"; sysname = \"NuttX\"; };\n"
+  "clock { name = monotonic; freq = 1000000000; };\n"
+  "typealias integer { size = 64; align = 8; signed = false; "
+  "map = clock.monotonic.value; } := clock_ns_t;\n"
+  "stream {\n"
+  "  id = 0;\n"
+  "  packet.context := struct {\n"
+  "    clock_ns_t timestamp_begin;\n"
+  "    clock_ns_t timestamp_end;\n"
+  "    uint64_t content_size;\n"
+  "    uint64_t packet_size;\n"
+  "    uint32_t events_discarded;\n"
+  "  };\n"
+  "  event.header := struct { uint8_t id; clock_ns_t timestamp; };\n"
+  "  event.context := struct { uint8_t cpu; int32_t pid; "
+  "uint8_t priority; };\n"
+  "};\n"
+  "event { name = \"task_start\"; id = 0; stream_id = 0; "
+  "fields := struct { string name; }; };\n"
+  "event { name = \"task_stop\"; id = 1; stream_id = 0; "
+  "fields := struct { }; };\n"
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SWITCH
+  "event { name = \"sched_suspend\"; id = 2; stream_id = 0; "
+  "fields := struct { uint8_t state; }; };\n"
+  "event { name = \"sched_resume\"; id = 3; stream_id = 0; "
+  "fields := struct { }; };\n"
+#endif
+#ifdef CONFIG_SMP
+  "event { name = \"cpu_start\"; id = 4; stream_id = 0; "
+  "fields := struct { uint8_t target; }; };\n"
+  "event { name = \"cpu_started\"; id = 5; stream_id = 0; "
+  "fields := struct { }; };\n"
+#  ifdef CONFIG_SCHED_INSTRUMENTATION_SWITCH
+  "event { name = \"cpu_pause\"; id = 6; stream_id = 0; "
+  "fields := struct { uint8_t target; }; };\n"
+  "event { name = \"cpu_paused\"; id = 7; stream_id = 0; "
+  "fields := struct { }; };\n"
+  "event { name = \"cpu_resume\"; id = 8; stream_id = 0; "
+  "fields := struct { uint8_t target; }; };\n"
+  "event { name = \"cpu_resumed\"; id = 9; stream_id = 0; "
+  "fields := struct { }; };\n"
+#  endif
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_PREEMPTION
+  "event { name = \"preempt_lock\"; id = 10; stream_id = 0; "
+  "fields := struct { uint16_t count; }; };\n"
+  "event { name = \"preempt_unlock\"; id = 11; stream_id = 0; "
+  "fields := struct { uint16_t count; }; };\n"
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
+  "event { name = \"csection_enter\"; id = 12; stream_id = 0; "
+  "fields := struct { uint16_t count; }; };\n"
+  "event { name = \"csection_leave\"; id = 13; stream_id = 0; "
+  "fields := struct { uint16_t count; }; };\n"
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  "event { name = \"spinlock_lock\"; id = 14; stream_id = 0; "
+  "fields := struct { ptr_t lock; uint8_t value; }; };\n"
+  "event { name = \"spinlock_locked\"; id = 15; stream_id = 0; "
+  "fields := struct { ptr_t lock; uint8_t value; }; };\n"
+  "event { name = \"spinlock_unlock\"; id = 16; stream_id = 0; "
+  "fields := struct { ptr_t lock; uint8_t value; }; };\n"
+  "event { name = \"spinlock_abort\"; id = 17; stream_id = 0; "
+  "fields := struct { ptr_t lock; uint8_t value; }; };\n"
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SYSCALL
+  "event { name = \"syscall_enter\"; id = 18; stream_id = 0; "
+  "fields := struct { uint8_t nr; uint8_t argc; ptr_t args[argc]; }; };\n"
+  "event { name = \"syscall_leave\"; id = 19; stream_id = 0; "
+  "fields := struct { uint8_t nr; ptr_t result; }; };\n"
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
+  "event { name = \"irq_enter\"; id = 20; stream_id = 0; "
+  "fields := struct { uint8_t irq; ptr_t handler; }; };\n"
+  "event { name = \"irq_leave\"; id = 21; stream_id = 0; "
+  "fields := struct { uint8_t irq; ptr_t handler; }; };\n"
+#endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+  "/* The string carries sched_note_beginex/endex/mark/counter markers in\n"
+  " * the atrace format B|pid|name, E|pid|name, I|pid|name, C|pid|name|val\n"
+  " */\n"
+  "event { name = \"dump_string\"; id = 22; stream_id = 0; "
+  "fields := struct { ptr_t ip; string data; }; };\n"
+  "event { name = \"dump_binary\"; id = 23; stream_id = 0; "
+  "fields := struct { ptr_t ip; uint8_t event; uint8_t len; "
+  "uint8_t data[len]; }; };\n"
+#endif
+  ;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notectf_get / notectf_put
+ *
+ * Description:
+ *   Decode a little endian field of a note and append a little endian
+ *   field to the packet.
+ *
+ ****************************************************************************/
+
+static uint64_t notectf_get(FAR const uint8_t *src, size_t len)
+{
+  uint64_t value = 0;
+
+  while (len-- > 0)
+    {
+      value = (value << 8) | src[len];
+    }
+
+  return value;
+}
+
+static void notectf_put(FAR struct notectf_s *ctf, uint64_t value,
+                        size_t len)
+{
+  while (len-- > 0)
+    {
+      ctf->packet[ctf->len++] = (uint8_t)value;
+      value >>= 8;
+    }
+}
+
+static void notectf_putbytes(FAR struct notectf_s *ctf,
+                             FAR const void *src, size_t len)
+{
+  memcpy(&ctf->packet[ctf->len], src, len);
+  ctf->len += len;
+}
+
+/****************************************************************************
+ * Name: notectf_putstring
+ *
+ * Description:
+ *   Append a null terminated string of at most 'len' bytes.
+ *
+ ****************************************************************************/
+
+static void notectf_putstring(FAR struct notectf_s *ctf,
+                              FAR const char *str, size_t len)
+{
+  len = strnlen(str, len);
+  notectf_putbytes(ctf, str, len);
+  ctf->packet[ctf->len++] = '\0';
+}
+
+/****************************************************************************
+ * Name: notectf_send
+ *
+ * Description:
+ *   Complete the packet header and context and hand the packet to the
+ *   transport.
+ *
+ * Assumptions:
+ *   ctf->lock is held.
+ *
+ ****************************************************************************/
+
+static void notectf_send(FAR struct notectf_s *ctf)
+{
+  size_t len = ctf->len;
+
+  if (len <= CTF_PACKET_HDRSIZE || ctf->stream == NULL)
+    {
+      return;
+    }
+
+  ctf->len = 0;
+  notectf_put(ctf, CTF_MAGIC, 4);
+  notectf_put(ctf, 0, 4);                       /* stream_id */
+  notectf_put(ctf, ctf->begin, 8);
+  notectf_put(ctf, ctf->end, 8);
+  notectf_put(ctf, len * 8, 8);                 /* content_size (bits) */
+  notectf_put(ctf, len * 8, 8);                 /* packet_size (bits) */
+  notectf_put(ctf, ctf->discarded, 4);
+  DEBUGASSERT(ctf->len == CTF_PACKET_HDRSIZE);
+
+  lib_stream_puts(ctf->stream, ctf->packet, len);
+  lib_stream_flush(ctf->stream);
+
+  ctf->len     = CTF_PACKET_HDRSIZE;
+  ctf->flushed = clock_systime_ticks();
+}
+
+/****************************************************************************
+ * Name: notectf_encode
+ *
+ * Description:
+ *   Append the event payload of one note, see the metadata above.
+ *
+ ****************************************************************************/
+
+static void notectf_encode(FAR struct notectf_s *ctf,
+                           FAR const struct note_common_s *note)
+{
+  size_t notelen = note->nc_length;
+
+  switch (note->nc_type)
+    {
+      case NOTE_START:
+#if CONFIG_TASK_NAME_SIZE > 0
+        notectf_putstring(ctf, ((FAR struct note_start_s *)note)->nst_name,
+                          notelen - offsetof(struct note_start_s,
+                                             nst_name));
+#else
+        notectf_putstring(ctf, "", 0);
+#endif
+        break;
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SWITCH
+      case NOTE_SUSPEND:
+        notectf_put(ctf, ((FAR struct note_suspend_s *)note)->nsu_state, 1);
+        break;
+#endif
+
+#ifdef CONFIG_SMP
+      case NOTE_CPU_START:
+        notectf_put(ctf, ((FAR struct note_cpu_start_s *)note)->ncs_target,
+                    1);
+        break;
+
+#  ifdef CONFIG_SCHED_INSTRUMENTATION_SWITCH
+      case NOTE_CPU_PAUSE:
+        notectf_put(ctf, ((FAR struct note_cpu_pause_s *)note)->ncp_target,
+                    1);
+        break;
+
+      case NOTE_CPU_RESUME:
+        notectf_put(ctf,
+                    ((FAR struct note_cpu_resume_s *)note)->ncr_target, 1);
+        break;
+#  endif
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_PREEMPTION
+      case NOTE_PREEMPT_LOCK:
+      case NOTE_PREEMPT_UNLOCK:
+        notectf_putbytes(ctf, ((FAR struct note_preempt_s *)note)->npr_count,
+                         2);
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_CSECTION
+      case NOTE_CSECTION_ENTER:
+      case NOTE_CSECTION_LEAVE:
+#  ifdef CONFIG_SMP
+        notectf_putbytes(ctf,
+                         ((FAR struct note_csection_s *)note)->ncs_count, 2);
+#  else
+        notectf_put(ctf, 0, 2);
+#  endif
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+      case NOTE_SPINLOCK_LOCK:
+      case NOTE_SPINLOCK_LOCKED:
+      case NOTE_SPINLOCK_UNLOCK:
+      case NOTE_SPINLOCK_ABORT:
+        {
+          FAR struct note_spinlock_s *nsp = (FAR struct note_spinlock_s *)
+                                            note;
+
+          notectf_putbytes(ctf, nsp->nsp_spinlock, sizeof(uintptr_t));
+          notectf_put(ctf, nsp->nsp_value, 1);
+        }
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SYSCALL
+      case NOTE_SYSCALL_ENTER:
+        {
+          FAR struct note_syscall_enter_s *nsc =
+            (FAR struct note_syscall_enter_s *)note;
+
+          notectf_put(ctf, nsc->nsc_nr, 1);
+          notectf_put(ctf, nsc->nsc_argc, 1);
+          notectf_putbytes(ctf, nsc->nsc_args,
+                           nsc->nsc_argc * sizeof(uintptr_t));
+        }
+        break;
+
+      case NOTE_SYSCALL_LEAVE:
+        {
+          FAR struct note_syscall_leave_s *nsc =
+            (FAR struct note_syscall_leave_s *)note;
+
+          notectf_put(ctf, nsc->nsc_nr, 1);
+          notectf_putbytes(ctf, nsc->nsc_result, sizeof(uintptr_t));
+        }
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_IRQHANDLER
+      case NOTE_IRQ_ENTER:
+      case NOTE_IRQ_LEAVE:
+        {
+          FAR struct note_irqhandler_s *nih =
+            (FAR struct note_irqhandler_s *)note;
+
+          notectf_put(ctf, nih->nih_irq, 1);
+          notectf_put(ctf, nih->nih_handler, sizeof(uintptr_t));
+        }
+        break;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+      case NOTE_DUMP_STRING:
+        {
+          FAR struct note_string_s *nst = (FAR struct note_string_s *)note;
+
+          notectf_putbytes(ctf, nst->nst_ip, sizeof(uintptr_t));
+          notectf_putstring(ctf, nst->nst_data,
+                            notelen - offsetof(struct note_string_s,
+                                               nst_data));
+        }
+        break;
+
+      case NOTE_DUMP_BINARY:
+        {
+          FAR struct note_binary_s *nbi = (FAR struct note_binary_s *)note;
+          size_t len = notelen - offsetof(struct note_binary_s, nbi_data);
+
+          notectf_putbytes(ctf, nbi->nbi_ip, sizeof(uintptr_t));
+          notectf_put(ctf, nbi->nbi_event, 1);
+          notectf_put(ctf, len, 1);
+          notectf_putbytes(ctf, nbi->nbi_data, len);
+        }
+        break;
+#endif
+
+      default:
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: notectf_add
+ *
+ * Description:
+ *   Append one note as a CTF event to the current packet, sending the
+ *   packet when it is full or has been pending for too long.
+ *
+ ****************************************************************************/
+
+static void notectf_add(FAR struct note_driver_s *drv,
+                        FAR const void *buf, size_t notelen)
+{
+  FAR struct notectf_s *ctf = (FAR struct notectf_s *)drv;
+  FAR const struct note_common_s *note = buf;
+  irqstate_t flags;
+  uint64_t ts;
+
+  ts = notectf_get(note->nc_systime_sec, sizeof(note->nc_systime_sec)) *
+       NSEC_PER_SEC +
+       notectf_get(note->nc_systime_nsec, sizeof(note->nc_systime_nsec));
+
+  flags = spin_lock_irqsave_wo_note(&ctf->lock);
+
+  if (ctf->stream == NULL)
+    {
+      spin_unlock_irqrestore_wo_note(&ctf->lock, flags);
+      return;
+    }
+
+  if (CTF_PACKET_HDRSIZE + CTF_EVENT_OVERHEAD + notelen >
+      CONFIG_DRIVERS_NOTECTF_PACKETSIZE)
+    {
+      ctf->discarded++;
+      spin_unlock_irqrestore_wo_note(&ctf->lock, flags);
+      return;
+    }
+
+  if (ctf->len + CTF_EVENT_OVERHEAD + notelen >
+      CONFIG_DRIVERS_NOTECTF_PACKETSIZE)
+    {
+      notectf_send(ctf);
+    }
+
+  if (ctf->len == CTF_PACKET_HDRSIZE)
+    {
+      ctf->begin = ts;
+    }
+
+  ctf->end = ts;
+
+  /* Event header and context */
+
+  notectf_put(ctf, note->nc_type, 1);
+  notectf_put(ctf, ts, 8);
+#ifdef CONFIG_SMP
+  notectf_put(ctf, note->nc_cpu, 1);
+#else
+  notectf_put(ctf, 0, 1);
+#endif
+  notectf_put(ctf, notectf_get(note->nc_pid, sizeof(note->nc_pid)), 4);
+  notectf_put(ctf, note->nc_priority, 1);
+
+  notectf_encode(ctf, note);
+
+  if (clock_systime_ticks() - ctf->flushed >=
+      MSEC2TICK(CONFIG_DRIVERS_NOTECTF_FLUSH_MS))
+    {
+      notectf_send(ctf);
+    }
+
+  spin_unlock_irqrestore_wo_note(&ctf->lock, flags);
+}
+
+/****************************************************************************
+ * Name: notectf_read
+ *
+ * Description:
+ *   Read the CTF metadata matching the data stream.
+ *
+ ****************************************************************************/
+
+static ssize_t notectf_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  size_t size = sizeof(g_notectf_metadata) - 1;
+
+  if (filep->f_pos >= size)
+    {
+      return 0;
+    }
+
+  if (buflen > size - filep->f_pos)
+    {
+      buflen = size - filep->f_pos;
+    }
+
+  memcpy(buffer, g_notectf_metadata + filep->f_pos, buflen);
+  filep->f_pos += buflen;
+  return buflen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notectf_initialize
+ *
+ * Description:
+ *   Start streaming sched notes as a Common Trace Format (CTF) data stream
+ *   to 'stream'.  The stream is written from the context that generates
+ *   the note, possibly an interrupt handler, so it must never block.  The
+ *   matching CTF metadata can be read from /dev/note/ctfmeta.
+ *
+ * Input Parameters:
+ *   stream - The transport that receives the CTF packets
+ *
+ * Returned Value:
+ *   Zero on success. A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int notectf_initialize(FAR struct lib_outstream_s *stream)
+{
+  irqstate_t flags;
+  bool registered;
+
+  if (stream == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = spin_lock_irqsave_wo_note(&g_notectf.lock);
+  registered          = g_notectf.stream != NULL;
+  g_notectf.stream    = stream;
+  g_notectf.len       = CTF_PACKET_HDRSIZE;
+  g_notectf.discarded = 0;
+  g_notectf.flushed   = clock_systime_ticks();
+  spin_unlock_irqrestore_wo_note(&g_notectf.lock, flags);
+
+  return registered ? OK : note_driver_register(&g_notectf.driver);
+}
+
+/****************************************************************************
+ * Name: notectf_register
+ *
+ * Description:
+ *   Register /dev/note/ctfmeta and, if a built-in transport is configured,
+ *   start streaming to it.
+ *
+ * Returned Value:
+ *   Zero on success. A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int notectf_register(void)
+{
+  int ret;
+
+  ret = register_driver("/dev/note/ctfmeta", &g_notectf_fops, 0444, NULL);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+#ifdef CONFIG_DRIVERS_NOTECTF_RTT
+  lib_rttoutstream_open(&g_notectf_rtt, CONFIG_DRIVERS_NOTECTF_RTT_CHANNEL,
+                        CONFIG_DRIVERS_NOTECTF_RTT_BUFSIZE);
+  ret = notectf_initialize(&g_notectf_rtt.public);
+#endif
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: notectf_flush
+ *
+ * Description:
+ *   Send the partially filled packet now.
+ *
+ ****************************************************************************/
+
+void notectf_flush(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave_wo_note(&g_notectf.lock);
+  notectf_send(&g_notectf);
+  spin_unlock_irqrestore_wo_note(&g_notectf.lock, flags);
+}
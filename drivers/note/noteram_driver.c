@@ -31,7 +31,10 @@
 #include <errno.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched.h>
 #include <nuttx/sched_note.h>
@@ -68,10 +71,39 @@
 #define get_task_state(s)                                                    \
   ((s) == 0 ? 'X' : ((s) <= LAST_READY_TO_RUN_STATE ? 'R' : 'S'))
 
+/* With per-CPU buffers the default device has one ring of
+ * CONFIG_DRIVERS_NOTERAM_CPU_BUFSIZE bytes for each CPU.
+ */
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+#  if (CONFIG_DRIVERS_NOTERAM_CPU_BUFSIZE & \
+       (CONFIG_DRIVERS_NOTERAM_CPU_BUFSIZE - 1)) != 0
+#    error CONFIG_DRIVERS_NOTERAM_CPU_BUFSIZE must be a power of two
+#  endif
+#  define NOTERAM_BUFSIZE (CONFIG_DRIVERS_NOTERAM_CPU_BUFSIZE * NCPUS)
+#else
+#  define NOTERAM_BUFSIZE CONFIG_DRIVERS_NOTERAM_BUFSIZE
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* The ring of one CPU.  The indices run freely and are reduced modulo the
+ * (power of two) ring size on access.  head and tail are only written by
+ * the owning CPU, read and clear only by the reader.
+ */
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+struct noteram_cpu_s
+{
+  volatile unsigned int head;   /* Next byte to be written */
+  volatile unsigned int tail;   /* Oldest note still in the ring */
+  volatile unsigned int read;   /* Next note to be read */
+  volatile unsigned int clear;  /* Notes before this one were cleared */
+};
+#endif
+
 struct noteram_driver_s
 {
   struct note_driver_s driver;
@@ -82,6 +114,10 @@ struct noteram_driver_s
   volatile unsigned int ni_tail;
   volatile unsigned int ni_read;
   spinlock_t lock;
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  size_t ni_cpusize;            /* Size of each per-CPU ring */
+  struct noteram_cpu_s ni_cpu[NCPUS];
+#endif
 };
 
 /* The structure to hold the context data of trace dump */
@@ -113,6 +149,8 @@ static ssize_t noteram_read(FAR struct file *filep,
 static int noteram_ioctl(struct file *filep, int cmd, unsigned long arg);
 static void noteram_add(FAR struct note_driver_s *drv,
                         FAR const void *note, size_t len);
+static void noteram_dump_unflatten(FAR void *dst, FAR uint8_t *src,
+                                   size_t len);
 static void
 noteram_dump_init_context(FAR struct noteram_dump_context_s *ctx);
 static int noteram_dump_one(FAR uint8_t *p, FAR struct lib_outstream_s *s,
@@ -132,7 +170,7 @@ static const struct file_operations g_noteram_fops =
   noteram_ioctl, /* ioctl */
 };
 
-static uint8_t g_ramnote_buffer[CONFIG_DRIVERS_NOTERAM_BUFSIZE];
+static uint8_t g_ramnote_buffer[NOTERAM_BUFSIZE];
 
 static const struct note_driver_ops_s g_noteram_ops =
 {
@@ -147,11 +185,18 @@ struct noteram_driver_s g_noteram_driver =
 {
   {&g_noteram_ops},
   g_ramnote_buffer,
-  CONFIG_DRIVERS_NOTERAM_BUFSIZE,
+  NOTERAM_BUFSIZE,
 #ifdef CONFIG_DRIVERS_NOTERAM_DEFAULT_NOOVERWRITE
-  NOTERAM_MODE_OVERWRITE_DISABLE
+  NOTERAM_MODE_OVERWRITE_DISABLE,
 #else
-  NOTERAM_MODE_OVERWRITE_ENABLE
+  NOTERAM_MODE_OVERWRITE_ENABLE,
+#endif
+  0,
+  0,
+  0,
+  SP_UNLOCKED,
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  CONFIG_DRIVERS_NOTERAM_CPU_BUFSIZE,
 #endif
 };
 
@@ -175,6 +220,18 @@ struct noteram_driver_s g_noteram_driver =
 
 static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
 {
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  int cpu;
+
+  /* The rings belong to their CPUs; only hide what was recorded so far */
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      drv->ni_cpu[cpu].clear = drv->ni_cpu[cpu].head;
+      drv->ni_cpu[cpu].read  = drv->ni_cpu[cpu].clear;
+    }
+#endif
+
   drv->ni_tail = drv->ni_head;
   drv->ni_read = drv->ni_head;
 
@@ -312,6 +369,203 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
   drv->ni_tail = noteram_next(drv, tail, length);
 }
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+
+/****************************************************************************
+ * Name: noteram_cpu_add
+ *
+ * Description:
+ *   Add a note to the ring of the current CPU.  Only this CPU ever writes
+ *   its ring, so disabling local interrupts is enough.  Old notes are
+ *   dropped by advancing the tail before their space is reused; the
+ *   barrier lets a concurrent reader detect that the note it is copying
+ *   was overwritten.
+ *
+ ****************************************************************************/
+
+static void noteram_cpu_add(FAR struct noteram_driver_s *drv,
+                            FAR const void *note, size_t notelen)
+{
+  FAR const uint8_t *buf = note;
+  FAR struct noteram_cpu_s *ring;
+  FAR uint8_t *base;
+  unsigned int mask = drv->ni_cpusize - 1;
+  unsigned int head;
+  unsigned int tail;
+  unsigned int offs;
+  unsigned int space;
+  irqstate_t flags;
+  int cpu;
+
+  flags = up_irq_save();
+
+  if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+    {
+      up_irq_restore(flags);
+      return;
+    }
+
+  DEBUGASSERT(note != NULL && notelen < drv->ni_cpusize);
+
+  cpu  = up_cpu_index();
+  ring = &drv->ni_cpu[cpu];
+  base = drv->ni_buffer + cpu * drv->ni_cpusize;
+  head = ring->head;
+  tail = ring->tail;
+
+  if (drv->ni_cpusize - (head - tail) < notelen)
+    {
+      if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
+        {
+          /* Stop recording if not in overwrite mode */
+
+          drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
+          up_irq_restore(flags);
+          return;
+        }
+
+      do
+        {
+          tail += base[tail & mask];
+        }
+      while (drv->ni_cpusize - (head - tail) < notelen);
+
+      ring->tail = tail;
+      SP_DMB();
+    }
+
+  offs  = head & mask;
+  space = drv->ni_cpusize - offs;
+  space = space < notelen ? space : notelen;
+  memcpy(base + offs, buf, space);
+  memcpy(base, buf + space, notelen - space);
+
+  /* Publish the note only when it is complete */
+
+  SP_DMB();
+  ring->head = head + notelen;
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: noteram_cpu_peek
+ *
+ * Description:
+ *   Copy up to 'buflen' bytes of the next unread note of one CPU without
+ *   consuming it.
+ *
+ * Returned Value:
+ *   The full length of the note, or zero if the ring is empty.
+ *
+ ****************************************************************************/
+
+static size_t noteram_cpu_peek(FAR struct noteram_driver_s *drv, int cpu,
+                               FAR uint8_t *buffer, size_t buflen)
+{
+  FAR struct noteram_cpu_s *ring = &drv->ni_cpu[cpu];
+  FAR uint8_t *base = drv->ni_buffer + cpu * drv->ni_cpusize;
+  unsigned int mask = drv->ni_cpusize - 1;
+  unsigned int head;
+  unsigned int read;
+  unsigned int i;
+  size_t notelen;
+
+  for (; ; )
+    {
+      head = ring->head;
+      SP_DMB();
+
+      /* Skip what was cleared or has been overwritten meanwhile */
+
+      read = ring->read;
+      if ((int)(read - ring->clear) < 0)
+        {
+          read = ring->clear;
+        }
+
+      if ((int)(read - ring->tail) < 0)
+        {
+          read = ring->tail;
+        }
+
+      ring->read = read;
+      if (read == head)
+        {
+          return 0;
+        }
+
+      notelen = base[read & mask];
+      for (i = 0; i < notelen && i < buflen; i++)
+        {
+          buffer[i] = base[(read + i) & mask];
+        }
+
+      /* The copy is only valid if the writer did not reclaim it */
+
+      SP_DMB();
+      if ((int)(read - ring->tail) >= 0)
+        {
+          DEBUGASSERT(notelen > 0 && notelen <= head - read);
+          return notelen;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: noteram_cpu_get
+ *
+ * Description:
+ *   Get the oldest unread note of all CPUs, merging the per-CPU rings by
+ *   note timestamp.
+ *
+ ****************************************************************************/
+
+static ssize_t noteram_cpu_get(FAR struct noteram_driver_s *drv,
+                               FAR uint8_t *buffer, size_t buflen)
+{
+  struct note_common_s note;
+  struct timespec oldest;
+  struct timespec ts;
+  size_t notelen;
+  int first = -1;
+  int cpu;
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      if (noteram_cpu_peek(drv, cpu, (FAR uint8_t *)&note,
+                           sizeof(note)) == 0)
+        {
+          continue;
+        }
+
+      noteram_dump_unflatten(&ts.tv_sec, note.nc_systime_sec,
+                             sizeof(note.nc_systime_sec));
+      noteram_dump_unflatten(&ts.tv_nsec, note.nc_systime_nsec,
+                             sizeof(note.nc_systime_nsec));
+
+      if (first < 0 || clock_timespec_compare(&ts, &oldest) < 0)
+        {
+          oldest = ts;
+          first  = cpu;
+        }
+    }
+
+  if (first < 0)
+    {
+      return 0;
+    }
+
+  notelen = noteram_cpu_peek(drv, first, buffer, buflen);
+  drv->ni_cpu[first].read += notelen;
+
+  /* Skip a note that is too large so that we do not get constipated */
+
+  return notelen > buflen ? -EFBIG : notelen;
+}
+
+#endif /* CONFIG_DRIVERS_NOTERAM_PERCPU */
+
 /****************************************************************************
  * Name: noteram_get
  *
@@ -340,6 +594,10 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
 
   DEBUGASSERT(buffer != NULL);
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  return noteram_cpu_get(drv, buffer, buflen);
+#endif
+
   /* Verify that the circular buffer is not empty */
 
   circlen = noteram_unread_length(drv);
@@ -401,10 +659,20 @@ static int noteram_open(FAR struct file *filep)
   FAR struct noteram_dump_context_s *ctx;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)
                                      filep->f_inode->i_private;
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  int cpu;
+#endif
 
   /* Reset the read index of the circular buffer */
 
   drv->ni_read = drv->ni_tail;
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      drv->ni_cpu[cpu].read = drv->ni_cpu[cpu].tail;
+    }
+#endif
+
   ctx = kmm_zalloc(sizeof(*ctx));
   if (ctx == NULL)
     {
@@ -556,6 +824,11 @@ static void noteram_add(FAR struct note_driver_s *driver,
   unsigned int space;
   irqstate_t flags;
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  noteram_cpu_add(drv, note, notelen);
+  return;
+#endif
+
   flags = spin_lock_irqsave_wo_note(&drv->lock);
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
@@ -1125,6 +1398,20 @@ noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite)
   drv->ni_head = 0;
   drv->ni_tail = 0;
   drv->ni_read = 0;
+  spin_initialize(&drv->lock, SP_UNLOCKED);
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  /* Split the buffer into power of two rings, one per CPU */
+
+  if (bufsize < NCPUS)
+    {
+      kmm_free(drv);
+      return NULL;
+    }
+
+  drv->ni_cpusize = 1u << (flsl(bufsize / NCPUS) - 1);
+  memset(drv->ni_cpu, 0, sizeof(drv->ni_cpu));
+#endif
 
   ret = note_driver_register(&drv->driver);
   if (ret < 0)
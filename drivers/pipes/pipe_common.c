@@ -27,12 +27,15 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <sys/param.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sched.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -60,6 +63,12 @@
 #  define pipe_dumpbuffer(m,a,n)
 #endif
 
+/* The largest reader wakeup threshold, that still leaves room for an
+ * atomic write once the readers were woken up.
+ */
+
+#define PIPE_MAX_RDLOWAT(s)      ((s) - MIN(PIPE_BUF, (s)))
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -78,6 +87,283 @@ static void pipecommon_wakeup(FAR sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_rdwakeup
+ *
+ * Description:
+ *   Wake up the blocked readers once enough data was buffered, so that a
+ *   stream of small writes does not cost a context switch each.
+ *
+ ****************************************************************************/
+
+static void pipecommon_rdwakeup(FAR struct pipe_dev_s *dev)
+{
+  if (circbuf_used(&dev->d_buffer) >= MAX(dev->d_rdlowat, 1))
+    {
+      pipecommon_wakeup(&dev->d_rdsem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_wrwakeup
+ *
+ * Description:
+ *   Wake up the blocked writers once enough space was freed.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wrwakeup(FAR struct pipe_dev_s *dev)
+{
+  if (circbuf_space(&dev->d_buffer) >= MAX(dev->d_wrlowat, 1))
+    {
+      pipecommon_wakeup(&dev->d_wrsem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_xfer
+ *
+ * Description:
+ *   Read from or write to the other file of a splice, at its position or
+ *   at *offset which is then advanced.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_xfer(FAR struct pipe_splice_s *splice,
+                               FAR void *buf, size_t nbytes)
+{
+  ssize_t ret;
+
+  if (splice->offset == NULL)
+    {
+      return splice->out ? file_read(splice->file, buf, nbytes) :
+                           file_write(splice->file, buf, nbytes);
+    }
+
+  ret = splice->out ? file_pread(splice->file, buf, nbytes,
+                                 *splice->offset) :
+                      file_pwrite(splice->file, buf, nbytes,
+                                  *splice->offset);
+  if (ret > 0)
+    {
+      *splice->offset += ret;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice
+ *
+ * Description:
+ *   Move data between the pipe and another file straight from or into the
+ *   circular buffer of the pipe, instead of going through a bounce buffer
+ *   with a read() and a write().
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_splice(FAR struct file *filep,
+                                 FAR struct pipe_splice_s *splice)
+{
+  FAR struct pipe_dev_s *dev    = filep->f_inode->i_private;
+  bool                   nonblock;
+  ssize_t                nxfer  = 0;
+  ssize_t                ret;
+  FAR void              *buf;
+  uint8_t                busy;
+  size_t                 n;
+
+  if (splice == NULL || splice->file == NULL ||
+      splice->file->f_inode == filep->f_inode)
+    {
+      return -EINVAL;
+    }
+
+  nonblock = (filep->f_oflags & O_NONBLOCK) != 0 ||
+             (splice->flags & SPLICE_F_NONBLOCK) != 0;
+  busy     = splice->out ? PIPE_FLAG_WRBUSY : PIPE_FLAG_RDBUSY;
+
+  ret = nxmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait for data to read, or for space to write, like read() and
+   * write() do, and for another splice in the same direction to finish.
+   */
+
+  while ((dev->d_flags & busy) != 0 ||
+         (splice->out ? circbuf_is_full(&dev->d_buffer) :
+                        circbuf_is_empty(&dev->d_buffer)))
+    {
+      if (splice->out ? dev->d_nreaders <= 0 :
+                        (dev->d_nwriters <= 0 &&
+                         circbuf_is_empty(&dev->d_buffer)))
+        {
+          nxmutex_unlock(&dev->d_bflock);
+          return splice->out ? -EPIPE : 0;
+        }
+
+      nxmutex_unlock(&dev->d_bflock);
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      ret = nxsem_wait(splice->out ? &dev->d_wrsem : &dev->d_rdsem);
+      if (ret < 0 || (ret = nxmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (splice->out && dev->d_nreaders <= 0)
+    {
+      nxmutex_unlock(&dev->d_bflock);
+      return -EPIPE;
+    }
+
+  /* Each contiguous region of the buffer is passed to the other file as
+   * is, without another copy.  The other file may block, so the region is
+   * reserved with the busy flag and the lock is dropped around the
+   * transfer: the other writers (or readers) wait for the flag to clear,
+   * while the readers (or writers) go on with the rest of the buffer.
+   * Resizing the buffer is refused until then.
+   */
+
+  dev->d_flags |= busy;
+
+  while ((size_t)nxfer < splice->count)
+    {
+      buf = splice->out ? circbuf_get_writeptr(&dev->d_buffer, &n) :
+                          circbuf_get_readptr(&dev->d_buffer, &n);
+      n   = MIN(n, splice->count - nxfer);
+      if (n == 0)
+        {
+          break;
+        }
+
+      nxmutex_unlock(&dev->d_bflock);
+      ret = pipecommon_xfer(splice, buf, n);
+      nxmutex_lock(&dev->d_bflock);
+
+      if (ret <= 0)
+        {
+          if (nxfer == 0)
+            {
+              nxfer = ret;
+            }
+
+          break;
+        }
+
+      if (splice->out)
+        {
+          circbuf_writecommit(&dev->d_buffer, ret);
+        }
+      else
+        {
+          circbuf_readcommit(&dev->d_buffer, ret);
+        }
+
+      nxfer += ret;
+      if ((size_t)ret < n)
+        {
+          break;
+        }
+    }
+
+  dev->d_flags &= ~busy;
+
+  /* Let the writers (or readers) that waited for the flag look again */
+
+  if (splice->out)
+    {
+      if (nxfer > 0)
+        {
+          if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
+            {
+              poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+            }
+
+          pipecommon_rdwakeup(dev);
+        }
+
+      pipecommon_wakeup(&dev->d_wrsem);
+    }
+  else
+    {
+      if (nxfer > 0)
+        {
+          if (circbuf_used(&dev->d_buffer) <=
+              (dev->d_bufsize - dev->d_polloutthrd))
+            {
+              poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS,
+                          POLLOUT);
+            }
+
+          pipecommon_wrwakeup(dev);
+        }
+
+      pipecommon_wakeup(&dev->d_rdsem);
+    }
+
+  nxmutex_unlock(&dev->d_bflock);
+  return nxfer;
+}
+
+/****************************************************************************
+ * Name: pipecommon_resize
+ *
+ * Description:
+ *   Change the size of the buffer of the pipe, keeping the data that it
+ *   holds.
+ *
+ ****************************************************************************/
+
+static int pipecommon_resize(FAR struct pipe_dev_s *dev, size_t size)
+{
+  int ret;
+
+  if (size == 0 || size > CONFIG_DEV_PIPE_MAXSIZE)
+    {
+      return -EINVAL;
+    }
+
+  /* A splice in progress works on the current buffer */
+
+  if (PIPE_IS_WRBUSY(dev->d_flags) || PIPE_IS_RDBUSY(dev->d_flags))
+    {
+      return -EBUSY;
+    }
+
+  if (circbuf_is_init(&dev->d_buffer))
+    {
+      if (circbuf_used(&dev->d_buffer) > size)
+        {
+          return -EBUSY;
+        }
+
+      ret = circbuf_resize(&dev->d_buffer, size);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  dev->d_bufsize     = size;
+  dev->d_pollinthrd  = MIN(dev->d_pollinthrd, size - 1);
+  dev->d_polloutthrd = MIN(dev->d_polloutthrd, size - 1);
+  dev->d_rdlowat     = MIN(dev->d_rdlowat, PIPE_MAX_RDLOWAT(size));
+  dev->d_wrlowat     = MIN(dev->d_wrlowat, size);
+
+  /* A larger buffer may let the blocked writers go on */
+
+  pipecommon_wrwakeup(dev);
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -403,18 +689,27 @@ int pipecommon_close(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: pipecommon_read
+ * Name: pipecommon_readv
  ****************************************************************************/
 
-ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
+ssize_t pipecommon_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                         int iovcnt)
 {
   FAR struct inode      *inode = filep->f_inode;
   FAR struct pipe_dev_s *dev   = inode->i_private;
   ssize_t                nread = 0;
+  size_t                 len   = 0;
+  size_t                 n;
   int                    ret;
+  int                    i;
 
   DEBUGASSERT(dev);
 
+  for (i = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
+
   if (len == 0)
     {
       return 0;
@@ -432,13 +727,15 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return ret;
     }
 
-  /* If the pipe is empty, then wait for something to be written to it */
+  /* If the pipe is empty, then wait for something to be written to it.
+   * Also wait while a splice drains the data.
+   */
 
-  while (circbuf_is_empty(&dev->d_buffer))
+  while (circbuf_is_empty(&dev->d_buffer) || PIPE_IS_RDBUSY(dev->d_flags))
     {
       /* If there are no writers on the pipe, then return end of file */
 
-      if (dev->d_nwriters <= 0)
+      if (dev->d_nwriters <= 0 && circbuf_is_empty(&dev->d_buffer))
         {
           nxmutex_unlock(&dev->d_bflock);
           return 0;
@@ -468,10 +765,19 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
     }
 
   /* Then return whatever is available in the pipe (which is at least one
-   * byte).
+   * byte), filling each buffer before proceeding to the next.
    */
 
-  nread = circbuf_read(&dev->d_buffer, buffer, len);
+  for (i = 0; i < iovcnt; i++)
+    {
+      n = circbuf_read(&dev->d_buffer, iov[i].iov_base, iov[i].iov_len);
+      pipe_dumpbuffer("From PIPE:", iov[i].iov_base, n);
+      nread += n;
+      if (n < iov[i].iov_len)
+        {
+          break;
+        }
+    }
 
   /* Notify all poll/select waiters that they can write to the
    * FIFO when buffer can accept more than d_polloutthrd bytes.
@@ -482,32 +788,52 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
     }
 
-  /* Notify all waiting writers that bytes have been removed from the
-   * buffer.
+  /* Notify the waiting writers that bytes have been removed from the
+   * buffer, once there is enough room for them.
    */
 
-  pipecommon_wakeup(&dev->d_wrsem);
+  pipecommon_wrwakeup(dev);
 
   nxmutex_unlock(&dev->d_bflock);
-  pipe_dumpbuffer("From PIPE:", buffer, nread);
   return nread;
 }
 
 /****************************************************************************
- * Name: pipecommon_write
+ * Name: pipecommon_read
  ****************************************************************************/
 
-ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t len)
+ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
+{
+  struct iovec iov;
+
+  iov.iov_base = buffer;
+  iov.iov_len  = len;
+  return pipecommon_readv(filep, &iov, 1);
+}
+
+/****************************************************************************
+ * Name: pipecommon_writev
+ ****************************************************************************/
+
+ssize_t pipecommon_writev(FAR struct file *filep,
+                          FAR const struct iovec *iov, int iovcnt)
 {
   FAR struct inode      *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev      = inode->i_private;
   ssize_t                nwritten = 0;
-  ssize_t                last;
+  size_t                 len      = 0;
+  size_t                 off      = 0;
+  bool                   atomic;
   int                    ret;
+  int                    i;
 
   DEBUGASSERT(dev);
-  pipe_dumpbuffer("To PIPE:", (FAR uint8_t *)buffer, len);
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      pipe_dumpbuffer("To PIPE:", iov[i].iov_base, iov[i].iov_len);
+      len += iov[i].iov_len;
+    }
 
   /* Handle zero-length writes */
 
@@ -516,6 +842,12 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
       return 0;
     }
 
+  /* Writes of up to PIPE_BUF bytes that fit in the buffer are not
+   * interleaved with the data of other writers.
+   */
+
+  atomic = len <= MIN(PIPE_BUF, dev->d_bufsize);
+
   /* At present, this method cannot be called from interrupt handlers.  That
    * is because it calls nxmutex_lock() and nxmutex_lock() cannot be called
    * form interrupt level. This actually happens fairly commonly
@@ -545,7 +877,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
   /* Loop until all of the bytes have been written */
 
-  last = 0;
+  i = 0;
   for (; ; )
     {
       /* REVISIT:  "If all file descriptors referring to the read end of a
@@ -560,14 +892,32 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
           return nwritten == 0 ? -EPIPE : nwritten;
         }
 
-      /* Would the next write overflow the circular buffer? */
+      /* Would the next write overflow the circular buffer?  An atomic
+       * write waits until there is room for all of it.  Nothing is written
+       * while a splice fills the free space.
+       */
 
-      if (!circbuf_is_full(&dev->d_buffer))
+      if (!PIPE_IS_WRBUSY(dev->d_flags) &&
+          (atomic ? circbuf_space(&dev->d_buffer) >= len :
+                    !circbuf_is_full(&dev->d_buffer)))
         {
-          /* Loop until all of the bytes have been written */
+          /* Write as much of the remaining buffers as fits */
 
-          nwritten += circbuf_write(&dev->d_buffer,
-                                    buffer + nwritten, len - nwritten);
+          while (i < iovcnt && !circbuf_is_full(&dev->d_buffer))
+            {
+              FAR const char *buffer = iov[i].iov_base;
+              ssize_t n;
+
+              n = circbuf_write(&dev->d_buffer, buffer + off,
+                                iov[i].iov_len - off);
+              nwritten += n;
+              off      += n;
+              if (off == iov[i].iov_len)
+                {
+                  off = 0;
+                  i++;
+                }
+            }
 
           if ((size_t)nwritten == len)
             {
@@ -581,11 +931,11 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
                               POLLIN);
                 }
 
-              /* Yes.. Notify all of the waiting readers that more data is
-               * available.
+              /* Yes.. Notify the waiting readers that more data is
+               * available, once there is enough of it for them.
                */
 
-              pipecommon_wakeup(&dev->d_rdsem);
+              pipecommon_rdwakeup(dev);
 
               /* Return the number of bytes written */
 
@@ -595,11 +945,13 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
         }
       else
         {
-          /* There is not enough room for the next byte.  Was anything
-           * written in this pass?
+          /* There is not enough room for the next byte.  Is there any
+           * data buffered?  The readers are woken up whatever the reader
+           * wakeup threshold, else an atomic write that waits for room
+           * and readers that wait for more data would block each other.
            */
 
-          if (last < nwritten)
+          if (!circbuf_is_empty(&dev->d_buffer))
             {
               /* Notify all poll/select waiters that they can read from the
                * FIFO.
@@ -607,15 +959,13 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
               poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
 
-              /* Yes.. Notify all of the waiting readers that more data is
+              /* Yes.. Notify all of the waiting readers that data is
                * available.
                */
 
               pipecommon_wakeup(&dev->d_rdsem);
             }
 
-          last = nwritten;
-
           /* If O_NONBLOCK was set, then return partial bytes written or
            * EGAIN.
            */
@@ -649,6 +999,20 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_write
+ ****************************************************************************/
+
+ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t len)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR char *)buffer;
+  iov.iov_len  = len;
+  return pipecommon_writev(filep, &iov, 1);
+}
+
 /****************************************************************************
  * Name: pipecommon_poll
  ****************************************************************************/
@@ -787,6 +1151,13 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     }
 #endif
 
+  /* The splice waits for the pipe without the lock held */
+
+  if (cmd == PIPEIOC_SPLICE)
+    {
+      return pipecommon_splice(filep, (FAR struct pipe_splice_s *)arg);
+    }
+
   ret = nxmutex_lock(&dev->d_bflock);
   if (ret < 0)
     {
@@ -838,6 +1209,41 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      case PIPEIOC_RDLOWAT:
+      case PIPEIOC_WRLOWAT:
+        {
+          if (arg > (cmd == PIPEIOC_RDLOWAT ?
+                     PIPE_MAX_RDLOWAT(dev->d_bufsize) : dev->d_bufsize))
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          if (cmd == PIPEIOC_RDLOWAT)
+            {
+              dev->d_rdlowat = (pipe_ndx_t)arg;
+            }
+          else
+            {
+              dev->d_wrlowat = (pipe_ndx_t)arg;
+            }
+
+          ret = OK;
+        }
+        break;
+
+      case PIPEIOC_SETSIZE:
+        {
+          ret = pipecommon_resize(dev, arg);
+        }
+        break;
+
+      case PIPEIOC_GETSIZE:
+        {
+          ret = dev->d_bufsize;
+        }
+        break;
+
       case PIPEIOC_PEEK:
         {
           FAR struct pipe_peek_s *peek = (FAR struct pipe_peek_s *)arg;
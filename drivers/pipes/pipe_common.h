@@ -85,6 +85,8 @@
 
 #define PIPE_FLAG_POLICY    (1 << 0) /* Bit 0: Policy=Free buffer when empty */
 #define PIPE_FLAG_UNLINKED  (1 << 1) /* Bit 1: The driver has been unlinked */
+#define PIPE_FLAG_WRBUSY    (1 << 2) /* Bit 2: A splice fills the free space */
+#define PIPE_FLAG_RDBUSY    (1 << 3) /* Bit 3: A splice drains the data */
 
 #define PIPE_POLICY_0(f)    do { (f) &= ~PIPE_FLAG_POLICY; } while (0)
 #define PIPE_POLICY_1(f)    do { (f) |= PIPE_FLAG_POLICY; } while (0)
@@ -94,6 +96,9 @@
 #define PIPE_UNLINK(f)      do { (f) |= PIPE_FLAG_UNLINKED; } while (0)
 #define PIPE_IS_UNLINKED(f) (((f) & PIPE_FLAG_UNLINKED) != 0)
 
+#define PIPE_IS_WRBUSY(f)   (((f) & PIPE_FLAG_WRBUSY) != 0)
+#define PIPE_IS_RDBUSY(f)   (((f) & PIPE_FLAG_RDBUSY) != 0)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -123,6 +128,8 @@ struct pipe_dev_s
   pipe_ndx_t       d_bufsize;     /* allocated size of d_buffer in bytes */
   pipe_ndx_t       d_pollinthrd;  /* Buffer threshold for POLLIN to occur */
   pipe_ndx_t       d_polloutthrd; /* Buffer threshold for POLLOUT to occur */
+  pipe_ndx_t       d_rdlowat;     /* Bytes buffered to wake blocked readers */
+  pipe_ndx_t       d_wrlowat;     /* Bytes free to wake blocked writers */
   uint8_t          d_nwriters;    /* Number of reference counts for write access */
   uint8_t          d_nreaders;    /* Number of reference counts for read access */
   uint8_t          d_flags;       /* See PIPE_FLAG_* definitions */
@@ -150,6 +157,7 @@ extern "C"
 
 struct file;  /* Forward reference */
 struct inode; /* Forward reference */
+struct iovec; /* Forward reference */
 
 FAR struct pipe_dev_s *pipecommon_allocdev(size_t bufsize);
 void    pipecommon_freedev(FAR struct pipe_dev_s *dev);
@@ -157,6 +165,10 @@ int     pipecommon_open(FAR struct file *filep);
 int     pipecommon_close(FAR struct file *filep);
 ssize_t pipecommon_read(FAR struct file *, FAR char *, size_t);
 ssize_t pipecommon_write(FAR struct file *, FAR const char *, size_t);
+ssize_t pipecommon_readv(FAR struct file *filep, FAR const struct iovec *iov,
+                         int iovcnt);
+ssize_t pipecommon_writev(FAR struct file *filep,
+                          FAR const struct iovec *iov, int iovcnt);
 int     pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
 int     pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
                                bool setup);
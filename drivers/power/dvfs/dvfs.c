@@ -0,0 +1,431 @@
+/****************************************************************************
+ * drivers/power/dvfs/dvfs.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/clk/clk.h>
+#include <nuttx/power/dvfs.h>
+
+#ifdef CONFIG_REGULATOR
+#  include <nuttx/power/consumer.h>
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct dvfs_s
+{
+  FAR const struct dvfs_governor_s *gov;
+  FAR const struct dvfs_opp_s *opps;
+  size_t nopps;
+  size_t cur;                                 /* Current operating point */
+  FAR struct clk_s *clk;
+#ifdef CONFIG_REGULATOR
+  FAR struct regulator_s *reg;
+#endif
+  mutex_t lock;
+  struct work_s work;
+  clock_t boost;                              /* End of the boost */
+  struct cpuload_s idle[CONFIG_SMP_NCPUS];    /* Last IDLE thread sample */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct dvfs_s g_dvfs =
+{
+  .lock = NXMUTEX_INITIALIZER,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dvfs_findopp
+ *
+ * Description:
+ *   Return the lowest operating point that reaches 'freq', or the highest
+ *   one if none does.
+ *
+ ****************************************************************************/
+
+static size_t dvfs_findopp(FAR struct dvfs_s *dvfs, uint32_t freq)
+{
+  size_t i;
+
+  for (i = 0; i < dvfs->nopps - 1; i++)
+    {
+      if (dvfs->opps[i].freq >= freq)
+        {
+          break;
+        }
+    }
+
+  return i;
+}
+
+/****************************************************************************
+ * Name: dvfs_setopp
+ *
+ * Description:
+ *   Switch to the operating point 'index'.  The voltage is raised before
+ *   the frequency and lowered after it, so that the CPU never runs faster
+ *   than its supply allows.
+ *
+ ****************************************************************************/
+
+static int dvfs_setopp(FAR struct dvfs_s *dvfs, size_t index)
+{
+  FAR const struct dvfs_opp_s *prev = &dvfs->opps[dvfs->cur];
+  FAR const struct dvfs_opp_s *next = &dvfs->opps[index];
+  int ret;
+
+  if (index == dvfs->cur)
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_REGULATOR
+  if (dvfs->reg != NULL && next->uv > prev->uv)
+    {
+      ret = regulator_set_voltage(dvfs->reg, next->uv, next->uv);
+      if (ret < 0)
+        {
+          pwrerr("ERROR: Failed to set %d uV: %d\n", next->uv, ret);
+          return ret;
+        }
+    }
+#endif
+
+  ret = clk_set_rate(dvfs->clk, next->freq);
+  if (ret < 0)
+    {
+      pwrerr("ERROR: Failed to set %" PRIu32 " Hz: %d\n", next->freq, ret);
+
+#ifdef CONFIG_REGULATOR
+      if (dvfs->reg != NULL && next->uv > prev->uv)
+        {
+          regulator_set_voltage(dvfs->reg, prev->uv, prev->uv);
+        }
+#endif
+
+      return ret;
+    }
+
+#ifdef CONFIG_REGULATOR
+  if (dvfs->reg != NULL && next->uv < prev->uv)
+    {
+      /* Failing to lower the voltage only wastes power */
+
+      regulator_set_voltage(dvfs->reg, next->uv, next->uv);
+    }
+#endif
+
+  dvfs->cur = index;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dvfs_load
+ *
+ * Description:
+ *   Return the busy time of the busiest CPU since the last call in
+ *   percent.  It is what its IDLE thread did not get of the CPU load ticks
+ *   counted meanwhile.
+ *
+ ****************************************************************************/
+
+static unsigned int dvfs_load(FAR struct dvfs_s *dvfs)
+{
+  unsigned int load = 0;
+  struct cpuload_s now;
+  uint32_t total;
+  uint32_t idle;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      FAR struct cpuload_s *last = &dvfs->idle[cpu];
+
+      /* The IDLE thread of each CPU has the CPU index as its PID */
+
+      if (clock_cpuload(cpu, &now) < 0)
+        {
+          continue;
+        }
+
+      /* All tick counts are halved when the total reaches the CPU load
+       * time constant.  Halve the previous sample too then.
+       */
+
+      if (now.total < last->total)
+        {
+          last->total  >>= 1;
+          last->active >>= 1;
+        }
+
+      /* The total counts the ticks of all CPUs */
+
+      total = (now.total - last->total) / CONFIG_SMP_NCPUS;
+      idle  = now.active > last->active ? now.active - last->active : 0;
+
+      last->total  = now.total;
+      last->active = now.active;
+
+      if (total > 0)
+        {
+          idle = MIN(idle, total);
+          load = MAX(load, 100 - idle * 100 / total);
+        }
+    }
+
+  return load;
+}
+
+/****************************************************************************
+ * Name: dvfs_worker
+ *
+ * Description:
+ *   Sample the load and move to the operating point that the governor
+ *   wants, but no lower than the SCHED_DEADLINE threads need and to the
+ *   highest one during a boost.
+ *
+ ****************************************************************************/
+
+static void dvfs_worker(FAR void *arg)
+{
+  FAR struct dvfs_s *dvfs = arg;
+  uint32_t minfreq = dvfs->opps[0].freq;
+  uint32_t maxfreq = dvfs->opps[dvfs->nopps - 1].freq;
+  uint32_t target;
+  irqstate_t flags;
+  clock_t boost;
+#ifdef CONFIG_SCHED_DEADLINE
+  unsigned int util;
+#endif
+
+  nxmutex_lock(&dvfs->lock);
+
+  target = dvfs->gov->target(dvfs_load(dvfs), dvfs->opps[dvfs->cur].freq,
+                             minfreq, maxfreq);
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* The reserved bandwidth must be served whatever the load is.  The
+   * budgets are taken as sized for the highest operating point, and are
+   * spread over all CPUs.
+   */
+
+  util   = nxsched_deadline_utilization();
+  util   = MIN((util + CONFIG_SMP_NCPUS - 1) / CONFIG_SMP_NCPUS, 100);
+  target = MAX(target, (uint32_t)((uint64_t)maxfreq * util / 100));
+#endif
+
+  flags = enter_critical_section();
+  boost = dvfs->boost;
+  leave_critical_section(flags);
+
+  if ((sclock_t)(boost - clock_systime_ticks()) > 0)
+    {
+      target = maxfreq;
+    }
+
+  dvfs_setopp(dvfs, dvfs_findopp(dvfs, target));
+  nxmutex_unlock(&dvfs->lock);
+
+  work_queue(LPWORK, &dvfs->work, dvfs_worker, dvfs,
+             MSEC2TICK(CONFIG_DVFS_SAMPLE_PERIOD));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dvfs_initialize
+ *
+ * Description:
+ *   Start scaling the CPU clock domain.
+ *
+ * Input Parameters:
+ *   clkname - The name of the CPU clock in the clk framework.
+ *   regname - The name of the core supply regulator, or NULL.
+ *   opps    - The operating points, sorted by increasing frequency.
+ *   nopps   - The number of operating points.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dvfs_initialize(FAR const char *clkname, FAR const char *regname,
+                    FAR const struct dvfs_opp_s *opps, size_t nopps)
+{
+  FAR struct dvfs_s *dvfs = &g_dvfs;
+  int ret;
+
+  DEBUGASSERT(clkname != NULL && opps != NULL && nopps > 0);
+
+  ret = nxmutex_lock(&dvfs->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (dvfs->gov != NULL)
+    {
+      ret = -EBUSY;
+      goto errout;
+    }
+
+  dvfs->clk = clk_get(clkname);
+  if (dvfs->clk == NULL)
+    {
+      pwrerr("ERROR: No clock %s\n", clkname);
+      ret = -ENODEV;
+      goto errout;
+    }
+
+  dvfs->opps  = opps;
+  dvfs->nopps = nopps;
+  dvfs->cur   = dvfs_findopp(dvfs, clk_get_rate(dvfs->clk));
+
+#ifdef CONFIG_REGULATOR
+  /* Bring the supply to the voltage of the operating point we start
+   * from, which is enough for the current frequency.
+   */
+
+  if (regname != NULL)
+    {
+      dvfs->reg = regulator_get(regname);
+      if (dvfs->reg == NULL)
+        {
+          pwrerr("ERROR: No regulator %s\n", regname);
+          ret = -ENODEV;
+          goto errout;
+        }
+
+      ret = regulator_enable(dvfs->reg);
+      if (ret >= 0)
+        {
+          ret = regulator_set_voltage(dvfs->reg, opps[dvfs->cur].uv,
+                                      opps[dvfs->cur].uv);
+        }
+
+      if (ret < 0)
+        {
+          regulator_put(dvfs->reg);
+          dvfs->reg = NULL;
+          goto errout;
+        }
+    }
+#else
+  UNUSED(regname);
+#endif
+
+#if defined(CONFIG_DVFS_GOVERNOR_ONDEMAND)
+  dvfs->gov = dvfs_ondemand_governor_initialize();
+#elif defined(CONFIG_DVFS_GOVERNOR_SCHEDUTIL)
+  dvfs->gov = dvfs_schedutil_governor_initialize();
+#endif
+
+  /* Start the first sampling period now */
+
+  dvfs_load(dvfs);
+  ret = work_queue(LPWORK, &dvfs->work, dvfs_worker, dvfs,
+                   MSEC2TICK(CONFIG_DVFS_SAMPLE_PERIOD));
+
+errout:
+  nxmutex_unlock(&dvfs->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dvfs_boost
+ *
+ * Description:
+ *   Run at the highest operating point for at least 'msec' milliseconds.
+ *
+ * Input Parameters:
+ *   msec - The duration of the boost in milliseconds.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODEV if DVFS is not initialized.
+ *
+ ****************************************************************************/
+
+int dvfs_boost(unsigned int msec)
+{
+  FAR struct dvfs_s *dvfs = &g_dvfs;
+  irqstate_t flags;
+  clock_t boost;
+
+  if (dvfs->gov == NULL)
+    {
+      return -ENODEV;
+    }
+
+  boost = clock_systime_ticks() + MSEC2TICK(msec);
+
+  flags = enter_critical_section();
+  if ((sclock_t)(boost - dvfs->boost) > 0)
+    {
+      dvfs->boost = boost;
+    }
+
+  leave_critical_section(flags);
+
+  /* Sample now instead of at the end of the period */
+
+  return work_queue(LPWORK, &dvfs->work, dvfs_worker, dvfs, 0);
+}
+
+/****************************************************************************
+ * Name: dvfs_getfreq
+ *
+ * Description:
+ *   Return the frequency of the current operating point.
+ *
+ ****************************************************************************/
+
+uint32_t dvfs_getfreq(void)
+{
+  FAR struct dvfs_s *dvfs = &g_dvfs;
+
+  return dvfs->gov != NULL ? dvfs->opps[dvfs->cur].freq : 0;
+}
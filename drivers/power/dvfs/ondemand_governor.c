@@ -0,0 +1,90 @@
+/****************************************************************************
+ * drivers/power/dvfs/ondemand_governor.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/power/dvfs.h>
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uint32_t ondemand_governor_target(unsigned int load,
+                                         uint32_t curfreq,
+                                         uint32_t minfreq,
+                                         uint32_t maxfreq);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct dvfs_governor_s g_ondemand_governor_ops =
+{
+  ondemand_governor_target,     /* target */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ondemand_governor_target
+ *
+ * Description:
+ *   Jump to the highest frequency as soon as the load crosses the up
+ *   threshold, so that bursts are served at once.  Below it, the frequency
+ *   is proportional to the load, which brings an idle system down to the
+ *   lowest operating point.
+ *
+ ****************************************************************************/
+
+static uint32_t ondemand_governor_target(unsigned int load,
+                                         uint32_t curfreq,
+                                         uint32_t minfreq,
+                                         uint32_t maxfreq)
+{
+  UNUSED(curfreq);
+
+  if (load >= CONFIG_DVFS_ONDEMAND_UP_THRESHOLD)
+    {
+      return maxfreq;
+    }
+
+  return minfreq + (uint32_t)((uint64_t)(maxfreq - minfreq) * load / 100);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dvfs_ondemand_governor_initialize
+ ****************************************************************************/
+
+FAR const struct dvfs_governor_s *dvfs_ondemand_governor_initialize(void)
+{
+  return &g_ondemand_governor_ops;
+}
@@ -0,0 +1,91 @@
+/****************************************************************************
+ * drivers/power/dvfs/schedutil_governor.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+
+#include <nuttx/power/dvfs.h>
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uint32_t schedutil_governor_target(unsigned int load,
+                                          uint32_t curfreq,
+                                          uint32_t minfreq,
+                                          uint32_t maxfreq);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct dvfs_governor_s g_schedutil_governor_ops =
+{
+  schedutil_governor_target,    /* target */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: schedutil_governor_target
+ *
+ * Description:
+ *   Scale the load measured at 'curfreq' into the capacity it used, which
+ *   does not depend on the frequency, and ask for that capacity plus
+ *   CONFIG_DVFS_SCHEDUTIL_HEADROOM percent.  A steady load thus settles at
+ *   the operating point where the CPUs are busy about 1 / (1 + headroom)
+ *   of the time, and a load that saturates the CPU climbs by the headroom
+ *   at each sampling period.
+ *
+ ****************************************************************************/
+
+static uint32_t schedutil_governor_target(unsigned int load,
+                                          uint32_t curfreq,
+                                          uint32_t minfreq,
+                                          uint32_t maxfreq)
+{
+  uint64_t util = (uint64_t)curfreq * load / 100;
+
+  UNUSED(minfreq);
+
+  util = util * (100 + CONFIG_DVFS_SCHEDUTIL_HEADROOM) / 100;
+  return (uint32_t)MIN(util, maxfreq);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dvfs_schedutil_governor_initialize
+ ****************************************************************************/
+
+FAR const struct dvfs_governor_s *dvfs_schedutil_governor_initialize(void)
+{
+  return &g_schedutil_governor_ops;
+}
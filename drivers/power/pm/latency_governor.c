@@ -0,0 +1,174 @@
+/****************************************************************************
+ * drivers/power/pm/latency_governor.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/wdog.h>
+#include <nuttx/power/pm.h>
+
+#include "pm.h"
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* PM governor methods */
+
+static enum pm_state_e latency_governor_checkstate(int domain);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct pm_governor_s g_latency_governor_ops =
+{
+  NULL,                         /* initialize */
+  NULL,                         /* deinitialize */
+  NULL,                         /* statechanged */
+  latency_governor_checkstate,  /* checkstate */
+  NULL,                         /* activity */
+  NULL                          /* priv */
+};
+
+/* The time (usec) needed to return to PM_NORMAL from each state */
+
+static const uint32_t g_exit_latency[PM_COUNT] =
+{
+  0,
+  CONFIG_PM_GOVERNOR_IDLE_EXIT_LATENCY,
+  CONFIG_PM_GOVERNOR_STANDBY_EXIT_LATENCY,
+  CONFIG_PM_GOVERNOR_SLEEP_EXIT_LATENCY
+};
+
+/* The minimum time (usec) that must be spent in each state, including the
+ * transitions, for entering it to save energy.
+ */
+
+static const uint32_t g_target_residency[PM_COUNT] =
+{
+  0,
+  CONFIG_PM_GOVERNOR_IDLE_RESIDENCY,
+  CONFIG_PM_GOVERNOR_STANDBY_RESIDENCY,
+  CONFIG_PM_GOVERNOR_SLEEP_RESIDENCY
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: latency_governor_sleeptime
+ *
+ * Description:
+ *   Return the time (usec) until the next timer event will wake up the
+ *   CPU, or UINT32_MAX if no timer is pending.
+ *
+ ****************************************************************************/
+
+static uint32_t latency_governor_sleeptime(void)
+{
+  sclock_t ticks = wd_nextexpiry();
+
+  if (ticks < 0 || ticks >= UINT32_MAX / USEC_PER_TICK)
+    {
+      return UINT32_MAX;
+    }
+
+  return TICK2USEC((uint32_t)ticks);
+}
+
+/****************************************************************************
+ * Name: latency_governor_checkstate
+ *
+ * Description:
+ *   Recommend the deepest state that is not held by a wakelock, whose exit
+ *   latency meets every QoS constraint of the domain, and whose target
+ *   residency fits before the next timer event.
+ *
+ ****************************************************************************/
+
+static enum pm_state_e latency_governor_checkstate(int domain)
+{
+  FAR struct pm_domain_s *pdom;
+  uint32_t sleeptime;
+  uint32_t latency;
+  irqstate_t flags;
+  int state;
+
+  pdom  = &g_pmglobals.domain[domain];
+  state = PM_NORMAL;
+
+  /* pm_stay()/pm_relax() may modify the wakelocks concurrently */
+
+  flags = pm_domain_lock(domain);
+
+  /* Find the lowest power-level which is not locked. */
+
+  while (dq_empty(&pdom->wakelock[state]) && state < (PM_COUNT - 1))
+    {
+      state++;
+    }
+
+  pm_domain_unlock(domain, flags);
+
+  /* Then back off until the cost of the state is acceptable */
+
+  latency   = pm_qos_latency(domain);
+  sleeptime = latency_governor_sleeptime();
+
+  while (state > PM_NORMAL &&
+         (g_exit_latency[state] > latency ||
+          g_target_residency[state] > sleeptime))
+    {
+      state--;
+    }
+
+  return state;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_latency_governor_initialize
+ *
+ * Description:
+ *   Return the latency governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct. Otherwise NULL is returned on error.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_latency_governor_initialize(void)
+{
+  return &g_latency_governor_ops;
+}
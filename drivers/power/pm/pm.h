@@ -64,6 +64,12 @@ struct pm_domain_s
   struct timespec sleep[PM_COUNT];
 #endif
 
+#ifdef CONFIG_PM_QOS
+  /* The list of latency constraints (struct pm_qos_s) */
+
+  struct dq_queue_s qos;
+#endif
+
   /* Auto update or not */
 
   bool auto_update;
@@ -0,0 +1,184 @@
+/****************************************************************************
+ * drivers/power/pm/pm_qos.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/power/pm.h>
+#include "pm.h"
+
+#ifdef CONFIG_PM_QOS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_qos_add
+ *
+ * Description:
+ *   Register a wakeup latency constraint on a PM domain.  Until it is
+ *   removed, no power state whose exit latency exceeds 'latency' will be
+ *   recommended for the domain.
+ *
+ * Input Parameters:
+ *   qos     - The constraint instance, owned by the caller
+ *   domain  - The PM domain to constrain
+ *   latency - The maximum tolerated wakeup latency in microseconds
+ *
+ * Returned Value:
+ *   None.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_add(FAR struct pm_qos_s *qos, int domain, uint32_t latency)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(qos != NULL);
+  DEBUGASSERT(domain >= 0 && domain < CONFIG_PM_NDOMAINS);
+
+  qos->domain  = domain;
+  qos->latency = latency;
+
+  flags = pm_domain_lock(domain);
+  dq_addlast(&qos->node, &g_pmglobals.domain[domain].qos);
+  pm_domain_unlock(domain, flags);
+
+  /* A tighter constraint may require leaving the current state */
+
+  pm_auto_updatestate(domain);
+}
+
+/****************************************************************************
+ * Name: pm_qos_update
+ *
+ * Description:
+ *   Change the latency of a registered constraint.
+ *
+ * Input Parameters:
+ *   qos     - The constraint instance previously passed to pm_qos_add()
+ *   latency - The new maximum tolerated wakeup latency in microseconds
+ *
+ * Returned Value:
+ *   None.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_update(FAR struct pm_qos_s *qos, uint32_t latency)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(qos != NULL);
+
+  flags = pm_domain_lock(qos->domain);
+  qos->latency = latency;
+  pm_domain_unlock(qos->domain, flags);
+
+  pm_auto_updatestate(qos->domain);
+}
+
+/****************************************************************************
+ * Name: pm_qos_remove
+ *
+ * Description:
+ *   Remove a constraint previously registered with pm_qos_add().
+ *
+ * Input Parameters:
+ *   qos - The constraint instance to remove
+ *
+ * Returned Value:
+ *   None.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_remove(FAR struct pm_qos_s *qos)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(qos != NULL);
+
+  flags = pm_domain_lock(qos->domain);
+  dq_rem(&qos->node, &g_pmglobals.domain[qos->domain].qos);
+  pm_domain_unlock(qos->domain, flags);
+
+  pm_auto_updatestate(qos->domain);
+}
+
+/****************************************************************************
+ * Name: pm_qos_latency
+ *
+ * Description:
+ *   Return the tightest latency constraint of a PM domain.
+ *
+ * Input Parameters:
+ *   domain - The PM domain to query
+ *
+ * Returned Value:
+ *   The smallest registered latency in microseconds, or UINT32_MAX if the
+ *   domain is not constrained.
+ *
+ ****************************************************************************/
+
+uint32_t pm_qos_latency(int domain)
+{
+  FAR struct dq_entry_s *entry;
+  uint32_t latency = UINT32_MAX;
+  irqstate_t flags;
+
+  DEBUGASSERT(domain >= 0 && domain < CONFIG_PM_NDOMAINS);
+
+  flags = pm_domain_lock(domain);
+
+  for (entry = dq_peek(&g_pmglobals.domain[domain].qos);
+       entry != NULL;
+       entry = dq_next(entry))
+    {
+      FAR struct pm_qos_s *qos =
+        container_of(entry, struct pm_qos_s, node);
+
+      if (qos->latency < latency)
+        {
+          latency = qos->latency;
+        }
+    }
+
+  pm_domain_unlock(domain, flags);
+  return latency;
+}
+
+#endif /* CONFIG_PM_QOS */
@@ -44,6 +44,10 @@
 #define DEVNAME_FMT        "/dev/lirc%d"
 #define DEVNAME_MAX        32
 
+/* lirc_edge_events() converts this many samples at a time */
+
+#define LIRC_EDGE_BATCH    32
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -58,6 +62,9 @@ struct lirc_upperhalf_s
   bool                         gap;          /* true if we're in a gap */
   uint64_t                     gap_start;    /* time when gap starts */
   uint64_t                     gap_duration; /* duration of initial gap */
+  bool                         edge_valid;   /* edge_last belongs to this packet */
+  bool                         edge_pulse;   /* a pulse started at edge_last */
+  uint32_t                     edge_last;    /* timestamp of the last edge */
 };
 
 /* The structure describes an open lirc file */
@@ -112,6 +119,81 @@ static const struct file_operations g_lirc_fops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: lirc_push_samples
+ *
+ * Description:
+ *   Append 'n' samples to the buffer of every open file and wake up each
+ *   reader once.  Timeouts are skipped for files that did not ask for them.
+ *
+ ****************************************************************************/
+
+static void lirc_push_samples(FAR struct lirc_upperhalf_s *upper,
+                              FAR const unsigned int *samples, size_t n)
+{
+  FAR struct list_node *node;
+  FAR struct list_node *tmp;
+  FAR struct lirc_fh_s *fh;
+  irqstate_t flags;
+  bool written;
+  int semcount;
+  size_t i;
+
+  flags = enter_critical_section();
+  list_for_every_safe(&upper->fh, node, tmp)
+    {
+      fh = (FAR struct lirc_fh_s *)node;
+      written = false;
+
+      for (i = 0; i < n; i++)
+        {
+          if (LIRC_IS_TIMEOUT(samples[i]) && !fh->send_timeout_reports)
+            {
+              continue;
+            }
+
+          if (circbuf_write(&fh->buffer, &samples[i],
+                            sizeof(unsigned int)) > 0)
+            {
+              written = true;
+            }
+        }
+
+      if (written)
+        {
+          poll_notify(&fh->fd, 1, POLLIN | POLLRDNORM);
+          nxsem_get_value(&fh->waitsem, &semcount);
+          if (semcount < 1)
+            {
+              nxsem_post(&fh->waitsem);
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: lirc_gap_end
+ *
+ * Description:
+ *   End the gap after a timeout and return the space sample that covers
+ *   it.
+ *
+ ****************************************************************************/
+
+static unsigned int lirc_gap_end(FAR struct lirc_upperhalf_s *upper)
+{
+  upper->gap_duration += (lirc_get_timestamp() / 1000) - upper->gap_start;
+
+  /* Cap by LIRC_VALUE_MASK */
+
+  upper->gap_duration = MIN(upper->gap_duration, LIRC_VALUE_MASK);
+  upper->gap = false;
+
+  return LIRC_SPACE(upper->gap_duration);
+}
+
 static int lirc_open(FAR struct file *filep)
 {
   FAR struct inode *inode = filep->f_inode;
@@ -849,13 +931,8 @@ void lirc_raw_event(FAR struct lirc_lowerhalf_s *lower,
                     struct lirc_raw_event_s ev)
 {
   FAR struct lirc_upperhalf_s *upper = lower->priv;
-  FAR struct list_node *node;
-  FAR struct list_node *tmp;
-  FAR struct lirc_fh_s *fh;
   unsigned int sample;
-  irqstate_t flags;
-  int semcount;
-  int gap;
+  unsigned int gap;
 
   /* Packet start */
 
@@ -869,6 +946,7 @@ void lirc_raw_event(FAR struct lirc_lowerhalf_s *lower,
        */
 
       sample = LIRC_SPACE(LIRC_VALUE_MASK);
+      upper->edge_valid = false;
       rcinfo("delivering reset sync space to lirc_dev\n");
     }
   else if (ev.carrier_report)
@@ -890,6 +968,7 @@ void lirc_raw_event(FAR struct lirc_lowerhalf_s *lower,
       upper->gap = true;
       upper->gap_start = lirc_get_timestamp() / 1000;
       upper->gap_duration = ev.duration;
+      upper->edge_valid = false;
 
       sample = LIRC_TIMEOUT(ev.duration);
       rcinfo("timeout report (duration: %d)\n", sample);
@@ -900,32 +979,8 @@ void lirc_raw_event(FAR struct lirc_lowerhalf_s *lower,
 
       if (upper->gap)
         {
-          upper->gap_duration += (lirc_get_timestamp() / 1000) -
-                                 upper->gap_start;
-
-          /* Cap by LIRC_VALUE_MASK */
-
-          upper->gap_duration = MIN(upper->gap_duration, LIRC_VALUE_MASK);
-          gap = LIRC_SPACE(upper->gap_duration);
-
-          flags = enter_critical_section();
-          list_for_every_safe(&upper->fh, node, tmp)
-            {
-              fh = (FAR struct lirc_fh_s *)node;
-              if (circbuf_write(&fh->buffer, &gap, sizeof(int)) > 0)
-                {
-                  poll_notify(&fh->fd, 1, POLLIN | POLLRDNORM);
-                  nxsem_get_value(&fh->waitsem, &semcount);
-                  if (semcount < 1)
-                    {
-                      nxsem_post(&fh->waitsem);
-                    }
-                }
-
-              upper->gap = false;
-            }
-
-          leave_critical_section(flags);
+          gap = lirc_gap_end(upper);
+          lirc_push_samples(upper, &gap, 1);
         }
 
       sample = ev.pulse ? LIRC_PULSE(ev.duration) : LIRC_SPACE(ev.duration);
@@ -933,27 +988,7 @@ void lirc_raw_event(FAR struct lirc_lowerhalf_s *lower,
              ev.duration, ev.pulse ? 1 : 0);
     }
 
-  flags = enter_critical_section();
-  list_for_every_safe(&upper->fh, node, tmp)
-    {
-      fh = (FAR struct lirc_fh_s *)node;
-      if (LIRC_IS_TIMEOUT(sample) && !fh->send_timeout_reports)
-        {
-          continue;
-        }
-
-      if (circbuf_write(&fh->buffer, &sample, sizeof(unsigned int)) > 0)
-        {
-          poll_notify(&fh->fd, 1, POLLIN | POLLRDNORM);
-          nxsem_get_value(&fh->waitsem, &semcount);
-          if (semcount < 1)
-            {
-              nxsem_post(&fh->waitsem);
-            }
-        }
-    }
-
-  leave_critical_section(flags);
+  lirc_push_samples(upper, &sample, 1);
 }
 
 /****************************************************************************
@@ -1045,3 +1080,94 @@ void lirc_sample_event(FAR struct lirc_lowerhalf_s *lower,
 
   leave_critical_section(flags);
 }
+
+/****************************************************************************
+ * Name: lirc_sample_events
+ *
+ * Description:
+ *   Like lirc_sample_event(), but sends 'n' samples at once and wakes up
+ *   the readers once.  Timeout samples only reach the readers that asked
+ *   for timeout reports.
+ *
+ * Input Parameters:
+ *   lower   - A pointer to an instance of lower half lirc driver.
+ *   samples - The pulse, space and timeout codes
+ *   n       - The number of samples
+ ****************************************************************************/
+
+void lirc_sample_events(FAR struct lirc_lowerhalf_s *lower,
+                        FAR const unsigned int *samples, size_t n)
+{
+  lirc_push_samples(lower->priv, samples, n);
+}
+
+/****************************************************************************
+ * Name: lirc_edge_events
+ *
+ * Description:
+ *   Lirc lowerhalf driver sends the timestamps of the edges of the
+ *   demodulated IR signal, e.g. a half of a timer capture DMA ring.  They
+ *   are turned into pulse and space samples and sent in batches.
+ *
+ *   The first edge after registration, a reset or a timeout reported with
+ *   lirc_raw_event() starts a pulse; the edges then alternate.
+ *
+ * Input Parameters:
+ *   lower - A pointer to an instance of lower half lirc driver.
+ *   edges - The timestamps of consecutive edges
+ *   n     - The number of timestamps
+ *   freq  - Timestamp ticks per second
+ *   mask  - The timestamps count modulo (mask + 1)
+ ****************************************************************************/
+
+void lirc_edge_events(FAR struct lirc_lowerhalf_s *lower,
+                      FAR const uint32_t *edges, size_t n,
+                      uint32_t freq, uint32_t mask)
+{
+  FAR struct lirc_upperhalf_s *upper = lower->priv;
+  unsigned int samples[LIRC_EDGE_BATCH];
+  uint64_t duration;
+  size_t count = 0;
+  size_t i;
+
+  DEBUGASSERT(freq > 0);
+
+  for (i = 0; i < n; i++)
+    {
+      if (!upper->edge_valid)
+        {
+          /* The first edge of a packet starts a pulse */
+
+          if (upper->gap)
+            {
+              samples[count++] = lirc_gap_end(upper);
+            }
+
+          upper->edge_valid = true;
+          upper->edge_pulse = true;
+        }
+      else
+        {
+          duration = (uint64_t)((edges[i] - upper->edge_last) & mask) *
+                     1000000 / freq;
+          duration = MIN(duration, LIRC_VALUE_MASK);
+
+          samples[count++] = upper->edge_pulse ? LIRC_PULSE(duration) :
+                                                 LIRC_SPACE(duration);
+          upper->edge_pulse = !upper->edge_pulse;
+        }
+
+      upper->edge_last = edges[i];
+
+      if (count == LIRC_EDGE_BATCH)
+        {
+          lirc_push_samples(upper, samples, count);
+          count = 0;
+        }
+    }
+
+  if (count > 0)
+    {
+      lirc_push_samples(upper, samples, count);
+    }
+}
@@ -38,6 +38,7 @@
 #include <nuttx/rptun/openamp.h>
 #include <nuttx/rptun/rptun.h>
 #include <nuttx/power/pm.h>
+#include <nuttx/wdog.h>
 #include <nuttx/wqueue.h>
 #include <metal/utilities.h>
 
@@ -80,6 +81,18 @@ struct rptun_priv_s
 #ifdef CONFIG_RPTUN_PING
   struct rpmsg_endpoint        ping;
 #endif
+#ifdef CONFIG_RPTUN_BULK
+  struct rptun_bulk_s          bulk;
+#endif
+#ifdef CONFIG_RPTUN_NOTIFY_COALESCE
+  struct wdog_s                notify_wdog;
+  uint32_t                     notify_id;
+  unsigned int                 notify_cnt;
+#endif
+#ifdef CONFIG_RPTUN_POLL
+  struct wdog_s                poll_wdog;
+  clock_t                      poll_ticks;
+#endif
 };
 
 struct rptun_bind_s
@@ -222,6 +235,37 @@ static inline void rptun_pm_action(FAR struct rptun_priv_s *priv,
 #  define rptun_pm_action(priv, stay)
 #endif
 
+static bool rptun_event_idx(FAR struct rptun_priv_s *priv)
+{
+  FAR struct virtio_device *vdev = priv->rvdev.vdev;
+
+  return priv->rproc.state == RPROC_RUNNING && vdev != NULL &&
+         (vdev->features & VIRTIO_RING_F_EVENT_IDX) != 0;
+}
+
+static bool rptun_enable_cb(FAR struct rptun_priv_s *priv)
+{
+  if (!rptun_event_idx(priv))
+    {
+      return false;
+    }
+
+  /* The other CPU only notifies again once it goes past the event index
+   * we publish here, so pick up what it sent meanwhile.  The returned tx
+   * buffers are only reclaimed by the next send, don't wait for them.
+   */
+
+  virtqueue_enable_cb(priv->rvdev.svq);
+#ifdef CONFIG_RPTUN_POLL
+  if (priv->poll_ticks != 0)
+    {
+      return false;
+    }
+#endif
+
+  return virtqueue_enable_cb(priv->rvdev.rvq) != 0;
+}
+
 static void rptun_worker(FAR void *arg)
 {
   FAR struct rptun_priv_s *priv = arg;
@@ -244,7 +288,12 @@ static void rptun_worker(FAR void *arg)
     }
 
   priv->cmd = RPTUNIOC_NONE;
-  remoteproc_get_notification(&priv->rproc, RPTUN_NOTIFY_ALL);
+
+  do
+    {
+      remoteproc_get_notification(&priv->rproc, RPTUN_NOTIFY_ALL);
+    }
+  while (rptun_enable_cb(priv));
 }
 
 #ifdef CONFIG_RPTUN_WORKQUEUE
@@ -337,6 +386,104 @@ static int rptun_callback(FAR void *arg, uint32_t vqid)
   return OK;
 }
 
+#ifdef CONFIG_RPTUN_NOTIFY_COALESCE
+static void rptun_notify_flush(FAR struct rptun_priv_s *priv)
+{
+  irqstate_t flags;
+  unsigned int cnt;
+  uint32_t id;
+
+  flags = enter_critical_section();
+  wd_cancel(&priv->notify_wdog);
+  cnt = priv->notify_cnt;
+  id  = priv->notify_id;
+  priv->notify_cnt = 0;
+  leave_critical_section(flags);
+
+  if (cnt > 0)
+    {
+      RPTUN_NOTIFY(priv->dev, id);
+    }
+}
+
+static void rptun_notify_timeout(wdparm_t arg)
+{
+  rptun_notify_flush((FAR struct rptun_priv_s *)arg);
+}
+
+/* Hold the notification back until CONFIG_RPTUN_NOTIFY_BATCH of them are
+ * pending or CONFIG_RPTUN_NOTIFY_DELAY expired, the other CPU drains the
+ * whole vring on every interrupt anyway.
+ */
+
+static void rptun_notify_coalesce(FAR struct rptun_priv_s *priv,
+                                  uint32_t id)
+{
+  irqstate_t flags;
+  bool flush;
+
+  flags = enter_critical_section();
+
+  if (priv->notify_cnt == 0)
+    {
+      priv->notify_id = id;
+      wd_start(&priv->notify_wdog, USEC2TICK(CONFIG_RPTUN_NOTIFY_DELAY),
+               rptun_notify_timeout, (wdparm_t)priv);
+    }
+  else if (priv->notify_id != id)
+    {
+      priv->notify_id = RPTUN_NOTIFY_ALL;
+    }
+
+  flush = ++priv->notify_cnt >= CONFIG_RPTUN_NOTIFY_BATCH;
+  leave_critical_section(flags);
+
+  if (flush)
+    {
+      rptun_notify_flush(priv);
+    }
+}
+#endif
+
+#ifdef CONFIG_RPTUN_POLL
+static void rptun_poll_timeout(wdparm_t arg)
+{
+  FAR struct rptun_priv_s *priv = (FAR struct rptun_priv_s *)arg;
+
+  rptun_callback(priv, RPTUN_NOTIFY_ALL);
+  wd_start(&priv->poll_wdog, priv->poll_ticks, rptun_poll_timeout, arg);
+}
+
+/* Poll the rx vring every 'usec' microseconds instead of taking an
+ * interrupt for each message, 0 goes back to the interrupt.
+ */
+
+static int rptun_poll_setup(FAR struct rptun_priv_s *priv,
+                            unsigned long usec)
+{
+  FAR struct virtqueue *rvq = priv->rvdev.rvq;
+
+  if (priv->rproc.state != RPROC_RUNNING || rvq == NULL)
+    {
+      return -ENODEV;
+    }
+
+  wd_cancel(&priv->poll_wdog);
+  priv->poll_ticks = usec ? MAX(USEC2TICK(usec), 1) : 0;
+
+  if (priv->poll_ticks != 0)
+    {
+      virtqueue_disable_cb(rvq);
+      return wd_start(&priv->poll_wdog, priv->poll_ticks,
+                      rptun_poll_timeout, (wdparm_t)priv);
+    }
+
+  virtqueue_enable_cb(rvq);
+  rptun_callback(priv, RPTUN_NOTIFY_ALL);
+  return OK;
+}
+#endif
+
 static FAR struct remoteproc *rptun_init(FAR struct remoteproc *rproc,
                                         FAR const struct remoteproc_ops *ops,
                                          FAR void *arg)
@@ -400,7 +547,11 @@ static int rptun_notify(FAR struct remoteproc *rproc, uint32_t id)
       rptun_pm_action(priv, true);
     }
 
+#ifdef CONFIG_RPTUN_NOTIFY_COALESCE
+  rptun_notify_coalesce(priv, id);
+#else
   RPTUN_NOTIFY(priv->dev, id);
+#endif
   return 0;
 }
 
@@ -447,6 +598,12 @@ static int rptun_notify_wait(FAR struct remoteproc *rproc, uint32_t id)
 {
   FAR struct rptun_priv_s *priv = rproc->priv;
 
+#ifdef CONFIG_RPTUN_NOTIFY_COALESCE
+  /* The other CPU can't return buffers it wasn't told about */
+
+  rptun_notify_flush(priv);
+#endif
+
   if (!rptun_is_recursive(priv))
     {
       return -EAGAIN;
@@ -454,7 +611,11 @@ static int rptun_notify_wait(FAR struct remoteproc *rproc, uint32_t id)
 
   /* Wait to wakeup */
 
-  nxsem_wait(&priv->semtx);
+  if (!rptun_event_idx(priv) || !virtqueue_enable_cb(priv->rvdev.svq))
+    {
+      nxsem_wait(&priv->semtx);
+    }
+
   rptun_worker(priv);
 
   return 0;
@@ -566,6 +727,10 @@ static int rptun_dev_start(FAR struct remoteproc *rproc)
   FAR struct metal_list *node;
   FAR struct rptun_cb_s *cb;
   unsigned int role = RPMSG_REMOTE;
+#ifdef CONFIG_RPTUN_BULK
+  FAR void *bulkbuf;
+  size_t bulksize;
+#endif
   int ret;
 
   ret = remoteproc_config(rproc, NULL);
@@ -673,14 +838,31 @@ static int rptun_dev_start(FAR struct remoteproc *rproc)
           rpmsg_virtio_init_shm_pool(&priv->pool[1], shbuf, shbufsz);
         }
 
+#ifdef CONFIG_RPTUN_EVENT_IDX
+      rsc->rpmsg_vdev.dfeatures |= VIRTIO_RING_F_EVENT_IDX;
+#endif
+
       role = RPMSG_HOST;
     }
 
+#ifdef CONFIG_RPTUN_BULK
+  /* Lay the bulk buffer pool out before the remote starts to use it */
+
+  bulkbuf = RPTUN_GET_BULKBUF(priv->dev, &bulksize);
+  if (bulkbuf != NULL && RPTUN_IS_MASTER(priv->dev))
+    {
+      rptun_bulk_init(&priv->bulk, bulkbuf, bulksize, true);
+    }
+#endif
+
   /* Remote proc create */
 
   vdev = remoteproc_create_virtio(rproc, 0, role, NULL);
   if (!vdev)
     {
+#ifdef CONFIG_RPTUN_BULK
+      rptun_bulk_deinit(&priv->bulk);
+#endif
       return -ENOMEM;
     }
 
@@ -706,19 +888,26 @@ static int rptun_dev_start(FAR struct remoteproc *rproc)
 
   if (ret)
     {
-      remoteproc_remove_virtio(rproc, vdev);
-      return ret;
+      goto err_with_virtio;
     }
 
   priv->rvdev.rdev.ns_unbind_cb = rptun_ns_unbind;
 
+#ifdef CONFIG_RPTUN_BULK
+  /* The master has written the layout of the pool by now */
+
+  if (bulkbuf != NULL && !RPTUN_IS_MASTER(priv->dev))
+    {
+      rptun_bulk_init(&priv->bulk, bulkbuf, bulksize, false);
+    }
+#endif
+
   /* Remote proc start */
 
   ret = remoteproc_start(rproc);
   if (ret)
     {
-      remoteproc_remove_virtio(rproc, vdev);
-      return ret;
+      goto err_with_virtio;
     }
 
   /* Register callback to mbox for receiving remote message */
@@ -746,6 +935,13 @@ static int rptun_dev_start(FAR struct remoteproc *rproc)
   rptun_ping_init(&priv->rvdev, &priv->ping);
 #endif
   return 0;
+
+err_with_virtio:
+#ifdef CONFIG_RPTUN_BULK
+  rptun_bulk_deinit(&priv->bulk);
+#endif
+  remoteproc_remove_virtio(rproc, vdev);
+  return ret;
 }
 
 static int rptun_dev_stop(FAR struct remoteproc *rproc)
@@ -762,6 +958,11 @@ static int rptun_dev_stop(FAR struct remoteproc *rproc)
 
   RPTUN_UNREGISTER_CALLBACK(priv->dev);
 
+#ifdef CONFIG_RPTUN_POLL
+  wd_cancel(&priv->poll_wdog);
+  priv->poll_ticks = 0;
+#endif
+
   /* Remove priv from list */
 
   nxrmutex_lock(&g_rptun_lockcb);
@@ -779,6 +980,10 @@ static int rptun_dev_stop(FAR struct remoteproc *rproc)
 
   nxrmutex_unlock(&g_rptun_lockcb);
 
+#ifdef CONFIG_RPTUN_NOTIFY_COALESCE
+  rptun_notify_flush(priv);
+#endif
+
   /* Remote proc stop and shutdown */
 
   remoteproc_shutdown(rproc);
@@ -788,6 +993,10 @@ static int rptun_dev_stop(FAR struct remoteproc *rproc)
   rpmsg_deinit_vdev(&priv->rvdev);
   remoteproc_remove_virtio(rproc, priv->rvdev.vdev);
 
+#ifdef CONFIG_RPTUN_BULK
+  rptun_bulk_deinit(&priv->bulk);
+#endif
+
   return 0;
 }
 
@@ -816,6 +1025,11 @@ static int rptun_do_ioctl(FAR struct rptun_priv_s *priv, int cmd,
       case RPTUNIOC_PING:
         rptun_ping(&priv->ping, (FAR const struct rptun_ping_s *)arg);
         break;
+#endif
+#ifdef CONFIG_RPTUN_POLL
+      case RPTUNIOC_POLL:
+        ret = rptun_poll_setup(priv, arg);
+        break;
 #endif
       default:
         ret = -ENOTTY;
@@ -1281,6 +1495,15 @@ int rptun_buffer_nused(FAR struct rpmsg_virtio_device *rvdev, bool rx)
     }
 }
 
+#ifdef CONFIG_RPTUN_BULK
+FAR struct rptun_bulk_s *rptun_get_bulk(FAR struct rpmsg_device *rdev)
+{
+  FAR struct rptun_priv_s *priv = rptun_get_priv_by_rdev(rdev);
+
+  return priv ? &priv->bulk : NULL;
+}
+#endif
+
 void rptun_dump_all(void)
 {
   rptun_ioctl_foreach(NULL, RPTUNIOC_DUMP, 0);
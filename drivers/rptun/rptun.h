@@ -26,8 +26,34 @@
  ****************************************************************************/
 
 #include <nuttx/rptun/rptun.h>
+#include <nuttx/spinlock.h>
 #include <openamp/open_amp.h>
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The bulk buffer pool has a part for each CPU, the blocks of which only
+ * it allocates and fills.  The other CPU frees them by moving the counter
+ * of the block in 'freed' on, it is the only one to write these counters.
+ * A block is free when the counter is the same as the private one in
+ * 'alloc', moved on by the owner at allocation.
+ */
+
+#ifdef CONFIG_RPTUN_BULK
+struct rptun_bulk_s
+{
+  FAR uint8_t          *base[2];   /* The blocks of each part */
+  FAR volatile uint8_t *freed[2];  /* The free counters of each part */
+  FAR uint8_t          *alloc;     /* The allocation counters of ours */
+  uint32_t              blksize;   /* The size of a block */
+  uint32_t              nblocks;   /* The number of blocks in a part */
+  uint32_t              align;     /* The cache line size of both CPUs */
+  uint8_t               own;       /* The index of our part */
+  spinlock_t            lock;
+};
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -41,4 +67,11 @@ void rptun_ping_deinit(FAR struct rpmsg_endpoint *ept);
 int rptun_ping(FAR struct rpmsg_endpoint *ept,
                FAR const struct rptun_ping_s *ping);
 
+#ifdef CONFIG_RPTUN_BULK
+int rptun_bulk_init(FAR struct rptun_bulk_s *bulk, FAR void *buf,
+                    size_t size, bool master);
+void rptun_bulk_deinit(FAR struct rptun_bulk_s *bulk);
+FAR struct rptun_bulk_s *rptun_get_bulk(FAR struct rpmsg_device *rdev);
+#endif
+
 #endif /* __DRIVERS_RPTUN_RPTUN_H */
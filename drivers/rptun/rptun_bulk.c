@@ -0,0 +1,361 @@
+/****************************************************************************
+ * drivers/rptun/rptun_bulk.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/rptun/openamp.h>
+
+#include "rptun.h"
+
+/****************************************************************************
+ * Pre-processor definitions
+ ****************************************************************************/
+
+#ifndef ALIGN_UP
+#  define ALIGN_UP(s, a)            (((s) + (a) - 1) & ~((a) - 1))
+#endif
+
+#define RPTUN_BULK_MAGIC            0x4b4c5542
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The pool starts with this header, in a cache line of its own, followed
+ * by the part of the master and then the one of the remote.  A part is the
+ * free counters, padded to a cache line, and then the blocks.
+ */
+
+begin_packed_struct struct rptun_bulk_hdr_s
+{
+  uint32_t magic;
+  uint32_t blksize;
+  uint32_t nblocks;
+  uint32_t align;
+} end_packed_struct;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR uint8_t *rptun_bulk_check(FAR struct rptun_bulk_s *bulk,
+                                     int part,
+                                     FAR const struct rpmsg_bulk_s *ref)
+{
+  uint32_t total = bulk->nblocks * bulk->blksize;
+
+  if (bulk->nblocks == 0 || ref->len == 0 || ref->offset >= total ||
+      ref->offset % bulk->blksize != 0 || ref->len > total - ref->offset)
+    {
+      return NULL;
+    }
+
+  return bulk->base[part] + ref->offset;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int rptun_bulk_init(FAR struct rptun_bulk_s *bulk, FAR void *buf,
+                    size_t size, bool master)
+{
+  FAR struct rptun_bulk_hdr_s *hdr = buf;
+  struct dcache_batch_s batch;
+  FAR uint8_t *part;
+  size_t stride;
+  int i;
+
+  memset(bulk, 0, sizeof(*bulk));
+  spin_initialize(&bulk->lock, SP_UNLOCKED);
+
+  if (master)
+    {
+      /* Lay the pool out, both parts get the same number of blocks */
+
+      bulk->align   = CONFIG_RPTUN_BULK_ALIGN;
+      bulk->blksize = ALIGN_UP(CONFIG_RPTUN_BULK_BLKSIZE, bulk->align);
+      if (size < 4 * bulk->align)
+        {
+          return -EINVAL;
+        }
+
+      bulk->nblocks = ((size - bulk->align) / 2 - bulk->align) /
+                      (bulk->blksize + 1);
+    }
+  else
+    {
+      /* The master wrote the header before it let us start */
+
+      up_invalidate_dcache((uintptr_t)hdr,
+                           (uintptr_t)hdr + sizeof(*hdr));
+      if (hdr->magic != RPTUN_BULK_MAGIC || hdr->align == 0 ||
+          (hdr->align & (hdr->align - 1)) != 0 || hdr->blksize == 0)
+        {
+          return -ENODEV;
+        }
+
+      bulk->align   = hdr->align;
+      bulk->blksize = hdr->blksize;
+      bulk->nblocks = hdr->nblocks;
+    }
+
+  stride = ALIGN_UP(bulk->nblocks, bulk->align) +
+           (size_t)bulk->nblocks * bulk->blksize;
+  if (bulk->nblocks == 0 || bulk->align + 2 * stride > size)
+    {
+      bulk->nblocks = 0;
+      return -EINVAL;
+    }
+
+  for (i = 0; i < 2; i++)
+    {
+      part           = (FAR uint8_t *)buf + bulk->align + i * stride;
+      bulk->freed[i] = part;
+      bulk->base[i]  = part + ALIGN_UP(bulk->nblocks, bulk->align);
+    }
+
+  bulk->own   = master ? 0 : 1;
+  bulk->alloc = kmm_zalloc(bulk->nblocks);
+  if (bulk->alloc == NULL)
+    {
+      bulk->nblocks = 0;
+      return -ENOMEM;
+    }
+
+  if (master)
+    {
+      /* The remote is not started before we return, so the header and
+       * the freed[] arrays can be written back together.  The header
+       * and freed[0] are adjacent and coalesce into one range.
+       */
+
+      dcache_batch_init(&batch, DCACHE_BATCH_CLEAN);
+
+      memset(buf, 0, bulk->align);
+      for (i = 0; i < 2; i++)
+        {
+          memset((FAR uint8_t *)bulk->freed[i], 0, bulk->nblocks);
+          dcache_batch_add(&batch, (uintptr_t)bulk->freed[i],
+                           (uintptr_t)bulk->base[i]);
+        }
+
+      hdr->blksize = bulk->blksize;
+      hdr->nblocks = bulk->nblocks;
+      hdr->align   = bulk->align;
+      hdr->magic   = RPTUN_BULK_MAGIC;
+      dcache_batch_add(&batch, (uintptr_t)hdr,
+                       (uintptr_t)hdr + bulk->align);
+      dcache_batch_commit(&batch);
+    }
+
+  return OK;
+}
+
+void rptun_bulk_deinit(FAR struct rptun_bulk_s *bulk)
+{
+  kmm_free(bulk->alloc);
+  bulk->alloc   = NULL;
+  bulk->nblocks = 0;
+}
+
+/* Allocate a buffer of 'len' bytes from our part of the pool, NULL if
+ * there is none free.  It is sent with a reference from rpmsg_bulk_ref(),
+ * and returns to the pool once the other CPU released it.
+ */
+
+FAR void *rpmsg_bulk_alloc(FAR struct rpmsg_endpoint *ept, size_t len)
+{
+  FAR struct rptun_bulk_s *bulk = rptun_get_bulk(ept->rdev);
+  FAR volatile uint8_t *freed;
+  irqstate_t flags;
+  uint32_t count;
+  uint32_t run;
+  uint32_t i;
+
+  if (bulk == NULL || bulk->nblocks == 0 || len == 0)
+    {
+      return NULL;
+    }
+
+  count = (len + bulk->blksize - 1) / bulk->blksize;
+  if (count > bulk->nblocks)
+    {
+      return NULL;
+    }
+
+  /* The other CPU moved the free counters on, read them again */
+
+  freed = bulk->freed[bulk->own];
+  up_invalidate_dcache((uintptr_t)freed,
+                       (uintptr_t)freed + ALIGN_UP(bulk->nblocks,
+                                                   bulk->align));
+
+  flags = spin_lock_irqsave(&bulk->lock);
+
+  for (i = 0, run = 0; i < bulk->nblocks; i++)
+    {
+      if (bulk->alloc[i] != freed[i])
+        {
+          run = 0;
+        }
+      else if (++run == count)
+        {
+          for (i = i + 1 - count, run = 0; run < count; run++)
+            {
+              bulk->alloc[i + run]++;
+            }
+
+          spin_unlock_irqrestore(&bulk->lock, flags);
+          return bulk->base[bulk->own] + i * bulk->blksize;
+        }
+    }
+
+  spin_unlock_irqrestore(&bulk->lock, flags);
+  return NULL;
+}
+
+/* Give back a buffer of rpmsg_bulk_alloc() that was not sent */
+
+void rpmsg_bulk_free(FAR struct rpmsg_endpoint *ept, FAR void *buf,
+                     size_t len)
+{
+  FAR struct rptun_bulk_s *bulk = rptun_get_bulk(ept->rdev);
+  struct rpmsg_bulk_s ref;
+  irqstate_t flags;
+  uint32_t first;
+  uint32_t i;
+
+  if (bulk == NULL)
+    {
+      return;
+    }
+
+  ref.offset = (FAR uint8_t *)buf - bulk->base[bulk->own];
+  ref.len    = len;
+  if (rptun_bulk_check(bulk, bulk->own, &ref) == NULL)
+    {
+      return;
+    }
+
+  first = ref.offset / bulk->blksize;
+  flags = spin_lock_irqsave(&bulk->lock);
+
+  for (i = 0; i * bulk->blksize < len; i++)
+    {
+      bulk->alloc[first + i]--;
+    }
+
+  spin_unlock_irqrestore(&bulk->lock, flags);
+}
+
+/* Fill the reference to send for 'len' bytes of a buffer, and write them
+ * back to the memory.  The buffer belongs to the other CPU once sent.
+ */
+
+int rpmsg_bulk_ref(FAR struct rpmsg_endpoint *ept, FAR void *buf,
+                   size_t len, FAR struct rpmsg_bulk_s *ref)
+{
+  FAR struct rptun_bulk_s *bulk = rptun_get_bulk(ept->rdev);
+  FAR uint8_t *data;
+
+  if (bulk == NULL)
+    {
+      return -ENODEV;
+    }
+
+  ref->offset = (FAR uint8_t *)buf - bulk->base[bulk->own];
+  ref->len    = len;
+  data        = rptun_bulk_check(bulk, bulk->own, ref);
+  if (data == NULL)
+    {
+      return -EINVAL;
+    }
+
+  up_clean_dcache((uintptr_t)data,
+                  (uintptr_t)data + ALIGN_UP(len, bulk->align));
+  return OK;
+}
+
+/* Get the data of a received reference, NULL if it is not valid.  It is
+ * given back with rpmsg_bulk_release() once done with.
+ */
+
+FAR void *rpmsg_bulk_get(FAR struct rpmsg_endpoint *ept,
+                         FAR const struct rpmsg_bulk_s *ref)
+{
+  FAR struct rptun_bulk_s *bulk = rptun_get_bulk(ept->rdev);
+  FAR uint8_t *data;
+
+  if (bulk == NULL)
+    {
+      return NULL;
+    }
+
+  data = rptun_bulk_check(bulk, !bulk->own, ref);
+  if (data != NULL)
+    {
+      up_invalidate_dcache((uintptr_t)data,
+                           (uintptr_t)data + ALIGN_UP(ref->len,
+                                                      bulk->align));
+    }
+
+  return data;
+}
+
+/* Give a received buffer back to the CPU that sent it */
+
+void rpmsg_bulk_release(FAR struct rpmsg_endpoint *ept,
+                        FAR const struct rpmsg_bulk_s *ref)
+{
+  FAR struct rptun_bulk_s *bulk = rptun_get_bulk(ept->rdev);
+  FAR volatile uint8_t *freed;
+  irqstate_t flags;
+  uint32_t first;
+  uint32_t i;
+
+  if (bulk == NULL || rptun_bulk_check(bulk, !bulk->own, ref) == NULL)
+    {
+      return;
+    }
+
+  freed = bulk->freed[1 - bulk->own];
+  first = ref->offset / bulk->blksize;
+  flags = spin_lock_irqsave(&bulk->lock);
+
+  for (i = 0; i * bulk->blksize < ref->len; i++)
+    {
+      freed[first + i]++;
+    }
+
+  spin_unlock_irqrestore(&bulk->lock, flags);
+
+  up_clean_dcache((uintptr_t)&freed[first], (uintptr_t)&freed[first + i]);
+}
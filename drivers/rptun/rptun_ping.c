@@ -29,6 +29,8 @@
 #include <string.h>
 #include <sys/param.h>
 
+#include <nuttx/rptun/openamp.h>
+
 #include "rptun.h"
 
 /****************************************************************************
@@ -39,6 +41,7 @@
 #define RPTUN_PING_SEND             1
 #define RPTUN_PING_SEND_NOACK       2
 #define RPTUN_PING_ACK              3
+#define RPTUN_PING_SEND_BULK        4
 
 /****************************************************************************
  * Private Types
@@ -51,6 +54,12 @@ begin_packed_struct struct rptun_ping_msg_s
   uint64_t cookie;
 } end_packed_struct;
 
+begin_packed_struct struct rptun_ping_bulk_s
+{
+  struct rptun_ping_msg_s msg;
+  struct rpmsg_bulk_s     ref;
+} end_packed_struct;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -67,6 +76,24 @@ static int rptun_ping_ept_cb(FAR struct rpmsg_endpoint *ept,
       msg->cmd = RPTUN_PING_ACK;
       rpmsg_send(ept, msg, len);
     }
+#ifdef CONFIG_RPTUN_BULK
+  else if (msg->cmd == RPTUN_PING_SEND_BULK &&
+           len >= sizeof(struct rptun_ping_bulk_s))
+    {
+      FAR struct rptun_ping_bulk_s *bmsg = data;
+      FAR volatile uint8_t *buf;
+
+      buf = rpmsg_bulk_get(ept, &bmsg->ref);
+      if (buf != NULL)
+        {
+          buf[0] = buf[bmsg->ref.len - 1];
+          rpmsg_bulk_release(ept, &bmsg->ref);
+        }
+
+      msg->cmd = RPTUN_PING_ACK;
+      rpmsg_send(ept, msg, sizeof(*msg));
+    }
+#endif
   else if (msg->cmd == RPTUN_PING_ACK)
     {
       nxsem_post(sem);
@@ -121,6 +148,60 @@ static int rptun_ping_once(FAR struct rpmsg_endpoint *ept,
   return ret;
 }
 
+#ifdef CONFIG_RPTUN_BULK
+static int rptun_ping_bulk(FAR struct rpmsg_endpoint *ept, int len)
+{
+  FAR struct rptun_ping_bulk_s *msg;
+  FAR void *buf;
+  uint32_t space;
+  sem_t sem;
+  int ret;
+
+  len = MAX(len, 1);
+  buf = rpmsg_bulk_alloc(ept, len);
+  if (buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  msg = rpmsg_get_tx_payload_buffer(ept, &space, true);
+  if (!msg)
+    {
+      rpmsg_bulk_free(ept, buf, len);
+      return -ENOMEM;
+    }
+
+  memset(buf, 0, len);
+
+  ret = rpmsg_bulk_ref(ept, buf, len, &msg->ref);
+  if (ret < 0)
+    {
+      rpmsg_release_tx_buffer(ept, msg);
+      rpmsg_bulk_free(ept, buf, len);
+      return ret;
+    }
+
+  msg->msg.cmd    = RPTUN_PING_SEND_BULK;
+  msg->msg.len    = len;
+  msg->msg.cookie = (uintptr_t)&sem;
+
+  nxsem_init(&sem, 0, 0);
+
+  ret = rpmsg_send_nocopy(ept, msg, sizeof(*msg));
+  if (ret >= 0)
+    {
+      nxsem_wait_uninterruptible(&sem);
+    }
+  else
+    {
+      rpmsg_bulk_free(ept, buf, len);
+    }
+
+  nxsem_destroy(&sem);
+  return ret;
+}
+#endif
+
 static void rptun_ping_logout(FAR const char *s, unsigned long value)
 {
   struct timespec ts;
@@ -155,7 +236,19 @@ int rptun_ping(FAR struct rpmsg_endpoint *ept,
     {
       unsigned long tm = up_perf_gettime();
 
-      int ret = rptun_ping_once(ept, ping->len, ping->ack);
+      int ret;
+
+#ifdef CONFIG_RPTUN_BULK
+      if (ping->bulk)
+        {
+          ret = rptun_ping_bulk(ept, ping->len);
+        }
+      else
+#endif
+        {
+          ret = rptun_ping_once(ept, ping->len, ping->ack);
+        }
+
       if (ret < 0)
         {
           return ret;
@@ -176,6 +269,15 @@ int rptun_ping(FAR struct rpmsg_endpoint *ept,
   rptun_ping_logout("min", min);
   rptun_ping_logout("max", max);
 
+#ifdef CONFIG_RPTUN_BULK
+  if (ping->bulk && total > 0)
+    {
+      syslog(LOG_INFO, "bulk: %d bytes, %" PRIu64 " KB/s\n", ping->len,
+             (uint64_t)ping->len * ping->times * up_perf_getfreq() /
+             total / 1024);
+    }
+#endif
+
   return 0;
 }
 
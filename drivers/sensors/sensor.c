@@ -40,6 +40,10 @@
 #include <nuttx/mutex.h>
 #include <nuttx/sensors/sensor.h>
 
+#ifdef CONFIG_SENSORS_MMAP
+#  include <nuttx/spinlock.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -97,6 +101,10 @@ struct sensor_upperhalf_s
   struct circbuf_s   buffer;             /* The circular buffer of data */
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_ring_s *ring;        /* The area holding both buffers */
+  size_t             ringsize;           /* The size of the area */
+#endif
 };
 
 /****************************************************************************
@@ -115,6 +123,10 @@ static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
+#ifdef CONFIG_SENSORS_MMAP
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes);
 
@@ -169,7 +181,11 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
+#ifdef CONFIG_SENSORS_MMAP
+  sensor_mmap,    /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -190,6 +206,38 @@ static void sensor_unlock(FAR void *priv)
   nxrmutex_unlock(&upper->lock);
 }
 
+static int sensor_batch(FAR struct file *filep,
+                        FAR struct sensor_upperhalf_s *upper,
+                        unsigned long interval,
+                        FAR unsigned long *latency)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+
+  /* Tell the driver how many samples the latency spans, so that it
+   * raises its FIFO interrupt once per batch and pushes them in one go.
+   */
+
+  if (*latency && interval && interval != ULONG_MAX)
+    {
+      lower->watermark = *latency / interval;
+      if (lower->watermark > lower->nbuffer)
+        {
+          lower->watermark = lower->nbuffer;
+        }
+
+      if (lower->watermark == 0)
+        {
+          lower->watermark = 1;
+        }
+    }
+  else
+    {
+      lower->watermark = 0;
+    }
+
+  return lower->ops->batch(lower, filep, latency);
+}
+
 static int sensor_update_interval(FAR struct file *filep,
                                   FAR struct sensor_upperhalf_s *upper,
                                   FAR struct sensor_user_s *user,
@@ -251,7 +299,7 @@ static int sensor_update_interval(FAR struct file *filep,
           (min_latency != upper->state.min_latency ||
           (min_interval != upper->state.min_interval && min_latency)))
         {
-          ret = lower->ops->batch(lower, filep, &min_latency);
+          ret = sensor_batch(filep, upper, min_interval, &min_latency);
           if (ret >= 0)
             {
               upper->state.min_latency = min_latency;
@@ -318,7 +366,8 @@ update:
 
   if (lower->ops->batch)
     {
-      ret = lower->ops->batch(lower, filep, &min_latency);
+      ret = sensor_batch(filep, upper, upper->state.min_interval,
+                         &min_latency);
       if (ret < 0)
         {
           return ret;
@@ -372,6 +421,30 @@ static bool sensor_is_updated(FAR struct sensor_upperhalf_s *upper,
     }
 }
 
+static bool sensor_is_batched(FAR struct sensor_upperhalf_s *upper,
+                              FAR struct sensor_user_s *user)
+{
+  unsigned long pending;
+
+  if (!sensor_is_updated(upper, user))
+    {
+      return false;
+    }
+  else if (user->state.latency == 0 || user->state.interval == ULONG_MAX)
+    {
+      return true;
+    }
+
+  /* Wake a batching user up once its samples span the latency it asked
+   * for, or earlier if they fill half of the buffer, so that it has time
+   * to read them before they are overwritten.
+   */
+
+  pending = upper->timing.head / TIMING_BUF_ESIZE - user->bufferpos;
+  return upper->state.generation - user->state.generation >=
+         user->state.latency || pending > upper->state.nbuffer / 2;
+}
+
 static void sensor_catch_up(FAR struct sensor_upperhalf_s *upper,
                             FAR struct sensor_user_s *user)
 {
@@ -486,6 +559,62 @@ static ssize_t sensor_do_samples(FAR struct sensor_upperhalf_s *upper,
   return ret;
 }
 
+static int sensor_init_buffer(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_ring_s *ring;
+  size_t timesize = lower->nbuffer * TIMING_BUF_ESIZE;
+  size_t datasize = lower->nbuffer * upper->state.esize;
+  size_t size = sizeof(*ring) + timesize + datasize;
+#endif
+  int ret;
+
+  if (circbuf_is_init(&upper->buffer))
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_SENSORS_MMAP
+  /* Allocate both buffers in one area that subscribers can map, the
+   * generations first as they keep the samples aligned.
+   */
+
+  ring = kumm_zalloc(size);
+  if (ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ring->esize   = upper->state.esize;
+  ring->nbuffer = lower->nbuffer;
+  ring->timeoff = sizeof(*ring);
+  ring->dataoff = sizeof(*ring) + timesize;
+
+  circbuf_init(&upper->timing, (FAR char *)ring + ring->timeoff, timesize);
+  circbuf_init(&upper->buffer, (FAR char *)ring + ring->dataoff, datasize);
+  upper->ring     = ring;
+  upper->ringsize = size;
+  ret = OK;
+#else
+  ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
+                     upper->state.esize);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
+                     TIMING_BUF_ESIZE);
+  if (ret < 0)
+    {
+      circbuf_uninit(&upper->buffer);
+    }
+#endif
+
+  return ret;
+}
+
 static void sensor_pollnotify_one(FAR struct sensor_user_s *user,
                                   pollevent_t eventset)
 {
@@ -835,6 +964,30 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_SENSORS_MMAP
+      case SNIOC_RING_CONSUME:
+        {
+          nxrmutex_lock(&upper->lock);
+          if (!circbuf_is_init(&upper->timing) ||
+              arg <= upper->timing.tail / TIMING_BUF_ESIZE ||
+              arg > upper->timing.head / TIMING_BUF_ESIZE)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              /* Move the user on as a read() of these samples would */
+
+              user->bufferpos = arg;
+              circbuf_peekat(&upper->timing, (arg - 1) * TIMING_BUF_ESIZE,
+                             &user->state.generation, TIMING_BUF_ESIZE);
+            }
+
+          nxrmutex_unlock(&upper->lock);
+        }
+        break;
+#endif
+
       default:
 
         /* Lowerhalf driver process other cmd. */
@@ -895,7 +1048,7 @@ static int sensor_poll(FAR struct file *filep,
                 }
             }
         }
-      else if (sensor_is_updated(upper, user))
+      else if (sensor_is_batched(upper, user))
         {
           eventset |= POLLIN;
         }
@@ -918,11 +1071,44 @@ errout:
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_MMAP
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  int ret;
+
+  if (lower->ops->fetch)
+    {
+      return -ENOTSUP;
+    }
+
+  nxrmutex_lock(&upper->lock);
+  ret = sensor_init_buffer(upper);
+  if (ret >= 0)
+    {
+      if (map->offset >= 0 && map->offset < upper->ringsize &&
+          map->length && map->offset + map->length <= upper->ringsize)
+        {
+          map->vaddr = (FAR char *)upper->ring + map->offset;
+        }
+      else
+        {
+          ret = -EINVAL;
+        }
+    }
+
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif
+
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes)
 {
   FAR struct sensor_upperhalf_s *upper = priv;
-  FAR struct sensor_lowerhalf_s *lower = upper->lower;
   FAR struct sensor_user_s *user;
   unsigned long envcount;
   int semcount;
@@ -935,33 +1121,33 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
     }
 
   nxrmutex_lock(&upper->lock);
-  if (!circbuf_is_init(&upper->buffer))
-    {
-      /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
-                         upper->state.esize);
-      if (ret < 0)
-        {
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
+  /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
-                         TIMING_BUF_ESIZE);
-      if (ret < 0)
-        {
-          circbuf_uninit(&upper->buffer);
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
+  ret = sensor_init_buffer(upper);
+  if (ret < 0)
+    {
+      nxrmutex_unlock(&upper->lock);
+      return ret;
     }
 
+#ifdef CONFIG_SENSORS_MMAP
+  /* Tell the mapping subscribers which samples are being overwritten */
+
+  upper->ring->begin = upper->timing.head / TIMING_BUF_ESIZE + envcount;
+  SEQ_DMB();
+#endif
+
   circbuf_overwrite(&upper->buffer, data, bytes);
   sensor_generate_timing(upper, envcount);
+
+#ifdef CONFIG_SENSORS_MMAP
+  SEQ_DMB();
+  upper->ring->end = upper->timing.head / TIMING_BUF_ESIZE;
+#endif
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
-      if (sensor_is_updated(upper, user))
+      if (sensor_is_batched(upper, user))
         {
           nxsem_get_value(&user->buffersem, &semcount);
           if (semcount < 1)
@@ -1212,5 +1398,9 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
       circbuf_uninit(&upper->timing);
     }
 
+#ifdef CONFIG_SENSORS_MMAP
+  kumm_free(upper->ring);
+#endif
+
   kmm_free(upper);
 }
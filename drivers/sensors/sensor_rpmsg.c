@@ -680,12 +680,33 @@ static int sensor_rpmsg_activate(FAR struct sensor_lowerhalf_s *lower,
 
 SENSOR_RPMSG_FUNCTION(set_interval, SNIOC_SET_INTERVAL,
                       *interval, interval, 0, false)
-SENSOR_RPMSG_FUNCTION(batch, SNIOC_BATCH, *latency, latency, 0, false)
 SENSOR_RPMSG_FUNCTION(selftest, SNIOC_SELFTEST, arg, arg, 0, true)
 SENSOR_RPMSG_FUNCTION(set_calibvalue, SNIOC_SET_CALIBVALUE,
                       arg, arg, 256, true)
 SENSOR_RPMSG_FUNCTION(calibrate, SNIOC_CALIBRATE, arg, arg, 256, true)
 
+static int sensor_rpmsg_batch(FAR struct sensor_lowerhalf_s *lower,
+                              FAR struct file *filep,
+                              FAR unsigned long *latency_us)
+{
+  FAR struct sensor_rpmsg_dev_s *dev = lower->priv;
+  FAR struct sensor_lowerhalf_s *drv = dev->drv;
+
+  /* The upper half set the watermark in our copy of the lower half */
+
+  if (drv->ops->batch)
+    {
+      drv->watermark = lower->watermark;
+      return drv->ops->batch(drv, filep, latency_us);
+    }
+  else if (!(filep->f_oflags & SENSOR_REMOTE))
+    {
+      sensor_rpmsg_ioctl(dev, SNIOC_BATCH, *latency_us, 0, false);
+    }
+
+  return 0;
+}
+
 static int sensor_rpmsg_control(FAR struct sensor_lowerhalf_s *lower,
                                 FAR struct file *filep,
                                 int cmd, unsigned long arg)
@@ -163,11 +163,32 @@ void uart_xmitchars_done(FAR uart_dev_t *dev)
 
   if (nbytes)
     {
+#ifdef CONFIG_SERIAL_ICOUNT
+      dev->icount.tx += nbytes;
+#endif
       uart_datasent(dev);
     }
 }
 #endif
 
+/****************************************************************************
+ * Name: uart_xmitchars_next
+ *
+ * Description:
+ *   Complete the TX DMA transfer and start the next one from the data that
+ *   was written to the TX circular buffer while the previous one was in
+ *   flight, so that the line does not go idle between the two.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_TXDMA
+void uart_xmitchars_next(FAR uart_dev_t *dev)
+{
+  uart_xmitchars_done(dev);
+  uart_xmitchars_dma(dev);
+}
+#endif
+
 /****************************************************************************
  * Name: uart_recvchars_dma
  *
@@ -328,6 +349,9 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
 
   /* Move head for nbytes. */
 
+#ifdef CONFIG_SERIAL_ICOUNT
+  dev->icount.rx += nbytes;
+#endif
   rxbuf->head  = (rxbuf->head + nbytes) % rxbuf->size;
   xfer->nbytes = 0;
   xfer->length = xfer->nlength = 0;
@@ -367,4 +391,103 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_cyclic
+ *
+ * Description:
+ *   Take the data that a circular RX DMA wrote to the RX circular buffer
+ *   up to 'pos', the index it will write next, and wake up the readers
+ *   if the line went idle, half of the buffer is full or the port is in
+ *   low-latency mode.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_cyclic(FAR uart_dev_t *dev, size_t pos, bool idle)
+{
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  size_t nbuffered;
+  size_t nbytes;
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+  int signo;
+#endif
+
+  DEBUGASSERT(pos < rxbuf->size);
+
+  /* How many bytes the DMA wrote since the last call, and how many were
+   * buffered before them.
+   */
+
+  nbytes    = (pos + rxbuf->size - rxbuf->head) % rxbuf->size;
+  nbuffered = (rxbuf->head + rxbuf->size - rxbuf->tail) % rxbuf->size;
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+  if (rxbuf->head + nbytes <= rxbuf->size)
+    {
+      signo = uart_check_special(dev, &rxbuf->buffer[rxbuf->head],
+                                 nbytes);
+    }
+  else
+    {
+      signo = uart_check_special(dev, &rxbuf->buffer[rxbuf->head],
+                                 rxbuf->size - rxbuf->head);
+      if (signo == 0)
+        {
+          signo = uart_check_special(dev, rxbuf->buffer, pos);
+        }
+    }
+#endif
+
+  /* The DMA does not stop when the buffer is full.  If it overwrote data
+   * that was not read yet, drop the oldest bytes so that the buffer holds
+   * the last size - 1 bytes received.
+   */
+
+  if (nbuffered + nbytes >= rxbuf->size)
+    {
+#ifdef CONFIG_SERIAL_ICOUNT
+      dev->icount.buf_overrun += nbuffered + nbytes - (rxbuf->size - 1);
+#endif
+      nbuffered   = rxbuf->size - 1;
+      rxbuf->tail = (pos + 1) % rxbuf->size;
+    }
+  else
+    {
+      nbuffered += nbytes;
+    }
+
+#ifdef CONFIG_SERIAL_ICOUNT
+  dev->icount.rx += nbytes;
+#endif
+  rxbuf->head = pos;
+
+  /* In throughput mode the readers are only woken up by a half full
+   * buffer or an idle line, so that a burst costs a few wakeups.
+   */
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  if (nbuffered > 0 && nbuffered >= dev->minrecv &&
+#else
+  if (nbuffered > 0 &&
+#endif
+      (idle || dev->lowlatency || nbuffered >= rxbuf->size / 2))
+    {
+      uart_datareceived(dev);
+    }
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+  /* Send the signal if necessary */
+
+  if (signo != 0)
+    {
+      nxsig_kill(dev->pid, signo);
+      uart_reset_sem(dev);
+    }
+#endif
+}
+#endif
+
 #endif /* CONFIG_SERIAL_TXDMA || CONFIG_SERIAL_RXDMA */
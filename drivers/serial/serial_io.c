@@ -97,6 +97,9 @@ void uart_xmitchars(FAR uart_dev_t *dev)
 
   if (nbytes)
     {
+#ifdef CONFIG_SERIAL_ICOUNT
+      dev->icount.tx += nbytes;
+#endif
       uart_datasent(dev);
     }
 
@@ -231,6 +234,14 @@ void uart_recvchars(FAR uart_dev_t *dev)
                nexthead = 0;
             }
         }
+#ifdef CONFIG_SERIAL_ICOUNT
+      else
+        {
+          dev->icount.buf_overrun++;
+        }
+
+      dev->icount.rx++;
+#endif
     }
 
   /* If any bytes were added to the buffer, inform any waiters there is new
@@ -29,45 +29,70 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
 #include <nuttx/signal.h>
 #include <nuttx/spi/spi.h>
 #include <nuttx/spi/spi_transfer.h>
+#include <nuttx/wqueue.h>
 
 #ifdef CONFIG_SPI_EXCHANGE
 
 /****************************************************************************
- * Public Functions
+ * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_LPWORK
+#  define SPI_ASYNC_WORK LPWORK
+#else
+#  define SPI_ASYNC_WORK HPWORK
+#endif
+
 /****************************************************************************
- * Name: spi_transfer
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+/* The queue of asynchronous transfers of one SPI bus */
+
+struct spi_async_bus_s
+{
+  FAR struct spi_async_bus_s *flink;  /* Next bus with a queue */
+  FAR struct spi_dev_s *spi;          /* The bus */
+  FAR struct spi_async_s *head;       /* Transfers waiting for the bus */
+  FAR struct spi_async_s *tail;
+  struct work_s work;                 /* Runs the queue */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+static FAR struct spi_async_bus_s *g_spi_async_buses;
+static mutex_t g_spi_async_lock = NXMUTEX_INITIALIZER;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_sequence
  *
  * Description:
- *   This is a helper function that can be used to encapsulate and manage
- *   a sequence of SPI transfers.  The SPI bus will be locked and the
- *   SPI device selected for the duration of the transfers.
- *
- * Input Parameters:
- *   spi - An instance of the SPI device to use for the transfer
- *   seq - Describes the sequence of transfers.
- *
- * Returned Value:
- *   Zero (OK) on success; a negated errno value on failure.
+ *   Perform a sequence of SPI transfers on a bus that the caller locked.
  *
  ****************************************************************************/
 
-int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
+static int spi_sequence(FAR struct spi_dev_s *spi,
+                        FAR struct spi_sequence_s *seq)
 {
   FAR struct spi_trans_s *trans;
   int ret = OK;
   int i;
 
-  DEBUGASSERT(spi != NULL && seq != NULL && seq->trans != NULL);
-
-  /* Get exclusive access to the SPI bus */
-
-  SPI_LOCK(spi, true);
-
   /* Establish the fixed SPI attributes for all transfers in the sequence */
 
   SPI_SETFREQUENCY(spi, seq->frequency);
@@ -77,7 +102,6 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
   if (ret < 0)
     {
       spierr("ERROR: SPI_SETDELAY failed: %d\n", ret);
-      SPI_LOCK(spi, false);
       return ret;
     }
 #endif
@@ -139,8 +163,180 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
     }
 
   SPI_SELECT(spi, seq->dev, false);
+  return ret;
+}
+
+#ifdef CONFIG_SPI_ASYNC
+/****************************************************************************
+ * Name: spi_async_worker
+ *
+ * Description:
+ *   Perform the queued transfers of a bus back-to-back, with the bus
+ *   locked once for all of them, then report their completion.
+ *
+ ****************************************************************************/
+
+static void spi_async_worker(FAR void *arg)
+{
+  FAR struct spi_async_bus_s *bus = arg;
+  FAR struct spi_async_s *req;
+  FAR struct spi_async_s *done;
+
+  for (; ; )
+    {
+      nxmutex_lock(&g_spi_async_lock);
+      done      = bus->head;
+      bus->head = NULL;
+      bus->tail = NULL;
+      nxmutex_unlock(&g_spi_async_lock);
+
+      if (done == NULL)
+        {
+          break;
+        }
+
+      SPI_LOCK(bus->spi, true);
+      for (req = done; req != NULL; req = req->flink)
+        {
+          req->result = spi_sequence(bus->spi, req->seq);
+        }
+
+      SPI_LOCK(bus->spi, false);
+
+      /* The callbacks run with the bus unlocked, they may start other
+       * transfers, synchronous or not.
+       */
+
+      while (done != NULL)
+        {
+          req  = done;
+          done = req->flink;
+          req->callback(req);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_transfer
+ *
+ * Description:
+ *   This is a helper function that can be used to encapsulate and manage
+ *   a sequence of SPI transfers.  The SPI bus will be locked and the
+ *   SPI device selected for the duration of the transfers.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfer
+ *   seq - Describes the sequence of transfers.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq)
+{
+  int ret;
+
+  DEBUGASSERT(spi != NULL && seq != NULL && seq->trans != NULL);
+
+  /* Get exclusive access to the SPI bus */
+
+  SPI_LOCK(spi, true);
+  ret = spi_sequence(spi, seq);
   SPI_LOCK(spi, false);
   return ret;
 }
 
+#ifdef CONFIG_SPI_ASYNC
+/****************************************************************************
+ * Name: spi_async_submit
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return without waiting for them.
+ *   The queued sequences of a bus are performed back-to-back, in order,
+ *   and req->callback() is called with req->result set once a sequence is
+ *   done.
+ *
+ *   When the lower half provides the submit() method, the request goes to
+ *   it: it chains the DMA of the queued sequences and may call the
+ *   callback from its interrupt handler.  Otherwise they are performed by
+ *   the work queue, where the callback is called too.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfer
+ *   req - Describes the transfers and the callback.  It belongs to the SPI
+ *         bus until the callback is called.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_async_submit(FAR struct spi_dev_s *spi, FAR struct spi_async_s *req)
+{
+  FAR struct spi_async_bus_s *bus;
+  bool idle;
+
+  DEBUGASSERT(spi != NULL && req != NULL && req->seq != NULL &&
+              req->seq->trans != NULL && req->callback != NULL);
+
+  req->flink = NULL;
+  if (spi->ops->submit != NULL)
+    {
+      return spi->ops->submit(spi, req);
+    }
+
+  nxmutex_lock(&g_spi_async_lock);
+
+  for (bus = g_spi_async_buses; bus != NULL; bus = bus->flink)
+    {
+      if (bus->spi == spi)
+        {
+          break;
+        }
+    }
+
+  if (bus == NULL)
+    {
+      bus = kmm_zalloc(sizeof(*bus));
+      if (bus == NULL)
+        {
+          nxmutex_unlock(&g_spi_async_lock);
+          return -ENOMEM;
+        }
+
+      bus->spi          = spi;
+      bus->flink        = g_spi_async_buses;
+      g_spi_async_buses = bus;
+    }
+
+  idle = bus->head == NULL;
+  if (idle)
+    {
+      bus->head = req;
+    }
+  else
+    {
+      bus->tail->flink = req;
+    }
+
+  bus->tail = req;
+
+  /* Start the worker unless the queue already had requests for it */
+
+  if (idle)
+    {
+      work_queue(SPI_ASYNC_WORK, &bus->work, spi_async_worker, bus, 0);
+    }
+
+  nxmutex_unlock(&g_spi_async_lock);
+  return OK;
+}
+#endif
+
 #endif /* CONFIG_SPI_EXCHANGE */
@@ -27,14 +27,40 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <time.h>
 
 /****************************************************************************
- * Public Data
+ * Public Types
  ****************************************************************************/
 
 #ifndef __ASSEMBLY__
 
+/* When and by whom a message was logged, for the prefix of the message */
+
+struct syslog_stamp_s
+{
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec ts;        /* Time of the message */
+#endif
+#ifdef CONFIG_SMP
+  int cpu;                   /* CPU that logged the message */
+#endif
+  pid_t pid;                 /* Thread that logged the message */
+};
+
+/* Formats the body of a message to the stream */
+
+struct lib_outstream_s;
+typedef CODE int (*syslog_body_t)(FAR struct lib_outstream_s *stream,
+                                  FAR void *arg);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
 #ifdef __cplusplus
 #define EXTERN extern "C"
 extern "C"
@@ -224,6 +250,76 @@ int syslog_add_intbuffer(int ch);
 int syslog_flush_intbuffer(bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_stamp
+ *
+ * Description:
+ *   Record the time, CPU and thread of a message being logged.
+ *
+ ****************************************************************************/
+
+void syslog_stamp(FAR struct syslog_stamp_s *stamp);
+
+/****************************************************************************
+ * Name: syslog_format
+ *
+ * Description:
+ *   Write one message to the SYSLOG channels with the configured prefix.
+ *
+ * Input Parameters:
+ *   priority - The priority of the message
+ *   stamp    - When and by whom the message was logged
+ *   body     - Formats the body of the message
+ *   arg      - The argument of 'body'
+ *
+ * Returned Value:
+ *   The number of characters written.
+ *
+ ****************************************************************************/
+
+int syslog_format(int priority, FAR const struct syslog_stamp_s *stamp,
+                  syslog_body_t body, FAR void *arg);
+
+/****************************************************************************
+ * Name: syslog_defer
+ *
+ * Description:
+ *   Store the format string and the arguments of a message in the ring of
+ *   this CPU and leave the formatting to the SYSLOG worker.
+ *
+ * Input Parameters:
+ *   priority - The priority of the message
+ *   stamp    - When and by whom the message was logged
+ *   fmt      - The format string, which must stay valid
+ *   ap       - The arguments of the format string
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was deferred, or dropped because the ring was
+ *   full.  A negated errno value if it must be formatted at once.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_defer(int priority, FAR const struct syslog_stamp_s *stamp,
+                 FAR const IPTR char *fmt, FAR va_list *ap);
+#endif
+
+/****************************************************************************
+ * Name: syslog_defer_flush
+ *
+ * Description:
+ *   Format and write the messages that are waiting in the rings.
+ *
+ * Input Parameters:
+ *   force - Drain the rings even if the SYSLOG worker is draining them,
+ *           as this is done on a crash.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+void syslog_defer_flush(bool force);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,855 @@
+/****************************************************************************
+ * drivers/syslog/syslog_defer.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <syslog.h>
+#include <errno.h>
+
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/streams.h>
+#include <nuttx/wqueue.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define SYSLOG_DEFER_WORK      LPWORK
+#else
+#  define SYSLOG_DEFER_WORK      HPWORK
+#endif
+
+/* The rings are made of argument slots, records are aligned to them */
+
+#define SYSLOG_DEFER_SLOT        sizeof(union syslog_defer_arg_u)
+#define SYSLOG_DEFER_NSLOTS      (CONFIG_SYSLOG_DEFERRED_BUFSIZE / \
+                                  SYSLOG_DEFER_SLOT)
+#define SYSLOG_DEFER_BUFSIZE     (SYSLOG_DEFER_NSLOTS * SYSLOG_DEFER_SLOT)
+#define SYSLOG_DEFER_ALIGN(n)    (((n) + SYSLOG_DEFER_SLOT - 1) & \
+                                  ~(SYSLOG_DEFER_SLOT - 1))
+#define SYSLOG_DEFER_HDRSIZE     \
+  SYSLOG_DEFER_ALIGN(sizeof(struct syslog_defer_s))
+#define SYSLOG_DEFER_MSGSIZE     \
+  MIN(CONFIG_SYSLOG_DEFERRED_MSGSIZE, SYSLOG_DEFER_BUFSIZE / 2)
+
+/* The priority of the record that fills the end of a ring before it
+ * wraps.
+ */
+
+#define SYSLOG_DEFER_PAD         UINT8_MAX
+
+/* The width and/or the precision of a conversion come from arguments */
+
+#define SYSLOG_DEFER_STAR_WIDTH  (1 << 0)
+#define SYSLOG_DEFER_STAR_PREC   (1 << 1)
+
+#define SYSLOG_DEFER_SPECLEN     32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The arguments are saved promoted to the widest type of their class.  A
+ * string is saved as its length in a slot, followed by its characters.
+ */
+
+union syslog_defer_arg_u
+{
+  uintmax_t i;
+  double d;
+  FAR void *p;
+};
+
+/* A message in a ring, followed by its arguments */
+
+struct syslog_defer_s
+{
+  uint16_t len;                   /* Size of the record, aligned */
+  uint8_t priority;               /* Priority, or SYSLOG_DEFER_PAD */
+  struct syslog_stamp_s stamp;    /* When and by whom it was logged */
+  FAR const IPTR char *fmt;       /* The format string */
+};
+
+/* The ring of one CPU.  Only that CPU writes messages to it, with its
+ * interrupts disabled, and only the SYSLOG worker reads them.
+ */
+
+struct syslog_ring_s
+{
+  volatile size_t head;           /* Next record to write, by the CPU */
+  volatile size_t tail;           /* Next record to read, by the worker */
+  volatile size_t dropped;        /* Messages dropped, by the CPU */
+  size_t reported;                /* Drops reported, by the worker */
+  union syslog_defer_arg_u buffer[SYSLOG_DEFER_NSLOTS];
+};
+
+enum syslog_defer_type_e
+{
+  SYSLOG_DEFER_PERCENT = 0,       /* "%%", no argument */
+  SYSLOG_DEFER_INT,               /* Signed integer */
+  SYSLOG_DEFER_UINT,              /* Unsigned integer */
+  SYSLOG_DEFER_CHAR,              /* Character */
+  SYSLOG_DEFER_STR,               /* String, copied */
+  SYSLOG_DEFER_PTR,               /* Pointer */
+  SYSLOG_DEFER_DOUBLE,            /* Floating point */
+  SYSLOG_DEFER_BAD                /* Cannot be deferred */
+};
+
+/* One conversion of a format string */
+
+struct syslog_defer_spec_s
+{
+  FAR const IPTR char *flags;     /* The flags, after the '%' */
+  FAR const IPTR char *width;     /* The width */
+  FAR const IPTR char *prec;      /* The precision, with its '.' */
+  FAR const IPTR char *end;       /* The length modifier */
+  uint8_t type;                   /* See enum syslog_defer_type_e */
+  uint8_t star;                   /* See SYSLOG_DEFER_STAR_* */
+  char length[3];                 /* The length modifier */
+  char conv;                      /* The conversion character */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_ring_s g_syslog_ring[CONFIG_SMP_NCPUS];
+static struct work_s g_syslog_work;
+static volatile bool g_syslog_draining;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_defer_parse
+ *
+ * Description:
+ *   Parse the conversion at *fmt, which points to its '%', and move *fmt
+ *   past it.
+ *
+ ****************************************************************************/
+
+static void syslog_defer_parse(FAR const IPTR char **fmt,
+                               FAR struct syslog_defer_spec_s *spec)
+{
+  FAR const IPTR char *ptr = *fmt + 1;
+  int n = 0;
+
+  memset(spec, 0, sizeof(*spec));
+
+  if (*ptr == '%')
+    {
+      spec->type = SYSLOG_DEFER_PERCENT;
+      *fmt = ptr + 1;
+      return;
+    }
+
+  spec->flags = ptr;
+  while (*ptr != '\0' && strchr("-+ #0'", *ptr) != NULL)
+    {
+      ptr++;
+    }
+
+  spec->width = ptr;
+  if (*ptr == '*')
+    {
+      spec->star |= SYSLOG_DEFER_STAR_WIDTH;
+      ptr++;
+    }
+  else
+    {
+      while (isdigit(*ptr))
+        {
+          ptr++;
+        }
+    }
+
+  spec->prec = ptr;
+  if (*ptr == '.')
+    {
+      if (*++ptr == '*')
+        {
+          spec->star |= SYSLOG_DEFER_STAR_PREC;
+          ptr++;
+        }
+      else
+        {
+          while (isdigit(*ptr))
+            {
+              ptr++;
+            }
+        }
+    }
+
+  spec->end = ptr;
+  while (n < 2 && *ptr != '\0' && strchr("hljztLq", *ptr) != NULL)
+    {
+      spec->length[n++] = *ptr++;
+    }
+
+  spec->conv = *ptr;
+  switch (spec->conv)
+    {
+      case 'd':
+      case 'i':
+        spec->type = SYSLOG_DEFER_INT;
+        break;
+
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+        spec->type = SYSLOG_DEFER_UINT;
+        break;
+
+      case 'c':
+        spec->type = n == 0 ? SYSLOG_DEFER_CHAR : SYSLOG_DEFER_BAD;
+        break;
+
+      case 's':
+        spec->type = n == 0 ? SYSLOG_DEFER_STR : SYSLOG_DEFER_BAD;
+        break;
+
+      case 'p':
+
+        /* The %p extensions, like %pV, read through the pointer */
+
+        spec->type = n == 0 && !isalpha(ptr[1]) ?
+                     SYSLOG_DEFER_PTR : SYSLOG_DEFER_BAD;
+        break;
+
+      case 'a':
+      case 'A':
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'F':
+      case 'g':
+      case 'G':
+        spec->type = SYSLOG_DEFER_DOUBLE;
+        break;
+
+      default:
+
+        /* %n writes through its argument, and is the end of an invalid
+         * format string.
+         */
+
+        spec->type = SYSLOG_DEFER_BAD;
+        break;
+    }
+
+  *fmt = spec->conv != '\0' ? ptr + 1 : ptr;
+}
+
+/****************************************************************************
+ * Name: syslog_defer_fetch
+ *
+ * Description:
+ *   Fetch the value of the conversion from the argument list.
+ *
+ ****************************************************************************/
+
+static void syslog_defer_fetch(FAR const struct syslog_defer_spec_s *spec,
+                               FAR union syslog_defer_arg_u *arg,
+                               va_list *ap)
+{
+  FAR const char *len = spec->length;
+
+  switch (spec->type)
+    {
+      case SYSLOG_DEFER_INT:
+        if (strcmp(len, "hh") == 0)
+          {
+            arg->i = (intmax_t)(signed char)va_arg(*ap, int);
+          }
+        else if (len[0] == 'h')
+          {
+            arg->i = (intmax_t)(short)va_arg(*ap, int);
+          }
+        else if (strcmp(len, "ll") == 0 || len[0] == 'q')
+          {
+            arg->i = (intmax_t)va_arg(*ap, long long);
+          }
+        else if (len[0] == 'l')
+          {
+            arg->i = (intmax_t)va_arg(*ap, long);
+          }
+        else if (len[0] == 'j')
+          {
+            arg->i = (uintmax_t)va_arg(*ap, intmax_t);
+          }
+        else if (len[0] == 'z')
+          {
+            arg->i = (intmax_t)va_arg(*ap, ssize_t);
+          }
+        else if (len[0] == 't')
+          {
+            arg->i = (intmax_t)va_arg(*ap, ptrdiff_t);
+          }
+        else
+          {
+            arg->i = (intmax_t)va_arg(*ap, int);
+          }
+        break;
+
+      case SYSLOG_DEFER_UINT:
+        if (strcmp(len, "hh") == 0)
+          {
+            arg->i = (unsigned char)va_arg(*ap, unsigned int);
+          }
+        else if (len[0] == 'h')
+          {
+            arg->i = (unsigned short)va_arg(*ap, unsigned int);
+          }
+        else if (strcmp(len, "ll") == 0 || len[0] == 'q')
+          {
+            arg->i = va_arg(*ap, unsigned long long);
+          }
+        else if (len[0] == 'l')
+          {
+            arg->i = va_arg(*ap, unsigned long);
+          }
+        else if (len[0] == 'j')
+          {
+            arg->i = va_arg(*ap, uintmax_t);
+          }
+        else if (len[0] == 'z')
+          {
+            arg->i = va_arg(*ap, size_t);
+          }
+        else if (len[0] == 't')
+          {
+            arg->i = (uintmax_t)va_arg(*ap, ptrdiff_t);
+          }
+        else
+          {
+            arg->i = va_arg(*ap, unsigned int);
+          }
+        break;
+
+      case SYSLOG_DEFER_CHAR:
+        arg->i = (intmax_t)va_arg(*ap, int);
+        break;
+
+      case SYSLOG_DEFER_PTR:
+      case SYSLOG_DEFER_STR:
+        arg->p = va_arg(*ap, FAR void *);
+        break;
+
+      case SYSLOG_DEFER_DOUBLE:
+        if (len[0] == 'L')
+          {
+            arg->d = (double)va_arg(*ap, long double);
+          }
+        else
+          {
+            arg->d = va_arg(*ap, double);
+          }
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_defer_pack
+ *
+ * Description:
+ *   Save a message and its arguments to 'rec', writing no more than
+ *   'limit' bytes.
+ *
+ * Returned Value:
+ *   The size of the record, which was only written if it is no larger
+ *   than 'limit'.  A negated errno value if the message cannot be
+ *   deferred.
+ *
+ ****************************************************************************/
+
+static ssize_t syslog_defer_pack(FAR struct syslog_defer_s *rec,
+                                 size_t limit, int priority,
+                                 FAR const struct syslog_stamp_s *stamp,
+                                 FAR const IPTR char *fmt, va_list *ap)
+{
+  FAR union syslog_defer_arg_u *slot;
+  FAR const IPTR char *ptr = fmt;
+  struct syslog_defer_spec_s spec;
+  union syslog_defer_arg_u arg;
+  FAR const char *str;
+  size_t off = SYSLOG_DEFER_HDRSIZE;
+  size_t room;
+  size_t n;
+
+  while (*ptr != '\0')
+    {
+      if (*ptr++ != '%')
+        {
+          continue;
+        }
+
+      ptr--;
+      syslog_defer_parse(&ptr, &spec);
+      if (spec.type == SYSLOG_DEFER_PERCENT)
+        {
+          continue;
+        }
+      else if (spec.type == SYSLOG_DEFER_BAD)
+        {
+          return -ENOTSUP;
+        }
+
+      /* The width and the precision from arguments come first, then the
+       * value itself.
+       */
+
+      for (n = 0; n < 3; n++)
+        {
+          if (n == 0 && (spec.star & SYSLOG_DEFER_STAR_WIDTH) != 0)
+            {
+              arg.i = (intmax_t)va_arg(*ap, int);
+            }
+          else if (n == 1 && (spec.star & SYSLOG_DEFER_STAR_PREC) != 0)
+            {
+              arg.i = (intmax_t)va_arg(*ap, int);
+            }
+          else if (n == 2)
+            {
+              syslog_defer_fetch(&spec, &arg, ap);
+            }
+          else
+            {
+              continue;
+            }
+
+          if (off + SYSLOG_DEFER_SLOT > SYSLOG_DEFER_MSGSIZE)
+            {
+              return -E2BIG;
+            }
+
+          slot = (FAR union syslog_defer_arg_u *)((FAR uint8_t *)rec + off);
+          off += SYSLOG_DEFER_SLOT;
+
+          if (n < 2 || spec.type != SYSLOG_DEFER_STR)
+            {
+              if (off <= limit)
+                {
+                  *slot = arg;
+                }
+
+              continue;
+            }
+
+          /* Copy the string, the caller may free it once we return.  It is
+           * truncated to what fits into a record.
+           */
+
+          str  = arg.p != NULL ? (FAR const char *)arg.p : "(null)";
+          room = SYSLOG_DEFER_MSGSIZE - off;
+          if (room == 0)
+            {
+              return -E2BIG;
+            }
+
+          n = strnlen(str, room - 1);
+          if (off + n + 1 <= limit)
+            {
+              slot->i = n;
+              memcpy(slot + 1, str, n);
+              ((FAR char *)(slot + 1))[n] = '\0';
+            }
+
+          off += SYSLOG_DEFER_ALIGN(n + 1);
+          break;
+        }
+    }
+
+  if (off <= limit)
+    {
+      rec->len      = off;
+      rec->priority = priority;
+      rec->stamp    = *stamp;
+      rec->fmt      = fmt;
+    }
+
+  return off;
+}
+
+/****************************************************************************
+ * Name: syslog_defer_body
+ *
+ * Description:
+ *   Format the body of a deferred message from its saved arguments.
+ *
+ ****************************************************************************/
+
+static int syslog_defer_body(FAR struct lib_outstream_s *stream,
+                             FAR void *arg)
+{
+  FAR struct syslog_defer_s *rec = arg;
+  FAR const union syslog_defer_arg_u *slot;
+  FAR const IPTR char *fmt = rec->fmt;
+  struct syslog_defer_spec_s spec;
+  char buf[SYSLOG_DEFER_SPECLEN];
+  char width[12];
+  char prec[13];
+  int ret = 0;
+
+  slot = (FAR const union syslog_defer_arg_u *)
+         ((FAR uint8_t *)rec + SYSLOG_DEFER_HDRSIZE);
+
+  while (*fmt != '\0')
+    {
+      if (*fmt != '%')
+        {
+          lib_stream_putc(stream, *fmt++);
+          ret++;
+          continue;
+        }
+
+      syslog_defer_parse(&fmt, &spec);
+      if (spec.type == SYSLOG_DEFER_PERCENT)
+        {
+          lib_stream_putc(stream, '%');
+          ret++;
+          continue;
+        }
+
+      /* Rebuild the conversion with the width and the precision that were
+       * passed as arguments, and the integers as wide as they were saved.
+       */
+
+      if ((spec.star & SYSLOG_DEFER_STAR_WIDTH) != 0)
+        {
+          snprintf(width, sizeof(width), "%d", (int)(slot++)->i);
+        }
+      else
+        {
+          snprintf(width, sizeof(width), "%.*s",
+                   (int)(spec.prec - spec.width), spec.width);
+        }
+
+      if ((spec.star & SYSLOG_DEFER_STAR_PREC) == 0)
+        {
+          snprintf(prec, sizeof(prec), "%.*s",
+                   (int)(spec.end - spec.prec), spec.prec);
+        }
+      else if ((int)slot->i >= 0)
+        {
+          snprintf(prec, sizeof(prec), ".%d", (int)(slot++)->i);
+        }
+      else
+        {
+          prec[0] = '\0';
+          slot++;
+        }
+
+      snprintf(buf, sizeof(buf), "%%%.*s%s%s%s%c",
+               (int)(spec.width - spec.flags), spec.flags, width, prec,
+               spec.type == SYSLOG_DEFER_INT ||
+               spec.type == SYSLOG_DEFER_UINT ? "j" : "", spec.conv);
+
+      switch (spec.type)
+        {
+          case SYSLOG_DEFER_INT:
+            ret += lib_sprintf_internal(stream, buf, (intmax_t)slot->i);
+            break;
+
+          case SYSLOG_DEFER_UINT:
+            ret += lib_sprintf_internal(stream, buf, slot->i);
+            break;
+
+          case SYSLOG_DEFER_CHAR:
+            ret += lib_sprintf_internal(stream, buf, (int)slot->i);
+            break;
+
+          case SYSLOG_DEFER_PTR:
+            ret += lib_sprintf_internal(stream, buf, slot->p);
+            break;
+
+          case SYSLOG_DEFER_DOUBLE:
+            ret += lib_sprintf_internal(stream, buf, slot->d);
+            break;
+
+          case SYSLOG_DEFER_STR:
+            ret += lib_sprintf_internal(stream, buf,
+                                        (FAR const char *)(slot + 1));
+            slot += SYSLOG_DEFER_ALIGN(slot->i + 1) / SYSLOG_DEFER_SLOT;
+            break;
+        }
+
+      slot++;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: syslog_defer_dropped
+ *
+ * Description:
+ *   Format the notice of the messages that were dropped.
+ *
+ ****************************************************************************/
+
+static int syslog_defer_dropped(FAR struct lib_outstream_s *stream,
+                                FAR void *arg)
+{
+  return lib_sprintf_internal(stream, "[%zu messages dropped]",
+                              *(FAR size_t *)arg);
+}
+
+/****************************************************************************
+ * Name: syslog_defer_drain
+ *
+ * Description:
+ *   Format and write the messages of all of the rings.
+ *
+ ****************************************************************************/
+
+static void syslog_defer_drain(void)
+{
+  FAR struct syslog_ring_s *ring;
+  FAR struct syslog_defer_s *rec;
+  struct syslog_stamp_s stamp;
+  size_t dropped;
+  size_t tail;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      ring = &g_syslog_ring[cpu];
+
+      dropped = ring->dropped - ring->reported;
+      if (dropped != 0)
+        {
+          ring->reported += dropped;
+          syslog_stamp(&stamp);
+          syslog_format(LOG_WARNING, &stamp, syslog_defer_dropped,
+                        &dropped);
+        }
+
+      while ((tail = ring->tail) != ring->head)
+        {
+          /* Read the record only after its head was published */
+
+          SEQ_DMB();
+
+          rec = (FAR struct syslog_defer_s *)
+                ((FAR uint8_t *)ring->buffer + tail);
+          if (rec->priority == SYSLOG_DEFER_PAD)
+            {
+              tail = 0;
+            }
+          else
+            {
+              syslog_format(rec->priority, &rec->stamp,
+                            syslog_defer_body, rec);
+              tail = (tail + rec->len) % SYSLOG_DEFER_BUFSIZE;
+            }
+
+          /* And give it back to the CPU once it was formatted */
+
+          SEQ_DMB();
+          ring->tail = tail;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_defer_worker
+ ****************************************************************************/
+
+static void syslog_defer_worker(FAR void *arg)
+{
+  syslog_defer_flush(false);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_defer
+ *
+ * Description:
+ *   Store the format string and the arguments of a message in the ring of
+ *   this CPU and leave the formatting to the SYSLOG worker.  The messages
+ *   more urgent than LOG_ERR, and those logged before the work queues run,
+ *   are not deferred.
+ *
+ ****************************************************************************/
+
+int syslog_defer(int priority, FAR const struct syslog_stamp_s *stamp,
+                 FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  FAR struct syslog_ring_s *ring;
+  FAR struct syslog_defer_s *rec;
+  irqstate_t flags;
+  ssize_t len;
+  size_t limit;
+  size_t head;
+  size_t tail;
+  va_list copy;
+
+  if (priority < LOG_ERR || priority >= SYSLOG_DEFER_PAD ||
+      !OSINIT_OS_READY())
+    {
+      return -EPERM;
+    }
+
+  /* Nothing but the SYSLOG worker touches the ring of this CPU while its
+   * interrupts are disabled.
+   */
+
+  flags = up_irq_save();
+  ring  = &g_syslog_ring[up_cpu_index()];
+  head  = ring->head;
+  tail  = ring->tail;
+
+  /* Do not write over a record before the worker is done with it */
+
+  SEQ_DMB();
+
+  /* How much contiguous space there is at the head, keeping one slot free
+   * so that a full ring does not look empty.
+   */
+
+  if (tail > head)
+    {
+      limit = tail - head - SYSLOG_DEFER_SLOT;
+    }
+  else
+    {
+      limit = SYSLOG_DEFER_BUFSIZE - head - (tail == 0 ?
+                                             SYSLOG_DEFER_SLOT : 0);
+    }
+
+  rec = (FAR struct syslog_defer_s *)((FAR uint8_t *)ring->buffer + head);
+  va_copy(copy, *ap);
+  len = syslog_defer_pack(rec, limit, priority, stamp, fmt, &copy);
+  va_end(copy);
+
+  if (len < 0)
+    {
+      up_irq_restore(flags);
+      return len;
+    }
+
+  if ((size_t)len > limit)
+    {
+      /* Fill the end of the ring and start over at its beginning, if the
+       * record fits there.
+       */
+
+      if (tail > head || tail < (size_t)len + SYSLOG_DEFER_SLOT)
+        {
+          ring->dropped++;
+          up_irq_restore(flags);
+          return OK;
+        }
+
+      rec->len      = SYSLOG_DEFER_BUFSIZE - head;
+      rec->priority = SYSLOG_DEFER_PAD;
+
+      rec = (FAR struct syslog_defer_s *)ring->buffer;
+      va_copy(copy, *ap);
+      len = syslog_defer_pack(rec, len, priority, stamp, fmt, &copy);
+      va_end(copy);
+      head = 0;
+    }
+
+  /* Publish the record once it is complete */
+
+  SEQ_DMB();
+  ring->head = (head + len) % SYSLOG_DEFER_BUFSIZE;
+  up_irq_restore(flags);
+
+  if (work_available(&g_syslog_work))
+    {
+      work_queue(SYSLOG_DEFER_WORK, &g_syslog_work, syslog_defer_worker,
+                 NULL, 0);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_defer_flush
+ *
+ * Description:
+ *   Format and write the messages that are waiting in the rings.  Unless
+ *   forced, they are left to whoever is draining the rings already.
+ *
+ ****************************************************************************/
+
+void syslog_defer_flush(bool force)
+{
+  irqstate_t flags;
+  int cpu;
+
+  flags = enter_critical_section();
+  if (g_syslog_draining && !force)
+    {
+      leave_critical_section(flags);
+      return;
+    }
+
+  g_syslog_draining = true;
+  leave_critical_section(flags);
+
+  syslog_defer_drain();
+  g_syslog_draining = false;
+
+  /* Come back for the messages that were stored while another drainer
+   * had the rings.
+   */
+
+  if (!force && work_available(&g_syslog_work))
+    {
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          if (g_syslog_ring[cpu].head != g_syslog_ring[cpu].tail)
+            {
+              work_queue(SYSLOG_DEFER_WORK, &g_syslog_work,
+                         syslog_defer_worker, NULL, 0);
+              break;
+            }
+        }
+    }
+}
+
+#endif /* CONFIG_SYSLOG_DEFERRED */
@@ -34,9 +34,19 @@
 #include <string.h>
 #include <sys/types.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/lib/lib.h>
 #include <nuttx/syslog/syslog.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+
+#ifdef CONFIG_SYSLOG_FILE_LZ4
+#  include <lz4.h>
+#endif
 
 #include "syslog.h"
 
@@ -49,6 +59,59 @@
 #define OPEN_FLAGS (O_WRONLY | O_CREAT | O_APPEND)
 #define OPEN_MODE  (S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR)
 
+#ifdef CONFIG_SYSLOG_FILE_BATCH
+#  ifdef CONFIG_SCHED_LPWORK
+#    define SYSLOG_FILE_WORK LPWORK
+#  else
+#    define SYSLOG_FILE_WORK HPWORK
+#  endif
+
+#  define SYSLOG_FILE_BUFSIZE CONFIG_SYSLOG_FILE_BATCH_SIZE
+#  define SYSLOG_FILE_DELAY   MSEC2TICK(CONFIG_SYSLOG_FILE_BATCH_INTERVAL)
+
+/* The buffer is written early once it is three quarters full, so that it
+ * is seldom full when a task logs to it.
+ */
+
+#  define SYSLOG_FILE_KICK    (SYSLOG_FILE_BUFSIZE - SYSLOG_FILE_BUFSIZE / 4)
+
+/* A compressed buffer is written as the "LZ4B" magic, the size of the
+ * data and the size of the block, both 32-bit little-endian, and the
+ * block.  A block as long as the data holds the data uncompressed.
+ */
+
+#  define SYSLOG_FILE_HDRSIZE 12
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_FILE_BATCH
+/* The output is collected in one buffer while the other is written */
+
+struct syslog_file_s
+{
+  struct syslog_channel_s channel;
+
+  mutex_t       sf_lock;      /* Serializes the writes to the file */
+  struct work_s sf_work;      /* Delayed write of the buffer */
+  struct file   sf_file;      /* The log file, while sf_opened */
+  bool          sf_opened;    /* The log file is open */
+  uint8_t       sf_active;    /* The buffer that collects the output */
+  size_t        sf_len[2];    /* Bytes in each buffer */
+#if CONFIG_SYSLOG_FILE_ROTATIONS > 0
+  off_t         sf_size;      /* Size of the log file */
+#endif
+  FAR char     *sf_path;      /* Path of the log file */
+  char          sf_buf[2][SYSLOG_FILE_BUFSIZE];
+#ifdef CONFIG_SYSLOG_FILE_LZ4
+  lz4_state_t   sf_htab;      /* Working memory of lz4_compress() */
+  uint8_t       sf_zbuf[SYSLOG_FILE_HDRSIZE + SYSLOG_FILE_BUFSIZE];
+#endif
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -125,6 +188,336 @@ end:
 }
 #endif
 
+#ifdef CONFIG_SYSLOG_FILE_BATCH
+
+/****************************************************************************
+ * Name: syslog_file_output
+ *
+ * Description:
+ *   Write one buffer to the log file, opening it first if needed, and
+ *   rotate the log once it grew past the size limit.  The file is opened
+ *   again on the next write if anything failed, as it may be on a file
+ *   system that is not mounted yet.
+ *
+ ****************************************************************************/
+
+static void syslog_file_output(FAR struct syslog_file_s *sf,
+                               FAR const char *buf, size_t len)
+{
+  ssize_t nwritten;
+#if CONFIG_SYSLOG_FILE_ROTATIONS > 0
+  struct stat st;
+#endif
+#ifdef CONFIG_SYSLOG_FILE_LZ4
+  FAR uint8_t *hdr = sf->sf_zbuf;
+  unsigned int zlen;
+  int i;
+#endif
+
+  if (!sf->sf_opened)
+    {
+      if (file_open(&sf->sf_file, sf->sf_path, OPEN_FLAGS, OPEN_MODE) < 0)
+        {
+          return;
+        }
+
+      sf->sf_opened = true;
+#if CONFIG_SYSLOG_FILE_ROTATIONS > 0
+      sf->sf_size   = file_fstat(&sf->sf_file, &st) < 0 ? 0 : st.st_size;
+#endif
+    }
+
+#ifdef CONFIG_SYSLOG_FILE_LZ4
+  /* Keep the data as it is if it does not shrink */
+
+  zlen = lz4_compress(buf, len, hdr + SYSLOG_FILE_HDRSIZE, len - 1,
+                      sf->sf_htab);
+  if (zlen == 0)
+    {
+      memcpy(hdr + SYSLOG_FILE_HDRSIZE, buf, len);
+      zlen = len;
+    }
+
+  memcpy(hdr, "LZ4B", 4);
+  for (i = 0; i < 4; i++)
+    {
+      hdr[4 + i] = (uint8_t)(len >> (8 * i));
+      hdr[8 + i] = (uint8_t)(zlen >> (8 * i));
+    }
+
+  buf = (FAR const char *)hdr;
+  len = SYSLOG_FILE_HDRSIZE + zlen;
+#endif
+
+  nwritten = file_write(&sf->sf_file, buf, len);
+  if (nwritten < 0)
+    {
+      file_close(&sf->sf_file);
+      sf->sf_opened = false;
+      return;
+    }
+
+#if CONFIG_SYSLOG_FILE_ROTATIONS > 0
+  sf->sf_size += nwritten;
+  if (sf->sf_size >= CONFIG_SYSLOG_FILE_SIZE_LIMIT)
+    {
+      file_close(&sf->sf_file);
+      sf->sf_opened = false;
+      log_rotate(sf->sf_path);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: syslog_file_drain
+ *
+ * Description:
+ *   Swap the buffers and write the one that collected the output.  The
+ *   output goes to the other buffer meanwhile.
+ *
+ ****************************************************************************/
+
+static int syslog_file_drain(FAR struct syslog_file_s *sf, bool sync)
+{
+  irqstate_t flags;
+  uint8_t index;
+  int ret;
+
+  /* The file system may log while we write, that output stays in the
+   * active buffer.
+   */
+
+  if (nxmutex_is_hold(&sf->sf_lock))
+    {
+      return -EWOULDBLOCK;
+    }
+
+  ret = nxmutex_lock(&sf->sf_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  flags         = enter_critical_section();
+  index         = sf->sf_active;
+  sf->sf_active = !index;
+  leave_critical_section(flags);
+
+  if (sf->sf_len[index] > 0)
+    {
+      syslog_file_output(sf, sf->sf_buf[index], sf->sf_len[index]);
+      sf->sf_len[index] = 0;
+    }
+
+  if (sync && sf->sf_opened)
+    {
+      file_fsync(&sf->sf_file);
+    }
+
+  nxmutex_unlock(&sf->sf_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_file_worker
+ ****************************************************************************/
+
+static void syslog_file_worker(FAR void *arg)
+{
+  syslog_file_drain(arg, false);
+}
+
+/****************************************************************************
+ * Name: syslog_file_append
+ *
+ * Description:
+ *   Copy as much of the output as fits to the active buffer, each line
+ *   feed becomes a CR-LF sequence as on the device channel.  The buffer is
+ *   written by the worker after the flush interval, or earlier once it is
+ *   mostly full.  This may be called from an interrupt handler.
+ *
+ * Returned Value:
+ *   The number of bytes of buffer that were consumed.
+ *
+ ****************************************************************************/
+
+static size_t syslog_file_append(FAR struct syslog_file_s *sf,
+                                 FAR const char *buffer, size_t buflen)
+{
+  FAR char *buf;
+  irqstate_t flags;
+  size_t start;
+  size_t len;
+  size_t i;
+
+  flags = enter_critical_section();
+  buf   = sf->sf_buf[sf->sf_active];
+  start = sf->sf_len[sf->sf_active];
+
+  for (i = 0, len = start; i < buflen; i++)
+    {
+      if (buffer[i] == '\n')
+        {
+          if (len + 2 > SYSLOG_FILE_BUFSIZE)
+            {
+              break;
+            }
+
+          buf[len++] = '\r';
+          buf[len++] = '\n';
+        }
+      else if (buffer[i] != '\r')
+        {
+          if (len >= SYSLOG_FILE_BUFSIZE)
+            {
+              break;
+            }
+
+          buf[len++] = buffer[i];
+        }
+    }
+
+  sf->sf_len[sf->sf_active] = len;
+
+  if (start < SYSLOG_FILE_KICK && len >= SYSLOG_FILE_KICK)
+    {
+      work_queue(SYSLOG_FILE_WORK, &sf->sf_work, syslog_file_worker,
+                 sf, 0);
+    }
+  else if (start == 0 && len > 0 && work_available(&sf->sf_work))
+    {
+      work_queue(SYSLOG_FILE_WORK, &sf->sf_work, syslog_file_worker,
+                 sf, SYSLOG_FILE_DELAY);
+    }
+
+  leave_critical_section(flags);
+  return i;
+}
+
+/****************************************************************************
+ * Name: syslog_file_write
+ *
+ * Description:
+ *   Buffer the output.  A task writes the buffer itself when it is full,
+ *   the output that does not fit is lost in an interrupt handler.
+ *
+ ****************************************************************************/
+
+static ssize_t syslog_file_write(FAR struct syslog_channel_s *channel,
+                                 FAR const char *buffer, size_t buflen)
+{
+  FAR struct syslog_file_s *sf = (FAR struct syslog_file_s *)channel;
+  size_t nwritten = 0;
+
+  for (; ; )
+    {
+      nwritten += syslog_file_append(sf, buffer + nwritten,
+                                     buflen - nwritten);
+      if (nwritten == buflen || up_interrupt_context() ||
+          sched_idletask() || syslog_file_drain(sf, false) < 0)
+        {
+          break;
+        }
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: syslog_file_putc
+ ****************************************************************************/
+
+static int syslog_file_putc(FAR struct syslog_channel_s *channel, int ch)
+{
+  char tmp = ch;
+
+  syslog_file_write(channel, &tmp, 1);
+  return ch;
+}
+
+/****************************************************************************
+ * Name: syslog_file_flush
+ ****************************************************************************/
+
+static int syslog_file_flush(FAR struct syslog_channel_s *channel)
+{
+  if (!up_interrupt_context() && !sched_idletask())
+    {
+      syslog_file_drain((FAR struct syslog_file_s *)channel, true);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_file_close
+ ****************************************************************************/
+
+static void syslog_file_close(FAR struct syslog_channel_s *channel)
+{
+  FAR struct syslog_file_s *sf = (FAR struct syslog_file_s *)channel;
+
+  work_cancel(SYSLOG_FILE_WORK, &sf->sf_work);
+
+  /* Write both buffers, one may be left from a write that was running */
+
+  syslog_file_drain(sf, false);
+  syslog_file_drain(sf, true);
+
+  nxmutex_lock(&sf->sf_lock);
+  if (sf->sf_opened)
+    {
+      file_close(&sf->sf_file);
+    }
+
+  nxmutex_unlock(&sf->sf_lock);
+  nxmutex_destroy(&sf->sf_lock);
+  lib_free(sf->sf_path);
+  kmm_free(sf);
+}
+
+static const struct syslog_channel_ops_s g_syslog_file_ops =
+{
+  syslog_file_putc,
+  syslog_file_putc,
+  syslog_file_flush,
+  syslog_file_write,
+  syslog_file_write,
+  syslog_file_close
+};
+
+/****************************************************************************
+ * Name: syslog_file_initialize
+ *
+ * Description:
+ *   Create a batched file channel.  The file is opened by the first write.
+ *
+ ****************************************************************************/
+
+static FAR struct syslog_channel_s *
+syslog_file_initialize(FAR const char *devpath)
+{
+  FAR struct syslog_file_s *sf;
+
+  sf = kmm_zalloc(sizeof(struct syslog_file_s));
+  if (sf == NULL)
+    {
+      return NULL;
+    }
+
+  sf->sf_path = strdup(devpath);
+  if (sf->sf_path == NULL)
+    {
+      kmm_free(sf);
+      return NULL;
+    }
+
+  nxmutex_init(&sf->sf_lock);
+  sf->channel.sc_ops = &g_syslog_file_ops;
+  return &sf->channel;
+}
+#endif /* CONFIG_SYSLOG_FILE_BATCH */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -152,6 +545,10 @@ end:
  *   NOTE interrupt level SYSLOG output will be lost in this case unless
  *   the interrupt buffer is used.
  *
+ *   With CONFIG_SYSLOG_FILE_BATCH the output is buffered instead and
+ *   written in large blocks from the work queue, interrupt level output
+ *   included.
+ *
  * Input Parameters:
  *   devpath - The full path to the file to be used for SYSLOG output.
  *     This may be an existing file or not.  If the file exists,
@@ -192,7 +589,11 @@ FAR struct syslog_channel_s *syslog_file_channel(FAR const char *devpath)
 
   /* Then initialize the file interface */
 
+#ifdef CONFIG_SYSLOG_FILE_BATCH
+  file_channel = syslog_file_initialize(devpath);
+#else
   file_channel = syslog_dev_initialize(devpath, OPEN_FLAGS, OPEN_MODE);
+#endif
   if (file_channel == NULL)
     {
       goto errout_with_lock;
@@ -204,7 +605,7 @@ FAR struct syslog_channel_s *syslog_file_channel(FAR const char *devpath)
 
   if (syslog_channel(file_channel) != OK)
     {
-      syslog_dev_uninitialize(file_channel);
+      file_channel->sc_ops->sc_close(file_channel);
       file_channel = NULL;
     }
 
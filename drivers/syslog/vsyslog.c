@@ -63,50 +63,53 @@ static FAR const char * const g_priority_str[] =
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Private Types
  ****************************************************************************/
 
+struct syslog_vformat_s
+{
+  FAR const IPTR char *fmt;
+  FAR va_list *ap;
+};
+
 /****************************************************************************
- * Name: nx_vsyslog
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_vformat
  *
  * Description:
- *   nx_vsyslog() handles the system logging system calls. It is functionally
- *   equivalent to vsyslog() except that (1) the per-process priority
- *   filtering has already been performed and the va_list parameter is
- *   passed by reference.  That is because the va_list is a structure in
- *   some compilers and passing of structures in the NuttX sycalls does
- *   not work.
+ *   Format the body of a message from its format string and va_list.
  *
  ****************************************************************************/
 
-int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+static int syslog_vformat(FAR struct lib_outstream_s *stream,
+                          FAR void *arg)
 {
-  struct lib_syslograwstream_s stream;
-  int ret = 0;
-#if CONFIG_TASK_NAME_SIZE > 0 && defined(CONFIG_SYSLOG_PROCESS_NAME)
-  FAR struct tcb_s *tcb = nxsched_get_tcb(nxsched_gettid());
-#endif
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  struct timespec ts;
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  struct tm tm;
-  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
-#  endif
-#endif
+  FAR struct syslog_vformat_s *vformat = arg;
 
-  /* Wrap the low-level output in a stream object and let lib_vsprintf
-   * do the work.
-   */
+  return lib_vsprintf_internal(stream, vformat->fmt, *vformat->ap);
+}
 
-  lib_syslograwstream_open(&stream);
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  ts.tv_sec = 0;
-  ts.tv_nsec = 0;
+/****************************************************************************
+ * Name: syslog_stamp
+ *
+ * Description:
+ *   Record when and by whom a message is logged, for the prefix of the
+ *   message.
+ *
+ ****************************************************************************/
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-  memset(&tm, 0, sizeof(tm));
-#  endif
+void syslog_stamp(FAR struct syslog_stamp_s *stamp)
+{
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  stamp->ts.tv_sec  = 0;
+  stamp->ts.tv_nsec = 0;
 
   /* Get the current time.  Since debug output may be generated very early
    * in the start-up sequence, hardware timer support may not yet be
@@ -118,31 +121,68 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_REALTIME)
       /* Use CLOCK_REALTIME if so configured */
 
-      clock_gettime(CLOCK_REALTIME, &ts);
+      clock_gettime(CLOCK_REALTIME, &stamp->ts);
 #  else
       /* Prefer monotonic when enabled, as it can be synchronized to
        * RTC with clock_resynchronize.
        */
 
-      clock_gettime(CLOCK_MONOTONIC, &ts);
+      clock_gettime(CLOCK_MONOTONIC, &stamp->ts);
 #  endif
+    }
+#endif
 
-      /* Prepend the message with the current time, if available */
+#ifdef CONFIG_SMP
+  stamp->cpu = up_cpu_index();
+#endif
+  stamp->pid = nxsched_gettid();
+}
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-#    if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
-      localtime_r(&ts.tv_sec, &tm);
-#    else
-      gmtime_r(&ts.tv_sec, &tm);
-#    endif
+/****************************************************************************
+ * Name: syslog_format
+ *
+ * Description:
+ *   Write one message to the SYSLOG channels: the configured prefix built
+ *   from 'stamp', then the body that 'body' formats, then the line end.
+ *
+ ****************************************************************************/
+
+int syslog_format(int priority, FAR const struct syslog_stamp_s *stamp,
+                  syslog_body_t body, FAR void *arg)
+{
+  struct lib_syslograwstream_s stream;
+  int ret = 0;
+#if CONFIG_TASK_NAME_SIZE > 0 && defined(CONFIG_SYSLOG_PROCESS_NAME)
+  FAR struct tcb_s *tcb = nxsched_get_tcb(stamp->pid);
+#endif
+#if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+  struct tm tm;
+  char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
+#endif
+
+  /* Wrap the low-level output in a stream object and let lib_vsprintf
+   * do the work.
+   */
+
+  lib_syslograwstream_open(&stream);
+
+#if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+  memset(&tm, 0, sizeof(tm));
+
+  /* Prepend the message with the current time, if available */
+
+  if (stamp->ts.tv_sec != 0 || stamp->ts.tv_nsec != 0)
+    {
+#  if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
+      localtime_r(&stamp->ts.tv_sec, &tm);
+#  else
+      gmtime_r(&stamp->ts.tv_sec, &tm);
 #  endif
     }
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   date_buf[0] = '\0';
   strftime(date_buf, CONFIG_SYSLOG_TIMESTAMP_BUFFER,
            CONFIG_SYSLOG_TIMESTAMP_FORMAT, &tm);
-#  endif
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT) || defined(CONFIG_SYSLOG_TIMESTAMP) || \
@@ -204,24 +244,24 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_TIMESTAMP
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
 #    if defined(CONFIG_SYSLOG_TIMESTAMP_FORMAT_MICROSECOND)
-                             , date_buf, ts.tv_nsec / NSEC_PER_USEC
+                             , date_buf, stamp->ts.tv_nsec / NSEC_PER_USEC
 #    else
                              , date_buf
 #    endif
 #  else
-                             , (uintmax_t)ts.tv_sec
-                             , ts.tv_nsec / NSEC_PER_USEC
+                             , (uintmax_t)stamp->ts.tv_sec
+                             , stamp->ts.tv_nsec / NSEC_PER_USEC
 #  endif
 #endif
 
 #if defined(CONFIG_SMP)
-                             , up_cpu_index()
+                             , stamp->cpu
 #endif
 
 #if defined(CONFIG_SYSLOG_PROCESSID)
   /* Prepend the Thread ID */
 
-                             , nxsched_gettid()
+                             , stamp->pid
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
@@ -253,7 +293,7 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 
   /* Generate the output */
 
-  ret += lib_vsprintf_internal(&stream.public, fmt, *ap);
+  ret += body(&stream.public, arg);
 
   if (stream.last_ch != '\n')
     {
@@ -272,3 +312,43 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
   lib_syslograwstream_close(&stream);
   return ret;
 }
+
+/****************************************************************************
+ * Name: nx_vsyslog
+ *
+ * Description:
+ *   nx_vsyslog() handles the system logging system calls. It is functionally
+ *   equivalent to vsyslog() except that (1) the per-process priority
+ *   filtering has already been performed and the va_list parameter is
+ *   passed by reference.  That is because the va_list is a structure in
+ *   some compilers and passing of structures in the NuttX sycalls does
+ *   not work.
+ *
+ ****************************************************************************/
+
+int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  struct syslog_vformat_s vformat;
+  struct syslog_stamp_s stamp;
+
+  syslog_stamp(&stamp);
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Leave the formatting to the SYSLOG worker if the message can be
+   * deferred.
+   */
+
+  if (syslog_defer(priority, &stamp, fmt, ap) >= 0)
+    {
+      return 0;
+    }
+
+  /* Otherwise write out the messages deferred before it first */
+
+  syslog_defer_flush(false);
+#endif
+
+  vformat.fmt = fmt;
+  vformat.ap  = ap;
+  return syslog_format(priority, &stamp, syslog_vformat, &vformat);
+}
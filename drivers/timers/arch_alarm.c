@@ -24,8 +24,12 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
+
 #include <nuttx/arch.h>
 #include <nuttx/clock.h>
+#include <nuttx/hrtimer.h>
+#include <nuttx/irq.h>
 #include <nuttx/timers/arch_alarm.h>
 
 /****************************************************************************
@@ -45,10 +49,30 @@
 
 static FAR struct oneshot_lowerhalf_s *g_oneshot_lower;
 
-#ifndef CONFIG_SCHED_TICKLESS
+#ifdef CONFIG_HRTIMER
+/* The oneshot timer is shared by the scheduler and the high resolution
+ * timers.  g_alarm_tick is the tick the scheduler is to be called at and
+ * g_hrtimer_list holds the active high resolution timers by expiry.
+ */
+
+static struct list_node g_hrtimer_list = LIST_INITIAL_VALUE(g_hrtimer_list);
+static uint64_t g_oneshot_maxdelay;
+static clock_t g_alarm_tick;
+static bool g_alarm_running;
+#  ifdef CONFIG_SCHED_TICKLESS
+static bool g_alarm_active;
+#  endif
+#elif !defined(CONFIG_SCHED_TICKLESS)
 static clock_t g_current_tick;
 #endif
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void oneshot_callback(FAR struct oneshot_lowerhalf_s *lower,
+                             FAR void *arg);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -61,6 +85,89 @@ static inline void timespec_from_nsec(FAR struct timespec *ts,
   ts->tv_nsec   = nanoseconds;
 }
 
+#ifdef CONFIG_HRTIMER
+static uint64_t alarm_current_nsec(void)
+{
+  struct timespec ts;
+
+  ONESHOT_CURRENT(g_oneshot_lower, &ts);
+  return timespec_to_nsec(&ts);
+}
+
+static void hrtimer_insert(FAR struct hrtimer_s *timer)
+{
+  FAR struct hrtimer_s *curr;
+
+  /* Timers with the same expiry run in the order they were started */
+
+  list_for_every_entry(&g_hrtimer_list, curr, struct hrtimer_s, node)
+    {
+      if (curr->expiry > timer->expiry)
+        {
+          list_add_before(&curr->node, &timer->node);
+          return;
+        }
+    }
+
+  list_add_tail(&g_hrtimer_list, &timer->node);
+}
+
+/* Program the oneshot timer for the earlier of the scheduler tick and the
+ * first high resolution timer.  Called with interrupts disabled.
+ */
+
+static void alarm_reprogram(void)
+{
+  FAR struct hrtimer_s *timer;
+  struct timespec ts;
+  uint64_t delay;
+  uint64_t now;
+  sclock_t delta;
+  clock_t tick;
+
+  if (g_alarm_running || g_oneshot_lower == NULL)
+    {
+      return;
+    }
+
+  now   = alarm_current_nsec();
+  delay = g_oneshot_maxdelay;
+
+  ONESHOT_TICK_CURRENT(g_oneshot_lower, &tick);
+
+#ifdef CONFIG_SCHED_TICKLESS
+  if (g_alarm_active)
+#endif
+    {
+      delta = g_alarm_tick - tick;
+      if (delta <= 0)
+        {
+          delay = 0;
+        }
+      else if ((uint64_t)delta * NSEC_PER_TICK < delay)
+        {
+          delay = (uint64_t)delta * NSEC_PER_TICK;
+        }
+    }
+
+  if (!list_is_empty(&g_hrtimer_list))
+    {
+      timer = list_first_entry(&g_hrtimer_list, struct hrtimer_s, node);
+      if (timer->expiry <= now)
+        {
+          delay = 0;
+        }
+      else if (timer->expiry - now < delay)
+        {
+          delay = timer->expiry - now;
+        }
+    }
+
+  timespec_from_nsec(&ts, delay);
+  ONESHOT_START(g_oneshot_lower, oneshot_callback, NULL, &ts);
+}
+#endif /* CONFIG_HRTIMER */
+
 static void udelay_accurate(useconds_t microseconds)
 {
   struct timespec now;
@@ -127,6 +234,67 @@ static void udelay_coarse(useconds_t microseconds)
 static void oneshot_callback(FAR struct oneshot_lowerhalf_s *lower,
                              FAR void *arg)
 {
+#ifdef CONFIG_HRTIMER
+  FAR struct hrtimer_s *timer;
+  hrtimer_entry_t func;
+  irqstate_t flags;
+  uint64_t period;
+  uint64_t now;
+  clock_t tick;
+
+  /* The timer functions and the scheduler may start new timers, the
+   * oneshot timer is programmed once when they are all done.
+   */
+
+  flags = enter_critical_section();
+  g_alarm_running = true;
+
+  now = alarm_current_nsec();
+  while (!list_is_empty(&g_hrtimer_list))
+    {
+      timer = list_first_entry(&g_hrtimer_list, struct hrtimer_s, node);
+      if (timer->expiry > now)
+        {
+          break;
+        }
+
+      list_delete(&timer->node);
+      func        = timer->func;
+      timer->func = NULL;
+
+      /* A periodic timer is due again one period after its last expiry,
+       * unless the timer function restarted it itself.
+       */
+
+      period = func(timer, timer->arg);
+      if (period > 0 && timer->func == NULL)
+        {
+          timer->func    = func;
+          timer->expiry += period;
+          hrtimer_insert(timer);
+        }
+    }
+
+  ONESHOT_TICK_CURRENT(g_oneshot_lower, &tick);
+
+#ifdef CONFIG_SCHED_TICKLESS
+  if (g_alarm_active && (sclock_t)(tick - g_alarm_tick) >= 0)
+    {
+      g_alarm_active = false;
+      nxsched_alarm_tick_expiration(tick);
+    }
+#else
+  while ((sclock_t)(tick - g_alarm_tick) >= 0)
+    {
+      nxsched_process_timer();
+      g_alarm_tick++;
+    }
+#endif
+
+  g_alarm_running = false;
+  alarm_reprogram();
+  leave_critical_section(flags);
+#else
   clock_t now = 0;
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -148,6 +316,7 @@ static void oneshot_callback(FAR struct oneshot_lowerhalf_s *lower,
 
   ONESHOT_TICK_START(g_oneshot_lower, oneshot_callback, NULL, delta);
 #endif
+#endif /* CONFIG_HRTIMER */
 }
 
 /****************************************************************************
@@ -158,13 +327,30 @@ void up_alarm_set_lowerhalf(FAR struct oneshot_lowerhalf_s *lower)
 {
 #ifdef CONFIG_SCHED_TICKLESS
   clock_t ticks;
+#endif
+#ifdef CONFIG_HRTIMER
+  struct timespec ts;
+#  ifndef CONFIG_SCHED_TICKLESS
+  irqstate_t flags;
+#  endif
 #endif
 
   g_oneshot_lower = lower;
 
+#ifdef CONFIG_HRTIMER
+  ONESHOT_MAX_DELAY(g_oneshot_lower, &ts);
+  g_oneshot_maxdelay = timespec_to_nsec(&ts);
+#endif
+
 #ifdef CONFIG_SCHED_TICKLESS
   ONESHOT_TICK_MAX_DELAY(g_oneshot_lower, &ticks);
   g_oneshot_maxticks = ticks < UINT32_MAX ? ticks : UINT32_MAX;
+#elif defined(CONFIG_HRTIMER)
+  flags = enter_critical_section();
+  ONESHOT_TICK_CURRENT(g_oneshot_lower, &g_alarm_tick);
+  g_alarm_tick++;
+  alarm_reprogram();
+  leave_critical_section(flags);
 #else
   ONESHOT_TICK_CURRENT(g_oneshot_lower, &g_current_tick);
   ONESHOT_TICK_START(g_oneshot_lower, oneshot_callback, NULL, 1);
@@ -284,8 +470,18 @@ int weak_function up_alarm_tick_cancel(FAR clock_t *ticks)
 
   if (g_oneshot_lower != NULL)
     {
+#ifdef CONFIG_HRTIMER
+      /* The oneshot timer may still be needed by the high resolution
+       * timers.  It is left running, an expiry with nothing due just
+       * programs it again.
+       */
+
+      g_alarm_active = false;
+      ret = ONESHOT_TICK_CURRENT(g_oneshot_lower, ticks);
+#else
       ret = ONESHOT_TICK_CANCEL(g_oneshot_lower, ticks);
       ONESHOT_TICK_CURRENT(g_oneshot_lower, ticks);
+#endif
     }
 
   return ret;
@@ -323,6 +519,16 @@ int weak_function up_alarm_tick_start(clock_t ticks)
 
   if (g_oneshot_lower != NULL)
     {
+#ifdef CONFIG_HRTIMER
+      irqstate_t flags;
+
+      flags = enter_critical_section();
+      g_alarm_tick   = ticks;
+      g_alarm_active = true;
+      alarm_reprogram();
+      leave_critical_section(flags);
+      ret = OK;
+#else
       clock_t now;
       clock_t delta;
 
@@ -335,12 +541,104 @@ int weak_function up_alarm_tick_start(clock_t ticks)
 
       ret = ONESHOT_TICK_START(g_oneshot_lower, oneshot_callback,
                                NULL, delta);
+#endif
     }
 
   return ret;
 }
 #endif
 
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the time in nanoseconds of the oneshot timer that the high
+ *   resolution timers run on.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+uint64_t hrtimer_gettime(void)
+{
+  return g_oneshot_lower != NULL ? alarm_current_nsec() : 0;
+}
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start a high resolution timer, 'func' will be called from the oneshot
+ *   timer interrupt once 'delay' nanoseconds have elapsed.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t delay,
+                  hrtimer_entry_t func, FAR void *arg)
+{
+  irqstate_t flags;
+
+  if (timer == NULL || func == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (g_oneshot_lower == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  flags = enter_critical_section();
+
+  if (HRTIMER_ISACTIVE(timer))
+    {
+      list_delete(&timer->node);
+    }
+
+  timer->expiry = alarm_current_nsec() + delay;
+  timer->func   = func;
+  timer->arg    = arg;
+  hrtimer_insert(timer);
+
+  /* The oneshot timer only has to be moved for a new first timer, a
+   * later expiry of the old one just finds nothing due.
+   */
+
+  if (list_first_entry(&g_hrtimer_list, struct hrtimer_s, node) == timer)
+    {
+      alarm_reprogram();
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a high resolution timer.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer)
+{
+  irqstate_t flags;
+  int ret = -EINVAL;
+
+  flags = enter_critical_section();
+
+  if (timer != NULL && HRTIMER_ISACTIVE(timer))
+    {
+      list_delete(&timer->node);
+      timer->func = NULL;
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif /* CONFIG_HRTIMER */
+
 /****************************************************************************
  * Name: up_perf_*
  *
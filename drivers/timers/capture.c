@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -38,7 +39,9 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/arch.h>
+#include <nuttx/cache.h>
 #include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/timers/capture.h>
 
 #include <arch/irq.h>
@@ -51,6 +54,16 @@
 
 /* Debug ********************************************************************/
 
+/* The alignment of the DMA ring, so that invalidating it cannot discard
+ * the neighbouring heap data on any supported D-cache.
+ */
+
+#define CAP_DMA_ALIGN 64
+
+#ifndef ALIGN_UP
+#  define ALIGN_UP(s, a) (((s) + (a) - 1) & ~((a) - 1))
+#endif
+
 /****************************************************************************
  * Private Type Definitions
  ****************************************************************************/
@@ -62,6 +75,14 @@ struct cap_upperhalf_s
   uint8_t                    crefs;    /* The number of times the device has been opened */
   mutex_t                    lock;     /* Supports mutual exclusion */
   FAR struct cap_lowerhalf_s *lower;   /* lower-half state */
+#ifdef CONFIG_CAPTURE_DMA
+  bool                       active;   /* Streaming, the DMA fills dma.ring */
+  struct cap_dma_s           dma;      /* The ring of edge timestamps */
+  sem_t                      waitsem;  /* Wakes up the readers */
+  size_t                     lastpos;  /* The DMA position at the last update */
+  size_t                     avail;    /* Timestamps not read yet */
+  uint32_t                   overruns; /* Timestamps overwritten unread */
+#endif
 };
 
 /****************************************************************************
@@ -94,6 +115,213 @@ static const struct file_operations g_capops =
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_CAPTURE_DMA
+
+/****************************************************************************
+ * Name: cap_dma_update
+ *
+ * Description:
+ *   Account for the timestamps written by the DMA since the last update.
+ *   The DMA position alone cannot tell a full lap from none, so this must
+ *   run at least twice per lap; the lower half calls back at each half of
+ *   the ring for that.  The oldest timestamps are dropped if the reader
+ *   fell behind by more than a ring.
+ *
+ * Assumptions:
+ *   Called within a critical section while streaming.
+ *
+ ****************************************************************************/
+
+static void cap_dma_update(FAR struct cap_upperhalf_s *upper)
+{
+  FAR struct cap_lowerhalf_s *lower = upper->lower;
+  size_t nedges = upper->dma.nedges;
+  size_t pos;
+
+  pos            = lower->ops->dma_position(lower);
+  upper->avail  += (pos + nedges - upper->lastpos) % nedges;
+  upper->lastpos = pos;
+
+  if (upper->avail > nedges)
+    {
+      upper->overruns += upper->avail - nedges;
+      upper->avail     = nedges;
+    }
+}
+
+/****************************************************************************
+ * Name: cap_dma_copy
+ *
+ * Description:
+ *   Copy the 'n' oldest unread timestamps out of the ring.
+ *
+ * Assumptions:
+ *   Called within a critical section, n <= upper->avail.
+ *
+ ****************************************************************************/
+
+static void cap_dma_copy(FAR struct cap_upperhalf_s *upper,
+                         FAR uint32_t *edges, size_t n)
+{
+  FAR uint32_t *ring = upper->dma.ring;
+  size_t nedges = upper->dma.nedges;
+  size_t index = (upper->lastpos + nedges - upper->avail) % nedges;
+  size_t chunk;
+
+  while (n > 0)
+    {
+      chunk = MIN(n, nedges - index);
+
+      up_invalidate_dcache((uintptr_t)&ring[index],
+                           (uintptr_t)&ring[index + chunk]);
+      memcpy(edges, &ring[index], chunk * sizeof(uint32_t));
+
+      edges += chunk;
+      n     -= chunk;
+      index  = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: cap_dma_callback
+ *
+ * Description:
+ *   Called by the lower half from its DMA interrupt at each half of the
+ *   ring.  Wakes up a reader.
+ *
+ ****************************************************************************/
+
+static void cap_dma_callback(FAR void *arg)
+{
+  FAR struct cap_upperhalf_s *upper = arg;
+  irqstate_t flags;
+  int semcount;
+
+  flags = enter_critical_section();
+
+  if (upper->active)
+    {
+      cap_dma_update(upper);
+
+      nxsem_get_value(&upper->waitsem, &semcount);
+      if (upper->avail > 0 && semcount < 1)
+        {
+          nxsem_post(&upper->waitsem);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: cap_dma_stop
+ *
+ * Description:
+ *   Stop streaming, wake up all readers and free the ring.
+ *
+ * Assumptions:
+ *   upper->lock is held.
+ *
+ ****************************************************************************/
+
+static int cap_dma_stop(FAR struct cap_upperhalf_s *upper)
+{
+  FAR struct cap_lowerhalf_s *lower = upper->lower;
+  irqstate_t flags;
+  int semcount;
+  int ret;
+
+  if (!upper->active)
+    {
+      return OK;
+    }
+
+  flags = enter_critical_section();
+  upper->active = false;
+  leave_critical_section(flags);
+
+  ret = lower->ops->dma_stop(lower);
+
+  while (nxsem_get_value(&upper->waitsem, &semcount) >= 0 && semcount < 0)
+    {
+      nxsem_post(&upper->waitsem);
+    }
+
+  kmm_free(upper->dma.ring);
+  upper->dma.ring = NULL;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cap_dma_start
+ *
+ * Description:
+ *   Allocate a ring of stream->nedges timestamps and let the lower half
+ *   fill it with DMA.
+ *
+ * Assumptions:
+ *   upper->lock is held and the stream is stopped.
+ *
+ ****************************************************************************/
+
+static int cap_dma_start(FAR struct cap_upperhalf_s *upper,
+                         FAR struct cap_stream_s *stream)
+{
+  FAR struct cap_lowerhalf_s *lower = upper->lower;
+  size_t size;
+  int ret;
+
+  if (lower->ops->dma_start == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  if (stream->nedges < 2)
+    {
+      return -EINVAL;
+    }
+
+  DEBUGASSERT(lower->ops->dma_stop != NULL &&
+              lower->ops->dma_position != NULL);
+
+  size = ALIGN_UP(stream->nedges * sizeof(uint32_t), CAP_DMA_ALIGN);
+  upper->dma.ring = kmm_memalign(CAP_DMA_ALIGN, size);
+  if (upper->dma.ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* The heap may have left dirty lines over the ring */
+
+  up_invalidate_dcache((uintptr_t)upper->dma.ring,
+                       (uintptr_t)upper->dma.ring + size);
+
+  upper->dma.nedges   = stream->nedges;
+  upper->dma.callback = cap_dma_callback;
+  upper->dma.arg      = upper;
+  upper->dma.freq     = 0;
+  upper->dma.mask     = UINT32_MAX;
+  upper->lastpos      = 0;
+  upper->avail        = 0;
+  upper->overruns     = 0;
+  upper->active    = true;
+
+  ret = lower->ops->dma_start(lower, &upper->dma);
+  if (ret < 0)
+    {
+      upper->active = false;
+      kmm_free(upper->dma.ring);
+      upper->dma.ring = NULL;
+      return ret;
+    }
+
+  stream->freq = upper->dma.freq;
+  stream->mask = upper->dma.mask;
+  return OK;
+}
+
+#endif /* CONFIG_CAPTURE_DMA */
+
 /****************************************************************************
  * Name: cap_open
  *
@@ -198,6 +426,10 @@ static int cap_close(FAR struct file *filep)
 
       upper->crefs = 0;
 
+#ifdef CONFIG_CAPTURE_DMA
+      cap_dma_stop(upper);
+#endif
+
       /* Disable the PWM Capture device */
 
       DEBUGASSERT(lower->ops->stop != NULL);
@@ -216,7 +448,10 @@ errout:
  * Name: cap_read
  *
  * Description:
- *   A dummy read method.  This is provided only to satisfy the VFS layer.
+ *   Return the oldest unread edge timestamps while streaming, as many as
+ *   fit into the buffer.  Blocks until there is at least one, unless the
+ *   file was opened with O_NONBLOCK.  Returns end-of-file when the device
+ *   does not stream.
  *
  ****************************************************************************/
 
@@ -224,9 +459,70 @@ static ssize_t cap_read(FAR struct file *filep,
                        FAR char *buffer,
                        size_t buflen)
 {
+#ifdef CONFIG_CAPTURE_DMA
+  FAR struct inode           *inode = filep->f_inode;
+  FAR struct cap_upperhalf_s *upper = inode->i_private;
+  irqstate_t                  flags;
+  uint32_t                    overruns;
+  size_t                      n;
+  ssize_t                     ret;
+
+  flags = enter_critical_section();
+
+  for (; ; )
+    {
+      if (!upper->active)
+        {
+          ret = 0;
+          break;
+        }
+
+      if (buflen < sizeof(uint32_t))
+        {
+          ret = -EINVAL;
+          break;
+        }
+
+      cap_dma_update(upper);
+      if (upper->avail == 0)
+        {
+          if ((filep->f_oflags & O_NONBLOCK) != 0)
+            {
+              ret = -EAGAIN;
+              break;
+            }
+
+          ret = nxsem_wait(&upper->waitsem);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      n        = MIN(upper->avail, buflen / sizeof(uint32_t));
+      overruns = upper->overruns;
+      cap_dma_copy(upper, (FAR uint32_t *)buffer, n);
+
+      /* Copy again if the DMA overwrote the oldest timestamps meanwhile */
+
+      cap_dma_update(upper);
+      if (upper->overruns == overruns)
+        {
+          upper->avail -= n;
+          ret = n * sizeof(uint32_t);
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+#else
   /* Return zero -- usually meaning end-of-file */
 
   return 0;
+#endif
 }
 
 /****************************************************************************
@@ -304,6 +600,37 @@ static int cap_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_CAPTURE_DMA
+      /* CAPIOC_STREAM - Start or stop streaming edge timestamps.
+       * Argument: A pointer to struct cap_stream_s.
+       */
+
+      case CAPIOC_STREAM:
+        {
+          FAR struct cap_stream_s *stream =
+            (FAR struct cap_stream_s *)((uintptr_t)arg);
+          DEBUGASSERT(stream != NULL);
+          ret = cap_dma_stop(upper);
+          if (ret >= 0 && stream->nedges > 0)
+            {
+              ret = cap_dma_start(upper, stream);
+            }
+        }
+        break;
+
+      /* CAPIOC_OVERRUNS - Get the number of timestamps lost.
+       * Argument: uint32_t pointer to the location to return the count.
+       */
+
+      case CAPIOC_OVERRUNS:
+        {
+          FAR uint32_t *ptr = (FAR uint32_t *)((uintptr_t)arg);
+          DEBUGASSERT(ptr != NULL);
+          *ptr = upper->overruns;
+        }
+        break;
+#endif
+
       /* Any unrecognized IOCTL commands might be platform-specific ioctl
        * commands
        */
@@ -362,6 +689,9 @@ int cap_register(FAR const char *devpath, FAR struct cap_lowerhalf_s *lower)
    */
 
   nxmutex_init(&upper->lock);
+#ifdef CONFIG_CAPTURE_DMA
+  nxsem_init(&upper->waitsem, 0, 0);
+#endif
   upper->lower = lower;
 
   /* Register the PWM Capture device */
@@ -33,13 +33,18 @@
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <debug.h>
 
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
 #include <nuttx/queue.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/wdog.h>
 #include <nuttx/arch.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/serial/serial.h>
 
 #include <nuttx/usb/usb.h>
@@ -96,6 +101,7 @@ struct cdcacm_dev_s
   uint8_t nrdq;                        /* Number of queue read requests (in epbulkout) */
   uint8_t minor;                       /* The device minor number */
   uint8_t ctrlline;                    /* Buffered control line state */
+  uint16_t rdreqlen;                   /* Size of the read requests */
 #ifdef CONFIG_CDCACM_IFLOWCONTROL
   uint8_t serialstate;                 /* State of the DSR/DCD */
   bool iflow;                          /* True: input flow control is enabled */
@@ -117,6 +123,18 @@ struct cdcacm_dev_s
 
   struct usbdev_devinfo_s devinfo;
 
+#ifdef CONFIG_CDCACM_BULKMODE
+  /* Character device state of the raw bulk mode */
+
+  mutex_t rdlock;                      /* Serializes the readers */
+  mutex_t wrlock;                      /* Serializes the writers */
+  sem_t rdsem;                         /* Wakes up a waiting reader */
+  sem_t wrsem;                         /* Wakes up a waiting writer */
+  bool rdwaiting;                      /* A reader waits for rxpending */
+  bool wrwaiting;                      /* A writer waits for txfree */
+  FAR struct pollfd *fds[CONFIG_CDCACM_NPOLLWAITERS];
+#endif
+
   /* Pre-allocated write request containers.  The write requests will
    * be linked in a free list (txfree), and used to send requests to
    * EPBULKIN; Read requests will be queued in the EBULKOUT.
@@ -163,6 +181,19 @@ static int     cdcacm_requeue_rdrequest(FAR struct cdcacm_dev_s *priv,
 static int     cdcacm_release_rxpending(FAR struct cdcacm_dev_s *priv);
 static void    cdcacm_rxtimeout(wdparm_t arg);
 
+/* Raw bulk mode ************************************************************/
+
+#ifdef CONFIG_CDCACM_BULKMODE
+static void    cdcacm_bulk_notify(FAR struct cdcacm_dev_s *priv,
+                 pollevent_t eventset);
+static ssize_t cdcacm_bulk_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t cdcacm_bulk_write(FAR struct file *filep,
+                 FAR const char *buffer, size_t buflen);
+static int     cdcacm_bulk_poll(FAR struct file *filep,
+                 FAR struct pollfd *fds, bool setup);
+#endif
+
 /* Flow Control *************************************************************/
 
 #ifdef CONFIG_CDCACM_IFLOWCONTROL
@@ -275,6 +306,23 @@ static const struct uart_ops_s g_uartops =
   cdcuart_txempty        /* txempty */
 };
 
+/* Raw bulk mode ************************************************************/
+
+#ifdef CONFIG_CDCACM_BULKMODE
+static const struct file_operations g_bulkfops =
+{
+  NULL,                  /* open */
+  NULL,                  /* close */
+  cdcacm_bulk_read,      /* read */
+  cdcacm_bulk_write,     /* write */
+  NULL,                  /* seek */
+  NULL,                  /* ioctl */
+  NULL,                  /* mmap */
+  NULL,                  /* truncate */
+  cdcacm_bulk_poll       /* poll */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -303,23 +351,36 @@ static uint16_t cdcacm_fillrequest(FAR struct cdcacm_dev_s *priv,
   FAR struct uart_buffer_s *xmit = &serdev->xmit;
   irqstate_t flags;
   uint16_t nbytes = 0;
+  uint16_t ncopy;
 
   /* Disable interrupts */
 
   flags = enter_critical_section();
 
   /* Transfer bytes while we have bytes available and there is room in the
-   * request.
+   * request, one contiguous run of the circular buffer at a time.
    */
 
   while (xmit->head != xmit->tail && nbytes < reqlen)
     {
-      *reqbuf++ = xmit->buffer[xmit->tail];
-      nbytes++;
+      if (xmit->head > xmit->tail)
+        {
+          ncopy = xmit->head - xmit->tail;
+        }
+      else
+        {
+          ncopy = xmit->size - xmit->tail;
+        }
 
-      /* Increment the tail pointer */
+      ncopy = MIN(ncopy, reqlen - nbytes);
+      memcpy(reqbuf, &xmit->buffer[xmit->tail], ncopy);
+      reqbuf += ncopy;
+      nbytes += ncopy;
 
-      if (++(xmit->tail) >= xmit->size)
+      /* Advance the tail pointer */
+
+      xmit->tail += ncopy;
+      if (xmit->tail >= xmit->size)
         {
           xmit->tail = 0;
         }
@@ -624,7 +685,7 @@ static int cdcacm_requeue_rdrequest(FAR struct cdcacm_dev_s *priv,
   /* Requeue the read request */
 
   ep       = priv->epbulkout;
-  req->len = ep->maxpacket;
+  req->len = priv->rdreqlen;
   ret      = EP_SUBMIT(ep, req);
   if (ret != OK)
     {
@@ -753,6 +814,301 @@ static void cdcacm_rxtimeout(wdparm_t arg)
   cdcacm_release_rxpending(priv);
 }
 
+#ifdef CONFIG_CDCACM_BULKMODE
+/****************************************************************************
+ * Name: cdcacm_bulk_notify
+ *
+ * Description:
+ *   Wake up the readers, writers and pollers of the raw bulk mode after a
+ *   request completed or the connection state changed.
+ *
+ * Assumptions:
+ *   May be called from the USB interrupt handler.
+ *
+ ****************************************************************************/
+
+static void cdcacm_bulk_notify(FAR struct cdcacm_dev_s *priv,
+                               pollevent_t eventset)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if ((eventset & (POLLIN | POLLHUP)) != 0 && priv->rdwaiting)
+    {
+      priv->rdwaiting = false;
+      nxsem_post(&priv->rdsem);
+    }
+
+  if ((eventset & (POLLOUT | POLLHUP)) != 0 && priv->wrwaiting)
+    {
+      priv->wrwaiting = false;
+      nxsem_post(&priv->wrsem);
+    }
+
+  leave_critical_section(flags);
+  poll_notify(priv->fds, CONFIG_CDCACM_NPOLLWAITERS, eventset);
+}
+
+/****************************************************************************
+ * Name: cdcacm_bulk_read
+ *
+ * Description:
+ *   Copy the data of the completed read requests to the caller.  The data
+ *   is taken straight from the requests, there is no intermediate serial
+ *   RX buffer; a request is requeued as soon as it has been consumed.
+ *
+ ****************************************************************************/
+
+static ssize_t cdcacm_bulk_read(FAR struct file *filep, FAR char *buffer,
+                                size_t buflen)
+{
+  FAR struct cdcacm_dev_s *priv = filep->f_inode->i_private;
+  FAR struct cdcacm_rdreq_s *rdcontainer;
+  FAR struct usbdev_req_s *req;
+  irqstate_t flags;
+  size_t nread = 0;
+  size_t ncopy;
+  int ret;
+
+  ret = nxmutex_lock(&priv->rdlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+
+  /* Wait for the first completed read request */
+
+  while (sq_empty(&priv->rxpending))
+    {
+      if (priv->config == CDCACM_CONFIGIDNONE)
+        {
+          ret = -EPIPE;
+          goto errout;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      priv->rdwaiting = true;
+      ret = nxsem_wait(&priv->rdsem);
+      if (ret < 0)
+        {
+          priv->rdwaiting = false;
+          goto errout;
+        }
+    }
+
+  /* Then drain as many of the pending requests as the buffer can hold */
+
+  while (nread < buflen &&
+         (rdcontainer = (FAR struct cdcacm_rdreq_s *)
+                        sq_peek(&priv->rxpending)) != NULL)
+    {
+      req   = rdcontainer->req;
+      ncopy = MIN(buflen - nread, req->xfrd - rdcontainer->offset);
+
+      leave_critical_section(flags);
+      memcpy(buffer + nread, req->buf + rdcontainer->offset, ncopy);
+      flags = enter_critical_section();
+      nread += ncopy;
+
+      /* The request may have been discarded by a disconnection while the
+       * data was copied
+       */
+
+      if (sq_peek(&priv->rxpending) != (FAR sq_entry_t *)rdcontainer)
+        {
+          break;
+        }
+
+      rdcontainer->offset += ncopy;
+      if (rdcontainer->offset >= req->xfrd)
+        {
+          sq_remfirst(&priv->rxpending);
+          cdcacm_requeue_rdrequest(priv, rdcontainer);
+        }
+    }
+
+  ret = nread;
+
+errout:
+  leave_critical_section(flags);
+  nxmutex_unlock(&priv->rdlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcacm_bulk_write
+ *
+ * Description:
+ *   Copy the caller data into free write requests and submit them to the
+ *   bulk IN endpoint, each request carries up to
+ *   CONFIG_CDCACM_BULKIN_REQLEN bytes.
+ *
+ ****************************************************************************/
+
+static ssize_t cdcacm_bulk_write(FAR struct file *filep,
+                                 FAR const char *buffer, size_t buflen)
+{
+  FAR struct cdcacm_dev_s *priv = filep->f_inode->i_private;
+  FAR struct cdcacm_wrreq_s *wrcontainer;
+  FAR struct usbdev_req_s *req;
+  irqstate_t flags;
+  size_t nwritten = 0;
+  size_t reqlen;
+  int ret;
+
+  ret = nxmutex_lock(&priv->wrlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+
+  while (nwritten < buflen)
+    {
+      if (priv->config == CDCACM_CONFIGIDNONE)
+        {
+          ret = -EPIPE;
+          break;
+        }
+
+      /* Wait for a free write request */
+
+      wrcontainer = (FAR struct cdcacm_wrreq_s *)sq_remfirst(&priv->txfree);
+      if (wrcontainer == NULL)
+        {
+          if ((filep->f_oflags & O_NONBLOCK) != 0)
+            {
+              ret = -EAGAIN;
+              break;
+            }
+
+          priv->wrwaiting = true;
+          ret = nxsem_wait(&priv->wrsem);
+          if (ret < 0)
+            {
+              priv->wrwaiting = false;
+              break;
+            }
+
+          continue;
+        }
+
+      priv->nwrq--;
+      leave_critical_section(flags);
+
+      /* Fill the request and submit it */
+
+      req    = wrcontainer->req;
+      reqlen = MAX(CONFIG_CDCACM_BULKIN_REQLEN, priv->epbulkin->maxpacket);
+      reqlen = MIN(reqlen, buflen - nwritten);
+      memcpy(req->buf, buffer + nwritten, reqlen);
+
+      req->len   = reqlen;
+      req->priv  = wrcontainer;
+      req->flags = USBDEV_REQFLAGS_NULLPKT;
+
+      flags = enter_critical_section();
+      ret   = EP_SUBMIT(priv->epbulkin, req);
+      if (ret != OK)
+        {
+          usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_SUBMITFAIL),
+                   (uint16_t)-ret);
+          sq_addlast((FAR sq_entry_t *)wrcontainer, &priv->txfree);
+          priv->nwrq++;
+          break;
+        }
+
+      nwritten += reqlen;
+    }
+
+  leave_critical_section(flags);
+  nxmutex_unlock(&priv->wrlock);
+  return nwritten > 0 ? nwritten : ret;
+}
+
+/****************************************************************************
+ * Name: cdcacm_bulk_poll
+ *
+ * Description:
+ *   Poll for the completed read requests and the free write requests of
+ *   the raw bulk mode.
+ *
+ ****************************************************************************/
+
+static int cdcacm_bulk_poll(FAR struct file *filep,
+                            FAR struct pollfd *fds, bool setup)
+{
+  FAR struct cdcacm_dev_s *priv = filep->f_inode->i_private;
+  pollevent_t eventset = 0;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  if (!setup)
+    {
+      /* This is a request to tear down the poll */
+
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+      return OK;
+    }
+
+  flags = enter_critical_section();
+
+  /* This is a request to set up the poll.  Find an available slot for the
+   * poll structure reference
+   */
+
+  for (i = 0; i < CONFIG_CDCACM_NPOLLWAITERS; i++)
+    {
+      if (priv->fds[i] == NULL)
+        {
+          priv->fds[i] = fds;
+          fds->priv    = &priv->fds[i];
+          break;
+        }
+    }
+
+  if (i >= CONFIG_CDCACM_NPOLLWAITERS)
+    {
+      fds->priv = NULL;
+      ret       = -EBUSY;
+      goto errout;
+    }
+
+  /* Report the events that are already pending */
+
+  if (!sq_empty(&priv->rxpending))
+    {
+      eventset |= POLLIN;
+    }
+
+  if (priv->config == CDCACM_CONFIGIDNONE)
+    {
+      eventset |= POLLHUP;
+    }
+  else if (!sq_empty(&priv->txfree))
+    {
+      eventset |= POLLOUT;
+    }
+
+  poll_notify(&fds, 1, eventset);
+
+errout:
+  leave_critical_section(flags);
+  return ret;
+}
+#endif /* CONFIG_CDCACM_BULKMODE */
+
 /****************************************************************************
  * Name: cdcacm_serialstate
  *
@@ -878,7 +1234,7 @@ static void cdcacm_resetconfig(FAR struct cdcacm_dev_s *priv)
        * connection.
        */
 
-#ifdef CONFIG_SERIAL_REMOVABLE
+#if defined(CONFIG_SERIAL_REMOVABLE) && !defined(CONFIG_CDCACM_BULKMODE)
       uart_connected(&priv->serdev, false);
 #endif
 
@@ -889,6 +1245,19 @@ static void cdcacm_resetconfig(FAR struct cdcacm_dev_s *priv)
       EP_DISABLE(priv->epintin);
       EP_DISABLE(priv->epbulkin);
       EP_DISABLE(priv->epbulkout);
+
+#ifdef CONFIG_CDCACM_BULKMODE
+      /* The completed read requests that were not consumed by a reader
+       * are no longer queued, discard them and wake up everyone waiting.
+       */
+
+      while (sq_remfirst(&priv->rxpending) != NULL)
+        {
+          priv->nrdq--;
+        }
+
+      cdcacm_bulk_notify(priv, POLLHUP);
+#endif
     }
 }
 
@@ -1054,7 +1423,9 @@ static int cdcacm_setconfig(FAR struct cdcacm_dev_s *priv, uint8_t config)
 
   /* Inform the "upper half" driver that we are "open for business" */
 
-#ifdef CONFIG_SERIAL_REMOVABLE
+#ifdef CONFIG_CDCACM_BULKMODE
+  cdcacm_bulk_notify(priv, POLLOUT);
+#elif defined(CONFIG_SERIAL_REMOVABLE)
   uart_connected(&priv->serdev, true);
 #endif
 
@@ -1132,11 +1503,17 @@ static void cdcacm_rdcomplete(FAR struct usbdev_ep_s *ep,
         rdcontainer->offset = 0;
         sq_addlast((FAR sq_entry_t *)rdcontainer, &priv->rxpending);
 
+#ifdef CONFIG_CDCACM_BULKMODE
+        /* Then let the reader take the data straight from the request */
+
+        cdcacm_bulk_notify(priv, POLLIN);
+#else
         /* Then process all pending RX packet starting at the head of the
          * list
          */
 
         cdcacm_release_rxpending(priv);
+#endif
       }
       break;
 
@@ -1206,13 +1583,20 @@ static void cdcacm_wrcomplete(FAR struct usbdev_ep_s *ep,
     case OK: /* Normal completion */
       {
         usbtrace(TRACE_CLASSWRCOMPLETE, priv->nwrq);
+#ifdef CONFIG_CDCACM_BULKMODE
+        cdcacm_bulk_notify(priv, POLLOUT);
+#else
         cdcacm_sndpacket(priv);
+#endif
       }
       break;
 
     case -ESHUTDOWN: /* Disconnection */
       {
         usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_WRSHUTDOWN), priv->nwrq);
+#ifdef CONFIG_CDCACM_BULKMODE
+        cdcacm_bulk_notify(priv, POLLHUP);
+#endif
       }
       break;
 
@@ -1323,7 +1707,11 @@ static int cdcacm_bind(FAR struct usbdevclass_driver_s *driver,
 
   priv->epbulkout->priv = priv;
 
-  /* Pre-allocate read requests.  The buffer size is one full packet. */
+  /* Pre-allocate read requests.  The buffer size is at least one full
+   * packet; a larger CONFIG_CDCACM_BULKOUT_REQLEN is rounded down to a
+   * whole number of packets so that one request may collect a burst of
+   * packets before it completes.
+   */
 
 #ifdef CONFIG_USBDEV_DUALSPEED
   reqlen = CONFIG_CDCACM_EPBULKOUT_HSSIZE;
@@ -1331,6 +1719,13 @@ static int cdcacm_bind(FAR struct usbdevclass_driver_s *driver,
   reqlen = CONFIG_CDCACM_EPBULKOUT_FSSIZE;
 #endif
 
+  if (CONFIG_CDCACM_BULKOUT_REQLEN > reqlen)
+    {
+      reqlen = CONFIG_CDCACM_BULKOUT_REQLEN / reqlen * reqlen;
+    }
+
+  priv->rdreqlen = reqlen;
+
   for (i = 0; i < CONFIG_CDCACM_NRDREQS; i++)
     {
       rdcontainer      = &priv->rdreqs[i];
@@ -1983,7 +2378,7 @@ static void cdcacm_disconnect(FAR struct usbdevclass_driver_s *driver,
    */
 
   flags = enter_critical_section();
-#ifdef CONFIG_SERIAL_REMOVABLE
+#if defined(CONFIG_SERIAL_REMOVABLE) && !defined(CONFIG_CDCACM_BULKMODE)
   uart_connected(&priv->serdev, false);
 #endif
 
@@ -2034,9 +2429,15 @@ static void cdcacm_suspend(FAR struct usbdevclass_driver_s *driver,
 
   priv = ((FAR struct cdcacm_driver_s *)driver)->dev;
 
-  /* And let the "upper half" driver now that we are suspended */
+  /* And let the "upper half" driver now that we are suspended.  The raw
+   * bulk mode has no upper half, its requests simply stall until resumed.
+   */
 
+#ifdef CONFIG_CDCACM_BULKMODE
+  UNUSED(priv);
+#else
   uart_connected(&priv->serdev, false);
+#endif
 }
 #endif
 
@@ -2074,7 +2475,11 @@ static void cdcacm_resume(FAR struct usbdevclass_driver_s *driver,
     {
       /* Yes.. let the "upper half" know that have resumed */
 
+#ifdef CONFIG_CDCACM_BULKMODE
+      cdcacm_bulk_notify(priv, POLLOUT);
+#else
       uart_connected(&priv->serdev, true);
+#endif
     }
 }
 #endif
@@ -2893,6 +3298,15 @@ int cdcacm_classobject(int minor, FAR struct usbdev_devinfo_s *devinfo,
   priv->serdev.ops          = &g_uartops;
   priv->serdev.priv         = priv;
 
+#ifdef CONFIG_CDCACM_BULKMODE
+  /* Initialize the character device of the raw bulk mode */
+
+  nxmutex_init(&priv->rdlock);
+  nxmutex_init(&priv->wrlock);
+  nxsem_init(&priv->rdsem, 0, 0);
+  nxsem_init(&priv->wrsem, 0, 0);
+#endif
+
   /* Initialize the USB class driver structure */
 
 #ifdef CONFIG_USBDEV_DUALSPEED
@@ -2920,10 +3334,16 @@ int cdcacm_classobject(int minor, FAR struct usbdev_devinfo_s *devinfo,
     }
 #endif
 
-  /* Register the CDC/ACM TTY device */
+  /* Register the CDC/ACM TTY device, or the raw character device that
+   * exchanges the data with the bulk requests directly in bulk mode.
+   */
 
   snprintf(devname, CDCACM_DEVNAME_SIZE, CDCACM_DEVNAME_FORMAT, minor);
+#ifdef CONFIG_CDCACM_BULKMODE
+  ret = register_driver(devname, &g_bulkfops, 0666, priv);
+#else
   ret = uart_register(devname, &priv->serdev);
+#endif
   if (ret < 0)
     {
       usbtrace(TRACE_CLSERROR(USBSER_TRACEERR_UARTREGISTER),
@@ -2935,6 +3355,12 @@ int cdcacm_classobject(int minor, FAR struct usbdev_devinfo_s *devinfo,
   return OK;
 
 errout_with_class:
+#ifdef CONFIG_CDCACM_BULKMODE
+  nxmutex_destroy(&priv->rdlock);
+  nxmutex_destroy(&priv->wrlock);
+  nxsem_destroy(&priv->rdsem);
+  nxsem_destroy(&priv->wrsem);
+#endif
   kmm_free(alloc);
   return ret;
 }
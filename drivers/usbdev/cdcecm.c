@@ -21,6 +21,8 @@
 /* References:
  *   [CDCECM1.2] Universal Serial Bus - Communications Class - Subclass
  *               Specification for Ethernet Control Model Devices - Rev 1.2
+ *   [NCM1.0]    Universal Serial Bus Communications Class Subclass
+ *               Specification for Network Control Model Devices - Rev 1.0
  */
 
 /****************************************************************************
@@ -96,6 +98,32 @@
 
 #define BUF ((FAR struct eth_hdr_s *)self->dev.d_buf)
 
+/* In NCM mode the requests carry whole Network Transfer Blocks.  Each IN
+ * NTB is laid out as the NTH16 header, one NDP16 table with room for
+ * CDCECM_NCM_MAXDGRAMS datagrams and then the datagrams themselves, each
+ * aligned to CDCECM_NCM_ALIGN bytes.  Two IN NTBs are used so that one can
+ * be filled while the other one is being sent.
+ */
+
+#ifdef CONFIG_CDCECM_NCM
+#  define CDCECM_NCM_NWRREQS     2
+#  define CDCECM_NCM_MAXDGRAMS   32
+#  define CDCECM_NCM_MAXNDPS     8
+#  define CDCECM_NCM_ALIGN       4
+#  define CDCECM_NCM_ALIGNUP(n)  (((n) + CDCECM_NCM_ALIGN - 1) & \
+                                  ~(CDCECM_NCM_ALIGN - 1))
+#  define CDCECM_NCM_DGOFFSET    \
+     CDCECM_NCM_ALIGNUP(SIZEOF_NCM_NTH16 + \
+                        SIZEOF_NCM_NDP16(CDCECM_NCM_MAXDGRAMS + 1))
+#  define CDCECM_RDREQLEN        CONFIG_CDCECM_NCM_NTBSIZE
+#  define CDCECM_WRREQLEN        CONFIG_CDCECM_NCM_NTBSIZE
+#else
+#  define CDCECM_RDREQLEN        (CONFIG_NET_ETH_PKTSIZE + \
+                                  CONFIG_NET_GUARDSIZE)
+#  define CDCECM_WRREQLEN        (CONFIG_NET_ETH_PKTSIZE + \
+                                  CONFIG_NET_GUARDSIZE)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -122,7 +150,19 @@ struct cdcecm_driver_s
   struct usbdev_req_s         *rdreq;       /* Single read request */
   bool                         rxpending;   /* Packet available in rdreq */
 
+#ifdef CONFIG_CDCECM_NCM
+  /* The write requests that carry the IN NTBs */
+
+  struct usbdev_req_s         *wrreqs[CDCECM_NCM_NWRREQS];
+  FAR struct usbdev_req_s     *ntb;         /* IN NTB being filled */
+  uint8_t                      ntbnext;     /* Next wrreqs[] to fill */
+  uint8_t                      ntbbusy;     /* IN NTBs being sent */
+  uint16_t                     ntbseq;      /* Sequence of the next NTB */
+  uint16_t                     ntbinsize;   /* Maximum IN NTB size */
+  uint16_t                     ndg;         /* Datagrams in the IN NTB */
+#else
   struct usbdev_req_s         *wrreq;       /* Single write request */
+#endif
   sem_t                        wrreq_idle;  /* Is the wrreq available? */
   bool                         txdone;      /* Did a write request complete? */
 
@@ -155,9 +195,17 @@ static int  cdcecm_txpoll(FAR struct net_driver_s *dev);
 /* Interrupt handling */
 
 static void cdcecm_reply(struct cdcecm_driver_s *priv);
-static void cdcecm_receive(FAR struct cdcecm_driver_s *priv);
+static void cdcecm_receive(FAR struct cdcecm_driver_s *priv,
+              FAR const uint8_t *buf, size_t len);
 static void cdcecm_txdone(FAR struct cdcecm_driver_s *priv);
 
+/* NCM framing */
+
+#ifdef CONFIG_CDCECM_NCM
+static int  cdcecm_ncm_flush(FAR struct cdcecm_driver_s *priv);
+static void cdcecm_ncm_receive(FAR struct cdcecm_driver_s *priv);
+#endif
+
 static void cdcecm_interrupt_work(FAR void *arg);
 
 /* NuttX callback functions */
@@ -240,7 +288,7 @@ static const struct usb_devdesc_s g_devdesc =
     MSBYTE(0x0200)
   },
   USB_CLASS_CDC,
-  CDC_SUBCLASS_ECM,
+  CDCECM_SUBCLASS,
   CDC_PROTO_NONE,
   CONFIG_CDCECM_EP0MAXPACKET,
   {
@@ -284,6 +332,65 @@ static const struct usb_devdesc_s g_devdesc =
  *
  ****************************************************************************/
 
+#ifdef CONFIG_CDCECM_NCM
+static int cdcecm_transmit(FAR struct cdcecm_driver_s *self)
+{
+  FAR struct usbdev_req_s *req;
+  FAR uint8_t *dg;
+  uint16_t offset;
+
+  /* Send the IN NTB being filled if the packet does not fit into it */
+
+  if (self->ntb != NULL &&
+      CDCECM_NCM_ALIGNUP(self->ntb->len) + self->dev.d_len >
+      self->ntbinsize)
+    {
+      cdcecm_ncm_flush(self);
+    }
+
+  /* Start a new IN NTB in the next write request once it is available */
+
+  if (self->ntb == NULL)
+    {
+      while (nxsem_wait(&self->wrreq_idle) != OK)
+        {
+        }
+
+      self->ntb      = self->wrreqs[self->ntbnext];
+      self->ntbnext  = (self->ntbnext + 1) % CDCECM_NCM_NWRREQS;
+      self->ntb->len = CDCECM_NCM_DGOFFSET;
+      self->ndg      = 0;
+    }
+
+  /* Increment statistics */
+
+  NETDEV_TXPACKETS(self->dev);
+
+  /* Append the packet to the NTB and record it in the datagram table */
+
+  req      = self->ntb;
+  offset   = CDCECM_NCM_ALIGNUP(req->len);
+  memcpy(req->buf + offset, self->dev.d_buf, self->dev.d_len);
+  req->len = offset + self->dev.d_len;
+
+  dg = req->buf + SIZEOF_NCM_NTH16 + SIZEOF_NCM_NDP16(self->ndg);
+  dg[0] = LSBYTE(offset);
+  dg[1] = MSBYTE(offset);
+  dg[2] = LSBYTE(self->dev.d_len);
+  dg[3] = MSBYTE(self->dev.d_len);
+
+  /* The NTB is sent as soon as its datagram table is full, otherwise when
+   * the driver runs out of work (see cdcecm_ncm_flush()).
+   */
+
+  if (++self->ndg >= CDCECM_NCM_MAXDGRAMS)
+    {
+      return cdcecm_ncm_flush(self);
+    }
+
+  return OK;
+}
+#else
 static int cdcecm_transmit(FAR struct cdcecm_driver_s *self)
 {
   /* Wait until the USB device request for Ethernet frame transmissions
@@ -305,6 +412,7 @@ static int cdcecm_transmit(FAR struct cdcecm_driver_s *self)
 
   return EP_SUBMIT(self->epbulkin, self->wrreq);
 }
+#endif
 
 /****************************************************************************
  * Name: cdcecm_txpoll
@@ -340,10 +448,16 @@ static int cdcecm_txpoll(FAR struct net_driver_s *dev)
   cdcecm_transmit(priv);
 
   /* Check if there is room in the device to hold another packet. If
-   * not, return a non-zero value to terminate the poll.
+   * not, return a non-zero value to terminate the poll.  In NCM mode the
+   * packets are gathered into the NTBs, cdcecm_transmit() waits for a free
+   * one when needed.
    */
 
+#ifdef CONFIG_CDCECM_NCM
+  return 0;
+#else
   return 1;
+#endif
 }
 
 /****************************************************************************
@@ -387,6 +501,8 @@ static void cdcecm_reply(struct cdcecm_driver_s *priv)
  *
  * Input Parameters:
  *   priv - Reference to the driver state structure
+ *   buf  - The received Ethernet frame
+ *   len  - The size of the frame
  *
  * Returned Value:
  *   None
@@ -396,20 +512,25 @@ static void cdcecm_reply(struct cdcecm_driver_s *priv)
  *
  ****************************************************************************/
 
-static void cdcecm_receive(FAR struct cdcecm_driver_s *self)
+static void cdcecm_receive(FAR struct cdcecm_driver_s *self,
+                           FAR const uint8_t *buf, size_t len)
 {
-  /* Check for errors and update statistics */
-
   /* Check if the packet is a valid size for the network buffer
    * configuration.
    */
 
+  if (len > CONFIG_NET_ETH_PKTSIZE)
+    {
+      NETDEV_RXERRORS(&self->dev);
+      return;
+    }
+
   /* Copy the data data from the hardware to self->dev.d_buf.  Set
    * amount of data in self->dev.d_len
    */
 
-  memcpy(self->dev.d_buf, self->rdreq->buf, self->rdreq->xfrd);
-  self->dev.d_len = self->rdreq->xfrd;
+  memcpy(self->dev.d_buf, buf, len);
+  self->dev.d_len = len;
 
 #ifdef CONFIG_NET_PKT
   /* When packet sockets are enabled, feed the frame into the tap */
@@ -475,6 +596,184 @@ static void cdcecm_receive(FAR struct cdcecm_driver_s *self)
     }
 }
 
+/****************************************************************************
+ * Name: cdcecm_ncm_flush
+ *
+ * Description:
+ *   Complete the header and the datagram table of the IN NTB being filled
+ *   and send it on the bulk IN endpoint.
+ *
+ * Input Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   OK on success; a negated errno on failure
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CDCECM_NCM
+static int cdcecm_ncm_flush(FAR struct cdcecm_driver_s *self)
+{
+  FAR struct usbdev_req_s *req = self->ntb;
+  FAR struct cdc_ncm_nth16_s *nth;
+  FAR struct cdc_ncm_ndp16_s *ndp;
+  FAR uint8_t *dg;
+  irqstate_t flags;
+  uint16_t ndplen;
+  int ret;
+
+  if (req == NULL)
+    {
+      return OK;
+    }
+
+  self->ntb = NULL;
+
+  /* The datagram table follows the header and ends with a null entry */
+
+  ndp    = (FAR struct cdc_ncm_ndp16_s *)(req->buf + SIZEOF_NCM_NTH16);
+  ndplen = SIZEOF_NCM_NDP16(self->ndg + 1);
+  memcpy(ndp->sig, NCM_NDP16_SIGNATURE, 4);
+  ndp->len[0]     = LSBYTE(ndplen);
+  ndp->len[1]     = MSBYTE(ndplen);
+  ndp->nextidx[0] = 0;
+  ndp->nextidx[1] = 0;
+
+  dg = (FAR uint8_t *)ndp + SIZEOF_NCM_NDP16(self->ndg);
+  memset(dg, 0, 4);
+
+  nth = (FAR struct cdc_ncm_nth16_s *)req->buf;
+  memcpy(nth->sig, NCM_NTH16_SIGNATURE, 4);
+  nth->hdrlen[0] = LSBYTE(SIZEOF_NCM_NTH16);
+  nth->hdrlen[1] = MSBYTE(SIZEOF_NCM_NTH16);
+  nth->seq[0]    = LSBYTE(self->ntbseq);
+  nth->seq[1]    = MSBYTE(self->ntbseq);
+  nth->blklen[0] = LSBYTE(req->len);
+  nth->blklen[1] = MSBYTE(req->len);
+  nth->ndpidx[0] = LSBYTE(SIZEOF_NCM_NTH16);
+  nth->ndpidx[1] = MSBYTE(SIZEOF_NCM_NTH16);
+  self->ntbseq++;
+
+  /* A short NTB that is a multiple of the max packet size is terminated
+   * with a null packet.
+   */
+
+  req->flags = USBDEV_REQFLAGS_NULLPKT;
+
+  flags = enter_critical_section();
+  self->ntbbusy++;
+  leave_critical_section(flags);
+
+  ret = EP_SUBMIT(self->epbulkin, req);
+  if (ret < 0)
+    {
+      uerr("EP_SUBMIT failed. ret %d\n", ret);
+
+      flags = enter_critical_section();
+      self->ntbbusy--;
+      leave_critical_section(flags);
+
+      nxsem_post(&self->wrreq_idle);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cdcecm_ncm_receive
+ *
+ * Description:
+ *   Walk the datagram tables of a received OUT NTB and pass each datagram
+ *   to the network.
+ *
+ * Input Parameters:
+ *   priv - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void cdcecm_ncm_receive(FAR struct cdcecm_driver_s *self)
+{
+  FAR uint8_t *buf = self->rdreq->buf;
+  FAR struct cdc_ncm_nth16_s *nth = (FAR struct cdc_ncm_nth16_s *)buf;
+  FAR struct cdc_ncm_ndp16_s *ndp;
+  FAR uint8_t *dg;
+  uint16_t blklen;
+  uint16_t ndpidx;
+  uint16_t ndplen;
+  uint16_t dgidx;
+  uint16_t dglen;
+  int nndp;
+  int i;
+
+  if (self->rdreq->xfrd < SIZEOF_NCM_NTH16 ||
+      memcmp(nth->sig, NCM_NTH16_SIGNATURE, 4) != 0)
+    {
+      uwarn("WARNING: Bad NTB header\n");
+      NETDEV_RXERRORS(&self->dev);
+      return;
+    }
+
+  blklen = MIN(GETUINT16(nth->blklen), self->rdreq->xfrd);
+  ndpidx = GETUINT16(nth->ndpidx);
+
+  /* Follow the chain of datagram tables.  The number of tables is bounded
+   * in case a corrupted chain loops.
+   */
+
+  for (nndp = 0; ndpidx != 0 && nndp < CDCECM_NCM_MAXNDPS; nndp++)
+    {
+      ndp = (FAR struct cdc_ncm_ndp16_s *)(buf + ndpidx);
+      if ((ndpidx & 3) != 0 || ndpidx + SIZEOF_NCM_NDP16(2) > blklen ||
+          memcmp(ndp->sig, NCM_NDP16_SIGNATURE, 4) != 0)
+        {
+          uwarn("WARNING: Bad NDP at %u\n", ndpidx);
+          NETDEV_RXERRORS(&self->dev);
+          break;
+        }
+
+      ndplen = GETUINT16(ndp->len);
+      if (ndplen < SIZEOF_NCM_NDP16(2) || ndpidx + ndplen > blklen)
+        {
+          NETDEV_RXERRORS(&self->dev);
+          break;
+        }
+
+      for (i = 0; SIZEOF_NCM_NDP16(i + 1) <= ndplen; i++)
+        {
+          dg    = (FAR uint8_t *)ndp + SIZEOF_NCM_NDP16(i);
+          dgidx = GETUINT16(dg);
+          dglen = (uint16_t)(dg[3] << 8) | dg[2];
+
+          /* The table ends with a null entry */
+
+          if (dgidx == 0 || dglen == 0)
+            {
+              break;
+            }
+
+          if (dgidx + dglen > blklen)
+            {
+              NETDEV_RXERRORS(&self->dev);
+              continue;
+            }
+
+          cdcecm_receive(self, buf + dgidx, dglen);
+        }
+
+      ndpidx = GETUINT16(ndp->nextidx);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: cdcecm_txdone
  *
@@ -537,7 +836,11 @@ static void cdcecm_interrupt_work(FAR void *arg)
 
   if (self->rxpending)
     {
-      cdcecm_receive(self);
+#ifdef CONFIG_CDCECM_NCM
+      cdcecm_ncm_receive(self);
+#else
+      cdcecm_receive(self, self->rdreq->buf, self->rdreq->xfrd);
+#endif
 
       flags = enter_critical_section();
       self->rxpending = false;
@@ -559,6 +862,17 @@ static void cdcecm_interrupt_work(FAR void *arg)
       cdcecm_txdone(self);
     }
 
+#ifdef CONFIG_CDCECM_NCM
+  /* Send the IN NTB gathered so far unless one is still being sent, its
+   * completion will bring us here again.
+   */
+
+  if (self->ntbbusy == 0)
+    {
+      cdcecm_ncm_flush(self);
+    }
+#endif
+
   net_unlock();
 }
 
@@ -684,6 +998,13 @@ static void cdcecm_txavail_work(FAR void *arg)
   if (self->bifup)
     {
       devif_poll(&self->dev, cdcecm_txpoll);
+
+#ifdef CONFIG_CDCECM_NCM
+      if (self->ntbbusy == 0)
+        {
+          cdcecm_ncm_flush(self);
+        }
+#endif
     }
 
   net_unlock();
@@ -979,6 +1300,10 @@ static void cdcecm_wrcomplete(FAR struct usbdev_ep_s *ep,
    * transmissions again.
    */
 
+#ifdef CONFIG_CDCECM_NCM
+  self->ntbbusy--;
+#endif
+
   rc = nxsem_post(&self->wrreq_idle);
 
   if (rc != OK)
@@ -1091,6 +1416,12 @@ static int cdcecm_setconfig(FAR struct cdcecm_driver_s *self, uint8_t config)
 
   DEBUGASSERT(!self->rxpending);
 
+#ifdef CONFIG_CDCECM_NCM
+  /* Start with the largest IN NTBs until the host selects a size */
+
+  self->ntbinsize = CONFIG_CDCECM_NCM_NTBSIZE;
+#endif
+
   self->rdreq->callback = cdcecm_rdcomplete,
   ret = EP_SUBMIT(self->epbulkout, self->rdreq);
   if (ret != OK)
@@ -1349,7 +1680,7 @@ static int16_t cdcecm_mkcfgdesc(FAR uint8_t *desc,
       iaddesc->firstif   = devinfo->ifnobase;                   /* Number of first interface of the function */
       iaddesc->nifs      = devinfo->ninterfaces;                /* Number of interfaces associated with the function */
       iaddesc->classid   = USB_CLASS_CDC;                       /* Class code */
-      iaddesc->subclass  = CDC_SUBCLASS_ECM;                    /* Sub-class code */
+      iaddesc->subclass  = CDCECM_SUBCLASS;                     /* Sub-class code */
       iaddesc->protocol  = CDC_PROTO_NONE;                      /* Protocol code */
       iaddesc->ifunction = 0;                                   /* Index to string identifying the function */
 
@@ -1371,7 +1702,7 @@ static int16_t cdcecm_mkcfgdesc(FAR uint8_t *desc,
       ifdesc->alt      = 0;
       ifdesc->neps     = 1;
       ifdesc->classid  = USB_CLASS_CDC;
-      ifdesc->subclass = CDC_SUBCLASS_ECM;
+      ifdesc->subclass = CDCECM_SUBCLASS;
       ifdesc->protocol = CDC_PROTO_NONE;
       ifdesc->iif      = 0;
 
@@ -1436,6 +1767,25 @@ static int16_t cdcecm_mkcfgdesc(FAR uint8_t *desc,
 
   len += SIZEOF_ECM_FUNCDESC;
 
+#ifdef CONFIG_CDCECM_NCM
+  if (desc)
+    {
+      FAR struct cdc_ncm_funcdesc_s *ncmdesc;
+
+      ncmdesc = (FAR struct cdc_ncm_funcdesc_s *)desc;
+      ncmdesc->size       = SIZEOF_NCM_FUNCDESC;
+      ncmdesc->type       = USB_DESC_TYPE_CSINTERFACE;
+      ncmdesc->subtype    = CDC_DSUBTYPE_NCM;
+      ncmdesc->version[0] = LSBYTE(0x0100);
+      ncmdesc->version[1] = MSBYTE(0x0100);
+      ncmdesc->netcaps    = NCMCAP_PACKET_FILTER;
+
+      desc += SIZEOF_NCM_FUNCDESC;
+    }
+
+  len += SIZEOF_NCM_FUNCDESC;
+#endif
+
   if (desc)
     {
       FAR struct usb_epdesc_s *epdesc = (FAR struct usb_epdesc_s *)desc;
@@ -1459,8 +1809,8 @@ static int16_t cdcecm_mkcfgdesc(FAR uint8_t *desc,
       ifdesc->alt      = 0;
       ifdesc->neps     = 0;
       ifdesc->classid  = USB_CLASS_CDC_DATA;
-      ifdesc->subclass = CDC_SUBCLASS_ECM;
-      ifdesc->protocol = CDC_PROTO_NONE;
+      ifdesc->subclass = CDCECM_DATASUBCLASS;
+      ifdesc->protocol = CDCECM_DATAPROTO;
       ifdesc->iif      = 0;
 
       desc += USB_SIZEOF_IFDESC;
@@ -1479,8 +1829,8 @@ static int16_t cdcecm_mkcfgdesc(FAR uint8_t *desc,
       ifdesc->alt      = 1;
       ifdesc->neps     = 2;
       ifdesc->classid  = USB_CLASS_CDC_DATA;
-      ifdesc->subclass = CDC_SUBCLASS_ECM;
-      ifdesc->protocol = CDC_PROTO_NONE;
+      ifdesc->subclass = CDCECM_DATASUBCLASS;
+      ifdesc->protocol = CDCECM_DATAPROTO;
       ifdesc->iif      = 0;
 
       desc += USB_SIZEOF_IFDESC;
@@ -1518,6 +1868,37 @@ static int16_t cdcecm_mkcfgdesc(FAR uint8_t *desc,
   return len;
 }
 
+/****************************************************************************
+ * Name: cdcecm_ncm_ntbparms
+ *
+ * Description:
+ *   Construct the NTB parameter structure returned to GetNtbParameters
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CDCECM_NCM
+static int cdcecm_ncm_ntbparms(FAR uint8_t *buf)
+{
+  FAR struct cdc_ncm_ntbparms_s *parms =
+    (FAR struct cdc_ncm_ntbparms_s *)buf;
+
+  memset(parms, 0, SIZEOF_NCM_NTBPARMS);
+  parms->len[0]        = LSBYTE(SIZEOF_NCM_NTBPARMS);
+  parms->len[1]        = MSBYTE(SIZEOF_NCM_NTBPARMS);
+  parms->formats[0]    = 1; /* NTB16 only */
+  parms->inmaxsize[0]  = LSBYTE(CONFIG_CDCECM_NCM_NTBSIZE);
+  parms->inmaxsize[1]  = MSBYTE(CONFIG_CDCECM_NCM_NTBSIZE);
+  parms->indivisor[0]  = CDCECM_NCM_ALIGN;
+  parms->inalign[0]    = CDCECM_NCM_ALIGN;
+  parms->outmaxsize[0] = LSBYTE(CONFIG_CDCECM_NCM_NTBSIZE);
+  parms->outmaxsize[1] = MSBYTE(CONFIG_CDCECM_NCM_NTBSIZE);
+  parms->outdivisor[0] = CDCECM_NCM_ALIGN;
+  parms->outalign[0]   = CDCECM_NCM_ALIGN;
+
+  return SIZEOF_NCM_NTBPARMS;
+}
+#endif
+
 /****************************************************************************
  * Name: cdcecm_getdescriptor
  *
@@ -1598,6 +1979,9 @@ static int cdcecm_bind(FAR struct usbdevclass_driver_s *driver,
                        FAR struct usbdev_s *dev)
 {
   FAR struct cdcecm_driver_s *self = (FAR struct cdcecm_driver_s *)driver;
+#ifdef CONFIG_CDCECM_NCM
+  int i;
+#endif
   int ret = OK;
 
   uinfo("\n");
@@ -1642,10 +2026,11 @@ static int cdcecm_bind(FAR struct usbdevclass_driver_s *driver,
   self->epbulkin->priv  = self;
   self->epbulkout->priv = self;
 
-  /* Pre-allocate read requests.  The buffer size is one full packet. */
+  /* Pre-allocate read requests.  The buffer size is one full packet, or
+   * one full NTB in NCM mode.
+   */
 
-  self->rdreq = usbdev_allocreq(self->epbulkout,
-                  CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE);
+  self->rdreq = usbdev_allocreq(self->epbulkout, CDCECM_RDREQLEN);
   if (self->rdreq == NULL)
     {
       uerr("Out of memory\n");
@@ -1655,10 +2040,34 @@ static int cdcecm_bind(FAR struct usbdevclass_driver_s *driver,
 
   self->rdreq->callback = cdcecm_rdcomplete;
 
+#ifdef CONFIG_CDCECM_NCM
+  /* Pre-allocate the write requests of the IN NTBs */
+
+  for (i = 0; i < CDCECM_NCM_NWRREQS; i++)
+    {
+      self->wrreqs[i] = usbdev_allocreq(self->epbulkin, CDCECM_WRREQLEN);
+      if (self->wrreqs[i] == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
+
+      self->wrreqs[i]->callback = cdcecm_wrcomplete;
+    }
+
+  self->ntb       = NULL;
+  self->ntbnext   = 0;
+  self->ntbbusy   = 0;
+  self->ntbinsize = CONFIG_CDCECM_NCM_NTBSIZE;
+
+  /* All the write requests just allocated are available now. */
+
+  ret = nxsem_init(&self->wrreq_idle, 0, CDCECM_NCM_NWRREQS);
+#else
   /* Pre-allocate a single write request.  Buffer size is one full packet. */
 
-  self->wrreq = usbdev_allocreq(self->epbulkin,
-                  CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE);
+  self->wrreq = usbdev_allocreq(self->epbulkin, CDCECM_WRREQLEN);
   if (self->wrreq == NULL)
     {
       uerr("Out of memory\n");
@@ -1671,6 +2080,7 @@ static int cdcecm_bind(FAR struct usbdevclass_driver_s *driver,
   /* The single write request just allocated is available now. */
 
   ret = nxsem_init(&self->wrreq_idle, 0, 1);
+#endif
 
   if (ret != OK)
     {
@@ -1704,6 +2114,9 @@ static void cdcecm_unbind(FAR struct usbdevclass_driver_s *driver,
                           FAR struct usbdev_s *dev)
 {
   FAR struct cdcecm_driver_s *self = (FAR struct cdcecm_driver_s *)driver;
+#ifdef CONFIG_CDCECM_NCM
+  int i;
+#endif
 
 #ifdef CONFIG_DEBUG_FEATURES
   if (!driver || !dev)
@@ -1761,11 +2174,24 @@ static void cdcecm_unbind(FAR struct usbdevclass_driver_s *driver,
    * of them)
    */
 
+#ifdef CONFIG_CDCECM_NCM
+  for (i = 0; i < CDCECM_NCM_NWRREQS; i++)
+    {
+      if (self->wrreqs[i] != NULL)
+        {
+          usbdev_freereq(self->epbulkin, self->wrreqs[i]);
+          self->wrreqs[i] = NULL;
+        }
+    }
+
+  self->ntb = NULL;
+#else
   if (self->wrreq != NULL)
     {
       usbdev_freereq(self->epbulkin, self->wrreq);
       self->wrreq = NULL;
     }
+#endif
 
   /* Free the bulk IN endpoint */
 
@@ -1840,6 +2266,58 @@ static int cdcecm_setup(FAR struct usbdevclass_driver_s *driver,
             ret = OK;
             break;
 
+#ifdef CONFIG_CDCECM_NCM
+          case NCM_GET_NTB_PARAMETERS:
+            ret = cdcecm_ncm_ntbparms(self->ctrlreq->buf);
+            break;
+
+          case NCM_GET_NTB_FORMAT:
+
+            /* Only the 16-bit NTB format is supported */
+
+            memset(self->ctrlreq->buf, 0, 2);
+            ret = 2;
+            break;
+
+          case NCM_SET_NTB_FORMAT:
+            ret = value == 0 ? OK : -EINVAL;
+            break;
+
+          case NCM_GET_NTB_INPUT_SIZE:
+            {
+              FAR uint8_t *buf = self->ctrlreq->buf;
+
+              buf[0] = LSBYTE(self->ntbinsize);
+              buf[1] = MSBYTE(self->ntbinsize);
+              buf[2] = 0;
+              buf[3] = 0;
+              ret    = 4;
+            }
+            break;
+
+          case NCM_SET_NTB_INPUT_SIZE:
+
+            /* Not all device controller drivers provide the EP0 OUT data
+             * with the setup command, the IN NTBs keep their size then.
+             */
+
+            ret = OK;
+            if (dataout != NULL && outlen >= 4)
+              {
+                uint32_t size = GETUINT32(dataout);
+
+                if (size < 2048 || size > CONFIG_CDCECM_NCM_NTBSIZE)
+                  {
+                    ret = -EINVAL;
+                  }
+                else
+                  {
+                    self->ntbinsize = size;
+                  }
+              }
+            break;
+#endif
+
           default:
             uwarn("Unsupported class req: 0x%02hhx\n", ctrl->req);
             break;
@@ -37,7 +37,11 @@
  ****************************************************************************/
 
 #define CDCECM_VERSIONNO         (0x0100)
-#define CDCECM_MXDESCLEN         (80)
+#ifdef CONFIG_CDCECM_NCM
+#  define CDCECM_MXDESCLEN       (86)
+#else
+#  define CDCECM_MXDESCLEN       (80)
+#endif
 #define CDCECM_MAXSTRLEN         (CDCECM_MXDESCLEN - 2)
 #define CDCECM_NCONFIGS          (1)
 #define CDCECM_NINTERFACES       (2)
@@ -58,4 +62,18 @@
 #define CDCECM_SELFPOWERED       (0)
 #define CDCECM_REMOTEWAKEUP      (0)
 
+/* The NCM mode reports itself with the NCM subclass and runs the NTB
+ * protocol on the data interface, everything else is shared with ECM.
+ */
+
+#ifdef CONFIG_CDCECM_NCM
+#  define CDCECM_SUBCLASS        CDC_SUBCLASS_NCM
+#  define CDCECM_DATASUBCLASS    CDC_DATA_SUBCLASS_NONE
+#  define CDCECM_DATAPROTO       CDC_DATA_PROTO_NCMNTB
+#else
+#  define CDCECM_SUBCLASS        CDC_SUBCLASS_ECM
+#  define CDCECM_DATASUBCLASS    CDC_SUBCLASS_ECM
+#  define CDCECM_DATAPROTO       CDC_PROTO_NONE
+#endif
+
 #endif /* __DRIVERS_USBDEV_CDCECM_H */
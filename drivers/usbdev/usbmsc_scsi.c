@@ -2226,6 +2226,12 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
  *   nreqbytes  - holds the number of bytes currently buffered in the request
  *                at the head of the wrreqlist.
  *
+ *   When a write request holds at least one whole sector, as many sectors
+ *   as fit are read straight into the request which is then submitted, so
+ *   the block driver fills the next request while the previous ones are
+ *   being sent.  Otherwise the sectors are read into the I/O buffer and
+ *   sent in packet sized pieces.
+ *
  ****************************************************************************/
 
 static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
@@ -2235,6 +2241,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
   FAR struct usbdev_req_s *req;
   irqstate_t flags;
   ssize_t nread;
+  uint32_t nsectors;
   uint8_t *src;
   uint8_t *dest;
   int nbytes;
@@ -2249,6 +2256,69 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
     {
       usbtrace(TRACE_CLASSSTATE(USBMSC_CLASSSTATE_CMDREAD), priv->u.xfrlen);
 
+      /* Can whole sectors be read straight into the next request? */
+
+      if (priv->nsectbytes <= 0 && priv->nreqbytes == 0 &&
+          CONFIG_USBMSC_BULKINREQLEN >= lun->sectorsize)
+        {
+          flags   = enter_critical_section();
+          privreq = (FAR struct usbmsc_req_s *)sq_remfirst(&priv->wrreqlist);
+          leave_critical_section(flags);
+
+          /* If there no request structures available, then remain in the
+           * CMDREAD state until a request is returned.
+           */
+
+          if (!privreq)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADWRRQEMPTY), 0);
+              return -ENOMEM;
+            }
+
+          req      = privreq->req;
+          nsectors = MIN(priv->u.xfrlen,
+                         CONFIG_USBMSC_BULKINREQLEN / lun->sectorsize);
+
+          nread = USBMSC_DRVR_READ(lun, req->buf, priv->sector, nsectors);
+          if (nread <= 0)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL),
+                       -nread);
+              lun->sd     = SCSI_KCQME_UNRRE1;
+              lun->sdinfo = priv->sector;
+
+              flags = enter_critical_section();
+              sq_addfirst((FAR sq_entry_t *)privreq, &priv->wrreqlist);
+              leave_critical_section(flags);
+              break;
+            }
+
+          /* The block driver may have transferred fewer sectors */
+
+          nsectors = MIN(nread, nsectors);
+
+          req->len      = nsectors * lun->sectorsize;
+          req->priv     = privreq;
+          req->callback = usbmsc_wrcomplete;
+          req->flags    = 0;
+
+          priv->u.xfrlen -= nsectors;
+          priv->sector   += nsectors;
+
+          ret = EP_SUBMIT(priv->epbulkin, req);
+          if (ret != OK)
+            {
+              usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADSUBMIT),
+                       (uint16_t)-ret);
+              lun->sd     = SCSI_KCQME_UNRRE1;
+              lun->sdinfo = priv->sector;
+              break;
+            }
+
+          priv->residue -= req->len;
+          continue;
+        }
+
       /* Is the I/O buffer empty? */
 
       if (priv->nsectbytes <= 0)
@@ -0,0 +1,571 @@
+/****************************************************************************
+ * drivers/usrsock/usrsock_ring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET_USRSOCK_RING)
+
+#include <sys/types.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <poll.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/usrsock.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_USRSOCKDEV_NPOLLWAITERS
+#  define CONFIG_NET_USRSOCKDEV_NPOLLWAITERS 1
+#endif
+
+#if (CONFIG_NET_USRSOCK_RING_SIZE & (CONFIG_NET_USRSOCK_RING_SIZE - 1)) != 0
+#  error CONFIG_NET_USRSOCK_RING_SIZE must be a power of two
+#endif
+
+/* Layout of the shared area: the header, then the two rings */
+
+#define USRSOCK_RING_REQOFF \
+  USRSOCK_RING_ALIGN(sizeof(struct usrsock_ring_s))
+#define USRSOCK_RING_RESPOFF \
+  (USRSOCK_RING_REQOFF + CONFIG_NET_USRSOCK_RING_SIZE)
+#define USRSOCK_RING_MAPSIZE \
+  (USRSOCK_RING_RESPOFF + CONFIG_NET_USRSOCK_RING_SIZE)
+
+#define USRSOCK_RING_MASK   (CONFIG_NET_USRSOCK_RING_SIZE - 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct usrsockring_s
+{
+  mutex_t  devlock;  /* Lock for device node */
+  sem_t    spacesem; /* Wakes the requests waiting for ring space */
+  uint8_t  ocount;   /* The number of times the device has been opened */
+  uint8_t  nwaiters; /* The number of requests waiting for ring space */
+
+  /* The area shared with the daemon, and the poll waiters */
+
+  FAR struct usrsock_ring_s *ring;
+  FAR struct pollfd *pollfds[CONFIG_NET_USRSOCKDEV_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Character driver methods */
+
+static int usrsockring_open(FAR struct file *filep);
+
+static int usrsockring_close(FAR struct file *filep);
+
+static int usrsockring_ioctl(FAR struct file *filep, int cmd,
+                             unsigned long arg);
+
+static int usrsockring_mmap(FAR struct file *filep,
+                            FAR struct mm_map_entry_s *map);
+
+static int usrsockring_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                            bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_usrsockringops =
+{
+  usrsockring_open,   /* open */
+  usrsockring_close,  /* close */
+  NULL,               /* read */
+  NULL,               /* write */
+  NULL,               /* seek */
+  usrsockring_ioctl,  /* ioctl */
+  usrsockring_mmap,   /* mmap */
+  NULL,               /* truncate */
+  usrsockring_poll    /* poll */
+};
+
+static struct usrsockring_s g_usrsockring =
+{
+  NXMUTEX_INITIALIZER,
+  SEM_INITIALIZER(0)
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: usrsockring_wakeup
+ *
+ * Description:
+ *   Wake up all the requests waiting for space in the request ring, so
+ *   that they check the ring again.
+ *
+ ****************************************************************************/
+
+static void usrsockring_wakeup(FAR struct usrsockring_s *dev)
+{
+  while (dev->nwaiters > 0)
+    {
+      dev->nwaiters--;
+      nxsem_post(&dev->spacesem);
+    }
+}
+
+/****************************************************************************
+ * Name: usrsockring_kick
+ *
+ * Description:
+ *   Pass the records of the response ring to the usrsock stack.
+ *
+ * Returned Value:
+ *   The number of responses handled, or -EINVAL if the ring is corrupted.
+ *
+ ****************************************************************************/
+
+static int usrsockring_kick(FAR struct usrsockring_s *dev)
+{
+  FAR struct usrsock_ring_s *ring = dev->ring;
+  FAR uint8_t *base = (FAR uint8_t *)ring + USRSOCK_RING_RESPOFF;
+  FAR struct usrsock_ringrec_s *rec;
+  uint32_t head;
+  uint32_t pos;
+  uint32_t len;
+  ssize_t ret;
+  int nresp = 0;
+
+  /* Read the head before the records it covers */
+
+  head = ring->resphead;
+  SEQ_DMB();
+
+  while (ring->resptail != head)
+    {
+      pos = ring->resptail & USRSOCK_RING_MASK;
+      rec = (FAR struct usrsock_ringrec_s *)(base + pos);
+      len = rec->len;
+
+      if (len == USRSOCK_RING_PAD)
+        {
+          ring->resptail += CONFIG_NET_USRSOCK_RING_SIZE - pos;
+          continue;
+        }
+
+      if (len > CONFIG_NET_USRSOCK_RING_SIZE - pos - sizeof(*rec) ||
+          USRSOCK_RING_ALIGN(sizeof(*rec) + len) > head - ring->resptail)
+        {
+          nerr("ERROR: bad response record, len=%" PRIu32 "\n", len);
+          ring->resptail = head;
+          return -EINVAL;
+        }
+
+      ret = usrsock_response((FAR const char *)(rec + 1), len, NULL);
+      if (ret < 0)
+        {
+          nwarn("WARNING: response dropped: %zd\n", ret);
+        }
+      else
+        {
+          nresp++;
+        }
+
+      ring->resptail += USRSOCK_RING_ALIGN(sizeof(*rec) + len);
+    }
+
+  return nresp;
+}
+
+/****************************************************************************
+ * Name: usrsockring_open
+ ****************************************************************************/
+
+static int usrsockring_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct usrsockring_s *dev;
+  FAR struct usrsock_ring_s *ring;
+  int ret;
+
+  dev = inode->i_private;
+
+  DEBUGASSERT(dev);
+
+  ret = nxmutex_lock(&dev->devlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ninfo("opening /dev/usrsock\n");
+
+  if (dev->ocount > 0)
+    {
+      /* Only one reference is allowed. */
+
+      nwarn("failed to open\n");
+
+      ret = -EPERM;
+    }
+  else
+    {
+      /* No request is queued while the device is closed, so the new
+       * daemon starts with empty rings.
+       */
+
+      ring           = dev->ring;
+      ring->reqhead  = 0;
+      ring->reqtail  = 0;
+      ring->resphead = 0;
+      ring->resptail = 0;
+
+      dev->ocount    = 1;
+    }
+
+  nxmutex_unlock(&dev->devlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: usrsockring_close
+ ****************************************************************************/
+
+static int usrsockring_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct usrsockring_s *dev;
+  int ret;
+
+  dev = inode->i_private;
+
+  DEBUGASSERT(dev);
+
+  ret = nxmutex_lock(&dev->devlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ninfo("closing /dev/usrsock\n");
+
+  dev->ocount--;
+  DEBUGASSERT(dev->ocount == 0);
+
+  /* The requests waiting for space find the daemon gone. */
+
+  usrsockring_wakeup(dev);
+
+  nxmutex_unlock(&dev->devlock);
+  usrsock_abort();
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: usrsockring_ioctl
+ ****************************************************************************/
+
+static int usrsockring_ioctl(FAR struct file *filep, int cmd,
+                             unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct usrsockring_s *dev;
+  int ret;
+
+  dev = inode->i_private;
+
+  DEBUGASSERT(dev);
+
+  switch (cmd)
+    {
+      case USRSOCKIOC_RINGSIZE:
+        {
+          FAR uint32_t *size = (FAR uint32_t *)((uintptr_t)arg);
+
+          if (size == NULL)
+            {
+              return -EINVAL;
+            }
+
+          *size = USRSOCK_RING_MAPSIZE;
+          return OK;
+        }
+
+      case USRSOCKIOC_KICK:
+        {
+          ret = nxmutex_lock(&dev->devlock);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          ret = usrsockring_kick(dev);
+
+          /* The daemon has advanced reqtail before the kick. */
+
+          usrsockring_wakeup(dev);
+
+          nxmutex_unlock(&dev->devlock);
+          return ret;
+        }
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+/****************************************************************************
+ * Name: usrsockring_mmap
+ ****************************************************************************/
+
+static int usrsockring_mmap(FAR struct file *filep,
+                            FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct usrsockring_s *dev;
+
+  dev = inode->i_private;
+
+  DEBUGASSERT(dev);
+
+  if (map->offset >= 0 && map->offset < USRSOCK_RING_MAPSIZE &&
+      map->length && map->offset + map->length <= USRSOCK_RING_MAPSIZE)
+    {
+      map->vaddr = (FAR char *)dev->ring + map->offset;
+      return OK;
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: usrsockring_poll
+ ****************************************************************************/
+
+static int usrsockring_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                            bool setup)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct usrsockring_s *dev;
+  int ret;
+  int i;
+
+  dev = inode->i_private;
+
+  DEBUGASSERT(dev);
+
+  ret = nxmutex_lock(&dev->devlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (setup)
+    {
+      for (i = 0; i < nitems(dev->pollfds); i++)
+        {
+          if (!dev->pollfds[i])
+            {
+              dev->pollfds[i] = fds;
+              fds->priv = &dev->pollfds[i];
+              break;
+            }
+        }
+
+      if (i >= nitems(dev->pollfds))
+        {
+          fds->priv = NULL;
+          ret = -EBUSY;
+          goto errout;
+        }
+
+      /* Notify the POLLIN event if requests are pending. */
+
+      if (dev->ring->reqhead != dev->ring->reqtail)
+        {
+          poll_notify(dev->pollfds, nitems(dev->pollfds), POLLIN);
+        }
+    }
+  else
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      if (!slot)
+        {
+          ret = -EIO;
+          goto errout;
+        }
+
+      *slot = NULL;
+      fds->priv = NULL;
+    }
+
+errout:
+  nxmutex_unlock(&dev->devlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: usrsock_request
+ *
+ * Description:
+ *   Copy the request to the request ring as one record.  The caller's
+ *   buffers are no longer needed when this function returns.
+ *
+ ****************************************************************************/
+
+int usrsock_request(FAR struct iovec *iov, unsigned int iovcnt)
+{
+  FAR struct usrsockring_s *dev = &g_usrsockring;
+  FAR struct usrsock_ring_s *ring = dev->ring;
+  FAR uint8_t *base = (FAR uint8_t *)ring + USRSOCK_RING_REQOFF;
+  FAR struct usrsock_ringrec_s *rec;
+  uint32_t contig;
+  uint32_t space;
+  uint32_t need;
+  uint32_t pos;
+  size_t len = 0;
+  int ret = OK;
+  int i;
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
+
+  if (len > CONFIG_NET_USRSOCK_RING_SIZE - sizeof(*rec))
+    {
+      nwarn("WARNING: request too large for the ring: %zu\n", len);
+      return -EMSGSIZE;
+    }
+
+  need = USRSOCK_RING_ALIGN(sizeof(*rec) + len);
+
+  net_mutex_lock(&dev->devlock);
+
+  for (; ; )
+    {
+      if (dev->ocount == 0)
+        {
+          ninfo("daemon abruptly closed /dev/usrsock.\n");
+          ret = -ENETDOWN;
+          goto errout;
+        }
+
+      pos    = ring->reqhead & USRSOCK_RING_MASK;
+      contig = CONFIG_NET_USRSOCK_RING_SIZE - pos;
+      space  = CONFIG_NET_USRSOCK_RING_SIZE -
+               (ring->reqhead - ring->reqtail);
+
+      if (need > contig && space >= contig)
+        {
+          /* The record does not fit before the end: skip the end. */
+
+          rec = (FAR struct usrsock_ringrec_s *)(base + pos);
+          rec->len = USRSOCK_RING_PAD;
+          SEQ_DMB();
+          ring->reqhead += contig;
+          continue;
+        }
+
+      if (need <= contig && space >= need)
+        {
+          break;
+        }
+
+      /* Have the daemon release the space of the handled requests. */
+
+      poll_notify(dev->pollfds, nitems(dev->pollfds), POLLIN);
+
+      dev->nwaiters++;
+      nxmutex_unlock(&dev->devlock);
+      net_sem_wait_uninterruptible(&dev->spacesem);
+      net_mutex_lock(&dev->devlock);
+    }
+
+  rec = (FAR struct usrsock_ringrec_s *)(base + pos);
+  rec->len = len;
+  usrsock_iovec_get(rec + 1, len, iov, iovcnt, 0, NULL);
+
+  /* Publish the record after its content */
+
+  SEQ_DMB();
+  ring->reqhead += need;
+
+  poll_notify(dev->pollfds, nitems(dev->pollfds), POLLIN);
+
+errout:
+  nxmutex_unlock(&dev->devlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: usrsock_register
+ *
+ * Description:
+ *   Allocate the shared rings and register /dev/usrsock
+ *
+ ****************************************************************************/
+
+void usrsock_register(void)
+{
+  FAR struct usrsock_ring_s *ring;
+
+  /* The daemon maps the rings, so they live in the user heap. */
+
+  ring = kumm_zalloc(USRSOCK_RING_MAPSIZE);
+  if (ring == NULL)
+    {
+      nerr("ERROR: failed to allocate the usrsock rings\n");
+      return;
+    }
+
+  ring->size    = CONFIG_NET_USRSOCK_RING_SIZE;
+  ring->reqoff  = USRSOCK_RING_REQOFF;
+  ring->respoff = USRSOCK_RING_RESPOFF;
+
+  g_usrsockring.ring = ring;
+  register_driver("/dev/usrsock", &g_usrsockringops, 0666,
+                  &g_usrsockring);
+}
+
+#endif /* CONFIG_NET_USRSOCK_RING */
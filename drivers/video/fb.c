@@ -35,9 +35,12 @@
 #include <errno.h>
 #include <poll.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/mm/circbuf.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/video/fb.h>
 #include <nuttx/clock.h>
 #include <nuttx/wdog.h>
@@ -66,6 +69,11 @@ struct fb_chardev_s
   volatile bool pollready;        /* Poll ready flag */
   clock_t vsyncoffset;            /* VSync offset ticks */
   struct wdog_s wdog;             /* VSync offset timer */
+  struct circbuf_s panbuf;        /* Pans waiting for vertical sync */
+#ifdef CONFIG_FB_SYNC
+  sem_t vsyncsem;                 /* Wakes up FBIO_WAITFORVSYNC */
+  int16_t nvsyncwait;             /* Number of threads waiting for it */
+#endif
 #ifdef CONFIG_FB_OVERLAY
   int overlay;                    /* Overlay number */
 #endif
@@ -498,7 +506,25 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 #ifdef CONFIG_FB_SYNC
       case FBIO_WAITFORVSYNC:  /* Wait upon vertical sync */
         {
-          ret = fb->vtable->waitforvsync(fb->vtable);
+          irqstate_t flags;
+
+          if (fb->vtable->waitforvsync != NULL)
+            {
+              ret = fb->vtable->waitforvsync(fb->vtable);
+              break;
+            }
+
+          /* The lower half reports it with fb_vsyncnotify() instead */
+
+          flags = enter_critical_section();
+          fb->nvsyncwait++;
+          ret = nxsem_wait(&fb->vsyncsem);
+          if (ret < 0)
+            {
+              fb->nvsyncwait--;
+            }
+
+          leave_critical_section(flags);
         }
         break;
 #endif
@@ -677,10 +703,41 @@ static int fb_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
           FAR struct fb_planeinfo_s *pinfo =
             (FAR struct fb_planeinfo_s *)((uintptr_t)arg);
 
-          DEBUGASSERT(pinfo != NULL && fb->vtable != NULL &&
-                      fb->vtable->pandisplay != NULL);
-          ret = fb->vtable->pandisplay(fb->vtable, pinfo);
-          fb->pollready = false;
+          irqstate_t flags;
+
+          DEBUGASSERT(pinfo != NULL && fb->vtable != NULL);
+
+          if (!circbuf_is_init(&fb->panbuf))
+            {
+              DEBUGASSERT(fb->vtable->pandisplay != NULL);
+              ret = fb->vtable->pandisplay(fb->vtable, pinfo);
+              fb->pollready = false;
+              break;
+            }
+
+          /* Queue the pan, the lower half shows it on the next vertical
+           * sync and releases the buffer that was shown until then.  The
+           * device stays writable while a buffer is free.
+           */
+
+          flags = enter_critical_section();
+          if (circbuf_space(&fb->panbuf) < sizeof(*pinfo))
+            {
+              ret = -EBUSY;
+            }
+          else
+            {
+              circbuf_write(&fb->panbuf, pinfo, sizeof(*pinfo));
+              fb->pollready = circbuf_space(&fb->panbuf) >= sizeof(*pinfo);
+              ret = OK;
+            }
+
+          leave_critical_section(flags);
+
+          if (ret >= 0 && fb->vtable->pandisplay != NULL)
+            {
+              ret = fb->vtable->pandisplay(fb->vtable, pinfo);
+            }
         }
         break;
 
@@ -1029,6 +1086,148 @@ void fb_pollnotify(FAR struct fb_vtable_s *vtable)
     }
 }
 
+/****************************************************************************
+ * Name: fb_paninfo_count
+ *
+ * Description:
+ *   Return the number of pans that wait for the vertical sync.  This may
+ *   be called from the vertical sync interrupt handler.
+ *
+ * Input Parameters:
+ *   vtable - Pointer to framebuffer's virtual table.
+ *
+ ****************************************************************************/
+
+int fb_paninfo_count(FAR struct fb_vtable_s *vtable)
+{
+  FAR struct fb_chardev_s *fb = vtable->priv;
+  irqstate_t flags;
+  int count;
+
+  if (fb == NULL || !circbuf_is_init(&fb->panbuf))
+    {
+      return 0;
+    }
+
+  flags = enter_critical_section();
+  count = circbuf_used(&fb->panbuf) / sizeof(struct fb_planeinfo_s);
+  leave_critical_section(flags);
+  return count;
+}
+
+/****************************************************************************
+ * Name: fb_peek_paninfo
+ *
+ * Description:
+ *   Get the oldest pan that waits for the vertical sync, so that the lower
+ *   half can program the scan out address of its buffer.  The pan stays
+ *   queued until fb_remove_paninfo().  This may be called from the
+ *   vertical sync interrupt handler.
+ *
+ * Input Parameters:
+ *   vtable - Pointer to framebuffer's virtual table.
+ *   pinfo  - Returns the plane information given to FBIOPAN_DISPLAY.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODATA if no pan is queued.
+ *
+ ****************************************************************************/
+
+int fb_peek_paninfo(FAR struct fb_vtable_s *vtable,
+                    FAR struct fb_planeinfo_s *pinfo)
+{
+  FAR struct fb_chardev_s *fb = vtable->priv;
+  irqstate_t flags;
+  ssize_t ret;
+
+  if (fb == NULL || !circbuf_is_init(&fb->panbuf))
+    {
+      return -ENODATA;
+    }
+
+  flags = enter_critical_section();
+  ret   = circbuf_peek(&fb->panbuf, pinfo, sizeof(*pinfo));
+  leave_critical_section(flags);
+
+  return ret == sizeof(*pinfo) ? OK : -ENODATA;
+}
+
+/****************************************************************************
+ * Name: fb_remove_paninfo
+ *
+ * Description:
+ *   Remove the oldest pan once the hardware shows its buffer.  The buffer
+ *   that was shown until then is released and the waiting thread is
+ *   notified that it can be written, as by fb_pollnotify().  This may be
+ *   called from the vertical sync interrupt handler.
+ *
+ * Input Parameters:
+ *   vtable - Pointer to framebuffer's virtual table.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODATA if no pan is queued.
+ *
+ ****************************************************************************/
+
+int fb_remove_paninfo(FAR struct fb_vtable_s *vtable)
+{
+  FAR struct fb_chardev_s *fb = vtable->priv;
+  irqstate_t flags;
+  ssize_t ret;
+
+  if (fb == NULL || !circbuf_is_init(&fb->panbuf))
+    {
+      return -ENODATA;
+    }
+
+  flags = enter_critical_section();
+  ret   = circbuf_skip(&fb->panbuf, sizeof(struct fb_planeinfo_s));
+  leave_critical_section(flags);
+
+  if (ret != sizeof(struct fb_planeinfo_s))
+    {
+      return -ENODATA;
+    }
+
+  fb_pollnotify(vtable);
+  return OK;
+}
+
+#ifdef CONFIG_FB_SYNC
+/****************************************************************************
+ * Name: fb_vsyncnotify
+ *
+ * Description:
+ *   Wake up the threads waiting in FBIO_WAITFORVSYNC.  This is called from
+ *   the vertical sync interrupt handler of a lower half that does not
+ *   provide the waitforvsync method.
+ *
+ * Input Parameters:
+ *   vtable - Pointer to framebuffer's virtual table.
+ *
+ ****************************************************************************/
+
+void fb_vsyncnotify(FAR struct fb_vtable_s *vtable)
+{
+  FAR struct fb_chardev_s *fb = vtable->priv;
+  irqstate_t flags;
+
+  if (fb == NULL)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  while (fb->nvsyncwait > 0)
+    {
+      fb->nvsyncwait--;
+      nxsem_post(&fb->vsyncsem);
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Name: fb_register
  *
@@ -1056,11 +1255,13 @@ int fb_register(int display, int plane)
 {
   FAR struct fb_chardev_s *fb;
   struct fb_panelinfo_s panelinfo;
+  struct fb_planeinfo_s pinfo;
   struct fb_videoinfo_s vinfo;
 #ifdef CONFIG_FB_OVERLAY
   struct fb_overlayinfo_s oinfo;
 #endif
   char devname[16];
+  int nbuffers;
   int nplanes;
   int ret;
 
@@ -1155,21 +1356,54 @@ int fb_register(int display, int plane)
       snprintf(devname, 16, "/dev/fb%d.%d", display, plane);
     }
 
+  /* With more than one buffer in the virtual resolution, all but the one
+   * that is shown can wait for the vertical sync.
+   */
+
+  memset(&pinfo, 0, sizeof(pinfo));
+  ret = fb->vtable->getplaneinfo(fb->vtable, plane, &pinfo);
+  if (ret < 0)
+    {
+      goto errout_with_fb;
+    }
+
+  nbuffers = vinfo.yres > 0 ? pinfo.yres_virtual / vinfo.yres : 0;
+  if (nbuffers > 1)
+    {
+      ret = circbuf_init(&fb->panbuf, NULL,
+                         (nbuffers - 1) * sizeof(struct fb_planeinfo_s));
+      if (ret < 0)
+        {
+          goto errout_with_fb;
+        }
+
+      fb->pollready = true;
+    }
+
   nxmutex_init(&fb->lock);
+#ifdef CONFIG_FB_SYNC
+  nxsem_init(&fb->vsyncsem, 0, 0);
+#endif
 
   ret = register_driver(devname, &g_fb_fops, 0666, (FAR void *)fb);
   if (ret < 0)
     {
       gerr("ERROR: register_driver() failed: %d\n", ret);
-      goto errout_with_fb;
+      goto errout_with_panbuf;
     }
 
   fb->vtable->priv = fb;
 
   return OK;
 
-errout_with_fb:
+errout_with_panbuf:
   nxmutex_destroy(&fb->lock);
+#ifdef CONFIG_FB_SYNC
+  nxsem_destroy(&fb->vsyncsem);
+#endif
+  circbuf_uninit(&fb->panbuf);
+
+errout_with_fb:
   kmm_free(fb);
   return ret;
 }
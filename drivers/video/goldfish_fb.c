@@ -27,7 +27,6 @@
 #include <nuttx/video/fb.h>
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
-#include <nuttx/mm/circbuf.h>
 
 /****************************************************************************
  * Pre-processor definitions
@@ -81,10 +80,8 @@ struct goldfish_fb_s
   struct fb_videoinfo_s videoinfo;
   FAR void *base;
   int irq;
-  struct circbuf_s vsync;   /* Vsync event queued */
 #ifdef CONFIG_GOLDFISH_FB_VIDEO_MODE
-  bool busy; /* Only used in the video mode */
-  uintptr_t cur_buf;
+  uintptr_t cur_buf;        /* Buffer sent on each vsync */
 #endif
 };
 
@@ -98,8 +95,6 @@ static FAR struct goldfish_fb_s *g_goldfish_fb;
  * Private Function Prototypes
  ****************************************************************************/
 
-static int goldfish_fb_pan_display(FAR struct fb_vtable_s *vtable,
-                                   FAR struct fb_planeinfo_s *pinfo);
 static int goldfish_getvideoinfo(FAR struct fb_vtable_s *vtable,
                                  FAR struct fb_videoinfo_s *vinfo);
 static int goldfish_getplaneinfo(FAR struct fb_vtable_s *vtable, int planeno,
@@ -116,88 +111,57 @@ static void goldfish_fb_framedone_irq(FAR struct goldfish_fb_s *fb);
  * Name: goldfish_fb_vsync_irq
  ****************************************************************************/
 
-#ifdef CONFIG_GOLDFISH_FB_VIDEO_MODE
 static void goldfish_fb_vsync_irq(FAR struct goldfish_fb_s *fb)
 {
   struct fb_planeinfo_s pinfo;
+  uintptr_t buf = 0;
 
-  /* Attempte to retrieve a frame from the vsync queue */
-
-  ssize_t ret = circbuf_read(&fb->vsync, &pinfo,
-                             sizeof(struct fb_planeinfo_s));
-  DEBUGASSERT(ret <= 0 || ret == sizeof(struct fb_planeinfo_s));
+  /* Show the oldest pan, the upper half queued it */
 
-  fb->busy = true;
-  if (ret > 0)
+  if (fb_peek_paninfo(&fb->vtable, &pinfo) == OK)
     {
-      fb->cur_buf = (uintptr_t)((uint8_t *)fb->planeinfo.fbmem +
-                                           fb->planeinfo.stride *
-                                           pinfo.yoffset);
+      buf = (uintptr_t)((uint8_t *)fb->planeinfo.fbmem +
+                                   fb->planeinfo.stride * pinfo.yoffset);
     }
 
-  if (fb->cur_buf)
+#ifdef CONFIG_GOLDFISH_FB_VIDEO_MODE
+  if (buf != 0)
     {
-      /* Send buffer addr to GOLDFISH */
-
-      putreg32(fb->cur_buf, fb->base + GOLDFISH_FB_SET_BASE);
+      fb->cur_buf = buf;
     }
-}
-#else
-static void goldfish_fb_vsync_irq(FAR struct goldfish_fb_s *fb)
-{
-  struct fb_planeinfo_s pinfo;
-
-  /* Attempte to retrieve a frame from the vsync queue */
 
-  ssize_t ret = circbuf_read(&fb->vsync, &pinfo,
-                             sizeof(struct fb_planeinfo_s));
-  DEBUGASSERT(ret <= 0 || ret == sizeof(struct fb_planeinfo_s));
+  buf = fb->cur_buf;
+#endif
 
-  if (ret > 0)
+  if (buf != 0)
     {
-      uintptr_t buf = (uintptr_t)((uint8_t *)fb->planeinfo.fbmem +
-                                             fb->planeinfo.stride *
-                                             pinfo.yoffset);
-
       /* Send buffer addr to GOLDFISH */
 
       putreg32(buf, fb->base + GOLDFISH_FB_SET_BASE);
     }
-}
+
+#ifdef CONFIG_FB_SYNC
+  fb_vsyncnotify(&fb->vtable);
 #endif
+}
 
 /****************************************************************************
  * Name: goldfish_fb_framedone_irq
  ****************************************************************************/
 
-#ifdef CONFIG_GOLDFISH_FB_VIDEO_MODE
 static void goldfish_fb_framedone_irq(FAR struct goldfish_fb_s *fb)
 {
-  fb->busy = false;
+  /* Once the frame of the new buffer is sent, the previous one is released
+   * and the upper layer is notified that it can be written.
+   */
 
-  if (fb->cur_buf && !circbuf_is_empty(&fb->vsync))
+  if (fb_remove_paninfo(&fb->vtable) < 0)
     {
-      /* Clear the current frame buffer */
-
-      fb->cur_buf = 0;
-
-      /* After the sending is completed, notify the upper
-       * layer that the framebuffer can be written.
-       */
-
+#ifndef CONFIG_GOLDFISH_FB_VIDEO_MODE
       fb_pollnotify(&fb->vtable);
+#endif
     }
 }
-#else
-static void goldfish_fb_framedone_irq(FAR struct goldfish_fb_s *fb)
-{
-  /* After the sending is completed, notify the upper
-   * layer that the framebuffer can be written.
-   */
-
-  fb_pollnotify(&fb->vtable);
-}
-#endif
 
 /****************************************************************************
  * Name: goldfish_fb_interrupt
@@ -225,51 +189,6 @@ static int goldfish_fb_interrupt(int irq, FAR void *dev_id, FAR void *arg)
   return OK;
 }
 
-/****************************************************************************
- * Name: goldfish_fb_pan_display
- ****************************************************************************/
-
-static int goldfish_fb_pan_display(FAR struct fb_vtable_s *vtable,
-                                   FAR struct fb_planeinfo_s *pinfo)
-{
-  struct goldfish_fb_s *fb = (FAR struct goldfish_fb_s *)vtable;
-  irqstate_t flags;
-  ssize_t ret;
-
-  /** Disable the interrupt when writing to the queue to
-   *  prevent it from being modified by the interrupted
-   * thread during the writing process.
-   */
-
-  flags = enter_critical_section();
-
-  /* Write the planeinfo information submitted
-   * by the renderer to the queue
-   */
-
-  ret = circbuf_write(&fb->vsync, pinfo,
-                      sizeof(struct fb_planeinfo_s));
-  DEBUGASSERT(ret == sizeof(struct fb_planeinfo_s));
-
-#ifdef CONFIG_GOLDFISH_FB_VIDEO_MODE
-  if (fb->cur_buf && !fb->busy)
-    {
-      /* Clear the current frame buffer if not busy in transfering */
-
-      fb->cur_buf = 0;
-
-      /* Notify the upper layer that the framebuffer can be written */
-
-      fb_pollnotify(&fb->vtable);
-    }
-#endif
-
-  /* Re-enable interrupts */
-
-  leave_critical_section(flags);
-  return ret < 0 ? ret : 0;
-}
-
 /****************************************************************************
  * Name: goldfish_getvideoinfo
  ****************************************************************************/
@@ -351,16 +270,6 @@ int up_fbinitialize(int display)
   fb->base = (FAR void *)CONFIG_GOLDFISH_FB_BASE;
   fb->irq = CONFIG_GOLDFISH_FB_IRQ;
 
-  /* Initialize vsync queue */
-
-  ret = circbuf_init(&fb->vsync, NULL,
-                     CONFIG_GOLDFISH_FB_FRAME_NBUFFER *
-                     sizeof(struct fb_planeinfo_s));
-  if (ret < 0)
-    {
-      goto err_circbuf_alloc_failed;
-    }
-
   fmt = getreg32(fb->base + GOLDFISH_FB_GET_FORMAT);
 
   fb->videoinfo.xres = getreg32(fb->base + GOLDFISH_FB_GET_WIDTH);
@@ -384,7 +293,6 @@ int up_fbinitialize(int display)
       goto err_fbmem_alloc_failed;
     }
 
-  fb->vtable.pandisplay = goldfish_fb_pan_display;
   fb->vtable.getplaneinfo = goldfish_getplaneinfo;
   fb->vtable.getvideoinfo = goldfish_getvideoinfo;
 
@@ -409,8 +317,6 @@ int up_fbinitialize(int display)
 err_irq_attach_failed:
   kmm_free(fb->planeinfo.fbmem);
 err_fbmem_alloc_failed:
-  circbuf_uninit(&fb->vsync);
-err_circbuf_alloc_failed:
   kmm_free(fb);
   return ret;
 }
@@ -435,7 +341,6 @@ void up_fbuninitialize(int display)
       FAR struct goldfish_fb_s *fb = g_goldfish_fb;
 
       irq_detach(fb->irq);
-      circbuf_uninit(&fb->vsync);
       kmm_free(fb->planeinfo.fbmem);
       kmm_free(fb);
       g_goldfish_fb = NULL;
@@ -33,6 +33,7 @@
 #include <errno.h>
 #include <poll.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 
@@ -116,6 +117,7 @@ struct video_type_inf_s
   struct v4l2_fract    frame_interval;
   video_framebuff_t    bufinf;
   FAR uint8_t          *bufheap;   /* for V4L2_MEMORY_MMAP buffers */
+  uint16_t             nexported;  /* Planes exported by VIDIOC_EXPBUF */
   FAR struct pollfd    *fds;
   uint32_t             seqnum;
 };
@@ -194,6 +196,21 @@ struct video_mng_s
 
 typedef struct video_mng_s video_mng_t;
 
+/* A plane of a V4L2_MEMORY_MMAP buffer exported by VIDIOC_EXPBUF.
+ * It keeps the video device open, so that the buffer stays allocated
+ * until the last descriptor sharing it is closed.
+ */
+
+struct video_dmabuf_s
+{
+  FAR video_mng_t      *vmng;
+  FAR video_type_inf_t *type_inf;
+  FAR uint8_t          *base;      /* Start of the whole buffer */
+  size_t               bufsize;    /* Size of the whole buffer */
+  FAR uint8_t          *addr;      /* Start of the exported plane */
+  size_t               length;     /* Size of the exported plane */
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -213,6 +230,9 @@ static int video_poll(FAR struct file *filep, FAR struct pollfd *fds,
                       bool setup);
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 static int video_unlink(FAR struct inode *inode);
+static int video_dmabuf_close(FAR struct file *filep);
+static int video_dmabuf_mmap(FAR struct file *filep,
+                             FAR struct mm_map_entry_s *map);
 #endif
 /* Common function */
 
@@ -241,6 +261,7 @@ static int validate_frame_setting(FAR video_mng_t *vmng,
                                   FAR struct v4l2_rect *clip,
                                   FAR struct v4l2_fract *interval);
 static size_t get_bufsize(FAR video_format_t *vf);
+static uint8_t get_planes(FAR video_format_t *vf, FAR uint32_t *sizes);
 
 /* Internal function for each cmds of ioctl */
 
@@ -258,6 +279,7 @@ static int video_dqbuf(FAR struct video_mng_s *vmng,
                        int oflags);
 static int video_cancel_dqbuf(FAR struct video_mng_s *vmng,
                               enum v4l2_buf_type type);
+static int video_dmabuf_import(FAR struct v4l2_buffer *buf);
 static int video_g_fmt(FAR struct video_mng_s *priv,
                        FAR struct v4l2_format *fmt);
 static int video_s_fmt(FAR struct video_mng_s *priv,
@@ -321,6 +343,29 @@ static const struct file_operations g_video_fops =
 #endif
 };
 
+static const struct file_operations g_video_dmabuf_fops =
+{
+  NULL,                     /* open */
+  video_dmabuf_close,       /* close */
+  NULL,                     /* read */
+  NULL,                     /* write */
+  NULL,                     /* seek */
+  NULL,                     /* ioctl */
+  video_dmabuf_mmap,        /* mmap */
+};
+
+static struct inode g_video_dmabuf_inode =
+{
+  NULL,                     /* i_parent */
+  NULL,                     /* i_peer */
+  NULL,                     /* i_child */
+  1,                        /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER,   /* i_flags */
+  {
+    &g_video_dmabuf_fops    /* u */
+  }
+};
+
 static const video_parameter_name_t g_video_parameter_name[] =
 {
   {IMGSENSOR_ID_BRIGHTNESS,           "Brightness"},
@@ -384,6 +429,7 @@ get_video_type_inf(FAR video_mng_t *vmng, uint8_t type)
   switch (type)
     {
       case V4L2_BUF_TYPE_VIDEO_CAPTURE:
+      case V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE:
         type_inf = &vmng->video_inf;
         break;
 
@@ -466,10 +512,12 @@ static void convert_to_imgdatafmt(FAR video_format_t *video,
   switch (video->pixelformat)
     {
       case V4L2_PIX_FMT_NV12:
+      case V4L2_PIX_FMT_NV12M:
         data->pixelformat = IMGDATA_PIX_FMT_NV12;
         break;
 
       case V4L2_PIX_FMT_YUV420:
+      case V4L2_PIX_FMT_YUV420M:
         data->pixelformat = IMGDATA_PIX_FMT_YUV420P;
         break;
 
@@ -505,10 +553,12 @@ static void convert_to_imgsensorfmt(FAR video_format_t *video,
   switch (video->pixelformat)
     {
       case V4L2_PIX_FMT_NV12:
+      case V4L2_PIX_FMT_NV12M:
         sensor->pixelformat = IMGSENSOR_PIX_FMT_NV12;
         break;
 
       case V4L2_PIX_FMT_YUV420:
+      case V4L2_PIX_FMT_YUV420M:
         sensor->pixelformat = IMGSENSOR_PIX_FMT_YUV420P;
         break;
 
@@ -1079,11 +1129,12 @@ static int video_open(FAR struct file *filep)
   return ret;
 }
 
-static int video_close(FAR struct file *filep)
-{
-  FAR struct inode *inode = filep->f_inode;
-  FAR video_mng_t  *priv  = inode->i_private;
+/* Drop a reference to the device taken by video_open() or by an exported
+ * buffer, return true if the device was freed.
+ */
 
+static bool video_release(FAR video_mng_t *priv)
+{
   nxmutex_lock(&priv->lock_open_num);
 
   if (--priv->open_num == 0)
@@ -1098,14 +1149,25 @@ static int video_close(FAR struct file *filep)
           nxmutex_destroy(&priv->lock_open_num);
           kmm_free(priv->devpath);
           kmm_free(priv);
-          inode->i_private = NULL;
-          return OK;
+          return true;
         }
 
 #endif
     }
 
   nxmutex_unlock(&priv->lock_open_num);
+  return false;
+}
+
+static int video_close(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+
+  if (video_release(inode->i_private))
+    {
+      inode->i_private = NULL;
+    }
+
   return OK;
 }
 
@@ -1167,7 +1229,9 @@ static int video_querycap(FAR video_mng_t *vmng,
   /* cap->driver needs to be NULL-terminated. */
 
   strlcpy((FAR char *)cap->driver, name, sizeof(cap->driver));
-  cap->capabilities = V4L2_CAP_VIDEO_CAPTURE | V4L2_CAP_STREAMING;
+  cap->capabilities = V4L2_CAP_VIDEO_CAPTURE |
+                      V4L2_CAP_VIDEO_CAPTURE_MPLANE |
+                      V4L2_CAP_STREAMING;
 
   return OK;
 }
@@ -1229,6 +1293,12 @@ static int video_reqbufs(FAR struct video_mng_s         *vmng,
 
       ret = -EPERM;
     }
+  else if (type_inf->nexported > 0)
+    {
+      /* The buffers are shared by VIDIOC_EXPBUF descriptors */
+
+      ret = -EBUSY;
+    }
   else
     {
       if (reqbufs->count > V4L2_REQBUFS_COUNT_MAX)
@@ -1293,6 +1363,7 @@ static int video_qbuf(FAR struct video_mng_s *vmng,
   FAR vbuf_container_t *container;
   enum video_state_e   next_video_state;
   irqstate_t           flags;
+  int                  ret;
 
   if (vmng == NULL || buf == NULL)
     {
@@ -1325,6 +1396,23 @@ static int video_qbuf(FAR struct video_mng_s *vmng,
       container->buf.m.userptr = (unsigned long)(type_inf->bufheap +
                                  container->buf.length * buf->index);
     }
+  else if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      /* Capture straight into the memory behind the descriptor */
+
+      container->fd = buf->m.fd;
+      ret = video_dmabuf_import(&container->buf);
+      if (ret == OK && !is_bufsize_sufficient(vmng, container->buf.length))
+        {
+          ret = -EINVAL;
+        }
+
+      if (ret < 0)
+        {
+          video_framebuff_free_container(&type_inf->bufinf, container);
+          return ret;
+        }
+    }
 
   video_framebuff_queue_container(&type_inf->bufinf, container);
 
@@ -1441,6 +1529,11 @@ static int video_dqbuf(FAR struct video_mng_s *vmng,
     }
 
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
+  if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      buf->m.fd = container->fd;
+    }
+
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   return OK;
@@ -1471,6 +1564,271 @@ static int video_cancel_dqbuf(FAR struct video_mng_s *vmng,
   return nxsem_post(&type_inf->wait_capture.dqbuf_wait_flg);
 }
 
+static int video_dmabuf_import(FAR struct v4l2_buffer *buf)
+{
+  FAR struct video_dmabuf_s *dmabuf;
+  FAR struct file *filep;
+  struct mm_map_entry_s map;
+  int ret;
+
+  ret = fs_getfilep(buf->m.fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (filep->f_inode == &g_video_dmabuf_inode)
+    {
+      /* A buffer exported by VIDIOC_EXPBUF, capture to all of its planes */
+
+      dmabuf         = filep->f_priv;
+      buf->m.userptr = (unsigned long)dmabuf->base;
+      buf->length    = dmabuf->bufsize;
+      return OK;
+    }
+
+  /* Any other driver that can be mmap()ed, a frame buffer for example */
+
+  if (filep->f_inode == NULL || !INODE_IS_DRIVER(filep->f_inode) ||
+      filep->f_inode->u.i_ops->mmap == NULL)
+    {
+      return -EINVAL;
+    }
+
+  memset(&map, 0, sizeof(map));
+  map.length = buf->length;
+  ret = filep->f_inode->u.i_ops->mmap(filep, &map);
+  if (ret >= 0)
+    {
+      buf->m.userptr = (unsigned long)map.vaddr;
+    }
+
+  return ret;
+}
+
+static int video_expbuf(FAR struct video_mng_s *vmng,
+                        FAR struct v4l2_exportbuffer *expbuf)
+{
+  FAR video_type_inf_t *type_inf;
+  FAR struct video_dmabuf_s *dmabuf;
+  uint32_t sizes[VIDEO_MAX_PLANES];
+  irqstate_t flags;
+  uint8_t nplanes;
+  int i;
+  int ret;
+
+  if (vmng == NULL || expbuf == NULL)
+    {
+      return -EINVAL;
+    }
+
+  type_inf = get_video_type_inf(vmng, expbuf->type);
+  if (type_inf == NULL || type_inf->bufheap == NULL ||
+      expbuf->index >= type_inf->bufinf.container_size)
+    {
+      return -EINVAL;
+    }
+
+  nplanes = get_planes(&type_inf->fmt[VIDEO_FMT_MAIN], sizes);
+  if (expbuf->plane >= nplanes)
+    {
+      return -EINVAL;
+    }
+
+  dmabuf = kmm_zalloc(sizeof(struct video_dmabuf_s));
+  if (dmabuf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  dmabuf->vmng     = vmng;
+  dmabuf->type_inf = type_inf;
+  dmabuf->bufsize  = get_bufsize(&type_inf->fmt[VIDEO_FMT_MAIN]);
+  dmabuf->base     = type_inf->bufheap + dmabuf->bufsize * expbuf->index;
+  dmabuf->addr     = dmabuf->base;
+  dmabuf->length   = sizes[expbuf->plane];
+  for (i = 0; i < expbuf->plane; i++)
+    {
+      dmabuf->addr += sizes[i];
+    }
+
+  nxmutex_lock(&vmng->lock_open_num);
+  vmng->open_num++;
+  nxmutex_unlock(&vmng->lock_open_num);
+
+  flags = enter_critical_section();
+  type_inf->nexported++;
+  leave_critical_section(flags);
+
+  ret = file_allocate(&g_video_dmabuf_inode,
+                      O_RDWR | (expbuf->flags & O_CLOEXEC),
+                      0, dmabuf, 0, true);
+  if (ret < 0)
+    {
+      flags = enter_critical_section();
+      type_inf->nexported--;
+      leave_critical_section(flags);
+
+      video_release(vmng);
+      kmm_free(dmabuf);
+      return ret;
+    }
+
+  expbuf->fd = ret;
+  return OK;
+}
+
+/* Describe the planes of a buffer to a V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE
+ * caller.
+ */
+
+static void video_fill_planes(FAR video_type_inf_t *type_inf,
+                              FAR struct v4l2_buffer *buf,
+                              FAR struct v4l2_buffer *mp)
+{
+  FAR struct v4l2_plane *planes = mp->m.planes;
+  uint32_t sizes[VIDEO_MAX_PLANES];
+  uint32_t remaining = buf->bytesused;
+  uint32_t offset = 0;
+  uint8_t nplanes;
+  int i;
+
+  nplanes = get_planes(&type_inf->fmt[VIDEO_FMT_MAIN], sizes);
+  for (i = 0; i < nplanes; i++)
+    {
+      planes[i].length      = sizes[i];
+      planes[i].bytesused   = remaining < sizes[i] ? remaining : sizes[i];
+      planes[i].data_offset = 0;
+      remaining            -= planes[i].bytesused;
+
+      if (buf->memory == V4L2_MEMORY_MMAP)
+        {
+          planes[i].m.mem_offset =
+            get_bufsize(&type_inf->fmt[VIDEO_FMT_MAIN]) * buf->index +
+            offset;
+        }
+      else if (buf->memory == V4L2_MEMORY_USERPTR)
+        {
+          planes[i].m.userptr = buf->m.userptr + offset;
+        }
+      else if (i == 0)
+        {
+          planes[i].m.fd = buf->m.fd;
+        }
+
+      offset += sizes[i];
+    }
+
+  memcpy(mp, buf, sizeof(struct v4l2_buffer));
+  mp->type     = V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE;
+  mp->m.planes = planes;
+  mp->length   = nplanes;
+}
+
+static int video_check_planes(FAR video_type_inf_t *type_inf,
+                              FAR struct v4l2_buffer *mp)
+{
+  uint32_t sizes[VIDEO_MAX_PLANES];
+
+  if (mp->m.planes == NULL ||
+      mp->length < get_planes(&type_inf->fmt[VIDEO_FMT_MAIN], sizes))
+    {
+      return -EINVAL;
+    }
+
+  return OK;
+}
+
+static int video_querybuf_mplane(FAR struct video_mng_s *vmng,
+                                 FAR struct v4l2_buffer *mp)
+{
+  struct v4l2_buffer buf;
+  int ret;
+
+  ret = video_check_planes(&vmng->video_inf, mp);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memcpy(&buf, mp, sizeof(struct v4l2_buffer));
+  buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  ret = video_querybuf(vmng, &buf);
+  if (ret == OK)
+    {
+      video_fill_planes(&vmng->video_inf, &buf, mp);
+    }
+
+  return ret;
+}
+
+static int video_qbuf_mplane(FAR struct video_mng_s *vmng,
+                             FAR struct v4l2_buffer *mp)
+{
+  FAR struct v4l2_plane *planes = mp->m.planes;
+  struct v4l2_buffer buf;
+  int ret;
+  int i;
+
+  ret = video_check_planes(&vmng->video_inf, mp);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memcpy(&buf, mp, sizeof(struct v4l2_buffer));
+  buf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  buf.length = 0;
+
+  for (i = 0; i < mp->length && i < VIDEO_MAX_PLANES; i++)
+    {
+      /* The planes are captured at once, so they must follow each other */
+
+      if (mp->memory == V4L2_MEMORY_USERPTR &&
+          planes[i].m.userptr != planes[0].m.userptr + buf.length)
+        {
+          return -EINVAL;
+        }
+
+      buf.length += planes[i].length;
+    }
+
+  if (mp->memory == V4L2_MEMORY_USERPTR)
+    {
+      buf.m.userptr = planes[0].m.userptr;
+    }
+  else if (mp->memory == V4L2_MEMORY_DMABUF)
+    {
+      buf.m.fd = planes[0].m.fd;
+    }
+
+  return video_qbuf(vmng, &buf);
+}
+
+static int video_dqbuf_mplane(FAR struct video_mng_s *vmng,
+                              FAR struct v4l2_buffer *mp,
+                              int oflags)
+{
+  struct v4l2_buffer buf;
+  int ret;
+
+  ret = video_check_planes(&vmng->video_inf, mp);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memcpy(&buf, mp, sizeof(struct v4l2_buffer));
+  buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  ret = video_dqbuf(vmng, &buf, oflags);
+  if (ret == OK)
+    {
+      video_fill_planes(&vmng->video_inf, &buf, mp);
+    }
+
+  return ret;
+}
+
 static bool validate_clip_range(int32_t pos, uint32_t c_sz, uint16_t frm_sz)
 {
   return pos >= 0 && c_sz <= frm_sz && pos + c_sz <= frm_sz;
@@ -1618,7 +1976,9 @@ static size_t get_bufsize(FAR video_format_t *vf)
   switch (vf->pixelformat)
     {
       case V4L2_PIX_FMT_NV12:
+      case V4L2_PIX_FMT_NV12M:
       case V4L2_PIX_FMT_YUV420:
+      case V4L2_PIX_FMT_YUV420M:
         return ret * 3 / 2;
       case V4L2_PIX_FMT_YUYV:
       case V4L2_PIX_FMT_UYVY:
@@ -1629,6 +1989,33 @@ static size_t get_bufsize(FAR video_format_t *vf)
     }
 }
 
+/* The planes of the multi-planar formats follow each other in one buffer,
+ * as the capture writes a whole frame at once.
+ */
+
+static uint8_t get_planes(FAR video_format_t *vf, FAR uint32_t *sizes)
+{
+  uint32_t pixels = vf->width * vf->height;
+
+  switch (vf->pixelformat)
+    {
+      case V4L2_PIX_FMT_YUV420M:
+        sizes[0] = pixels;
+        sizes[1] = pixels / 4;
+        sizes[2] = pixels / 4;
+        return 3;
+
+      case V4L2_PIX_FMT_NV12M:
+        sizes[0] = pixels;
+        sizes[1] = pixels / 2;
+        return 2;
+
+      default:
+        sizes[0] = get_bufsize(vf);
+        return 1;
+    }
+}
+
 static size_t get_heapsize(FAR video_type_inf_t *type_inf)
 {
   return type_inf->bufinf.container_size *
@@ -1678,7 +2065,9 @@ static int video_try_fmt(FAR struct video_mng_s *priv,
               V4L2_PIX_FMT_UYVY : V4L2_PIX_FMT_RGB565;
         break;
       case V4L2_PIX_FMT_NV12:
+      case V4L2_PIX_FMT_NV12M:
       case V4L2_PIX_FMT_YUV420:
+      case V4L2_PIX_FMT_YUV420M:
       case V4L2_PIX_FMT_YUYV:
       case V4L2_PIX_FMT_UYVY:
       case V4L2_PIX_FMT_RGB565:
@@ -1773,6 +2162,59 @@ static int video_s_fmt(FAR struct video_mng_s *priv,
   return OK;
 }
 
+static int video_fmt_mplane(FAR struct video_mng_s *vmng, int cmd,
+                            FAR struct v4l2_format *mp)
+{
+  FAR struct v4l2_pix_format_mplane *pix_mp = &mp->fmt.pix_mp;
+  struct v4l2_format fmt;
+  uint32_t sizes[VIDEO_MAX_PLANES];
+  video_format_t vf;
+  int ret;
+  int i;
+
+  memset(&fmt, 0, sizeof(fmt));
+  fmt.type                = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  fmt.fmt.pix.width       = pix_mp->width;
+  fmt.fmt.pix.height      = pix_mp->height;
+  fmt.fmt.pix.pixelformat = pix_mp->pixelformat;
+
+  switch (cmd)
+    {
+      case VIDIOC_TRY_FMT:
+        ret = video_try_fmt(vmng, &fmt);
+        break;
+
+      case VIDIOC_G_FMT:
+        ret = video_g_fmt(vmng, &fmt);
+        break;
+
+      default: /* VIDIOC_S_FMT */
+        ret = video_s_fmt(vmng, &fmt);
+        break;
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  vf.width       = fmt.fmt.pix.width;
+  vf.height      = fmt.fmt.pix.height;
+  vf.pixelformat = fmt.fmt.pix.pixelformat;
+
+  memset(pix_mp, 0, sizeof(*pix_mp));
+  pix_mp->width       = vf.width;
+  pix_mp->height      = vf.height;
+  pix_mp->pixelformat = vf.pixelformat;
+  pix_mp->num_planes  = get_planes(&vf, sizes);
+  for (i = 0; i < pix_mp->num_planes; i++)
+    {
+      pix_mp->plane_fmt[i].sizeimage = sizes[i];
+    }
+
+  return OK;
+}
+
 static int video_s_parm(FAR struct video_mng_s *priv,
                         FAR struct v4l2_streamparm *parm)
 {
@@ -1867,7 +2309,8 @@ static int video_streamon(FAR struct video_mng_s *vmng,
       return -EINVAL;
     }
 
-  if (*type != V4L2_BUF_TYPE_VIDEO_CAPTURE)
+  if (*type != V4L2_BUF_TYPE_VIDEO_CAPTURE &&
+      *type != V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE)
     {
       /* No procedure for VIDIOC_STREAMON(STILL_CAPTURE) */
 
@@ -1910,7 +2353,8 @@ static int video_streamoff(FAR struct video_mng_s *vmng,
       return -EINVAL;
     }
 
-  if (*type != V4L2_BUF_TYPE_VIDEO_CAPTURE)
+  if (*type != V4L2_BUF_TYPE_VIDEO_CAPTURE &&
+      *type != V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE)
     {
       /* No procedure for VIDIOC_STREAMOFF(STILL_CAPTURE) */
 
@@ -3101,17 +3545,48 @@ static int video_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 
       case VIDIOC_QUERYBUF:
-        ret = video_querybuf(priv, (FAR struct v4l2_buffer *)arg);
+        if (((FAR struct v4l2_buffer *)arg)->type ==
+            V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE)
+          {
+            ret = video_querybuf_mplane(priv, (FAR struct v4l2_buffer *)arg);
+          }
+        else
+          {
+            ret = video_querybuf(priv, (FAR struct v4l2_buffer *)arg);
+          }
 
         break;
 
       case VIDIOC_QBUF:
-        ret = video_qbuf(priv, (FAR struct v4l2_buffer *)arg);
+        if (((FAR struct v4l2_buffer *)arg)->type ==
+            V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE)
+          {
+            ret = video_qbuf_mplane(priv, (FAR struct v4l2_buffer *)arg);
+          }
+        else
+          {
+            ret = video_qbuf(priv, (FAR struct v4l2_buffer *)arg);
+          }
+
+        break;
+
+      case VIDIOC_EXPBUF:
+        ret = video_expbuf(priv, (FAR struct v4l2_exportbuffer *)arg);
         break;
 
       case VIDIOC_DQBUF:
-        ret = video_dqbuf(priv, (FAR struct v4l2_buffer *)arg,
-                          filep->f_oflags);
+        if (((FAR struct v4l2_buffer *)arg)->type ==
+            V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE)
+          {
+            ret = video_dqbuf_mplane(priv, (FAR struct v4l2_buffer *)arg,
+                                     filep->f_oflags);
+          }
+        else
+          {
+            ret = video_dqbuf(priv, (FAR struct v4l2_buffer *)arg,
+                              filep->f_oflags);
+          }
+
         break;
 
       case VIDIOC_CANCEL_DQBUF:
@@ -3147,15 +3622,42 @@ static int video_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 
       case VIDIOC_TRY_FMT:
-        ret = video_try_fmt(priv, (FAR struct v4l2_format *)arg);
+        if (((FAR struct v4l2_format *)arg)->type ==
+            V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE)
+          {
+            ret = video_fmt_mplane(priv, cmd, (FAR struct v4l2_format *)arg);
+          }
+        else
+          {
+            ret = video_try_fmt(priv, (FAR struct v4l2_format *)arg);
+          }
+
         break;
 
       case VIDIOC_G_FMT:
-        ret = video_g_fmt(priv, (FAR struct v4l2_format *)arg);
+        if (((FAR struct v4l2_format *)arg)->type ==
+            V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE)
+          {
+            ret = video_fmt_mplane(priv, cmd, (FAR struct v4l2_format *)arg);
+          }
+        else
+          {
+            ret = video_g_fmt(priv, (FAR struct v4l2_format *)arg);
+          }
+
         break;
 
       case VIDIOC_S_FMT:
-        ret = video_s_fmt(priv, (FAR struct v4l2_format *)arg);
+        if (((FAR struct v4l2_format *)arg)->type ==
+            V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE)
+          {
+            ret = video_fmt_mplane(priv, cmd, (FAR struct v4l2_format *)arg);
+          }
+        else
+          {
+            ret = video_s_fmt(priv, (FAR struct v4l2_format *)arg);
+          }
+
         break;
 
       case VIDIOC_S_PARM:
@@ -3250,6 +3752,36 @@ static int video_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
   return ret;
 }
 
+static int video_dmabuf_close(FAR struct file *filep)
+{
+  FAR struct video_dmabuf_s *dmabuf = filep->f_priv;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  dmabuf->type_inf->nexported--;
+  leave_critical_section(flags);
+
+  video_release(dmabuf->vmng);
+  kmm_free(dmabuf);
+  return OK;
+}
+
+static int video_dmabuf_mmap(FAR struct file *filep,
+                             FAR struct mm_map_entry_s *map)
+{
+  FAR struct video_dmabuf_s *dmabuf = filep->f_priv;
+  int                       ret     = -EINVAL;
+
+  if (map->offset >= 0 && map->offset < dmabuf->length &&
+      map->length && map->offset + map->length <= dmabuf->length)
+    {
+      map->vaddr = dmabuf->addr + map->offset;
+      ret = OK;
+    }
+
+  return ret;
+}
+
 static int video_poll(FAR struct file *filep, struct pollfd *fds, bool setup)
 {
   FAR struct inode     *inode = filep->f_inode;
@@ -35,6 +35,7 @@
 struct vbuf_container_s
 {
   struct v4l2_buffer       buf;   /* Buffer information */
+  int                      fd;    /* Descriptor of a DMABUF buffer */
   struct vbuf_container_s *next;  /* Pointer to next buffer */
 };
 
@@ -25,11 +25,15 @@
 #include <debug.h>
 #include <errno.h>
 #include <stdio.h>
+#include <strings.h>
+#include <sys/param.h>
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
-#include <nuttx/mutex.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/virtio/virtio.h>
 
 #include "virtio-blk.h"
@@ -57,6 +61,22 @@
 
 #define VIRTIO_BLK_SECTOR_SIZE      512
 
+/* Block device feature bits */
+
+#define VIRTIO_BLK_F_MQ             12 /* Support more than one vq */
+
+/* The request virtqueues, one for each CPU when the device offers them */
+
+#ifdef CONFIG_SMP
+#  define VIRTIO_BLK_MAX_QUEUES     CONFIG_SMP_NCPUS
+#else
+#  define VIRTIO_BLK_MAX_QUEUES     1
+#endif
+
+/* Each request takes three descriptors: out header, data and in header */
+
+#define VIRTIO_BLK_REQ_NDESCS       3
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -105,12 +125,26 @@ begin_packed_struct struct virtio_blk_config_s
   uint32_t secure_erase_sector_alignment;
 } end_packed_struct;
 
+/* A request virtqueue.  Up to 'depth' requests are in flight on it, each
+ * owning one slot of the out and in header arrays.
+ */
+
+struct virtio_blk_queue_s
+{
+  FAR struct virtqueue         *vq;             /* Request virtqueue */
+  FAR struct virtio_blk_req_s  *req;            /* Out headers of the slots */
+  FAR struct virtio_blk_resp_s *resp;           /* In headers of the slots */
+  spinlock_t                    lock;           /* Protects vq and freemap */
+  sem_t                         slotsem;        /* Counts the free slots */
+  uint32_t                      freemap;        /* Bitmap of the free slots */
+  unsigned int                  depth;          /* Number of slots */
+};
+
 struct virtio_blk_priv_s
 {
   FAR struct virtio_device     *vdev;           /* Virtio deivce */
-  FAR struct virtio_blk_req_s  *req;            /* Virtio block out header */
-  FAR struct virtio_blk_resp_s *resp;           /* Virtio block in header */
-  mutex_t                       lock;           /* Lock */
+  struct virtio_blk_queue_s     queue[VIRTIO_BLK_MAX_QUEUES];
+  unsigned int                  nqueues;        /* Request virtqueues used */
   uint64_t                      nsectors;       /* Sectore numbers */
   char                          name[NAME_MAX]; /* Device name */
 };
@@ -121,6 +155,9 @@ struct virtio_blk_priv_s
 
 /* BLK block_operations functions and they helper function */
 
+static int     virtio_blk_submit(FAR struct virtio_blk_priv_s *priv,
+                                 uint32_t type, blkcnt_t sector,
+                                 FAR void *buffer, size_t len);
 static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
                                FAR void *buffer, blkcnt_t startsector,
                                unsigned int nsectors, bool write);
@@ -144,6 +181,10 @@ static int  virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
                             FAR struct virtio_device *vdev);
 static void virtio_blk_uninit(FAR struct virtio_blk_priv_s *priv);
 static void virtio_blk_done(FAR struct virtqueue *vq);
+static int  virtio_blk_init_queue(FAR struct virtio_blk_priv_s *priv,
+                                  FAR struct virtio_blk_queue_s *queue,
+                                  FAR struct virtqueue *vq);
+static void virtio_blk_uninit_queues(FAR struct virtio_blk_priv_s *priv);
 static int  virtio_blk_probe(FAR struct virtio_device *vdev);
 static void virtio_blk_remove(FAR struct virtio_device *vdev);
 
@@ -176,72 +217,121 @@ static int g_virtio_blk_idx = 0;
  ****************************************************************************/
 
 /****************************************************************************
- * Name: virtio_blk_rdwr
+ * Name: virtio_blk_submit
  *
  * Description:
- *   Common function for read and write
+ *   Queue one request on the virtqueue of the calling CPU and wait for its
+ *   completion.  Requests from other tasks may be in flight at the same
+ *   time, on this virtqueue or on the others.
  *
  ****************************************************************************/
 
-static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
-                               FAR void *buffer, blkcnt_t startsector,
-                               unsigned int nsectors, bool write)
+static int virtio_blk_submit(FAR struct virtio_blk_priv_s *priv,
+                             uint32_t type, blkcnt_t sector,
+                             FAR void *buffer, size_t len)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
-  FAR struct virtqueue_buf vb[3];
+  FAR struct virtio_blk_queue_s *queue;
+  FAR struct virtqueue_buf vb[VIRTIO_BLK_REQ_NDESCS];
+  irqstate_t flags;
   sem_t respsem;
-  ssize_t ret;
   int readnum;
+  int nvb = 0;
+  int slot;
+  int ret;
 
-  ret = nxmutex_lock(&priv->lock);
-  if (ret < 0)
-    {
-      return ret;
-    }
+  queue = &priv->queue[up_cpu_index() % priv->nqueues];
+
+  /* Wait for a free slot, then take it */
 
+  nxsem_wait_uninterruptible(&queue->slotsem);
   nxsem_init(&respsem, 0, 0);
 
+  flags = spin_lock_irqsave(&queue->lock);
+  slot  = ffs(queue->freemap) - 1;
+  queue->freemap &= ~(1u << slot);
+
   /* Build the block request */
 
-  priv->req->type     = write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
-  priv->req->reserved = 0;
-  priv->req->sector   = startsector;
-  priv->resp->status  = VIRTIO_BLK_S_IOERR;
+  queue->req[slot].type     = type;
+  queue->req[slot].reserved = 0;
+  queue->req[slot].sector   = sector;
+  queue->resp[slot].status  = VIRTIO_BLK_S_IOERR;
 
   /* Fill the virtqueue buffer:
    * Buffer 0: the block out header;
-   * Buffer 1: the read/write buffer;
-   * Buffer 2: the block in header, return the status.
+   * Buffer 1: the read/write buffer, if any;
+   * Last buffer: the block in header, return the status.
    */
 
-  vb[0].buf = priv->req;
-  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
-  vb[1].buf = buffer;
-  vb[1].len = nsectors * VIRTIO_BLK_SECTOR_SIZE;
-  vb[2].buf = priv->resp;
-  vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
-  readnum = write ? 2 : 1;
-  ret = virtqueue_add_buffer(vq, vb, readnum, 3 - readnum, &respsem);
+  vb[nvb].buf   = &queue->req[slot];
+  vb[nvb++].len = VIRTIO_BLK_REQ_HEADER_SIZE;
+  if (len > 0)
+    {
+      vb[nvb].buf   = buffer;
+      vb[nvb++].len = len;
+    }
+
+  vb[nvb].buf   = &queue->resp[slot];
+  vb[nvb++].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+
+  readnum = type == VIRTIO_BLK_T_OUT ? 2 : 1;
+  ret = virtqueue_add_buffer(queue->vq, vb, readnum, nvb - readnum,
+                             &respsem);
+  if (ret >= 0)
+    {
+      virtqueue_kick(queue->vq);
+    }
+
+  spin_unlock_irqrestore(&queue->lock, flags);
+
   if (ret < 0)
     {
-      vrterr("virtqueue_add_buffer failed, ret=%zd\n", ret);
-      goto err;
+      vrterr("virtqueue_add_buffer failed, ret=%d\n", ret);
     }
+  else
+    {
+      /* Wait for the request completion */
+
+      nxsem_wait_uninterruptible(&respsem);
+      if (queue->resp[slot].status != VIRTIO_BLK_S_OK)
+        {
+          ret = -EIO;
+        }
+    }
+
+  nxsem_destroy(&respsem);
+
+  /* Give the slot back */
+
+  flags = spin_lock_irqsave(&queue->lock);
+  queue->freemap |= 1u << slot;
+  spin_unlock_irqrestore(&queue->lock, flags);
+  nxsem_post(&queue->slotsem);
+  return ret;
+}
 
-  virtqueue_kick(vq);
+/****************************************************************************
+ * Name: virtio_blk_rdwr
+ *
+ * Description:
+ *   Common function for read and write
+ *
+ ****************************************************************************/
 
-  /* Wait for the request completion */
+static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
+                               FAR void *buffer, blkcnt_t startsector,
+                               unsigned int nsectors, bool write)
+{
+  int ret;
 
-  nxsem_wait_uninterruptible(&respsem);
-  if (priv->resp->status != VIRTIO_BLK_S_OK)
+  ret = virtio_blk_submit(priv, write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN,
+                          startsector, buffer,
+                          nsectors * VIRTIO_BLK_SECTOR_SIZE);
+  if (ret == -EIO)
     {
       vrterr("%s Error\n", write ? "Write" : "Read");
-      ret = -EIO;
     }
 
-err:
-  nxmutex_unlock(&priv->lock);
   return ret >= 0 ? nsectors : ret;
 }
 
@@ -347,50 +437,14 @@ static int virtio_blk_geometry(FAR struct inode *inode,
 
 static int virtio_blk_flush(FAR struct virtio_blk_priv_s *priv)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
-  FAR struct virtqueue_buf vb[2];
-  sem_t respsem;
   int ret;
 
-  ret = nxmutex_lock(&priv->lock);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  nxsem_init(&respsem, 0, 0);
-
-  /* Build the block request */
-
-  priv->req->type     = VIRTIO_BLK_T_FLUSH;
-  priv->req->reserved = 0;
-  priv->req->sector   = 0;
-  priv->resp->status  = VIRTIO_BLK_S_IOERR;
-
-  vb[0].buf = priv->req;
-  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
-  vb[1].buf = priv->resp;
-  vb[1].len = VIRTIO_BLK_RESP_HEADER_SIZE;
-  ret = virtqueue_add_buffer(vq, vb, 1, 1, &respsem);
-  if (ret < 0)
-    {
-      goto err;
-    }
-
-  virtqueue_kick(vq);
-
-  /* Wait for the request completion */
-
-  nxsem_wait_uninterruptible(&respsem);
-  if (priv->resp->status != VIRTIO_BLK_S_OK)
+  ret = virtio_blk_submit(priv, VIRTIO_BLK_T_FLUSH, 0, NULL, 0);
+  if (ret == -EIO)
     {
       vrterr("Flush Error\n");
-      ret = -EIO;
     }
 
-err:
-  nxmutex_unlock(&priv->lock);
   return ret;
 }
 
@@ -423,12 +477,103 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
 
 static void virtio_blk_done(FAR struct virtqueue *vq)
 {
+  FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
+  FAR struct virtio_blk_queue_s *queue = &priv->queue[vq->vq_queue_index];
   FAR sem_t *respsem;
+  irqstate_t flags;
+  bool pending;
 
-  respsem = virtqueue_get_buffer(vq, NULL, NULL);
-  if (respsem != NULL)
+  /* Complete every finished request.  Re-enabling the callback also moves
+   * the used event index forward when VIRTIO_RING_F_EVENT_IDX is in use,
+   * and reports the requests that completed in the meantime.
+   */
+
+  do
     {
-      nxsem_post(respsem);
+      for (; ; )
+        {
+          flags   = spin_lock_irqsave(&queue->lock);
+          respsem = virtqueue_get_buffer(vq, NULL, NULL);
+          spin_unlock_irqrestore(&queue->lock, flags);
+          if (respsem == NULL)
+            {
+              break;
+            }
+
+          nxsem_post(respsem);
+        }
+
+      flags   = spin_lock_irqsave(&queue->lock);
+      pending = virtqueue_enable_cb(vq) != 0;
+      spin_unlock_irqrestore(&queue->lock, flags);
+    }
+  while (pending);
+}
+
+/****************************************************************************
+ * Name: virtio_blk_init_queue
+ ****************************************************************************/
+
+static int virtio_blk_init_queue(FAR struct virtio_blk_priv_s *priv,
+                                 FAR struct virtio_blk_queue_s *queue,
+                                 FAR struct virtqueue *vq)
+{
+  FAR struct virtio_device *vdev = priv->vdev;
+
+  /* Never queue more requests than the vring has descriptors for */
+
+  queue->vq    = vq;
+  queue->depth = MIN(CONFIG_DRIVERS_VIRTIO_BLK_QUEUE_DEPTH,
+                     vq->vq_nentries / VIRTIO_BLK_REQ_NDESCS);
+  if (queue->depth == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Alloc the request and in headers from tansport layer */
+
+  queue->req = virtio_alloc_buf(vdev, queue->depth * sizeof(*queue->req),
+                                16);
+  if (queue->req == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  queue->resp = virtio_alloc_buf(vdev, queue->depth * sizeof(*queue->resp),
+                                 16);
+  if (queue->resp == NULL)
+    {
+      virtio_free_buf(vdev, queue->req);
+      queue->req = NULL;
+      return -ENOMEM;
+    }
+
+  queue->freemap = UINT32_MAX >> (32 - queue->depth);
+  spin_initialize(&queue->lock, SP_UNLOCKED);
+  nxsem_init(&queue->slotsem, 0, queue->depth);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_uninit_queues
+ ****************************************************************************/
+
+static void virtio_blk_uninit_queues(FAR struct virtio_blk_priv_s *priv)
+{
+  FAR struct virtio_device *vdev = priv->vdev;
+  FAR struct virtio_blk_queue_s *queue;
+  unsigned int i;
+
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      queue = &priv->queue[i];
+      if (queue->req != NULL)
+        {
+          nxsem_destroy(&queue->slotsem);
+          virtio_free_buf(vdev, queue->resp);
+          virtio_free_buf(vdev, queue->req);
+          queue->req = NULL;
+        }
     }
 }
 
@@ -439,55 +584,74 @@ static void virtio_blk_done(FAR struct virtqueue *vq)
 static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqname[1];
-  vq_callback callback[1];
+  FAR const char *vqname[VIRTIO_BLK_MAX_QUEUES];
+  vq_callback callback[VIRTIO_BLK_MAX_QUEUES];
+  uint32_t features;
+  uint16_t nqueues = 1;
+  unsigned int i;
   int ret;
 
   priv->vdev = vdev;
   vdev->priv = priv;
-  nxmutex_init(&priv->lock);
 
-  /* Alloc the request and in header from tansport layer */
+  /* Initialize the virtio device.  Use one request virtqueue per CPU if
+   * the device has them, and let the event index suppress the
+   * notifications and interrupts that are not needed.
+   */
+
+  virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
+
+  features = virtio_get_features(vdev);
+  features &= (1 << VIRTIO_BLK_F_MQ) | VIRTIO_RING_F_EVENT_IDX;
+  virtio_set_features(vdev, features);
+  virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  priv->req = virtio_alloc_buf(vdev, sizeof(*priv->req), 16);
-  if (priv->req == NULL)
+  if (features & (1 << VIRTIO_BLK_F_MQ))
     {
-      ret = -ENOMEM;
-      goto err_with_lock;
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                num_queues, &nqueues);
     }
 
-  priv->resp = virtio_alloc_buf(vdev, sizeof(*priv->resp), 16);
-  if (priv->resp == NULL)
+  priv->nqueues = MAX(MIN(nqueues, VIRTIO_BLK_MAX_QUEUES), 1);
+  for (i = 0; i < priv->nqueues; i++)
     {
-      ret = -ENOMEM;
-      goto err_with_req;
+      vqname[i]   = "virtio_blk_vq";
+      callback[i] = virtio_blk_done;
     }
 
-  /* Initialize the virtio device */
-
-  virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_set_features(vdev, 0);
-  virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
-
-  vqname[0]   = "virtio_blk_vq";
-  callback[0] = virtio_blk_done;
-  ret = virtio_create_virtqueues(vdev, 0, 1, vqname, callback);
+  ret = virtio_create_virtqueues(vdev, 0, priv->nqueues, vqname, callback);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
-      goto err_with_resp;
+      return ret;
     }
 
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      ret = virtio_blk_init_queue(priv, &priv->queue[i],
+                                  vdev->vrings_info[i].vq);
+      if (ret < 0)
+        {
+          vrterr("virtio_blk_init_queue failed, ret=%d\n", ret);
+          goto err_with_queues;
+        }
+    }
+
+  vrtinfo("Virtio blk queues=%u event_idx=%d\n", priv->nqueues,
+          !!(features & VIRTIO_RING_F_EVENT_IDX));
+
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
-  virtqueue_enable_cb(vdev->vrings_info[0].vq);
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      virtqueue_enable_cb(priv->queue[i].vq);
+    }
+
   return OK;
 
-err_with_resp:
-  virtio_free_buf(vdev, priv->resp);
-err_with_req:
-  virtio_free_buf(vdev, priv->req);
-err_with_lock:
-  nxmutex_destroy(&priv->lock);
+err_with_queues:
+  virtio_blk_uninit_queues(priv);
+  virtio_reset_device(vdev);
+  virtio_delete_virtqueues(vdev);
   return ret;
 }
 
@@ -501,9 +665,7 @@ static void virtio_blk_uninit(FAR struct virtio_blk_priv_s *priv)
 
   virtio_reset_device(vdev);
   virtio_delete_virtqueues(vdev);
-  virtio_free_buf(vdev, priv->resp);
-  virtio_free_buf(vdev, priv->req);
-  nxmutex_destroy(&priv->lock);
+  virtio_blk_uninit_queues(priv);
 }
 
 /****************************************************************************
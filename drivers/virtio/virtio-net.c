@@ -24,13 +24,18 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <inttypes.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
 #include <nuttx/compiler.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
 #include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
 #include <nuttx/virtio/virtio.h>
 
 #include "virtio-net.h"
@@ -39,30 +44,98 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-/* Virtio net header size and packet buffer size */
+/* Virtio net feature bits */
+
+#define VIRTIO_NET_F_CSUM       0  /* Device handles partial checksums */
+#define VIRTIO_NET_F_GUEST_CSUM 1  /* Driver handles partial checksums */
+#define VIRTIO_NET_F_HOST_TSO4  11 /* Device can receive TSOv4 */
+#define VIRTIO_NET_F_HOST_TSO6  12 /* Device can receive TSOv6 */
+#define VIRTIO_NET_F_MRG_RXBUF  15 /* Driver can merge receive buffers */
+#define VIRTIO_NET_F_CTRL_VQ    17 /* Control virtqueue available */
+#define VIRTIO_NET_F_MQ         22 /* Device supports multiqueue */
+
+/* Virtio net header flags and GSO types */
+
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM 1
+#define VIRTIO_NET_HDR_GSO_TCPV4    1
+#define VIRTIO_NET_HDR_GSO_TCPV6    4
+
+/* Virtio net control commands */
+
+#define VIRTIO_NET_CTRL_MQ              4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+#define VIRTIO_NET_OK                   0
+
+/* Virtio net header size and packet buffer size.  The device runs in the
+ * legacy mode, where the header is only extended by the buffer count of
+ * VIRTIO_NET_F_MRG_RXBUF.  A mergeable RX buffer is a single IOB.
+ */
 
 #define VIRTIO_NET_HDRSIZE    (sizeof(struct virtio_net_hdr_s))
-#define VIRTIO_NET_LLHDRSIZE  (sizeof(struct virtio_net_llhdr_s))
+#define VIRTIO_NET_MRGHDRSIZE (sizeof(struct virtio_net_mrghdr_s))
 #define VIRTIO_NET_BUFSIZE    (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
+#define VIRTIO_NET_MRGBUFSIZE \
+    (CONFIG_IOB_BUFSIZE - CONFIG_NET_LL_GUARDSIZE + ETH_HDRLEN)
 
-/* Virtio net virtqueue index and number */
+/* Virtio net virtqueue index in a queue pair, and number in a pair */
 
 #define VIRTIO_NET_RX         0
 #define VIRTIO_NET_TX         1
 #define VIRTIO_NET_NUM        2
 
+/* Virtio net queue pairs, and virtqueues with the control virtqueue */
+
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+#  define VIRTIO_NET_MAX_PAIRS CONFIG_NETDEV_MAX_QUEUES
+#  define VIRTIO_NET_MAX_VQS   (VIRTIO_NET_NUM * VIRTIO_NET_MAX_PAIRS + 1)
+#else
+#  define VIRTIO_NET_MAX_PAIRS 1
+#  define VIRTIO_NET_MAX_VQS   VIRTIO_NET_NUM
+#endif
+
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
 #define VIRTIO_NET_MAX_NIOB \
     ((VIRTIO_NET_MAX_PKT_SIZE + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
 
+/* A TSO segment is up to 64 KiB, it is only offloaded when it fits in a
+ * small enough number of IOBs to be described on the stack.
+ */
+
+#define VIRTIO_NET_TSO_PKTSIZE (ETH_HDRLEN + UINT16_MAX)
+#define VIRTIO_NET_TSO_NIOB \
+    ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN + VIRTIO_NET_TSO_PKTSIZE + \
+      CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
+
+#if defined(CONFIG_NETDEV_OFFLOAD) && VIRTIO_NET_TSO_NIOB <= 32
+#  define VIRTIO_NET_HAVE_TSO  1
+#  define VIRTIO_NET_TX_NIOB   VIRTIO_NET_TSO_NIOB
+#else
+#  define VIRTIO_NET_TX_NIOB   VIRTIO_NET_MAX_NIOB
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  define VIRTIO_NET_TSO4      (1 << VIRTIO_NET_F_HOST_TSO4)
+#else
+#  define VIRTIO_NET_TSO4      0
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#  define VIRTIO_NET_TSO6      (1 << VIRTIO_NET_F_HOST_TSO6)
+#else
+#  define VIRTIO_NET_TSO6      0
+#endif
+
+#define VIRTIO_NET_TSO_FEATURES \
+    ((1 << VIRTIO_NET_F_CSUM) | VIRTIO_NET_TSO4 | VIRTIO_NET_TSO6)
+
+#define VIRTIO_NET_HAS_FEATURE(priv, f) (((priv)->features & (1 << (f))) != 0)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* Virtio net header, just define it here for further, now only use it
- * to calculate the virto net header size, see marco VIRTIO_NET_HDRSIZE
- */
+/* Virtio net header, the fields are in the guest byte order */
 
 begin_packed_struct struct virtio_net_hdr_s
 {
@@ -74,6 +147,42 @@ begin_packed_struct struct virtio_net_hdr_s
   uint16_t csum_offset;
 } end_packed_struct;
 
+/* Virtio net header with VIRTIO_NET_F_MRG_RXBUF */
+
+begin_packed_struct struct virtio_net_mrghdr_s
+{
+  struct virtio_net_hdr_s hdr;
+  uint16_t                num_buffers;
+} end_packed_struct;
+
+/* Virtio net config space */
+
+begin_packed_struct struct virtio_net_config_s
+{
+  uint8_t  mac[6];
+  uint16_t status;
+  uint16_t max_virtqueue_pairs;
+} end_packed_struct;
+
+/* Virtio net control command, VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET only */
+
+begin_packed_struct struct virtio_net_ctrl_s
+{
+  uint8_t  class;
+  uint8_t  cmd;
+  uint16_t pairs;
+  uint8_t  ack;
+} end_packed_struct;
+
+/* A pair of RX and TX virtqueues, served by one queue of the upper half */
+
+struct virtio_net_queue_s
+{
+  FAR struct virtqueue *rxvq;          /* RX virtqueue */
+  FAR struct virtqueue *txvq;          /* TX virtqueue */
+  int                   rxnum;         /* RX buffers held by rxvq */
+};
+
 struct virtio_net_priv_s
 {
   /* This holds the information visible to the NuttX network */
@@ -83,7 +192,12 @@ struct virtio_net_priv_s
   /* Virtio device information */
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
+  uint32_t                  features;  /* Negotiated features */
   int                       bufnum;    /* TX and RX Buffer number */
+  uint8_t                   hdrlen;    /* Virtio net header size */
+  uint8_t                   npairs;    /* Queue pairs in use */
+  struct virtio_net_ctrl_s  ctrl;      /* Control command buffer */
+  struct virtio_net_queue_s queue[VIRTIO_NET_MAX_PAIRS];
 };
 
 /* Virtio Link Layer Header, follow shows the iob buffer layout:
@@ -95,21 +209,19 @@ struct virtio_net_priv_s
  * |               |<--------- datalen -------->|
  * ^base           ^data
  *
- * CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDR_SIZE
- *                          = sizeof(uintptr) + 10 + 14
- *                          = 32 (64-Bit)
- *                          = 28 (32-Bit)
+ * The netpkt itself is the cookie of its buffers in the virtqueues.
+ *
+ * CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_MRGHDRSIZE + ETH_HDR_SIZE
+ *                          = 12 + 14
+ *
+ * With VIRTIO_NET_F_MRG_RXBUF, the device writes a frame larger than one
+ * RX buffer into several of them, the virtio header is only at the start
+ * of the first one and the frame goes on from the start of the others.
  */
 
-begin_packed_struct struct virtio_net_llhdr_s
-{
-  FAR netpkt_t           *pkt;         /* Netpaket pointer */
-  struct virtio_net_hdr_s vhdr;        /* Virtio net header */
-} end_packed_struct;
-
-static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_LLHDRSIZE + ETH_HDRLEN,
+static_assert(CONFIG_NET_LL_GUARDSIZE >= VIRTIO_NET_MRGHDRSIZE + ETH_HDRLEN,
               "CONFIG_NET_LL_GUARDSIZE cannot be less than ETH_HDRLEN"
-              " + VIRTIO_NET_LLHDRSIZE");
+              " + VIRTIO_NET_MRGHDRSIZE");
 
 /****************************************************************************
  * Private Function Prototypes
@@ -127,7 +239,22 @@ static int virtio_net_rmmac(FAR struct netdev_lowerhalf_s *dev,
                             FAR const uint8_t *mac);
 #endif
 #ifdef CONFIG_NETDEV_IOCTL
-static int virtio_net_ioctl(FAR struct netdev_lowerhalf_s *dev);
+static int virtio_net_ioctl(FAR struct netdev_lowerhalf_s *dev, int cmd,
+                            unsigned long arg);
+#endif
+#ifdef VIRTIO_NET_HAVE_TSO
+static int virtio_net_send_tso(FAR struct netdev_lowerhalf_s *dev,
+                               FAR netpkt_t *pkt, uint16_t mss);
+#endif
+#if VIRTIO_NET_MAX_PAIRS > 1
+static int virtio_net_sendq(FAR struct netdev_lowerhalf_s *dev,
+                            FAR netpkt_t *pkt, int queue);
+static netpkt_t *virtio_net_recvq(FAR struct netdev_lowerhalf_s *dev,
+                                  int queue);
+#  ifdef VIRTIO_NET_HAVE_TSO
+static int virtio_net_sendq_tso(FAR struct netdev_lowerhalf_s *dev,
+                                FAR netpkt_t *pkt, int queue, uint16_t mss);
+#  endif
 #endif
 
 static int  virtio_net_probe(FAR struct virtio_device *vdev);
@@ -158,6 +285,29 @@ static const struct netdev_ops_s g_virtio_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   virtio_net_ioctl,
 #endif
+#ifdef CONFIG_NETDEV_SCATTER_GATHER
+  NULL,                  /* transmit_sg */
+#endif
+  NULL,                  /* rxint */
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  ifdef VIRTIO_NET_HAVE_TSO
+  virtio_net_send_tso,
+#  else
+  NULL,                  /* transmit_tso */
+#  endif
+#endif
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+  virtio_net_sendq,
+  virtio_net_recvq,
+  NULL,                  /* rxintq */
+#  ifdef CONFIG_NETDEV_OFFLOAD
+#    ifdef VIRTIO_NET_HAVE_TSO
+  virtio_net_sendq_tso,
+#    else
+  NULL,                  /* transmitq_tso */
+#    endif
+#  endif
+#endif
 };
 
 /****************************************************************************
@@ -168,34 +318,41 @@ static const struct netdev_ops_s g_virtio_net_ops =
  * Name: virtio_net_rxfill
  ****************************************************************************/
 
-static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_rxfill(FAR struct virtio_net_priv_s *priv,
+                              FAR struct virtio_net_queue_s *queue)
 {
-  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
-  FAR struct virtio_net_llhdr_s *hdr;
+  FAR struct netdev_lowerhalf_s *dev = &priv->lower;
+  FAR struct virtqueue *vq = queue->rxvq;
   struct virtqueue_buf vb[VIRTIO_NET_MAX_NIOB];
   struct iovec iov[VIRTIO_NET_MAX_NIOB];
   FAR netpkt_t *pkt;
+  unsigned int bufsize;
   int iov_cnt;
+  int count;
   int i;
 
-  for (i = 0; i < priv->bufnum; i++)
+  /* A mergeable RX buffer is a single IOB, the other ones hold a frame */
+
+  bufsize = VIRTIO_NET_HAS_FEATURE(priv, VIRTIO_NET_F_MRG_RXBUF) ?
+            VIRTIO_NET_MRGBUFSIZE : VIRTIO_NET_BUFSIZE;
+
+  for (count = 0; queue->rxnum < priv->bufnum; count++)
     {
       /* IOB Offload, Alloc buffer from RX netpkt */
 
       pkt = netpkt_alloc(dev, NETPKT_RX);
       if (pkt == NULL)
         {
-          vrtinfo("Has ran out of the RX buffer, i=%d\n", i);
+          vrtinfo("Has ran out of the RX buffer, count=%d\n", count);
           break;
         }
 
       /* Preserve data length */
 
-      if (netpkt_setdatalen(dev, pkt, VIRTIO_NET_BUFSIZE) <
-          VIRTIO_NET_BUFSIZE)
+      if (netpkt_setdatalen(dev, pkt, bufsize) < bufsize)
         {
-          vrtwarn("No enough buffer to prepare RX buffer, i=%d\n", i);
+          vrtwarn("No enough buffer to prepare RX buffer, count=%d\n",
+                  count);
           netpkt_free(dev, pkt, NETPKT_RX);
           break;
         }
@@ -203,30 +360,30 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
       /* Convert netpkt to virtqueue_buf */
 
       iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_MAX_NIOB);
+      if (vq->vq_free_cnt < iov_cnt)
+        {
+          netpkt_free(dev, pkt, NETPKT_RX);
+          break;
+        }
+
       for (i = 0; i < iov_cnt; i++)
         {
           vb[i].buf = iov[i].iov_base;
           vb[i].len = iov[i].iov_len;
         }
 
-      /* Alloc cookie and net header from transport layer */
-
-      hdr = (FAR struct virtio_net_llhdr_s *)
-              ((FAR uint8_t *)vb[0].buf - VIRTIO_NET_LLHDRSIZE);
-      DEBUGASSERT((FAR uint8_t *)hdr >= netpkt_getbase(pkt));
-      memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
-      hdr->pkt = pkt;
-
-      /* Buffer 0, the virtio net header */
+      /* Buffer 0 starts with the virtio net header */
 
-      vb[0].buf = &hdr->vhdr;
-      vb[0].len += VIRTIO_NET_HDRSIZE;
+      vb[0].buf  = (FAR uint8_t *)vb[0].buf - priv->hdrlen;
+      vb[0].len += priv->hdrlen;
+      DEBUGASSERT((FAR uint8_t *)vb[0].buf >= netpkt_getbase(pkt));
 
-      vrtinfo("Fill rx, hdr=%p, count=%d\n", hdr, iov_cnt);
-      virtqueue_add_buffer(vq, vb, 0, iov_cnt, hdr);
+      vrtinfo("Fill rx, pkt=%p, count=%d\n", pkt, iov_cnt);
+      virtqueue_add_buffer(vq, vb, 0, iov_cnt, pkt);
+      queue->rxnum++;
     }
 
-  if (i > 0)
+  if (count > 0)
     {
       virtqueue_kick(vq);
     }
@@ -236,27 +393,215 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
  * Name: virtio_net_txfree
  ****************************************************************************/
 
-static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_txfree(FAR struct virtio_net_priv_s *priv,
+                              FAR struct virtio_net_queue_s *queue)
 {
-  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
-  FAR struct virtio_net_llhdr_s *hdr;
+  FAR netpkt_t *pkt;
 
   while (1)
     {
       /* Get buffer from tx virtqueue */
 
-      hdr = virtqueue_get_buffer(vq, NULL, NULL);
-      if (hdr == NULL)
+      pkt = virtqueue_get_buffer(queue->txvq, NULL, NULL);
+      if (pkt == NULL)
         {
           break;
         }
 
-      netpkt_free(dev, hdr->pkt, NETPKT_TX);
-      vrtinfo("Free, hdr: %p, pkt: %p\n", hdr, hdr->pkt);
+      netpkt_free(&priv->lower, pkt, NETPKT_TX);
+      vrtinfo("Free, pkt: %p\n", pkt);
+    }
+}
+
+/****************************************************************************
+ * Name: virtio_net_txhdr
+ *
+ * Description:
+ *   Fill the virtio net header of a frame to send.  With
+ *   NETDEV_FEATURE_TXCSUM, the stack leaves the TCP and UDP checksums to
+ *   the device, and the TCP segments larger than 'mss' with
+ *   NETDEV_FEATURE_TSO.
+ *
+ ****************************************************************************/
+
+static void virtio_net_txhdr(FAR struct virtio_net_priv_s *priv,
+                             FAR netpkt_t *pkt,
+                             FAR struct virtio_net_hdr_s *vhdr,
+                             uint16_t mss)
+{
+#ifdef CONFIG_NETDEV_OFFLOAD
+  FAR struct netdev_lowerhalf_s *dev = &priv->lower;
+  FAR uint8_t *frame;
+  FAR uint16_t *chksum;
+  uint16_t l3off = ETH_HDRLEN;
+  uint16_t l4off;
+  uint16_t type;
+  uint8_t gsotype;
+  uint8_t proto;
+#endif
+
+  memset(vhdr, 0, priv->hdrlen);
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  if (!NETDEV_HAS_FEATURE(&dev->netdev, NETDEV_FEATURE_TXCSUM))
+    {
+      return;
+    }
+
+  frame = netpkt_getdata(dev, pkt);
+  type  = ((FAR struct eth_hdr_s *)frame)->type;
+  if (type == HTONS(TPID_8021QVLAN))
+    {
+      type   = ((FAR uint16_t *)(frame + ETH_HDRLEN))[1];
+      l3off += 4;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (type == HTONS(ETHTYPE_IP))
+    {
+      FAR struct ipv4_hdr_s *ipv4 =
+        (FAR struct ipv4_hdr_s *)(frame + l3off);
+
+      /* The checksum of a fragmented datagram is done by ip_fragout() */
+
+      if ((((uint16_t)ipv4->ipoffset[0] << 8 | ipv4->ipoffset[1]) &
+           ~(IP_FLAG_RESERVED | IP_FLAG_DONTFRAG)) != 0)
+        {
+          return;
+        }
+
+      l4off   = l3off + ((ipv4->vhl & IPv4_HLMASK) << 2);
+      proto   = ipv4->proto;
+      gsotype = VIRTIO_NET_HDR_GSO_TCPV4;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (type == HTONS(ETHTYPE_IP6))
+    {
+      l4off   = l3off + IPv6_HDRLEN;
+      proto   = ((FAR struct ipv6_hdr_s *)(frame + l3off))->proto;
+      gsotype = VIRTIO_NET_HDR_GSO_TCPV6;
+    }
+  else
+#endif
+    {
+      return;
+    }
+
+  if (proto == IP_PROTO_TCP)
+    {
+      vhdr->csum_offset = offsetof(struct tcp_hdr_s, tcpchksum);
     }
+  else if (proto == IP_PROTO_UDP)
+    {
+      /* A zero UDP checksum is not computed */
+
+      chksum = (FAR uint16_t *)(frame + l4off +
+                                offsetof(struct udp_hdr_s, udpchksum));
+      if (*chksum == 0)
+        {
+          return;
+        }
+
+      vhdr->csum_offset = offsetof(struct udp_hdr_s, udpchksum);
+    }
+  else
+    {
+      return;
+    }
+
+  vhdr->flags      = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+  vhdr->csum_start = l4off;
+
+  if (mss > 0)
+    {
+      FAR struct tcp_hdr_s *tcp = (FAR struct tcp_hdr_s *)(frame + l4off);
+
+      vhdr->gso_type = gsotype;
+      vhdr->gso_size = mss;
+      vhdr->hdr_len  = l4off + ((tcp->tcpoffset >> 4) << 2);
+    }
+#endif
 }
 
+/****************************************************************************
+ * Name: virtio_net_rxcsum
+ *
+ * Description:
+ *   Complete the checksum of a received frame that the device left
+ *   partial, VIRTIO_NET_HDR_F_NEEDS_CSUM is only set with
+ *   VIRTIO_NET_F_GUEST_CSUM.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+static int virtio_net_rxcsum(FAR struct virtio_net_priv_s *priv,
+                             FAR netpkt_t *pkt,
+                             FAR struct virtio_net_hdr_s *vhdr)
+{
+  FAR struct netdev_lowerhalf_s *dev = &priv->lower;
+  unsigned int llhdrlen = NET_LL_HDRLEN(&dev->netdev);
+  uint16_t chksum;
+
+  if ((vhdr->flags & VIRTIO_NET_HDR_F_NEEDS_CSUM) == 0)
+    {
+      return OK;
+    }
+
+  if (vhdr->csum_start < llhdrlen ||
+      vhdr->csum_start + vhdr->csum_offset + sizeof(chksum) >
+      netpkt_getdatalen(dev, pkt))
+    {
+      return -EINVAL;
+    }
+
+  /* The checksum field holds the sum of the pseudo-header */
+
+  chksum = ~chksum_iob(0, pkt, vhdr->csum_start - llhdrlen);
+  chksum = HTONS(chksum);
+  return netpkt_copyin(dev, pkt, (FAR const uint8_t *)&chksum,
+                       sizeof(chksum),
+                       vhdr->csum_start + vhdr->csum_offset);
+}
+#endif
+
+/****************************************************************************
+ * Name: virtio_net_setpairs
+ ****************************************************************************/
+
+#if VIRTIO_NET_MAX_PAIRS > 1
+static int virtio_net_setpairs(FAR struct virtio_net_priv_s *priv,
+                               uint16_t npairs)
+{
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_NUM * npairs].vq;
+  struct virtqueue_buf vb[3];
+
+  priv->ctrl.class = VIRTIO_NET_CTRL_MQ;
+  priv->ctrl.cmd   = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  priv->ctrl.pairs = npairs;
+  priv->ctrl.ack   = ~VIRTIO_NET_OK;
+
+  vb[0].buf = &priv->ctrl.class;
+  vb[0].len = 2;
+  vb[1].buf = &priv->ctrl.pairs;
+  vb[1].len = sizeof(priv->ctrl.pairs);
+  vb[2].buf = &priv->ctrl.ack;
+  vb[2].len = sizeof(priv->ctrl.ack);
+
+  /* The device answers the control commands at once, poll for it */
+
+  virtqueue_add_buffer(vq, vb, 2, 1, &priv->ctrl);
+  virtqueue_kick(vq);
+  while (virtqueue_get_buffer(vq, NULL, NULL) == NULL)
+    {
+    }
+
+  return priv->ctrl.ack == VIRTIO_NET_OK ? OK : -EIO;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_ifup
  ****************************************************************************/
@@ -264,6 +609,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -280,8 +626,11 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb(priv->vdev->vrings_info[VIRTIO_NET_RX].vq);
-  virtio_net_rxfill(dev);
+  for (i = 0; i < priv->npairs; i++)
+    {
+      virtqueue_enable_cb(priv->queue[i].rxvq);
+      virtio_net_rxfill(priv, &priv->queue[i]);
+    }
 
   return netdev_lower_carrier_on(dev);
 }
@@ -297,32 +646,36 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (i = 0; i < priv->npairs; i++)
     {
-      virtqueue_disable_cb(priv->vdev->vrings_info[i].vq);
+      virtqueue_disable_cb(priv->queue[i].rxvq);
+      virtqueue_disable_cb(priv->queue[i].txvq);
     }
 
   return netdev_lower_carrier_off(dev);
 }
 
 /****************************************************************************
- * Name: virtio_net_send
+ * Name: virtio_net_xmit
  ****************************************************************************/
 
-static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
-                           FAR netpkt_t *pkt)
+static int virtio_net_xmit(FAR struct virtio_net_priv_s *priv,
+                           FAR struct virtio_net_queue_s *queue,
+                           FAR netpkt_t *pkt, uint16_t mss)
 {
-  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
-  FAR struct virtio_net_llhdr_s *hdr;
-  struct virtqueue_buf vb[VIRTIO_NET_MAX_NIOB];
-  struct iovec iov[VIRTIO_NET_MAX_NIOB];
+  FAR struct netdev_lowerhalf_s *dev = &priv->lower;
+  FAR struct virtqueue *vq = queue->txvq;
+  struct virtqueue_buf vb[VIRTIO_NET_TX_NIOB];
+  struct iovec iov[VIRTIO_NET_TX_NIOB];
+  unsigned int datalen;
+  unsigned int len = 0;
   int iov_cnt;
   int i;
 
   /* Check the send length */
 
-  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE)
+  datalen = netpkt_getdatalen(dev, pkt);
+  if (datalen > (mss > 0 ? VIRTIO_NET_TSO_PKTSIZE : VIRTIO_NET_BUFSIZE))
     {
       vrterr("net send buffer too large\n");
       return -EINVAL;
@@ -330,89 +683,257 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   /* Convert netpkt to virtqueue_buf */
 
-  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_MAX_NIOB);
+  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_TX_NIOB);
   for (i = 0; i < iov_cnt; i++)
     {
       vb[i].buf = iov[i].iov_base;
       vb[i].len = iov[i].iov_len;
+      len      += iov[i].iov_len;
     }
 
-  /* Prepare virtio net header */
+  if (len != datalen)
+    {
+      vrterr("net send buffer has too many IOBs\n");
+      return -E2BIG;
+    }
 
-  hdr = (FAR struct virtio_net_llhdr_s *)
-          ((FAR uint8_t *)vb[0].buf - VIRTIO_NET_LLHDRSIZE);
-  DEBUGASSERT((FAR uint8_t *)hdr >= netpkt_getbase(pkt));
-  hdr->pkt = pkt;
-  memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
+  /* Make room for the buffers of a large frame */
 
-  /* Buffer 0 is the virtio net header */
+  if (vq->vq_free_cnt < iov_cnt)
+    {
+      virtio_net_txfree(priv, queue);
+      if (vq->vq_free_cnt < iov_cnt)
+        {
+          return -EAGAIN;
+        }
+    }
+
+  /* Buffer 0 starts with the virtio net header */
 
-  vb[0].buf = &hdr->vhdr;
-  vb[0].len += VIRTIO_NET_HDRSIZE;
+  vb[0].buf  = (FAR uint8_t *)vb[0].buf - priv->hdrlen;
+  vb[0].len += priv->hdrlen;
+  DEBUGASSERT((FAR uint8_t *)vb[0].buf >= netpkt_getbase(pkt));
+  virtio_net_txhdr(priv, pkt, vb[0].buf, mss);
 
   /* Add buffer to vq and notify the other side */
 
-  vrtinfo("Send, hdr=%p, count=%d\n", hdr, iov_cnt);
-  virtqueue_add_buffer(vq, vb, iov_cnt, 0, hdr);
+  vrtinfo("Send, pkt=%p, count=%d\n", pkt, iov_cnt);
+  virtqueue_add_buffer(vq, vb, iov_cnt, 0, pkt);
   virtqueue_kick(vq);
 
   /* Try return Netpkt TX buffer to upper-half. */
 
-  virtio_net_txfree(dev);
+  virtio_net_txfree(priv, queue);
 
-  /* If we have no buffer left, enable TX done callback. */
+  /* If we have no buffer left, enable TX done callback.  Enabling it also
+   * reports the buffers sent in the meantime with VIRTIO_RING_F_EVENT_IDX.
+   */
 
-  if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
+  while (netdev_lower_quota_load(dev, NETPKT_TX) <= 0 &&
+         virtqueue_enable_cb(vq) != 0)
     {
-      virtqueue_enable_cb(vq);
+      virtqueue_disable_cb(vq);
+      virtio_net_txfree(priv, queue);
     }
 
   return OK;
 }
 
 /****************************************************************************
- * Name: virtio_net_recv
+ * Name: virtio_net_rxget
+ *
+ * Description:
+ *   Get the next frame received on a queue pair, or NULL with the RX
+ *   callback enabled again.
+ *
  ****************************************************************************/
 
-static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+static FAR netpkt_t *virtio_net_rxget(FAR struct virtio_net_priv_s *priv,
+                                      FAR struct virtio_net_queue_s *queue)
 {
-  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
-  FAR struct virtio_net_llhdr_s *hdr;
+  FAR struct netdev_lowerhalf_s *dev = &priv->lower;
+  FAR struct virtqueue *vq = queue->rxvq;
+  FAR struct virtio_net_hdr_s *vhdr;
+  FAR netpkt_t *next;
+  FAR netpkt_t *pkt;
+  uint16_t nbufs;
   uint32_t len;
 
-  /* Fill the free Netpkt RX buffer to the RX virtqueue */
+  /* Get received buffer form RX virtqueue */
 
-  virtio_net_rxfill(dev);
+again:
+  nbufs = 1;
+  while ((pkt = virtqueue_get_buffer(vq, &len, NULL)) == NULL)
+    {
+      /* If we have no buffer left, enable RX callback.  With
+       * VIRTIO_RING_F_EVENT_IDX this also reports the buffers received
+       * in the meantime.
+       */
 
-  /* Get received buffer form RX virtqueue */
+      if (virtqueue_enable_cb(vq) == 0)
+        {
+          vrtinfo("get NULL buffer\n");
+          return NULL;
+        }
+
+      virtqueue_disable_cb(vq);
+    }
 
-  hdr = virtqueue_get_buffer(vq, &len, NULL);
-  if (hdr == NULL)
+  queue->rxnum--;
+  vhdr = (FAR struct virtio_net_hdr_s *)
+           (netpkt_getdata(dev, pkt) - priv->hdrlen);
+  if (len < priv->hdrlen + ETH_HDRLEN)
     {
-      /* If we have no buffer left, enable RX callback. */
+      goto errout;
+    }
 
-      virtqueue_enable_cb(vq);
+  /* Set the received pkt length */
 
+  netpkt_setdatalen(dev, pkt, len - priv->hdrlen);
+  vrtinfo("Recv, pkt=%p, len=%" PRIu32 "\n", pkt, len);
+
+  /* Append the other buffers of a mergeable frame */
+
+  if (VIRTIO_NET_HAS_FEATURE(priv, VIRTIO_NET_F_MRG_RXBUF))
+    {
+      nbufs = ((FAR struct virtio_net_mrghdr_s *)vhdr)->num_buffers;
+    }
+
+  while (--nbufs > 0)
+    {
+      next = virtqueue_get_buffer(vq, &len, NULL);
+      if (next == NULL)
+        {
+          vrterr("Missing buffers of a mergeable frame\n");
+          goto errout;
+        }
+
+      queue->rxnum--;
+      netpkt_concat(dev, pkt, next, netpkt_getdata(dev, next) -
+                    priv->hdrlen, len, NETPKT_RX);
+    }
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  if (virtio_net_rxcsum(priv, pkt, vhdr) < 0)
+    {
+      goto errout;
+    }
+#endif
+
+  return pkt;
+
+errout:
+  NETDEV_RXERRORS(&dev->netdev);
+  netpkt_free(dev, pkt, NETPKT_RX);
+  goto again;
+}
+
+/****************************************************************************
+ * Name: virtio_net_recvpkt
+ ****************************************************************************/
+
+static FAR netpkt_t *
+virtio_net_recvpkt(FAR struct virtio_net_priv_s *priv,
+                   FAR struct virtio_net_queue_s *queue)
+{
+  FAR netpkt_t *pkt;
+
+  /* Fill the free Netpkt RX buffer to the RX virtqueue */
+
+  virtio_net_rxfill(priv, queue);
+
+  pkt = virtio_net_rxget(priv, queue);
+  if (pkt == NULL)
+    {
       /* We do transmit after recv, now it's time to free TX buffer.
        * Depends on upper-half order (Call TX after RX).
        *
        * TODO: Find a better way to free TX buffer.
        */
 
-      virtio_net_txfree(&priv->lower);
-
-      vrtinfo("get NULL buffer\n");
-      return NULL;
+      virtio_net_txfree(priv, queue);
     }
 
-  /* Set the received pkt length */
+  return pkt;
+}
+
+/****************************************************************************
+ * Name: virtio_net_send
+ ****************************************************************************/
+
+static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
 
-  netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
-  vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, hdr->pkt, len);
-  return hdr->pkt;
+  return virtio_net_xmit(priv, &priv->queue[0], pkt, 0);
 }
 
+/****************************************************************************
+ * Name: virtio_net_recv
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+
+  return virtio_net_recvpkt(priv, &priv->queue[0]);
+}
+
+/****************************************************************************
+ * Name: virtio_net_send_tso
+ ****************************************************************************/
+
+#ifdef VIRTIO_NET_HAVE_TSO
+static int virtio_net_send_tso(FAR struct netdev_lowerhalf_s *dev,
+                               FAR netpkt_t *pkt, uint16_t mss)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+
+  return virtio_net_xmit(priv, &priv->queue[0], pkt, mss);
+}
+#endif
+
+#if VIRTIO_NET_MAX_PAIRS > 1
+/****************************************************************************
+ * Name: virtio_net_sendq
+ ****************************************************************************/
+
+static int virtio_net_sendq(FAR struct netdev_lowerhalf_s *dev,
+                            FAR netpkt_t *pkt, int queue)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+
+  return virtio_net_xmit(priv, &priv->queue[queue], pkt, 0);
+}
+
+/****************************************************************************
+ * Name: virtio_net_recvq
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recvq(FAR struct netdev_lowerhalf_s *dev,
+                                  int queue)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+
+  return virtio_net_recvpkt(priv, &priv->queue[queue]);
+}
+
+/****************************************************************************
+ * Name: virtio_net_sendq_tso
+ ****************************************************************************/
+
+#  ifdef VIRTIO_NET_HAVE_TSO
+static int virtio_net_sendq_tso(FAR struct netdev_lowerhalf_s *dev,
+                                FAR netpkt_t *pkt, int queue, uint16_t mss)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+
+  return virtio_net_xmit(priv, &priv->queue[queue], pkt, mss);
+}
+#  endif
+#endif
+
 #ifdef CONFIG_NET_MCASTGROUP
 /****************************************************************************
  * Name: virtio_net_addmac
@@ -440,7 +961,8 @@ static int virtio_net_rmmac(FAR struct netdev_lowerhalf_s *dev,
  * Name: virtio_net_ioctl
  ****************************************************************************/
 
-static int virtio_net_ioctl(FAR struct netdev_lowerhalf_s *dev)
+static int virtio_net_ioctl(FAR struct netdev_lowerhalf_s *dev, int cmd,
+                            unsigned long arg)
 {
   return -ENOTTY;
 }
@@ -455,6 +977,15 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
   virtqueue_disable_cb(vq);
+#if VIRTIO_NET_MAX_PAIRS > 1
+  if (priv->npairs > 1)
+    {
+      netdev_lower_rxready_queue(&priv->lower,
+                                 vq->vq_queue_index / VIRTIO_NET_NUM);
+      return;
+    }
+#endif
+
   netdev_lower_rxready(&priv->lower);
 }
 
@@ -467,6 +998,15 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
   virtqueue_disable_cb(vq);
+#if VIRTIO_NET_MAX_PAIRS > 1
+  if (priv->npairs > 1)
+    {
+      netdev_lower_txdone_queue(&priv->lower,
+                                vq->vq_queue_index / VIRTIO_NET_NUM);
+      return;
+    }
+#endif
+
   netdev_lower_txdone(&priv->lower);
 }
 
@@ -477,25 +1017,88 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char *vqnames[VIRTIO_NET_MAX_VQS];
+  vq_callback callbacks[VIRTIO_NET_MAX_VQS];
+  uint32_t features;
+  uint16_t npairs = 1;
+  int nvqs;
   int ret;
+  int i;
 
   priv->vdev = vdev;
   vdev->priv = priv;
 
-  /* Initialize the virtio device */
+  /* Initialize the virtio device.  Let the device merge the RX buffers,
+   * handle the checksums and segmentation, spread the frames over several
+   * queue pairs, and suppress the notifications that are not needed.
+   */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_set_features(vdev, 0);
+
+  features  = virtio_get_features(vdev);
+  features &= (1 << VIRTIO_NET_F_MRG_RXBUF) |
+#ifdef CONFIG_NETDEV_OFFLOAD
+              (1 << VIRTIO_NET_F_CSUM) | (1 << VIRTIO_NET_F_GUEST_CSUM) |
+              (1 << VIRTIO_NET_F_HOST_TSO4) | (1 << VIRTIO_NET_F_HOST_TSO6) |
+#endif
+#if VIRTIO_NET_MAX_PAIRS > 1
+              (1 << VIRTIO_NET_F_CTRL_VQ) | (1 << VIRTIO_NET_F_MQ) |
+#endif
+              VIRTIO_RING_F_EVENT_IDX;
+
+  /* The segmentation offloads need the checksum one */
+
+  if ((features & (1 << VIRTIO_NET_F_CSUM)) == 0)
+    {
+      features &= ~((1 << VIRTIO_NET_F_HOST_TSO4) |
+                    (1 << VIRTIO_NET_F_HOST_TSO6));
+    }
+
+#if VIRTIO_NET_MAX_PAIRS > 1
+  /* The control virtqueue follows all the queue pairs of the device, only
+   * use them if there are not more than the upper half supports.
+   */
+
+  if ((features & (1 << VIRTIO_NET_F_MQ)) != 0 &&
+      (features & (1 << VIRTIO_NET_F_CTRL_VQ)) != 0)
+    {
+      virtio_read_config_member(vdev, struct virtio_net_config_s,
+                                max_virtqueue_pairs, &npairs);
+    }
+
+  if (npairs < 2 || npairs > VIRTIO_NET_MAX_PAIRS)
+    {
+      features &= ~((1 << VIRTIO_NET_F_CTRL_VQ) | (1 << VIRTIO_NET_F_MQ));
+      npairs    = 1;
+    }
+#endif
+
+  virtio_set_features(vdev, features);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks);
+  priv->features = features;
+  priv->hdrlen   = VIRTIO_NET_HAS_FEATURE(priv, VIRTIO_NET_F_MRG_RXBUF) ?
+                   VIRTIO_NET_MRGHDRSIZE : VIRTIO_NET_HDRSIZE;
+
+  for (i = 0; i < npairs; i++)
+    {
+      vqnames[VIRTIO_NET_NUM * i + VIRTIO_NET_RX]   = "virtio_net_rx";
+      vqnames[VIRTIO_NET_NUM * i + VIRTIO_NET_TX]   = "virtio_net_tx";
+      callbacks[VIRTIO_NET_NUM * i + VIRTIO_NET_RX] = virtio_net_rxready;
+      callbacks[VIRTIO_NET_NUM * i + VIRTIO_NET_TX] = virtio_net_txdone;
+    }
+
+  nvqs = VIRTIO_NET_NUM * npairs;
+#if VIRTIO_NET_MAX_PAIRS > 1
+  if (npairs > 1)
+    {
+      vqnames[nvqs]   = "virtio_net_ctrl";
+      callbacks[nvqs] = NULL;
+      nvqs++;
+    }
+#endif
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqnames, callbacks);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -504,19 +1107,47 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+#if VIRTIO_NET_MAX_PAIRS > 1
+  /* The device starts with one queue pair */
+
+  if (npairs > 1)
+    {
+      virtqueue_disable_cb(vdev->vrings_info[nvqs - 1].vq);
+      ret = virtio_net_setpairs(priv, npairs);
+      if (ret < 0)
+        {
+          vrtwarn("virtio_net_setpairs failed, ret=%d\n", ret);
+          npairs = 1;
+        }
+    }
+#endif
+
+  priv->npairs = npairs;
+  for (i = 0; i < npairs; i++)
+    {
+      priv->queue[i].rxvq =
+        vdev->vrings_info[VIRTIO_NET_NUM * i + VIRTIO_NET_RX].vq;
+      priv->queue[i].txvq =
+        vdev->vrings_info[VIRTIO_NET_NUM * i + VIRTIO_NET_TX].vq;
+    }
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
   priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
   /* Calculate the virtio network buffer number:
-   * 1/4 for the TX netpkts, 1/4 for the RX netpkts.
+   * 1/4 for the TX netpkts, 1/4 for the RX netpkts, shared by the pairs.
    */
 
-  priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4;
+  priv->bufnum = MAX(CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4 /
+                     npairs, 1);
 #endif
   priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs,
                      priv->bufnum);
   priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs,
                      priv->bufnum);
+
+  vrtinfo("Virtio net pairs=%u hdrlen=%u features=%08" PRIx32 "\n",
+          priv->npairs, priv->hdrlen, features);
   return OK;
 }
 
@@ -547,9 +1178,30 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   /* Initialize the netdev lower half */
 
   netdev = &priv->lower;
-  netdev->quota[NETPKT_RX] = priv->bufnum;
-  netdev->quota[NETPKT_TX] = priv->bufnum;
+  netdev->quota[NETPKT_RX] = priv->bufnum * priv->npairs;
+  netdev->quota[NETPKT_TX] = priv->bufnum * priv->npairs;
   netdev->ops = &g_virtio_net_ops;
+#if VIRTIO_NET_MAX_PAIRS > 1
+  netdev->nqueues = priv->npairs;
+#endif
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* The received frames are still verified by the stack, the device only
+   * tells per frame that it did it with VIRTIO_NET_HDR_F_DATA_VALID.
+   */
+
+  if (VIRTIO_NET_HAS_FEATURE(priv, VIRTIO_NET_F_CSUM))
+    {
+      netdev->netdev.d_features |= NETDEV_FEATURE_TXCSUM;
+    }
+
+#  ifdef VIRTIO_NET_HAVE_TSO
+  if ((priv->features & VIRTIO_NET_TSO_FEATURES) == VIRTIO_NET_TSO_FEATURES)
+    {
+      netdev->netdev.d_features |= NETDEV_FEATURE_TSO;
+    }
+#  endif
+#endif
 
   /* Register the net deivce */
 
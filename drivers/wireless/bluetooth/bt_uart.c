@@ -102,11 +102,16 @@ static ssize_t btuart_read(FAR struct btuart_upperhalf_s *upper,
 static void btuart_rxwork(FAR void *arg)
 {
   FAR struct btuart_upperhalf_s *upper;
-  uint8_t data[BLUETOOTH_MAX_FRAMELEN];
+  uint8_t rxbuf[BLUETOOTH_MAX_FRAMELEN];
+#ifdef CONFIG_WIRELESS_BLUETOOTH
+  FAR struct bt_buf_s *buf = NULL;
+#endif
   enum bt_buf_type_e type;
+  FAR uint8_t *data;
   unsigned int hdrlen;
   unsigned int pktlen;
   ssize_t nread;
+  uint8_t htype;
   union
     {
       struct bt_hci_evt_hdr_s evt;
@@ -121,51 +126,75 @@ static void btuart_rxwork(FAR void *arg)
    * Read the first byte to get the packet type.
    */
 
-  nread = btuart_read(upper, data, H4_HEADER_SIZE, 0);
+  nread = btuart_read(upper, &htype, H4_HEADER_SIZE, 0);
   if (nread != H4_HEADER_SIZE)
     {
       wlwarn("WARNING: Unable to read H4 packet type: %zd\n", nread);
       goto errout_with_busy;
     }
 
-  if (data[0] == H4_EVT)
+  if (htype == H4_EVT)
     {
       hdrlen = sizeof(struct bt_hci_evt_hdr_s);
+      type = BT_EVT;
     }
-  else if (data[0] == H4_ACL)
+  else if (htype == H4_ACL)
     {
       hdrlen = sizeof(struct bt_hci_acl_hdr_s);
+      type = BT_ACL_IN;
     }
   else
     {
-      wlerr("ERROR: Unknown H4 type %u\n", data[0]);
+      wlerr("ERROR: Unknown H4 type %u\n", htype);
       goto errout_with_busy;
     }
 
+  /* Receive straight into a stack buffer if the stack can take it over,
+   * otherwise into the local buffer to be copied by the stack.
+   */
+
+  data = rxbuf;
+
+#ifdef CONFIG_WIRELESS_BLUETOOTH
+  if (upper->dev.receive_buf != NULL)
+    {
+      /* The buffer gets its type once the packet is complete, so that
+       * dropping a partial ACL packet does not return a credit.
+       */
+
+      buf = bt_buf_alloc(BT_DUMMY, NULL, H4_HEADER_SIZE);
+      if (buf != NULL)
+        {
+          data = buf->data - H4_HEADER_SIZE;
+        }
+    }
+#endif
+
+  data[0] = htype;
+
   nread = btuart_read(upper, data + H4_HEADER_SIZE,
                       hdrlen, hdrlen);
   if (nread != hdrlen)
     {
       wlwarn("WARNING: Unable to read H4 packet header: %zd\n", nread);
-      goto errout_with_busy;
+      goto errout_with_buf;
     }
 
   hdr = (void *)(data + H4_HEADER_SIZE);
 
-  if (data[0] == H4_EVT)
+  if (type == BT_EVT)
     {
       pktlen = hdr->evt.len;
-      type = BT_EVT;
     }
-  else if (data[0] == H4_ACL)
+  else
     {
-      pktlen = hdr->acl.len;
-      type = BT_ACL_IN;
+      pktlen = BT_LE162HOST(hdr->acl.len);
     }
-  else
+
+  if (H4_HEADER_SIZE + hdrlen + pktlen > BLUETOOTH_MAX_FRAMELEN)
     {
-      wlerr("ERROR: Unknown H4 type %u\n", data[0]);
-      goto errout_with_busy;
+      wlerr("ERROR: H4 packet too large: %u\n", pktlen);
+      goto errout_with_buf;
     }
 
   nread = btuart_read(upper, data + H4_HEADER_SIZE + hdrlen,
@@ -173,17 +202,36 @@ static void btuart_rxwork(FAR void *arg)
   if (nread != pktlen)
     {
       wlwarn("WARNING: Unable to read H4 packet: %zd\n", nread);
-      goto errout_with_busy;
+      goto errout_with_buf;
     }
 
   /* Pass buffer to the stack */
 
   BT_DUMP("Received", data, H4_HEADER_SIZE + hdrlen + pktlen);
   upper->busy = false;
+
+#ifdef CONFIG_WIRELESS_BLUETOOTH
+  if (buf != NULL)
+    {
+      buf->type = type;
+      bt_buf_extend(buf, hdrlen + pktlen);
+      bt_netdev_receive_buf(&upper->dev, buf);
+      return;
+    }
+#endif
+
   bt_netdev_receive(&upper->dev, type, data + H4_HEADER_SIZE,
                     hdrlen + pktlen);
   return;
 
+errout_with_buf:
+#ifdef CONFIG_WIRELESS_BLUETOOTH
+  if (buf != NULL)
+    {
+      bt_buf_release(buf);
+    }
+#endif
+
 errout_with_busy:
   upper->busy = false;
 }
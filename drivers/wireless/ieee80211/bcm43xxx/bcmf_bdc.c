@@ -31,6 +31,7 @@
 #include <string.h>
 
 #include <net/ethernet.h>
+#include <netinet/in.h>
 
 #include "bcmf_driver.h"
 #include "bcmf_ioctl.h"
@@ -44,6 +45,9 @@
 
 #define BCMF_EVENT_ETHER_TYPE 0x6C88 /* Ether type of event frames */
 
+#define BDC_PROTO_VERSION    0x20    /* bdc protocol version 2 */
+#define BDC_FLAG_SUM_NEEDED  0x08    /* Firmware computes the checksum */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -82,6 +86,47 @@ static const uint8_t bcmf_broadcom_oui[] =
   0x00, 0x10, 0x18
 };
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_IEEE80211_BROADCOM_TXCSUM
+/* Return true if the frame is a TCP or UDP packet whose checksum is left to
+ * the firmware.
+ */
+
+static bool bcmf_bdc_sum_needed(FAR struct bcmf_dev_s *priv,
+                                FAR struct bcmf_frame_s *frame)
+{
+  FAR struct ether_header *eth = (FAR struct ether_header *)frame->data;
+  unsigned int len = frame->len - (unsigned int)(frame->data - frame->base);
+  FAR uint8_t *ip = (FAR uint8_t *)(eth + 1);
+  uint8_t proto;
+
+  if (!NETDEV_HAS_FEATURE(&priv->bc_dev, NETDEV_FEATURE_TXCSUM))
+    {
+      return false;
+    }
+
+  if (eth->ether_type == HTONS(ETHERTYPE_IP) &&
+      len >= sizeof(struct ether_header) + 20)
+    {
+      proto = ip[9];
+    }
+  else if (eth->ether_type == HTONS(ETHERTYPE_IPV6) &&
+           len >= sizeof(struct ether_header) + 40)
+    {
+      proto = ip[6];
+    }
+  else
+    {
+      return false;
+    }
+
+  return proto == IPPROTO_TCP || proto == IPPROTO_UDP;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -229,6 +274,14 @@ int bcmf_bdc_transmit_frame(FAR struct bcmf_dev_s *priv,
                             struct bcmf_frame_s *frame)
 {
   struct bcmf_bdc_header *header;
+  uint8_t flags = BDC_PROTO_VERSION;
+
+#ifdef CONFIG_IEEE80211_BROADCOM_TXCSUM
+  if (bcmf_bdc_sum_needed(priv, frame))
+    {
+      flags |= BDC_FLAG_SUM_NEEDED;
+    }
+#endif
 
   /* Set frame data for lower layer */
 
@@ -237,7 +290,7 @@ int bcmf_bdc_transmit_frame(FAR struct bcmf_dev_s *priv,
 
   /* Setup data frame header */
 
-  header->flags       = 0x20; /* Set bdc protocol version */
+  header->flags       = flags;
   header->priority    = 0;    /* TODO handle priority */
   header->flags2      = CHIP_STA_INTERFACE;
   header->data_offset = 0;
@@ -451,10 +451,14 @@ int bcmf_wl_active(FAR struct bcmf_dev_s *priv, bool active)
     }
 #endif
 
-  /* Disable TX Gloming feature */
+  /* Enable or disable TX Gloming feature */
 
   out_len = 4;
+#ifdef CONFIG_IEEE80211_BROADCOM_TXGLOM
+  *(FAR uint32_t *)tmp_buf = 1;
+#else
   *(FAR uint32_t *)tmp_buf = 0;
+#endif
   ret = bcmf_cdc_iovar_request(priv, interface, true,
                                IOVAR_STR_TX_GLOM, tmp_buf,
                                &out_len);
@@ -463,6 +467,54 @@ int bcmf_wl_active(FAR struct bcmf_dev_s *priv, bool active)
       goto errout_in_sdio_active;
     }
 
+  /* The firmware aggregates the frames itself, only tune it.  This must be
+   * done before the interface is up.
+   */
+
+#if CONFIG_IEEE80211_BROADCOM_AMPDU_BA_WSIZE > 0
+  out_len = 4;
+  value   = CONFIG_IEEE80211_BROADCOM_AMPDU_BA_WSIZE;
+  if (bcmf_cdc_iovar_request(priv, interface, true,
+                             IOVAR_STR_AMPDU_BA_WINDOW_SIZE,
+                             (FAR uint8_t *)&value, &out_len) != OK)
+    {
+      wlwarn("Cannot set the AMPDU block ack window\n");
+    }
+#endif
+
+#if CONFIG_IEEE80211_BROADCOM_AMPDU_MPDU > 0
+  out_len = 4;
+  value   = CONFIG_IEEE80211_BROADCOM_AMPDU_MPDU;
+  if (bcmf_cdc_iovar_request(priv, interface, true,
+                             IOVAR_STR_AMPDU_MPDU,
+                             (FAR uint8_t *)&value, &out_len) != OK)
+    {
+      wlwarn("Cannot set the AMPDU size\n");
+    }
+#endif
+
+#ifdef CONFIG_IEEE80211_BROADCOM_TXCSUM
+  /* Not every firmware has the TCP offload engine, the stack computes the
+   * checksums when the firmware does not.
+   */
+
+  priv->bc_dev.d_features &= ~NETDEV_FEATURE_TXCSUM;
+
+  out_len = 4;
+  value   = TOE_TX_CSUM_OL;
+  if (bcmf_cdc_iovar_request(priv, interface, true, IOVAR_STR_TOE_OL,
+                             (FAR uint8_t *)&value, &out_len) == OK)
+    {
+      out_len = 4;
+      value   = 1;
+      if (bcmf_cdc_iovar_request(priv, interface, true, IOVAR_STR_TOE,
+                                 (FAR uint8_t *)&value, &out_len) == OK)
+        {
+          priv->bc_dev.d_features |= NETDEV_FEATURE_TXCSUM;
+        }
+    }
+#endif
+
   /* Set default power save mode */
 
   out_len = 4;
@@ -864,6 +864,8 @@ end_packed_struct wlc_iov_trx_t;
 #define IOVAR_STR_AMPDU_BA_WINDOW_SIZE   "ampdu_ba_wsize"
 #define IOVAR_STR_AMPDU_MPDU             "ampdu_mpdu"
 #define IOVAR_STR_AMPDU_RX_FACTOR        "ampdu_rx_factor"
+#define IOVAR_STR_TOE                    "toe"
+#define IOVAR_STR_TOE_OL                 "toe_ol"
 #define IOVAR_STR_MIMO_BW_CAP            "mimo_bw_cap"
 #define IOVAR_STR_CLMLOAD                "clmload"
 #define IOVAR_STR_CLVER                  "clmver"
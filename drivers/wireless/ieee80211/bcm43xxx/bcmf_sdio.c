@@ -671,6 +671,19 @@ static int bcmf_bus_sdio_initialize(FAR struct bcmf_dev_s *priv,
   sbus->bus.free_frame     = bcmf_sdpcm_free_frame;
   sbus->bus.stop           = NULL; /* TODO */
 
+#ifdef CONFIG_IEEE80211_BROADCOM_TXGLOM
+  /* The superframes are sent in 64 bytes blocks */
+
+  sbus->txglom_buf = kmm_memalign(CONFIG_IEEE80211_BROADCOM_DMABUF_ALIGNMENT,
+                                  (CONFIG_IEEE80211_BROADCOM_TXGLOM_BUFSIZE +
+                                   63) & ~63);
+  if (sbus->txglom_buf == NULL)
+    {
+      kmm_free(sbus);
+      return -ENOMEM;
+    }
+#endif
+
   /* Init transmit frames queue */
 
   nxmutex_init(&sbus->queue_lock);
@@ -714,6 +727,9 @@ static int bcmf_bus_sdio_initialize(FAR struct bcmf_dev_s *priv,
   return OK;
 
 exit_free_bus:
+#ifdef CONFIG_IEEE80211_BROADCOM_TXGLOM
+  kmm_free(sbus->txglom_buf);
+#endif
   kmm_free(sbus);
   priv->bus = NULL;
   return ret;
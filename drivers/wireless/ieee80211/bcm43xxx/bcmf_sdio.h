@@ -43,7 +43,11 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define HEADER_SIZE          0x12 /* Default sdpcm + bdc header size */
+#ifdef CONFIG_IEEE80211_BROADCOM_TXGLOM
+#  define HEADER_SIZE        0x1a /* sdpcm + glom + bdc header size */
+#else
+#  define HEADER_SIZE        0x12 /* Default sdpcm + bdc header size */
+#endif
 #define FIRST_WORD_SIZE      4
 #define FC_UPDATE_PKT_LENGTH 12
 
@@ -109,6 +113,10 @@ struct bcmf_sdio_dev_s
   struct list_node tx_queue;       /* Queue of frames to transmit */
   struct list_node rx_queue;       /* Queue of frames used to receive */
   volatile int tx_queue_count;     /* Count of items in TX queue */
+
+#ifdef CONFIG_IEEE80211_BROADCOM_TXGLOM
+  FAR uint8_t *txglom_buf;         /* Buffer of the TX superframes */
+#endif
 };
 
 /****************************************************************************
@@ -53,6 +53,16 @@
 #define SDPCM_EVENT_CHANNEL   1  /* Asynchronous event frame id */
 #define SDPCM_DATA_CHANNEL    2  /* Data frame id */
 
+/* With TX glomming, every frame sent carries a hardware extension header
+ * that tells its length within the superframe and whether it is the last
+ * one.  The frames are padded to SDPCM_GLOM_ALIGN within the superframe.
+ */
+
+#define SDPCM_HWHDR_LEN       4
+#define SDPCM_GLOM_LAST       (1 << 24)
+#define SDPCM_GLOM_PAD_SHIFT  16
+#define SDPCM_GLOM_ALIGN      4
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -70,6 +80,25 @@ begin_packed_struct struct bcmf_sdpcm_header
   uint16_t padding;
 } end_packed_struct;
 
+/* Header of the frames sent to the chip */
+
+begin_packed_struct struct bcmf_sdpcm_txheader
+{
+  uint16_t size;
+  uint16_t checksum;
+#ifdef CONFIG_IEEE80211_BROADCOM_TXGLOM
+  uint32_t glom_len;     /* Frame length less the hardware header, last flag */
+  uint32_t glom_pad;     /* Tail padding of the frame */
+#endif
+  uint8_t  sequence;
+  uint8_t  channel;
+  uint8_t  next_length;
+  uint8_t  data_offset;
+  uint8_t  flow_control;
+  uint8_t  credit;
+  uint16_t padding;
+} end_packed_struct;
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -79,6 +108,11 @@ static int bcmf_sdpcm_rxfail(FAR bcmf_interface_dev_t *ibus, bool retry);
 static int bcmf_sdpcm_process_header(FAR bcmf_interface_dev_t *ibus,
                               struct bcmf_sdpcm_header *header);
 
+#ifdef CONFIG_IEEE80211_BROADCOM_TXGLOM
+static int bcmf_sdpcm_sendglom(FAR struct bcmf_dev_s *priv,
+                               FAR struct list_node *glom);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -127,6 +161,96 @@ int bcmf_sdpcm_process_header(FAR bcmf_interface_dev_t *ibus,
   return OK;
 }
 
+#ifdef CONFIG_IEEE80211_BROADCOM_TXGLOM
+/* Send the frames of 'glom' in one transfer.  A single frame is sent from
+ * its own buffer, several are copied into the superframe buffer.
+ */
+
+int bcmf_sdpcm_sendglom(FAR struct bcmf_dev_s *priv,
+                        FAR struct list_node *glom)
+{
+  FAR bcmf_interface_dev_t *ibus = (FAR bcmf_interface_dev_t *)priv->bus;
+  FAR struct bcmf_sdpcm_txheader *header;
+  bcmf_interface_frame_t *iframe;
+  FAR uint8_t *buf;
+  unsigned int total = 0;
+  unsigned int len;
+  unsigned int pad;
+  bool single;
+  bool last;
+  bool is_txframe = false;
+  int ret;
+
+  single = list_length(glom) == 1;
+
+  list_for_every_entry(glom, iframe, bcmf_interface_frame_t, list_entry)
+    {
+      header = (FAR struct bcmf_sdpcm_txheader *)iframe->header.base;
+      len    = iframe->header.len;
+      last   = iframe->list_entry.next == glom;
+      pad    = (SDPCM_GLOM_ALIGN - len % SDPCM_GLOM_ALIGN) %
+               SDPCM_GLOM_ALIGN;
+
+      /* The last frame also carries the padding to the end of the last
+       * block of the transfer.
+       */
+
+      if (last && total + len + pad >= 64)
+        {
+          pad = ((total + len + 63) & ~63) - total - len;
+        }
+
+      header->sequence = ibus->tx_seq++;
+      header->glom_len = (len - SDPCM_HWHDR_LEN) |
+                         (last ? SDPCM_GLOM_LAST : 0);
+      header->glom_pad = (uint32_t)pad << SDPCM_GLOM_PAD_SHIFT;
+
+      if (!single)
+        {
+          memcpy(ibus->txglom_buf + total, header, len);
+          memset(ibus->txglom_buf + total + len, 0, pad);
+        }
+
+      total      += len + pad;
+      is_txframe |= iframe->tx;
+    }
+
+  if (single)
+    {
+      iframe = list_first_entry(glom, bcmf_interface_frame_t, list_entry);
+      buf    = iframe->header.base;
+      total  = iframe->header.len;
+    }
+  else
+    {
+      buf    = ibus->txglom_buf;
+    }
+
+  wlinfo("Send %zu frames, %u bytes\n", list_length(glom), total);
+
+  /* Write the frame data (the buffer is DMA aligned here) */
+
+  ret = bcmf_transfer_bytes(ibus, true, 2, 0, buf, total);
+
+  /* Free frame buffers */
+
+  while ((iframe = list_remove_head_type(glom, bcmf_interface_frame_t,
+                                         list_entry)) != NULL)
+    {
+      bcmf_interface_free_frame(priv, iframe);
+    }
+
+  if (ret == OK && is_txframe)
+    {
+      /* Notify upper layer at least one TX buffer is available */
+
+      bcmf_netdev_notify_tx(priv);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -356,10 +480,16 @@ exit_free_frame:
 int bcmf_sdpcm_sendframe(FAR struct bcmf_dev_s *priv)
 {
   int ret;
-  bool is_txframe;
   bcmf_interface_frame_t *iframe;
-  struct bcmf_sdpcm_header *header;
   FAR bcmf_interface_dev_t *ibus = (FAR bcmf_interface_dev_t *)priv->bus;
+#ifdef CONFIG_IEEE80211_BROADCOM_TXGLOM
+  struct list_node glom;
+  unsigned int total;
+  uint8_t seq;
+#else
+  bool is_txframe;
+  struct bcmf_sdpcm_txheader *header;
+#endif
 
   if (list_is_empty(&ibus->tx_queue))
     {
@@ -383,9 +513,48 @@ int bcmf_sdpcm_sendframe(FAR struct bcmf_dev_s *priv)
 
   iframe = list_remove_head_type(&ibus->tx_queue, bcmf_interface_frame_t,
                                  list_entry);
+
+#ifdef CONFIG_IEEE80211_BROADCOM_TXGLOM
+  /* Take the following frames that the firmware has credits for and that
+   * fit in the superframe.
+   */
+
+  list_initialize(&glom);
+  list_add_tail(&glom, &iframe->list_entry);
+
+  total = (iframe->header.len + SDPCM_GLOM_ALIGN - 1) &
+          ~(SDPCM_GLOM_ALIGN - 1);
+  seq   = ibus->tx_seq + 1;
+
+  while (seq != ibus->max_seq && !list_is_empty(&ibus->tx_queue))
+    {
+      iframe = list_first_entry(&ibus->tx_queue, bcmf_interface_frame_t,
+                                list_entry);
+      if (total + iframe->header.len >
+          CONFIG_IEEE80211_BROADCOM_TXGLOM_BUFSIZE)
+        {
+          break;
+        }
+
+      list_delete(&iframe->list_entry);
+      list_add_tail(&glom, &iframe->list_entry);
+
+      total += (iframe->header.len + SDPCM_GLOM_ALIGN - 1) &
+               ~(SDPCM_GLOM_ALIGN - 1);
+      seq++;
+    }
+
+  nxmutex_unlock(&ibus->queue_lock);
+
+  ret = bcmf_sdpcm_sendglom(priv, &glom);
+
+  wlinfo("return %d\n", ret);
+
+  return ret;
+#else
   nxmutex_unlock(&ibus->queue_lock);
 
-  header = (struct bcmf_sdpcm_header *)iframe->header.base;
+  header = (struct bcmf_sdpcm_txheader *)iframe->header.base;
 
   /* Set frame sequence id */
 
@@ -419,6 +588,7 @@ int bcmf_sdpcm_sendframe(FAR struct bcmf_dev_s *priv)
   wlinfo("return %d\n", ret);
 
   return ret;
+#endif
 }
 
 int bcmf_sdpcm_queue_frame(FAR struct bcmf_dev_s *priv,
@@ -426,13 +596,13 @@ int bcmf_sdpcm_queue_frame(FAR struct bcmf_dev_s *priv,
 {
   FAR bcmf_interface_dev_t *ibus = (FAR bcmf_interface_dev_t *)priv->bus;
   bcmf_interface_frame_t *iframe = (bcmf_interface_frame_t *)frame;
-  struct bcmf_sdpcm_header *header =
-    (struct bcmf_sdpcm_header *)iframe->data;
+  struct bcmf_sdpcm_txheader *header =
+    (struct bcmf_sdpcm_txheader *)iframe->data;
   int semcount;
 
   /* Prepare sw header */
 
-  memset(header, 0, sizeof(struct bcmf_sdpcm_header));
+  memset(header, 0, sizeof(struct bcmf_sdpcm_txheader));
   header->size = frame->len;
   header->checksum = ~header->size;
   header->data_offset = (uint8_t)(frame->data - frame->base);
@@ -473,7 +643,7 @@ struct bcmf_frame_s *bcmf_sdpcm_alloc_frame(FAR struct bcmf_dev_s *priv,
                                             bool control)
 {
   bcmf_interface_frame_t *iframe;
-  unsigned int header_len = sizeof(struct bcmf_sdpcm_header);
+  unsigned int header_len = sizeof(struct bcmf_sdpcm_txheader);
 
   if (!control)
     {
@@ -0,0 +1,560 @@
+/****************************************************************************
+ * fs/bcache/fs_bcache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/bcache.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached sector */
+
+struct bcache_block_s
+{
+  dq_entry_t node;                      /* Link in the LRU list */
+  FAR struct inode *inode;              /* The block driver, NULL if free */
+  blkcnt_t sector;                      /* The sector number */
+  size_t size;                          /* The sector size */
+#ifdef CONFIG_FS_BCACHE_WRITEBACK
+  clock_t dirtied;                      /* When the sector was modified */
+  bool dirty;                           /* Not written to the driver yet */
+#endif
+  uint8_t data[CONFIG_FS_BCACHE_BLOCKSIZE];
+};
+
+struct bcache_s
+{
+  mutex_t lock;                         /* Protects everything below */
+  dq_queue_t lru;                       /* Blocks in use, the MRU first */
+  unsigned int nused;                   /* Blocks ever used */
+#ifdef CONFIG_FS_BCACHE_WRITEBACK
+  struct work_s work;                   /* Flushes the expired sectors */
+#endif
+  struct bcache_block_s blocks[CONFIG_FS_BCACHE_NBLOCKS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct bcache_s g_bcache =
+{
+  NXMUTEX_INITIALIZER
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bcache_driver_read/bcache_driver_write
+ ****************************************************************************/
+
+static ssize_t bcache_driver_read(FAR struct inode *inode,
+                                  FAR unsigned char *buffer,
+                                  blkcnt_t start, unsigned int nsectors)
+{
+  if (inode->u.i_bops == NULL || inode->u.i_bops->read == NULL)
+    {
+      return -ENODEV;
+    }
+
+  return inode->u.i_bops->read(inode, buffer, start, nsectors);
+}
+
+static ssize_t bcache_driver_write(FAR struct inode *inode,
+                                   FAR const unsigned char *buffer,
+                                   blkcnt_t start, unsigned int nsectors)
+{
+  if (inode->u.i_bops == NULL || inode->u.i_bops->write == NULL)
+    {
+      return -EACCES;
+    }
+
+  return inode->u.i_bops->write(inode, buffer, start, nsectors);
+}
+
+/****************************************************************************
+ * Name: bcache_writeout
+ *
+ * Description:
+ *   Write a modified sector back to its driver.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BCACHE_WRITEBACK
+static int bcache_writeout(FAR struct bcache_block_s *block)
+{
+  ssize_t ret;
+
+  if (!block->dirty)
+    {
+      return OK;
+    }
+
+  ret = bcache_driver_write(block->inode, block->data, block->sector, 1);
+  if (ret != 1)
+    {
+      ferr("ERROR: Write back of sector %" PRIdOFF " failed: %zd\n",
+           (off_t)block->sector, ret);
+      return ret < 0 ? ret : -EIO;
+    }
+
+  block->dirty = false;
+  return OK;
+}
+#else
+#  define bcache_writeout(block) OK
+#endif
+
+/****************************************************************************
+ * Name: bcache_find
+ ****************************************************************************/
+
+static FAR struct bcache_block_s *bcache_find(FAR struct inode *inode,
+                                              blkcnt_t sector)
+{
+  FAR struct bcache_block_s *block;
+  FAR dq_entry_t *node;
+
+  for (node = dq_peek(&g_bcache.lru); node != NULL; node = dq_next(node))
+    {
+      block = container_of(node, struct bcache_block_s, node);
+      if (block->inode == inode && block->sector == sector)
+        {
+          /* Move it to the front of the LRU list */
+
+          dq_rem(node, &g_bcache.lru);
+          dq_addfirst(node, &g_bcache.lru);
+          return block;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: bcache_evict
+ *
+ * Description:
+ *   Take a block for a new sector, the least recently used one once all
+ *   of them are in use.  NULL is returned if it could not be written back.
+ *
+ ****************************************************************************/
+
+static FAR struct bcache_block_s *bcache_evict(void)
+{
+  FAR struct bcache_block_s *block;
+
+  if (g_bcache.nused < CONFIG_FS_BCACHE_NBLOCKS)
+    {
+      block = &g_bcache.blocks[g_bcache.nused++];
+    }
+  else
+    {
+      block = container_of(dq_tail(&g_bcache.lru),
+                           struct bcache_block_s, node);
+      if (block->inode != NULL && bcache_writeout(block) < 0)
+        {
+          return NULL;
+        }
+
+      dq_rem(&block->node, &g_bcache.lru);
+    }
+
+  block->inode = NULL;
+  dq_addfirst(&block->node, &g_bcache.lru);
+  return block;
+}
+
+/****************************************************************************
+ * Name: bcache_overlap
+ *
+ * Description:
+ *   Call 'handler' for every cached sector of a driver within a range.
+ *
+ ****************************************************************************/
+
+static void bcache_overlap(FAR struct inode *inode, blkcnt_t start,
+                           unsigned int nsectors,
+                           CODE void (*handler)(FAR struct bcache_block_s *,
+                                                FAR unsigned char *),
+                           FAR unsigned char *buffer, size_t sectorsize)
+{
+  FAR struct bcache_block_s *block;
+  FAR dq_entry_t *node;
+
+  for (node = dq_peek(&g_bcache.lru); node != NULL; node = dq_next(node))
+    {
+      block = container_of(node, struct bcache_block_s, node);
+      if (block->inode == inode && block->sector >= start &&
+          block->sector < start + nsectors)
+        {
+          handler(block, buffer + (block->sector - start) * sectorsize);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: bcache_copyout/bcache_copyin
+ ****************************************************************************/
+
+static void bcache_copyout(FAR struct bcache_block_s *block,
+                           FAR unsigned char *buffer)
+{
+#ifdef CONFIG_FS_BCACHE_WRITEBACK
+  /* The sectors in sync with the driver were just read from it */
+
+  if (block->dirty)
+    {
+      memcpy(buffer, block->data, block->size);
+    }
+#endif
+}
+
+static void bcache_copyin(FAR struct bcache_block_s *block,
+                          FAR unsigned char *buffer)
+{
+  memcpy(block->data, buffer, block->size);
+#ifdef CONFIG_FS_BCACHE_WRITEBACK
+  block->dirty = false;
+#endif
+}
+
+/****************************************************************************
+ * Name: bcache_worker
+ *
+ * Description:
+ *   Write back the sectors that are modified for longer than the deadline
+ *   and come back for the others.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BCACHE_WRITEBACK
+static void bcache_worker(FAR void *arg)
+{
+  FAR struct bcache_block_s *block;
+  clock_t deadline = MSEC2TICK(CONFIG_FS_BCACHE_FLUSH_MSEC);
+  clock_t delay = 0;
+  clock_t now;
+  clock_t age;
+  FAR dq_entry_t *node;
+
+  nxmutex_lock(&g_bcache.lock);
+
+  now = clock_systime_ticks();
+  for (node = dq_peek(&g_bcache.lru); node != NULL; node = dq_next(node))
+    {
+      block = container_of(node, struct bcache_block_s, node);
+      if (block->inode == NULL || !block->dirty)
+        {
+          continue;
+        }
+
+      age = now - block->dirtied;
+      if (age >= deadline)
+        {
+          bcache_writeout(block);
+        }
+      else if (delay == 0 || deadline - age < delay)
+        {
+          delay = deadline - age;
+        }
+    }
+
+  if (delay != 0)
+    {
+      work_queue(LPWORK, &g_bcache.work, bcache_worker, NULL, delay);
+    }
+
+  nxmutex_unlock(&g_bcache.lock);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bcache_read
+ *
+ * Description:
+ *   Read sectors of a block driver through the shared buffer cache.
+ *
+ ****************************************************************************/
+
+ssize_t bcache_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                    blkcnt_t start, unsigned int nsectors,
+                    size_t sectorsize)
+{
+  FAR struct bcache_block_s *block;
+  ssize_t ret;
+
+  if (sectorsize > CONFIG_FS_BCACHE_BLOCKSIZE)
+    {
+      return bcache_driver_read(inode, buffer, start, nsectors);
+    }
+
+  ret = nxmutex_lock(&g_bcache.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (nsectors != 1)
+    {
+      /* Bulk reads are left to the driver, apart from the sectors that it
+       * does not have yet.
+       */
+
+      ret = bcache_driver_read(inode, buffer, start, nsectors);
+      if (ret > 0)
+        {
+          bcache_overlap(inode, start, ret, bcache_copyout, buffer,
+                         sectorsize);
+        }
+
+      goto out;
+    }
+
+  block = bcache_find(inode, start);
+  if (block == NULL)
+    {
+      block = bcache_evict();
+      if (block == NULL)
+        {
+          ret = bcache_driver_read(inode, buffer, start, 1);
+          goto out;
+        }
+
+      ret = bcache_driver_read(inode, block->data, start, 1);
+      if (ret != 1)
+        {
+          goto out;
+        }
+
+      block->inode  = inode;
+      block->sector = start;
+      block->size   = sectorsize;
+#ifdef CONFIG_FS_BCACHE_WRITEBACK
+      block->dirty  = false;
+#endif
+    }
+
+  memcpy(buffer, block->data, sectorsize);
+  ret = 1;
+
+out:
+  nxmutex_unlock(&g_bcache.lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_write
+ *
+ * Description:
+ *   Write sectors of a block driver through the shared buffer cache.
+ *
+ ****************************************************************************/
+
+ssize_t bcache_write(FAR struct inode *inode,
+                     FAR const unsigned char *buffer, blkcnt_t start,
+                     unsigned int nsectors, size_t sectorsize)
+{
+  FAR struct bcache_block_s *block;
+  ssize_t ret;
+
+  if (sectorsize > CONFIG_FS_BCACHE_BLOCKSIZE)
+    {
+      return bcache_driver_write(inode, buffer, start, nsectors);
+    }
+
+  ret = nxmutex_lock(&g_bcache.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (nsectors != 1)
+    {
+      /* Bulk writes go to the driver and refresh the cached sectors */
+
+      ret = bcache_driver_write(inode, buffer, start, nsectors);
+      if (ret > 0)
+        {
+          bcache_overlap(inode, start, ret, bcache_copyin,
+                         (FAR unsigned char *)buffer, sectorsize);
+        }
+
+      goto out;
+    }
+
+  block = bcache_find(inode, start);
+  if (block == NULL)
+    {
+      block = bcache_evict();
+    }
+
+#ifdef CONFIG_FS_BCACHE_WRITEBACK
+  if (block != NULL)
+    {
+      memcpy(block->data, buffer, sectorsize);
+      block->inode  = inode;
+      block->sector = start;
+      block->size   = sectorsize;
+      if (!block->dirty)
+        {
+          block->dirty   = true;
+          block->dirtied = clock_systime_ticks();
+        }
+
+      if (work_available(&g_bcache.work))
+        {
+          work_queue(LPWORK, &g_bcache.work, bcache_worker, NULL,
+                     MSEC2TICK(CONFIG_FS_BCACHE_FLUSH_MSEC));
+        }
+
+      ret = 1;
+      goto out;
+    }
+#endif
+
+  ret = bcache_driver_write(inode, buffer, start, 1);
+  if (block != NULL)
+    {
+      if (ret == 1)
+        {
+          memcpy(block->data, buffer, sectorsize);
+          block->inode  = inode;
+          block->sector = start;
+          block->size   = sectorsize;
+        }
+      else
+        {
+          block->inode  = NULL;
+        }
+    }
+
+out:
+  nxmutex_unlock(&g_bcache.lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_flush
+ *
+ * Description:
+ *   Write all the cached sectors of a block driver that are not written
+ *   back yet.
+ *
+ ****************************************************************************/
+
+int bcache_flush(FAR struct inode *inode)
+{
+#ifdef CONFIG_FS_BCACHE_WRITEBACK
+  FAR struct bcache_block_s *block;
+  FAR dq_entry_t *node;
+  int result = OK;
+  int ret;
+
+  ret = nxmutex_lock(&g_bcache.lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (node = dq_peek(&g_bcache.lru); node != NULL; node = dq_next(node))
+    {
+      block = container_of(node, struct bcache_block_s, node);
+      if (block->inode != NULL && (inode == NULL || block->inode == inode))
+        {
+          ret = bcache_writeout(block);
+          if (ret < 0)
+            {
+              result = ret;
+            }
+        }
+    }
+
+  nxmutex_unlock(&g_bcache.lock);
+  return result;
+#else
+  return OK;
+#endif
+}
+
+/****************************************************************************
+ * Name: bcache_invalidate
+ *
+ * Description:
+ *   Flush and then drop all the cached sectors of a block driver.
+ *
+ ****************************************************************************/
+
+int bcache_invalidate(FAR struct inode *inode)
+{
+  FAR struct bcache_block_s *block;
+  FAR dq_entry_t *node;
+  FAR dq_entry_t *next;
+  int ret;
+
+  DEBUGASSERT(inode != NULL);
+
+  ret = bcache_flush(inode);
+
+  /* The dropped blocks go to the end of the LRU list to be reused first */
+
+  nxmutex_lock(&g_bcache.lock);
+  for (node = dq_peek(&g_bcache.lru); node != NULL; node = next)
+    {
+      next  = dq_next(node);
+      block = container_of(node, struct bcache_block_s, node);
+      if (block->inode == inode)
+        {
+          block->inode = NULL;
+#ifdef CONFIG_FS_BCACHE_WRITEBACK
+          block->dirty = false;
+#endif
+          dq_rem(node, &g_bcache.lru);
+          dq_addlast(node, &g_bcache.lru);
+        }
+    }
+
+  nxmutex_unlock(&g_bcache.lock);
+  return ret;
+}
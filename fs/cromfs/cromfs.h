@@ -28,6 +28,18 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Data blocks start with one of the LZF headers of <lzf.h>.  A block
+ * compressed with LZ4 has the layout of struct lzf_type1_header_s with this
+ * type in place of LZF_TYPE1_HDR.
+ */
+
+#define LZ4_TYPE2_HDR      2
+#define LZ4_TYPE2_HDR_SIZE 7
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -34,11 +34,14 @@
 #include <string.h>
 #include <fcntl.h>
 #include <lzf.h>
+#include <lz4.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 
@@ -68,9 +71,18 @@ struct cromfs_dir_s
 struct cromfs_file_s
 {
   FAR const struct cromfs_node_s *ff_node;  /* The open file node */
-  uint32_t ff_offset;                       /* Cached block offset (zero means none) */
-  uint16_t ff_ulen;                         /* Length of decompressed data in cache */
-  FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
+};
+
+/* This structure represents one decompressed block in the cache shared by
+ * all open files.
+ */
+
+struct cromfs_cache_s
+{
+  uint32_t cc_offset;       /* Offset of the block data (zero means none) */
+  uint32_t cc_stamp;        /* Time of last use, for LRU replacement */
+  uint16_t cc_ulen;         /* Length of decompressed data */
+  FAR uint8_t *cc_buffer;   /* Decompressed data */
 };
 
 /* This is the form of the callback from cromfs_foreach_node(): */
@@ -131,6 +143,16 @@ static int      cromfs_find_node(FAR const struct cromfs_volume_s *fs,
                   FAR const char *relpath,
                   FAR struct cromfs_nodeinfo_s *info,
                   FAR uint32_t *offset);
+static int      cromfs_decompress(FAR const struct cromfs_volume_s *fs,
+                  FAR const struct lzf_header_s *hdr, FAR uint8_t *dest);
+static FAR struct cromfs_cache_s *
+                cromfs_cache_find(uint32_t voloffs);
+static int      cromfs_cache_fill(FAR const struct cromfs_volume_s *fs,
+                  FAR const struct lzf_header_s *hdr, uint32_t voloffs,
+                  FAR struct cromfs_cache_s **entry);
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+static void     cromfs_readahead(FAR void *arg);
+#endif
 
 /* Common file system methods */
 
@@ -220,6 +242,23 @@ const struct mountpt_operations g_cromfs_operations =
 
 extern const struct cromfs_volume_s g_cromfs_image;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Decompressed blocks shared by all open files.  The cache, the buffers and
+ * the mount count are protected by g_cromfs_lock.
+ */
+
+static struct cromfs_cache_s g_cromfs_cache[CONFIG_FS_CROMFS_CACHE_NBLOCKS];
+static uint32_t g_cromfs_stamp;
+static unsigned int g_cromfs_nmounts;
+static mutex_t g_cromfs_lock = NXMUTEX_INITIALIZER;
+
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+static struct work_s g_cromfs_work;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -718,6 +757,161 @@ static int cromfs_find_node(FAR const struct cromfs_volume_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: cromfs_decompress
+ *
+ * Description:
+ *   Decompress one LZF or LZ4 block into 'dest', which must hold at least
+ *   the volume block size.  Returns the decompressed length.
+ *
+ ****************************************************************************/
+
+static int cromfs_decompress(FAR const struct cromfs_volume_s *fs,
+                             FAR const struct lzf_header_s *hdr,
+                             FAR uint8_t *dest)
+{
+  FAR const struct lzf_type1_header_s *hdr1 =
+    (FAR const struct lzf_type1_header_s *)hdr;
+  FAR const uint8_t *src = (FAR const uint8_t *)hdr + LZF_TYPE1_HDR_SIZE;
+  unsigned int decomplen;
+  uint16_t ulen;
+  uint16_t clen;
+
+  ulen = (uint16_t)hdr1->lzf_ulen[0] << 8 | (uint16_t)hdr1->lzf_ulen[1];
+  clen = (uint16_t)hdr1->lzf_clen[0] << 8 | (uint16_t)hdr1->lzf_clen[1];
+
+  if (hdr->lzf_type == LZF_TYPE1_HDR)
+    {
+      decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
+    }
+#ifdef CONFIG_FS_CROMFS_LZ4
+  else if (hdr->lzf_type == LZ4_TYPE2_HDR)
+    {
+      decomplen = lz4_decompress(src, clen, dest, fs->cv_bsize);
+    }
+#endif
+  else
+    {
+      ferr("ERROR: Unsupported block type %u\n", hdr->lzf_type);
+      return -EINVAL;
+    }
+
+  if (decomplen != ulen)
+    {
+      ferr("ERROR: Bad block at %p: ulen=%" PRIu16 " decomplen=%u\n",
+           hdr, ulen, decomplen);
+      return -EIO;
+    }
+
+  return decomplen;
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_find
+ *
+ * Description:
+ *   Return the cache entry holding the block with data at image offset
+ *   'voloffs', or NULL.  The caller holds g_cromfs_lock.
+ *
+ ****************************************************************************/
+
+static FAR struct cromfs_cache_s *cromfs_cache_find(uint32_t voloffs)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      if (g_cromfs_cache[i].cc_offset == voloffs)
+        {
+          g_cromfs_cache[i].cc_stamp = ++g_cromfs_stamp;
+          return &g_cromfs_cache[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_fill
+ *
+ * Description:
+ *   Decompress a block into the least recently used cache entry.  The
+ *   caller holds g_cromfs_lock and has checked that the block is not
+ *   already cached.
+ *
+ ****************************************************************************/
+
+static int cromfs_cache_fill(FAR const struct cromfs_volume_s *fs,
+                             FAR const struct lzf_header_s *hdr,
+                             uint32_t voloffs,
+                             FAR struct cromfs_cache_s **entry)
+{
+  FAR struct cromfs_cache_s *victim = &g_cromfs_cache[0];
+  int ret;
+  int i;
+
+  for (i = 1; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      if (g_cromfs_cache[i].cc_stamp < victim->cc_stamp)
+        {
+          victim = &g_cromfs_cache[i];
+        }
+    }
+
+  if (victim->cc_buffer == NULL)
+    {
+      victim->cc_buffer = kmm_malloc(fs->cv_bsize);
+      if (victim->cc_buffer == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  victim->cc_offset = 0;
+  ret = cromfs_decompress(fs, hdr, victim->cc_buffer);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  victim->cc_offset = voloffs;
+  victim->cc_ulen   = ret;
+  victim->cc_stamp  = ++g_cromfs_stamp;
+  *entry            = victim;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cromfs_readahead
+ *
+ * Description:
+ *   Decompress the block 'arg' into the cache on the work queue.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+static void cromfs_readahead(FAR void *arg)
+{
+  FAR const struct lzf_header_s *hdr = arg;
+  FAR const struct cromfs_volume_s *fs = &g_cromfs_image;
+  FAR struct cromfs_cache_s *entry;
+  uint32_t voloffs;
+
+  voloffs = cromfs_addr2offset(fs, (FAR const uint8_t *)hdr +
+                                   LZF_TYPE1_HDR_SIZE);
+
+  /* The file system may have been unmounted since the work was queued */
+
+  nxmutex_lock(&g_cromfs_lock);
+  if (g_cromfs_nmounts > 0 && cromfs_cache_find(voloffs) == NULL)
+    {
+      cromfs_cache_fill(fs, hdr, voloffs, &entry);
+    }
+
+  nxmutex_unlock(&g_cromfs_lock);
+}
+#endif
+
 /****************************************************************************
  * Name: cromfs_open
  ****************************************************************************/
@@ -786,15 +980,6 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
-  /* Create a file buffer to support partial sector accesses */
-
-  ff->ff_buffer = kmm_malloc(fs->cv_bsize);
-  if (!ff->ff_buffer)
-    {
-      kmm_free(ff);
-      return -ENOMEM;
-    }
-
   /* Save the node in the open file instance */
 
   ff->ff_node = (FAR const struct cromfs_node_s *)
@@ -820,11 +1005,10 @@ static int cromfs_close(FAR struct file *filep)
   /* Get the open file instance from the file structure */
 
   ff = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Free all resources consumed by the opened file */
 
-  kmm_free(ff->ff_buffer);
   kmm_free(ff);
 
   return OK;
@@ -866,7 +1050,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   /* Get the open file instance from the file structure */
 
   ff = (FAR struct cromfs_file_s *)filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Check for a read past the end of the file */
 
@@ -971,83 +1155,72 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
         }
       else
         {
-          /* If the source of the data is at the beginning of the compressed
-           * data buffer and if the uncompressed data would not overrun the
-           * buffer, then we can decompress directly into the user buffer.
-           */
+          FAR struct cromfs_cache_s *entry;
+          uint32_t voloffs;
+          int ret;
+
+          copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
+          DEBUGASSERT(ulen > copyoffs);
+          copysize = ulen - copyoffs;
 
-          if (filep->f_pos <= blkoffs && ulen <= remaining)
+          if (copysize > remaining)  /* Clip to the size really needed */
             {
-              uint32_t voloffs;
+              copysize = remaining;
+            }
 
-              copyoffs = 0;
-              copysize = ulen;
+          /* Get the offset in the CROMFS image of the compressed data.
+           * Check if the block is already in the cache.
+           */
 
-              /* Get the address and offset in the CROMFS image to obtain
-               * the data.  Check if we already have this offset in the
-               * cache.
-               */
+          src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
+          voloffs = cromfs_addr2offset(fs, src);
 
-              src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
+          ret = nxmutex_lock(&g_cromfs_lock);
+          if (ret >= 0)
+            {
+              entry = cromfs_cache_find(voloffs);
+              if (entry == NULL && copyoffs == 0 && copysize == ulen)
                 {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
+                  /* Not cached, but the whole block is wanted: decompress
+                   * it directly into the user buffer.
+                   */
 
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
+                  nxmutex_unlock(&g_cromfs_lock);
+                  ret = cromfs_decompress(fs, currhdr, dest);
                 }
+              else
+                {
+                  /* Otherwise we need the block in the cache */
 
-              finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32
-                    " ulen=%" PRIu16 " ff_offset=%" PRIu32 " copysize=%u\n",
-                    voloffs, blkoffs, ulen, ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
-            }
-          else
-            {
-              uint32_t voloffs;
-
-              /* No, we will need to decompress into the our intermediate
-               * decompression buffer.
-               */
+                  if (entry == NULL)
+                    {
+                      ret = cromfs_cache_fill(fs, currhdr, voloffs, &entry);
+                    }
 
-              copyoffs = (blkoffs >= filep->f_pos) ?
-                            0 : filep->f_pos - blkoffs;
-              DEBUGASSERT(ulen > copyoffs);
-              copysize = ulen - copyoffs;
+                  if (ret >= 0)
+                    {
+                      DEBUGASSERT(entry->cc_ulen >= (copyoffs + copysize));
+                      memcpy(dest, &entry->cc_buffer[copyoffs], copysize);
+                    }
 
-              if (copysize > remaining)  /* Clip to the size really needed */
-                {
-                  copysize = remaining;
+                  nxmutex_unlock(&g_cromfs_lock);
                 }
+            }
 
-              DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
-
-              src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
+          finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32 " ulen=%" PRIu16
+                " clen=%" PRIu16 " copyoffs=%u copysize=%u\n",
+                voloffs, blkoffs, ulen, clen, copyoffs, copysize);
 
-                  decomplen = lzf_decompress(src, clen, ff->ff_buffer,
-                                             fs->cv_bsize);
+          if (ret < 0)
+            {
+              /* Return the data read before the bad block, if any */
 
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
+              if (fpos == filep->f_pos)
+                {
+                  return ret;
                 }
 
-              finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32 " ulen=%" PRIu16
-                    " clen=%" PRIu16 " ff_offset=%" PRIu32
-                    "  copyoffs=%u copysize=%u\n",
-                    voloffs, blkoffs, ulen, clen, ff->ff_offset,
-                    copyoffs, copysize);
-              DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
-
-              /* Then copy to user buffer */
-
-              memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+              break;
             }
         }
 
@@ -1058,8 +1231,21 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
       fpos      += copysize;
     }
 
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+  /* Start decompressing the next block if it is compressed and not cached
+   * yet.  The reader is most likely sequential.
+   */
+
+  if (fpos == blkoffs + ulen && fpos < ff->ff_node->cn_size &&
+      nexthdr->lzf_type != LZF_TYPE0_HDR && work_available(&g_cromfs_work))
+    {
+      work_queue(LPWORK, &g_cromfs_work, cromfs_readahead, nexthdr, 0);
+    }
+#endif
+
   /* Update the file pointer */
 
+  buflen       = fpos - filep->f_pos;
   filep->f_pos = fpos;
   return buflen;
 }
@@ -1087,7 +1273,6 @@ static int cromfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
 static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
 {
-  FAR struct cromfs_volume_s *fs;
   FAR struct cromfs_file_s *oldff;
   FAR struct cromfs_file_s *newff;
 
@@ -1095,15 +1280,10 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   DEBUGASSERT(oldp->f_priv != NULL && oldp->f_inode != NULL &&
               newp->f_priv == NULL && newp->f_inode != NULL);
 
-  /* Recover our private data from the struct file instance */
-
-  fs = oldp->f_inode->i_private;
-  DEBUGASSERT(fs != NULL);
-
   /* Get the open file instance from the file structure */
 
   oldff = oldp->f_priv;
-  DEBUGASSERT(oldff->ff_node != NULL && oldff->ff_buffer != NULL);
+  DEBUGASSERT(oldff->ff_node != NULL);
 
   /* Allocate and initialize an new open file instance referring to the
    * same node.
@@ -1115,15 +1295,6 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       return -ENOMEM;
     }
 
-  /* Create a file buffer to support partial sector accesses */
-
-  newff->ff_buffer = kmm_malloc(fs->cv_bsize);
-  if (newff->ff_buffer == NULL)
-    {
-      kmm_free(newff);
-      return -ENOMEM;
-    }
-
   /* Save the node in the open file instance */
 
   newff->ff_node = oldff->ff_node;
@@ -1160,7 +1331,7 @@ static int cromfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
    */
 
   ff              = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   inode           = filep->f_inode;
   fs              = inode->i_private;
@@ -1422,6 +1593,12 @@ static int cromfs_bind(FAR struct inode *blkdriver, const void *data,
   DEBUGASSERT(blkdriver == NULL && handle != NULL);
   DEBUGASSERT(g_cromfs_image.cv_magic == CROMFS_MAGIC);
 
+  /* The block cache is released when the last mount is removed */
+
+  nxmutex_lock(&g_cromfs_lock);
+  g_cromfs_nmounts++;
+  nxmutex_unlock(&g_cromfs_lock);
+
   /* Return the new file system handle */
 
   *handle = (FAR void *)&g_cromfs_image;
@@ -1439,8 +1616,28 @@ static int cromfs_bind(FAR struct inode *blkdriver, const void *data,
 static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
                         unsigned int flags)
 {
+  int i;
+
   finfo("handle: %p blkdriver: %p flags: %02x\n",
         handle, blkdriver, flags);
+
+#ifdef CONFIG_FS_CROMFS_READAHEAD
+  work_cancel(LPWORK, &g_cromfs_work);
+#endif
+
+  nxmutex_lock(&g_cromfs_lock);
+  if (--g_cromfs_nmounts == 0)
+    {
+      for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+        {
+          kmm_free(g_cromfs_cache[i].cc_buffer);
+          memset(&g_cromfs_cache[i], 0, sizeof(struct cromfs_cache_s));
+        }
+
+      g_cromfs_stamp = 0;
+    }
+
+  nxmutex_unlock(&g_cromfs_lock);
   return OK;
 }
 
@@ -28,6 +28,7 @@
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <sys/mount.h>
+#include <sys/uio.h>
 
 #include <stdlib.h>
 #include <unistd.h>
@@ -38,6 +39,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/bcache.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
 
@@ -65,6 +67,10 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
 static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
                  size_t buflen);
+static ssize_t fat_readv(FAR struct file *filep,
+                 FAR const struct iovec *iov, int iovcnt);
+static ssize_t fat_writev(FAR struct file *filep,
+                 FAR const struct iovec *iov, int iovcnt);
 static off_t   fat_seek(FAR struct file *filep, off_t offset, int whence);
 static int     fat_ioctl(FAR struct file *filep, int cmd,
                  unsigned long arg);
@@ -146,7 +152,9 @@ const struct mountpt_operations g_fat_operations =
   fat_rmdir,         /* rmdir */
   fat_rename,        /* rename */
   fat_stat,          /* stat */
-  NULL               /* chstat */
+  NULL,              /* chstat */
+  fat_readv,         /* readv */
+  fat_writev         /* writev */
 };
 
 /****************************************************************************
@@ -470,11 +478,16 @@ static int fat_close(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: fat_read
+ * Name: fat_doread
+ *
+ * Description:
+ *   Transfer one buffer of a vector.  The caller holds the mount lock and
+ *   has checked the mount.
+ *
  ****************************************************************************/
 
-static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
-                        size_t buflen)
+static ssize_t fat_doread(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
 {
   FAR struct inode *inode;
   FAR struct fat_mountpt_s *fs;
@@ -489,6 +502,8 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
+  unsigned int navail;
+  uint32_t lastcluster;
   bool force_indirect = false;
 #endif
 
@@ -499,41 +514,9 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
   /* Recover our private data from the struct file instance */
 
   ff = filep->f_priv;
-
-  /* Check for the forced mount condition */
-
-  if ((ff->ff_bflags & UMOUNT_FORCED) != 0)
-    {
-      return -EPIPE;
-    }
-
   inode = filep->f_inode;
   fs    = inode->i_private;
 
-  DEBUGASSERT(fs != NULL);
-
-  /* Make sure that the mount is still healthy */
-
-  ret = nxmutex_lock(&fs->fs_lock);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  ret = fat_checkmount(fs);
-  if (ret != OK)
-    {
-      goto errout_with_lock;
-    }
-
-  /* Check if the file was opened with read access */
-
-  if ((ff->ff_oflags & O_RDOK) == 0)
-    {
-      ret = -EACCES;
-      goto errout_with_lock;
-    }
-
   /* Get the number of bytes left in the file */
 
   bytesleft = ff->ff_size - filep->f_pos;
@@ -558,7 +541,7 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
       ret = fat_currentsector(fs, ff, filep->f_pos);
       if (ret < 0)
         {
-          goto errout_with_lock;
+          return ret;
         }
     }
 
@@ -585,8 +568,7 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
           cluster = fat_getcluster(fs, ff->ff_currentcluster);
           if (cluster < 2 || cluster >= fs->fs_nclusters)
             {
-              ret = -EINVAL; /* Not the right error */
-              goto errout_with_lock;
+              return -EINVAL; /* Not the right error */
             }
 
           /* Setup to read the first sector from the new cluster */
@@ -614,12 +596,15 @@ fat_read_restart:
            *
            * Limit the number of sectors that we read on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and in the clusters that physically follow
+           * it in the chain
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          ret = fat_contigsectors(fs, ff, &nsectors, false, &lastcluster,
+                                  &navail);
+          if (ret < 0)
             {
-              nsectors = ff->ff_sectorsincluster;
+              return ret;
             }
 
           /* We are not sure of the state of the file buffer so
@@ -651,10 +636,11 @@ fat_read_restart:
                 }
 #endif /* CONFIG_FAT_DIRECT_RETRY */
 
-              goto errout_with_lock;
+              return ret;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
+          ff->ff_currentcluster    = lastcluster;
+          ff->ff_sectorsincluster  = navail - nsectors;
           ff->ff_currentsector    += nsectors;
           bytesread                = nsectors * fs->fs_hwsectorsize;
         }
@@ -670,7 +656,7 @@ fat_read_restart:
           ret = fat_ffcacheread(fs, ff, ff->ff_currentsector);
           if (ret < 0)
             {
-              goto errout_with_lock;
+              return ret;
             }
 
           /* Copy the requested part of the sector into the user buffer */
@@ -702,20 +688,20 @@ fat_read_restart:
       sectorindex   = filep->f_pos & SEC_NDXMASK(fs);
     }
 
-  nxmutex_unlock(&fs->fs_lock);
   return readsize;
-
-errout_with_lock:
-  nxmutex_unlock(&fs->fs_lock);
-  return ret;
 }
 
 /****************************************************************************
- * Name: fat_write
+ * Name: fat_dowrite
+ *
+ * Description:
+ *   Transfer one buffer of a vector.  The caller holds the mount lock and
+ *   has checked the mount.
+ *
  ****************************************************************************/
 
-static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
-                         size_t buflen)
+static ssize_t fat_dowrite(FAR struct file *filep, FAR const char *buffer,
+                           size_t buflen)
 {
   FAR struct inode *inode;
   FAR struct fat_mountpt_s *fs;
@@ -729,6 +715,8 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
+  unsigned int navail;
+  uint32_t lastcluster;
   bool force_indirect = false;
 #endif
 
@@ -737,47 +725,14 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
   /* Recover our private data from the struct file instance */
 
   ff = filep->f_priv;
-
-  /* Check for the forced mount condition */
-
-  if ((ff->ff_bflags & UMOUNT_FORCED) != 0)
-    {
-      return -EPIPE;
-    }
-
   inode = filep->f_inode;
   fs    = inode->i_private;
 
-  DEBUGASSERT(fs != NULL);
-
-  /* Make sure that the mount is still healthy */
-
-  ret = nxmutex_lock(&fs->fs_lock);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
-  ret = fat_checkmount(fs);
-  if (ret != OK)
-    {
-      goto errout_with_lock;
-    }
-
-  /* Check if the file was opened for write access */
-
-  if ((ff->ff_oflags & O_WROK) == 0)
-    {
-      ret = -EACCES;
-      goto errout_with_lock;
-    }
-
   /* Check if the file size would exceed the range of off_t */
 
   if (buflen > OFF_MAX || ff->ff_size > OFF_MAX - (off_t)buflen)
     {
-      ret = -EFBIG;
-      goto errout_with_lock;
+      return -EFBIG;
     }
 
   /* Get the first sector to write to. */
@@ -802,7 +757,7 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
       ret = fat_currentsector(fs, ff, filep->f_pos);
       if (ret < 0)
         {
-          goto errout_with_lock;
+          return ret;
         }
     }
 
@@ -832,13 +787,11 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
 
           if (cluster < 0)
             {
-              ret = cluster;
-              goto errout_with_lock;
+              return cluster;
             }
           else if (cluster < 2 || cluster >= fs->fs_nclusters)
             {
-              ret = -ENOSPC;
-              goto errout_with_lock;
+              return -ENOSPC;
             }
 
           /* Setup to write the first sector from the new cluster */
@@ -865,12 +818,15 @@ fat_write_restart:
            *
            * Limit the number of sectors that we write on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and in the clusters that physically follow
+           * it in the chain
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          ret = fat_contigsectors(fs, ff, &nsectors, true, &lastcluster,
+                                  &navail);
+          if (ret < 0)
             {
-              nsectors = ff->ff_sectorsincluster;
+              return ret;
             }
 
           /* We are not sure of the state of the sector cache so the
@@ -903,10 +859,11 @@ fat_write_restart:
                 }
 #endif /* CONFIG_FAT_DIRECT_RETRY */
 
-              goto errout_with_lock;
+              return ret;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
+          ff->ff_currentcluster    = lastcluster;
+          ff->ff_sectorsincluster  = navail - nsectors;
           ff->ff_currentsector    += nsectors;
           writesize                = nsectors * fs->fs_hwsectorsize;
           ff->ff_bflags           |= FFBUFF_MODIFIED;
@@ -937,7 +894,7 @@ fat_write_restart:
               ret = fat_ffcacheflush(fs, ff);
               if (ret < 0)
                 {
-                  goto errout_with_lock;
+                  return ret;
                 }
 
               /* Now mark the clean cache buffer as the current sector. */
@@ -953,7 +910,7 @@ fat_write_restart:
               ret = fat_ffcacheread(fs, ff, ff->ff_currentsector);
               if (ret < 0)
                 {
-                  goto errout_with_lock;
+                  return ret;
                 }
             }
 
@@ -1003,14 +960,154 @@ fat_write_restart:
       ff->ff_size = filep->f_pos;
     }
 
-  nxmutex_unlock(&fs->fs_lock);
   return byteswritten;
+}
+
+/****************************************************************************
+ * Name: fat_transfer
+ *
+ * Description:
+ *   Read or write all of the buffers of a vector under one hold of the
+ *   mount lock.  The transfer ends at the first short transfer.
+ *
+ ****************************************************************************/
+
+static ssize_t fat_transfer(FAR struct file *filep,
+                            FAR const struct iovec *iov, int iovcnt,
+                            bool write)
+{
+  FAR struct inode *inode;
+  FAR struct fat_mountpt_s *fs;
+  FAR struct fat_file_s *ff;
+  ssize_t ntotal = 0;
+  ssize_t nxfer;
+  int ret;
+  int i;
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  /* Recover our private data from the struct file instance */
+
+  ff = filep->f_priv;
+
+  /* Check for the forced mount condition */
+
+  if ((ff->ff_bflags & UMOUNT_FORCED) != 0)
+    {
+      return -EPIPE;
+    }
+
+  inode = filep->f_inode;
+  fs    = inode->i_private;
+
+  DEBUGASSERT(fs != NULL);
+
+  /* Make sure that the mount is still healthy */
+
+  ret = nxmutex_lock(&fs->fs_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = fat_checkmount(fs);
+  if (ret != OK)
+    {
+      goto errout_with_lock;
+    }
+
+  /* Check if the file was opened with the needed access */
+
+  if ((ff->ff_oflags & (write ? O_WROK : O_RDOK)) == 0)
+    {
+      ret = -EACCES;
+      goto errout_with_lock;
+    }
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      if (write)
+        {
+          nxfer = fat_dowrite(filep, iov[i].iov_base, iov[i].iov_len);
+        }
+      else
+        {
+          nxfer = fat_doread(filep, iov[i].iov_base, iov[i].iov_len);
+        }
+
+      if (nxfer < 0)
+        {
+          if (ntotal == 0)
+            {
+              ntotal = nxfer;
+            }
+
+          break;
+        }
+
+      ntotal += nxfer;
+      if ((size_t)nxfer < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&fs->fs_lock);
+  return ntotal;
 
 errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
 
+/****************************************************************************
+ * Name: fat_read
+ ****************************************************************************/
+
+static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
+                        size_t buflen)
+{
+  struct iovec iov;
+
+  iov.iov_base = buffer;
+  iov.iov_len  = buflen;
+  return fat_transfer(filep, &iov, 1, false);
+}
+
+/****************************************************************************
+ * Name: fat_write
+ ****************************************************************************/
+
+static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t buflen)
+{
+  struct iovec iov;
+
+  iov.iov_base = (FAR char *)buffer;
+  iov.iov_len  = buflen;
+  return fat_transfer(filep, &iov, 1, true);
+}
+
+/****************************************************************************
+ * Name: fat_readv
+ ****************************************************************************/
+
+static ssize_t fat_readv(FAR struct file *filep,
+                         FAR const struct iovec *iov, int iovcnt)
+{
+  return fat_transfer(filep, iov, iovcnt, false);
+}
+
+/****************************************************************************
+ * Name: fat_writev
+ ****************************************************************************/
+
+static ssize_t fat_writev(FAR struct file *filep,
+                          FAR const struct iovec *iov, int iovcnt)
+{
+  return fat_transfer(filep, iov, iovcnt, true);
+}
+
 /****************************************************************************
  * Name: fat_seek
  ****************************************************************************/
@@ -1153,6 +1250,15 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
        */
 
       clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+
+#if CONFIG_FAT_EXTENTS > 0
+      /* Start from the closest cluster known to precede the position */
+
+      filep->f_pos  = (off_t)fat_extentfind(ff, position / clustersize,
+                                            &cluster) * clustersize;
+      position     -= filep->f_pos;
+#endif
+
       for (; ; )
         {
           /* Skip over clusters prior to the one containing
@@ -1160,6 +1266,9 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
            */
 
           ff->ff_currentcluster = cluster;
+#if CONFIG_FAT_EXTENTS > 0
+          fat_extentadd(ff, filep->f_pos / clustersize, cluster);
+#endif
           if (position < clustersize)
             {
               break;
@@ -1436,6 +1545,15 @@ static int fat_sync(FAR struct file *filep)
       ret          = fat_updatefsinfo(fs);
     }
 
+#ifdef CONFIG_FS_BCACHE
+  /* Push out the sectors still held by the shared block cache */
+
+  if (ret >= 0)
+    {
+      ret = bcache_flush(fs->fs_blkdriver);
+    }
+#endif
+
 errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -2277,6 +2395,10 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       FAR struct inode *inode = fs->fs_blkdriver;
       if (inode)
         {
+#ifdef CONFIG_FS_BCACHE
+          bcache_invalidate(inode);
+#endif
+
           if (inode->u.i_bops && inode->u.i_bops->close)
             {
               inode->u.i_bops->close(inode);
@@ -2302,6 +2424,10 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  fat_freemapfree(fs);
+#endif
+
   nxmutex_destroy(&fs->fs_lock);
   kmm_free(fs);
   return OK;
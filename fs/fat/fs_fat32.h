@@ -887,7 +887,22 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#ifdef CONFIG_FAT_FREEMAP
+  FAR uint32_t *fs_freemap;        /* Bitmap of the clusters in use */
+  bool     fs_freemapfailed;       /* true: The bitmap could not be built */
+#endif
+};
+
+#if CONFIG_FAT_EXTENTS > 0
+/* A run of consecutive clusters in the chain of a file */
+
+struct fat_extent_s
+{
+  uint32_t fe_index;               /* Index of the first cluster in the file */
+  uint32_t fe_cluster;             /* First cluster of the run */
+  uint32_t fe_count;               /* Number of clusters in the run */
 };
+#endif
 
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
@@ -908,6 +923,11 @@ struct fat_file_s
   off_t    ff_currentsector;       /* Current sector being operated on */
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#if CONFIG_FAT_EXTENTS > 0
+  uint8_t  ff_nextents;            /* Number of valid entries in ff_extents */
+  uint8_t  ff_extentndx;           /* Next entry of ff_extents to replace */
+  struct fat_extent_s ff_extents[CONFIG_FAT_EXTENTS];
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -1050,6 +1070,12 @@ EXTERN int32_t fat_extendchain(FAR struct fat_mountpt_s *fs,
 
 #define fat_createchain(fs) fat_extendchain(fs, 0)
 
+EXTERN int    fat_contigsectors(FAR struct fat_mountpt_s *fs,
+                                FAR struct fat_file_s *ff,
+                                FAR unsigned int *nsectors, bool extend,
+                                FAR uint32_t *lastcluster,
+                                FAR unsigned int *navail);
+
 /* Help for traversing directory trees and accessing directory entries */
 
 EXTERN int    fat_nextdirentry(FAR struct fat_mountpt_s *fs,
@@ -1095,6 +1121,19 @@ EXTERN int    fat_ffcacheread(FAR struct fat_mountpt_s *fs,
 EXTERN int    fat_ffcacheinvalidate(FAR struct fat_mountpt_s *fs,
                                     FAR struct fat_file_s *ff);
 
+/* Cluster chain cache and free cluster bitmap */
+
+#if CONFIG_FAT_EXTENTS > 0
+EXTERN uint32_t fat_extentfind(FAR struct fat_file_s *ff, uint32_t index,
+                               FAR int32_t *cluster);
+EXTERN void   fat_extentadd(FAR struct fat_file_s *ff, uint32_t index,
+                            uint32_t cluster);
+EXTERN void   fat_extentinvalidate(FAR struct fat_mountpt_s *fs);
+#endif
+#ifdef CONFIG_FAT_FREEMAP
+EXTERN void   fat_freemapfree(FAR struct fat_mountpt_s *fs);
+#endif
+
 /* FSINFO sector support */
 
 EXTERN int    fat_updatefsinfo(FAR struct fat_mountpt_s *fs);
@@ -30,12 +30,14 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <time.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/bcache.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
 
@@ -263,6 +265,133 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+#ifdef CONFIG_FAT_FREEMAP
+/****************************************************************************
+ * Name: fat_freemapset
+ *
+ * Description:
+ *   Record whether a cluster is in use in the free cluster bitmap
+ *
+ ****************************************************************************/
+
+static inline void fat_freemapset(FAR struct fat_mountpt_s *fs,
+                                  uint32_t cluster, bool inuse)
+{
+  if (fs->fs_freemap != NULL)
+    {
+      if (inuse)
+        {
+          fs->fs_freemap[cluster >> 5] |= (uint32_t)1 << (cluster & 31);
+        }
+      else
+        {
+          fs->fs_freemap[cluster >> 5] &= ~((uint32_t)1 << (cluster & 31));
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fat_freemapbuild
+ *
+ * Description:
+ *   Build the free cluster bitmap from the FAT.  Clusters 0 and 1, and the
+ *   bits past the last cluster, are marked in use so that they are never
+ *   returned as free.
+ *
+ ****************************************************************************/
+
+static int fat_freemapbuild(FAR struct fat_mountpt_s *fs)
+{
+  uint32_t nwords = (fs->fs_nclusters + 31) / 32;
+  uint32_t nfreeclusters = 0;
+  uint32_t cluster;
+  off_t next;
+
+  fs->fs_freemap = kmm_malloc(nwords * sizeof(uint32_t));
+  if (fs->fs_freemap == NULL)
+    {
+      fwarn("WARNING: No memory for the free cluster bitmap\n");
+      fs->fs_freemapfailed = true;
+      return -ENOMEM;
+    }
+
+  memset(fs->fs_freemap, 0xff, nwords * sizeof(uint32_t));
+  for (cluster = 2; cluster < fs->fs_nclusters; cluster++)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          fat_freemapfree(fs);
+          fs->fs_freemapfailed = true;
+          return next;
+        }
+
+      if (next == 0)
+        {
+          fat_freemapset(fs, cluster, false);
+          nfreeclusters++;
+        }
+    }
+
+  /* The count comes for free and may be better than the FSINFO one */
+
+  fs->fs_fsifreecount = nfreeclusters;
+  if (fs->fs_type == FSTYPE_FAT32)
+    {
+      fs->fs_fsidirty = true;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_freemapfind
+ *
+ * Description:
+ *   Find the first free cluster after 'start', wrapping around to the
+ *   beginning of the volume.  Returns 0 if there is none.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_freemapfind(FAR struct fat_mountpt_s *fs,
+                                uint32_t start)
+{
+  uint32_t nwords = (fs->fs_nclusters + 31) / 32;
+  uint32_t cluster = start + 1;
+  uint32_t word;
+  uint32_t ndx;
+  uint32_t n;
+
+  if (cluster >= fs->fs_nclusters)
+    {
+      cluster = 2;
+    }
+
+  /* Visit every word once, the first one again at the end for the bits
+   * before 'cluster'.
+   */
+
+  ndx  = cluster >> 5;
+  word = ~fs->fs_freemap[ndx] & (UINT32_MAX << (cluster & 31));
+  for (n = 0; n <= nwords; n++)
+    {
+      if (word != 0)
+        {
+          return (ndx << 5) + ffs(word) - 1;
+        }
+
+      if (++ndx >= nwords)
+        {
+          ndx = 0;
+        }
+
+      word = ~fs->fs_freemap[ndx];
+    }
+
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -721,8 +850,13 @@ int fat_hwread(struct fat_mountpt_s *fs, uint8_t *buffer,  off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->read)
         {
+#ifdef CONFIG_FS_BCACHE
+          ssize_t nsectorsread = bcache_read(inode, buffer, sector,
+                                             nsectors, fs->fs_hwsectorsize);
+#else
           ssize_t nsectorsread = inode->u.i_bops->read(inode, buffer,
                                                        sector, nsectors);
+#endif
           if (nsectorsread == nsectors)
             {
               ret = OK;
@@ -754,8 +888,14 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
       struct inode *inode = fs->fs_blkdriver;
       if (inode && inode->u.i_bops && inode->u.i_bops->write)
         {
+#ifdef CONFIG_FS_BCACHE
+          ssize_t nsectorswritten =
+              bcache_write(inode, buffer, sector, nsectors,
+                           fs->fs_hwsectorsize);
+#else
           ssize_t nsectorswritten =
               inode->u.i_bops->write(inode, buffer, sector, nsectors);
+#endif
 
           if (nsectorswritten == nsectors)
             {
@@ -1092,6 +1232,9 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
+#ifdef CONFIG_FAT_FREEMAP
+      fat_freemapset(fs, clusterno, nextcluster != 0);
+#endif
       return OK;
     }
 
@@ -1111,6 +1254,12 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
   int32_t nextcluster;
   int    ret;
 
+#if CONFIG_FAT_EXTENTS > 0
+  /* The freed clusters may be reused by any file */
+
+  fat_extentinvalidate(fs);
+#endif
+
   /* Loop while there are clusters in the chain */
 
   while (cluster >= 2 && cluster < fs->fs_nclusters)
@@ -1221,6 +1370,38 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
    */
 
   newcluster = startcluster;
+
+#ifdef CONFIG_FAT_FREEMAP
+  /* Look for the free cluster in the bitmap, building it first if this is
+   * the first allocation since the volume was mounted.
+   */
+
+  if (fs->fs_freemap == NULL && !fs->fs_freemapfailed)
+    {
+      ret = fat_freemapbuild(fs);
+      if (ret < 0 && ret != -ENOMEM)
+        {
+          return ret;
+        }
+    }
+
+  if (fs->fs_freemap != NULL)
+    {
+      newcluster = fat_freemapfind(fs, startcluster);
+      if (newcluster == 0)
+        {
+          return 0;
+        }
+
+      /* Let the search below start right before it, which also checks it
+       * against the FAT.
+       */
+
+      startcluster = newcluster - 1;
+      newcluster   = startcluster;
+    }
+#endif
+
   for (; ; )
     {
       /* Examine the next cluster in the FAT */
@@ -1312,6 +1493,209 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
   return newcluster;
 }
 
+/****************************************************************************
+ * Name: fat_contigsectors
+ *
+ * Description:
+ *   Find how much of a whole-sector transfer starting at the current
+ *   sector of a file can be done with one driver request, i.e. follow the
+ *   cluster chain past the current cluster as long as the clusters are
+ *   physically contiguous.  The file state is not changed.
+ *
+ * Input Parameters:
+ *   fs          - The mountpoint
+ *   ff          - The open file
+ *   nsectors    - The number of sectors wanted, and on return the number
+ *                 of sectors to transfer
+ *   extend      - Allocate the clusters missing at the end of the chain
+ *   lastcluster - Returns the cluster of the last sector transferred
+ *   navail      - Returns the number of sectors from the current sector to
+ *                 the end of 'lastcluster'
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int fat_contigsectors(FAR struct fat_mountpt_s *fs,
+                      FAR struct fat_file_s *ff,
+                      FAR unsigned int *nsectors, bool extend,
+                      FAR uint32_t *lastcluster,
+                      FAR unsigned int *navail)
+{
+  uint32_t cluster = ff->ff_currentcluster;
+  unsigned int avail = ff->ff_sectorsincluster;
+  off_t next;
+
+  while (avail < *nsectors)
+    {
+      if (extend)
+        {
+          next = fat_extendchain(fs, cluster);
+        }
+      else
+        {
+          next = fat_getcluster(fs, cluster);
+        }
+
+      if (next < 0)
+        {
+          return next;
+        }
+
+      /* The end of the chain and a gap end the run alike */
+
+      if (next != cluster + 1)
+        {
+          break;
+        }
+
+      cluster = next;
+      avail  += fs->fs_fatsecperclus;
+    }
+
+  if (*nsectors > avail)
+    {
+      *nsectors = avail;
+    }
+
+  *lastcluster = cluster;
+  *navail      = avail;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_extentfind
+ *
+ * Description:
+ *   Find the closest cluster of a file, at or before the cluster with the
+ *   given index in the file, whose number is in the cluster chain cache.
+ *
+ * Returned Value:
+ *   The index of that cluster in the file, its number is returned in
+ *   'cluster'.  Zero and the start cluster if nothing better is known.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_EXTENTS > 0
+uint32_t fat_extentfind(FAR struct fat_file_s *ff, uint32_t index,
+                        FAR int32_t *cluster)
+{
+  FAR struct fat_extent_s *extent;
+  uint32_t best = 0;
+  uint32_t offset;
+  int i;
+
+  *cluster = ff->ff_startcluster;
+  for (i = 0; i < ff->ff_nextents; i++)
+    {
+      extent = &ff->ff_extents[i];
+      if (extent->fe_index > index)
+        {
+          continue;
+        }
+
+      offset = index - extent->fe_index;
+      if (offset >= extent->fe_count)
+        {
+          offset = extent->fe_count - 1;
+        }
+
+      if (extent->fe_index + offset > best)
+        {
+          best     = extent->fe_index + offset;
+          *cluster = extent->fe_cluster + offset;
+        }
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: fat_extentadd
+ *
+ * Description:
+ *   Record that the cluster with the given index in a file is 'cluster'.
+ *   It extends the run that it follows, if any, or takes a new entry,
+ *   replacing the entries in turn once all are used.
+ *
+ ****************************************************************************/
+
+void fat_extentadd(FAR struct fat_file_s *ff, uint32_t index,
+                   uint32_t cluster)
+{
+  FAR struct fat_extent_s *extent;
+  int i;
+
+  for (i = 0; i < ff->ff_nextents; i++)
+    {
+      extent = &ff->ff_extents[i];
+      if (index >= extent->fe_index &&
+          index < extent->fe_index + extent->fe_count)
+        {
+          return;
+        }
+
+      if (index == extent->fe_index + extent->fe_count &&
+          cluster == extent->fe_cluster + extent->fe_count)
+        {
+          extent->fe_count++;
+          return;
+        }
+    }
+
+  if (ff->ff_nextents < CONFIG_FAT_EXTENTS)
+    {
+      extent = &ff->ff_extents[ff->ff_nextents++];
+    }
+  else
+    {
+      extent = &ff->ff_extents[ff->ff_extentndx];
+      ff->ff_extentndx = (ff->ff_extentndx + 1) % CONFIG_FAT_EXTENTS;
+    }
+
+  extent->fe_index   = index;
+  extent->fe_cluster = cluster;
+  extent->fe_count   = 1;
+}
+
+/****************************************************************************
+ * Name: fat_extentinvalidate
+ *
+ * Description:
+ *   Forget the cached cluster chains of all the files open on a volume,
+ *   after a chain has been cut.
+ *
+ ****************************************************************************/
+
+void fat_extentinvalidate(FAR struct fat_mountpt_s *fs)
+{
+  FAR struct fat_file_s *ff;
+
+  for (ff = fs->fs_head; ff != NULL; ff = ff->ff_next)
+    {
+      ff->ff_nextents  = 0;
+      ff->ff_extentndx = 0;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_freemapfree
+ *
+ * Description:
+ *   Release the free cluster bitmap
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+void fat_freemapfree(FAR struct fat_mountpt_s *fs)
+{
+  kmm_free(fs->fs_freemap);
+  fs->fs_freemap = NULL;
+}
+#endif
+
 /****************************************************************************
  * Name: fat_nextdirentry
  *
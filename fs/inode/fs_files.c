@@ -53,6 +53,16 @@
 
 /****************************************************************************
  * Name: files_extend
+ *
+ * Description:
+ *   Grow the file list to 'row' rows.  fs_getfilep() reads the list without
+ *   the list mutex, so the array of rows is replaced rather than
+ *   reallocated, and the old array is kept until files_releaselist().  The
+ *   word before each array links it to the array it replaced.
+ *
+ * Assumptions:
+ *   The caller holds the list mutex.
+ *
  ****************************************************************************/
 
 static int files_extend(FAR struct filelist *list, size_t row)
@@ -70,13 +80,19 @@ static int files_extend(FAR struct filelist *list, size_t row)
       return -EMFILE;
     }
 
-  tmp = kmm_realloc(list->fl_files, sizeof(FAR struct file *) * row);
+  tmp = kmm_malloc(sizeof(FAR struct file *) * (row + 1));
   DEBUGASSERT(tmp);
   if (tmp == NULL)
     {
       return -ENFILE;
     }
 
+  *tmp++ = (FAR struct file *)list->fl_files;
+  if (list->fl_rows > 0)
+    {
+      memcpy(tmp, list->fl_files, sizeof(FAR struct file *) * list->fl_rows);
+    }
+
   i = list->fl_rows;
   do
     {
@@ -89,14 +105,16 @@ static int files_extend(FAR struct filelist *list, size_t row)
               kmm_free(tmp[i]);
             }
 
-          kmm_free(tmp);
+          kmm_free(tmp - 1);
           return -ENFILE;
         }
     }
   while (++i < row);
 
-  list->fl_files = tmp;
-  list->fl_rows = row;
+  /* Publish the new rows after the array that holds them */
+
+  __atomic_store_n(&list->fl_files, tmp, __ATOMIC_RELEASE);
+  __atomic_store_n(&list->fl_rows, row, __ATOMIC_RELEASE);
 
   /* Note: If assertion occurs, the fl_rows has a overflow.
    * And there may be file descriptors leak in system.
@@ -165,6 +183,7 @@ void files_initlist(FAR struct filelist *list)
 
 void files_releaselist(FAR struct filelist *list)
 {
+  FAR struct file **files;
   int i;
   int j;
 
@@ -185,7 +204,16 @@ void files_releaselist(FAR struct filelist *list)
       kmm_free(list->fl_files[i]);
     }
 
-  kmm_free(list->fl_files);
+  /* Free the current array of rows and the ones it replaced */
+
+  files = list->fl_files;
+  while (files != NULL)
+    {
+      FAR struct file **prev = (FAR struct file **)*(files - 1);
+
+      kmm_free(files - 1);
+      files = prev;
+    }
 
   /* Destroy the mutex */
 
@@ -253,8 +281,9 @@ int file_allocate_from_tcb(FAR struct tcb_s *tcb, FAR struct inode *inode,
             {
               list->fl_files[i][j].f_oflags = oflags;
               list->fl_files[i][j].f_pos    = pos;
-              list->fl_files[i][j].f_inode  = inode;
               list->fl_files[i][j].f_priv   = priv;
+              __atomic_store_n(&list->fl_files[i][j].f_inode, inode,
+                               __ATOMIC_RELEASE);
               nxmutex_unlock(&list->fl_lock);
 
               if (addref)
@@ -287,8 +316,8 @@ int file_allocate_from_tcb(FAR struct tcb_s *tcb, FAR struct inode *inode,
 
   list->fl_files[i][0].f_oflags = oflags;
   list->fl_files[i][0].f_pos    = pos;
-  list->fl_files[i][0].f_inode  = inode;
   list->fl_files[i][0].f_priv   = priv;
+  __atomic_store_n(&list->fl_files[i][0].f_inode, inode, __ATOMIC_RELEASE);
   nxmutex_unlock(&list->fl_lock);
 
   if (addref)
@@ -402,7 +431,9 @@ out:
  *
  * Description:
  *   Given a file descriptor, return the corresponding instance of struct
- *   file.
+ *   file.  The lookup does not take the list mutex, so concurrent I/O on
+ *   different descriptors does not serialize here.  As before, the caller
+ *   must not race a close() of the same descriptor.
  *
  * Input Parameters:
  *   fd    - The file descriptor
@@ -417,7 +448,9 @@ out:
 int fs_getfilep(int fd, FAR struct file **filep)
 {
   FAR struct filelist *list;
-  int ret;
+  FAR struct file **files;
+  FAR struct file *file;
+  uint8_t rows;
 
 #ifdef CONFIG_FDCHECK
   fd = fdcheck_restore(fd);
@@ -439,36 +472,29 @@ int fs_getfilep(int fd, FAR struct file **filep)
       return -EAGAIN;
     }
 
-  if (fd < 0 || fd >= list->fl_rows * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
-    {
-      return -EBADF;
-    }
-
-  /* The descriptor is in a valid range to file descriptor... Get the
-   * thread-specific file list.
+  /* files_extend() publishes the rows after the array that holds them,
+   * and never frees an array that a reader may still be using.
    */
 
-  /* And return the file pointer from the list */
-
-  ret = nxmutex_lock(&list->fl_lock);
-  if (ret < 0)
+  rows = __atomic_load_n(&list->fl_rows, __ATOMIC_ACQUIRE);
+  if (fd < 0 || fd >= rows * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
     {
-      return ret;
+      return -EBADF;
     }
 
-  *filep = &list->fl_files[fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK]
-                          [fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
+  files = __atomic_load_n(&list->fl_files, __ATOMIC_ACQUIRE);
+  file  = &files[fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK]
+                [fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK];
 
   /* if f_inode is NULL, fd was closed */
 
-  if (!(*filep)->f_inode)
+  if (__atomic_load_n(&file->f_inode, __ATOMIC_ACQUIRE) == NULL)
     {
-      *filep = NULL;
-      ret = -EBADF;
+      return -EBADF;
     }
 
-  nxmutex_unlock(&list->fl_lock);
-  return ret;
+  *filep = file;
+  return OK;
 }
 
 /****************************************************************************
@@ -62,6 +62,19 @@ void inode_free(FAR struct inode *node)
       inode_free(node->i_peer);
       inode_free(node->i_child);
 
+#ifdef CONFIG_FS_INODE_HASH
+      /* The children of an unlinked inode are still hashed below it.  The
+       * inode may be freed without the inode lock, so take it here.
+       */
+
+      while (inode_lock() < 0)
+        {
+        }
+
+      inode_hashdel(node);
+      inode_unlock();
+#endif
+
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
       /* If the inode is a symbolic link, the free the path to the linked
        * entity.
@@ -0,0 +1,169 @@
+/****************************************************************************
+ * fs/inode/fs_inodehash.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODE_HASH
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The inodes of the pseudo file system hashed by (parent, name).  Each
+ * bucket is a singly linked list through i_hash.
+ */
+
+static FAR struct inode *g_inode_hash[CONFIG_FS_INODE_HASH_SIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_hashkey
+ *
+ * Description:
+ *   Return the bucket of a name below 'parent'.  The name ends at the first
+ *   '/' or at the end of the string.
+ *
+ ****************************************************************************/
+
+static FAR struct inode **inode_hashkey(FAR struct inode *parent,
+                                        FAR const char *name)
+{
+  uint32_t key = 2166136261u ^ (uint32_t)((uintptr_t)parent >> 2);
+
+  for (; *name != '\0' && *name != '/'; name++)
+    {
+      key = (key ^ (uint8_t)*name) * 16777619u;
+    }
+
+  return &g_inode_hash[key % CONFIG_FS_INODE_HASH_SIZE];
+}
+
+/****************************************************************************
+ * Name: inode_hashmatch
+ ****************************************************************************/
+
+static bool inode_hashmatch(FAR struct inode *node,
+                            FAR const char *name)
+{
+  FAR const char *nname = node->i_name;
+
+  for (; *nname != '\0'; nname++, name++)
+    {
+      if (*nname != *name)
+        {
+          return false;
+        }
+    }
+
+  return *name == '\0' || *name == '/';
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_hashadd
+ *
+ * Description:
+ *   Enter a node that was just linked below node->i_parent.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock.
+ *
+ ****************************************************************************/
+
+void inode_hashadd(FAR struct inode *node)
+{
+  FAR struct inode **bucket = inode_hashkey(node->i_parent, node->i_name);
+
+  node->i_hash = *bucket;
+  *bucket      = node;
+}
+
+/****************************************************************************
+ * Name: inode_hashdel
+ *
+ * Description:
+ *   Remove a node from the hash table.  This must be done before
+ *   node->i_parent is changed.  Nothing happens if the node is not hashed.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock.
+ *
+ ****************************************************************************/
+
+void inode_hashdel(FAR struct inode *node)
+{
+  FAR struct inode **prev = inode_hashkey(node->i_parent, node->i_name);
+
+  for (; *prev != NULL; prev = &(*prev)->i_hash)
+    {
+      if (*prev == node)
+        {
+          *prev        = node->i_hash;
+          node->i_hash = NULL;
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: inode_hashfind
+ *
+ * Description:
+ *   Return the child of 'parent' called 'name', the name ending at the
+ *   first '/' or at the end of the string, or NULL if there is none.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock.
+ *
+ ****************************************************************************/
+
+FAR struct inode *inode_hashfind(FAR struct inode *parent,
+                                 FAR const char *name)
+{
+  FAR struct inode *node = *inode_hashkey(parent, name);
+
+  for (; node != NULL; node = node->i_hash)
+    {
+      if (node->i_parent == parent && inode_hashmatch(node, name))
+        {
+          break;
+        }
+    }
+
+  return node;
+}
+
+#endif /* CONFIG_FS_INODE_HASH */
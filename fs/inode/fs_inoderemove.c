@@ -77,6 +77,9 @@ FAR struct inode *inode_unlink(FAR const char *path)
       node = desc.node;
       DEBUGASSERT(node != NULL);
 
+      inode_findpeer(&desc);
+      inode_hashdel(node);
+
       /* If peer is non-null, then remove the node from the right of
        * of that peer node.
        */
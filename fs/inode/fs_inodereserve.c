@@ -125,6 +125,8 @@ static void inode_insert(FAR struct inode *node,
       node->i_parent  = parent;
       parent->i_child = node;
     }
+
+  inode_hashadd(node);
 }
 
 /****************************************************************************
@@ -205,6 +207,7 @@ int inode_reserve(FAR const char *path,
 
   /* Now we now where to insert the subtree */
 
+  inode_findpeer(&desc);
   name   = desc.path;
   left   = desc.peer;
   parent = desc.parent;
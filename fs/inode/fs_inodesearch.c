@@ -388,7 +388,11 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
               above = node;
               left  = NULL;
+#ifdef CONFIG_FS_INODE_HASH
+              node  = inode_hashfind(node, name);
+#else
               node  = node->i_child;
+#endif
             }
         }
     }
@@ -444,6 +448,42 @@ static FAR const char *_inode_getcwd(void)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: inode_findpeer
+ *
+ * Description:
+ *   Set desc->peer after a hashed inode_search().  Only the inode tree
+ *   modifications need the peer, so the walk of the peers is left to them.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_HASH
+void inode_findpeer(FAR struct inode_search_s *desc)
+{
+  FAR struct inode *node;
+
+  desc->peer = NULL;
+  if (desc->parent == NULL)
+    {
+      return;
+    }
+
+  for (node = desc->parent->i_child; node != NULL && node != desc->node;
+       node = node->i_peer)
+    {
+      if (desc->node == NULL && _inode_compare(desc->path, node) <= 0)
+        {
+          break;
+        }
+
+      desc->peer = node;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: inode_search
  *
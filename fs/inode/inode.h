@@ -76,7 +76,9 @@
  *  node     - INPUT:  (not used)
  *             OUTPUT: On success, holds the pointer to the inode found.
  *  peer     - INPUT:  (not used)
- *             OUTPUT: The inode to the "left" of the inode found.
+ *             OUTPUT: The inode to the "left" of the inode found.  Only
+ *                     set with CONFIG_FS_INODE_HASH if inode_findpeer()
+ *                     is called.
  *  parent   - INPUT:  (not used)
  *             OUTPUT: The inode to the "above" of the inode found.
  *  relpath  - INPUT:  (not used)
@@ -291,6 +293,45 @@ int inode_getpath(FAR struct inode *node, FAR char *path, size_t len);
 
 void inode_free(FAR struct inode *node);
 
+/****************************************************************************
+ * Name: inode_hashadd, inode_hashdel and inode_hashfind
+ *
+ * Description:
+ *   Maintain and query the hash table of the pseudo file system inodes,
+ *   keyed by parent inode and name.  The caller holds the inode lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_HASH
+void inode_hashadd(FAR struct inode *node);
+void inode_hashdel(FAR struct inode *node);
+FAR struct inode *inode_hashfind(FAR struct inode *parent,
+                                 FAR const char *name);
+#else
+#  define inode_hashadd(n)
+#  define inode_hashdel(n)
+#endif
+
+/****************************************************************************
+ * Name: inode_findpeer
+ *
+ * Description:
+ *   The hashed inode_search() does not walk the peers of the terminal node
+ *   and leaves desc->peer NULL.  Set desc->peer to the inode to the "left"
+ *   of desc->node or, if the search failed, to the "left" of where
+ *   desc->path would be inserted below desc->parent.
+ *
+ * Assumptions:
+ *   The caller holds the inode lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_HASH
+void inode_findpeer(FAR struct inode_search_s *desc);
+#else
+#  define inode_findpeer(d)
+#endif
+
 /****************************************************************************
  * Name: inode_nextname
  *
@@ -26,15 +26,21 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/lib/lib.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
 
 #include <sys/stat.h>
 #include <sys/statfs.h>
+#include <sys/uio.h>
 
 #include "littlefs/lfs.h"
 #include "littlefs/lfs_util.h"
@@ -47,6 +53,15 @@
 #  error littlefs requires CONFIG_C99_BOOL to be selected
 #endif
 
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_LITTLEFS)
+#  define LITTLEFS_HAVE_PROCFS 1
+#endif
+
+/* Mount option flags */
+
+#define LITTLEFS_OPT_FORCEFORMAT  (1 << 0)
+#define LITTLEFS_OPT_AUTOFORMAT   (1 << 1)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -70,12 +85,33 @@ struct littlefs_file_s
 
 struct littlefs_mountpt_s
 {
+  sq_entry_t            node;     /* Link in g_littlefs_mounts */
   mutex_t               lock;
   FAR struct inode     *drv;
   struct mtd_geometry_s geo;
   struct lfs_config     cfg;
   struct lfs            lfs;
+  FAR uint8_t          *buffer;   /* Lookahead, read and program caches */
+
+  /* Device traffic.  Every littlefs cache miss is one call below. */
+
+  uint32_t              nread;    /* Number of read calls */
+  uint32_t              nprog;    /* Number of program calls */
+  uint32_t              nerase;   /* Number of erase calls */
+  uint32_t              nsync;    /* Number of sync calls */
+  uint64_t              rdbytes;  /* Bytes read from the device */
+  uint64_t              prbytes;  /* Bytes programmed to the device */
+};
+
+#ifdef LITTLEFS_HAVE_PROCFS
+/* This structure describes one open fs/littlefs procfs file */
+
+struct littlefs_procfile_s
+{
+  struct procfs_file_s  base;     /* Base open file structure */
+  struct procfs_seq_s   seq;      /* Record cursor */
 };
+#endif
 
 /****************************************************************************
  * Private Function Prototypes
@@ -88,6 +124,10 @@ static ssize_t littlefs_read(FAR struct file *filep, FAR char *buffer,
                              size_t buflen);
 static ssize_t littlefs_write(FAR struct file *filep, FAR const char *buffer,
                               size_t buflen);
+static ssize_t littlefs_readv(FAR struct file *filep,
+                              FAR const struct iovec *iov, int iovcnt);
+static ssize_t littlefs_writev(FAR struct file *filep,
+                               FAR const struct iovec *iov, int iovcnt);
 static off_t   littlefs_seek(FAR struct file *filep, off_t offset,
                              int whence);
 static int     littlefs_ioctl(FAR struct file *filep, int cmd,
@@ -131,6 +171,28 @@ static int     littlefs_rename(FAR struct inode *mountpt,
 static int     littlefs_stat(FAR struct inode *mountpt,
                              FAR const char *relpath, FAR struct stat *buf);
 
+#ifdef LITTLEFS_HAVE_PROCFS
+static int     littlefs_procfs_open(FAR struct file *filep,
+                                    FAR const char *relpath,
+                                    int oflags, mode_t mode);
+static int     littlefs_procfs_close(FAR struct file *filep);
+static ssize_t littlefs_procfs_read(FAR struct file *filep,
+                                    FAR char *buffer, size_t buflen);
+static int     littlefs_procfs_dup(FAR const struct file *oldp,
+                                   FAR struct file *newp);
+static int     littlefs_procfs_stat(FAR const char *relpath,
+                                    FAR struct stat *buf);
+
+static FAR void *littlefs_procfs_start(FAR struct procfs_seq_s *seq,
+                                       off_t index);
+static FAR void *littlefs_procfs_next(FAR struct procfs_seq_s *seq,
+                                      FAR void *elem, off_t index);
+static void    littlefs_procfs_stop(FAR struct procfs_seq_s *seq,
+                                    FAR void *elem);
+static int     littlefs_procfs_show(FAR struct procfs_seq_s *seq,
+                                    FAR void *elem);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -170,8 +232,49 @@ const struct mountpt_operations g_littlefs_operations =
   littlefs_rmdir,         /* rmdir */
   littlefs_rename,        /* rename */
   littlefs_stat,          /* stat */
-  NULL                    /* chstat */
+  NULL,                   /* chstat */
+  littlefs_readv,         /* readv */
+  littlefs_writev         /* writev */
+};
+
+#ifdef LITTLEFS_HAVE_PROCFS
+/* See fs_procfs.c -- this is the handler of /proc/fs/littlefs */
+
+const struct procfs_operations g_littlefs_procfs_operations =
+{
+  littlefs_procfs_open,   /* open */
+  littlefs_procfs_close,  /* close */
+  littlefs_procfs_read,   /* read */
+  NULL,                   /* write */
+  littlefs_procfs_dup,    /* dup */
+  NULL,                   /* opendir */
+  NULL,                   /* closedir */
+  NULL,                   /* readdir */
+  NULL,                   /* rewinddir */
+  littlefs_procfs_stat    /* stat */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef LITTLEFS_HAVE_PROCFS
+/* All mounted littlefs instances, for /proc/fs/littlefs */
+
+static sq_queue_t g_littlefs_mounts;
+static mutex_t    g_littlefs_lock = NXMUTEX_INITIALIZER;
+
+/* Record 0 is the headers, record n is the n-th mounted volume */
+
+static const struct procfs_seq_operations_s g_littlefs_seqops =
+{
+  littlefs_procfs_start,  /* start */
+  littlefs_procfs_next,   /* next */
+  littlefs_procfs_stop,   /* stop */
+  littlefs_procfs_show    /* show */
 };
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -402,16 +505,24 @@ static int littlefs_close(FAR struct file *filep)
 }
 
 /****************************************************************************
- * Name: littlefs_read
+ * Name: littlefs_transfer
+ *
+ * Description:
+ *   Read or write all of the buffers of a vector under one hold of the
+ *   mount lock.  The transfer ends at the first short transfer.
+ *
  ****************************************************************************/
 
-static ssize_t littlefs_read(FAR struct file *filep, FAR char *buffer,
-                             size_t buflen)
+static ssize_t littlefs_transfer(FAR struct file *filep,
+                                 FAR const struct iovec *iov, int iovcnt,
+                                 bool write)
 {
   FAR struct littlefs_mountpt_s *fs;
   FAR struct littlefs_file_s *priv;
   FAR struct inode *inode;
+  ssize_t ntotal = 0;
   ssize_t ret;
+  int i;
 
   /* Recover our private data from the struct file instance */
 
@@ -419,7 +530,7 @@ static ssize_t littlefs_read(FAR struct file *filep, FAR char *buffer,
   inode = filep->f_inode;
   fs    = inode->i_private;
 
-  /* Call LFS to perform the read */
+  /* Call LFS to perform the transfer */
 
   ret = nxmutex_lock(&fs->lock);
   if (ret < 0)
@@ -438,11 +549,36 @@ static ssize_t littlefs_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
-  ret = littlefs_convert_result(lfs_file_read(&fs->lfs, &priv->file,
-                                              buffer, buflen));
-  if (ret > 0)
+  for (i = 0; i < iovcnt; i++)
     {
+      if (write)
+        {
+          ret = lfs_file_write(&fs->lfs, &priv->file,
+                               iov[i].iov_base, iov[i].iov_len);
+        }
+      else
+        {
+          ret = lfs_file_read(&fs->lfs, &priv->file,
+                              iov[i].iov_base, iov[i].iov_len);
+        }
+
+      ret = littlefs_convert_result(ret);
+      if (ret < 0)
+        {
+          break;
+        }
+
       filep->f_pos += ret;
+      ntotal       += ret;
+      if ((size_t)ret < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  if (ntotal > 0 || ret >= 0)
+    {
+      ret = ntotal;
     }
 
 out:
@@ -450,6 +586,20 @@ out:
   return ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_read
+ ****************************************************************************/
+
+static ssize_t littlefs_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  struct iovec iov;
+
+  iov.iov_base = buffer;
+  iov.iov_len  = buflen;
+  return littlefs_transfer(filep, &iov, 1, false);
+}
+
 /****************************************************************************
  * Name: littlefs_write
  ****************************************************************************/
@@ -457,46 +607,31 @@ out:
 static ssize_t littlefs_write(FAR struct file *filep, const char *buffer,
                               size_t buflen)
 {
-  FAR struct littlefs_mountpt_s *fs;
-  FAR struct littlefs_file_s *priv;
-  FAR struct inode *inode;
-  ssize_t ret;
-
-  /* Recover our private data from the struct file instance */
+  struct iovec iov;
 
-  priv  = filep->f_priv;
-  inode = filep->f_inode;
-  fs    = inode->i_private;
-
-  /* Call LFS to perform the write */
+  iov.iov_base = (FAR char *)buffer;
+  iov.iov_len  = buflen;
+  return littlefs_transfer(filep, &iov, 1, true);
+}
 
-  ret = nxmutex_lock(&fs->lock);
-  if (ret < 0)
-    {
-      return ret;
-    }
+/****************************************************************************
+ * Name: littlefs_readv
+ ****************************************************************************/
 
-  if (filep->f_pos != priv->file.pos)
-    {
-      ret = littlefs_convert_result(lfs_file_seek(&fs->lfs, &priv->file,
-                                                  filep->f_pos,
-                                                  LFS_SEEK_SET));
-      if (ret < 0)
-        {
-          goto out;
-        }
-    }
+static ssize_t littlefs_readv(FAR struct file *filep,
+                              FAR const struct iovec *iov, int iovcnt)
+{
+  return littlefs_transfer(filep, iov, iovcnt, false);
+}
 
-  ret = littlefs_convert_result(lfs_file_write(&fs->lfs, &priv->file,
-                                               buffer, buflen));
-  if (ret > 0)
-    {
-      filep->f_pos += ret;
-    }
+/****************************************************************************
+ * Name: littlefs_writev
+ ****************************************************************************/
 
-out:
-  nxmutex_unlock(&fs->lock);
-  return ret;
+static ssize_t littlefs_writev(FAR struct file *filep,
+                               FAR const struct iovec *iov, int iovcnt)
+{
+  return littlefs_transfer(filep, iov, iovcnt, true);
 }
 
 /****************************************************************************
@@ -911,6 +1046,9 @@ static int littlefs_read_block(FAR const struct lfs_config *c,
   FAR struct inode *drv = fs->drv;
   int ret;
 
+  fs->nread++;
+  fs->rdbytes += size;
+
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
@@ -939,6 +1077,9 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
   FAR struct inode *drv = fs->drv;
   int ret;
 
+  fs->nprog++;
+  fs->prbytes += size;
+
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
@@ -965,6 +1106,8 @@ static int littlefs_erase_block(FAR const struct lfs_config *c,
   FAR struct inode *drv = fs->drv;
   int ret = OK;
 
+  fs->nerase++;
+
   if (INODE_IS_MTD(drv))
     {
       FAR struct mtd_geometry_s *geo = &fs->geo;
@@ -987,6 +1130,8 @@ static int littlefs_sync_block(FAR const struct lfs_config *c)
   FAR struct inode *drv = fs->drv;
   int ret;
 
+  fs->nsync++;
+
   if (INODE_IS_MTD(drv))
     {
       ret = MTD_IOCTL(drv->u.i_mtd, BIOC_FLUSH, 0);
@@ -1006,6 +1151,155 @@ static int littlefs_sync_block(FAR const struct lfs_config *c)
   return ret == -ENOTTY ? OK : ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_parse_options
+ *
+ * Description:
+ *   Parse the comma separated mount options.  The lfs_config sizes are
+ *   preset from the Kconfig defaults and are overridden here.  The options
+ *   we support are:
+ *
+ *     forceformat        Format the volume before mounting it
+ *     autoformat         Format the volume if it cannot be mounted
+ *     read_size=n        Minimum size of a block read in bytes
+ *     prog_size=n        Minimum size of a block program in bytes
+ *     cache_size=n       Size of each block cache in bytes
+ *     lookahead_size=n   Size of the block allocator bitmap in bytes
+ *     block_cycles=n     Erase cycles before a metadata log is moved
+ *     metadata_max=n     Bytes of a block metadata logs may use
+ *
+ ****************************************************************************/
+
+static int littlefs_parse_options(FAR struct littlefs_mountpt_s *fs,
+                                  FAR const char *data, FAR int *flags)
+{
+  FAR char *options;
+  FAR char *saveptr;
+  FAR char *ptr;
+  FAR char *end;
+  FAR char *val;
+  long value;
+  int ret = OK;
+
+  *flags = 0;
+  if (data == NULL)
+    {
+      return OK;
+    }
+
+  options = strdup(data);
+  if (options == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ptr = strtok_r(options, ",", &saveptr);
+  while (ptr != NULL && ret == OK)
+    {
+      if (strcmp(ptr, "forceformat") == 0)
+        {
+          *flags |= LITTLEFS_OPT_FORCEFORMAT;
+        }
+      else if (strcmp(ptr, "autoformat") == 0)
+        {
+          *flags |= LITTLEFS_OPT_AUTOFORMAT;
+        }
+      else if ((val = strchr(ptr, '=')) == NULL)
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          *val++ = '\0';
+          value  = strtol(val, &end, 0);
+          if (end == val || *end != '\0')
+            {
+              ret = -EINVAL;
+            }
+          else if (strcmp(ptr, "block_cycles") == 0)
+            {
+              fs->cfg.block_cycles = value;
+            }
+          else if (value < 0)
+            {
+              ret = -EINVAL;
+            }
+          else if (strcmp(ptr, "read_size") == 0)
+            {
+              fs->cfg.read_size = value;
+            }
+          else if (strcmp(ptr, "prog_size") == 0)
+            {
+              fs->cfg.prog_size = value;
+            }
+          else if (strcmp(ptr, "cache_size") == 0)
+            {
+              fs->cfg.cache_size = value;
+            }
+          else if (strcmp(ptr, "lookahead_size") == 0)
+            {
+              fs->cfg.lookahead_size = value;
+            }
+          else if (strcmp(ptr, "metadata_max") == 0)
+            {
+              fs->cfg.metadata_max = value;
+            }
+          else
+            {
+              ret = -EINVAL;
+            }
+        }
+
+      ptr = strtok_r(NULL, ",", &saveptr);
+    }
+
+  lib_free(options);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: littlefs_check_config
+ *
+ * Description:
+ *   Check the sizes against the device geometry and the rules littlefs
+ *   documents for lfs_config, and allocate the caches.  The lookahead
+ *   bitmap, the read cache and the program cache share one allocation.
+ *
+ ****************************************************************************/
+
+static int littlefs_check_config(FAR struct littlefs_mountpt_s *fs)
+{
+  FAR struct lfs_config *cfg = &fs->cfg;
+
+  if (cfg->read_size == 0 || cfg->prog_size == 0 ||
+      cfg->read_size % fs->geo.blocksize != 0 ||
+      cfg->prog_size % fs->geo.blocksize != 0 ||
+      cfg->cache_size % cfg->read_size != 0 ||
+      cfg->cache_size % cfg->prog_size != 0 ||
+      cfg->cache_size == 0 || cfg->block_size % cfg->cache_size != 0 ||
+      cfg->lookahead_size == 0 || cfg->lookahead_size % 8 != 0 ||
+      cfg->metadata_max > cfg->block_size ||
+      cfg->block_cycles == 0)
+    {
+      ferr("ERROR: Bad littlefs geometry\n");
+      return -EINVAL;
+    }
+
+  fs->buffer = kmm_malloc(cfg->lookahead_size + 2 * cfg->cache_size);
+  if (fs->buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* The lookahead bitmap must be 32-bit aligned, so it goes first */
+
+  cfg->lookahead_buffer = fs->buffer;
+  cfg->read_buffer      = fs->buffer + cfg->lookahead_size;
+  cfg->prog_buffer      = fs->buffer + cfg->lookahead_size +
+                          cfg->cache_size;
+  return OK;
+}
+
 /****************************************************************************
  * Name: littlefs_bind
  ****************************************************************************/
@@ -1014,6 +1308,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
                          FAR void **handle)
 {
   FAR struct littlefs_mountpt_s *fs;
+  int flags;
   int ret;
 
   /* Open the block driver */
@@ -1107,6 +1402,8 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.cache_size     = fs->geo.blocksize *
                            CONFIG_FS_LITTLEFS_CACHE_SIZE_FACTOR;
 
+  fs->cfg.metadata_max   = CONFIG_FS_LITTLEFS_METADATA_MAX;
+
 #if CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE == 0
   fs->cfg.lookahead_size = lfs_min(lfs_alignup(fs->cfg.block_count, 64) / 8,
                                    fs->cfg.read_size);
@@ -1114,13 +1411,27 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.lookahead_size = CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE;
 #endif
 
+  /* Apply the per-mount tuning given with -o */
+
+  ret = littlefs_parse_options(fs, data, &flags);
+  if (ret < 0)
+    {
+      goto errout_with_fs;
+    }
+
+  ret = littlefs_check_config(fs);
+  if (ret < 0)
+    {
+      goto errout_with_fs;
+    }
+
   /* Then get information about the littlefs filesystem on the devices
    * managed by this driver.
    */
 
   /* Force format the device if -o forceformat */
 
-  if (data && strcmp(data, "forceformat") == 0)
+  if (flags & LITTLEFS_OPT_FORCEFORMAT)
     {
       ret = littlefs_convert_result(lfs_format(&fs->lfs, &fs->cfg));
       if (ret < 0)
@@ -1134,7 +1445,7 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
     {
       /* Auto format the device if -o autoformat */
 
-      if (ret != -EFAULT || !data || strcmp(data, "autoformat"))
+      if (ret != -EFAULT || (flags & LITTLEFS_OPT_AUTOFORMAT) == 0)
         {
           goto errout_with_fs;
         }
@@ -1154,11 +1465,18 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
         }
     }
 
+#ifdef LITTLEFS_HAVE_PROCFS
+  nxmutex_lock(&g_littlefs_lock);
+  sq_addlast(&fs->node, &g_littlefs_mounts);
+  nxmutex_unlock(&g_littlefs_lock);
+#endif
+
   *handle = fs;
   return OK;
 
 errout_with_fs:
   nxmutex_destroy(&fs->lock);
+  kmm_free(fs->buffer);
   kmm_free(fs);
 errout_with_block:
   if (INODE_IS_BLOCK(driver) && driver->u.i_bops->close)
@@ -1215,9 +1533,16 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
           *driver = drv;
         }
 
+#ifdef LITTLEFS_HAVE_PROCFS
+      nxmutex_lock(&g_littlefs_lock);
+      sq_rem(&fs->node, &g_littlefs_mounts);
+      nxmutex_unlock(&g_littlefs_lock);
+#endif
+
       /* Release the mountpoint private data */
 
       nxmutex_destroy(&fs->lock);
+      kmm_free(fs->buffer);
       kmm_free(fs);
     }
 
@@ -1445,3 +1770,189 @@ static int littlefs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   return ret;
 }
+
+#ifdef LITTLEFS_HAVE_PROCFS
+
+/****************************************************************************
+ * Name: littlefs_procfs_open
+ ****************************************************************************/
+
+static int littlefs_procfs_open(FAR struct file *filep,
+                                FAR const char *relpath,
+                                int oflags, mode_t mode)
+{
+  FAR struct littlefs_procfile_s *procfile;
+
+  /* This is a read-only file */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      return -EACCES;
+    }
+
+  procfile = kmm_zalloc(sizeof(struct littlefs_procfile_s));
+  if (procfile == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  procfs_seq_open(&procfile->seq, &g_littlefs_seqops, NULL);
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_close
+ ****************************************************************************/
+
+static int littlefs_procfs_close(FAR struct file *filep)
+{
+  FAR struct littlefs_procfile_s *procfile = filep->f_priv;
+
+  procfs_seq_close(&procfile->seq);
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_read
+ ****************************************************************************/
+
+static ssize_t littlefs_procfs_read(FAR struct file *filep,
+                                    FAR char *buffer, size_t buflen)
+{
+  FAR struct littlefs_procfile_s *procfile = filep->f_priv;
+
+  return procfs_seq_read(&procfile->seq, filep, buffer, buflen);
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_dup
+ ****************************************************************************/
+
+static int littlefs_procfs_dup(FAR const struct file *oldp,
+                               FAR struct file *newp)
+{
+  FAR struct littlefs_procfile_s *oldattr = oldp->f_priv;
+  FAR struct littlefs_procfile_s *newattr;
+
+  newattr = kmm_malloc(sizeof(struct littlefs_procfile_s));
+  if (newattr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldattr, sizeof(struct littlefs_procfile_s));
+  if (procfs_seq_dup(&newattr->seq, &oldattr->seq) < 0)
+    {
+      kmm_free(newattr);
+      return -ENOMEM;
+    }
+
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_stat
+ ****************************************************************************/
+
+static int littlefs_procfs_stat(FAR const char *relpath,
+                                FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_start
+ *
+ * Description:
+ *   Lock the list of mounts and return the record at 'index'.  The lock is
+ *   held until littlefs_procfs_stop() so that no volume is unmounted while
+ *   it is being shown.
+ *
+ ****************************************************************************/
+
+static FAR void *littlefs_procfs_start(FAR struct procfs_seq_s *seq,
+                                       off_t index)
+{
+  FAR sq_entry_t *node;
+
+  nxmutex_lock(&g_littlefs_lock);
+
+  /* The sequence state itself stands for the headers */
+
+  if (index == 0)
+    {
+      return seq;
+    }
+
+  node = sq_peek(&g_littlefs_mounts);
+  while (node != NULL && --index > 0)
+    {
+      node = sq_next(node);
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_next
+ ****************************************************************************/
+
+static FAR void *littlefs_procfs_next(FAR struct procfs_seq_s *seq,
+                                      FAR void *elem, off_t index)
+{
+  return elem == seq ? sq_peek(&g_littlefs_mounts) :
+                       sq_next((FAR sq_entry_t *)elem);
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_stop
+ ****************************************************************************/
+
+static void littlefs_procfs_stop(FAR struct procfs_seq_s *seq,
+                                 FAR void *elem)
+{
+  nxmutex_unlock(&g_littlefs_lock);
+}
+
+/****************************************************************************
+ * Name: littlefs_procfs_show
+ ****************************************************************************/
+
+static int littlefs_procfs_show(FAR struct procfs_seq_s *seq,
+                                FAR void *elem)
+{
+  FAR struct littlefs_mountpt_s *fs;
+
+  if (elem == seq)
+    {
+      procfs_seq_printf(seq, "%-12s%7s%7s%7s%7s%7s%7s%9s%11s%9s%11s%7s"
+                        "%7s\n", "device", "block", "read", "prog",
+                        "cache", "lahead", "cycles", "nread", "rdbytes",
+                        "nprog", "prbytes", "nerase", "nsync");
+      return OK;
+    }
+
+  fs = container_of(elem, struct littlefs_mountpt_s, node);
+  procfs_seq_printf(seq, "%-12s%7lu%7lu%7lu%7lu%7lu%7ld%9lu%11llu%9lu"
+                    "%11llu%7lu%7lu\n", fs->drv->i_name,
+                    (unsigned long)fs->cfg.block_size,
+                    (unsigned long)fs->cfg.read_size,
+                    (unsigned long)fs->cfg.prog_size,
+                    (unsigned long)fs->cfg.cache_size,
+                    (unsigned long)fs->cfg.lookahead_size,
+                    (long)fs->cfg.block_cycles,
+                    (unsigned long)fs->nread,
+                    (unsigned long long)fs->rdbytes,
+                    (unsigned long)fs->nprog,
+                    (unsigned long long)fs->prbytes,
+                    (unsigned long)fs->nerase,
+                    (unsigned long)fs->nsync);
+  return OK;
+}
+#endif /* LITTLEFS_HAVE_PROCFS */
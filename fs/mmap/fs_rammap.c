@@ -23,6 +23,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 
 #include <assert.h>
@@ -33,20 +34,164 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
 #include <nuttx/sched.h>
 
+#include "inode/inode.h"
 #include "fs_rammap.h"
 
 #ifdef CONFIG_FS_RAMMAP
 
 /****************************************************************************
- * Public Data
+ * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FS_RAMMAP_SHARED
+/* One in-memory copy of a file region, shared by all of its mappings */
+
+struct rammap_copy_s
+{
+  dq_entry_t node;             /* Link in g_rammap_copies */
+  FAR struct inode *inode;     /* The mapped file, one reference held */
+  off_t offset;                /* File offset of the copy */
+  size_t length;               /* Length of the copy */
+  FAR uint8_t *buffer;         /* The copy itself */
+  bool kernel;                 /* Buffer allocated from the kernel heap */
+  int crefs;                   /* Number of mappings of the copy */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RAMMAP_SHARED
+static dq_queue_t g_rammap_copies;
+static mutex_t g_rammap_lock = NXMUTEX_INITIALIZER;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: rammap_free
+ ****************************************************************************/
+
+static void rammap_free(FAR void *buffer, bool kernel)
+{
+  if (kernel)
+    {
+      kmm_free(buffer);
+    }
+  else
+    {
+      kumm_free(buffer);
+    }
+}
+
+#ifdef CONFIG_FS_RAMMAP_SHARED
+/****************************************************************************
+ * Name: rammap_shareable
+ *
+ * Description:
+ *   Only mappings that can never diverge from each other may share one
+ *   copy: shared ones, whose writes must be seen by all the mappers, and
+ *   private ones that cannot be written.
+ *
+ ****************************************************************************/
+
+static bool rammap_shareable(FAR struct mm_map_entry_s *entry)
+{
+  return (entry->flags & MAP_SHARED) != 0 ||
+         (entry->prot & PROT_WRITE) == 0;
+}
+
+/****************************************************************************
+ * Name: rammap_find
+ *
+ * Description:
+ *   Find a copy that covers the region of a new mapping and take a
+ *   reference to it.
+ *
+ * Assumptions:
+ *   g_rammap_lock is held.
+ *
+ ****************************************************************************/
+
+static FAR struct rammap_copy_s *
+rammap_find(FAR struct inode *inode, FAR struct mm_map_entry_s *entry,
+            bool kernel)
+{
+  FAR struct rammap_copy_s *copy;
+  FAR dq_entry_t *node;
+
+  for (node = dq_peek(&g_rammap_copies); node != NULL; node = dq_next(node))
+    {
+      copy = container_of(node, struct rammap_copy_s, node);
+      if (copy->inode == inode && copy->kernel == kernel &&
+          copy->offset <= entry->offset &&
+          entry->offset + entry->length <= copy->offset + copy->length)
+        {
+          copy->crefs++;
+          return copy;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: unmap_rammap_shared
+ ****************************************************************************/
+
+static int unmap_rammap_shared(FAR struct task_group_s *group,
+                               FAR struct mm_map_entry_s *entry,
+                               FAR void *start,
+                               size_t length)
+{
+  FAR struct rammap_copy_s *copy = entry->priv.p;
+  off_t offset;
+  int ret;
+
+  /* As with the private copies, the mapping can only be cut at its end.
+   * The shared buffer is left untouched until the last mapping is gone.
+   */
+
+  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+  if (offset + length < entry->length)
+    {
+      ferr("ERROR: Cannot umap without unmapping to the end\n");
+      return -ENOSYS;
+    }
+
+  if (offset > 0)
+    {
+      entry->length = offset;
+      return OK;
+    }
+
+  ret = mm_map_remove(get_group_mm(group), entry);
+
+  nxmutex_lock(&g_rammap_lock);
+  if (--copy->crefs > 0)
+    {
+      nxmutex_unlock(&g_rammap_lock);
+      return ret;
+    }
+
+  dq_rem(&copy->node, &g_rammap_copies);
+  nxmutex_unlock(&g_rammap_lock);
+
+  rammap_free(copy->buffer, copy->kernel);
+  inode_release(copy->inode);
+  kmm_free(copy);
+  return ret;
+}
+#endif
+
 static int unmap_rammap(FAR struct task_group_s *group,
                         FAR struct mm_map_entry_s *entry,
                         FAR void *start,
@@ -83,14 +228,7 @@ static int unmap_rammap(FAR struct task_group_s *group,
     {
       /* Free the region */
 
-      if (kernel)
-        {
-          kmm_free(entry->vaddr);
-        }
-      else
-        {
-          kumm_free(entry->vaddr);
-        }
+      rammap_free(entry->vaddr, kernel);
 
       /* Then remove the mapping from the list */
 
@@ -149,51 +287,32 @@ static int unmap_rammap(FAR struct task_group_s *group,
  *
  ****************************************************************************/
 
-int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
-           bool kernel)
+/****************************************************************************
+ * Name: rammap_fill
+ *
+ * Description:
+ *   Read a file region into memory, zeroing whatever lies beyond the end
+ *   of the file.
+ *
+ ****************************************************************************/
+
+static int rammap_fill(FAR struct file *filep, FAR uint8_t *rdbuffer,
+                       off_t offset, size_t length)
 {
-  FAR uint8_t *rdbuffer;
   ssize_t nread;
   off_t fpos;
-  int ret;
-  size_t length = entry->length;
-
-  /* There is a major design flaw that I have not yet thought of fix for:
-   * The goal is to have a single region of memory that represents a single
-   * file and can be shared by many threads.  That is, given a filename a
-   * thread should be able to open the file, get a file descriptor, and
-   * call mmap() to get a memory region.  Different file descriptors opened
-   * with the same file path should get the same memory region when mapped.
-   *
-   * The design flaw is that I don't have sufficient knowledge to know that
-   * these different file descriptors map to the same file.  So, for the time
-   * being, a new memory region is created each time that rammap() is called.
-   * Not very useful!
-   */
-
-  /* Allocate a region of memory of the specified size */
-
-  rdbuffer = kernel ? kmm_malloc(length) : kumm_malloc(length);
-  if (!rdbuffer)
-    {
-      ferr("ERROR: Region allocation failed, length: %zu\n", length);
-      return -ENOMEM;
-    }
-
-  entry->vaddr = rdbuffer; /* save the buffer firstly */
 
   /* Seek to the specified file offset */
 
-  fpos = file_seek(filep, entry->offset, SEEK_SET);
+  fpos = file_seek(filep, offset, SEEK_SET);
   if (fpos < 0)
     {
       /* Seek failed... errno has already been set, but EINVAL is probably
        * the correct response.
        */
 
-      ferr("ERROR: Seek to position %zu failed\n", (size_t)entry->offset);
-      ret = fpos;
-      goto errout_with_region;
+      ferr("ERROR: Seek to position %zu failed\n", (size_t)offset);
+      return fpos;
     }
 
   /* Read the file data into the memory region */
@@ -212,10 +331,8 @@ int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
               /* All other read errors are bad. */
 
               ferr("ERROR: Read failed: offset=%zu ret=%zd\n",
-                   (size_t)entry->offset, nread);
-
-              ret = nread;
-              goto errout_with_region;
+                   (size_t)offset, nread);
+              return nread;
             }
         }
 
@@ -235,29 +352,151 @@ int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
   /* Zero any memory beyond the amount read from the file */
 
   memset(rdbuffer, 0, length);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rammmap
+ *
+ * Description:
+ *   Support simulation of memory mapped files by copying files into RAM.
+ *   With CONFIG_FS_RAMMAP_SHARED, the mappings of the same file region that
+ *   cannot diverge share one copy.
+ *
+ * Input Parameters:
+ *   filep   file descriptor of the backing file -- required.
+ *   entry   mmap entry information.
+ *           field offset and length must be initialized correctly.
+ *   kernel  kmm_zalloc or kumm_zalloc
+ *
+ * Returned Value:
+ *  On success, rammap returns 0 and entry->vaddr points to memory mapped.
+ *     Otherwise errno is returned appropriately.
+ *
+ *     EBADF
+ *      'fd' is not a valid file descriptor.
+ *     EINVAL
+ *       'length' or 'offset' are invalid
+ *     ENOMEM
+ *       Insufficient memory is available to map the file.
+ *
+ ****************************************************************************/
+
+int rammap(FAR struct file *filep, FAR struct mm_map_entry_s *entry,
+           bool kernel)
+{
+#ifdef CONFIG_FS_RAMMAP_SHARED
+  FAR struct rammap_copy_s *copy = NULL;
+#endif
+  FAR uint8_t *rdbuffer;
+  int ret;
+
+#ifdef CONFIG_FS_RAMMAP_SHARED
+  /* Map an existing copy if there is one.  The lock is kept while a new
+   * copy is read so that concurrent mappers of the same file wait for it
+   * instead of reading another one.
+   */
+
+  if (rammap_shareable(entry))
+    {
+      ret = nxmutex_lock(&g_rammap_lock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      copy = rammap_find(filep->f_inode, entry, kernel);
+      if (copy != NULL)
+        {
+          nxmutex_unlock(&g_rammap_lock);
+
+          entry->vaddr  = copy->buffer + (entry->offset - copy->offset);
+          entry->priv.p = copy;
+          entry->munmap = unmap_rammap_shared;
+          goto add_entry;
+        }
+
+      copy = kmm_zalloc(sizeof(struct rammap_copy_s));
+      if (copy == NULL)
+        {
+          nxmutex_unlock(&g_rammap_lock);
+          return -ENOMEM;
+        }
+    }
+#endif
+
+  /* Allocate a region of memory of the specified size */
+
+  rdbuffer = kernel ? kmm_malloc(entry->length) : kumm_malloc(entry->length);
+  if (!rdbuffer)
+    {
+      ferr("ERROR: Region allocation failed, length: %zu\n", entry->length);
+      ret = -ENOMEM;
+      goto errout_with_copy;
+    }
+
+  entry->vaddr = rdbuffer; /* save the buffer firstly */
+
+  ret = rammap_fill(filep, rdbuffer, entry->offset, entry->length);
+  if (ret < 0)
+    {
+      goto errout_with_region;
+    }
+
+#ifdef CONFIG_FS_RAMMAP_SHARED
+  if (copy != NULL)
+    {
+      inode_addref(filep->f_inode);
+
+      copy->inode  = filep->f_inode;
+      copy->offset = entry->offset;
+      copy->length = entry->length;
+      copy->buffer = rdbuffer;
+      copy->kernel = kernel;
+      copy->crefs  = 1;
+      dq_addlast(&copy->node, &g_rammap_copies);
+      nxmutex_unlock(&g_rammap_lock);
+
+      entry->priv.p = copy;
+      entry->munmap = unmap_rammap_shared;
+      goto add_entry;
+    }
+#endif
 
   /* Add the buffer to the list of regions */
 
   entry->priv.i = kernel;
   entry->munmap = unmap_rammap;
 
+#ifdef CONFIG_FS_RAMMAP_SHARED
+add_entry:
+#endif
   ret = mm_map_add(get_current_mm(), entry);
   if (ret < 0)
     {
-      goto errout_with_region;
+      /* Undo the mapping as munmap() would */
+
+      entry->munmap(NULL, entry, entry->vaddr, entry->length);
+      return ret;
     }
 
   return OK;
 
 errout_with_region:
-  if (kernel)
-    {
-      kmm_free(entry->vaddr);
-    }
-  else
+  rammap_free(rdbuffer, kernel);
+
+errout_with_copy:
+#ifdef CONFIG_FS_RAMMAP_SHARED
+  if (copy != NULL)
     {
-      kumm_free(entry->vaddr);
+      nxmutex_unlock(&g_rammap_lock);
+      kmm_free(copy);
     }
+#endif
 
   return ret;
 }
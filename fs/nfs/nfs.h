@@ -125,6 +125,11 @@ EXTERN int nfs_finddir(FAR struct nfsmount *nmp, FAR const char *relpath,
               FAR struct nfs_fattr *attributes, FAR char *filename);
 EXTERN void nfs_attrupdate(FAR struct nfsnode *np,
               FAR struct nfs_fattr *attributes);
+#ifdef CONFIG_NFS_ATTRCACHE
+EXTERN void nfs_attrcache_invalidate(FAR struct nfsmount *nmp);
+#else
+#  define nfs_attrcache_invalidate(nmp)
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
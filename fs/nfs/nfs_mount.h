@@ -49,6 +49,8 @@
  ****************************************************************************/
 
 #include <sys/socket.h>
+#include <stdbool.h>
+#include <nuttx/clock.h>
 #include <nuttx/mutex.h>
 
 #include "rpc.h"
@@ -57,10 +59,29 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Size of the data cache of an open file */
+
+#define NFS_CACHESIZE(nmp) ((nmp)->nm_rsize > (nmp)->nm_wsize ? \
+                            (nmp)->nm_rsize : (nmp)->nm_wsize)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* One entry of the lookup cache: the file handle and attributes that were
+ * found for a path.  An entry with an empty path is unused.
+ */
+
+#ifdef CONFIG_NFS_ATTRCACHE
+struct nfs_attrcache_s
+{
+  clock_t                   ac_time;          /* Time of the lookup */
+  struct file_handle        ac_fhandle;       /* File handle of the object */
+  struct nfs_fattr          ac_attributes;    /* Object attributes */
+  char                      ac_path[CONFIG_NFS_ATTRCACHE_PATHLEN];
+};
+#endif
+
 /* Mount structure. One mount structure is allocated for each NFS mount. This
  * structure holds NFS specific information for mount.
  */
@@ -79,6 +100,11 @@ struct nfsmount
   uint16_t                  nm_wsize;         /* Max size of write RPC */
   uint16_t                  nm_readdirsize;   /* Size of a readdir RPC */
   uint16_t                  nm_buflen;        /* Size of I/O buffer */
+  bool                      nm_noreaddirplus; /* Server lacks READDIRPLUS */
+#ifdef CONFIG_NFS_ATTRCACHE
+  uint8_t                   nm_attrnext;      /* Next lookup cache entry to replace */
+  struct nfs_attrcache_s    nm_attrcache[CONFIG_NFS_ATTRCACHE_NENTRIES];
+#endif
 
   /* Set aside memory on the stack to hold the largest call message.
    * NOTE that for the case of the write call message, it is the reply
@@ -95,6 +121,7 @@ struct nfsmount
     struct rpc_call_mkdir   mkdir;
     struct rpc_call_rmdir   rmdir;
     struct rpc_call_readdir readdir;
+    struct rpc_call_readdirplus readdirplus;
     struct rpc_call_fs      fsstat;
     struct rpc_call_setattr setattr;
     struct rpc_call_fs      fsinfo;
@@ -48,6 +48,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
+
 #include "nfs_proto.h"
 
 /****************************************************************************
@@ -70,6 +72,12 @@ struct nfsnode
   struct timespec     n_ctime;      /* File creation time */
   nfsfh_t             n_fhandle;    /* NFS File Handle */
   uint64_t            n_size;       /* Current size of file */
+#ifdef CONFIG_NFS_DATA_CACHE
+  FAR uint8_t        *n_buffer;     /* Cached file data (NFS_CACHESIZE) */
+  uint64_t            n_bufpos;     /* File offset of the cached data */
+  uint32_t            n_buflen;     /* Number of valid bytes in n_buffer */
+  bool                n_bufdirty;   /* Cached data not written to server */
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
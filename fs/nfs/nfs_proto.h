@@ -550,6 +550,28 @@ struct READDIR3resok
    (sizeof(uint32_t) + sizeof(struct nfs_fattr) + \
     NFSX_V3COOKIEVERF + sizeof(uint32_t) + (n))
 
+struct READDIRPLUS3args
+{
+  struct file_handle dir;                           /* Variable length */
+  nfsuint64          cookie;
+  uint8_t            cookieverf[NFSX_V3COOKIEVERF];
+  uint32_t           dircount;
+  uint32_t           maxcount;
+};
+
+/* The READDIRPLUS reply has the same header as the READDIR reply.  Each
+ * entry is followed by the post-operation attributes and file handle of the
+ * object:
+ *
+ *  File ID (8 bytes)
+ *  Name length (4 bytes)
+ *  Name string (variable size but in multiples of 4 bytes)
+ *  Cookie (8 bytes)
+ *  Attributes follow (4 bytes) and attributes (if they follow)
+ *  Handle follows (4 bytes) and variable length handle (if it follows)
+ *  next entry (4 bytes)
+ */
+
 struct FS3args
 {
   struct file_handle fsroot;
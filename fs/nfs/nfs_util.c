@@ -36,6 +36,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+
 #include "rpc.h"
 #include "nfs.h"
 #include "nfs_proto.h"
@@ -99,6 +101,76 @@ static inline int nfs_pathsegment(FAR const char **path, FAR char *buffer,
     }
 }
 
+/****************************************************************************
+ * Name: nfs_attrcache_find
+ *
+ * Description:
+ *   Return the unexpired lookup cache entry of 'relpath', or NULL.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_ATTRCACHE
+static FAR struct nfs_attrcache_s *
+nfs_attrcache_find(FAR struct nfsmount *nmp, FAR const char *relpath)
+{
+  FAR struct nfs_attrcache_s *ac;
+  clock_t now = clock_systime_ticks();
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      ac = &nmp->nm_attrcache[i];
+      if (ac->ac_path[0] != '\0' && strcmp(ac->ac_path, relpath) == 0)
+        {
+          if (now - ac->ac_time < MSEC2TICK(CONFIG_NFS_ATTRCACHE_TIMEOUT))
+            {
+              return ac;
+            }
+
+          /* Expired */
+
+          ac->ac_path[0] = '\0';
+          break;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: nfs_attrcache_add
+ *
+ * Description:
+ *   Remember the file handle and attributes found for 'relpath', replacing
+ *   the entries in round robin order.
+ *
+ ****************************************************************************/
+
+static void nfs_attrcache_add(FAR struct nfsmount *nmp,
+                              FAR const char *relpath,
+                              FAR const struct file_handle *fhandle,
+                              FAR const struct nfs_fattr *attributes)
+{
+  FAR struct nfs_attrcache_s *ac;
+
+  if (strlen(relpath) >= CONFIG_NFS_ATTRCACHE_PATHLEN)
+    {
+      return;
+    }
+
+  ac = &nmp->nm_attrcache[nmp->nm_attrnext];
+  if (++nmp->nm_attrnext >= CONFIG_NFS_ATTRCACHE_NENTRIES)
+    {
+      nmp->nm_attrnext = 0;
+    }
+
+  ac->ac_time = clock_systime_ticks();
+  memcpy(&ac->ac_fhandle, fhandle, sizeof(struct file_handle));
+  memcpy(&ac->ac_attributes, attributes, sizeof(struct nfs_fattr));
+  strlcpy(ac->ac_path, relpath, sizeof(ac->ac_path));
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -318,10 +390,23 @@ int nfs_findnode(FAR struct nfsmount *nmp, FAR const char *relpath,
                  FAR struct nfs_fattr *dir_attributes)
 {
   FAR const char *path = relpath;
+  struct nfs_fattr attributes;
   char            buffer[NAME_MAX + 1];
   char            terminator;
   uint32_t         tmp;
   int             error;
+#ifdef CONFIG_NFS_ATTRCACHE
+  FAR struct nfs_attrcache_s *ac;
+#endif
+
+  /* The attributes of intermediate directories are needed even if the
+   * caller does not want them.
+   */
+
+  if (obj_attributes == NULL)
+    {
+      obj_attributes = &attributes;
+    }
 
   /* Start with the file handle of the root directory.  */
 
@@ -349,6 +434,24 @@ int nfs_findnode(FAR struct nfsmount *nmp, FAR const char *relpath,
       return OK;
     }
 
+#ifdef CONFIG_NFS_ATTRCACHE
+  /* Check if the path was looked up recently.  The cache does not keep the
+   * attributes of the parent directory.
+   */
+
+  if (dir_attributes == NULL)
+    {
+      ac = nfs_attrcache_find(nmp, relpath);
+      if (ac != NULL)
+        {
+          memcpy(fhandle, &ac->ac_fhandle, sizeof(struct file_handle));
+          memcpy(obj_attributes, &ac->ac_attributes,
+                 sizeof(struct nfs_fattr));
+          return OK;
+        }
+    }
+#endif
+
   /* This is not the root directory. Loop until the directory entry
    * corresponding to the path is found.
    */
@@ -390,6 +493,9 @@ int nfs_findnode(FAR struct nfsmount *nmp, FAR const char *relpath,
            * dir_attributes.
            */
 
+#ifdef CONFIG_NFS_ATTRCACHE
+          nfs_attrcache_add(nmp, relpath, fhandle, obj_attributes);
+#endif
           return OK;
         }
 
@@ -526,3 +632,27 @@ void nfs_attrupdate(FAR struct nfsnode *np, FAR struct nfs_fattr *attributes)
   fxdr_nfsv3time(&attributes->fa_mtime, &np->n_mtime);
   fxdr_nfsv3time(&attributes->fa_ctime, &np->n_ctime);
 }
+
+/****************************************************************************
+ * Name: nfs_attrcache_invalidate
+ *
+ * Description:
+ *   Forget all cached lookups.  Called after any change to the file system
+ *   made through this mount.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_ATTRCACHE
+void nfs_attrcache_invalidate(FAR struct nfsmount *nmp)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_ATTRCACHE_NENTRIES; i++)
+    {
+      nmp->nm_attrcache[i].ac_path[0] = '\0';
+    }
+}
+#endif
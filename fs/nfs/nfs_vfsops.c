@@ -48,6 +48,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/statfs.h>
@@ -112,6 +113,10 @@ struct nfs_dir_s
   uint8_t  nfs_fhandle[DIRENT_NFS_MAXHANDLE]; /* File handle (max size allocated) */
   uint8_t  nfs_verifier[DIRENT_NFS_VERFLEN];  /* Cookie verifier */
   uint32_t nfs_cookie[2];                     /* Cookie */
+  bool     nfs_eof;                           /* Last batch was read */
+  uint16_t nfs_next;                          /* Next entry in nfs_entries */
+  uint16_t nfs_end;                           /* End of nfs_entries */
+  FAR uint8_t *nfs_entries;                   /* Batch of entries read */
 };
 
 /****************************************************************************
@@ -139,6 +144,17 @@ static int     nfs_fileopen(FAR struct nfsmount *nmp,
 static int     nfs_open(FAR struct file *filep, FAR const char *relpath,
                    int oflags, mode_t mode);
 static int     nfs_close(FAR struct file *filep);
+static ssize_t nfs_readrpc(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                   off_t offset, FAR char *buffer, size_t buflen,
+                   FAR bool *eof);
+static ssize_t nfs_writerpc(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np, off_t offset,
+                   FAR const char *buffer, size_t buflen);
+#ifdef CONFIG_NFS_DATA_CACHE
+static bool    nfs_cachealloc(FAR struct nfsmount *nmp,
+                   FAR struct nfsnode *np);
+static int     nfs_flush(FAR struct nfsmount *nmp, FAR struct nfsnode *np);
+#endif
 static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
                         size_t buflen);
 static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
@@ -155,6 +171,9 @@ static int     nfs_opendir(FAR struct inode *mountpt,
                    FAR const char *relpath, FAR struct fs_dirent_s **dir);
 static int     nfs_closedir(FAR struct inode *mountpt,
                    FAR struct fs_dirent_s *dir);
+static uint8_t nfs_dirtype(uint32_t type);
+static int     nfs_readdirfill(FAR struct nfsmount *nmp,
+                   FAR struct nfs_dir_s *ndir);
 static int     nfs_readdir(FAR struct inode *mountpt,
                            FAR struct fs_dirent_s *dir,
                            FAR struct dirent *entry);
@@ -333,6 +352,7 @@ static int nfs_filecreate(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
 
   /* Send the NFS request. */
 
+  nfs_attrcache_invalidate(nmp);
   nfs_statistics(NFSPROC_CREATE);
   ret = nfs_request(nmp, NFSPROC_CREATE,
                     &nmp->nm_msgbuffer.create, reqlen,
@@ -500,6 +520,7 @@ static int nfs_filechstat(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
 
   /* Perform the SETATTR RPC */
 
+  nfs_attrcache_invalidate(nmp);
   nfs_statistics(NFSPROC_SETATTR);
   ret = nfs_request(nmp, NFSPROC_SETATTR,
                     &nmp->nm_msgbuffer.setattr, reqlen,
@@ -836,10 +857,18 @@ static int nfs_close(FAR struct file *filep)
                   nmp->nm_head = np->n_next;
                 }
 
-              /* Then deallocate the file structure and return success */
+#ifdef CONFIG_NFS_DATA_CACHE
+              /* Write out the buffered data, report if that failed */
 
-              kmm_free(np);
+              ret = nfs_flush(nmp, np);
+              kmm_free(np->n_buffer);
+#else
               ret = OK;
+#endif
+
+              /* Then deallocate the file structure */
+
+              kmm_free(np);
               break;
             }
         }
@@ -850,6 +879,320 @@ static int nfs_close(FAR struct file *filep)
   return ret;
 }
 
+/****************************************************************************
+ * Name: nfs_readrpc
+ *
+ * Description:
+ *   Read up to 'buflen' bytes at 'offset' of the file with one READ RPC.
+ *   The read may be shorter than requested.
+ *
+ * Returned Value:
+ *   The (non-negative) number of bytes read on success; a negated errno
+ *   value on failure.  '*eof' is set when the end of file was reached.
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_readrpc(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
+                           off_t offset, FAR char *buffer, size_t buflen,
+                           FAR bool *eof)
+{
+  ssize_t                    readsize;
+  ssize_t                    tmp;
+  size_t                     reqlen;
+  FAR uint32_t              *ptr;
+  int                        ret;
+
+  /* Make sure that the attempted read size does not exceed the RPC
+   * maximum
+   */
+
+  readsize = buflen;
+  if (readsize > nmp->nm_rsize)
+    {
+      readsize = nmp->nm_rsize;
+    }
+
+  /* Make sure that the attempted read size does not exceed the IO buffer
+   * size
+   */
+
+  tmp = SIZEOF_rpc_reply_read(readsize);
+  if (tmp > nmp->nm_buflen)
+    {
+      readsize -= (tmp - nmp->nm_buflen);
+    }
+
+  /* Initialize the request */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper((uint64_t)offset, ptr);
+  ptr += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Set the readsize */
+
+  *ptr = txdr_unsigned(readsize);
+  reqlen += sizeof(uint32_t);
+
+  /* Perform the read */
+
+  finfo("Reading %zu bytes\n", readsize);
+  nfs_statistics(NFSPROC_READ);
+  ret = nfs_request(nmp, NFSPROC_READ,
+                    &nmp->nm_msgbuffer.read, reqlen,
+                    nmp->nm_iobuffer, nmp->nm_buflen);
+  if (ret)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
+
+  /* The read was successful.  Get a pointer to the beginning of the NFS
+   * response data.
+   */
+
+  ptr = (FAR uint32_t *)
+    &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
+
+  /* Check if attributes are included in the responses */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. Update the cached file status in the file structure. */
+
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* This is followed by the count of data read.  Isn't this
+   * the same as the length that is included in the read data?
+   *
+   * Just skip over if for now.
+   */
+
+  ptr++;
+
+  /* Next comes an EOF indication. */
+
+  *eof = *ptr++ != 0;
+
+  /* Then the length of the read data followed by the read data itself */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  ptr++;
+
+  if (tmp > readsize)
+    {
+      return -EIO;
+    }
+
+  /* Copy the read data into the user buffer */
+
+  memcpy(buffer, ptr, tmp);
+  return tmp;
+}
+
+/****************************************************************************
+ * Name: nfs_writerpc
+ *
+ * Description:
+ *   Write up to 'buflen' bytes at 'offset' of the file with one WRITE RPC.
+ *   The write may be shorter than requested.
+ *
+ * Returned Value:
+ *   The (positive) number of bytes written on success; a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t nfs_writerpc(FAR struct nfsmount *nmp,
+                            FAR struct nfsnode *np, off_t offset,
+                            FAR const char *buffer, size_t buflen)
+{
+  ssize_t              writesize;
+  ssize_t              bufsize;
+  size_t               reqlen;
+  FAR uint32_t        *ptr;
+  uint32_t             tmp;
+  int                  ret;
+
+  /* Make sure that the attempted write size does not exceed the RPC
+   * maximum.
+   */
+
+  writesize = buflen;
+  if (writesize > nmp->nm_wsize)
+    {
+      writesize = nmp->nm_wsize;
+    }
+
+  /* Make sure that the attempted read size does not exceed the IO
+   * buffer size.
+   */
+
+  bufsize = SIZEOF_rpc_call_write(writesize);
+  if (bufsize > nmp->nm_buflen)
+    {
+      writesize -= (bufsize - nmp->nm_buflen);
+    }
+
+  /* Initialize the request.  Here we need an offset pointer to the write
+   * arguments, skipping over the RPC header.  Write is unique among the
+   * RPC calls in that the entry RPC calls message lies in the I/O buffer
+   */
+
+  ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
+              nmp->nm_iobuffer)->write;
+  reqlen  = 0;
+
+  /* Copy the variable length, file handle */
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
+
+  /* Copy the file offset */
+
+  txdr_hyper((uint64_t)offset, ptr);
+  ptr    += 2;
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy the count and stable values */
+
+  *ptr++  = txdr_unsigned(writesize);
+  *ptr++  = txdr_unsigned(NFSV3WRITE_FILESYNC);
+  reqlen += 2*sizeof(uint32_t);
+
+  /* Copy a chunk of the user data into the I/O buffer */
+
+  *ptr++  = txdr_unsigned(writesize);
+  reqlen += sizeof(uint32_t);
+  memcpy(ptr, buffer, writesize);
+  reqlen += uint32_alignup(writesize);
+
+  /* Perform the write */
+
+  nfs_attrcache_invalidate(nmp);
+  nfs_statistics(NFSPROC_WRITE);
+  ret = nfs_request(nmp, NFSPROC_WRITE,
+                    nmp->nm_iobuffer, reqlen,
+                    &nmp->nm_msgbuffer.write,
+                    sizeof(struct rpc_reply_write));
+  if (ret)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
+
+  /* Get a pointer to the WRITE reply data */
+
+  ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
+
+  /* Parse file_wcc.  First, check if WCC attributes follow. */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. WCC attributes follow.  But we just skip over them. */
+
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  /* Check if normal file attributes follow */
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      /* Yes.. Update the cached file status in the file structure. */
+
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  /* Get the count of bytes actually written */
+
+  tmp = fxdr_unsigned(uint32_t, *ptr);
+  if (tmp < 1 || tmp > writesize)
+    {
+      return -EIO;
+    }
+
+  return tmp;
+}
+
+#ifdef CONFIG_NFS_DATA_CACHE
+/****************************************************************************
+ * Name: nfs_cachealloc
+ *
+ * Description:
+ *   Allocate the data cache of an open file on first use.  Without memory
+ *   the file is accessed without the cache.
+ *
+ ****************************************************************************/
+
+static bool nfs_cachealloc(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  if (np->n_buffer == NULL)
+    {
+      np->n_buffer = kmm_malloc(NFS_CACHESIZE(nmp));
+      np->n_buflen = 0;
+    }
+
+  return np->n_buffer != NULL;
+}
+
+/****************************************************************************
+ * Name: nfs_flush
+ *
+ * Description:
+ *   Write the buffered data of an open file to the server.  The data stays
+ *   in the cache.
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nfs_flush(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  ssize_t ret;
+  size_t nwritten = 0;
+
+  while (np->n_bufdirty && nwritten < np->n_buflen)
+    {
+      ret = nfs_writerpc(nmp, np, np->n_bufpos + nwritten,
+                         (FAR const char *)np->n_buffer + nwritten,
+                         np->n_buflen - nwritten);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nwritten += ret;
+    }
+
+  np->n_bufdirty = false;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: nfs_read
  *
@@ -867,8 +1210,7 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t                    readsize;
   ssize_t                    tmp;
   ssize_t                    bytesread;
-  size_t                     reqlen;
-  FAR uint32_t              *ptr;
+  bool                       eof;
   int                        ret = 0;
 
   finfo("Read %zu bytes from offset %jd\n",
@@ -906,102 +1248,60 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
 
   for (bytesread = 0; bytesread < buflen; )
     {
-      /* Make sure that the attempted read size does not exceed the RPC
-       * maximum
-       */
-
-      readsize = buflen - bytesread;
-      if (readsize > nmp->nm_rsize)
-        {
-          readsize = nmp->nm_rsize;
-        }
-
-      /* Make sure that the attempted read size does not exceed the IO buffer
-       * size
-       */
+#ifdef CONFIG_NFS_DATA_CACHE
+      /* Copy what the cache holds of the requested data */
 
-      tmp = SIZEOF_rpc_reply_read(readsize);
-      if (tmp > nmp->nm_buflen)
+      if (np->n_buflen > 0 && filep->f_pos >= np->n_bufpos &&
+          filep->f_pos < np->n_bufpos + np->n_buflen)
         {
-          readsize -= (tmp - nmp->nm_buflen);
+          tmp      = filep->f_pos - np->n_bufpos;
+          readsize = MIN(buflen - bytesread, np->n_buflen - tmp);
+          memcpy(buffer, np->n_buffer + tmp, readsize);
+
+          filep->f_pos += readsize;
+          bytesread    += readsize;
+          buffer       += readsize;
+          continue;
         }
 
-      /* Initialize the request */
-
-      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.read.read;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Set the readsize */
+      /* The server has to see the buffered writes before we read */
 
-      *ptr = txdr_unsigned(readsize);
-      reqlen += sizeof(uint32_t);
-
-      /* Perform the read */
-
-      finfo("Reading %zu bytes\n", readsize);
-      nfs_statistics(NFSPROC_READ);
-      ret = nfs_request(nmp, NFSPROC_READ,
-                        &nmp->nm_msgbuffer.read, reqlen,
-                        nmp->nm_iobuffer, nmp->nm_buflen);
-      if (ret)
+      ret = nfs_flush(nmp, np);
+      if (ret < 0)
         {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
-          goto errout_with_lock;
+          break;
         }
 
-      /* The read was successful.  Get a pointer to the beginning of the NFS
-       * response data.
+      /* Fill the whole cache if less is wanted, the sequential reads that
+       * follow are then served from the cache.
        */
 
-      ptr = (FAR uint32_t *)
-        &((FAR struct rpc_reply_read *)nmp->nm_iobuffer)->read;
-
-      /* Check if attributes are included in the responses */
-
-      tmp = *ptr++;
-      if (tmp != 0)
+      if (buflen - bytesread < NFS_CACHESIZE(nmp) &&
+          nfs_cachealloc(nmp, np))
         {
-          /* Yes.. Update the cached file status in the file structure. */
+          np->n_buflen = 0;
+          readsize = nfs_readrpc(nmp, np, filep->f_pos,
+                                 (FAR char *)np->n_buffer,
+                                 NFS_CACHESIZE(nmp), &eof);
+          if (readsize <= 0)
+            {
+              ret = readsize;
+              break;
+            }
 
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
+          np->n_bufpos = filep->f_pos;
+          np->n_buflen = readsize;
+          continue;
         }
+#endif
 
-      /* This is followed by the count of data read.  Isn't this
-       * the same as the length that is included in the read data?
-       *
-       * Just skip over if for now.
-       */
-
-      ptr++;
-
-      /* Next comes an EOF indication.  Save that in tmp for now. */
-
-      tmp = *ptr++;
-
-      /* Then the length of the read data followed by the read data itself */
-
-      readsize = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
-
-      /* Copy the read data into the user buffer */
-
-      memcpy(buffer, ptr, readsize);
+      readsize = nfs_readrpc(nmp, np, filep->f_pos, buffer,
+                             buflen - bytesread, &eof);
+      if (readsize < 0)
+        {
+          ret = readsize;
+          break;
+        }
 
       /* Update the read state data */
 
@@ -1011,13 +1311,12 @@ static ssize_t nfs_read(FAR struct file *filep, FAR char *buffer,
 
       /* Check if we hit the end of file */
 
-      if (tmp != 0)
+      if (eof || readsize == 0)
         {
           break;
         }
     }
 
-errout_with_lock:
   nxmutex_unlock(&nmp->nm_lock);
   return bytesread > 0 ? bytesread : ret;
 }
@@ -1037,13 +1336,7 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct nfsmount *nmp;
   FAR struct nfsnode  *np;
   ssize_t              writesize;
-  ssize_t              bufsize;
   ssize_t              byteswritten = 0;
-  size_t               reqlen;
-  FAR uint32_t        *ptr;
-  uint32_t             tmp;
-  int                  commit = 0;
-  int                  committed = NFSV3WRITE_FILESYNC;
   int                  ret;
 
   finfo("Write %zu bytes to offset %jd\n",
@@ -1078,125 +1371,50 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
 
   for (byteswritten = 0; byteswritten < buflen; )
     {
-      /* Make sure that the attempted write size does not exceed the RPC
-       * maximum.
+#ifdef CONFIG_NFS_DATA_CACHE
+      /* Data can only be added to the end of buffered writes, anything
+       * else in the cache is written out (if dirty) and dropped.
        */
 
-      writesize = buflen - byteswritten;
-      if (writesize > nmp->nm_wsize)
+      if (np->n_buflen > 0 &&
+          (!np->n_bufdirty || np->n_buflen >= NFS_CACHESIZE(nmp) ||
+           filep->f_pos != np->n_bufpos + np->n_buflen))
         {
-          writesize = nmp->nm_wsize;
+          ret = nfs_flush(nmp, np);
+          if (ret < 0)
+            {
+              goto errout_with_lock;
+            }
+
+          np->n_buflen = 0;
         }
 
-      /* Make sure that the attempted read size does not exceed the IO
-       * buffer size.
-       */
+      /* Collect writes smaller than the cache */
 
-      bufsize = SIZEOF_rpc_call_write(writesize);
-      if (bufsize > nmp->nm_buflen)
+      if (buflen - byteswritten < NFS_CACHESIZE(nmp) &&
+          nfs_cachealloc(nmp, np))
         {
-          writesize -= (bufsize - nmp->nm_buflen);
-        }
-
-      /* Initialize the request.  Here we need an offset pointer to the write
-       * arguments, skipping over the RPC header.  Write is unique among the
-       * RPC calls in that the entry RPC calls message lies in the I/O buffer
-       */
-
-      ptr     = (FAR uint32_t *)&((FAR struct rpc_call_write *)
-                  nmp->nm_iobuffer)->write;
-      reqlen  = 0;
-
-      /* Copy the variable length, file handle */
-
-      *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
-      reqlen += sizeof(uint32_t);
-
-      memcpy(ptr, &np->n_fhandle, np->n_fhsize);
-      reqlen += uint32_alignup(np->n_fhsize);
-      ptr    += uint32_increment(np->n_fhsize);
-
-      /* Copy the file offset */
-
-      txdr_hyper((uint64_t)filep->f_pos, ptr);
-      ptr    += 2;
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy the count and stable values */
-
-      *ptr++  = txdr_unsigned(writesize);
-      *ptr++  = txdr_unsigned(committed);
-      reqlen += 2*sizeof(uint32_t);
-
-      /* Copy a chunk of the user data into the I/O buffer */
-
-      *ptr++  = txdr_unsigned(writesize);
-      reqlen += sizeof(uint32_t);
-      memcpy(ptr, buffer, writesize);
-      reqlen += uint32_alignup(writesize);
-
-      /* Perform the write */
-
-      nfs_statistics(NFSPROC_WRITE);
-      ret = nfs_request(nmp, NFSPROC_WRITE,
-                        nmp->nm_iobuffer, reqlen,
-                        &nmp->nm_msgbuffer.write,
-                        sizeof(struct rpc_reply_write));
-      if (ret)
-        {
-          ferr("ERROR: nfs_request failed: %d\n", ret);
-          goto errout_with_lock;
-        }
-
-      /* Get a pointer to the WRITE reply data */
-
-      ptr = (FAR uint32_t *)&nmp->nm_msgbuffer.write.write;
-
-      /* Parse file_wcc.  First, check if WCC attributes follow. */
-
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. WCC attributes follow.  But we just skip over them. */
-
-          ptr += uint32_increment(sizeof(struct wcc_attr));
-        }
-
-      /* Check if normal file attributes follow */
-
-      tmp = *ptr++;
-      if (tmp != 0)
-        {
-          /* Yes.. Update the cached file status in the file structure. */
-
-          nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
-          ptr += uint32_increment(sizeof(struct nfs_fattr));
-        }
-
-      /* Get the count of bytes actually written */
-
-      tmp = fxdr_unsigned(uint32_t, *ptr);
-      ptr++;
-
-      if (tmp < 1 || tmp > writesize)
-        {
-          ret = -EIO;
-          goto errout_with_lock;
-        }
-
-      writesize = tmp;
-
-      /* Determine the lowest commitment level obtained by any of the RPCs. */
+          if (np->n_buflen == 0)
+            {
+              np->n_bufpos = filep->f_pos;
+            }
 
-      commit = *ptr++;
-      if (committed == NFSV3WRITE_FILESYNC)
-        {
-          committed = commit;
+          writesize = MIN(buflen - byteswritten,
+                          NFS_CACHESIZE(nmp) - np->n_buflen);
+          memcpy(np->n_buffer + np->n_buflen, buffer, writesize);
+          np->n_buflen  += writesize;
+          np->n_bufdirty = true;
         }
-      else if (committed == NFSV3WRITE_DATASYNC &&
-               commit == NFSV3WRITE_UNSTABLE)
+      else
+#endif
         {
-          committed = commit;
+          writesize = nfs_writerpc(nmp, np, filep->f_pos, buffer,
+                                   buflen - byteswritten);
+          if (writesize < 0)
+            {
+              ret = writesize;
+              goto errout_with_lock;
+            }
         }
 
       /* Update the read state data */
@@ -1204,6 +1422,11 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
       filep->f_pos += writesize;
       byteswritten += writesize;
       buffer       += writesize;
+
+      if (filep->f_pos > np->n_size)
+        {
+          np->n_size = filep->f_pos;
+        }
     }
 
 errout_with_lock:
@@ -1286,7 +1509,30 @@ static off_t nfs_seek(FAR struct file *filep, off_t offset, int whence)
 
 static int nfs_sync(FAR struct file *filep)
 {
+#ifdef CONFIG_NFS_DATA_CACHE
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode  *np;
+  int ret;
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  nmp = filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
+
+  DEBUGASSERT(nmp != NULL);
+
+  ret = nxmutex_lock(&nmp->nm_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = nfs_flush(nmp, np);
+  nxmutex_unlock(&nmp->nm_lock);
+  return ret;
+#else
   return 0;
+#endif
 }
 
 /****************************************************************************
@@ -1419,6 +1665,17 @@ static int nfs_fchstat(FAR const struct file *filep,
       return ret;
     }
 
+#ifdef CONFIG_NFS_DATA_CACHE
+  /* Buffered writes would override the new times */
+
+  ret = nfs_flush(nmp, np);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&nmp->nm_lock);
+      return ret;
+    }
+#endif
+
   /* Change the file mode, owner, group and time. */
 
   ret = nfs_filechstat(nmp, np, buf, flags);
@@ -1457,6 +1714,19 @@ static int nfs_truncate(FAR struct file *filep, off_t length)
     {
       struct stat buf;
 
+#ifdef CONFIG_NFS_DATA_CACHE
+      /* Write out and drop the cached data, it may be past the new end */
+
+      ret = nfs_flush(nmp, np);
+      if (ret < 0)
+        {
+          nxmutex_unlock(&nmp->nm_lock);
+          return ret;
+        }
+
+      np->n_buflen = 0;
+#endif
+
       /* Then perform the SETATTR RPC to set the new file size */
 
       buf.st_size = length;
@@ -1504,6 +1774,17 @@ static int nfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
       return -ENOMEM;
     }
 
+  /* The entries of a READDIR reply are kept in a packed form that is
+   * always smaller than the reply.
+   */
+
+  ndir->nfs_entries = kmm_malloc(nmp->nm_buflen);
+  if (ndir->nfs_entries == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_ndir;
+    }
+
   ret = nxmutex_lock(&nmp->nm_lock);
   if (ret < 0)
     {
@@ -1544,6 +1825,7 @@ static int nfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
 errout_with_lock:
   nxmutex_unlock(&nmp->nm_lock);
 errout_with_ndir:
+  kmm_free(ndir->nfs_entries);
   kmm_free(ndir);
   return ret;
 }
@@ -1562,60 +1844,105 @@ errout_with_ndir:
 static int nfs_closedir(FAR struct inode *mountpt,
                         FAR struct fs_dirent_s *dir)
 {
+  FAR struct nfs_dir_s *ndir = (FAR struct nfs_dir_s *)dir;
+
   DEBUGASSERT(dir);
-  kmm_free(dir);
+  kmm_free(ndir->nfs_entries);
+  kmm_free(ndir);
   return 0;
 }
 
 /****************************************************************************
- * Name: nfs_readdir
+ * Name: nfs_dirtype
  *
- * Description: Read from directory
+ * Description:
+ *   Map an NFS file type to the dirent file type.
+ *
+ ****************************************************************************/
+
+static uint8_t nfs_dirtype(uint32_t type)
+{
+  switch (type)
+    {
+    case NFSOCK:       /* Socket */
+      return DTYPE_SOCK;
+
+    case NFLNK:        /* Symbolic link */
+      return DTYPE_LINK;
+
+    case NFREG:        /* Regular file */
+      return DTYPE_FILE;
+
+    case NFDIR:        /* Directory */
+      return DTYPE_DIRECTORY;
+
+    case NFBLK:        /* Block special device file */
+      return DTYPE_BLK;
+
+    case NFFIFO:       /* Named FIFO */
+      return DTYPE_FIFO;
+
+    case NFCHR:        /* Character special device file */
+      return DTYPE_CHR;
+
+    default:
+    case NFNON:        /* Unknown type */
+      return DTYPE_UNKNOWN;
+    }
+}
+
+/****************************************************************************
+ * Name: nfs_readdirfill
+ *
+ * Description:
+ *   Read the next batch of directory entries with one READDIRPLUS (or
+ *   READDIR if the server does not support it) RPC.  The entries are kept
+ *   in nfs_entries, each as its type, its name length and its name.
  *
  * Returned Value:
  *   0 on success; a negated errno value on failure.
  *
  ****************************************************************************/
 
-static int nfs_readdir(FAR struct inode *mountpt,
-                       FAR struct fs_dirent_s *dir,
-                       FAR struct dirent *entry)
+static int nfs_readdirfill(FAR struct nfsmount *nmp,
+                           FAR struct nfs_dir_s *ndir)
 {
-  FAR struct nfsmount *nmp;
-  FAR struct nfs_dir_s *ndir;
-  struct file_handle fhandle;
-  struct nfs_fattr obj_attributes;
-  uint32_t readsize;
-  uint32_t tmp;
   FAR uint32_t *ptr;
+  FAR uint32_t *end;
   FAR uint8_t *name;
+  FAR void *request;
+  uint32_t readsize;
+  uint32_t tmp;
   unsigned int length;
+  uint8_t type;
+  bool plus;
+  int procid;
   int reqlen;
   int ret;
 
-  finfo("Entry\n");
-
-  /* Sanity checks */
-
-  DEBUGASSERT(mountpt != NULL && mountpt->i_private != NULL);
+  ndir->nfs_next = 0;
+  ndir->nfs_end  = 0;
 
-  /* Recover our private data from the inode instance */
-
-  nmp = mountpt->i_private;
-  ndir = (FAR struct nfs_dir_s *)dir;
+retry:
+  /* Request a block directory entries, copying directory information from
+   * the dirent structure.  The READDIRPLUS arguments only add a maximum
+   * reply size at the end.
+   */
 
-  ret = nxmutex_lock(&nmp->nm_lock);
-  if (ret < 0)
+  plus = !nmp->nm_noreaddirplus;
+  if (plus)
     {
-      return ret;
+      request = &nmp->nm_msgbuffer.readdirplus;
+      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.readdirplus.readdirplus;
+      procid  = NFSPROC_READDIRPLUS;
+    }
+  else
+    {
+      request = &nmp->nm_msgbuffer.readdir;
+      ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.readdir.readdir;
+      procid  = NFSPROC_READDIR;
     }
 
-read_dir:
-  /* Request a block directory entries, copying directory information from
-   * the dirent structure.
-   */
-
-  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.readdir.readdir;
   reqlen  = 0;
 
   /* Copy the variable length, directory file handle */
@@ -1638,8 +1965,8 @@ read_dir:
   ptr    += uint32_increment(DIRENT_NFS_VERFLEN);
   reqlen += DIRENT_NFS_VERFLEN;
 
-  /* Number of directory entries (We currently only process one entry at a
-   * time)
+  /* Size of the directory information to return, as many entries as fit
+   * in the I/O buffer.
    */
 
   readsize = nmp->nm_readdirsize;
@@ -1649,19 +1976,31 @@ read_dir:
       readsize -= (tmp - nmp->nm_buflen);
     }
 
-  *ptr     = txdr_unsigned(readsize);
+  *ptr++   = txdr_unsigned(readsize);
   reqlen  += sizeof(uint32_t);
 
+  if (plus)
+    {
+      *ptr    = txdr_unsigned(readsize);
+      reqlen += sizeof(uint32_t);
+    }
+
   /* And read the directory */
 
-  nfs_statistics(NFSPROC_READDIR);
-  ret = nfs_request(nmp, NFSPROC_READDIR,
-                    &nmp->nm_msgbuffer.readdir, reqlen,
+  nfs_statistics(procid);
+  ret = nfs_request(nmp, procid, request, reqlen,
                     nmp->nm_iobuffer, nmp->nm_buflen);
   if (ret != OK)
     {
+      if (plus && (ret == -NFSERR_NOTSUPP || ret == -EOPNOTSUPP))
+        {
+          finfo("READDIRPLUS not supported, using READDIR\n");
+          nmp->nm_noreaddirplus = true;
+          goto retry;
+        }
+
       ferr("ERROR: nfs_request failed: %d\n", ret);
-      goto errout_with_lock;
+      return ret;
     }
 
   /* A new group of entries was successfully read.  Process the
@@ -1676,6 +2015,7 @@ read_dir:
 
   ptr = (FAR uint32_t *)
     &((FAR struct rpc_reply_readdir *)nmp->nm_iobuffer)->readdir;
+  end = (FAR uint32_t *)((FAR uint8_t *)nmp->nm_iobuffer + nmp->nm_buflen);
 
   /* Check if attributes follow, if 0 so Skip over the attributes */
 
@@ -1689,141 +2029,229 @@ read_dir:
 
   /* Save the verification cookie */
 
+  if (ptr + uint32_increment(DIRENT_NFS_VERFLEN) > end)
+    {
+      return -EIO;
+    }
+
   memcpy(ndir->nfs_verifier, ptr, DIRENT_NFS_VERFLEN);
   ptr += uint32_increment(DIRENT_NFS_VERFLEN);
 
-next_entry:
-  /* Check if values follow.  If no values follow, then the EOF indication
-   * will appear next.
+  /* Then a set of entries follows the header, each preceded by a values
+   * follow indication.  Each entry is of the form:
+   *
+   *    File ID (8 bytes)
+   *    Name length (4 bytes)
+   *    Name string (variable size but in multiples of 4 bytes)
+   *    Cookie (8 bytes)
+   *
+   * For READDIRPLUS followed by the optional attributes and file handle.
    */
 
-  tmp = *ptr++;
-  if (tmp == 0)
+  for (; ; )
     {
-      /* No values follow, then the reply should consist only of a 4-byte
-       * end-of-directory indication.
-       */
+      if (ptr >= end)
+        {
+          return -EIO;
+        }
 
       tmp = *ptr++;
-      if (tmp != 0)
+      if (tmp == 0)
         {
-          finfo("End of directory\n");
-          ret = -ENOENT;
-          goto errout_with_lock;
+          break;
         }
 
-      /* What would it mean if there were not data and we not at the end of
-       * file?
-       */
+      /* Skip over the file ID and get the length of the name */
 
-       else
+      if (ptr + 3 > end)
         {
-          finfo("No data but not end of directory???\n");
-          goto read_dir;
+          return -EIO;
         }
-    }
 
-  /* If we are not at the end of the directory listing, then a set of entries
-   * will follow the header.  Each entry is of the form:
-   *
-   *    File ID (8 bytes)
-   *    Name length (4 bytes)
-   *    Name string (variable size but in multiples of 4 bytes)
-   *    Cookie (8 bytes)
-   *    next entry (4 bytes)
-   */
+      ptr   += 2;
+      length = fxdr_unsigned(uint32_t, *ptr++);
+      name   = (FAR uint8_t *)ptr;
 
-  /* There is an entry. Skip over the file ID and point to the length */
+      if (length > NFS_MAXNAMLEN ||
+          ptr + uint32_increment(length) + 2 > end)
+        {
+          return -EIO;
+        }
 
-  ptr += 2;
+      /* Increment the pointer past the name (allowing for padding) and
+       * save the cookie.
+       */
 
-  /* Get the length and point to the name */
+      ptr += uint32_increment(length);
+      ndir->nfs_cookie[0] = *ptr++;
+      ndir->nfs_cookie[1] = *ptr++;
 
-  tmp    = *ptr++;
-  length = fxdr_unsigned(uint32_t, tmp);
-  name   = (FAR uint8_t *)ptr;
+      /* The type comes with the attributes of READDIRPLUS */
 
-  /* Increment the pointer past the name (allowing for padding). ptr
-   * now points to the cookie.
-   */
+      type = DTYPE_UNKNOWN;
+      if (plus)
+        {
+          if (ptr >= end)
+            {
+              return -EIO;
+            }
 
-  ptr += uint32_increment(length);
+          tmp = *ptr++;
+          if (tmp != 0)
+            {
+              if (ptr + uint32_increment(sizeof(struct nfs_fattr)) > end)
+                {
+                  return -EIO;
+                }
 
-  /* Save the cookie and increment the pointer to the next entry */
+              tmp  = ((FAR struct nfs_fattr *)ptr)->fa_type;
+              type = nfs_dirtype(fxdr_unsigned(uint32_t, tmp));
+              ptr += uint32_increment(sizeof(struct nfs_fattr));
+            }
 
-  ndir->nfs_cookie[0] = *ptr++;
-  ndir->nfs_cookie[1] = *ptr++;
+          /* Skip over the file handle */
 
-  /* Return the name of the node to the caller */
+          if (ptr >= end)
+            {
+              return -EIO;
+            }
 
-  if (length > NAME_MAX)
-    {
-      length = NAME_MAX;
+          tmp = *ptr++;
+          if (tmp != 0)
+            {
+              if (ptr >= end)
+                {
+                  return -EIO;
+                }
+
+              tmp = fxdr_unsigned(uint32_t, *ptr++);
+              if (tmp > NFSX_V3FHMAX || ptr + uint32_increment(tmp) > end)
+                {
+                  return -EIO;
+                }
+
+              ptr += uint32_increment(tmp);
+            }
+        }
+
+      /* Keep the entry, skipping . and .. */
+
+      if ((length == 1 && name[0] == '.') ||
+          (length == 2 && name[0] == '.' && name[1] == '.'))
+        {
+          continue;
+        }
+
+      if (length > NAME_MAX)
+        {
+          length = NAME_MAX;
+        }
+
+      DEBUGASSERT(ndir->nfs_end + 2 + length <= nmp->nm_buflen);
+      ndir->nfs_entries[ndir->nfs_end++] = type;
+      ndir->nfs_entries[ndir->nfs_end++] = length;
+      memcpy(&ndir->nfs_entries[ndir->nfs_end], name, length);
+      ndir->nfs_end += length;
     }
 
-  memcpy(entry->d_name, name, length);
-  entry->d_name[length] = '\0';
-  finfo("name: \"%s\"\n", entry->d_name);
+  /* The end-of-directory indication ends the reply */
 
-  if (strcmp(entry->d_name, ".") == 0 ||
-      strcmp(entry->d_name, "..") == 0)
+  if (ptr >= end)
     {
-      goto next_entry; /* Skip . and .. */
+      return -EIO;
     }
 
-  /* Get the file attributes associated with this name and return
-   * the file type.
-   */
+  ndir->nfs_eof = *ptr != 0;
+  return OK;
+}
 
-  fhandle.length = (uint32_t)ndir->nfs_fhsize;
-  memcpy(&fhandle.handle, ndir->nfs_fhandle, fhandle.length);
+/****************************************************************************
+ * Name: nfs_readdir
+ *
+ * Description: Read from directory
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
 
-  ret = nfs_lookup(nmp, entry->d_name, &fhandle, &obj_attributes, NULL);
-  if (ret != OK)
+static int nfs_readdir(FAR struct inode *mountpt,
+                       FAR struct fs_dirent_s *dir,
+                       FAR struct dirent *entry)
+{
+  FAR struct nfsmount *nmp;
+  FAR struct nfs_dir_s *ndir;
+  struct file_handle fhandle;
+  struct nfs_fattr obj_attributes;
+  unsigned int length;
+  uint32_t tmp;
+  int ret;
+
+  finfo("Entry\n");
+
+  /* Sanity checks */
+
+  DEBUGASSERT(mountpt != NULL && mountpt->i_private != NULL);
+
+  /* Recover our private data from the inode instance */
+
+  nmp = mountpt->i_private;
+  ndir = (FAR struct nfs_dir_s *)dir;
+
+  ret = nxmutex_lock(&nmp->nm_lock);
+  if (ret < 0)
     {
-      ferr("ERROR: nfs_lookup failed: %d\n", ret);
-      goto errout_with_lock;
+      return ret;
     }
 
-  /* Set the dirent file type */
+  /* Read more entries until there is one to return */
 
-  tmp = fxdr_unsigned(uint32_t, obj_attributes.fa_type);
-  switch (tmp)
+  while (ndir->nfs_next >= ndir->nfs_end)
     {
-    default:
-    case NFNON:        /* Unknown type */
-      break;
+      if (ndir->nfs_eof)
+        {
+          finfo("End of directory\n");
+          ret = -ENOENT;
+          goto errout_with_lock;
+        }
 
-    case NFSOCK:       /* Socket */
-      entry->d_type = DTYPE_SOCK;
-      break;
+      ret = nfs_readdirfill(nmp, ndir);
+      if (ret != OK)
+        {
+          goto errout_with_lock;
+        }
+    }
 
-    case NFLNK:        /* Symbolic link */
-      entry->d_type = DTYPE_LINK;
-      break;
+  /* Return the name of the node to the caller */
 
-    case NFREG:        /* Regular file */
-      entry->d_type = DTYPE_FILE;
-      break;
+  entry->d_type = ndir->nfs_entries[ndir->nfs_next++];
+  length        = ndir->nfs_entries[ndir->nfs_next++];
 
-    case NFDIR:        /* Directory */
-      entry->d_type = DTYPE_DIRECTORY;
-      break;
+  memcpy(entry->d_name, &ndir->nfs_entries[ndir->nfs_next], length);
+  entry->d_name[length] = '\0';
+  ndir->nfs_next += length;
+  finfo("name: \"%s\"\n", entry->d_name);
 
-    case NFBLK:        /* Block special device file */
-      entry->d_type = DTYPE_BLK;
-      break;
+  /* READDIR does not return the type.  Get the file attributes associated
+   * with this name and return the file type.
+   */
 
-    case NFFIFO:       /* Named FIFO */
-      entry->d_type = DTYPE_FIFO;
-      break;
+  if (entry->d_type == DTYPE_UNKNOWN)
+    {
+      fhandle.length = (uint32_t)ndir->nfs_fhsize;
+      memcpy(&fhandle.handle, ndir->nfs_fhandle, fhandle.length);
 
-    case NFCHR:        /* Character special device file */
-      entry->d_type = DTYPE_CHR;
-      break;
-    }
+      ret = nfs_lookup(nmp, entry->d_name, &fhandle, &obj_attributes, NULL);
+      if (ret != OK)
+        {
+          ferr("ERROR: nfs_lookup failed: %d\n", ret);
+          goto errout_with_lock;
+        }
 
-  finfo("type: %d->%d\n", (int)tmp, entry->d_type);
+      tmp = fxdr_unsigned(uint32_t, obj_attributes.fa_type);
+      entry->d_type = nfs_dirtype(tmp);
+      finfo("type: %d->%d\n", (int)tmp, entry->d_type);
+    }
 
 errout_with_lock:
   nxmutex_unlock(&nmp->nm_lock);
@@ -1862,6 +2290,9 @@ static int nfs_rewinddir(FAR struct inode *mountpt,
   memset(&ndir->nfs_verifier, 0, DIRENT_NFS_VERFLEN);
   ndir->nfs_cookie[0] = 0;
   ndir->nfs_cookie[1] = 0;
+  ndir->nfs_eof       = false;
+  ndir->nfs_next      = 0;
+  ndir->nfs_end       = 0;
   return OK;
 }
 
@@ -2495,6 +2926,7 @@ static int nfs_remove(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Perform the REMOVE RPC call */
 
+  nfs_attrcache_invalidate(nmp);
   nfs_statistics(NFSPROC_REMOVE);
   ret = nfs_request(nmp, NFSPROC_REMOVE,
                     &nmp->nm_msgbuffer.removef, reqlen,
@@ -2618,6 +3050,7 @@ static int nfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Perform the MKDIR RPC */
 
+  nfs_attrcache_invalidate(nmp);
   nfs_statistics(NFSPROC_MKDIR);
   ret = nfs_request(nmp, NFSPROC_MKDIR,
                     &nmp->nm_msgbuffer.mkdir, reqlen,
@@ -2705,6 +3138,7 @@ static int nfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Perform the RMDIR RPC */
 
+  nfs_attrcache_invalidate(nmp);
   nfs_statistics(NFSPROC_RMDIR);
   ret = nfs_request(nmp, NFSPROC_RMDIR,
                     &nmp->nm_msgbuffer.rmdir, reqlen,
@@ -2818,6 +3252,7 @@ static int nfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
 
   /* Perform the RENAME RPC */
 
+  nfs_attrcache_invalidate(nmp);
   nfs_statistics(NFSPROC_RENAME);
   ret = nfs_request(nmp, NFSPROC_RENAME,
                     &nmp->nm_msgbuffer.renamef, reqlen,
@@ -0,0 +1,350 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsboottime.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_BOOTTIME)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BOOTTIME_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct boottime_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  char line[BOOTTIME_LINELEN];  /* Pre-allocated buffer for formatted lines */
+};
+
+/* This structure holds the state of one read */
+
+struct boottime_info_s
+{
+  FAR struct boottime_file_s *attr;
+  FAR char *buffer;
+  off_t offset;
+  size_t buflen;
+  size_t totalsize;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     boottime_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     boottime_close(FAR struct file *filep);
+static ssize_t boottime_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     boottime_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     boottime_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_boottime_operations =
+{
+  boottime_open,      /* open */
+  boottime_close,     /* close */
+  boottime_read,      /* read */
+  NULL,               /* write */
+
+  boottime_dup,       /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  boottime_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: boottime_open
+ ****************************************************************************/
+
+static int boottime_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct boottime_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct boottime_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: boottime_close
+ ****************************************************************************/
+
+static int boottime_close(FAR struct file *filep)
+{
+  FAR struct boottime_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct boottime_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: boottime_emit
+ *
+ * Description:
+ *   Copy one formatted line to the user buffer, honoring the file offset.
+ *   Returns false once the user buffer is full.
+ *
+ ****************************************************************************/
+
+static bool boottime_emit(FAR struct boottime_info_s *info, size_t linesize)
+{
+  size_t copysize;
+
+  copysize = procfs_memcpy(info->attr->line, linesize,
+                           info->buffer + info->totalsize,
+                           info->buflen - info->totalsize,
+                           &info->offset);
+
+  info->totalsize += copysize;
+  return info->totalsize < info->buflen;
+}
+
+/****************************************************************************
+ * Name: boottime_usec
+ *
+ * Description:
+ *   Convert an up_perf_gettime() interval to microseconds.
+ *
+ ****************************************************************************/
+
+static unsigned long boottime_usec(unsigned long elapsed)
+{
+  struct timespec ts;
+
+  up_perf_convert(elapsed, &ts);
+  return ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: boottime_read
+ ****************************************************************************/
+
+static ssize_t boottime_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  struct boottime_info_s info;
+  struct boottime_s entry;
+  unsigned long origin = 0;
+  size_t linesize;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  info.attr      = (FAR struct boottime_file_s *)filep->f_priv;
+  info.buffer    = buffer;
+  info.offset    = filep->f_pos;
+  info.buflen    = buflen;
+  info.totalsize = 0;
+
+  DEBUGASSERT(info.attr);
+
+  linesize = procfs_snprintf(info.attr->line, BOOTTIME_LINELEN,
+                             "%10s %10s  %s\n", "START(us)", "TIME(us)",
+                             "PHASE");
+  if (!boottime_emit(&info, linesize))
+    {
+      goto out;
+    }
+
+  /* One line per phase.  Start times are relative to the first phase and
+   * nested phases are indented.  A phase that has not ended yet shows no
+   * duration.
+   */
+
+  for (i = 0; boottime_get(i, &entry) >= 0; i++)
+    {
+      if (i == 0)
+        {
+          origin = entry.start;
+        }
+
+      if (entry.done)
+        {
+          linesize = procfs_snprintf(info.attr->line, BOOTTIME_LINELEN,
+                                     "%10lu %10lu  %*s%s\n",
+                                     boottime_usec(entry.start - origin),
+                                     boottime_usec(entry.elapsed),
+                                     2 * entry.depth, "", entry.name);
+        }
+      else
+        {
+          linesize = procfs_snprintf(info.attr->line, BOOTTIME_LINELEN,
+                                     "%10lu %10s  %*s%s\n",
+                                     boottime_usec(entry.start - origin),
+                                     "-", 2 * entry.depth, "", entry.name);
+        }
+
+      if (!boottime_emit(&info, linesize))
+        {
+          break;
+        }
+    }
+
+out:
+  filep->f_pos += info.totalsize;
+  return info.totalsize;
+}
+
+/****************************************************************************
+ * Name: boottime_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int boottime_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct boottime_file_s *oldattr;
+  FAR struct boottime_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct boottime_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct boottime_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct boottime_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: boottime_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int boottime_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "boottime" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_SCHED_BOOTTIME */
@@ -45,16 +45,6 @@
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
     defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-/* Determines the size of an intermediate buffer that must be large enough
- * to handle the longest line generated by this logic.
- */
-
-#define IOBINFO_LINELEN 80
-
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -64,8 +54,7 @@
 struct iobinfo_file_s
 {
   struct procfs_file_s base;      /* Base open file structure */
-  unsigned int linesize;          /* Number of valid characters in line[] */
-  char line[IOBINFO_LINELEN];     /* Pre-allocated buffer for formatted lines */
+  struct procfs_seq_s seq;        /* Record cursor */
 };
 
 /****************************************************************************
@@ -83,6 +72,27 @@ static int     iobinfo_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     iobinfo_stat(FAR const char *relpath, FAR struct stat *buf);
 
+/* Record iterator */
+
+static FAR void *iobinfo_start(FAR struct procfs_seq_s *seq, off_t index);
+static FAR void *iobinfo_next(FAR struct procfs_seq_s *seq, FAR void *elem,
+                              off_t index);
+static int     iobinfo_show(FAR struct procfs_seq_s *seq, FAR void *elem);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The file has two records: the headers and the usage statistics */
+
+static const struct procfs_seq_operations_s g_iobinfo_seqops =
+{
+  iobinfo_start,  /* start */
+  iobinfo_next,   /* next */
+  NULL,           /* stop */
+  iobinfo_show    /* show */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -110,6 +120,49 @@ const struct procfs_operations g_iobinfo_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iobinfo_start
+ ****************************************************************************/
+
+static FAR void *iobinfo_start(FAR struct procfs_seq_s *seq, off_t index)
+{
+  return index < 2 ? (FAR void *)(uintptr_t)(index + 1) : NULL;
+}
+
+/****************************************************************************
+ * Name: iobinfo_next
+ ****************************************************************************/
+
+static FAR void *iobinfo_next(FAR struct procfs_seq_s *seq, FAR void *elem,
+                              off_t index)
+{
+  return iobinfo_start(seq, index);
+}
+
+/****************************************************************************
+ * Name: iobinfo_show
+ ****************************************************************************/
+
+static int iobinfo_show(FAR struct procfs_seq_s *seq, FAR void *elem)
+{
+  struct iob_stats_s stats;
+
+  if ((uintptr_t)elem == 1)
+    {
+      procfs_seq_printf(seq, "%10s%10s%10s%10s\n",
+                        "ntotal", "nfree", "nwait", "nthrottle");
+    }
+  else
+    {
+      iob_getstats(&stats);
+      procfs_seq_printf(seq, "%10d%10d%10d%10d\n",
+                        stats.ntotal, stats.nfree,
+                        stats.nwait, stats.nthrottle);
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: iobinfo_open
  ****************************************************************************/
@@ -143,6 +196,8 @@ static int iobinfo_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+  procfs_seq_open(&procfile->seq, &g_iobinfo_seqops, NULL);
+
   /* Save the attributes as the open-specific state in filep->f_priv */
 
   filep->f_priv = (FAR void *)procfile;
@@ -164,6 +219,7 @@ static int iobinfo_close(FAR struct file *filep)
 
   /* Release the file attributes structure */
 
+  procfs_seq_close(&procfile->seq);
   kmm_free(procfile);
   filep->f_priv = NULL;
   return OK;
@@ -177,51 +233,17 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
                             size_t buflen)
 {
   FAR struct iobinfo_file_s *iobfile;
-  FAR struct iob_stats_s stats;
-  size_t linesize;
-  size_t copysize;
-  size_t totalsize;
-  off_t offset;
 
   finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
 
   DEBUGASSERT(buffer != NULL && buflen > 0);
-  offset = filep->f_pos;
 
   /* Recover our private data from the struct file instance */
 
   iobfile = (FAR struct iobinfo_file_s *)filep->f_priv;
   DEBUGASSERT(iobfile);
 
-  /* The first line is the headers */
-
-  linesize  = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
-                              "%10s%10s%10s%10s\n",
-                              "ntotal", "nfree", "nwait", "nthrottle");
-
-  copysize  = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
-                            &offset);
-  totalsize = copysize;
-
-  buffer   += copysize;
-  buflen   -= copysize;
-
-  /* The second line is the usage statistics */
-
-  iob_getstats(&stats);
-  linesize   = procfs_snprintf(iobfile->line, IOBINFO_LINELEN,
-                               "%10d%10d%10d%10d\n",
-                               stats.ntotal, stats.nfree,
-                               stats.nwait, stats.nthrottle);
-
-  copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
-                             &offset);
-  totalsize += copysize;
-
-  /* Update the file offset */
-
-  filep->f_pos += totalsize;
-  return totalsize;
+  return procfs_seq_read(&iobfile->seq, filep, buffer, buflen);
 }
 
 /****************************************************************************
@@ -257,6 +279,11 @@ static int iobinfo_dup(FAR const struct file *oldp, FAR struct file *newp)
   /* The copy the file attributes from the old attributes to the new */
 
   memcpy(newattr, oldattr, sizeof(struct iobinfo_file_s));
+  if (procfs_seq_dup(&newattr->seq, &oldattr->seq) < 0)
+    {
+      kmm_free(newattr);
+      return -ENOMEM;
+    }
 
   /* Save the new attributes in the new file structure */
 
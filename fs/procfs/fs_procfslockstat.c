@@ -0,0 +1,372 @@
+/****************************************************************************
+ * fs/procfs/fs_procfslockstat.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/arch.h>
+#include <nuttx/lockstat.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_LOCKSTAT)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define LOCKSTAT_LINELEN 128
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct lockstat_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  char line[LOCKSTAT_LINELEN];  /* Pre-allocated buffer for formatted lines */
+};
+
+/* This structure is used to emit one line per lock with lockstat_foreach */
+
+struct lockstat_info_s
+{
+  FAR struct lockstat_file_s *attr;
+  FAR char *buffer;
+  off_t offset;
+  size_t buflen;
+  size_t totalsize;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     lockstat_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     lockstat_close(FAR struct file *filep);
+static ssize_t lockstat_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t lockstat_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static int     lockstat_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     lockstat_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_lockstat_operations =
+{
+  lockstat_open,      /* open */
+  lockstat_close,     /* close */
+  lockstat_read,      /* read */
+  lockstat_write,     /* write */
+
+  lockstat_dup,       /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  lockstat_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lockstat_open
+ ****************************************************************************/
+
+static int lockstat_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct lockstat_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct lockstat_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_close
+ ****************************************************************************/
+
+static int lockstat_close(FAR struct file *filep)
+{
+  FAR struct lockstat_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct lockstat_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_emit
+ *
+ * Description:
+ *   Copy one formatted line to the user buffer, honoring the file offset.
+ *   Returns false once the user buffer is full.
+ *
+ ****************************************************************************/
+
+static bool lockstat_emit(FAR struct lockstat_info_s *info, size_t linesize)
+{
+  size_t copysize;
+
+  copysize = procfs_memcpy(info->attr->line, linesize,
+                           info->buffer + info->totalsize,
+                           info->buflen - info->totalsize,
+                           &info->offset);
+
+  info->totalsize += copysize;
+  return info->totalsize < info->buflen;
+}
+
+/****************************************************************************
+ * Name: lockstat_usec
+ *
+ * Description:
+ *   Convert up_perf_gettime() counts to microseconds.
+ *
+ ****************************************************************************/
+
+static unsigned long lockstat_usec(uint64_t elapsed)
+{
+  return elapsed * USEC_PER_SEC / up_perf_getfreq();
+}
+
+/****************************************************************************
+ * Name: lockstat_entry
+ *
+ * Description:
+ *   lockstat_foreach() callback emitting one line per (lock, caller) pair.
+ *
+ ****************************************************************************/
+
+static void lockstat_entry(FAR const struct lockstat_s *stat,
+                           FAR void *arg)
+{
+  static FAR const char *const types[] =
+  {
+    "sem", "mutex", "spin"
+  };
+
+  FAR struct lockstat_info_s *info = arg;
+  size_t linesize;
+
+  if (info->totalsize >= info->buflen)
+    {
+      return;
+    }
+
+  linesize = procfs_snprintf(info->attr->line, LOCKSTAT_LINELEN,
+                             "%-5s %p %p %10" PRIu32 " %10" PRIu32
+                             " %10lu %10lu %10lu %10lu\n",
+                             types[stat->type], stat->lock, stat->caller,
+                             stat->acquires, stat->contended,
+                             lockstat_usec(stat->waitmax),
+                             stat->acquires > 0 ?
+                             lockstat_usec(stat->waittotal /
+                                           stat->acquires) : 0,
+                             lockstat_usec(stat->holdmax),
+                             stat->holds > 0 ?
+                             lockstat_usec(stat->holdtotal /
+                                           stat->holds) : 0);
+  lockstat_emit(info, linesize);
+}
+
+/****************************************************************************
+ * Name: lockstat_read
+ ****************************************************************************/
+
+static ssize_t lockstat_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  struct lockstat_info_s info;
+  size_t linesize;
+  uint32_t dropped;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  info.attr      = (FAR struct lockstat_file_s *)filep->f_priv;
+  info.buffer    = buffer;
+  info.offset    = filep->f_pos;
+  info.buflen    = buflen;
+  info.totalsize = 0;
+
+  DEBUGASSERT(info.attr);
+
+  /* One line per lock and call site, times in microseconds */
+
+  linesize = procfs_snprintf(info.attr->line, LOCKSTAT_LINELEN,
+                             "%-5s %-*s %-*s %10s %10s %10s %10s %10s "
+                             "%10s\n", "TYPE",
+                             (int)sizeof(uintptr_t) * 2 + 2, "LOCK",
+                             (int)sizeof(uintptr_t) * 2 + 2, "CALLER",
+                             "ACQUIRE", "CONTEND", "WAITMAX", "WAITAVG",
+                             "HOLDMAX", "HOLDAVG");
+  if (!lockstat_emit(&info, linesize))
+    {
+      goto out;
+    }
+
+  dropped = lockstat_foreach(lockstat_entry, &info);
+
+  if (dropped > 0 && info.totalsize < info.buflen)
+    {
+      linesize = procfs_snprintf(info.attr->line, LOCKSTAT_LINELEN,
+                                 "Dropped: %" PRIu32 "\n", dropped);
+      lockstat_emit(&info, linesize);
+    }
+
+out:
+  filep->f_pos += info.totalsize;
+  return info.totalsize;
+}
+
+/****************************************************************************
+ * Name: lockstat_write
+ *
+ * Description:
+ *   Any write clears the statistics collected so far.
+ *
+ ****************************************************************************/
+
+static ssize_t lockstat_write(FAR struct file *filep, FAR const char *buffer,
+                              size_t buflen)
+{
+  lockstat_reset();
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: lockstat_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int lockstat_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct lockstat_file_s *oldattr;
+  FAR struct lockstat_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct lockstat_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct lockstat_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct lockstat_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int lockstat_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "lockstat" is the name for a file that may be written to reset it */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_SCHED_LOCKSTAT */
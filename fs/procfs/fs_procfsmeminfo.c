@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -38,6 +39,8 @@
 #include <debug.h>
 #include <ctype.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/pgalloc.h>
 #include <nuttx/progmem.h>
@@ -71,6 +74,23 @@ struct meminfo_file_s
   char line[MEMINFO_LINELEN];     /* Pre-allocated buffer for formatted lines */
 };
 
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+/* This structure is used to emit the lines of /proc/memfrag */
+
+struct memfrag_info_s
+{
+  FAR struct meminfo_file_s *procfile;
+  FAR struct mm_memfrag_s *frag;
+#if CONFIG_MM_BACKTRACE > 0
+  FAR struct mm_memfrag_caller_s *callers;
+#endif
+  FAR char *buffer;
+  off_t offset;
+  size_t buflen;
+  size_t totalsize;
+};
+#endif
+
 #if defined(CONFIG_ARCH_HAVE_PROGMEM) && defined(CONFIG_FS_PROCFS_INCLUDE_PROGMEM)
 struct progmem_info_s
 {
@@ -102,6 +122,12 @@ static ssize_t memdump_read(FAR struct file *filep, FAR char *buffer,
 static ssize_t memdump_write(FAR struct file *filep, FAR const char *buffer,
                              size_t buflen);
 #endif
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+static ssize_t memfrag_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+static ssize_t memfrag_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen);
+#endif
 static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
 static int     meminfo_dup(FAR const struct file *oldp,
@@ -147,6 +173,22 @@ const struct procfs_operations g_memdump_operations =
 };
 #endif
 
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+const struct procfs_operations g_memfrag_operations =
+{
+  meminfo_open,   /* open */
+  meminfo_close,  /* close */
+  memfrag_read,   /* read */
+  memfrag_write,  /* write */
+  meminfo_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  meminfo_stat    /* stat */
+};
+#endif
+
 static FAR struct procfs_meminfo_entry_s *g_procfs_meminfo = NULL;
 
 /****************************************************************************
@@ -521,6 +563,35 @@ static ssize_t memdump_write(FAR struct file *filep, FAR const char *buffer,
     }
 #endif
 
+#ifdef CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE
+  if (strncmp(buffer, "tune", 4) == 0)
+    {
+      FAR char *arg;
+      size_t npools = 0;
+      bool apply = false;
+
+      /* "tune reset" or "tune <npools> [apply]" */
+
+      if (strstr(buffer + 4, "reset") == NULL)
+        {
+          npools = strtoul(buffer + 4, &arg, 0);
+          if (npools == 0)
+            {
+              return -EINVAL;
+            }
+
+          apply = strstr(arg, "apply") != NULL;
+        }
+
+      for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+        {
+          mm_mempool_tune(entry->heap, npools, apply);
+        }
+
+      return buflen;
+    }
+#endif
+
   switch (buffer[0])
     {
       case 'u':
@@ -583,6 +654,281 @@ dump:
 }
 #endif
 
+/****************************************************************************
+ * Name: memfrag_emit
+ *
+ * Description:
+ *   Copy one formatted line to the user buffer.  Returns false once the
+ *   buffer is full.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+static bool memfrag_emit(FAR struct memfrag_info_s *info, size_t linesize)
+{
+  size_t copysize;
+
+  copysize = procfs_memcpy(info->procfile->line, linesize,
+                           info->buffer + info->totalsize,
+                           info->buflen - info->totalsize,
+                           &info->offset);
+
+  info->totalsize += copysize;
+  return info->totalsize < info->buflen;
+}
+
+/****************************************************************************
+ * Name: memfrag_nsec
+ *
+ * Description:
+ *   Convert the upper bound of a latency class to nanoseconds.
+ *
+ ****************************************************************************/
+
+static unsigned long memfrag_nsec(int n)
+{
+  return ((uint64_t)1 << (n + 1)) * NSEC_PER_SEC / up_perf_getfreq();
+}
+
+/****************************************************************************
+ * Name: memfrag_heap
+ *
+ * Description:
+ *   Emit the telemetry of one heap.  Returns false once the buffer is
+ *   full.
+ *
+ ****************************************************************************/
+
+static bool memfrag_heap(FAR struct memfrag_info_s *info,
+                         FAR const struct procfs_meminfo_entry_s *entry)
+{
+  FAR struct mm_memfrag_s *frag = info->frag;
+  FAR char *line = info->procfile->line;
+  size_t permille = 0;
+#if CONFIG_MM_BACKTRACE > 0
+  struct mm_memfrag_caller_s tmp;
+  size_t ncallers;
+  size_t linesize;
+  size_t j;
+#endif
+  size_t i;
+
+  mm_memfrag(entry->heap, frag);
+
+  /* The share of the free memory that is not in the largest free chunk */
+
+  if (frag->totalfree > 0)
+    {
+      permille = (frag->totalfree - frag->largest) * 1000 /
+                 frag->totalfree;
+    }
+
+  if (!memfrag_emit(info, procfs_snprintf(line, MEMINFO_LINELEN,
+                    "%s:\n  Fragmentation: %zu.%zu%% "
+                    "(free %zu, largest %zu)\n"
+                    "  %-14s%11s%11s\n", entry->name,
+                    permille / 10, permille % 10, frag->totalfree,
+                    frag->largest, "Free chunks", "count", "bytes")))
+    {
+      return false;
+    }
+
+  for (i = 0; i < MM_MEMFRAG_NCLASSES; i++)
+    {
+      if (frag->freecount[i] == 0)
+        {
+          continue;
+        }
+
+      if (!memfrag_emit(info, procfs_snprintf(line, MEMINFO_LINELEN,
+                        "  >= %-10lu%11zu%11zu\n", 1ul << i,
+                        frag->freecount[i], frag->freebytes[i])))
+        {
+          return false;
+        }
+    }
+
+  if (!memfrag_emit(info, procfs_snprintf(line, MEMINFO_LINELEN,
+                    "  %-14s%11s%11s\n", "Latency (ns)", "malloc",
+                    "free")))
+    {
+      return false;
+    }
+
+  for (i = 0; i < MM_MEMFRAG_NCLASSES; i++)
+    {
+      if (frag->alloclat[i] == 0 && frag->freelat[i] == 0)
+        {
+          continue;
+        }
+
+      if (!memfrag_emit(info, procfs_snprintf(line, MEMINFO_LINELEN,
+                        "  < %-11lu%11" PRIu32 "%11" PRIu32 "\n",
+                        memfrag_nsec(i), frag->alloclat[i],
+                        frag->freelat[i])))
+        {
+          return false;
+        }
+    }
+
+  if (!memfrag_emit(info, procfs_snprintf(line, MEMINFO_LINELEN,
+                    "  %-14s%11lu%11lu\n", "max",
+                    (unsigned long)((uint64_t)frag->allocmax *
+                                    NSEC_PER_SEC / up_perf_getfreq()),
+                    (unsigned long)((uint64_t)frag->freemax *
+                                    NSEC_PER_SEC / up_perf_getfreq()))))
+    {
+      return false;
+    }
+
+#if CONFIG_MM_BACKTRACE > 0
+  /* The call sites holding the most memory first */
+
+  ncallers = mm_memfrag_callers(entry->heap, info->callers,
+                                CONFIG_MM_HEAP_TELEMETRY_NCALLERS + 1);
+  for (i = 0; i < ncallers; i++)
+    {
+      for (j = i + 1; j < ncallers; j++)
+        {
+          if (info->callers[j].bytes > info->callers[i].bytes)
+            {
+              tmp = info->callers[i];
+              info->callers[i] = info->callers[j];
+              info->callers[j] = tmp;
+            }
+        }
+    }
+
+  if (!memfrag_emit(info, procfs_snprintf(line, MEMINFO_LINELEN,
+                    "  %-*s%11s%11s\n", (int)sizeof(uintptr_t) * 2 + 2,
+                    "Callers", "count", "bytes")))
+    {
+      return false;
+    }
+
+  for (i = 0; i < ncallers; i++)
+    {
+      if (info->callers[i].count == 0)
+        {
+          continue;
+        }
+
+      if (info->callers[i].caller != NULL)
+        {
+          linesize = procfs_snprintf(line, MEMINFO_LINELEN,
+                                     "  %-*p%11zu%11zu\n",
+                                     (int)sizeof(uintptr_t) * 2 + 2,
+                                     info->callers[i].caller,
+                                     info->callers[i].count,
+                                     info->callers[i].bytes);
+        }
+      else
+        {
+          linesize = procfs_snprintf(line, MEMINFO_LINELEN,
+                                     "  %-*s%11zu%11zu\n",
+                                     (int)sizeof(uintptr_t) * 2 + 2,
+                                     "other", info->callers[i].count,
+                                     info->callers[i].bytes);
+        }
+
+      if (!memfrag_emit(info, linesize))
+        {
+          return false;
+        }
+    }
+#endif
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: memfrag_read
+ ****************************************************************************/
+
+static ssize_t memfrag_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR const struct procfs_meminfo_entry_s *entry;
+  struct memfrag_info_s info;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  info.procfile  = (FAR struct meminfo_file_s *)filep->f_priv;
+  info.buffer    = buffer;
+  info.offset    = filep->f_pos;
+  info.buflen    = buflen;
+  info.totalsize = 0;
+
+  DEBUGASSERT(info.procfile);
+
+  /* The snapshots are too large for the stack */
+
+  info.frag = kmm_malloc(sizeof(struct mm_memfrag_s));
+  if (info.frag == NULL)
+    {
+      return -ENOMEM;
+    }
+
+#if CONFIG_MM_BACKTRACE > 0
+  info.callers = kmm_malloc((CONFIG_MM_HEAP_TELEMETRY_NCALLERS + 1) *
+                            sizeof(struct mm_memfrag_caller_s));
+  if (info.callers == NULL)
+    {
+      kmm_free(info.frag);
+      return -ENOMEM;
+    }
+#endif
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      if (!memfrag_heap(&info, entry))
+        {
+          break;
+        }
+    }
+
+#if CONFIG_MM_BACKTRACE > 0
+  kmm_free(info.callers);
+#endif
+  kmm_free(info.frag);
+
+  filep->f_pos += info.totalsize;
+  return info.totalsize;
+}
+
+/****************************************************************************
+ * Name: memfrag_write
+ *
+ * Description:
+ *   Writing "reset" clears the latency histograms of all heaps.
+ *
+ ****************************************************************************/
+
+static ssize_t memfrag_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  FAR struct procfs_meminfo_entry_s *entry;
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+
+  if (strncmp(buffer, "reset", 5) != 0)
+    {
+      return -EINVAL;
+    }
+
+  for (entry = g_procfs_meminfo; entry != NULL; entry = entry->next)
+    {
+      mm_memfrag_reset(entry->heap);
+    }
+
+  return buflen;
+}
+#endif /* CONFIG_MM_HEAP_TELEMETRY */
+
 /****************************************************************************
  * Name: meminfo_dup
  *
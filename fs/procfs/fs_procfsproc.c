@@ -90,6 +90,9 @@ enum proc_node_e
 #ifdef CONFIG_SCHED_CRITMONITOR
   PROC_CRITMON,                       /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_STATS
+  PROC_SCHEDSTAT,                     /* Thread scheduling statistics */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   PROC_HEAP,                          /* Task heap info */
 #endif
@@ -181,6 +184,11 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#ifdef CONFIG_SCHED_STATS
+static ssize_t proc_schedstat(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
 static ssize_t proc_heap(FAR struct proc_file_s *procfile,
                          FAR struct tcb_s *tcb, FAR char *buffer,
@@ -292,6 +300,13 @@ static const struct proc_node_s g_critmon =
 };
 #endif
 
+#ifdef CONFIG_SCHED_STATS
+static const struct proc_node_s g_schedstat =
+{
+  "schedstat",  "schedstat", (uint8_t)PROC_SCHEDSTAT,    DTYPE_FILE        /* Thread scheduling statistics */
+};
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static const struct proc_node_s g_heap =
 {
@@ -346,6 +361,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section Monitor */
 #endif
+#ifdef CONFIG_SCHED_STATS
+  &g_schedstat,    /* Thread scheduling statistics */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -375,6 +393,9 @@ static const struct proc_node_s * const g_level0info[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_STATS
+  &g_schedstat,    /* Thread scheduling statistics */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -460,6 +481,7 @@ static FAR const struct proc_node_s *proc_findnode(FAR const char *relpath)
  *   Priority:   nnn                Decimal, 0-255
  *   Scheduler:  xxxxxxxxxxxxxx     {SCHED_FIFO, SCHED_RR, SCHED_SPORADIC}
  *   Sigmask:    nnnnnnnn           Hexadecimal, 32-bit
+ *   FPUSaves:   nnnnnnnn           Decimal (CONFIG_ARCH_LAZYFPU only)
  *
  ****************************************************************************/
 
@@ -644,6 +666,27 @@ static ssize_t proc_status(FAR struct proc_file_s *procfile,
                            &offset);
 
   totalsize += copysize;
+
+#ifdef CONFIG_ARCH_LAZYFPU
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show how often the FPU state of the thread had to be saved */
+
+  linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                               "%-12s%" PRIu32 "\n", "FPUSaves:",
+                               tcb->fpu_saves);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                             &offset);
+
+  totalsize += copysize;
+#endif
+
   return totalsize;
 }
 
@@ -872,6 +915,101 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_schedstat
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_STATS
+static ssize_t proc_schedstat(FAR struct proc_file_s *procfile,
+                              FAR struct tcb_s *tcb, FAR char *buffer,
+                              size_t buflen, off_t offset)
+{
+  unsigned long freq = up_perf_getfreq();
+  uint64_t runtime;
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  int i;
+
+  remaining = buflen;
+  totalsize = 0;
+
+  /* Show the total run time */
+
+  runtime    = tcb->stat_runtime;
+  linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                               "%-12s%" PRIu64 ".%09" PRIu64 "\n",
+                               "RunTime:", runtime / freq,
+                               runtime % freq * NSEC_PER_SEC / freq);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                             &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the number of wakeups and switches */
+
+  linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                               "%-12s%" PRIu32 "\n%-12s%" PRIu32 "\n"
+                               "%-12s%" PRIu32 "\n",
+                               "Wakeups:", tcb->stat_wakeups,
+                               "Voluntary:", tcb->stat_voluntary,
+                               "Preempted:", tcb->stat_involuntary);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                             &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  if (totalsize >= buflen)
+    {
+      return totalsize;
+    }
+
+  /* Show the maximum wakeup latency */
+
+  linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                               "%-12s%" PRIu32 " us\n", "LatMax:",
+                               tcb->stat_latmax);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                             &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  /* Show the wakeup latency histogram, see /proc/schedlat */
+
+  for (i = 0; i < CONFIG_SCHED_STATS_NHIST && totalsize < buflen; i++)
+    {
+      linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                                   "%s%10" PRIu32 " us: %10" PRIu32 "\n",
+                                   i < CONFIG_SCHED_STATS_NHIST - 1 ?
+                                   "< " : ">=",
+                                   i < CONFIG_SCHED_STATS_NHIST - 1 ?
+                                   (uint32_t)1 << i :
+                                   (uint32_t)1 << (i - 1),
+                                   tcb->stat_lathist[i]);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                 remaining, &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+    }
+
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_heap
  ****************************************************************************/
@@ -1531,6 +1669,11 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_critmon(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 #endif
+#ifdef CONFIG_SCHED_STATS
+    case PROC_SCHEDSTAT: /* Thread scheduling statistics */
+      ret = proc_schedstat(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
     case PROC_HEAP: /* Task heap info */
       ret = proc_heap(procfile, tcb, buffer, buflen, filep->f_pos);
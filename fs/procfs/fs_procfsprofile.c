@@ -0,0 +1,417 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsprofile.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/profile.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_PROFILE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#if CONFIG_SCHED_PROFILE_BTDEPTH > 0
+#  define PROFILE_LINELEN (128 + 20 * CONFIG_SCHED_PROFILE_BTDEPTH)
+#else
+#  define PROFILE_LINELEN 128
+#endif
+
+/* The heading of the samples.  With SCHED_PERFCOUNT each sample ends with
+ * the events counted on its CPU since the previous sample.
+ */
+
+#ifdef CONFIG_SCHED_PERFCOUNT
+#  define PROFILE_SAMPLE_HDR "PC [CALLERS] e=CYCLES,INSNS,L1DMISS,BRMISS"
+#else
+#  define PROFILE_SAMPLE_HDR "PC [CALLERS]"
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct profile_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  char line[PROFILE_LINELEN];   /* Pre-allocated buffer for formatted lines */
+};
+
+/* This structure is used to emit the lines of the profile */
+
+struct profile_info_s
+{
+  FAR struct profile_file_s *attr;
+  FAR char *buffer;
+  off_t offset;
+  size_t buflen;
+  size_t totalsize;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     profile_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     profile_close(FAR struct file *filep);
+static ssize_t profile_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t profile_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static int     profile_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     profile_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_profile_operations =
+{
+  profile_open,      /* open */
+  profile_close,     /* close */
+  profile_read,      /* read */
+  profile_write,     /* write */
+
+  profile_dup,       /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  profile_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: profile_open
+ ****************************************************************************/
+
+static int profile_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct profile_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct profile_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: profile_close
+ ****************************************************************************/
+
+static int profile_close(FAR struct file *filep)
+{
+  FAR struct profile_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct profile_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: profile_emit
+ *
+ * Description:
+ *   Copy one formatted line to the user buffer, honoring the file offset.
+ *   Returns false once the user buffer is full.
+ *
+ ****************************************************************************/
+
+static bool profile_emit(FAR struct profile_info_s *info, size_t linesize)
+{
+  size_t copysize;
+
+  copysize = procfs_memcpy(info->attr->line, linesize,
+                           info->buffer + info->totalsize,
+                           info->buflen - info->totalsize,
+                           &info->offset);
+
+  info->totalsize += copysize;
+  return info->totalsize < info->buflen;
+}
+
+/****************************************************************************
+ * Name: profile_hotentry
+ *
+ * Description:
+ *   profile_foreach_hot() callback emitting one line per program counter.
+ *
+ ****************************************************************************/
+
+static void profile_hotentry(FAR const struct profile_hot_s *hot,
+                             FAR void *arg)
+{
+  FAR struct profile_info_s *info = arg;
+  size_t linesize;
+
+  if (info->totalsize >= info->buflen)
+    {
+      return;
+    }
+
+#ifdef CONFIG_ALLSYMS
+  linesize = procfs_snprintf(info->attr->line, PROFILE_LINELEN,
+                             "%10" PRIu32 " %p %pS\n", hot->count,
+                             (FAR void *)hot->pc, (FAR void *)hot->pc);
+#else
+  linesize = procfs_snprintf(info->attr->line, PROFILE_LINELEN,
+                             "%10" PRIu32 " %p\n", hot->count,
+                             (FAR void *)hot->pc);
+#endif
+  profile_emit(info, linesize);
+}
+
+/****************************************************************************
+ * Name: profile_sampleentry
+ *
+ * Description:
+ *   profile_foreach_sample() callback emitting one line per recent sample,
+ *   the program counter followed by its callers.
+ *
+ ****************************************************************************/
+
+static void profile_sampleentry(int cpu,
+                                FAR const struct profile_sample_s *sample,
+                                FAR void *arg)
+{
+  FAR struct profile_info_s *info = arg;
+  size_t linesize;
+#if CONFIG_SCHED_PROFILE_BTDEPTH > 0
+  int i;
+#endif
+
+  if (info->totalsize >= info->buflen)
+    {
+      return;
+    }
+
+  linesize = procfs_snprintf(info->attr->line, PROFILE_LINELEN,
+                             "%3d %5d %p", cpu, (int)sample->pid,
+                             (FAR void *)sample->pc);
+
+#if CONFIG_SCHED_PROFILE_BTDEPTH > 0
+  for (i = 0; i < sample->depth; i++)
+    {
+      linesize += procfs_snprintf(info->attr->line + linesize,
+                                  PROFILE_LINELEN - linesize,
+                                  " %p", sample->bt[i]);
+    }
+#endif
+
+#ifdef CONFIG_SCHED_PERFCOUNT
+  linesize += procfs_snprintf(info->attr->line + linesize,
+                              PROFILE_LINELEN - linesize,
+                              " e=%" PRIu32 ",%" PRIu32 ",%" PRIu32
+                              ",%" PRIu32,
+                              sample->events[PERFCOUNT_CYCLES],
+                              sample->events[PERFCOUNT_INSTRUCTIONS],
+                              sample->events[PERFCOUNT_CACHE_MISSES],
+                              sample->events[PERFCOUNT_BRANCH_MISSES]);
+#endif
+
+  linesize += procfs_snprintf(info->attr->line + linesize,
+                              PROFILE_LINELEN - linesize, "\n");
+  profile_emit(info, linesize);
+}
+
+/****************************************************************************
+ * Name: profile_read
+ ****************************************************************************/
+
+static ssize_t profile_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  struct profile_info_s info;
+  size_t linesize;
+  uint32_t total;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  info.attr      = (FAR struct profile_file_s *)filep->f_priv;
+  info.buffer    = buffer;
+  info.offset    = filep->f_pos;
+  info.buflen    = buflen;
+  info.totalsize = 0;
+
+  DEBUGASSERT(info.attr);
+
+  /* The sample count of each program counter, unsorted */
+
+  linesize = procfs_snprintf(info.attr->line, PROFILE_LINELEN,
+                             "%10s %s\n", "COUNT", "PC");
+  if (!profile_emit(&info, linesize))
+    {
+      goto out;
+    }
+
+  total = profile_foreach_hot(profile_hotentry, &info);
+  if (info.totalsize >= info.buflen)
+    {
+      goto out;
+    }
+
+  linesize = procfs_snprintf(info.attr->line, PROFILE_LINELEN,
+                             "Total: %" PRIu32 "\n\n%3s %5s %s\n",
+                             total, "CPU", "PID", PROFILE_SAMPLE_HDR);
+  if (!profile_emit(&info, linesize))
+    {
+      goto out;
+    }
+
+  profile_foreach_sample(profile_sampleentry, &info);
+
+out:
+  filep->f_pos += info.totalsize;
+  return info.totalsize;
+}
+
+/****************************************************************************
+ * Name: profile_write
+ *
+ * Description:
+ *   Any write discards the samples taken so far.
+ *
+ ****************************************************************************/
+
+static ssize_t profile_write(FAR struct file *filep, FAR const char *buffer,
+                              size_t buflen)
+{
+  profile_reset();
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: profile_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int profile_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct profile_file_s *oldattr;
+  FAR struct profile_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct profile_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct profile_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct profile_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: profile_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int profile_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "profile" is the name for a file that may be written to reset it */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_SCHED_PROFILE */
@@ -0,0 +1,355 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsschedlat.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/sched.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_STATS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define SCHEDLAT_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct schedlat_file_s
+{
+  struct procfs_file_s base;    /* Base open file structure */
+  char line[SCHEDLAT_LINELEN];  /* Pre-allocated buffer for formatted lines */
+};
+
+/* This structure is used to emit one line per thread with nxsched_foreach */
+
+struct schedlat_info_s
+{
+  FAR struct schedlat_file_s *attr;
+  FAR char *buffer;
+  off_t offset;
+  size_t buflen;
+  size_t totalsize;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     schedlat_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     schedlat_close(FAR struct file *filep);
+static ssize_t schedlat_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     schedlat_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     schedlat_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_schedlat_operations =
+{
+  schedlat_open,      /* open */
+  schedlat_close,     /* close */
+  schedlat_read,      /* read */
+  NULL,               /* write */
+
+  schedlat_dup,       /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  schedlat_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: schedlat_open
+ ****************************************************************************/
+
+static int schedlat_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct schedlat_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = kmm_zalloc(sizeof(struct schedlat_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: schedlat_close
+ ****************************************************************************/
+
+static int schedlat_close(FAR struct file *filep)
+{
+  FAR struct schedlat_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct schedlat_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  kmm_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: schedlat_emit
+ *
+ * Description:
+ *   Copy one formatted line to the user buffer, honoring the file offset.
+ *   Returns false once the user buffer is full.
+ *
+ ****************************************************************************/
+
+static bool schedlat_emit(FAR struct schedlat_info_s *info, size_t linesize)
+{
+  size_t copysize;
+
+  copysize = procfs_memcpy(info->attr->line, linesize,
+                           info->buffer + info->totalsize,
+                           info->buflen - info->totalsize,
+                           &info->offset);
+
+  info->totalsize += copysize;
+  return info->totalsize < info->buflen;
+}
+
+/****************************************************************************
+ * Name: schedlat_thread
+ *
+ * Description:
+ *   nxsched_foreach() callback emitting one line per thread that has been
+ *   woken up at least once.
+ *
+ ****************************************************************************/
+
+static void schedlat_thread(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  FAR struct schedlat_info_s *info = arg;
+  size_t linesize;
+
+  if (tcb->stat_wakeups == 0 || info->totalsize >= info->buflen)
+    {
+      return;
+    }
+
+  linesize = procfs_snprintf(info->attr->line, SCHEDLAT_LINELEN,
+                             "%5d %3d %10" PRIu32 " %10" PRIu32
+                             " %10" PRIu32 "\n",
+                             tcb->pid, tcb->sched_priority,
+                             tcb->stat_wakeups, tcb->stat_latmax,
+                             tcb->stat_involuntary);
+  schedlat_emit(info, linesize);
+}
+
+/****************************************************************************
+ * Name: schedlat_read
+ ****************************************************************************/
+
+static ssize_t schedlat_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  struct schedlat_info_s info;
+  size_t linesize;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  info.attr      = (FAR struct schedlat_file_s *)filep->f_priv;
+  info.buffer    = buffer;
+  info.offset    = filep->f_pos;
+  info.buflen    = buflen;
+  info.totalsize = 0;
+
+  DEBUGASSERT(info.attr);
+
+  /* The system-wide wakeup latency histogram.  Bucket 0 holds latencies
+   * below 1 usec and bucket n those of at least 2^(n-1) usec.
+   */
+
+  linesize = procfs_snprintf(info.attr->line, SCHEDLAT_LINELEN,
+                             "%-12s%" PRIu32 " us\n", "Max:",
+                             g_schedlat_max);
+  if (!schedlat_emit(&info, linesize))
+    {
+      goto out;
+    }
+
+  for (i = 0; i < CONFIG_SCHED_STATS_NHIST; i++)
+    {
+      linesize = procfs_snprintf(info.attr->line, SCHEDLAT_LINELEN,
+                                 "%s%10" PRIu32 " us: %10" PRIu32 "\n",
+                                 i < CONFIG_SCHED_STATS_NHIST - 1 ?
+                                 "< " : ">=",
+                                 i < CONFIG_SCHED_STATS_NHIST - 1 ?
+                                 (uint32_t)1 << i :
+                                 (uint32_t)1 << (i - 1),
+                                 g_schedlat_hist[i]);
+      if (!schedlat_emit(&info, linesize))
+        {
+          goto out;
+        }
+    }
+
+  /* Then one line per thread, to spot the victims of priority inversion */
+
+  linesize = procfs_snprintf(info.attr->line, SCHEDLAT_LINELEN,
+                             "%5s %3s %10s %10s %10s\n", "PID", "PRI",
+                             "WAKEUPS", "MAX(us)", "PREEMPTED");
+  if (!schedlat_emit(&info, linesize))
+    {
+      goto out;
+    }
+
+  nxsched_foreach(schedlat_thread, &info);
+
+out:
+  filep->f_pos += info.totalsize;
+  return info.totalsize;
+}
+
+/****************************************************************************
+ * Name: schedlat_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int schedlat_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct schedlat_file_s *oldattr;
+  FAR struct schedlat_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct schedlat_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = kmm_malloc(sizeof(struct schedlat_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct schedlat_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: schedlat_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int schedlat_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "schedlat" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_SCHED_STATS */
@@ -0,0 +1,259 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsseq.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/procfs.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: procfs_seq_copy
+ *
+ * Description:
+ *   Return the pending bytes of the current record, skipping the first
+ *   '*skip' bytes of the text.
+ *
+ ****************************************************************************/
+
+static size_t procfs_seq_copy(FAR struct procfs_seq_s *seq,
+                              FAR char *buffer, size_t buflen,
+                              FAR off_t *skip)
+{
+  size_t copysize;
+
+  copysize = MIN(seq->count - seq->from, *skip);
+  seq->from += copysize;
+  *skip     -= copysize;
+
+  copysize = MIN(seq->count - seq->from, buflen);
+  memcpy(buffer, seq->buf + seq->from, copysize);
+  seq->from += copysize;
+  return copysize;
+}
+
+/****************************************************************************
+ * Name: procfs_seq_grow
+ *
+ * Description:
+ *   Replace the record buffer by one twice as large.
+ *
+ ****************************************************************************/
+
+static int procfs_seq_grow(FAR struct procfs_seq_s *seq)
+{
+  size_t size = seq->size > 0 ? 2 * seq->size : CONFIG_FS_PROCFS_SEQ_BUFSIZE;
+  FAR char *buf;
+
+  buf = kmm_malloc(size);
+  if (buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  kmm_free(seq->buf);
+  seq->buf  = buf;
+  seq->size = size;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: procfs_seq_open
+ ****************************************************************************/
+
+void procfs_seq_open(FAR struct procfs_seq_s *seq,
+                     FAR const struct procfs_seq_operations_s *ops,
+                     FAR void *priv)
+{
+  memset(seq, 0, sizeof(struct procfs_seq_s));
+  seq->ops  = ops;
+  seq->priv = priv;
+}
+
+/****************************************************************************
+ * Name: procfs_seq_close
+ ****************************************************************************/
+
+void procfs_seq_close(FAR struct procfs_seq_s *seq)
+{
+  kmm_free(seq->buf);
+  seq->buf  = NULL;
+  seq->size = 0;
+}
+
+/****************************************************************************
+ * Name: procfs_seq_dup
+ ****************************************************************************/
+
+int procfs_seq_dup(FAR struct procfs_seq_s *newseq,
+                   FAR const struct procfs_seq_s *oldseq)
+{
+  memcpy(newseq, oldseq, sizeof(struct procfs_seq_s));
+  if (oldseq->buf != NULL)
+    {
+      newseq->buf = kmm_malloc(oldseq->size);
+      if (newseq->buf == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      memcpy(newseq->buf, oldseq->buf, oldseq->count);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: procfs_seq_read
+ ****************************************************************************/
+
+ssize_t procfs_seq_read(FAR struct procfs_seq_s *seq,
+                        FAR struct file *filep,
+                        FAR char *buffer, size_t buflen)
+{
+  FAR const struct procfs_seq_operations_s *ops = seq->ops;
+  FAR void *elem;
+  size_t copied = 0;
+  size_t copysize;
+  off_t skip = 0;
+  int ret = OK;
+
+  /* A seek invalidates the cursor: start again from the first record and
+   * skip up to the new position.
+   */
+
+  if (filep->f_pos != seq->pos)
+    {
+      seq->count = 0;
+      seq->from  = 0;
+      seq->index = 0;
+      skip       = filep->f_pos;
+    }
+
+  /* Return what is left of the current record */
+
+  copysize = procfs_seq_copy(seq, buffer, buflen, &skip);
+  copied  += copysize;
+
+  if (copied < buflen)
+    {
+      elem = ops->start(seq, seq->index);
+      while (elem != NULL && copied < buflen)
+        {
+          if (seq->buf == NULL)
+            {
+              ret = procfs_seq_grow(seq);
+              if (ret < 0)
+                {
+                  break;
+                }
+            }
+
+          seq->count    = 0;
+          seq->from     = 0;
+          seq->overflow = false;
+
+          ret = ops->show(seq, elem);
+          if (ret < 0)
+            {
+              seq->count = 0;
+              break;
+            }
+
+          if (seq->overflow)
+            {
+              /* Format the same record again into a larger buffer */
+
+              seq->count = 0;
+              ret = procfs_seq_grow(seq);
+              if (ret < 0)
+                {
+                  break;
+                }
+
+              continue;
+            }
+
+          seq->index++;
+          elem = ops->next(seq, elem, seq->index);
+
+          copysize = procfs_seq_copy(seq, buffer + copied, buflen - copied,
+                                     &skip);
+          copied  += copysize;
+        }
+
+      if (ops->stop != NULL)
+        {
+          ops->stop(seq, elem);
+        }
+    }
+
+  filep->f_pos += copied;
+  seq->pos      = filep->f_pos;
+  return copied > 0 ? (ssize_t)copied : ret;
+}
+
+/****************************************************************************
+ * Name: procfs_seq_printf
+ ****************************************************************************/
+
+void procfs_seq_printf(FAR struct procfs_seq_s *seq,
+                       FAR const IPTR char *format, ...)
+{
+  size_t avail = seq->size - seq->count;
+  va_list ap;
+  int len;
+
+  if (seq->overflow)
+    {
+      return;
+    }
+
+  va_start(ap, format);
+  len = vsnprintf(seq->buf + seq->count, avail, format, ap);
+  va_end(ap);
+
+  if (len < 0 || (size_t)len >= avail)
+    {
+      seq->overflow = true;
+    }
+  else
+    {
+      seq->count += len;
+    }
+}
@@ -411,6 +411,17 @@ static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
       buflen = bytesleft;
     }
 
+  /* If the volume is mapped into memory, copy straight from it */
+
+  if (rm->rm_xipbase)
+    {
+      memcpy(userbuffer, rm->rm_xipbase + rf->rf_startoffset +
+             filep->f_pos, buflen);
+      filep->f_pos += buflen;
+      readsize      = buflen;
+      buflen        = 0;
+    }
+
   /* Loop until either (1) all data has been transferred, or (2) an
    * error occurs.
    */
@@ -582,6 +593,7 @@ errout_with_lock:
 
 static int romfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
+  FAR struct romfs_mountpt_s *rm;
   FAR struct romfs_file_s *rf;
 
   finfo("cmd: %d arg: %08lx\n", cmd, arg);
@@ -593,8 +605,7 @@ static int romfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   /* Recover our private data from the struct file instance */
 
   rf = filep->f_priv;
-
-  /* Only one ioctl command is supported */
+  rm = filep->f_inode->i_private;
 
   if (cmd == FIOC_FILEPATH)
     {
@@ -603,6 +614,22 @@ static int romfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       strlcat(ptr, rf->rf_path, PATH_MAX);
       return OK;
     }
+  else if (cmd == FIOC_XIPBASE)
+    {
+      FAR void **ppv = (FAR void **)((uintptr_t)arg);
+
+      /* The file data can be executed or read in place only if the whole
+       * volume is mapped into memory.
+       */
+
+      if (ppv == NULL || rm->rm_xipbase == NULL)
+        {
+          return rm->rm_xipbase == NULL ? -ENOTTY : -EINVAL;
+        }
+
+      *ppv = rm->rm_xipbase + rf->rf_startoffset;
+      return OK;
+    }
 
   return -ENOTTY;
 }
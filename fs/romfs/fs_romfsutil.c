@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <sys/param.h>
 
 #include <inttypes.h>
 #include <stdlib.h>
@@ -48,6 +49,7 @@
 #define LINK_NOT_FOLLOWED 0
 #define LINK_FOLLOWED     1
 #define NODEINFO_NINCR    4
+#define ENTRY_PAST        1 /* romfs_checkentry(): Sorts after the name */
 
 /****************************************************************************
  * Private Types
@@ -105,6 +107,7 @@ static inline int romfs_checkentry(FAR struct romfs_mountpt_s *rm,
   uint32_t next;
   uint32_t info;
   uint32_t size;
+  size_t namelen;
   int ret;
 
   /* Parse the directory entry at this offset (which may be re-directed
@@ -130,7 +133,8 @@ static inline int romfs_checkentry(FAR struct romfs_mountpt_s *rm,
    * on entryname (there is a terminator on name, however)
    */
 
-  if (strlen(name) == entrylen &&
+  namelen = strlen(name);
+  if (namelen == entrylen &&
       memcmp(entryname, name, entrylen) == 0)
     {
       /* Found it -- save the component info and return success */
@@ -150,6 +154,22 @@ static inline int romfs_checkentry(FAR struct romfs_mountpt_s *rm,
       return OK;
     }
 
+#ifdef CONFIG_FS_ROMFS_SORTED_DIRS
+  /* In a sorted directory no later entry can match once this one sorts
+   * after the name.  "." and ".." always come first and are not part of
+   * the order.
+   */
+
+  if (strcmp(name, ".") != 0 && strcmp(name, "..") != 0)
+    {
+      ret = memcmp(entryname, name, MIN(namelen, entrylen));
+      if (ret < 0 || (ret == 0 && entrylen < namelen))
+        {
+          return ENTRY_PAST;
+        }
+    }
+#endif
+
   /* The entry is not a directory or it does not have the matching name */
 
   return -ENOENT;
@@ -303,6 +323,7 @@ static int romfs_nodeinfo_search(FAR const void *a, FAR const void *b)
   return ret;
 }
 
+#ifndef CONFIG_FS_ROMFS_SORTED_DIRS
 static int romfs_nodeinfo_compare(FAR const void *a, FAR const void *b)
 {
   FAR struct romfs_nodeinfo_s *nodeinfo = *(FAR struct romfs_nodeinfo_s **)a;
@@ -313,6 +334,7 @@ static int romfs_nodeinfo_compare(FAR const void *a, FAR const void *b)
   return romfs_nodeinfo_search(&entry, b);
 }
 #endif
+#endif
 
 /****************************************************************************
  * Name: romfs_searchdir
@@ -382,6 +404,10 @@ static inline int romfs_searchdir(FAR struct romfs_mountpt_s *rm,
 
           return OK;
         }
+      else if (ret == ENTRY_PAST)
+        {
+          break;
+        }
 
       /* No match... select the offset to the next entry */
 
@@ -495,11 +521,13 @@ static int romfs_cachenode(FAR struct romfs_mountpt_s *rm,
     }
   while (next != 0);
 
+#ifndef CONFIG_FS_ROMFS_SORTED_DIRS
   if (nodeinfo->rn_count > 1)
     {
       qsort(nodeinfo->rn_child, nodeinfo->rn_count,
             sizeof(*nodeinfo->rn_child), romfs_nodeinfo_compare);
     }
+#endif
 
   return 0;
 }
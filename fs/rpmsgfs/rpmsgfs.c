@@ -36,6 +36,7 @@
 #include <debug.h>
 #include <limits.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/lib/lib.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -49,6 +50,10 @@
 
 #define RPMSGFS_RETRY_DELAY_MS       10
 
+#ifdef CONFIG_FS_RPMSGFS_ATTRCACHE
+#  define RPMSGFS_NATTRCACHE         CONFIG_FS_RPMSGFS_ATTRCACHE_NENTRIES
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -57,7 +62,21 @@ struct rpmsgfs_dir_s
 {
   struct fs_dirent_s base;
   FAR void *dir;
+  int next;                              /* Next entry in entries */
+  int count;                             /* Number of entries read */
+  struct dirent entries[CONFIG_FS_RPMSGFS_READDIR_NENTRIES];
+};
+
+/* One entry of the attribute cache, an entry with an empty path is unused */
+
+#ifdef CONFIG_FS_RPMSGFS_ATTRCACHE
+struct rpmsgfs_attrcache_s
+{
+  clock_t                    ac_time;  /* Time of the stat() */
+  struct stat                ac_buf;   /* Attributes of the path */
+  char                       ac_path[CONFIG_FS_RPMSGFS_ATTRCACHE_PATHLEN];
 };
+#endif
 
 /* This structure describes the state of one open file.  This structure
  * is protected by the volume semaphore.
@@ -83,6 +102,10 @@ struct rpmsgfs_mountpt_s
   char                       fs_root[PATH_MAX];
   void                       *handle;
   int                        timeout;  /* Connect timeout */
+#ifdef CONFIG_FS_RPMSGFS_ATTRCACHE
+  uint8_t                    fs_attrnext; /* Next entry to replace */
+  struct rpmsgfs_attrcache_s fs_attrcache[RPMSGFS_NATTRCACHE];
+#endif
 };
 
 /****************************************************************************
@@ -265,6 +288,92 @@ static void rpmsgfs_mkpath(FAR struct rpmsgfs_mountpt_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: rpmsgfs_attrcache_find
+ *
+ * Description: Return the unexpired cached attributes of relpath, or NULL.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_RPMSGFS_ATTRCACHE
+static FAR struct rpmsgfs_attrcache_s *
+rpmsgfs_attrcache_find(FAR struct rpmsgfs_mountpt_s *fs,
+                       FAR const char *relpath)
+{
+  FAR struct rpmsgfs_attrcache_s *ac;
+  clock_t now = clock_systime_ticks();
+  int i;
+
+  for (i = 0; i < RPMSGFS_NATTRCACHE; i++)
+    {
+      ac = &fs->fs_attrcache[i];
+      if (ac->ac_path[0] != '\0' && strcmp(ac->ac_path, relpath) == 0)
+        {
+          if (now - ac->ac_time <
+              MSEC2TICK(CONFIG_FS_RPMSGFS_ATTRCACHE_TIMEOUT))
+            {
+              return ac;
+            }
+
+          ac->ac_path[0] = '\0';
+          break;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_attrcache_add
+ *
+ * Description: Remember the attributes of relpath, replacing the entries in
+ *   round robin order.
+ *
+ ****************************************************************************/
+
+static void rpmsgfs_attrcache_add(FAR struct rpmsgfs_mountpt_s *fs,
+                                  FAR const char *relpath,
+                                  FAR const struct stat *buf)
+{
+  FAR struct rpmsgfs_attrcache_s *ac;
+
+  if (relpath[0] == '\0' ||
+      strlen(relpath) >= CONFIG_FS_RPMSGFS_ATTRCACHE_PATHLEN)
+    {
+      return;
+    }
+
+  ac = &fs->fs_attrcache[fs->fs_attrnext];
+  if (++fs->fs_attrnext >= RPMSGFS_NATTRCACHE)
+    {
+      fs->fs_attrnext = 0;
+    }
+
+  ac->ac_time = clock_systime_ticks();
+  memcpy(&ac->ac_buf, buf, sizeof(struct stat));
+  strlcpy(ac->ac_path, relpath, sizeof(ac->ac_path));
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_attrcache_invalidate
+ *
+ * Description: Forget all cached attributes after a change.
+ *
+ ****************************************************************************/
+
+static void rpmsgfs_attrcache_invalidate(FAR struct rpmsgfs_mountpt_s *fs)
+{
+  int i;
+
+  for (i = 0; i < RPMSGFS_NATTRCACHE; i++)
+    {
+      fs->fs_attrcache[i].ac_path[0] = '\0';
+    }
+}
+#else
+#  define rpmsgfs_attrcache_invalidate(fs)
+#endif
+
 /****************************************************************************
  * Name: rpmsgfs_open
  ****************************************************************************/
@@ -314,6 +423,11 @@ static int rpmsgfs_open(FAR struct file *filep, FAR const char *relpath,
 
   /* Try to open the file in the host file system */
 
+  if ((oflags & (O_WROK | O_CREAT | O_TRUNC)) != 0)
+    {
+      rpmsgfs_attrcache_invalidate(fs);
+    }
+
   hf->fd = rpmsgfs_client_open(fs->handle, path, oflags, mode);
   if (hf->fd < 0)
     {
@@ -546,6 +660,7 @@ static ssize_t rpmsgfs_write(FAR struct file *filep, const char *buffer,
 
   /* Call the host to perform the write */
 
+  rpmsgfs_attrcache_invalidate(fs);
   ret = rpmsgfs_client_write(fs->handle, hf->fd, buffer, buflen);
   if (ret > 0)
     {
@@ -800,6 +915,7 @@ static int rpmsgfs_fchstat(FAR const struct file *filep,
 
   /* Call the host to perform the change */
 
+  rpmsgfs_attrcache_invalidate(fs);
   ret = rpmsgfs_client_fchstat(fs->handle, hf->fd, buf, flags);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -841,6 +957,7 @@ static int rpmsgfs_truncate(FAR struct file *filep, off_t length)
 
   /* Call the host to perform the truncate */
 
+  rpmsgfs_attrcache_invalidate(fs);
   ret = rpmsgfs_client_ftruncate(fs->handle, hf->fd, length);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -981,10 +1098,27 @@ static int rpmsgfs_readdir(FAR struct inode *mountpt,
       return ret;
     }
 
-  /* Call the host OS's readdir function */
+  /* Call the host OS's readdir function when all entries read before were
+   * returned.
+   */
 
-  ret = rpmsgfs_client_readdir(fs->handle, rdir->dir, entry);
+  if (rdir->next >= rdir->count)
+    {
+      ret = rpmsgfs_client_readdir(fs->handle, rdir->dir, rdir->entries,
+                                   CONFIG_FS_RPMSGFS_READDIR_NENTRIES);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+
+      rdir->next  = 0;
+      rdir->count = ret;
+    }
+
+  memcpy(entry, &rdir->entries[rdir->next++], sizeof(struct dirent));
+  ret = OK;
 
+errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
@@ -1023,6 +1157,8 @@ static int rpmsgfs_rewinddir(FAR struct inode *mountpt,
   /* Call the host and let it do all the work */
 
   rpmsgfs_client_rewinddir(fs->handle, rdir->dir);
+  rdir->next  = 0;
+  rdir->count = 0;
 
   nxmutex_unlock(&fs->fs_lock);
   return OK;
@@ -1259,6 +1395,7 @@ static int rpmsgfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Call the host fs to perform the unlink */
 
+  rpmsgfs_attrcache_invalidate(fs);
   ret = rpmsgfs_client_unlink(fs->handle, path);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -1299,6 +1436,7 @@ static int rpmsgfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the mkdir */
 
+  rpmsgfs_attrcache_invalidate(fs);
   ret = rpmsgfs_client_mkdir(fs->handle, path, mode);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -1340,6 +1478,7 @@ int rpmsgfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Call the host FS to do the mkdir */
 
+  rpmsgfs_attrcache_invalidate(fs);
   ret = rpmsgfs_client_rmdir(fs->handle, path);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -1384,6 +1523,7 @@ int rpmsgfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
 
   /* Call the host FS to do the mkdir */
 
+  rpmsgfs_attrcache_invalidate(fs);
   ret = rpmsgfs_client_rename(fs->handle, oldpath, newpath);
 
   nxmutex_unlock(&fs->fs_lock);
@@ -1401,6 +1541,9 @@ static int rpmsgfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                         FAR struct stat *buf)
 {
   FAR struct rpmsgfs_mountpt_s *fs;
+#ifdef CONFIG_FS_RPMSGFS_ATTRCACHE
+  FAR struct rpmsgfs_attrcache_s *ac;
+#endif
   char path[PATH_MAX];
   int ret;
 
@@ -1418,6 +1561,16 @@ static int rpmsgfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
       return ret;
     }
 
+#ifdef CONFIG_FS_RPMSGFS_ATTRCACHE
+  ac = rpmsgfs_attrcache_find(fs, relpath);
+  if (ac != NULL)
+    {
+      memcpy(buf, &ac->ac_buf, sizeof(struct stat));
+      nxmutex_unlock(&fs->fs_lock);
+      return OK;
+    }
+#endif
+
   /* Append to the host's root directory */
 
   rpmsgfs_mkpath(fs, relpath, path, sizeof(path));
@@ -1426,6 +1579,13 @@ static int rpmsgfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   ret = rpmsgfs_client_stat(fs->handle, path, buf);
 
+#ifdef CONFIG_FS_RPMSGFS_ATTRCACHE
+  if (ret >= 0)
+    {
+      rpmsgfs_attrcache_add(fs, relpath, buf);
+    }
+#endif
+
   nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
@@ -1464,6 +1624,7 @@ static int rpmsgfs_chstat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the chstat operation */
 
+  rpmsgfs_attrcache_invalidate(fs);
   ret = rpmsgfs_client_chstat(fs->handle, path, buf, flags);
 
   nxmutex_unlock(&fs->fs_lock);
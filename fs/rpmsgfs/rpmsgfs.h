@@ -144,6 +144,13 @@ begin_packed_struct struct rpmsgfs_opendir_s
   char                    pathname[0];
 } end_packed_struct;
 
+/* In a READDIR request 'type' is the number of entries the client can take
+ * (0 is taken as 1).  When it is more than one the result of the reply is
+ * the number of entries returned, and each entry after the first follows
+ * the terminating NUL of the name before it as one byte of type and the
+ * NUL terminated name.  Otherwise the result is 0 for the single entry.
+ */
+
 begin_packed_struct struct rpmsgfs_readdir_s
 {
   struct rpmsgfs_header_s header;
@@ -224,7 +231,7 @@ int       rpmsgfs_client_fchstat(FAR void *handle, int fd,
 int       rpmsgfs_client_ftruncate(FAR void *handle, int fd, off_t length);
 FAR void *rpmsgfs_client_opendir(FAR void *handle, FAR const char *name);
 int       rpmsgfs_client_readdir(FAR void *handle, FAR void *dirp,
-                                 FAR struct dirent *entry);
+                                 FAR struct dirent *entry, size_t nentries);
 void      rpmsgfs_client_rewinddir(FAR void *handle, FAR void *dirp);
 int       rpmsgfs_client_bind(FAR void **handle, FAR const char *cpuname);
 int       rpmsgfs_client_unbind(FAR void *handle);
@@ -192,13 +192,37 @@ static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
   FAR struct rpmsgfs_cookie_s *cookie =
       (struct rpmsgfs_cookie_s *)(uintptr_t)header->cookie;
   FAR struct rpmsgfs_readdir_s *rsp = data;
-  FAR struct dirent *entry = cookie->data;
+  FAR struct iovec *entries = cookie->data;
+  FAR struct dirent *entry = entries->iov_base;
+  FAR const char *end = (FAR const char *)data + len;
+  FAR const char *name;
+  size_t count;
+  size_t i;
 
   cookie->result = header->result;
   if (cookie->result >= 0)
     {
       strlcpy(entry->d_name, rsp->name, sizeof(entry->d_name));
       entry->d_type = rsp->type;
+
+      /* Unpack the entries that follow the first one */
+
+      count = MIN(MAX(cookie->result, 1), entries->iov_len);
+      name  = rsp->name + strnlen(rsp->name, end - rsp->name) + 1;
+
+      for (i = 1; i < count && name + 1 < end; i++)
+        {
+          entry[i].d_type = *name++;
+          if (strnlen(name, end - name) == (size_t)(end - name))
+            {
+              break;
+            }
+
+          strlcpy(entry[i].d_name, name, sizeof(entry[i].d_name));
+          name += strlen(name) + 1;
+        }
+
+      cookie->result = i;
     }
 
   rpmsg_post(ept, &cookie->sem);
@@ -674,15 +698,22 @@ FAR void *rpmsgfs_client_opendir(FAR void *handle, FAR const char *name)
 }
 
 int rpmsgfs_client_readdir(FAR void *handle, FAR void *dirp,
-                           FAR struct dirent *entry)
+                           FAR struct dirent *entry, size_t nentries)
 {
+  struct iovec entries =
+  {
+    .iov_base = entry,
+    .iov_len  = nentries,
+  };
+
   struct rpmsgfs_readdir_s msg =
   {
-    .fd = (uintptr_t)dirp,
+    .fd   = (uintptr_t)dirp,
+    .type = nentries,
   };
 
   return rpmsgfs_send_recv(handle, RPMSGFS_READDIR, true,
-          (struct rpmsgfs_header_s *)&msg, sizeof(msg), entry);
+          (struct rpmsgfs_header_s *)&msg, sizeof(msg), &entries);
 }
 
 void rpmsgfs_client_rewinddir(FAR void *handle, FAR void *dirp)
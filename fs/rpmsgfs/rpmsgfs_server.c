@@ -601,6 +601,10 @@ static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
 {
   FAR struct rpmsgfs_readdir_s *msg = data;
   FAR struct dirent *entry;
+  FAR char *name = msg->name;
+  FAR char *end;
+  uint32_t nentries = MAX(msg->type, 1);
+  uint32_t count = 0;
   int ret = -ENOENT;
   FAR void *dir;
   size_t size;
@@ -608,16 +612,43 @@ static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
   dir = rpmsgfs_get_dir(priv, msg->fd);
   if (dir)
     {
-      entry = readdir(dir);
-      if (entry)
+      size = MIN(rpmsg_virtio_get_buffer_size(ept->rdev),
+                 rpmsg_virtio_get_rx_buffer_size(ept->rdev));
+      end  = (FAR char *)msg + size;
+
+      /* Pack the entries while the longest name still fits, an entry that
+       * was read can not be given back to the directory.
+       */
+
+      while (count < nentries &&
+             (count == 0 || end - name >= NAME_MAX + 2))
+        {
+          entry = readdir(dir);
+          if (entry == NULL)
+            {
+              break;
+            }
+
+          if (count == 0)
+            {
+              size = MIN(end - name, strlen(entry->d_name) + 1);
+              msg->type = entry->d_type;
+            }
+          else
+            {
+              size = strlen(entry->d_name) + 1;
+              *name++ = entry->d_type;
+            }
+
+          strlcpy(name, entry->d_name, size);
+          name += size;
+          count++;
+        }
+
+      if (count > 0)
         {
-          size = MIN(rpmsg_virtio_get_buffer_size(ept->rdev),
-                     rpmsg_virtio_get_rx_buffer_size(ept->rdev));
-          size = MIN(size - len, strlen(entry->d_name) + 1);
-          msg->type = entry->d_type;
-          strlcpy(msg->name, entry->d_name, size);
-          len += size;
-          ret = 0;
+          ret = nentries > 1 ? count : 0;
+          len = name - (FAR char *)msg;
         }
     }
 
@@ -29,14 +29,25 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/mm/mm.h>
 
+#include <sys/param.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <assert.h>
+#include <string.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <debug.h>
 
 #include "inode/inode.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest datagram that readv() receives, the IP length is 16 bits */
+
+#define SOCK_MAX_DGRAMSIZE 65535
+
 /****************************************************************************
  * Private Functions Prototypes
  ****************************************************************************/
@@ -51,7 +62,13 @@ static int sock_file_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg);
 static int sock_file_poll(FAR struct file *filep, struct pollfd *fds,
                           bool setup);
+static int sock_file_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map);
 static int sock_file_truncate(FAR struct file *filep, off_t length);
+static ssize_t sock_file_readv(FAR struct file *filep,
+                               FAR const struct iovec *iov, int iovcnt);
+static ssize_t sock_file_writev(FAR struct file *filep,
+                                FAR const struct iovec *iov, int iovcnt);
 
 /****************************************************************************
  * Private Data
@@ -65,9 +82,14 @@ static const struct file_operations g_sock_fileops =
   sock_file_write,    /* write */
   NULL,               /* seek */
   sock_file_ioctl,    /* ioctl */
-  NULL,               /* mmap */
+  sock_file_mmap,     /* mmap */
   sock_file_truncate, /* truncate */
-  sock_file_poll      /* poll */
+  sock_file_poll,     /* poll */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  NULL,               /* unlink */
+#endif
+  sock_file_readv,    /* readv */
+  sock_file_writev    /* writev */
 };
 
 static struct inode g_sock_inode =
@@ -141,11 +163,115 @@ static int sock_file_poll(FAR struct file *filep, FAR struct pollfd *fds,
   return psock_poll(filep->f_priv, fds, setup);
 }
 
+static int sock_file_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map)
+{
+  return psock_mmap(filep->f_priv, map);
+}
+
 static int sock_file_truncate(FAR struct file *filep, off_t length)
 {
   return -EINVAL;
 }
 
+static ssize_t sock_file_readv(FAR struct file *filep,
+                               FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct socket *psock = filep->f_priv;
+  FAR char *buffer;
+  size_t buflen = 0;
+  ssize_t nread = 0;
+  ssize_t ret;
+  size_t copy;
+  size_t off;
+  int i;
+
+  if (iovcnt == 1)
+    {
+      return psock_recv(psock, iov->iov_base, iov->iov_len, 0);
+    }
+
+  /* A stream is received into each buffer in turn.  Only the first
+   * receive may wait, the next ones take what has already arrived, and
+   * the transfer ends at the first short receive.
+   */
+
+  if (psock->s_type == SOCK_STREAM)
+    {
+      for (i = 0; i < iovcnt; i++)
+        {
+          if (iov[i].iov_len == 0)
+            {
+              continue;
+            }
+
+          ret = psock_recv(psock, iov[i].iov_base, iov[i].iov_len,
+                           nread > 0 ? MSG_DONTWAIT : 0);
+          if (ret <= 0)
+            {
+              return nread > 0 ? nread : ret;
+            }
+
+          nread += ret;
+          if ((size_t)ret < iov[i].iov_len)
+            {
+              break;
+            }
+        }
+
+      return nread;
+    }
+
+  /* A datagram must be received by one call, so receive into a bounce
+   * buffer no larger than the largest datagram and scatter it.
+   */
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      buflen += iov[i].iov_len;
+    }
+
+  buflen = MIN(buflen, SOCK_MAX_DGRAMSIZE);
+  if (buflen == 0 || iov[0].iov_len >= buflen)
+    {
+      return psock_recv(psock, iov[0].iov_base, iov[0].iov_len, 0);
+    }
+
+  buffer = kmm_malloc(buflen);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = psock_recv(psock, buffer, buflen, 0);
+  for (i = 0, off = 0; ret > 0 && off < (size_t)ret; i++)
+    {
+      copy = MIN(iov[i].iov_len, ret - off);
+      memcpy(iov[i].iov_base, buffer + off, copy);
+      off += copy;
+    }
+
+  kmm_free(buffer);
+  return ret;
+}
+
+static ssize_t sock_file_writev(FAR struct file *filep,
+                                FAR const struct iovec *iov, int iovcnt)
+{
+  struct msghdr msg;
+
+  if (iovcnt == 0)
+    {
+      return 0;
+    }
+
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov    = (FAR struct iovec *)iov;
+  msg.msg_iovlen = iovcnt;
+
+  return psock_sendmsg(filep->f_priv, &msg, 0);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <stdint.h>
@@ -49,10 +50,6 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
-#  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
-#endif
-
 #define tmpfs_lock(fs) \
            nxrmutex_lock(&fs->tfs_lock)
 #define tmpfs_lock_object(to) \
@@ -91,6 +88,8 @@ static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static FAR uint8_t *tmpfs_file_chunk(FAR struct tmpfs_file_s *tfo,
+              size_t index);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_release_file(FAR struct tmpfs_file_s *tfo);
@@ -259,62 +258,131 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
 
 /****************************************************************************
  * Name: tmpfs_realloc_file
+ *
+ * Description:
+ *   Change the size of a file.  Growing only extends the chunk table, which
+ *   grows by doubling, and leaves the new range as holes.  Shrinking frees
+ *   the chunks beyond the new end one by one and clears the tail of the
+ *   last chunk, so that the memory is returned as the file shrinks.
+ *
  ****************************************************************************/
 
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
                               size_t newsize)
 {
-  FAR uint8_t *newdata;
-  size_t allocsize;
-  size_t delta;
+  FAR uint8_t **newchunk;
+  size_t nchunks;
+  size_t offset;
+  size_t i;
+
+  nchunks = TMPFS_NCHUNKS(newsize);
 
   /* Are we growing or shrinking the object? */
 
-  if (newsize <= tfo->tfo_alloc)
+  if (newsize > tfo->tfo_size)
     {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
-       */
-
-      if (newsize > 0)
+      if (nchunks > tfo->tfo_nchunks)
         {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
+          size_t allocsize = tfo->tfo_nchunks > 0 ? tfo->tfo_nchunks : 1;
 
-          delta = tfo->tfo_alloc - newsize;
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
+          while (allocsize < nchunks)
             {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
+              allocsize <<= 1;
+            }
 
-              tfo->tfo_size = newsize;
-              return OK;
+          newchunk = kmm_realloc(tfo->tfo_chunk,
+                                 allocsize * sizeof(FAR uint8_t *));
+          if (newchunk == NULL)
+            {
+              return -ENOMEM;
             }
+
+          memset(&newchunk[tfo->tfo_nchunks], 0,
+                 (allocsize - tfo->tfo_nchunks) * sizeof(FAR uint8_t *));
+
+          tfo->tfo_chunk   = newchunk;
+          tfo->tfo_nchunks = allocsize;
         }
+
+      tfo->tfo_size = newsize;
+      return OK;
     }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
-   */
+  /* Shrinking ... Free the chunks past the new end of the file */
 
-  allocsize = newsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+  for (i = nchunks; i < TMPFS_NCHUNKS(tfo->tfo_size); i++)
+    {
+      if (tfo->tfo_chunk[i] != NULL)
+        {
+          kmm_free(tfo->tfo_chunk[i]);
+          tfo->tfo_chunk[i] = NULL;
+          tfo->tfo_alloc   -= TMPFS_CHUNKSIZE;
+        }
+    }
 
-  /* Realloc the file object */
+  /* Keep the bytes beyond the end of the last chunk zero */
 
-  newdata = kmm_realloc(tfo->tfo_data, allocsize);
-  if (newdata == NULL)
+  offset = newsize % TMPFS_CHUNKSIZE;
+  if (offset != 0 && tfo->tfo_chunk[nchunks - 1] != NULL)
     {
-      return -ENOMEM;
+      memset(tfo->tfo_chunk[nchunks - 1] + offset, 0,
+             TMPFS_CHUNKSIZE - offset);
     }
 
-  /* Return the new address of the reallocated file object */
+  tfo->tfo_size = newsize;
+
+  /* Release the chunk table when it is empty and halve it when it is
+   * mostly unused.
+   */
+
+  if (nchunks == 0)
+    {
+      kmm_free(tfo->tfo_chunk);
+      tfo->tfo_chunk   = NULL;
+      tfo->tfo_nchunks = 0;
+    }
+  else if (nchunks < tfo->tfo_nchunks / 4)
+    {
+      newchunk = kmm_realloc(tfo->tfo_chunk,
+                             (tfo->tfo_nchunks / 2) *
+                             sizeof(FAR uint8_t *));
+      if (newchunk != NULL)
+        {
+          tfo->tfo_chunk    = newchunk;
+          tfo->tfo_nchunks /= 2;
+        }
+    }
 
-  tfo->tfo_alloc = allocsize;
-  tfo->tfo_size  = newsize;
-  tfo->tfo_data  = newdata;
   return OK;
 }
 
+/****************************************************************************
+ * Name: tmpfs_file_chunk
+ *
+ * Description:
+ *   Return the chunk of the file that holds the given chunk index,
+ *   allocating a zeroed chunk for a hole.  NULL is returned if the memory
+ *   is exhausted.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_file_chunk(FAR struct tmpfs_file_s *tfo,
+                                     size_t index)
+{
+  DEBUGASSERT(index < tfo->tfo_nchunks);
+
+  if (tfo->tfo_chunk[index] == NULL)
+    {
+      tfo->tfo_chunk[index] = kmm_zalloc(TMPFS_CHUNKSIZE);
+      if (tfo->tfo_chunk[index] != NULL)
+        {
+          tfo->tfo_alloc += TMPFS_CHUNKSIZE;
+        }
+    }
+
+  return tfo->tfo_chunk[index];
+}
+
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
  ****************************************************************************/
@@ -352,7 +420,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
-      kmm_free(tfo->tfo_data);
+      tmpfs_realloc_file(tfo, 0);
       kmm_free(tfo);
     }
 
@@ -543,12 +611,13 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
    * locked with one reference count.
    */
 
-  tfo->tfo_alloc = 0;
-  tfo->tfo_type  = TMPFS_REGULAR;
-  tfo->tfo_refs  = 1;
-  tfo->tfo_flags = 0;
-  tfo->tfo_size  = 0;
-  tfo->tfo_data  = NULL;
+  tfo->tfo_alloc   = 0;
+  tfo->tfo_type    = TMPFS_REGULAR;
+  tfo->tfo_refs    = 1;
+  tfo->tfo_flags   = 0;
+  tfo->tfo_size    = 0;
+  tfo->tfo_nchunks = 0;
+  tfo->tfo_chunk   = NULL;
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -1099,7 +1168,11 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 
       tmptfo             = (FAR struct tmpfs_file_s *)to;
       tmpbuf->tsf_alloc += sizeof(struct tmpfs_file_s);
-      tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+      if (to->to_alloc > tmptfo->tfo_size)
+        {
+          tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+        }
+
       tmpbuf->tsf_files++;
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
@@ -1175,7 +1248,7 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      kmm_free(tfo->tfo_data);
+      tmpfs_realloc_file(tfo, 0);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
@@ -1454,9 +1527,13 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
                           size_t buflen)
 {
   FAR struct tmpfs_file_s *tfo;
+  FAR uint8_t *chunk;
   ssize_t nread;
   off_t startpos;
   off_t endpos;
+  size_t offset;
+  size_t nbytes;
+  off_t pos;
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1494,18 +1571,28 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
       nread  = endpos - startpos;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the memory object to the user buffer, one chunk at a
+   * time.  Holes read as zeros.
+   */
 
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(buffer, &tfo->tfo_data[startpos], nread);
-      filep->f_pos += nread;
-    }
-  else
+  for (pos = startpos; pos < endpos; pos += nbytes, buffer += nbytes)
     {
-      DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
+      chunk  = tfo->tfo_chunk[pos / TMPFS_CHUNKSIZE];
+      offset = pos % TMPFS_CHUNKSIZE;
+      nbytes = MIN(TMPFS_CHUNKSIZE - offset, endpos - pos);
+
+      if (chunk != NULL)
+        {
+          memcpy(buffer, chunk + offset, nbytes);
+        }
+      else
+        {
+          memset(buffer, 0, nbytes);
+        }
     }
 
+  filep->f_pos += nread;
+
   /* Release the lock on the file */
 
   tmpfs_unlock_file(tfo);
@@ -1520,9 +1607,14 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
                            size_t buflen)
 {
   FAR struct tmpfs_file_s *tfo;
+  FAR uint8_t *chunk;
   ssize_t nwritten;
   off_t startpos;
   off_t endpos;
+  size_t offset;
+  size_t nbytes;
+  size_t oldsize;
+  off_t pos;
   int ret;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
@@ -1544,12 +1636,12 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
   /* Handle attempts to write beyond the end of the file */
 
   startpos = filep->f_pos;
-  nwritten = buflen;
   endpos   = startpos + buflen;
+  oldsize  = tfo->tfo_size;
 
   if (endpos > tfo->tfo_size)
     {
-      /* Reallocate the file to handle the write past the end of the file. */
+      /* Extend the file to handle the write past the end of the file. */
 
       ret = tmpfs_realloc_file(tfo, (size_t)endpos);
       if (ret < 0)
@@ -1558,18 +1650,40 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
         }
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the user buffer to the memory object, one chunk at a
+   * time.  Only the chunks that are written are allocated.
+   */
 
-  if (tfo->tfo_data != NULL)
+  for (pos = startpos; pos < endpos; pos += nbytes, buffer += nbytes)
     {
-      memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
-      filep->f_pos += nwritten;
+      chunk = tmpfs_file_chunk(tfo, pos / TMPFS_CHUNKSIZE);
+      if (chunk == NULL)
+        {
+          break;
+        }
+
+      offset = pos % TMPFS_CHUNKSIZE;
+      nbytes = MIN(TMPFS_CHUNKSIZE - offset, endpos - pos);
+      memcpy(chunk + offset, buffer, nbytes);
     }
-  else
+
+  nwritten = pos - startpos;
+  if (pos < endpos)
     {
-      DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
+      /* Out of memory.  Drop the part of the extension that was not
+       * written.
+       */
+
+      tmpfs_realloc_file(tfo, MAX(oldsize, (size_t)pos));
+      if (nwritten == 0)
+        {
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
     }
 
+  filep->f_pos += nwritten;
+
   /* Release the lock on the file */
 
   tmpfs_unlock_file(tfo);
@@ -1689,17 +1803,37 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
   if (map->offset >= 0 && map->offset < tfo->tfo_size &&
       map->length && map->offset + map->length <= tfo->tfo_size)
     {
-      map->vaddr = tfo->tfo_data + map->offset;
+      FAR uint8_t *chunk;
+      size_t index = map->offset / TMPFS_CHUNKSIZE;
+
+      /* Only a range within one chunk is directly mappable, let mmap()
+       * fall back to a copy for the others.
+       */
+
+      if ((map->offset + map->length - 1) / TMPFS_CHUNKSIZE != index)
+        {
+          return -ENOTTY;
+        }
+
+      tmpfs_lock_file(tfo);
+      chunk = tmpfs_file_chunk(tfo, index);
+      if (chunk == NULL)
+        {
+          tmpfs_unlock_file(tfo);
+          return -ENOMEM;
+        }
+
+      map->vaddr = chunk + map->offset % TMPFS_CHUNKSIZE;
       map->priv.p = tfo;
       map->munmap = tmpfs_unmap;
       ret = mm_map_add(get_current_mm(), map);
 
       if (ret >= 0)
         {
-          tmpfs_lock_file(tfo);
           tfo->tfo_refs++;
-          tmpfs_unlock_file(tfo);
         }
+
+      tmpfs_unlock_file(tfo);
     }
 
   return ret;
@@ -1824,7 +1958,9 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
   oldsize = tfo->tfo_size;
   if (oldsize != length)
     {
-      /* The size is changing.. up or down.  Reallocate the file memory. */
+      /* The size is changing.. up or down.  Reallocate the file memory.
+       * A newly added range is a hole that reads as zeros.
+       */
 
       ret = tmpfs_realloc_file(tfo, (size_t)length);
       if (ret < 0)
@@ -1832,15 +1968,6 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
           goto errout_with_lock;
         }
 
-      /* If the size has increased, then we need to zero the newly added
-       * memory.
-       */
-
-      if (length > oldsize)
-        {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
-        }
-
       ret = OK;
     }
 
@@ -2282,7 +2409,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      kmm_free(tfo->tfo_data);
+      tmpfs_realloc_file(tfo, 0);
       kmm_free(tfo);
     }
 
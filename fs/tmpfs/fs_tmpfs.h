@@ -40,6 +40,11 @@
 
 #define TFO_FLAG_UNLINKED (1 << 0)  /* Bit 0: File is unlinked */
 
+/* File data is kept in chunks of CONFIG_FS_TMPFS_FILE_CHUNKSIZE bytes */
+
+#define TMPFS_CHUNKSIZE   CONFIG_FS_TMPFS_FILE_CHUNKSIZE
+#define TMPFS_NCHUNKS(s)  (((s) + TMPFS_CHUNKSIZE - 1) / TMPFS_CHUNKSIZE)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -107,6 +112,10 @@ struct tmpfs_directory_s
  * state.  The file memory object also serves as the open file object,
  * saving an allocation.  This has the negative side effect that no per-
  * open state can be retained (such as open flags).
+ *
+ * The data lives in fixed size chunks indexed by offset / TMPFS_CHUNKSIZE.
+ * A NULL chunk is a hole that reads as zeros, and the bytes of a chunk
+ * beyond tfo_size are always zero.
  */
 
 struct tmpfs_file_s
@@ -115,15 +124,16 @@ struct tmpfs_file_s
 
   rmutex_t tfo_lock;
 
-  size_t   tfo_alloc;    /* Allocated size of the file object */
+  size_t   tfo_alloc;    /* Allocated size of the file chunks */
   uint8_t  tfo_type;     /* See enum tmpfs_objtype_e */
   uint8_t  tfo_refs;     /* Reference count */
 
   /* Remaining fields are unique to a directory object */
 
-  uint8_t       tfo_flags; /* See TFO_FLAG_* definitions */
-  size_t        tfo_size;  /* Valid file size */
-  FAR uint8_t  *tfo_data;  /* File data starts here */
+  uint8_t       tfo_flags;   /* See TFO_FLAG_* definitions */
+  size_t        tfo_size;    /* Valid file size */
+  size_t        tfo_nchunks; /* Number of entries of tfo_chunk */
+  FAR uint8_t **tfo_chunk;   /* File data chunks, NULL for holes */
 };
 
 /* This structure represents one instance of a TMPFS file system */
@@ -39,6 +39,7 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 
@@ -49,6 +50,9 @@
 struct epoll_node_s
 {
   struct list_node      node;
+  struct list_node      rnode;    /* Link in the ready list */
+  bool                  ready;    /* True if on the ready list */
+  FAR struct epoll_head_s *eph;
   epoll_data_t          data;
   struct pollfd         pfd;
 };
@@ -78,6 +82,15 @@ struct epoll_head_s
   struct list_node      free;     /* The free list, store all the freed epoll
                                    * node.
                                    */
+  struct list_node      ready;    /* The ready list, store all the setuped
+                                   * epoll node notified since the last
+                                   * epoll_wait, so that epoll_wait only
+                                   * visits these nodes.
+                                   */
+  spinlock_t            rlock;    /* Protect the ready list, the poll
+                                   * callback may run in the interrupt
+                                   * context.
+                                   */
   struct list_node      extend;   /* The extend list, store all the malloced
                                    * first node, used to free the malloced
                                    * memory in epoll_do_close().
@@ -156,6 +169,54 @@ static FAR epoll_head_t *epoll_head_from_fd(int fd)
   return (FAR epoll_head_t *)filep->f_priv;
 }
 
+/****************************************************************************
+ * Name: epoll_default_cb
+ *
+ * Description:
+ *   The poll callback of the epoll nodes.  Queue the node to the ready list
+ *   and wake up epoll_wait().
+ *
+ ****************************************************************************/
+
+static void epoll_default_cb(FAR struct pollfd *fds)
+{
+  FAR epoll_node_t *epn = container_of(fds, epoll_node_t, pfd);
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (!epn->ready)
+    {
+      epn->ready = true;
+      list_add_tail(&eph->ready, &epn->rnode);
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
+  poll_default_cb(fds);
+}
+
+/****************************************************************************
+ * Name: epoll_unready
+ *
+ * Description:
+ *   Remove a node that is no longer setup from the ready list.
+ *
+ ****************************************************************************/
+
+static void epoll_unready(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (epn->ready)
+    {
+      epn->ready = false;
+      list_delete(&epn->rnode);
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
+}
+
 static int epoll_do_open(FAR struct file *filep)
 {
   FAR epoll_head_t *eph = filep->f_priv;
@@ -241,6 +302,8 @@ static int epoll_do_create(int size, int flags)
   list_initialize(&eph->oneshot);
   list_initialize(&eph->extend);
   list_initialize(&eph->free);
+  list_initialize(&eph->ready);
+  spin_initialize(&eph->rlock, SP_UNLOCKED);
   for (i = 0; i < size; i++)
     {
       list_add_tail(&eph->free, &epn[i].node);
@@ -300,29 +363,63 @@ static int epoll_setup(FAR epoll_head_t *eph)
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents)
 {
-  FAR epoll_node_t *tepn;
   FAR epoll_node_t *epn;
+  pollevent_t revents;
+  irqstate_t flags;
+  bool empty;
   int i = 0;
 
   nxmutex_lock(&eph->lock);
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  /* Only the nodes notified since the last epoll_wait() are visited */
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  while (i < maxevents && !list_is_empty(&eph->ready))
     {
-      if (epn->pfd.revents != 0 && i < maxevents)
+      epn = container_of(list_remove_head(&eph->ready), epoll_node_t,
+                         rnode);
+      epn->ready       = false;
+      revents          = epn->pfd.revents;
+      epn->pfd.revents = 0;
+      spin_unlock_irqrestore(&eph->rlock, flags);
+
+      if (revents != 0)
         {
           evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
-          list_delete(&epn->node);
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
-            {
-              list_add_tail(&eph->oneshot, &epn->node);
-            }
-          else
+          evs[i++].events = revents;
+
+          /* An edge triggered node stays setup and is queued again by the
+           * next notification.  The others are setup again by the next
+           * epoll_wait() to report the events that are still pending.
+           */
+
+          if ((epn->pfd.events & (EPOLLET | EPOLLONESHOT)) != EPOLLET)
             {
-              list_add_tail(&eph->teardown, &epn->node);
+              poll_fdsetup(epn->pfd.fd, &epn->pfd, false);
+              epoll_unready(eph, epn);
+              list_delete(&epn->node);
+              if ((epn->pfd.events & EPOLLONESHOT) != 0)
+                {
+                  list_add_tail(&eph->oneshot, &epn->node);
+                }
+              else
+                {
+                  list_add_tail(&eph->teardown, &epn->node);
+                }
             }
         }
+
+      flags = spin_lock_irqsave(&eph->rlock);
+    }
+
+  empty = list_is_empty(&eph->ready);
+  spin_unlock_irqrestore(&eph->rlock, flags);
+
+  /* Drop a wakeup left by the nodes consumed above */
+
+  if (empty)
+    {
+      nxsem_trywait(&eph->sem);
     }
 
   nxmutex_unlock(&eph->lock);
@@ -476,12 +573,15 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         epn->pfd.events  = ev->events;
         epn->pfd.fd      = fd;
         epn->pfd.arg     = &eph->sem;
-        epn->pfd.cb      = poll_default_cb;
+        epn->pfd.cb      = epoll_default_cb;
         epn->pfd.revents = 0;
+        epn->eph         = eph;
+        epn->ready       = false;
 
         ret = poll_fdsetup(fd, &epn->pfd, true);
         if (ret < 0)
           {
+            epoll_unready(eph, epn);
             list_add_tail(&eph->free, &epn->node);
             goto err;
           }
@@ -496,6 +596,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
             if (epn->pfd.fd == fd)
               {
                 poll_fdsetup(fd, &epn->pfd, false);
+                epoll_unready(eph, epn);
                 list_delete(&epn->node);
                 list_add_tail(&eph->free, &epn->node);
                 goto out;
@@ -533,6 +634,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
                 if (epn->pfd.events != ev->events)
                   {
                     poll_fdsetup(fd, &epn->pfd, false);
+                    epoll_unready(eph, epn);
 
                     epn->data        = ev->data;
                     epn->pfd.events  = ev->events;
@@ -636,11 +738,11 @@ int epoll_pwait(int epfd, FAR struct epoll_event *evs,
       goto err;
     }
 
-  /* Wait the poll ready */
+  /* Wait the poll ready, unless a node is ready already */
 
   nxsig_procmask(SIG_SETMASK, sigmask, &oldsigmask);
 
-  if (timeout == 0)
+  if (timeout == 0 || !list_is_empty(&eph->ready))
     {
       ret = OK;
     }
@@ -710,9 +812,9 @@ int epoll_wait(int epfd, FAR struct epoll_event *evs,
       goto err;
     }
 
-  /* Wait the poll ready */
+  /* Wait the poll ready, unless a node is ready already */
 
-  if (timeout == 0)
+  if (timeout == 0 || !list_is_empty(&eph->ready))
     {
       ret = OK;
     }
@@ -227,6 +227,36 @@ static int file_vfcntl(FAR struct file *filep, int cmd, va_list ap)
         {
           ret = file_ioctl(filep, FIOC_FILEPATH, va_arg(ap, FAR char *));
         }
+        break;
+
+      case F_SETPIPE_SZ:
+        /* Resize the buffer of a pipe, keeping the data it holds.  The
+         * argument is the new size in bytes.
+         */
+
+        if (!INODE_IS_PIPE(filep->f_inode))
+          {
+            ret = -EBADF;
+            break;
+          }
+
+        ret = file_ioctl(filep, PIPEIOC_SETSIZE,
+                         (unsigned long)va_arg(ap, int));
+        if (ret >= 0)
+          {
+            ret = file_ioctl(filep, PIPEIOC_GETSIZE, 0);
+          }
+
+        break;
+
+      case F_GETPIPE_SZ:
+        /* Get the size of the buffer of a pipe.  The argument is ignored
+         * and the size in bytes is returned.
+         */
+
+        ret = INODE_IS_PIPE(filep->f_inode) ?
+              file_ioctl(filep, PIPEIOC_GETSIZE, 0) : -EBADF;
+        break;
 
       default:
         break;
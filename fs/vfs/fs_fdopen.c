@@ -218,11 +218,13 @@ int fs_fdopen(int fd, int oflags, FAR struct tcb_s *tcb,
 #endif /* CONFIG_STDIO_DISABLE_BUFFERING */
 
   /* Save the file description and open flags.  Setting the
-   * file descriptor locks this stream.
+   * file descriptor locks this stream.  lib_get_stream() reads fs_oflags
+   * without the stream list lock to tell whether a standard stream is set
+   * up, so it is stored last with release semantics.
    */
 
   stream->fs_fd       = fd;
-  stream->fs_oflags   = oflags;
+  __atomic_store_n(&stream->fs_oflags, oflags, __ATOMIC_RELEASE);
 
   if (filep != NULL)
     {
@@ -0,0 +1,824 @@
+/****************************************************************************
+ * fs/vfs/fs_ioring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioring.h>
+#include <poll.h>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/queue.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes the internal state of one ring */
+
+struct ioring_priv_s
+{
+  mutex_t            lock;      /* Serializes the accesses to the rings */
+  sem_t              waitsem;   /* Wakes up ioring_enter() */
+  sem_t              drainsem;  /* Wakes up the last close */
+  FAR struct ioring *ring;      /* The rings shared with the application */
+  dq_queue_t         parked;    /* Waiting polls, under g_ioring_lock */
+  uint32_t           inflight;  /* Submissions not completed yet */
+  uint16_t           nwaiters;  /* Threads waiting in ioring_enter() */
+  uint8_t            crefs;     /* References counts on the ring */
+  bool               closing;   /* The last reference is being closed */
+
+  /* The following is a list if poll structures of threads waiting for
+   * completions.
+   */
+
+  FAR struct pollfd *fds[CONFIG_FS_IORING_NPOLLWAITERS];
+};
+
+/* One submission on its way through the worker pool */
+
+struct ioring_req_s
+{
+  dq_entry_t         link;      /* In g_ioring_queue or priv->parked */
+  FAR struct ioring_priv_s *priv;
+  FAR struct file   *filep;     /* The file of sqe.fd */
+  struct ioring_sqe  sqe;       /* Copy of the submission */
+  struct pollfd      pfd;       /* IORING_OP_POLL only */
+  bool               polled;    /* IORING_OP_POLL is set up */
+  bool               parked;    /* In priv->parked */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int ioring_do_open(FAR struct file *filep);
+static int ioring_do_close(FAR struct file *filep);
+static int ioring_do_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                          bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_ioring_fops =
+{
+  ioring_do_open,   /* open */
+  ioring_do_close,  /* close */
+  NULL,             /* read */
+  NULL,             /* write */
+  NULL,             /* seek */
+  NULL,             /* ioctl */
+  NULL,             /* mmap */
+  NULL,             /* truncate */
+  ioring_do_poll    /* poll */
+};
+
+static struct inode g_ioring_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_ioring_fops        /* u */
+  }
+};
+
+/* The submissions of all the rings waiting for a worker */
+
+static dq_queue_t g_ioring_queue;
+static spinlock_t g_ioring_lock = SP_UNLOCKED;
+static sem_t g_ioring_sem = NXSEM_INITIALIZER(0, 0);
+
+/* The worker pool is started by the first ioring_setup() */
+
+static mutex_t g_ioring_startlock = NXMUTEX_INITIALIZER;
+static int g_ioring_nworkers;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ioring_post
+ *
+ * Description:
+ *   Fill the next completion queue entry and wake up the waiters.
+ *
+ * Assumptions:
+ *   The caller holds priv->lock.
+ *
+ ****************************************************************************/
+
+static void ioring_post(FAR struct ioring_priv_s *priv, uint64_t user_data,
+                        ssize_t res)
+{
+  FAR struct ioring *ring = priv->ring;
+  FAR struct ioring_cqe *cqe;
+  uint32_t tail = ring->cq_tail;
+
+  if (tail - __atomic_load_n(&ring->cq_head, __ATOMIC_ACQUIRE) <
+      ring->cq_entries)
+    {
+      cqe = &ring->cqes[tail & (ring->cq_entries - 1)];
+      cqe->user_data = user_data;
+      cqe->res       = res;
+      __atomic_store_n(&ring->cq_tail, tail + 1, __ATOMIC_RELEASE);
+    }
+  else
+    {
+      ring->cq_overflow++;
+    }
+
+  if (priv->nwaiters > 0)
+    {
+      nxsem_post(&priv->waitsem);
+    }
+
+  poll_notify(priv->fds, CONFIG_FS_IORING_NPOLLWAITERS, POLLIN);
+
+  DEBUGASSERT(priv->inflight > 0);
+  if (--priv->inflight == 0 && priv->closing)
+    {
+      nxsem_post(&priv->drainsem);
+    }
+}
+
+/****************************************************************************
+ * Name: ioring_complete
+ ****************************************************************************/
+
+static void ioring_complete(FAR struct ioring_req_s *req, ssize_t res)
+{
+  FAR struct ioring_priv_s *priv = req->priv;
+
+  nxmutex_lock(&priv->lock);
+  ioring_post(priv, req->sqe.user_data, res);
+  nxmutex_unlock(&priv->lock);
+  kmm_free(req);
+}
+
+/****************************************************************************
+ * Name: ioring_poll_cb
+ *
+ * Description:
+ *   The poll callback of IORING_OP_POLL.  Hand a parked poll back to the
+ *   worker pool, which tears it down and completes it.
+ *
+ ****************************************************************************/
+
+static void ioring_poll_cb(FAR struct pollfd *fds)
+{
+  FAR struct ioring_req_s *req = fds->arg;
+  irqstate_t flags;
+  bool wakeup = false;
+
+  flags = spin_lock_irqsave(&g_ioring_lock);
+  if (req->parked)
+    {
+      req->parked = false;
+      dq_rem(&req->link, &req->priv->parked);
+      dq_addlast(&req->link, &g_ioring_queue);
+      wakeup = true;
+    }
+
+  spin_unlock_irqrestore(&g_ioring_lock, flags);
+
+  if (wakeup)
+    {
+      nxsem_post(&g_ioring_sem);
+    }
+}
+
+/****************************************************************************
+ * Name: ioring_poll
+ *
+ * Description:
+ *   Execute IORING_OP_POLL.  The request is parked instead of blocking the
+ *   worker if no event is pending.
+ *
+ * Returned Value:
+ *   The events, a negated errno value or -EINPROGRESS if parked.
+ *
+ ****************************************************************************/
+
+static ssize_t ioring_poll(FAR struct ioring_req_s *req)
+{
+  FAR struct ioring_priv_s *priv = req->priv;
+  irqstate_t flags;
+  int ret;
+
+  if (!req->polled)
+    {
+      req->pfd.fd      = req->sqe.fd;
+      req->pfd.events  = req->sqe.flags;
+      req->pfd.revents = 0;
+      req->pfd.arg     = req;
+      req->pfd.cb      = ioring_poll_cb;
+      req->pfd.priv    = NULL;
+
+      ret = file_poll(req->filep, &req->pfd, true);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      req->polled = true;
+
+      /* The events may have been notified during the setup */
+
+      flags = spin_lock_irqsave(&g_ioring_lock);
+      if (req->pfd.revents == 0 && !priv->closing)
+        {
+          req->parked = true;
+          dq_addlast(&req->link, &priv->parked);
+          spin_unlock_irqrestore(&g_ioring_lock, flags);
+          return -EINPROGRESS;
+        }
+
+      spin_unlock_irqrestore(&g_ioring_lock, flags);
+    }
+
+  file_poll(req->filep, &req->pfd, false);
+  return req->pfd.revents;
+}
+
+/****************************************************************************
+ * Name: ioring_execute
+ ****************************************************************************/
+
+static void ioring_execute(FAR struct ioring_req_s *req)
+{
+  FAR struct ioring_sqe *sqe = &req->sqe;
+#ifdef CONFIG_NET
+  FAR struct socket *psock;
+#endif
+  ssize_t res;
+
+  switch (sqe->opcode)
+    {
+      case IORING_OP_NOP:
+        res = 0;
+        break;
+
+      case IORING_OP_READ:
+        res = sqe->off < 0 ?
+              file_read(req->filep, sqe->addr, sqe->len) :
+              file_pread(req->filep, sqe->addr, sqe->len, sqe->off);
+        break;
+
+      case IORING_OP_WRITE:
+        res = sqe->off < 0 ?
+              file_write(req->filep, sqe->addr, sqe->len) :
+              file_pwrite(req->filep, sqe->addr, sqe->len, sqe->off);
+        break;
+
+      case IORING_OP_FSYNC:
+        res = file_fsync(req->filep);
+        break;
+
+#ifdef CONFIG_NET
+      case IORING_OP_SEND:
+        psock = file_socket(req->filep);
+        res = psock != NULL ?
+              psock_send(psock, sqe->addr, sqe->len, sqe->flags) :
+              -ENOTSOCK;
+        break;
+
+      case IORING_OP_RECV:
+        psock = file_socket(req->filep);
+        res = psock != NULL ?
+              psock_recv(psock, sqe->addr, sqe->len, sqe->flags) :
+              -ENOTSOCK;
+        break;
+#endif
+
+      case IORING_OP_POLL:
+        res = ioring_poll(req);
+        if (res == -EINPROGRESS)
+          {
+            return;
+          }
+
+        break;
+
+      default:
+        res = -EINVAL;
+        break;
+    }
+
+  ioring_complete(req, res);
+}
+
+/****************************************************************************
+ * Name: ioring_worker
+ *
+ * Description:
+ *   The worker pool threads execute the submissions of all the rings.
+ *
+ ****************************************************************************/
+
+static int ioring_worker(int argc, FAR char *argv[])
+{
+  FAR struct ioring_req_s *req;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&g_ioring_sem);
+
+      flags = spin_lock_irqsave(&g_ioring_lock);
+      req = (FAR struct ioring_req_s *)dq_remfirst(&g_ioring_queue);
+      spin_unlock_irqrestore(&g_ioring_lock, flags);
+
+      if (req != NULL)
+        {
+          ioring_execute(req);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ioring_start
+ *
+ * Description:
+ *   Start the worker pool if it is not running yet.
+ *
+ ****************************************************************************/
+
+static int ioring_start(void)
+{
+  int ret;
+
+  ret = nxmutex_lock(&g_ioring_startlock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (g_ioring_nworkers < CONFIG_FS_IORING_NWORKERS)
+    {
+      ret = kthread_create("ioring", CONFIG_FS_IORING_PRIORITY,
+                           CONFIG_FS_IORING_STACKSIZE, ioring_worker, NULL);
+      if (ret < 0)
+        {
+          ferr("ERROR: Failed to start a worker: %d\n", ret);
+          break;
+        }
+
+      g_ioring_nworkers++;
+    }
+
+  ret = g_ioring_nworkers > 0 ? OK : ret;
+  nxmutex_unlock(&g_ioring_startlock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ioring_priv_from_fd
+ ****************************************************************************/
+
+static FAR struct ioring_priv_s *ioring_priv_from_fd(int fd)
+{
+  FAR struct file *filep;
+
+  if (fs_getfilep(fd, &filep) < 0 ||
+      filep->f_inode->u.i_ops != &g_ioring_fops)
+    {
+      return NULL;
+    }
+
+  return filep->f_priv;
+}
+
+/****************************************************************************
+ * Name: ioring_destroy
+ *
+ * Description:
+ *   Cancel the parked polls, wait for the other submissions and free the
+ *   ring.
+ *
+ ****************************************************************************/
+
+static void ioring_destroy(FAR struct ioring_priv_s *priv)
+{
+  FAR struct ioring_req_s *req;
+  dq_queue_t parked;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_ioring_lock);
+  priv->closing = true;
+  dq_move(&priv->parked, &parked);
+  for (req = (FAR struct ioring_req_s *)dq_peek(&parked); req != NULL;
+       req = (FAR struct ioring_req_s *)dq_next(&req->link))
+    {
+      req->parked = false;
+    }
+
+  spin_unlock_irqrestore(&g_ioring_lock, flags);
+
+  while ((req = (FAR struct ioring_req_s *)dq_remfirst(&parked)) != NULL)
+    {
+      file_poll(req->filep, &req->pfd, false);
+      ioring_complete(req, -ECANCELED);
+    }
+
+  nxmutex_lock(&priv->lock);
+  while (priv->inflight > 0)
+    {
+      nxmutex_unlock(&priv->lock);
+      nxsem_wait_uninterruptible(&priv->drainsem);
+      nxmutex_lock(&priv->lock);
+    }
+
+  nxmutex_unlock(&priv->lock);
+
+  nxmutex_destroy(&priv->lock);
+  nxsem_destroy(&priv->waitsem);
+  nxsem_destroy(&priv->drainsem);
+  kmm_free(priv);
+}
+
+static int ioring_do_open(FAR struct file *filep)
+{
+  FAR struct ioring_priv_s *priv = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (priv->crefs >= 255)
+    {
+      ret = -EMFILE;
+    }
+  else
+    {
+      priv->crefs++;
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+
+static int ioring_do_close(FAR struct file *filep)
+{
+  FAR struct ioring_priv_s *priv = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (--priv->crefs > 0)
+    {
+      nxmutex_unlock(&priv->lock);
+      return OK;
+    }
+
+  nxmutex_unlock(&priv->lock);
+  ioring_destroy(priv);
+  return OK;
+}
+
+static int ioring_do_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                          bool setup)
+{
+  FAR struct ioring_priv_s *priv = filep->f_priv;
+  FAR struct ioring *ring = priv->ring;
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (!setup)
+    {
+      /* This is a request to tear down the poll. */
+
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      *slot     = NULL;
+      fds->priv = NULL;
+      goto out;
+    }
+
+  for (i = 0; i < CONFIG_FS_IORING_NPOLLWAITERS; i++)
+    {
+      if (priv->fds[i] == NULL)
+        {
+          priv->fds[i] = fds;
+          fds->priv    = &priv->fds[i];
+          break;
+        }
+    }
+
+  if (i >= CONFIG_FS_IORING_NPOLLWAITERS)
+    {
+      fds->priv = NULL;
+      ret       = -EBUSY;
+      goto out;
+    }
+
+  /* Notify the POLLIN event if completions are pending */
+
+  if (ring->cq_tail != __atomic_load_n(&ring->cq_head, __ATOMIC_ACQUIRE))
+    {
+      poll_notify(priv->fds, CONFIG_FS_IORING_NPOLLWAITERS, POLLIN);
+    }
+
+out:
+  nxmutex_unlock(&priv->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ioring_submit
+ *
+ * Description:
+ *   Take up to 'to_submit' entries from the submission queue and hand them
+ *   to the worker pool.
+ *
+ * Returned Value:
+ *   The number of entries taken or a negated errno value.
+ *
+ ****************************************************************************/
+
+static int ioring_submit(FAR struct ioring_priv_s *priv,
+                         unsigned int to_submit)
+{
+  FAR struct ioring *ring = priv->ring;
+  FAR struct ioring_req_s *req;
+  dq_queue_t queue;
+  irqstate_t flags;
+  uint32_t head;
+  uint32_t tail;
+  int count = 0;
+  int ret;
+
+  dq_init(&queue);
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  head = ring->sq_head;
+  tail = __atomic_load_n(&ring->sq_tail, __ATOMIC_ACQUIRE);
+  while (count < to_submit && head != tail)
+    {
+      req = kmm_malloc(sizeof(struct ioring_req_s));
+      if (req == NULL)
+        {
+          ret = -ENOMEM;
+          break;
+        }
+
+      memcpy(&req->sqe, &ring->sqes[head & (ring->sq_entries - 1)],
+             sizeof(struct ioring_sqe));
+      req->priv   = priv;
+      req->filep  = NULL;
+      req->polled = false;
+      req->parked = false;
+      priv->inflight++;
+      head++;
+      count++;
+
+      /* The descriptor belongs to the caller, the workers have no file
+       * list to resolve it.
+       */
+
+      if (req->sqe.opcode != IORING_OP_NOP &&
+          fs_getfilep(req->sqe.fd, &req->filep) < 0)
+        {
+          ioring_post(priv, req->sqe.user_data, -EBADF);
+          kmm_free(req);
+          continue;
+        }
+
+      dq_addlast(&req->link, &queue);
+    }
+
+  __atomic_store_n(&ring->sq_head, head, __ATOMIC_RELEASE);
+  nxmutex_unlock(&priv->lock);
+
+  /* Hand the whole batch to the worker pool */
+
+  flags = spin_lock_irqsave(&g_ioring_lock);
+  dq_cat(&queue, &g_ioring_queue);
+  spin_unlock_irqrestore(&g_ioring_lock, flags);
+
+  for (ret = count > 0 ? count : ret; count > 0; count--)
+    {
+      nxsem_post(&g_ioring_sem);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ioring_wait
+ *
+ * Description:
+ *   Wait until at least 'min_complete' completions are pending.
+ *
+ ****************************************************************************/
+
+static int ioring_wait(FAR struct ioring_priv_s *priv,
+                       unsigned int min_complete, int timeout)
+{
+  FAR struct ioring *ring = priv->ring;
+  clock_t deadline = clock_systime_ticks() + MSEC2TICK(timeout);
+  clock_t now;
+  int ret;
+
+  ret = nxmutex_lock(&priv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (ring->cq_tail -
+         __atomic_load_n(&ring->cq_head, __ATOMIC_ACQUIRE) < min_complete)
+    {
+      priv->nwaiters++;
+      nxmutex_unlock(&priv->lock);
+
+      if (timeout < 0)
+        {
+          ret = nxsem_wait(&priv->waitsem);
+        }
+      else
+        {
+          now = clock_systime_ticks();
+          ret = (sclock_t)(deadline - now) > 0 ?
+                nxsem_tickwait(&priv->waitsem, deadline - now) :
+                -ETIMEDOUT;
+        }
+
+      nxmutex_lock(&priv->lock);
+      priv->nwaiters--;
+
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&priv->lock);
+  return ret == -ETIMEDOUT ? OK : ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ioring_setup
+ *
+ * Description:
+ *   Create a file descriptor that services the submissions of 'ring'.
+ *
+ ****************************************************************************/
+
+int ioring_setup(FAR struct ioring *ring, int flags)
+{
+  FAR struct ioring_priv_s *priv;
+  int ret;
+
+  if (ring == NULL || ring->sqes == NULL || ring->cqes == NULL ||
+      ring->sq_entries == 0 || ring->cq_entries == 0 ||
+      (ring->sq_entries & (ring->sq_entries - 1)) != 0 ||
+      (ring->cq_entries & (ring->cq_entries - 1)) != 0 ||
+      (flags & ~IORING_CLOEXEC) != 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = ioring_start();
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  priv = kmm_zalloc(sizeof(struct ioring_priv_s));
+  if (priv == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  nxmutex_init(&priv->lock);
+  nxsem_init(&priv->waitsem, 0, 0);
+  nxsem_init(&priv->drainsem, 0, 0);
+  priv->ring  = ring;
+  priv->crefs = 1;
+
+  ret = file_allocate(&g_ioring_inode, O_RDWR | flags, 0, priv, 0, true);
+  if (ret < 0)
+    {
+      nxmutex_destroy(&priv->lock);
+      nxsem_destroy(&priv->waitsem);
+      nxsem_destroy(&priv->drainsem);
+      kmm_free(priv);
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: ioring_enter
+ *
+ * Description:
+ *   Submit new entries of the submission queue and/or wait for
+ *   completions.
+ *
+ ****************************************************************************/
+
+int ioring_enter(int fd, unsigned int to_submit, unsigned int min_complete,
+                 int timeout)
+{
+  FAR struct ioring_priv_s *priv;
+  int submitted = 0;
+  int ret;
+
+  priv = ioring_priv_from_fd(fd);
+  if (priv == NULL)
+    {
+      set_errno(EBADF);
+      return ERROR;
+    }
+
+  if (to_submit > 0)
+    {
+      submitted = ioring_submit(priv, to_submit);
+      if (submitted < 0)
+        {
+          set_errno(-submitted);
+          return ERROR;
+        }
+    }
+
+  if (min_complete > 0 && timeout != 0)
+    {
+      ret = ioring_wait(priv, min_complete, timeout);
+      if (ret < 0)
+        {
+          set_errno(-ret);
+          return ERROR;
+        }
+    }
+
+  return submitted;
+}
@@ -66,6 +66,7 @@ static int pseudorename(FAR const char *oldpath, FAR struct inode *oldinode,
 {
   struct inode_search_s newdesc;
   FAR struct inode *newinode;
+  FAR struct inode *child;
   FAR char *subdir = NULL;
   int ret;
 
@@ -191,6 +192,16 @@ next_subdir:
   /* Copy the inode state from the old inode to the newly allocated inode */
 
   newinode->i_child   = oldinode->i_child;   /* Link to lower level inode */
+
+  /* The children are now below the new inode */
+
+  for (child = newinode->i_child; child != NULL; child = child->i_peer)
+    {
+      inode_hashdel(child);
+      child->i_parent = newinode;
+      inode_hashadd(child);
+    }
+
   newinode->i_flags   = oldinode->i_flags;   /* Flags for inode */
   newinode->u.i_ops   = oldinode->u.i_ops;   /* Inode operations */
 #ifdef CONFIG_PSEUDOFS_ATTRIBUTES
@@ -25,19 +25,208 @@
 #include <nuttx/config.h>
 
 #include <sys/sendfile.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/param.h>
 #include <stdbool.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <errno.h>
+#include <string.h>
 #include <debug.h>
 
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mm/map.h>
 #include <nuttx/net/net.h>
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
-                        off_t *offset, size_t count)
+/****************************************************************************
+ * Name: writefile
+ *
+ * Description:
+ *   Write to 'outfile' at its current position or, if 'outoffset' is not
+ *   NULL, at *outoffset which is then advanced.
+ *
+ ****************************************************************************/
+
+static ssize_t writefile(FAR struct file *outfile, FAR off_t *outoffset,
+                         FAR const void *buf, size_t nbytes)
+{
+  ssize_t nwritten;
+
+  if (outoffset == NULL)
+    {
+      return file_write(outfile, buf, nbytes);
+    }
+
+  nwritten = file_pwrite(outfile, buf, nbytes, *outoffset);
+  if (nwritten > 0)
+    {
+      *outoffset += nwritten;
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: splicepipe
+ *
+ * Description:
+ *   Let the pipe at either end of the transfer move the data straight from
+ *   or into its buffer.  -ENOSYS is returned if neither file is a pipe.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PIPES
+static ssize_t splicepipe(FAR struct file *outfile, FAR off_t *outoffset,
+                          FAR struct file *infile, FAR off_t *inoffset,
+                          size_t count, unsigned int flags)
+{
+  struct pipe_splice_s splice;
+
+  splice.count = MIN(count, INT_MAX);
+  splice.flags = flags;
+
+  if (INODE_IS_PIPE(infile->f_inode) && inoffset == NULL)
+    {
+      splice.file   = outfile;
+      splice.offset = outoffset;
+      splice.out    = false;
+      return file_ioctl(infile, PIPEIOC_SPLICE, &splice);
+    }
+
+  if (INODE_IS_PIPE(outfile->f_inode) && outoffset == NULL)
+    {
+      splice.file   = infile;
+      splice.offset = inoffset;
+      splice.out    = true;
+      return file_ioctl(outfile, PIPEIOC_SPLICE, &splice);
+    }
+
+  return -ENOSYS;
+}
+#endif
+
+/****************************************************************************
+ * Name: mapfile
+ *
+ * Description:
+ *   Write the data of a regular file whose file system can map it
+ *   directly, like tmpfs or an XIP romfs, straight from the mapping.  This
+ *   saves the copy through the I/O buffer of copyfile().  -ENOSYS is
+ *   returned if the file cannot be mapped.
+ *
+ ****************************************************************************/
+
+static ssize_t mapfile(FAR struct file *outfile, FAR off_t *outoffset,
+                       FAR struct file *infile, FAR off_t *offset,
+                       size_t count)
+{
+  struct mm_map_entry_s entry;
+  struct stat buf;
+  FAR const uint8_t *rdbuffer;
+  ssize_t nbyteswritten;
+  size_t ntransferred;
+  off_t pos;
+  int ret;
+
+  if (infile->f_inode == NULL || infile->f_inode->u.i_ops == NULL ||
+      infile->f_inode->u.i_ops->mmap == NULL ||
+      (infile->f_oflags & O_RDOK) == 0)
+    {
+      return -ENOSYS;
+    }
+
+  ret = file_fstat(infile, &buf);
+  if (ret < 0 || !S_ISREG(buf.st_mode))
+    {
+      return -ENOSYS;
+    }
+
+  pos = offset != NULL ? *offset : file_seek(infile, 0, SEEK_CUR);
+  if (pos < 0)
+    {
+      return -ENOSYS;
+    }
+
+  if (pos >= buf.st_size)
+    {
+      return 0;
+    }
+
+  if (count > buf.st_size - pos)
+    {
+      count = buf.st_size - pos;
+    }
+
+  /* Only ask the file system itself.  The rammap() fallback of mmap()
+   * would copy the whole file into memory.
+   */
+
+  memset(&entry, 0, sizeof(entry));
+  entry.offset = pos;
+  entry.length = count;
+  entry.prot   = PROT_READ;
+  entry.flags  = MAP_SHARED;
+
+  ret = infile->f_inode->u.i_ops->mmap(infile, &entry);
+  if (ret < 0)
+    {
+      return -ENOSYS;
+    }
+
+  rdbuffer = entry.vaddr;
+  for (ntransferred = 0; ntransferred < count; )
+    {
+      nbyteswritten = writefile(outfile, outoffset, rdbuffer + ntransferred,
+                                count - ntransferred);
+      if (nbyteswritten > 0)
+        {
+          ntransferred += nbyteswritten;
+        }
+      else if (nbyteswritten != -EINTR || ntransferred == 0)
+        {
+          if (ntransferred == 0)
+            {
+              ntransferred = nbyteswritten;
+            }
+
+          break;
+        }
+    }
+
+  if (entry.munmap != NULL)
+    {
+      file_munmap(entry.vaddr, entry.length);
+    }
+
+  if ((ssize_t)ntransferred > 0)
+    {
+      pos += ntransferred;
+      if (offset != NULL)
+        {
+          *offset = pos;
+        }
+      else
+        {
+          file_seek(infile, pos, SEEK_SET);
+        }
+    }
+
+  return ntransferred;
+}
+
+/****************************************************************************
+ * Name: copyfile
+ ****************************************************************************/
+
+static ssize_t copyfile(FAR struct file *outfile, FAR off_t *outoffset,
+                        FAR struct file *infile, FAR off_t *offset,
+                        size_t count)
 {
   FAR uint8_t *iobuffer;
   FAR uint8_t *wrbuffer;
@@ -143,7 +332,8 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
             {
               /* Write the buffer of data to the outfile */
 
-              nbyteswritten = file_write(outfile, wrbuffer, nbytesread);
+              nbyteswritten = writefile(outfile, outoffset, wrbuffer,
+                                        nbytesread);
 
               /* Check for a complete (or partial) write.  write() should not
                * return zero.
@@ -234,20 +424,23 @@ static ssize_t copyfile(FAR struct file *outfile, FAR struct file *infile,
  ****************************************************************************/
 
 /****************************************************************************
- * Name: file_sendfile
+ * Name: file_splice
  *
  * Description:
- *   Equivalent to the standard sendfile function except that is accepts a
- *   struct file instance instead of a file descriptor.
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
  *
  ****************************************************************************/
 
-ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
-                      off_t *offset, size_t count)
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoffset,
+                    FAR struct file *outfile, FAR off_t *outoffset,
+                    size_t count, unsigned int flags)
 {
+  ssize_t ret;
+
   if (count == 0)
     {
-      nwarn("WARNING: sendfile count is zero\n");
+      nwarn("WARNING: splice count is zero\n");
       return 0;
     }
 
@@ -259,11 +452,11 @@ ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
   FAR struct socket *psock;
 
   psock = file_socket(outfile);
-  if (psock != NULL)
+  if (psock != NULL && outoffset == NULL)
     {
       /* Then let psock_sendfile do the work. */
 
-      int ret = psock_sendfile(psock, infile, offset, count);
+      ret = psock_sendfile(psock, infile, inoffset, count);
       if (ret >= 0 || ret != -ENOSYS)
         {
           return ret;
@@ -275,11 +468,44 @@ ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
     }
 #endif
 
+#ifdef CONFIG_PIPES
+  /* A pipe moves the data straight from or into its own buffer */
+
+  ret = splicepipe(outfile, outoffset, infile, inoffset, count, flags);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+#endif
+
+  /* Write directly from the source if it can be mapped */
+
+  ret = mapfile(outfile, outoffset, infile, inoffset, count);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+
   /* No... then this is probably a file-to-file transfer.  The generic
    * copyfile() can handle that case.
    */
 
-  return copyfile(outfile, infile, offset, count);
+  return copyfile(outfile, outoffset, infile, inoffset, count);
+}
+
+/****************************************************************************
+ * Name: file_sendfile
+ *
+ * Description:
+ *   Equivalent to the standard sendfile function except that is accepts a
+ *   struct file instance instead of a file descriptor.
+ *
+ ****************************************************************************/
+
+ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
+                      off_t *offset, size_t count)
+{
+  return file_splice(infile, offset, outfile, NULL, count, 0);
 }
 
 /****************************************************************************
@@ -357,3 +583,61 @@ errout:
   set_errno(-ret);
   return ERROR;
 }
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   splice() moves data between two file descriptors.  Unlike the Linux
+ *   interface, neither of them needs to be a pipe: this is sendfile() with
+ *   an optional offset for the output as well.  Data of files that their
+ *   file system can map directly is written from the mapping without an
+ *   intermediate copy.
+ *
+ * Input Parameters:
+ *   infd      - A file (or socket) descriptor opened for reading
+ *   inoffset  - If not NULL, the offset to read from, updated on return.
+ *               The file offset of 'infd' is then not changed.
+ *   outfd     - A descriptor opened for writing
+ *   outoffset - If not NULL, the offset to write to, updated on return.
+ *               The file offset of 'outfd' is then not changed.
+ *   count     - The number of bytes to move
+ *   flags     - SPLICE_F_* flags, accepted but not used
+ *
+ * Returned Value:
+ *   The number of bytes moved on success.  On error, -1 is returned, and
+ *   errno is set appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int infd, FAR off_t *inoffset, int outfd,
+               FAR off_t *outoffset, size_t count, unsigned int flags)
+{
+  FAR struct file *outfile;
+  FAR struct file *infile;
+  ssize_t ret;
+
+  ret = fs_getfilep(outfd, &outfile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = fs_getfilep(infd, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_splice(infile, inoffset, outfile, outoffset, count, flags);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
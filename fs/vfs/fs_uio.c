@@ -0,0 +1,350 @@
+/****************************************************************************
+ * fs/vfs/fs_uio.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/cancelpt.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE ssize_t (*uio_vector_t)(FAR struct file *filep,
+                                     FAR const struct iovec *iov,
+                                     int iovcnt);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uio_check
+ *
+ * Description:
+ *   Validate an I/O vector: the count must be in range and the total size
+ *   must fit in the returned ssize_t.
+ *
+ ****************************************************************************/
+
+static int uio_check(FAR const struct iovec *iov, int iovcnt)
+{
+  size_t total = 0;
+  int i;
+
+  if (iovcnt < 0 || iovcnt > IOV_MAX || (iov == NULL && iovcnt > 0))
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      if (iov[i].iov_len > SSIZE_MAX - total)
+        {
+          return -EINVAL;
+        }
+
+      total += iov[i].iov_len;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: uio_vector
+ *
+ * Description:
+ *   Return the readv or writev method of the driver or file system that
+ *   backs 'filep', or NULL if it has none.
+ *
+ ****************************************************************************/
+
+static uio_vector_t uio_vector(FAR struct file *filep, bool write)
+{
+  FAR struct inode *inode = filep->f_inode;
+
+  if (inode == NULL || inode->u.i_ops == NULL)
+    {
+      return NULL;
+    }
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+  if (INODE_IS_MOUNTPT(inode))
+    {
+      return write ? inode->u.i_mops->writev : inode->u.i_mops->readv;
+    }
+#endif
+
+  return write ? inode->u.i_ops->writev : inode->u.i_ops->readv;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_readv
+ *
+ * Description:
+ *   file_readv() is an internal OS interface.  It is functionally similar
+ *   to the standard readv() interface except:
+ *
+ *    - It does not modify the errno variable,
+ *    - It is not a cancellation point,
+ *    - It accepts a file structure instance instead of file descriptor.
+ *
+ *   Without a readv method, each element is read in turn and the transfer
+ *   ends at the first short read.
+ *
+ * Input Parameters:
+ *   filep  - File structure instance
+ *   iov    - Array of read buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   The number of bytes read on success, 0 on an end-of-file condition, or
+ *   a negated errno value on any failure.
+ *
+ ****************************************************************************/
+
+ssize_t file_readv(FAR struct file *filep,
+                   FAR const struct iovec *iov, int iovcnt)
+{
+  uio_vector_t readv;
+  ssize_t ntotal = 0;
+  ssize_t nread;
+  int ret;
+  int i;
+
+  ret = uio_check(iov, iovcnt);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if ((filep->f_oflags & O_RDOK) == 0)
+    {
+      return -EACCES;
+    }
+
+  readv = uio_vector(filep, false);
+  if (readv != NULL)
+    {
+      return readv(filep, iov, iovcnt);
+    }
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      /* Ignore zero-length reads */
+
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      nread = file_read(filep, iov[i].iov_base, iov[i].iov_len);
+      if (nread < 0)
+        {
+          return ntotal > 0 ? ntotal : nread;
+        }
+
+      ntotal += nread;
+      if (nread < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return ntotal;
+}
+
+/****************************************************************************
+ * Name: file_writev
+ *
+ * Description:
+ *   file_writev() is an internal OS interface.  It is functionally similar
+ *   to the standard writev() interface except:
+ *
+ *    - It does not modify the errno variable,
+ *    - It is not a cancellation point,
+ *    - It accepts a file structure instance instead of file descriptor.
+ *
+ *   Without a writev method, each element is written in turn and the
+ *   transfer ends at the first short write.
+ *
+ * Input Parameters:
+ *   filep  - File structure instance
+ *   iov    - Array of write buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   The number of bytes written on success, or a negated errno value on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+ssize_t file_writev(FAR struct file *filep,
+                    FAR const struct iovec *iov, int iovcnt)
+{
+  uio_vector_t writev;
+  ssize_t ntotal = 0;
+  ssize_t nwritten;
+  int ret;
+  int i;
+
+  ret = uio_check(iov, iovcnt);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if ((filep->f_oflags & O_WROK) == 0)
+    {
+      return -EACCES;
+    }
+
+  writev = uio_vector(filep, true);
+  if (writev != NULL)
+    {
+      return writev(filep, iov, iovcnt);
+    }
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      /* Ignore zero-length writes */
+
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      nwritten = file_write(filep, iov[i].iov_base, iov[i].iov_len);
+      if (nwritten < 0)
+        {
+          return ntotal > 0 ? ntotal : nwritten;
+        }
+
+      ntotal += nwritten;
+      if (nwritten < iov[i].iov_len)
+        {
+          break;
+        }
+    }
+
+  return ntotal;
+}
+
+/****************************************************************************
+ * Name: readv
+ *
+ * Description:
+ *   The standard, POSIX readv interface.
+ *
+ * Input Parameters:
+ *   fd     - The open file descriptor for the file to be read
+ *   iov    - Array of read buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   The number of bytes read on success, 0 on an end-of-file condition, or
+ *   -1 on failure with errno set appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t readv(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct file *filep;
+  ssize_t ret;
+
+  /* readv() is a cancellation point */
+
+  enter_cancellation_point();
+
+  ret = (ssize_t)fs_getfilep(fd, &filep);
+  if (ret >= 0)
+    {
+      ret = file_readv(filep, iov, iovcnt);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: writev
+ *
+ * Description:
+ *   The standard, POSIX writev interface.
+ *
+ * Input Parameters:
+ *   fd     - The open file descriptor for the file to be written
+ *   iov    - Array of write buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   The number of bytes written on success, or -1 on failure with errno set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+ssize_t writev(int fd, FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct file *filep;
+  ssize_t ret;
+
+  /* writev() is a cancellation point */
+
+  enter_cancellation_point();
+
+  ret = (ssize_t)fs_getfilep(fd, &filep);
+  if (ret >= 0)
+    {
+      ret = file_writev(filep, iov, iovcnt);
+    }
+
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
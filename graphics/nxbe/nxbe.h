@@ -255,6 +255,15 @@ struct nxbe_state_s
   /* Rasterizing functions selected to match the BPP reported in pinfo[] */
 
   struct nxbe_plane_s plane[CONFIG_NX_NPLANES];
+
+#ifdef CONFIG_NX_COMPOSITOR
+  /* Regions of RAM backed windows not yet copied to the display (absolute
+   * device coordinates).
+   */
+
+  uint8_t ndamage;
+  struct nxgl_rect_s damage[CONFIG_NX_COMPOSITOR_NDAMAGE];
+#endif
 };
 
 /****************************************************************************
@@ -739,6 +748,48 @@ void nxbe_flush(FAR struct nxbe_window_s *wnd,
                  unsigned int stride);
 #endif
 
+/****************************************************************************
+ * Name: nxbe_damage
+ *
+ * Description:
+ *   Record that a region of the per-window framebuffer of a RAM backed
+ *   window was modified.  This replaces nxbe_flush() when drawing with
+ *   CONFIG_NX_COMPOSITOR: the region is copied to the display by the next
+ *   nxbe_composite().
+ *
+ * Input Parameters:
+ *   wnd  - The RAM backed window that was drawn into
+ *   rect - The modified region (window coordinate frame)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_COMPOSITOR
+void nxbe_damage(FAR struct nxbe_window_s *wnd,
+                 FAR const struct nxgl_rect_s *rect);
+#endif
+
+/****************************************************************************
+ * Name: nxbe_composite
+ *
+ * Description:
+ *   Copy the visible parts of the damaged regions of all RAM backed windows
+ *   from their framebuffers to the display, then forget the damage.
+ *
+ * Input Parameters:
+ *   be - The back-end state structure instance
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_COMPOSITOR
+void nxbe_composite(FAR struct nxbe_state_s *be);
+#endif
+
 /****************************************************************************
  * Name: nxbe_redraw
  *
@@ -29,6 +29,7 @@
 #include <debug.h>
 
 #include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nxaccel.h>
 #include "nxbe.h"
 
 /****************************************************************************
@@ -64,8 +65,14 @@ static void bitmap_clipcopy(FAR struct nxbe_clipops_s *cops,
 
   /* Copy the rectangular region to the graphics device. */
 
-  plane->dev.copyrectangle(&plane->pinfo, rect, bminfo->src,
-                           &bminfo->origin, bminfo->stride);
+#ifdef CONFIG_NX_ACCEL
+  if (nxgl_accel_copyrectangle(&plane->pinfo, rect, bminfo->src,
+                               &bminfo->origin, bminfo->stride) < 0)
+#endif
+    {
+      plane->dev.copyrectangle(&plane->pinfo, rect, bminfo->src,
+                               &bminfo->origin, bminfo->stride);
+    }
 
 #ifdef CONFIG_NX_UPDATE
   /* Notify external logic that the display has been updated */
@@ -312,6 +319,13 @@ void nxbe_bitmap(FAR struct nxbe_window_s *wnd,
       /* Update the per-window framebuffer */
 
       nxbe_bitmap_pwfb(wnd, dest, src, origin, stride);
+
+#ifdef CONFIG_NX_COMPOSITOR
+      /* The display is updated by the next composition */
+
+      nxbe_damage(wnd, dest);
+      return;
+#endif
     }
 #endif
 
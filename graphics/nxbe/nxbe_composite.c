@@ -0,0 +1,177 @@
+/****************************************************************************
+ * graphics/nxbe/nxbe_composite.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <debug.h>
+
+#include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nxbe.h>
+
+#include "nxbe.h"
+
+#ifdef CONFIG_NX_COMPOSITOR
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_rectarea
+ ****************************************************************************/
+
+static inline uint32_t nxbe_rectarea(FAR const struct nxgl_rect_s *rect)
+{
+  return (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+         (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxbe_damage
+ *
+ * Description:
+ *   Record that a region of the per-window framebuffer of a RAM backed
+ *   window was modified.  The region is copied to the display by the next
+ *   nxbe_composite().
+ *
+ * Input Parameters:
+ *   wnd  - The RAM backed window that was drawn into
+ *   rect - The modified region (window coordinate frame)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxbe_damage(FAR struct nxbe_window_s *wnd,
+                 FAR const struct nxgl_rect_s *rect)
+{
+  FAR struct nxbe_state_s *be = wnd->be;
+  struct nxgl_rect_s damage;
+  struct nxgl_rect_s merged;
+  uint32_t growth;
+  uint32_t least;
+  int best;
+  int i;
+
+  /* Nothing of a hidden window reaches the display */
+
+  if (NXBE_ISHIDDEN(wnd))
+    {
+      return;
+    }
+
+  /* Convert to absolute device coordinates and clip to the limits of the
+   * window and of the background screen.
+   */
+
+  nxgl_rectoffset(&damage, rect, wnd->bounds.pt1.x, wnd->bounds.pt1.y);
+  nxgl_rectintersect(&damage, &damage, &wnd->bounds);
+  nxgl_rectintersect(&damage, &damage, &be->bkgd.bounds);
+  if (nxgl_nullrect(&damage))
+    {
+      return;
+    }
+
+  /* Grow a region that the damage overlaps */
+
+  for (i = 0; i < be->ndamage; i++)
+    {
+      if (nxgl_rectoverlap(&be->damage[i], &damage))
+        {
+          nxgl_rectunion(&be->damage[i], &be->damage[i], &damage);
+          return;
+        }
+    }
+
+  if (be->ndamage < CONFIG_NX_COMPOSITOR_NDAMAGE)
+    {
+      nxgl_rectcopy(&be->damage[be->ndamage++], &damage);
+      return;
+    }
+
+  /* All regions are used, merge with the one that grows the least */
+
+  best  = 0;
+  least = UINT32_MAX;
+
+  for (i = 0; i < be->ndamage; i++)
+    {
+      nxgl_rectunion(&merged, &be->damage[i], &damage);
+      growth = nxbe_rectarea(&merged) - nxbe_rectarea(&be->damage[i]);
+      if (growth < least)
+        {
+          least = growth;
+          best  = i;
+        }
+    }
+
+  nxgl_rectunion(&be->damage[best], &be->damage[best], &damage);
+}
+
+/****************************************************************************
+ * Name: nxbe_composite
+ *
+ * Description:
+ *   Copy the visible parts of the damaged regions of all RAM backed windows
+ *   from their framebuffers to the display, then forget the damage.
+ *
+ * Input Parameters:
+ *   be - The back-end state structure instance
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxbe_composite(FAR struct nxbe_state_s *be)
+{
+  FAR struct nxbe_window_s *wnd;
+  int i;
+
+  for (i = 0; i < be->ndamage; i++)
+    {
+      /* Only RAM backed windows are damaged, the display already holds the
+       * content of the others.  nxbe_redraw() clips each window by the
+       * ones above it, so every pixel is copied from the window on top.
+       */
+
+      for (wnd = be->topwnd; wnd != NULL; wnd = wnd->below)
+        {
+          if (NXBE_ISRAMBACKED(wnd))
+            {
+              nxbe_redraw(be, wnd, &be->damage[i]);
+            }
+        }
+    }
+
+  be->ndamage = 0;
+}
+
+#endif /* CONFIG_NX_COMPOSITOR */
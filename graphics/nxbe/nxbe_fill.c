@@ -27,6 +27,7 @@
 #include <assert.h>
 
 #include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nxaccel.h>
 #include <nuttx/nx/nx.h>
 
 #include "nxbe.h"
@@ -62,7 +63,12 @@ static void nxbe_clipfill(FAR struct nxbe_clipops_s *cops,
 
   /* Draw the rectangle to the graphics device. */
 
-  plane->dev.fillrectangle(&plane->pinfo, rect, fillinfo->color);
+#ifdef CONFIG_NX_ACCEL
+  if (nxgl_accel_fillrectangle(&plane->pinfo, rect, fillinfo->color) < 0)
+#endif
+    {
+      plane->dev.fillrectangle(&plane->pinfo, rect, fillinfo->color);
+    }
 
 #ifdef CONFIG_NX_UPDATE
   /* Notify external logic that the display has been updated */
@@ -218,6 +224,13 @@ void nxbe_fill(FAR struct nxbe_window_s *wnd,
       if (NXBE_ISRAMBACKED(wnd))
         {
           nxbe_fill_pwfb(wnd, &remaining, color);
+
+#ifdef CONFIG_NX_COMPOSITOR
+          /* The display is updated by the next composition */
+
+          nxbe_damage(wnd, rect);
+          return;
+#endif
         }
 #endif
 
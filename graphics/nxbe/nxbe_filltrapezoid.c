@@ -170,11 +170,13 @@ nxbe_filltrapezoid_pwfb(FAR struct nxbe_window_s *wnd,
                         FAR const struct nxgl_trapezoid_s *trap,
                         nxgl_mxpixel_t color[CONFIG_NX_NPLANES])
 {
+#ifndef CONFIG_NX_COMPOSITOR
   FAR const void *src[CONFIG_NX_NPLANES];
-  struct nxgl_trapezoid_s reltrap;
-  struct nxgl_rect_s relbounds;
   struct nxgl_point_s origin;
   unsigned int bpp;
+#endif
+  struct nxgl_trapezoid_s reltrap;
+  struct nxgl_rect_s relbounds;
 
   /* Both the rectangle that we receive here are in absolute device
    * coordinates.  We need to restore both to windows relative coordinates.
@@ -193,6 +195,11 @@ nxbe_filltrapezoid_pwfb(FAR struct nxbe_window_s *wnd,
   wnd->be->plane[0].pwfb.filltrapezoid(wnd, &reltrap, &relbounds,
                                        color[0]);
 
+#ifdef CONFIG_NX_COMPOSITOR
+  /* The display is updated by the next composition */
+
+  nxbe_damage(wnd, &relbounds);
+#else
   /* Get the source of address of the trapezoid bounding box in the
    * framebuffer.
    */
@@ -246,6 +253,7 @@ nxbe_filltrapezoid_pwfb(FAR struct nxbe_window_s *wnd,
    */
 
   nxbe_flush(wnd, &relbounds, src, &origin, wnd->stride);
+#endif
 }
 #endif
 
@@ -315,12 +315,14 @@ static inline void nxbe_move_pwfb(FAR struct nxbe_window_s *wnd,
                                   FAR const struct nxgl_rect_s *rect,
                                   FAR const struct nxgl_point_s *offset)
 {
+#ifndef CONFIG_NX_COMPOSITOR
   FAR const void *src[CONFIG_NX_NPLANES];
-  struct nxgl_point_s destpos;
   struct nxgl_point_s origin;
+  unsigned int bpp;
+#endif
+  struct nxgl_point_s destpos;
   struct nxgl_rect_s srcrect;
   struct nxgl_rect_s destrect;
-  unsigned int bpp;
 
   /* The rectangle that we receive here is in absolute device coordinates.
    * We need to restore this to windows relative coordinates.
@@ -348,6 +350,11 @@ static inline void nxbe_move_pwfb(FAR struct nxbe_window_s *wnd,
 
   nxgl_rectoffset(&destrect, &srcrect, offset->x, offset->y);
 
+#ifdef CONFIG_NX_COMPOSITOR
+  /* The display is updated by the next composition */
+
+  nxbe_damage(wnd, &destrect);
+#else
   /* Get the source of address of the moved rectangle in the framebuffer. */
 
   bpp    = wnd->be->plane[0].pinfo.bpp;
@@ -399,6 +406,7 @@ static inline void nxbe_move_pwfb(FAR struct nxbe_window_s *wnd,
    */
 
   nxbe_flush(wnd, &destrect, src, &origin, wnd->stride);
+#endif
 }
 #endif
 
@@ -0,0 +1,231 @@
+/****************************************************************************
+ * graphics/nxglib/nxglib_accel.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nxaccel.h>
+
+#ifdef CONFIG_NX_ACCEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Blend one 8-bit channel of an image over the plane */
+
+#define NXGL_BLEND(s, d, a) (((s) * (a) + (d) * (255 - (a)) + 127) / 255)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct nxgl_accel_s *g_nxgl_accel;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxgl_accel_worth
+ *
+ * Description:
+ *   Return true if a rectangle is large enough for the accelerator.
+ *
+ ****************************************************************************/
+
+static bool nxgl_accel_worth(FAR const struct nxgl_rect_s *rect)
+{
+  return (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+         (uint32_t)(rect->pt2.y - rect->pt1.y + 1) >=
+         CONFIG_NX_ACCEL_MINPIXELS;
+}
+
+/****************************************************************************
+ * Name: nxgl_blend16
+ *
+ * Description:
+ *   Blend one RGB565 pixel.
+ *
+ ****************************************************************************/
+
+static uint16_t nxgl_blend16(uint16_t s, uint16_t d, unsigned int a)
+{
+  unsigned int r = NXGL_BLEND(s >> 11, d >> 11, a);
+  unsigned int g = NXGL_BLEND((s >> 5) & 0x3f, (d >> 5) & 0x3f, a);
+  unsigned int b = NXGL_BLEND(s & 0x1f, d & 0x1f, a);
+
+  return (uint16_t)(r << 11 | g << 5 | b);
+}
+
+/****************************************************************************
+ * Name: nxgl_blend32
+ *
+ * Description:
+ *   Blend one (A)RGB8888 pixel, the alpha byte of the plane is kept.
+ *
+ ****************************************************************************/
+
+static uint32_t nxgl_blend32(uint32_t s, uint32_t d, unsigned int a)
+{
+  uint32_t result = d & 0xff000000;
+  int shift;
+
+  for (shift = 0; shift < 24; shift += 8)
+    {
+      result |= (uint32_t)NXGL_BLEND((s >> shift) & 0xff,
+                                     (d >> shift) & 0xff, a) << shift;
+    }
+
+  return result;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxgl_accel_register
+ ****************************************************************************/
+
+void nxgl_accel_register(FAR const struct nxgl_accel_s *accel)
+{
+  g_nxgl_accel = accel;
+}
+
+/****************************************************************************
+ * Name: nxgl_accel_fillrectangle
+ ****************************************************************************/
+
+int nxgl_accel_fillrectangle(FAR struct fb_planeinfo_s *pinfo,
+                             FAR const struct nxgl_rect_s *rect,
+                             nxgl_mxpixel_t color)
+{
+  FAR const struct nxgl_accel_s *accel = g_nxgl_accel;
+
+  if (accel == NULL || accel->fillrectangle == NULL ||
+      !nxgl_accel_worth(rect))
+    {
+      return -ENOSYS;
+    }
+
+  return accel->fillrectangle(accel, pinfo, rect, color);
+}
+
+/****************************************************************************
+ * Name: nxgl_accel_copyrectangle
+ ****************************************************************************/
+
+int nxgl_accel_copyrectangle(FAR struct fb_planeinfo_s *pinfo,
+                             FAR const struct nxgl_rect_s *dest,
+                             FAR const void *src,
+                             FAR const struct nxgl_point_s *origin,
+                             unsigned int srcstride)
+{
+  FAR const struct nxgl_accel_s *accel = g_nxgl_accel;
+
+  if (accel == NULL || accel->copyrectangle == NULL ||
+      !nxgl_accel_worth(dest))
+    {
+      return -ENOSYS;
+    }
+
+  return accel->copyrectangle(accel, pinfo, dest, src, origin, srcstride);
+}
+
+/****************************************************************************
+ * Name: nxgl_blendrectangle
+ ****************************************************************************/
+
+int nxgl_blendrectangle(FAR struct fb_planeinfo_s *pinfo,
+                        FAR const struct nxgl_rect_s *dest,
+                        FAR const void *src,
+                        FAR const struct nxgl_point_s *origin,
+                        unsigned int srcstride, uint8_t alpha)
+{
+  FAR const struct nxgl_accel_s *accel = g_nxgl_accel;
+  FAR const uint8_t *sline;
+  FAR uint8_t *dline;
+  unsigned int bypp;
+  unsigned int width;
+  unsigned int x;
+  int rows;
+
+  if (accel != NULL && accel->blendrectangle != NULL &&
+      nxgl_accel_worth(dest) &&
+      accel->blendrectangle(accel, pinfo, dest, src, origin, srcstride,
+                            alpha) >= 0)
+    {
+      return OK;
+    }
+
+  if (pinfo->bpp != 16 && pinfo->bpp != 32)
+    {
+      return -ENOSYS;
+    }
+
+  bypp  = pinfo->bpp >> 3;
+  width = dest->pt2.x - dest->pt1.x + 1;
+  rows  = dest->pt2.y - dest->pt1.y + 1;
+  dline = (FAR uint8_t *)pinfo->fbmem + dest->pt1.y * pinfo->stride +
+          dest->pt1.x * bypp;
+  sline = (FAR const uint8_t *)src +
+          (dest->pt1.y - origin->y) * srcstride +
+          (dest->pt1.x - origin->x) * bypp;
+
+  while (rows-- > 0)
+    {
+      if (bypp == 2)
+        {
+          FAR const uint16_t *s = (FAR const uint16_t *)sline;
+          FAR uint16_t *d = (FAR uint16_t *)dline;
+
+          for (x = 0; x < width; x++)
+            {
+              d[x] = nxgl_blend16(s[x], d[x], alpha);
+            }
+        }
+      else
+        {
+          FAR const uint32_t *s = (FAR const uint32_t *)sline;
+          FAR uint32_t *d = (FAR uint32_t *)dline;
+
+          for (x = 0; x < width; x++)
+            {
+              d[x] = nxgl_blend32(s[x], d[x], alpha);
+            }
+        }
+
+      sline += srcstride;
+      dline += pinfo->stride;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_NX_ACCEL */
@@ -274,6 +274,19 @@ int nxmu_mousein(FAR struct nxmu_state_s *nxmu,
 void nxmu_kbdin(FAR struct nxmu_state_s *nxmu, uint8_t nch, FAR uint8_t *ch);
 #endif
 
+/****************************************************************************
+ * Name: nxmu_batch
+ *
+ * Description:
+ *   Execute the drawing commands that a client collected after
+ *   nx_batchbegin().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+void nxmu_batch(FAR const struct nxsvrmsg_batch_s *batch);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
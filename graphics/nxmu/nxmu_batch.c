@@ -0,0 +1,117 @@
+/****************************************************************************
+ * graphics/nxmu/nxmu_batch.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <debug.h>
+
+#include <nuttx/nx/nx.h>
+#include "nxmu.h"
+
+#ifdef CONFIG_NX_BATCH
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmu_batch
+ *
+ * Description:
+ *   Execute the drawing commands that a client collected after
+ *   nx_batchbegin().  Each is handled as if it had been received alone.
+ *
+ * Input Parameters:
+ *   batch - The batch message received from the client
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxmu_batch(FAR const struct nxsvrmsg_batch_s *batch)
+{
+  FAR uint8_t *cmd = batch->cmds;
+  FAR uint8_t *end = batch->cmds + batch->len;
+  FAR uint8_t *msg;
+  size_t msglen;
+
+  while (cmd + NX_BATCH_ALIGN(sizeof(size_t)) <= end)
+    {
+      msglen = *(FAR size_t *)cmd;
+      msg    = cmd + NX_BATCH_ALIGN(sizeof(size_t));
+      if (msglen < sizeof(uint32_t) || msg + msglen > end)
+        {
+          gerr("ERROR: Bad command in batch\n");
+          break;
+        }
+
+      switch (*(FAR uint32_t *)msg)
+        {
+          case NX_SVRMSG_SETPIXEL:
+            {
+              FAR struct nxsvrmsg_setpixel_s *setmsg =
+                (FAR struct nxsvrmsg_setpixel_s *)msg;
+              nxbe_setpixel(setmsg->wnd, &setmsg->pos, setmsg->color);
+            }
+            break;
+
+          case NX_SVRMSG_FILL:
+            {
+              FAR struct nxsvrmsg_fill_s *fillmsg =
+                (FAR struct nxsvrmsg_fill_s *)msg;
+              nxbe_fill(fillmsg->wnd, &fillmsg->rect, fillmsg->color);
+            }
+            break;
+
+          case NX_SVRMSG_FILLTRAP:
+            {
+              FAR struct nxsvrmsg_filltrapezoid_s *trapmsg =
+                (FAR struct nxsvrmsg_filltrapezoid_s *)msg;
+              nxbe_filltrapezoid(trapmsg->wnd, &trapmsg->clip,
+                                 &trapmsg->trap, trapmsg->color);
+            }
+            break;
+
+          case NX_SVRMSG_MOVE:
+            {
+              FAR struct nxsvrmsg_move_s *movemsg =
+                (FAR struct nxsvrmsg_move_s *)msg;
+              nxbe_move(movemsg->wnd, &movemsg->rect, &movemsg->offset);
+            }
+            break;
+
+          default:
+            gerr("ERROR: Command %" PRId32 " cannot be batched\n",
+                 *(FAR uint32_t *)msg);
+            break;
+        }
+
+      cmd = msg + NX_BATCH_ALIGN(msglen);
+    }
+}
+
+#endif /* CONFIG_NX_BATCH */
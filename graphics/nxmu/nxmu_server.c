@@ -34,6 +34,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/mqueue.h>
 #include <nuttx/nx/nx.h>
 
@@ -43,6 +44,34 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxmu_composite
+ *
+ * Description:
+ *   Copy the damage of the RAM backed windows to the display once the
+ *   current frame is over, and start the next frame.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_COMPOSITOR
+static void nxmu_composite(FAR struct nxmu_state_s *nxmu,
+                           FAR struct timespec *frame)
+{
+  struct timespec period;
+  struct timespec now;
+
+  clock_gettime(CLOCK_REALTIME, &now);
+  if (nxmu->be.ndamage > 0 && clock_timespec_compare(&now, frame) >= 0)
+    {
+      nxbe_composite(&nxmu->be);
+
+      period.tv_sec  = 0;
+      period.tv_nsec = NSEC_PER_SEC / CONFIG_NX_COMPOSITOR_FPS;
+      clock_timespec_add(&now, &period, frame);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nxmu_disconnect
  ****************************************************************************/
@@ -270,6 +299,9 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
   struct nxmu_state_s    nxmu;
   FAR struct nxsvrmsg_s *msg;
   char                   buffer[NX_MXSVRMSGLEN];
+#ifdef CONFIG_NX_COMPOSITOR
+  struct timespec        frame;
+#endif
   int                    nbytes;
   int                    ret;
 
@@ -289,15 +321,45 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
 
   nxbe_redraw(&nxmu.be, &nxmu.be.bkgd, &nxmu.be.bkgd.bounds);
 
+#ifdef CONFIG_NX_COMPOSITOR
+  clock_gettime(CLOCK_REALTIME, &frame);
+#endif
+
   /* Message Loop ***********************************************************/
 
   /* Then loop forever processing incoming messages */
 
   for (; ; )
     {
-      /* Receive the next server message */
+#ifdef CONFIG_NX_COMPOSITOR
+      /* Composite at the end of each frame, even if the clients keep the
+       * server busy.
+       */
+
+      nxmu_composite(&nxmu, &frame);
+
+      /* Receive the next server message, waiting no longer than the end of
+       * the frame if there is damage.
+       */
+
+      if (nxmu.be.ndamage > 0)
+        {
+          nbytes = nxmq_timedreceive(nxmu.conn.crdmq, buffer,
+                                     NX_MXSVRMSGLEN, 0, &frame);
+          if (nbytes == -ETIMEDOUT)
+            {
+              continue;
+            }
+        }
+      else
+#endif
+        {
+          /* Receive the next server message */
+
+          nbytes = nxmq_receive(nxmu.conn.crdmq, buffer, NX_MXSVRMSGLEN,
+                                0);
+        }
 
-      nbytes = nxmq_receive(nxmu.conn.crdmq, buffer, NX_MXSVRMSGLEN, 0);
       if (nbytes < 0)
         {
           if (nbytes != -EINTR)
@@ -364,6 +426,12 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
             {
               FAR struct nxsvrmsg_synch_s *synch =
                 (FAR struct nxsvrmsg_synch_s *)buffer;
+
+#ifdef CONFIG_NX_COMPOSITOR
+              /* The client expects to see what it drew so far */
+
+              nxbe_composite(&nxmu.be);
+#endif
               nxmu_event(synch->wnd, NXEVENT_SYNCHED, synch->arg);
             }
             break;
@@ -572,6 +640,21 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
             }
             break;
 
+#ifdef CONFIG_NX_BATCH
+          case NX_SVRMSG_BATCH: /* Execute a batch of drawing commands */
+            {
+              FAR struct nxsvrmsg_batch_s *batchmsg =
+                (FAR struct nxsvrmsg_batch_s *)buffer;
+              nxmu_batch(batchmsg);
+
+              if (batchmsg->sem_done)
+                {
+                  nxsem_post(batchmsg->sem_done);
+                }
+            }
+            break;
+#endif
+
           /* Messages sent to the background window *************************/
 
           case NX_CLIMSG_REDRAW: /* Re-draw the background window */
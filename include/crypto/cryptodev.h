@@ -131,6 +131,19 @@
 #define CRYPTO_ALG_FLAG_RNG_ENABLE  0x02 /* Has HW RNG for DH/DSA */
 #define CRYPTO_ALG_FLAG_DSA_SHA     0x04 /* Can do SHA on msg */
 
+/* The priority with which a driver claims an algorithm, or-ed into its
+ * entry of the algorithm array passed to crypto_register().  New sessions
+ * go to the driver with the highest priority for their algorithms.  A
+ * driver that gives no priority gets CRYPTO_PRIO_SOFTWARE or
+ * CRYPTO_PRIO_HARDWARE, depending on CRYPTOCAP_F_SOFTWARE.
+ */
+
+#define CRYPTO_ALG_FLAG_PRIO(p)     (((p) & 0xff) << 8)
+#define CRYPTO_ALG_PRIO(f)          (((f) >> 8) & 0xff)
+
+#define CRYPTO_PRIO_SOFTWARE        64
+#define CRYPTO_PRIO_HARDWARE        128
+
 /* Standard initialization structure beginning */
 
 struct cryptoini
@@ -332,6 +345,15 @@ struct crypt_op
   caddr_t iv;
 };
 
+/* A batch of operations for CIOCASYNCCRYPTM and CIOCASYNCFETCHM */
+
+struct crypt_mop
+{
+  unsigned count;           /* In: entries of ops/status, out: ops done */
+  FAR struct crypt_op *ops;
+  FAR int *status;          /* Out: result of each fetched op */
+};
+
 /* hamc buffer, software & hardware need it */
 
 extern const uint8_t hmac_ipad_buffer[HMAC_MAX_BLOCK_LEN];
@@ -353,7 +375,20 @@ extern const uint8_t hmac_opad_buffer[HMAC_MAX_BLOCK_LEN];
 #define CIOCKEY                 104
 #define CIOCASYMFEAT            105
 
+/* Asynchronous operations: queue struct crypt_op (or a batch of them) and
+ * take the finished ones back later, in the order that they finish.
+ * poll() reports POLLIN when there is a finished operation to fetch and
+ * POLLOUT when there is room to queue more.
+ */
+
+#define CIOCASYNCCRYPT          106
+#define CIOCASYNCFETCH          107
+#define CIOCASYNCCRYPTM         108
+#define CIOCASYNCFETCHM         109
+
 int crypto_newsession(FAR uint64_t *, FAR struct cryptoini *, int);
+int crypto_driver_newsession(uint32_t, FAR uint64_t *,
+                             FAR struct cryptoini *);
 int crypto_freesession(uint64_t);
 int crypto_register(uint32_t, FAR int *,
                     CODE int (*)(uint32_t *, struct cryptoini *),
@@ -239,6 +239,58 @@ struct dq_frame_f32_s
 
 typedef struct dq_frame_f32_s dq_frame_f32_t;
 
+#ifdef CONFIG_LIBDSP_BATCH
+
+/* Frames of a batch of motors, as a structure of arrays: element i of each
+ * array belongs to the motor i.  The arrays of one frame must not overlap
+ * with the arrays of another frame of the same call.
+ */
+
+struct abc_batch_f32_s
+{
+  FAR float *a;                /* A components */
+  FAR float *b;                /* B components */
+  FAR float *c;                /* C components */
+};
+
+struct ab_batch_f32_s
+{
+  FAR float *a;                /* Alpha components */
+  FAR float *b;                /* Beta components */
+};
+
+struct dq_batch_f32_s
+{
+  FAR float *d;                /* Direct components */
+  FAR float *q;                /* Quadrature components */
+};
+
+struct angle_batch_f32_s
+{
+  FAR float *sin;              /* Phase angle sines */
+  FAR float *cos;              /* Phase angle cosines */
+};
+
+/* PI controllers of a batch of motors.  The flags are common to all the
+ * controllers, the coefficients and the state are per motor.
+ */
+
+struct pi_batch_f32_s
+{
+  bool       aw_en;            /* Integral part decay if saturated */
+  bool       ireset_en;        /* Intergral part reset if saturated */
+  bool       pisat_en;         /* PI saturation enabled */
+  FAR float *KP;               /* Proportional coefficients */
+  FAR float *KI;               /* Integral coefficients */
+  FAR float *KC;               /* Integral anti-windup decay coefficients */
+  FAR float *sat_min;          /* Output lower limits */
+  FAR float *sat_max;          /* Output upper limits */
+  FAR float *part_i;           /* Integral parts */
+  FAR float *aw;               /* Integral anti-windup decay parts */
+  FAR float *out;              /* Controller outputs */
+};
+#endif
+
 /* Space Vector Modulation data for 3-phase system */
 
 struct svm3_state_f32_s
@@ -509,6 +561,26 @@ void park_transform(FAR phase_angle_f32_t *angle, FAR ab_frame_f32_t *ab,
 void inv_park_transform(FAR phase_angle_f32_t *angle, FAR dq_frame_f32_t *dq,
                         FAR ab_frame_f32_t *ab);
 
+#ifdef CONFIG_LIBDSP_BATCH
+
+/* Batched transformation and PI controller functions */
+
+void clarke_transform_batch(FAR const struct abc_batch_f32_s *abc,
+                            FAR const struct ab_batch_f32_s *ab, size_t n);
+void inv_clarke_transform_batch(FAR const struct ab_batch_f32_s *ab,
+                                FAR const struct abc_batch_f32_s *abc,
+                                size_t n);
+void park_transform_batch(FAR const struct angle_batch_f32_s *angle,
+                          FAR const struct ab_batch_f32_s *ab,
+                          FAR const struct dq_batch_f32_s *dq, size_t n);
+void inv_park_transform_batch(FAR const struct angle_batch_f32_s *angle,
+                              FAR const struct dq_batch_f32_s *dq,
+                              FAR const struct ab_batch_f32_s *ab,
+                              size_t n);
+void pi_controller_batch(FAR const struct pi_batch_f32_s *pi,
+                         FAR const float *err, size_t n);
+#endif
+
 /* Phase angle related functions */
 
 void angle_norm(FAR float *angle, float per, float bottom, float top);
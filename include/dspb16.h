@@ -229,6 +229,57 @@ struct dq_frame_b16_s
 
 typedef struct dq_frame_b16_s dq_frame_b16_t;
 
+#ifdef CONFIG_LIBDSP_BATCH
+
+/* Frames of a batch of motors, as a structure of arrays: element i of each
+ * array belongs to the motor i.
+ */
+
+struct abc_batch_b16_s
+{
+  FAR b16_t *a;                   /* A components */
+  FAR b16_t *b;                   /* B components */
+  FAR b16_t *c;                   /* C components */
+};
+
+struct ab_batch_b16_s
+{
+  FAR b16_t *a;                   /* Alpha components */
+  FAR b16_t *b;                   /* Beta components */
+};
+
+struct dq_batch_b16_s
+{
+  FAR b16_t *d;                   /* Direct components */
+  FAR b16_t *q;                   /* Quadrature components */
+};
+
+struct angle_batch_b16_s
+{
+  FAR b16_t *sin;                 /* Phase angle sines */
+  FAR b16_t *cos;                 /* Phase angle cosines */
+};
+
+/* PI controllers of a batch of motors.  The flags are common to all the
+ * controllers, the coefficients and the state are per motor.
+ */
+
+struct pi_batch_b16_s
+{
+  bool       aw_en;               /* Integral part decay if saturated */
+  bool       ireset_en;           /* Intergral part reset if saturated */
+  bool       pisat_en;            /* PI saturation enabled */
+  FAR b16_t *KP;                  /* Proportional coefficients */
+  FAR b16_t *KI;                  /* Integral coefficients */
+  FAR b16_t *KC;                  /* Integral anti-windup decay coeffs */
+  FAR b16_t *sat_min;             /* Output lower limits */
+  FAR b16_t *sat_max;             /* Output upper limits */
+  FAR b16_t *part_i;              /* Integral parts */
+  FAR b16_t *aw;                  /* Integral anti-windup decay parts */
+  FAR b16_t *out;                 /* Controller outputs */
+};
+#endif
+
 /* Space Vector Modulation data for 3-phase system */
 
 struct svm3_state_b16_s
@@ -491,6 +542,28 @@ void park_transform_b16(FAR phase_angle_b16_t *angle, FAR ab_frame_b16_t *ab,
 void inv_park_transform_b16(FAR phase_angle_b16_t *angle,
                             FAR dq_frame_b16_t *dq, FAR ab_frame_b16_t *ab);
 
+#ifdef CONFIG_LIBDSP_BATCH
+
+/* Batched transformation and PI controller functions */
+
+void clarke_transform_batch_b16(FAR const struct abc_batch_b16_s *abc,
+                                FAR const struct ab_batch_b16_s *ab,
+                                size_t n);
+void inv_clarke_transform_batch_b16(FAR const struct ab_batch_b16_s *ab,
+                                    FAR const struct abc_batch_b16_s *abc,
+                                    size_t n);
+void park_transform_batch_b16(FAR const struct angle_batch_b16_s *angle,
+                              FAR const struct ab_batch_b16_s *ab,
+                              FAR const struct dq_batch_b16_s *dq,
+                              size_t n);
+void inv_park_transform_batch_b16(FAR const struct angle_batch_b16_s *angle,
+                                  FAR const struct dq_batch_b16_s *dq,
+                                  FAR const struct ab_batch_b16_s *ab,
+                                  size_t n);
+void pi_controller_batch_b16(FAR const struct pi_batch_b16_s *pi,
+                             FAR const b16_t *err, size_t n);
+#endif
+
 /* Phase angle related functions */
 
 void angle_norm_b16(FAR b16_t *angle, b16_t per, b16_t bottom, b16_t top);
@@ -102,6 +102,8 @@
 #define F_ADD_SEALS     16 /* Add the bit-mask argument arg to the set of seals of the inode */
 #define F_GET_SEALS     17 /* Get (as the function result) the current set of seals of the inode */
 #define F_DUPFD_CLOEXEC 18 /* Duplicate file descriptor with close-on-exit set.  */
+#define F_SETPIPE_SZ    19 /* Set the size of the buffer of a pipe (linux) */
+#define F_GETPIPE_SZ    20 /* Get the size of the buffer of a pipe (linux) */
 
 /* For posix fcntl() and lockf() */
 
@@ -142,6 +144,13 @@
 #define F_SEAL_WRITE        0x0008 /* Prevent writes */
 #define F_SEAL_FUTURE_WRITE 0x0010 /* Prevent future writes while mapped */
 
+/* Flags for splice() */
+
+#define SPLICE_F_MOVE       0x0001 /* Move pages instead of copying */
+#define SPLICE_F_NONBLOCK   0x0002 /* Do not block on I/O */
+#define SPLICE_F_MORE       0x0004 /* More data will be coming */
+#define SPLICE_F_GIFT       0x0008 /* Pages passed in are a gift */
+
 /* int creat(const char *path, mode_t mode);
  *
  * is equivalent to open with O_WRONLY|O_CREAT|O_TRUNC.
@@ -203,6 +212,9 @@ int fcntl(int fd, int cmd, ...);
 
 int posix_fallocate(int fd, off_t offset, off_t len);
 
+ssize_t splice(int infd, FAR off_t *inoffset, int outfd,
+               FAR off_t *outoffset, size_t count, unsigned int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,124 @@
+/****************************************************************************
+ * include/lz4.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_LZ4_H
+#define __INCLUDE_LZ4_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_LIBC_LZ4
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Limits of the LZ4 block format */
+
+#define LZ4_MIN_MATCH      4   /* Shortest match */
+#define LZ4_LAST_LITERALS  5   /* The last bytes of a block are literals */
+#define LZ4_MF_LIMIT       12  /* No match starts in the last bytes */
+#define LZ4_MAX_DISTANCE   65535
+
+/* Worst case size of 'n' bytes of incompressible input */
+
+#define LZ4_COMPRESSBOUND(n) ((n) + (n) / 255 + 16)
+
+/* Size of the match finder hash table of lz4_compress() */
+
+#ifndef LZ4_HLOG
+#  define LZ4_HLOG         12
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Working memory of lz4_compress(), one offset per hash slot */
+
+typedef uint32_t lz4_state_t[1 << LZ4_HLOG];
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: lz4_compress
+ *
+ * Description:
+ *   Compress in_len bytes stored at in_data into one block in the LZ4
+ *   block format at out_data, up to a maximum of out_len bytes.  htab is
+ *   the working memory, it does not need to be initialized.
+ *
+ *   A 0 is returned if the block does not fit in the output buffer, so
+ *   an out_len less than in_len only accepts data that actually shrinks.
+ *   An out_len of LZ4_COMPRESSBOUND(in_len) always fits.  Otherwise the
+ *   number of compressed bytes is returned.
+ *
+ *   The buffers must not be overlapping.
+ *
+ ****************************************************************************/
+
+unsigned int lz4_compress(FAR const void *in_data, unsigned int in_len,
+                          FAR void *out_data, unsigned int out_len,
+                          lz4_state_t htab);
+
+/****************************************************************************
+ * Name: lz4_decompress
+ *
+ * Description:
+ *   Decompress one block in the LZ4 block format (no frame header) stored
+ *   at in_data with length in_len.  The result will be stored at out_data
+ *   up to a maximum of out_len bytes.
+ *
+ *   If the output buffer is not large enough to hold the decompressed
+ *   data, a 0 is returned and errno is set to E2BIG.  If an error in the
+ *   compressed data is detected, a 0 is returned and errno is set to
+ *   EINVAL.  Otherwise the number of decompressed bytes is returned.
+ *
+ *   A sequence is a token byte, the literal length extension, the
+ *   literals, a 16-bit little-endian match offset and the match length
+ *   extension.  The last sequence ends after its literals.
+ *
+ ****************************************************************************/
+
+unsigned int lz4_decompress(FAR const void *in_data, unsigned int in_len,
+                            FAR void *out_data, unsigned int out_len);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_LIBC_LZ4 */
+#endif /* __INCLUDE_LZ4_H */
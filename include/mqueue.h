@@ -34,6 +34,14 @@
 
 #define MQ_NONBLOCK O_NONBLOCK
 
+/* Non-standard mq_attr.mq_flags bit that may be given to mq_open() when
+ * the queue is created: keep messages in a lock-free ring of fixed size
+ * slots.  Such a queue is strictly FIFO; message priorities are returned
+ * but do not reorder messages.  Requires CONFIG_MQ_RINGBUF.
+ */
+
+#define MQ_RINGBUF  (1 << 24)
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
@@ -118,6 +118,14 @@
  *   EAI_SYSTEM      - A system error occurred. The error code can be found
  *                     in errno.
  *   EAI_OVERFLOW    - An argument buffer overflowed.
+ *
+ * And, as in glibc, for the requests of getaddrinfo_a():
+ *
+ *   EAI_INPROGRESS  - The request has not completed yet.
+ *   EAI_CANCELED    - The request was canceled.
+ *   EAI_NOTCANCELED - The request could not be canceled.
+ *   EAI_ALLDONE     - The requests have all completed.
+ *   EAI_INTR        - Interrupted by a signal.
  */
 
 #define EAI_AGAIN       1
@@ -130,6 +138,16 @@
 #define EAI_SOCKTYPE    8
 #define EAI_SYSTEM      9
 #define EAI_OVERFLOW    10
+#define EAI_INPROGRESS  11
+#define EAI_CANCELED    12
+#define EAI_NOTCANCELED 13
+#define EAI_ALLDONE     14
+#define EAI_INTR        15
+
+/* Modes of getaddrinfo_a() */
+
+#define GAI_WAIT        0 /* Wait for the requests to complete */
+#define GAI_NOWAIT      1 /* Return once the requests are queued */
 
 /* h_errno values that may be returned by gethosbyname(), gethostbyname_r(),
  * gethostbyaddr(), or gethostbyaddr_r()
@@ -251,6 +269,24 @@ struct addrinfo
   FAR struct addrinfo *ai_next;      /* Pointer to next in list. */
 };
 
+/* A request of getaddrinfo_a() */
+
+struct gaicb
+{
+  FAR const char            *ar_name;    /* Name to look up */
+  FAR const char            *ar_service; /* Service to look up */
+  FAR const struct addrinfo *ar_request; /* Hints, as for getaddrinfo() */
+  FAR struct addrinfo       *ar_result;  /* The addresses found */
+
+  /* Internal to the implementation */
+
+  int                        __return;   /* Result, as for gai_error() */
+  int                        __state;    /* Queued, running or done */
+};
+
+struct sigevent;
+struct timespec;
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -299,6 +335,13 @@ int                  getaddrinfo(FAR const char *nodename,
                                  FAR const char *servname,
                                  FAR const struct addrinfo *hints,
                                  FAR struct addrinfo **res);
+int                  getaddrinfo_a(int mode, FAR struct gaicb *list[],
+                                   int nitems, FAR struct sigevent *sevp);
+int                  gai_error(FAR struct gaicb *req);
+int                  gai_cancel(FAR struct gaicb *req);
+int                  gai_suspend(FAR const struct gaicb * const list[],
+                                 int nitems,
+                                 FAR const struct timespec *timeout);
 int                  getnameinfo(FAR const struct sockaddr *sa,
                                  socklen_t salen, FAR char *node,
                                  socklen_t nodelen, FAR char *service,
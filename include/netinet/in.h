@@ -112,6 +112,8 @@
 #define IP_TTL                (__SO_PROTOCOL + 14) /* The IP TTL (time to live)
                                                     * of IP packets sent by the
                                                     * network stack */
+#define IP_RECVERR            (__SO_PROTOCOL + 15) /* Error queue messages,
+                                                    * see MSG_ERRQUEUE */
 
 /* SOL_IPV6 protocol-level socket options. */
 
@@ -134,6 +136,21 @@
                                                     * field */
 #define IPV6_RECVHOPLIMIT     (__SO_PROTOCOL + 11) /* Access the hop limit field */
 #define IPV6_HOPLIMIT         (__SO_PROTOCOL + 12) /* Hop limit */
+#define IPV6_RECVERR          (__SO_PROTOCOL + 13) /* Error queue messages,
+                                                    * see MSG_ERRQUEUE */
+
+/* Origins and codes of the struct sock_extended_err of an error queue
+ * message.
+ */
+
+#define SO_EE_ORIGIN_NONE          0
+#define SO_EE_ORIGIN_LOCAL         1
+#define SO_EE_ORIGIN_ICMP          2
+#define SO_EE_ORIGIN_ICMP6         3
+#define SO_EE_ORIGIN_ZEROCOPY      5 /* ee_info..ee_data MSG_ZEROCOPY sends
+                                      * completed */
+
+#define SO_EE_CODE_ZEROCOPY_COPIED 1 /* The data was copied */
 
 /* Values used with SIOCSIFMCFILTER and SIOCGIFMCFILTER ioctl's */
 
@@ -342,6 +359,19 @@ struct in6_pktinfo
   int             ipi6_ifindex;     /* send/recv interface index */
 };
 
+/* The IP_RECVERR/IPV6_RECVERR control message read with MSG_ERRQUEUE */
+
+struct sock_extended_err
+{
+  uint32_t        ee_errno;         /* Error number, 0 for notifications */
+  uint8_t         ee_origin;        /* SO_EE_ORIGIN_* */
+  uint8_t         ee_type;          /* ICMP type */
+  uint8_t         ee_code;          /* ICMP code or SO_EE_CODE_* */
+  uint8_t         ee_pad;
+  uint32_t        ee_info;          /* Additional information */
+  uint32_t        ee_data;          /* Other data */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -31,6 +31,18 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* UDP protocol (SOL_UDP) socket options */
+
+#define UDP_SEGMENT      (__SO_PROTOCOL + 0) /* Split sends in datagrams of
+                                              * this payload size (int) */
+#define UDP_GRO          (__SO_PROTOCOL + 1) /* Coalesce received datagrams,
+                                              * the size is reported by a
+                                              * UDP_GRO cmsg (int) */
+
+/* The maximum number of datagrams produced by one UDP_SEGMENT send */
+
+#define UDP_MAX_SEGMENTS 64
+
 /* UDP header as specified by RFC 768, August 1980. */
 
 struct udphdr
@@ -28,10 +28,66 @@
 #include <nuttx/config.h>
 #include <stdint.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Packet types (sll_pkttype) */
+
+#define PACKET_HOST         0    /* To us */
+#define PACKET_BROADCAST    1    /* To all */
+#define PACKET_MULTICAST    2    /* To group */
+#define PACKET_OTHERHOST    3    /* To someone else */
+#define PACKET_OUTGOING     4    /* Outgoing of any type */
+
+/* Packet socket options (level SOL_PACKET) */
+
+#define PACKET_RX_RING      5    /* arg: struct tpacket_req3 */
+#define PACKET_STATISTICS   6    /* arg: struct tpacket_stats_v3 */
+#define PACKET_VERSION      10   /* arg: int, enum tpacket_versions */
+#define PACKET_TX_RING      13   /* arg: struct tpacket_req3 */
+
+/* Status of a block or a frame of a memory-mapped ring (tp_status and
+ * block_status).  A block or a frame is owned by the kernel while
+ * TP_STATUS_KERNEL (RX) or TP_STATUS_AVAILABLE (TX), and by the
+ * application otherwise.
+ */
+
+#define TP_STATUS_KERNEL       0
+#define TP_STATUS_USER         (1 << 0)
+#define TP_STATUS_LOSING       (1 << 2)
+#define TP_STATUS_BLK_TMO      (1 << 5)
+
+#define TP_STATUS_AVAILABLE    0
+#define TP_STATUS_SEND_REQUEST (1 << 0)
+#define TP_STATUS_SENDING      (1 << 1)
+#define TP_STATUS_WRONG_FORMAT (1 << 2)
+
+/* The headers in a ring are aligned to TPACKET_ALIGNMENT bytes */
+
+#define TPACKET_ALIGNMENT   16
+#define TPACKET_ALIGN(x)    (((x) + TPACKET_ALIGNMENT - 1) & \
+                             ~(TPACKET_ALIGNMENT - 1))
+
+/* The size of the frame header and address, the data of a received frame
+ * starts at the next alignment and the data of a frame to send starts at
+ * TPACKET3_HDRLEN - sizeof(struct sockaddr_ll).
+ */
+
+#define TPACKET3_HDRLEN     (TPACKET_ALIGN(sizeof(struct tpacket3_hdr)) + \
+                             sizeof(struct sockaddr_ll))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+enum tpacket_versions
+{
+  TPACKET_V1,
+  TPACKET_V2,
+  TPACKET_V3
+};
+
 struct sockaddr_ll
 {
   unsigned short sll_family;
@@ -43,4 +99,91 @@ struct sockaddr_ll
   unsigned char  sll_addr[8];
 };
 
+/* Requested layout of a ring.  The RX ring is made of tp_block_nr blocks
+ * of tp_block_size bytes, closed when full or tp_retire_blk_tov
+ * milliseconds after their first frame.  The TX ring is made of
+ * tp_frame_nr frames of tp_frame_size bytes.  The RX ring is mapped first,
+ * followed by the TX ring.
+ */
+
+struct tpacket_req3
+{
+  unsigned int   tp_block_size;      /* Size of a block */
+  unsigned int   tp_block_nr;        /* Number of blocks */
+  unsigned int   tp_frame_size;      /* Size of a frame */
+  unsigned int   tp_frame_nr;        /* Total number of frames */
+  unsigned int   tp_retire_blk_tov;  /* Block timeout in msec */
+  unsigned int   tp_sizeof_priv;     /* Private area of each block */
+  unsigned int   tp_feature_req_word;
+};
+
+struct tpacket_stats_v3
+{
+  unsigned int   tp_packets;         /* Frames received */
+  unsigned int   tp_drops;           /* Frames dropped, the ring was full */
+  unsigned int   tp_freeze_q_cnt;    /* Times the ring was found full */
+};
+
+struct tpacket_bd_ts
+{
+  unsigned int   ts_sec;
+  union
+  {
+    unsigned int ts_usec;
+    unsigned int ts_nsec;
+  };
+};
+
+struct tpacket_hdr_v1
+{
+  uint32_t       block_status;        /* TP_STATUS_KERNEL or _USER */
+  uint32_t       num_pkts;            /* Number of frames in the block */
+  uint32_t       offset_to_first_pkt; /* From the start of the block */
+  uint32_t       blk_len;             /* Bytes used in the block */
+  uint64_t       seq_num;             /* Sequence number of the block */
+  struct tpacket_bd_ts ts_first_pkt;
+  struct tpacket_bd_ts ts_last_pkt;
+};
+
+union tpacket_bd_header_u
+{
+  struct tpacket_hdr_v1 bh1;
+};
+
+/* Header at the start of each block of a TPACKET_V3 RX ring */
+
+struct tpacket_block_desc
+{
+  uint32_t       version;
+  uint32_t       offset_to_priv;
+  union tpacket_bd_header_u hdr;
+};
+
+struct tpacket_hdr_variant1
+{
+  uint32_t       tp_rxhash;
+  uint32_t       tp_vlan_tci;
+  uint16_t       tp_vlan_tpid;
+  uint16_t       tp_padding;
+};
+
+/* Header of each frame of a TPACKET_V3 ring */
+
+struct tpacket3_hdr
+{
+  uint32_t       tp_next_offset;      /* To the next frame of the block */
+  uint32_t       tp_sec;
+  uint32_t       tp_nsec;
+  uint32_t       tp_snaplen;          /* Bytes of the frame in the ring */
+  uint32_t       tp_len;              /* Length of the frame */
+  uint32_t       tp_status;
+  uint16_t       tp_mac;              /* From the header to the frame */
+  uint16_t       tp_net;              /* From the header to the payload */
+  union
+  {
+    struct tpacket_hdr_variant1 hv1;
+  };
+  uint8_t        tp_padding[8];
+};
+
 #endif /* __INCLUDE_NETPACKET_PACKET_H */
@@ -258,6 +258,9 @@ struct addrenv_s
   struct arch_addrenv_s addrenv; /* The address environment page directory  */
   struct work_s         work;    /* Worker to free address environment      */
   int                   refs;    /* Users of address environment            */
+#ifdef CONFIG_ARCH_HAVE_ADDRENV_TEXTSHARE
+  FAR struct addrenv_s *textenv; /* Owner of shared .text pages, if any     */
+#endif
 };
 
 typedef struct addrenv_s addrenv_t;
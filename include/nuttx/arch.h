@@ -480,6 +480,26 @@ int up_backtrace(FAR struct tcb_s *tcb,
                  FAR void **buffer, int size, int skip);
 #endif /* CONFIG_ARCH_HAVE_BACKTRACE */
 
+/****************************************************************************
+ * Name: up_getusrpc
+ *
+ * Description:
+ *   Return the program counter saved in a register context.
+ *
+ * Input Parameters:
+ *   regs - The register context, or NULL for the context interrupted by
+ *          the interrupt being handled on this CPU
+ *
+ * Returned Value:
+ *   The saved program counter; zero if 'regs' is NULL and the CPU is not
+ *   handling an interrupt.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_GETUSRPC
+uintptr_t up_getusrpc(FAR void *regs);
+#endif
+
 /****************************************************************************
  * Name: up_schedule_sigaction
  *
@@ -823,6 +843,8 @@ int up_copy_section(FAR void *dest, FAR const void *src, size_t n);
  *   up_addrenv_select   - Instantiate an address environment
  *   up_addrenv_clone    - Copy an address environment from one location to
  *                         another.
+ *   up_addrenv_share_text - Map the .text of one address environment into
+ *                         another.
  *
  * Higher-level interfaces used by the tasking logic.  These interfaces are
  * used by the functions in sched/ and all operate on the thread which whose
@@ -1089,6 +1111,32 @@ int up_addrenv_clone(FAR const arch_addrenv_t *src,
                      FAR arch_addrenv_t *dest);
 #endif
 
+/****************************************************************************
+ * Name: up_addrenv_share_text
+ *
+ * Description:
+ *   Replace the .text pages of an address environment with those of
+ *   another one, so that both run the same physical copy of the program.
+ *   Both must have been created by up_addrenv_create() with the same
+ *   textsize.  The shared pages are mapped read/execute only and are not
+ *   freed by up_addrenv_destroy(addrenv); 'src' must outlive 'addrenv'.
+ *
+ * Input Parameters:
+ *   src      - The address environment that owns the .text pages.
+ *   addrenv  - The address environment that will share them.
+ *   textsize - The size of the .text region in bytes.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_ARCH_ADDRENV) && \
+    defined(CONFIG_ARCH_HAVE_ADDRENV_TEXTSHARE)
+int up_addrenv_share_text(FAR const arch_addrenv_t *src,
+                          FAR arch_addrenv_t *addrenv, size_t textsize);
+#endif
+
 /****************************************************************************
  * Name: up_addrenv_attach
  *
@@ -2228,6 +2276,25 @@ int up_cpu_paused(int cpu);
 int up_cpu_resume(int cpu);
 #endif
 
+/****************************************************************************
+ * Name: up_send_smp_call
+ *
+ * Description:
+ *   Raise the inter-processor interrupt that is handled by
+ *   nxsched_smp_call_handler() on each CPU in 'cpuset'.
+ *
+ * Input Parameters:
+ *   cpuset - The set of CPUs to interrupt
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+void up_send_smp_call(cpu_set_t cpuset);
+#endif
+
 /****************************************************************************
  * Name: up_romgetc
  *
@@ -2698,6 +2765,57 @@ unsigned long up_perf_gettime(void);
 unsigned long up_perf_getfreq(void);
 void up_perf_convert(unsigned long elapsed, FAR struct timespec *ts);
 
+/****************************************************************************
+ * Name: up_pmu_start/up_pmu_read
+ *
+ * Description:
+ *   up_pmu_start() programs the performance counters of this CPU to count
+ *   the PERFCOUNT_* events of <nuttx/perfcount.h> and starts them.  It
+ *   returns the mask (1 << PERFCOUNT_*) of the events that this CPU can
+ *   count.
+ *
+ *   up_pmu_read() returns the current values of the free running counters
+ *   of this CPU, PERFCOUNT_NEVENTS of them.  Only the entries started by
+ *   up_pmu_start() are written.  The counters wrap at 32 bits.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_PMU
+uint32_t up_pmu_start(void);
+void up_pmu_read(FAR uint32_t *counts);
+#endif
+
+/****************************************************************************
+ * Name: up_irq_timestamp
+ *
+ * Description:
+ *   Return the up_perf_gettime() value at which the interrupt currently
+ *   being dispatched was raised, as latched by the hardware or by the
+ *   earliest entry code, or zero if that is not known for this IRQ.  Used
+ *   by the IRQ monitor to measure entry latency.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_IRQ_TIMESTAMP
+unsigned long up_irq_timestamp(int irq);
+#endif
+
+/****************************************************************************
+ * Name: up_vdso_getfreq
+ *
+ * Description:
+ *   Return the frequency in Hz of the counter that up_vdso_counter()
+ *   reads.  up_vdso_counter() itself is an inline function of
+ *   <arch/arch.h> since it is also called from user space: it returns a
+ *   free running 64-bit counter that unprivileged code can read without
+ *   trapping.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_VDSO_COUNTER
+uint32_t up_vdso_getfreq(void);
+#endif
+
 /****************************************************************************
  * Name: up_show_cpuinfo
  *
@@ -92,6 +92,12 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * AUDIOIOC_GETRING - Get the ring buffer of the device for mmap().  Sent by
+ *   the upper half to the lower half, which allocates the ring if needed.
+ *
+ *   ioctl argument:  Pointer to a FAR struct audio_ring_s * to receive the
+ *                    ring.
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -114,6 +120,7 @@
 #define AUDIOIOC_SETPARAMTER        _AUDIOIOC(18)
 #define AUDIOIOC_GETLATENCY         _AUDIOIOC(19)
 #define AUDIOIOC_FLUSH              _AUDIOIOC(20)
+#define AUDIOIOC_GETRING            _AUDIOIOC(21)
 
 /* Audio Device Types *******************************************************/
 
@@ -320,6 +327,15 @@
 #define AUDIO_CALLBACK_IOERR        0x02
 #define AUDIO_CALLBACK_COMPLETE     0x03
 #define AUDIO_CALLBACK_MESSAGE      0x04
+#define AUDIO_CALLBACK_PERIOD       0x05
+
+/* Memory mapped ring buffer ************************************************/
+
+/* Offset of the samples from the start of the ring, the header keeps a
+ * cache line of its own.
+ */
+
+#define AUDIO_RING_DATA             64
 
 /* Audio Pipeline Buffer (AP Buffer) flags **********************************/
 
@@ -462,6 +478,26 @@ struct ap_buffer_s
   FAR uint8_t           *samp;      /* Offset of the first sample */
 };
 
+#ifdef CONFIG_AUDIO_MMAP
+/* This structure is the header of the ring buffer that an application maps
+ * with mmap() of the audio device, the samples follow at AUDIO_RING_DATA.
+ * Both positions are free running byte counts, taken modulo buffer_size
+ * to index the samples.  The driver moves hw_ptr on by period_size at each
+ * period interrupt and wakes the poll() waiters, the application moves
+ * appl_ptr on after it wrote (playback) or read (capture) the samples.
+ */
+
+struct audio_ring_s
+{
+  volatile uint32_t     hw_ptr;      /* Bytes done by the device */
+  volatile uint32_t     appl_ptr;    /* Bytes done by the application */
+  uint32_t              buffer_size; /* Size of the samples in bytes */
+  uint32_t              period_size; /* Bytes between two wakeups */
+  volatile uint32_t     xruns;       /* Number of underruns or overruns */
+  uint8_t               playback;    /* Nonzero: output, zero: input */
+};
+#endif
+
 /* Structure defining the messages passed to a listening audio thread
  * for dequeuing buffers and other operations.  Also used to allocate
  * and enqueue buffers via the AUDIOIOC_ALLOCBUFFER, AUDIOIOC_FREEBUFFER,
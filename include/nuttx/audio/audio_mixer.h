@@ -0,0 +1,188 @@
+/****************************************************************************
+ * include/nuttx/audio/audio_mixer.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H
+#define __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef CONFIG_AUDIO_MIXER
+#include <nuttx/audio/audio.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Gains are Q15, the unity gain leaves the samples as they are */
+
+#define AUDIO_GAIN_UNITY          0x7fff
+
+/* The sample rate converter interpolates between input samples with a
+ * polyphase FIR filter of AUDIO_SRC_NTAPS taps, the fraction of the
+ * position selects one of AUDIO_SRC_NPHASES sets of coefficients.
+ */
+
+#define AUDIO_SRC_NTAPS           8
+#define AUDIO_SRC_NPHASES         32
+#define AUDIO_SRC_ONE             0x10000 /* Q16 position of one sample */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The state of a sample rate converter, the input and output are
+ * interleaved 16-bit frames of 'nchannels' samples.
+ */
+
+struct audio_src_s
+{
+  uint32_t step;                      /* Q16 input samples per output one */
+  uint32_t pos;                       /* Q16 position of the next output */
+  int16_t  hist[2][AUDIO_SRC_NTAPS];  /* Last input samples per channel */
+  uint8_t  nchannels;                 /* 1 or 2 */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_dsp_mix
+ *
+ * Description:
+ *   Add 'nsamples' 16-bit samples of 'src' scaled by the Q15 'gain' to
+ *   'dst', saturating the sums.
+ *
+ ****************************************************************************/
+
+void audio_dsp_mix(FAR int16_t *dst, FAR const int16_t *src,
+                   size_t nsamples, int16_t gain);
+
+/****************************************************************************
+ * Name: audio_dsp_volume
+ *
+ * Description:
+ *   Scale 'nsamples' 16-bit samples by the Q15 'gain' in place.
+ *
+ ****************************************************************************/
+
+void audio_dsp_volume(FAR int16_t *buf, size_t nsamples, int16_t gain);
+
+/****************************************************************************
+ * Name: audio_dsp_convert
+ *
+ * Description:
+ *   Convert 'nframes' PCM frames of 'nchannels' samples of 'bpsamp' bits
+ *   to interleaved 16-bit stereo frames.  8-bit samples are unsigned as in
+ *   WAV files, wider ones are signed little endian, mono is duplicated.
+ *
+ * Returned Value:
+ *   Zero on success; -EINVAL if the format is not supported.
+ *
+ ****************************************************************************/
+
+int audio_dsp_convert(FAR int16_t *dst, FAR const uint8_t *src,
+                      uint8_t bpsamp, uint8_t nchannels, size_t nframes);
+
+/****************************************************************************
+ * Name: audio_src_init
+ *
+ * Description:
+ *   Set a sample rate converter up from 'inrate' to 'outrate'.
+ *
+ ****************************************************************************/
+
+void audio_src_init(FAR struct audio_src_s *src, uint32_t inrate,
+                    uint32_t outrate, uint8_t nchannels);
+
+/****************************************************************************
+ * Name: audio_src_process
+ *
+ * Description:
+ *   Convert input frames to at most 'nout' output frames.
+ *
+ * Input Parameters:
+ *   src  - The sample rate converter
+ *   out  - Where to write the output frames
+ *   nout - The number of output frames wanted
+ *   in   - The input frames
+ *   nin  - In: the number of input frames.  Out: the number used.
+ *
+ * Returned Value:
+ *   The number of output frames written, less than 'nout' once the input
+ *   is used up.
+ *
+ ****************************************************************************/
+
+size_t audio_src_process(FAR struct audio_src_s *src, FAR int16_t *out,
+                         size_t nout, FAR const int16_t *in,
+                         FAR size_t *nin);
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Create a mixer of 'nstreams' streams over a lower half output device.
+ *   Each stream is a lower half of its own that takes PCM buffers of any
+ *   rate, width and channel count, as a pcm_decode_initialize() would pass
+ *   them down.  The streams are converted, resampled, scaled by their
+ *   volume and mixed into 16-bit stereo buffers at
+ *   CONFIG_AUDIO_MIXER_SAMPRATE for 'lower'.
+ *
+ * Input Parameters:
+ *   lower    - The output device
+ *   nstreams - The number of streams
+ *   streams  - Receives the lower half of each stream
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR struct audio_lowerhalf_s *lower,
+                           int nstreams,
+                           FAR struct audio_lowerhalf_s **streams);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_AUDIO_MIXER */
+#endif /* __INCLUDE_NUTTX_AUDIO_AUDIO_MIXER_H */
@@ -216,6 +216,23 @@ int core_dump(FAR struct memory_region_s *regions,
               FAR struct lib_outstream_s *stream,
               pid_t pid);
 
+/****************************************************************************
+ * Name: coredump_initialize
+ *
+ * Description:
+ *   Open CONFIG_BOARD_COREDUMP_DEVPATH for the core dump taken when the
+ *   system crashes.  This is done after board_late_initialize(); board
+ *   logic that registers the device later calls it again.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOARD_COREDUMP
+int coredump_initialize(void);
+#endif
+
 /****************************************************************************
  * Name: load_module
  *
@@ -36,6 +36,12 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* The operations of a D-cache batch, see dcache_batch_init() */
+
+#define DCACHE_BATCH_CLEAN      0   /* up_clean_dcache() */
+#define DCACHE_BATCH_INVALIDATE 1   /* up_invalidate_dcache() */
+#define DCACHE_BATCH_FLUSH      2   /* up_flush_dcache() */
+
 #ifdef __cplusplus
 #define EXTERN extern "C"
 extern "C"
@@ -44,6 +50,24 @@ extern "C"
 #define EXTERN extern
 #endif
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A set of disjoint address ranges waiting for the same D-cache
+ * operation.
+ */
+
+struct dcache_batch_s
+{
+  uint8_t op;                       /* DCACHE_BATCH_* */
+#ifdef CONFIG_ARCH_DCACHE
+  uint8_t nranges;                  /* Number of pending ranges */
+  uintptr_t start[CONFIG_ARCH_DCACHE_BATCH_NRANGES];
+  uintptr_t end[CONFIG_ARCH_DCACHE_BATCH_NRANGES];
+#endif
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -537,6 +561,76 @@ void up_coherent_dcache(uintptr_t addr, size_t len);
 #  define up_coherent_dcache(addr, len)
 #endif
 
+/****************************************************************************
+ * Name: dcache_batch_init
+ *
+ * Description:
+ *   Start an empty batch of D-cache maintenance.  Drivers that maintain
+ *   many small or overlapping buffers at a time, like the segments of a
+ *   scatter-gather transfer, add them to a batch and apply it once:  each
+ *   cache line is then visited once, and a large batch is applied to the
+ *   whole cache at once (see CONFIG_ARCH_DCACHE_BATCH_THRESHOLD).
+ *
+ * Input Parameters:
+ *   batch - The batch to initialize
+ *   op    - The operation to apply, DCACHE_BATCH_*
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_DCACHE
+void dcache_batch_init(FAR struct dcache_batch_s *batch, int op);
+#else
+#  define dcache_batch_init(batch, op) ((void)(batch))
+#endif
+
+/****************************************************************************
+ * Name: dcache_batch_add
+ *
+ * Description:
+ *   Add a region to a batch, merging it with the regions that it overlaps
+ *   or touches.  If the batch is full, the pending regions are applied
+ *   first.
+ *
+ * Input Parameters:
+ *   batch - The batch
+ *   start - virtual start address of region
+ *   end   - virtual end address of region + 1
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_DCACHE
+void dcache_batch_add(FAR struct dcache_batch_s *batch,
+                      uintptr_t start, uintptr_t end);
+#else
+#  define dcache_batch_add(batch, start, end) ((void)(batch))
+#endif
+
+/****************************************************************************
+ * Name: dcache_batch_commit
+ *
+ * Description:
+ *   Apply the operation of a batch to its pending regions and empty it.
+ *
+ * Input Parameters:
+ *   batch - The batch
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_DCACHE
+void dcache_batch_commit(FAR struct dcache_batch_s *batch);
+#else
+#  define dcache_batch_commit(batch) ((void)(batch))
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
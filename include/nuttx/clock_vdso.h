@@ -0,0 +1,137 @@
+/****************************************************************************
+ * include/nuttx/clock_vdso.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_CLOCK_VDSO_H
+#define __INCLUDE_NUTTX_CLOCK_VDSO_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
+
+#ifdef CONFIG_CLOCK_VDSO
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The clock data page.  The kernel maps it read-only into the processes
+ * that ask for it with clock_vdso_map(), so that clock_gettime() can
+ * compute CLOCK_MONOTONIC and CLOCK_REALTIME from the user readable
+ * counter of up_vdso_counter() without trapping into the kernel:
+ *
+ *   delta     = up_vdso_counter() - cv_counter
+ *   monotonic = cv_monotonic + delta / cv_freq seconds
+ *   realtime  = monotonic + cv_realtime
+ *
+ * The kernel only changes cv_realtime after the initialization, when the
+ * time of day is set or slewed; cv_seq tells the readers to retry then.
+ */
+
+struct clock_vdso_s
+{
+  seqcount_t      cv_seq;        /* Odd while the kernel updates the page */
+  uint32_t        cv_freq;       /* Frequency of the counter in Hz */
+  uint64_t        cv_counter;    /* Counter value at cv_monotonic */
+  struct timespec cv_monotonic;  /* CLOCK_MONOTONIC at cv_counter */
+  struct timespec cv_realtime;   /* CLOCK_REALTIME - CLOCK_MONOTONIC */
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_vdso_monotonic
+ *
+ * Description:
+ *   Convert a value of the counter to CLOCK_MONOTONIC.  This is shared by
+ *   the kernel and the C library so that they agree to the nanosecond.
+ *   The caller has to hold the sequence count of the page.
+ *
+ ****************************************************************************/
+
+static inline void clock_vdso_monotonic(FAR const struct clock_vdso_s *vdso,
+                                        uint64_t counter,
+                                        FAR struct timespec *ts)
+{
+  uint64_t delta = counter - vdso->cv_counter;
+  uint64_t sec   = delta / vdso->cv_freq;
+  long nsec;
+
+  /* Split the seconds off first: the rest is less than cv_freq so that
+   * scaling it to nanoseconds cannot overflow.
+   */
+
+  delta -= sec * vdso->cv_freq;
+  nsec   = vdso->cv_monotonic.tv_nsec +
+           (long)(delta * NSEC_PER_SEC / vdso->cv_freq);
+
+  ts->tv_sec = vdso->cv_monotonic.tv_sec + sec;
+  if (nsec >= NSEC_PER_SEC)
+    {
+      nsec -= NSEC_PER_SEC;
+      ts->tv_sec++;
+    }
+
+  ts->tv_nsec = nsec;
+}
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: clock_vdso_map
+ *
+ * Description:
+ *   Map the clock data page into the calling process.  Mapping it again
+ *   returns the address of the existing mapping.
+ *
+ * Returned Value:
+ *   The address of the clock data page, or NULL if there is none; the
+ *   caller then has to go through the clock_gettime() system call.
+ *
+ ****************************************************************************/
+
+FAR const struct clock_vdso_s *clock_vdso_map(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_CLOCK_VDSO */
+#endif /* __INCLUDE_NUTTX_CLOCK_VDSO_H */
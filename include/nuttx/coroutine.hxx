@@ -0,0 +1,498 @@
+//***************************************************************************
+// include/nuttx/coroutine.hxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+#ifndef __INCLUDE_NUTTX_COROUTINE_HXX
+#define __INCLUDE_NUTTX_COROUTINE_HXX
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <sys/epoll.h>
+
+#if __has_include(<coroutine>)
+#  include <coroutine>
+#else
+#  include <experimental/coroutine>
+#endif
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+#  include <nuttx/wqueue.h>
+#endif
+
+#ifdef CONFIG_LIBCXX_COROUTINE
+
+//***************************************************************************
+// Public Types
+//***************************************************************************
+
+namespace nuttx
+{
+namespace coro
+{
+#if __has_include(<coroutine>)
+  using std::coroutine_handle;
+  using std::noop_coroutine;
+  using std::suspend_always;
+#else
+  using std::experimental::coroutine_handle;
+  using std::experimental::noop_coroutine;
+  using std::experimental::suspend_always;
+#endif
+
+  // Coroutine frames are allocated here.  With CONFIG_LIBCXX_PMR they come
+  // from a mempool_resource, so that the frames of short-lived sessions do
+  // not fragment the heap.
+
+  void *frame_alloc(std::size_t size);
+  void frame_free(void *p, std::size_t size);
+
+  template <typename T = void>
+  class task;
+
+  namespace detail
+  {
+    class promise_base
+    {
+    public:
+      static void *operator new(std::size_t size)
+      {
+        return frame_alloc(size);
+      }
+
+      static void operator delete(void *p, std::size_t size)
+      {
+        frame_free(p, size);
+      }
+
+      // When the coroutine completes, resume whoever awaited it.  A
+      // spawned coroutine has nobody to return to and frees itself.
+
+      struct final_awaiter
+      {
+        bool await_ready() const noexcept
+        {
+          return false;
+        }
+
+        template <typename P>
+        coroutine_handle<> await_suspend(coroutine_handle<P> h) noexcept
+        {
+          promise_base &p = h.promise();
+
+          if (p.m_continuation)
+            {
+              return p.m_continuation;
+            }
+
+          if (p.m_detached)
+            {
+              h.destroy();
+            }
+
+          return noop_coroutine();
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+      };
+
+      // A task does not run until it is awaited or spawned
+
+      suspend_always initial_suspend() const noexcept
+      {
+        return {};
+      }
+
+      final_awaiter final_suspend() const noexcept
+      {
+        return {};
+      }
+
+      void unhandled_exception() const noexcept
+      {
+        std::terminate();
+      }
+
+      coroutine_handle<> m_continuation;
+      bool m_detached = false;
+    };
+
+    template <typename T>
+    class promise : public promise_base
+    {
+    public:
+      task<T> get_return_object() noexcept;
+
+      void return_value(T value)
+      {
+        m_value = std::move(value);
+      }
+
+      T m_value{};
+    };
+
+    template <>
+    class promise<void> : public promise_base
+    {
+    public:
+      task<void> get_return_object() noexcept;
+
+      void return_void() const noexcept
+      {
+      }
+    };
+  } // namespace detail
+
+  // The return type of a coroutine.  Awaiting a task runs it to completion
+  // and yields its result.  T must be default constructible.
+
+  template <typename T>
+  class task
+  {
+  public:
+    using promise_type = detail::promise<T>;
+    using handle_type = coroutine_handle<promise_type>;
+
+    explicit task(handle_type h) noexcept
+      : m_handle(h)
+    {
+    }
+
+    task(task &&other) noexcept
+      : m_handle(std::exchange(other.m_handle, nullptr))
+    {
+    }
+
+    ~task()
+    {
+      if (m_handle)
+        {
+          m_handle.destroy();
+        }
+    }
+
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+
+    bool await_ready() const noexcept
+    {
+      return false;
+    }
+
+    coroutine_handle<> await_suspend(coroutine_handle<> h) noexcept
+    {
+      m_handle.promise().m_continuation = h;
+      return m_handle;
+    }
+
+    T await_resume()
+    {
+      if constexpr (!std::is_void_v<T>)
+        {
+          return std::move(m_handle.promise().m_value);
+        }
+    }
+
+    // Give up the ownership of the coroutine frame
+
+    handle_type release() noexcept
+    {
+      return std::exchange(m_handle, nullptr);
+    }
+
+  private:
+    handle_type m_handle;
+  };
+
+  template <typename T>
+  task<T> detail::promise<T>::get_return_object() noexcept
+  {
+    return task<T>(task<T>::handle_type::from_promise(*this));
+  }
+
+  inline task<void> detail::promise<void>::get_return_object() noexcept
+  {
+    return task<void>(task<void>::handle_type::from_promise(*this));
+  }
+
+  // Runs coroutines on the thread that calls run().  A coroutine waiting for
+  // a file descriptor is registered in the executor's epoll set, so that
+  // thousands of idle sessions cost nothing but their frames.  Any thread
+  // may post() a coroutine or spawn() a new one.
+
+  class executor
+  {
+  public:
+    // Resumes the awaiting coroutine when 'fd' reports any of 'events'.
+    // The result is the returned event mask, or EPOLLERR if 'fd' could not
+    // be watched.
+
+    class io_awaiter
+    {
+    public:
+      io_awaiter(executor &ex, int fd, uint32_t events) noexcept
+        : m_ex(ex), m_fd(fd), m_events(events), m_revents(0)
+      {
+      }
+
+      bool await_ready() const noexcept
+      {
+        return false;
+      }
+
+      bool await_suspend(coroutine_handle<> h) noexcept
+      {
+        m_handle = h;
+        if (m_ex.arm(m_fd, m_events, this) < 0)
+          {
+            m_revents = EPOLLERR;
+            return false;
+          }
+
+        return true;
+      }
+
+      uint32_t await_resume() const noexcept
+      {
+        return m_revents;
+      }
+
+    private:
+      friend class executor;
+
+      executor &m_ex;
+      int m_fd;
+      uint32_t m_events;
+      uint32_t m_revents;
+      coroutine_handle<> m_handle;
+    };
+
+    // Resumes the awaiting coroutine after 'msec' milliseconds.  Must be
+    // awaited on the executor thread.
+
+    class timer_awaiter
+    {
+    public:
+      timer_awaiter(executor &ex, unsigned int msec) noexcept
+        : m_ex(ex), m_msec(msec)
+      {
+      }
+
+      bool await_ready() const noexcept
+      {
+        return false;
+      }
+
+      void await_suspend(coroutine_handle<> h)
+      {
+        m_ex.add_timer(m_msec, h);
+      }
+
+      void await_resume() const noexcept
+      {
+      }
+
+    private:
+      executor &m_ex;
+      unsigned int m_msec;
+    };
+
+    // Resumes the awaiting coroutine on the executor thread, behind the
+    // coroutines that are already ready to run
+
+    class schedule_awaiter
+    {
+    public:
+      explicit schedule_awaiter(executor &ex) noexcept
+        : m_ex(ex)
+      {
+      }
+
+      bool await_ready() const noexcept
+      {
+        return false;
+      }
+
+      void await_suspend(coroutine_handle<> h)
+      {
+        m_ex.post(h);
+      }
+
+      void await_resume() const noexcept
+      {
+      }
+
+    private:
+      executor &m_ex;
+    };
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+    // Resumes the awaiting coroutine on work queue 'qid', for blocking
+    // calls that would stall the executor.  co_await schedule() returns to
+    // the executor.  If the work cannot be queued, the coroutine continues
+    // on the calling thread.
+
+    class work_awaiter
+    {
+    public:
+      explicit work_awaiter(int qid) noexcept
+        : m_qid(qid), m_work()
+      {
+      }
+
+      bool await_ready() const noexcept
+      {
+        return false;
+      }
+
+      bool await_suspend(coroutine_handle<> h) noexcept
+      {
+        m_handle = h;
+        return work_queue(m_qid, &m_work, worker, this, 0) == 0;
+      }
+
+      void await_resume() const noexcept
+      {
+      }
+
+    private:
+      static void worker(FAR void *arg)
+      {
+        static_cast<work_awaiter *>(arg)->m_handle.resume();
+      }
+
+      int m_qid;
+      struct work_s m_work;
+      coroutine_handle<> m_handle;
+    };
+#endif
+
+    executor();
+    ~executor();
+
+    executor(const executor &) = delete;
+    executor &operator=(const executor &) = delete;
+
+    // True if the epoll set and the wakeup descriptor were created
+
+    bool valid() const noexcept
+    {
+      return m_epfd >= 0 && m_evfd >= 0;
+    }
+
+    // Start 't' on the executor.  The executor owns its frame from now on,
+    // and the frame is freed when the coroutine completes.
+
+    void spawn(task<void> &&t);
+
+    // Resume 'h' on the executor thread.  May be called from any thread.
+
+    void post(coroutine_handle<> h);
+
+    // Run the coroutines until stop() is called.  Returns OK, or a negated
+    // errno value if epoll_wait() failed.
+
+    int run();
+
+    // Make run() return.  May be called from any thread.
+
+    void stop();
+
+    io_awaiter wait(int fd, uint32_t events) noexcept
+    {
+      return io_awaiter(*this, fd, events);
+    }
+
+    io_awaiter readable(int fd) noexcept
+    {
+      return io_awaiter(*this, fd, EPOLLIN);
+    }
+
+    io_awaiter writable(int fd) noexcept
+    {
+      return io_awaiter(*this, fd, EPOLLOUT);
+    }
+
+    // Remove 'fd' from the epoll set.  Must be called before 'fd' is
+    // closed, and only while nobody waits on it.
+
+    int forget(int fd);
+
+    timer_awaiter sleep_for(unsigned int msec) noexcept
+    {
+      return timer_awaiter(*this, msec);
+    }
+
+    schedule_awaiter schedule() noexcept
+    {
+      return schedule_awaiter(*this);
+    }
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+    static work_awaiter offload(int qid = LPWORK) noexcept
+    {
+      return work_awaiter(qid);
+    }
+#endif
+
+  private:
+    struct timer
+    {
+      uint64_t deadline;
+      coroutine_handle<> handle;
+
+      bool operator>(const timer &other) const noexcept
+      {
+        return deadline > other.deadline;
+      }
+    };
+
+    int arm(int fd, uint32_t events, FAR io_awaiter *waiter);
+    void add_timer(unsigned int msec, coroutine_handle<> h);
+    int next_timeout();
+
+    int m_epfd;
+    int m_evfd;
+    pthread_mutex_t m_lock;
+    bool m_stop;                                  // Guarded by m_lock
+    std::vector<coroutine_handle<>> m_posted;     // Guarded by m_lock
+    std::vector<coroutine_handle<>> m_ready;      // Executor thread only
+    std::priority_queue<timer, std::vector<timer>,
+                        std::greater<timer>> m_timers;
+  };
+} // namespace coro
+} // namespace nuttx
+
+#endif // CONFIG_LIBCXX_COROUTINE
+#endif // __INCLUDE_NUTTX_COROUTINE_HXX
@@ -82,6 +82,10 @@ int aes_cypher(FAR void *out, FAR const void *in, size_t size,
 int crypto_test(void);
 #endif
 
+#if defined(CONFIG_CRYPTO_ALGTEST_BENCH)
+void crypto_bench(void);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -192,6 +192,16 @@
 
 #define DMA_RESIDUAL(chan) (chan)->ops->residual(chan)
 
+/****************************************************************************
+ * Name: DMA_START_SG
+ *
+ * Description:
+ *   Start a scatter-gather transfer, see dma_start_sg().
+ *
+ ****************************************************************************/
+
+#define DMA_START_SG(chan, xfer) dma_start_sg(chan, xfer)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -272,6 +282,34 @@ struct dma_link_config_s
 };
 #endif
 
+/* One segment of a scatter-gather transfer */
+
+struct dma_sg_s
+{
+  uintptr_t dst;                 /* The destination address */
+  uintptr_t src;                 /* The source address */
+  size_t len;                    /* The length to transfer */
+};
+
+/* A scatter-gather transfer started by dma_start_sg().  The callback gets
+ * the total length once all the segments are transferred, or the error
+ * code of the segment that failed.  The structure belongs to the DMA
+ * channel until then.
+ */
+
+struct dma_sgxfer_s
+{
+  FAR const struct dma_sg_s *sg; /* The segments, in transfer order */
+  unsigned int nsg;              /* The number of segments */
+  dma_callback_t callback;       /* Called once the transfer finished */
+  FAR void *arg;                 /* The argument passed to callback */
+
+  /* Used by dma_start_sg() when it chains the segments itself */
+
+  unsigned int next;             /* The segment in progress */
+  size_t done;                   /* The length already transferred */
+};
+
 /* The DMA vtable */
 
 struct dma_ops_s
@@ -295,6 +333,11 @@ struct dma_ops_s
   CODE int (*pause)(FAR struct dma_chan_s *chan);
   CODE int (*resume)(FAR struct dma_chan_s *chan);
   CODE size_t (*residual)(FAR struct dma_chan_s *chan);
+
+  /* Optional, for controllers that chain descriptors in hardware */
+
+  CODE int (*start_sg)(FAR struct dma_chan_s *chan,
+                       FAR struct dma_sgxfer_s *xfer);
 };
 
 /* This structure only defines the initial fields of the structure
@@ -315,4 +358,84 @@ struct dma_dev_s
                         FAR struct dma_chan_s *chan);
 };
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: dma_register
+ *
+ * Description:
+ *   Register a DMA controller, so that drivers which are not aware of it
+ *   can find it by its index.
+ *
+ * Input Parameters:
+ *   index - The index of the controller, from 0
+ *   dev   - The controller
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the index is out of range or -EEXIST
+ *   if a controller is already registered at it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DMA
+int dma_register(unsigned int index, FAR struct dma_dev_s *dev);
+
+/****************************************************************************
+ * Name: dma_unregister
+ *
+ * Description:
+ *   Remove a DMA controller registered by dma_register().
+ *
+ ****************************************************************************/
+
+void dma_unregister(unsigned int index);
+
+/****************************************************************************
+ * Name: dma_get_device
+ *
+ * Description:
+ *   Return the DMA controller registered at an index, or NULL if none is.
+ *   Its channels are then taken with DMA_GET_CHAN().
+ *
+ ****************************************************************************/
+
+FAR struct dma_dev_s *dma_get_device(unsigned int index);
+
+/****************************************************************************
+ * Name: dma_start_sg
+ *
+ * Description:
+ *   Start a scatter-gather transfer on a channel configured by
+ *   DMA_CONFIG().  The controller chains the segments itself if it
+ *   provides start_sg(), otherwise each segment is started by the
+ *   completion callback of the previous one.
+ *
+ * Input Parameters:
+ *   chan - The channel to start
+ *   xfer - Describes the segments and the callback
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_start_sg(FAR struct dma_chan_s *chan, FAR struct dma_sgxfer_s *xfer);
+#endif
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
 #endif /* __INCLUDE_NUTTX_DMA_DMA_H */
@@ -0,0 +1,71 @@
+/****************************************************************************
+ * include/nuttx/drivers/blkqueue.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_DRIVERS_BLKQUEUE_H
+#define __INCLUDE_NUTTX_DRIVERS_BLKQUEUE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_BLK_QUEUE
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: blkqueue_register
+ *
+ * Description:
+ *   Register a block driver at 'path' that queues the reads and writes of
+ *   all tasks for the block driver 'blkdev'.  Requests are dispatched to
+ *   'blkdev' one at a time, the request of the highest priority task
+ *   first, and contiguous requests in the same direction are merged into
+ *   a single transfer.  File systems are then mounted on 'path'.
+ *
+ * Input Parameters:
+ *   blkdev - The path of the block driver to queue requests for.
+ *   path   - The path of the block driver to register.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int blkqueue_register(FAR const char *blkdev, FAR const char *path);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_BLK_QUEUE */
+#endif /* __INCLUDE_NUTTX_DRIVERS_BLKQUEUE_H */
@@ -0,0 +1,165 @@
+/****************************************************************************
+ * include/nuttx/drivers/devstats.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_DRIVERS_DEVSTATS_H
+#define __INCLUDE_NUTTX_DRIVERS_DEVSTATS_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IOCTL commands of /dev/stats
+ *
+ * STATSIOC_GET
+ *   Description: Take a snapshot of the system counters and, optionally,
+ *                of the per-task and per-mempool counters.
+ *   Argument:    A pointer to struct stats_request_s
+ *   Return:      Zero (OK) on success; a negated errno value on failure.
+ */
+
+#define STATSIOC_GET          _STATSIOC(0x0001)
+
+/* The version of the structures below, returned in stats_system_s */
+
+#define STATS_VERSION         1
+
+/* The size of the names reported, including the NUL terminator */
+
+#define STATS_NAME_SIZE       16
+
+/* Values of stats_system_s::flags: which groups were filled in */
+
+#define STATS_FLAG_CPULOAD    (1 << 0)
+#define STATS_FLAG_HEAP       (1 << 1)
+#define STATS_FLAG_IOB        (1 << 2)
+#define STATS_FLAG_NET        (1 << 3)
+#define STATS_FLAG_STACK      (1 << 4)  /* stats_task_s::stack_used is valid */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The counters of one network protocol */
+
+struct stats_proto_s
+{
+  uint32_t recv;                    /* Received packets */
+  uint32_t sent;                    /* Sent packets */
+  uint32_t drop;                    /* Dropped packets */
+};
+
+/* The system wide counters.  The layout does not depend on the
+ * configuration: the groups that are not available are zero and their
+ * flag is clear.
+ */
+
+struct stats_system_s
+{
+  uint16_t version;                 /* STATS_VERSION */
+  uint16_t flags;                   /* STATS_FLAG_* */
+  uint16_t ncpus;                   /* Number of CPUs */
+  uint16_t ntasks;                  /* Number of tasks and threads */
+  uint64_t uptime;                  /* System time in ticks */
+
+  /* CPU load, in ticks of the load measurement */
+
+  uint32_t cpu_total;               /* Ticks measured */
+  uint32_t cpu_idle;                /* Ticks spent in the IDLE threads */
+
+  /* Kernel heap */
+
+  uint32_t heap_size;               /* Total size */
+  uint32_t heap_used;               /* Bytes in allocated chunks */
+  uint32_t heap_free;               /* Bytes in free chunks */
+  uint32_t heap_largest;            /* Largest free chunk */
+  uint32_t heap_nused;              /* Number of allocated chunks */
+  uint32_t heap_nfree;              /* Number of free chunks */
+
+  /* I/O buffers */
+
+  int32_t  iob_total;               /* Number of IOBs */
+  int32_t  iob_free;                /* Number of free IOBs */
+  int32_t  iob_wait;                /* Number of waiters */
+  int32_t  iob_throttle;            /* Number of free throttled IOBs */
+
+  /* Network */
+
+  struct stats_proto_s ipv4;
+  struct stats_proto_s ipv6;
+  struct stats_proto_s icmp;
+  struct stats_proto_s icmpv6;
+  struct stats_proto_s tcp;
+  struct stats_proto_s udp;
+};
+
+/* The counters of one task or thread */
+
+struct stats_task_s
+{
+  pid_t    pid;                     /* Task ID */
+  uint8_t  priority;                /* Current priority */
+  uint8_t  state;                   /* enum tstate_e */
+  uint16_t flags;                   /* TCB_FLAG_* */
+  uint32_t cpu_active;              /* Ticks running, see cpu_total */
+  uint32_t stack_size;              /* Allocated stack size */
+  uint32_t stack_used;              /* Stack high water mark */
+  char     name[STATS_NAME_SIZE];   /* Task name, possibly truncated */
+};
+
+/* The counters of one memory pool */
+
+struct stats_mempool_s
+{
+  uint32_t blocksize;               /* Size of a block */
+  uint32_t arena;                   /* Total size */
+  uint32_t nused;                   /* Number of allocated blocks */
+  uint32_t nfree;                   /* Number of free blocks */
+  uint32_t nifree;                  /* Number of free interrupt blocks */
+  uint32_t nwaiter;                 /* Number of waiters */
+  char     name[STATS_NAME_SIZE];   /* Pool name, possibly truncated */
+};
+
+/* The argument of STATSIOC_GET.  On input ntasks and npools are the sizes
+ * of the arrays, which may be NULL.  On return they are the number of
+ * entries filled in; the entries that did not fit are left out and are
+ * still counted in system.ntasks.
+ */
+
+struct stats_request_s
+{
+  struct stats_system_s system;      /* Returned system counters */
+  FAR struct stats_task_s *tasks;    /* Array of per-task counters */
+  size_t ntasks;                     /* Size of tasks[] / entries returned */
+  FAR struct stats_mempool_s *pools; /* Array of per-mempool counters */
+  size_t npools;                     /* Size of pools[] / entries returned */
+};
+
+#endif /* __INCLUDE_NUTTX_DRIVERS_DEVSTATS_H */
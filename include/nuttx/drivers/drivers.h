@@ -133,6 +133,22 @@ void devurandom_register(void);
 
 void devcrypto_register(void);
 
+/****************************************************************************
+ * Name: devstats_register
+ *
+ * Description:
+ *   Register /dev/stats, the binary statistics driver
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void devstats_register(void);
+
 /****************************************************************************
  * Name: devzero_register
  *
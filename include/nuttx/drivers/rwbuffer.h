@@ -177,7 +177,7 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb,
 /* Character oriented transfers */
 
 #ifdef CONFIG_DRVR_READBYTES
-ssize_t rwb_readbytes(FAR struct rwbuffer_s *dev, off_t offset,
+ssize_t rwb_readbytes(FAR struct rwbuffer_s *rwb, off_t offset,
                       size_t nbytes, FAR uint8_t *buffer);
 #endif
 
@@ -0,0 +1,142 @@
+/****************************************************************************
+ * include/nuttx/fs/bcache.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FS_BCACHE_H
+#define __INCLUDE_NUTTX_FS_BCACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#ifdef CONFIG_FS_BCACHE
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+struct inode;
+
+/****************************************************************************
+ * Name: bcache_read
+ *
+ * Description:
+ *   Read sectors of a block driver through the shared buffer cache.
+ *   Single sector requests are served from the cache, larger ones go to
+ *   the driver and only pick the cached sectors that are not written back
+ *   yet.
+ *
+ * Input Parameters:
+ *   inode      - The block driver
+ *   buffer     - The buffer that receives the data
+ *   start      - The first sector to read
+ *   nsectors   - The number of sectors to read
+ *   sectorsize - The sector size of the driver
+ *
+ * Returned Value:
+ *   The number of sectors read on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t bcache_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                    blkcnt_t start, unsigned int nsectors,
+                    size_t sectorsize);
+
+/****************************************************************************
+ * Name: bcache_write
+ *
+ * Description:
+ *   Write sectors of a block driver through the shared buffer cache.  With
+ *   CONFIG_FS_BCACHE_WRITEBACK, single sector writes are only written to
+ *   the driver when they are evicted, flushed or older than
+ *   CONFIG_FS_BCACHE_FLUSH_MSEC.
+ *
+ * Input Parameters:
+ *   inode      - The block driver
+ *   buffer     - The data to write
+ *   start      - The first sector to write
+ *   nsectors   - The number of sectors to write
+ *   sectorsize - The sector size of the driver
+ *
+ * Returned Value:
+ *   The number of sectors written on success; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t bcache_write(FAR struct inode *inode,
+                     FAR const unsigned char *buffer, blkcnt_t start,
+                     unsigned int nsectors, size_t sectorsize);
+
+/****************************************************************************
+ * Name: bcache_flush
+ *
+ * Description:
+ *   Write all the cached sectors of a block driver that are not written
+ *   back yet.
+ *
+ * Input Parameters:
+ *   inode - The block driver, or NULL for all of them
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int bcache_flush(FAR struct inode *inode);
+
+/****************************************************************************
+ * Name: bcache_invalidate
+ *
+ * Description:
+ *   Flush and then drop all the cached sectors of a block driver.  This
+ *   must be called before the driver is closed or its content is changed
+ *   behind the cache.
+ *
+ * Input Parameters:
+ *   inode - The block driver
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value if the flush failed.  The
+ *   sectors are dropped in either case.
+ *
+ ****************************************************************************/
+
+int bcache_invalidate(FAR struct inode *inode);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_FS_BCACHE */
+#endif /* __INCLUDE_NUTTX_FS_BCACHE_H */
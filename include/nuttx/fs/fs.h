@@ -172,6 +172,7 @@ struct inode;
 struct stat;
 struct statfs;
 struct pollfd;
+struct iovec;
 struct mtd_dev_s;
 struct tcb_s;
 
@@ -229,6 +230,15 @@ struct file_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   CODE int     (*unlink)(FAR struct inode *inode);
 #endif
+
+  /* Optional scatter/gather transfers.  If not provided, readv() and
+   * writev() fall back to one read or write call per I/O vector.
+   */
+
+  CODE ssize_t (*readv)(FAR struct file *filep, FAR const struct iovec *iov,
+                        int iovcnt);
+  CODE ssize_t (*writev)(FAR struct file *filep,
+                         FAR const struct iovec *iov, int iovcnt);
 };
 
 /* This structure provides information about the state of a block driver */
@@ -364,6 +374,13 @@ struct mountpt_operations
                        FAR struct stat *buf);
   CODE int     (*chstat)(FAR struct inode *mountpt, FAR const char *relpath,
                          FAR const struct stat *buf, int flags);
+
+  /* Optional scatter/gather transfers on an open file */
+
+  CODE ssize_t (*readv)(FAR struct file *filep, FAR const struct iovec *iov,
+                        int iovcnt);
+  CODE ssize_t (*writev)(FAR struct file *filep,
+                         FAR const struct iovec *iov, int iovcnt);
 };
 #endif /* CONFIG_DISABLE_MOUNTPOINT */
 
@@ -420,6 +437,9 @@ struct inode
   struct timespec   i_ctime;    /* Time of last status change */
 #endif
   FAR void         *i_private;  /* Per inode driver private data */
+#ifdef CONFIG_FS_INODE_HASH
+  FAR struct inode *i_hash;     /* Link to next inode in hash bucket */
+#endif
   char              i_name[1];  /* Name of inode (variable) */
 };
 
@@ -450,7 +470,7 @@ struct file
 
 struct filelist
 {
-  mutex_t           fl_lock;    /* Manage access to the file list */
+  mutex_t           fl_lock;    /* Serialize changes to the file list */
   uint8_t           fl_rows;    /* The number of rows of fl_files array */
   FAR struct file **fl_files;   /* The pointer of two layer file descriptors array */
 };
@@ -1304,6 +1324,32 @@ ssize_t file_write(FAR struct file *filep, FAR const void *buf,
 
 ssize_t nx_write(int fd, FAR const void *buf, size_t nbytes);
 
+/****************************************************************************
+ * Name: file_readv and file_writev
+ *
+ * Description:
+ *   Equivalent to the standard readv() and writev() functions except that
+ *   they accept a struct file instance instead of a file descriptor, do not
+ *   modify the errno variable and are not cancellation points.  The whole
+ *   vector is passed to the readv or writev method of the driver or file
+ *   system when there is one.
+ *
+ * Input Parameters:
+ *   filep  - Instance of struct file to use with the transfer
+ *   iov    - Array of buffer descriptors
+ *   iovcnt - Number of elements in iov[]
+ *
+ * Returned Value:
+ *   The number of bytes transferred on success, or a negated errno value on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+ssize_t file_readv(FAR struct file *filep,
+                   FAR const struct iovec *iov, int iovcnt);
+ssize_t file_writev(FAR struct file *filep,
+                    FAR const struct iovec *iov, int iovcnt);
+
 /****************************************************************************
  * Name: file_pread
  *
@@ -1342,6 +1388,19 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count);
 
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *inoffset,
+                    FAR struct file *outfile, FAR off_t *outoffset,
+                    size_t count, unsigned int flags);
+
 /****************************************************************************
  * Name: file_seek
  *
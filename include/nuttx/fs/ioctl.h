@@ -27,6 +27,7 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdbool.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -96,7 +97,10 @@
 #define _VIDIOCBASE     (0x3700) /* Video device ioctl commands */
 #define _CELLIOCBASE    (0x3800) /* Cellular device ioctl commands */
 #define _MIPIDSIBASE    (0x3900) /* Mipidsi device ioctl commands */
+#define _USRSOCKBASE    (0x3a00) /* Usrsock device ioctl commands */
 #define _SYSLOGBASE     (0x3c00) /* Syslog device ioctl commands */
+#define _STATSBASE      (0x3d00) /* Binary statistics ioctl commands */
+#define _PERFIOCBASE    (0x3e00) /* Performance counter ioctl commands */
 #define _WLIOCBASE      (0x8b00) /* Wireless modules ioctl network commands */
 
 /* boardctl() commands share the same number space */
@@ -198,6 +202,14 @@
                                            */
 #endif
 
+#define FIOC_XIPBASE    _FIOC(0x0010)     /* IN:  Pointer to pointer to void in
+                                           *      which to receive the address
+                                           *      of the file data.
+                                           * OUT: If the file data is directly
+                                           *      accessible in memory, its base
+                                           *      address. -ENOTTY otherwise.
+                                           */
+
 /* NuttX file system ioctl definitions **************************************/
 
 #define _DIOCVALID(c)   (_IOC_TYPE(c)==_DIOCBASE)
@@ -458,6 +470,37 @@
                                                * IN: pipe_peek_s
                                                * OUT: Length of data */
 
+#define PIPEIOC_RDLOWAT     _PIPEIOC(0x0005)  /* Set reader wakeup threshold
+                                               * IN: unsigned long integer.
+                                               *     Blocked readers are
+                                               *     only woken up once the
+                                               *     buffer holds this many
+                                               *     bytes, or a writer
+                                               *     blocks or closes.  At
+                                               *     most the buffer size
+                                               *     less PIPE_BUF.
+                                               * OUT: None */
+
+#define PIPEIOC_WRLOWAT     _PIPEIOC(0x0006)  /* Set writer wakeup threshold
+                                               * IN: unsigned long integer.
+                                               *     Blocked writers are
+                                               *     only woken up once the
+                                               *     buffer has this many
+                                               *     free bytes.
+                                               * OUT: None */
+
+#define PIPEIOC_SETSIZE     _PIPEIOC(0x0007)  /* Resize the buffer
+                                               * IN: unsigned long integer
+                                               * OUT: None */
+
+#define PIPEIOC_GETSIZE     _PIPEIOC(0x0008)  /* Get the buffer size
+                                               * IN: None
+                                               * OUT: None */
+
+#define PIPEIOC_SPLICE      _PIPEIOC(0x0009)  /* Splice to/from the pipe
+                                               * IN: pipe_splice_s
+                                               * OUT: Bytes transferred */
+
 /* RTC driver ioctl definitions *********************************************/
 
 /* (see nuttx/include/rtc.h */
@@ -651,11 +694,26 @@
 #define _MIPIDSIIOCVALID(c)    (_IOC_TYPE(c)==_MIPIDSIBASE)
 #define _MIPIDSIIOC(nr)        _IOC(_MIPIDSIBASE,nr)
 
+/* usrsock driver ioctl definitions *****************************************/
+
+#define _USRSOCKIOCVALID(c)    (_IOC_TYPE(c)==_USRSOCKBASE)
+#define _USRSOCKIOC(nr)        _IOC(_USRSOCKBASE,nr)
+
 /* syslog driver ioctl definitions ******************************************/
 
 #define _SYSLOGVALID(c) (_IOC_TYPE(c)==_SYSLOGBASE)
 #define _SYSLOGIOC(nr)  _IOC(_SYSLOGBASE,nr)
 
+/* Binary statistics driver ioctl definitions *******************************/
+
+#define _STATSIOCVALID(c) (_IOC_TYPE(c)==_STATSBASE)
+#define _STATSIOC(nr)     _IOC(_STATSBASE,nr)
+
+/* Performance counter driver ioctl definitions *****************************/
+
+#define _PERFIOCVALID(c)  (_IOC_TYPE(c)==_PERFIOCBASE)
+#define _PERFIOC(nr)      _IOC(_PERFIOCBASE,nr)
+
 /* Wireless driver network ioctl definitions ********************************/
 
 /* (see nuttx/include/wireless/wireless.h */
@@ -678,6 +736,21 @@ struct pipe_peek_s
   size_t size;
 };
 
+/* Used with PIPEIOC_SPLICE: move 'count' bytes between the pipe the ioctl
+ * is issued on and 'file', without the bounce buffer of the generic
+ * copy.
+ */
+
+struct file;
+struct pipe_splice_s
+{
+  FAR struct file *file;    /* The other end of the transfer */
+  FAR off_t *offset;        /* Its offset, NULL for the file position */
+  size_t count;             /* Maximum number of bytes to move */
+  unsigned int flags;       /* SPLICE_F_* flags */
+  bool out;                 /* true: The pipe is the destination */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -126,6 +126,47 @@ struct procfs_dir_priv_s
   FAR const struct procfs_entry_s *procfsentry; /* Pointer to procfs handler entry */
 };
 
+/* A sequence file generates its text one record at a time, so that each
+ * read() resumes from a cursor and formats only the records it returns.
+ * The handler provides the iterator below:
+ *
+ *   start - Return the record at 'index', or NULL past the last one.  It is
+ *           called once at the beginning of each read() and may take a lock
+ *           that is released by stop.
+ *   next  - Return the record at 'index' that follows 'elem', or NULL.
+ *   stop  - End the iteration.  'elem' is the last record returned by
+ *           start or next, possibly NULL.  May be NULL.
+ *   show  - Format 'elem' with procfs_seq_printf().  Returns zero (OK) or a
+ *           negated errno value.
+ */
+
+struct procfs_seq_s;
+struct procfs_seq_operations_s
+{
+  CODE FAR void *(*start)(FAR struct procfs_seq_s *seq, off_t index);
+  CODE FAR void *(*next)(FAR struct procfs_seq_s *seq, FAR void *elem,
+                         off_t index);
+  CODE void      (*stop)(FAR struct procfs_seq_s *seq, FAR void *elem);
+  CODE int       (*show)(FAR struct procfs_seq_s *seq, FAR void *elem);
+};
+
+/* The state of an open sequence file, usually embedded in the open file
+ * structure of the handler.
+ */
+
+struct procfs_seq_s
+{
+  FAR const struct procfs_seq_operations_s *ops;
+  FAR void *priv;                 /* Handler data, free for its use */
+  FAR char *buf;                  /* Text of the current record */
+  size_t size;                    /* Allocated size of buf[] */
+  size_t count;                   /* Number of valid bytes in buf[] */
+  size_t from;                    /* First byte of buf[] not yet returned */
+  off_t index;                    /* Index of the next record to show */
+  off_t pos;                      /* File position after the returned data */
+  bool overflow;                  /* The record did not fit in buf[] */
+};
+
 /* An entry for procfs_register_meminfo */
 
 struct mm_heap_s;
@@ -243,6 +284,87 @@ int procfs_snprintf(FAR char *buf, size_t size,
 void procfs_sprintf(FAR char *buf, size_t size, FAR off_t *offset,
                     FAR const IPTR char *format, ...) printf_like(4, 5);
 
+/****************************************************************************
+ * Name: procfs_seq_open
+ *
+ * Description:
+ *   Initialize the sequence state of a newly opened file.  The record
+ *   buffer is allocated by the first read.
+ *
+ * Input Parameters:
+ *   seq  - The sequence state to initialize
+ *   ops  - The record iterator of the handler
+ *   priv - Handler data, saved in seq->priv
+ *
+ ****************************************************************************/
+
+void procfs_seq_open(FAR struct procfs_seq_s *seq,
+                     FAR const struct procfs_seq_operations_s *ops,
+                     FAR void *priv);
+
+/****************************************************************************
+ * Name: procfs_seq_close
+ *
+ * Description:
+ *   Release the record buffer of a sequence file.
+ *
+ ****************************************************************************/
+
+void procfs_seq_close(FAR struct procfs_seq_s *seq);
+
+/****************************************************************************
+ * Name: procfs_seq_dup
+ *
+ * Description:
+ *   Copy the sequence state of 'oldseq', including the part of the current
+ *   record not yet returned, into 'newseq'.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int procfs_seq_dup(FAR struct procfs_seq_s *newseq,
+                   FAR const struct procfs_seq_s *oldseq);
+
+/****************************************************************************
+ * Name: procfs_seq_read
+ *
+ * Description:
+ *   The read() method of a sequence file.  The rest of the current record
+ *   is returned first, then new records are formatted until 'buflen' bytes
+ *   are returned or the records are exhausted.  If the file position was
+ *   changed since the last read, the records are regenerated from the
+ *   first one and the bytes before the new position are skipped.
+ *
+ * Input Parameters:
+ *   seq    - The sequence state of the open file
+ *   filep  - The open file, whose f_pos is advanced
+ *   buffer - The user's receive buffer
+ *   buflen - The size of the user's receive buffer
+ *
+ * Returned Value:
+ *   The number of bytes returned, 0 at the end of the file, or a negated
+ *   errno value if nothing could be returned.
+ *
+ ****************************************************************************/
+
+ssize_t procfs_seq_read(FAR struct procfs_seq_s *seq,
+                        FAR struct file *filep,
+                        FAR char *buffer, size_t buflen);
+
+/****************************************************************************
+ * Name: procfs_seq_printf
+ *
+ * Description:
+ *   Append formatted text to the current record from the show method.  A
+ *   record that does not fit is formatted again into a larger buffer.
+ *
+ ****************************************************************************/
+
+void procfs_seq_printf(FAR struct procfs_seq_s *seq,
+                       FAR const IPTR char *format, ...) printf_like(2, 3);
+
 /****************************************************************************
  * Name: procfs_register
  *
@@ -0,0 +1,137 @@
+/****************************************************************************
+ * include/nuttx/hrtimer.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_HRTIMER_H
+#define __INCLUDE_NUTTX_HRTIMER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/list.h>
+
+#ifdef CONFIG_HRTIMER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HRTIMER_ISACTIVE(t)   ((t)->func != NULL)
+
+/****************************************************************************
+ * Public Type Declarations
+ ****************************************************************************/
+
+struct hrtimer_s;
+
+/* This is the form of the function that is called when the timer expires.
+ * It returns the period in nanoseconds after which it is to be called
+ * again, or zero to leave the timer stopped.
+ */
+
+typedef CODE uint64_t (*hrtimer_entry_t)(FAR struct hrtimer_s *timer,
+                                         FAR void *arg);
+
+struct hrtimer_s
+{
+  struct list_node node;         /* Supports the list ordered by expiry */
+  uint64_t         expiry;       /* Absolute expiration time in ns */
+  hrtimer_entry_t  func;         /* Function to execute on expiry */
+  FAR void        *arg;          /* Callback argument */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Return the time in nanoseconds of the oneshot timer that the high
+ *   resolution timers run on, that is the time base of their expiries.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(void);
+
+/****************************************************************************
+ * Name: hrtimer_start
+ *
+ * Description:
+ *   Start a high resolution timer.  'func' will be called from the oneshot
+ *   timer interrupt once 'delay' nanoseconds have elapsed.  Unlike the
+ *   watchdog timers, the expiry is not rounded to the system tick.
+ *
+ *   A timer that is already active is restarted with the new delay.
+ *
+ * Input Parameters:
+ *   timer - The timer to start.  It must stay valid while it is active.
+ *   delay - The delay in nanoseconds
+ *   func  - The function to call on expiry
+ *   arg   - The argument passed to func
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EINVAL if func is NULL or -EAGAIN
+ *   if the oneshot timer has not been set up yet.
+ *
+ * Assumptions:
+ *   May be called from interrupt level handling, including from a timer
+ *   function.  A timer function that restarts its own timer must return
+ *   zero.
+ *
+ ****************************************************************************/
+
+int hrtimer_start(FAR struct hrtimer_s *timer, uint64_t delay,
+                  hrtimer_entry_t func, FAR void *arg);
+
+/****************************************************************************
+ * Name: hrtimer_cancel
+ *
+ * Description:
+ *   Stop a high resolution timer.  Cancelling a timer that is not active
+ *   is harmless.
+ *
+ * Returned Value:
+ *   Zero (OK) if the timer was active; -EINVAL otherwise.
+ *
+ ****************************************************************************/
+
+int hrtimer_cancel(FAR struct hrtimer_s *timer);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_HRTIMER */
+#endif /* __INCLUDE_NUTTX_HRTIMER_H */
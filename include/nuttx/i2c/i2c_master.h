@@ -179,6 +179,7 @@
 
 struct i2c_master_s;
 struct i2c_msg_s;
+struct i2c_async_s;
 struct i2c_ops_s
 {
   CODE int (*transfer)(FAR struct i2c_master_s *dev,
@@ -186,6 +187,10 @@ struct i2c_ops_s
 #ifdef CONFIG_I2C_RESET
   CODE int (*reset)(FAR struct i2c_master_s *dev);
 #endif
+#ifdef CONFIG_I2C_ASYNC
+  CODE int (*submit)(FAR struct i2c_master_s *dev,
+                     FAR struct i2c_async_s *req);
+#endif
 };
 
 /* This structure contains the full state of I2C as needed for a specific
@@ -234,6 +239,24 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+#ifdef CONFIG_I2C_ASYNC
+/* This describes a transfer queued by i2c_async_submit().  The structure
+ * belongs to the I2C bus from the submission until its callback is called.
+ */
+
+typedef CODE void (*i2c_async_callback_t)(FAR struct i2c_async_s *req);
+
+struct i2c_async_s
+{
+  FAR struct i2c_async_s *flink;  /* Used by the I2C bus while queued */
+  FAR struct i2c_msg_s *msgv;     /* Array of I2C messages to transfer */
+  int msgc;                       /* Number of messages in the array */
+  i2c_async_callback_t callback;  /* Called once the transfer is done */
+  FAR void *arg;                  /* Opaque data for the callback */
+  int result;                     /* Zero (OK) or a negated errno value */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -273,6 +296,30 @@ extern "C"
 int i2c_register(FAR struct i2c_master_s *i2c, int bus);
 #endif
 
+/****************************************************************************
+ * Name: i2c_async_submit
+ *
+ * Description:
+ *   Queue a transfer and return without waiting for it.  The queued
+ *   transfers of a bus are performed in order, and req->callback() is
+ *   called with req->result set once a transfer is done: from the work
+ *   queue, or from the interrupt handler of a lower half that provides the
+ *   submit() method.
+ *
+ * Input Parameters:
+ *   dev - Device-specific state data
+ *   req - Describes the transfer and its callback
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_I2C_ASYNC
+int i2c_async_submit(FAR struct i2c_master_s *dev,
+                     FAR struct i2c_async_s *req);
+#endif
+
 /****************************************************************************
  * Name: i2c_writeread
  *
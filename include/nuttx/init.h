@@ -28,6 +28,7 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 
 /****************************************************************************
@@ -44,6 +45,11 @@
 #define OSINIT_IDLELOOP()        (g_nx_initstate >= OSINIT_IDLELOOP)
 #define OSINIT_OS_INITIALIZING() (g_nx_initstate  < OSINIT_OSREADY)
 
+/* Initcall flags */
+
+#define INITCALL_ASYNC           (1 << 0) /* May complete after the init
+                                           * task has been started */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -71,6 +77,44 @@ enum nx_initstate_e
   OSINIT_IDLELOOP  = 6   /* The OS enter idle loop */
 };
 
+#ifdef CONFIG_SCHED_BOOTTIME
+/* One boot phase recorded by boottime_begin() and boottime_end() */
+
+struct boottime_s
+{
+  FAR const char *name;                   /* Name of the phase */
+  unsigned long start;                    /* up_perf_gettime() at begin */
+  unsigned long elapsed;                  /* Duration in up_perf_gettime()
+                                           * units */
+  uint8_t depth;                          /* Number of enclosing phases */
+  bool done;                              /* boottime_end() was called */
+};
+#endif
+
+#ifdef CONFIG_INITCALL
+/* This describes one initializer registered with initcall_register().
+ * Initializers whose dependencies have completed run concurrently on a
+ * pool of kernel threads.  All fields but 'name', 'func', 'depends' and
+ * 'flags' are private to the initcall logic.
+ */
+
+struct initcall_s
+{
+  FAR const char *name;                   /* Name for debug output */
+  CODE int (*func)(void);                 /* The initializer */
+  FAR struct initcall_s * const *depends; /* NULL terminated list of
+                                           * initializers that must
+                                           * complete first, or NULL */
+  uint8_t flags;                          /* See INITCALL_* definitions */
+
+  /* Private */
+
+  uint8_t state;                          /* Pending, running or done */
+  int result;                             /* Value returned by func */
+  FAR struct initcall_s *flink;           /* Next registered initializer */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -100,6 +144,87 @@ EXTERN uint8_t g_nx_initstate;  /* See enum nx_initstate_e */
 
 void nx_start(void);
 
+/* Functions contained in nx_boottime.c *************************************/
+
+#ifdef CONFIG_SCHED_BOOTTIME
+/****************************************************************************
+ * Name: boottime_begin and boottime_end
+ *
+ * Description:
+ *   Record the start and the end of a boot phase in the boot log that is
+ *   shown by /proc/boottime.  With CONFIG_SCHED_INSTRUMENTATION_DUMP, the
+ *   phase is also emitted as a begin/end note.  Phases may nest and phases
+ *   run by different threads may overlap.  'name' must be a string
+ *   constant.
+ *
+ ****************************************************************************/
+
+void boottime_begin(FAR const char *name);
+void boottime_end(FAR const char *name);
+
+/****************************************************************************
+ * Name: boottime_get
+ *
+ * Description:
+ *   Return boot log entry 'index'.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if there is no such entry.
+ *
+ ****************************************************************************/
+
+int boottime_get(int index, FAR struct boottime_s *entry);
+#else
+#  define boottime_begin(n)
+#  define boottime_end(n)
+#endif
+
+/* Functions contained in nx_initcall.c *************************************/
+
+#ifdef CONFIG_INITCALL
+/****************************************************************************
+ * Name: initcall_register
+ *
+ * Description:
+ *   Register an initializer.  Initializers registered before the OS
+ *   bring-up are started together by nx_bringup(); later ones are started
+ *   at once.  The initializers named in 'depends' must already be
+ *   registered.  If one of them fails, 'call' is not run and fails with
+ *   -ENODEV.
+ *
+ *   Unless INITCALL_ASYNC is set in 'flags', the init task is not started
+ *   before the initializer has completed.
+ *
+ * Input Parameters:
+ *   call - The initializer.  It must persist until it has completed.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int initcall_register(FAR struct initcall_s *call);
+
+/****************************************************************************
+ * Name: initcall_wait
+ *
+ * Description:
+ *   Wait for a registered initializer to complete, typically one marked
+ *   INITCALL_ASYNC.
+ *
+ * Input Parameters:
+ *   call - The initializer
+ *
+ * Returned Value:
+ *   The value returned by the initializer.  -ENODEV if one of its
+ *   dependencies failed, or -EDEADLK if its dependencies can never
+ *   complete.
+ *
+ ****************************************************************************/
+
+int initcall_wait(FAR struct initcall_s *call);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -28,6 +28,7 @@
 #include <nuttx/config.h>
 
 #ifndef __ASSEMBLY__
+#  include <sys/types.h>
 #  include <stdint.h>
 #  include <stdbool.h>
 #endif
@@ -48,6 +49,12 @@
 
 #  define irq_detach(irq) irq_attach(irq, NULL, NULL)
 
+/* Returned by the top half of a threaded interrupt handler to have its
+ * thread run.  See irq_attach_thread().
+ */
+
+#  define IRQ_WAKE_THREAD 1
+
 /* Maximum/minimum values of IRQ integer types */
 
 #  if NR_IRQS <= 256
@@ -148,6 +155,50 @@ extern "C"
 
 int irq_attach(int irq, xcpt_t isr, FAR void *arg);
 
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Attach a threaded interrupt handler to IRQ number 'irq'.  'isr' runs
+ *   in interrupt context and returns IRQ_WAKE_THREAD to have 'isrthread'
+ *   run in a dedicated kernel thread of the given priority.  'isr' may be
+ *   NULL; then the IRQ is disabled on every interrupt and enabled again
+ *   once 'isrthread' has run.  Passing a NULL 'isrthread' detaches the
+ *   handler and deletes the thread.
+ *
+ * Input Parameters:
+ *   irq        - The IRQ number
+ *   isr        - Top half, called in interrupt context; may be NULL
+ *   isrthread  - Bottom half, called in the thread
+ *   arg        - Argument passed to both
+ *   priority   - Priority of the thread
+ *   stack_size - Stack size of the thread
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IRQ_THREAD
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread,
+                      FAR void *arg, int priority, int stack_size);
+#endif
+
+/****************************************************************************
+ * Name: irq_set_affinity
+ *
+ * Description:
+ *   Route IRQ number 'irq' to the CPUs in 'cpuset' with up_affinity_irq().
+ *   If the IRQ has a handler thread attached with irq_attach_thread(), the
+ *   thread is restricted to the same CPUs, so that all of its interrupt
+ *   load stays off the other CPUs.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+int irq_set_affinity(int irq, cpu_set_t cpuset);
+#endif
+
 #ifdef CONFIG_IRQCHAIN
 int irqchain_detach(int irq, xcpt_t isr, FAR void *arg);
 #else
@@ -108,6 +108,15 @@ extern "C"
 
 #endif
 
+/* Without placement hints every attributed allocation comes from the
+ * kernel heap.
+ */
+
+#ifndef CONFIG_MM_KERNEL_HEAP_ATTR
+#  define kmm_malloc_attr(s,a)   kmm_malloc(s)
+#  define kmm_zalloc_attr(s,a)   kmm_zalloc(s)
+#endif
+
 #ifdef CONFIG_MM_KERNEL_HEAP
 /****************************************************************************
  * Group memory management
@@ -68,6 +68,10 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#ifdef CONFIG_LIBM_VECTOR
+#  include <sys/types.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -609,6 +613,19 @@ double      scalbn(double x, int n);
 long double scalbnl(long double x, int n);
 #endif
 
+/* Batch Functions **********************************************************/
+
+/* y[i] = f(x[i]) for i = 0..n - 1, see CONFIG_LIBM_VECTOR */
+
+#ifdef CONFIG_LIBM_VECTOR
+void        vsinf  (const float *x, float *y, size_t n);
+void        vcosf  (const float *x, float *y, size_t n);
+void        vexpf  (const float *x, float *y, size_t n);
+void        vlogf  (const float *x, float *y, size_t n);
+void        vatan2f(const float *y, const float *x, float *z, size_t n);
+void        vsqrtf (const float *x, float *y, size_t n);
+#endif
+
 #define FP_INFINITE     0
 #define FP_NAN          1
 #define FP_NORMAL       2
@@ -115,6 +115,7 @@ typedef CODE int (*mod_uninitializer_t)(FAR void *arg);
  */
 
 struct symtab_s;
+struct symtab_hash_s;
 struct mod_info_s
 {
   mod_uninitializer_t uninitializer;   /* Module uninitializer */
@@ -157,6 +158,7 @@ struct module_s
   mod_initializer_t initializer;       /* Module initializer function */
 #endif
   struct mod_info_s modinfo;           /* Module information */
+  FAR struct symtab_hash_s *exphash;   /* Hash index of modinfo.exports */
   FAR void *textalloc;                 /* Allocated kernel text memory */
   FAR void *dataalloc;                 /* Allocated kernel memory */
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
@@ -204,6 +206,9 @@ struct mod_loadinfo_s
   uint8_t      *iobuffer;    /* File I/O buffer */
   uintptr_t     datasec;     /* ET_DYN - data area start from Phdr */
   uintptr_t     segpad;      /* Padding between text and data */
+#ifdef CONFIG_MODLIB_XIP
+  uintptr_t     xipbase;     /* Address of the file in memory, 0 if none */
+#endif
   uintptr_t     initarr;     /* .init_array */
   uintptr_t     finiarr;     /* .fini_array */
   uintptr_t     preiarr;     /* .preinit_array */
@@ -275,6 +280,23 @@ int modlib_uninitialize(FAR struct mod_loadinfo_s *loadinfo);
 
 void modlib_getsymtab(FAR const struct symtab_s **symtab, FAR int *nsymbols);
 
+/****************************************************************************
+ * Name: modlib_findsymbol
+ *
+ * Description:
+ *   Find a symbol by name in the current symbol table selection.  The hash
+ *   index of the table is used if there is one.
+ *
+ * Input Parameters:
+ *   name - The name of the symbol
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry; NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *modlib_findsymbol(FAR const char *name);
+
 /****************************************************************************
  * Name: modlib_setsymtab
  *
@@ -0,0 +1,161 @@
+/****************************************************************************
+ * include/nuttx/lockstat.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_LOCKSTAT_H
+#define __INCLUDE_NUTTX_LOCKSTAT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Lock types */
+
+#define LOCKSTAT_SEM        0  /* Counting semaphore, wait time only */
+#define LOCKSTAT_MUTEX      1  /* Mutex, wait and hold time */
+#define LOCKSTAT_SPINLOCK   2  /* Spinlock, wait and hold time */
+
+/* The caller recorded for a lock operation */
+
+#define LOCKSTAT_CALLER()   __builtin_return_address(0)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The statistics of one lock taken from one call site.  Times are in
+ * up_perf_gettime() counts.
+ */
+
+struct lockstat_s
+{
+  FAR const void *lock;     /* Address of the lock */
+  FAR void *caller;         /* Return address of the acquiring call */
+  uint8_t type;             /* See LOCKSTAT_* definitions */
+  uint32_t acquires;        /* Number of successful acquisitions */
+  uint32_t contended;       /* Number of acquisitions that had to wait */
+  uint32_t holds;           /* Number of measured hold times */
+  unsigned long waitmax;    /* Longest wait */
+  unsigned long holdmax;    /* Longest hold */
+  uint64_t waittotal;       /* Sum of all waits */
+  uint64_t holdtotal;       /* Sum of all measured holds */
+};
+
+typedef CODE void (*lockstat_handler_t)(FAR const struct lockstat_s *stat,
+                                        FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: lockstat_acquire
+ *
+ * Description:
+ *   Record a successful acquisition of a lock.  For mutexes and spinlocks
+ *   the hold time is measured until the matching lockstat_release().
+ *
+ * Input Parameters:
+ *   lock      - The address of the lock
+ *   type      - The type of the lock, one of LOCKSTAT_*
+ *   caller    - The call site, normally LOCKSTAT_CALLER()
+ *   start     - up_perf_gettime() when the acquisition was started
+ *   contended - True if the lock was not immediately available
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void lockstat_acquire(FAR const void *lock, uint8_t type,
+                      FAR void *caller, unsigned long start,
+                      bool contended);
+
+/****************************************************************************
+ * Name: lockstat_release
+ *
+ * Description:
+ *   Record the release of a mutex or spinlock and account its hold time.
+ *
+ * Input Parameters:
+ *   lock - The address of the lock
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void lockstat_release(FAR const void *lock);
+
+/****************************************************************************
+ * Name: lockstat_foreach
+ *
+ * Description:
+ *   Call 'handler' with a snapshot of every recorded (lock, caller) pair.
+ *   The handler is called without any lock held.
+ *
+ * Input Parameters:
+ *   handler - The function to call for each entry
+ *   arg     - An opaque argument passed to the handler
+ *
+ * Returned Value:
+ *   The number of events dropped because the table was full.
+ *
+ ****************************************************************************/
+
+uint32_t lockstat_foreach(lockstat_handler_t handler, FAR void *arg);
+
+/****************************************************************************
+ * Name: lockstat_reset
+ *
+ * Description:
+ *   Discard all statistics collected so far.  Locks that are currently
+ *   held are not measured on release.
+ *
+ ****************************************************************************/
+
+void lockstat_reset(void);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_SCHED_LOCKSTAT */
+#endif /* __INCLUDE_NUTTX_LOCKSTAT_H */
@@ -27,6 +27,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/uio.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -76,10 +77,24 @@
 #  define CONFIG_IOB_ALIGNMENT      1
 #endif
 
+/* External buffers and pools of other sizes need the data of an I/O
+ * buffer to be addressed through a pointer.
+ */
+
+#if defined(CONFIG_IOB_EXTBUF) || defined(CONFIG_IOB_POOLS)
+#  define IOB_HAVE_BUFPTR
+#endif
+
 /* IOB helpers */
 
+#ifdef IOB_HAVE_BUFPTR
+#  define IOB_BUFSIZE(p) ((p)->io_bufsize)
+#else
+#  define IOB_BUFSIZE(p) CONFIG_IOB_BUFSIZE
+#endif
+
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -92,6 +107,28 @@
  * Public Types
  ****************************************************************************/
 
+#ifdef CONFIG_IOB_EXTBUF
+/* An external buffer that I/O buffers can refer to instead of carrying
+ * their own data.  The owner initializes it with iob_extbuf_init(), which
+ * gives the owner the first reference, attaches it to I/O buffers with
+ * iob_tryalloc_extbuf() and drops its own reference with iob_extbuf_put().
+ * eb_release is called when the last reference is dropped, possibly from
+ * an interrupt handler.
+ */
+
+struct iob_extbuf_s;
+typedef CODE void (*iob_extbuf_release_t)(FAR struct iob_extbuf_s *ext);
+
+struct iob_extbuf_s
+{
+  FAR uint8_t *eb_data;            /* The memory of the buffer */
+  uint16_t eb_size;                /* The size of the buffer in bytes */
+  int eb_refs;                     /* Number of references */
+  iob_extbuf_release_t eb_release; /* Called when unreferenced */
+  FAR void *eb_arg;                /* Owner private data */
+};
+#endif
+
 /* Represents one I/O buffer.  A packet is contained by one or more I/O
  * buffers in a chain.  The io_pktlen is only valid for the I/O buffer at
  * the head of the chain.
@@ -105,7 +142,7 @@ struct iob_s
 
   /* Payload */
 
-#if CONFIG_IOB_BUFSIZE < 256
+#if CONFIG_IOB_BUFSIZE < 256 && !defined(IOB_HAVE_BUFPTR)
   uint8_t  io_len;      /* Length of the data in the entry */
   uint8_t  io_offset;   /* Data begins at this offset */
 #else
@@ -114,7 +151,22 @@ struct iob_s
 #endif
   unsigned int io_pktlen; /* Total length of the packet */
 
+#ifdef IOB_HAVE_BUFPTR
+  uint16_t io_bufsize;  /* Size of the memory at io_data */
+#ifdef CONFIG_IOB_POOLS
+  uint8_t  io_pool;     /* Owning pool, 0 for the default pool */
+#endif
+#ifdef CONFIG_IOB_EXTBUF
+  FAR struct iob_extbuf_s *io_ext; /* External buffer, NULL if none */
+#endif
+  FAR uint8_t *io_data; /* io_buf or the memory of io_ext */
+
+  /* Must be last: the buffers of the other pools are sized differently */
+
+  uint8_t  io_buf[CONFIG_IOB_BUFSIZE];
+#else
   uint8_t  io_data[CONFIG_IOB_BUFSIZE];
+#endif
 };
 
 #if CONFIG_IOB_NCHAINS > 0
@@ -203,6 +255,74 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+#ifdef CONFIG_IOB_POOLS
+/****************************************************************************
+ * Name: iob_alloc_size/iob_tryalloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer from the pool whose buffer size fits 'size'
+ *   best: the smallest one that holds 'size' bytes, or the largest one if
+ *   there is none.  The default pool is used if it fits best or the
+ *   chosen pool is exhausted, iob_alloc_size() then waits for a buffer
+ *   like iob_alloc().
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_size(unsigned int size, bool throttled);
+FAR struct iob_s *iob_tryalloc_size(unsigned int size, bool throttled);
+#endif
+
+#ifdef CONFIG_IOB_EXTBUF
+/****************************************************************************
+ * Name: iob_extbuf_init
+ *
+ * Description:
+ *   Initialize an external buffer.  The caller holds the first reference
+ *   and drops it with iob_extbuf_put().
+ *
+ * Input Parameters:
+ *   ext     - The external buffer to initialize
+ *   data    - The memory of the buffer
+ *   size    - The size of the memory in bytes
+ *   release - Called when the last reference is dropped
+ *   arg     - Owner private data, saved in eb_arg
+ *
+ ****************************************************************************/
+
+void iob_extbuf_init(FAR struct iob_extbuf_s *ext, FAR void *data,
+                     uint16_t size, iob_extbuf_release_t release,
+                     FAR void *arg);
+
+/****************************************************************************
+ * Name: iob_extbuf_put
+ *
+ * Description:
+ *   Drop a reference to an external buffer, releasing it if it was the
+ *   last one.
+ *
+ ****************************************************************************/
+
+void iob_extbuf_put(FAR struct iob_extbuf_s *ext);
+
+/****************************************************************************
+ * Name: iob_tryalloc_extbuf
+ *
+ * Description:
+ *   Allocate an I/O buffer whose data is 'len' bytes of an external
+ *   buffer, starting at 'offset', without copying.  The I/O buffer takes
+ *   a reference to the external buffer that is dropped when it is freed.
+ *   The unused memory after the data is available as tail room.
+ *
+ * Returned Value:
+ *   The I/O buffer, NULL if none is available.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_extbuf(bool throttled,
+                                      FAR struct iob_extbuf_s *ext,
+                                      uint16_t offset, uint16_t len);
+#endif
+
 /****************************************************************************
  * Name: iob_navail
  *
@@ -592,6 +712,29 @@ int iob_update_pktlen(FAR struct iob_s *iob, unsigned int pktlen,
 
 int iob_count(FAR struct iob_s *iob);
 
+/****************************************************************************
+ * Name: iob_to_sglist
+ *
+ * Description:
+ *   Describe the data of an I/O buffer chain, starting 'offset' bytes into
+ *   the packet, as a scatter-gather list, e.g. to program the DMA
+ *   descriptors of a device.  Empty entries are skipped.
+ *
+ * Input Parameters:
+ *   iob    - The head of the I/O buffer chain
+ *   offset - The number of leading bytes to leave out
+ *   iov    - The list to fill
+ *   iovcnt - The number of entries of the list
+ *
+ * Returned Value:
+ *   The number of entries used, or -E2BIG if the chain needs more than
+ *   'iovcnt' entries.
+ *
+ ****************************************************************************/
+
+int iob_to_sglist(FAR struct iob_s *iob, unsigned int offset,
+                  FAR struct iovec *iov, int iovcnt);
+
 /****************************************************************************
  * Name: iob_dump
  *
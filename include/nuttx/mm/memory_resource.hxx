@@ -0,0 +1,143 @@
+//***************************************************************************
+// include/nuttx/mm/memory_resource.hxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+#ifndef __INCLUDE_NUTTX_MM_MEMORY_RESOURCE_HXX
+#define __INCLUDE_NUTTX_MM_MEMORY_RESOURCE_HXX
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <experimental/memory_resource>
+
+#ifdef CONFIG_LIBCXX_PMR
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+// Blocks up to CONFIG_LIBCXX_PMR_THRESHOLD bytes are served from size
+// classes spaced LIBCXX_PMR_GRANULE bytes apart.
+
+#define LIBCXX_PMR_GRANULE  16
+#define LIBCXX_PMR_NCLASSES (CONFIG_LIBCXX_PMR_THRESHOLD / LIBCXX_PMR_GRANULE)
+
+//***************************************************************************
+// Public Types
+//***************************************************************************
+
+struct mempool_multiple_s;
+
+namespace nuttx
+{
+namespace pmr
+{
+  using std::experimental::pmr::memory_resource;
+  using std::experimental::pmr::get_default_resource;
+
+  // A thread-safe resource that serves small blocks from a multiple
+  // mempool.  Each size class has its own pool, so only a pool that has to
+  // grow takes the heap lock.  Larger blocks come from 'upstream'.
+
+  class mempool_resource : public memory_resource
+  {
+  public:
+    explicit mempool_resource(FAR const char *name = "pmr",
+                              memory_resource *upstream =
+                                get_default_resource());
+    ~mempool_resource();
+
+    mempool_resource(const mempool_resource &) = delete;
+    mempool_resource &operator=(const mempool_resource &) = delete;
+
+  protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(const memory_resource &other) const noexcept override;
+
+  private:
+    FAR struct mempool_multiple_s *m_mpool;
+    memory_resource *m_upstream;
+  };
+
+  // A resource for the use of a single thread.  Small blocks are carved
+  // from chunks taken from 'upstream' and recycled through per size class
+  // free lists without any locking.  Blocks must be released by the thread
+  // that uses the resource; the chunks are returned to 'upstream' when the
+  // resource is destroyed.
+
+  class arena_resource : public memory_resource
+  {
+  public:
+    explicit arena_resource(std::size_t chunksize =
+                              CONFIG_LIBCXX_PMR_ARENA_CHUNKSIZE,
+                            memory_resource *upstream =
+                              get_default_resource());
+    ~arena_resource();
+
+    arena_resource(const arena_resource &) = delete;
+    arena_resource &operator=(const arena_resource &) = delete;
+
+    // Return all chunks to 'upstream'.  Every block is invalidated.
+
+    void release();
+
+  protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(const memory_resource &other) const noexcept override;
+
+  private:
+    struct block
+    {
+      FAR struct block *next;
+    };
+
+    struct chunk
+    {
+      FAR struct chunk *next;
+      std::size_t size;
+    };
+
+    FAR struct block *m_free[LIBCXX_PMR_NCLASSES];
+    FAR struct chunk *m_chunks;
+    FAR char *m_cur;
+    FAR char *m_end;
+    std::size_t m_chunksize;
+    memory_resource *m_upstream;
+  };
+
+  // Return the arena_resource of the calling thread, created on first use
+  // and destroyed when the thread exits.  If no arena can be created, the
+  // default resource is returned instead.
+
+#if CONFIG_TLS_NELEM > 0
+  memory_resource *thread_arena_resource();
+#endif
+} // namespace pmr
+} // namespace nuttx
+
+#endif // CONFIG_LIBCXX_PMR
+#endif // __INCLUDE_NUTTX_MM_MEMORY_RESOURCE_HXX
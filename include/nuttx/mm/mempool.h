@@ -88,6 +88,21 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+/* A lock-free stack of free blocks.  'top' holds the index of the first
+ * block plus one in its lower half and a tag in its upper half.  The tag
+ * is incremented by every pop, so that a block that was popped and pushed
+ * again while another context was about to pop it (ABA) makes the other
+ * context's compare-and-swap fail.
+ */
+
+struct mempool_lfstack_s
+{
+  uintptr_t top;    /* Tagged index of the first free block */
+  size_t    count;  /* The number of blocks in the stack */
+};
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -113,6 +128,16 @@ struct mempool_s
   size_t     nalloc;    /* The number of used block in mempool */
 #endif
   spinlock_t lock;      /* The protect lock to mempool */
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  bool       lockfree;  /* The free blocks are held in the stacks below */
+  FAR char  *lfbase;    /* The base of the normal mempool blocks */
+  size_t     lfnint;    /* The number of interrupt mempool blocks */
+
+  /* The free blocks in normal and interrupt mempool */
+
+  struct mempool_lfstack_s lfqueue;
+  struct mempool_lfstack_s lfiqueue;
+#endif
   sem_t      waitsem;   /* The semaphore of waiter get free block */
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   struct mempool_procfs_entry_s procfs; /* The entry of procfs */
@@ -305,6 +330,23 @@ void mempool_procfs_register(FAR struct mempool_procfs_entry_s *entry,
 void mempool_procfs_unregister(FAR struct mempool_procfs_entry_s *entry);
 #endif
 
+/****************************************************************************
+ * Name: mempool_procfs_foreach
+ *
+ * Description:
+ *   Call 'handler' for each mempool registered in the procfs file system.
+ *
+ * Input Parameters:
+ *   handler - The function called for each pool
+ *   arg     - The argument passed to the handler
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
+void mempool_procfs_foreach(mempool_multiple_foreach_t handler,
+                            FAR void *arg);
+#endif
+
 /****************************************************************************
  * Name: mempool_multiple_init
  *
@@ -487,6 +529,20 @@ void mempool_multiple_memdump(FAR struct mempool_multiple_s *mpool,
 
 void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool);
 
+/****************************************************************************
+ * Name: mempool_multiple_drain
+ *
+ * Description:
+ *   Return the free blocks held in the per-CPU caches of all CPUs to their
+ *   pools.  Without CONFIG_MM_HEAP_MEMPOOL_CPUCACHE this does nothing.
+ *
+ * Input Parameters:
+ *   mpool - The handle of multiple memory pool to be used.
+ *
+ ****************************************************************************/
+
+void mempool_multiple_drain(FAR struct mempool_multiple_s *mpool);
+
 /****************************************************************************
  * Name: mempool_multiple_foreach
  * Description:
@@ -523,6 +579,89 @@ struct mallinfo_task
 mempool_multiple_info_task(FAR struct mempool_multiple_s *mpool,
                            FAR const struct malltask *task);
 
+#ifdef CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE
+
+/****************************************************************************
+ * Name: mempool_multiple_enable
+ *
+ * Description:
+ *   Enable or disable a size class at run time.  The requests of a
+ *   disabled class are served by the next larger enabled class, or are
+ *   refused if there is none.  Blocks already allocated from a disabled
+ *   class stay valid.
+ *
+ * Input Parameters:
+ *   mpool     - The handle of multiple memory pool to be used.
+ *   blocksize - The block size of the class.
+ *   enable    - True to enable the class, false to disable it.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mempool_multiple_enable(FAR struct mempool_multiple_s *mpool,
+                            size_t blocksize, bool enable);
+
+/****************************************************************************
+ * Name: mempool_multiple_suggest
+ *
+ * Description:
+ *   Compute the set of at most 'npools' of the existing size classes that
+ *   would have served the recorded requests with the least internal
+ *   fragmentation.
+ *
+ * Input Parameters:
+ *   mpool    - The handle of multiple memory pool to be used.
+ *   poolsize - The array that receives the block sizes, in ascending order.
+ *   npools   - The number of elements of poolsize.
+ *   waste    - Receives the bytes the set would have wasted; may be NULL.
+ *
+ * Returned Value:
+ *   The number of classes stored in poolsize; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t mempool_multiple_suggest(FAR struct mempool_multiple_s *mpool,
+                                 FAR size_t *poolsize, size_t npools,
+                                 FAR uint64_t *waste);
+
+/****************************************************************************
+ * Name: mempool_multiple_tune
+ *
+ * Description:
+ *   Dump the recorded size histogram and the best set of 'npools' classes
+ *   for it, and optionally switch the multiple mempool to that set.
+ *
+ * Input Parameters:
+ *   mpool  - The handle of multiple memory pool to be used.
+ *   npools - The number of classes to choose.
+ *   apply  - True to enable exactly the chosen classes.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mempool_multiple_tune(FAR struct mempool_multiple_s *mpool,
+                          size_t npools, bool apply);
+
+/****************************************************************************
+ * Name: mempool_multiple_profile_reset
+ *
+ * Description:
+ *   Clear the size histogram of a multiple mempool.
+ *
+ * Input Parameters:
+ *   mpool - The handle of multiple memory pool to be used.
+ *
+ ****************************************************************************/
+
+void mempool_multiple_profile_reset(FAR struct mempool_multiple_s *mpool);
+
+#endif /* CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -133,12 +133,62 @@
 #  define MM_INTERNAL_HEAP(heap) ((heap) == USR_HEAP)
 #endif
 
+/* Placement hints of kmm_malloc_attr().  MM_FAST and MM_DMA select the
+ * heap, MM_CACHEALIGN gives the block whole data cache lines.
+ */
+
+#define MM_FAST       (1 << 0) /* Low latency memory, e.g. TCM */
+#define MM_DMA        (1 << 1) /* Memory reachable by the DMA controllers */
+#define MM_CACHEALIGN (1 << 2) /* Do not share cache lines with other data */
+
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+/* The number of power of two classes of the heap telemetry histograms */
+
+#  define MM_MEMFRAG_NCLASSES 32
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
 struct mm_heap_s; /* Forward reference */
 
+/* Called by mm_walk() for each chunk of a heap.  'mem' and 'size' cover
+ * the chunk and 'used' tells if it is allocated.
+ */
+
+typedef CODE void (*mm_walk_handler_t)(FAR void *mem, size_t size,
+                                       bool used, FAR void *arg);
+
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+/* A snapshot of the state of a heap.  Class n of the free chunk histogram
+ * holds the chunks of size [2^n, 2^(n+1)), which is the free list class of
+ * the chunk.  Class n of the latency histograms holds the calls that took
+ * [2^n, 2^(n+1)) up_perf_gettime() counts.
+ */
+
+struct mm_memfrag_s
+{
+  size_t   freecount[MM_MEMFRAG_NCLASSES]; /* Free chunks per class */
+  size_t   freebytes[MM_MEMFRAG_NCLASSES]; /* Free bytes per class */
+  size_t   totalfree;                      /* Sum of all free chunks */
+  size_t   largest;                        /* The largest free chunk */
+  uint32_t alloclat[MM_MEMFRAG_NCLASSES];  /* mm_malloc() latencies */
+  uint32_t freelat[MM_MEMFRAG_NCLASSES];   /* mm_free() latencies */
+  unsigned long allocmax;                  /* The slowest mm_malloc() */
+  unsigned long freemax;                   /* The slowest mm_free() */
+};
+
+/* The memory held by one call site */
+
+struct mm_memfrag_caller_s
+{
+  FAR void *caller;                        /* The allocating call site */
+  size_t    count;                         /* Number of allocated chunks */
+  size_t    bytes;                         /* Sum of their sizes */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -203,6 +253,12 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
                   size_t heapsize);
 void mm_uninitialize(FAR struct mm_heap_s *heap);
 
+#ifdef CONFIG_MM_KASAN
+void mm_kasan_enable(FAR struct mm_heap_s *heap, bool enable);
+#else
+#  define mm_kasan_enable(heap, enable)
+#endif
+
 /* Functions contained in umm_initialize.c **********************************/
 
 void umm_initialize(FAR void *heap_start, size_t heap_size);
@@ -316,6 +372,15 @@ bool umm_heapmember(FAR void *mem);
 bool kmm_heapmember(FAR void *mem);
 #endif
 
+/* Functions contained in kmm_malloc_attr.c *********************************/
+
+#ifdef CONFIG_MM_KERNEL_HEAP_ATTR
+int kmm_addheap_attr(FAR struct mm_heap_s *heap, unsigned int attr);
+FAR struct mm_heap_s *kmm_heapof(FAR void *mem);
+FAR void *kmm_malloc_attr(size_t size, unsigned int attr) malloc_like1(1);
+FAR void *kmm_zalloc_attr(size_t size, unsigned int attr) malloc_like1(1);
+#endif
+
 /* Functions contained in mm_brkaddr.c **************************************/
 
 FAR void *mm_brkaddr(FAR struct mm_heap_s *heap, int region);
@@ -365,6 +430,28 @@ struct mallinfo_task kmm_mallinfo_task(FAR const struct malltask *task);
 void mm_memdump(FAR struct mm_heap_s *heap,
                 FAR const struct mm_memdump_s *dump);
 
+/* Functions contained in mm_walk.c *****************************************/
+
+void mm_walk(FAR struct mm_heap_s *heap, mm_walk_handler_t handler,
+             FAR void *arg);
+
+/* Functions contained in mm_memfrag.c **************************************/
+
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+void mm_memfrag(FAR struct mm_heap_s *heap, FAR struct mm_memfrag_s *frag);
+void mm_memfrag_reset(FAR struct mm_heap_s *heap);
+#  if CONFIG_MM_BACKTRACE > 0
+size_t mm_memfrag_callers(FAR struct mm_heap_s *heap,
+                          FAR struct mm_memfrag_caller_s *callers,
+                          size_t ncallers);
+#  endif
+#endif
+
+#ifdef CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE
+int mm_mempool_tune(FAR struct mm_heap_s *heap, size_t npools,
+                    bool apply);
+#endif
+
 #ifdef CONFIG_DEBUG_MM
 /* Functions contained in mm_checkcorruption.c ******************************/
 
@@ -104,6 +104,8 @@ struct mqueue_cmn_s
 
 /* This structure defines a message queue */
 
+struct mqueue_ring_s; /* Forward reference */
+
 struct mqueue_inode_s
 {
   struct mqueue_cmn_s cmn;    /* Common prologue */
@@ -122,6 +124,9 @@ struct mqueue_inode_s
   struct sigwork_s ntwork;    /* Notification work */
 #endif
   FAR struct pollfd *fds[CONFIG_FS_MQUEUE_NPOLLWAITERS];
+#ifdef CONFIG_MQ_RINGBUF
+  FAR struct mqueue_ring_s *ring; /* Lock-free message ring (MQ_RINGBUF) */
+#endif
 };
 
 /****************************************************************************
@@ -34,6 +34,11 @@
 
 #include <nuttx/fs/ioctl.h>
 
+#ifdef CONFIG_MTD_STATISTICS
+#  include <errno.h>
+#  include <string.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -76,15 +81,30 @@
                                              *      erased state of the MTD cell */
 #define MTDIOC_ERASESECTORS _MTDIOC(0x000c) /* IN: Pointer to mtd_erase_s structure
                                              * OUT: None */
+#define MTDIOC_STATISTICS   _MTDIOC(0x000d) /* IN:  Pointer to write-able struct
+                                             *      mtd_stats_s
+                                             * OUT: The access counters of the
+                                             *      MTD (CONFIG_MTD_STATISTICS) */
+#define MTDIOC_RESETSTATS   _MTDIOC(0x000e) /* IN:  None
+                                             * OUT: None */
 
 /* Macros to hide implementation */
 
-#define MTD_ERASE(d,s,n)   ((d)->erase   ? (d)->erase(d,s,n)    : (-ENOSYS))
-#define MTD_BREAD(d,s,n,b) ((d)->bread   ? (d)->bread(d,s,n,b)  : (-ENOSYS))
-#define MTD_BWRITE(d,s,n,b)((d)->bwrite  ? (d)->bwrite(d,s,n,b) : (-ENOSYS))
-#define MTD_READ(d,s,n,b)  ((d)->read    ? (d)->read(d,s,n,b)   : (-ENOSYS))
-#define MTD_WRITE(d,s,n,b) ((d)->write   ? (d)->write(d,s,n,b)  : (-ENOSYS))
-#define MTD_IOCTL(d,c,a)   ((d)->ioctl   ? (d)->ioctl(d,c,a)    : (-ENOSYS))
+#ifdef CONFIG_MTD_STATISTICS
+#  define MTD_ERASE(d,s,n)   mtd_erase_count(d,s,n)
+#  define MTD_BREAD(d,s,n,b) mtd_bread_count(d,s,n,b)
+#  define MTD_BWRITE(d,s,n,b)mtd_bwrite_count(d,s,n,b)
+#  define MTD_READ(d,s,n,b)  mtd_read_count(d,s,n,b)
+#  define MTD_WRITE(d,s,n,b) mtd_write_count(d,s,n,b)
+#  define MTD_IOCTL(d,c,a)   mtd_ioctl_count(d,c,a)
+#else
+#  define MTD_ERASE(d,s,n)   ((d)->erase   ? (d)->erase(d,s,n)    : (-ENOSYS))
+#  define MTD_BREAD(d,s,n,b) ((d)->bread   ? (d)->bread(d,s,n,b)  : (-ENOSYS))
+#  define MTD_BWRITE(d,s,n,b)((d)->bwrite  ? (d)->bwrite(d,s,n,b) : (-ENOSYS))
+#  define MTD_READ(d,s,n,b)  ((d)->read    ? (d)->read(d,s,n,b)   : (-ENOSYS))
+#  define MTD_WRITE(d,s,n,b) ((d)->write   ? (d)->write(d,s,n,b)  : (-ENOSYS))
+#  define MTD_IOCTL(d,c,a)   ((d)->ioctl   ? (d)->ioctl(d,c,a)    : (-ENOSYS))
+#endif
 #define MTD_ISBAD(d,b)     ((d)->isbad   ? (d)->isbad(d,b)      : (-ENOSYS))
 #define MTD_MARKBAD(d,b)   ((d)->markbad ? (d)->markbad(d,b)    : (-ENOSYS))
 
@@ -149,6 +169,20 @@ struct mtd_erase_s
   uint32_t nblocks;     /* Number of blocks to be erased */
 };
 
+/* The access counters of an MTD, returned by MTDIOC_STATISTICS.  Only the
+ * successful accesses are counted.
+ */
+
+struct mtd_stats_s
+{
+  uint32_t nerase;      /* Number of erase requests */
+  uint32_t nerased;     /* Number of erase blocks erased */
+  uint32_t nbread;      /* Number of read/write blocks read */
+  uint32_t nbwrite;     /* Number of read/write blocks written */
+  uint64_t nread;       /* Number of bytes read with read() */
+  uint64_t nwrite;      /* Number of bytes written with write() */
+};
+
 /* This structure defines the interface to a simple memory technology device.
  * It will likely need to be extended in the future to support more complex
  * devices.
@@ -205,8 +239,122 @@ struct mtd_dev_s
   /* Name of this MTD device */
 
   FAR const char *name;
+
+#ifdef CONFIG_MTD_STATISTICS
+  /* Access counters, kept by the MTD_* macros */
+
+  struct mtd_stats_s stats;
+#endif
 };
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_STATISTICS
+static inline int mtd_erase_count(FAR struct mtd_dev_s *dev,
+                                  off_t startblock, size_t nblocks)
+{
+  int ret = dev->erase ? dev->erase(dev, startblock, nblocks) : -ENOSYS;
+
+  if (ret >= 0)
+    {
+      dev->stats.nerase++;
+      dev->stats.nerased += nblocks;
+    }
+
+  return ret;
+}
+
+static inline ssize_t mtd_bread_count(FAR struct mtd_dev_s *dev,
+                                      off_t startblock, size_t nblocks,
+                                      FAR uint8_t *buffer)
+{
+  ssize_t ret = dev->bread ? dev->bread(dev, startblock, nblocks, buffer) :
+                             -ENOSYS;
+
+  if (ret > 0)
+    {
+      dev->stats.nbread += ret;
+    }
+
+  return ret;
+}
+
+static inline ssize_t mtd_bwrite_count(FAR struct mtd_dev_s *dev,
+                                       off_t startblock, size_t nblocks,
+                                       FAR const uint8_t *buffer)
+{
+  ssize_t ret = dev->bwrite ? dev->bwrite(dev, startblock, nblocks, buffer) :
+                              -ENOSYS;
+
+  if (ret > 0)
+    {
+      dev->stats.nbwrite += ret;
+    }
+
+  return ret;
+}
+
+static inline ssize_t mtd_read_count(FAR struct mtd_dev_s *dev,
+                                     off_t offset, size_t nbytes,
+                                     FAR uint8_t *buffer)
+{
+  ssize_t ret = dev->read ? dev->read(dev, offset, nbytes, buffer) :
+                            -ENOSYS;
+
+  if (ret > 0)
+    {
+      dev->stats.nread += ret;
+    }
+
+  return ret;
+}
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+static inline ssize_t mtd_write_count(FAR struct mtd_dev_s *dev,
+                                      off_t offset, size_t nbytes,
+                                      FAR const uint8_t *buffer)
+{
+  ssize_t ret = dev->write ? dev->write(dev, offset, nbytes, buffer) :
+                             -ENOSYS;
+
+  if (ret > 0)
+    {
+      dev->stats.nwrite += ret;
+    }
+
+  return ret;
+}
+#endif
+
+/* The statistics ioctls are served here for every driver */
+
+static inline int mtd_ioctl_count(FAR struct mtd_dev_s *dev, int cmd,
+                                  unsigned long arg)
+{
+  if (cmd == MTDIOC_STATISTICS)
+    {
+      FAR struct mtd_stats_s *stats = (FAR struct mtd_stats_s *)arg;
+
+      if (stats == NULL)
+        {
+          return -EINVAL;
+        }
+
+      *stats = dev->stats;
+      return OK;
+    }
+  else if (cmd == MTDIOC_RESETSTATS)
+    {
+      memset(&dev->stats, 0, sizeof(dev->stats));
+      return OK;
+    }
+
+  return dev->ioctl ? dev->ioctl(dev, cmd, arg) : -ENOSYS;
+}
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -114,6 +114,31 @@ extern "C"
 struct net_driver_s; /* Forward reference */
 int can_input(FAR struct net_driver_s *dev);
 
+#ifdef CONFIG_NET_TIMESTAMP
+/****************************************************************************
+ * Name: can_input_timestamp
+ *
+ * Description:
+ *   Same as can_input(), but the frame is stamped with the time at which
+ *   the controller received it instead of the time it is handled.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure containing the received packet
+ *   ts  - The receive time of the frame, on the CLOCK_REALTIME scale
+ *
+ * Returned Value:
+ *   The same as can_input().
+ *
+ * Assumptions:
+ *   Called from the CAN device diver with the network locked.
+ *
+ ****************************************************************************/
+
+struct timespec; /* Forward reference */
+int can_input_timestamp(FAR struct net_driver_s *dev,
+                        FAR const struct timespec *ts);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -135,10 +135,11 @@ typedef uint8_t sockcaps_t;
  * a given address family.
  */
 
-struct file;    /* Forward reference */
-struct stat;    /* Forward reference */
-struct socket;  /* Forward reference */
-struct pollfd;  /* Forward reference */
+struct file;           /* Forward reference */
+struct stat;           /* Forward reference */
+struct socket;         /* Forward reference */
+struct pollfd;         /* Forward reference */
+struct mm_map_entry_s; /* Forward reference */
 
 struct sock_intf_s
 {
@@ -179,6 +180,22 @@ struct sock_intf_s
                     FAR struct file *infile, FAR off_t *offset,
                     size_t count);
 #endif
+
+  /* Optional batched paths, NULL or -ENOSYS falls back to one
+   * si_recvmsg/si_sendmsg call per message.
+   */
+
+  CODE int        (*si_recvmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags, FAR struct timespec *timeout);
+  CODE int        (*si_sendmmsg)(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
+
+  /* Optional, map the memory shared with the network into the caller */
+
+  CODE int        (*si_mmap)(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
 };
 
 /* Each socket refers to a connection structure of type FAR void *.  Each
@@ -204,6 +221,13 @@ struct socket_conn_s
   FAR struct devif_callback_s *list;
   FAR struct devif_callback_s *list_tail;
 
+#ifdef CONFIG_NETDEV_POLL_PENDING
+  /* The queue of the device that has TX pending for this connection */
+
+  dq_entry_t pnode;
+  FAR dq_queue_t *pqueue;
+#endif
+
   /* Socket options */
 
 #ifdef CONFIG_NET_SOCKOPTS
@@ -925,6 +949,60 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives up to 'vlen' messages from a socket with a
+ *   single call.  This is an internal OS interface.  It is functionally
+ *   equivalent to recvmmsg() except that it is not a cancellation point,
+ *   does not modify the errno variable and accepts the internal socket
+ *   structure as an input rather than a task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to receive, msg_len is set for each of them
+ *   vlen      The number of messages in msgvec
+ *   flags     Receive flags, MSG_WAITFORONE included
+ *   timeout   Checked after each message as on Linux, or NULL
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  Otherwise, on
+ *   any failure, a negated errno value is returned (see comments with
+ *   recvmsg() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout);
+
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends up to 'vlen' messages to a socket with a single
+ *   call.  This is an internal OS interface.  It is functionally
+ *   equivalent to sendmmsg() except that it is not a cancellation point,
+ *   does not modify the errno variable and accepts the internal socket
+ *   structure as an input rather than a task-specific socket descriptor.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    The messages to send, msg_len is set for each of them
+ *   vlen      The number of messages in msgvec
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  Otherwise, on any
+ *   failure, a negated errno value is returned (see comments with
+ *   sendmsg() for a list of appropriate errno values).
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -1327,6 +1405,24 @@ int psock_shutdown(FAR struct socket *psock, int how);
 struct pollfd; /* Forward reference -- see poll.h */
 int psock_poll(FAR struct socket *psock, struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: psock_mmap
+ *
+ * Description:
+ *   The standard mmap() operation redirects operations on socket
+ *   descriptors to this function.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   map   - The mapping to setup, see mm_map_entry_s.
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure.
+ *
+ ****************************************************************************/
+
+int psock_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map);
+
 /****************************************************************************
  * Name: psock_dup2
  *
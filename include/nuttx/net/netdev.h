@@ -97,6 +97,30 @@
 #  define RADIO_MAX_ADDRLEN CONFIG_PKTRADIO_ADDRLEN
 #endif
 
+/* Offloads of the device, set in d_features by the driver before it is
+ * registered:
+ *
+ *   NETDEV_FEATURE_TXCSUM - The device computes the TCP and UDP checksums
+ *     of outgoing packets.  The stack fills the checksum field with the
+ *     sum of the pseudo-header, without the length for TSO segments.
+ *   NETDEV_FEATURE_RXCSUM - The device verifies the TCP and UDP checksums
+ *     of incoming packets and drops the bad ones.
+ *   NETDEV_FEATURE_TSO    - The device splits TCP segments larger than
+ *     d_gsosize into segments of d_gsosize bytes of payload.
+ */
+
+#define NETDEV_FEATURE_TXCSUM (1 << 0)
+#define NETDEV_FEATURE_RXCSUM (1 << 1)
+#define NETDEV_FEATURE_TSO    (1 << 2)
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define NETDEV_HAS_FEATURE(dev,f) (((dev)->d_features & (f)) != 0)
+#  define NETDEV_GSOSIZE(dev)       ((dev)->d_gsosize)
+#else
+#  define NETDEV_HAS_FEATURE(dev,f) false
+#  define NETDEV_GSOSIZE(dev)       0
+#endif
+
 /* Helper macros for network device statistics */
 
 #ifdef CONFIG_NETDEV_STATISTICS
@@ -131,6 +155,8 @@
 #    define NETDEV_RXARP(dev)
 #  endif
 #  define NETDEV_RXDROPPED(dev)   _NETDEV_STATISTIC(dev,rx_dropped)
+#  define NETDEV_RXPOLLS(dev)     _NETDEV_STATISTIC(dev,rx_polls)
+#  define NETDEV_RXEXHAUSTED(dev) _NETDEV_STATISTIC(dev,rx_exhausted)
 
 #  define NETDEV_TXPACKETS(dev)   _NETDEV_STATISTIC(dev,tx_packets)
 #  define NETDEV_TXDONE(dev)      _NETDEV_STATISTIC(dev,tx_done)
@@ -148,6 +174,8 @@
 #  define NETDEV_RXIPV6(dev)
 #  define NETDEV_RXARP(dev)
 #  define NETDEV_RXDROPPED(dev)
+#  define NETDEV_RXPOLLS(dev)
+#  define NETDEV_RXEXHAUSTED(dev)
 
 #  define NETDEV_TXPACKETS(dev)
 #  define NETDEV_TXDONE(dev)
@@ -195,6 +223,8 @@ struct netdev_statistics_s
   uint32_t rx_arp;         /* Number of Rx ARP packets received */
 #endif
   uint32_t rx_dropped;     /* Unsupported Rx packets received */
+  uint32_t rx_polls;       /* Number of Rx polls of the driver */
+  uint32_t rx_exhausted;   /* Number of Rx polls that used up the budget */
 
   /* Tx Status */
 
@@ -271,6 +301,12 @@ struct net_driver_s
 
   uint16_t d_pktsize;           /* Maximum packet size */
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  uint8_t d_features;           /* Offloads, see NETDEV_FEATURE_* */
+  uint16_t d_gsosize;           /* TSO segment size of the packet, or 0.
+                                 * Cleared once the driver took it */
+#endif
+
   /* Link layer address */
 
 #if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_NET_6LOWPAN) || \
@@ -425,6 +461,13 @@ struct net_driver_s
   FAR struct devif_callback_s *d_conncb_tail; /* This is the list tail */
   FAR struct devif_callback_s *d_devcb;
 
+#ifdef CONFIG_NETDEV_POLL_PENDING
+  /* The TCP and UDP connections with pending TX on the device */
+
+  dq_queue_t d_tcppend;
+  dq_queue_t d_udppend;
+#endif
+
   /* Driver callbacks */
 
   int (*d_ifup)(FAR struct net_driver_s *dev);
@@ -438,6 +481,15 @@ struct net_driver_s
   int (*d_ioctl)(FAR struct net_driver_s *dev, int cmd,
                  unsigned long arg);
 #endif
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+  /* Optional: transmit the frame in d_iob right away, as if returned to
+   * the devif_poll() callback.  Used by the IP forwarding fast path from
+   * the RX context of another device.  Returns OK once the frame is taken,
+   * a negated errno value leaves it in d_iob.
+   */
+
+  int (*d_xmit)(FAR struct net_driver_s *dev);
+#endif
 
   /* Drivers may attached device-specific, private information */
 
@@ -802,6 +854,29 @@ uint16_t net_chksum_iob(uint16_t sum, FAR struct iob_s *iob,
 uint16_t ipv4_upperlayer_chksum(FAR struct net_driver_s *dev, uint8_t proto);
 #endif /* CONFIG_NET_IPv4 */
 
+/****************************************************************************
+ * Name: ipv4_upperlayer_txchksum
+ *
+ * Description:
+ *   Return the value for the checksum field of an outgoing IPv4 packet: the
+ *   complemented checksum, or only the sum of the pseudo-header if the
+ *   device computes the checksum (NETDEV_FEATURE_TXCSUM).
+ *
+ * Input Parameters:
+ *   dev   - The network driver instance.  The packet data is in the d_buf
+ *           of the device.
+ *   proto - The protocol being supported
+ *
+ * Returned Value:
+ *   The value for the checksum field
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+uint16_t ipv4_upperlayer_txchksum(FAR struct net_driver_s *dev,
+                                  uint8_t proto);
+#endif /* CONFIG_NET_IPv4 */
+
 /****************************************************************************
  * Name: ipv6_upperlayer_chksum
  *
@@ -827,6 +902,32 @@ uint16_t ipv6_upperlayer_chksum(FAR struct net_driver_s *dev,
                                 uint8_t proto, unsigned int iplen);
 #endif /* CONFIG_NET_IPv6 */
 
+/****************************************************************************
+ * Name: ipv6_upperlayer_txchksum
+ *
+ * Description:
+ *   Return the value for the checksum field of an outgoing IPv6 packet: the
+ *   complemented checksum, or only the sum of the pseudo-header if the
+ *   device computes the checksum (NETDEV_FEATURE_TXCSUM).
+ *
+ * Input Parameters:
+ *   dev   - The network driver instance.  The packet data is in the d_buf
+ *           of the device.
+ *   proto - The protocol being supported
+ *   iplen - The size of the IPv6 header.  This may be larger than
+ *           IPv6_HDRLEN the IPv6 header if IPv6 extension headers are
+ *           present.
+ *
+ * Returned Value:
+ *   The value for the checksum field
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+uint16_t ipv6_upperlayer_txchksum(FAR struct net_driver_s *dev,
+                                  uint8_t proto, unsigned int iplen);
+#endif /* CONFIG_NET_IPv6 */
+
 /****************************************************************************
  * Name: ipv4_chksum
  *
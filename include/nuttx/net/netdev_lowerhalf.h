@@ -121,6 +121,14 @@ struct netdev_lowerhalf_s
   spinlock_t lock;
 #endif
 
+  /* Number of TX/RX queue pairs, set before registration.  Zero or one for
+   * a single queue, the operations of the queues are then not used.
+   */
+
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+  uint8_t nqueues;
+#endif
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
@@ -167,6 +175,68 @@ struct netdev_ops_s
   int (*ioctl)(FAR struct netdev_lowerhalf_s *dev, int cmd,
                unsigned long arg);
 #endif
+
+#ifdef CONFIG_NETDEV_SCATTER_GATHER
+  /* transmit_sg - Optional, used instead of transmit if set.  The packet
+   *   is also described by 'iov': at most CONFIG_NETDEV_SG_MAXSEGS
+   *   segments, the first one starting with the link layer header, ready
+   *   to be programmed into DMA descriptors:  the segments have already
+   *   been written back from the D-cache.  Ownership and returned value
+   *   are those of transmit.  For scatter-gather receive, a chain sized
+   *   with netpkt_setdatalen() can be described with netpkt_to_iov().
+   */
+
+  int (*transmit_sg)(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                     FAR const struct iovec *iov, int iovcnt);
+#endif
+
+  /* rxint - Optional, enable or disable the RX interrupt.  A lower half
+   *   that provides it disables its RX interrupt before it calls
+   *   netdev_lower_rxready(), and leaves it disabled.  The upper half then
+   *   polls receive() up to CONFIG_NETDEV_RX_BUDGET frames at a time and
+   *   enables the interrupt once receive() returns NULL.  It may be enabled
+   *   when it already is, and must fire at once if a frame arrived in the
+   *   meantime.
+   */
+
+  void (*rxint)(FAR struct netdev_lowerhalf_s *dev, bool enable);
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* transmit_tso - Optional, needed for NETDEV_FEATURE_TSO in d_features.
+   *   Used instead of transmit for a TCP segment with more than 'mss'
+   *   bytes of payload, that the device splits into segments of 'mss'
+   *   bytes.  Ownership and returned value are those of transmit.  With
+   *   several queues, transmitq_tso is used instead.
+   */
+
+  int (*transmit_tso)(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                      uint16_t mss);
+#endif
+
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+  /* transmitq/receiveq/rxintq - Used instead of transmit, receive and
+   *   rxint when nqueues is more than one, 'queue' is the index of the
+   *   queue pair.  transmitq and receiveq are mandatory then, rxintq is
+   *   optional.  Each queue is served by a worker of its own and the calls
+   *   for different queues may run at the same time.  The frames of a flow
+   *   are always transmitted on the same queue.
+   */
+
+  int (*transmitq)(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                   int queue);
+  FAR netpkt_t *(*receiveq)(FAR struct netdev_lowerhalf_s *dev, int queue);
+  void (*rxintq)(FAR struct netdev_lowerhalf_s *dev, int queue,
+                 bool enable);
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* transmitq_tso - Optional, transmit_tso for a queue, needed for
+   *   NETDEV_FEATURE_TSO when nqueues is more than one.
+   */
+
+  int (*transmitq_tso)(FAR struct netdev_lowerhalf_s *dev,
+                       FAR netpkt_t *pkt, int queue, uint16_t mss);
+#endif
+#endif
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -309,6 +379,39 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read on
+ *   one queue.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The index of the queue
+ *
+ ****************************************************************************/
+
+#if CONFIG_NETDEV_MAX_QUEUES > 1
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue);
+
+/****************************************************************************
+ * Name: netdev_lower_txdone_queue
+ *
+ * Description:
+ *   Notifies the networking layer about a TX packet is sent on one queue.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The index of the queue
+ *
+ ****************************************************************************/
+
+void netdev_lower_txdone_queue(FAR struct netdev_lowerhalf_s *dev,
+                               int queue);
+#endif
+
 /****************************************************************************
  * Name: netdev_lower_quota_load
  *
@@ -342,6 +445,33 @@ int netdev_lower_quota_load(FAR struct netdev_lowerhalf_s *dev,
 FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
                            enum netpkt_type_e type);
 
+/****************************************************************************
+ * Name: netpkt_alloc_extbuf
+ *
+ * Description:
+ *   Wrap a frame that the hardware placed in an external buffer, e.g. a
+ *   DMA receive buffer, in a netpkt without copying.  The netpkt holds a
+ *   reference to the buffer until the stack frees it.
+ *
+ * Input Parameters:
+ *   dev    - The lower half device driver structure
+ *   type   - Whether used for TX or RX
+ *   ext    - The external buffer holding the frame
+ *   offset - The offset of the frame in the buffer
+ *   len    - The length of the frame, including the link layer header
+ *
+ * Returned Value:
+ *   Pointer to the packet, NULL on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_EXTBUF
+FAR netpkt_t *netpkt_alloc_extbuf(FAR struct netdev_lowerhalf_s *dev,
+                                  enum netpkt_type_e type,
+                                  FAR struct iob_extbuf_s *ext,
+                                  uint16_t offset, uint16_t len);
+#endif
+
 /****************************************************************************
  * Name: netpkt_free
  *
@@ -358,6 +488,30 @@ FAR netpkt_t *netpkt_alloc(FAR struct netdev_lowerhalf_s *dev,
 void netpkt_free(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
                  enum netpkt_type_e type);
 
+/****************************************************************************
+ * Name: netpkt_concat
+ *
+ * Description:
+ *   Append a buffer received as part of a frame to the netpkt holding the
+ *   start of the frame, for devices that spread a frame over several
+ *   receive buffers.  'next' has a single buffer, whose 'len' bytes of
+ *   data start at 'data'.  It no longer counts as a buffer held by the
+ *   driver.
+ *
+ * Input Parameters:
+ *   dev  - The lower half device driver structure
+ *   pkt  - The packet holding the start of the frame
+ *   next - The packet to append
+ *   data - The start of the data in the buffer of 'next'
+ *   len  - The length of the data
+ *   type - Whether used for TX or RX
+ *
+ ****************************************************************************/
+
+void netpkt_concat(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
+                   FAR netpkt_t *next, FAR uint8_t *data, unsigned int len,
+                   enum netpkt_type_e type);
+
 /****************************************************************************
  * Name: netpkt_copyin
  *
@@ -43,6 +43,25 @@
 #define XT_ERROR_TARGET         "ERROR"
 #define XT_MASQUERADE_TARGET    "MASQUERADE"
 
+/* Names of the tcp and udp matches */
+
+#define XT_TCP_MATCH            "tcp"
+#define XT_UDP_MATCH            "udp"
+
+/* Values for "invflags" field in struct xt_tcp. */
+
+#define XT_TCP_INV_SRCPT        0x01 /* Invert the sense of source ports. */
+#define XT_TCP_INV_DSTPT        0x02 /* Invert the sense of dest ports. */
+#define XT_TCP_INV_FLAGS        0x04 /* Invert the sense of TCP flags. */
+#define XT_TCP_INV_OPTION       0x08 /* Invert the sense of option test. */
+#define XT_TCP_INV_MASK         0x0f /* All possible flags. */
+
+/* Values for "invflags" field in struct xt_udp. */
+
+#define XT_UDP_INV_SRCPT        0x01 /* Invert the sense of source ports. */
+#define XT_UDP_INV_DSTPT        0x02 /* Invert the sense of dest ports. */
+#define XT_UDP_INV_MASK         0x03 /* All possible flags. */
+
 /* For standard target */
 
 #define XT_RETURN               (-NF_REPEAT - 1)
@@ -156,4 +175,25 @@ struct xt_entry_match
   unsigned char data[1];
 };
 
+/* The data of the tcp match */
+
+struct xt_tcp
+{
+  uint16_t spts[2];  /* Source port range. */
+  uint16_t dpts[2];  /* Destination port range. */
+  uint8_t  option;   /* TCP Option if non-zero */
+  uint8_t  flg_mask; /* TCP flags mask byte */
+  uint8_t  flg_cmp;  /* TCP flags compare byte */
+  uint8_t  invflags; /* Inverse flags */
+};
+
+/* The data of the udp match */
+
+struct xt_udp
+{
+  uint16_t spts[2];  /* Source port range. */
+  uint16_t dpts[2];  /* Destination port range. */
+  uint8_t  invflags; /* Inverse flags */
+};
+
 #endif /* __INCLUDE_NUTTX_NET_NETFILTER_X_TABLES_H */
@@ -80,6 +80,21 @@
  * Public Type Definitions
  ****************************************************************************/
 
+/* NAT statistics */
+
+#if defined(CONFIG_NET_NAT) && defined(CONFIG_NET_IPv4)
+struct nat_stats_s
+{
+  net_stats_t entries;   /* Number of NAT entries */
+  net_stats_t created;   /* Number of NAT entries created */
+  net_stats_t expired;   /* Number of NAT entries expired */
+  net_stats_t inhits;    /* Inbound lookups that found an entry */
+  net_stats_t inmisses;  /* Inbound lookups that found none */
+  net_stats_t outhits;   /* Outbound lookups that found an entry */
+  net_stats_t outmisses; /* Outbound lookups that found none */
+};
+#endif
+
 /* The structure holding the networking statistics that are gathered if
  * CONFIG_NET_STATISTICS is defined.
  */
@@ -117,6 +132,10 @@ struct net_stats_s
 #ifdef CONFIG_NET_UDP
   struct udp_stats_s  udp;      /* UDP statistics */
 #endif
+
+#if defined(CONFIG_NET_NAT) && defined(CONFIG_NET_IPv4)
+  struct nat_stats_s  nat;      /* NAT statistics */
+#endif
 };
 
 /****************************************************************************
@@ -79,11 +79,14 @@
 #define TCP_OPT_WS        3   /* Window size scaling factor */
 #define TCP_OPT_SACK_PERM 4   /* Selective-ACK Permitted option */
 #define TCP_OPT_SACK      5   /* Selective-ACK Block option */
+#define TCP_OPT_TS        8   /* Timestamps option */
 
 #define TCP_OPT_NOOP_LEN       1   /* Length of TCP NOOP option. */
 #define TCP_OPT_MSS_LEN        4   /* Length of TCP MSS option. */
 #define TCP_OPT_WS_LEN         3   /* Length of TCP WS option. */
 #define TCP_OPT_SACK_PERM_LEN  2   /* Length of TCP SACK option. */
+#define TCP_OPT_TS_LEN        10   /* Length of TCP Timestamps option. */
+#define TCP_OPT_TS_ALIGNED_LEN 12  /* Same, preceded by two NOOPs */
 
 /* The TCP states used in the struct tcp_conn_s tcpstateflags field */
 
@@ -203,6 +206,12 @@ struct tcp_stats_s
   net_stats_t syndrop;    /* Number of dropped SYNs due to too few
                            * available connections */
   net_stats_t synrst;     /* Number of SYNs for closed ports triggering a RST */
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  net_stats_t sack;       /* Number of retransmissions guided by SACKs */
+#endif
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+  net_stats_t paws;       /* Number of segments dropped by PAWS */
+#endif
 };
 #endif
 
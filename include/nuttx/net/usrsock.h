@@ -33,6 +33,7 @@
 #include <sys/param.h>
 
 #include <nuttx/net/netconfig.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/compiler.h>
 
 /****************************************************************************
@@ -61,6 +62,30 @@
 #define USRSOCK_MESSAGE_REQ_COMPLETED(flags) \
                           (!USRSOCK_MESSAGE_REQ_IN_PROGRESS(flags))
 
+/* Shared ring transport (CONFIG_NET_USRSOCK_RING) device commands:
+ *
+ * USRSOCKIOC_RINGSIZE
+ *   Description: Return the number of bytes to mmap() at offset 0
+ *   Argument:    A pointer to an uint32_t
+ *
+ * USRSOCKIOC_KICK
+ *   Description: Process the records of the response ring and release the
+ *                space of the consumed requests.  Returns the number of
+ *                responses handled.
+ *   Argument:    None
+ */
+
+#define USRSOCKIOC_RINGSIZE _USRSOCKIOC(0x0001)
+#define USRSOCKIOC_KICK     _USRSOCKIOC(0x0002)
+
+/* A ring record of this length only pads the ring up to its end */
+
+#define USRSOCK_RING_PAD    UINT32_MAX
+
+/* Records start on 4-byte boundaries */
+
+#define USRSOCK_RING_ALIGN(n) (((n) + 3) & ~3)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -266,6 +291,36 @@ begin_packed_struct struct usrsock_message_socket_event_s
   int16_t usockid;
 } end_packed_struct;
 
+/* Shared ring transport.  The area mapped from /dev/usrsock starts with
+ * this header, followed by the request ring at 'reqoff' and the response
+ * ring at 'respoff', each 'size' bytes long.  The head and tail values
+ * are free-running byte counts, taken modulo 'size' to address the ring.
+ *
+ * The kernel appends each request as one record to the request ring and
+ * raises POLLIN; the daemon handles as many records as it finds before
+ * advancing 'reqtail'.  The daemon appends each response or event as one
+ * complete record, header and data together, to the response ring,
+ * advances 'resphead' and calls USRSOCKIOC_KICK once for the whole batch.
+ * A record never wraps: the rest of the ring is skipped when a record of
+ * length USRSOCK_RING_PAD is met.
+ */
+
+struct usrsock_ring_s
+{
+  uint32_t size;     /* Size of each ring, a power of two */
+  uint32_t reqoff;   /* Offset of the request ring in the area */
+  uint32_t respoff;  /* Offset of the response ring in the area */
+  uint32_t reqhead;  /* Request ring: written by the kernel */
+  uint32_t reqtail;  /* Request ring: written by the daemon */
+  uint32_t resphead; /* Response ring: written by the daemon */
+  uint32_t resptail; /* Response ring: written by the kernel */
+};
+
+struct usrsock_ringrec_s
+{
+  uint32_t len;      /* Length of the message following the record */
+};
+
 /****************************************************************************
  * Name: usrsock_iovec_get() - copy from iovec to buffer.
  ****************************************************************************/
@@ -0,0 +1,90 @@
+/****************************************************************************
+ * include/nuttx/note/notectf_driver.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NOTE_NOTECTF_DRIVER_H
+#define __INCLUDE_NUTTX_NOTE_NOTECTF_DRIVER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/streams.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#ifdef CONFIG_DRIVERS_NOTECTF
+
+/****************************************************************************
+ * Name: notectf_initialize
+ *
+ * Description:
+ *   Start streaming sched notes as a Common Trace Format (CTF) data stream
+ *   to 'stream'.  The stream is written from the context that generates
+ *   the note, possibly an interrupt handler, so it must never block.  The
+ *   matching CTF metadata can be read from /dev/note/ctfmeta.
+ *
+ * Input Parameters:
+ *   stream - The transport that receives the CTF packets
+ *
+ * Returned Value:
+ *   Zero on success. A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int notectf_initialize(FAR struct lib_outstream_s *stream);
+
+/****************************************************************************
+ * Name: notectf_register
+ *
+ * Description:
+ *   Register /dev/note/ctfmeta and, if a built-in transport is configured,
+ *   start streaming to it.
+ *
+ * Returned Value:
+ *   Zero on success. A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int notectf_register(void);
+
+/****************************************************************************
+ * Name: notectf_flush
+ *
+ * Description:
+ *   Send the partially filled packet now.
+ *
+ ****************************************************************************/
+
+void notectf_flush(void);
+
+#endif /* CONFIG_DRIVERS_NOTECTF */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_NOTE_NOTECTF_DRIVER_H */
@@ -549,6 +549,47 @@ int nx_block(NXWINDOW hwnd, FAR void *arg);
 
 int nx_synch(NXWINDOW hwnd, FAR void *arg);
 
+/****************************************************************************
+ * Name: nx_batchbegin
+ *
+ * Description:
+ *   Start collecting the drawing commands of the connection.  The fills,
+ *   trapezoids, pixels and moves of its windows are packed in a buffer of
+ *   the connection (CONFIG_NX_BATCH_SIZE bytes) and sent to the server as
+ *   a single message when it is full, before any other command, or by
+ *   nx_batchend().  Nothing of the batch is drawn before it is sent.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+int nx_batchbegin(NXHANDLE handle);
+#endif
+
+/****************************************************************************
+ * Name: nx_batchend
+ *
+ * Description:
+ *   Send the drawing commands collected since nx_batchbegin() to the server
+ *   and wait until it executed them, then send commands one by one again.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+int nx_batchend(NXHANDLE handle);
+#endif
+
 /****************************************************************************
  * Name: nx_requestbkgd
  *
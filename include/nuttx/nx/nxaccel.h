@@ -0,0 +1,156 @@
+/****************************************************************************
+ * include/nuttx/nx/nxaccel.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NX_NXACCEL_H
+#define __INCLUDE_NUTTX_NX_NXACCEL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/video/fb.h>
+#include <nuttx/nx/nxtypes.h>
+
+#ifdef CONFIG_NX_ACCEL
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A 2D accelerator that draws to framebuffer memory.  Each method returns
+ * a negated errno value for what it does not handle (a pixel format, an
+ * unaligned buffer, ...), and the software rasterizers of nxglib draw it
+ * instead.  The methods may be NULL and return once the memory holds the
+ * result.
+ *
+ * The rectangles are in pixels of the plane, both corners included.  For
+ * the copy and the blend, src is the start of the source image, which has
+ * the pixel format of the plane, srcstride is its line length in bytes and
+ * origin is the position of src in the plane.
+ */
+
+struct nxgl_accel_s
+{
+  /* Fill a rectangle with a color */
+
+  CODE int (*fillrectangle)(FAR const struct nxgl_accel_s *accel,
+                            FAR struct fb_planeinfo_s *pinfo,
+                            FAR const struct nxgl_rect_s *rect,
+                            nxgl_mxpixel_t color);
+
+  /* Copy an image to a rectangle */
+
+  CODE int (*copyrectangle)(FAR const struct nxgl_accel_s *accel,
+                            FAR struct fb_planeinfo_s *pinfo,
+                            FAR const struct nxgl_rect_s *dest,
+                            FAR const void *src,
+                            FAR const struct nxgl_point_s *origin,
+                            unsigned int srcstride);
+
+  /* Blend an image over a rectangle, alpha is the opacity of the image
+   * from 0 (transparent) to 255 (opaque).
+   */
+
+  CODE int (*blendrectangle)(FAR const struct nxgl_accel_s *accel,
+                             FAR struct fb_planeinfo_s *pinfo,
+                             FAR const struct nxgl_rect_s *dest,
+                             FAR const void *src,
+                             FAR const struct nxgl_point_s *origin,
+                             unsigned int srcstride, uint8_t alpha);
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: nxgl_accel_register
+ *
+ * Description:
+ *   Use a 2D accelerator for the fills and copies of NX, typically called
+ *   by the driver of the accelerator once it is initialized.  A NULL
+ *   accelerator returns to the software rasterizers.
+ *
+ ****************************************************************************/
+
+void nxgl_accel_register(FAR const struct nxgl_accel_s *accel);
+
+/****************************************************************************
+ * Name: nxgl_accel_fillrectangle, nxgl_accel_copyrectangle
+ *
+ * Description:
+ *   Draw with the accelerator.  Rectangles of less than
+ *   CONFIG_NX_ACCEL_MINPIXELS pixels are left to the software, where they
+ *   cost less than setting up the hardware.
+ *
+ * Returned Value:
+ *   Zero (OK) if the accelerator did the work; a negated errno value if
+ *   the caller has to.
+ *
+ ****************************************************************************/
+
+int nxgl_accel_fillrectangle(FAR struct fb_planeinfo_s *pinfo,
+                             FAR const struct nxgl_rect_s *rect,
+                             nxgl_mxpixel_t color);
+int nxgl_accel_copyrectangle(FAR struct fb_planeinfo_s *pinfo,
+                             FAR const struct nxgl_rect_s *dest,
+                             FAR const void *src,
+                             FAR const struct nxgl_point_s *origin,
+                             unsigned int srcstride);
+
+/****************************************************************************
+ * Name: nxgl_blendrectangle
+ *
+ * Description:
+ *   Blend an image over a rectangle of the plane with the opacity alpha.
+ *   The accelerator does it if it can, else it is done in software for the
+ *   RGB565 and the 32-bit (A)RGB8888 planes.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOSYS if the pixel format cannot be blended.
+ *
+ ****************************************************************************/
+
+int nxgl_blendrectangle(FAR struct fb_planeinfo_s *pinfo,
+                        FAR const struct nxgl_rect_s *dest,
+                        FAR const void *src,
+                        FAR const struct nxgl_point_s *origin,
+                        unsigned int srcstride, uint8_t alpha);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_NX_ACCEL */
+#endif /* __INCLUDE_NUTTX_NX_NXACCEL_H */
@@ -65,6 +65,15 @@
 #define NX_CLIMSG_PRIO 42
 #define NX_SVRMSG_PRIO 42
 
+/* Each command of a batch is a size_t holding the length of the message,
+ * followed by the message.  Both start at a multiple of the pointer size.
+ */
+
+#ifdef CONFIG_NX_BATCH
+#  define NX_BATCH_ALIGN(n) \
+     (((n) + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1))
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -97,6 +106,14 @@ struct nxmu_conn_s
   /* These are only usable on the server side of the connection */
 
   mqd_t swrmq;            /* MQ to write to the client */
+
+#ifdef CONFIG_NX_BATCH
+  /* Drawing commands collected by the client after nx_batchbegin() */
+
+  bool batching;          /* True: collect the drawing commands */
+  size_t nbatch;          /* Number of bytes used in batch[] */
+  uintptr_t batch[CONFIG_NX_BATCH_SIZE / sizeof(uintptr_t)];
+#endif
 };
 
 /* Message IDs **************************************************************/
@@ -142,7 +159,8 @@ enum nxmsg_e
   NX_SVRMSG_SETBGCOLOR,       /* Set the color of the background */
   NX_SVRMSG_MOUSEIN,          /* New mouse report from mouse client */
   NX_SVRMSG_KBDIN,            /* New keyboard report from keyboard client */
-  NX_SVRMSG_REDRAWREQ         /* Request re-drawing of rectangular region */
+  NX_SVRMSG_REDRAWREQ,        /* Request re-drawing of rectangular region */
+  NX_SVRMSG_BATCH             /* Execute a batch of drawing commands */
 };
 
 /* Server-to-Client Message Structures **************************************/
@@ -520,6 +538,18 @@ struct nxsvrmsg_redrawreq_s
   struct nxgl_rect_s rect;         /* Describes the rectangular region to be redrawn */
 };
 
+/* Execute the drawing commands collected after nx_batchbegin() */
+
+#ifdef CONFIG_NX_BATCH
+struct nxsvrmsg_batch_s
+{
+  uint32_t msgid;                  /* NX_SVRMSG_BATCH */
+  FAR uint8_t *cmds;               /* The packed commands */
+  size_t len;                      /* The length of the commands in bytes */
+  sem_t *sem_done;                 /* Posted when the batch is done */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -602,6 +632,47 @@ int nxmu_sendserver(FAR struct nxmu_conn_s *conn,
 int nxmu_sendwindow(FAR struct nxbe_window_s *wnd, FAR const void *msg,
                     size_t msglen);
 
+/****************************************************************************
+ * Name: nxmu_batchadd
+ *
+ * Description:
+ *  Add a message to the batch of the connection if it is a drawing command
+ *  that can be batched, else send it to the server after the batch.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *   msg    - A pointer to the message to send
+ *   msglen - The length of the message in bytes.
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+int nxmu_batchadd(FAR struct nxmu_conn_s *conn, FAR const void *msg,
+                  size_t msglen);
+#endif
+
+/****************************************************************************
+ * Name: nxmu_batchflush
+ *
+ * Description:
+ *  Send the collected drawing commands of the connection to the server and
+ *  wait until it executed them, so that the batch buffer can be reused.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+int nxmu_batchflush(FAR struct nxmu_conn_s *conn);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
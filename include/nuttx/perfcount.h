@@ -0,0 +1,161 @@
+/****************************************************************************
+ * include/nuttx/perfcount.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_PERFCOUNT_H
+#define __INCLUDE_NUTTX_PERFCOUNT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The hardware events counted for every thread */
+
+#define PERFCOUNT_CYCLES        0   /* CPU cycles */
+#define PERFCOUNT_INSTRUCTIONS  1   /* Instructions retired */
+#define PERFCOUNT_CACHE_MISSES  2   /* Level 1 data cache refills */
+#define PERFCOUNT_BRANCH_MISSES 3   /* Mispredicted branches */
+#define PERFCOUNT_NEVENTS       4
+
+/* IOCTL commands of /dev/perf
+ *
+ * PERFIOC_READ
+ *   Description: Read the counters of a thread.
+ *   Argument:    A pointer to struct perfcount_s, with pid filled in.
+ *   Return:      Zero (OK) on success; a negated errno value on failure.
+ *
+ * PERFIOC_RESET
+ *   Description: Clear the counters of a thread.
+ *   Argument:    The pid of the thread, or 0 for the caller.
+ *   Return:      Zero (OK) on success; a negated errno value on failure.
+ */
+
+#define PERFIOC_READ            _PERFIOC(0x0001)
+#define PERFIOC_RESET           _PERFIOC(0x0002)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The counters of one thread, virtualized across context switches */
+
+struct perfcount_s
+{
+  pid_t pid;                        /* The thread, or 0 for the caller */
+  uint32_t valid;                   /* Bit n set if count[n] is counted */
+
+  /* The PERFCOUNT_* events counted while the thread ran */
+
+  uint64_t count[PERFCOUNT_NEVENTS];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_SCHED_PERFCOUNT
+
+/****************************************************************************
+ * Name: perfcount_read
+ *
+ * Description:
+ *   Return the events counted while the thread perf->pid ran.  The count
+ *   of a thread that is running on another CPU does not include its
+ *   current time slice.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ESRCH if there is no such thread.
+ *
+ ****************************************************************************/
+
+int perfcount_read(FAR struct perfcount_s *perf);
+
+/****************************************************************************
+ * Name: perfcount_reset
+ *
+ * Description:
+ *   Clear the counters of the thread 'pid', or of the caller if 'pid' is
+ *   zero.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ESRCH if there is no such thread.
+ *
+ ****************************************************************************/
+
+int perfcount_reset(pid_t pid);
+
+/****************************************************************************
+ * Name: perfcount_sample
+ *
+ * Description:
+ *   Return the events counted on this CPU since the previous call on this
+ *   CPU.  This is meant for a sampling profiler, which calls it from its
+ *   timer interrupt to weight each sample.
+ *
+ * Input Parameters:
+ *   delta - Receives PERFCOUNT_NEVENTS counts; those not counted are zero
+ *
+ * Returned Value:
+ *   The mask of the valid entries of delta, zero if the counters of this
+ *   CPU have not been started yet.
+ *
+ ****************************************************************************/
+
+uint32_t perfcount_sample(FAR uint32_t *delta);
+
+#endif /* CONFIG_SCHED_PERFCOUNT */
+
+/****************************************************************************
+ * Name: devperf_register
+ *
+ * Description:
+ *   Register /dev/perf
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_PERF
+void devperf_register(void);
+#endif
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_PERFCOUNT_H */
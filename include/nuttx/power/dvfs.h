@@ -0,0 +1,168 @@
+/****************************************************************************
+ * include/nuttx/power/dvfs.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_POWER_DVFS_H
+#define __INCLUDE_NUTTX_POWER_DVFS_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef CONFIG_DVFS
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One operating performance point of the CPU clock domain: the frequency
+ * of the CPU clock and the lowest core voltage that sustains it.
+ */
+
+struct dvfs_opp_s
+{
+  uint32_t freq;  /* CPU clock frequency in Hz */
+  int      uv;    /* Core voltage in microvolts */
+};
+
+/* A DVFS governor maps the measured load to the CPU frequency wanted for
+ * the next sampling period.
+ */
+
+struct dvfs_governor_s
+{
+  /**************************************************************************
+   * Name: target
+   *
+   * Description:
+   *   Return the frequency wanted for the next sampling period.  The DVFS
+   *   system selects the lowest operating point that reaches it.
+   *
+   * Input Parameters:
+   *   load    - The busy time of the busiest CPU during the last sampling
+   *             period, in percent.
+   *   curfreq - The frequency the CPUs ran at during that period.
+   *   minfreq - The lowest frequency of the operating points.
+   *   maxfreq - The highest frequency of the operating points.
+   *
+   **************************************************************************/
+
+  CODE uint32_t (*target)(unsigned int load, uint32_t curfreq,
+                          uint32_t minfreq, uint32_t maxfreq);
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: dvfs_initialize
+ *
+ * Description:
+ *   Start scaling the CPU clock domain.  Called by board logic once the
+ *   clock and regulator drivers are registered.  The load is sampled every
+ *   CONFIG_DVFS_SAMPLE_PERIOD milliseconds on the low priority work queue,
+ *   and the configured governor selects the operating point.
+ *
+ * Input Parameters:
+ *   clkname - The name of the CPU clock in the clk framework.
+ *   regname - The name of the core supply regulator, or NULL if the
+ *             voltage is not scaled.
+ *   opps    - The operating points, sorted by increasing frequency.  The
+ *             table must stay valid.
+ *   nopps   - The number of operating points.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dvfs_initialize(FAR const char *clkname, FAR const char *regname,
+                    FAR const struct dvfs_opp_s *opps, size_t nopps);
+
+/****************************************************************************
+ * Name: dvfs_boost
+ *
+ * Description:
+ *   Run at the highest operating point for at least 'msec' milliseconds,
+ *   e.g. when a burst of work is known to come.  The switch happens on the
+ *   low priority work queue, so this may be called from interrupt
+ *   handlers.
+ *
+ * Input Parameters:
+ *   msec - The duration of the boost in milliseconds.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODEV if DVFS is not initialized.
+ *
+ ****************************************************************************/
+
+int dvfs_boost(unsigned int msec);
+
+/****************************************************************************
+ * Name: dvfs_getfreq
+ *
+ * Description:
+ *   Return the frequency of the current operating point in Hz, or zero if
+ *   DVFS is not initialized.
+ *
+ ****************************************************************************/
+
+uint32_t dvfs_getfreq(void);
+
+/****************************************************************************
+ * Name: dvfs_ondemand_governor_initialize
+ *
+ * Description:
+ *   Return the ondemand governor instance.
+ *
+ ****************************************************************************/
+
+FAR const struct dvfs_governor_s *dvfs_ondemand_governor_initialize(void);
+
+/****************************************************************************
+ * Name: dvfs_schedutil_governor_initialize
+ *
+ * Description:
+ *   Return the schedutil governor instance.
+ *
+ ****************************************************************************/
+
+FAR const struct dvfs_governor_s *dvfs_schedutil_governor_initialize(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_DVFS */
+#endif /* __INCLUDE_NUTTX_POWER_DVFS_H */
@@ -59,6 +59,7 @@
 #include <nuttx/wdog.h>
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <time.h>
 
 #ifdef CONFIG_PM
@@ -313,6 +314,19 @@ struct pm_wakelock_s
 #endif
 };
 
+#ifdef CONFIG_PM_QOS
+/* A latency constraint on a PM domain.  While it is registered, the
+ * governor must not select a state whose exit latency exceeds 'latency'.
+ */
+
+struct pm_qos_s
+{
+  struct dq_entry_s node;    /* Link in the constraint list of the domain */
+  int domain;                /* The constrained PM domain */
+  uint32_t latency;          /* Maximum tolerated wakeup latency (usec) */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -377,6 +391,19 @@ FAR const struct pm_governor_s *pm_greedy_governor_initialize(void);
 
 FAR const struct pm_governor_s *pm_activity_governor_initialize(void);
 
+/****************************************************************************
+ * Name: pm_latency_governor_initialize
+ *
+ * Description:
+ *   Return the latency governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct. Otherwise NULL is returned on error.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_latency_governor_initialize(void);
+
 /****************************************************************************
  * Name: pm_set_governor
  *
@@ -785,6 +812,87 @@ enum pm_state_e pm_querystate(int domain);
 
 void pm_auto_updatestate(int domain);
 
+#ifdef CONFIG_PM_QOS
+/****************************************************************************
+ * Name: pm_qos_add
+ *
+ * Description:
+ *   Register a wakeup latency constraint on a PM domain.  Until it is
+ *   removed, no power state whose exit latency exceeds 'latency' will be
+ *   recommended for the domain.
+ *
+ * Input Parameters:
+ *   qos     - The constraint instance, owned by the caller
+ *   domain  - The PM domain to constrain
+ *   latency - The maximum tolerated wakeup latency in microseconds
+ *
+ * Returned Value:
+ *   None.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_add(FAR struct pm_qos_s *qos, int domain, uint32_t latency);
+
+/****************************************************************************
+ * Name: pm_qos_update
+ *
+ * Description:
+ *   Change the latency of a registered constraint.
+ *
+ * Input Parameters:
+ *   qos     - The constraint instance previously passed to pm_qos_add()
+ *   latency - The new maximum tolerated wakeup latency in microseconds
+ *
+ * Returned Value:
+ *   None.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_update(FAR struct pm_qos_s *qos, uint32_t latency);
+
+/****************************************************************************
+ * Name: pm_qos_remove
+ *
+ * Description:
+ *   Remove a constraint previously registered with pm_qos_add().
+ *
+ * Input Parameters:
+ *   qos - The constraint instance to remove
+ *
+ * Returned Value:
+ *   None.
+ *
+ * Assumptions:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void pm_qos_remove(FAR struct pm_qos_s *qos);
+
+/****************************************************************************
+ * Name: pm_qos_latency
+ *
+ * Description:
+ *   Return the tightest latency constraint of a PM domain.
+ *
+ * Input Parameters:
+ *   domain - The PM domain to query
+ *
+ * Returned Value:
+ *   The smallest registered latency in microseconds, or UINT32_MAX if the
+ *   domain is not constrained.
+ *
+ ****************************************************************************/
+
+uint32_t pm_qos_latency(int domain);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -822,6 +930,10 @@ void pm_auto_updatestate(int domain);
 #  define pm_changestate(domain,state)        (0)
 #  define pm_querystate(domain)               (0)
 #  define pm_auto_updatestate(domain)
+#  define pm_qos_add(q,d,l)
+#  define pm_qos_update(q,l)
+#  define pm_qos_remove(q)
+#  define pm_qos_latency(domain)              (UINT32_MAX)
 
 #endif /* CONFIG_PM */
 #endif /* __INCLUDE_NUTTX_POWER_PM_H */
@@ -0,0 +1,161 @@
+/****************************************************************************
+ * include/nuttx/profile.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_PROFILE_H
+#define __INCLUDE_NUTTX_PROFILE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/perfcount.h>
+
+#ifdef CONFIG_SCHED_PROFILE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One sample taken by the profiling timer */
+
+struct profile_sample_s
+{
+  uintptr_t pc;                     /* The interrupted program counter */
+  pid_t pid;                        /* The interrupted thread */
+#ifdef CONFIG_SCHED_PERFCOUNT
+
+  /* The PERFCOUNT_* events of this CPU since its previous sample */
+
+  uint32_t events[PERFCOUNT_NEVENTS];
+#endif
+#if CONFIG_SCHED_PROFILE_BTDEPTH > 0
+  uint8_t depth;                    /* Number of valid entries in bt[] */
+
+  /* The callers of pc, innermost first */
+
+  FAR void *bt[CONFIG_SCHED_PROFILE_BTDEPTH];
+#endif
+};
+
+/* The number of samples that hit one program counter */
+
+struct profile_hot_s
+{
+  uintptr_t pc;                     /* The sampled program counter */
+  uint32_t count;                   /* Number of samples */
+};
+
+typedef CODE void
+(*profile_hot_handler_t)(FAR const struct profile_hot_s *hot,
+                         FAR void *arg);
+typedef CODE void
+(*profile_sample_handler_t)(int cpu, FAR const struct profile_sample_s *s,
+                            FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: profile_start
+ *
+ * Description:
+ *   Start sampling every CONFIG_SCHED_PROFILE_INTERVAL system ticks.  This
+ *   is done at boot; it is only needed after profile_stop().
+ *
+ ****************************************************************************/
+
+void profile_start(void);
+
+/****************************************************************************
+ * Name: profile_stop
+ *
+ * Description:
+ *   Stop sampling.  The samples taken so far are kept.
+ *
+ ****************************************************************************/
+
+void profile_stop(void);
+
+/****************************************************************************
+ * Name: profile_reset
+ *
+ * Description:
+ *   Discard all samples taken so far.
+ *
+ ****************************************************************************/
+
+void profile_reset(void);
+
+/****************************************************************************
+ * Name: profile_foreach_hot
+ *
+ * Description:
+ *   Call 'handler' with a snapshot of the sample count of every program
+ *   counter hit so far.  The handler is called without any lock held.
+ *
+ * Input Parameters:
+ *   handler - The function to call for each entry
+ *   arg     - An opaque argument passed to the handler
+ *
+ * Returned Value:
+ *   The total number of samples.  Samples whose program counter did not
+ *   fit into the table are counted here but not reported.
+ *
+ ****************************************************************************/
+
+uint32_t profile_foreach_hot(profile_hot_handler_t handler, FAR void *arg);
+
+/****************************************************************************
+ * Name: profile_foreach_sample
+ *
+ * Description:
+ *   Call 'handler' with a snapshot of the most recent samples of each CPU,
+ *   oldest first.  The handler is called without any lock held.
+ *
+ * Input Parameters:
+ *   handler - The function to call for each sample
+ *   arg     - An opaque argument passed to the handler
+ *
+ ****************************************************************************/
+
+void profile_foreach_sample(profile_sample_handler_t handler, FAR void *arg);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_SCHED_PROFILE */
+#endif /* __INCLUDE_NUTTX_PROFILE_H */
@@ -30,6 +30,8 @@
 #include <nuttx/semaphore.h>
 #include <nuttx/lirc.h>
 
+#include <stddef.h>
+#include <stdint.h>
 #include <time.h>
 
 /****************************************************************************
@@ -259,6 +261,46 @@ void lirc_raw_event(FAR struct lirc_lowerhalf_s *lower,
 void lirc_scancode_event(FAR struct lirc_lowerhalf_s *lower,
                          FAR struct lirc_scancode *lsc);
 
+/****************************************************************************
+ * Name: lirc_sample_events
+ *
+ * Description:
+ *   Like lirc_sample_event(), but sends 'n' samples at once and wakes up
+ *   the readers once.  Timeout samples only reach the readers that asked
+ *   for timeout reports.
+ *
+ * Input Parameters:
+ *   lower   - A pointer to an instance of lower half lirc driver.
+ *   samples - The pulse, space and timeout codes
+ *   n       - The number of samples
+ ****************************************************************************/
+
+void lirc_sample_events(FAR struct lirc_lowerhalf_s *lower,
+                        FAR const unsigned int *samples, size_t n);
+
+/****************************************************************************
+ * Name: lirc_edge_events
+ *
+ * Description:
+ *   Lirc lowerhalf driver sends the timestamps of the edges of the
+ *   demodulated IR signal, e.g. a half of a timer capture DMA ring.  They
+ *   are turned into pulse and space samples and sent in batches.
+ *
+ *   The first edge after registration, a reset or a timeout reported with
+ *   lirc_raw_event() starts a pulse; the edges then alternate.
+ *
+ * Input Parameters:
+ *   lower - A pointer to an instance of lower half lirc driver.
+ *   edges - The timestamps of consecutive edges
+ *   n     - The number of timestamps
+ *   freq  - Timestamp ticks per second
+ *   mask  - The timestamps count modulo (mask + 1)
+ ****************************************************************************/
+
+void lirc_edge_events(FAR struct lirc_lowerhalf_s *lower,
+                      FAR const uint32_t *edges, size_t n,
+                      uint32_t freq, uint32_t mask);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
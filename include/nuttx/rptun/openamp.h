@@ -29,6 +29,7 @@
 
 #ifdef CONFIG_RPTUN
 
+#include <nuttx/compiler.h>
 #include <openamp/open_amp.h>
 #include <openamp/remoteproc_loader.h>
 
@@ -45,6 +46,17 @@ typedef void (*rpmsg_bind_cb_t)(FAR struct rpmsg_device *rdev,
                                 FAR void *priv, FAR const char *name,
                                 uint32_t dest);
 
+/* A reference to a buffer of the bulk buffer pool, sent in a message in
+ * place of the data.  The offset is relative to the part of the pool that
+ * belongs to the sender.
+ */
+
+begin_packed_struct struct rpmsg_bulk_s
+{
+  uint32_t offset;
+  uint32_t len;
+} end_packed_struct;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -73,6 +85,18 @@ void rpmsg_unregister_callback(FAR void *priv,
                                rpmsg_match_cb_t ns_match,
                                rpmsg_bind_cb_t ns_bind);
 
+#ifdef CONFIG_RPTUN_BULK
+FAR void *rpmsg_bulk_alloc(FAR struct rpmsg_endpoint *ept, size_t len);
+void rpmsg_bulk_free(FAR struct rpmsg_endpoint *ept, FAR void *buf,
+                     size_t len);
+int rpmsg_bulk_ref(FAR struct rpmsg_endpoint *ept, FAR void *buf,
+                   size_t len, FAR struct rpmsg_bulk_s *ref);
+FAR void *rpmsg_bulk_get(FAR struct rpmsg_endpoint *ept,
+                         FAR const struct rpmsg_bulk_s *ref);
+void rpmsg_bulk_release(FAR struct rpmsg_endpoint *ept,
+                        FAR const struct rpmsg_bulk_s *ref);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
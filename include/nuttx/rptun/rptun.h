@@ -42,6 +42,7 @@
 #define RPTUNIOC_PANIC              _RPTUNIOC(4)
 #define RPTUNIOC_DUMP               _RPTUNIOC(5)
 #define RPTUNIOC_PING               _RPTUNIOC(6)
+#define RPTUNIOC_POLL               _RPTUNIOC(7)
 
 #define RPTUN_NOTIFY_ALL            (UINT32_MAX - 0)
 
@@ -289,6 +290,25 @@
 #define RPTUN_PANIC(d) ((d)->ops->panic ? \
                         (d)->ops->panic(d) : -ENOSYS)
 
+/****************************************************************************
+ * Name: RPTUN_GET_BULKBUF
+ *
+ * Description:
+ *   Get the shared memory of the bulk buffer pool, the same memory on both
+ *   CPUs.  It is laid out by the master at start.
+ *
+ * Input Parameters:
+ *   dev  - Device-specific state data
+ *   size - The location to return the size of the memory
+ *
+ * Returned Value:
+ *   The memory on success, NULL if there is no bulk buffer pool.
+ *
+ ****************************************************************************/
+
+#define RPTUN_GET_BULKBUF(d, s) ((d)->ops->get_bulkbuf ? \
+                                 (d)->ops->get_bulkbuf(d, s) : NULL)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -335,6 +355,9 @@ struct rptun_ops_s
 
   CODE void (*reset)(FAR struct rptun_dev_s *dev, int value);
   CODE void (*panic)(FAR struct rptun_dev_s *dev);
+
+  CODE FAR void *(*get_bulkbuf)(FAR struct rptun_dev_s *dev,
+                                FAR size_t *size);
 };
 
 struct rptun_dev_s
@@ -350,6 +373,7 @@ struct rptun_ping_s
   int  len;
   bool ack;
   int  sleep; /* unit: ms */
+  bool bulk;  /* send 'len' bytes in a bulk buffer, always acked */
 };
 
 /****************************************************************************
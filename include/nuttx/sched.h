@@ -38,6 +38,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/irq.h>
 #include <nuttx/mutex.h>
+#include <nuttx/perfcount.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/queue.h>
 #include <nuttx/wdog.h>
@@ -96,6 +97,7 @@
 #  define TCB_FLAG_SCHED_FIFO      (0 << TCB_FLAG_POLICY_SHIFT)  /* FIFO scheding policy */
 #  define TCB_FLAG_SCHED_RR        (1 << TCB_FLAG_POLICY_SHIFT)  /* Round robin scheding policy */
 #  define TCB_FLAG_SCHED_SPORADIC  (2 << TCB_FLAG_POLICY_SHIFT)  /* Sporadic scheding policy */
+#  define TCB_FLAG_SCHED_DEADLINE  (3 << TCB_FLAG_POLICY_SHIFT)  /* Deadline scheding policy */
 #define TCB_FLAG_CPU_LOCKED        (1 << 8)                      /* Bit 7: Locked to this CPU */
 #define TCB_FLAG_SIGNAL_ACTION     (1 << 9)                      /* Bit 8: In a signal handler */
 #define TCB_FLAG_SYSCALL           (1 << 10)                     /* Bit 9: In a system call */
@@ -316,6 +318,23 @@ struct sporadic_s
 
 #endif /* CONFIG_SCHED_SPORADIC */
 
+#ifdef CONFIG_SCHED_DEADLINE
+/* struct deadline_s ********************************************************/
+
+/* This structure holds the constant bandwidth server state of a thread
+ * with the SCHED_DEADLINE policy.  The remaining budget of the current
+ * server period is kept in the timeslice field of the TCB.
+ */
+
+struct deadline_s
+{
+  uint32_t  runtime;                /* Execution budget per period (ticks)   */
+  uint32_t  deadline;               /* Relative deadline (ticks)             */
+  uint32_t  period;                 /* Server period (ticks)                 */
+  clock_t   abs_deadline;           /* Absolute deadline of current period   */
+};
+#endif /* CONFIG_SCHED_DEADLINE */
+
 /* struct child_status_s ****************************************************/
 
 /* This structure is used to maintain information about child tasks.
@@ -520,6 +539,41 @@ struct task_group_s
   struct mm_map_s tg_mm_map;    /* Task mmappings */
 };
 
+#ifdef CONFIG_SMP_CALL
+/* struct smp_call_data_s ***************************************************/
+
+/* This is the function type of a cross-CPU call made with
+ * nxsched_smp_call() or nxsched_smp_call_async().  It runs in the
+ * inter-processor interrupt handler of the target CPU.
+ */
+
+typedef CODE int (*nxsched_smp_call_t)(FAR void *arg);
+
+/* One queue node for each target CPU.  A request is linked into the
+ * lock-free queue of each target CPU through the node of that CPU.
+ */
+
+struct smp_call_data_s;
+struct smp_call_node_s
+{
+  FAR struct smp_call_node_s *flink;     /* Next request for the CPU        */
+  FAR struct smp_call_data_s *data;      /* The request containing the node */
+};
+
+/* This describes one cross-CPU call request.  An asynchronous request is
+ * owned by the caller and may be queued again once 'remaining' has dropped
+ * to zero.
+ */
+
+struct smp_call_data_s
+{
+  nxsched_smp_call_t func;               /* Function to run on each target  */
+  FAR void *arg;                         /* Argument passed to func         */
+  int remaining;                         /* Targets not yet dequeued        */
+  struct smp_call_node_s node[CONFIG_SMP_NCPUS];
+};
+#endif
+
 /* struct tcb_s *************************************************************/
 
 /* This is the common part of the task control block (TCB).
@@ -577,15 +631,22 @@ struct tcb_s
 #endif
   int16_t  errcode;                      /* Used to pass error information  */
 
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
-  int32_t  timeslice;                    /* RR timeslice OR Sporadic budget */
-                                         /* interval remaining              */
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
+  int32_t  timeslice;                    /* RR timeslice OR Sporadic or     */
+                                         /* Deadline budget remaining       */
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
   FAR struct sporadic_s *sporadic;       /* Sporadic scheduling parameters  */
 #endif
+#ifdef CONFIG_SCHED_DEADLINE
+  struct deadline_s deadline;            /* Deadline scheduling parameters  */
+#endif
 
   struct wdog_s waitdog;                 /* All timed waits use this timer  */
+#ifdef CONFIG_SCHED_TIMER_SLACK
+  unsigned long timerslack;              /* Timed wait slack (nanoseconds)  */
+#endif
 
   /* Stack-Related Fields ***************************************************/
 
@@ -640,6 +701,35 @@ struct tcb_s
   unsigned long run_time;                /* Total time thread run           */
 #endif
 
+  /* Lazy FPU context switch statistics *************************************/
+
+#ifdef CONFIG_ARCH_LAZYFPU
+  uint32_t fpu_saves;                    /* Times FPU state saved on switch */
+#endif
+
+  /* High-resolution thread statistics **************************************/
+
+#ifdef CONFIG_SCHED_STATS
+  unsigned long stat_wakeup;             /* Time when made ready after wait */
+  unsigned long stat_start;              /* Time when thread began running  */
+  uint64_t stat_runtime;                 /* Total time thread ran           */
+  uint32_t stat_latmax;                  /* Max wakeup latency (usec)       */
+  uint32_t stat_wakeups;                 /* Number of wakeups after a wait  */
+  uint32_t stat_voluntary;               /* Switches out due to blocking    */
+  uint32_t stat_involuntary;             /* Switches out while still ready  */
+  bool     stat_waking;                  /* stat_wakeup is valid            */
+
+  /* Wakeup latency histogram */
+
+  uint32_t stat_lathist[CONFIG_SCHED_STATS_NHIST];
+#endif
+
+  /* Hardware performance counters ******************************************/
+
+#ifdef CONFIG_SCHED_PERFCOUNT
+  uint64_t perf_count[PERFCOUNT_NEVENTS]; /* Events while running           */
+#endif
+
   /* State save areas *******************************************************/
 
   /* The form and content of these fields are platform-specific.            */
@@ -766,6 +856,13 @@ EXTERN unsigned long g_premp_max[CONFIG_SMP_NCPUS];
 EXTERN unsigned long g_crit_max[CONFIG_SMP_NCPUS];
 #endif /* CONFIG_SCHED_CRITMONITOR */
 
+#ifdef CONFIG_SCHED_STATS
+/* System-wide wakeup latency histogram and maximum (usec) */
+
+EXTERN uint32_t g_schedlat_hist[CONFIG_SCHED_STATS_NHIST];
+EXTERN uint32_t g_schedlat_max;
+#endif /* CONFIG_SCHED_STATS */
+
 EXTERN const struct tcbinfo_s g_tcbinfo;
 
 /****************************************************************************
@@ -838,6 +935,48 @@ FAR struct tcb_s *nxsched_get_tcb(pid_t pid);
 
 int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype);
 
+/****************************************************************************
+ * Name: nxsched_alloc_tcb
+ *
+ * Description:
+ *   Allocate a zeroed TCB for a new thread: a struct pthread_tcb_s for
+ *   TCB_FLAG_TTYPE_PTHREAD, a struct task_tcb_s otherwise.  The TCB of an
+ *   exited thread of the same type may be reused (see
+ *   CONFIG_TASK_TCB_POOLSIZE and CONFIG_PTHREAD_TCB_POOLSIZE).  Such a
+ *   TCB may still hold its previous stack, preferably one of
+ *   'stack_size' bytes, which up_create_stack() keeps if the size
+ *   matches.
+ *
+ * Input Parameters:
+ *   ttype      - The type of the new thread.  It is set in the TCB flags.
+ *   stack_size - The stack size that the new thread will request
+ *
+ * Returned Value:
+ *   The new TCB on success; NULL if there is not enough memory.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_alloc_tcb(uint8_t ttype, size_t stack_size);
+
+/****************************************************************************
+ * Name: nxsched_free_tcb
+ *
+ * Description:
+ *   Release a TCB allocated by nxsched_alloc_tcb(), or a TCB whose
+ *   resources have been released by nxsched_release_tcb(), together with
+ *   any stack it still holds.  The TCB may be kept for reuse.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB to release
+ *   ttype - The type of the TCB
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_free_tcb(FAR struct tcb_s *tcb, uint8_t ttype);
+
 /* File system helpers ******************************************************/
 
 /* These functions all extract lists from the group structure associated with
@@ -1400,6 +1539,109 @@ int nxsched_set_affinity(pid_t pid, size_t cpusetsize,
                          FAR const cpu_set_t *mask);
 #endif
 
+/****************************************************************************
+ * Name: nxsched_smp_call
+ *
+ * Description:
+ *   Run 'func' on each CPU in 'cpuset' and wait until it has completed on
+ *   all of them.  The function runs directly on the calling CPU if that
+ *   CPU is in 'cpuset' and in the inter-processor interrupt handler on
+ *   each of the other CPUs.  Requests to the same CPU are queued without
+ *   locking and only one interrupt is raised for each batch of requests.
+ *
+ *   Unlike up_cpu_pause(), the target CPUs are not halted:  They run the
+ *   function when they next take their interrupt and then continue.
+ *
+ * Input Parameters:
+ *   cpuset - The set of CPUs to run the function on
+ *   func   - The function to run
+ *   arg    - The argument passed to 'func'
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ * Assumptions:
+ *   The caller must not be within a critical section or have interrupts
+ *   disabled:  A target CPU may be waiting for the critical section with
+ *   its interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+int nxsched_smp_call(cpu_set_t cpuset, nxsched_smp_call_t func,
+                     FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Name: nxsched_smp_call_init
+ *
+ * Description:
+ *   Initialize a request for nxsched_smp_call_async().
+ *
+ * Input Parameters:
+ *   data - The request to initialize
+ *   func - The function to run on each target CPU
+ *   arg  - The argument passed to 'func'
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+void nxsched_smp_call_init(FAR struct smp_call_data_s *data,
+                           nxsched_smp_call_t func, FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Name: nxsched_smp_call_async
+ *
+ * Description:
+ *   Queue a request to run a function on each CPU in 'cpuset' and return
+ *   without waiting.  Unlike nxsched_smp_call(), the function does not run
+ *   on the calling CPU; the calling CPU, if present, is removed from
+ *   'cpuset'.
+ *
+ * Input Parameters:
+ *   cpuset - The set of CPUs to run the function on
+ *   data   - The request initialized by nxsched_smp_call_init().  It must
+ *            stay valid until the function has been started on all CPUs.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  -EBUSY is returned if 'data' is
+ *   still queued from a previous call.
+ *
+ * Assumptions:
+ *   May be called from within a critical section or an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+int nxsched_smp_call_async(cpu_set_t cpuset,
+                           FAR struct smp_call_data_s *data);
+#endif
+
+/****************************************************************************
+ * Name: nxsched_smp_call_handler
+ *
+ * Description:
+ *   This is the handler of the inter-processor interrupt raised by
+ *   up_send_smp_call().  It runs every request queued for this CPU in the
+ *   order in which they were queued.
+ *
+ * Input Parameters:
+ *   Standard interrupt handling
+ *
+ * Returned Value:
+ *   Zero (OK) is always returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_CALL
+int nxsched_smp_call_handler(int irq, FAR void *context, FAR void *arg);
+#endif
+
 /****************************************************************************
  * Name: nxsched_get_stackinfo
  *
@@ -1566,6 +1808,23 @@ pid_t nxsched_getppid(void);
 
 size_t nxsched_collect_deadlock(FAR pid_t *pid, size_t count);
 
+/****************************************************************************
+ * Name: nxsched_deadline_utilization
+ *
+ * Description:
+ *   Return the CPU bandwidth reserved by all SCHED_DEADLINE threads, i.e.
+ *   the sum of runtime / period, in percent of one CPU rounded up.  This
+ *   is the demand that must be met whatever the current load is.
+ *
+ * Returned Value:
+ *   The reserved bandwidth in percent.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+unsigned int nxsched_deadline_utilization(void);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -31,6 +31,7 @@
 #include <semaphore.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/compiler.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -57,6 +58,17 @@
      {(c), (f), SEM_WAITLIST_INITIALIZER}
 #endif /* CONFIG_PRIORITY_INHERITANCE */
 
+/* With CONFIG_SEM_FASTPATH, uncontended nxsem_wait(), nxsem_trywait() and
+ * nxsem_post() update semcount with an atomic compare-and-swap instead of
+ * entering the critical section.  Any other logic that modifies semcount
+ * directly must then use nxsem_count_add() so that its update cannot be
+ * lost, even if it already holds the critical section.
+ */
+
+#if defined(CONFIG_SEM_FASTPATH) && defined(CONFIG_HAVE_ATOMICS)
+#  define NXSEM_FASTPATH 1
+#endif
+
 /* Most internal nxsem_* interfaces are not available in the user space in
  * PROTECTED and KERNEL builds.  In that context, the application semaphore
  * interfaces must be used.  The differences between the two sets of
@@ -632,6 +644,34 @@ int nxsem_clockwait_uninterruptible(FAR sem_t *sem, clockid_t clockid,
 
 int nxsem_tickwait_uninterruptible(FAR sem_t *sem, uint32_t delay);
 
+/****************************************************************************
+ * Name: nxsem_count_add
+ *
+ * Description:
+ *   Add 'value' to the semaphore count without any further semaphore
+ *   processing (no waiters are woken).  This is for the few places that
+ *   manage the count of a semaphore by hand.  The update is atomic with
+ *   regard to the nxsem_wait()/nxsem_post() fast path.
+ *
+ * Input Parameters:
+ *   sem   - Semaphore object
+ *   value - The (possibly negative) amount to add to the count
+ *
+ * Returned Value:
+ *   The new semaphore count.
+ *
+ ****************************************************************************/
+
+static inline int16_t nxsem_count_add(FAR sem_t *sem, int16_t value)
+{
+#ifdef NXSEM_FASTPATH
+  return __atomic_add_fetch(&sem->semcount, value, __ATOMIC_ACQ_REL);
+#else
+  sem->semcount += value;
+  return sem->semcount;
+#endif
+}
+
 #undef EXTERN
 #ifdef __cplusplus
 }
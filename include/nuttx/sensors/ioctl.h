@@ -406,4 +406,13 @@
 
 #define SNIOC_ENABLE_FIFO             _SNIOC(0x009A)
 
+/* Command:      SNIOC_RING_CONSUME
+ * Description:  Report how far a subscriber that maps the topic has read
+ *               the shared ring, as a read() of these samples would.
+ * Argument:     The number of samples published before the next one to
+ *               read, see struct sensor_ring_s.
+ */
+
+#define SNIOC_RING_CONSUME            _SNIOC(0x009B)
+
 #endif /* __INCLUDE_NUTTX_SENSORS_IOCTL_H */
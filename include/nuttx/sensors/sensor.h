@@ -928,6 +928,16 @@ struct sensor_lowerhalf_s
 
   unsigned long nbuffer;
 
+  /* The FIFO watermark, in samples, that goes with the latency passed to
+   * batch().  The upper half sets it to the number of samples the latency
+   * spans, capped to nbuffer, just before it calls batch(), and to zero
+   * when batching stops.  A driver with a hardware FIFO should raise its
+   * interrupt at this level and push the whole FIFO with one push_event()
+   * call, so that subscribers are woken up once per batch.
+   */
+
+  unsigned long watermark;
+
   /* The uncalibrated use to describe whether the sensor event is
    * uncalibrated. True is uncalibrated data, false is calibrated data,
    * default false.
@@ -1025,6 +1035,31 @@ struct sensor_ustate_s
   unsigned long generation;    /* The recent generation of circular buffer */
 };
 
+#ifdef CONFIG_SENSORS_MMAP
+/* The area mapped from a topic starts with this header, followed by the
+ * generation of each sample at 'timeoff' and the samples at 'dataoff',
+ * both rings of 'nbuffer' entries.  Sample n, counted from the first one
+ * published, is at index n % nbuffer of both rings.
+ *
+ * The samples before 'end' are published, the ones before 'begin' may be
+ * in the rings or being overwritten.  A subscriber reads samples in place
+ * from max(pos, end - nbuffer) up to 'end' and keeps one only if 'begin',
+ * read again once done with it, is still within 'nbuffer' of it.  Reads
+ * of the header and of a sample must be ordered by memory barriers on
+ * SMP.  SNIOC_RING_CONSUME reports the position for poll() and intervals.
+ */
+
+struct sensor_ring_s
+{
+  unsigned long esize;          /* The size of a sample */
+  unsigned long nbuffer;        /* The number of samples the rings hold */
+  unsigned long timeoff;        /* Offset of the generation ring */
+  unsigned long dataoff;        /* Offset of the sample ring */
+  volatile unsigned long begin; /* Samples being or already written */
+  volatile unsigned long end;   /* Samples completely written */
+};
+#endif
+
 /* This structure describes the register info for the user sensor */
 
 #ifdef CONFIG_USENSOR
@@ -34,6 +34,7 @@
 #include <termios.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/semaphore.h>
 
 /****************************************************************************
@@ -307,6 +308,11 @@ struct uart_dev_s
 #endif
 #ifdef CONFIG_SERIAL_RXDMA
   struct uart_dmaxfer_s dmarx;       /* Describes receive DMA transfer */
+  bool                 lowlatency;   /* true: Wake readers on each update */
+#endif
+
+#ifdef CONFIG_SERIAL_ICOUNT
+  struct serial_icounter_struct icount; /* Counters for TIOCGICOUNT */
 #endif
 
   /* Driver interface */
@@ -461,6 +467,21 @@ void uart_xmitchars_dma(FAR uart_dev_t *dev);
 void uart_xmitchars_done(FAR uart_dev_t *dev);
 #endif
 
+/****************************************************************************
+ * Name: uart_xmitchars_next
+ *
+ * Description:
+ *  Complete the TX DMA transfer like uart_xmitchars_done() and, if more
+ *  data was written to the TX circular buffer meanwhile, start the next
+ *  transfer at once from the DMA completion interrupt.  The lower half
+ *  must then ignore dmatxavail() calls while its DMA is busy.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_TXDMA
+void uart_xmitchars_next(FAR uart_dev_t *dev);
+#endif
+
 /****************************************************************************
  * Name: uart_recvchars_dma
  *
@@ -487,6 +508,26 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_cyclic
+ *
+ * Description:
+ *  For lower halves that run the RX DMA without stopping, in circular mode
+ *  over the whole RX circular buffer.  It is called from the half transfer
+ *  and transfer complete interrupts with idle false, and from the idle line
+ *  interrupt (or an RX timeout) with idle true, giving the index in the RX
+ *  buffer that the DMA will write next.
+ *
+ *  Readers are woken up on an idle line, when half of the buffer is full
+ *  or, in low-latency mode, on every call.  If the DMA overtook the reader
+ *  the oldest data is dropped and counted as a buffer overrun.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_cyclic(FAR uart_dev_t *dev, size_t pos, bool idle);
+#endif
+
 /****************************************************************************
  * Name: uart_reset_sem
  *
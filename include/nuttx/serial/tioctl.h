@@ -202,6 +202,11 @@
 
 #define TIOCSLINID      _TIOC(0x0037) /* Master send one LIN header with specified LIN identifier: uint8_t */
 
+/* RX DMA notification mode */
+
+#define TIOCSLOWLAT     _TIOC(0x0038)  /* Set low-latency mode: int */
+#define TIOCGLOWLAT     _TIOC(0x0039)  /* Get low-latency mode: FAR int */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -226,6 +231,23 @@ struct serial_rs485
   uint32_t delay_rts_after_send;   /* Delay after send (milliseconds) */
 };
 
+/* Structure used with TIOCGICOUNT (Linux compatible) */
+
+struct serial_icounter_struct
+{
+  int cts;                         /* Changes of the modem lines */
+  int dsr;
+  int rng;
+  int dcd;
+  int rx;                          /* Bytes received */
+  int tx;                          /* Bytes sent */
+  int frame;                       /* Framing errors */
+  int overrun;                     /* Hardware FIFO overruns */
+  int parity;                      /* Parity errors */
+  int brk;                         /* Breaks received */
+  int buf_overrun;                 /* Bytes lost when the RX buffer overran */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
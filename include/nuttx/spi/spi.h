@@ -541,6 +541,7 @@ typedef uint8_t spi_hwfeatures_t;
 /* The SPI vtable */
 
 struct spi_dev_s;
+struct spi_async_s;
 struct spi_ops_s
 {
   CODE int      (*lock)(FAR struct spi_dev_s *dev, bool lock);
@@ -579,6 +580,10 @@ struct spi_ops_s
 #endif
   CODE int      (*registercallback)(FAR struct spi_dev_s *dev,
                   spi_mediachange_t callback, void *arg);
+#ifdef CONFIG_SPI_ASYNC
+  CODE int      (*submit)(FAR struct spi_dev_s *dev,
+                  FAR struct spi_async_s *req);
+#endif
 };
 
 /* SPI private data.  This structure only defines the initial fields of the
@@ -112,6 +112,25 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_ASYNC
+/* This describes a sequence of SPI transactions queued by
+ * spi_async_submit().  The structure belongs to the SPI bus from the
+ * submission until its callback is called.
+ */
+
+struct spi_async_s;
+typedef CODE void (*spi_async_callback_t)(FAR struct spi_async_s *req);
+
+struct spi_async_s
+{
+  FAR struct spi_async_s *flink;  /* Used by the SPI bus while queued */
+  FAR struct spi_sequence_s *seq; /* The transactions to perform */
+  spi_async_callback_t callback;  /* Called once the sequence is done */
+  FAR void *arg;                  /* Opaque data for the callback */
+  int result;                     /* Zero (OK) or a negated errno value */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -135,6 +154,29 @@ struct spi_sequence_s
 
 int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 
+/****************************************************************************
+ * Name: spi_async_submit
+ *
+ * Description:
+ *   Queue a sequence of SPI transfers and return without waiting for them.
+ *   The queued sequences of a bus are performed back-to-back, in order,
+ *   and req->callback() is called with req->result set once a sequence is
+ *   done: from the work queue, or from the interrupt handler of a lower
+ *   half that provides the submit() method to chain their DMA.
+ *
+ * Input Parameters:
+ *   spi - An instance of the SPI device to use for the transfer
+ *   req - Describes the sequence of transfers and its callback.
+ *
+ * Returned Value:
+ *   Zero (OK) if the request was queued; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPI_ASYNC
+int spi_async_submit(FAR struct spi_dev_s *spi, FAR struct spi_async_s *req);
+#endif
+
 /****************************************************************************
  * Name: spi_register
  *
@@ -28,6 +28,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <nuttx/irq.h>
@@ -80,10 +81,31 @@ typedef uint8_t spinlock_t;
 #  define SP_SEV()
 #endif
 
-#if defined(CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS) && !defined(__SP_UNLOCK_FUNCTION)
+#if (defined(CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS) || \
+     defined(CONFIG_SCHED_LOCKSTAT)) && !defined(__SP_UNLOCK_FUNCTION)
 #  define __SP_UNLOCK_FUNCTION 1
 #endif
 
+/* Ticket spinlocks split the spinlock_t word into two halves:  The lower
+ * half holds the next ticket to be handed out and the upper half holds the
+ * ticket currently being served.  The lock is free when both halves are
+ * equal.  This encoding keeps SP_UNLOCKED (0) meaning "free" and SP_LOCKED
+ * (1) meaning "held with no waiters", so statically initialized locks and
+ * the orlock handling of spin_setbit()/spin_clrbit() keep working.
+ */
+
+#ifdef CONFIG_TICKET_SPINLOCK
+#  define SP_TICKET_SHIFT      (sizeof(spinlock_t) * 4)
+#  define SP_TICKET_MASK       (((spinlock_t)1 << SP_TICKET_SHIFT) - 1)
+#  define SP_TICKET_NEXT(v)    ((spinlock_t)(v) & SP_TICKET_MASK)
+#  define SP_TICKET_OWNER(v)   (((spinlock_t)(v) >> SP_TICKET_SHIFT) & \
+                                SP_TICKET_MASK)
+
+#  ifndef __SP_UNLOCK_FUNCTION
+#    define __SP_UNLOCK_FUNCTION 1
+#  endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -285,7 +307,16 @@ void spin_unlock_wo_note(FAR volatile spinlock_t *lock);
  ****************************************************************************/
 
 /* bool spin_islocked(FAR spinlock_t lock); */
-#define spin_islocked(l) (*(l) == SP_LOCKED)
+#ifdef CONFIG_TICKET_SPINLOCK
+static inline bool spin_islocked(FAR volatile spinlock_t *lock)
+{
+  spinlock_t value = *lock;
+
+  return SP_TICKET_NEXT(value) != SP_TICKET_OWNER(value);
+}
+#else
+#  define spin_islocked(l) (*(l) == SP_LOCKED)
+#endif
 
 /****************************************************************************
  * Name: spin_setbit
@@ -449,4 +480,277 @@ void spin_unlock_irqrestore_wo_note(FAR spinlock_t *lock, irqstate_t flags);
 #  define spin_unlock_irqrestore_wo_note(l, f) up_irq_restore(f)
 #endif
 
+/****************************************************************************
+ * Name: spin_lock_irqsave_subsys / spin_unlock_irqrestore_subsys
+ *
+ * Description:
+ *   Protect a short section of kernel code that only manipulates data
+ *   private to one subsystem (such as a free list) and that never calls
+ *   back into the scheduler.  Normally, the subsystem-scoped spinlock is
+ *   used so that unrelated subsystems on different CPUs do not contend
+ *   for the global critical section.  If CONFIG_SCHED_CSECTION_LEGACY is
+ *   selected, the lock is ignored and the global critical section is used
+ *   instead.
+ *
+ *   A subsystem-scoped lock must never be held while calling
+ *   enter_critical_section().
+ *
+ * Input Parameters:
+ *   lock  - The subsystem-scoped spinlock
+ *   flags - The value returned by spin_lock_irqsave_subsys()
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CSECTION_LEGACY
+#  define spin_lock_irqsave_subsys(l) \
+     ((void)(l), enter_critical_section())
+#  define spin_unlock_irqrestore_subsys(l, f) \
+     do { (void)(l); leave_critical_section(f); } while (0)
+#else
+#  define spin_lock_irqsave_subsys(l)         spin_lock_irqsave(l)
+#  define spin_unlock_irqrestore_subsys(l, f) spin_unlock_irqrestore(l, f)
+#endif
+
+/****************************************************************************
+ * Reader-writer spinlocks
+ *
+ *   A rwlock_t allows any number of concurrent readers or a single writer.
+ *   RW_SP_UNLOCKED is the free state; a positive value is the number of
+ *   readers holding the lock and RW_SP_WRITE_LOCKED marks a writer.
+ *   Readers on different CPUs only update the reader count and never wait
+ *   for each other.  Writers are not given priority over readers, so these
+ *   locks are intended for data that is updated rarely.
+ *
+ *   Like spin_lock(), read_lock()/write_lock() are only provided when
+ *   CONFIG_SPINLOCK is enabled.  The irqsave variants are always available
+ *   and reduce to up_irq_save()/up_irq_restore() in non-SMP builds.
+ *
+ ****************************************************************************/
+
+#define RW_SP_UNLOCKED      0
+#define RW_SP_WRITE_LOCKED  -1
+
+typedef int32_t rwlock_t;
+
+/* void rwlock_init(FAR rwlock_t *lock); */
+
+#define rwlock_init(l) do { *(l) = RW_SP_UNLOCKED; } while (0)
+
+#ifdef CONFIG_SPINLOCK
+
+/****************************************************************************
+ * Name: read_lock
+ *
+ * Description:
+ *   Spin until no writer holds the lock, then take a reader reference.
+ *
+ * Input Parameters:
+ *   lock - A reference to the rwlock object to lock.
+ *
+ * Returned Value:
+ *   None.  The caller holds a reader reference upon return.
+ *
+ ****************************************************************************/
+
+void read_lock(FAR volatile rwlock_t *lock);
+
+/****************************************************************************
+ * Name: read_trylock
+ *
+ * Description:
+ *   Take a reader reference only if no writer holds the lock.
+ *
+ * Returned Value:
+ *   true if a reader reference was taken; false otherwise.
+ *
+ ****************************************************************************/
+
+bool read_trylock(FAR volatile rwlock_t *lock);
+
+/****************************************************************************
+ * Name: read_unlock
+ *
+ * Description:
+ *   Release a reader reference taken with read_lock() or read_trylock().
+ *
+ ****************************************************************************/
+
+void read_unlock(FAR volatile rwlock_t *lock);
+
+/****************************************************************************
+ * Name: write_lock
+ *
+ * Description:
+ *   Spin until neither readers nor a writer hold the lock, then take it
+ *   exclusively.
+ *
+ ****************************************************************************/
+
+void write_lock(FAR volatile rwlock_t *lock);
+
+/****************************************************************************
+ * Name: write_trylock
+ *
+ * Description:
+ *   Take the lock exclusively only if it is free.
+ *
+ * Returned Value:
+ *   true if the lock was taken; false otherwise.
+ *
+ ****************************************************************************/
+
+bool write_trylock(FAR volatile rwlock_t *lock);
+
+/****************************************************************************
+ * Name: write_unlock
+ *
+ * Description:
+ *   Release a lock taken with write_lock() or write_trylock().
+ *
+ ****************************************************************************/
+
+void write_unlock(FAR volatile rwlock_t *lock);
+
+#endif /* CONFIG_SPINLOCK */
+
+/****************************************************************************
+ * Name: read_lock_irqsave / write_lock_irqsave
+ *
+ * Description:
+ *   If SMP is enabled, disable local interrupts and take the rwlock as a
+ *   reader or as a writer.  If SMP is not enabled, these are equivalent to
+ *   up_irq_save().
+ *
+ * Input Parameters:
+ *   lock - A reference to the rwlock object.
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP)
+irqstate_t read_lock_irqsave(FAR rwlock_t *lock);
+irqstate_t write_lock_irqsave(FAR rwlock_t *lock);
+#else
+#  define read_lock_irqsave(l)  ((void)(l), up_irq_save())
+#  define write_lock_irqsave(l) ((void)(l), up_irq_save())
+#endif
+
+/****************************************************************************
+ * Name: read_unlock_irqrestore / write_unlock_irqrestore
+ *
+ * Description:
+ *   Release a rwlock taken with read_lock_irqsave()/write_lock_irqsave()
+ *   and restore the interrupt state.  If SMP is not enabled, these are
+ *   equivalent to up_irq_restore().
+ *
+ * Input Parameters:
+ *   lock  - A reference to the rwlock object.
+ *   flags - The value returned when the lock was taken.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP)
+void read_unlock_irqrestore(FAR rwlock_t *lock, irqstate_t flags);
+void write_unlock_irqrestore(FAR rwlock_t *lock, irqstate_t flags);
+#else
+#  define read_unlock_irqrestore(l, f)  up_irq_restore(f)
+#  define write_unlock_irqrestore(l, f) up_irq_restore(f)
+#endif
+
+/****************************************************************************
+ * Sequence counters
+ *
+ *   A seqcount_t lets readers access data without taking any lock.  The
+ *   writer makes the count odd while it updates the data; a reader samples
+ *   the count with read_seqbegin(), reads the data and then calls
+ *   read_seqretry(), repeating the read if a writer intervened.
+ *
+ *   Writers must be serialized by some other means (normally a spinlock
+ *   taken with interrupts disabled so that a reader can never interrupt a
+ *   writer on the same CPU).
+ *
+ ****************************************************************************/
+
+typedef struct
+{
+  volatile uint32_t sequence;
+} seqcount_t;
+
+#define SEQCOUNT_INITIALIZER { 0 }
+
+/* void seqcount_init(FAR seqcount_t *s); */
+
+#define seqcount_init(s) do { (s)->sequence = 0; } while (0)
+
+#if defined(CONFIG_HAVE_ATOMICS)
+#  define SEQ_DMB()  __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#elif defined(CONFIG_SPINLOCK)
+#  define SEQ_DMB()  SP_DMB()
+#elif defined(__GNUC__)
+#  define SEQ_DMB()  __asm__ __volatile__ ("" : : : "memory")
+#else
+#  define SEQ_DMB()
+#endif
+
+/****************************************************************************
+ * Name: read_seqbegin
+ *
+ * Description:
+ *   Wait until no update is in progress and return the sequence value to
+ *   be passed to read_seqretry().
+ *
+ ****************************************************************************/
+
+static inline uint32_t read_seqbegin(FAR const seqcount_t *s)
+{
+  uint32_t seq;
+
+  do
+    {
+      seq = s->sequence;
+    }
+  while ((seq & 1) != 0);
+
+  SEQ_DMB();
+  return seq;
+}
+
+/****************************************************************************
+ * Name: read_seqretry
+ *
+ * Description:
+ *   Return true if the data read since read_seqbegin() returned 'start'
+ *   may be inconsistent and the read must be repeated.
+ *
+ ****************************************************************************/
+
+static inline bool read_seqretry(FAR const seqcount_t *s, uint32_t start)
+{
+  SEQ_DMB();
+  return s->sequence != start;
+}
+
+/****************************************************************************
+ * Name: write_seqbegin / write_seqend
+ *
+ * Description:
+ *   Bracket an update of the data protected by the sequence counter.
+ *
+ ****************************************************************************/
+
+static inline void write_seqbegin(FAR seqcount_t *s)
+{
+  s->sequence++;
+  SEQ_DMB();
+}
+
+static inline void write_seqend(FAR seqcount_t *s)
+{
+  SEQ_DMB();
+  s->sequence++;
+}
+
 #endif /* __INCLUDE_NUTTX_SPINLOCK_H */
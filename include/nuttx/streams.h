@@ -27,6 +27,7 @@
 
 #include <nuttx/config.h>
 
+#include <lz4.h>
 #include <lzf.h>
 #include <stdio.h>
 #ifndef CONFIG_DISABLE_MOUNTPOINT
@@ -63,6 +64,17 @@
 #define LZF_STREAM_BLOCKSIZE  ((1 << CONFIG_STREAM_LZF_BLOG) - 1)
 #endif
 
+#ifdef CONFIG_LIBC_LZ4
+#define LZ4_STREAM_BLOCKSIZE  (1 << CONFIG_STREAM_LZ4_BLOG)
+
+/* A block is written as the "LZ4B" magic, the size of the data and the
+ * size of the block, both 32-bit little-endian, and the block.  A block as
+ * long as the data holds the data uncompressed.
+ */
+
+#define LZ4_STREAM_HDRSIZE    12
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -276,6 +288,20 @@ struct lib_lzfoutstream_s
 };
 #endif
 
+/* LZ4 compressed stream pipeline */
+
+#ifdef CONFIG_LIBC_LZ4
+struct lib_lz4outstream_s
+{
+  struct lib_outstream_s      public;
+  FAR struct lib_outstream_s *backend;
+  lz4_state_t                 state;
+  size_t                      offset;
+  uint8_t                     in[LZ4_STREAM_BLOCKSIZE];
+  uint8_t                     out[LZ4_STREAM_HDRSIZE + LZ4_STREAM_BLOCKSIZE];
+};
+#endif
+
 #ifndef CONFIG_DISABLE_MOUNTPOINT
 struct lib_blkoutstream_s
 {
@@ -569,6 +595,29 @@ void lib_lzfoutstream(FAR struct lib_lzfoutstream_s *stream,
                       FAR struct lib_outstream_s *backend);
 #endif
 
+/****************************************************************************
+ * Name: lib_lz4outstream
+ *
+ * Description:
+ *  LZ4 compressed pipeline stream.  The data is compressed in blocks of
+ *  LZ4_STREAM_BLOCKSIZE bytes, each written with the header described by
+ *  LZ4_STREAM_HDRSIZE.
+ *
+ * Input Parameters:
+ *   stream  - User allocated, uninitialized instance of struct
+ *                lib_lz4outstream_s to be initialized.
+ *   backend - Stream backend port.
+ *
+ * Returned Value:
+ *   None (User allocated instance initialized).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_LZ4
+void lib_lz4outstream(FAR struct lib_lz4outstream_s *stream,
+                      FAR struct lib_outstream_s *backend);
+#endif
+
 /****************************************************************************
  * Name: lib_blkoutstream_open
  *
@@ -27,6 +27,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -55,6 +57,24 @@ struct symtab_s
   FAR const void *sym_value; /* The value associated with the string */
 };
 
+/* struct symtab_hash_s is a hash index over a symbol table, in the style of
+ * the GNU ELF hash section.  The symbols of the table are grouped by hash
+ * bucket:  The symbols in bucket 'b' are those from index buckets[b] up to,
+ * but not including, index buckets[b + 1].  hashes[] holds the full hash of
+ * each symbol so that most mismatches are rejected without a string
+ * comparison.
+ *
+ * The index is generated together with the table by 'mksymtab -h' or built
+ * at run time by symtab_buildhash().
+ */
+
+struct symtab_hash_s
+{
+  uint32_t nbuckets;              /* Number of hash buckets */
+  FAR const uint32_t *buckets;    /* Start of each bucket (nbuckets + 1) */
+  FAR const uint32_t *hashes;     /* Hash of each symbol (nsyms) */
+};
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -119,6 +139,51 @@ symtab_findbyvalue(FAR const struct symtab_s *symtab,
 
 void symtab_sortbyname(FAR struct symtab_s *symtab, int nsyms);
 
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   Return the hash of a symbol name as used by struct symtab_hash_s.  This
+ *   is the GNU ELF hash function (h = h * 33 + c, starting at 5381).
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hash(FAR const char *name);
+
+/****************************************************************************
+ * Name: symtab_findbyhash
+ *
+ * Description:
+ *   Find the symbol in the symbol table with the matching name using the
+ *   hash index of the table.  Access time is constant on average.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findbyhash(FAR const struct symtab_s *symtab,
+                  FAR const struct symtab_hash_s *hash,
+                  FAR const char *name, int nsyms);
+
+/****************************************************************************
+ * Name: symtab_buildhash
+ *
+ * Description:
+ *   Reorder the symbol table by hash bucket and build its hash index.  The
+ *   index is returned in a single allocation that is freed with lib_free().
+ *
+ * Returned Value:
+ *   The hash index on success; NULL if memory could not be allocated, in
+ *   which case the symbol table is left unchanged.
+ *
+ ****************************************************************************/
+
+FAR struct symtab_hash_s *symtab_buildhash(FAR struct symtab_s *symtab,
+                                           int nsyms);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -26,6 +26,10 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
 #include <nuttx/fs/ioctl.h>
 
 /****************************************************************************
@@ -37,6 +41,25 @@
 #define CAPIOC_DUTYCYCLE _CAPIOC(1)
 #define CAPIOC_FREQUENCE _CAPIOC(2)
 
+/* CAPIOC_STREAM
+ *   Description: Start streaming edge timestamps, or stop it if nedges
+ *                is zero.  While streaming, read() returns the timestamps
+ *                of the captured edges as an array of uint32_t, oldest
+ *                first.
+ *   Argument:    A pointer to struct cap_stream_s
+ *   Return:      Zero (OK) on success; a negated errno value on failure.
+ *                -ENOTTY if the lower half cannot stream.
+ *
+ * CAPIOC_OVERRUNS
+ *   Description: Return the number of edges lost because the reader did
+ *                not keep up with the DMA since the stream was started.
+ *   Argument:    A pointer to uint32_t
+ *   Return:      Zero (OK) on success; a negated errno value on failure.
+ */
+
+#define CAPIOC_STREAM    _CAPIOC(3)
+#define CAPIOC_OVERRUNS  _CAPIOC(4)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -45,6 +68,33 @@
  * the "upper-half" driver.
  */
 
+#ifdef CONFIG_CAPTURE_DMA
+/* The argument of CAPIOC_STREAM */
+
+struct cap_stream_s
+{
+  uint32_t nedges;   /* Size of the ring in edges, 0 to stop streaming */
+  uint32_t freq;     /* Returned: timestamp ticks per second */
+  uint32_t mask;     /* Returned: timestamps count modulo (mask + 1) */
+};
+
+/* Called by the lower half from its DMA interrupt */
+
+typedef CODE void (*cap_dma_callback_t)(FAR void *arg);
+
+/* The ring that the timer DMA fills with edge timestamps */
+
+struct cap_dma_s
+{
+  FAR uint32_t *ring;            /* Filled circularly by the DMA */
+  size_t nedges;                 /* Number of entries in ring */
+  cap_dma_callback_t callback;   /* To call at each half of the ring */
+  FAR void *arg;                 /* The argument of callback */
+  uint32_t freq;                 /* Set by dma_start: ticks per second */
+  uint32_t mask;                 /* Set by dma_start: counter mask */
+};
+#endif
+
 struct cap_lowerhalf_s;
 struct cap_ops_s
 {
@@ -67,6 +117,27 @@ struct cap_ops_s
 
   CODE int (*getfreq)(FAR struct cap_lowerhalf_s *lower,
                       FAR uint32_t *freq);
+
+#ifdef CONFIG_CAPTURE_DMA
+  /* Optional methods *******************************************************/
+
+  /* Start capturing every edge into dma->ring with the timer DMA, wrapping
+   * around at the end of the ring, and stop interrupting per edge.  The
+   * lower half calls dma->callback when the DMA reaches the middle and the
+   * end of the ring.
+   */
+
+  CODE int (*dma_start)(FAR struct cap_lowerhalf_s *lower,
+                        FAR struct cap_dma_s *dma);
+
+  /* Stop the DMA started by dma_start */
+
+  CODE int (*dma_stop)(FAR struct cap_lowerhalf_s *lower);
+
+  /* Return the index of the ring entry that the DMA writes next */
+
+  CODE size_t (*dma_position)(FAR struct cap_lowerhalf_s *lower);
+#endif
 };
 
 /* This structure provides the publicly visible representation of the
@@ -33,6 +33,7 @@
 #include <nuttx/list.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <pthread.h>
 
 /****************************************************************************
@@ -135,6 +136,7 @@ struct task_info_s
 #endif
 #ifdef CONFIG_FILE_STREAM
   struct streamlist ta_streamlist; /* Holds C buffered I/O info */
+  bool            ta_multithread;  /* Streams are shared with pthreads */
 #endif
 
 #ifdef CONFIG_PTHREAD_ATFORK
@@ -18,6 +18,11 @@
  *
  *****************************************************************************/
 
+/* The table numbers below refer to the CDC specification unless they are
+ * tagged with [NCM1.0], the "Universal Serial Bus Communications Class
+ * Subclass Specification for Network Control Model Devices, Revision 1.0"
+ */
+
 #ifndef __INCLUDE_NUTTX_USB_CDC_H
 #define __INCLUDE_NUTTX_USB_CDC_H
 
@@ -57,7 +62,8 @@
 #define CDC_SUBCLASS_CAPI       0x05 /* CAPI Control Model */
 #define CDC_SUBCLASS_ECM        0x06 /* Ethernet Networking Control Model */
 #define CDC_SUBCLASS_ATM        0x07 /* ATM Networking Control Model */
-                                     /* 0x08-0x0d Reserved (future use) */
+                                     /* 0x08-0x0c Reserved (future use) */
+#define CDC_SUBCLASS_NCM        0x0d /* Network Control Model */
 #define CDC_SUBCLASS_MBIM       0x0e /* MBIM Control Model */
                                      /* 0x0f-0x7f Reserved (future use) */
                                      /* 0x80-0xfe Reserved (vendor specific) */
@@ -84,8 +90,9 @@
 /* Table 19: Data Interface Class Protocol Codes */
 
 #define CDC_DATA_PROTO_NONE     0x00 /* No class specific protocol required */
-                                     /* 0x01-0x2f Reserved (future use) */
+#define CDC_DATA_PROTO_NCMNTB   0x01 /* NCM Network Transfer Block protocol */
 #define CDC_DATA_PROTO_NTB      0x02 /* Network Transfer Block protocol */
+                                     /* 0x03-0x2f Reserved (future use) */
 #define CDC_DATA_PROTO_ISDN     0x30 /* Physical interface protocol for ISDN BRI */
 #define CDC_DATA_PROTO_HDLC     0x31 /* HDLC */
 #define CDC_DATA_PROTO_TRANSP   0x32 /* Transparent */
@@ -328,6 +335,42 @@
                                       */
 #define ECM_SPEED_CHANGE        ATM_SPEED_CHANGE
 
+/* [NCM1.0] Table 6-2: Requests, Network Control Model */
+
+#define NCM_GET_NTB_PARAMETERS  0x80 /* Returns the NTB data format and size
+                                      * parameters (Required)
+                                      */
+#define NCM_GET_NET_ADDRESS     0x81 /* Returns the current EUI-48 station
+                                      * address (Optional)
+                                      */
+#define NCM_SET_NET_ADDRESS     0x82 /* Sets the EUI-48 station address
+                                      * (Optional)
+                                      */
+#define NCM_GET_NTB_FORMAT      0x83 /* Returns the current NTB format
+                                      * (Optional)
+                                      */
+#define NCM_SET_NTB_FORMAT      0x84 /* Selects the 16 or 32-bit NTB format
+                                      * (Optional)
+                                      */
+#define NCM_GET_NTB_INPUT_SIZE  0x85 /* Returns the current maximum size of
+                                      * the IN NTBs (Required)
+                                      */
+#define NCM_SET_NTB_INPUT_SIZE  0x86 /* Selects the maximum size of the IN
+                                      * NTBs (Required)
+                                      */
+#define NCM_GET_MAX_DATAGRAM    0x87 /* Returns the current maximum datagram
+                                      * size (Optional)
+                                      */
+#define NCM_SET_MAX_DATAGRAM    0x88 /* Sets the maximum datagram size
+                                      * (Optional)
+                                      */
+#define NCM_GET_CRC_MODE        0x89 /* Returns the current CRC mode
+                                      * (Optional)
+                                      */
+#define NCM_SET_CRC_MODE        0x8a /* Selects whether the datagrams carry a
+                                      * CRC (Optional)
+                                      */
+
 /* Descriptors ***************************************************************/
 
 /* Table 25: bDescriptor SubType in Functional Descriptors */
@@ -352,6 +395,7 @@
 #define CDC_DSUBTYPE_CAPI       0x0e /* CAPI Control Management Functional Descriptor */
 #define CDC_DSUBTYPE_ECM        0x0f /* Ethernet Networking Functional Descriptor */
 #define CDC_DSUBTYPE_ATM        0x10 /* ATM Networking Functional Descriptor */
+#define CDC_DSUBTYPE_NCM        0x1a /* NCM Functional Descriptor */
 #define CDC_DSUBTYPE_MBIM       0x1b /* MBIM Functional Descriptor */
                                      /* 0x11-0xff Reserved (future use) */
 
@@ -911,6 +955,28 @@ struct cdc_atm_funcdesc_s
 
 #define SIZEOF_ATM_FUNCDESC 12
 
+/* [NCM1.0] Table 5-2: NCM Functional Descriptor */
+
+struct cdc_ncm_funcdesc_s
+{
+  uint8_t size;       /* bFunctionLength, Size of this descriptor */
+  uint8_t type;       /* bDescriptorType, USB_DESC_TYPE_CSINTERFACE */
+  uint8_t subtype;    /* bDescriptorSubType, CDC_DSUBTYPE_NCM */
+  uint8_t version[2]; /* bcdNcmVersion, Release of the NCM specification */
+  uint8_t netcaps;    /* bmNetworkCapabilities, The optional requests that
+                       * are supported, see NCMCAP_* definitions.
+                       */
+};
+
+#define SIZEOF_NCM_FUNCDESC 6
+
+#define NCMCAP_PACKET_FILTER       (1 << 0)  /* SetEthernetPacketFilter */
+#define NCMCAP_NET_ADDRESS         (1 << 1)  /* Get/SetNetAddress */
+#define NCMCAP_ENCAP_COMMAND       (1 << 2)  /* Encapsulated commands */
+#define NCMCAP_MAX_DATAGRAM        (1 << 3)  /* Get/SetMaxDatagramSize */
+#define NCMCAP_CRC_MODE            (1 << 4)  /* Get/SetCrcMode */
+#define NCMCAP_NTB_INPUT_SIZE8     (1 << 5)  /* 8-byte SetNtbInputSize */
+
 /* Descriptor Data Structures ************************************************/
 
 /* Table 50: Line Coding Structure */
@@ -955,6 +1021,63 @@ struct cdc_notification_s
 
 #define SIZEOF_NOTIFICATION_S(n) (sizeof(struct cdc_notification_s) + (n) - 1)
 
+/* [NCM1.0] Table 6-3: NTB Parameter Structure */
+
+struct cdc_ncm_ntbparms_s
+{
+  uint8_t len[2];        /* wLength, Size of this structure */
+  uint8_t formats[2];    /* bmNtbFormatsSupported, bit 0: NTB16, 1: NTB32 */
+  uint8_t inmaxsize[4];  /* dwNtbInMaxSize, Maximum size of the IN NTBs */
+  uint8_t indivisor[2];  /* wNdpInDivisor, Modulus of the IN datagrams */
+  uint8_t inremain[2];   /* wNdpInPayloadRemainder, Their offset remainder */
+  uint8_t inalign[2];    /* wNdpInAlignment, Alignment of the IN NDPs */
+  uint8_t reserved[2];
+  uint8_t outmaxsize[4]; /* dwNtbOutMaxSize, Maximum size of the OUT NTBs */
+  uint8_t outdivisor[2]; /* wNdpOutDivisor, Modulus of the OUT datagrams */
+  uint8_t outremain[2];  /* wNdpOutPayloadRemainder, Their offset remainder */
+  uint8_t outalign[2];   /* wNdpOutAlignment, Alignment of the OUT NDPs */
+  uint8_t outmaxdg[2];   /* wNtbOutMaxDatagrams, 0: no limit */
+};
+
+#define SIZEOF_NCM_NTBPARMS 28
+
+/* [NCM1.0] Table 3-1: 16-bit NCM Transfer Header (NTH16) */
+
+#define NCM_NTH16_SIGNATURE "NCMH"
+
+struct cdc_ncm_nth16_s
+{
+  uint8_t sig[4];        /* dwSignature, NCM_NTH16_SIGNATURE */
+  uint8_t hdrlen[2];     /* wHeaderLength, Size of this header, 12 */
+  uint8_t seq[2];        /* wSequence, Sequence number of the NTB */
+  uint8_t blklen[2];     /* wBlockLength, Size of the NTB */
+  uint8_t ndpidx[2];     /* wNdpIndex, Offset of the first NDP16 */
+};
+
+#define SIZEOF_NCM_NTH16 12
+
+/* [NCM1.0] Table 3-3: 16-bit NCM Datagram Pointer Table (NDP16), a table
+ * of datagram index and length pairs terminated by a null entry.
+ */
+
+#define NCM_NDP16_SIGNATURE "NCM0"   /* Datagrams without CRC */
+
+struct cdc_ncm_dpe16_s
+{
+  uint8_t index[2];      /* wDatagramIndex, Offset of the datagram */
+  uint8_t len[2];        /* wDatagramLength, Size of the datagram */
+};
+
+struct cdc_ncm_ndp16_s
+{
+  uint8_t sig[4];        /* dwSignature, NCM_NDP16_SIGNATURE */
+  uint8_t len[2];        /* wLength, Size of this table, at least 16 */
+  uint8_t nextidx[2];    /* wNextNdpIndex, Offset of the next NDP16 */
+  struct cdc_ncm_dpe16_s dg[1];
+};
+
+#define SIZEOF_NCM_NDP16(n) (8 + 4 * (n))
+
 /* Table 60: Unit Parameter Structure */
 
 struct cdc_unitparm_s
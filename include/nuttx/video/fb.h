@@ -806,7 +806,11 @@ struct fb_vtable_s
 
 #endif
 
-  /* Pan display for multiple buffers. */
+  /* Pan display for multiple buffers.  When the virtual resolution holds
+   * more than one buffer, the upper half queues the pan and this is only
+   * a notification, it may be NULL.  The lower half shows the queued pans
+   * with fb_peek_paninfo() and fb_remove_paninfo() on vertical sync.
+   */
 
   int (*pandisplay)(FAR struct fb_vtable_s *vtable,
                     FAR struct fb_planeinfo_s *pinfo);
@@ -1010,6 +1014,76 @@ void up_fbuninitialize(int display);
 
 void fb_pollnotify(FAR struct fb_vtable_s *vtable);
 
+/****************************************************************************
+ * Name: fb_paninfo_count
+ *
+ * Description:
+ *   Return the number of FBIOPAN_DISPLAY requests that wait for the
+ *   vertical sync.  The requests are queued when the virtual resolution
+ *   holds more than one buffer.
+ *
+ * Input Parameters:
+ *   vtable - Pointer to framebuffer's virtual table.
+ *
+ ****************************************************************************/
+
+int fb_paninfo_count(FAR struct fb_vtable_s *vtable);
+
+/****************************************************************************
+ * Name: fb_peek_paninfo
+ *
+ * Description:
+ *   Get the oldest queued pan without removing it.  A lower half calls
+ *   this from its vertical sync interrupt handler to program the scan out
+ *   address of the buffer, no pixel data is copied.
+ *
+ * Input Parameters:
+ *   vtable - Pointer to framebuffer's virtual table.
+ *   pinfo  - Returns the plane information given to FBIOPAN_DISPLAY.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODATA if no pan is queued.
+ *
+ ****************************************************************************/
+
+int fb_peek_paninfo(FAR struct fb_vtable_s *vtable,
+                    FAR struct fb_planeinfo_s *pinfo);
+
+/****************************************************************************
+ * Name: fb_remove_paninfo
+ *
+ * Description:
+ *   Remove the oldest queued pan once the hardware shows its buffer.  This
+ *   releases the buffer shown until then and notifies the waiting thread
+ *   as fb_pollnotify() does.
+ *
+ * Input Parameters:
+ *   vtable - Pointer to framebuffer's virtual table.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENODATA if no pan is queued.
+ *
+ ****************************************************************************/
+
+int fb_remove_paninfo(FAR struct fb_vtable_s *vtable);
+
+/****************************************************************************
+ * Name: fb_vsyncnotify
+ *
+ * Description:
+ *   Wake up the threads waiting in FBIO_WAITFORVSYNC.  A lower half that
+ *   does not provide the waitforvsync method calls this from its vertical
+ *   sync interrupt handler.
+ *
+ * Input Parameters:
+ *   vtable - Pointer to framebuffer's virtual table.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FB_SYNC
+void fb_vsyncnotify(FAR struct fb_vtable_s *vtable);
+#endif
+
 /****************************************************************************
  * Name: fb_register
  *
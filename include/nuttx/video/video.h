@@ -462,6 +462,10 @@ extern "C"
 
 #define V4L2_REQBUFS_COUNT_MAX CONFIG_VIDEO_REQBUFS_COUNT_MAX
 
+/* MAX number of planes of a multi-planar format */
+
+#define VIDEO_MAX_PLANES       (3)
+
 /* Buffer error flag */
 
 #define V4L2_BUF_FLAG_ERROR    (0x0001)
@@ -832,6 +836,25 @@ struct v4l2_buffer
 
 typedef struct v4l2_buffer v4l2_buffer_t;
 
+/* struct v4l2_exportbuffer
+ * Parameter of ioctl(VIDIOC_EXPBUF).
+ * The plane 'plane' of the V4L2_MEMORY_MMAP buffer 'index' is exported as
+ * the file descriptor 'fd'.  The descriptor can be mmap()ed or queued as a
+ * V4L2_MEMORY_DMABUF buffer so that the data is shared without copies.
+ */
+
+struct v4l2_exportbuffer
+{
+  uint32_t             type;      /* enum #v4l2_buf_type */
+  uint32_t             index;     /* Buffer id */
+  uint32_t             plane;     /* Plane of a multi-planar buffer */
+  uint32_t             flags;     /* O_CLOEXEC and access mode flags */
+  int32_t              fd;        /* Driver sets the file descriptor */
+  uint32_t             reserved[11];
+};
+
+typedef struct v4l2_exportbuffer v4l2_exportbuffer_t;
+
 struct v4l2_fmtdesc
 {
   uint16_t index;                           /* Format number      */
@@ -945,12 +968,40 @@ struct v4l2_pix_format
 
 typedef struct v4l2_pix_format v4l2_pix_format_t;
 
+/* The format of one plane of a multi-planar format */
+
+struct v4l2_plane_pix_format
+{
+  uint32_t  sizeimage;          /* Size in bytes of the plane */
+  uint32_t  bytesperline;       /* Distance in bytes between two lines */
+  uint16_t  reserved[6];
+};
+
+struct v4l2_pix_format_mplane
+{
+  uint16_t  width;              /* Image width in pixels */
+  uint16_t  height;             /* Image height in pixels */
+  uint32_t  pixelformat;        /* The pixel format */
+  uint32_t  field;              /* enum #v4l2_field */
+  uint32_t  colorspace;         /* Image colorspace */
+  struct v4l2_plane_pix_format plane_fmt[VIDEO_MAX_PLANES];
+  uint8_t   num_planes;         /* Number of planes */
+  uint8_t   flags;              /* Format flags (V4L2_PIX_FMT_FLAG_*) */
+  uint8_t   ycbcr_enc;          /* enum v4l2_ycbcr_encoding */
+  uint8_t   quantization;       /* enum v4l2_quantization */
+  uint8_t   xfer_func;          /* enum v4l2_xfer_func */
+  uint8_t   reserved[7];
+};
+
+typedef struct v4l2_pix_format_mplane v4l2_pix_format_mplane_t;
+
 struct v4l2_format
 {
   uint32_t  type;               /* enum #v4l2_buf_type. */
   union
   {
-    struct v4l2_pix_format pix; /* Image format */
+    struct v4l2_pix_format        pix;    /* Image format */
+    struct v4l2_pix_format_mplane pix_mp; /* Multi-planar image format */
   } fmt;
 };
 
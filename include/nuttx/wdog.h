@@ -75,7 +75,12 @@ struct wdog_s
 #ifdef CONFIG_PIC
   FAR void          *picbase;    /* PIC base address */
 #endif
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  FAR struct wdog_s **pprev;     /* Link that points to this watchdog */
+  clock_t            expired;    /* Absolute expiration time in ticks */
+#else
   sclock_t           lag;        /* Timer associated with the delay */
+#endif
 };
 
 /****************************************************************************
@@ -129,6 +134,36 @@ extern "C"
 int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
              wdentry_t wdentry, wdparm_t arg);
 
+/****************************************************************************
+ * Name: wd_start_slack
+ *
+ * Description:
+ *   Start a watchdog timer like wd_start(), but allow the expiration to be
+ *   deferred by up to 'slack' clock ticks so that it may be coalesced with
+ *   other nearby timer events.  Without CONFIG_SCHED_TIMER_SLACK this is
+ *   the same as wd_start().
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   delay    - Delay count in clock ticks
+ *   slack    - Maximum additional delay in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TIMER_SLACK
+int wd_start_slack(FAR struct wdog_s *wdog, sclock_t delay, sclock_t slack,
+                   wdentry_t wdentry, wdparm_t arg);
+#else
+#  define wd_start_slack(wdog, delay, slack, wdentry, arg) \
+     wd_start(wdog, delay, wdentry, arg)
+#endif
+
 /****************************************************************************
  * Name: wd_cancel
  *
@@ -166,6 +201,26 @@ int wd_cancel(FAR struct wdog_s *wdog);
 
 sclock_t wd_gettime(FAR struct wdog_s *wdog);
 
+/****************************************************************************
+ * Name: wd_nextexpiry
+ *
+ * Description:
+ *   This function returns the time remaining before the next active
+ *   watchdog timer (of any owner) expires.  This is the earliest time at
+ *   which the timer will wake up an idle CPU.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the next watchdog expires.
+ *   Zero means that a watchdog is already due.  A negative value means
+ *   that no watchdog is active.
+ *
+ ****************************************************************************/
+
+sclock_t wd_nextexpiry(void);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
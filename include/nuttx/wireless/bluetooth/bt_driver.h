@@ -49,6 +49,9 @@
 #define bt_netdev_receive(btdev, type, data, len) \
         (btdev)->receive(btdev, type, data, len)
 
+#define bt_netdev_receive_buf(btdev, buf) \
+        (btdev)->receive_buf(btdev, buf)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -79,6 +82,15 @@ struct bt_driver_s
                       enum bt_buf_type_e type,
                       FAR void *data, size_t len);
 
+  /* Filled by register function if the stack can take over a buffer from
+   * bt_buf_alloc(), NULL otherwise.  Drivers that receive directly into
+   * such a buffer save a copy of each packet.  The buffer is released by
+   * the stack in any case.
+   */
+
+  CODE int (*receive_buf)(FAR struct bt_driver_s *btdev,
+                          FAR struct bt_buf_s *buf);
+
   /* Lower-half logic may support platform-specific ioctl commands */
 
   CODE int (*ioctl)(FAR struct bt_driver_s *btdev, int cmd,
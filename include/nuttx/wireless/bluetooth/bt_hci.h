@@ -103,7 +103,21 @@
 
 /* LE features */
 
-#define BT_HCI_LE_ENCRYPTION     0x01
+#define BT_HCI_LE_ENCRYPTION     0x01 /* le_features[0] */
+#define BT_HCI_LE_DATA_LEN_EXT   0x20 /* le_features[0] */
+#define BT_HCI_LE_2M_PHY         0x01 /* le_features[1] */
+
+/* LE PHYs */
+
+#define BT_HCI_LE_PHY_1M         0x01
+#define BT_HCI_LE_PHY_2M         0x02
+
+/* The largest LE data channel PDU payload and the time it takes to send
+ * it on the 1M PHY, which is also enough on the 2M PHY.
+ */
+
+#define BT_HCI_LE_MAX_TX_OCTETS  251
+#define BT_HCI_LE_MAX_TX_TIME    2120
 
 /* OpCode Group Fields */
 
@@ -175,6 +189,10 @@
 #define BT_HCI_OP_LE_START_ENCRYPTION         BT_OP(BT_OGF_LE, 0x0019)
 #define BT_HCI_OP_LE_LTK_REQ_REPLY            BT_OP(BT_OGF_LE, 0x001a)
 #define BT_HCI_OP_LE_LTK_REQ_NEG_REPLY        BT_OP(BT_OGF_LE, 0x001b)
+#define BT_HCI_OP_LE_SET_DATA_LEN             BT_OP(BT_OGF_LE, 0x0022)
+#define BT_HCI_OP_LE_WRITE_DEFAULT_DATA_LEN   BT_OP(BT_OGF_LE, 0x0024)
+#define BT_HCI_OP_LE_SET_DEFAULT_PHY          BT_OP(BT_OGF_LE, 0x0031)
+#define BT_HCI_OP_LE_SET_PHY                  BT_OP(BT_OGF_LE, 0x0032)
 
 /* Event definitions */
 
@@ -509,6 +527,35 @@ begin_packed_struct struct bt_hci_cp_le_ltk_req_neg_reply_s
   uint16_t handle;
 } end_packed_struct;
 
+begin_packed_struct struct bt_hci_cp_le_set_data_len_s
+{
+  uint16_t handle;
+  uint16_t tx_octets;
+  uint16_t tx_time;
+} end_packed_struct;
+
+begin_packed_struct struct bt_hci_cp_le_write_default_data_len_s
+{
+  uint16_t max_tx_octets;
+  uint16_t max_tx_time;
+} end_packed_struct;
+
+begin_packed_struct struct bt_hci_cp_le_set_default_phy_s
+{
+  uint8_t all_phys;
+  uint8_t tx_phys;
+  uint8_t rx_phys;
+} end_packed_struct;
+
+begin_packed_struct struct bt_hci_cp_le_set_phy_s
+{
+  uint16_t handle;
+  uint8_t all_phys;
+  uint8_t tx_phys;
+  uint8_t rx_phys;
+  uint16_t phy_opts;
+} end_packed_struct;
+
 /* Event definitions */
 
 begin_packed_struct struct bt_hci_evt_disconn_complete_s
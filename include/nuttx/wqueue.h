@@ -254,6 +254,9 @@ struct work_s
   } u;
   worker_t  worker;         /* Work callback */
   FAR void *arg;            /* Callback argument */
+#ifdef CONFIG_SCHED_CPUWORK
+  uint8_t   cpu;            /* CPU of work_queue_cpu() work */
+#endif
 };
 
 /* This is an enumeration of the various events that may be
@@ -383,6 +386,52 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
 
 int work_cancel(int qid, FAR struct work_s *work);
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue kernel-mode work to be performed by the worker thread bound to
+ *   the specified CPU.  The semantics are otherwise identical to
+ *   work_queue().
+ *
+ * Input Parameters:
+ *   cpu    - The CPU whose work queue is used
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUWORK
+int work_queue_cpu(int cpu, FAR struct work_s *work, worker_t worker,
+                   FAR void *arg, clock_t delay);
+
+/****************************************************************************
+ * Name: work_cancel_cpu
+ *
+ * Description:
+ *   Cancel work previously queued with work_queue_cpu().
+ *
+ * Input Parameters:
+ *   cpu    - The CPU whose work queue was used
+ *   work   - The previously queued work structure to cancel
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ *   -ENOENT - There is no such work queued.
+ *   -EINVAL - An invalid CPU was specified
+ *
+ ****************************************************************************/
+
+int work_cancel_cpu(int cpu, FAR struct work_s *work);
+#endif
+
 /****************************************************************************
  * Name: work_foreach
  *
@@ -386,15 +386,24 @@ typedef struct pthread_rwlockattr_s pthread_rwlockattr_t;
 #  define __PTHREAD_RWLOCKATTR_T_DEFINED 1
 #endif
 
+/* Readers and writers take and release an uncontended rwlock with atomic
+ * operations on 'state' alone.  'lock' and 'cv' are used only to wait, and
+ * only while PTHREAD_RWLOCK_WAITERS is set.
+ */
+
 struct pthread_rwlock_s
 {
   pthread_mutex_t lock;
   pthread_cond_t  cv;
-  unsigned int num_readers;
-  unsigned int num_writers;
-  bool write_in_progress;
+  unsigned int state;        /* Holders, see PTHREAD_RWLOCK_* below */
+  unsigned int num_writers;  /* Writers waiting, protected by 'lock' */
+  unsigned int num_waiters;  /* Threads waiting, protected by 'lock' */
 };
 
+#define PTHREAD_RWLOCK_WRITER   0x80000000 /* Held by a writer */
+#define PTHREAD_RWLOCK_WAITERS  0x40000000 /* Threads wait on 'cv' */
+#define PTHREAD_RWLOCK_READERS  0x3fffffff /* Number of readers */
+
 #ifndef __PTHREAD_RWLOCK_T_DEFINED
 typedef struct pthread_rwlock_s pthread_rwlock_t;
 #  define __PTHREAD_RWLOCK_T_DEFINED 1
@@ -402,7 +411,7 @@ typedef struct pthread_rwlock_s pthread_rwlock_t;
 
 #define PTHREAD_RWLOCK_INITIALIZER  {PTHREAD_MUTEX_INITIALIZER, \
                                      PTHREAD_COND_INITIALIZER, \
-                                     0, 0, false}
+                                     0, 0, 0}
 
 #ifdef CONFIG_PTHREAD_SPINLOCKS
 /* This (non-standard) structure represents a pthread spinlock */
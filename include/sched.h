@@ -46,6 +46,7 @@
 #define SCHED_FIFO                1  /* FIFO priority scheduling policy */
 #define SCHED_RR                  2  /* Round robin scheduling policy */
 #define SCHED_SPORADIC            3  /* Sporadic scheduling policy */
+#define SCHED_DEADLINE            4  /* Earliest deadline first policy */
 
 /* Maximum number of SCHED_SPORADIC replenishments */
 
@@ -197,6 +198,29 @@ struct sched_param
   int sched_ss_max_repl;                /* Maximum pending replenishments for
                                          * sporadic server. */
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  struct timespec sched_dl_runtime;     /* Execution budget per period */
+  struct timespec sched_dl_deadline;    /* Deadline relative to the start of
+                                         * each period. */
+  struct timespec sched_dl_period;      /* Period of the deadline server */
+#endif
+};
+
+/* This is the Linux-compatible extended scheduling attribute structure used
+ * with sched_setattr() and sched_getattr().  All times are in nanoseconds.
+ */
+
+struct sched_attr
+{
+  uint32_t size;                        /* Size of this structure */
+  uint32_t sched_policy;                /* Scheduling policy */
+  uint64_t sched_flags;                 /* Unused, must be zero */
+  int32_t  sched_nice;                  /* Unused */
+  uint32_t sched_priority;              /* Priority for SCHED_FIFO/RR */
+  uint64_t sched_runtime;               /* SCHED_DEADLINE budget */
+  uint64_t sched_deadline;              /* SCHED_DEADLINE relative deadline */
+  uint64_t sched_period;                /* SCHED_DEADLINE period */
 };
 
 /****************************************************************************
@@ -244,6 +268,10 @@ int    sched_yield(void);
 int    sched_get_priority_max(int policy);
 int    sched_get_priority_min(int policy);
 int    sched_rr_get_interval(pid_t pid, FAR struct timespec *interval);
+int    sched_setattr(pid_t pid, FAR const struct sched_attr *attr,
+                     unsigned int flags);
+int    sched_getattr(pid_t pid, FAR struct sched_attr *attr,
+                     unsigned int size, unsigned int flags);
 
 #ifdef CONFIG_SMP
 /* Task affinity */
@@ -266,6 +266,7 @@
 #ifdef CONFIG_SIG_EVTHREAD
 #  define SIGEV_THREAD  3 /* A notification function is called */
 #endif
+#define SIGEV_THREAD_ID 4 /* Notify the thread sigev_notify_thread_id via signal */
 
 /* sigaltstack stack size */
 
@@ -345,6 +346,8 @@ struct sigevent
   sigev_notify_function_t sigev_notify_function;      /* Notification function */
   FAR struct pthread_attr_s *sigev_notify_attributes; /* Notification attributes (not used) */
 #endif
+
+  pid_t        sigev_notify_thread_id; /* Thread for SIGEV_THREAD_ID */
 };
 
 /* The following types is used to pass parameters to/from signal handlers */
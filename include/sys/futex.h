@@ -0,0 +1,107 @@
+/****************************************************************************
+ * include/sys/futex.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_FUTEX_H
+#define __INCLUDE_SYS_FUTEX_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef CONFIG_FUTEX
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: futex_wait
+ *
+ * Description:
+ *   Atomically check that the 32-bit word at 'uaddr' still contains 'val'
+ *   and, if so, sleep until futex_wake() is called on the same address,
+ *   the timeout expires or a signal is received.  The word is only ever
+ *   read by the kernel; the caller owns its meaning.
+ *
+ *   In the flat build any tasks may share a futex.  In protected and
+ *   kernel builds a futex is private to the task group (process) that
+ *   owns the address, except that with CONFIG_FUTEX_SHARED a futex in
+ *   shared memory is shared by all processes that map it.
+ *
+ * Input Parameters:
+ *   uaddr   - The address of the futex word; must be 4-byte aligned
+ *   val     - The value the caller expects the futex word to hold
+ *   timeout - The maximum relative time to wait, or NULL to wait forever
+ *
+ * Returned Value:
+ *   Zero (OK) is returned when woken up.  Otherwise -1 (ERROR) is returned
+ *   and errno is set to indicate the error:
+ *
+ *   EAGAIN    The futex word did not contain 'val'
+ *   EINVAL    'uaddr' is misaligned or 'timeout' is invalid
+ *   ETIMEDOUT The timeout expired
+ *   EINTR     The wait was interrupted by a signal
+ *
+ ****************************************************************************/
+
+int futex_wait(FAR volatile uint32_t *uaddr, uint32_t val,
+               FAR const struct timespec *timeout);
+
+/****************************************************************************
+ * Name: futex_wake
+ *
+ * Description:
+ *   Wake up at most 'nwake' threads waiting in futex_wait() on 'uaddr'.
+ *
+ * Input Parameters:
+ *   uaddr - The address of the futex word; must be 4-byte aligned
+ *   nwake - The maximum number of threads to wake up
+ *
+ * Returned Value:
+ *   The number of threads woken up.  Otherwise -1 (ERROR) is returned and
+ *   errno is set to indicate the error:
+ *
+ *   EINVAL    'uaddr' is misaligned or 'nwake' is negative
+ *
+ ****************************************************************************/
+
+int futex_wake(FAR volatile uint32_t *uaddr, int nwake);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_FUTEX */
+#endif /* __INCLUDE_SYS_FUTEX_H */
@@ -0,0 +1,160 @@
+/****************************************************************************
+ * include/sys/ioring.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_IORING_H
+#define __INCLUDE_SYS_IORING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <fcntl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Flags to be passed to ioring_setup() */
+
+#define IORING_CLOEXEC    O_CLOEXEC
+
+/* Submission queue entry operations */
+
+#define IORING_OP_NOP     0  /* Complete with 0 */
+#define IORING_OP_READ    1  /* read() or pread() if off >= 0 */
+#define IORING_OP_WRITE   2  /* write() or pwrite() if off >= 0 */
+#define IORING_OP_FSYNC   3  /* fsync() */
+#define IORING_OP_SEND    4  /* send() with 'flags' as the MSG_* flags */
+#define IORING_OP_RECV    5  /* recv() with 'flags' as the MSG_* flags */
+#define IORING_OP_POLL    6  /* Wait for the poll events in 'flags' */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* A submission queue entry, filled by the application */
+
+struct ioring_sqe
+{
+  uint8_t    opcode;      /* IORING_OP_* */
+  int        fd;          /* The file descriptor to operate on */
+  uint32_t   flags;       /* Operation specific flags */
+  off_t      off;         /* File offset of IORING_OP_READ/WRITE */
+  FAR void  *addr;        /* The I/O buffer */
+  size_t     len;         /* The size of the I/O buffer */
+  uint64_t   user_data;   /* Returned unchanged in the completion */
+};
+
+/* A completion queue entry, filled by the kernel */
+
+struct ioring_cqe
+{
+  uint64_t   user_data;   /* user_data of the submission */
+  ssize_t    res;         /* Result of the operation or a negated errno */
+};
+
+/* The rings shared by the application and the kernel.  Both numbers of
+ * entries must be powers of two.  The head and tail indexes run freely
+ * and are masked with the number of entries minus one.
+ *
+ * The application fills sqes[sq_tail] and then advances sq_tail, the
+ * kernel advances sq_head when it has taken the entries.  The kernel fills
+ * cqes[cq_tail] and then advances cq_tail, the application advances
+ * cq_head when it has consumed the completions.  A completion that finds
+ * a full completion queue is dropped and counted in cq_overflow.
+ *
+ * The rings and the I/O buffers must stay valid until the completions of
+ * all the submissions are consumed or the ring is closed.
+ */
+
+struct ioring
+{
+  uint32_t   sq_head;     /* Next submission taken by the kernel */
+  uint32_t   sq_tail;     /* Next submission filled by the application */
+  uint32_t   sq_entries;  /* Number of submission queue entries */
+  uint32_t   cq_head;     /* Next completion consumed by the application */
+  uint32_t   cq_tail;     /* Next completion filled by the kernel */
+  uint32_t   cq_entries;  /* Number of completion queue entries */
+  uint32_t   cq_overflow; /* Number of dropped completions */
+  FAR struct ioring_sqe *sqes;
+  FAR struct ioring_cqe *cqes;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: ioring_setup
+ *
+ * Description:
+ *   Create a file descriptor that services the submissions of 'ring'.  The
+ *   descriptor is readable (POLLIN) while completions are pending.
+ *
+ * Input Parameters:
+ *   ring  - The shared rings, initialized by the application
+ *   flags - Zero or IORING_CLOEXEC
+ *
+ * Returned Value:
+ *   The new file descriptor on success; -1 (ERROR) with errno set on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int ioring_setup(FAR struct ioring *ring, int flags);
+
+/****************************************************************************
+ * Name: ioring_enter
+ *
+ * Description:
+ *   Submit up to 'to_submit' new entries of the submission queue and then
+ *   wait until at least 'min_complete' completions are pending.
+ *
+ * Input Parameters:
+ *   fd           - The descriptor returned by ioring_setup()
+ *   to_submit    - The maximum number of entries to submit
+ *   min_complete - The number of pending completions to wait for
+ *   timeout      - The maximum wait in milliseconds, -1 waits forever
+ *
+ * Returned Value:
+ *   The number of entries submitted on success; -1 (ERROR) with errno set
+ *   on failure.  A timeout is not a failure.
+ *
+ ****************************************************************************/
+
+int ioring_enter(int fd, unsigned int to_submit, unsigned int min_complete,
+                 int timeout);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_SYS_IORING_H */
@@ -67,12 +67,29 @@
  *
  *      char myname[CONFIG_TASK_NAME_SIZE];
  *      prctl(PR_GET_NAME_EXT, myname, pid);
+ *
+ *  PR_SET_TIMERSLACK
+ *    Set the timer slack of the calling thread to the number of nanoseconds
+ *    in arg2 (unsigned long).  Timed waits of the thread may then expire up
+ *    to that much later than requested so that they can be coalesced with
+ *    other nearby timer events.  A value of 0 restores the default slack,
+ *    CONFIG_SCHED_TIMER_SLACK_DEFAULT.  As an example:
+ *
+ *      prctl(PR_SET_TIMERSLACK, 50000);
+ *
+ *  PR_GET_TIMERSLACK
+ *    Return the current timer slack of the calling thread, in nanoseconds,
+ *    as the value of prctl().  As an example:
+ *
+ *      int slack = prctl(PR_GET_TIMERSLACK);
  */
 
-#define PR_SET_NAME     1
-#define PR_GET_NAME     2
-#define PR_SET_NAME_EXT 3
-#define PR_GET_NAME_EXT 4
+#define PR_SET_NAME       1
+#define PR_GET_NAME       2
+#define PR_SET_NAME_EXT   3
+#define PR_GET_NAME_EXT   4
+#define PR_SET_TIMERSLACK 29
+#define PR_GET_TIMERSLACK 30
 
 /****************************************************************************
  * Public Type Definitions
@@ -0,0 +1,233 @@
+/****************************************************************************
+ * include/sys/shmring.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_SHMRING_H
+#define __INCLUDE_SYS_SHMRING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef CONFIG_LIBC_SHMRING
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The control block at the start of the shared memory object.  The
+ * indices run freely and are reduced modulo the size of the data area.
+ * head and tail are also the futex words that the consumer and the
+ * producer sleep on.
+ */
+
+struct shmring_ctrl_s
+{
+  uint32_t magic;                   /* SHMRING_MAGIC once initialized */
+  uint32_t size;                    /* Size of the data area, a power of 2 */
+  volatile uint32_t head;           /* Written by the producer */
+  volatile uint32_t tail;           /* Written by the consumer */
+  volatile uint32_t rwait;          /* Non-zero while the consumer sleeps */
+  volatile uint32_t wwait;          /* Non-zero while the producer sleeps */
+};
+
+/* One end of a channel, private to the process that opened it */
+
+struct shmring_s
+{
+  FAR struct shmring_ctrl_s *ctrl;  /* The mapped control block */
+  FAR uint8_t *data;                /* The mapped data area */
+  size_t maplen;                    /* Length of the mapping */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: shmring_create
+ *
+ * Description:
+ *   Create the named shared memory channel and map it.  A channel is a
+ *   byte ring with exactly one producer and one consumer, which may live
+ *   in different processes.  Data is written and read in place in the
+ *   shared pages, and a side only enters the kernel to sleep on, or to
+ *   wake, the other side.
+ *
+ * Input Parameters:
+ *   ring - The channel end to initialize
+ *   name - The name of the channel, as for shm_open()
+ *   size - The size of the data area; must be a power of two
+ *   mode - The permissions of the shared memory object
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -1 (ERROR) on failure with errno set.  EEXIST
+ *   is reported if the channel already exists.
+ *
+ ****************************************************************************/
+
+int shmring_create(FAR struct shmring_s *ring, FAR const char *name,
+                   size_t size, mode_t mode);
+
+/****************************************************************************
+ * Name: shmring_open
+ *
+ * Description:
+ *   Map an existing shared memory channel.
+ *
+ * Input Parameters:
+ *   ring - The channel end to initialize
+ *   name - The name of the channel
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -1 (ERROR) on failure with errno set.  EINVAL
+ *   is reported if the object is not a channel.
+ *
+ ****************************************************************************/
+
+int shmring_open(FAR struct shmring_s *ring, FAR const char *name);
+
+/****************************************************************************
+ * Name: shmring_close
+ *
+ * Description:
+ *   Unmap a channel end.  The channel lives on until it is unlinked with
+ *   shm_unlink() and both ends are closed.
+ *
+ ****************************************************************************/
+
+int shmring_close(FAR struct shmring_s *ring);
+
+/****************************************************************************
+ * Name: shmring_reserve
+ *
+ * Description:
+ *   Return the contiguous free space at the head of the ring, waiting for
+ *   at least one free byte.  The producer writes its data there and then
+ *   publishes it with shmring_commit().
+ *
+ * Input Parameters:
+ *   ring    - The producer end of the channel
+ *   buf     - Receives the address of the free space
+ *   timeout - The maximum relative time to wait, or NULL to wait forever
+ *
+ * Returned Value:
+ *   The number of contiguous free bytes; -1 (ERROR) on failure with errno
+ *   set, e.g. ETIMEDOUT or EINTR.
+ *
+ ****************************************************************************/
+
+ssize_t shmring_reserve(FAR struct shmring_s *ring, FAR void **buf,
+                        FAR const struct timespec *timeout);
+
+/****************************************************************************
+ * Name: shmring_commit
+ *
+ * Description:
+ *   Publish 'len' bytes written to the space returned by
+ *   shmring_reserve() and wake the consumer if it sleeps.
+ *
+ ****************************************************************************/
+
+void shmring_commit(FAR struct shmring_s *ring, size_t len);
+
+/****************************************************************************
+ * Name: shmring_peek
+ *
+ * Description:
+ *   Return the contiguous data at the tail of the ring, waiting for at
+ *   least one byte.  The consumer reads the data in place and then
+ *   releases it with shmring_consume().
+ *
+ * Input Parameters:
+ *   ring    - The consumer end of the channel
+ *   buf     - Receives the address of the data
+ *   timeout - The maximum relative time to wait, or NULL to wait forever
+ *
+ * Returned Value:
+ *   The number of contiguous bytes available; -1 (ERROR) on failure with
+ *   errno set, e.g. ETIMEDOUT or EINTR.
+ *
+ ****************************************************************************/
+
+ssize_t shmring_peek(FAR struct shmring_s *ring, FAR void **buf,
+                     FAR const struct timespec *timeout);
+
+/****************************************************************************
+ * Name: shmring_consume
+ *
+ * Description:
+ *   Release 'len' bytes returned by shmring_peek() and wake the producer
+ *   if it sleeps.
+ *
+ ****************************************************************************/
+
+void shmring_consume(FAR struct shmring_s *ring, size_t len);
+
+/****************************************************************************
+ * Name: shmring_send
+ *
+ * Description:
+ *   Copy 'len' bytes into the ring, waiting for space as needed.
+ *
+ * Returned Value:
+ *   The number of bytes sent, which is short only if a wait failed after
+ *   some data was sent; -1 (ERROR) on failure with errno set.
+ *
+ ****************************************************************************/
+
+ssize_t shmring_send(FAR struct shmring_s *ring, FAR const void *buf,
+                     size_t len, FAR const struct timespec *timeout);
+
+/****************************************************************************
+ * Name: shmring_recv
+ *
+ * Description:
+ *   Copy up to 'len' bytes out of the ring, waiting for at least one.
+ *
+ * Returned Value:
+ *   The number of bytes received; -1 (ERROR) on failure with errno set.
+ *
+ ****************************************************************************/
+
+ssize_t shmring_recv(FAR struct shmring_s *ring, FAR void *buf,
+                     size_t len, FAR const struct timespec *timeout);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_LIBC_SHMRING */
+#endif /* __INCLUDE_SYS_SHMRING_H */
@@ -131,6 +131,8 @@
 #define MSG_ERRQUEUE     0x002000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL     0x004000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE         0x008000 /* Sender will send more.  */
+#define MSG_WAITFORONE   0x010000 /* recvmmsg(): wait for the first only. */
+#define MSG_ZEROCOPY     0x020000 /* Send user data by reference.  */
 #define MSG_CMSG_CLOEXEC 0x100000 /* Set close_on_exit for file
                                    * descriptor received through SCM_RIGHTS.
                                    */
@@ -215,6 +217,17 @@
 #define SO_PEERCRED     18 /* Return the credentials of the peer process
                             * connected to this socket.
                             */
+#define SO_REUSEPORT    19 /* Allow sockets to bind the same local address
+                            * and port, the traffic is balanced among them
+                            * (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
+#define SO_ZEROCOPY     20 /* Allow MSG_ZEROCOPY sends, the completions are
+                            * read from the error queue (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
 
 /* The options are unsupported but included for compatibility
  * and portability
@@ -229,6 +242,7 @@
 #define SOL_IPV6        IPPROTO_IPV6 /* See options in include/netinet/ip6.h */
 #define SOL_TCP         IPPROTO_TCP  /* See options in include/netinet/tcp.h */
 #define SOL_UDP         IPPROTO_UDP  /* See options in include/netinit/udp.h */
+#define SOL_PACKET      263          /* See include/netpacket/packet.h */
 
 /* Bluetooth-level operations. */
 
@@ -348,6 +362,14 @@ struct msghdr
   unsigned int msg_flags;
 };
 
+/* An entry of the message vector of recvmmsg()/sendmmsg() */
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;        /* The message */
+  unsigned int msg_len;         /* Number of bytes transferred */
+};
+
 struct cmsghdr
 {
   unsigned long cmsg_len;       /* Data byte count, including hdr */
@@ -435,6 +457,12 @@ int getpeername(int sockfd, FAR struct sockaddr *addr,
 ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags);
 
+struct timespec; /* Forward reference */
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 #if CONFIG_FORTIFY_SOURCE > 0
 fortify_function(send) ssize_t send(int sockfd, FAR const void *buf,
                                     size_t len, int flags)
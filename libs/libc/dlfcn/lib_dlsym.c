@@ -84,8 +84,17 @@ static inline FAR const void *dlgetsym(FAR void *handle,
 
   /* Search the symbol table for the matching symbol */
 
-  symbol = symtab_findbyname(modp->modinfo.exports, name,
-                             modp->modinfo.nexports);
+  if (modp->exphash != NULL)
+    {
+      symbol = symtab_findbyhash(modp->modinfo.exports, modp->exphash,
+                                 name, modp->modinfo.nexports);
+    }
+  else
+    {
+      symbol = symtab_findbyname(modp->modinfo.exports, name,
+                                 modp->modinfo.nexports);
+    }
+
   if (symbol == NULL)
     {
       serr("ERROR: Failed to find symbol in symbol \"%s\" in table\n", name);
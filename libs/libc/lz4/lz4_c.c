@@ -0,0 +1,193 @@
+/****************************************************************************
+ * libs/libc/lz4/lz4_c.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <lz4.h>
+
+#ifdef CONFIG_LIBC_LZ4
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LZ4_HASH(p) ((lz4_get32(p) * 2654435761u) >> (32 - LZ4_HLOG))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline uint32_t lz4_get32(FAR const uint8_t *ptr)
+{
+  return (uint32_t)ptr[0] | (uint32_t)ptr[1] << 8 |
+         (uint32_t)ptr[2] << 16 | (uint32_t)ptr[3] << 24;
+}
+
+/****************************************************************************
+ * Name: lz4_sequence
+ *
+ * Description:
+ *   Append one sequence to the output: the token, the literal run and, if
+ *   matchlen is not zero, the match offset and length.  Return false if it
+ *   does not fit.
+ *
+ ****************************************************************************/
+
+static bool lz4_sequence(FAR uint8_t **outptr, FAR const uint8_t *outend,
+                         FAR const uint8_t *literals, size_t litlen,
+                         unsigned int offset, size_t matchlen)
+{
+  FAR uint8_t *op = *outptr;
+  FAR uint8_t *token;
+  size_t len;
+
+  /* Worst case: token, literal run, offset and the length extensions */
+
+  if ((size_t)(outend - op) < 1 + litlen + litlen / 255 + 1 + 2 +
+                              matchlen / 255 + 1)
+    {
+      return false;
+    }
+
+  token = op++;
+  if (litlen >= 15)
+    {
+      *token = 15 << 4;
+      for (len = litlen - 15; len >= 255; len -= 255)
+        {
+          *op++ = 255;
+        }
+
+      *op++ = len;
+    }
+  else
+    {
+      *token = litlen << 4;
+    }
+
+  memcpy(op, literals, litlen);
+  op += litlen;
+
+  /* A sequence without a match ends the block */
+
+  if (matchlen > 0)
+    {
+      *op++ = offset & 0xff;
+      *op++ = offset >> 8;
+
+      len = matchlen - LZ4_MIN_MATCH;
+      if (len >= 15)
+        {
+          *token |= 15;
+          for (len -= 15; len >= 255; len -= 255)
+            {
+              *op++ = 255;
+            }
+
+          *op++ = len;
+        }
+      else
+        {
+          *token |= len;
+        }
+    }
+
+  *outptr = op;
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_compress
+ ****************************************************************************/
+
+unsigned int lz4_compress(FAR const void *in_data, unsigned int in_len,
+                          FAR void *out_data, unsigned int out_len,
+                          lz4_state_t htab)
+{
+  FAR const uint8_t *const in     = in_data;
+  FAR const uint8_t *const in_end = in + in_len;
+  FAR const uint8_t *ip           = in;
+  FAR const uint8_t *anchor       = in;
+  FAR uint8_t       *op           = out_data;
+  FAR uint8_t       *const op_end = op + out_len;
+  FAR const uint8_t *ref;
+  unsigned int hval;
+  size_t matchlen;
+
+  /* Greedy match search, the entries are offsets in the block plus one */
+
+  memset(htab, 0, sizeof(lz4_state_t));
+
+  if (in_len >= LZ4_MF_LIMIT)
+    {
+      while (ip <= in_end - LZ4_MF_LIMIT)
+        {
+          hval       = LZ4_HASH(ip);
+          ref        = htab[hval] > 0 ? in + htab[hval] - 1 : NULL;
+          htab[hval] = ip - in + 1;
+
+          if (ref == NULL || ip - ref > LZ4_MAX_DISTANCE ||
+              memcmp(ref, ip, LZ4_MIN_MATCH) != 0)
+            {
+              ip++;
+              continue;
+            }
+
+          /* The match must end before the last literals */
+
+          matchlen = LZ4_MIN_MATCH;
+          while (ip + matchlen < in_end - LZ4_LAST_LITERALS &&
+                 ref[matchlen] == ip[matchlen])
+            {
+              matchlen++;
+            }
+
+          if (!lz4_sequence(&op, op_end, anchor, ip - anchor, ip - ref,
+                            matchlen))
+            {
+              return 0;
+            }
+
+          ip    += matchlen;
+          anchor = ip;
+        }
+    }
+
+  /* The remaining bytes are the literals of the last sequence */
+
+  if (!lz4_sequence(&op, op_end, anchor, in_end - anchor, 0, 0))
+    {
+      return 0;
+    }
+
+  return op - (FAR uint8_t *)out_data;
+}
+
+#endif /* CONFIG_LIBC_LZ4 */
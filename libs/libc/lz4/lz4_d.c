@@ -0,0 +1,176 @@
+/****************************************************************************
+ * libs/libc/lz4/lz4_d.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <errno.h>
+#include <string.h>
+#include <lz4.h>
+
+#ifdef CONFIG_LIBC_LZ4
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_getlength
+ *
+ * Description:
+ *   Add the length extension bytes that follow a token nibble of 15.  Each
+ *   byte adds its value, and a byte of 255 means that another follows.
+ *
+ ****************************************************************************/
+
+static bool lz4_getlength(FAR const uint8_t **ip,
+                          FAR const uint8_t *in_end,
+                          FAR unsigned int *length)
+{
+  uint8_t byte;
+
+  do
+    {
+      if (*ip >= in_end)
+        {
+          return false;
+        }
+
+      byte     = *(*ip)++;
+      *length += byte;
+    }
+  while (byte == 255);
+
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4_decompress
+ ****************************************************************************/
+
+unsigned int lz4_decompress(FAR const void *in_data, unsigned int in_len,
+                            FAR void *out_data, unsigned int out_len)
+{
+  FAR const uint8_t *ip            = in_data;
+  FAR const uint8_t *const in_end  = ip + in_len;
+  FAR uint8_t       *const out     = out_data;
+  FAR uint8_t       *const out_end = out + out_len;
+  FAR uint8_t       *op            = out;
+  FAR const uint8_t *ref;
+  unsigned int length;
+  unsigned int offset;
+  uint8_t token;
+
+  while (ip < in_end)
+    {
+      /* Literals */
+
+      token  = *ip++;
+      length = token >> 4;
+      if (length == 15 && !lz4_getlength(&ip, in_end, &length))
+        {
+          goto errout_inval;
+        }
+
+      if (length > (unsigned int)(in_end - ip))
+        {
+          goto errout_inval;
+        }
+
+      if (length > (unsigned int)(out_end - op))
+        {
+          set_errno(E2BIG);
+          return 0;
+        }
+
+      memcpy(op, ip, length);
+      op += length;
+      ip += length;
+
+      /* The last sequence has no match */
+
+      if (ip >= in_end)
+        {
+          break;
+        }
+
+      /* Match */
+
+      if (in_end - ip < 2)
+        {
+          goto errout_inval;
+        }
+
+      offset = ip[0] | ((unsigned int)ip[1] << 8);
+      ip    += 2;
+
+      if (offset == 0 || offset > (unsigned int)(op - out))
+        {
+          goto errout_inval;
+        }
+
+      length = token & 15;
+      if (length == 15 && !lz4_getlength(&ip, in_end, &length))
+        {
+          goto errout_inval;
+        }
+
+      length += LZ4_MIN_MATCH;
+      if (length > (unsigned int)(out_end - op))
+        {
+          set_errno(E2BIG);
+          return 0;
+        }
+
+      /* The match may overlap the output, copy it a byte at a time unless
+       * it is far enough behind.
+       */
+
+      ref = op - offset;
+      if (offset >= length)
+        {
+          memcpy(op, ref, length);
+          op += length;
+        }
+      else
+        {
+          while (length-- > 0)
+            {
+              *op++ = *ref++;
+            }
+        }
+    }
+
+  return op - out;
+
+errout_inval:
+  set_errno(EINVAL);
+  return 0;
+}
+
+#endif /* CONFIG_LIBC_LZ4 */
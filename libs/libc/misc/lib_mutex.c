@@ -24,9 +24,11 @@
 
 #include <errno.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/sched.h>
 #include <nuttx/clock.h>
 #include <nuttx/mutex.h>
+#include <nuttx/lockstat.h>
 #include <nuttx/semaphore.h>
 
 /****************************************************************************
@@ -35,6 +37,13 @@
 
 #define NXMUTEX_RESET          ((pid_t)-2)
 
+/* Lock statistics are collected by the kernel only */
+
+#if defined(CONFIG_SCHED_LOCKSTAT) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define NXMUTEX_LOCKSTAT 1
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -195,6 +204,10 @@ bool nxmutex_is_locked(FAR mutex_t *mutex)
 int nxmutex_lock(FAR mutex_t *mutex)
 {
   int ret;
+#ifdef NXMUTEX_LOCKSTAT
+  unsigned long start = up_perf_gettime();
+  bool contended = nxmutex_is_locked(mutex);
+#endif
 
   DEBUGASSERT(!nxmutex_is_hold(mutex));
   for (; ; )
@@ -205,6 +218,10 @@ int nxmutex_lock(FAR mutex_t *mutex)
       if (ret >= 0)
         {
           mutex->holder = _SCHED_GETTID();
+#ifdef NXMUTEX_LOCKSTAT
+          lockstat_acquire(mutex, LOCKSTAT_MUTEX, LOCKSTAT_CALLER(),
+                           start, contended);
+#endif
           break;
         }
       else if (ret != -EINTR && ret != -ECANCELED)
@@ -249,6 +266,10 @@ int nxmutex_trylock(FAR mutex_t *mutex)
     }
 
   mutex->holder = _SCHED_GETTID();
+#ifdef NXMUTEX_LOCKSTAT
+  lockstat_acquire(mutex, LOCKSTAT_MUTEX, LOCKSTAT_CALLER(),
+                   up_perf_gettime(), false);
+#endif
   return ret;
 }
 
@@ -282,6 +303,10 @@ int nxmutex_timedlock(FAR mutex_t *mutex, unsigned int timeout)
   struct timespec now;
   struct timespec delay;
   struct timespec rqtp;
+#ifdef NXMUTEX_LOCKSTAT
+  unsigned long start = up_perf_gettime();
+  bool contended = nxmutex_is_locked(mutex);
+#endif
 
   clock_gettime(CLOCK_MONOTONIC, &now);
   clock_ticks2time(MSEC2TICK(timeout), &delay);
@@ -302,6 +327,10 @@ int nxmutex_timedlock(FAR mutex_t *mutex, unsigned int timeout)
   if (ret >= 0)
     {
       mutex->holder = _SCHED_GETTID();
+#ifdef NXMUTEX_LOCKSTAT
+      lockstat_acquire(mutex, LOCKSTAT_MUTEX, LOCKSTAT_CALLER(),
+                       start, contended);
+#endif
     }
 
   return ret;
@@ -338,6 +367,10 @@ int nxmutex_unlock(FAR mutex_t *mutex)
 
   DEBUGASSERT(nxmutex_is_hold(mutex));
 
+#ifdef NXMUTEX_LOCKSTAT
+  lockstat_release(mutex);
+#endif
+
   mutex->holder = NXMUTEX_NO_HOLDER;
 
   ret = _SEM_POST(&mutex->sem);
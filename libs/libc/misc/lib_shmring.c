@@ -0,0 +1,446 @@
+/****************************************************************************
+ * libs/libc/misc/lib_shmring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/futex.h>
+#include <sys/mman.h>
+#include <sys/shmring.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <nuttx/clock.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SHMRING_MAGIC    0x53524e47
+
+/* The data area starts on its own cache line */
+
+#define SHMRING_CTRLSIZE 64
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: shmring_deadline
+ *
+ * Description:
+ *   Convert a relative timeout to a deadline on the monotonic clock.
+ *
+ ****************************************************************************/
+
+static FAR const struct timespec *
+shmring_deadline(FAR const struct timespec *timeout,
+                 FAR struct timespec *deadline)
+{
+  struct timespec now;
+
+  if (timeout == NULL)
+    {
+      return NULL;
+    }
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  clock_timespec_add(&now, timeout, deadline);
+  return deadline;
+}
+
+/****************************************************************************
+ * Name: shmring_wait
+ *
+ * Description:
+ *   Sleep until the futex word '*word' no longer holds 'val', the deadline
+ *   passes or a signal is received.  The caller has already raised its
+ *   wait flag, so that the other side wakes us after changing the word.
+ *
+ ****************************************************************************/
+
+static int shmring_wait(FAR volatile uint32_t *word, uint32_t val,
+                        FAR const struct timespec *deadline)
+{
+  struct timespec remain;
+  struct timespec now;
+
+  if (deadline != NULL)
+    {
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      clock_timespec_subtract(deadline, &now, &remain);
+      if (remain.tv_sec == 0 && remain.tv_nsec == 0)
+        {
+          set_errno(ETIMEDOUT);
+          return ERROR;
+        }
+    }
+
+  if (futex_wait(word, val, deadline != NULL ? &remain : NULL) < 0 &&
+      get_errno() != EAGAIN)
+    {
+      return ERROR;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: shmring_space
+ *
+ * Description:
+ *   Return the contiguous free space at the head of the ring.
+ *
+ ****************************************************************************/
+
+static size_t shmring_space(FAR struct shmring_s *ring, FAR void **buf)
+{
+  FAR struct shmring_ctrl_s *ctrl = ring->ctrl;
+  uint32_t head = ctrl->head;
+  uint32_t tail = __atomic_load_n(&ctrl->tail, __ATOMIC_ACQUIRE);
+  uint32_t off = head & (ctrl->size - 1);
+  size_t len = ctrl->size - (head - tail);
+
+  if (len > ctrl->size - off)
+    {
+      len = ctrl->size - off;
+    }
+
+  *buf = ring->data + off;
+  return len;
+}
+
+/****************************************************************************
+ * Name: shmring_data
+ *
+ * Description:
+ *   Return the contiguous data at the tail of the ring.
+ *
+ ****************************************************************************/
+
+static size_t shmring_data(FAR struct shmring_s *ring, FAR void **buf)
+{
+  FAR struct shmring_ctrl_s *ctrl = ring->ctrl;
+  uint32_t tail = ctrl->tail;
+  uint32_t head = __atomic_load_n(&ctrl->head, __ATOMIC_ACQUIRE);
+  uint32_t off = tail & (ctrl->size - 1);
+  size_t len = head - tail;
+
+  if (len > ctrl->size - off)
+    {
+      len = ctrl->size - off;
+    }
+
+  *buf = ring->data + off;
+  return len;
+}
+
+/****************************************************************************
+ * Name: shmring_map
+ *
+ * Description:
+ *   Map the shared memory object 'fd' of 'len' bytes.
+ *
+ ****************************************************************************/
+
+static int shmring_map(FAR struct shmring_s *ring, int fd, size_t len)
+{
+  FAR void *addr;
+
+  addr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED)
+    {
+      return ERROR;
+    }
+
+  ring->ctrl   = addr;
+  ring->data   = (FAR uint8_t *)addr + SHMRING_CTRLSIZE;
+  ring->maplen = len;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int shmring_create(FAR struct shmring_s *ring, FAR const char *name,
+                   size_t size, mode_t mode)
+{
+  FAR struct shmring_ctrl_s *ctrl;
+  size_t len = SHMRING_CTRLSIZE + size;
+  int ret;
+  int fd;
+
+  if (size == 0 || size > 0x80000000 || (size & (size - 1)) != 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, mode);
+  if (fd < 0)
+    {
+      return ERROR;
+    }
+
+  ret = ftruncate(fd, len);
+  if (ret >= 0)
+    {
+      ret = shmring_map(ring, fd, len);
+    }
+
+  close(fd);
+
+  if (ret < 0)
+    {
+      int errcode = get_errno();
+
+      shm_unlink(name);
+      set_errno(errcode);
+      return ERROR;
+    }
+
+  ctrl        = ring->ctrl;
+  ctrl->size  = size;
+  ctrl->head  = 0;
+  ctrl->tail  = 0;
+  ctrl->rwait = 0;
+  ctrl->wwait = 0;
+
+  /* The other end checks the magic before it trusts the rest */
+
+  __atomic_store_n(&ctrl->magic, SHMRING_MAGIC, __ATOMIC_RELEASE);
+  return OK;
+}
+
+int shmring_open(FAR struct shmring_s *ring, FAR const char *name)
+{
+  FAR struct shmring_ctrl_s *ctrl;
+  struct stat st;
+  int ret;
+  int fd;
+
+  fd = shm_open(name, O_RDWR, 0);
+  if (fd < 0)
+    {
+      return ERROR;
+    }
+
+  ret = fstat(fd, &st);
+  if (ret >= 0 && st.st_size <= SHMRING_CTRLSIZE)
+    {
+      set_errno(EINVAL);
+      ret = ERROR;
+    }
+
+  if (ret >= 0)
+    {
+      ret = shmring_map(ring, fd, st.st_size);
+    }
+
+  close(fd);
+
+  if (ret < 0)
+    {
+      return ERROR;
+    }
+
+  ctrl = ring->ctrl;
+  if (__atomic_load_n(&ctrl->magic, __ATOMIC_ACQUIRE) != SHMRING_MAGIC ||
+      SHMRING_CTRLSIZE + (off_t)ctrl->size != st.st_size)
+    {
+      munmap(ring->ctrl, ring->maplen);
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  return OK;
+}
+
+int shmring_close(FAR struct shmring_s *ring)
+{
+  return munmap(ring->ctrl, ring->maplen);
+}
+
+ssize_t shmring_reserve(FAR struct shmring_s *ring, FAR void **buf,
+                        FAR const struct timespec *timeout)
+{
+  FAR struct shmring_ctrl_s *ctrl = ring->ctrl;
+  FAR const struct timespec *deadline = NULL;
+  struct timespec abstime;
+  uint32_t tail;
+  size_t len;
+
+  while ((len = shmring_space(ring, buf)) == 0)
+    {
+      /* Announce the sleep before the last look at the tail.  The
+       * consumer advances the tail before it looks at the flag, so either
+       * we see the new tail or it sees the flag.
+       */
+
+      tail = __atomic_load_n(&ctrl->tail, __ATOMIC_RELAXED);
+      __atomic_store_n(&ctrl->wwait, 1, __ATOMIC_SEQ_CST);
+      if (__atomic_load_n(&ctrl->tail, __ATOMIC_SEQ_CST) != tail)
+        {
+          continue;
+        }
+
+      if (deadline == NULL)
+        {
+          deadline = shmring_deadline(timeout, &abstime);
+        }
+
+      if (shmring_wait(&ctrl->tail, tail, deadline) < 0)
+        {
+          return ERROR;
+        }
+    }
+
+  return len;
+}
+
+void shmring_commit(FAR struct shmring_s *ring, size_t len)
+{
+  FAR struct shmring_ctrl_s *ctrl = ring->ctrl;
+
+  __atomic_store_n(&ctrl->head, ctrl->head + len, __ATOMIC_SEQ_CST);
+  if (__atomic_exchange_n(&ctrl->rwait, 0, __ATOMIC_SEQ_CST) != 0)
+    {
+      futex_wake(&ctrl->head, 1);
+    }
+}
+
+ssize_t shmring_peek(FAR struct shmring_s *ring, FAR void **buf,
+                     FAR const struct timespec *timeout)
+{
+  FAR struct shmring_ctrl_s *ctrl = ring->ctrl;
+  FAR const struct timespec *deadline = NULL;
+  struct timespec abstime;
+  uint32_t head;
+  size_t len;
+
+  while ((len = shmring_data(ring, buf)) == 0)
+    {
+      /* The mirror image of shmring_reserve() */
+
+      head = __atomic_load_n(&ctrl->head, __ATOMIC_RELAXED);
+      __atomic_store_n(&ctrl->rwait, 1, __ATOMIC_SEQ_CST);
+      if (__atomic_load_n(&ctrl->head, __ATOMIC_SEQ_CST) != head)
+        {
+          continue;
+        }
+
+      if (deadline == NULL)
+        {
+          deadline = shmring_deadline(timeout, &abstime);
+        }
+
+      if (shmring_wait(&ctrl->head, head, deadline) < 0)
+        {
+          return ERROR;
+        }
+    }
+
+  return len;
+}
+
+void shmring_consume(FAR struct shmring_s *ring, size_t len)
+{
+  FAR struct shmring_ctrl_s *ctrl = ring->ctrl;
+
+  __atomic_store_n(&ctrl->tail, ctrl->tail + len, __ATOMIC_SEQ_CST);
+  if (__atomic_exchange_n(&ctrl->wwait, 0, __ATOMIC_SEQ_CST) != 0)
+    {
+      futex_wake(&ctrl->tail, 1);
+    }
+}
+
+ssize_t shmring_send(FAR struct shmring_s *ring, FAR const void *buf,
+                     size_t len, FAR const struct timespec *timeout)
+{
+  FAR const uint8_t *src = buf;
+  FAR void *dest;
+  size_t sent = 0;
+  ssize_t n;
+
+  while (sent < len)
+    {
+      n = shmring_reserve(ring, &dest, timeout);
+      if (n < 0)
+        {
+          return sent > 0 ? sent : ERROR;
+        }
+
+      if ((size_t)n > len - sent)
+        {
+          n = len - sent;
+        }
+
+      memcpy(dest, src + sent, n);
+      shmring_commit(ring, n);
+      sent += n;
+    }
+
+  return sent;
+}
+
+ssize_t shmring_recv(FAR struct shmring_s *ring, FAR void *buf,
+                     size_t len, FAR const struct timespec *timeout)
+{
+  FAR uint8_t *dest = buf;
+  FAR void *src;
+  size_t recvd = 0;
+  size_t n;
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  /* Wait for the first byte only, then take what is there, which may be
+   * split in two by the end of the ring.
+   */
+
+  if (shmring_peek(ring, &src, timeout) < 0)
+    {
+      return ERROR;
+    }
+
+  while (recvd < len && (n = shmring_data(ring, &src)) > 0)
+    {
+      if (n > len - recvd)
+        {
+          n = len - recvd;
+        }
+
+      memcpy(dest + recvd, src, n);
+      shmring_consume(ring, n);
+      recvd += n;
+    }
+
+  return recvd;
+}
@@ -24,9 +24,11 @@
 
 #include <nuttx/config.h>
 
+#include <sys/ioctl.h>
 #include <sys/param.h>
 #include <sys/types.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -35,6 +37,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/lib/modlib.h>
 
 #include "libc.h"
@@ -56,6 +59,54 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: modlib_xipsection
+ *
+ * Description:
+ *   Return true if section 'index' can be used in place in the memory
+ *   mapped file instead of being copied to RAM.  That is the case for a
+ *   read-only section with data in the file, to which no relocation
+ *   applies and whose address in the file meets its alignment.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MODLIB_XIP
+static bool modlib_xipsection(FAR struct mod_loadinfo_s *loadinfo,
+                              int index)
+{
+  FAR Elf_Shdr *shdr = &loadinfo->shdr[index];
+  int i;
+
+  if (loadinfo->xipbase == 0 || loadinfo->ehdr.e_phnum > 0 ||
+      (shdr->sh_flags & (SHF_ALLOC | SHF_WRITE)) != SHF_ALLOC ||
+      shdr->sh_type == SHT_NOBITS)
+    {
+      return false;
+    }
+
+  if (shdr->sh_addralign > 1 &&
+      ((loadinfo->xipbase + shdr->sh_offset) &
+       (shdr->sh_addralign - 1)) != 0)
+    {
+      return false;
+    }
+
+  for (i = 0; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      if ((loadinfo->shdr[i].sh_type == SHT_REL ||
+           loadinfo->shdr[i].sh_type == SHT_RELA) &&
+          loadinfo->shdr[i].sh_info == index)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#else
+#  define modlib_xipsection(l, i) false
+#endif
+
 /****************************************************************************
  * Name: modlib_elfsize
  *
@@ -110,7 +161,8 @@ static void modlib_elfsize(FAR struct mod_loadinfo_s *loadinfo)
            * execution.
            */
 
-          if ((shdr->sh_flags & SHF_ALLOC) != 0)
+          if ((shdr->sh_flags & SHF_ALLOC) != 0 &&
+              !modlib_xipsection(loadinfo, i))
             {
               /* SHF_WRITE indicates that the section address space is write-
                * able
@@ -214,6 +266,20 @@ static inline int modlib_loadfile(FAR struct mod_loadinfo_s *loadinfo)
               continue;
             }
 
+#ifdef CONFIG_MODLIB_XIP
+          /* A section executed in place is used where it is in the file */
+
+          if (modlib_xipsection(loadinfo, i))
+            {
+              binfo("%d. %08lx->%08lx (XIP)\n", i,
+                    (unsigned long)shdr->sh_addr,
+                    (unsigned long)(loadinfo->xipbase + shdr->sh_offset));
+
+              shdr->sh_addr = loadinfo->xipbase + shdr->sh_offset;
+              continue;
+            }
+#endif
+
           /* SHF_WRITE indicates that the section address space is write-
            * able
            */
@@ -305,6 +371,16 @@ int modlib_load(FAR struct mod_loadinfo_s *loadinfo)
       goto errout_with_buffers;
     }
 
+#ifdef CONFIG_MODLIB_XIP
+  /* Find out whether the file is mapped into memory */
+
+  if (ioctl(loadinfo->filfd, FIOC_XIPBASE,
+            (unsigned long)((uintptr_t)&loadinfo->xipbase)) < 0)
+    {
+      loadinfo->xipbase = 0;
+    }
+#endif
+
   /* Determine total size to allocate */
 
   modlib_elfsize(loadinfo);
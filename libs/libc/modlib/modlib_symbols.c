@@ -202,9 +202,19 @@ static int modlib_symcallback(FAR struct module_s *modp, FAR void *arg)
 
   /* Check if this module exports a symbol of that name */
 
-  exportinfo->symbol = symtab_findbyname(modp->modinfo.exports,
-                                         exportinfo->name,
-                                         modp->modinfo.nexports);
+  if (modp->exphash != NULL)
+    {
+      exportinfo->symbol = symtab_findbyhash(modp->modinfo.exports,
+                                             modp->exphash,
+                                             exportinfo->name,
+                                             modp->modinfo.nexports);
+    }
+  else
+    {
+      exportinfo->symbol = symtab_findbyname(modp->modinfo.exports,
+                                             exportinfo->name,
+                                             modp->modinfo.nexports);
+    }
 
   if (exportinfo->symbol != NULL)
     {
@@ -339,7 +349,6 @@ int modlib_symvalue(FAR struct module_s *modp,
   FAR const struct symtab_s *symbol;
   struct mod_exportinfo_s exportinfo;
   uintptr_t secbase;
-  int nsymbols;
   int ret;
 
   switch (sym->st_shndx)
@@ -403,9 +412,7 @@ int modlib_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
-            modlib_getsymtab(&symbol, &nsymbols);
-            symbol = symtab_findbyname(symbol, exportinfo.name,
-                                       nsymbols);
+            symbol = modlib_findsymbol(exportinfo.name);
           }
 
         /* Was the symbol found from any exporter? */
@@ -524,6 +531,12 @@ int modlib_insertsymtab(FAR struct module_s *modp,
                   j++;
                 }
             }
+
+          /* Index the table for modules that link against this one.
+           * Without the index the table is searched linearly.
+           */
+
+          modp->exphash = symtab_buildhash(symbol, symcount);
         }
       else
         {
@@ -617,5 +630,12 @@ void modlib_freesymtab(FAR struct module_s *modp)
         }
 
       lib_free((FAR void *)symbol);
+      modp->modinfo.exports = NULL;
+    }
+
+  if (modp->exphash != NULL)
+    {
+      lib_free(modp->exphash);
+      modp->exphash = NULL;
     }
 }
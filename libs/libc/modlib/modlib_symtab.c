@@ -46,6 +46,12 @@
 #  ifndef CONFIG_MODLIB_NSYMBOLS_VAR
 #    error "CONFIG_MODLIB_NSYMBOLS_VAR must be defined"
 #  endif
+
+  /* Hash index of the table, as named by 'mksymtab -h' */
+
+#  define MODLIB_CONCAT_(a, b) a##b
+#  define MODLIB_CONCAT(a, b)  MODLIB_CONCAT_(a, b)
+#  define MODLIB_SYMTAB_HASH   MODLIB_CONCAT(CONFIG_MODLIB_SYMTAB_ARRAY, _hash)
 #endif
 
 /****************************************************************************
@@ -55,6 +61,9 @@
 #ifdef CONFIG_MODLIB_HAVE_SYMTAB
 extern const struct symtab_s CONFIG_MODLIB_SYMTAB_ARRAY[];
 extern int CONFIG_MODLIB_NSYMBOLS_VAR;
+#  ifdef CONFIG_MODLIB_SYMTAB_HASH
+extern const struct symtab_hash_s MODLIB_SYMTAB_HASH;
+#  endif
 #endif
 
 /****************************************************************************
@@ -63,6 +72,34 @@ extern int CONFIG_MODLIB_NSYMBOLS_VAR;
 
 static FAR const struct symtab_s *g_modlib_symtab;
 static FAR int g_modlib_nsymbols;
+static FAR const struct symtab_hash_s *g_modlib_symhash;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: modlib_defaultsymtab
+ *
+ * Description:
+ *   Select the configured symbol table if none was selected.  Called with
+ *   the registry lock held.
+ *
+ ****************************************************************************/
+
+static void modlib_defaultsymtab(void)
+{
+#ifdef CONFIG_MODLIB_HAVE_SYMTAB
+  if (g_modlib_symtab == NULL)
+    {
+      g_modlib_symtab = CONFIG_MODLIB_SYMTAB_ARRAY;
+      g_modlib_nsymbols = CONFIG_MODLIB_NSYMBOLS_VAR;
+#  ifdef CONFIG_MODLIB_SYMTAB_HASH
+      g_modlib_symhash = &MODLIB_SYMTAB_HASH;
+#  endif
+    }
+#endif
+}
 
 /****************************************************************************
  * Public Functions
@@ -91,19 +128,50 @@ void modlib_getsymtab(FAR const struct symtab_s **symtab, FAR int *nsymbols)
   /* Borrow the registry lock to assure atomic access */
 
   modlib_registry_lock();
-#ifdef CONFIG_MODLIB_HAVE_SYMTAB
-  if (g_modlib_symtab == NULL)
-    {
-      g_modlib_symtab = CONFIG_MODLIB_SYMTAB_ARRAY;
-      g_modlib_nsymbols = CONFIG_MODLIB_NSYMBOLS_VAR;
-    }
-#endif
+  modlib_defaultsymtab();
 
   *symtab   = g_modlib_symtab;
   *nsymbols = g_modlib_nsymbols;
   modlib_registry_unlock();
 }
 
+/****************************************************************************
+ * Name: modlib_findsymbol
+ *
+ * Description:
+ *   Find a symbol by name in the current symbol table selection.  The hash
+ *   index of the table is used if there is one.
+ *
+ * Input Parameters:
+ *   name - The name of the symbol
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry; NULL if there is none.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *modlib_findsymbol(FAR const char *name)
+{
+  FAR const struct symtab_hash_s *hash;
+  FAR const struct symtab_s *symtab;
+  int nsymbols;
+
+  modlib_registry_lock();
+  modlib_defaultsymtab();
+
+  symtab   = g_modlib_symtab;
+  nsymbols = g_modlib_nsymbols;
+  hash     = g_modlib_symhash;
+  modlib_registry_unlock();
+
+  if (hash != NULL)
+    {
+      return symtab_findbyhash(symtab, hash, name, nsymbols);
+    }
+
+  return symtab_findbyname(symtab, name, nsymbols);
+}
+
 /****************************************************************************
  * Name: modlib_setsymtab
  *
@@ -126,5 +194,6 @@ void modlib_setsymtab(FAR const struct symtab_s *symtab, int nsymbols)
   modlib_registry_lock();
   g_modlib_symtab   = symtab;
   g_modlib_nsymbols = nsymbols;
+  g_modlib_symhash  = NULL;
   modlib_registry_unlock();
 }
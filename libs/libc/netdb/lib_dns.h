@@ -76,6 +76,14 @@
 #  define CONFIG_NETDB_DNSCLIENT_LIFESEC 3600
 #endif
 
+#ifndef CONFIG_NETDB_DNSCLIENT_NEGLIFESEC
+#  define CONFIG_NETDB_DNSCLIENT_NEGLIFESEC 60
+#endif
+
+#ifndef CONFIG_NETDB_DNSCLIENT_NSERVERS
+#  define CONFIG_NETDB_DNSCLIENT_NSERVERS 3
+#endif
+
 #ifndef CONFIG_NETDB_RESOLVCONF_PATH
 #  define CONFIG_NETDB_RESOLVCONF_PATH "/etc/resolv.conf"
 #endif
@@ -193,8 +201,10 @@ int dns_bind(sa_family_t family);
  * Name: dns_query
  *
  * Description:
- *   Using the DNS resolver socket (sd), look up the 'hostname', and
- *   return its IP address in 'ipaddr'
+ *   Look up the 'hostname' on the configured name servers, and return its
+ *   IP addresses in 'addr'.  The queries for the IPv6 and IPv4 addresses
+ *   are sent together to up to CONFIG_NETDB_DNSCLIENT_NSERVERS servers
+ *   at a time; the first server to answer wins.
  *
  * Input Parameters:
  *   hostname - The hostname string to be resolved.
@@ -205,7 +215,8 @@ int dns_bind(sa_family_t family);
  *     the returned addresses.
  *
  * Returned Value:
- *   Returns zero (OK) if the query was successful.
+ *   Returns zero (OK) if the query was successful.  -EADDRNOTAVAIL is
+ *   returned if the servers answered that the name has no address.
  *
  ****************************************************************************/
 
@@ -221,7 +232,7 @@ int dns_query(FAR const char *hostname, FAR union dns_addr_u *addr,
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses, zero if the name has none.
  *   ttl      - The TTL of the IP addresses.
  *
  * Returned Value:
@@ -267,8 +278,9 @@ void dns_clear_answer(void);
  * Returned Value:
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
- *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   value will be returned: -ENOENT meaning that the hostname was not
+ *   found in the cache, or -EADDRNOTAVAIL meaning that the cache holds
+ *   the answer that the hostname has no address.
  *
  ****************************************************************************/
 
@@ -25,6 +25,7 @@
 #include <nuttx/config.h>
 
 #include <sys/time.h>
+#include <stdint.h>
 #include <string.h>
 #include <time.h>
 #include <assert.h>
@@ -35,11 +36,24 @@
 
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
+#  define DNS_MAX_LIFESEC     CONFIG_NETDB_DNSCLIENT_LIFESEC
+#else
+#  define DNS_MAX_LIFESEC     UINT32_MAX
+#endif
+
+#define DNS_NBUCKETS          CONFIG_NETDB_DNSCLIENT_ENTRIES
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* This described one entry in the cache of resolved hostnames.
+/* This described one entry in the cache of resolved hostnames.  The
+ * entries are chained by the hash of the hostname.
  *
  * REVISIT: this consumes extra space, especially when multiple
  * addresses per name are stored.
@@ -47,21 +61,23 @@
 
 struct dns_cache_s
 {
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  time_t            ctime;      /* Creation time */
-#endif
+  uint32_t          hash;       /* Hash of the hostname */
+  uint32_t          ctime;      /* Creation time */
+  uint32_t          lifetime;   /* Seconds after ctime that it is valid */
+  uint8_t           next;       /* Next entry in the hash chain + 1 */
+  uint8_t           naddr;      /* How many addresses, 0 if there are none */
+  bool              used;       /* The entry holds an answer */
   char              name[CONFIG_NETDB_DNSCLIENT_NAMESIZE];
-  uint8_t           naddr;      /* How many addresses per name */
   union dns_addr_u  addr[CONFIG_NETDB_MAX_IPADDR];
-  uint32_t          ttl;
 };
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-static uint8_t g_dns_head;        /* Head of the circular, DNS resolver cache */
-static uint8_t g_dns_tail;        /* Tail of the circular, DNS resolver cache */
+/* The first entry + 1 of each hash chain, 0 if the chain is empty */
+
+static uint8_t g_dns_buckets[DNS_NBUCKETS];
 
 /* This is the DNS resolver cache */
 
@@ -71,6 +87,110 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: dns_hash
+ *
+ * Description:
+ *   Return the FNV-1a hash of the whole hostname.  Names longer than the
+ *   cached ones are told apart by it.
+ *
+ ****************************************************************************/
+
+static uint32_t dns_hash(FAR const char *hostname)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*hostname != '\0')
+    {
+      hash = (hash ^ (uint8_t)*hostname++) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: dns_now
+ *
+ * Description:
+ *   Return the current time in seconds.
+ *
+ ****************************************************************************/
+
+static uint32_t dns_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)now.tv_sec;
+}
+
+/****************************************************************************
+ * Name: dns_expired
+ ****************************************************************************/
+
+static bool dns_expired(FAR struct dns_cache_s *entry, uint32_t now)
+{
+  return now - entry->ctime >= entry->lifetime;
+}
+
+/****************************************************************************
+ * Name: dns_remove_entry
+ *
+ * Description:
+ *   Unlink the entry 'ndx' from its hash chain and free it.
+ *
+ ****************************************************************************/
+
+static void dns_remove_entry(int ndx)
+{
+  FAR struct dns_cache_s *entry = &g_dns_cache[ndx];
+  FAR uint8_t *link = &g_dns_buckets[entry->hash % DNS_NBUCKETS];
+
+  while (*link != ndx + 1)
+    {
+      link = &g_dns_cache[*link - 1].next;
+    }
+
+  *link       = entry->next;
+  entry->used = false;
+}
+
+/****************************************************************************
+ * Name: dns_lookup_entry
+ *
+ * Description:
+ *   Return the index of the valid entry for 'hostname', or -1.  An expired
+ *   entry found on the way is freed.
+ *
+ ****************************************************************************/
+
+static int dns_lookup_entry(FAR const char *hostname, uint32_t hash,
+                            uint32_t now)
+{
+  FAR struct dns_cache_s *entry;
+  int ndx;
+
+  for (ndx = g_dns_buckets[hash % DNS_NBUCKETS] - 1; ndx >= 0;
+       ndx = entry->next - 1)
+    {
+      entry = &g_dns_cache[ndx];
+      if (entry->hash == hash &&
+          strncmp(hostname, entry->name,
+                  CONFIG_NETDB_DNSCLIENT_NAMESIZE - 1) == 0)
+        {
+          if (dns_expired(entry, now))
+            {
+              dns_remove_entry(ndx);
+              return -1;
+            }
+
+          return ndx;
+        }
+    }
+
+  return -1;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -79,12 +199,16 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Name: dns_save_answer
  *
  * Description:
- *   Save the last resolved hostname in the DNS cache
+ *   Save the last resolved hostname in the DNS cache.  The answer is kept
+ *   for its TTL, for at most CONFIG_NETDB_DNSCLIENT_LIFESEC seconds, or for
+ *   at most CONFIG_NETDB_DNSCLIENT_NEGLIFESEC seconds if it is that the
+ *   name has no address.  An entry that is free, expired, or else the one
+ *   that expires first is replaced.
  *
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
+ *   naddr    - The count of the IP addresses, zero if the name has none.
  *   ttl      - The TTL of the IP addresses.
  *
  * Returned Value:
@@ -97,62 +221,90 @@ void dns_save_answer(FAR const char *hostname,
                      uint32_t ttl)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-#endif
-  int next;
+  FAR uint8_t *bucket;
+  uint32_t remaining;
+  uint32_t lifetime;
+  uint32_t hash;
+  uint32_t now;
+  uint32_t min;
   int ndx;
+  int i;
 
   naddr = MIN(naddr, CONFIG_NETDB_MAX_IPADDR);
-  DEBUGASSERT(naddr >= 1 && naddr <= UCHAR_MAX);
+  DEBUGASSERT(naddr >= 0 && naddr <= UCHAR_MAX);
+
+  lifetime = MIN(ttl, naddr > 0 ? DNS_MAX_LIFESEC :
+                      CONFIG_NETDB_DNSCLIENT_NEGLIFESEC);
+  if (lifetime == 0)
+    {
+      return;
+    }
+
+  hash = dns_hash(hostname);
+  now  = dns_now();
 
   /* Get exclusive access to the DNS cache */
 
   dns_lock();
 
-  /* Get the index to the new head of the list */
+  /* Replace the previous answer for this name if there is one, else
+   * take a free or an expired entry, else the one that expires first.
+   */
 
-  ndx  = g_dns_head;
-  next = ndx + 1;
-  if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+  ndx = dns_lookup_entry(hostname, hash, now);
+  if (ndx >= 0)
     {
-      next = 0;
+      dns_remove_entry(ndx);
     }
-
-  /* If the next head pointer would match the tail index, then increment
-   * the tail index, discarding the oldest mapping in the cache.
-   */
-
-  if (next == g_dns_tail)
+  else
     {
-      int tmp = g_dns_tail + 1;
-      if (tmp >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+      min = UINT32_MAX;
+      ndx = 0;
+      for (i = 0; i < CONFIG_NETDB_DNSCLIENT_ENTRIES; i++)
         {
-          tmp = 0;
+          entry = &g_dns_cache[i];
+          if (!entry->used || dns_expired(entry, now))
+            {
+              ndx = i;
+              break;
+            }
+
+          remaining = entry->lifetime - (now - entry->ctime);
+          if (remaining < min)
+            {
+              min = remaining;
+              ndx = i;
+            }
         }
 
-      g_dns_tail = tmp;
+      if (g_dns_cache[ndx].used)
+        {
+          dns_remove_entry(ndx);
+        }
     }
 
   /* Save the answer in the cache */
 
   entry = &g_dns_cache[ndx];
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time */
+  strlcpy(entry->name, hostname, CONFIG_NETDB_DNSCLIENT_NAMESIZE);
+  if (naddr > 0)
+    {
+      memcpy(&entry->addr, addr, naddr * sizeof(*addr));
+    }
 
-  clock_gettime(CLOCK_MONOTONIC, &now);
-  entry->ctime = (time_t)now.tv_sec;
-#endif
+  entry->hash     = hash;
+  entry->ctime    = now;
+  entry->lifetime = lifetime;
+  entry->naddr    = naddr;
+  entry->used     = true;
 
-  strlcpy(entry->name, hostname, CONFIG_NETDB_DNSCLIENT_NAMESIZE);
-  memcpy(&entry->addr, addr, naddr * sizeof(*addr));
-  entry->naddr = naddr;
-  entry->ttl = ttl;
+  /* And add it to its hash chain */
 
-  /* Save the updated head index */
+  bucket      = &g_dns_buckets[hash % DNS_NBUCKETS];
+  entry->next = *bucket;
+  *bucket     = ndx + 1;
 
-  g_dns_head = next;
   dns_unlock();
 }
 
@@ -169,14 +321,19 @@ void dns_save_answer(FAR const char *hostname,
 
 void dns_clear_answer(void)
 {
+  int i;
+
   /* Get exclusive access to the DNS cache */
 
   dns_lock();
 
-  /* Reset the circular of DNS cache */
+  /* Empty all of the hash chains */
 
-  g_dns_head = 0;
-  g_dns_tail = 0;
+  memset(g_dns_buckets, 0, sizeof(g_dns_buckets));
+  for (i = 0; i < CONFIG_NETDB_DNSCLIENT_ENTRIES; i++)
+    {
+      g_dns_cache[i].used = false;
+    }
 
   dns_unlock();
 }
@@ -198,8 +355,9 @@ void dns_clear_answer(void)
  * Returned Value:
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
- *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   value will be returned: -ENOENT meaning that the hostname was not
+ *   found in the cache, or -EADDRNOTAVAIL meaning that the cache holds
+ *   the answer that the hostname has no address.
  *
  ****************************************************************************/
 
@@ -207,86 +365,35 @@ int dns_find_answer(FAR const char *hostname, FAR union dns_addr_u *addr,
                     FAR int *naddr)
 {
   FAR struct dns_cache_s *entry;
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  struct timespec now;
-  uint32_t elapsed;
-  int ret;
-#endif
-  int next;
+  uint32_t hash = dns_hash(hostname);
+  uint32_t now = dns_now();
+  int ret = -ENOENT;
   int ndx;
 
   /* Get exclusive access to the DNS cache */
 
   dns_lock();
 
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-  /* Get the current time */
-
-  ret = clock_gettime(CLOCK_MONOTONIC, &now);
-#endif
-
-  for (ndx = g_dns_tail; ndx != g_dns_head; ndx = next)
+  ndx = dns_lookup_entry(hostname, hash, now);
+  if (ndx >= 0)
     {
       entry = &g_dns_cache[ndx];
-
-      /* Advance the index for the next time through the loop, handling
-       * wrapping to the beginning of the circular buffer.
-       */
-
-      next = ndx + 1;
-      if (next >= CONFIG_NETDB_DNSCLIENT_ENTRIES)
+      if (entry->naddr == 0)
         {
-          next = 0;
-        }
-
-#if CONFIG_NETDB_DNSCLIENT_LIFESEC > 0
-      /* Check if this entry has expired
-       * REVISIT: Does not this calculation assume that the sizeof(time_t)
-       * is equal to the sizeof(uint32_t)?
-       */
-
-      elapsed = (uint32_t)now.tv_sec - (uint32_t)entry->ctime;
-      if (ret >= 0 &&
-          (elapsed > CONFIG_NETDB_DNSCLIENT_LIFESEC || elapsed > entry->ttl))
-        {
-          /* This entry has expired.  Increment the tail index to exclude
-           * this entry on future traversals.
-           */
-
-          g_dns_tail = next;
+          ret = -EADDRNOTAVAIL;
         }
       else
-#endif
         {
-          /* The entry has not expired, check for a name match. Because
-           * the names are truncated to CONFIG_NETDB_DNSCLIENT_NAMESIZE,
-           * this has the possibility of aliasing two names and returning
-           * the wrong entry from the cache.
+          /* We have a match.  Make sure that the address will fit in the
+           * caller-provided buffer and return it.
            */
 
-          if (strncmp(hostname, entry->name,
-                      CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
-            {
-              /* We have a match.  Return the resolved host address */
-
-              /* Make sure that the address will fit in the caller-provided
-               * buffer.
-               */
-
-              *naddr = MIN(*naddr, entry->naddr);
-
-              /* Return the address information */
-
-              memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
-
-              dns_unlock();
-              return OK;
-            }
+          *naddr = MIN(*naddr, entry->naddr);
+          memcpy(addr, &entry->addr, *naddr * sizeof(*addr));
+          ret = OK;
         }
     }
 
-  ret = -ENOENT;
-
   dns_unlock();
   return ret;
 }
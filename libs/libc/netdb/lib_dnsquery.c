@@ -48,6 +48,8 @@
 
 #include <nuttx/config.h>
 
+#include <inttypes.h>
+#include <poll.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
@@ -83,19 +85,18 @@
 #define RECV_BUFFER_SIZE  CONFIG_NETDB_DNSCLIENT_MAXRESPONSE
 #define QUERY_BUFFER_SIZE MAX(SEND_BUFFER_SIZE, RECV_BUFFER_SIZE)
 
+/* The AAAA and A queries are sent together */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define DNS_NRECTYPES   2
+#else
+#  define DNS_NRECTYPES   1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-struct dns_query_s
-{
-  int result;                     /* Explanation of the failure */
-  FAR const char *hostname;       /* Hostname to lookup */
-  FAR union dns_addr_u *addr;     /* Location to return host address */
-  FAR int *naddr;                 /* Number of returned addresses */
-  uint32_t ttl;                   /* Time to Live, unit:s */
-};
-
 /* Query info to check response against. */
 
 struct dns_query_info_s
@@ -107,13 +108,55 @@ struct dns_query_info_s
                                                     * encoded format + NUL */
 };
 
+/* A name server of the batch being queried */
+
+struct dns_server_s
+{
+  union dns_addr_u addr;                      /* Server address */
+  int sd;                                     /* Socket, -1 if unusable */
+  uint8_t failed;                             /* Record types it failed */
+
+  /* The query of each record type */
+
+  struct dns_query_info_s qinfo[DNS_NRECTYPES];
+};
+
 struct dns_query_data_s
 {
-  struct dns_query_s query;
-  struct dns_query_info_s qinfo;
+  FAR const char *hostname;       /* Hostname to lookup */
+  int result;                     /* Explanation of the last failure */
+  uint32_t ttl;                   /* Time to Live, unit:s */
+  int nservers;                   /* Servers in the batch */
+  struct dns_server_s servers[CONFIG_NETDB_DNSCLIENT_NSERVERS];
+  struct pollfd fds[CONFIG_NETDB_DNSCLIENT_NSERVERS];
+
+  /* The answer for each record type: number of addresses, zero if the
+   * name has none or -1 until a server answers.
+   */
+
+  int naddr[DNS_NRECTYPES];
+  union dns_addr_u addr[DNS_NRECTYPES][CONFIG_NETDB_MAX_IPADDR];
   uint8_t buffer[QUERY_BUFFER_SIZE]; /* Buffer to hold request & response */
 };
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The record types queried, the addresses from each are returned in this
+ * order.
+ */
+
+static const uint16_t g_dns_rectypes[DNS_NRECTYPES] =
+{
+#ifdef CONFIG_NET_IPv6
+  DNS_RECTYPE_AAAA,
+#endif
+#ifdef CONFIG_NET_IPv4
+  DNS_RECTYPE_A,
+#endif
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -324,49 +367,56 @@ static int dns_send_query(int sd, FAR const char *name,
 }
 
 /****************************************************************************
- * Name: dns_recv_response
+ * Name: dns_parse_ttl
  *
  * Description:
- *   Called when new UDP data arrives
+ *   Return the TTL of the resource record whose type field is at 'ans'.
+ *
+ ****************************************************************************/
+
+static inline uint32_t dns_parse_ttl(FAR struct dns_answer_s *ans)
+{
+  return ((uint32_t)NTOHS(ans->ttl[0]) << 16) | NTOHS(ans->ttl[1]);
+}
+
+/****************************************************************************
+ * Name: dns_parse_response
+ *
+ * Description:
+ *   Parse a response to the query described by 'qinfo' received in
+ *   'buffer'.  The TTL of the answer, or for a negative answer the TTL
+ *   from the SOA record of the authority section (RFC 2308), is lowered
+ *   into 'ttl'.
  *
  * Returned Value:
- *   Returns number of valid IP address responses.  Negated errno value is
- *   returned in all other cases.
+ *   Returns number of valid IP address responses, zero if the name has
+ *   no address of the queried type.  Negated errno value is returned in
+ *   all other cases: -EPROTO if the server reported an error, -EBADMSG or
+ *   -EILSEQ if the response is not for the query or is malformed.
  *
  ****************************************************************************/
 
-static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
-                             FAR struct dns_query_info_s *qinfo,
-                             FAR uint32_t *ttl, FAR uint8_t *buffer)
+static int dns_parse_response(FAR uint8_t *buffer, int buflen,
+                              FAR union dns_addr_u *addr, int naddr,
+                              FAR struct dns_query_info_s *qinfo,
+                              FAR uint32_t *ttl)
 {
   FAR uint8_t *nameptr;
   FAR uint8_t *namestart;
   FAR uint8_t *endofbuffer;
+  FAR uint8_t *soamin;
   FAR struct dns_answer_s *ans;
   FAR struct dns_header_s *hdr;
   FAR struct dns_question_s *que;
   uint16_t nquestions;
   uint16_t nanswers;
+  uint16_t nauthrr;
   uint16_t temp;
+  uint32_t minimum;
   int naddr_read;
-  int ret;
-
-  if (naddr <= 0)
-    {
-      return -ERANGE;
-    }
-
-  /* Receive the response */
+  int rcode;
 
-  ret = recv(sd, buffer, RECV_BUFFER_SIZE, 0);
-  if (ret < 0)
-    {
-      ret = -get_errno();
-      nerr("ERROR: recv failed: %d\n", ret);
-      return ret;
-    }
-
-  if (ret < sizeof(*hdr))
+  if (buflen < sizeof(*hdr))
     {
       /* DNS header can't fit in received data */
 
@@ -375,7 +425,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
     }
 
   hdr         = (FAR struct dns_header_s *)buffer;
-  endofbuffer = buffer + ret;
+  endofbuffer = buffer + buflen;
 
   ninfo("ID %d\n", NTOHS(hdr->id));
   ninfo("Query %d\n", hdr->flags1 & DNS_FLAG1_RESPONSE);
@@ -384,14 +434,6 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
         NTOHS(hdr->numquestions), NTOHS(hdr->numanswers),
         NTOHS(hdr->numauthrr), NTOHS(hdr->numextrarr));
 
-  /* Check for error */
-
-  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
-    {
-      nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
-      return -EPROTO;
-    }
-
   /* Check for matching ID. */
 
   if (hdr->id != qinfo->id)
@@ -401,12 +443,24 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
       return -EBADMSG;
     }
 
-  /* We only care about the question(s) and the answers. The authrr
-   * and the extrarr are simply discarded.
+  /* Check for error.  A name error is an answer: the name does not
+   * exist.
+   */
+
+  rcode = hdr->flags2 & DNS_FLAG2_ERR_MASK;
+  if (rcode != DNS_FLAG2_ERR_NONE && rcode != DNS_FLAG2_ERR_NAME)
+    {
+      nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
+      return -EPROTO;
+    }
+
+  /* We only care about the question(s), the answers and the SOA record
+   * of negative answers.  The extrarr are simply discarded.
    */
 
   nquestions = NTOHS(hdr->numquestions);
   nanswers   = NTOHS(hdr->numanswers);
+  nauthrr    = NTOHS(hdr->numauthrr);
 
   /* We only ever send queries with one question. */
 
@@ -448,6 +502,10 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
   /* Validate query type and class */
 
   que = (FAR struct dns_question_s *)nameptr;
+  if (nameptr + sizeof(struct dns_question_s) > endofbuffer)
+    {
+      return -EILSEQ;
+    }
 
   /* N.B. Unaligned access may occur here */
 
@@ -463,7 +521,6 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
 
   nameptr += sizeof(struct dns_question_s);
 
-  ret = OK;
   naddr_read = 0;
 
   for (; nanswers > 0; nanswers--)
@@ -471,23 +528,23 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
       /* Each answer starts with a name */
 
       nameptr = dns_parse_name(nameptr, endofbuffer);
-      if (nameptr == endofbuffer)
+      if (nameptr + 10 > endofbuffer)
         {
-          ret = -EILSEQ;
-          nwarn("Further parse returned %d\n", ret);
+          nwarn("Further parse returned %d\n", -EILSEQ);
           break;
         }
 
       ans = (FAR struct dns_answer_s *)nameptr;
 
-      ninfo("Answer: type=%04x, class=%04x, ttl=%06x, length=%04x\n",
-            NTOHS(ans->type), NTOHS(ans->class),
-            (NTOHS(ans->ttl[0]) << 16) | NTOHS(ans->ttl[1]),
-            NTOHS(ans->len));
-      if (ttl)
-        {
-          *ttl = (NTOHS(ans->ttl[0]) << 16) | NTOHS(ans->ttl[1]);
-        }
+      ninfo("Answer: type=%04x, class=%04x, ttl=%06" PRIx32
+            ", length=%04x\n", NTOHS(ans->type), NTOHS(ans->class),
+            dns_parse_ttl(ans), NTOHS(ans->len));
+
+      /* The answer is valid for the shortest TTL of its records,
+       * including those of the aliases that led to the addresses.
+       */
+
+      *ttl = MIN(*ttl, dns_parse_ttl(ans));
 
       /* Check for IPv4/6 address type and Internet class. Others are
        * discarded.
@@ -516,7 +573,6 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
 
           if (++naddr_read >= naddr)
             {
-              ret = -ERANGE;
               break;
             }
         }
@@ -549,7 +605,6 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
 
           if (++naddr_read >= naddr)
             {
-              ret = -ERANGE;
               break;
             }
         }
@@ -560,12 +615,47 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
         }
     }
 
-  if (naddr_read == 0 && ret == OK)
+  if (naddr_read > 0)
     {
-      ret = -EADDRNOTAVAIL;
+      return naddr_read;
+    }
+
+  if (nanswers > 0)
+    {
+      /* The answers were cut short */
+
+      return -EILSEQ;
     }
 
-  return naddr_read > 0 ? naddr_read : ret;
+  /* A negative answer.  It should be cached for the minimum of the TTL and
+   * of the MINIMUM field of the SOA record that came with it.
+   */
+
+  for (; nauthrr > 0; nauthrr--)
+    {
+      nameptr = dns_parse_name(nameptr, endofbuffer);
+      if (nameptr + 10 > endofbuffer)
+        {
+          break;
+        }
+
+      ans      = (FAR struct dns_answer_s *)nameptr;
+      nameptr += 10 + NTOHS(ans->len);
+      if (ans->type == HTONS(DNS_RECTYPE_SOA) &&
+          NTOHS(ans->len) >= 22 && nameptr <= endofbuffer)
+        {
+          /* MINIMUM is the last field of the record data */
+
+          soamin  = nameptr - 4;
+          minimum = ((uint32_t)soamin[0] << 24) |
+                    ((uint32_t)soamin[1] << 16) |
+                    ((uint32_t)soamin[2] << 8) | soamin[3];
+          *ttl    = MIN(*ttl, MIN(dns_parse_ttl(ans), minimum));
+          break;
+        }
+    }
+
+  return 0;
 }
 
 /****************************************************************************
@@ -608,143 +698,264 @@ static void dns_query_error(FAR const char *prompt, int ret,
 }
 
 /****************************************************************************
- * Name: dns_query_callback
+ * Name: dns_query_pending
  *
  * Description:
- *   Using the DNS information and this DNS server address, look up the
- *   hostname.
+ *   Return true if some record type has not been answered yet.
  *
- * Input Parameters:
- *   arg      - Query arguments
- *   addr     - DNS name server address
- *   addrlen  - Length of the DNS name server address.
+ ****************************************************************************/
+
+static bool dns_query_pending(FAR struct dns_query_data_s *qdata)
+{
+  int i;
+
+  for (i = 0; i < DNS_NRECTYPES; i++)
+    {
+      if (qdata->naddr[i] < 0)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: dns_query_waiting
  *
- * Returned Value:
- *   Returns one (1) if the query was successful.  Zero is returned in all
- *   other cases.  The result field of the query structure is set to a
- *   negated errno value indicate the reason for the last failure (only).
+ * Description:
+ *   Return true if some record type has not been answered yet by a server
+ *   of the batch that has not failed it.
  *
  ****************************************************************************/
 
-static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
-                              FAR socklen_t addrlen)
+static bool dns_query_waiting(FAR struct dns_query_data_s *qdata)
 {
-  FAR struct dns_query_data_s *qdata = arg;
-  FAR struct dns_query_s      *query = &qdata->query;
-  int next = 0;
-  int retries;
+  int i;
+  int j;
+
+  for (i = 0; i < DNS_NRECTYPES; i++)
+    {
+      for (j = 0; qdata->naddr[i] < 0 && j < qdata->nservers; j++)
+        {
+          if (qdata->servers[j].sd >= 0 &&
+              (qdata->servers[j].failed & (1 << i)) == 0)
+            {
+              return true;
+            }
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: dns_query_recv
+ *
+ * Description:
+ *   Receive a response on the socket of 'server' and record it as the
+ *   answer for its record type if that one is still pending.
+ *
+ ****************************************************************************/
+
+static void dns_query_recv(FAR struct dns_query_data_s *qdata,
+                           FAR struct dns_server_s *server)
+{
+  FAR struct dns_header_s *hdr = (FAR struct dns_header_s *)qdata->buffer;
+  uint32_t ttl = UINT32_MAX;
   int ret;
-  int sd;
+  int i;
 
-  /* Loop while receive timeout errors occur and there are remaining
-   * retries.
+  ret = recv(server->sd, qdata->buffer, RECV_BUFFER_SIZE, 0);
+  if (ret < 0)
+    {
+      ret = -get_errno();
+      dns_query_error("ERROR: recv failed", ret, &server->addr);
+      qdata->result = ret;
+      return;
+    }
+
+  /* Find the query by its ID.  Late responses for record types that
+   * another server answered first are discarded.
    */
 
-  for (retries = 0; retries < CONFIG_NETDB_DNSCLIENT_RETRIES; retries++)
+  for (i = 0; i < DNS_NRECTYPES; i++)
     {
-#ifdef CONFIG_NET_IPv6
-      /* Send the IPv6 query */
-
-      sd = dns_bind(addr->sa_family);
-      if (sd < 0)
+      if (ret >= sizeof(*hdr) && hdr->id == server->qinfo[i].id)
         {
-          query->result = sd;
-          return 0;
+          break;
         }
+    }
 
-      ret = dns_send_query(sd, query->hostname,
-                          (FAR union dns_addr_u *)addr,
-                           DNS_RECTYPE_AAAA, &qdata->qinfo, qdata->buffer);
-      if (ret < 0)
-        {
-          dns_query_error("ERROR: IPv6 dns_send_query failed",
-                          ret, (FAR union dns_addr_u *)addr);
-          query->result = ret;
-        }
-      else
-        {
-          /* Obtain the IPv6 response */
+  if (i == DNS_NRECTYPES || qdata->naddr[i] >= 0)
+    {
+      return;
+    }
 
-          ret = dns_recv_response(sd, &query->addr[next],
-                                  *query->naddr - next, &qdata->qinfo,
-                                  &query->ttl, qdata->buffer);
-          if (ret >= 0)
-            {
-              next += ret;
-            }
-          else
-            {
-              dns_query_error("ERROR: IPv6 dns_recv_response failed",
-                              ret, (FAR union dns_addr_u *)addr);
-              query->result = ret;
-            }
-        }
+  ret = dns_parse_response(qdata->buffer, ret, qdata->addr[i],
+                           CONFIG_NETDB_MAX_IPADDR, &server->qinfo[i],
+                           &ttl);
+  if (ret >= 0)
+    {
+      qdata->naddr[i] = ret;
+      qdata->ttl      = MIN(qdata->ttl, ttl);
+      return;
+    }
 
-      close(sd);
-#endif
+  dns_query_error("ERROR: dns_parse_response failed", ret, &server->addr);
+  qdata->result = ret;
 
-#ifdef CONFIG_NET_IPv4
-      /* Send the IPv4 query */
+  /* A server error fails the query on this server, a response that was
+   * not for it is ignored.
+   */
+
+  if (ret == -EPROTO)
+    {
+      server->failed |= 1 << i;
+    }
+}
+
+/****************************************************************************
+ * Name: dns_query_batch
+ *
+ * Description:
+ *   Send the queries for all of the record types to each server of the
+ *   batch at once and wait for the first answer to each of them, resending
+ *   the unanswered ones when the receive timeout expires.
+ *
+ ****************************************************************************/
 
-      sd = dns_bind(addr->sa_family);
-      if (sd < 0)
+static void dns_query_batch(FAR struct dns_query_data_s *qdata)
+{
+  FAR struct dns_server_s *server;
+  struct timespec deadline;
+  struct timespec now;
+  int retries;
+  int timeout;
+  int ret;
+  int i;
+  int j;
+
+  for (i = 0; i < qdata->nservers; i++)
+    {
+      server         = &qdata->servers[i];
+      server->failed = 0;
+      server->sd     = dns_bind(server->addr.addr.sa_family);
+      if (server->sd < 0)
         {
-          query->result = sd;
-          return 0;
+          qdata->result = server->sd;
         }
 
-      ret = dns_send_query(sd, query->hostname,
-                           (FAR union dns_addr_u *)addr,
-                           DNS_RECTYPE_A, &qdata->qinfo, qdata->buffer);
-      if (ret < 0)
+      qdata->fds[i].fd     = server->sd;
+      qdata->fds[i].events = POLLIN;
+    }
+
+  for (retries = 0;
+       retries < CONFIG_NETDB_DNSCLIENT_RETRIES && dns_query_waiting(qdata);
+       retries++)
+    {
+      /* Send the queries that are still unanswered */
+
+      for (i = 0; i < qdata->nservers; i++)
         {
-          dns_query_error("ERROR: IPv4 dns_send_query failed",
-                          ret, (FAR union dns_addr_u *)addr);
-          query->result = ret;
+          server = &qdata->servers[i];
+          for (j = 0; server->sd >= 0 && j < DNS_NRECTYPES; j++)
+            {
+              if (qdata->naddr[j] >= 0 || (server->failed & (1 << j)) != 0)
+                {
+                  continue;
+                }
+
+              ret = dns_send_query(server->sd, qdata->hostname,
+                                   &server->addr, g_dns_rectypes[j],
+                                   &server->qinfo[j], qdata->buffer);
+              if (ret < 0)
+                {
+                  dns_query_error("ERROR: dns_send_query failed", ret,
+                                  &server->addr);
+                  qdata->result   = ret;
+                  server->failed |= 1 << j;
+                }
+            }
         }
-      else
+
+      /* Wait for the responses */
+
+      clock_gettime(CLOCK_MONOTONIC, &deadline);
+      deadline.tv_sec += CONFIG_NETDB_DNSCLIENT_RECV_TIMEOUT;
+
+      while (dns_query_waiting(qdata))
         {
-          /* Obtain the IPv4 response */
+          clock_gettime(CLOCK_MONOTONIC, &now);
+          timeout = (deadline.tv_sec - now.tv_sec) * 1000 +
+                    (deadline.tv_nsec - now.tv_nsec) / 1000000;
+          if (timeout <= 0)
+            {
+              qdata->result = -EAGAIN;
+              break;
+            }
 
-          ret = dns_recv_response(sd, &query->addr[next],
-                                  *query->naddr - next, &qdata->qinfo,
-                                  &query->ttl, qdata->buffer);
-          if (ret >= 0)
+          ret = poll(qdata->fds, qdata->nservers, timeout);
+          if (ret < 0 && get_errno() != EINTR)
             {
-              next += ret;
+              qdata->result = -get_errno();
+              goto out;
             }
-          else
+
+          for (i = 0; ret > 0 && i < qdata->nservers; i++)
             {
-              dns_query_error("ERROR: IPv4 dns_recv_response failed",
-                              ret, (FAR union dns_addr_u *)addr);
-              query->result = ret;
+              if ((qdata->fds[i].revents & POLLIN) != 0)
+                {
+                  dns_query_recv(qdata, &qdata->servers[i]);
+                }
             }
         }
+    }
 
-      close(sd);
-#endif /* CONFIG_NET_IPv4 */
-
-      if (next > 0)
+out:
+  for (i = 0; i < qdata->nservers; i++)
+    {
+      if (qdata->servers[i].sd >= 0)
         {
-#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
-          /* Save the answer in the DNS cache */
+          close(qdata->servers[i].sd);
+        }
+    }
 
-          dns_save_answer(query->hostname, query->addr, next, query->ttl);
-#endif
-          /* Return 1 to indicate to (1) stop the traversal, and (2)
-           * indicate that the address was found.
-           */
+  qdata->nservers = 0;
+}
 
-          *query->naddr = next;
-          return 1;
-        }
-      else if (query->result != -EAGAIN)
-        {
-          break;
-        }
+/****************************************************************************
+ * Name: dns_query_callback
+ *
+ * Description:
+ *   Add this DNS server address to the batch of servers queried at once,
+ *   and query the batch once it is full.
+ *
+ * Input Parameters:
+ *   arg      - Query arguments
+ *   addr     - DNS name server address
+ *   addrlen  - Length of the DNS name server address.
+ *
+ * Returned Value:
+ *   Returns one (1) if the query was answered.  Zero is returned in all
+ *   other cases.  The result field of the query structure is set to a
+ *   negated errno value indicate the reason for the last failure (only).
+ *
+ ****************************************************************************/
+
+static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
+                              FAR socklen_t addrlen)
+{
+  FAR struct dns_query_data_s *qdata = arg;
+
+  memcpy(&qdata->servers[qdata->nservers++].addr, addr, addrlen);
+  if (qdata->nservers < CONFIG_NETDB_DNSCLIENT_NSERVERS)
+    {
+      return 0;
     }
 
-  return 0;
+  dns_query_batch(qdata);
+  return !dns_query_pending(qdata);
 }
 
 /****************************************************************************
@@ -755,8 +966,10 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
  * Name: dns_query
  *
  * Description:
- *   Using the DNS resolver socket (sd), look up the 'hostname', and
- *   return its IP address in 'ipaddr'
+ *   Look up the 'hostname' on the configured name servers, and return its
+ *   IP addresses in 'addr'.  The queries for the IPv6 and IPv4 addresses
+ *   are sent together to up to CONFIG_NETDB_DNSCLIENT_NSERVERS servers
+ *   at a time; the first server to answer wins.
  *
  * Input Parameters:
  *   hostname - The hostname string to be resolved.
@@ -767,7 +980,8 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
  *     the returned addresses.
  *
  * Returned Value:
- *   Returns zero (OK) if the query was successful.
+ *   Returns zero (OK) if the query was successful.  -EADDRNOTAVAIL is
+ *   returned if the servers answered that the name has no address.
  *
  ****************************************************************************/
 
@@ -775,7 +989,9 @@ int dns_query(FAR const char *hostname, FAR union dns_addr_u *addr,
               FAR int *naddr)
 {
   FAR struct dns_query_data_s *qdata = lib_malloc(sizeof(*qdata));
+  int next;
   int ret;
+  int i;
 
   if (qdata == NULL)
     {
@@ -784,28 +1000,67 @@ int dns_query(FAR const char *hostname, FAR union dns_addr_u *addr,
 
   /* Set up the query info structure */
 
-  qdata->query.result   = -EADDRNOTAVAIL;
-  qdata->query.hostname = hostname;
-  qdata->query.addr     = addr;
-  qdata->query.naddr    = naddr;
+  qdata->result   = -EADDRNOTAVAIL;
+  qdata->hostname = hostname;
+  qdata->ttl      = UINT32_MAX;
+  qdata->nservers = 0;
+  for (i = 0; i < DNS_NRECTYPES; i++)
+    {
+      qdata->naddr[i] = -1;
+    }
 
   /* Perform the query. dns_foreach_nameserver() will return:
    *
-   *  1 - The query was successful.
-   *  0 - Look up failed
+   *  1 - The query was answered.
+   *  0 - All of the full batches failed
    * <0 - Some other failure (?, shouldn't happen)
    */
 
   ret = dns_foreach_nameserver(dns_query_callback, qdata);
-  if (ret > 0)
+  if (ret == 0 && qdata->nservers > 0)
+    {
+      /* Query the last servers */
+
+      dns_query_batch(qdata);
+    }
+
+  if (ret >= 0)
+    {
+      ret = dns_query_pending(qdata) ? 0 : 1;
+    }
+
+  /* Return the addresses of each record type in turn */
+
+  for (i = 0, next = 0; ret > 0 && i < DNS_NRECTYPES; i++)
+    {
+      int n = MIN(qdata->naddr[i], *naddr - next);
+
+      memcpy(&addr[next], qdata->addr[i], n * sizeof(*addr));
+      next += n;
+    }
+
+  if (ret > 0 && next > 0)
     {
-      /* The lookup was successful */
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+      /* Save the answer in the DNS cache */
 
+      dns_save_answer(hostname, addr, next, qdata->ttl);
+#endif
+      *naddr = next;
       ret = OK;
     }
+  else if (ret > 0)
+    {
+#if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+      /* Remember that the name has no address */
+
+      dns_save_answer(hostname, NULL, 0, qdata->ttl);
+#endif
+      ret = -EADDRNOTAVAIL;
+    }
   else if (ret == 0)
     {
-      ret = qdata->query.result;
+      ret = qdata->result;
     }
 
   /* Free the query data */
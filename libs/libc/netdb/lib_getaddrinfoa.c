@@ -0,0 +1,451 @@
+/****************************************************************************
+ * libs/libc/netdb/lib_getaddrinfoa.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <errno.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/param.h>
+
+#include <nuttx/clock.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The life cycle of a request, kept in gaicb.__state */
+
+#define GAI_STATE_QUEUED   1 /* Waiting for a worker */
+#define GAI_STATE_RUNNING  2 /* getaddrinfo() in progress */
+#define GAI_STATE_DONE     3 /* __return holds the result */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The requests of one getaddrinfo_a() call.  The list is copied so that
+ * the caller may reuse its array once getaddrinfo_a() has returned.
+ */
+
+struct gai_batch_s
+{
+  int                  mode;     /* GAI_WAIT or GAI_NOWAIT */
+  int                  nitems;   /* Number of entries in list */
+  int                  next;     /* Next entry to be taken by a worker */
+  int                  nrunning; /* Workers that have not finished yet */
+  pid_t                pid;      /* The process to be signalled */
+  struct sigevent      sev;      /* How to notify completion */
+  FAR struct gaicb   **list;     /* The requests */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* One lock for all the requests: it protects their state and the batches,
+ * and the condition is broadcast whenever a request completes.
+ */
+
+static pthread_mutex_t g_gai_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  g_gai_cond = PTHREAD_COND_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gai_run
+ *
+ * Description:
+ *   Resolve queued requests of the batch until none are left.
+ *
+ * Returned Value:
+ *   True if the caller was the last worker of a GAI_NOWAIT batch, which it
+ *   then has to notify and free.
+ *
+ ****************************************************************************/
+
+static bool gai_run(FAR struct gai_batch_s *batch)
+{
+  FAR struct gaicb *req;
+  bool last;
+  int ret;
+
+  pthread_mutex_lock(&g_gai_lock);
+  while (batch->next < batch->nitems)
+    {
+      req = batch->list[batch->next++];
+      if (req->__state != GAI_STATE_QUEUED)
+        {
+          continue; /* Canceled */
+        }
+
+      req->__state = GAI_STATE_RUNNING;
+      pthread_mutex_unlock(&g_gai_lock);
+
+      ret = getaddrinfo(req->ar_name, req->ar_service, req->ar_request,
+                        &req->ar_result);
+
+      pthread_mutex_lock(&g_gai_lock);
+      req->__return = ret;
+      req->__state  = GAI_STATE_DONE;
+      pthread_cond_broadcast(&g_gai_cond);
+    }
+
+  last = --batch->nrunning == 0;
+  if (last)
+    {
+      pthread_cond_broadcast(&g_gai_cond);
+    }
+
+  last = last && batch->mode == GAI_NOWAIT;
+  pthread_mutex_unlock(&g_gai_lock);
+  return last;
+}
+
+/****************************************************************************
+ * Name: gai_notify
+ *
+ * Description:
+ *   Notify the completion of a GAI_NOWAIT batch as sevp of getaddrinfo_a()
+ *   asked, then free the batch.
+ *
+ ****************************************************************************/
+
+static void gai_notify(FAR struct gai_batch_s *batch)
+{
+  switch (batch->sev.sigev_notify)
+    {
+      case SIGEV_SIGNAL:
+        sigqueue(batch->pid, batch->sev.sigev_signo,
+                 batch->sev.sigev_value);
+        break;
+
+#ifdef CONFIG_SIG_EVTHREAD
+      case SIGEV_THREAD:
+
+        /* We are on a thread of our own already */
+
+        batch->sev.sigev_notify_function(batch->sev.sigev_value);
+        break;
+#endif
+
+      default:
+        break;
+    }
+
+  lib_free(batch);
+}
+
+static FAR void *gai_worker(FAR void *arg)
+{
+  FAR struct gai_batch_s *batch = arg;
+
+  if (gai_run(batch))
+    {
+      gai_notify(batch);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: getaddrinfo_a
+ *
+ * Description:
+ *   Start the name look ups of the nitems requests in list.  Each of them
+ *   is resolved as getaddrinfo() would, by up to
+ *   CONFIG_NETDB_GETADDRINFO_A_NTHREADS worker threads in parallel, and
+ *   its result is left in ar_result and reported by gai_error().  NULL
+ *   entries of the list are ignored.
+ *
+ *   With GAI_WAIT the call returns once all the requests are done; the
+ *   calling thread works on them too.  With GAI_NOWAIT it returns at once
+ *   and, if sevp is not NULL, the completion of the last request is
+ *   notified by a signal (SIGEV_SIGNAL) or a call of the notification
+ *   function (SIGEV_THREAD).
+ *
+ * Returned Value:
+ *   Zero if the requests were queued; EAI_AGAIN if no worker thread could
+ *   be started, EAI_MEMORY if out of memory or EAI_SYSTEM with errno set
+ *   to EINVAL if mode or nitems is invalid.
+ *
+ ****************************************************************************/
+
+int getaddrinfo_a(int mode, FAR struct gaicb *list[],
+                  int nitems, FAR struct sigevent *sevp)
+{
+  FAR struct gai_batch_s *batch;
+  pthread_attr_t attr;
+  pthread_t thread;
+  int nthreads;
+  int count;
+  int i;
+
+  if ((mode != GAI_WAIT && mode != GAI_NOWAIT) || nitems < 0)
+    {
+      set_errno(EINVAL);
+      return EAI_SYSTEM;
+    }
+
+  batch = lib_malloc(sizeof(*batch) + nitems * sizeof(FAR struct gaicb *));
+  if (batch == NULL)
+    {
+      return EAI_MEMORY;
+    }
+
+  batch->mode     = mode;
+  batch->next     = 0;
+  batch->nrunning = mode == GAI_WAIT;
+  batch->pid      = getpid();
+  batch->list     = (FAR struct gaicb **)(batch + 1);
+
+  if (sevp != NULL && mode == GAI_NOWAIT)
+    {
+      batch->sev = *sevp;
+    }
+  else
+    {
+      batch->sev.sigev_notify = SIGEV_NONE;
+    }
+
+  pthread_mutex_lock(&g_gai_lock);
+
+  for (i = count = 0; i < nitems; i++)
+    {
+      if (list[i] != NULL)
+        {
+          list[i]->ar_result = NULL;
+          list[i]->__return  = EAI_INPROGRESS;
+          list[i]->__state   = GAI_STATE_QUEUED;
+          batch->list[count++] = list[i];
+        }
+    }
+
+  batch->nitems = count;
+
+  /* A GAI_WAIT caller counts as one of the workers */
+
+  nthreads = MIN(count, CONFIG_NETDB_GETADDRINFO_A_NTHREADS) -
+             batch->nrunning;
+
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(&attr, CONFIG_NETDB_GETADDRINFO_A_STACKSIZE);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+  /* The workers block on the lock until the batch is complete */
+
+  for (i = 0; i < nthreads; i++)
+    {
+      if (pthread_create(&thread, &attr, gai_worker, batch) != 0)
+        {
+          break;
+        }
+
+      batch->nrunning++;
+    }
+
+  pthread_attr_destroy(&attr);
+
+  if (mode == GAI_NOWAIT)
+    {
+      if (batch->nrunning == 0)
+        {
+          for (i = 0; i < count; i++)
+            {
+              batch->list[i]->__return = EAI_AGAIN;
+              batch->list[i]->__state  = GAI_STATE_DONE;
+            }
+
+          pthread_mutex_unlock(&g_gai_lock);
+          lib_free(batch);
+          return count > 0 ? EAI_AGAIN : OK;
+        }
+
+      pthread_mutex_unlock(&g_gai_lock);
+      return OK;
+    }
+
+  pthread_mutex_unlock(&g_gai_lock);
+  gai_run(batch);
+
+  /* Wait for the workers still busy with their last request */
+
+  pthread_mutex_lock(&g_gai_lock);
+  while (batch->nrunning > 0)
+    {
+      pthread_cond_wait(&g_gai_cond, &g_gai_lock);
+    }
+
+  pthread_mutex_unlock(&g_gai_lock);
+  lib_free(batch);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: gai_error
+ *
+ * Description:
+ *   Return the status of a request of getaddrinfo_a(): EAI_INPROGRESS
+ *   while it is pending, EAI_CANCELED if it was canceled, otherwise the
+ *   value that getaddrinfo() returned for it.
+ *
+ ****************************************************************************/
+
+int gai_error(FAR struct gaicb *req)
+{
+  int ret;
+
+  pthread_mutex_lock(&g_gai_lock);
+  ret = req->__return;
+  pthread_mutex_unlock(&g_gai_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: gai_cancel
+ *
+ * Description:
+ *   Cancel a request of getaddrinfo_a().  Only a request that no worker
+ *   has taken yet can be canceled.
+ *
+ * Returned Value:
+ *   EAI_CANCELED if the request was canceled, EAI_NOTCANCELED if it is in
+ *   progress or EAI_ALLDONE if it has already completed.
+ *
+ ****************************************************************************/
+
+int gai_cancel(FAR struct gaicb *req)
+{
+  int ret;
+
+  pthread_mutex_lock(&g_gai_lock);
+  switch (req->__state)
+    {
+      case GAI_STATE_QUEUED:
+        req->__return = EAI_CANCELED;
+        req->__state  = GAI_STATE_DONE;
+        pthread_cond_broadcast(&g_gai_cond);
+        ret = EAI_CANCELED;
+        break;
+
+      case GAI_STATE_RUNNING:
+        ret = EAI_NOTCANCELED;
+        break;
+
+      default:
+        ret = EAI_ALLDONE;
+        break;
+    }
+
+  pthread_mutex_unlock(&g_gai_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: gai_suspend
+ *
+ * Description:
+ *   Wait until at least one of the requests in list has completed, or the
+ *   relative timeout, if not NULL, has elapsed.  NULL entries of the list
+ *   are ignored.
+ *
+ * Returned Value:
+ *   Zero if a request has completed, EAI_AGAIN on timeout or EAI_ALLDONE
+ *   if the list holds no request.
+ *
+ ****************************************************************************/
+
+int gai_suspend(FAR const struct gaicb * const list[], int nitems,
+                FAR const struct timespec *timeout)
+{
+  struct timespec abstime;
+  bool pending;
+  int ret;
+  int i;
+
+  if (timeout != NULL)
+    {
+      clock_gettime(CLOCK_REALTIME, &abstime);
+      clock_timespec_add(&abstime, timeout, &abstime);
+    }
+
+  pthread_mutex_lock(&g_gai_lock);
+
+  for (; ; )
+    {
+      pending = false;
+      for (i = 0; i < nitems; i++)
+        {
+          if (list[i] == NULL)
+            {
+              continue;
+            }
+
+          if (list[i]->__return != EAI_INPROGRESS)
+            {
+              ret = OK;
+              goto out;
+            }
+
+          pending = true;
+        }
+
+      if (!pending)
+        {
+          ret = EAI_ALLDONE;
+          break;
+        }
+
+      if (timeout != NULL)
+        {
+          ret = pthread_cond_timedwait(&g_gai_cond, &g_gai_lock, &abstime);
+        }
+      else
+        {
+          ret = pthread_cond_wait(&g_gai_cond, &g_gai_lock);
+        }
+
+      if (ret == ETIMEDOUT)
+        {
+          ret = EAI_AGAIN;
+          break;
+        }
+    }
+
+out:
+  pthread_mutex_unlock(&g_gai_lock);
+  return ret;
+}
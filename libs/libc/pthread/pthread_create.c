@@ -27,6 +27,7 @@
 #include <assert.h>
 
 #include <nuttx/pthread.h>
+#include <nuttx/tls.h>
 
 /****************************************************************************
  * Private Functions
@@ -86,6 +87,12 @@ static void pthread_startup(pthread_startroutine_t entry,
 int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr,
                    pthread_startroutine_t pthread_entry, pthread_addr_t arg)
 {
+#ifdef CONFIG_FILE_STREAM
+  /* From now on the streams of the task group have to be locked */
+
+  task_get_info()->ta_multithread = true;
+#endif
+
   return nx_pthread_create(pthread_startup, thread, attr, pthread_entry,
                            arg);
 }
@@ -38,9 +38,9 @@ int pthread_rwlock_init(FAR pthread_rwlock_t *lock,
 {
   int err;
 
-  lock->num_readers       = 0;
-  lock->num_writers       = 0;
-  lock->write_in_progress = false;
+  lock->state       = 0;
+  lock->num_writers = 0;
+  lock->num_waiters = 0;
 
   err = pthread_cond_init(&lock->cv, NULL);
   if (err != 0)
@@ -73,34 +73,46 @@ int pthread_rwlock_destroy(FAR pthread_rwlock_t *lock)
 
 int pthread_rwlock_unlock(FAR pthread_rwlock_t *rw_lock)
 {
-  int err;
+  unsigned int newstate;
+  unsigned int state;
+  int err = 0;
 
-  err = pthread_mutex_lock(&rw_lock->lock);
-  if (err != 0)
+  state = __atomic_load_n(&rw_lock->state, __ATOMIC_RELAXED);
+  do
     {
-      return err;
+      if ((state & PTHREAD_RWLOCK_WRITER) != 0)
+        {
+          newstate = state & ~PTHREAD_RWLOCK_WRITER;
+        }
+      else if ((state & PTHREAD_RWLOCK_READERS) != 0)
+        {
+          newstate = state - 1;
+        }
+      else
+        {
+          return EINVAL;
+        }
     }
+  while (!__atomic_compare_exchange_n(&rw_lock->state, &state, newstate,
+                                      true, __ATOMIC_RELEASE,
+                                      __ATOMIC_RELAXED));
 
-  if (rw_lock->num_readers > 0)
-    {
-      rw_lock->num_readers--;
+  /* Only the release of the last holder can unblock a waiter, and only
+   * then is the mutex needed.
+   */
 
-      if (rw_lock->num_readers == 0)
+  if ((newstate & PTHREAD_RWLOCK_WAITERS) != 0 &&
+      (newstate & (PTHREAD_RWLOCK_WRITER | PTHREAD_RWLOCK_READERS)) == 0)
+    {
+      err = pthread_mutex_lock(&rw_lock->lock);
+      if (err != 0)
         {
-          err = pthread_cond_broadcast(&rw_lock->cv);
+          return err;
         }
-    }
-  else if (rw_lock->write_in_progress)
-    {
-      rw_lock->write_in_progress = false;
 
       err = pthread_cond_broadcast(&rw_lock->cv);
-    }
-  else
-    {
-      err = EINVAL;
+      pthread_mutex_unlock(&rw_lock->lock);
     }
 
-  pthread_mutex_unlock(&rw_lock->lock);
   return err;
 }
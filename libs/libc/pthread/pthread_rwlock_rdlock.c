@@ -24,6 +24,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <pthread.h>
 #include <errno.h>
@@ -33,34 +34,77 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: rdlock_endwait
+ *
+ * Description:
+ *   Stop waiting for the lock.  Called with the mutex held.
+ *
+ ****************************************************************************/
+
+static void rdlock_endwait(FAR pthread_rwlock_t *rw_lock)
+{
+  if (--rw_lock->num_waiters == 0)
+    {
+      __atomic_fetch_and(&rw_lock->state, ~PTHREAD_RWLOCK_WAITERS,
+                         __ATOMIC_RELAXED);
+    }
+}
+
 #if defined(CONFIG_PTHREAD_CLEANUP_STACKSIZE) && CONFIG_PTHREAD_CLEANUP_STACKSIZE > 0
 static void rdlock_cleanup(FAR void *arg)
 {
   FAR pthread_rwlock_t *rw_lock = (FAR pthread_rwlock_t *)arg;
 
+  rdlock_endwait(rw_lock);
   pthread_mutex_unlock(&rw_lock->lock);
 }
 #endif
 
-static int tryrdlock(FAR pthread_rwlock_t *rw_lock)
+/****************************************************************************
+ * Name: tryrdlock
+ *
+ * Description:
+ *   Take the lock for reading unless a writer holds it.  With
+ *   CONFIG_PTHREAD_RWLOCK_PREFER_WRITER, a waiting writer also keeps new
+ *   readers out; 'waiting' tells whether the mutex is held, so that the
+ *   waiting writers can be counted.
+ *
+ ****************************************************************************/
+
+static int tryrdlock(FAR pthread_rwlock_t *rw_lock, bool waiting)
 {
-  int err;
+  unsigned int busy = PTHREAD_RWLOCK_WRITER;
+  unsigned int state;
 
-  if (rw_lock->num_writers > 0 || rw_lock->write_in_progress)
+#ifdef CONFIG_PTHREAD_RWLOCK_PREFER_WRITER
+  if (!waiting)
     {
-      err = EBUSY;
+      busy |= PTHREAD_RWLOCK_WAITERS;
     }
-  else if (rw_lock->num_readers == UINT_MAX)
+  else if (rw_lock->num_writers > 0)
     {
-      err = EAGAIN;
+      return EBUSY;
     }
-  else
+#endif
+
+  state = __atomic_load_n(&rw_lock->state, __ATOMIC_RELAXED);
+  do
     {
-      rw_lock->num_readers++;
-      err = OK;
+      if ((state & busy) != 0)
+        {
+          return EBUSY;
+        }
+      else if ((state & PTHREAD_RWLOCK_READERS) == PTHREAD_RWLOCK_READERS)
+        {
+          return EAGAIN;
+        }
     }
+  while (!__atomic_compare_exchange_n(&rw_lock->state, &state, state + 1,
+                                      true, __ATOMIC_ACQUIRE,
+                                      __ATOMIC_RELAXED));
 
-  return err;
+  return OK;
 }
 
 /****************************************************************************
@@ -85,34 +129,39 @@ static int tryrdlock(FAR pthread_rwlock_t *rw_lock)
 
 int pthread_rwlock_tryrdlock(FAR pthread_rwlock_t *rw_lock)
 {
-  int err = pthread_mutex_trylock(&rw_lock->lock);
-
-  if (err != 0)
-    {
-      return err;
-    }
-
-  err = tryrdlock(rw_lock);
-
-  pthread_mutex_unlock(&rw_lock->lock);
-  return err;
+  return tryrdlock(rw_lock, false);
 }
 
 int pthread_rwlock_clockrdlock(FAR pthread_rwlock_t *rw_lock,
                                clockid_t clockid,
                                FAR const struct timespec *ts)
 {
-  int err = pthread_mutex_lock(&rw_lock->lock);
+  int err;
+
+  /* The fast path touches nothing but the lock state */
+
+  err = tryrdlock(rw_lock, false);
+  if (err != EBUSY)
+    {
+      return err;
+    }
 
+  err = pthread_mutex_lock(&rw_lock->lock);
   if (err != 0)
     {
       return err;
     }
 
+  /* Have the holder that releases the lock wake us up */
+
+  rw_lock->num_waiters++;
+  __atomic_fetch_or(&rw_lock->state, PTHREAD_RWLOCK_WAITERS,
+                    __ATOMIC_SEQ_CST);
+
 #if defined(CONFIG_PTHREAD_CLEANUP_STACKSIZE) && CONFIG_PTHREAD_CLEANUP_STACKSIZE > 0
   pthread_cleanup_push(&rdlock_cleanup, rw_lock);
 #endif
-  while ((err = tryrdlock(rw_lock)) == EBUSY)
+  while ((err = tryrdlock(rw_lock, true)) == EBUSY)
     {
       if (ts != NULL)
         {
@@ -134,6 +183,7 @@ int pthread_rwlock_clockrdlock(FAR pthread_rwlock_t *rw_lock,
   pthread_cleanup_pop(0);
 #endif
 
+  rdlock_endwait(rw_lock);
   pthread_mutex_unlock(&rw_lock->lock);
   return err;
 }
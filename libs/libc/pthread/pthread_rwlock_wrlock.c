@@ -33,16 +33,65 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wrlock_endwait
+ *
+ * Description:
+ *   Stop waiting for the lock.  Called with the mutex held.
+ *
+ ****************************************************************************/
+
+static void wrlock_endwait(FAR pthread_rwlock_t *rw_lock)
+{
+  rw_lock->num_writers--;
+  if (--rw_lock->num_waiters == 0)
+    {
+      __atomic_fetch_and(&rw_lock->state, ~PTHREAD_RWLOCK_WAITERS,
+                         __ATOMIC_RELAXED);
+    }
+}
+
 #if defined(CONFIG_PTHREAD_CLEANUP_STACKSIZE) && CONFIG_PTHREAD_CLEANUP_STACKSIZE > 0
 static void wrlock_cleanup(FAR void *arg)
 {
   FAR pthread_rwlock_t *rw_lock = (FAR pthread_rwlock_t *)arg;
 
-  rw_lock->num_writers--;
+  /* Readers may have waited behind this writer */
+
+  pthread_cond_broadcast(&rw_lock->cv);
+  wrlock_endwait(rw_lock);
   pthread_mutex_unlock(&rw_lock->lock);
 }
 #endif
 
+/****************************************************************************
+ * Name: trywrlock
+ *
+ * Description:
+ *   Take the lock for writing unless it is held.
+ *
+ ****************************************************************************/
+
+static int trywrlock(FAR pthread_rwlock_t *rw_lock)
+{
+  unsigned int state;
+
+  state = __atomic_load_n(&rw_lock->state, __ATOMIC_RELAXED);
+  do
+    {
+      if ((state & (PTHREAD_RWLOCK_WRITER | PTHREAD_RWLOCK_READERS)) != 0)
+        {
+          return EBUSY;
+        }
+    }
+  while (!__atomic_compare_exchange_n(&rw_lock->state, &state,
+                                      state | PTHREAD_RWLOCK_WRITER,
+                                      true, __ATOMIC_ACQUIRE,
+                                      __ATOMIC_RELAXED));
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,32 +114,23 @@ static void wrlock_cleanup(FAR void *arg)
 
 int pthread_rwlock_trywrlock(FAR pthread_rwlock_t *rw_lock)
 {
-  int err = pthread_mutex_trylock(&rw_lock->lock);
-
-  if (err != 0)
-    {
-      return err;
-    }
-
-  if (rw_lock->num_readers > 0 || rw_lock->write_in_progress)
-    {
-      err = EBUSY;
-    }
-  else
-    {
-      rw_lock->write_in_progress = true;
-    }
-
-  pthread_mutex_unlock(&rw_lock->lock);
-  return err;
+  return trywrlock(rw_lock);
 }
 
 int pthread_rwlock_clockwrlock(FAR pthread_rwlock_t *rw_lock,
                                clockid_t clockid,
                                FAR const struct timespec *ts)
 {
-  int err = pthread_mutex_lock(&rw_lock->lock);
+  int err;
+
+  /* The fast path touches nothing but the lock state */
+
+  if (trywrlock(rw_lock) == OK)
+    {
+      return OK;
+    }
 
+  err = pthread_mutex_lock(&rw_lock->lock);
   if (err != 0)
     {
       return err;
@@ -102,12 +142,17 @@ int pthread_rwlock_clockwrlock(FAR pthread_rwlock_t *rw_lock,
       goto exit_with_mutex;
     }
 
+  /* Have the holder that releases the lock wake us up */
+
   rw_lock->num_writers++;
+  rw_lock->num_waiters++;
+  __atomic_fetch_or(&rw_lock->state, PTHREAD_RWLOCK_WAITERS,
+                    __ATOMIC_SEQ_CST);
 
 #if defined(CONFIG_PTHREAD_CLEANUP_STACKSIZE) && CONFIG_PTHREAD_CLEANUP_STACKSIZE > 0
   pthread_cleanup_push(&wrlock_cleanup, rw_lock);
 #endif
-  while (rw_lock->write_in_progress || rw_lock->num_readers > 0)
+  while ((err = trywrlock(rw_lock)) == EBUSY)
     {
       if (ts != NULL)
         {
@@ -129,18 +174,14 @@ int pthread_rwlock_clockwrlock(FAR pthread_rwlock_t *rw_lock,
   pthread_cleanup_pop(0);
 #endif
 
-  if (err == 0)
-    {
-      rw_lock->write_in_progress = true;
-    }
-  else
+  if (err != 0)
     {
       /* In case of error, notify any blocked readers. */
 
       pthread_cond_broadcast(&rw_lock->cv);
     }
 
-  rw_lock->num_writers--;
+  wrlock_endwait(rw_lock);
 
 exit_with_mutex:
   pthread_mutex_unlock(&rw_lock->lock);
@@ -3925,6 +3925,10 @@ int regcomp(regex_t *restrict preg, const char *restrict regex, int cflags)
   tnfa->num_states      = parse_ctx.position;
   tnfa->cflags          = cflags;
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+  tnfa->dfa             = tre_dfa_new(tnfa);
+#endif
+
   tre_mem_destroy(mem);
   tre_stack_destroy(stack);
   xfree(counts);
@@ -4032,5 +4036,9 @@ void regfree(regex_t *preg)
       xfree(tnfa->minimal_tags);
     }
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+  tre_dfa_free(tnfa->dfa);
+#endif
+
   xfree(tnfa);
 }
@@ -138,8 +138,8 @@ static int tre_tag_order(int num_tags, tre_tag_direction_t *tag_directions,
   return 0;
 }
 
-static int tre_neg_char_classes_match(tre_ctype_t *classes, tre_cint_t wc,
-                                      int icase)
+int tre_neg_char_classes_match(tre_ctype_t *classes, tre_cint_t wc,
+                               int icase)
 {
   while (*classes != (tre_ctype_t)0)
     {
@@ -1227,6 +1227,18 @@ int regexec(const regex_t *restrict preg, const char *restrict string,
       nmatch = 0;
     }
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+  /* The DFA answers whether the string matches.  The TNFA only needs to be
+   * run for the strings that do and only if the submatches are wanted.
+   */
+
+  status = tre_dfa_run(tnfa, string, eflags);
+  if (status == REG_NOMATCH || (status == REG_OK && nmatch == 0))
+    {
+      return status;
+    }
+#endif
+
   if (tnfa->num_tags > 0 && nmatch > 0)
     {
       tags = xmalloc(sizeof(*tags) * tnfa->num_tags);
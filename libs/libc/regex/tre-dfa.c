@@ -0,0 +1,561 @@
+/****************************************************************************
+ * libs/libc/regex/tre-dfa.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/*  This matcher only tells whether the string matches.  It runs the TNFA
+ *  without its tags as a DFA whose states are the sets of TNFA states that
+ *  the parallel matcher would reach, built the first time that they are
+ *  needed and kept in the compiled regex for the following calls.  Each
+ *  character then costs a table lookup once the states it leads to have
+ *  been built, and at most one walk over the TNFA otherwise.
+ *
+ *  The assertions of a transition are checked against the characters
+ *  before and after the position that it reaches.  The character before is
+ *  the one consumed, so a DFA transition is selected by the class of that
+ *  character and by the class of the next one.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include <nuttx/mutex.h>
+
+#include "tre.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The classes of the next character that the assertions tell apart */
+
+#define DFA_NEXT_OTHER      0
+#define DFA_NEXT_WORD       1
+#define DFA_NEXT_NL         2
+#define DFA_NEXT_NUL        3
+#define DFA_NEXT_NUL_NOTEOL 4
+#define DFA_NNEXT           5
+
+#define ASSERT_CONTEXT      (ASSERT_AT_BOL | ASSERT_AT_EOL | ASSERT_AT_BOW | \
+                             ASSERT_AT_EOW | ASSERT_AT_WB | ASSERT_AT_WB_NEG)
+
+#define IS_WORD_CHAR(c)     ((c) == L'_' || tre_isalnum(c))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tre_dfa_state_s
+{
+  struct tre_dfa_state_s **next; /* Successors by byte class and next
+                                  * character class, NULL until built */
+  unsigned int hash;             /* Hash of the TNFA state set */
+  int accept;                    /* The set holds the final state */
+  int nstates;                   /* Number of TNFA states in the set */
+  int *states;                   /* Their ids, in ascending order */
+};
+
+struct tre_dfa_s
+{
+  mutex_t lock;                  /* Serializes the users of the cache */
+  const tre_tnfa_t *tnfa;
+  tre_tnfa_transition_t **idmap; /* TNFA state of each state id */
+  char *mark;                    /* Scratch: the states of a new set */
+  int *set;                      /* Scratch: their ids */
+  struct tre_dfa_state_s *cache[CONFIG_LIBC_REGEX_DFA_NSTATES];
+  struct tre_dfa_state_s *start[2][DFA_NNEXT];
+  int ncached;
+  int nclasses;                  /* Number of byte classes */
+  int nnext;                     /* Number of next character classes */
+  unsigned char classes[256];    /* Byte class of each byte */
+  unsigned char nextclass[256];  /* Next character class of each byte */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Returns 1 if the character part of transition `trans' accepts `c'. */
+
+static int tre_dfa_accepts(const tre_tnfa_t *tnfa,
+                           const tre_tnfa_transition_t *trans, tre_cint_t c)
+{
+  int icase = tnfa->cflags & REG_ICASE;
+
+  if (trans->code_min > c || trans->code_max < c)
+    {
+      return 0;
+    }
+
+  if (trans->assertions & ASSERT_CHAR_CLASS)
+    {
+      if (!icase)
+        {
+          if (!tre_isctype(c, trans->u.class))
+            {
+              return 0;
+            }
+        }
+      else if (!tre_isctype(tre_tolower(c), trans->u.class) &&
+               !tre_isctype(tre_toupper(c), trans->u.class))
+        {
+          return 0;
+        }
+    }
+
+  if ((trans->assertions & ASSERT_CHAR_CLASS_NEG) &&
+      tre_neg_char_classes_match(trans->neg_classes, c, icase))
+    {
+      return 0;
+    }
+
+  return 1;
+}
+
+/* Returns 1 if the `assertions' fail between the characters `prev' and the
+ * next one of class `next', as CHECK_ASSERTIONS() of the parallel matcher.
+ */
+
+static int tre_dfa_assert_fail(const tre_tnfa_t *tnfa, int assertions,
+                               int at_start, int notbol, tre_cint_t prev,
+                               int next)
+{
+  int newline  = tnfa->cflags & REG_NEWLINE;
+  int nul      = next == DFA_NEXT_NUL || next == DFA_NEXT_NUL_NOTEOL;
+  int prevword = !at_start && IS_WORD_CHAR(prev);
+  int nextword = next == DFA_NEXT_WORD;
+
+  return ((assertions & ASSERT_AT_BOL) &&
+          (!at_start || notbol) &&
+          (at_start || prev != L'\n' || !newline)) ||
+         ((assertions & ASSERT_AT_EOL) &&
+          (!nul || next == DFA_NEXT_NUL_NOTEOL) &&
+          (next != DFA_NEXT_NL || !newline)) ||
+         ((assertions & ASSERT_AT_BOW) && (prevword || !nextword)) ||
+         ((assertions & ASSERT_AT_EOW) && (!prevword || nextword)) ||
+         ((assertions & ASSERT_AT_WB) &&
+          !at_start && !nul && prevword == nextword) ||
+         ((assertions & ASSERT_AT_WB_NEG) &&
+          (at_start || nul || prevword != nextword));
+}
+
+static int tre_dfa_nextclass(const struct tre_dfa_s *dfa, tre_cint_t c,
+                             int noteol)
+{
+  int next;
+
+  if (dfa->nnext == 1)
+    {
+      return 0;
+    }
+
+  if (c < 256)
+    {
+      next = dfa->nextclass[c];
+    }
+  else
+    {
+      next = IS_WORD_CHAR(c) ? DFA_NEXT_WORD : DFA_NEXT_OTHER;
+    }
+
+  if (next == DFA_NEXT_NUL && noteol)
+    {
+      next = DFA_NEXT_NUL_NOTEOL;
+    }
+
+  return next;
+}
+
+static void tre_dfa_flush(struct tre_dfa_s *dfa)
+{
+  int i;
+
+  for (i = 0; i < dfa->ncached; i++)
+    {
+      xfree(dfa->cache[i]);
+    }
+
+  dfa->ncached = 0;
+  memset(dfa->start, 0, sizeof(dfa->start));
+}
+
+/* Returns the DFA state of the TNFA states marked in `dfa->mark', building
+ * it if needed.  `*flushed' is set if the states built so far had to be
+ * dropped to make room for it.
+ */
+
+static struct tre_dfa_state_s *tre_dfa_lookup(struct tre_dfa_s *dfa,
+                                              int *flushed)
+{
+  const tre_tnfa_t *tnfa = dfa->tnfa;
+  struct tre_dfa_state_s *state;
+  unsigned int hash = 2166136261u;
+  size_t nnext;
+  int accept = 0;
+  int n = 0;
+  int i;
+
+  for (i = 0; i < tnfa->num_states; i++)
+    {
+      if (dfa->mark[i])
+        {
+          dfa->mark[i] = 0;
+          dfa->set[n++] = i;
+          hash = (hash ^ i) * 16777619u;
+          if (dfa->idmap[i] == tnfa->final)
+            {
+              accept = 1;
+            }
+        }
+    }
+
+  for (i = 0; i < dfa->ncached; i++)
+    {
+      state = dfa->cache[i];
+      if (state->hash == hash && state->nstates == n &&
+          memcmp(state->states, dfa->set, n * sizeof(int)) == 0)
+        {
+          return state;
+        }
+    }
+
+  if (dfa->ncached == CONFIG_LIBC_REGEX_DFA_NSTATES)
+    {
+      tre_dfa_flush(dfa);
+      *flushed = 1;
+    }
+
+  nnext = dfa->nclasses * dfa->nnext;
+  state = xcalloc(1, sizeof(*state) + nnext * sizeof(state) +
+                  n * sizeof(int));
+  if (state == NULL)
+    {
+      return NULL;
+    }
+
+  state->next    = (void *)(state + 1);
+  state->states  = (void *)(state->next + nnext);
+  state->hash    = hash;
+  state->accept  = accept;
+  state->nstates = n;
+  memcpy(state->states, dfa->set, n * sizeof(int));
+
+  dfa->cache[dfa->ncached++] = state;
+  return state;
+}
+
+/* Returns the DFA state reached from `from' on `c' followed by a character
+ * of class `next', or the initial state at the start of the string if
+ * `from' is NULL.  As in the parallel matcher, the initial states of the
+ * TNFA are added at each position so that the match may start anywhere.
+ */
+
+static struct tre_dfa_state_s *tre_dfa_step(struct tre_dfa_s *dfa,
+                                            struct tre_dfa_state_s *from,
+                                            tre_cint_t c, int next,
+                                            int notbol, int *flushed)
+{
+  const tre_tnfa_t *tnfa = dfa->tnfa;
+  tre_tnfa_transition_t *trans;
+  int at_start = from == NULL;
+  int i;
+
+  if (from != NULL)
+    {
+      for (i = 0; i < from->nstates; i++)
+        {
+          for (trans = dfa->idmap[from->states[i]]; trans->state; trans++)
+            {
+              if (!dfa->mark[trans->state_id] &&
+                  tre_dfa_accepts(tnfa, trans, c) &&
+                  !(trans->assertions &&
+                    tre_dfa_assert_fail(tnfa, trans->assertions, 0, 0, c,
+                                        next)))
+                {
+                  dfa->mark[trans->state_id] = 1;
+                }
+            }
+        }
+    }
+
+  for (trans = tnfa->initial; trans->state; trans++)
+    {
+      if (!(trans->assertions &&
+            tre_dfa_assert_fail(tnfa, trans->assertions, at_start, notbol,
+                                c, next)))
+        {
+          dfa->mark[trans->state_id] = 1;
+        }
+    }
+
+  return tre_dfa_lookup(dfa, flushed);
+}
+
+/* Splits the byte classes into those for which pred[] is 0 and 1. */
+
+static void tre_dfa_refine(struct tre_dfa_s *dfa, const char *pred,
+                           int16_t (*remap)[256])
+{
+  int n = 0;
+  int c;
+
+  memset(remap, 0xff, 2 * sizeof(*remap));
+  for (c = 0; c < 256; c++)
+    {
+      int16_t *cls = &remap[pred[c] != 0][dfa->classes[c]];
+
+      if (*cls < 0)
+        {
+          *cls = n++;
+        }
+
+      dfa->classes[c] = *cls;
+    }
+
+  dfa->nclasses = n;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* Returns a DFA for `tnfa', or NULL if out of memory or if the TNFA has
+ * back references.  The states are built later, while matching.
+ */
+
+struct tre_dfa_s *tre_dfa_new(const tre_tnfa_t *tnfa)
+{
+  struct tre_dfa_s *dfa;
+  int16_t (*remap)[256];
+  tre_tnfa_transition_t *trans;
+  unsigned int i;
+  char pred[256];
+  int context = 0;
+  int c;
+
+  if (tnfa->have_backrefs)
+    {
+      return NULL;
+    }
+
+  dfa = xcalloc(1, sizeof(*dfa) + tnfa->num_states *
+                (sizeof(*dfa->idmap) + sizeof(*dfa->set) + 1));
+  remap = xmalloc(2 * sizeof(*remap));
+  if (dfa == NULL || remap == NULL)
+    {
+      xfree(remap);
+      xfree(dfa);
+      return NULL;
+    }
+
+  dfa->tnfa  = tnfa;
+  dfa->idmap = (void *)(dfa + 1);
+  dfa->set   = (void *)(dfa->idmap + tnfa->num_states);
+  dfa->mark  = (void *)(dfa->set + tnfa->num_states);
+
+  for (trans = tnfa->initial; trans->state; trans++)
+    {
+      dfa->idmap[trans->state_id] = trans->state;
+      context |= trans->assertions;
+    }
+
+  /* Bytes that no transition and no assertion tell apart share a class
+   * and so the successors of the DFA states.
+   */
+
+  dfa->nclasses = 1;
+  for (i = 0; i < tnfa->num_transitions; i++)
+    {
+      trans = &tnfa->transitions[i];
+      if (trans->state == NULL)
+        {
+          continue;
+        }
+
+      dfa->idmap[trans->state_id] = trans->state;
+      context |= trans->assertions;
+
+      for (c = 0; c < 256; c++)
+        {
+          pred[c] = tre_dfa_accepts(tnfa, trans, c);
+        }
+
+      tre_dfa_refine(dfa, pred, remap);
+    }
+
+  for (c = 0; c < 256; c++)
+    {
+      dfa->nextclass[c] = c == 0 ? DFA_NEXT_NUL :
+                          c == L'\n' ? DFA_NEXT_NL :
+                          IS_WORD_CHAR(c) ? DFA_NEXT_WORD : DFA_NEXT_OTHER;
+    }
+
+  dfa->nnext = 1;
+  if (context & ASSERT_CONTEXT)
+    {
+      dfa->nnext = DFA_NNEXT;
+      for (c = 0; c < 256; c++)
+        {
+          pred[c] = dfa->nextclass[c] == DFA_NEXT_WORD;
+        }
+
+      tre_dfa_refine(dfa, pred, remap);
+      for (c = 0; c < 256; c++)
+        {
+          pred[c] = c == L'\n';
+        }
+
+      tre_dfa_refine(dfa, pred, remap);
+    }
+
+  xfree(remap);
+  nxmutex_init(&dfa->lock);
+  return dfa;
+}
+
+void tre_dfa_free(struct tre_dfa_s *dfa)
+{
+  if (dfa != NULL)
+    {
+      tre_dfa_flush(dfa);
+      nxmutex_destroy(&dfa->lock);
+      xfree(dfa);
+    }
+}
+
+/* Returns REG_OK if `string' matches, REG_NOMATCH if it does not, or
+ * REG_ENOSYS if the DFA cannot be used now and another matcher has to
+ * answer: if it is used by another thread or if out of memory.
+ */
+
+reg_errcode_t tre_dfa_run(const tre_tnfa_t *tnfa, const char *string,
+                          int eflags)
+{
+  struct tre_dfa_s *dfa = tnfa->dfa;
+  struct tre_dfa_state_s *state;
+  struct tre_dfa_state_s *next;
+  const char *str_byte = string;
+  int notbol = (eflags & REG_NOTBOL) != 0;
+  int noteol = (eflags & REG_NOTEOL) != 0;
+  reg_errcode_t ret = REG_NOMATCH;
+  tre_char_t next_c;
+  tre_cint_t c;
+  int nextclass;
+  int flushed;
+  int len;
+
+  if (dfa == NULL || nxmutex_trylock(&dfa->lock) < 0)
+    {
+      return REG_ENOSYS;
+    }
+
+  /* Decode the characters as GET_NEXT_WCHAR() does, ASCII directly */
+
+#define DFA_NEXT_WCHAR()                                  \
+  do                                                      \
+    {                                                     \
+      if ((unsigned char)*str_byte < 0x80)                \
+        {                                                 \
+          next_c = (unsigned char)*str_byte++;            \
+        }                                                 \
+      else if ((len = mbtowc(&next_c, str_byte,           \
+                             MB_LEN_MAX)) < 0)            \
+        {                                                 \
+          goto out;                                       \
+        }                                                 \
+      else                                                \
+        {                                                 \
+          str_byte += len > 0 ? len : 1;                  \
+        }                                                 \
+    }                                                     \
+  while (0)
+
+  DFA_NEXT_WCHAR();
+  nextclass = tre_dfa_nextclass(dfa, next_c, noteol);
+  state = dfa->start[notbol][nextclass];
+  if (state == NULL)
+    {
+      flushed = 0;
+      state = tre_dfa_step(dfa, NULL, 0, nextclass, notbol, &flushed);
+      if (state == NULL)
+        {
+          ret = REG_ENOSYS;
+          goto out;
+        }
+
+      dfa->start[notbol][nextclass] = state;
+    }
+
+  while (!state->accept)
+    {
+      if (next_c == 0)
+        {
+          goto out;
+        }
+
+      c = next_c;
+      DFA_NEXT_WCHAR();
+      nextclass = tre_dfa_nextclass(dfa, next_c, noteol);
+
+      if (c < 256)
+        {
+          struct tre_dfa_state_s **slot =
+            &state->next[dfa->classes[c] * dfa->nnext + nextclass];
+
+          if (*slot != NULL)
+            {
+              state = *slot;
+              continue;
+            }
+
+          flushed = 0;
+          next = tre_dfa_step(dfa, state, c, nextclass, notbol, &flushed);
+          if (next != NULL && !flushed)
+            {
+              *slot = next;
+            }
+        }
+      else
+        {
+          next = tre_dfa_step(dfa, state, c, nextclass, notbol, &flushed);
+        }
+
+      if (next == NULL)
+        {
+          ret = REG_ENOSYS;
+          goto out;
+        }
+
+      state = next;
+    }
+
+  ret = REG_OK;
+
+out:
+#undef DFA_NEXT_WCHAR
+  nxmutex_unlock(&dfa->lock);
+  return ret;
+}
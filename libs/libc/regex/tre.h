@@ -38,6 +38,8 @@
 #ifndef _REGEX_TRE_H
 #define _REGEX_TRE_H
 
+#include <nuttx/config.h>
+
 #include <regex.h>
 #include <wchar.h>
 #include <wctype.h>
@@ -213,6 +215,9 @@ struct tnfa
   int cflags;
   int have_backrefs;
   int have_approx;
+#ifdef CONFIG_LIBC_REGEX_DFA
+  struct tre_dfa_s *dfa;
+#endif
 };
 
 /* from tre-mem.h: */
@@ -280,6 +285,38 @@ void *tre_mem_alloc_impl(tre_mem_t mem, int provided, void *provided_block,
 
 void tre_mem_destroy(tre_mem_t mem);
 
+/* from regexec.c: */
+
+#define tre_neg_char_classes_match  __tre_neg_char_classes_match
+
+int tre_neg_char_classes_match(tre_ctype_t *classes, tre_cint_t wc,
+                               int icase);
+
+/* from tre-dfa.c: */
+
+#ifdef CONFIG_LIBC_REGEX_DFA
+#define tre_dfa_new   __tre_dfa_new
+#define tre_dfa_free  __tre_dfa_free
+#define tre_dfa_run   __tre_dfa_run
+
+/* Returns the DFA that answers whether strings match `tnfa', or NULL if
+ *  out of memory or if `tnfa' has back references.
+ */
+
+struct tre_dfa_s *tre_dfa_new(const tre_tnfa_t *tnfa);
+
+/* Frees the DFA and all the states built for it. */
+
+void tre_dfa_free(struct tre_dfa_s *dfa);
+
+/* Returns REG_OK or REG_NOMATCH, or REG_ENOSYS if the DFA cannot answer
+ *  now and the TNFA has to be run instead.
+ */
+
+reg_errcode_t tre_dfa_run(const tre_tnfa_t *tnfa, const char *string,
+                          int eflags);
+#endif
+
 #define xmalloc     malloc
 #define xcalloc     calloc
 #define xfree       free
@@ -0,0 +1,104 @@
+/****************************************************************************
+ * libs/libc/sched/sched_getattr.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+static uint64_t sched_timespec2ns(FAR const struct timespec *ts)
+{
+  return (uint64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_getattr
+ *
+ * Description:
+ *   Get the scheduling policy and attributes of the thread identified by
+ *   pid.  This is the Linux-compatible counterpart of sched_setattr().
+ *
+ * Input Parameters:
+ *   pid   - The ID of the thread to query.  Zero selects the calling
+ *           thread.
+ *   attr  - The location to return the scheduling policy and attributes.
+ *   size  - The size of the structure at attr.
+ *   flags - Reserved, must be zero.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise -1 (ERROR) is returned and errno is
+ *   set appropriately:
+ *
+ *   EINVAL attr is NULL, size is too small or flags is not zero.
+ *   ESRCH  The thread whose ID is pid could not be found.
+ *
+ ****************************************************************************/
+
+int sched_getattr(pid_t pid, FAR struct sched_attr *attr,
+                  unsigned int size, unsigned int flags)
+{
+  struct sched_param param;
+  int policy;
+
+  if (attr == NULL || size < sizeof(struct sched_attr) || flags != 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  policy = sched_getscheduler(pid);
+  if (policy < 0 || sched_getparam(pid, &param) < 0)
+    {
+      return ERROR;
+    }
+
+  memset(attr, 0, sizeof(struct sched_attr));
+  attr->size           = sizeof(struct sched_attr);
+  attr->sched_policy   = (uint32_t)policy;
+  attr->sched_priority = (uint32_t)param.sched_priority;
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if (policy == SCHED_DEADLINE)
+    {
+      attr->sched_runtime  = sched_timespec2ns(&param.sched_dl_runtime);
+      attr->sched_deadline = sched_timespec2ns(&param.sched_dl_deadline);
+      attr->sched_period   = sched_timespec2ns(&param.sched_dl_period);
+    }
+#endif
+
+  return OK;
+}
@@ -0,0 +1,100 @@
+/****************************************************************************
+ * libs/libc/sched/sched_setattr.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_DEADLINE
+static void sched_ns2timespec(uint64_t nsec, FAR struct timespec *ts)
+{
+  ts->tv_sec  = (time_t)(nsec / NSEC_PER_SEC);
+  ts->tv_nsec = (long)(nsec % NSEC_PER_SEC);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_setattr
+ *
+ * Description:
+ *   Set the scheduling policy and attributes of the thread identified by
+ *   pid.  This is the Linux-compatible interface for SCHED_DEADLINE: the
+ *   runtime, deadline and period attributes are provided in nanoseconds.
+ *   For the other policies, only sched_priority is used.  This is a thin
+ *   wrapper around sched_setscheduler().
+ *
+ * Input Parameters:
+ *   pid   - The ID of the thread to modify.  Zero selects the calling
+ *           thread.
+ *   attr  - The new scheduling policy and attributes.
+ *   flags - Reserved, must be zero.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise -1 (ERROR) is returned and errno is
+ *   set appropriately:
+ *
+ *   EINVAL attr is NULL, flags or sched_flags is not zero, or the policy
+ *          or its attributes are not valid.
+ *   EBUSY  The SCHED_DEADLINE request failed admission control.
+ *   ESRCH  The thread whose ID is pid could not be found.
+ *
+ ****************************************************************************/
+
+int sched_setattr(pid_t pid, FAR const struct sched_attr *attr,
+                  unsigned int flags)
+{
+  struct sched_param param;
+
+  if (attr == NULL || flags != 0 || attr->sched_flags != 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  memset(&param, 0, sizeof(param));
+  param.sched_priority = (int)attr->sched_priority;
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if (attr->sched_policy == SCHED_DEADLINE)
+    {
+      sched_ns2timespec(attr->sched_runtime, &param.sched_dl_runtime);
+      sched_ns2timespec(attr->sched_deadline, &param.sched_dl_deadline);
+      sched_ns2timespec(attr->sched_period, &param.sched_dl_period);
+    }
+#endif
+
+  return sched_setscheduler(pid, (int)attr->sched_policy, &param);
+}
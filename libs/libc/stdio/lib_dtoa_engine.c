@@ -93,6 +93,19 @@ int __dtoa_engine(double x, FAR struct dtoa_s *dtoa, int max_digits,
     {
       double y;
 
+#ifdef CONFIG_LIBC_DTOA_RYU
+      i = __dtoa_ryu(x, dtoa, max_digits, max_decimals);
+      if (i >= 0)
+        {
+          dtoa->flags = flags;
+          return i;
+        }
+
+      /* The scaling below gives only up to DBL_DIG digits */
+
+      max_digits = MIN(max_digits, DBL_DIG);
+#endif
+
       exp = MIN_MANT_EXP;
 
       /* Bring x within range MIN_MANT <= x < MAX_MANT while computing
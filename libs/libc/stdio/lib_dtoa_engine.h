@@ -40,6 +40,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <stdint.h>
 #include <float.h>
 
@@ -47,7 +49,19 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define DTOA_MAX_DIG        DBL_DIG
+/* Ryu gives the 17 digits needed to read a double back exactly */
+
+#ifdef CONFIG_LIBC_DTOA_RYU
+#  define DTOA_MAX_DIG      17
+#else
+#  define DTOA_MAX_DIG      DBL_DIG
+#endif
+
+/* max_digits for __dtoa_ryu() to get the shortest digits that read back
+ * as the same double, rather than a correctly rounded fixed number.
+ */
+
+#define DTOA_SHORTEST       (-1)
 
 #define DTOA_MINUS          1
 #define DTOA_ZERO           2
@@ -186,4 +200,9 @@ extern const double g_dtoa_round[];
 int __dtoa_engine(double x, FAR struct dtoa_s *dtoa, int max_digits,
                   int max_decimals);
 
+#ifdef CONFIG_LIBC_DTOA_RYU
+int __dtoa_ryu(double x, FAR struct dtoa_s *dtoa, int max_digits,
+               int max_decimals);
+#endif
+
 #endif /* __LIBS_LIBC_STDIO_LIB_DTOA_ENGINE_H */
@@ -52,7 +52,7 @@
  *
  ****************************************************************************/
 
-int fflush(FAR FILE *stream)
+int fflush_unlocked(FAR FILE *stream)
 {
   int ret;
 
@@ -66,7 +66,7 @@ int fflush(FAR FILE *stream)
     }
   else
     {
-      ret = lib_fflush(stream, true);
+      ret = lib_fflush_unlocked(stream, true);
     }
 
   /* Check the return value */
@@ -86,3 +86,19 @@ int fflush(FAR FILE *stream)
 
   return OK;
 }
+
+int fflush(FAR FILE *stream)
+{
+  int ret;
+
+  if (!stream)
+    {
+      return fflush_unlocked(NULL);
+    }
+
+  flockfile(stream);
+  ret = fflush_unlocked(stream);
+  funlockfile(stream);
+
+  return ret;
+}
@@ -32,6 +32,26 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/tls.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_lockneeded
+ *
+ * Description:
+ *   The streams belong to the task group.  As long as it has no pthreads,
+ *   only the calling thread can use them and the locks are omitted.  Once
+ *   pthread_create() has been called they are always taken.
+ *
+ ****************************************************************************/
+
+static inline bool lib_lockneeded(void)
+{
+  return task_get_info()->ta_multithread;
+}
 
 /****************************************************************************
  * Public Functions
@@ -43,7 +63,10 @@
 
 void flockfile(FAR struct file_struct *stream)
 {
-  nxrmutex_lock(&stream->fs_lock);
+  if (lib_lockneeded())
+    {
+      nxrmutex_lock(&stream->fs_lock);
+    }
 }
 
 /****************************************************************************
@@ -52,7 +75,7 @@ void flockfile(FAR struct file_struct *stream)
 
 int ftrylockfile(FAR struct file_struct *stream)
 {
-  return nxrmutex_trylock(&stream->fs_lock);
+  return lib_lockneeded() ? nxrmutex_trylock(&stream->fs_lock) : OK;
 }
 
 /****************************************************************************
@@ -61,5 +84,12 @@ int ftrylockfile(FAR struct file_struct *stream)
 
 void funlockfile(FAR struct file_struct *stream)
 {
-  nxrmutex_unlock(&stream->fs_lock);
+  /* The lock was not taken if the first pthread was created after the
+   * stream was locked.
+   */
+
+  if (lib_lockneeded() && nxrmutex_is_hold(&stream->fs_lock))
+    {
+      nxrmutex_unlock(&stream->fs_lock);
+    }
 }
@@ -126,11 +126,11 @@ ssize_t lib_fread_unlocked(FAR void *ptr, size_t count, FAR FILE *stream)
 
               if (gulp_size > 0)
                 {
-                  if (gulp_size > count)
+                  if (gulp_size > remaining)
                     {
-                      /* Clip the gulp size to the requested byte count */
+                      /* Clip the gulp size to the remaining byte count */
 
-                      gulp_size = count;
+                      gulp_size = remaining;
                     }
 
                   memcpy(dest, stream->fs_bufpos, gulp_size);
@@ -164,13 +164,17 @@ ssize_t lib_fread_unlocked(FAR void *ptr, size_t count, FAR FILE *stream)
 
                   /* Will the number of bytes that we need to read fit into
                    * the buffer space that is available? If the read size is
-                   * larger than the buffer, then read some of the data
-                   * directly into the user's buffer.
+                   * larger than the buffer, then read whole buffers of the
+                   * data directly into the user's buffer.  The rest is read
+                   * through the buffer, which keeps the reads aligned to
+                   * its size.
                    */
 
-                  if (remaining > buffer_available)
+                  if (remaining >= buffer_available)
                     {
-                      bytes_read = _NX_READ(stream->fs_fd, dest, remaining);
+                      bytes_read = _NX_READ(stream->fs_fd, dest,
+                                            remaining - remaining %
+                                            buffer_available);
                       if (bytes_read < 0)
                         {
                           if (count - remaining > 0)
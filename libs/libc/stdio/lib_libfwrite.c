@@ -51,6 +51,7 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
   FAR const unsigned char *src   = ptr;
   ssize_t ret = ERROR;
   size_t gulp_size;
+  size_t bufsize;
 
   /* Make sure that writing to this stream is allowed */
 
@@ -94,8 +95,9 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
 
   /* Determine the number of bytes left in the buffer */
 
+  bufsize   = stream->fs_bufend - stream->fs_bufstart;
   gulp_size = stream->fs_bufend - stream->fs_bufpos;
-  if (gulp_size != CONFIG_STDIO_BUFFER_SIZE || count < gulp_size)
+  if (gulp_size != bufsize || count < gulp_size)
     {
       if (gulp_size > count)
         {
@@ -130,9 +132,27 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
         }
     }
 
-  if (count >= CONFIG_STDIO_BUFFER_SIZE)
+  if (count > 0 && stream->fs_bufpos != stream->fs_bufstart)
     {
-      ret = _NX_WRITE(stream->fs_fd, src, count);
+      /* The buffer was only partially flushed.  Its data has to be
+       * written first, only buffer as much more as fits.
+       */
+
+      gulp_size = stream->fs_bufend - stream->fs_bufpos;
+      if (count > gulp_size)
+        {
+          count = gulp_size;
+        }
+    }
+  else if (count >= bufsize)
+    {
+      /* Write whole buffers of data directly, without copying it.  Only
+       * the rest goes through the buffer, so that the writes from the
+       * buffer stay aligned to its size.
+       */
+
+      gulp_size = count - count % bufsize;
+      ret = _NX_WRITE(stream->fs_fd, src, gulp_size);
       if (ret < 0)
         {
           _NX_SETERRNO(ret);
@@ -140,9 +160,11 @@ ssize_t lib_fwrite_unlocked(FAR const void *ptr, size_t count,
           goto errout;
         }
 
-      src += ret;
+      src  += ret;
+      count = (size_t)ret < gulp_size ? 0 : count - gulp_size;
     }
-  else if (count > 0)
+
+  if (count > 0)
     {
       memcpy(stream->fs_bufpos, src, count);
       stream->fs_bufpos += count;
@@ -24,7 +24,10 @@
 
 #include <nuttx/config.h>
 #include <assert.h>
+#include <fcntl.h>
 
+#include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
 #include <nuttx/tls.h>
 #include <nuttx/lib/lib.h>
 
@@ -65,11 +68,34 @@ FAR struct streamlist *lib_get_streams(void)
  *   Return a pointer to the file stream for this thread and given fd.
  *   Note: only reserved fd number 0/1/2 is valid.
  *
+ *   The standard streams are not set up when a task is created, which
+ *   would cost every new task the time even if it never uses stdio.
+ *   Instead each is set up here the first time it is used.
+ *
  ****************************************************************************/
 
 FAR struct file_struct *lib_get_stream(int fd)
 {
-  return &lib_get_streams()->sl_std[fd];
+  FAR struct streamlist *list = lib_get_streams();
+  FAR struct file_struct *stream = &list->sl_std[fd];
+
+  /* fs_fdopen() stores fs_oflags with release semantics once the stream
+   * is set up, so a non-zero value read with acquire semantics means that
+   * the rest of the stream can be used.
+   */
+
+  if (__atomic_load_n(&stream->fs_oflags, __ATOMIC_ACQUIRE) == 0)
+    {
+      nxmutex_lock(&list->sl_lock);
+      if (stream->fs_oflags == 0)
+        {
+          fs_fdopen(fd, fd == 0 ? O_RDONLY : O_WROK | O_CREAT, NULL, NULL);
+        }
+
+      nxmutex_unlock(&list->sl_lock);
+    }
+
+  return stream;
 }
 
 #endif /* CONFIG_FILE_STREAM */
@@ -117,6 +117,21 @@
 
 #define fmt_ungetc(fmt)   ((fmt)--)
 
+/* The literal text of the format string can be written in runs when it is
+ * in data space
+ */
+
+#if !defined(CONFIG_ARCH_ROMGETC) && !defined(CONFIG_AVR_HAS_MEMX_PTR)
+#  define FMT_LITERAL_RUNS
+#endif
+
+/* The flags an integer conversion may have to be written without padding,
+ * alternate form or explicit sign
+ */
+
+#define FL_PLAIN_INT      (FL_ARGNUMBER | FL_LONG | FL_SHORT | \
+                           FL_REPD_TYPE | FL_NEGATIVE)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -182,6 +197,9 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
   size_t size;
   unsigned char len;
   int total_len = 0;
+#ifdef FMT_LITERAL_RUNS
+  FAR const IPTR char *lit;
+#endif
 
 #ifdef CONFIG_LIBC_NUMBERED_ARGS
   int argnumber = 0;
@@ -191,6 +209,23 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
     {
       for (; ; )
         {
+#ifdef FMT_LITERAL_RUNS
+          /* Write the text up to the next conversion at once */
+
+          for (lit = fmt; *fmt != '\0' && *fmt != '%'; fmt++)
+            {
+            }
+
+#ifdef CONFIG_LIBC_NUMBERED_ARGS
+          if (fmt != lit && stream != NULL)
+#else
+          if (fmt != lit)
+#endif
+            {
+              stream_puts(lit, fmt - lit, stream);
+            }
+#endif
+
           c = fmt_char(fmt);
           if (c == '\0')
             {
@@ -1210,6 +1245,20 @@ str_lpad:
           flags &= ~FL_NEGATIVE;
         }
 
+      /* The common conversions without width, precision or flags only need
+       * the sign and the digits.
+       */
+
+      if ((flags & ~FL_PLAIN_INT) == 0)
+        {
+          if ((flags & FL_NEGATIVE) != 0)
+            {
+              stream_putc('-', stream);
+            }
+
+          goto digits;
+        }
+
       len = c;
 
       if ((flags & FL_PREC) != 0)
@@ -1296,9 +1345,24 @@ str_lpad:
           prec--;
         }
 
-      while (c)
+digits:
+
+      /* The digits are in reverse order, swap them to write them at once */
+
+      if (c > 0)
         {
-          stream_putc(buf[--c], stream);
+          FAR unsigned char *lo = buf;
+          FAR unsigned char *hi = buf + c - 1;
+
+          while (lo < hi)
+            {
+              unsigned char tmp = *lo;
+
+              *lo++ = *hi;
+              *hi-- = tmp;
+            }
+
+          stream_puts(buf, c, stream);
         }
 
 tail:
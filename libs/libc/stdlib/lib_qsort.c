@@ -48,12 +48,35 @@
 
 #include <sys/types.h>
 #include <sys/param.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Partitions smaller than this are insertion sorted */
+
+#define INSERTION_SORT_THRESHOLD 12
+
+/* The number of element moves after which an insertion sort of input that
+ * looked sorted is given up.
+ */
+
+#define PARTIAL_INSERTION_LIMIT  8
+
+/* Partitions larger than this take the pivot from a median of medians */
+
+#define NINTHER_THRESHOLD        40
+
+/* The ways to swap elements, chosen from their width and alignment */
+
+#define SWAPTYPE_UINT32          0
+#define SWAPTYPE_UINT64          1
+#define SWAPTYPE_LONG            2
+#define SWAPTYPE_CHAR            3
+
 #define swapcode(TYPE, parmi, parmj, n) \
   { \
     long i = (n) / sizeof (TYPE); \
@@ -66,52 +89,66 @@
     } while (--i > 0); \
   }
 
-#define SWAPINIT(a, width) \
-  swaptype = (uintptr_t)a % sizeof(long) || \
-  width % sizeof(long) ? 2 : width == sizeof(long) ? 0 : 1;
-
-#define swap(a, b) \
-  if (swaptype == 0) \
-    { \
-      long t = *(long *)(a); \
-      *(long *)(a) = *(long *)(b); \
-      *(long *)(b) = t; \
-    } \
-  else \
-    { \
-      swapfunc(a, b, width, swaptype); \
-    }
-
+#define swap(a, b)       swapfunc(a, b, width, swaptype)
 #define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
 
 /****************************************************************************
- * Private Function Prototypes
+ * Private Types
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
-static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *));
+typedef CODE int (*compar_t)(FAR const void *, FAR const void *);
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
+static inline int swaptype_init(FAR void *base, size_t width)
 {
-  if (swaptype <= 1)
+  uintptr_t addr = (uintptr_t)base;
+
+  if (width == sizeof(uint32_t) && addr % sizeof(uint32_t) == 0)
     {
-      swapcode(long, a, b, n)
+      return SWAPTYPE_UINT32;
     }
-  else
+  else if (width == sizeof(uint64_t) && addr % sizeof(uint64_t) == 0)
     {
-      swapcode(char, a, b, n)
+      return SWAPTYPE_UINT64;
+    }
+  else if (width % sizeof(long) == 0 && addr % sizeof(long) == 0)
+    {
+      return SWAPTYPE_LONG;
+    }
+
+  return SWAPTYPE_CHAR;
+}
+
+/* Swap n bytes, n being a multiple of the element width */
+
+static inline void swapfunc(FAR char *a, FAR char *b, size_t n,
+                            int swaptype)
+{
+  switch (swaptype)
+    {
+      case SWAPTYPE_UINT32:
+        swapcode(uint32_t, a, b, n)
+        break;
+
+      case SWAPTYPE_UINT64:
+        swapcode(uint64_t, a, b, n)
+        break;
+
+      case SWAPTYPE_LONG:
+        swapcode(long, a, b, n)
+        break;
+
+      default:
+        swapcode(char, a, b, n)
+        break;
     }
 }
 
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *))
+                             compar_t compar)
 {
   return compar(a, b) < 0 ?
          (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a)) :
@@ -119,50 +156,105 @@ static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
 }
 
 /****************************************************************************
- * Public Function
- ****************************************************************************/
-
-/****************************************************************************
- * Name: qsort
+ * Name: insertion_sort
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
- *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
+ *   Insertion sort 'nel' elements.  If 'limit' is not zero, give up once
+ *   more than 'limit' elements have been moved.
  *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
+ * Returned Value:
+ *   true if the elements are sorted.
  *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
+ ****************************************************************************/
+
+static bool insertion_sort(FAR char *base, size_t nel, size_t width,
+                           compar_t compar, int swaptype, size_t limit)
+{
+  FAR char *end = base + nel * width;
+  FAR char *pm;
+  FAR char *pl;
+  size_t moves = 0;
+
+  for (pm = base + width; pm < end; pm += width)
+    {
+      for (pl = pm; pl > base && compar(pl - width, pl) > 0; pl -= width)
+        {
+          swap(pl, pl - width);
+          moves++;
+        }
+
+      if (limit != 0 && moves > limit)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: heap_sort
  *
- *   (Based on description from OpenGroup.org).
+ * Description:
+ *   Heapsort 'nel' elements.  It is used for the partitions that quicksort
+ *   fails to split evenly.
  *
- * Returned Value:
- *   The qsort() function will not return a value.
+ ****************************************************************************/
+
+static void heap_sort(FAR char *base, size_t nel, size_t width,
+                      compar_t compar, int swaptype)
+{
+  size_t start;
+  size_t root;
+  size_t child;
+  size_t end;
+
+  for (start = nel / 2, end = nel; end > 1; )
+    {
+      if (start > 0)
+        {
+          /* Build the heap */
+
+          start--;
+        }
+      else
+        {
+          /* Move the largest element behind the heap */
+
+          end--;
+          swap(base, base + end * width);
+        }
+
+      for (root = start; (child = 2 * root + 1) < end; root = child)
+        {
+          if (child + 1 < end &&
+              compar(base + child * width, base + (child + 1) * width) < 0)
+            {
+              child++;
+            }
+
+          if (compar(base + root * width, base + child * width) >= 0)
+            {
+              break;
+            }
+
+          swap(base + root * width, base + child * width);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: qsort_loop
  *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ * Description:
+ *   Sort 'nel' elements, recursing into the smaller partition and looping
+ *   over the larger one.  'bad' is the number of unbalanced partitions
+ *   allowed before falling back to heapsort.
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static void qsort_loop(FAR char *base, size_t nel, size_t width,
+                       compar_t compar, int swaptype, int bad)
 {
   FAR char *pa;
   FAR char *pb;
@@ -171,38 +263,28 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
-  int swaptype;
+  size_t nleft;
+  size_t nright;
+  size_t d;
   int swap_cnt;
-  int d;
   int r;
 
-loop:
-  SWAPINIT(base, width);
-  swap_cnt = 0;
-
-  if (nel < 7)
+  for (; ; )
     {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      if (nel < INSERTION_SORT_THRESHOLD)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          insertion_sort(base, nel, width, compar, swaptype, 0);
+          return;
         }
 
-      return;
-    }
+      /* The pivot is the median of the first, middle and last elements,
+       * or of three such medians.
+       */
 
-  pm = (FAR char *)base + (nel / 2) * width;
-  if (nel > 7)
-    {
       pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
-      if (nel > 40)
+      pm = base + (nel / 2) * width;
+      pn = base + (nel - 1) * width;
+      if (nel > NINTHER_THRESHOLD)
         {
           d  = (nel / 8) * width;
           pl = med3(pl, pl + d, pl + 2 * d, compar);
@@ -211,86 +293,182 @@ loop:
         }
 
       pm = med3(pl, pm, pn, compar);
-    }
 
-  swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+      /* Partition into the elements equal to the pivot at both ends, the
+       * smaller ones then the larger ones between them.
+       */
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
-  for (; ; )
-    {
-      while (pb <= pc && (r = compar(pb, base)) <= 0)
+      swap(base, pm);
+      swap_cnt = 0;
+      pa = pb = base + width;
+      pc = pd = base + (nel - 1) * width;
+
+      for (; ; )
         {
-          if (r == 0)
+          while (pb <= pc && (r = compar(pb, base)) <= 0)
             {
-              swap_cnt = 1;
-              swap(pa, pb);
-              pa += width;
+              if (r == 0)
+                {
+                  swap_cnt = 1;
+                  swap(pa, pb);
+                  pa += width;
+                }
+
+              pb += width;
             }
 
-          pb += width;
-        }
+          while (pb <= pc && (r = compar(pc, base)) >= 0)
+            {
+              if (r == 0)
+                {
+                  swap_cnt = 1;
+                  swap(pc, pd);
+                  pd -= width;
+                }
+
+              pc -= width;
+            }
 
-      while (pb <= pc && (r = compar(pc, base)) >= 0)
-        {
-          if (r == 0)
+          if (pb > pc)
             {
-              swap_cnt = 1;
-              swap(pc, pd);
-              pd -= width;
+              break;
             }
 
-          pc -= width;
+          swap(pb, pc);
+          swap_cnt = 1;
+          pb      += width;
+          pc      -= width;
         }
 
-      if (pb > pc)
-        {
-          break;
-        }
+      /* Move the equal elements to the middle */
 
-      swap(pb, pc);
-      swap_cnt = 1;
-      pb      += width;
-      pc      -= width;
-    }
+      pn = base + nel * width;
+      d  = MIN(pa - base, pb - pa);
+      vecswap(base, pb - d, d);
 
-  if (swap_cnt == 0)
-    {
-      /* Switch to insertion sort */
+      d  = MIN(pd - pc, pn - pd - width);
+      vecswap(pb, pn - d, d);
+
+      nleft  = (pb - pa) / width;
+      nright = (pd - pc) / width;
 
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      if (MAX(nleft, nright) > nel - nel / 8)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
+          /* Unbalanced partition.  Past too many of them the input is
+           * adversarial: heapsort it.  Otherwise break the patterns up.
+           */
+
+          if (--bad <= 0)
+            {
+              heap_sort(base, nel, width, compar, swaptype);
+              return;
+            }
+
+          if (nleft >= INSERTION_SORT_THRESHOLD)
+            {
+              swap(base, base + (nleft / 4) * width);
+              swap(base + (nleft - 1) * width,
+                   base + (nleft - nleft / 4) * width);
+            }
+
+          if (nright >= INSERTION_SORT_THRESHOLD)
             {
-              swap(pl, pl - width);
+              pl = pn - nright * width;
+              swap(pl, pl + (nright / 4) * width);
+              swap(pn - width, pn - (nright / 4 + 1) * width);
             }
         }
+      else if (swap_cnt == 0 &&
+               insertion_sort(base, nleft, width, compar, swaptype,
+                              PARTIAL_INSERTION_LIMIT) &&
+               insertion_sort(pn - nright * width, nright, width, compar,
+                              swaptype, PARTIAL_INSERTION_LIMIT))
+        {
+          /* Nothing had to be swapped, the input was likely sorted and
+           * it is now.
+           */
+
+          return;
+        }
+
+      /* Recurse into the smaller partition, iterate over the larger one */
 
-      return;
+      if (nleft < nright)
+        {
+          qsort_loop(base, nleft, width, compar, swaptype, bad);
+          base = pn - nright * width;
+          nel  = nright;
+        }
+      else
+        {
+          qsort_loop(pn - nright * width, nright, width, compar, swaptype,
+                     bad);
+          nel = nleft;
+        }
     }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-  pn = (FAR char *)base + nel * width;
-  r  = MIN(pa - (FAR char *)base, pb - pa);
-  vecswap(base, pb - r, r);
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes:
+ *   The partitioning is that of Bentley & McIlroy's "Engineering a Sort
+ *   Function" from the original BSD version.  As in Orson Peters'
+ *   pattern-defeating quicksort, inputs that give unbalanced partitions
+ *   are shuffled and finally sorted with heapsort, input that is already
+ *   sorted costs a linear pass and small partitions are insertion sorted.
+ *   This bounds the time to O(n log n) and the stack to O(log n).
+ *
+ ****************************************************************************/
 
-  r  = MIN(pd - pc, pn - pd - width);
-  vecswap(pb, pn - r, r);
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  size_t n;
+  int bad = 0;
 
-  if ((r = pb - pa) > width)
-    {
-      qsort(base, r / width, width, compar);
-    }
+  /* Allow about log2(nel) unbalanced partitions */
 
-  if ((r = pd - pc) > width)
+  for (n = nel; n > 1; n >>= 1)
     {
-      /* Iterate rather than recurse to save stack space */
-
-      base = pn - r;
-      nel = r / width;
-      goto loop;
+      bad++;
     }
+
+  qsort_loop(base, nel, width, compar, swaptype_init(base, width),
+             bad + 1);
 }
@@ -0,0 +1,161 @@
+/****************************************************************************
+ * libs/libc/stream/lib_lz4compress.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <nuttx/streams.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lz4outstream_block
+ *
+ * Description:
+ *   Compress the collected data and write it as one block to the backend
+ *
+ ****************************************************************************/
+
+static int lz4outstream_block(FAR struct lib_lz4outstream_s *stream)
+{
+  FAR uint8_t *hdr = stream->out;
+  unsigned int zlen;
+  int ret;
+  int i;
+
+  /* Keep the data as it is if it does not shrink */
+
+  zlen = lz4_compress(stream->in, stream->offset,
+                      hdr + LZ4_STREAM_HDRSIZE, stream->offset - 1,
+                      stream->state);
+  if (zlen == 0)
+    {
+      memcpy(hdr + LZ4_STREAM_HDRSIZE, stream->in, stream->offset);
+      zlen = stream->offset;
+    }
+
+  memcpy(hdr, "LZ4B", 4);
+  for (i = 0; i < 4; i++)
+    {
+      hdr[4 + i] = (uint8_t)(stream->offset >> (8 * i));
+      hdr[8 + i] = (uint8_t)(zlen >> (8 * i));
+    }
+
+  stream->offset = 0;
+
+  ret = lib_stream_puts(stream->backend, hdr, LZ4_STREAM_HDRSIZE + zlen);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: lz4outstream_flush
+ ****************************************************************************/
+
+static int lz4outstream_flush(FAR struct lib_outstream_s *this)
+{
+  FAR struct lib_lz4outstream_s *stream =
+                                 (FAR struct lib_lz4outstream_s *)this;
+
+  if (stream->offset > 0)
+    {
+      lz4outstream_block(stream);
+    }
+
+  return lib_stream_flush(stream->backend);
+}
+
+/****************************************************************************
+ * Name: lz4outstream_puts
+ ****************************************************************************/
+
+static int lz4outstream_puts(FAR struct lib_outstream_s *this,
+                             FAR const void *buf, int len)
+{
+  FAR struct lib_lz4outstream_s *stream =
+                                 (FAR struct lib_lz4outstream_s *)this;
+  FAR const uint8_t *ptr = buf;
+  size_t total = len;
+  size_t copyin;
+  int ret;
+
+  while (total > 0)
+    {
+      copyin = stream->offset + total > LZ4_STREAM_BLOCKSIZE ?
+               LZ4_STREAM_BLOCKSIZE - stream->offset : total;
+
+      memcpy(stream->in + stream->offset, ptr, copyin);
+
+      ptr            += copyin;
+      stream->offset += copyin;
+      this->nput     += copyin;
+      total          -= copyin;
+
+      if (stream->offset == LZ4_STREAM_BLOCKSIZE)
+        {
+          ret = lz4outstream_block(stream);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lib_lz4outstream
+ *
+ * Description:
+ *  LZ4 compressed pipeline stream
+ *
+ * Input Parameters:
+ *   stream  - User allocated, uninitialized instance of struct
+ *                lib_lz4outstream_s to be initialized.
+ *   backend - Stream backend port.
+ *
+ * Returned Value:
+ *   None (User allocated instance initialized).
+ *
+ ****************************************************************************/
+
+void lib_lz4outstream(FAR struct lib_lz4outstream_s *stream,
+                      FAR struct lib_outstream_s *backend)
+{
+  if (stream == NULL || backend == NULL)
+    {
+      return;
+    }
+
+  memset(stream, 0, sizeof(*stream));
+  stream->public.puts  = lz4outstream_puts;
+  stream->public.flush = lz4outstream_flush;
+  stream->backend      = backend;
+}
@@ -286,7 +286,7 @@ void lib_syslograwstream_open(FAR struct lib_syslograwstream_s *stream)
   if (stream->iob != NULL)
     {
       stream->base = (FAR void *)stream->iob->io_data;
-      stream->size = sizeof(stream->iob->io_data);
+      stream->size = IOB_BUFSIZE(stream->iob);
     }
   else
     {
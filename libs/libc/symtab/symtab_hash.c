@@ -0,0 +1,204 @@
+/****************************************************************************
+ * libs/libc/symtab/symtab_hash.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/symtab.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   Return the hash of a symbol name as used by struct symtab_hash_s.  This
+ *   is the GNU ELF hash function (h = h * 33 + c, starting at 5381).
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hash(FAR const char *name)
+{
+  uint32_t hash = 5381;
+
+  for (; *name != '\0'; name++)
+    {
+      hash = (hash << 5) + hash + (uint8_t)*name;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: symtab_findbyhash
+ *
+ * Description:
+ *   Find the symbol in the symbol table with the matching name using the
+ *   hash index of the table.  Access time is constant on average.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findbyhash(FAR const struct symtab_s *symtab,
+                  FAR const struct symtab_hash_s *hash,
+                  FAR const char *name, int nsyms)
+{
+  uint32_t value;
+  uint32_t bucket;
+  uint32_t i;
+
+  if (symtab == NULL || hash == NULL || hash->nbuckets == 0)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_SYMTAB_DECORATED
+  if (name[0] == '_')
+    {
+      name++;
+    }
+#endif
+
+  DEBUGASSERT(name != NULL);
+
+  value  = symtab_hash(name);
+  bucket = value % hash->nbuckets;
+
+  DEBUGASSERT(hash->buckets[hash->nbuckets] <= (uint32_t)nsyms);
+
+  for (i = hash->buckets[bucket]; i < hash->buckets[bucket + 1]; i++)
+    {
+      if (hash->hashes[i] == value &&
+          strcmp(name, symtab[i].sym_name) == 0)
+        {
+          return &symtab[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: symtab_buildhash
+ *
+ * Description:
+ *   Reorder the symbol table by hash bucket and build its hash index.  The
+ *   index is returned in a single allocation that is freed with lib_free().
+ *
+ * Returned Value:
+ *   The hash index on success; NULL if memory could not be allocated, in
+ *   which case the symbol table is left unchanged.
+ *
+ ****************************************************************************/
+
+FAR struct symtab_hash_s *symtab_buildhash(FAR struct symtab_s *symtab,
+                                           int nsyms)
+{
+  FAR struct symtab_hash_s *hash;
+  FAR struct symtab_s *sorted;
+  FAR uint32_t *buckets;
+  FAR uint32_t *hashes;
+  FAR uint32_t *values;
+  uint32_t nbuckets;
+  uint32_t bucket;
+  int i;
+
+  DEBUGASSERT(symtab != NULL && nsyms > 0);
+
+  /* Two symbols per bucket on average, as the GNU linker does */
+
+  nbuckets = nsyms / 2 + 1;
+
+  hash = lib_malloc(sizeof(struct symtab_hash_s) +
+                    sizeof(uint32_t) * (nbuckets + 1 + nsyms));
+  if (hash == NULL)
+    {
+      return NULL;
+    }
+
+  sorted = lib_malloc(sizeof(struct symtab_s) * nsyms +
+                      sizeof(uint32_t) * nsyms);
+  if (sorted == NULL)
+    {
+      lib_free(hash);
+      return NULL;
+    }
+
+  buckets = (FAR uint32_t *)(hash + 1);
+  hashes  = buckets + nbuckets + 1;
+  values  = (FAR uint32_t *)(sorted + nsyms);
+
+  /* Count the symbols in each bucket.  buckets[b + 1] holds the count of
+   * bucket 'b' so that the running sum below leaves the start of each
+   * bucket in buckets[b].
+   */
+
+  memset(buckets, 0, sizeof(uint32_t) * (nbuckets + 1));
+  for (i = 0; i < nsyms; i++)
+    {
+      values[i] = symtab_hash(symtab[i].sym_name);
+      buckets[values[i] % nbuckets + 1]++;
+    }
+
+  for (bucket = 0; bucket < nbuckets; bucket++)
+    {
+      buckets[bucket + 1] += buckets[bucket];
+    }
+
+  /* Place each symbol in its bucket, using buckets[b] as the insertion
+   * point and restoring it afterwards.
+   */
+
+  for (i = 0; i < nsyms; i++)
+    {
+      bucket = values[i] % nbuckets;
+      hashes[buckets[bucket]] = values[i];
+      sorted[buckets[bucket]++] = symtab[i];
+    }
+
+  for (bucket = nbuckets; bucket > 0; bucket--)
+    {
+      buckets[bucket] = buckets[bucket - 1];
+    }
+
+  buckets[0] = 0;
+
+  memcpy(symtab, sorted, sizeof(struct symtab_s) * nsyms);
+  lib_free(sorted);
+
+  hash->nbuckets = nbuckets;
+  hash->buckets  = buckets;
+  hash->hashes   = hashes;
+  return hash;
+}
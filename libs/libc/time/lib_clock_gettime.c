@@ -0,0 +1,103 @@
+/****************************************************************************
+ * libs/libc/time/lib_clock_gettime.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <syscall.h>
+#include <time.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/clock_vdso.h>
+
+/* The kernel has its own clock_gettime() */
+
+#if defined(CONFIG_CLOCK_VDSO) && !defined(__KERNEL__)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The clock data page of this process, mapped on first use */
+
+static FAR const struct clock_vdso_s *g_clock_vdso;
+static bool g_clock_vdso_mapped;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_gettime
+ *
+ * Description:
+ *   Read CLOCK_MONOTONIC, CLOCK_BOOTTIME and CLOCK_REALTIME from the clock
+ *   data page of the kernel and the user readable counter, without a
+ *   system call.  The other clocks, and all of them if the page could not
+ *   be mapped, are passed on to the kernel.
+ *
+ ****************************************************************************/
+
+int clock_gettime(clockid_t clock_id, FAR struct timespec *tp)
+{
+  FAR const struct clock_vdso_s *vdso;
+  struct timespec realtime;
+  uint32_t seq;
+
+  if (!g_clock_vdso_mapped)
+    {
+      /* Racing threads map the same page, so no lock is needed */
+
+      g_clock_vdso        = clock_vdso_map();
+      g_clock_vdso_mapped = true;
+    }
+
+  vdso = g_clock_vdso;
+  if (vdso == NULL || (clock_id != CLOCK_MONOTONIC &&
+                       clock_id != CLOCK_BOOTTIME &&
+                       clock_id != CLOCK_REALTIME))
+    {
+      return (int)sys_call2(SYS_clock_gettime, (uintptr_t)clock_id,
+                            (uintptr_t)tp);
+    }
+
+  do
+    {
+      seq = read_seqbegin(&vdso->cv_seq);
+      clock_vdso_monotonic(vdso, up_vdso_counter(), tp);
+      realtime = vdso->cv_realtime;
+    }
+  while (read_seqretry(&vdso->cv_seq, seq));
+
+  if (clock_id == CLOCK_REALTIME)
+    {
+      clock_timespec_add(tp, &realtime, tp);
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_CLOCK_VDSO && !__KERNEL__ */
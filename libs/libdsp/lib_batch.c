@@ -0,0 +1,429 @@
+/****************************************************************************
+ * libs/libdsp/lib_batch.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/param.h>
+#include <dsp.h>
+#include <string.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The batched functions work on BATCH_LANES motors at a time with the
+ * vector extension of GCC, which the compiler maps to Helium (MVE) or NEON
+ * when the target has it and splits into scalar operations otherwise.
+ * Each lane computes exactly what the scalar function does for its motor.
+ */
+
+#ifdef __GNUC__
+#  define BATCH_VECTOR
+#  define BATCH_LANES 4
+#endif
+
+#ifdef BATCH_VECTOR
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef float   vf32_t __attribute__((vector_size(4 * BATCH_LANES)));
+typedef int32_t vi32_t __attribute__((vector_size(4 * BATCH_LANES)));
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline vf32_t batch_load(FAR const float *src, size_t count)
+{
+  vf32_t v;
+
+  memset(&v, 0, sizeof(v));
+  memcpy(&v, src, count * sizeof(float));
+  return v;
+}
+
+static inline void batch_store(FAR float *dst, vf32_t v, size_t count)
+{
+  memcpy(dst, &v, count * sizeof(float));
+}
+
+static inline vf32_t batch_select(vi32_t mask, vf32_t a, vf32_t b)
+{
+  return (vf32_t)(((vi32_t)a & mask) | ((vi32_t)b & ~mask));
+}
+
+#endif /* BATCH_VECTOR */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clarke_transform_batch
+ *
+ * Description:
+ *   Clarke transform (abc frame -> ab frame) of n motors.
+ *   See clarke_transform().
+ *
+ * Input Parameters:
+ *   abc - (in) the abc frames
+ *   ab  - (out) the ab frames
+ *   n   - (in) number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clarke_transform_batch(FAR const struct abc_batch_f32_s *abc,
+                            FAR const struct ab_batch_f32_s *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(abc != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+#ifdef BATCH_VECTOR
+  vf32_t a;
+  vf32_t b;
+  size_t count;
+
+  for (i = 0; i < n; i += count)
+    {
+      count = MIN(n - i, BATCH_LANES);
+      a     = batch_load(&abc->a[i], count);
+      b     = batch_load(&abc->b[i], count);
+
+      batch_store(&ab->a[i], a, count);
+      batch_store(&ab->b[i], ONE_BY_SQRT3_F * a + TWO_BY_SQRT3_F * b,
+                  count);
+    }
+#else
+  abc_frame_f32_t in;
+  ab_frame_f32_t  out;
+
+  for (i = 0; i < n; i++)
+    {
+      in.a = abc->a[i];
+      in.b = abc->b[i];
+
+      clarke_transform(&in, &out);
+
+      ab->a[i] = out.a;
+      ab->b[i] = out.b;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: inv_clarke_transform_batch
+ *
+ * Description:
+ *   Inverse Clarke transform (ab frame -> abc frame) of n motors.
+ *   See inv_clarke_transform().
+ *
+ * Input Parameters:
+ *   ab  - (in) the ab frames
+ *   abc - (out) the abc frames
+ *   n   - (in) number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_clarke_transform_batch(FAR const struct ab_batch_f32_s *ab,
+                                FAR const struct abc_batch_f32_s *abc,
+                                size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(abc != NULL);
+
+#ifdef BATCH_VECTOR
+  vf32_t a;
+  vf32_t b;
+  size_t count;
+
+  for (i = 0; i < n; i += count)
+    {
+      count = MIN(n - i, BATCH_LANES);
+      a     = batch_load(&ab->a[i], count);
+      b     = -0.5f * a + SQRT3_BY_TWO_F * batch_load(&ab->b[i], count);
+
+      batch_store(&abc->a[i], a, count);
+      batch_store(&abc->b[i], b, count);
+      batch_store(&abc->c[i], -a - b, count);
+    }
+#else
+  ab_frame_f32_t  in;
+  abc_frame_f32_t out;
+
+  for (i = 0; i < n; i++)
+    {
+      in.a = ab->a[i];
+      in.b = ab->b[i];
+
+      inv_clarke_transform(&in, &out);
+
+      abc->a[i] = out.a;
+      abc->b[i] = out.b;
+      abc->c[i] = out.c;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: park_transform_batch
+ *
+ * Description:
+ *   Park transform (ab frame -> dq frame) of n motors.
+ *   See park_transform().
+ *
+ * Input Parameters:
+ *   angle - (in) the phase angles
+ *   ab    - (in) the ab frames
+ *   dq    - (out) the dq frames
+ *   n     - (in) number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void park_transform_batch(FAR const struct angle_batch_f32_s *angle,
+                          FAR const struct ab_batch_f32_s *ab,
+                          FAR const struct dq_batch_f32_s *dq, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+
+#ifdef BATCH_VECTOR
+  vf32_t s;
+  vf32_t c;
+  vf32_t a;
+  vf32_t b;
+  size_t count;
+
+  for (i = 0; i < n; i += count)
+    {
+      count = MIN(n - i, BATCH_LANES);
+      s     = batch_load(&angle->sin[i], count);
+      c     = batch_load(&angle->cos[i], count);
+      a     = batch_load(&ab->a[i], count);
+      b     = batch_load(&ab->b[i], count);
+
+      batch_store(&dq->d[i], c * a + s * b, count);
+      batch_store(&dq->q[i], c * b - s * a, count);
+    }
+#else
+  phase_angle_f32_t phase;
+  ab_frame_f32_t    in;
+  dq_frame_f32_t    out;
+
+  for (i = 0; i < n; i++)
+    {
+      phase.sin = angle->sin[i];
+      phase.cos = angle->cos[i];
+      in.a      = ab->a[i];
+      in.b      = ab->b[i];
+
+      park_transform(&phase, &in, &out);
+
+      dq->d[i] = out.d;
+      dq->q[i] = out.q;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_batch
+ *
+ * Description:
+ *   Inverse Park transform (dq frame -> ab frame) of n motors.
+ *   See inv_park_transform().
+ *
+ * Input Parameters:
+ *   angle - (in) the phase angles
+ *   dq    - (in) the dq frames
+ *   ab    - (out) the ab frames
+ *   n     - (in) number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_park_transform_batch(FAR const struct angle_batch_f32_s *angle,
+                              FAR const struct dq_batch_f32_s *dq,
+                              FAR const struct ab_batch_f32_s *ab,
+                              size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+#ifdef BATCH_VECTOR
+  vf32_t s;
+  vf32_t c;
+  vf32_t d;
+  vf32_t q;
+  size_t count;
+
+  for (i = 0; i < n; i += count)
+    {
+      count = MIN(n - i, BATCH_LANES);
+      s     = batch_load(&angle->sin[i], count);
+      c     = batch_load(&angle->cos[i], count);
+      d     = batch_load(&dq->d[i], count);
+      q     = batch_load(&dq->q[i], count);
+
+      batch_store(&ab->a[i], c * d - s * q, count);
+      batch_store(&ab->b[i], c * q + s * d, count);
+    }
+#else
+  phase_angle_f32_t phase;
+  dq_frame_f32_t    in;
+  ab_frame_f32_t    out;
+
+  for (i = 0; i < n; i++)
+    {
+      phase.sin = angle->sin[i];
+      phase.cos = angle->cos[i];
+      in.d      = dq->d[i];
+      in.q      = dq->q[i];
+
+      inv_park_transform(&phase, &in, &out);
+
+      ab->a[i] = out.a;
+      ab->b[i] = out.b;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: pi_controller_batch
+ *
+ * Description:
+ *   Run the PI controllers of n motors, each one as pi_controller() does.
+ *   The outputs are left in pi->out.
+ *
+ * Input Parameters:
+ *   pi  - (in/out) the PI controllers
+ *   err - (in) the current errors
+ *   n   - (in) number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pi_controller_batch(FAR const struct pi_batch_f32_s *pi,
+                         FAR const float *err, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(pi != NULL);
+  LIBDSP_DEBUGASSERT(err != NULL);
+
+#ifdef BATCH_VECTOR
+  vi32_t hi;
+  vi32_t lo;
+  vi32_t reset;
+  vf32_t e;
+  vf32_t part;
+  vf32_t aw;
+  vf32_t out;
+  vf32_t min;
+  vf32_t max;
+  vf32_t tmp;
+  size_t count;
+
+  for (i = 0; i < n; i += count)
+    {
+      count = MIN(n - i, BATCH_LANES);
+      e     = batch_load(&err[i], count);
+      aw    = batch_load(&pi->aw[i], count);
+      part  = batch_load(&pi->part_i[i], count) +
+              batch_load(&pi->KI[i], count) * (e - aw);
+      out   = batch_load(&pi->KP[i], count) * e + part;
+      tmp   = out;
+
+      if (pi->pisat_en)
+        {
+          min = batch_load(&pi->sat_min[i], count);
+          max = batch_load(&pi->sat_max[i], count);
+          hi  = out > max;
+          lo  = ~hi & (out < min);
+
+          if (pi->ireset_en)
+            {
+              reset = (hi & (e > 0.0f)) | (lo & (e < 0.0f));
+              part  = (vf32_t)((vi32_t)part & ~reset);
+              aw    = (vf32_t)((vi32_t)aw & ~reset);
+            }
+
+          out = batch_select(hi, max, out);
+          out = batch_select(lo, min, out);
+        }
+
+      if (pi->aw_en)
+        {
+          aw = batch_load(&pi->KC[i], count) * (tmp - out);
+        }
+
+      batch_store(&pi->part_i[i], part, count);
+      batch_store(&pi->aw[i], aw, count);
+      batch_store(&pi->out[i], out, count);
+    }
+#else
+  pid_controller_f32_t pid;
+
+  memset(&pid, 0, sizeof(pid));
+  pid.aw_en     = pi->aw_en;
+  pid.ireset_en = pi->ireset_en;
+  pid.pisat_en  = pi->pisat_en;
+
+  for (i = 0; i < n; i++)
+    {
+      pid.KP      = pi->KP[i];
+      pid.KI      = pi->KI[i];
+      pid.KC      = pi->aw_en ? pi->KC[i] : 0.0f;
+      pid.sat.min = pi->pisat_en ? pi->sat_min[i] : 0.0f;
+      pid.sat.max = pi->pisat_en ? pi->sat_max[i] : 0.0f;
+      pid.part[1] = pi->part_i[i];
+      pid.aw      = pi->aw[i];
+
+      pi->out[i]    = pi_controller(&pid, err[i]);
+      pi->part_i[i] = pid.part[1];
+      pi->aw[i]     = pid.aw;
+    }
+#endif
+}
@@ -0,0 +1,314 @@
+/****************************************************************************
+ * libs/libdsp/lib_batch_b16.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dspb16.h>
+
+#ifdef __ARM_FEATURE_DSP
+#  include <arm_acle.h>
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: batch_qadd
+ *
+ * Description:
+ *   Saturating addition.  The sums of the batched functions saturate
+ *   instead of wrapping around, so that an overflow of one motor gives
+ *   the largest value of the right sign rather than one of the opposite
+ *   sign.
+ *
+ ****************************************************************************/
+
+static inline b16_t batch_qadd(b16_t a, b16_t b)
+{
+#ifdef __ARM_FEATURE_DSP
+  return __qadd(a, b);
+#else
+  int64_t sum = (int64_t)a + b;
+
+  if (sum > INT32_MAX)
+    {
+      return INT32_MAX;
+    }
+  else if (sum < INT32_MIN)
+    {
+      return INT32_MIN;
+    }
+
+  return (b16_t)sum;
+#endif
+}
+
+static inline b16_t batch_qsub(b16_t a, b16_t b)
+{
+#ifdef __ARM_FEATURE_DSP
+  return __qsub(a, b);
+#else
+  int64_t diff = (int64_t)a - b;
+
+  if (diff > INT32_MAX)
+    {
+      return INT32_MAX;
+    }
+  else if (diff < INT32_MIN)
+    {
+      return INT32_MIN;
+    }
+
+  return (b16_t)diff;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clarke_transform_batch_b16
+ *
+ * Description:
+ *   Clarke transform (abc frame -> ab frame) of n motors.
+ *   See clarke_transform_b16().
+ *
+ * Input Parameters:
+ *   abc - (in) the abc frames
+ *   ab  - (out) the ab frames
+ *   n   - (in) number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clarke_transform_batch_b16(FAR const struct abc_batch_b16_s *abc,
+                                FAR const struct ab_batch_b16_s *ab,
+                                size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(abc != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      b16_t a = abc->a[i];
+      b16_t b = abc->b[i];
+
+      ab->a[i] = a;
+      ab->b[i] = batch_qadd(b16mulb16(ONE_BY_SQRT3_B16, a),
+                            b16mulb16(TWO_BY_SQRT3_B16, b));
+    }
+}
+
+/****************************************************************************
+ * Name: inv_clarke_transform_batch_b16
+ *
+ * Description:
+ *   Inverse Clarke transform (ab frame -> abc frame) of n motors.
+ *   See inv_clarke_transform_b16().
+ *
+ * Input Parameters:
+ *   ab  - (in) the ab frames
+ *   abc - (out) the abc frames
+ *   n   - (in) number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_clarke_transform_batch_b16(FAR const struct ab_batch_b16_s *ab,
+                                    FAR const struct abc_batch_b16_s *abc,
+                                    size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(abc != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      b16_t a = ab->a[i];
+      b16_t b = batch_qadd(b16mulb16(-b16HALF, a),
+                           b16mulb16(SQRT3_BY_TWO_B16, ab->b[i]));
+
+      abc->a[i] = a;
+      abc->b[i] = b;
+      abc->c[i] = batch_qsub(-a, b);
+    }
+}
+
+/****************************************************************************
+ * Name: park_transform_batch_b16
+ *
+ * Description:
+ *   Park transform (ab frame -> dq frame) of n motors.
+ *   See park_transform_b16().
+ *
+ * Input Parameters:
+ *   angle - (in) the phase angles
+ *   ab    - (in) the ab frames
+ *   dq    - (out) the dq frames
+ *   n     - (in) number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void park_transform_batch_b16(FAR const struct angle_batch_b16_s *angle,
+                              FAR const struct ab_batch_b16_s *ab,
+                              FAR const struct dq_batch_b16_s *dq,
+                              size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      b16_t s = angle->sin[i];
+      b16_t c = angle->cos[i];
+      b16_t a = ab->a[i];
+      b16_t b = ab->b[i];
+
+      dq->d[i] = batch_qadd(b16mulb16(c, a), b16mulb16(s, b));
+      dq->q[i] = batch_qsub(b16mulb16(c, b), b16mulb16(s, a));
+    }
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_batch_b16
+ *
+ * Description:
+ *   Inverse Park transform (dq frame -> ab frame) of n motors.
+ *   See inv_park_transform_b16().
+ *
+ * Input Parameters:
+ *   angle - (in) the phase angles
+ *   dq    - (in) the dq frames
+ *   ab    - (out) the ab frames
+ *   n     - (in) number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_park_transform_batch_b16(FAR const struct angle_batch_b16_s *angle,
+                                  FAR const struct dq_batch_b16_s *dq,
+                                  FAR const struct ab_batch_b16_s *ab,
+                                  size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      b16_t s = angle->sin[i];
+      b16_t c = angle->cos[i];
+      b16_t d = dq->d[i];
+      b16_t q = dq->q[i];
+
+      ab->a[i] = batch_qsub(b16mulb16(c, d), b16mulb16(s, q));
+      ab->b[i] = batch_qadd(b16mulb16(c, q), b16mulb16(s, d));
+    }
+}
+
+/****************************************************************************
+ * Name: pi_controller_batch_b16
+ *
+ * Description:
+ *   Run the PI controllers of n motors, each one as pi_controller_b16()
+ *   does.  The outputs are left in pi->out.
+ *
+ * Input Parameters:
+ *   pi  - (in/out) the PI controllers
+ *   err - (in) the current errors
+ *   n   - (in) number of motors
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pi_controller_batch_b16(FAR const struct pi_batch_b16_s *pi,
+                             FAR const b16_t *err, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(pi != NULL);
+  LIBDSP_DEBUGASSERT(err != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      b16_t e    = err[i];
+      b16_t aw   = pi->aw[i];
+      b16_t part = batch_qadd(pi->part_i[i],
+                              b16mulb16(pi->KI[i], batch_qsub(e, aw)));
+      b16_t out  = batch_qadd(b16mulb16(pi->KP[i], e), part);
+      b16_t tmp  = out;
+
+      if (pi->pisat_en)
+        {
+          if (out > pi->sat_max[i])
+            {
+              if (pi->ireset_en && e > 0)
+                {
+                  part = 0;
+                  aw   = 0;
+                }
+
+              out = pi->sat_max[i];
+            }
+          else if (out < pi->sat_min[i])
+            {
+              if (pi->ireset_en && e < 0)
+                {
+                  part = 0;
+                  aw   = 0;
+                }
+
+              out = pi->sat_min[i];
+            }
+        }
+
+      if (pi->aw_en)
+        {
+          aw = b16mulb16(pi->KC[i], batch_qsub(tmp, out));
+        }
+
+      pi->part_i[i] = part;
+      pi->aw[i]     = aw;
+      pi->out[i]    = out;
+    }
+}
@@ -0,0 +1,129 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fastatan2f.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* pi and pi / 2 split in two parts */
+
+#define ATAN2F_PI_1    3.14159274f
+#define ATAN2F_PI_2    -8.74227766e-08f
+#define ATAN2F_PIO2_1  1.57079637f
+#define ATAN2F_PIO2_2  -4.37113883e-08f
+#define ATAN2F_PIO4    0.785398185f
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* atan(i / 8), i = 0..8 */
+
+static const float g_atanf_table[9] =
+{
+  0.000000000f, 0.124354996f, 0.244978666f, 0.358770669f,
+  0.463647604f, 0.558599293f, 0.643501103f, 0.718829989f,
+  0.785398185f,
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: atan2f
+ *
+ * Description:
+ *   Table driven arc tangent of y / x: with t = min(|x|, |y|) /
+ *   max(|x|, |y|) and c = i / 8 the table point below t,
+ *     atan(t) = atan(c) + atan((t - c) / (1 + t * c))
+ *   where 0 <= (t - c) / (1 + t * c) < 1 / 8, then mapped to the quadrant
+ *   of (x, y).  The error is below 2 ULP.
+ *
+ ****************************************************************************/
+
+float atan2f(float y, float x)
+{
+  float num;
+  float den;
+  float s;
+  float ax;
+  float ay;
+  float a;
+  float c;
+  float t;
+  float u;
+  int i;
+
+  if (isnan(x) || isnan(y))
+    {
+      return x + y;
+    }
+
+  ax  = fabsf(x);
+  ay  = fabsf(y);
+  num = ay < ax ? ay : ax;
+  den = ay < ax ? ax : ay;
+
+  if (den == 0.0f)
+    {
+      a = 0.0f;
+    }
+  else if (isinff(num))
+    {
+      a = ATAN2F_PIO4;
+    }
+  else
+    {
+      t = num / den;
+      i = (int)(t * 8.0f);
+      c = i * 0.125f;
+
+      /* Taylor polynomial of atan(u), accurate to 7e-9 relative.  Both
+       * terms of the sum are positive, so that they do not cancel.
+       */
+
+      u = (t - c) / (1.0f + t * c);
+      s = u * u;
+      a = g_atanf_table[i] +
+          (u + u * s * (-3.33333333e-01f + s * (0.2f +
+                        s * -1.42857143e-01f)));
+    }
+
+  if (ay > ax)
+    {
+      a = (ATAN2F_PIO2_1 - a) + ATAN2F_PIO2_2;
+    }
+
+  if (signbit(x))
+    {
+      a = (ATAN2F_PI_1 - a) + ATAN2F_PI_2;
+    }
+
+  return copysignf(a, y);
+}
@@ -0,0 +1,134 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fastexpf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+#include <stdint.h>
+
+#include "libm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* x = k * ln2 / 32 + r is computed with ln2 / 32 split in two parts, the
+ * first one short enough that k times it is exact for all the k that do
+ * not overflow.
+ */
+
+#define EXPF_INVLN2O32 46.1662407f          /* 32 / ln2 */
+#define EXPF_LN2O32_1  0.0216598511f        /* Top 12 bits of ln2 / 32 */
+#define EXPF_LN2O32_2  9.98318228e-07f      /* The rest */
+
+/* The results overflow above EXPF_MAX and underflow to 0 below EXPF_MIN */
+
+#define EXPF_MAX       88.7228394f
+#define EXPF_MIN       -103.972084f
+
+/* Rounds a float of magnitude below 2^22 to an integer when added */
+
+#define EXPF_SHIFT     12582912.0f          /* 1.5 * 2^23 */
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* 2^(j / 32), j = 0..31 */
+
+static const float g_expf_table[32] =
+{
+  1.00000000f, 1.02189720f, 1.04427373f, 1.06714046f,
+  1.09050775f, 1.11438680f, 1.13878858f, 1.16372490f,
+  1.18920708f, 1.21524739f, 1.24185777f, 1.26905096f,
+  1.29683959f, 1.32523668f, 1.35425556f, 1.38390994f,
+  1.41421354f, 1.44518077f, 1.47682619f, 1.50916445f,
+  1.54221082f, 1.57598090f, 1.61049032f, 1.64575553f,
+  1.68179286f, 1.71861935f, 1.75625217f, 1.79470909f,
+  1.83400810f, 1.87416768f, 1.91520655f, 1.95714414f,
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: expf
+ *
+ * Description:
+ *   Table driven exponential: exp(k * ln2 / 32 + r) =
+ *     2^(k / 32) * exp(r)
+ *   with 2^(k / 32) taken from the table and the exponent, and exp(r) from
+ *   a cubic for |r| <= ln2 / 64.  The error is below 1.1 ULP for normal
+ *   results.
+ *
+ ****************************************************************************/
+
+float expf(float x)
+{
+  uint32_t k;
+  int32_t e;
+  float t;
+  float n;
+  float r;
+  float p;
+  float y;
+
+  if (!(x <= EXPF_MAX))
+    {
+      return x > 0 ? INFINITY_F : x; /* Overflow or NaN */
+    }
+
+  if (x < EXPF_MIN)
+    {
+      return 0.0f;
+    }
+
+  t = x * EXPF_INVLN2O32 + EXPF_SHIFT;
+  n = t - EXPF_SHIFT;
+  k = lib_asuint32(t) - lib_asuint32(EXPF_SHIFT);
+  r = x - n * EXPF_LN2O32_1 - n * EXPF_LN2O32_2;
+
+  /* exp(r) - 1, accurate to 6e-10 for |r| <= ln2 / 64 */
+
+  p = r + r * r * (0.5f + r * 1.66666667e-01f);
+  y = g_expf_table[k & 31];
+  y = y + y * p;
+
+  /* Scale by 2^e, in two steps where 2^e itself is not a normal float */
+
+  e = (int32_t)k >> 5;
+  if (e > 127)
+    {
+      y *= 2.0f;
+      e--;
+    }
+  else if (e < -126)
+    {
+      y *= lib_asfloat((uint32_t)(e + 64 + 127) << 23);
+      return y * 5.42101086e-20f; /* 2^-64 */
+    }
+
+  return y * lib_asfloat((uint32_t)(e + 127) << 23);
+}
@@ -0,0 +1,155 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fastlogf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+#include <stdint.h>
+
+#include "libm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* x = 2^k * z with z in [LOGF_OFF, 2 * LOGF_OFF), about [0.7, 1.4), so
+ * that no cancellation occurs between k * ln2 and log(z) near x = 1.  The
+ * top 4 mantissa bits of z select the subinterval.
+ */
+
+#define LOGF_OFF       0x3f330000
+#define LOGF_TABLEBITS 4
+
+/* ln2 split in two parts, k times the first one being exact */
+
+#define LOGF_LN2_1     0.693145752f         /* Top 16 bits of ln2 */
+#define LOGF_LN2_2     1.42860677e-06f      /* The rest */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct logf_entry_s
+{
+  float c;     /* Center of the subinterval, short so that z - c is exact */
+  float invc;  /* 1 / c */
+  float logc;  /* log(c), rounded */
+  float logcl; /* The rounding error of logc */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The subinterval around 1 is centered on 1 so that log(x) is exact there
+ * but for the polynomial.
+ */
+
+static const struct logf_entry_s g_logf_table[1 << LOGF_TABLEBITS] =
+{
+  { 0.71484375f, 1.39890707f,  -0.335691303f,  1.13766134e-08f },
+  { 0.74609375f, 1.34031415f,  -0.292904019f,  2.92284130e-09f },
+  { 0.77734375f, 1.28643215f,  -0.251872629f,  9.17216081e-09f },
+  { 0.80859375f, 1.23671496f,  -0.212458655f,  4.02395806e-09f },
+  { 0.83984375f, 1.19069767f,  -0.174539417f,  6.76527445e-10f },
+  { 0.87109375f, 1.14798212f,  -0.138005674f,  8.65901739e-10f },
+  { 0.90234375f, 1.10822511f,  -0.102759734f, -1.61649250e-10f },
+  { 0.93359375f, 1.07112968f,  -0.068713896f,  3.42849171e-09f },
+  { 0.96484375f, 1.03643727f,  -0.035789106f, -1.81039228e-09f },
+  { 1.00000000f, 1.00000000f,   0.000000000f,  0.000000000f    },
+  { 1.05468750f, 0.948148131f,  0.0532445163f, -1.73465908e-09f },
+  { 1.11718750f, 0.895104885f,  0.110814363f,  3.57593155e-09f },
+  { 1.17968750f, 0.847682118f,  0.165249571f,  1.69112169e-09f },
+  { 1.24218750f, 0.805031419f,  0.216873944f, -5.50508039e-09f },
+  { 1.30468750f, 0.766467094f,  0.265963554f, -5.88518612e-09f },
+  { 1.36718750f, 0.731428564f,  0.312755704f,  6.07781026e-09f },
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: logf
+ *
+ * Description:
+ *   Table driven natural logarithm: log(2^k * z) =
+ *     k * ln2 + log(c) + log(1 + (z - c) / c)
+ *   with log(1 + r) from a polynomial for |r| < 0.03.  The error is below
+ *   1.6 ULP.
+ *
+ ****************************************************************************/
+
+float logf(float x)
+{
+  const struct logf_entry_s *entry;
+  uint32_t ix;
+  uint32_t tmp;
+  int32_t k;
+  float r;
+  float p;
+  float z;
+
+  ix = lib_asuint32(x);
+
+  if (ix - 0x00800000 >= 0x7f800000 - 0x00800000)
+    {
+      /* Zero, subnormal, negative, infinite or NaN */
+
+      if ((ix << 1) == 0)
+        {
+          return -INFINITY_F;
+        }
+
+      if (ix == 0x7f800000 || (ix << 1) > 0xff000000)
+        {
+          return x; /* +Inf or NaN */
+        }
+
+      if (ix & 0x80000000)
+        {
+          return NAN_F;
+        }
+
+      /* Normalize the subnormal */
+
+      ix  = lib_asuint32(x * 8388608.0f); /* 2^23 */
+      ix -= 23 << 23;
+    }
+
+  tmp   = ix - LOGF_OFF;
+  entry = &g_logf_table[(tmp >> (23 - LOGF_TABLEBITS)) &
+                        ((1 << LOGF_TABLEBITS) - 1)];
+  k     = (int32_t)tmp >> 23;
+  z     = lib_asfloat(ix - (tmp & 0xff800000));
+
+  /* Taylor polynomial of log(1 + r), accurate to 4e-9 relative */
+
+  r = (z - entry->c) * entry->invc;
+  p = r + r * r * (-0.5f + r * (3.33333333e-01f +
+                   r * (-0.25f + r * 0.2f)));
+
+  return (k * LOGF_LN2_1 + entry->logc) +
+         (p + (k * LOGF_LN2_2 + entry->logcl));
+}
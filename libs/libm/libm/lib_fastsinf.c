@@ -0,0 +1,247 @@
+/****************************************************************************
+ * libs/libm/libm/lib_fastsinf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <math.h>
+#include <stdint.h>
+
+#include "libm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* x = n * pi / 32 + r is computed with pi / 32 split in four parts, the
+ * first three short enough that n times them is exact for |n| < 2^14, so
+ * that r stays accurate close to the zeros of sin() and cos() too.
+ */
+
+#define SINF_INVPIO32  10.1859159f          /* 32 / pi */
+#define SINF_PIO32_1   0.09814453125f       /* Top 8 bits of pi / 32 */
+#define SINF_PIO32_2   3.02195549e-05f      /* Next 8 bits */
+#define SINF_PIO32_3   1.96159817e-08f      /* Next 8 bits */
+#define SINF_PIO32_4   3.79818399e-12f      /* The rest */
+
+/* The largest |x| the reduction above is exact for */
+
+#define SINF_MAXREDUCE 1024.0f
+
+/* Rounds a float of magnitude below 2^22 to an integer when added */
+
+#define SINF_SHIFT     12582912.0f          /* 1.5 * 2^23 */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* sin(j * pi / 32) as the sum of two floats, so that the rounding of the
+ * table does not show where the two terms of the result cancel.
+ */
+
+struct sinf_entry_s
+{
+  float hi;
+  float lo;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* sin(j * pi / 32), j = 0..63.  cos(j * pi / 32) is entry j + 16. */
+
+static const struct sinf_entry_s g_sinf_table[64] =
+{
+  {  0.0000000000f,  0.000000000000f },
+  {  0.0980171412f, -8.93393193e-10f },
+  {  0.1950903237f, -1.67047143e-09f },
+  {  0.2902846634f,  1.38156651e-08f },
+  {  0.3826834261f,  6.22335072e-09f },
+  {  0.4713967443f, -7.42525375e-09f },
+  {  0.5555702448f, -1.17695214e-08f },
+  {  0.6343932748f,  9.37955758e-09f },
+  {  0.7071067691f,  1.21016175e-08f },
+  {  0.7730104327f,  2.06425526e-08f },
+  {  0.8314695954f,  1.68702634e-08f },
+  {  0.8819212914f, -2.70029634e-08f },
+  {  0.9238795042f,  2.83074897e-08f },
+  {  0.9569403529f, -1.71845080e-08f },
+  {  0.9807852507f,  2.97394731e-08f },
+  {  0.9951847196f,  7.10966619e-09f },
+  {  1.0000000000f,  0.000000000000f },
+  {  0.9951847196f,  7.10966619e-09f },
+  {  0.9807852507f,  2.97394731e-08f },
+  {  0.9569403529f, -1.71845080e-08f },
+  {  0.9238795042f,  2.83074897e-08f },
+  {  0.8819212914f, -2.70029634e-08f },
+  {  0.8314695954f,  1.68702634e-08f },
+  {  0.7730104327f,  2.06425526e-08f },
+  {  0.7071067691f,  1.21016175e-08f },
+  {  0.6343932748f,  9.37955758e-09f },
+  {  0.5555702448f, -1.17695214e-08f },
+  {  0.4713967443f, -7.42525375e-09f },
+  {  0.3826834261f,  6.22335072e-09f },
+  {  0.2902846634f,  1.38156651e-08f },
+  {  0.1950903237f, -1.67047143e-09f },
+  {  0.0980171412f, -8.93393193e-10f },
+  {  0.0000000000f,  0.000000000000f },
+  { -0.0980171412f,  8.93393193e-10f },
+  { -0.1950903237f,  1.67047143e-09f },
+  { -0.2902846634f, -1.38156651e-08f },
+  { -0.3826834261f, -6.22335072e-09f },
+  { -0.4713967443f,  7.42525375e-09f },
+  { -0.5555702448f,  1.17695214e-08f },
+  { -0.6343932748f, -9.37955758e-09f },
+  { -0.7071067691f, -1.21016175e-08f },
+  { -0.7730104327f, -2.06425526e-08f },
+  { -0.8314695954f, -1.68702634e-08f },
+  { -0.8819212914f,  2.70029634e-08f },
+  { -0.9238795042f, -2.83074897e-08f },
+  { -0.9569403529f,  1.71845080e-08f },
+  { -0.9807852507f, -2.97394731e-08f },
+  { -0.9951847196f, -7.10966619e-09f },
+  { -1.0000000000f,  0.000000000000f },
+  { -0.9951847196f, -7.10966619e-09f },
+  { -0.9807852507f, -2.97394731e-08f },
+  { -0.9569403529f,  1.71845080e-08f },
+  { -0.9238795042f, -2.83074897e-08f },
+  { -0.8819212914f,  2.70029634e-08f },
+  { -0.8314695954f, -1.68702634e-08f },
+  { -0.7730104327f, -2.06425526e-08f },
+  { -0.7071067691f, -1.21016175e-08f },
+  { -0.6343932748f, -9.37955758e-09f },
+  { -0.5555702448f,  1.17695214e-08f },
+  { -0.4713967443f,  7.42525375e-09f },
+  { -0.3826834261f, -6.22335072e-09f },
+  { -0.2902846634f, -1.38156651e-08f },
+  { -0.1950903237f,  1.67047143e-09f },
+  { -0.0980171412f,  8.93393193e-10f },
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sinf_reduce
+ *
+ * Description:
+ *   Split x into n * pi / 32 + r with |r| <= pi / 64 and return sin(r) and
+ *   cos(r) - 1.  Arguments too large for an exact reduction are
+ *   first brought into [-2 * pi, 2 * pi] by fmodf(), as the generic sinf()
+ *   does.
+ *
+ ****************************************************************************/
+
+static uint32_t sinf_reduce(float x, float *sinr, float *cosm1)
+{
+  float r2;
+  float t;
+  float n;
+  float r;
+
+  if (!(fabsf(x) < SINF_MAXREDUCE))
+    {
+      x = fmodf(x, 2 * M_PI_F);
+    }
+
+  t = x * SINF_INVPIO32 + SINF_SHIFT;
+  n = t - SINF_SHIFT;
+  r = x - n * SINF_PIO32_1 - n * SINF_PIO32_2 - n * SINF_PIO32_3 -
+      n * SINF_PIO32_4;
+
+  /* Taylor polynomials, accurate to 3e-10 for |r| <= pi / 64 */
+
+  r2    = r * r;
+  *sinr  = r + r * r2 * (-1.66666667e-01f + r2 * 8.33333333e-03f);
+  *cosm1 = r2 * (-0.5f + r2 * 4.16666667e-02f);
+
+  return lib_asuint32(t) - lib_asuint32(SINF_SHIFT);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sinf
+ *
+ * Description:
+ *   Table driven sine: sin(n * pi / 32 + r) =
+ *     sin(n * pi / 32) + sin(n * pi / 32) * (cos(r) - 1) +
+ *     cos(n * pi / 32) * sin(r)
+ *   For |x| < 1024 the error is below 2.5 ULP, or 1e-14 absolute close to
+ *   the zeros of sin(); larger arguments lose the accuracy of the fmodf()
+ *   reduction.
+ *
+ ****************************************************************************/
+
+float sinf(float x)
+{
+  const struct sinf_entry_s *s;
+  const struct sinf_entry_s *c;
+  uint32_t n;
+  float sinr;
+  float cosm1;
+
+  /* Also keeps the sign of zero */
+
+  if (fabsf(x) < 0.000244140625f)
+    {
+      return x;
+    }
+
+  n = sinf_reduce(x, &sinr, &cosm1);
+  s = &g_sinf_table[n & 63];
+  c = &g_sinf_table[(n + 16) & 63];
+
+  return s->hi + (s->lo + (s->hi * cosm1 + c->hi * sinr));
+}
+
+/****************************************************************************
+ * Name: cosf
+ *
+ * Description:
+ *   Table driven cosine: cos(n * pi / 32 + r) =
+ *     cos(n * pi / 32) + cos(n * pi / 32) * (cos(r) - 1) -
+ *     sin(n * pi / 32) * sin(r)
+ *   with the accuracy of sinf().
+ *
+ ****************************************************************************/
+
+float cosf(float x)
+{
+  const struct sinf_entry_s *s;
+  const struct sinf_entry_s *c;
+  uint32_t n;
+  float sinr;
+  float cosm1;
+
+  n = sinf_reduce(x, &sinr, &cosm1);
+  s = &g_sinf_table[n & 63];
+  c = &g_sinf_table[(n + 16) & 63];
+
+  return c->hi + (c->lo + (c->hi * cosm1 - s->hi * sinr));
+}
@@ -0,0 +1,539 @@
+/****************************************************************************
+ * libs/libm/libm/lib_vmathf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <sys/param.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The kernels below work on VMATHF_LANES floats at a time with the vector
+ * extension of GCC, which the compiler maps to Helium (MVE) or NEON when
+ * the target has it and splits into scalar operations otherwise.  They are
+ * branch free and table free, so that no gather loads are needed, and
+ * leave the lanes they cannot handle, such as Inf, NaN or out of range
+ * values, to the scalar functions.
+ */
+
+#ifdef __GNUC__
+#  define VMATHF_VECTOR
+#  define VMATHF_LANES 4
+#endif
+
+/* Rounds a float of magnitude below 2^22 to an integer when added */
+
+#define VMATHF_SHIFT     12582912.0f        /* 1.5 * 2^23 */
+#define VMATHF_SHIFTBITS 0x4b400000
+
+/* expf(): x = n * ln2 + r, |r| <= ln2 / 2 */
+
+#define VEXPF_INVLN2   1.44269502f
+#define VEXPF_LN2_1    0.693145752f         /* Top 16 bits of ln2 */
+#define VEXPF_LN2_2    1.42860677e-06f      /* The rest */
+#define VEXPF_MAX      87.0f                /* 2^n stays a normal float */
+
+/* logf(): x = 2^k * (1 + f), sqrt(2) / 2 <= 1 + f < sqrt(2) */
+
+#define VLOGF_SQRT1_2  0x3f3504f3           /* sqrt(2) / 2 */
+#define VLOGF_LN2_1    0.693145752f
+#define VLOGF_LN2_2    1.42860677e-06f
+
+/* sinf(), cosf(): x = q * pi + r, |r| <= pi / 2, with pi split in four
+ * parts, the first three short enough that q times them is exact.
+ */
+
+#define VSINF_INVPI    0.318309873f
+#define VSINF_PI_1     3.140625f            /* Top 8 bits of pi */
+#define VSINF_PI_2     0.000967025757f      /* Next 8 bits */
+#define VSINF_PI_3     6.27711415e-07f      /* Next 8 bits */
+#define VSINF_PI_4     1.21541888e-10f      /* The rest */
+#define VSINF_MAX      8192.0f
+
+/* atan2f(): atan(t) for t in [0, 1] from atan(u), |u| <= tan(pi / 8) */
+
+#define VATANF_TANPIO8 0.414213568f
+#define VATANF_PI_1    3.14159274f
+#define VATANF_PI_2    -8.74227766e-08f
+#define VATANF_PIO2_1  1.57079637f
+#define VATANF_PIO2_2  -4.37113883e-08f
+#define VATANF_PIO4_1  0.785398185f
+#define VATANF_PIO4_2  -2.18556941e-08f
+#define VATANF_MAX     4.2535296e+37f       /* 2^125 */
+
+#ifdef VMATHF_VECTOR
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef float    vf32_t __attribute__((vector_size(4 * VMATHF_LANES)));
+typedef int32_t  vi32_t __attribute__((vector_size(4 * VMATHF_LANES)));
+typedef uint32_t vu32_t __attribute__((vector_size(4 * VMATHF_LANES)));
+
+/* A kernel returns f(x) and sets the lanes of *special it got wrong */
+
+typedef vf32_t (*vmathf_kernel1_t)(vf32_t x, vi32_t *special);
+typedef vf32_t (*vmathf_kernel2_t)(vf32_t y, vf32_t x,
+                                   vi32_t *special);
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* Inlined into each entry point, so that the kernel is inlined as well */
+
+static inline void vmathf_apply1(vmathf_kernel1_t kernel,
+                                 float (*scalar)(float),
+                                 const float *x, float *y, size_t n)
+                                 always_inline_function;
+static inline void vmathf_apply2(vmathf_kernel2_t kernel,
+                                 float (*scalar)(float, float),
+                                 const float *y, const float *x, float *z,
+                                 size_t n) always_inline_function;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Fills the lanes past the end of a short tail, where every kernel is
+ * well defined.
+ */
+
+static const vf32_t g_vmathf_one =
+{
+  1.0f, 1.0f, 1.0f, 1.0f
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static inline vf32_t vmathf_select(vi32_t mask, vf32_t a, vf32_t b)
+{
+  return (vf32_t)(((vi32_t)a & mask) | ((vi32_t)b & ~mask));
+}
+
+static inline vf32_t vmathf_abs(vf32_t x)
+{
+  return (vf32_t)((vu32_t)x & 0x7fffffff);
+}
+
+/****************************************************************************
+ * Name: vexpf_kernel
+ *
+ * Description:
+ *   exp(x) = 2^n * exp(r), with a degree 6 polynomial for exp(r).  The
+ *   error is below 1.5 ULP for |x| < 87.
+ *
+ ****************************************************************************/
+
+static inline vf32_t vexpf_kernel(vf32_t x, vi32_t *special)
+{
+  vf32_t t;
+  vf32_t n;
+  vf32_t r;
+  vf32_t p;
+  vi32_t e;
+
+  *special = ~(vmathf_abs(x) < VEXPF_MAX);
+
+  t = x * VEXPF_INVLN2 + VMATHF_SHIFT;
+  n = t - VMATHF_SHIFT;
+  r = x - n * VEXPF_LN2_1 - n * VEXPF_LN2_2;
+
+  p = r * 1.39411085e-03f + 8.37512594e-03f;
+  p = p * r + 4.16663513e-02f;
+  p = p * r + 1.66664153e-01f;
+  p = p * r + 0.5f;
+  p = p * r + 1.0f;
+  p = p * r + 1.0f;
+
+  e = ((vi32_t)t - VMATHF_SHIFTBITS + 127) << 23;
+  return p * (vf32_t)e;
+}
+
+/****************************************************************************
+ * Name: vlogf_kernel
+ *
+ * Description:
+ *   log(x) = k * ln2 + log(1 + f), with log(1 + f) = f - f^2 / 2 +
+ *   f^3 * Q(f) and Q a degree 7 polynomial.  The error is below 1.5 ULP for
+ *   positive normal x.
+ *
+ ****************************************************************************/
+
+static inline vf32_t vlogf_kernel(vf32_t x, vi32_t *special)
+{
+  vi32_t ix;
+  vi32_t k;
+  vf32_t kf;
+  vf32_t f;
+  vf32_t q;
+  vf32_t y;
+
+  ix       = (vi32_t)x;
+  *special = (vi32_t)((vu32_t)(ix - 0x00800000) >=
+                      (uint32_t)(0x7f800000 - 0x00800000));
+
+  k  = (ix - VLOGF_SQRT1_2) >> 23;
+  f  = (vf32_t)(ix - (k << 23)) - 1.0f;
+  kf = (vf32_t)(k + VMATHF_SHIFTBITS) - VMATHF_SHIFT;
+
+  q = f * -7.90274590e-02f + 1.26223207e-01f;
+  q = q * f - 1.29981831e-01f;
+  q = q * f + 1.42144963e-01f;
+  q = q * f - 1.66412815e-01f;
+  q = q * f + 2.00010449e-01f;
+  q = q * f - 2.50003070e-01f;
+  q = q * f + 3.33333313e-01f;
+
+  y = f + f * f * (-0.5f + f * q);
+  return kf * VLOGF_LN2_1 + (y + kf * VLOGF_LN2_2);
+}
+
+/****************************************************************************
+ * Name: vsinf_poly
+ *
+ * Description:
+ *   sin(r) = r + r^3 * S(r^2) for |r| <= pi / 2, with S a degree 4
+ *   polynomial, and the sign flipped in the lanes where n is odd.
+ *
+ ****************************************************************************/
+
+static inline vf32_t vsinf_poly(vf32_t r, vi32_t n)
+{
+  vf32_t s;
+  vf32_t p;
+
+  s = r * r;
+  p = s * -2.40801903e-08f + 2.75364641e-06f;
+  p = p * s - 1.98410868e-04f;
+  p = p * s + 8.33333284e-03f;
+  p = p * s - 1.66666672e-01f;
+
+  r = r + r * s * p;
+  return (vf32_t)((vu32_t)r ^ ((vu32_t)n << 31));
+}
+
+/****************************************************************************
+ * Name: vsinf_kernel
+ *
+ * Description:
+ *   sin(n * pi + r) = (-1)^n * sin(r).  The error is below 2.5 ULP for
+ *   |x| < 8192, away from the zeros of sin().
+ *
+ ****************************************************************************/
+
+static inline vf32_t vsinf_kernel(vf32_t x, vi32_t *special)
+{
+  vf32_t t;
+  vf32_t n;
+  vf32_t r;
+
+  *special = ~(vmathf_abs(x) < VSINF_MAX);
+
+  t = x * VSINF_INVPI + VMATHF_SHIFT;
+  n = t - VMATHF_SHIFT;
+  r = x - n * VSINF_PI_1 - n * VSINF_PI_2 - n * VSINF_PI_3 -
+      n * VSINF_PI_4;
+
+  return vsinf_poly(r, (vi32_t)t);
+}
+
+/****************************************************************************
+ * Name: vcosf_kernel
+ *
+ * Description:
+ *   cos((n - 1 / 2) * pi + r) = (-1)^n * sin(r), with the accuracy of
+ *   vsinf_kernel().
+ *
+ ****************************************************************************/
+
+static inline vf32_t vcosf_kernel(vf32_t x, vi32_t *special)
+{
+  vf32_t t;
+  vf32_t q;
+  vf32_t r;
+
+  *special = ~(vmathf_abs(x) < VSINF_MAX);
+
+  t = (x * VSINF_INVPI + 0.5f) + VMATHF_SHIFT;
+  q = (t - VMATHF_SHIFT) - 0.5f;
+  r = x - q * VSINF_PI_1 - q * VSINF_PI_2 - q * VSINF_PI_3 -
+      q * VSINF_PI_4;
+
+  return vsinf_poly(r, (vi32_t)t);
+}
+
+/****************************************************************************
+ * Name: vatan2f_kernel
+ *
+ * Description:
+ *   atan(t) for t = min(|x|, |y|) / max(|x|, |y|) is computed from a
+ *   degree 13 polynomial of u = t or, above tan(pi / 8), of
+ *   u = (t - 1) / (t + 1) plus pi / 4, then mapped to the quadrant of
+ *   (x, y).  The error is below 2.5 ULP.
+ *
+ ****************************************************************************/
+
+static inline vf32_t vatan2f_kernel(vf32_t y, vf32_t x,
+                                    vi32_t *special)
+{
+  vi32_t swap;
+  vi32_t red;
+  vf32_t num;
+  vf32_t den;
+  vf32_t ax;
+  vf32_t ay;
+  vf32_t a;
+  vf32_t p;
+  vf32_t s;
+  vf32_t u;
+
+  ax   = vmathf_abs(x);
+  ay   = vmathf_abs(y);
+  swap = ay > ax;
+  num  = vmathf_select(swap, ax, ay);
+  den  = vmathf_select(swap, ay, ax);
+
+  /* Zeros, infinities, NaNs and the values whose sum could overflow */
+
+  *special = ~(den < VATANF_MAX) | (den == 0.0f);
+
+  red = num > den * VATANF_TANPIO8;
+  u   = vmathf_select(red, num - den, num) /
+        vmathf_select(red, num + den, den);
+
+  s = u * u;
+  p = s * 5.04813790e-02f - 8.62467587e-02f;
+  p = p * s + 1.10713653e-01f;
+  p = p * s - 1.42841518e-01f;
+  p = p * s + 1.99999779e-01f;
+  p = p * s - 3.33333343e-01f;
+
+  a = u + u * s * p;
+  a = vmathf_select(red, (a + VATANF_PIO4_2) + VATANF_PIO4_1, a);
+  a = vmathf_select(swap, VATANF_PIO2_1 - (a - VATANF_PIO2_2), a);
+  a = vmathf_select((vi32_t)x < 0, VATANF_PI_1 - (a - VATANF_PI_2), a);
+
+  return (vf32_t)((vi32_t)a | ((vi32_t)y & (int32_t)0x80000000));
+}
+
+/****************************************************************************
+ * Name: vmathf_apply1
+ *
+ * Description:
+ *   Run kernel over x[0..n - 1], VMATHF_LANES at a time, and redo the
+ *   lanes it cannot handle with the scalar function.  x and y may be the
+ *   same array.
+ *
+ ****************************************************************************/
+
+static inline void vmathf_apply1(vmathf_kernel1_t kernel,
+                                 float (*scalar)(float),
+                                 const float *x, float *y, size_t n)
+{
+  vi32_t special;
+  vf32_t vx;
+  vf32_t vy;
+  size_t count;
+  size_t i;
+
+  while (n > 0)
+    {
+      count = MIN(n, VMATHF_LANES);
+      vx    = g_vmathf_one;
+      memcpy(&vx, x, count * sizeof(float));
+
+      vy = kernel(vx, &special);
+
+      for (i = 0; i < count; i++)
+        {
+          if (special[i])
+            {
+              vy[i] = scalar(vx[i]);
+            }
+        }
+
+      memcpy(y, &vy, count * sizeof(float));
+      x += count;
+      y += count;
+      n -= count;
+    }
+}
+
+/****************************************************************************
+ * Name: vmathf_apply2
+ *
+ * Description:
+ *   vmathf_apply1() for the functions of two arguments.
+ *
+ ****************************************************************************/
+
+static inline void vmathf_apply2(vmathf_kernel2_t kernel,
+                                 float (*scalar)(float, float),
+                                 const float *y, const float *x, float *z,
+                                 size_t n)
+{
+  vi32_t special;
+  vf32_t vy;
+  vf32_t vx;
+  vf32_t vz;
+  size_t count;
+  size_t i;
+
+  while (n > 0)
+    {
+      count = MIN(n, VMATHF_LANES);
+      vy    = g_vmathf_one;
+      vx    = vy;
+      memcpy(&vy, y, count * sizeof(float));
+      memcpy(&vx, x, count * sizeof(float));
+
+      vz = kernel(vy, vx, &special);
+
+      for (i = 0; i < count; i++)
+        {
+          if (special[i])
+            {
+              vz[i] = scalar(vy[i], vx[i]);
+            }
+        }
+
+      memcpy(z, &vz, count * sizeof(float));
+      y += count;
+      x += count;
+      z += count;
+      n -= count;
+    }
+}
+
+#endif /* VMATHF_VECTOR */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vsinf, vcosf, vexpf, vlogf
+ *
+ * Description:
+ *   Compute y[i] = f(x[i]) for i = 0..n - 1.  The results match the
+ *   scalar functions to within the error of the vector kernels for the
+ *   arguments those handle; x and y may be the same array.
+ *
+ ****************************************************************************/
+
+void vsinf(const float *x, float *y, size_t n)
+{
+#ifdef VMATHF_VECTOR
+  vmathf_apply1(vsinf_kernel, sinf, x, y, n);
+#else
+  while (n-- > 0)
+    {
+      *y++ = sinf(*x++);
+    }
+#endif
+}
+
+void vcosf(const float *x, float *y, size_t n)
+{
+#ifdef VMATHF_VECTOR
+  vmathf_apply1(vcosf_kernel, cosf, x, y, n);
+#else
+  while (n-- > 0)
+    {
+      *y++ = cosf(*x++);
+    }
+#endif
+}
+
+void vexpf(const float *x, float *y, size_t n)
+{
+#ifdef VMATHF_VECTOR
+  vmathf_apply1(vexpf_kernel, expf, x, y, n);
+#else
+  while (n-- > 0)
+    {
+      *y++ = expf(*x++);
+    }
+#endif
+}
+
+void vlogf(const float *x, float *y, size_t n)
+{
+#ifdef VMATHF_VECTOR
+  vmathf_apply1(vlogf_kernel, logf, x, y, n);
+#else
+  while (n-- > 0)
+    {
+      *y++ = logf(*x++);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: vatan2f
+ *
+ * Description:
+ *   Compute z[i] = atan2f(y[i], x[i]) for i = 0..n - 1.
+ *
+ ****************************************************************************/
+
+void vatan2f(const float *y, const float *x, float *z,
+             size_t n)
+{
+#ifdef VMATHF_VECTOR
+  vmathf_apply2(vatan2f_kernel, atan2f, y, x, z, n);
+#else
+  while (n-- > 0)
+    {
+      *z++ = atan2f(*y++, *x++);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: vsqrtf
+ *
+ * Description:
+ *   Compute y[i] = sqrtf(x[i]) for i = 0..n - 1.  Neither Helium nor
+ *   32-bit NEON has a vector square root, so this relies on the scalar
+ *   sqrtf(), which is a single instruction with a hardware FPU.
+ *
+ ****************************************************************************/
+
+void vsqrtf(const float *x, float *y, size_t n)
+{
+  while (n-- > 0)
+    {
+      *y++ = sqrtf(*x++);
+    }
+}
@@ -27,6 +27,7 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -36,6 +37,14 @@
  * Public Types
  ****************************************************************************/
 
+/* Permits to convert between a float and its IEEE 754 representation */
+
+union lib_float_u
+{
+  float    f;
+  uint32_t i;
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -62,6 +71,26 @@ double lib_expi(size_t n);
 
 float lib_sqrtapprox(float x);
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+static inline uint32_t lib_asuint32(float x)
+{
+  union lib_float_u u;
+
+  u.f = x;
+  return u.i;
+}
+
+static inline float lib_asfloat(uint32_t i)
+{
+  union lib_float_u u;
+
+  u.i = i;
+  return u.f;
+}
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
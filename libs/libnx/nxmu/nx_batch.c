@@ -0,0 +1,224 @@
+/****************************************************************************
+ * libs/libnx/nxmu/nx_batch.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/nx/nx.h>
+#include <nuttx/nx/nxmu.h>
+
+#ifdef CONFIG_NX_BATCH
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_batchbegin
+ *
+ * Description:
+ *   Start collecting the drawing commands of the connection.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_batchbegin(NXHANDLE handle)
+{
+  FAR struct nxmu_conn_s *conn = (FAR struct nxmu_conn_s *)handle;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (conn == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+#endif
+
+  conn->batching = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nx_batchend
+ *
+ * Description:
+ *   Send the collected drawing commands to the server and stop collecting.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_batchend(NXHANDLE handle)
+{
+  FAR struct nxmu_conn_s *conn = (FAR struct nxmu_conn_s *)handle;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (conn == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+#endif
+
+  conn->batching = false;
+  return nxmu_batchflush(conn);
+}
+
+/****************************************************************************
+ * Name: nxmu_batchadd
+ *
+ * Description:
+ *  Add a message to the batch of the connection if it is a drawing command
+ *  that can be batched, else send it to the server after the batch.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *   msg    - A pointer to the message to send
+ *   msglen - The length of the message in bytes.
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nxmu_batchadd(FAR struct nxmu_conn_s *conn, FAR const void *msg,
+                  size_t msglen)
+{
+  FAR uint8_t *cmd;
+  size_t cmdlen;
+  int ret;
+
+  /* Only the commands that the server does not reply to can wait in the
+   * batch.  The others go out right away, after the batch.
+   */
+
+  switch (*(FAR const uint32_t *)msg)
+    {
+      case NX_SVRMSG_SETPIXEL:
+      case NX_SVRMSG_FILL:
+      case NX_SVRMSG_FILLTRAP:
+      case NX_SVRMSG_MOVE:
+        break;
+
+      default:
+        return nxmu_sendserver(conn, msg, msglen);
+    }
+
+  cmdlen = NX_BATCH_ALIGN(sizeof(size_t)) + NX_BATCH_ALIGN(msglen);
+  if (cmdlen > sizeof(conn->batch))
+    {
+      return nxmu_sendserver(conn, msg, msglen);
+    }
+
+  /* Make room for the command */
+
+  if (conn->nbatch + cmdlen > sizeof(conn->batch))
+    {
+      ret = nxmu_batchflush(conn);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  cmd = (FAR uint8_t *)conn->batch + conn->nbatch;
+  *(FAR size_t *)cmd = msglen;
+  memcpy(cmd + NX_BATCH_ALIGN(sizeof(size_t)), msg, msglen);
+  conn->nbatch += cmdlen;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmu_batchflush
+ *
+ * Description:
+ *  Send the collected drawing commands of the connection to the server and
+ *  wait until it executed them, so that the batch buffer can be reused.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nxmu_batchflush(FAR struct nxmu_conn_s *conn)
+{
+  struct nxsvrmsg_batch_s outmsg;
+  sem_t sem_done;
+  int ret;
+
+  if (conn->nbatch == 0)
+    {
+      return OK;
+    }
+
+  /* Format the batch command.  The server reads the commands from the
+   * buffer of the connection.
+   */
+
+  outmsg.msgid    = NX_SVRMSG_BATCH;
+  outmsg.cmds     = (FAR uint8_t *)conn->batch;
+  outmsg.len      = conn->nbatch;
+  outmsg.sem_done = &sem_done;
+
+  /* The batch is empty for nxmu_sendserver() */
+
+  conn->nbatch    = 0;
+
+  ret = _SEM_INIT(&sem_done, 0, 0);
+  if (ret < 0)
+    {
+      gerr("ERROR: _SEM_INIT failed: %d\n", _SEM_ERRNO(ret));
+      return ret;
+    }
+
+  ret = nxmu_sendserver(conn, &outmsg, sizeof(struct nxsvrmsg_batch_s));
+
+  /* Wait until the server is done with the buffer */
+
+  if (ret == OK)
+    {
+      ret = _SEM_WAIT(&sem_done);
+    }
+
+  _SEM_DESTROY(&sem_done);
+  return ret;
+}
+
+#endif /* CONFIG_NX_BATCH */
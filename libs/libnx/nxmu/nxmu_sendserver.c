@@ -66,6 +66,15 @@ int nxmu_sendserver(FAR struct nxmu_conn_s *conn, FAR const void *msg,
     }
 #endif
 
+#ifdef CONFIG_NX_BATCH
+  /* Keep the order of the commands, the collected ones go first */
+
+  if (conn->nbatch > 0 && nxmu_batchflush(conn) < 0)
+    {
+      return ERROR;
+    }
+#endif
+
   /* Send the message to the server */
 
   ret = _MQ_SEND(conn->cwrmq, msg, msglen, NX_SVRMSG_PRIO);
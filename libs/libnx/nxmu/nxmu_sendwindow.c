@@ -71,9 +71,20 @@ int nxmu_sendwindow(FAR struct nxbe_window_s *wnd, FAR const void *msg,
 
   if (!NXBE_ISBLOCKED(wnd))
     {
-      /* Send the message to the server */
+#ifdef CONFIG_NX_BATCH
+      /* Collect the drawing commands after nx_batchbegin() */
 
-      ret = nxmu_sendserver(wnd->conn, msg, msglen);
+      if (wnd->conn->batching)
+        {
+          ret = nxmu_batchadd(wnd->conn, msg, msglen);
+        }
+      else
+#endif
+        {
+          /* Send the message to the server */
+
+          ret = nxmu_sendserver(wnd->conn, msg, msglen);
+        }
     }
 
   return ret;
@@ -0,0 +1,303 @@
+//***************************************************************************
+// libs/libxx/libcxxcoro/libxx_executor.cxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cerrno>
+#include <new>
+
+#include <debug.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include <nuttx/coroutine.hxx>
+
+#ifdef CONFIG_LIBCXX_PMR
+#  include <nuttx/mm/memory_resource.hxx>
+#endif
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+static uint64_t executor_now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+#ifdef CONFIG_LIBCXX_PMR
+static nuttx::pmr::memory_resource *executor_frames()
+{
+  static nuttx::pmr::mempool_resource frames("coro");
+
+  return &frames;
+}
+#endif
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx
+{
+namespace coro
+{
+  void *frame_alloc(std::size_t size)
+  {
+#ifdef CONFIG_LIBCXX_PMR
+    return executor_frames()->allocate(size);
+#else
+    return ::operator new(size);
+#endif
+  }
+
+  void frame_free(void *p, std::size_t size)
+  {
+#ifdef CONFIG_LIBCXX_PMR
+    executor_frames()->deallocate(p, size);
+#else
+    ::operator delete(p);
+#endif
+  }
+
+  executor::executor()
+    : m_stop(false)
+  {
+    struct epoll_event ev;
+
+    pthread_mutex_init(&m_lock, NULL);
+
+    m_epfd = epoll_create1(EPOLL_CLOEXEC);
+    m_evfd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_epfd < 0 || m_evfd < 0)
+      {
+        _err("ERROR: Failed to create the executor: %d\n", errno);
+        return;
+      }
+
+    // post() writes the eventfd to interrupt epoll_wait().  It is told
+    // apart from the io_awaiters by its NULL pointer.
+
+    ev.events   = EPOLLIN;
+    ev.data.ptr = NULL;
+    if (epoll_ctl(m_epfd, EPOLL_CTL_ADD, m_evfd, &ev) < 0)
+      {
+        _err("ERROR: Failed to watch the eventfd: %d\n", errno);
+        close(m_evfd);
+        m_evfd = -1;
+      }
+  }
+
+  executor::~executor()
+  {
+    if (m_evfd >= 0)
+      {
+        close(m_evfd);
+      }
+
+    if (m_epfd >= 0)
+      {
+        close(m_epfd);
+      }
+
+    pthread_mutex_destroy(&m_lock);
+  }
+
+  void executor::spawn(task<void> &&t)
+  {
+    task<void>::handle_type h = t.release();
+
+    h.promise().m_detached = true;
+    post(h);
+  }
+
+  void executor::post(coroutine_handle<> h)
+  {
+    bool wake;
+
+    pthread_mutex_lock(&m_lock);
+    wake = m_posted.empty();
+    m_posted.push_back(h);
+    pthread_mutex_unlock(&m_lock);
+
+    // Only the first post() after run() has collected the posted
+    // coroutines needs to wake it up
+
+    if (wake)
+      {
+        eventfd_write(m_evfd, 1);
+      }
+  }
+
+  void executor::stop()
+  {
+    pthread_mutex_lock(&m_lock);
+    m_stop = true;
+    pthread_mutex_unlock(&m_lock);
+
+    eventfd_write(m_evfd, 1);
+  }
+
+  int executor::forget(int fd)
+  {
+    if (epoll_ctl(m_epfd, EPOLL_CTL_DEL, fd, NULL) < 0)
+      {
+        return -errno;
+      }
+
+    return OK;
+  }
+
+  int executor::arm(int fd, uint32_t events, FAR io_awaiter *waiter)
+  {
+    struct epoll_event ev;
+
+    // The descriptor is one-shot, so that it stays in the epoll set between
+    // two waits but never reports to a coroutine that is not waiting.  It
+    // is re-armed with EPOLL_CTL_MOD and added on its first wait.
+
+    ev.events   = events | EPOLLONESHOT;
+    ev.data.ptr = waiter;
+
+    if (epoll_ctl(m_epfd, EPOLL_CTL_MOD, fd, &ev) == 0)
+      {
+        return OK;
+      }
+
+    if (errno == ENOENT && epoll_ctl(m_epfd, EPOLL_CTL_ADD, fd, &ev) == 0)
+      {
+        return OK;
+      }
+
+    return -errno;
+  }
+
+  void executor::add_timer(unsigned int msec, coroutine_handle<> h)
+  {
+    m_timers.push(timer{executor_now() + msec, h});
+  }
+
+  int executor::next_timeout()
+  {
+    uint64_t now;
+
+    if (m_timers.empty())
+      {
+        return -1;
+      }
+
+    now = executor_now();
+    if (m_timers.top().deadline <= now)
+      {
+        return 0;
+      }
+
+    return (int)(m_timers.top().deadline - now);
+  }
+
+  int executor::run()
+  {
+    struct epoll_event events[CONFIG_LIBCXX_COROUTINE_NEVENTS];
+    std::vector<coroutine_handle<>> batch;
+    eventfd_t value;
+    uint64_t now;
+    bool stop;
+    int ret = OK;
+    int n;
+
+    for (; ; )
+      {
+        // Collect what other threads have posted.  This must follow the
+        // read of the eventfd, or a wakeup could be lost.
+
+        pthread_mutex_lock(&m_lock);
+        stop   = m_stop;
+        m_stop = false;
+        m_ready.insert(m_ready.end(), m_posted.begin(), m_posted.end());
+        m_posted.clear();
+        pthread_mutex_unlock(&m_lock);
+
+        if (stop)
+          {
+            break;
+          }
+
+        // Resume the ready coroutines.  Those made ready meanwhile wait for
+        // the next round.
+
+        batch.swap(m_ready);
+        for (coroutine_handle<> h : batch)
+          {
+            h.resume();
+          }
+
+        batch.clear();
+
+        n = epoll_wait(m_epfd, events, CONFIG_LIBCXX_COROUTINE_NEVENTS,
+                       m_ready.empty() ? next_timeout() : 0);
+        if (n < 0)
+          {
+            if (errno == EINTR)
+              {
+                continue;
+              }
+
+            ret = -errno;
+            break;
+          }
+
+        for (int i = 0; i < n; i++)
+          {
+            FAR io_awaiter *waiter =
+              static_cast<FAR io_awaiter *>(events[i].data.ptr);
+
+            if (waiter == NULL)
+              {
+                eventfd_read(m_evfd, &value);
+              }
+            else
+              {
+                waiter->m_revents = events[i].events;
+                m_ready.push_back(waiter->m_handle);
+              }
+          }
+
+        now = executor_now();
+        while (!m_timers.empty() && m_timers.top().deadline <= now)
+          {
+            m_ready.push_back(m_timers.top().handle);
+            m_timers.pop();
+          }
+      }
+
+    return ret;
+  }
+} // namespace coro
+} // namespace nuttx
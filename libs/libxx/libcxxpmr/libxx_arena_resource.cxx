@@ -0,0 +1,218 @@
+//***************************************************************************
+// libs/libxx/libcxxpmr/libxx_arena_resource.cxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <new>
+#include <pthread.h>
+
+#include <nuttx/mm/memory_resource.hxx>
+
+//***************************************************************************
+// Pre-processor Definitions
+//***************************************************************************
+
+// The chunk header is padded so that the first block is aligned too
+
+#define ARENA_HDRSIZE \
+  ((sizeof(chunk) + LIBCXX_PMR_GRANULE - 1) & ~(LIBCXX_PMR_GRANULE - 1))
+
+//***************************************************************************
+// Private Data
+//***************************************************************************
+
+#if CONFIG_TLS_NELEM > 0
+static pthread_once_t g_arena_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_arena_key;
+static bool g_arena_haskey;
+#endif
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+#if CONFIG_TLS_NELEM > 0
+static void arena_destroy(FAR void *arg)
+{
+  delete static_cast<nuttx::pmr::arena_resource *>(arg);
+}
+
+static void arena_key_create()
+{
+  g_arena_haskey = pthread_key_create(&g_arena_key, arena_destroy) == 0;
+}
+#endif
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx
+{
+namespace pmr
+{
+  arena_resource::arena_resource(std::size_t chunksize,
+                                 memory_resource *upstream)
+    : m_free(),
+      m_chunks(NULL),
+      m_cur(NULL),
+      m_end(NULL),
+      m_chunksize(chunksize),
+      m_upstream(upstream)
+  {
+  }
+
+  arena_resource::~arena_resource()
+  {
+    release();
+  }
+
+  void arena_resource::release()
+  {
+    while (m_chunks != NULL)
+      {
+        FAR struct chunk *c = m_chunks;
+
+        m_chunks = c->next;
+        m_upstream->deallocate(c, c->size, alignof(std::max_align_t));
+      }
+
+    for (size_t i = 0; i < LIBCXX_PMR_NCLASSES; i++)
+      {
+        m_free[i] = NULL;
+      }
+
+    m_cur = NULL;
+    m_end = NULL;
+  }
+
+  void *arena_resource::do_allocate(std::size_t bytes,
+                                    std::size_t alignment)
+  {
+    FAR struct block *b;
+    size_t index;
+    size_t size;
+
+    if (bytes > CONFIG_LIBCXX_PMR_THRESHOLD ||
+        alignment > LIBCXX_PMR_GRANULE)
+      {
+        return m_upstream->allocate(bytes, alignment);
+      }
+
+    index = bytes > 0 ? (bytes - 1) / LIBCXX_PMR_GRANULE : 0;
+    b     = m_free[index];
+    if (b != NULL)
+      {
+        m_free[index] = b->next;
+        return b;
+      }
+
+    // Carve a new block.  What is left of the current chunk is abandoned
+    // when it is too small.
+
+    size = (index + 1) * LIBCXX_PMR_GRANULE;
+    if (static_cast<size_t>(m_end - m_cur) < size)
+      {
+        size_t chunksize = m_chunksize;
+        FAR struct chunk *c;
+
+        if (chunksize < ARENA_HDRSIZE + CONFIG_LIBCXX_PMR_THRESHOLD)
+          {
+            chunksize = ARENA_HDRSIZE + CONFIG_LIBCXX_PMR_THRESHOLD;
+          }
+
+        c = static_cast<FAR struct chunk *>(
+              m_upstream->allocate(chunksize, alignof(std::max_align_t)));
+        if (c == NULL)
+          {
+            return NULL;
+          }
+
+        c->next  = m_chunks;
+        c->size  = chunksize;
+        m_chunks = c;
+        m_cur    = reinterpret_cast<FAR char *>(c) + ARENA_HDRSIZE;
+        m_end    = reinterpret_cast<FAR char *>(c) + chunksize;
+      }
+
+    b      = reinterpret_cast<FAR struct block *>(m_cur);
+    m_cur += size;
+    return b;
+  }
+
+  void arena_resource::do_deallocate(void *p, std::size_t bytes,
+                                     std::size_t alignment)
+  {
+    FAR struct block *b;
+    size_t index;
+
+    if (bytes > CONFIG_LIBCXX_PMR_THRESHOLD ||
+        alignment > LIBCXX_PMR_GRANULE)
+      {
+        m_upstream->deallocate(p, bytes, alignment);
+        return;
+      }
+
+    index         = bytes > 0 ? (bytes - 1) / LIBCXX_PMR_GRANULE : 0;
+    b             = static_cast<FAR struct block *>(p);
+    b->next       = m_free[index];
+    m_free[index] = b;
+  }
+
+  bool arena_resource::do_is_equal(const memory_resource &other)
+    const noexcept
+  {
+    return this == &other;
+  }
+
+#if CONFIG_TLS_NELEM > 0
+  memory_resource *thread_arena_resource()
+  {
+    FAR arena_resource *arena;
+
+    pthread_once(&g_arena_once, arena_key_create);
+    if (!g_arena_haskey)
+      {
+        return get_default_resource();
+      }
+
+    arena = static_cast<FAR arena_resource *>(
+              pthread_getspecific(g_arena_key));
+    if (arena == NULL)
+      {
+        arena = new (std::nothrow) arena_resource();
+        if (arena == NULL)
+          {
+            return get_default_resource();
+          }
+
+        pthread_setspecific(g_arena_key, arena);
+      }
+
+    return arena;
+  }
+#endif
+} // namespace pmr
+} // namespace nuttx
@@ -0,0 +1,137 @@
+//***************************************************************************
+// libs/libxx/libcxxpmr/libxx_mempool_resource.cxx
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+// under the License.
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <debug.h>
+
+#include <nuttx/lib/lib.h>
+#include <nuttx/mm/mempool.h>
+#include <nuttx/mm/memory_resource.hxx>
+
+//***************************************************************************
+// Private Functions
+//***************************************************************************
+
+// The pools grow from the heap.  Only a growing pool takes the heap lock.
+
+static FAR void *mempool_resource_alloc(FAR void *arg, size_t alignment,
+                                        size_t size)
+{
+  return lib_memalign(alignment, size);
+}
+
+static size_t mempool_resource_size(FAR void *arg, FAR void *addr)
+{
+  return lib_malloc_size(addr);
+}
+
+static void mempool_resource_free(FAR void *arg, FAR void *addr)
+{
+  lib_free(addr);
+}
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx
+{
+namespace pmr
+{
+  mempool_resource::mempool_resource(FAR const char *name,
+                                     memory_resource *upstream)
+    : m_upstream(upstream)
+  {
+    size_t poolsize[LIBCXX_PMR_NCLASSES];
+
+    for (size_t i = 0; i < LIBCXX_PMR_NCLASSES; i++)
+      {
+        poolsize[i] = (i + 1) * LIBCXX_PMR_GRANULE;
+      }
+
+    m_mpool = mempool_multiple_init(name, poolsize, LIBCXX_PMR_NCLASSES,
+                                    mempool_resource_alloc,
+                                    mempool_resource_size,
+                                    mempool_resource_free, NULL, 0,
+                                    CONFIG_LIBCXX_PMR_EXPANDSIZE,
+                                    CONFIG_LIBCXX_PMR_EXPANDSIZE);
+    if (m_mpool == NULL)
+      {
+        // Everything will come from 'upstream'
+
+        _err("ERROR: Failed to create the mempools of %s\n", name);
+      }
+  }
+
+  mempool_resource::~mempool_resource()
+  {
+    if (m_mpool != NULL)
+      {
+        mempool_multiple_deinit(m_mpool);
+      }
+  }
+
+  void *mempool_resource::do_allocate(std::size_t bytes,
+                                      std::size_t alignment)
+  {
+    FAR void *p = NULL;
+
+    if (m_mpool != NULL && bytes <= CONFIG_LIBCXX_PMR_THRESHOLD)
+      {
+        if (alignment <= alignof(std::max_align_t))
+          {
+            p = mempool_multiple_alloc(m_mpool, bytes);
+          }
+        else
+          {
+            p = mempool_multiple_memalign(m_mpool, alignment, bytes);
+          }
+      }
+
+    if (p == NULL)
+      {
+        p = m_upstream->allocate(bytes, alignment);
+      }
+
+    return p;
+  }
+
+  void mempool_resource::do_deallocate(void *p, std::size_t bytes,
+                                       std::size_t alignment)
+  {
+    if (m_mpool == NULL || mempool_multiple_free(m_mpool, p) < 0)
+      {
+        m_upstream->deallocate(p, bytes, alignment);
+      }
+  }
+
+  bool mempool_resource::do_is_equal(const memory_resource &other)
+    const noexcept
+  {
+    return this == &other;
+  }
+} // namespace pmr
+} // namespace nuttx
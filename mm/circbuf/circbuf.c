@@ -36,6 +36,23 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/circbuf.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each index is only written by one side.  With MM_CIRCBUF_SPSC the
+ * release store of an index publishes the data moved before it, and the
+ * acquire load by the other side makes that data visible.
+ */
+
+#ifdef CONFIG_MM_CIRCBUF_SPSC
+#  define circbuf_load(p)     __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#  define circbuf_store(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#else
+#  define circbuf_load(p)     (*(p))
+#  define circbuf_store(p, v) (*(p) = (v))
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -209,7 +226,10 @@ size_t circbuf_size(FAR struct circbuf_s *circ)
 size_t circbuf_used(FAR struct circbuf_s *circ)
 {
   DEBUGASSERT(circ);
-  return circ->head - circ->tail;
+
+  /* Called by the producer or the consumer, one of the indexes is stable */
+
+  return circbuf_load(&circ->head) - circbuf_load(&circ->tail);
 }
 
 /****************************************************************************
@@ -296,6 +316,8 @@ bool circbuf_is_full(FAR struct circbuf_s *circ)
 ssize_t circbuf_peekat(FAR struct circbuf_s *circ, size_t pos,
                        FAR void *dst, size_t bytes)
 {
+  size_t head;
+  size_t tail;
   size_t len;
   size_t off;
 
@@ -306,12 +328,14 @@ ssize_t circbuf_peekat(FAR struct circbuf_s *circ, size_t pos,
       return 0;
     }
 
-  if (circ->head - pos > circ->head - circ->tail)
+  tail = circbuf_load(&circ->tail);
+  head = circbuf_load(&circ->head);
+  if (head - pos > head - tail)
     {
-      pos = circ->tail;
+      pos = tail;
     }
 
-  len = circ->head - pos;
+  len = head - pos;
   off = pos % circ->size;
 
   if (bytes > len)
@@ -384,7 +408,7 @@ ssize_t circbuf_read(FAR struct circbuf_s *circ,
   DEBUGASSERT(dst || !bytes);
 
   bytes = circbuf_peek(circ, dst, bytes);
-  circ->tail += bytes;
+  circbuf_store(&circ->tail, circ->tail + bytes);
 
   return bytes;
 }
@@ -421,7 +445,7 @@ ssize_t circbuf_skip(FAR struct circbuf_s *circ, size_t bytes)
       bytes = len;
     }
 
-  circ->tail += bytes;
+  circbuf_store(&circ->tail, circ->tail + bytes);
 
   return bytes;
 }
@@ -475,7 +499,7 @@ ssize_t circbuf_write(FAR struct circbuf_s *circ,
 
   memcpy((FAR char *)circ->base + off, src, space);
   memcpy(circ->base, (FAR char *)src + space, bytes - space);
-  circ->head += bytes;
+  circbuf_store(&circ->head, circ->head + bytes);
 
   return bytes;
 }
@@ -564,20 +588,21 @@ ssize_t circbuf_overwrite(FAR struct circbuf_s *circ,
 
 FAR void *circbuf_get_writeptr(FAR struct circbuf_s *circ, FAR size_t *size)
 {
+  size_t space;
   size_t off;
-  size_t pos;
 
   DEBUGASSERT(circ);
 
-  off = circ->head % circ->size;
-  pos = circ->tail % circ->size;
-  if (off >= pos)
-    {
-      *size = circ->size - off;
-    }
-  else
+  /* The contiguous free space ends at the tail or at the end of the
+   * buffer, whichever comes first.
+   */
+
+  space = circbuf_space(circ);
+  off   = circ->head % circ->size;
+  *size = circ->size - off;
+  if (*size > space)
     {
-      *size = pos - off;
+      *size = space;
     }
 
   return (FAR char *)circ->base + off;
@@ -600,20 +625,21 @@ FAR void *circbuf_get_writeptr(FAR struct circbuf_s *circ, FAR size_t *size)
 
 FAR void *circbuf_get_readptr(FAR struct circbuf_s *circ, size_t *size)
 {
-  size_t off;
+  size_t used;
   size_t pos;
 
   DEBUGASSERT(circ);
 
-  off = circ->head % circ->size;
-  pos = circ->tail % circ->size;
-  if (pos > off)
-    {
-      *size = circ->size - pos;
-    }
-  else
+  /* The contiguous data ends at the head or at the end of the buffer,
+   * whichever comes first.
+   */
+
+  used  = circbuf_used(circ);
+  pos   = circ->tail % circ->size;
+  *size = circ->size - pos;
+  if (*size > used)
     {
-      *size = off - pos;
+      *size = used;
     }
 
   return (FAR char *)circ->base + pos;
@@ -636,7 +662,7 @@ FAR void *circbuf_get_readptr(FAR struct circbuf_s *circ, size_t *size)
 void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize)
 {
   DEBUGASSERT(circ);
-  circ->head += writtensize;
+  circbuf_store(&circ->head, circ->head + writtensize);
 }
 
 /****************************************************************************
@@ -656,5 +682,5 @@ void circbuf_writecommit(FAR struct circbuf_s *circ, size_t writtensize)
 void circbuf_readcommit(FAR struct circbuf_s *circ, size_t readsize)
 {
   DEBUGASSERT(circ);
-  circ->tail += readsize;
+  circbuf_store(&circ->tail, circ->tail + readsize);
 }
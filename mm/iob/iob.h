@@ -48,6 +48,16 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+#define IOB_ROUNDUP(x, y)        (((x) + (y) - 1) / (y) * (y))
+
+/* The offset of the own payload of an I/O buffer */
+
+#ifdef IOB_HAVE_BUFPTR
+#  define IOB_DATA_OFFSET        offsetof(struct iob_s, io_buf)
+#else
+#  define IOB_DATA_OFFSET        offsetof(struct iob_s, io_data)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -143,5 +153,32 @@ FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 void iob_notifier_signal(void);
 #endif
 
+/****************************************************************************
+ * Name: iob_pool_initialize
+ *
+ * Description:
+ *   Set up the free lists of the I/O buffer pools of other sizes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_POOLS
+void iob_pool_initialize(void);
+#endif
+
+/****************************************************************************
+ * Name: iob_pool_free
+ *
+ * Description:
+ *   Return an I/O buffer of a pool of another size to its free list.
+ *
+ * Assumptions:
+ *   iob->io_pool is not zero.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_POOLS
+void iob_pool_free(FAR struct iob_s *iob);
+#endif
+
 #endif /* CONFIG_MM_IOB */
 #endif /* __MM_IOB_IOB_H */
@@ -168,7 +168,7 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
                * we will have to wait again.
                */
 
-              sem->semcount++;
+              nxsem_count_add(sem, 1);
               iob = iob_tryalloc(throttled);
             }
 
@@ -182,11 +182,11 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
             {
               if (throttled)
                 {
-                  g_iob_sem.semcount--;
+                  nxsem_count_add(&g_iob_sem, -1);
                 }
               else
                 {
-                  g_throttle_sem.semcount--;
+                  nxsem_count_add(&g_throttle_sem, -1);
                 }
             }
 #endif
@@ -300,7 +300,7 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
            * so a simple decrement is all that is needed.
            */
 
-          g_iob_sem.semcount--;
+          nxsem_count_add(&g_iob_sem, -1);
           DEBUGASSERT(g_iob_sem.semcount >= 0);
 
 #if CONFIG_IOB_THROTTLE > 0
@@ -311,7 +311,7 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
            * But it can be smaller than that if there are blocking threads.
            */
 
-          g_throttle_sem.semcount--;
+          nxsem_count_add(&g_throttle_sem, -1);
 #endif
 
           leave_critical_section(flags);
@@ -0,0 +1,116 @@
+/****************************************************************************
+ * mm/iob/iob_extbuf.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_EXTBUF
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_extbuf_init
+ *
+ * Description:
+ *   Initialize an external buffer.  The caller holds the first reference
+ *   and drops it with iob_extbuf_put().
+ *
+ ****************************************************************************/
+
+void iob_extbuf_init(FAR struct iob_extbuf_s *ext, FAR void *data,
+                     uint16_t size, iob_extbuf_release_t release,
+                     FAR void *arg)
+{
+  DEBUGASSERT(ext != NULL && data != NULL && release != NULL);
+
+  ext->eb_data    = data;
+  ext->eb_size    = size;
+  ext->eb_refs    = 1;
+  ext->eb_release = release;
+  ext->eb_arg     = arg;
+}
+
+/****************************************************************************
+ * Name: iob_extbuf_put
+ *
+ * Description:
+ *   Drop a reference to an external buffer, releasing it if it was the
+ *   last one.
+ *
+ ****************************************************************************/
+
+void iob_extbuf_put(FAR struct iob_extbuf_s *ext)
+{
+  DEBUGASSERT(ext->eb_refs > 0);
+
+  if (__atomic_sub_fetch(&ext->eb_refs, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+      ext->eb_release(ext);
+    }
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_extbuf
+ *
+ * Description:
+ *   Allocate an I/O buffer whose data is 'len' bytes of an external
+ *   buffer, starting at 'offset', without copying.  The own payload of the
+ *   I/O buffer is unused until it is freed.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_extbuf(bool throttled,
+                                      FAR struct iob_extbuf_s *ext,
+                                      uint16_t offset, uint16_t len)
+{
+  FAR struct iob_s *iob;
+
+  DEBUGASSERT(ext != NULL && ext->eb_refs > 0 &&
+              offset + len <= ext->eb_size);
+
+  iob = iob_tryalloc(throttled);
+  if (iob == NULL)
+    {
+      return NULL;
+    }
+
+  __atomic_fetch_add(&ext->eb_refs, 1, __ATOMIC_RELAXED);
+
+  iob->io_ext     = ext;
+  iob->io_data    = ext->eb_data;
+  iob->io_bufsize = ext->eb_size;
+  iob->io_offset  = offset;
+  iob->io_len     = len;
+  iob->io_pktlen  = len;
+  return iob;
+}
+
+#endif /* CONFIG_IOB_EXTBUF */
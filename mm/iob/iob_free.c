@@ -112,6 +112,28 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
               next, next->io_pktlen, next->io_len);
     }
 
+#ifdef CONFIG_IOB_EXTBUF
+  /* Give the external buffer back and return to the own payload */
+
+  if (iob->io_ext != NULL)
+    {
+      iob_extbuf_put(iob->io_ext);
+      iob->io_ext     = NULL;
+      iob->io_data    = iob->io_buf;
+      iob->io_bufsize = CONFIG_IOB_BUFSIZE;
+    }
+#endif
+
+#ifdef CONFIG_IOB_POOLS
+  /* The buffers of the other pools have their own free lists */
+
+  if (iob->io_pool != 0)
+    {
+      iob_pool_free(iob);
+      return next;
+    }
+#endif
+
   /* Free the I/O buffer by adding it to the head of the free or the
    * committed list. We don't know what context we are called from so
    * we use extreme measures to protect the free list:  We disable
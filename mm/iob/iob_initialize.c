@@ -34,11 +34,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define ROUNDUP(x, y)     (((x) + (y) - 1) / (y) * (y))
-
 /* Fix the I/O Buffer size with specified alignment size */
 
-#define IOB_ALIGN_SIZE    ROUNDUP(sizeof(struct iob_s), CONFIG_IOB_ALIGNMENT)
+#define IOB_ALIGN_SIZE    IOB_ROUNDUP(sizeof(struct iob_s), \
+                                      CONFIG_IOB_ALIGNMENT)
 #define IOB_BUFFER_SIZE   (IOB_ALIGN_SIZE * CONFIG_IOB_NBUFFERS + \
                            CONFIG_IOB_ALIGNMENT - 1)
 
@@ -119,12 +118,12 @@ void iob_initialize(void)
   int i;
   uintptr_t buf;
 
-  /* Get a start address which plus offsetof(struct iob_s, io_data) is
-   * aligned to the CONFIG_IOB_ALIGNMENT memory boundary
+  /* Get a start address which plus IOB_DATA_OFFSET is aligned to the
+   * CONFIG_IOB_ALIGNMENT memory boundary
    */
 
-  buf = ROUNDUP((uintptr_t)g_iob_buffer + offsetof(struct iob_s, io_data),
-                CONFIG_IOB_ALIGNMENT) - offsetof(struct iob_s, io_data);
+  buf = IOB_ROUNDUP((uintptr_t)g_iob_buffer + IOB_DATA_OFFSET,
+                    CONFIG_IOB_ALIGNMENT) - IOB_DATA_OFFSET;
 
   /* Get I/O buffer instance from the start address and add each I/O buffer
    * to the free list
@@ -134,6 +133,11 @@ void iob_initialize(void)
     {
       FAR struct iob_s *iob = (FAR struct iob_s *)(buf + i * IOB_ALIGN_SIZE);
 
+#ifdef IOB_HAVE_BUFPTR
+      iob->io_data    = iob->io_buf;
+      iob->io_bufsize = CONFIG_IOB_BUFSIZE;
+#endif
+
       /* Add the pre-allocate I/O buffer to the head of the free list */
 
       iob->io_flink  = g_iob_freelist;
@@ -155,4 +159,8 @@ void iob_initialize(void)
       g_iob_freeqlist = iobq;
     }
 #endif
+
+#ifdef CONFIG_IOB_POOLS
+  iob_pool_initialize();
+#endif
 }
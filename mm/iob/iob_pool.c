@@ -0,0 +1,269 @@
+/****************************************************************************
+ * mm/iob/iob_pool.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_POOLS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The buffer of a pool I/O buffer directly follows its header */
+
+#define IOB_POOL_ALIGN_SIZE(s) \
+  IOB_ROUNDUP(IOB_DATA_OFFSET + (s), CONFIG_IOB_ALIGNMENT)
+#define IOB_POOL_BUFFER_SIZE(s, n) \
+  (IOB_POOL_ALIGN_SIZE(s) * (n) + CONFIG_IOB_ALIGNMENT - 1)
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0 && CONFIG_IOB_LARGE_NBUFFERS > 0
+#  define IOB_NPOOLS 2
+#elif CONFIG_IOB_SMALL_NBUFFERS > 0 || CONFIG_IOB_LARGE_NBUFFERS > 0
+#  define IOB_NPOOLS 1
+#else
+#  define IOB_NPOOLS 0
+#endif
+
+#ifdef IOB_SECTION
+#  define IOB_POOL_LOCATE locate_data(IOB_SECTION)
+#else
+#  define IOB_POOL_LOCATE
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct iob_pool_s
+{
+  FAR struct iob_s *freelist;   /* Free I/O buffers of the pool */
+  FAR uint8_t *buffer;          /* Memory of the pool */
+  uint16_t bufsize;             /* Payload size of each I/O buffer */
+  uint16_t nbuffers;            /* Number of I/O buffers */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+static uint8_t g_iob_small_buffer[IOB_POOL_BUFFER_SIZE(
+  CONFIG_IOB_SMALL_BUFSIZE, CONFIG_IOB_SMALL_NBUFFERS)] IOB_POOL_LOCATE;
+#endif
+
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+static uint8_t g_iob_large_buffer[IOB_POOL_BUFFER_SIZE(
+  CONFIG_IOB_LARGE_BUFSIZE, CONFIG_IOB_LARGE_NBUFFERS)] IOB_POOL_LOCATE;
+#endif
+
+#if IOB_NPOOLS > 0
+static struct iob_pool_s g_iob_pools[IOB_NPOOLS] =
+{
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  {
+    NULL, g_iob_small_buffer,
+    CONFIG_IOB_SMALL_BUFSIZE, CONFIG_IOB_SMALL_NBUFFERS
+  },
+#endif
+#if CONFIG_IOB_LARGE_NBUFFERS > 0
+  {
+    NULL, g_iob_large_buffer,
+    CONFIG_IOB_LARGE_BUFSIZE, CONFIG_IOB_LARGE_NBUFFERS
+  },
+#endif
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_pool_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the pool that fits 'size' best.  NULL is
+ *   returned if the default pool fits best or the chosen pool is empty.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_pool_alloc(unsigned int size)
+{
+#if IOB_NPOOLS > 0
+  FAR struct iob_pool_s *best = NULL;
+  unsigned int bestsize = CONFIG_IOB_BUFSIZE;
+  bool bestfits = size <= CONFIG_IOB_BUFSIZE;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  bool fits;
+  int i;
+
+  /* The default pool is the first candidate */
+
+  for (i = 0; i < IOB_NPOOLS; i++)
+    {
+      fits = size <= g_iob_pools[i].bufsize;
+      if (fits ? (!bestfits || g_iob_pools[i].bufsize < bestsize) :
+                 (!bestfits && g_iob_pools[i].bufsize > bestsize))
+        {
+          best     = &g_iob_pools[i];
+          bestsize = best->bufsize;
+          bestfits = fits;
+        }
+    }
+
+  if (best == NULL)
+    {
+      return NULL;
+    }
+
+  flags = enter_critical_section();
+
+  iob = best->freelist;
+  if (iob != NULL)
+    {
+      best->freelist = iob->io_flink;
+
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL;
+      iob->io_len    = 0;
+      iob->io_offset = 0;
+      iob->io_pktlen = 0;
+    }
+
+  leave_critical_section(flags);
+  return iob;
+#else
+  return NULL;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_pool_initialize
+ *
+ * Description:
+ *   Set up the free lists of the I/O buffer pools of other sizes.
+ *
+ ****************************************************************************/
+
+void iob_pool_initialize(void)
+{
+#if IOB_NPOOLS > 0
+  FAR struct iob_pool_s *pool;
+  FAR struct iob_s *iob;
+  uintptr_t buf;
+  int i;
+  int j;
+
+  for (i = 0; i < IOB_NPOOLS; i++)
+    {
+      pool = &g_iob_pools[i];
+
+      /* Align the payload of the first I/O buffer like iob_initialize() */
+
+      buf = IOB_ROUNDUP((uintptr_t)pool->buffer + IOB_DATA_OFFSET,
+                        CONFIG_IOB_ALIGNMENT) - IOB_DATA_OFFSET;
+
+      for (j = 0; j < pool->nbuffers; j++)
+        {
+          iob = (FAR struct iob_s *)
+                (buf + j * IOB_POOL_ALIGN_SIZE(pool->bufsize));
+
+          iob->io_data    = iob->io_buf;
+          iob->io_bufsize = pool->bufsize;
+          iob->io_pool    = i + 1;
+          iob->io_flink   = pool->freelist;
+          pool->freelist  = iob;
+        }
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_pool_free
+ *
+ * Description:
+ *   Return an I/O buffer of a pool of another size to its free list.
+ *
+ ****************************************************************************/
+
+void iob_pool_free(FAR struct iob_s *iob)
+{
+#if IOB_NPOOLS > 0
+  FAR struct iob_pool_s *pool = &g_iob_pools[iob->io_pool - 1];
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  iob->io_flink  = pool->freelist;
+  pool->freelist = iob;
+  leave_critical_section(flags);
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_alloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer of the pool that fits 'size' best, waiting for
+ *   one of the default pool if needed.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_size(unsigned int size, bool throttled)
+{
+  FAR struct iob_s *iob = iob_pool_alloc(size);
+
+  return iob != NULL ? iob : iob_alloc(throttled);
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Allocate an I/O buffer of the pool that fits 'size' best without
+ *   waiting.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(unsigned int size, bool throttled)
+{
+  FAR struct iob_s *iob = iob_pool_alloc(size);
+
+  return iob != NULL ? iob : iob_tryalloc(throttled);
+}
+
+#endif /* CONFIG_IOB_POOLS */
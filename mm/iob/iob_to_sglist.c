@@ -0,0 +1,75 @@
+/****************************************************************************
+ * mm/iob/iob_to_sglist.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_to_sglist
+ *
+ * Description:
+ *   Describe the data of an I/O buffer chain, starting 'offset' bytes into
+ *   the packet, as a scatter-gather list.  Empty entries are skipped.
+ *
+ * Returned Value:
+ *   The number of entries used, or -E2BIG if the chain needs more than
+ *   'iovcnt' entries.
+ *
+ ****************************************************************************/
+
+int iob_to_sglist(FAR struct iob_s *iob, unsigned int offset,
+                  FAR struct iovec *iov, int iovcnt)
+{
+  int i = 0;
+
+  for (; iob != NULL; iob = iob->io_flink)
+    {
+      if (offset >= iob->io_len)
+        {
+          offset -= iob->io_len;
+          continue;
+        }
+
+      if (i >= iovcnt)
+        {
+          return -E2BIG;
+        }
+
+      iov[i].iov_base = IOB_DATA(iob) + offset;
+      iov[i].iov_len  = iob->io_len - offset;
+      offset          = 0;
+      i++;
+    }
+
+  return i;
+}
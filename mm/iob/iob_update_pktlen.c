@@ -23,6 +23,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <sys/param.h>
+
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -49,33 +52,44 @@ int iob_update_pktlen(FAR struct iob_s *iob, unsigned int pktlen,
 {
   FAR struct iob_s *penultimate;
   FAR struct iob_s *next;
-  uint16_t offset = 0;
+  unsigned int remain = pktlen;
   int ninqueue = 0;
-  int nrequire;
+  int nrequire = 0;
   uint16_t len;
 
-  /* The data offset must be less than CONFIG_IOB_BUFSIZE */
+  /* The data offset must be less than the buffer size */
 
   if (iob == NULL)
     {
       return -EINVAL;
     }
 
-  /* Calculate the total entries of the data in the I/O buffer chain */
+  /* Calculate the total entries of the data in the I/O buffer chain and
+   * how many of them the new length needs.  The buffers may differ in
+   * size, so the room of each entry is checked.
+   */
 
   next = iob;
   while (next != NULL)
     {
       ninqueue++;
-      offset += next->io_offset;
+      if (remain > 0)
+        {
+          len     = IOB_BUFSIZE(next) - next->io_offset;
+          remain -= MIN(len, remain);
+          nrequire++;
+        }
+
       penultimate = next;
       next = next->io_flink;
     }
 
+  /* Appended I/O buffers come from the pool and have no offset */
+
+  nrequire += (remain + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE;
+
   /* Trim inqueue entries if needed */
 
-  nrequire = (pktlen + offset + CONFIG_IOB_BUFSIZE - 1) /
-             CONFIG_IOB_BUFSIZE;
   if (nrequire == 0)
     {
       nrequire = 1;
@@ -130,9 +144,9 @@ int iob_update_pktlen(FAR struct iob_s *iob, unsigned int pktlen,
   next = iob;
   while (next != NULL && pktlen > 0)
     {
-      if (pktlen + next->io_offset > CONFIG_IOB_BUFSIZE)
+      if (pktlen + next->io_offset > IOB_BUFSIZE(next))
         {
-          len = CONFIG_IOB_BUFSIZE - next->io_offset;
+          len = IOB_BUFSIZE(next) - next->io_offset;
         }
       else
         {
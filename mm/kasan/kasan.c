@@ -35,18 +35,37 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define KASAN_BYTES_PER_WORD (sizeof(uintptr_t))
-#define KASAN_BITS_PER_WORD  (KASAN_BYTES_PER_WORD * 8)
+#ifdef CONFIG_MM_KASAN_SHADOW_BYTE
 
-#define KASAN_FIRST_WORD_MASK(start) \
+/* One shadow byte describes a granule of 8 bytes: zero if the whole
+ * granule is accessible, 1..7 if only that many leading bytes are, and
+ * KASAN_POISON_TAG if none is.
+ */
+
+#  define KASAN_GRANULE_SHIFT       3
+#  define KASAN_GRANULE_SIZE        (1 << KASAN_GRANULE_SHIFT)
+#  define KASAN_GRANULE_MASK        (KASAN_GRANULE_SIZE - 1)
+#  define KASAN_POISON_TAG          0xff
+
+#  define KASAN_ALIGN_UP(a, b)      (((a) + (b) - 1) & ~((b) - 1))
+
+#  define KASAN_SHADOW_SIZE(size) \
+  KASAN_ALIGN_UP((size) >> KASAN_GRANULE_SHIFT, sizeof(uintptr_t))
+#else
+#  define KASAN_BYTES_PER_WORD (sizeof(uintptr_t))
+#  define KASAN_BITS_PER_WORD  (KASAN_BYTES_PER_WORD * 8)
+
+#  define KASAN_FIRST_WORD_MASK(start) \
   (UINTPTR_MAX << ((start) & (KASAN_BITS_PER_WORD - 1)))
-#define KASAN_LAST_WORD_MASK(end) \
+#  define KASAN_LAST_WORD_MASK(end) \
   (UINTPTR_MAX >> (-(end) & (KASAN_BITS_PER_WORD - 1)))
 
-#define KASAN_SHADOW_SCALE (sizeof(uintptr_t))
+#  define KASAN_SHADOW_SCALE (sizeof(uintptr_t))
 
-#define KASAN_SHADOW_SIZE(size) \
+#  define KASAN_SHADOW_SIZE(size) \
   (KASAN_BYTES_PER_WORD * ((size) / KASAN_SHADOW_SCALE / KASAN_BITS_PER_WORD))
+#endif
+
 #define KASAN_REGION_SIZE(size) \
   (sizeof(struct kasan_region_s) + KASAN_SHADOW_SIZE(size))
 
@@ -61,6 +80,7 @@ struct kasan_region_s
   FAR struct kasan_region_s *next;
   uintptr_t                  begin;
   uintptr_t                  end;
+  bool                       disabled;
   uintptr_t                  shadow[1];
 };
 
@@ -72,36 +92,81 @@ static spinlock_t g_lock;
 static FAR struct kasan_region_s *g_region;
 static uint32_t g_region_init;
 
+/* The region of the last lookup.  Regions are never removed, so a stale
+ * value is harmless and the cache is accessed without the lock.
+ */
+
+static FAR struct kasan_region_s *g_region_hit;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static FAR uintptr_t *kasan_mem_to_shadow(FAR const void *ptr, size_t size,
-                                          unsigned int *bit)
+static FAR struct kasan_region_s *kasan_find_region(uintptr_t addr)
 {
   FAR struct kasan_region_s *region;
-  uintptr_t addr = (uintptr_t)ptr;
 
   if (g_region_init != KASAN_INIT_VALUE)
     {
       return NULL;
     }
 
+  region = g_region_hit;
+  if (region != NULL && addr >= region->begin && addr < region->end)
+    {
+      return region;
+    }
+
   for (region = g_region; region != NULL; region = region->next)
     {
       if (addr >= region->begin && addr < region->end)
         {
-          DEBUGASSERT(addr + size <= region->end);
-          addr -= region->begin;
-          addr /= KASAN_SHADOW_SCALE;
-          *bit  = addr % KASAN_BITS_PER_WORD;
-          return &region->shadow[addr / KASAN_BITS_PER_WORD];
+          g_region_hit = region;
+          return region;
         }
     }
 
   return NULL;
 }
 
+#ifdef CONFIG_MM_KASAN_SHADOW_BYTE
+static FAR uint8_t *kasan_mem_to_shadow(FAR const void *ptr, size_t size,
+                                        bool checking)
+{
+  FAR struct kasan_region_s *region;
+  uintptr_t addr = (uintptr_t)ptr;
+
+  region = kasan_find_region(addr);
+  if (region == NULL || (checking && region->disabled))
+    {
+      return NULL;
+    }
+
+  DEBUGASSERT(addr + size <= region->end);
+  addr -= region->begin;
+  return (FAR uint8_t *)region->shadow + (addr >> KASAN_GRANULE_SHIFT);
+}
+#else
+static FAR uintptr_t *kasan_mem_to_shadow(FAR const void *ptr, size_t size,
+                                          bool checking, unsigned int *bit)
+{
+  FAR struct kasan_region_s *region;
+  uintptr_t addr = (uintptr_t)ptr;
+
+  region = kasan_find_region(addr);
+  if (region == NULL || (checking && region->disabled))
+    {
+      return NULL;
+    }
+
+  DEBUGASSERT(addr + size <= region->end);
+  addr -= region->begin;
+  addr /= KASAN_SHADOW_SCALE;
+  *bit  = addr % KASAN_BITS_PER_WORD;
+  return &region->shadow[addr / KASAN_BITS_PER_WORD];
+}
+#endif
+
 static void kasan_report(FAR const void *addr, size_t size, bool is_write)
 {
   static int recursion;
@@ -117,12 +182,140 @@ static void kasan_report(FAR const void *addr, size_t size, bool is_write)
   --recursion;
 }
 
+#ifdef CONFIG_MM_KASAN_SHADOW_BYTE
+static inline void kasan_set_head(FAR uint8_t *p, unsigned int n)
+{
+  /* Make at least the first n bytes of a granule accessible */
+
+  if (*p != 0 && (*p >= KASAN_GRANULE_SIZE || *p < n))
+    {
+      *p = n;
+    }
+}
+
+static inline bool kasan_tag_poisoned(uint8_t tag, uintptr_t last)
+{
+  /* Whether the byte at 'last' is inaccessible in a granule of that tag */
+
+  return tag != 0 && (tag >= KASAN_GRANULE_SIZE ||
+                      (last & KASAN_GRANULE_MASK) >= tag);
+}
+
+static bool kasan_is_poisoned(FAR const void *addr, size_t size)
+{
+  uintptr_t first = (uintptr_t)addr;
+  uintptr_t last = first + size - 1;
+  size_t ngranules;
+  FAR uint8_t *p;
+
+  p = kasan_mem_to_shadow(addr, size, true);
+  if (p == NULL)
+    {
+      return false;
+    }
+
+  /* Fast path: the whole access falls into one granule, as any aligned
+   * access of up to eight bytes does.
+   */
+
+  if (((first ^ last) & ~KASAN_GRANULE_MASK) == 0)
+    {
+      return kasan_tag_poisoned(*p, last);
+    }
+
+  /* All the granules but the last must be fully accessible */
+
+  ngranules = (last >> KASAN_GRANULE_SHIFT) - (first >> KASAN_GRANULE_SHIFT);
+  while (ngranules-- > 0)
+    {
+      if (*p++ != 0)
+        {
+          return true;
+        }
+    }
+
+  return kasan_tag_poisoned(*p, last);
+}
+
+static void kasan_set_poison(FAR const void *addr, size_t size,
+                             bool poisoned)
+{
+  uintptr_t begin = (uintptr_t)addr;
+  uintptr_t end = begin + size;
+  unsigned int offset;
+  size_t ngranules;
+  irqstate_t flags;
+  FAR uint8_t *p;
+
+  if (size == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_lock);
+
+  p = kasan_mem_to_shadow(addr, size, false);
+  DEBUGASSERT(p != NULL);
+
+  /* The encoding cannot describe a hole inside a granule.  A partially
+   * covered granule is resolved towards accessible, so that it may hide
+   * a bug but never reports a false one.
+   */
+
+  offset = begin & KASAN_GRANULE_MASK;
+  if (offset != 0)
+    {
+      if ((end >> KASAN_GRANULE_SHIFT) == (begin >> KASAN_GRANULE_SHIFT))
+        {
+          if (!poisoned)
+            {
+              kasan_set_head(p, end & KASAN_GRANULE_MASK);
+            }
+
+          goto out;
+        }
+
+      if (poisoned)
+        {
+          if (*p == 0 || (*p > offset && *p < KASAN_GRANULE_SIZE))
+            {
+              *p = offset;
+            }
+        }
+      else
+        {
+          *p = 0;
+        }
+
+      p++;
+      begin = KASAN_ALIGN_UP(begin, KASAN_GRANULE_SIZE);
+    }
+
+  /* No memset() here, the shadow itself lies in a poisoned range that
+   * an instrumented memset() would check.
+   */
+
+  for (ngranules = (end - begin) >> KASAN_GRANULE_SHIFT; ngranules > 0;
+       ngranules--)
+    {
+      *p++ = poisoned ? KASAN_POISON_TAG : 0;
+    }
+
+  if (!poisoned && (end & KASAN_GRANULE_MASK) != 0)
+    {
+      kasan_set_head(p, end & KASAN_GRANULE_MASK);
+    }
+
+out:
+  spin_unlock_irqrestore(&g_lock, flags);
+}
+#else
 static bool kasan_is_poisoned(FAR const void *addr, size_t size)
 {
   FAR uintptr_t *p;
   unsigned int bit;
 
-  p = kasan_mem_to_shadow(addr + size - 1, 1, &bit);
+  p = kasan_mem_to_shadow(addr + size - 1, 1, true, &bit);
   return p && ((*p >> bit) & 1);
 }
 
@@ -137,7 +330,7 @@ static void kasan_set_poison(FAR const void *addr, size_t size,
 
   flags = spin_lock_irqsave(&g_lock);
 
-  p = kasan_mem_to_shadow(addr, size, &bit);
+  p = kasan_mem_to_shadow(addr, size, false, &bit);
   DEBUGASSERT(p != NULL);
 
   nbit = KASAN_BITS_PER_WORD - bit % KASAN_BITS_PER_WORD;
@@ -177,6 +370,7 @@ static void kasan_set_poison(FAR const void *addr, size_t size,
 
   spin_unlock_irqrestore(&g_lock, flags);
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -202,8 +396,9 @@ void kasan_register(FAR void *addr, FAR size_t *size)
   region = (FAR struct kasan_region_s *)
     ((FAR char *)addr + *size - KASAN_REGION_SIZE(*size));
 
-  region->begin = (uintptr_t)addr;
-  region->end   = region->begin + *size;
+  region->begin    = (uintptr_t)addr;
+  region->end      = region->begin + *size;
+  region->disabled = false;
 
   flags = spin_lock_irqsave(&g_lock);
   region->next  = g_region;
@@ -215,6 +410,17 @@ void kasan_register(FAR void *addr, FAR size_t *size)
   *size -= KASAN_REGION_SIZE(*size);
 }
 
+void kasan_enable_region(FAR const void *addr, bool enable)
+{
+  FAR struct kasan_region_s *region;
+
+  region = kasan_find_region((uintptr_t)addr);
+  if (region != NULL)
+    {
+      region->disabled = !enable;
+    }
+}
+
 /* Exported functions called from the compiler generated code */
 
 void __sanitizer_annotate_contiguous_container(FAR const void *beg,
@@ -25,6 +25,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
 #include <stddef.h>
 
 /****************************************************************************
@@ -35,6 +36,7 @@
 #  define kasan_poison(addr, size)
 #  define kasan_unpoison(addr, size)
 #  define kasan_register(addr, size)
+#  define kasan_enable_region(addr, enable)
 #endif
 
 /****************************************************************************
@@ -105,6 +107,25 @@ void kasan_unpoison(FAR const void *addr, size_t size);
 
 void kasan_register(FAR void *addr, FAR size_t *size);
 
+/****************************************************************************
+ * Name: kasan_enable_region
+ *
+ * Description:
+ *   Turn the access check of a registered range on or off.  The shadow is
+ *   still maintained while the check is off, so it is accurate again as
+ *   soon as the check is turned back on.
+ *
+ * Input Parameters:
+ *   addr   - any address inside the range passed to kasan_register()
+ *   enable - true to check the accesses to the range
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void kasan_enable_region(FAR const void *addr, bool enable);
+
 #endif /* CONFIG_MM_KASAN */
 
 #undef EXTERN
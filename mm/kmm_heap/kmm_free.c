@@ -53,7 +53,11 @@
 void kmm_free(FAR void *mem)
 {
   DEBUGASSERT((mem == NULL) || kmm_heapmember(mem));
+#ifdef CONFIG_MM_KERNEL_HEAP_ATTR
+  mm_free(kmm_heapof(mem), mem);
+#else
   mm_free(g_kmmheap, mem);
+#endif
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
@@ -52,7 +52,11 @@
 
 bool kmm_heapmember(FAR void *mem)
 {
+#ifdef CONFIG_MM_KERNEL_HEAP_ATTR
+  return mm_heapmember(kmm_heapof(mem), mem);
+#else
   return mm_heapmember(g_kmmheap, mem);
+#endif
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
@@ -0,0 +1,233 @@
+/****************************************************************************
+ * mm/kmm_heap/kmm_malloc_attr.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/cache.h>
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_KERNEL_HEAP_ATTR
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define KMM_ATTR_PLACEMENT (MM_FAST | MM_DMA)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct kmm_attrheap_s
+{
+  FAR struct mm_heap_s *heap;
+  unsigned int attr;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct kmm_attrheap_s g_kmm_attrheap[CONFIG_MM_KERNEL_HEAP_NATTR];
+static int g_kmm_nattrheap;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmm_attr_alloc
+ ****************************************************************************/
+
+static FAR void *kmm_attr_alloc(FAR struct mm_heap_s *heap, size_t size,
+                                unsigned int attr)
+{
+  size_t align;
+
+  if ((attr & MM_CACHEALIGN) != 0)
+    {
+      /* Round the size up too so that the tail of the block does not
+       * share a line with the next one.
+       */
+
+      align = up_get_dcache_linesize();
+      if (align > 0)
+        {
+          size = (size + align - 1) & ~(align - 1);
+          return mm_memalign(heap, align, size);
+        }
+    }
+
+  return mm_malloc(heap, size);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kmm_addheap_attr
+ *
+ * Description:
+ *   Register a heap, normally created by the platform over a memory region
+ *   with special properties, as the provider of 'attr' for
+ *   kmm_malloc_attr().  Heaps are tried in the order of registration.
+ *
+ * Input Parameters:
+ *   heap - The heap returned by mm_initialize()
+ *   attr - The MM_FAST and MM_DMA properties of the memory of the heap
+ *
+ * Returned Value:
+ *   Zero on success; -ENOSPC if CONFIG_MM_KERNEL_HEAP_NATTR heaps are
+ *   already registered.
+ *
+ * Assumptions:
+ *   Called during the initialization, before the first kmm_malloc_attr().
+ *
+ ****************************************************************************/
+
+int kmm_addheap_attr(FAR struct mm_heap_s *heap, unsigned int attr)
+{
+  int n = g_kmm_nattrheap;
+
+  DEBUGASSERT(heap != NULL && heap != g_kmmheap);
+
+  if (n >= CONFIG_MM_KERNEL_HEAP_NATTR)
+    {
+      return -ENOSPC;
+    }
+
+  g_kmm_attrheap[n].heap = heap;
+  g_kmm_attrheap[n].attr = attr & KMM_ATTR_PLACEMENT;
+  __atomic_store_n(&g_kmm_nattrheap, n + 1, __ATOMIC_RELEASE);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kmm_heapof
+ *
+ * Description:
+ *   Return the heap that owns a kernel allocation: the registered heap
+ *   that contains it, or the kernel heap.
+ *
+ ****************************************************************************/
+
+FAR struct mm_heap_s *kmm_heapof(FAR void *mem)
+{
+  int n = __atomic_load_n(&g_kmm_nattrheap, __ATOMIC_ACQUIRE);
+  int i;
+
+  if (mem != NULL)
+    {
+      for (i = 0; i < n; i++)
+        {
+          if (mm_heapmember(g_kmm_attrheap[i].heap, mem))
+            {
+              return g_kmm_attrheap[i].heap;
+            }
+        }
+    }
+
+  return g_kmmheap;
+}
+
+/****************************************************************************
+ * Name: kmm_malloc_attr
+ *
+ * Description:
+ *   Allocate kernel memory with placement hints.  The first registered
+ *   heap that has all the requested MM_FAST and MM_DMA properties serves
+ *   the request.  If there is none, the kernel heap is assumed to have
+ *   them.  MM_FAST alone is only a preference and falls back to the kernel
+ *   heap when the fast heaps are exhausted; MM_DMA is a requirement.
+ *
+ * Input Parameters:
+ *   size - Size (in bytes) of the memory region to be allocated.
+ *   attr - A combination of MM_FAST, MM_DMA and MM_CACHEALIGN
+ *
+ * Returned Value:
+ *   The address of the allocated memory (NULL on failure to allocate).
+ *   The memory is released with kmm_free().
+ *
+ ****************************************************************************/
+
+FAR void *kmm_malloc_attr(size_t size, unsigned int attr)
+{
+  int n = __atomic_load_n(&g_kmm_nattrheap, __ATOMIC_ACQUIRE);
+  unsigned int want = attr & KMM_ATTR_PLACEMENT;
+  bool found = false;
+  FAR void *ret;
+  int i;
+
+  if (want != 0)
+    {
+      for (i = 0; i < n; i++)
+        {
+          if ((g_kmm_attrheap[i].attr & want) != want)
+            {
+              continue;
+            }
+
+          found = true;
+          ret = kmm_attr_alloc(g_kmm_attrheap[i].heap, size, attr);
+          if (ret != NULL)
+            {
+              return ret;
+            }
+        }
+    }
+
+  if (found && (want & MM_DMA) != 0)
+    {
+      return NULL;
+    }
+
+  return kmm_attr_alloc(g_kmmheap, size, attr);
+}
+
+/****************************************************************************
+ * Name: kmm_zalloc_attr
+ *
+ * Description:
+ *   kmm_malloc_attr() followed by clearing the memory.
+ *
+ ****************************************************************************/
+
+FAR void *kmm_zalloc_attr(size_t size, unsigned int attr)
+{
+  FAR void *ret = kmm_malloc_attr(size, attr);
+
+  if (ret != NULL)
+    {
+      memset(ret, 0, size);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_MM_KERNEL_HEAP_ATTR */
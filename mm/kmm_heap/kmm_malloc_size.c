@@ -34,7 +34,11 @@
 
 size_t kmm_malloc_size(FAR void *mem)
 {
+#ifdef CONFIG_MM_KERNEL_HEAP_ATTR
+  return mm_malloc_size(kmm_heapof(mem), mem);
+#else
   return mm_malloc_size(g_kmmheap, mem);
+#endif
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
@@ -49,7 +49,11 @@
 
 FAR void *kmm_realloc(FAR void *oldmem, size_t newsize)
 {
+#ifdef CONFIG_MM_KERNEL_HEAP_ATTR
+  return mm_realloc(kmm_heapof(oldmem), oldmem, newsize);
+#else
   return mm_realloc(g_kmmheap, oldmem, newsize);
+#endif
 }
 
 #endif /* CONFIG_MM_KERNEL_HEAP */
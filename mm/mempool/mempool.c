@@ -42,6 +42,14 @@
 #undef  ALIGN_UP
 #define ALIGN_UP(x, a) (((x) + ((a) - 1)) & (~((a) - 1)))
 
+/* The layout of struct mempool_lfstack_s::top */
+
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+#  define MEMPOOL_LF_SHIFT  (sizeof(uintptr_t) * 4)
+#  define MEMPOOL_LF_MASK   (((uintptr_t)1 << MEMPOOL_LF_SHIFT) - 1)
+#  define MEMPOOL_LF_TAG    ((uintptr_t)1 << MEMPOOL_LF_SHIFT)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -83,6 +91,191 @@ static inline void mempool_add_queue(FAR sq_queue_t *queue,
     }
 }
 
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+
+/****************************************************************************
+ * Name: mempool_lfblock
+ *
+ * Description:
+ *   Convert a block index to the block address.  The interrupt blocks come
+ *   first, followed by the normal blocks.
+ *
+ ****************************************************************************/
+
+static inline FAR sq_entry_t *mempool_lfblock(FAR struct mempool_s *pool,
+                                              size_t index)
+{
+  size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+
+  if (index < pool->lfnint)
+    {
+      return (FAR sq_entry_t *)(pool->ibase + index * blocksize);
+    }
+
+  return (FAR sq_entry_t *)(pool->lfbase +
+                            (index - pool->lfnint) * blocksize);
+}
+
+/****************************************************************************
+ * Name: mempool_lfindex
+ *
+ * Description:
+ *   Convert a block address to the block index.
+ *
+ ****************************************************************************/
+
+static inline size_t mempool_lfindex(FAR struct mempool_s *pool,
+                                     FAR void *blk)
+{
+  size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+
+  if (pool->lfnint > 0 && (FAR char *)blk >= pool->ibase &&
+      (FAR char *)blk < pool->ibase + pool->lfnint * blocksize)
+    {
+      return ((FAR char *)blk - pool->ibase) / blocksize;
+    }
+
+  return pool->lfnint + ((FAR char *)blk - pool->lfbase) / blocksize;
+}
+
+/****************************************************************************
+ * Name: mempool_lfpush
+ ****************************************************************************/
+
+static inline void mempool_lfpush(FAR struct mempool_s *pool,
+                                  FAR struct mempool_lfstack_s *stack,
+                                  FAR void *blk)
+{
+  uintptr_t index = mempool_lfindex(pool, blk) + 1;
+  uintptr_t top = __atomic_load_n(&stack->top, __ATOMIC_RELAXED);
+
+  /* Pushes leave the tag alone, only pops have to invalidate the top
+   * seen by a concurrent pop.
+   */
+
+  do
+    {
+      *(FAR uintptr_t *)blk = top & MEMPOOL_LF_MASK;
+    }
+  while (!__atomic_compare_exchange_n(&stack->top, &top,
+                                      (top & ~MEMPOOL_LF_MASK) | index,
+                                      true, __ATOMIC_RELEASE,
+                                      __ATOMIC_RELAXED));
+
+  __atomic_fetch_add(&stack->count, 1, __ATOMIC_RELAXED);
+}
+
+/****************************************************************************
+ * Name: mempool_lfpop
+ ****************************************************************************/
+
+static inline FAR sq_entry_t *
+mempool_lfpop(FAR struct mempool_s *pool,
+              FAR struct mempool_lfstack_s *stack)
+{
+  uintptr_t top = __atomic_load_n(&stack->top, __ATOMIC_ACQUIRE);
+  FAR sq_entry_t *blk;
+  uintptr_t next;
+
+  /* The link of the block may be overwritten by its new owner as soon as
+   * another context pops it first.  The value read is then garbage, but
+   * the tag of 'top' has changed and the exchange fails.  The blocks are
+   * never returned to the heap while the pool exists, so the read itself
+   * is always safe.
+   */
+
+  do
+    {
+      if ((top & MEMPOOL_LF_MASK) == 0)
+        {
+          return NULL;
+        }
+
+      blk  = mempool_lfblock(pool, (top & MEMPOOL_LF_MASK) - 1);
+      next = __atomic_load_n((FAR uintptr_t *)blk, __ATOMIC_RELAXED);
+    }
+  while (!__atomic_compare_exchange_n(&stack->top, &top,
+                                      ((top & ~MEMPOOL_LF_MASK) +
+                                       MEMPOOL_LF_TAG) | next,
+                                      true, __ATOMIC_ACQUIRE,
+                                      __ATOMIC_ACQUIRE));
+
+  __atomic_fetch_sub(&stack->count, 1, __ATOMIC_RELAXED);
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_lfalloc
+ ****************************************************************************/
+
+static FAR void *mempool_lfalloc(FAR struct mempool_s *pool)
+{
+  FAR sq_entry_t *blk;
+
+  for (; ; )
+    {
+      blk = mempool_lfpop(pool, &pool->lfqueue);
+      if (blk == NULL && up_interrupt_context())
+        {
+          blk = mempool_lfpop(pool, &pool->lfiqueue);
+        }
+
+      if (blk != NULL)
+        {
+          __atomic_fetch_add(&pool->nalloc, 1, __ATOMIC_RELAXED);
+          return blk;
+        }
+
+      if (up_interrupt_context() || !pool->wait ||
+          nxsem_wait_uninterruptible(&pool->waitsem) < 0)
+        {
+          return NULL;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_lfinit
+ *
+ * Description:
+ *   Switch a pool that never expands to the lock-free stacks.  Pools with
+ *   more blocks than the index part of a stack top can hold stay locked.
+ *
+ ****************************************************************************/
+
+static void mempool_lfinit(FAR struct mempool_s *pool, FAR char *base,
+                           size_t ninterrupt, size_t ninitial)
+{
+  FAR sq_entry_t *blk;
+
+  pool->lockfree = false;
+  if (pool->expandsize != 0 || ninterrupt + ninitial >= MEMPOOL_LF_MASK)
+    {
+      return;
+    }
+
+  pool->lfbase = base;
+  pool->lfnint = ninterrupt;
+  pool->lfqueue.top = 0;
+  pool->lfqueue.count = 0;
+  pool->lfiqueue.top = 0;
+  pool->lfiqueue.count = 0;
+
+  while ((blk = mempool_remove_queue(&pool->queue)) != NULL)
+    {
+      mempool_lfpush(pool, &pool->lfqueue, blk);
+    }
+
+  while ((blk = mempool_remove_queue(&pool->iqueue)) != NULL)
+    {
+      mempool_lfpush(pool, &pool->lfiqueue, blk);
+    }
+
+  pool->lockfree = true;
+}
+
+#endif /* CONFIG_MM_MEMPOOL_LOCKFREE */
+
 #if CONFIG_MM_BACKTRACE >= 0
 static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
                                          FAR struct mempool_backtrace_s *buf)
@@ -133,6 +326,9 @@ static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
 int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
 {
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  size_t ninterrupt = 0;
+  size_t ninitial = 0;
+  FAR char *base = NULL;
 
   sq_init(&pool->queue);
   sq_init(&pool->iqueue);
@@ -146,8 +342,10 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
 
   if (pool->interruptsize >= blocksize)
     {
-      size_t ninterrupt = pool->interruptsize / blocksize;
-      size_t size = ninterrupt * blocksize;
+      size_t size;
+
+      ninterrupt = pool->interruptsize / blocksize;
+      size = ninterrupt * blocksize;
 
       pool->ibase = pool->alloc(pool, size);
       if (pool->ibase == NULL)
@@ -165,10 +363,10 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
 
   if (pool->initialsize >= blocksize + sizeof(sq_entry_t))
     {
-      size_t ninitial = (pool->initialsize - sizeof(sq_entry_t)) / blocksize;
-      size_t size = ninitial * blocksize + sizeof(sq_entry_t);
-      FAR char *base;
+      size_t size;
 
+      ninitial = (pool->initialsize - sizeof(sq_entry_t)) / blocksize;
+      size = ninitial * blocksize + sizeof(sq_entry_t);
       base = pool->alloc(pool, size);
       if (base == NULL)
         {
@@ -187,6 +385,14 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
     }
 
   spin_initialize(&pool->lock, 0);
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  mempool_lfinit(pool, base, ninterrupt, ninitial);
+#else
+  UNUSED(base);
+  UNUSED(ninterrupt);
+  UNUSED(ninitial);
+#endif
+
   if (pool->wait && pool->expandsize == 0)
     {
       nxsem_init(&pool->waitsem, 0, 0);
@@ -224,6 +430,13 @@ FAR void *mempool_alloc(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   irqstate_t flags;
 
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  if (pool->lockfree)
+    {
+      return mempool_lfalloc(pool);
+    }
+#endif
+
 retry:
   flags = spin_lock_irqsave(&pool->lock);
   blk = mempool_remove_queue(&pool->queue);
@@ -298,8 +511,27 @@ out_with_lock:
 
 void mempool_free(FAR struct mempool_s *pool, FAR void *blk)
 {
-  irqstate_t flags = spin_lock_irqsave(&pool->lock);
   size_t blocksize = MEMPOOL_REALBLOCKSIZE(pool);
+  irqstate_t flags;
+
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  if (pool->lockfree)
+    {
+      __atomic_fetch_sub(&pool->nalloc, 1, __ATOMIC_RELAXED);
+      if (mempool_lfindex(pool, blk) < pool->lfnint)
+        {
+          mempool_lfpush(pool, &pool->lfiqueue, blk);
+        }
+      else
+        {
+          mempool_lfpush(pool, &pool->lfqueue, blk);
+        }
+
+      goto out;
+    }
+#endif
+
+  flags = spin_lock_irqsave(&pool->lock);
 #if CONFIG_MM_BACKTRACE >= 0
   FAR struct mempool_backtrace_s *buf =
     (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
@@ -331,6 +563,10 @@ void mempool_free(FAR struct mempool_s *pool, FAR void *blk)
 
   kasan_poison(blk, pool->blocksize);
   spin_unlock_irqrestore(&pool->lock, flags);
+
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+out:
+#endif
   if (pool->wait && pool->expandsize == 0)
     {
       int semcount;
@@ -365,8 +601,21 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
   DEBUGASSERT(pool != NULL && info != NULL);
 
   flags = spin_lock_irqsave(&pool->lock);
-  info->ordblks = mempool_queue_lenth(&pool->queue);
-  info->iordblks = mempool_queue_lenth(&pool->iqueue);
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+  if (pool->lockfree)
+    {
+      info->ordblks = __atomic_load_n(&pool->lfqueue.count,
+                                      __ATOMIC_RELAXED);
+      info->iordblks = __atomic_load_n(&pool->lfiqueue.count,
+                                       __ATOMIC_RELAXED);
+    }
+  else
+#endif
+    {
+      info->ordblks = mempool_queue_lenth(&pool->queue);
+      info->iordblks = mempool_queue_lenth(&pool->iqueue);
+    }
+
 #if CONFIG_MM_BACKTRACE >= 0
   info->aordblks = list_length(&pool->alist);
 #else
@@ -409,8 +658,18 @@ mempool_info_task(FAR struct mempool_s *pool,
 
   if (task->pid == PID_MM_FREE)
     {
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+      size_t count = pool->lockfree ?
+                     __atomic_load_n(&pool->lfqueue.count,
+                                     __ATOMIC_RELAXED) +
+                     __atomic_load_n(&pool->lfiqueue.count,
+                                     __ATOMIC_RELAXED) :
+                     mempool_queue_lenth(&pool->queue) +
+                     mempool_queue_lenth(&pool->iqueue);
+#else
       size_t count = mempool_queue_lenth(&pool->queue) +
                      mempool_queue_lenth(&pool->iqueue);
+#endif
 
       info.aordblks += count;
       info.uordblks += count * blocksize;
@@ -472,6 +731,15 @@ void mempool_memdump(FAR struct mempool_s *pool,
     {
       FAR sq_entry_t *entry;
 
+#ifdef CONFIG_MM_MEMPOOL_LOCKFREE
+      /* The lock-free stacks can't be walked while the pool is in use */
+
+      if (pool->lockfree)
+        {
+          return;
+        }
+#endif
+
       sq_for_every(&pool->queue, entry)
         {
           syslog(LOG_INFO, "%12zu%*p\n",
@@ -22,13 +22,17 @@
  * Included Files
  ****************************************************************************/
 
+#include <inttypes.h>
 #include <strings.h>
 #include <syslog.h>
 #include <sys/param.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/mutex.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/mempool.h>
+#include <nuttx/spinlock.h>
 
 #include <assert.h>
 
@@ -41,6 +45,21 @@
 #undef  ALIGN_DOWN
 #define ALIGN_DOWN(x, a)      ((size_t)(x) & (~((a) - 1)))
 
+/* The per-CPU caches need up_cpu_index(), which is only available to the
+ * kernel.  The user space copy of the heap goes to the pools directly.
+ */
+
+#if defined(CONFIG_MM_HEAP_MEMPOOL_CPUCACHE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MEMPOOL_HAVE_CPUCACHE 1
+#  define MEMPOOL_CPUCACHE_DRAIN_TICKS \
+          MSEC2TICK(CONFIG_MM_HEAP_MEMPOOL_CPUCACHE_DRAIN_MS)
+#endif
+
+#ifdef CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE
+#  define MEMPOOL_PROFILE_MAXCLASSES UINT16_MAX
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -61,6 +80,41 @@ struct mpool_chunk_s
   size_t used;
 };
 
+#ifdef MEMPOOL_HAVE_CPUCACHE
+/* The free blocks of one size class cached on one CPU */
+
+struct mpool_cachelist_s
+{
+  FAR sq_entry_t *head;       /* Stack of free blocks */
+  size_t          count;      /* Number of blocks in the stack */
+};
+
+/* The cache of one CPU.  The lock is taken almost exclusively by its own
+ * CPU, so it stays uncontended and its cache line local; it only guards
+ * against mempool_multiple_drain() on another CPU and against migration
+ * of the caller.
+ */
+
+struct mpool_cpucache_s
+{
+  spinlock_t                    lock;
+  clock_t                       trimmed;     /* Tick of the last trim */
+  FAR struct mpool_cachelist_s *lists;       /* One list per pool */
+};
+#endif
+
+#ifdef CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE
+/* The requests recorded for one size class.  The class of a request is the
+ * smallest pool that fits it, whether or not that pool is enabled.
+ */
+
+struct mpool_profile_s
+{
+  uint64_t bytes;             /* Sum of the requested sizes */
+  size_t   count;             /* Number of requests */
+};
+#endif
+
 struct mempool_multiple_s
 {
   FAR struct mempool_s         *pools;       /* The memory pool array */
@@ -99,35 +153,45 @@ struct mempool_multiple_s
   size_t                        dict_col_num_log2;
   size_t                        dict_row_num;
   FAR struct mpool_dict_s     **dict;
+
+#ifdef MEMPOOL_HAVE_CPUCACHE
+  struct mpool_cpucache_s       cache[CONFIG_SMP_NCPUS];
+#endif
+
+#ifdef CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE
+  /* One histogram entry per pool plus one for the requests larger than
+   * the largest pool.  map[i] is the index of the pool serving the class
+   * of pool i: i itself if the pool is enabled, else the next larger
+   * enabled pool, or npools if there is none.
+   */
+
+  FAR struct mpool_profile_s   *profile;
+  FAR size_t                   *map;
+#endif
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline FAR struct mempool_s *
-mempool_multiple_find(FAR struct mempool_multiple_s *mpool, size_t size)
+static inline size_t
+mempool_multiple_index(FAR struct mempool_multiple_s *mpool, size_t size)
 {
   size_t right;
   size_t left = 0;
   size_t mid;
 
-  if (mpool == NULL)
-    {
-      return NULL;
-    }
-
   right = mpool->npools;
   if (mpool->delta != 0)
     {
       left = mpool->pools[0].blocksize;
       if (left >= size)
         {
-          return &mpool->pools[0];
+          return 0;
         }
 
       mid = (size - left + mpool->delta - 1) / mpool->delta;
-      return mid < right ? &mpool->pools[mid] : NULL;
+      return mid < right ? mid : right;
     }
 
   while (left < right)
@@ -143,12 +207,28 @@ mempool_multiple_find(FAR struct mempool_multiple_s *mpool, size_t size)
         }
     }
 
-  if (left == mpool->npools)
+  return left;
+}
+
+static inline FAR struct mempool_s *
+mempool_multiple_find(FAR struct mempool_multiple_s *mpool, size_t size)
+{
+  size_t index;
+
+  if (mpool == NULL)
     {
       return NULL;
     }
 
-  return &mpool->pools[left];
+  index = mempool_multiple_index(mpool, size);
+#ifdef CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE
+  if (index < mpool->npools)
+    {
+      index = mpool->map[index];
+    }
+#endif
+
+  return index < mpool->npools ? &mpool->pools[index] : NULL;
 }
 
 static FAR void *
@@ -334,6 +414,322 @@ mempool_multiple_get_dict(FAR struct mempool_multiple_s *mpool,
   return &mpool->dict[row][col];
 }
 
+#ifdef MEMPOOL_HAVE_CPUCACHE
+
+/****************************************************************************
+ * Name: mempool_multiple_release
+ *
+ * Description:
+ *   Return a chain of blocks taken from a cache list to their pool.
+ *
+ ****************************************************************************/
+
+static void mempool_multiple_release(FAR struct mempool_s *pool,
+                                     FAR sq_entry_t *blk)
+{
+  FAR sq_entry_t *next;
+
+  while (blk != NULL)
+    {
+      next = blk->flink;
+      mempool_free(pool, blk);
+      blk = next;
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_detach
+ *
+ * Description:
+ *   Unlink all but the first 'keep' blocks of a cache list and return
+ *   them as a chain.
+ *
+ * Assumptions:
+ *   The lock of the owning CPU cache is held.
+ *
+ ****************************************************************************/
+
+static FAR sq_entry_t *
+mempool_multiple_detach(FAR struct mpool_cachelist_s *list, size_t keep)
+{
+  FAR sq_entry_t *last = list->head;
+  FAR sq_entry_t *chain;
+  size_t i;
+
+  if (list->count <= keep)
+    {
+      return NULL;
+    }
+
+  if (keep == 0)
+    {
+      chain = list->head;
+      list->head = NULL;
+      list->count = 0;
+      return chain;
+    }
+
+  for (i = 1; i < keep; i++)
+    {
+      last = last->flink;
+    }
+
+  chain = last->flink;
+  last->flink = NULL;
+  list->count = keep;
+  return chain;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_trim
+ *
+ * Description:
+ *   Halve every list of a CPU cache.  This is done periodically, so that
+ *   blocks freed in a burst on one CPU do not stay out of reach of the
+ *   others forever.
+ *
+ ****************************************************************************/
+
+static void mempool_multiple_trim(FAR struct mempool_multiple_s *mpool,
+                                  FAR struct mpool_cpucache_s *cache)
+{
+  FAR sq_entry_t *chain;
+  irqstate_t flags;
+  size_t i;
+
+  for (i = 0; i < mpool->npools; i++)
+    {
+      flags = spin_lock_irqsave(&cache->lock);
+      chain = mempool_multiple_detach(&cache->lists[i],
+                                      cache->lists[i].count / 2);
+      spin_unlock_irqrestore(&cache->lock, flags);
+
+      mempool_multiple_release(mpool->pools + i, chain);
+    }
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_cache_get
+ *
+ * Description:
+ *   Take a free block of 'pool' from the cache of the current CPU.
+ *
+ ****************************************************************************/
+
+static FAR void *
+mempool_multiple_cache_get(FAR struct mempool_multiple_s *mpool,
+                           FAR struct mempool_s *pool)
+{
+  FAR struct mpool_cpucache_s *cache = &mpool->cache[up_cpu_index()];
+  FAR struct mpool_cachelist_s *list;
+  FAR sq_entry_t *blk;
+  irqstate_t flags;
+
+  if (cache->lists == NULL)
+    {
+      return NULL;
+    }
+
+  list  = &cache->lists[pool - mpool->pools];
+  flags = spin_lock_irqsave(&cache->lock);
+
+  blk = list->head;
+  if (blk != NULL)
+    {
+      list->head = blk->flink;
+      list->count--;
+    }
+
+  spin_unlock_irqrestore(&cache->lock, flags);
+  return blk;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_cache_put
+ *
+ * Description:
+ *   Keep a freed block of 'pool' in the cache of the current CPU.  If the
+ *   cache overflows, half of it is given back to the pool.
+ *
+ * Returned Value:
+ *   True if the block was cached; false if the caller has to return it to
+ *   the pool itself.
+ *
+ ****************************************************************************/
+
+static bool mempool_multiple_cache_put(FAR struct mempool_multiple_s *mpool,
+                                       FAR struct mempool_s *pool,
+                                       FAR void *blk)
+{
+  FAR struct mpool_cpucache_s *cache = &mpool->cache[up_cpu_index()];
+  FAR struct mpool_cachelist_s *list;
+  FAR sq_entry_t *chain = NULL;
+  clock_t now = clock_systime_ticks();
+  irqstate_t flags;
+
+  if (cache->lists == NULL)
+    {
+      return false;
+    }
+
+  list  = &cache->lists[pool - mpool->pools];
+  flags = spin_lock_irqsave(&cache->lock);
+
+  ((FAR sq_entry_t *)blk)->flink = list->head;
+  list->head = blk;
+  if (++list->count > CONFIG_MM_HEAP_MEMPOOL_CPUCACHE_DEPTH)
+    {
+      chain = mempool_multiple_detach(list,
+                                      CONFIG_MM_HEAP_MEMPOOL_CPUCACHE_DEPTH
+                                      / 2);
+    }
+
+  spin_unlock_irqrestore(&cache->lock, flags);
+
+  mempool_multiple_release(pool, chain);
+
+  if (now - cache->trimmed >= MEMPOOL_CPUCACHE_DRAIN_TICKS)
+    {
+      cache->trimmed = now;
+      mempool_multiple_trim(mpool, cache);
+    }
+
+  return true;
+}
+
+#endif /* MEMPOOL_HAVE_CPUCACHE */
+
+#ifdef CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE
+
+/****************************************************************************
+ * Name: mempool_multiple_record
+ *
+ * Description:
+ *   Account a request in the histogram of its size class.
+ *
+ ****************************************************************************/
+
+static void mempool_multiple_record(FAR struct mempool_multiple_s *mpool,
+                                    size_t size)
+{
+  FAR struct mpool_profile_s *profile =
+    &mpool->profile[mempool_multiple_index(mpool, size)];
+
+  __atomic_fetch_add(&profile->count, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&profile->bytes, size, __ATOMIC_RELAXED);
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_cost
+ *
+ * Description:
+ *   Return the bytes wasted when the classes a..j of the compressed
+ *   histogram are all served by the pool of class j.
+ *
+ ****************************************************************************/
+
+static uint64_t mempool_multiple_cost(FAR struct mempool_multiple_s *mpool,
+                                      FAR const size_t *index,
+                                      FAR const uint64_t *count,
+                                      FAR const uint64_t *bytes,
+                                      size_t a, size_t j)
+{
+  uint64_t used = (uint64_t)mpool->pools[index[j]].blocksize *
+                  (count[j + 1] - count[a]);
+  uint64_t req = bytes[j + 1] - bytes[a];
+
+  /* The counters are sampled while they are updated, so the request bytes
+   * may be slightly ahead of the request count.
+   */
+
+  return used > req ? used - req : 0;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_waste
+ *
+ * Description:
+ *   Return the bytes wasted by the currently enabled classes for the
+ *   recorded requests.  Requests that fall through to the caller of the
+ *   multiple mempool are not accounted.
+ *
+ ****************************************************************************/
+
+static uint64_t mempool_multiple_waste(FAR struct mempool_multiple_s *mpool)
+{
+  uint64_t waste = 0;
+  uint64_t used;
+  uint64_t req;
+  size_t i;
+
+  for (i = 0; i < mpool->npools; i++)
+    {
+      if (mpool->map[i] == mpool->npools)
+        {
+          continue;
+        }
+
+      used = (uint64_t)mpool->pools[mpool->map[i]].blocksize *
+             __atomic_load_n(&mpool->profile[i].count, __ATOMIC_RELAXED);
+      req  = __atomic_load_n(&mpool->profile[i].bytes, __ATOMIC_RELAXED);
+      waste += used > req ? used - req : 0;
+    }
+
+  return waste;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_setclass
+ *
+ * Description:
+ *   Enable or disable the class of pool i and redirect the classes that
+ *   were served by it.  map[] is read without the lock by the allocator;
+ *   a racing allocation only uses a neighbouring class.
+ *
+ ****************************************************************************/
+
+static void mempool_multiple_setclass(FAR struct mempool_multiple_s *mpool,
+                                      size_t i, bool enable)
+{
+  size_t target;
+  size_t j;
+
+  nxrmutex_lock(&mpool->lock);
+
+  if (enable && mpool->map[i] != i)
+    {
+      /* Take over the disabled classes below that were redirected past
+       * this one.
+       */
+
+      for (j = i + 1; j-- > 0; )
+        {
+          if (j < i && mpool->map[j] == j)
+            {
+              break;
+            }
+
+          mpool->map[j] = i;
+        }
+    }
+  else if (!enable && mpool->map[i] == i)
+    {
+      /* Hand this class and the ones redirected to it to the next
+       * enabled class.
+       */
+
+      target = i + 1 < mpool->npools ? mpool->map[i + 1] : mpool->npools;
+      for (j = i + 1; j-- > 0 && mpool->map[j] == i; )
+        {
+          mpool->map[j] = target;
+        }
+    }
+
+  nxrmutex_unlock(&mpool->lock);
+}
+
+#endif /* CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -379,6 +775,9 @@ mempool_multiple_init(FAR const char *name,
 {
   FAR struct mempool_multiple_s *mpool;
   FAR struct mempool_s *pools;
+#ifdef MEMPOOL_HAVE_CPUCACHE
+  FAR struct mpool_cachelist_s *lists;
+#endif
   size_t maxpoolszie;
   size_t minpoolsize;
   int ret;
@@ -430,6 +829,26 @@ mempool_multiple_init(FAR const char *name,
   mpool->minpoolsize = minpoolsize;
   mpool->delta = 0;
 
+#ifdef CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE
+  DEBUGASSERT(npools <= MEMPOOL_PROFILE_MAXCLASSES);
+
+  mpool->profile = mempool_multiple_alloc_chunk(mpool, sizeof(uint64_t),
+                     (npools + 1) * sizeof(struct mpool_profile_s) +
+                     npools * sizeof(size_t));
+  if (mpool->profile == NULL)
+    {
+      mempool_multiple_free_chunk(mpool, pools);
+      goto err_with_mpool;
+    }
+
+  memset(mpool->profile, 0, (npools + 1) * sizeof(struct mpool_profile_s));
+  mpool->map = (FAR size_t *)(mpool->profile + npools + 1);
+  for (i = 0; i < npools; i++)
+    {
+      mpool->map[i] = i;
+    }
+#endif
+
   for (i = 0; i < npools; i++)
     {
       pools[i].blocksize = poolsize[i];
@@ -475,6 +894,27 @@ mempool_multiple_init(FAR const char *name,
 
   memset(mpool->dict, 0,
          mpool->dict_row_num * sizeof(FAR struct mpool_dict_s *));
+
+#ifdef MEMPOOL_HAVE_CPUCACHE
+  /* Without the caches the pool still works, only slower */
+
+  lists = mempool_multiple_alloc_chunk(mpool, sizeof(uintptr_t),
+                                       CONFIG_SMP_NCPUS * npools *
+                                       sizeof(struct mpool_cachelist_s));
+  if (lists != NULL)
+    {
+      memset(lists, 0, CONFIG_SMP_NCPUS * npools *
+                       sizeof(struct mpool_cachelist_s));
+    }
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      spin_initialize(&mpool->cache[i].lock, SP_UNLOCKED);
+      mpool->cache[i].trimmed = 0;
+      mpool->cache[i].lists = lists != NULL ? lists + i * npools : NULL;
+    }
+#endif
+
   nxrmutex_init(&mpool->lock);
 
   return mpool;
@@ -485,6 +925,9 @@ err_with_pools:
       mempool_deinit(pools + i);
     }
 
+#ifdef CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE
+  mempool_multiple_free_chunk(mpool, mpool->profile);
+#endif
   mempool_multiple_free_chunk(mpool, pools);
 err_with_mpool:
   free(arg, mpool);
@@ -514,6 +957,14 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
 {
   FAR struct mempool_s *end;
   FAR struct mempool_s *pool;
+  FAR void *blk;
+
+#ifdef CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE
+  if (mpool != NULL)
+    {
+      mempool_multiple_record(mpool, size);
+    }
+#endif
 
   pool = mempool_multiple_find(mpool, size);
   if (pool == NULL)
@@ -521,10 +972,18 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
       return NULL;
     }
 
+#ifdef MEMPOOL_HAVE_CPUCACHE
+  blk = mempool_multiple_cache_get(mpool, pool);
+  if (blk != NULL)
+    {
+      return blk;
+    }
+#endif
+
   end = mpool->pools + mpool->npools;
   do
     {
-      FAR void *blk = mempool_alloc(pool);
+      blk = mempool_alloc(pool);
 
       if (blk)
         {
@@ -610,6 +1069,14 @@ int mempool_multiple_free(FAR struct mempool_multiple_s *mpool,
   blk = (FAR char *)blk - (((FAR char *)blk -
                            ((FAR char *)dict->addr + mpool->minpoolsize)) %
                            MEMPOOL_REALBLOCKSIZE(dict->pool));
+
+#ifdef MEMPOOL_HAVE_CPUCACHE
+  if (mempool_multiple_cache_put(mpool, dict->pool, blk))
+    {
+      return 0;
+    }
+#endif
+
   mempool_free(dict->pool, blk);
   return 0;
 }
@@ -700,6 +1167,49 @@ FAR void *mempool_multiple_memalign(FAR struct mempool_multiple_s *mpool,
   return NULL;
 }
 
+/****************************************************************************
+ * Name: mempool_multiple_drain
+ *
+ * Description:
+ *   Return the free blocks held in the per-CPU caches of all CPUs to their
+ *   pools.  Without CONFIG_MM_HEAP_MEMPOOL_CPUCACHE this does nothing.
+ *
+ * Input Parameters:
+ *   mpool - The handle of multiple memory pool to be used.
+ *
+ ****************************************************************************/
+
+void mempool_multiple_drain(FAR struct mempool_multiple_s *mpool)
+{
+#ifdef MEMPOOL_HAVE_CPUCACHE
+  FAR struct mpool_cpucache_s *cache;
+  FAR sq_entry_t *chain;
+  irqstate_t flags;
+  size_t i;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      cache = &mpool->cache[cpu];
+      if (cache->lists == NULL)
+        {
+          continue;
+        }
+
+      for (i = 0; i < mpool->npools; i++)
+        {
+          flags = spin_lock_irqsave(&cache->lock);
+          chain = mempool_multiple_detach(&cache->lists[i], 0);
+          spin_unlock_irqrestore(&cache->lock, flags);
+
+          mempool_multiple_release(mpool->pools + i, chain);
+        }
+    }
+#else
+  UNUSED(mpool);
+#endif
+}
+
 /****************************************************************************
  * Name: mempool_multiple_foreach
  ****************************************************************************/
@@ -725,6 +1235,9 @@ mempool_multiple_mallinfo(FAR struct mempool_multiple_s *mpool)
   struct mallinfo info;
   size_t i;
 
+  /* Cached blocks would otherwise be reported as used */
+
+  mempool_multiple_drain(mpool);
   memset(&info, 0, sizeof(struct mallinfo));
 
   nxrmutex_lock(&mpool->lock);
@@ -806,6 +1319,8 @@ void mempool_multiple_memdump(FAR struct mempool_multiple_s *mpool,
 {
   size_t i;
 
+  mempool_multiple_drain(mpool);
+
   for (i = 0; i < mpool->npools; i++)
     {
       mempool_memdump(mpool->pools + i, dump);
@@ -829,6 +1344,15 @@ void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool)
 
   DEBUGASSERT(mpool != NULL);
 
+  mempool_multiple_drain(mpool);
+
+#ifdef MEMPOOL_HAVE_CPUCACHE
+  if (mpool->cache[0].lists != NULL)
+    {
+      mempool_multiple_free_chunk(mpool, mpool->cache[0].lists);
+    }
+#endif
+
   for (i = 0; i < mpool->npools; i++)
     {
       DEBUGVERIFY(mempool_deinit(mpool->pools + i));
@@ -847,7 +1371,343 @@ void mempool_multiple_deinit(FAR struct mempool_multiple_s *mpool)
     }
 
   mempool_multiple_free_chunk(mpool, mpool->dict);
+#ifdef CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE
+  mempool_multiple_free_chunk(mpool, mpool->profile);
+#endif
   mempool_multiple_free_chunk(mpool, mpool->pools);
   nxrmutex_destroy(&mpool->lock);
   mpool->free(mpool, mpool);
 }
+
+#ifdef CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE
+
+/****************************************************************************
+ * Name: mempool_multiple_enable
+ *
+ * Description:
+ *   Enable or disable a size class at run time.  The requests of a
+ *   disabled class are served by the next larger enabled class, or are
+ *   refused if there is none, so that the caller falls back to its own
+ *   allocator.  Blocks already allocated from a disabled class stay valid.
+ *
+ * Input Parameters:
+ *   mpool     - The handle of multiple memory pool to be used.
+ *   blocksize - The block size of the class.
+ *   enable    - True to enable the class, false to disable it.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mempool_multiple_enable(FAR struct mempool_multiple_s *mpool,
+                            size_t blocksize, bool enable)
+{
+  size_t i;
+
+  if (mpool == NULL)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < mpool->npools; i++)
+    {
+      if (mpool->pools[i].blocksize == blocksize)
+        {
+          break;
+        }
+    }
+
+  if (i == mpool->npools)
+    {
+      return -ENOENT;
+    }
+
+  mempool_multiple_setclass(mpool, i, enable);
+  if (!enable)
+    {
+      mempool_multiple_drain(mpool);
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_suggest
+ *
+ * Description:
+ *   Compute the set of at most 'npools' of the existing size classes that
+ *   would have served the requests recorded since the last reset with the
+ *   least internal fragmentation.  The largest requested class is always
+ *   part of the set, so no request would fall through to the caller.
+ *
+ * Input Parameters:
+ *   mpool    - The handle of multiple memory pool to be used.
+ *   poolsize - The array that receives the block sizes, in ascending order.
+ *   npools   - The number of elements of poolsize.
+ *   waste    - Receives the bytes the set would have wasted; may be NULL.
+ *
+ * Returned Value:
+ *   The number of classes stored in poolsize; a negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t mempool_multiple_suggest(FAR struct mempool_multiple_s *mpool,
+                                 FAR size_t *poolsize, size_t npools,
+                                 FAR uint64_t *waste)
+{
+  FAR uint16_t *choice;
+  FAR uint64_t *count;
+  FAR uint64_t *bytes;
+  FAR uint64_t *prev;
+  FAR uint64_t *curr;
+  FAR uint64_t *tmp;
+  FAR size_t *index;
+  FAR void *work;
+  uint64_t best;
+  uint64_t cost;
+  size_t nclasses;
+  size_t m = 0;
+  size_t i;
+  size_t j;
+  size_t k;
+
+  if (mpool == NULL || poolsize == NULL || npools == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Only the classes that were requested can end an optimal class */
+
+  for (i = 0; i < mpool->npools; i++)
+    {
+      if (__atomic_load_n(&mpool->profile[i].count, __ATOMIC_RELAXED) != 0)
+        {
+          m++;
+        }
+    }
+
+  if (m == 0)
+    {
+      if (waste != NULL)
+        {
+          *waste = 0;
+        }
+
+      return 0;
+    }
+
+  nclasses = MIN(npools, m);
+  work = mpool->alloc(mpool->arg, sizeof(uint64_t),
+                      (4 * m + 2) * sizeof(uint64_t) +
+                      m * sizeof(size_t) +
+                      nclasses * m * sizeof(uint16_t));
+  if (work == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  count  = work;
+  bytes  = count + m + 1;
+  prev   = bytes + m + 1;
+  curr   = prev + m;
+  index  = (FAR size_t *)(curr + m);
+  choice = (FAR uint16_t *)(index + m);
+
+  /* Build the prefix sums of the compressed histogram */
+
+  count[0] = 0;
+  bytes[0] = 0;
+  for (i = 0, j = 0; i < mpool->npools && j < m; i++)
+    {
+      cost = __atomic_load_n(&mpool->profile[i].count, __ATOMIC_RELAXED);
+      if (cost != 0)
+        {
+          index[j] = i;
+          count[j + 1] = count[j] + cost;
+          bytes[j + 1] = bytes[j] +
+            __atomic_load_n(&mpool->profile[i].bytes, __ATOMIC_RELAXED);
+          j++;
+        }
+    }
+
+  m = j;
+  nclasses = MIN(nclasses, m);
+
+  /* prev[j] is the least waste of the first j + 1 requested classes served
+   * by k + 1 pools, the largest of which is the class j.
+   */
+
+  for (j = 0; j < m; j++)
+    {
+      prev[j] = mempool_multiple_cost(mpool, index, count, bytes, 0, j);
+    }
+
+  for (k = 1; k < nclasses; k++)
+    {
+      for (j = k; j < m; j++)
+        {
+          best = UINT64_MAX;
+          for (i = k - 1; i < j; i++)
+            {
+              cost = prev[i] + mempool_multiple_cost(mpool, index, count,
+                                                     bytes, i + 1, j);
+              if (cost < best)
+                {
+                  best = cost;
+                  choice[k * m + j] = i;
+                }
+            }
+
+          curr[j] = best;
+        }
+
+      tmp  = prev;
+      prev = curr;
+      curr = tmp;
+    }
+
+  if (waste != NULL)
+    {
+      *waste = m > 0 ? prev[m - 1] : 0;
+    }
+
+  for (k = nclasses, j = m - 1; k-- > 0; )
+    {
+      poolsize[k] = mpool->pools[index[j]].blocksize;
+      if (k > 0)
+        {
+          j = choice[k * m + j];
+        }
+    }
+
+  mpool->free(mpool->arg, work);
+  return nclasses;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_tune
+ *
+ * Description:
+ *   Dump the size histogram recorded since the last reset together with
+ *   the best set of 'npools' classes for it, and optionally switch the
+ *   multiple mempool to that set.
+ *
+ * Input Parameters:
+ *   mpool  - The handle of multiple memory pool to be used.
+ *   npools - The number of classes to choose.
+ *   apply  - True to enable exactly the chosen classes.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int mempool_multiple_tune(FAR struct mempool_multiple_s *mpool,
+                          size_t npools, bool apply)
+{
+  FAR size_t *poolsize;
+  ssize_t nclasses;
+  uint64_t waste;
+  size_t serving;
+  size_t i;
+  size_t j;
+
+  if (mpool == NULL || npools == 0)
+    {
+      return -EINVAL;
+    }
+
+  poolsize = mpool->alloc(mpool->arg, sizeof(uintptr_t),
+                          npools * sizeof(size_t));
+  if (poolsize == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nclasses = mempool_multiple_suggest(mpool, poolsize, npools, &waste);
+  if (nclasses < 0)
+    {
+      goto out;
+    }
+
+  syslog(LOG_INFO, "Mempool size class profile:\n");
+  syslog(LOG_INFO, "%12s%12s%12s%20s\n",
+         "Class", "Served by", "Requests", "Bytes");
+
+  for (i = 0; i < mpool->npools; i++)
+    {
+      serving = mpool->map[i] < mpool->npools ?
+                mpool->pools[mpool->map[i]].blocksize : 0;
+
+      syslog(LOG_INFO, "%12zu%12zu%12zu%20" PRIu64 "\n",
+             mpool->pools[i].blocksize, serving,
+             __atomic_load_n(&mpool->profile[i].count, __ATOMIC_RELAXED),
+             __atomic_load_n(&mpool->profile[i].bytes, __ATOMIC_RELAXED));
+    }
+
+  syslog(LOG_INFO, "%12s%12s%12zu%20" PRIu64 "\n", "Larger", "-",
+         __atomic_load_n(&mpool->profile[mpool->npools].count,
+                         __ATOMIC_RELAXED),
+         __atomic_load_n(&mpool->profile[mpool->npools].bytes,
+                         __ATOMIC_RELAXED));
+  syslog(LOG_INFO, "Current waste: %" PRIu64 " bytes\n",
+         mempool_multiple_waste(mpool));
+  syslog(LOG_INFO, "Best %zd classes waste: %" PRIu64 " bytes\n",
+         nclasses, waste);
+
+  for (j = 0; j < (size_t)nclasses; j++)
+    {
+      syslog(LOG_INFO, "%12zu\n", poolsize[j]);
+    }
+
+  if (apply && nclasses > 0)
+    {
+      for (i = 0, j = 0; i < mpool->npools; i++)
+        {
+          if (j < (size_t)nclasses &&
+              mpool->pools[i].blocksize == poolsize[j])
+            {
+              mempool_multiple_setclass(mpool, i, true);
+              j++;
+            }
+          else
+            {
+              mempool_multiple_setclass(mpool, i, false);
+            }
+        }
+
+      mempool_multiple_drain(mpool);
+    }
+
+  nclasses = 0;
+
+out:
+  mpool->free(mpool->arg, poolsize);
+  return nclasses;
+}
+
+/****************************************************************************
+ * Name: mempool_multiple_profile_reset
+ *
+ * Description:
+ *   Clear the size histogram of a multiple mempool.
+ *
+ * Input Parameters:
+ *   mpool - The handle of multiple memory pool to be used.
+ *
+ ****************************************************************************/
+
+void mempool_multiple_profile_reset(FAR struct mempool_multiple_s *mpool)
+{
+  size_t i;
+
+  for (i = 0; i <= mpool->npools; i++)
+    {
+      __atomic_store_n(&mpool->profile[i].count, 0, __ATOMIC_RELAXED);
+      __atomic_store_n(&mpool->profile[i].bytes, 0, __ATOMIC_RELAXED);
+    }
+}
+
+#endif /* CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE */
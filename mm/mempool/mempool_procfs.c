@@ -32,16 +32,6 @@
 #include <nuttx/nuttx.h>
 #include <nuttx/fs/procfs.h>
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-/* Determines the size of an intermediate buffer that must be large enough
- * to handle the longest line generated by this logic.
- */
-
-#define MEMPOOLINFO_LINELEN 80
-
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -51,8 +41,7 @@
 struct mempool_file_s
 {
   struct procfs_file_s base;      /* Base open file structure */
-  unsigned int linesize;          /* Number of valid characters in line[] */
-  char line[MEMPOOLINFO_LINELEN]; /* Pre-allocated buffer for formatted lines */
+  struct procfs_seq_s seq;        /* Record cursor */
 };
 
 /****************************************************************************
@@ -68,6 +57,11 @@ static int     mempool_stat(FAR const char *relpath, FAR struct stat *buf);
 static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
                             size_t buflen);
 
+static FAR void *mempool_start(FAR struct procfs_seq_s *seq, off_t index);
+static FAR void *mempool_next(FAR struct procfs_seq_s *seq, FAR void *elem,
+                              off_t index);
+static int     mempool_show(FAR struct procfs_seq_s *seq, FAR void *elem);
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -88,6 +82,16 @@ const struct procfs_operations g_mempool_operations =
 
 static FAR struct mempool_procfs_entry_s *g_mempool_procfs = NULL;
 
+/* Record 0 is the headers, record n is the n-th registered pool */
+
+static const struct procfs_seq_operations_s g_mempool_seqops =
+{
+  mempool_start,  /* start */
+  mempool_next,   /* next */
+  NULL,           /* stop */
+  mempool_show    /* show */
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -107,6 +111,7 @@ static int mempool_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+  procfs_seq_open(&procfile->seq, &g_mempool_seqops, NULL);
   filep->f_priv = procfile;
   return 0;
 }
@@ -117,62 +122,86 @@ static int mempool_open(FAR struct file *filep, FAR const char *relpath,
 
 static int mempool_close(FAR struct file *filep)
 {
-  kmm_free(filep->f_priv);
+  FAR struct mempool_file_s *procfile = filep->f_priv;
+
+  procfs_seq_close(&procfile->seq);
+  kmm_free(procfile);
   filep->f_priv = NULL;
   return 0;
 }
 
 /****************************************************************************
- * Name: mempool_read
+ * Name: mempool_start
  ****************************************************************************/
 
-static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
-                            size_t buflen)
+static FAR void *mempool_start(FAR struct procfs_seq_s *seq, off_t index)
 {
-  FAR const struct mempool_procfs_entry_s *entry;
-  FAR struct mempool_file_s *procfile;
-  size_t linesize;
-  size_t copysize;
-  size_t totalsize;
-  off_t offset;
-
-  offset    = filep->f_pos;
-  procfile  = filep->f_priv;
-  linesize  = procfs_snprintf(procfile->line, MEMPOOLINFO_LINELEN,
-                              "%13s%11s%9s%9s%9s%9s%9s\n", "", "total",
-                              "bsize", "nused", "nfree", "nifree",
-                              "nwaiter");
-
-  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
-                            &offset);
-  totalsize = copysize;
+  FAR struct mempool_procfs_entry_s *entry;
 
-  for (entry = g_mempool_procfs; entry != NULL; entry = entry->next)
+  /* The sequence state itself stands for the headers */
+
+  if (index == 0)
     {
-      if (totalsize < buflen)
-        {
-          FAR struct mempool_s *pool = container_of(entry, struct mempool_s,
-                                                    procfs);
-          struct mempoolinfo_s minfo;
-
-          buffer    += copysize;
-          buflen    -= copysize;
-
-          mempool_info(pool, &minfo);
-          linesize   = procfs_snprintf(procfile->line, MEMPOOLINFO_LINELEN,
-                                       "%12s:%11lu%9lu%9lu%9lu%9lu%9lu\n",
-                                       entry->name, minfo.arena,
-                                       minfo.sizeblks, minfo.aordblks,
-                                       minfo.ordblks, minfo.iordblks,
-                                       minfo.nwaiter);
-          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
-                                     buflen, &offset);
-          totalsize += copysize;
-        }
+      return seq;
     }
 
-  filep->f_pos += totalsize;
-  return totalsize;
+  entry = g_mempool_procfs;
+  while (entry != NULL && --index > 0)
+    {
+      entry = entry->next;
+    }
+
+  return entry;
+}
+
+/****************************************************************************
+ * Name: mempool_next
+ ****************************************************************************/
+
+static FAR void *mempool_next(FAR struct procfs_seq_s *seq, FAR void *elem,
+                              off_t index)
+{
+  FAR struct mempool_procfs_entry_s *entry = elem;
+
+  return elem == seq ? g_mempool_procfs : entry->next;
+}
+
+/****************************************************************************
+ * Name: mempool_show
+ ****************************************************************************/
+
+static int mempool_show(FAR struct procfs_seq_s *seq, FAR void *elem)
+{
+  FAR struct mempool_procfs_entry_s *entry = elem;
+  FAR struct mempool_s *pool;
+  struct mempoolinfo_s minfo;
+
+  if (elem == seq)
+    {
+      procfs_seq_printf(seq, "%13s%11s%9s%9s%9s%9s%9s\n", "", "total",
+                        "bsize", "nused", "nfree", "nifree", "nwaiter");
+      return 0;
+    }
+
+  pool = container_of(entry, struct mempool_s, procfs);
+  mempool_info(pool, &minfo);
+  procfs_seq_printf(seq, "%12s:%11lu%9lu%9lu%9lu%9lu%9lu\n",
+                    entry->name, minfo.arena, minfo.sizeblks,
+                    minfo.aordblks, minfo.ordblks, minfo.iordblks,
+                    minfo.nwaiter);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: mempool_read
+ ****************************************************************************/
+
+static ssize_t mempool_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct mempool_file_s *procfile = filep->f_priv;
+
+  return procfs_seq_read(&procfile->seq, filep, buffer, buflen);
 }
 
 /****************************************************************************
@@ -196,6 +225,12 @@ static int mempool_dup(FAR const struct file *oldp, FAR struct file *newp)
     }
 
   memcpy(newattr, oldattr, sizeof(struct mempool_file_s));
+  if (procfs_seq_dup(&newattr->seq, &oldattr->seq) < 0)
+    {
+      kmm_free(newattr);
+      return -ENOMEM;
+    }
+
   newp->f_priv = newattr;
   return 0;
 }
@@ -261,3 +296,26 @@ void mempool_procfs_unregister(FAR struct mempool_procfs_entry_s *entry)
         }
     }
 }
+
+/****************************************************************************
+ * Name: mempool_procfs_foreach
+ *
+ * Description:
+ *   Call 'handler' for each mempool registered in the procfs file system.
+ *
+ * Input Parameters:
+ *   handler - The function called for each pool
+ *   arg     - The argument passed to the handler
+ *
+ ****************************************************************************/
+
+void mempool_procfs_foreach(mempool_multiple_foreach_t handler,
+                            FAR void *arg)
+{
+  FAR struct mempool_procfs_entry_s *entry;
+
+  for (entry = g_mempool_procfs; entry != NULL; entry = entry->next)
+    {
+      handler(container_of(entry, struct mempool_s, procfs), arg);
+    }
+}
@@ -31,6 +31,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/lib/math32.h>
+#include <nuttx/mm/gran.h>
 #include <nuttx/mm/mempool.h>
 
 #include <assert.h>
@@ -45,6 +46,27 @@
 
 /* Configuration ************************************************************/
 
+/* The large allocation arena relies on the granule allocator, which
+ * allocates its state from the kernel heap.  The user space copy of the
+ * heap manager does without it.
+ */
+
+#if defined(CONFIG_MM_HEAP_LARGE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_HEAP_HAVE_LARGE  1
+#  define MM_LARGE_PAGESIZE   (1 << CONFIG_MM_HEAP_LARGE_PAGESHIFT)
+#  define MM_LARGE_MAXPAGES   32  /* The limit of gran_alloc() */
+#endif
+
+/* up_perf_gettime() is not available to the user space copy of the heap
+ * manager, whose calls are therefore not timed.
+ */
+
+#if defined(CONFIG_MM_HEAP_TELEMETRY) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_HEAP_HAVE_LATENCY 1
+#endif
+
 /* Chunk Header Definitions *************************************************/
 
 /* These definitions define the characteristics of the allocator:
@@ -110,7 +132,23 @@
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
-#define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
+
+/* With CONFIG_MM_HEAP_SEGREGATED, each power of two above MM_FL_SHIFT is
+ * split into MM_NSL equally sized classes with one free list each.  The
+ * sizes below (1 << MM_FL_SHIFT) are split linearly in steps of
+ * MM_MIN_CHUNK and form the first level 0.  Chunks of MM_MAX_CHUNK bytes
+ * and more all go into the last list.
+ */
+
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+#  define MM_SLI         CONFIG_MM_HEAP_SEGREGATED_SLI
+#  define MM_NSL         (1 << MM_SLI)
+#  define MM_FL_SHIFT    (MM_MIN_SHIFT + MM_SLI)
+#  define MM_NFL         (MM_MAX_SHIFT - MM_FL_SHIFT + 1)
+#  define MM_NNODES      (MM_NFL * MM_NSL)
+#else
+#  define MM_NNODES      (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
+#endif
 
 #if CONFIG_MM_DFAULT_ALIGNMENT == 0
 #  define MM_ALIGN       (2 * sizeof(uintptr_t))
@@ -203,6 +241,11 @@ static_assert(MM_ALIGN >= sizeof(uintptr_t) &&
               (MM_ALIGN & MM_GRAN_MASK) == 0,
               "Error memory aligment\n");
 
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+static_assert(MM_NFL > 0 && MM_NFL < 32,
+              "Error number of segregated fit levels\n");
+#endif
+
 struct mm_delaynode_s
 {
   FAR struct mm_delaynode_s *flink;
@@ -238,6 +281,16 @@ struct mm_heap_s
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
 
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+  /* Bit fl of mm_flbitmap is set if mm_slbitmap[fl] is non-zero.  Bit sl
+   * of mm_slbitmap[fl] is set if the list of the class (fl, sl) is not
+   * empty.
+   */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_NFL];
+#endif
+
   /* Free delay list, for some situations where we can't do free
    * immdiately.
    */
@@ -253,6 +306,28 @@ struct mm_heap_s
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
   struct procfs_meminfo_entry_s mm_procfs;
 #endif
+
+#ifdef CONFIG_MM_HEAP_LARGE
+  /* The page granular arena for large allocations.  It is one allocated
+   * chunk of the heap itself.  mm_largepages[n] is the number of pages of
+   * the allocation starting at page n, or zero.
+   */
+
+  FAR char *mm_largestart;
+  FAR char *mm_largeend;
+  FAR uint8_t *mm_largepages;
+  GRAN_HANDLE mm_largegran;
+  size_t mm_largecount;
+#endif
+
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+  /* Latency histograms of mm_malloc() and mm_free(), see mm_memfrag.c */
+
+  uint32_t mm_alloclat[MM_MEMFRAG_NCLASSES];
+  uint32_t mm_freelat[MM_MEMFRAG_NCLASSES];
+  unsigned long mm_allocmax;
+  unsigned long mm_freemax;
+#endif
 };
 
 /* This describes the callback for mm_foreach */
@@ -279,6 +354,16 @@ void mm_shrinkchunk(FAR struct mm_heap_s *heap,
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
 
+/* Functions contained in mm_delfreechunk.c *********************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node);
+
+/* Functions contained in mm_findfreechunk.c ********************************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size);
+
 /* Functions contained in mm_size2ndx.c *************************************/
 
 int mm_size2ndx(size_t size);
@@ -288,4 +373,29 @@ int mm_size2ndx(size_t size);
 void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
                 FAR void *arg);
 
+/* Functions contained in mm_memfrag.c **************************************/
+
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+void mm_memfrag_latency(FAR uint32_t *hist, FAR unsigned long *max,
+                        unsigned long elapsed);
+#endif
+
+/* Functions contained in mm_large.c ****************************************/
+
+#ifdef MM_HEAP_HAVE_LARGE
+static inline bool mm_large_member(FAR struct mm_heap_s *heap,
+                                   FAR void *mem)
+{
+  return (FAR char *)mem >= heap->mm_largestart &&
+         (FAR char *)mem < heap->mm_largeend;
+}
+
+void mm_large_initialize(FAR struct mm_heap_s *heap);
+void mm_large_uninitialize(FAR struct mm_heap_s *heap);
+FAR void *mm_large_alloc(FAR struct mm_heap_s *heap, size_t size);
+void mm_large_free(FAR struct mm_heap_s *heap, FAR void *mem);
+size_t mm_large_size(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_large_info(FAR struct mm_heap_s *heap, FAR struct mallinfo *info);
+#endif
+
 #endif /* __MM_MM_HEAP_MM_H */
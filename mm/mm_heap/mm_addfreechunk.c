@@ -58,12 +58,24 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap,
 
   ndx = mm_size2ndx(nodesize);
 
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+  /* The lists of the segregated fit index are not ordered, every chunk of
+   * a list is good enough for the requests mapped to it.
+   */
+
+  prev = &heap->mm_nodelist[ndx];
+  next = prev->flink;
+
+  heap->mm_slbitmap[ndx / MM_NSL] |= 1u << (ndx % MM_NSL);
+  heap->mm_flbitmap |= 1u << (ndx / MM_NSL);
+#else
   /* Now put the new node into the next */
 
   for (prev = &heap->mm_nodelist[ndx],
        next = heap->mm_nodelist[ndx].flink;
        next && next->size && SIZEOF_MM_NODE(next) < nodesize;
        prev = next, next = next->flink);
+#endif
 
   /* Does it go in mid next or at the end? */
 
@@ -52,12 +52,14 @@ static void checkcorruption_handler(FAR struct mm_allocnode_s *node,
 
       assert(nodesize >= MM_MIN_CHUNK);
       assert(fnode->blink->flink == fnode);
-      assert(SIZEOF_MM_NODE(fnode->blink) <= nodesize);
       assert(fnode->flink == NULL ||
              fnode->flink->blink == fnode);
+#ifndef CONFIG_MM_HEAP_SEGREGATED
+      assert(SIZEOF_MM_NODE(fnode->blink) <= nodesize);
       assert(fnode->flink == NULL ||
              SIZEOF_MM_NODE(fnode->flink) == 0 ||
              SIZEOF_MM_NODE(fnode->flink) >= nodesize);
+#endif
     }
 }
 
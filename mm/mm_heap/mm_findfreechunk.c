@@ -0,0 +1,141 @@
+/****************************************************************************
+ * mm/mm_heap/mm_findfreechunk.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <strings.h>
+
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *   Find a free chunk of at least 'size' bytes.  The chunk is not removed
+ *   from the nodes list.  It is assumed that the caller holds the mm mutex.
+ *
+ * Input Parameters:
+ *   heap - The heap to search
+ *   size - The size of the chunk, including the allocation node overhead
+ *
+ * Returned Value:
+ *   The free chunk, or NULL if there is no chunk large enough.
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size)
+{
+  FAR struct mm_freenode_s *node;
+  int ndx;
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+  uint32_t map;
+  int fl;
+  int sl;
+
+  /* Round the size up to the next class boundary, so that any chunk of
+   * the class found below is large enough.  Only the last list, which
+   * collects all the chunks too large to be classified, has to be
+   * searched.
+   */
+
+  if (size < (1 << MM_FL_SHIFT))
+    {
+      ndx = mm_size2ndx(size + MM_MIN_CHUNK - 1);
+    }
+  else if (size < MM_MAX_CHUNK)
+    {
+      ndx = mm_size2ndx(size + ((size_t)1 << (flsl(size) - 1 - MM_SLI))
+                        - 1);
+    }
+  else
+    {
+      ndx = MM_NNODES - 1;
+    }
+
+  if (ndx == MM_NNODES - 1)
+    {
+      for (node = heap->mm_nodelist[ndx].flink; node; node = node->flink)
+        {
+          if (SIZEOF_MM_NODE(node) >= size)
+            {
+              return node;
+            }
+        }
+
+      return NULL;
+    }
+
+  /* Find the first non-empty class at or above the rounded one */
+
+  fl  = ndx / MM_NSL;
+  sl  = ndx % MM_NSL;
+  map = heap->mm_slbitmap[fl] & (UINT32_MAX << sl);
+  if (map == 0)
+    {
+      map = heap->mm_flbitmap & (UINT32_MAX << (fl + 1));
+      if (map == 0)
+        {
+          return NULL;
+        }
+
+      fl  = ffs(map) - 1;
+      map = heap->mm_slbitmap[fl];
+    }
+
+  sl   = ffs(map) - 1;
+  node = heap->mm_nodelist[fl * MM_NSL + sl].flink;
+
+  DEBUGASSERT(node != NULL && SIZEOF_MM_NODE(node) >= size);
+  return node;
+#else
+  /* Convert the request size into a nodelist index */
+
+  ndx = mm_size2ndx(size);
+
+  /* Search for a large enough chunk in the list of nodes. This list is
+   * ordered by size, but will have occasional zero sized nodes as we visit
+   * other mm_nodelist[] entries.  Since the list is ordered, the first
+   * chunk found is the best fitting chunk available.
+   */
+
+  for (node = heap->mm_nodelist[ndx].flink; node; node = node->flink)
+    {
+      DEBUGASSERT(node->blink->flink == node);
+      if (SIZEOF_MM_NODE(node) >= size)
+        {
+          break;
+        }
+    }
+
+  return node;
+#endif
+}
@@ -67,7 +67,11 @@ static void add_delaylist(FAR struct mm_heap_s *heap, FAR void *mem)
  *
  ****************************************************************************/
 
+#ifdef MM_HEAP_HAVE_LATENCY
+static void mm_free_internal(FAR struct mm_heap_s *heap, FAR void *mem)
+#else
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
+#endif
 {
   FAR struct mm_freenode_s *node;
   FAR struct mm_freenode_s *prev;
@@ -104,6 +108,19 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
       return;
     }
 
+#ifdef MM_HEAP_HAVE_LARGE
+  /* The arena has its own lock; the heap lock was only taken to learn
+   * whether the caller may sleep on it.
+   */
+
+  if (mm_large_member(heap, mem))
+    {
+      mm_unlock(heap);
+      mm_large_free(heap, mem);
+      return;
+    }
+#endif
+
   kasan_poison(mem, mm_malloc_size(heap, mem));
 
   /* Map the memory chunk into a free node */
@@ -135,16 +152,9 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
       DEBUGASSERT((andbeyond->size & MM_PREVFREE_BIT) != 0 &&
                    andbeyond->preceding == nextsize);
 
-      /* Remove the next node.  There must be a predecessor,
-       * but there may not be a successor node.
-       */
+      /* Remove the next node */
 
-      DEBUGASSERT(next->blink);
-      next->blink->flink = next->flink;
-      if (next->flink)
-        {
-          next->flink->blink = next->blink;
-        }
+      mm_delfreechunk(heap, next);
 
       /* Then merge the two chunks */
 
@@ -171,16 +181,9 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
       DEBUGASSERT((prev->size & MM_ALLOC_BIT) == 0 &&
                   node->preceding == prevsize);
 
-      /* Remove the node.  There must be a predecessor, but there may
-       * not be a successor node.
-       */
+      /* Remove the node */
 
-      DEBUGASSERT(prev->blink);
-      prev->blink->flink = prev->flink;
-      if (prev->flink)
-        {
-          prev->flink->blink = prev->blink;
-        }
+      mm_delfreechunk(heap, prev);
 
       /* Then merge the two chunks */
 
@@ -195,3 +198,16 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
   mm_addfreechunk(heap, node);
   mm_unlock(heap);
 }
+
+#ifdef MM_HEAP_HAVE_LATENCY
+/* Time every free for /proc/memfrag */
+
+void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  unsigned long start = up_perf_gettime();
+
+  mm_free_internal(heap, mem);
+  mm_memfrag_latency(heap->mm_freelat, &heap->mm_freemax,
+                     up_perf_gettime() - start);
+}
+#endif
@@ -222,7 +222,10 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 #endif
   FAR struct mm_heap_s *heap;
   uintptr_t             heap_adj;
+#if !defined(CONFIG_MM_HEAP_SEGREGATED) || \
+    CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   int                   i;
+#endif
 
   minfo("Heap: name=%s, start=%p size=%zu\n", name, heapstart, heapsize);
 
@@ -244,13 +247,17 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 
   memset(heap, 0, sizeof(struct mm_heap_s));
 
-  /* Initialize the node array */
+  /* Initialize the node array.  The segregated fit lists are independent
+   * and need no set up beyond the memset above.
+   */
 
+#ifndef CONFIG_MM_HEAP_SEGREGATED
   for (i = 1; i < MM_NNODES; i++)
     {
       heap->mm_nodelist[i - 1].flink = &heap->mm_nodelist[i];
       heap->mm_nodelist[i].blink     = &heap->mm_nodelist[i - 1];
     }
+#endif
 
   /* Initialize the malloc mutex to one (to support one-at-
    * a-time access to private data sets).
@@ -278,6 +285,10 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 #  endif
 #endif
 
+#ifdef MM_HEAP_HAVE_LARGE
+  mm_large_initialize(heap);
+#endif
+
   /* Initialize the multiple mempool in heap */
 
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
@@ -318,6 +329,10 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
   mempool_multiple_deinit(heap->mm_mpool);
 #endif
 
+#ifdef MM_HEAP_HAVE_LARGE
+  mm_large_uninitialize(heap);
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
 #  if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
   procfs_unregister_meminfo(&heap->mm_procfs);
@@ -325,3 +340,38 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
 #endif
   nxmutex_destroy(&heap->mm_lock);
 }
+
+/****************************************************************************
+ * Name: mm_kasan_enable
+ *
+ * Description:
+ *   Turn the KASan access check of all the regions of a heap on or off,
+ *   e.g. to keep a heap that serves hot DSP buffers out of the check.
+ *   Allocations and frees are still tracked while the check is off.
+ *
+ * Input Parameters:
+ *   heap   - The heap whose regions are affected
+ *   enable - true to check the accesses to the heap
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_KASAN
+void mm_kasan_enable(FAR struct mm_heap_s *heap, bool enable)
+{
+#if CONFIG_MM_REGIONS > 1
+  int region;
+
+  for (region = 0; region < heap->mm_nregions; region++)
+#else
+#  define region 0
+#endif
+    {
+      kasan_enable_region(heap->mm_heapstart[region], enable);
+    }
+
+#undef region
+}
+#endif
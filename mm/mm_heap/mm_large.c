@@ -0,0 +1,284 @@
+/****************************************************************************
+ * mm/mm_heap/mm_large.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/mm/gran.h>
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+#ifdef MM_HEAP_HAVE_LARGE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MM_LARGE_NPAGES(s) \
+  (((s) + MM_LARGE_PAGESIZE - 1) >> CONFIG_MM_HEAP_LARGE_PAGESHIFT)
+#define MM_LARGE_PAGE(h,m) \
+  (((FAR char *)(m) - (h)->mm_largestart) >> CONFIG_MM_HEAP_LARGE_PAGESHIFT)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_large_gran
+ *
+ * Description:
+ *   Return the granule allocator of the arena, creating it on first use.
+ *   gran_initialize() takes its state from the kernel heap, which may be
+ *   the heap being initialized, so this cannot be done by
+ *   mm_large_initialize().
+ *
+ ****************************************************************************/
+
+static GRAN_HANDLE mm_large_gran(FAR struct mm_heap_s *heap)
+{
+  GRAN_HANDLE expected = NULL;
+  GRAN_HANDLE gran;
+
+  gran = __atomic_load_n(&heap->mm_largegran, __ATOMIC_ACQUIRE);
+  if (gran != NULL)
+    {
+      return gran;
+    }
+
+  gran = gran_initialize(heap->mm_largestart,
+                         heap->mm_largeend - heap->mm_largestart,
+                         CONFIG_MM_HEAP_LARGE_PAGESHIFT,
+                         CONFIG_MM_HEAP_LARGE_PAGESHIFT);
+  if (gran == NULL)
+    {
+      return NULL;
+    }
+
+  if (!__atomic_compare_exchange_n(&heap->mm_largegran, &expected, gran,
+                                   false, __ATOMIC_ACQ_REL,
+                                   __ATOMIC_ACQUIRE))
+    {
+      /* Another thread was faster */
+
+      gran_release(gran);
+      gran = expected;
+    }
+
+  return gran;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_large_initialize
+ *
+ * Description:
+ *   Reserve the large allocation arena of a newly initialized heap.  The
+ *   arena is left out if the heap is too small to spare it.
+ *
+ ****************************************************************************/
+
+void mm_large_initialize(FAR struct mm_heap_s *heap)
+{
+  FAR uint8_t *pages;
+  FAR char *start;
+
+  if (heap->mm_heapsize < 2 * CONFIG_MM_HEAP_LARGE_SIZE)
+    {
+      return;
+    }
+
+  start = mm_memalign(heap, MM_LARGE_PAGESIZE, CONFIG_MM_HEAP_LARGE_SIZE);
+  if (start == NULL)
+    {
+      return;
+    }
+
+  pages = mm_zalloc(heap, CONFIG_MM_HEAP_LARGE_SIZE / MM_LARGE_PAGESIZE);
+  if (pages == NULL)
+    {
+      mm_free(heap, start);
+      return;
+    }
+
+  heap->mm_largepages = pages;
+  heap->mm_largestart = start;
+  heap->mm_largeend   = start + CONFIG_MM_HEAP_LARGE_SIZE;
+}
+
+/****************************************************************************
+ * Name: mm_large_uninitialize
+ ****************************************************************************/
+
+void mm_large_uninitialize(FAR struct mm_heap_s *heap)
+{
+  if (heap->mm_largegran != NULL)
+    {
+      gran_release(heap->mm_largegran);
+      heap->mm_largegran = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_large_alloc
+ *
+ * Description:
+ *   Allocate a large block in whole pages from the arena.  NULL is
+ *   returned if the request is not a large one or does not fit, and the
+ *   caller then falls back to the free lists.
+ *
+ ****************************************************************************/
+
+FAR void *mm_large_alloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  GRAN_HANDLE gran;
+  size_t npages;
+  FAR void *ret;
+
+  if (heap->mm_largestart == NULL ||
+      size < CONFIG_MM_HEAP_LARGE_THRESHOLD)
+    {
+      return NULL;
+    }
+
+  npages = MM_LARGE_NPAGES(size);
+  if (npages > MM_LARGE_MAXPAGES)
+    {
+      return NULL;
+    }
+
+  gran = mm_large_gran(heap);
+  if (gran == NULL)
+    {
+      return NULL;
+    }
+
+  /* The granule allocator serializes the page table, and the entry of an
+   * allocation is only touched by its owner.
+   */
+
+  ret = gran_alloc(gran, npages << CONFIG_MM_HEAP_LARGE_PAGESHIFT);
+  if (ret != NULL)
+    {
+      heap->mm_largepages[MM_LARGE_PAGE(heap, ret)] = npages;
+      __atomic_fetch_add(&heap->mm_largecount, 1, __ATOMIC_RELAXED);
+      minfo("Allocated %p, %zu pages\n", ret, npages);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_large_free
+ *
+ * Description:
+ *   Return the pages of a large block to the arena.
+ *
+ * Assumptions:
+ *   mm_large_member(heap, mem) is true.
+ *
+ ****************************************************************************/
+
+void mm_large_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  size_t page = MM_LARGE_PAGE(heap, mem);
+  size_t npages = heap->mm_largepages[page];
+
+  /* Sanity check against double-frees and interior pointers */
+
+  DEBUGASSERT(npages != 0 &&
+              ((uintptr_t)mem & (MM_LARGE_PAGESIZE - 1)) == 0);
+
+  heap->mm_largepages[page] = 0;
+  __atomic_fetch_sub(&heap->mm_largecount, 1, __ATOMIC_RELAXED);
+  gran_free(heap->mm_largegran, mem,
+            npages << CONFIG_MM_HEAP_LARGE_PAGESHIFT);
+}
+
+/****************************************************************************
+ * Name: mm_large_size
+ *
+ * Assumptions:
+ *   mm_large_member(heap, mem) is true.
+ *
+ ****************************************************************************/
+
+size_t mm_large_size(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  return (size_t)heap->mm_largepages[MM_LARGE_PAGE(heap, mem)] <<
+         CONFIG_MM_HEAP_LARGE_PAGESHIFT;
+}
+
+/****************************************************************************
+ * Name: mm_large_info
+ *
+ * Description:
+ *   Correct the heap statistics, which see the whole arena as one used
+ *   chunk, with the free pages and the live blocks of the arena.
+ *
+ ****************************************************************************/
+
+void mm_large_info(FAR struct mm_heap_s *heap, FAR struct mallinfo *info)
+{
+  struct graninfo_s graninfo;
+  size_t nfree;
+  size_t mxfree;
+
+  if (heap->mm_largestart == NULL)
+    {
+      return;
+    }
+
+  if (heap->mm_largegran != NULL)
+    {
+      gran_info(heap->mm_largegran, &graninfo);
+      nfree  = (size_t)graninfo.nfree << CONFIG_MM_HEAP_LARGE_PAGESHIFT;
+      mxfree = (size_t)graninfo.mxfree << CONFIG_MM_HEAP_LARGE_PAGESHIFT;
+    }
+  else
+    {
+      nfree  = heap->mm_largeend - heap->mm_largestart;
+      mxfree = nfree;
+    }
+
+  info->uordblks -= nfree;
+  info->fordblks += nfree;
+  info->aordblks += heap->mm_largecount - 1;
+  if (nfree != 0)
+    {
+      info->ordblks++;
+    }
+
+  if (info->mxordblk < mxfree)
+    {
+      info->mxordblk = mxfree;
+    }
+}
+
+#endif /* MM_HEAP_HAVE_LARGE */
@@ -45,6 +45,15 @@ static void free_delaylist(FAR struct mm_heap_s *heap)
   FAR struct mm_delaynode_s *tmp;
   irqstate_t flags;
 
+  /* Nothing is ever queued to another CPU's list, so the common, empty
+   * case can be tested without entering the critical section.
+   */
+
+  if (heap->mm_delaylist[up_cpu_index()] == NULL)
+    {
+      return;
+    }
+
   /* Move the delay list to local */
 
   flags = enter_critical_section();
@@ -116,13 +125,16 @@ void mm_mempool_dump_handle(FAR struct mempool_s *pool, FAR void *arg)
  *
  ****************************************************************************/
 
+#ifdef MM_HEAP_HAVE_LATENCY
+static FAR void *mm_malloc_internal(FAR struct mm_heap_s *heap, size_t size)
+#else
 FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+#endif
 {
   FAR struct mm_freenode_s *node;
   size_t alignsize;
   size_t nodesize;
   FAR void *ret = NULL;
-  int ndx;
 
   /* Free the delay list first */
 
@@ -136,6 +148,14 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
     }
 #endif
 
+#ifdef MM_HEAP_HAVE_LARGE
+  ret = mm_large_alloc(heap, size);
+  if (ret != NULL)
+    {
+      return ret;
+    }
+#endif
+
   /* Adjust the size to account for (1) the size of the allocated node and
    * (2) to make sure that it is aligned with MM_ALIGN and its size is at
    * least MM_MIN_CHUNK.
@@ -160,29 +180,11 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   DEBUGVERIFY(mm_lock(heap));
 
-  /* Convert the request size into a nodelist index */
+  /* Search for a large enough chunk in the nodelist */
 
-  ndx = mm_size2ndx(alignsize);
+  node = mm_findfreechunk(heap, alignsize);
 
-  /* Search for a large enough chunk in the list of nodes. This list is
-   * ordered by size, but will have occasional zero sized nodes as we visit
-   * other mm_nodelist[] entries.
-   */
-
-  for (node = heap->mm_nodelist[ndx].flink; node; node = node->flink)
-    {
-      DEBUGASSERT(node->blink->flink == node);
-      nodesize = SIZEOF_MM_NODE(node);
-      if (nodesize >= alignsize)
-        {
-          break;
-        }
-    }
-
-  /* If we found a node with non-zero size, then this is one to use. Since
-   * the list is ordered, we know that it must be the best fitting chunk
-   * available.
-   */
+  /* If we found a node with non-zero size, then this is one to use. */
 
   if (node)
     {
@@ -190,16 +192,10 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       FAR struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      nodesize = SIZEOF_MM_NODE(node);
+      mm_delfreechunk(heap, node);
 
       /* Get a pointer to the next node in physical memory */
 
@@ -309,3 +305,17 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   DEBUGASSERT(ret == NULL || ((uintptr_t)ret) % MM_ALIGN == 0);
   return ret;
 }
+
+#ifdef MM_HEAP_HAVE_LATENCY
+/* Time every allocation for /proc/memfrag */
+
+FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  unsigned long start = up_perf_gettime();
+  FAR void *ret = mm_malloc_internal(heap, size);
+
+  mm_memfrag_latency(heap->mm_alloclat, &heap->mm_allocmax,
+                     up_perf_gettime() - start);
+  return ret;
+}
+#endif
@@ -54,6 +54,13 @@ size_t mm_malloc_size(FAR struct mm_heap_s *heap, FAR void *mem)
       return 0;
     }
 
+#ifdef MM_HEAP_HAVE_LARGE
+  if (mm_large_member(heap, mem))
+    {
+      return mm_large_size(heap, mem);
+    }
+#endif
+
   /* Map the memory chunk into a free node */
 
   node = (FAR struct mm_freenode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
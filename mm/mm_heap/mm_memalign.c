@@ -84,6 +84,19 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
    * alignment of malloc, then just let malloc do the work.
    */
 
+#ifdef MM_HEAP_HAVE_LARGE
+  /* Large blocks are page aligned */
+
+  if (alignment <= MM_LARGE_PAGESIZE)
+    {
+      node = mm_large_alloc(heap, size);
+      if (node != NULL)
+        {
+          return node;
+        }
+    }
+#endif
+
   if (alignment <= MM_ALIGN)
     {
       FAR void *ptr = mm_malloc(heap, size);
@@ -199,16 +212,9 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
           FAR struct mm_freenode_s *prev =
             (FAR struct mm_freenode_s *)((FAR char *)node - node->preceding);
 
-          /* Remove the node.  There must be a predecessor, but there may
-           * not be a successor node.
-           */
+          /* Remove the node */
 
-          DEBUGASSERT(prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           precedingsize += SIZEOF_MM_NODE(prev);
           node = (FAR struct mm_allocnode_s *)prev;
@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include <assert.h>
 #include <debug.h>
+#include <errno.h>
 
 #include <nuttx/mm/mm.h>
 
@@ -99,12 +100,14 @@ static void memdump_handler(FAR struct mm_allocnode_s *node, FAR void *arg)
 
       DEBUGASSERT(nodesize >= MM_MIN_CHUNK);
       DEBUGASSERT(fnode->blink->flink == fnode);
-      DEBUGASSERT(SIZEOF_MM_NODE(fnode->blink) <= nodesize);
       DEBUGASSERT(fnode->flink == NULL ||
                   fnode->flink->blink == fnode);
+#ifndef CONFIG_MM_HEAP_SEGREGATED
+      DEBUGASSERT(SIZEOF_MM_NODE(fnode->blink) <= nodesize);
       DEBUGASSERT(fnode->flink == NULL ||
                   SIZEOF_MM_NODE(fnode->flink) == 0 ||
                   SIZEOF_MM_NODE(fnode->flink) >= nodesize);
+#endif
 
       syslog(LOG_INFO, "%12zu%*p\n",
              nodesize, MM_PTR_FMT_WIDTH,
@@ -158,3 +161,38 @@ void mm_memdump(FAR struct mm_heap_s *heap,
   syslog(LOG_INFO, "%12s%12s\n", "Total Blks", "Total Size");
   syslog(LOG_INFO, "%12d%12d\n", info.aordblks, info.uordblks);
 }
+
+/****************************************************************************
+ * Name: mm_mempool_tune
+ *
+ * Description:
+ *   Report the best set of 'npools' size classes for the small requests
+ *   recorded by the heap mempool and optionally switch to it.  If npools
+ *   is zero, the recorded histogram is cleared instead.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE
+int mm_mempool_tune(FAR struct mm_heap_s *heap, size_t npools, bool apply)
+{
+#if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
+  if (heap->mm_mpool == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  if (npools == 0)
+    {
+      mempool_multiple_profile_reset(heap->mm_mpool);
+      return 0;
+    }
+
+  return mempool_multiple_tune(heap->mm_mpool, npools, apply);
+#else
+  UNUSED(heap);
+  UNUSED(npools);
+  UNUSED(apply);
+  return -ENOSYS;
+#endif
+}
+#endif
@@ -0,0 +1,232 @@
+/****************************************************************************
+ * mm/mm_heap/mm_memfrag.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <string.h>
+#include <strings.h>
+
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+#ifdef CONFIG_MM_HEAP_TELEMETRY
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if CONFIG_MM_BACKTRACE > 0
+struct mm_memfrag_callers_s
+{
+  FAR struct mm_memfrag_caller_s *callers;
+  size_t ncallers;
+  size_t nused;
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_memfrag_class
+ ****************************************************************************/
+
+static inline int mm_memfrag_class(unsigned long value)
+{
+  int n = value != 0 ? flsl(value) - 1 : 0;
+
+  return n < MM_MEMFRAG_NCLASSES ? n : MM_MEMFRAG_NCLASSES - 1;
+}
+
+/****************************************************************************
+ * Name: mm_memfrag_handler
+ ****************************************************************************/
+
+static void mm_memfrag_handler(FAR struct mm_allocnode_s *node,
+                               FAR void *arg)
+{
+  FAR struct mm_memfrag_s *frag = arg;
+  size_t nodesize = SIZEOF_MM_NODE(node);
+  int n;
+
+  if ((node->size & MM_ALLOC_BIT) != 0)
+    {
+      return;
+    }
+
+  n = mm_memfrag_class(nodesize);
+  frag->freecount[n]++;
+  frag->freebytes[n] += nodesize;
+  frag->totalfree += nodesize;
+  if (frag->largest < nodesize)
+    {
+      frag->largest = nodesize;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_memfrag_caller_handler
+ ****************************************************************************/
+
+#if CONFIG_MM_BACKTRACE > 0
+static void mm_memfrag_caller_handler(FAR struct mm_allocnode_s *node,
+                                      FAR void *arg)
+{
+  FAR struct mm_memfrag_callers_s *table = arg;
+  FAR void *caller = node->backtrace[0];
+  size_t i;
+
+  if ((node->size & MM_ALLOC_BIT) == 0 || node->pid == PID_MM_MEMPOOL)
+    {
+      return;
+    }
+
+  /* Entry 0 collects the chunks without backtrace and the call sites that
+   * did not fit in the table.
+   */
+
+  for (i = 1; caller != NULL && i < table->nused; i++)
+    {
+      if (table->callers[i].caller == caller)
+        {
+          break;
+        }
+    }
+
+  if (caller == NULL || i == table->ncallers)
+    {
+      i = 0;
+    }
+  else if (i == table->nused)
+    {
+      table->callers[i].caller = caller;
+      table->nused++;
+    }
+
+  table->callers[i].count++;
+  table->callers[i].bytes += SIZEOF_MM_NODE(node);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_memfrag_latency
+ *
+ * Description:
+ *   Account one measured call in a latency histogram.  The counters are
+ *   updated without the heap lock, so the maximum may miss a concurrent
+ *   update.
+ *
+ ****************************************************************************/
+
+void mm_memfrag_latency(FAR uint32_t *hist, FAR unsigned long *max,
+                        unsigned long elapsed)
+{
+  __atomic_fetch_add(&hist[mm_memfrag_class(elapsed)], 1, __ATOMIC_RELAXED);
+  if (elapsed > *max)
+    {
+      *max = elapsed;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_memfrag
+ *
+ * Description:
+ *   Take a snapshot of the free chunks and of the latency histograms of a
+ *   heap.
+ *
+ ****************************************************************************/
+
+void mm_memfrag(FAR struct mm_heap_s *heap, FAR struct mm_memfrag_s *frag)
+{
+  memset(frag, 0, sizeof(struct mm_memfrag_s));
+  mm_foreach(heap, mm_memfrag_handler, frag);
+
+  memcpy(frag->alloclat, heap->mm_alloclat, sizeof(frag->alloclat));
+  memcpy(frag->freelat, heap->mm_freelat, sizeof(frag->freelat));
+  frag->allocmax = heap->mm_allocmax;
+  frag->freemax  = heap->mm_freemax;
+}
+
+/****************************************************************************
+ * Name: mm_memfrag_reset
+ *
+ * Description:
+ *   Clear the latency histograms of a heap.
+ *
+ ****************************************************************************/
+
+void mm_memfrag_reset(FAR struct mm_heap_s *heap)
+{
+  memset(heap->mm_alloclat, 0, sizeof(heap->mm_alloclat));
+  memset(heap->mm_freelat, 0, sizeof(heap->mm_freelat));
+  heap->mm_allocmax = 0;
+  heap->mm_freemax  = 0;
+}
+
+/****************************************************************************
+ * Name: mm_memfrag_callers
+ *
+ * Description:
+ *   Sum the allocated chunks of a heap by the call site that allocated
+ *   them.  Entry 0 receives the chunks without a recorded backtrace and
+ *   those of the call sites beyond the end of the table.
+ *
+ * Input Parameters:
+ *   heap     - The heap to examine
+ *   callers  - The table to fill
+ *   ncallers - The number of entries of the table, at least one
+ *
+ * Returned Value:
+ *   The number of entries used.
+ *
+ ****************************************************************************/
+
+#if CONFIG_MM_BACKTRACE > 0
+size_t mm_memfrag_callers(FAR struct mm_heap_s *heap,
+                          FAR struct mm_memfrag_caller_s *callers,
+                          size_t ncallers)
+{
+  struct mm_memfrag_callers_s table;
+
+  DEBUGASSERT(ncallers > 0);
+
+  memset(callers, 0, ncallers * sizeof(struct mm_memfrag_caller_s));
+  table.callers  = callers;
+  table.ncallers = ncallers;
+  table.nused    = 1;
+
+  mm_foreach(heap, mm_memfrag_caller_handler, &table);
+  return table.nused;
+}
+#endif
+
+#endif /* CONFIG_MM_HEAP_TELEMETRY */
@@ -44,12 +44,36 @@
 
 int mm_size2ndx(size_t size)
 {
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+  int fl;
+  int sl;
+#endif
+
   DEBUGASSERT(size >= MM_MIN_CHUNK);
   if (size >= MM_MAX_CHUNK)
     {
       return MM_NNODES - 1;
     }
 
+#ifdef CONFIG_MM_HEAP_SEGREGATED
+  if (size < (1 << MM_FL_SHIFT))
+    {
+      /* The first level is split linearly */
+
+      fl = 0;
+      sl = size >> MM_MIN_SHIFT;
+    }
+  else
+    {
+      /* The sub-class is given by the MM_SLI bits below the MSB */
+
+      fl = flsl(size) - MM_FL_SHIFT;
+      sl = (size >> (flsl(size) - 1 - MM_SLI)) - MM_NSL;
+    }
+
+  return fl * MM_NSL + sl;
+#else
   size >>= MM_MIN_SHIFT;
   return flsl(size) - 1;
+#endif
 }
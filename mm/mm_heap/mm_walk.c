@@ -0,0 +1,83 @@
+/****************************************************************************
+ * mm/mm_heap/mm_walk.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_walk
+ *
+ * Description:
+ *   Call 'handler' for each chunk of the heap, header included.  Unlike
+ *   mm_foreach(), the heap is not locked, so that this can be used when
+ *   the system has stopped, e.g. by a crash dump taken while the crashed
+ *   task holds the heap lock.  The caller makes sure nobody changes the
+ *   heap meanwhile.
+ *
+ ****************************************************************************/
+
+void mm_walk(FAR struct mm_heap_s *heap, mm_walk_handler_t handler,
+             FAR void *arg)
+{
+  FAR struct mm_allocnode_s *node;
+  size_t nodesize;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+#  define region 0
+#endif
+
+  DEBUGASSERT(handler);
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      for (node = heap->mm_heapstart[region];
+           node < heap->mm_heapend[region];
+           node = (FAR struct mm_allocnode_s *)((FAR char *)node + nodesize))
+        {
+          nodesize = SIZEOF_MM_NODE(node);
+          if (nodesize == 0)
+            {
+              /* A corrupted heap, do not loop forever */
+
+              break;
+            }
+
+          handler(node, nodesize, (node->size & MM_ALLOC_BIT) != 0, arg);
+        }
+    }
+#undef region
+}
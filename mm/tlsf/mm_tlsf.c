@@ -28,6 +28,7 @@
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
+#include <limits.h>
 #include <sched.h>
 #include <stdio.h>
 #include <string.h>
@@ -125,6 +126,12 @@ struct mm_mallinfo_handler_s
   FAR struct mallinfo_task *info;
 };
 
+struct mm_walk_handler_s
+{
+  mm_walk_handler_t handler;
+  FAR void *arg;
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -192,6 +199,15 @@ static void free_delaylist(FAR struct mm_heap_s *heap)
   FAR struct mm_delaynode_s *tmp;
   irqstate_t flags;
 
+  /* Nothing is ever queued to another CPU's list, so the common, empty
+   * case can be tested without entering the critical section.
+   */
+
+  if (heap->mm_delaylist[up_cpu_index()] == NULL)
+    {
+      return;
+    }
+
   /* Move the delay list to local */
 
   flags = enter_critical_section();
@@ -250,6 +266,96 @@ static FAR void *mempool_memalign(FAR void *arg, size_t alignment,
 #  define mempool_memalign mm_memalign
 #endif
 
+/****************************************************************************
+ * Name: mm_dump_handler
+ ****************************************************************************/
+
+#if defined(CONFIG_DEBUG_MM) && defined(CONFIG_MM_DUMP_ON_FAILURE)
+#  if CONFIG_MM_BACKTRACE >= 0
+static void mm_dump_handler(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  struct mallinfo_task info;
+  struct malltask task;
+
+  task.pid = tcb ? tcb->pid : PID_MM_LEAK;
+  task.seqmin = 0;
+  task.seqmax = ULONG_MAX;
+  info = mm_mallinfo_task(arg, &task);
+  mwarn("pid:%5d, used:%10d, nused:%10d\n",
+        task.pid, info.uordblks, info.aordblks);
+}
+#  endif
+
+#  if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
+static void mm_mempool_dump_handle(FAR struct mempool_s *pool,
+                                   FAR void *arg)
+{
+  struct mempoolinfo_s info;
+
+  mempool_info(pool, &info);
+  mwarn("%9lu%11lu%9lu%9lu%9lu%9lu\n",
+        info.sizeblks, info.arena, info.aordblks,
+        info.ordblks, info.iordblks, info.nwaiter);
+}
+#  endif
+#endif
+
+/****************************************************************************
+ * Name: mm_alloc_failed
+ *
+ * Description:
+ *   Report an allocation failure the same way the default heap manager
+ *   does.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEBUG_MM
+static void mm_alloc_failed(FAR struct mm_heap_s *heap, size_t size)
+{
+#  ifdef CONFIG_MM_DUMP_ON_FAILURE
+  struct mallinfo minfo;
+#    ifdef CONFIG_MM_DUMP_DETAILS_ON_FAILURE
+  struct mm_memdump_s dump =
+  {
+    PID_MM_ALLOC, 0, ULONG_MAX
+  };
+#    endif
+#  endif
+
+  if (!MM_INTERNAL_HEAP(heap))
+    {
+      return;
+    }
+
+  mwarn("WARNING: Allocation failed, size %zu\n", size);
+#  ifdef CONFIG_MM_DUMP_ON_FAILURE
+  minfo = mm_mallinfo(heap);
+  mwarn("Total:%d, used:%d, free:%d, largest:%d, nused:%d, nfree:%d\n",
+        minfo.arena, minfo.uordblks, minfo.fordblks,
+        minfo.mxordblk, minfo.aordblks, minfo.ordblks);
+#    if CONFIG_MM_BACKTRACE >= 0
+  nxsched_foreach(mm_dump_handler, heap);
+  mm_dump_handler(NULL, heap);
+#    endif
+#    if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
+  mwarn("%11s%9s%9s%9s%9s%9s\n",
+        "bsize", "total", "nused",
+        "nfree", "nifree", "nwaiter");
+  mempool_multiple_foreach(heap->mm_mpool,
+                           mm_mempool_dump_handle, NULL);
+#    endif
+#    ifdef CONFIG_MM_DUMP_DETAILS_ON_FAILURE
+  mm_memdump(heap, &dump);
+#    endif
+#  endif
+#  ifdef CONFIG_MM_PANIC_ON_FAILURE
+  PANIC();
+#  endif
+}
+#else
+#  define mm_alloc_failed(heap, size)
+#endif
+
 /****************************************************************************
  * Name: mallinfo_handler
  ****************************************************************************/
@@ -394,6 +500,18 @@ static void mm_unlock(FAR struct mm_heap_s *heap)
   DEBUGVERIFY(nxmutex_unlock(&heap->mm_lock));
 }
 
+/****************************************************************************
+ * Name: walk_handler
+ ****************************************************************************/
+
+static void walk_handler(FAR void *ptr, size_t size, int used,
+                         FAR void *user)
+{
+  FAR struct mm_walk_handler_s *walk = user;
+
+  walk->handler(ptr, size, used != 0, walk->arg);
+}
+
 /****************************************************************************
  * Name: memdump_handler
  ****************************************************************************/
@@ -680,6 +798,8 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
       return;
     }
 
+  DEBUGASSERT(mm_heapmember(heap, mem));
+
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   if (mempool_multiple_free(heap->mm_mpool, mem) >= 0)
     {
@@ -989,6 +1109,72 @@ void mm_memdump(FAR struct mm_heap_s *heap,
   syslog(LOG_INFO, "%12d%12d\n", info.aordblks, info.uordblks);
 }
 
+/****************************************************************************
+ * Name: mm_walk
+ *
+ * Description:
+ *   Call 'handler' for each block of the heap.  The heap is not locked, see
+ *   mm/mm_heap/mm_walk.c.
+ *
+ ****************************************************************************/
+
+void mm_walk(FAR struct mm_heap_s *heap, mm_walk_handler_t handler,
+             FAR void *arg)
+{
+  struct mm_walk_handler_s walk;
+#if CONFIG_MM_REGIONS > 1
+  int region;
+#else
+#  define region 0
+#endif
+
+  walk.handler = handler;
+  walk.arg     = arg;
+
+#if CONFIG_MM_REGIONS > 1
+  for (region = 0; region < heap->mm_nregions; region++)
+#endif
+    {
+      tlsf_walk_pool(heap->mm_heapstart[region], walk_handler, &walk);
+    }
+#undef region
+}
+
+/****************************************************************************
+ * Name: mm_mempool_tune
+ *
+ * Description:
+ *   Report the best set of 'npools' size classes for the small requests
+ *   recorded by the heap mempool and optionally switch to it.  If npools
+ *   is zero, the recorded histogram is cleared instead.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_MEMPOOL_MULTIPLE_PROFILE
+int mm_mempool_tune(FAR struct mm_heap_s *heap, size_t npools, bool apply)
+{
+#if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
+  if (heap->mm_mpool == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  if (npools == 0)
+    {
+      mempool_multiple_profile_reset(heap->mm_mpool);
+      return 0;
+    }
+
+  return mempool_multiple_tune(heap->mm_mpool, npools, apply);
+#else
+  UNUSED(heap);
+  UNUSED(npools);
+  UNUSED(apply);
+  return -ENOSYS;
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: mm_malloc_size
  ****************************************************************************/
@@ -1064,6 +1250,14 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       memdump_backtrace(heap, buf);
 #endif
       kasan_unpoison(ret, mm_malloc_size(heap, ret));
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+      memset(ret, 0xaa, mm_malloc_size(heap, ret));
+#endif
+      minfo("Allocated %p, size %zu\n", ret, size);
+    }
+  else
+    {
+      mm_alloc_failed(heap, size);
     }
 
   return ret;
@@ -1118,6 +1312,13 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       memdump_backtrace(heap, buf);
 #endif
       kasan_unpoison(ret, mm_malloc_size(heap, ret));
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+      memset(ret, 0xaa, mm_malloc_size(heap, ret));
+#endif
+    }
+  else
+    {
+      mm_alloc_failed(heap, size);
     }
 
   return ret;
@@ -1167,6 +1368,8 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       size = 1;
     }
 
+  DEBUGASSERT(mm_heapmember(heap, oldmem));
+
 #if CONFIG_MM_HEAP_MEMPOOL_THRESHOLD != 0
   newmem = mempool_multiple_realloc(heap->mm_mpool, oldmem, size);
   if (newmem != NULL)
@@ -1177,12 +1380,13 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
            mempool_multiple_alloc_size(heap->mm_mpool, oldmem) >= 0)
     {
       newmem = mm_malloc(heap, size);
-      if (newmem != 0)
+      if (newmem != NULL)
         {
-          memcpy(newmem, oldmem, size);
+          memcpy(newmem, oldmem, MIN(size, mm_malloc_size(heap, oldmem)));
           mm_free(heap, oldmem);
-          return newmem;
         }
+
+      return newmem;
     }
 #endif
 
@@ -1258,6 +1462,41 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
   tlsf_destroy(&heap->mm_tlsf);
 }
 
+/****************************************************************************
+ * Name: mm_kasan_enable
+ *
+ * Description:
+ *   Turn the KASan access check of all the regions of a heap on or off,
+ *   e.g. to keep a heap that serves hot DSP buffers out of the check.
+ *   Allocations and frees are still tracked while the check is off.
+ *
+ * Input Parameters:
+ *   heap   - The heap whose regions are affected
+ *   enable - true to check the accesses to the heap
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_KASAN
+void mm_kasan_enable(FAR struct mm_heap_s *heap, bool enable)
+{
+#if CONFIG_MM_REGIONS > 1
+  int region;
+
+  for (region = 0; region < heap->mm_nregions; region++)
+#else
+#  define region 0
+#endif
+    {
+      kasan_enable_region(heap->mm_heapstart[region], enable);
+    }
+
+#undef region
+}
+#endif
+
 /****************************************************************************
  * Name: mm_zalloc
  *
@@ -38,11 +38,13 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <errno.h>
 
 #include <netinet/arp.h>
 #include <netinet/in.h>
 
+#include <nuttx/queue.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/semaphore.h>
 
@@ -152,13 +154,28 @@ struct arp_notify_s
 };
 #endif
 
-/* One entry in the ARP table (volatile!) */
+/* One entry in the ARP table (volatile!)
+ *
+ * An entry is REACHABLE for CONFIG_NET_ARP_REACHABLE seconds after the
+ * mapping is confirmed, then STALE.  A STALE entry is still used, but its
+ * next use moves it to PROBE: unicast ARP requests are sent to confirm the
+ * mapping, and the entry is removed if none is answered.
+ */
+
+#define ARP_STATE_REACHABLE 0           /* Confirmed, or STALE if old */
+#define ARP_STATE_PROBE     1           /* Being confirmed */
 
 struct arp_entry_s
 {
+  FAR struct arp_entry_s  *at_hnext;    /* Next entry of the hash bucket */
+  dq_entry_t               at_node;     /* Node of the LRU or free list */
+  dq_entry_t               at_pnode;    /* Node of the probe list */
   in_addr_t                at_ipaddr;   /* IP address */
   struct ether_addr        at_ethaddr;  /* Hardware address */
-  clock_t                  at_time;     /* Time of last usage */
+  uint8_t                  at_state;    /* See ARP_STATE_* definitions */
+  uint8_t                  at_probes;   /* Number of probes sent */
+  clock_t                  at_time;     /* Time of last confirmation */
+  clock_t                  at_ptime;    /* Time of last probe */
   FAR struct net_driver_s *at_dev;      /* The device driver structure */
 };
 
@@ -476,6 +493,28 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
 void arp_hdr_update(FAR struct net_driver_s *dev, FAR uint16_t *pipaddr,
                     FAR const uint8_t *ethaddr);
 
+/****************************************************************************
+ * Name: arp_probe
+ *
+ * Description:
+ *   Format a unicast ARP request in the device buffer to confirm the next
+ *   ARP table entry of the device in the PROBE state that is due a probe.
+ *   The entries whose probes were not answered are removed.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure
+ *
+ * Returned Value:
+ *   True if an ARP request is ready to be sent.
+ *
+ * Assumptions
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() with the network locked.
+ *
+ ****************************************************************************/
+
+bool arp_probe(FAR struct net_driver_s *dev);
+
 /****************************************************************************
  * Name: arp_snapshot
  *
@@ -541,6 +580,7 @@ void arp_dump(FAR struct arp_hdr_s *arp);
 #  define arp_cleanup(d)
 #  define arp_update(d,i,m);
 #  define arp_hdr_update(d,i,m);
+#  define arp_probe(d) (false)
 #  define arp_snapshot(s,n) (0)
 #  define arp_dump(arp)
 
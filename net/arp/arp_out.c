@@ -148,9 +148,8 @@ void arp_out(FAR struct net_driver_s *dev)
       return;
     }
 
-#if defined(CONFIG_NET_PKT) || defined(CONFIG_NET_ARP_SEND)
   /* Skip sending ARP requests when the frame to be transmitted was
-   * written into a packet socket.
+   * written into a packet socket, or is an ARP request.
    */
 
   if (IFF_IS_NOARP(dev->d_flags))
@@ -160,7 +159,6 @@ void arp_out(FAR struct net_driver_s *dev)
       IFF_CLR_NOARP(dev->d_flags);
       return;
     }
-#endif
 
   /* Find the destination IP address in the ARP table and construct
    * the Ethernet header. If the destination IP address isn't on the
@@ -55,6 +55,8 @@
 #include <net/ethernet.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -69,7 +71,14 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
+#define ARP_MAXAGE_TICK    SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
+#define ARP_REACHABLE_TICK SEC2TICK(CONFIG_NET_ARP_REACHABLE)
+#define ARP_PROBE_TICK     MSEC2TICK(CONFIG_NET_ARP_PROBE_INTERVAL)
+
+#define ARP_HASH_SIZE      (1 << CONFIG_NET_ARP_HASHBITS)
+
+#define ARP_ENTRY(n)       container_of(n, struct arp_entry_s, at_node)
+#define ARP_PENTRY(n)      container_of(n, struct arp_entry_s, at_pnode)
 
 /****************************************************************************
  * Private Types
@@ -89,6 +98,22 @@ struct arp_table_info_s
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 
+/* The entries hashed by IP address */
+
+static FAR struct arp_entry_s *g_arphash[ARP_HASH_SIZE];
+
+/* The entries in use, the least recently confirmed first, the deleted
+ * entries and the entries in the PROBE state.
+ */
+
+static dq_queue_t g_arplru;
+static dq_queue_t g_arpfree;
+static dq_queue_t g_arpprobe;
+
+/* The number of entries of g_arptable ever used */
+
+static int g_arpused;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -140,32 +165,117 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_hash
+ *
+ * Description:
+ *   Return the hash bucket of an IP address.
+ *
+ ****************************************************************************/
+
+static inline unsigned int arp_hash(in_addr_t ipaddr)
+{
+  return (uint32_t)(NTOHL(ipaddr) * 2654435761u) >>
+         (32 - CONFIG_NET_ARP_HASHBITS);
+}
+
+/****************************************************************************
+ * Name: arp_search
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Find the ARP entry of the IP address on the device, whatever its age.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static FAR struct arp_entry_s *arp_search(in_addr_t ipaddr,
+                                          FAR struct net_driver_s *dev)
 {
-  if (e1->at_ipaddr == 0)
+  FAR struct arp_entry_s *tabptr;
+
+  for (tabptr = g_arphash[arp_hash(ipaddr)]; tabptr != NULL;
+       tabptr = tabptr->at_hnext)
     {
-      return e1;
+      if (tabptr->at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
     }
-  else if (e2->at_ipaddr == 0)
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: arp_free
+ *
+ * Description:
+ *   Remove an entry from the ARP table.
+ *
+ ****************************************************************************/
+
+static void arp_free(FAR struct arp_entry_s *tabptr)
+{
+  FAR struct arp_entry_s **prev = &g_arphash[arp_hash(tabptr->at_ipaddr)];
+
+  while (*prev != tabptr)
     {
-      return e2;
+      prev = &(*prev)->at_hnext;
     }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+
+  *prev = tabptr->at_hnext;
+
+  if (tabptr->at_state == ARP_STATE_PROBE)
     {
-      return e1;
+      dq_rem(&tabptr->at_pnode, &g_arpprobe);
+    }
+
+  dq_rem(&tabptr->at_node, &g_arplru);
+  dq_addlast(&tabptr->at_node, &g_arpfree);
+
+  tabptr->at_ipaddr = 0;
+  tabptr->at_dev    = NULL;
+}
+
+/****************************************************************************
+ * Name: arp_alloc
+ *
+ * Description:
+ *   Add an entry to the ARP table, replacing the least recently confirmed
+ *   entry if the table is full.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_alloc(in_addr_t ipaddr,
+                                         FAR struct net_driver_s *dev)
+{
+  FAR struct arp_entry_s *tabptr;
+  FAR dq_entry_t *node;
+  unsigned int hash;
+
+  node = dq_remfirst(&g_arpfree);
+  if (node != NULL)
+    {
+      tabptr = ARP_ENTRY(node);
+    }
+  else if (g_arpused < CONFIG_NET_ARPTAB_SIZE)
+    {
+      tabptr = &g_arptable[g_arpused++];
     }
   else
     {
-      return e2;
+      tabptr = ARP_ENTRY(dq_peek(&g_arplru));
+      arp_free(tabptr);
+      dq_rem(&tabptr->at_node, &g_arpfree);
     }
+
+  hash              = arp_hash(ipaddr);
+  tabptr->at_hnext  = g_arphash[hash];
+  g_arphash[hash]   = tabptr;
+  tabptr->at_ipaddr = ipaddr;
+  tabptr->at_dev    = dev;
+  tabptr->at_state  = ARP_STATE_REACHABLE;
+
+  dq_addlast(&tabptr->at_node, &g_arplru);
+  return tabptr;
 }
 
 /****************************************************************************
@@ -188,24 +298,29 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
   FAR struct arp_entry_s *tabptr;
-  int i;
+  clock_t now;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_search(ipaddr, dev);
+  if (tabptr == NULL)
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
-        {
-          return tabptr;
-        }
+      return NULL;
     }
 
-  /* Not found */
+  /* Remove the entries too old or whose probes were not answered */
 
-  return NULL;
+  now = clock_systime_ticks();
+  if (now - tabptr->at_time > ARP_MAXAGE_TICK ||
+      (tabptr->at_state == ARP_STATE_PROBE &&
+       tabptr->at_probes >= CONFIG_NET_ARP_PROBES &&
+       now - tabptr->at_ptime >= ARP_PROBE_TICK))
+    {
+      arp_free(tabptr);
+      return NULL;
+    }
+
+  return tabptr;
 }
 
 /****************************************************************************
@@ -236,44 +351,36 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
-  int i;
+  FAR struct arp_entry_s *tabptr;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Find the entry to update.  If none is found, the IP -> MAC address
+   * mapping is inserted in the ARP table.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_search(ipaddr, dev);
+  if (tabptr == NULL)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
+      tabptr = arp_alloc(ipaddr, dev);
+    }
+  else
+    {
+      /* The mapping is confirmed, it is the most recent one */
 
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
+      if (tabptr->at_state == ARP_STATE_PROBE)
         {
-          /* An old entry found, break. */
-
-          tabptr = &g_arptable[i];
-          break;
+          dq_rem(&tabptr->at_pnode, &g_arpprobe);
+          tabptr->at_state = ARP_STATE_REACHABLE;
         }
-      else
-        {
-          /* Record the oldest entry. */
 
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
-        }
+      dq_rem(&tabptr->at_node, &g_arplru);
+      dq_addlast(&tabptr->at_node, &g_arplru);
     }
 
   /* Now, tabptr is the ARP table entry which we will fill with the new
    * information.
    */
 
-  tabptr->at_ipaddr = ipaddr;
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-  tabptr->at_dev = dev;
   tabptr->at_time = clock_systime_ticks();
   return OK;
 }
@@ -349,6 +456,20 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
           memcpy(ethaddr, &tabptr->at_ethaddr, ETHER_ADDR_LEN);
         }
 
+      /* A STALE entry is used: confirm it with unicast ARP requests, sent
+       * when the device polls for data.
+       */
+
+      if (tabptr->at_state == ARP_STATE_REACHABLE &&
+          clock_systime_ticks() - tabptr->at_time > ARP_REACHABLE_TICK)
+        {
+          tabptr->at_state  = ARP_STATE_PROBE;
+          tabptr->at_probes = 0;
+          tabptr->at_ptime  = clock_systime_ticks() - ARP_PROBE_TICK;
+          dq_addlast(&tabptr->at_pnode, &g_arpprobe);
+          netdev_txnotify_dev(dev);
+        }
+
       /* Return success in any case meaning that a valid Ethernet MAC
        * address mapping is available for the IP address.
        */
@@ -395,12 +516,10 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 
   /* Check if the IPv4 address is in the ARP table. */
 
-  tabptr = arp_lookup(ipaddr, dev);
+  tabptr = arp_search(ipaddr, dev);
   if (tabptr != NULL)
     {
-      /* Yes.. Set the IP address to zero to "delete" it */
-
-      tabptr->at_ipaddr = 0;
+      arp_free(tabptr);
       return OK;
     }
 
@@ -425,15 +544,92 @@ void arp_cleanup(FAR struct net_driver_s *dev)
 {
   int i;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (i = 0; i < g_arpused; ++i)
     {
-      if (dev == g_arptable[i].at_dev)
+      if (g_arptable[i].at_ipaddr != 0 && dev == g_arptable[i].at_dev)
         {
-          memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+          arp_free(&g_arptable[i]);
         }
     }
 }
 
+/****************************************************************************
+ * Name: arp_probe
+ *
+ * Description:
+ *   Format a unicast ARP request in the device buffer to confirm the next
+ *   ARP table entry of the device in the PROBE state that is due a probe.
+ *   The entries whose probes were not answered are removed.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure
+ *
+ * Returned Value:
+ *   True if an ARP request is ready to be sent.
+ *
+ * Assumptions
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() with the network locked.
+ *
+ ****************************************************************************/
+
+bool arp_probe(FAR struct net_driver_s *dev)
+{
+  FAR struct arp_entry_s *tabptr;
+  FAR dq_entry_t *node;
+  FAR dq_entry_t *next;
+  clock_t now;
+
+  if (dq_empty(&g_arpprobe))
+    {
+      return false;
+    }
+
+  now = clock_systime_ticks();
+  for (node = dq_peek(&g_arpprobe); node != NULL; node = next)
+    {
+      next   = dq_next(node);
+      tabptr = ARP_PENTRY(node);
+
+      if (tabptr->at_dev != dev || now - tabptr->at_ptime < ARP_PROBE_TICK)
+        {
+          continue;
+        }
+
+      if (tabptr->at_probes >= CONFIG_NET_ARP_PROBES)
+        {
+          ninfo("ARP entry for IP %08lx failed\n",
+                (unsigned long)tabptr->at_ipaddr);
+          arp_free(tabptr);
+          continue;
+        }
+
+      dev->d_len = 0;
+      arp_format(dev, tabptr->at_ipaddr);
+      if (dev->d_len == 0)
+        {
+          return false;
+        }
+
+      tabptr->at_probes++;
+      tabptr->at_ptime = now;
+
+      /* Send the request to the cached address only */
+
+      memcpy(ETHBUF->dest, &tabptr->at_ethaddr, ETHER_ADDR_LEN);
+      memcpy(ARPBUF->ah_dhwaddr, &tabptr->at_ethaddr, ETHER_ADDR_LEN);
+      arp_dump(ARPBUF);
+
+      /* Make sure arp_out() lets the ARP request go */
+
+      IFF_SET_IPv4(dev->d_flags);
+      IFF_SET_NOARP(dev->d_flags);
+      return true;
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: arp_snapshot
  *
@@ -467,7 +663,7 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
   /* Copy all non-empty, non-expired entries in the ARP table. */
 
   for (i = 0, now = clock_systime_ticks(), ncopied = 0;
-       nentries > ncopied && i < CONFIG_NET_ARPTAB_SIZE;
+       nentries > ncopied && i < g_arpused;
        i++)
     {
       tabptr = &g_arptable[i];
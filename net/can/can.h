@@ -56,6 +56,10 @@
 #define can_callback_free(dev,conn,cb) \
   devif_conn_callback_free(dev, cb, &conn->sconn.list, &conn->sconn.list_tail)
 
+/* Number of hash chains of the CAN_RAW filters of a connection */
+
+#define CAN_FILTER_NHASH 16
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -106,6 +110,14 @@ struct can_conn_s
 #  endif
   struct can_filter filters[CONFIG_NET_CAN_RAW_FILTER_MAX];
   int32_t filter_count;
+
+  /* Lookup tables of the filters, rebuilt by can_filter_update() */
+
+  canid_t filter_mask[CONFIG_NET_CAN_RAW_FILTER_MAX];  /* Distinct masks */
+  uint8_t filter_nmask;                                /* Number of masks */
+  uint8_t filter_ninv;                                 /* Inverted filters */
+  uint8_t filter_hash[CAN_FILTER_NHASH];               /* Index + 1 */
+  uint8_t filter_next[CONFIG_NET_CAN_RAW_FILTER_MAX];  /* Index + 1 */
 #  ifdef CONFIG_NET_CAN_RAW_TX_DEADLINE
   int32_t tx_deadline;
 #  endif
@@ -129,6 +141,12 @@ extern "C"
 
 EXTERN const struct sock_intf_s g_can_sockif;
 
+#ifdef CONFIG_NET_TIMESTAMP
+/* The controller receive time of the frame in can_input_timestamp() */
+
+EXTERN FAR const struct timespec *g_can_rxtime;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -247,6 +265,68 @@ uint16_t can_datahandler(FAR struct net_driver_s *dev,
 ssize_t can_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags);
 
+/****************************************************************************
+ * Name: can_recvmmsg
+ *
+ * Description:
+ *   Receive up to 'vlen' CAN frames from a socket while holding the
+ *   network lock once.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Receive info and buffers, msg_len is set for each frame
+ *   vlen     The number of entries in msgvec
+ *   flags    Receive flags
+ *   timeout  Checked after each frame, or NULL
+ *
+ * Returned Value:
+ *   The number of frames received, or a negated errno value if none was.
+ *
+ ****************************************************************************/
+
+int can_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                 unsigned int vlen, int flags,
+                 FAR struct timespec *timeout);
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+/****************************************************************************
+ * Name: can_filter_update
+ *
+ * Description:
+ *   Rebuild the lookup tables of the connection after its CAN_RAW filters
+ *   changed.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection whose filters changed
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void can_filter_update(FAR struct can_conn_s *conn);
+
+/****************************************************************************
+ * Name: can_filter_match
+ *
+ * Description:
+ *   Check a received CAN ID against the CAN_RAW filters of the connection.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection to deliver the frame to
+ *   id   - The CAN ID of the frame
+ *
+ * Returned Value:
+ *   true if any filter accepts the frame.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool can_filter_match(FAR struct can_conn_s *conn, canid_t id);
+#endif
+
 /****************************************************************************
  * Name: can_poll
  *
@@ -26,6 +26,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_CAN)
 
 #include <stdint.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <nuttx/net/netconfig.h>
@@ -94,6 +95,43 @@ can_data_event(FAR struct net_driver_s *dev, FAR struct can_conn_s *conn,
   return ret;
 }
 
+#ifdef CONFIG_NET_TIMESTAMP
+/****************************************************************************
+ * Name: can_timestamp
+ *
+ * Description:
+ *   Store the receive time of the frame ahead of its data, where both the
+ *   receive handler and the read-ahead path pick it up.
+ *
+ * Returned Value:
+ *   The size of the timestamp, or a negated errno value if it did not fit.
+ *
+ ****************************************************************************/
+
+static int can_timestamp(FAR struct net_driver_s *dev)
+{
+  struct timeval tv;
+  FAR struct timespec *ts = (FAR struct timespec *)&tv;
+  int len;
+
+  if (g_can_rxtime != NULL)
+    {
+      tv.tv_sec  = g_can_rxtime->tv_sec;
+      tv.tv_usec = g_can_rxtime->tv_nsec / 1000;
+    }
+  else
+    {
+      clock_systime_timespec(ts);
+      tv.tv_usec = ts->tv_nsec / 1000;
+    }
+
+  len = iob_trycopyin(dev->d_iob, (FAR uint8_t *)&tv,
+                      sizeof(struct timeval),
+                      -CONFIG_NET_LL_GUARDSIZE, false);
+  return len == sizeof(struct timeval) ? len : -ENOMEM;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -119,6 +157,24 @@ uint16_t can_callback(FAR struct net_driver_s *dev,
 
   if (conn)
     {
+#ifdef CONFIG_NET_TIMESTAMP
+      /* TIMESTAMP sockopt is activated, create timestamp and copy to iob
+       * before any receiver looks at the frame.
+       */
+
+      int tslen = 0;
+
+      if (conn->timestamp)
+        {
+          tslen = can_timestamp(dev);
+          if (tslen < 0)
+            {
+              dev->d_len = 0;
+              return flags & ~CAN_NEWDATA;
+            }
+        }
+#endif
+
       /* Try to lock the network when successful send data to the listener */
 
       if (net_trylock() == OK)
@@ -134,34 +190,9 @@ uint16_t can_callback(FAR struct net_driver_s *dev,
       if ((flags & CAN_NEWDATA) != 0)
         {
 #ifdef CONFIG_NET_TIMESTAMP
-          /* TIMESTAMP sockopt is activated,
-           * create timestamp and copy to iob
-           */
-
-          if (conn->timestamp)
-            {
-              struct timeval tv;
-              FAR struct timespec *ts = (FAR struct timespec *)&tv;
-              int len;
-
-              clock_systime_timespec(ts);
-              tv.tv_usec = ts->tv_nsec / 1000;
-
-              len = iob_trycopyin(dev->d_iob, (FAR uint8_t *)&tv,
-                                  sizeof(struct timeval),
-                                  -CONFIG_NET_LL_GUARDSIZE, false);
-              if (len != sizeof(struct timeval))
-                {
-                  dev->d_len = 0;
-                  return flags & ~CAN_NEWDATA;
-                }
-              else
-                {
-                  dev->d_len += len;
-                }
-            }
-
+          dev->d_len += tslen;
 #endif
+
           /* Data was not handled.. dispose of it appropriately */
 
           flags = can_data_event(dev, conn, flags);
@@ -0,0 +1,170 @@
+/****************************************************************************
+ * net/can/can_filter.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_CAN) && \
+    defined(CONFIG_NET_CANPROTO_OPTIONS)
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "can/can.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_filter_hash
+ *
+ * Description:
+ *   Return the hash chain of the masked CAN ID of a frame or filter.
+ *
+ ****************************************************************************/
+
+static inline unsigned int can_filter_hash(canid_t key)
+{
+  return (key ^ (key >> 11) ^ (key >> 22)) % CAN_FILTER_NHASH;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_filter_update
+ *
+ * Description:
+ *   Rebuild the lookup tables of the connection after its CAN_RAW filters
+ *   changed.  The filters that are not inverted are grouped by mask and
+ *   chained by masked CAN ID, so that a frame is matched with one lookup
+ *   per distinct mask instead of comparing it with every filter.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection whose filters changed
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void can_filter_update(FAR struct can_conn_s *conn)
+{
+  FAR struct can_filter *filter;
+  unsigned int hash;
+  int i;
+  int j;
+
+  memset(conn->filter_hash, 0, sizeof(conn->filter_hash));
+  conn->filter_nmask = 0;
+  conn->filter_ninv  = 0;
+
+  /* Chain backwards so each chain keeps the order of the filters */
+
+  for (i = conn->filter_count - 1; i >= 0; i--)
+    {
+      filter = &conn->filters[i];
+      if ((filter->can_id & CAN_INV_FILTER) != 0)
+        {
+          conn->filter_ninv++;
+          continue;
+        }
+
+      for (j = 0; j < conn->filter_nmask; j++)
+        {
+          if (conn->filter_mask[j] == filter->can_mask)
+            {
+              break;
+            }
+        }
+
+      if (j == conn->filter_nmask)
+        {
+          conn->filter_mask[conn->filter_nmask++] = filter->can_mask;
+        }
+
+      hash = can_filter_hash(filter->can_id & filter->can_mask);
+      conn->filter_next[i]    = conn->filter_hash[hash];
+      conn->filter_hash[hash] = i + 1;
+    }
+}
+
+/****************************************************************************
+ * Name: can_filter_match
+ *
+ * Description:
+ *   Check a received CAN ID against the CAN_RAW filters of the connection.
+ *
+ * Input Parameters:
+ *   conn - The CAN connection to deliver the frame to
+ *   id   - The CAN ID of the frame
+ *
+ * Returned Value:
+ *   true if any filter accepts the frame.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool can_filter_match(FAR struct can_conn_s *conn, canid_t id)
+{
+  FAR struct can_filter *filter;
+  canid_t mask;
+  int i;
+  int j;
+
+  for (j = 0; j < conn->filter_nmask; j++)
+    {
+      mask = conn->filter_mask[j];
+
+      for (i = conn->filter_hash[can_filter_hash(id & mask)]; i > 0;
+           i = conn->filter_next[i - 1])
+        {
+          filter = &conn->filters[i - 1];
+          if (filter->can_mask == mask &&
+              (filter->can_id & mask) == (id & mask))
+            {
+              return true;
+            }
+        }
+    }
+
+  /* The inverted filters match any frame but the ones they name */
+
+  for (i = 0; conn->filter_ninv > 0 && i < conn->filter_count; i++)
+    {
+      filter = &conn->filters[i];
+      if ((filter->can_id & CAN_INV_FILTER) != 0 &&
+          (id & filter->can_mask) !=
+          (filter->can_id & ~CAN_INV_FILTER & filter->can_mask))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_CAN && CONFIG_NET_CANPROTO_OPTIONS */
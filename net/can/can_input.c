@@ -27,6 +27,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_CAN)
 
 #include <errno.h>
+#include <string.h>
 #include <debug.h>
 
 #include <nuttx/net/netdev.h>
@@ -39,6 +40,10 @@
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TIMESTAMP
+FAR const struct timespec *g_can_rxtime;
+#endif
+
 const uint8_t can_dlc_to_len[16] =
 {
     0,
@@ -165,6 +170,31 @@ static int can_in(struct net_driver_s *dev)
         {
           uint16_t flags;
 
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+          canid_t can_id;
+
+          /* Drop the frames the socket filters out before they take a
+           * read-ahead buffer.
+           */
+
+          memcpy(&can_id, dev->d_buf, sizeof(canid_t));
+          if (!can_filter_match(conn, can_id))
+            {
+              continue;
+            }
+#endif
+
+          /* Do not pass frames with DLC > 8 to a legacy socket */
+
+#if defined(CONFIG_NET_CANPROTO_OPTIONS) && defined(CONFIG_NET_CAN_CANFD)
+          if (!conn->fd_frames && buflen > sizeof(struct can_frame))
+#else
+          if (buflen > sizeof(struct can_frame))
+#endif
+            {
+              continue;
+            }
+
           /* Setup for the application callback */
 
           dev->d_appdata = dev->d_buf;
@@ -239,4 +269,36 @@ int can_input(FAR struct net_driver_s *dev)
   return netdev_input(dev, can_in, false);
 }
 
+#ifdef CONFIG_NET_TIMESTAMP
+/****************************************************************************
+ * Name: can_input_timestamp
+ *
+ * Description:
+ *   Handle incoming packet input stamped by the controller
+ *
+ * Input Parameters:
+ *   dev - The device driver structure containing the received packet
+ *   ts  - The receive time of the frame
+ *
+ * Returned Value:
+ *   The same as can_input().
+ *
+ * Assumptions:
+ *   Called from the CAN device diver with the network locked.
+ *
+ ****************************************************************************/
+
+int can_input_timestamp(FAR struct net_driver_s *dev,
+                        FAR const struct timespec *ts)
+{
+  int ret;
+
+  g_can_rxtime = ts;
+  ret = can_input(dev);
+  g_can_rxtime = NULL;
+
+  return ret;
+}
+#endif
+
 #endif /* CONFIG_NET && CONFIG_NET_CAN */
@@ -297,42 +297,10 @@ static inline int can_readahead(struct can_recvfrom_s *pstate)
   return 0;
 }
 
-#ifdef CONFIG_NET_CANPROTO_OPTIONS
-static int can_recv_filter(struct can_conn_s *conn, canid_t id)
-{
-  uint32_t i;
-  for (i = 0; i < conn->filter_count; i++)
-    {
-      if (conn->filters[i].can_id & CAN_INV_FILTER)
-        {
-          if ((id & conn->filters[i].can_mask) !=
-                ((conn->filters[i].can_id & ~CAN_INV_FILTER) &
-                conn->filters[i].can_mask))
-            {
-              return 1;
-            }
-        }
-      else
-        {
-          if ((id & conn->filters[i].can_mask) ==
-                (conn->filters[i].can_id & conn->filters[i].can_mask))
-            {
-              return 1;
-            }
-        }
-    }
-
-  return 0;
-}
-#endif
-
 static uint16_t can_recvfrom_eventhandler(FAR struct net_driver_s *dev,
                                           FAR void *pvpriv, uint16_t flags)
 {
   struct can_recvfrom_s *pstate = pvpriv;
-#if defined(CONFIG_NET_CANPROTO_OPTIONS) || defined(CONFIG_NET_TIMESTAMP)
-  struct can_conn_s *conn = pstate->pr_conn;
-#endif
 
   /* 'priv' might be null in some race conditions (?) */
 
@@ -340,41 +308,6 @@ static uint16_t can_recvfrom_eventhandler(FAR struct net_driver_s *dev,
     {
       if ((flags & CAN_NEWDATA) != 0)
         {
-          /* If a new packet is available, check receive filters
-           * when is valid then complete the read action.
-           */
-#ifdef CONFIG_NET_CANPROTO_OPTIONS
-          canid_t can_id;
-          memcpy(&can_id, dev->d_appdata, sizeof(canid_t));
-
-          if (can_recv_filter(conn, can_id) == 0)
-            {
-              flags &= ~CAN_NEWDATA;
-              return flags;
-            }
-#endif
-
-          /* do not pass frames with DLC > 8 to a legacy socket */
-#if defined(CONFIG_NET_CANPROTO_OPTIONS) && defined(CONFIG_NET_CAN_CANFD)
-          if (!conn->fd_frames)
-#endif
-            {
-#ifdef CONFIG_NET_TIMESTAMP
-              if ((conn->timestamp && (dev->d_len >
-                  sizeof(struct can_frame) + sizeof(struct timeval)))
-                  || (!conn->timestamp && (dev->d_len >
-                   sizeof(struct can_frame))))
-#else
-              if (dev->d_len > sizeof(struct can_frame))
-#endif
-                {
-                  /* DO WE NEED TO CLEAR FLAGS?? */
-
-                  flags &= ~CAN_NEWDATA;
-                  return flags;
-                }
-            }
-
           /* Copy the packet */
 
           can_newdata(dev, pstate);
@@ -577,4 +510,90 @@ errout_with_state:
   return ret;
 }
 
+/****************************************************************************
+ * Name: can_recvmmsg
+ *
+ * Description:
+ *   Receive up to 'vlen' CAN frames while holding the network lock once,
+ *   so that a burst of frames is drained from the read-ahead queue without
+ *   a lock round trip and a system call per frame.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Receive info and buffers, msg_len is set for each frame
+ *   vlen     The number of entries in msgvec
+ *   flags    Receive flags
+ *   timeout  Checked after each frame, or NULL
+ *
+ * Returned Value:
+ *   The number of frames received, or a negated errno value if none was.
+ *
+ ****************************************************************************/
+
+int can_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                 unsigned int vlen, int flags,
+                 FAR struct timespec *timeout)
+{
+  FAR struct msghdr *msg;
+  unsigned long msg_controllen;
+  FAR void *msg_control;
+  sclock_t ticks = 0;
+  clock_t start;
+  unsigned int i;
+  ssize_t ret = OK;
+
+  if (timeout != NULL)
+    {
+      clock_time2ticks(timeout, &ticks);
+    }
+
+  /* can_recvmsg() only takes the lock recursively, a wait for a frame
+   * still releases it.
+   */
+
+  net_lock();
+  start = clock_systime_ticks();
+
+  for (i = 0; i < vlen; i++)
+    {
+      msg            = &msgvec[i].msg_hdr;
+      msg_control    = msg->msg_control;
+      msg_controllen = msg->msg_controllen;
+
+      ret = can_recvmsg(psock, msg, flags);
+
+      /* Recover the pointer and calculate the cmsg's true data length, as
+       * psock_recvmsg() does.
+       */
+
+      msg->msg_control    = msg_control;
+      msg->msg_controllen = msg_controllen - msg->msg_controllen;
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL &&
+          (sclock_t)(clock_systime_ticks() - start) >= ticks)
+        {
+          i++;
+          break;
+        }
+    }
+
+  net_unlock();
+
+  /* An error after some frames is reported by the next call */
+
+  return i > 0 ? (int)i : (int)ret;
+}
+
 #endif /* CONFIG_NET_CAN */
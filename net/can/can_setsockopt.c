@@ -123,7 +123,10 @@ int can_setsockopt(FAR struct socket *psock, int level, int option,
       case CAN_RAW_FILTER:
         if (value_len == 0)
           {
+            net_lock();
             conn->filter_count = 0;
+            can_filter_update(conn);
+            net_unlock();
             ret = OK;
           }
         else if (value_len % sizeof(struct can_filter) != 0)
@@ -141,12 +144,19 @@ int can_setsockopt(FAR struct socket *psock, int level, int option,
 
             count = value_len / sizeof(struct can_filter);
 
+            /* Swap the filters and their lookup tables in one go, as the
+             * receive path matches frames against them.
+             */
+
+            net_lock();
             for (i = 0; i < count; i++)
               {
                 conn->filters[i] = ((struct can_filter *)value)[i];
               }
 
             conn->filter_count = count;
+            can_filter_update(conn);
+            net_unlock();
 
             ret = OK;
           }
@@ -79,10 +79,20 @@ const struct sock_intf_s g_can_sockif =
   NULL,             /* si_ioctl */
   NULL,             /* si_socketpair */
   NULL              /* si_shutdown */
-#if defined(CONFIG_NET_SOCKOPTS) && defined(CONFIG_NET_CANPROTO_OPTIONS)
+#ifdef CONFIG_NET_SOCKOPTS
+#  ifdef CONFIG_NET_CANPROTO_OPTIONS
   , can_getsockopt  /* si_getsockopt */
   , can_setsockopt  /* si_setsockopt */
+#  else
+  , NULL            /* si_getsockopt */
+  , NULL            /* si_setsockopt */
+#  endif
 #endif
+#ifdef CONFIG_NET_SENDFILE
+  , NULL            /* si_sendfile */
+#endif
+  , can_recvmmsg    /* si_recvmmsg */
+  , NULL            /* si_sendmmsg */
 };
 
 /****************************************************************************
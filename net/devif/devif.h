@@ -621,6 +621,30 @@ int netdev_input(FAR struct net_driver_s *dev,
 
 uint16_t devif_get_mtu(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: devif_pend, devif_unpend and devif_pend_flush
+ *
+ * Description:
+ *   Maintain the per-device queues of the TCP and UDP connections with
+ *   pending TX.  devif_pend() adds a connection at the end of a queue (or
+ *   moves it there), devif_unpend() removes it and devif_pend_flush()
+ *   empties both queues of a device.
+ *
+ * Assumptions:
+ *   These functions must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_POLL_PENDING
+void devif_pend(FAR dq_queue_t *queue, FAR struct socket_conn_s *sconn);
+void devif_unpend(FAR struct socket_conn_s *sconn);
+void devif_pend_flush(FAR struct net_driver_s *dev);
+#else
+#  define devif_pend(queue, sconn)
+#  define devif_unpend(sconn)
+#  define devif_pend_flush(dev)
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,123 @@
+/****************************************************************************
+ * net/devif/devif_pend.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "devif/devif.h"
+
+#ifdef CONFIG_NETDEV_POLL_PENDING
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_pend
+ *
+ * Description:
+ *   Add the connection at the end of the queue of connections with pending
+ *   TX of a device.  A connection already in a queue is moved.
+ *
+ * Input Parameters:
+ *   queue - The pending queue of the device, d_tcppend or d_udppend
+ *   sconn - The connection with something to send
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+void devif_pend(FAR dq_queue_t *queue, FAR struct socket_conn_s *sconn)
+{
+  DEBUGASSERT(queue != NULL && sconn != NULL);
+
+  if (sconn->pqueue != NULL)
+    {
+      dq_rem(&sconn->pnode, sconn->pqueue);
+    }
+
+  dq_addlast(&sconn->pnode, queue);
+  sconn->pqueue = queue;
+}
+
+/****************************************************************************
+ * Name: devif_unpend
+ *
+ * Description:
+ *   Remove the connection from the pending queue it is in, if any.
+ *
+ * Input Parameters:
+ *   sconn - The connection with nothing more to send
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+void devif_unpend(FAR struct socket_conn_s *sconn)
+{
+  if (sconn->pqueue != NULL)
+    {
+      dq_rem(&sconn->pnode, sconn->pqueue);
+      sconn->pqueue = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: devif_pend_flush
+ *
+ * Description:
+ *   Empty the pending queues of a device which is going away.
+ *
+ * Input Parameters:
+ *   dev - The device
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+void devif_pend_flush(FAR struct net_driver_s *dev)
+{
+  FAR dq_entry_t *node;
+
+  while ((node = dq_peek(&dev->d_tcppend)) != NULL)
+    {
+      devif_unpend(container_of(node, struct socket_conn_s, pnode));
+    }
+
+  while ((node = dq_peek(&dev->d_udppend)) != NULL)
+    {
+      devif_unpend(container_of(node, struct socket_conn_s, pnode));
+    }
+}
+
+#endif /* CONFIG_NETDEV_POLL_PENDING */
@@ -28,6 +28,7 @@
 #include <debug.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/net.h>
@@ -45,6 +46,7 @@
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
 #include "mld/mld.h"
+#include "neighbor/neighbor.h"
 #include "ipforward/ipforward.h"
 #include "sixlowpan/sixlowpan.h"
 #include "ipfrag/ipfrag.h"
@@ -558,7 +560,42 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
 {
   FAR struct udp_conn_s *conn = NULL;
   int bstop = 0;
+#ifdef CONFIG_NETDEV_POLL_PENDING
+  FAR dq_entry_t *node;
+  size_t count;
 
+  /* Visit each connection with pending TX once.  Those that produced a
+   * packet go to the end of the queue so that the next poll starts with
+   * another one; the others have nothing more to send.
+   */
+
+  count = dq_count(&dev->d_udppend);
+  while (!bstop && count-- > 0 &&
+         (node = dq_peek(&dev->d_udppend)) != NULL)
+    {
+      conn = (FAR struct udp_conn_s *)
+             container_of(node, struct socket_conn_s, pnode);
+
+      udp_poll(dev, conn);
+
+      if (conn->sconn.pqueue == &dev->d_udppend)
+        {
+          if (dev->d_len > 0 || dev->d_iob == NULL)
+            {
+              devif_pend(&dev->d_udppend, &conn->sconn);
+            }
+          else
+            {
+              devif_unpend(&conn->sconn);
+            }
+        }
+
+      devif_packet_conversion(dev, DEVIF_UDP);
+      bstop = devif_poll_out(dev, callback);
+    }
+
+  return bstop;
+#else
   /* Traverse all of the allocated UDP connections and perform the poll
    * action.
    */
@@ -586,6 +623,7 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
     }
 
   return bstop;
+#endif
 }
 #endif /* NET_UDP_HAVE_STACK */
 
@@ -607,7 +645,49 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
 {
   FAR struct tcp_conn_s *conn  = NULL;
   int bstop = 0;
+#ifdef CONFIG_NETDEV_POLL_PENDING
+  FAR dq_entry_t *node;
+  size_t count;
+
+  /* Visit each connection with pending TX once, as for UDP.  An expired
+   * timer keeps the connection in the queue until it has been handled.
+   */
 
+  count = dq_count(&dev->d_tcppend);
+  while (!bstop && count-- > 0 &&
+         (node = dq_peek(&dev->d_tcppend)) != NULL)
+    {
+      conn = (FAR struct tcp_conn_s *)
+             container_of(node, struct socket_conn_s, pnode);
+
+      if (dev != conn->dev)
+        {
+          devif_unpend(&conn->sconn);
+          continue;
+        }
+
+      tcp_poll(dev, conn);
+
+      /* The poll may have freed the connection */
+
+      if (conn->sconn.pqueue == &dev->d_tcppend)
+        {
+          if (dev->d_len > 0 || dev->d_iob == NULL || conn->timeout)
+            {
+              devif_pend(&dev->d_tcppend, &conn->sconn);
+            }
+          else
+            {
+              devif_unpend(&conn->sconn);
+            }
+        }
+
+      devif_packet_conversion(dev, DEVIF_TCP);
+      bstop = devif_poll_out(dev, callback);
+    }
+
+  return bstop;
+#else
   /* Traverse all of the active TCP connections and perform the poll action */
 
   while (!bstop && (conn = tcp_nextconn(conn)))
@@ -631,6 +711,7 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
     }
 
   return bstop;
+#endif
 }
 #else
 #  define devif_poll_tcp_connections(dev, callback) (0)
@@ -765,6 +846,30 @@ static int devif_poll_connections(FAR struct net_driver_s *dev,
 
   if (!bstop)
 #endif
+#ifdef CONFIG_NET_ARP
+    {
+      /* Check for the ARP table entries to confirm */
+
+      if (arp_probe(dev))
+        {
+          bstop = devif_poll_out(dev, callback);
+        }
+    }
+
+  if (!bstop)
+#endif
+#ifdef CONFIG_NET_IPv6
+    {
+      /* Check for the Neighbor Table entries to confirm */
+
+      if (neighbor_probe(dev))
+        {
+          bstop = devif_poll_out(dev, callback);
+        }
+    }
+
+  if (!bstop)
+#endif
 #ifdef CONFIG_NET_PKT
     {
       /* Check for pending packet socket transfer */
@@ -1134,6 +1239,9 @@ int devif_poll_out(FAR struct net_driver_s *dev,
 
   if (dev->d_len == 0)
     {
+#ifdef CONFIG_NETDEV_OFFLOAD
+      dev->d_gsosize = 0;
+#endif
       return 0;
     }
 
@@ -1159,7 +1267,11 @@ int devif_poll_out(FAR struct net_driver_s *dev,
         }
 #endif
 
-      return callback(dev);
+      bstop = callback(dev);
+#ifdef CONFIG_NETDEV_OFFLOAD
+      dev->d_gsosize = 0;
+#endif
+      return bstop;
     }
 
   return 0;
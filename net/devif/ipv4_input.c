@@ -105,6 +105,7 @@
 #include "ipforward/ipforward.h"
 #include "devif/devif.h"
 #include "nat/nat.h"
+#include "netfilter/iptables.h"
 #include "ipfrag/ipfrag.h"
 #include "utils/utils.h"
 
@@ -269,6 +270,14 @@ static int ipv4_in(FAR struct net_driver_s *dev)
       if (dev->d_len > 0)
 #endif
         {
+#ifdef CONFIG_NET_IPTABLES_FILTER
+          if (ipt_filter_ipv4(NF_INET_LOCAL_IN, dev, NULL, ipv4) !=
+              NF_ACCEPT)
+            {
+              goto drop;
+            }
+#endif
+
           ret = udp_ipv4_input(dev);
         }
 
@@ -297,6 +306,14 @@ static int ipv4_in(FAR struct net_driver_s *dev)
       if (dev->d_len > 0)
 #endif
         {
+#ifdef CONFIG_NET_IPTABLES_FILTER
+          if (ipt_filter_ipv4(NF_INET_LOCAL_IN, dev, NULL, ipv4) !=
+              NF_ACCEPT)
+            {
+              goto drop;
+            }
+#endif
+
           ret = udp_ipv4_input(dev);
         }
 
@@ -396,6 +413,17 @@ static int ipv4_in(FAR struct net_driver_s *dev)
       goto drop;
     }
 
+#ifdef CONFIG_NET_IPTABLES_FILTER
+  if (ipt_filter_ipv4(NF_INET_LOCAL_IN, dev, NULL, ipv4) != NF_ACCEPT)
+    {
+      ninfo("Dropped by the filter rules\n");
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv4.drop++;
+#endif
+      goto drop;
+    }
+#endif
+
   /* Now process the incoming packet according to the protocol. */
 
   switch (ipv4->proto)
@@ -88,6 +88,12 @@ static ssize_t    inet_sendmsg(FAR struct socket *psock,
                     FAR struct msghdr *msg, int flags);
 static ssize_t    inet_recvmsg(FAR struct socket *psock,
                     FAR struct msghdr *msg, int flags);
+static int        inet_recvmmsg(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags, FAR struct timespec *timeout);
+static int        inet_sendmmsg(FAR struct socket *psock,
+                    FAR struct mmsghdr *msgvec, unsigned int vlen,
+                    int flags);
 static int        inet_ioctl(FAR struct socket *psock,
                     int cmd, unsigned long arg);
 static int        inet_socketpair(FAR struct socket *psocks[2]);
@@ -133,6 +139,8 @@ static const struct sock_intf_s g_inet_sockif =
 #ifdef CONFIG_NET_SENDFILE
   , inet_sendfile   /* si_sendfile */
 #endif
+  , inet_recvmmsg   /* si_recvmmsg */
+  , inet_sendmmsg   /* si_sendmmsg */
 };
 
 /****************************************************************************
@@ -794,6 +802,11 @@ static int inet_getsockopt(FAR struct socket *psock, int level, int option,
         return tcp_getsockopt(psock, option, value, value_len);
 #endif
 
+#ifdef CONFIG_NET_UDPPROTO_OPTIONS
+      case IPPROTO_UDP:
+        return udp_getsockopt(psock, option, value, value_len);
+#endif
+
 #ifdef CONFIG_NET_IPv4
       case IPPROTO_IP:/* IPv4 protocol socket options (see include/netinet/in.h) */
         return ipv4_getsockopt(psock, option, value, value_len);
@@ -943,6 +956,7 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
               /* Save the receive buffer size */
 
               tcp->rcv_bufs = buffersize;
+              tcp->flags   |= TCP_RCVBUF_LOCK;
             }
           else
 #endif
@@ -1004,6 +1018,7 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
               /* Save the send buffer size */
 
               tcp->snd_bufs = buffersize;
+              tcp->flags   |= TCP_SNDBUF_LOCK;
             }
           else
 #endif
@@ -1767,35 +1782,19 @@ static ssize_t inet_send(FAR struct socket *psock, FAR const void *buf,
 }
 
 /****************************************************************************
- * Name: inet_sendto
+ * Name: inet_checkaddr
  *
  * Description:
- *   Implements the sendto() operation for the case of the AF_INET and
- *   AF_INET6 sockets.
- *
- * Input Parameters:
- *   psock    A pointer to a NuttX-specific, internal socket structure
- *   buf      Data to send
- *   len      Length of data to send
- *   flags    Send flags
- *   to       Address of recipient
- *   tolen    The length of the address structure
+ *   Verify that a valid destination address has been provided.
  *
  * Returned Value:
- *   On success, returns the number of characters sent.  On  error, a negated
- *   errno value is returned (see send_to() for the list of appropriate error
- *   values.
+ *   The minimum length of the address family, or a negated errno value.
  *
  ****************************************************************************/
 
-static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
-                           size_t len, int flags,
-                           FAR const struct sockaddr *to, socklen_t tolen)
+static int inet_checkaddr(FAR const struct sockaddr *to, socklen_t tolen)
 {
   socklen_t minlen;
-  ssize_t nsent;
-
-  /* Verify that a valid address has been provided */
 
   switch (to->sa_family)
     {
@@ -1822,6 +1821,46 @@ static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
       return -EBADF;
     }
 
+  return minlen;
+}
+
+/****************************************************************************
+ * Name: inet_sendto
+ *
+ * Description:
+ *   Implements the sendto() operation for the case of the AF_INET and
+ *   AF_INET6 sockets.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags
+ *   to       Address of recipient
+ *   tolen    The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of characters sent.  On  error, a negated
+ *   errno value is returned (see send_to() for the list of appropriate error
+ *   values.
+ *
+ ****************************************************************************/
+
+static ssize_t inet_sendto(FAR struct socket *psock, FAR const void *buf,
+                           size_t len, int flags,
+                           FAR const struct sockaddr *to, socklen_t tolen)
+{
+  ssize_t nsent;
+  int minlen;
+
+  /* Verify that a valid address has been provided */
+
+  minlen = inet_checkaddr(to, tolen);
+  if (minlen < 0)
+    {
+      return minlen;
+    }
+
 #ifdef CONFIG_NET_UDP
   /* If this is a connected socket, then return EISCONN */
 
@@ -2256,6 +2295,14 @@ static ssize_t inet_recvmsg(FAR struct socket *psock,
 #ifdef CONFIG_NET_TCP
     case SOCK_STREAM:
       {
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+        if ((flags & MSG_ERRQUEUE) != 0)
+          {
+            ret = tcp_zerocopy_recverr(psock->s_conn, msg);
+            break;
+          }
+#endif
+
 #ifdef NET_TCP_HAVE_STACK
         ret = psock_tcp_recvfrom(psock, msg, flags);
 #else
@@ -2297,6 +2344,142 @@ static ssize_t inet_recvmsg(FAR struct socket *psock,
   return ret;
 }
 
+/****************************************************************************
+ * Name: inet_recvmmsg
+ *
+ * Description:
+ *   Implements the recvmmsg() interface for the case of the AF_INET and
+ *   AF_INET6 address families.  UDP sockets receive the whole batch under
+ *   a single network lock, other sockets return -ENOSYS to receive one
+ *   message at a time.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  - The messages to receive
+ *   vlen    - The number of messages in msgvec
+ *   flags   - Receive flags
+ *   timeout - Checked after each message, or NULL
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  Otherwise, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+static int inet_recvmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec, unsigned int vlen,
+                         int flags, FAR struct timespec *timeout)
+{
+#ifdef NET_UDP_HAVE_STACK
+  FAR struct msghdr *msg;
+  socklen_t minlen;
+  unsigned int i;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      return -ENOSYS;
+    }
+
+  /* Verify that the 'from' addresses are large enough, as inet_recvmsg()
+   * does.  The batch stops before the first bad one.
+   */
+
+  minlen = psock->s_domain == PF_INET ? sizeof(struct sockaddr_in) :
+                                        sizeof(struct sockaddr_in6);
+  for (i = 0; i < vlen; i++)
+    {
+      msg = &msgvec[i].msg_hdr;
+      if (msg->msg_name != NULL && msg->msg_namelen < minlen)
+        {
+          break;
+        }
+    }
+
+  if (i == 0)
+    {
+      return -EINVAL;
+    }
+
+  return psock_udp_recvmmsg(psock, msgvec, i, flags, timeout);
+#else
+  return -ENOSYS;
+#endif
+}
+
+/****************************************************************************
+ * Name: inet_sendmmsg
+ *
+ * Description:
+ *   Implements the sendmmsg() interface for the case of the AF_INET and
+ *   AF_INET6 address families.  Buffered UDP sockets queue the whole batch
+ *   under a single network lock, other sockets return -ENOSYS to send one
+ *   message at a time.
+ *
+ * Input Parameters:
+ *   psock   - A pointer to a NuttX-specific, internal socket structure
+ *   msgvec  - The messages to send
+ *   vlen    - The number of messages in msgvec
+ *   flags   - Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  Otherwise, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+static int inet_sendmmsg(FAR struct socket *psock,
+                         FAR struct mmsghdr *msgvec, unsigned int vlen,
+                         int flags)
+{
+#if defined(NET_UDP_HAVE_STACK) && defined(CONFIG_NET_UDP_WRITE_BUFFERS) && \
+    !defined(CONFIG_NET_6LOWPAN)
+  FAR struct msghdr *msg;
+  unsigned int i;
+  int ret = OK;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      return -ENOSYS;
+    }
+
+  /* Gathering several blocks is left to inet_sendmsg() */
+
+  for (i = 0; i < vlen; i++)
+    {
+      if (msgvec[i].msg_hdr.msg_iovlen != 1)
+        {
+          return -ENOSYS;
+        }
+    }
+
+  /* Verify the destination addresses as inet_sendto() does.  The batch
+   * stops before the first bad one.
+   */
+
+  for (i = 0; i < vlen; i++)
+    {
+      msg = &msgvec[i].msg_hdr;
+      if (msg->msg_name != NULL)
+        {
+          ret = inet_checkaddr(msg->msg_name, msg->msg_namelen);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+    }
+
+  if (i == 0)
+    {
+      return ret;
+    }
+
+  return psock_udp_sendmmsg(psock, msgvec, i, flags);
+#else
+  return -ENOSYS;
+#endif
+}
+
 #endif /* NET_UDP_HAVE_STACK || NET_TCP_HAVE_STACK */
 
 /****************************************************************************
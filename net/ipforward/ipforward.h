@@ -297,6 +297,47 @@ void ipfwd_dropstats(FAR struct forward_s *fwd);
 int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4);
 #endif
 
+/****************************************************************************
+ * Name: ipv4_forward_fast
+ *
+ * Description:
+ *   Forward a packet of a known flow from the RX context: the flow cache
+ *   provides the forwarding device and the link layer header, and the
+ *   packet is handed to the d_xmit() method of the device.
+ *
+ * Input Parameters:
+ *   dev   - The device on which the packet was received and which contains
+ *           the IPv4 packet.
+ *   ipv4  - A convenience pointer to the IPv4 header in within the IPv4
+ *           packet
+ *
+ * Returned Value:
+ *   Zero is returned if the packet was forwarded.  -ENOENT is returned,
+ *   the packet untouched, if it must take the normal forwarding path.  Any
+ *   other negated errno value means that the packet must be dropped.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+int ipv4_forward_fast(FAR struct net_driver_s *dev,
+                      FAR struct ipv4_hdr_s *ipv4);
+#endif
+
+/****************************************************************************
+ * Name: ipv4_forward_flush
+ *
+ * Description:
+ *   Forget the flows received or forwarded on a device.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+void ipv4_forward_flush(FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: ipv6_forward
  *
@@ -0,0 +1,406 @@
+/****************************************************************************
+ * net/ipforward/ipv4_fastpath.c
+ * IPv4 forwarding of known flows from the RX context
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/ip.h>
+
+#include "netdev/netdev.h"
+#include "utils/utils.h"
+#include "arp/arp.h"
+#include "route/route.h"
+#include "ipforward/ipforward.h"
+#include "nat/nat.h"
+#include "netfilter/iptables.h"
+
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_NET_IPFORWARD_NFLOWS & (CONFIG_NET_IPFORWARD_NFLOWS - 1)) != 0
+#  error CONFIG_NET_IPFORWARD_NFLOWS must be a power of two
+#endif
+
+#define IPv4_FLOWTIME MSEC2TICK(CONFIG_NET_IPFORWARD_FLOWTIME)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The 5-tuple of a flow and the device it is received on */
+
+struct ipv4_flowkey_s
+{
+  FAR struct net_driver_s *fk_dev;     /* Receiving device */
+  in_addr_t fk_srcaddr;                /* Source address */
+  in_addr_t fk_destaddr;               /* Destination address */
+  uint16_t  fk_srcport;                /* Source port, if TCP or UDP */
+  uint16_t  fk_destport;               /* Destination port, if TCP or UDP */
+  uint8_t   fk_proto;                  /* L4 protocol */
+};
+
+/* How the packets of a flow are forwarded */
+
+struct ipv4_flow_s
+{
+  struct ipv4_flowkey_s fl_key;        /* The flow */
+  FAR struct net_driver_s *fl_dev;     /* Forwarding device, NULL if unused */
+  clock_t fl_time;                     /* When the flow was resolved */
+  struct eth_hdr_s fl_ethhdr;          /* Header to the next hop */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct ipv4_flow_s g_ipv4_flows[CONFIG_NET_IPFORWARD_NFLOWS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flow_key
+ *
+ * Description:
+ *   Get the key of the flow of a packet and return its hash.
+ *
+ ****************************************************************************/
+
+static unsigned int ipv4_flow_key(FAR struct net_driver_s *dev,
+                                  FAR struct ipv4_hdr_s *ipv4,
+                                  FAR struct ipv4_flowkey_s *key)
+{
+  FAR const uint8_t *bytes = (FAR const uint8_t *)key;
+  uint32_t hash = 2166136261u;
+  uint16_t iphdrlen;
+  size_t i;
+
+  memset(key, 0, sizeof(*key));
+  key->fk_dev      = dev;
+  key->fk_srcaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  key->fk_destaddr = net_ip4addr_conv32(ipv4->destipaddr);
+  key->fk_proto    = ipv4->proto;
+
+  /* Only the first fragment holds the ports, the others are keyed on the
+   * addresses alone.
+   */
+
+  iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+  if ((ipv4->proto == IP_PROTO_TCP || ipv4->proto == IP_PROTO_UDP) &&
+      (ipv4->ipoffset[0] & 0x1f) == 0 && ipv4->ipoffset[1] == 0 &&
+      dev->d_len >= iphdrlen + 4)
+    {
+      FAR uint16_t *ports = (FAR uint16_t *)((FAR uint8_t *)ipv4 +
+                                             iphdrlen);
+
+      key->fk_srcport  = ports[0];
+      key->fk_destport = ports[1];
+    }
+
+  for (i = 0; i < sizeof(*key); i++)
+    {
+      hash = (hash ^ bytes[i]) * 16777619u;
+    }
+
+  return hash & (CONFIG_NET_IPFORWARD_NFLOWS - 1);
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_resolve
+ *
+ * Description:
+ *   Find the forwarding device and the link layer header of a flow, as the
+ *   normal forwarding path and arp_out() do.  Only unicast flows to an
+ *   Ethernet device with a known next hop are resolved.
+ *
+ * Returned Value:
+ *   Zero on success, -ENOENT if the flow must take the normal path.
+ *
+ ****************************************************************************/
+
+static int ipv4_flow_resolve(FAR struct ipv4_flow_s *flow,
+                             FAR const struct ipv4_flowkey_s *key)
+{
+  FAR struct net_driver_s *fwddev;
+  in_addr_t destaddr = key->fk_destaddr;
+  in_addr_t nexthop;
+
+  if (IN_MULTICAST(NTOHL(destaddr)) ||
+      net_ipv4addr_cmp(destaddr, INADDR_BROADCAST))
+    {
+      return -ENOENT;
+    }
+
+  fwddev = netdev_findby_ripv4addr(key->fk_srcaddr, destaddr);
+  if (fwddev == NULL || fwddev == key->fk_dev || fwddev->d_xmit == NULL ||
+      (fwddev->d_lltype != NET_LL_ETHERNET &&
+       fwddev->d_lltype != NET_LL_IEEE80211))
+    {
+      return -ENOENT;
+    }
+
+  if (net_ipv4addr_maskcmp(destaddr, fwddev->d_ipaddr, fwddev->d_netmask))
+    {
+      if (net_ipv4addr_broadcast(destaddr, fwddev->d_netmask))
+        {
+          return -ENOENT;
+        }
+
+      nexthop = destaddr;
+    }
+  else
+    {
+#ifdef CONFIG_NET_ROUTE
+      netdev_ipv4_router(fwddev, destaddr, &nexthop);
+#else
+      net_ipv4addr_copy(nexthop, fwddev->d_draddr);
+#endif
+    }
+
+  /* An unknown next hop is resolved by the ARP request of the normal path */
+
+  if (arp_find(nexthop, flow->fl_ethhdr.dest, fwddev) < 0)
+    {
+      return -ENOENT;
+    }
+
+  memcpy(flow->fl_ethhdr.src, fwddev->d_mac.ether.ether_addr_octet,
+         ETHER_ADDR_LEN);
+  flow->fl_ethhdr.type = HTONS(ETHTYPE_IP);
+
+  memcpy(&flow->fl_key, key, sizeof(*key));
+  flow->fl_dev  = fwddev;
+  flow->fl_time = clock_systime_ticks();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_lookup
+ *
+ * Description:
+ *   Return the cached flow of a packet, resolving it if needed.
+ *
+ ****************************************************************************/
+
+static FAR struct ipv4_flow_s *
+ipv4_flow_lookup(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
+{
+  FAR struct ipv4_flow_s *flow;
+  struct ipv4_flowkey_s key;
+
+  flow = &g_ipv4_flows[ipv4_flow_key(dev, ipv4, &key)];
+
+  /* The next hop of a flow may change, it is resolved again from time to
+   * time.
+   */
+
+  if (flow->fl_dev != NULL &&
+      clock_systime_ticks() - flow->fl_time < IPv4_FLOWTIME &&
+      memcmp(&flow->fl_key, &key, sizeof(key)) == 0)
+    {
+      return flow;
+    }
+
+  flow->fl_dev = NULL;
+  return ipv4_flow_resolve(flow, &key) < 0 ? NULL : flow;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_forward_fast
+ *
+ * Description:
+ *   Forward a packet of a known flow from the RX context: the flow cache
+ *   provides the forwarding device and the link layer header, and the
+ *   packet is handed to the d_xmit() method of the device.
+ *
+ * Input Parameters:
+ *   dev   - The device on which the packet was received and which contains
+ *           the IPv4 packet.
+ *   ipv4  - A convenience pointer to the IPv4 header in within the IPv4
+ *           packet
+ *
+ * Returned Value:
+ *   Zero is returned if the packet was forwarded.  -ENOENT is returned,
+ *   the packet untouched, if it must take the normal forwarding path.  Any
+ *   other negated errno value means that the packet must be dropped.
+ *
+ ****************************************************************************/
+
+int ipv4_forward_fast(FAR struct net_driver_s *dev,
+                      FAR struct ipv4_hdr_s *ipv4)
+{
+  FAR struct net_driver_s *fwddev;
+  FAR struct ipv4_flow_s *flow;
+  FAR struct forward_s *fwd;
+  FAR struct iob_s *iob;
+  uint16_t oldttl;
+  uint16_t newttl;
+  int ret;
+
+  /* Expiring packets, packets for the MTU logic and packets of unknown
+   * flows take the normal path, which has the ICMP replies.
+   */
+
+  if (ipv4->ttl <= 1 || dev->d_iob == NULL)
+    {
+      return -ENOENT;
+    }
+
+  flow = ipv4_flow_lookup(dev, ipv4);
+  if (flow == NULL)
+    {
+      return -ENOENT;
+    }
+
+  fwddev = flow->fl_dev;
+  if (!IFF_IS_UP(fwddev->d_flags) || fwddev->d_iob != NULL ||
+      ETH_HDRLEN + dev->d_len > NETDEV_PKTSIZE(fwddev) ||
+      dev->d_iob->io_offset < ETH_HDRLEN)
+    {
+      return -ENOENT;
+    }
+
+#ifdef CONFIG_NET_IPTABLES_FILTER
+  /* The flows are cached whatever the filter rules, which may change */
+
+  if (ipt_filter_ipv4(NF_INET_FORWARD, dev, fwddev, ipv4) != NF_ACCEPT)
+    {
+      return -EPERM;
+    }
+#endif
+
+  /* Decrement the TTL, adjusting the checksum for the new value only */
+
+  memcpy(&oldttl, &ipv4->ttl, sizeof(oldttl));
+  ipv4->ttl--;
+  memcpy(&newttl, &ipv4->ttl, sizeof(newttl));
+  net_chksum_adjust(&ipv4->ipchksum, &oldttl, sizeof(oldttl),
+                    &newttl, sizeof(newttl));
+
+#ifdef CONFIG_NET_NAT
+  ret = ipv4_nat_outbound(fwddev, ipv4, NAT_MANIP_SRC);
+  if (ret < 0)
+    {
+      nwarn("WARNING: Performing NAT outbound failed, dropping!\n");
+      return ret;
+    }
+#endif
+
+  /* Move the frame to the forwarding device, behind the cached link layer
+   * header.
+   */
+
+  iob = dev->d_iob;
+  netdev_iob_clear(dev);
+  netdev_iob_replace(fwddev, iob);
+
+  memcpy((FAR uint8_t *)IOB_DATA(iob) - ETH_HDRLEN, &flow->fl_ethhdr,
+         ETH_HDRLEN);
+  fwddev->d_len   += ETH_HDRLEN;
+  fwddev->d_sndlen = 0;
+#ifdef CONFIG_NET_IPv6
+  IFF_SET_IPv4(fwddev->d_flags);
+#endif
+
+  ret = fwddev->d_xmit(fwddev);
+  if (ret >= 0)
+    {
+      return OK;
+    }
+
+  /* The device is busy, queue the packet for its next TX poll instead */
+
+  netdev_iob_clear(fwddev);
+
+  fwd = ipfwd_alloc();
+  if (fwd != NULL)
+    {
+      fwd->f_dev    = fwddev;
+      fwd->f_iob    = iob;
+#ifdef CONFIG_NET_IPv6
+      fwd->f_domain = PF_INET;
+#endif
+
+      if (ipfwd_forward(fwd) >= 0)
+        {
+          return OK;
+        }
+
+      ipfwd_free(fwd);
+    }
+
+  /* Give the packet back to be dropped */
+
+  netdev_iob_replace(dev, iob);
+  return -ENOMEM;
+}
+
+/****************************************************************************
+ * Name: ipv4_forward_flush
+ *
+ * Description:
+ *   Forget the flows received or forwarded on a device.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipv4_forward_flush(FAR struct net_driver_s *dev)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_IPFORWARD_NFLOWS; i++)
+    {
+      FAR struct ipv4_flow_s *flow = &g_ipv4_flows[i];
+
+      if (flow->fl_dev == dev || flow->fl_key.fk_dev == dev)
+        {
+          flow->fl_dev = NULL;
+        }
+    }
+}
+
+#endif /* CONFIG_NET_IPFORWARD_FASTPATH */
@@ -40,6 +40,7 @@
 #include "icmp/icmp.h"
 #include "ipforward/ipforward.h"
 #include "nat/nat.h"
+#include "netfilter/iptables.h"
 #include "devif/devif.h"
 
 #if defined(CONFIG_NET_IPFORWARD) && defined(CONFIG_NET_IPv4)
@@ -360,6 +361,15 @@ static int ipv4_forward_callback(FAR struct net_driver_s *fwddev,
    * packet from.
    */
 
+#ifdef CONFIG_NET_IPTABLES_FILTER
+  /* Skip the devices the filter rules do not forward to */
+
+  if (ipt_filter_ipv4(NF_INET_FORWARD, dev, fwddev, IPv4BUF) != NF_ACCEPT)
+    {
+      return OK;
+    }
+#endif
+
   if (fwddev != dev)
     {
       /* Backup the forward IP packet */
@@ -449,6 +459,21 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   int icmp_reply_code;
 #endif /* CONFIG_NET_ICMP */
 
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+  /* Packets of known flows are transmitted right away */
+
+  ret = ipv4_forward_fast(dev, ipv4);
+  if (ret != -ENOENT)
+    {
+      if (ret < 0)
+        {
+          goto drop;
+        }
+
+      return OK;
+    }
+#endif
+
   /* Search for a device that can forward this packet. */
 
   destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
@@ -462,6 +487,15 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
       goto drop;
     }
 
+#ifdef CONFIG_NET_IPTABLES_FILTER
+  if (ipt_filter_ipv4(NF_INET_FORWARD, dev, fwddev, ipv4) != NF_ACCEPT)
+    {
+      ninfo("Dropped by the filter rules\n");
+      ret = -EPERM;
+      goto drop;
+    }
+#endif
+
   /* Check if we are forwarding on the same device that we received the
    * packet from.
    */
@@ -29,6 +29,7 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <stdlib.h>
 #include <debug.h>
 #include <string.h>
@@ -43,6 +44,8 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
 #include <nuttx/net/ipv6ext.h>
 
 #include "netdev/netdev.h"
@@ -93,7 +96,11 @@ do  \
 
 /* The maximum I/O buffer occupied by fragment reassembly cache */
 
-#define REASSEMBLY_MAXOCCUPYIOB        CONFIG_IOB_NBUFFERS / 5
+#if CONFIG_NET_IPFRAG_MAXIOBS > 0
+#  define REASSEMBLY_MAXOCCUPYIOB      CONFIG_NET_IPFRAG_MAXIOBS
+#else
+#  define REASSEMBLY_MAXOCCUPYIOB      (CONFIG_IOB_NBUFFERS / 5)
+#endif
 
 /* Deciding whether to fragment outgoing packets which target is to ourself */
 
@@ -116,13 +123,11 @@ static struct work_s g_wkfragtimeout;
 
 /* Remember the number of I/O buffers currently in reassembly cache */
 
-static uint8_t       g_bufoccupy;
+static uint32_t      g_bufoccupy;
 
-/* Queue header definition, it links all fragments of all NICs by ascending
- * ipid.
- */
+/* Hash table of the fragments of all NICs by addresses, protocol and ipid */
 
-static sq_queue_t    g_assemblyhead_ipid;
+static sq_queue_t    g_assemblyhash[CONFIG_NET_IPFRAG_HASHSIZE];
 
 /* Queue header definition, which connects all fragments of all NICs in order
  * of addition time.
@@ -134,8 +139,8 @@ static sq_queue_t    g_assemblyhead_time;
  * Public Data
  ****************************************************************************/
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
- * at a time.
+/* Only one thread can access g_assemblyhash and g_assemblyhead_time at a
+ * time.
  */
 
 mutex_t              g_ipfrag_lock = NXMUTEX_INITIALIZER;
@@ -148,10 +153,15 @@ static void ip_fragin_timerout_expiry(wdparm_t arg);
 static void ip_fragin_timerwork(FAR void *arg);
 static inline FAR struct ip_fraglink_s *
 ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink);
-static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode);
+static void ip_fragin_freenode(FAR struct ip_fragsnode_s *node);
+static int ip_fragin_fillhole(FAR struct ip_fragsnode_s *node,
+                              FAR struct ip_fraglink_s *fraglink);
 static void ip_fragin_cachemonitor(FAR struct ip_fragsnode_s *curnode);
 static inline FAR struct iob_s *
 ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq);
+#ifdef CONFIG_NETDEV_OFFLOAD
+static void ip_fragout_chksum(FAR struct net_driver_s *dev);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -360,48 +370,209 @@ ip_fragin_freelink(FAR struct ip_fraglink_s *fraglink)
 }
 
 /****************************************************************************
- * Name: ip_fragin_check
+ * Name: ip_fragin_freenode
+ *
+ * Description:
+ *   Free all fragments of a datagram and its node.
+ *
+ * Input Parameters:
+ *   node - node of the upper-level linked list, it maintains
+ *          information about all fragments belonging to an IP datagram
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void ip_fragin_freenode(FAR struct ip_fragsnode_s *node)
+{
+  FAR struct ip_fraglink_s *fraglink = node->frags;
+
+  while (fraglink != NULL)
+    {
+      fraglink = ip_fragin_freelink(fraglink);
+    }
+
+  ip_frag_remnode(node);
+  kmm_free(node);
+}
+
+/****************************************************************************
+ * Name: ip_fragin_getkey
  *
  * Description:
- *   Check whether the zero fragment has been received or all fragments have
- *   been received.
+ *   Get the fields that identify the datagram of a fragment from its IP
+ *   header.
  *
  * Input Parameters:
- *   fragsnode - node of the upper-level linked list, it maintains
- *               information bout all fragments belonging to an IP datagram
+ *   fraglink - node of the lower-level linked list, it maintains
+ *              information of one fragment
+ *   key      - The location to return the key
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-static void ip_fragin_check(FAR struct ip_fragsnode_s *fragsnode)
+static void ip_fragin_getkey(FAR struct ip_fraglink_s *fraglink,
+                             FAR struct ip_fragkey_s *key)
+{
+  FAR struct iob_s *iob = fraglink->frag;
+
+  /* The padding is compared too */
+
+  memset(key, 0, sizeof(*key));
+  key->ipid   = fraglink->ipid;
+  key->isipv4 = fraglink->isipv4;
+
+#ifdef CONFIG_NET_IPv4
+  if (fraglink->isipv4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)
+                                    (iob->io_data + iob->io_offset);
+
+      memcpy(key->srcaddr, ipv4->srcipaddr, sizeof(ipv4->srcipaddr));
+      memcpy(key->destaddr, ipv4->destipaddr, sizeof(ipv4->destipaddr));
+      key->proto = ipv4->proto;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!fraglink->isipv4)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)
+                                    (iob->io_data + iob->io_offset);
+
+      memcpy(key->srcaddr, ipv6->srcipaddr, sizeof(ipv6->srcipaddr));
+      memcpy(key->destaddr, ipv6->destipaddr, sizeof(ipv6->destipaddr));
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: ip_fragin_hash
+ *
+ * Description:
+ *   Return the bucket of the reassembly hash table of a datagram.
+ *
+ ****************************************************************************/
+
+static uint16_t ip_fragin_hash(FAR const struct ip_fragkey_s *key)
+{
+  uint32_t hash = key->ipid ^ key->proto;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash = hash * 31 + key->srcaddr[i];
+      hash = hash * 31 + key->destaddr[i];
+    }
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  return hash % CONFIG_NET_IPFRAG_HASHSIZE;
+}
+
+/****************************************************************************
+ * Name: ip_fragin_fillhole
+ *
+ * Description:
+ *   Update the holes of a datagram with a new fragment (RFC 815).  The
+ *   fragment must fill a part of one hole, the tail fragment the end of
+ *   the last hole.  Once no hole is left, all fragments have been
+ *   received.
+ *
+ * Input Parameters:
+ *   node     - node of the upper-level linked list, it maintains
+ *              information about all fragments belonging to an IP datagram
+ *   fraglink - node of the lower-level linked list, it maintains
+ *              information of one fragment
+ *
+ * Returned Value:
+ *   OK if the fragment filled a hole, -EEXIST if its data was already
+ *   received, -EINVAL if it overlaps received data partially or lies
+ *   beyond the end and -ENOSPC if the datagram would have too many
+ *   holes.
+ *
+ ****************************************************************************/
+
+static int ip_fragin_fillhole(FAR struct ip_fragsnode_s *node,
+                              FAR struct ip_fraglink_s *fraglink)
 {
-  uint16_t formerlen = 0;
-  FAR struct ip_fraglink_s *entry;
+  uint32_t first = fraglink->fragoff;
+  uint32_t last  = first + fraglink->fraglen - 1;
+  struct ip_fraghole_s hole;
+  int nadd;
+  int i;
+
+  if (fraglink->fraglen == 0)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < node->nholes; i++)
+    {
+      if (node->holes[i].first <= first && last <= node->holes[i].last)
+        {
+          break;
+        }
+    }
 
-  if (fragsnode->verifyflag & IP_FRAGVERIFY_RECVDTAILFRAG)
+  if (i == node->nholes)
     {
-      entry = fragsnode->frags;
-      while (entry != NULL)
+      /* Not within a hole: a duplicate if no hole is touched at all */
+
+      for (i = 0; i < node->nholes; i++)
         {
-          if (entry->morefrags)
+          if (first <= node->holes[i].last && node->holes[i].first <= last)
             {
-              formerlen += entry->fraglen;
+              return -EINVAL;
             }
-          else
-            {
-              /* Only the last entry has a 0 morefrags flag */
+        }
 
-              if (entry->fragoff == formerlen)
-                {
-                  fragsnode->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
-                }
-            }
+      return -EEXIST;
+    }
 
-          entry = entry->flink;
-        }
+  hole = node->holes[i];
+
+  /* Nothing may follow the tail fragment */
+
+  if (!fraglink->morefrags && hole.last != IP_FRAGHOLE_INFINITY)
+    {
+      return -EINVAL;
+    }
+
+  nadd = (first > hole.first) +
+         (last < hole.last && fraglink->morefrags);
+  if (node->nholes - 1 + nadd > CONFIG_NET_IPFRAG_MAXHOLES)
+    {
+      return -ENOSPC;
+    }
+
+  node->holes[i] = node->holes[--node->nholes];
+
+  if (first > hole.first)
+    {
+      node->holes[node->nholes].first = hole.first;
+      node->holes[node->nholes].last  = first - 1;
+      node->nholes++;
+    }
+
+  if (last < hole.last && fraglink->morefrags)
+    {
+      node->holes[node->nholes].first = last + 1;
+      node->holes[node->nholes].last  = hole.last;
+      node->nholes++;
+    }
+
+  if (node->nholes == 0)
+    {
+      node->verifyflag |= IP_FRAGVERIFY_RECVDALLFRAGS;
     }
+
+  return OK;
 }
 
 /****************************************************************************
@@ -503,6 +674,85 @@ ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq)
   return iob;
 }
 
+/****************************************************************************
+ * Name: ip_fragout_chksum
+ *
+ * Description:
+ *   Complete the TCP or UDP checksum that was left to a device with
+ *   NETDEV_FEATURE_TXCSUM, which cannot sum a datagram sent in fragments.
+ *
+ * Input Parameters:
+ *   dev    - The NIC device
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+static void ip_fragout_chksum(FAR struct net_driver_s *dev)
+{
+  FAR uint16_t *chksum;
+  unsigned int iplen;
+  uint8_t proto;
+
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv4(dev->d_flags))
+    {
+      iplen = (IPv4BUF->vhl & IPv4_HLMASK) << 2;
+      proto = IPv4BUF->proto;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+    {
+      iplen = IPv6_HDRLEN;
+      proto = IPv6BUF->proto;
+    }
+#else
+    {
+      return;
+    }
+#endif
+
+  if (proto == IP_PROTO_TCP)
+    {
+      chksum = IPBUF(iplen + offsetof(struct tcp_hdr_s, tcpchksum));
+    }
+  else if (proto == IP_PROTO_UDP)
+    {
+      /* A zero UDP checksum is not computed */
+
+      chksum = IPBUF(iplen + offsetof(struct udp_hdr_s, udpchksum));
+      if (*chksum == 0)
+        {
+          return;
+        }
+    }
+  else
+    {
+      return;
+    }
+
+  *chksum = 0;
+
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv4(dev->d_flags))
+    {
+      *chksum = ~ipv4_upperlayer_chksum(dev, proto);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+    {
+      *chksum = ~ipv6_upperlayer_chksum(dev, proto, iplen);
+    }
+#endif
+
+  if (proto == IP_PROTO_UDP && *chksum == 0)
+    {
+      *chksum = 0xffff;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -527,7 +777,7 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
   g_bufoccupy -= node->bufcnt;
   assert(g_bufoccupy < CONFIG_IOB_NBUFFERS);
 
-  sq_rem((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
+  sq_rem((FAR sq_entry_t *)node, &g_assemblyhash[node->bucket]);
   sq_rem((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
 
   return node->bufcnt;
@@ -540,173 +790,147 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
  *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   kept in a hash table by source, destination, protocol and IP ID.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
  *   curfraglink - node of the lower-level linked list, it maintains
  *                 information of one fragment
+ *   pnode       - The location to return the node of the datagram, NULL if
+ *                 the fragment was a duplicate and has been dropped
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   1 if the queue was empty before (the reassembly timer must be
+ *   started), 0 if not.  A negated errno value if the fragment cannot be
+ *   queued: curfraglink is freed but the fragment is left in dev->d_iob.
+ *   A fragment that overlaps another one partially drops its whole
+ *   datagram.
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink)
+int ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                      FAR struct ip_fraglink_s *curfraglink,
+                      FAR struct ip_fragsnode_s **pnode)
 {
   FAR struct ip_fragsnode_s *node;
+  FAR struct ip_fraglink_s  *fraglink;
+  FAR struct ip_fraglink_s  *lastlink = NULL;
   FAR sq_entry_t            *entry;
-  FAR sq_entry_t            *entrylast = NULL;
+  struct ip_fragkey_s        key;
+  uint16_t                   bucket;
   bool                       empty;
+  int                        ret;
 
-  /* The linked list is ordered by IP ID value, walk through it and try to
-   * find a node that has the same IP ID value, otherwise need to create a
-   * new node and insert it into the linked list.
+  *pnode = NULL;
+  empty  = sq_empty(&g_assemblyhead_time);
+
+  /* Look for the datagram in its bucket of the hash table, otherwise a new
+   * node is created.
    */
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-  empty = (entry == NULL) ? true : false;
+  ip_fragin_getkey(curfraglink, &key);
+  bucket = ip_fragin_hash(&key);
 
-  while (entry != NULL)
+  for (entry = sq_peek(&g_assemblyhash[bucket]); entry != NULL;
+       entry = sq_next(entry))
     {
-      node = (struct ip_fragsnode_s *)entry;
+      node = (FAR struct ip_fragsnode_s *)entry;
 
-      if (dev == node->dev && curfraglink->ipid <= node->ipid)
+      if (dev == node->dev && memcmp(&key, &node->key, sizeof(key)) == 0)
         {
           break;
         }
-
-      entrylast = entry;
-      entry = sq_next(entry);
     }
 
-  node = (FAR struct ip_fragsnode_s *)entry;
-
-  if (node != NULL && curfraglink->ipid == node->ipid)
+  if (entry != NULL)
     {
-      FAR struct ip_fraglink_s *fraglink;
-      FAR struct ip_fraglink_s *lastlink = NULL;
+      ret = ip_fragin_fillhole(node, curfraglink);
+      if (ret == -EEXIST)
+        {
+          /* Its data was already received, drop the newer copy.  Refer to
+           * RFC791, Section3.2, Page29: either copy may be used.
+           */
 
-      /* Found a previously created ip_fragsnode_s, insert this new
-       * ip_fraglink_s to the subchain of this node.
-       */
+          iob_free_chain(curfraglink->frag);
+          kmm_free(curfraglink);
+          netdev_iob_clear(dev);
+          return 0;
+        }
+      else if (ret < 0)
+        {
+          /* Overlapping or too scattered, the reassembly of this datagram
+           * could not be trusted (refer to RFC5722): drop it all.
+           */
 
-      fraglink = node->frags;
+          nwarn("WARNING: Dropping datagram %" PRIx32 ": %d\n",
+                key.ipid, ret);
+          ip_fragin_freenode(node);
+          kmm_free(curfraglink);
+          return ret;
+        }
 
-      /* An ip_fragsnode_s must have an ip_fraglink_s because we allocate a
-       * new ip_fraglink_s when caching a new ip_fraglink_s with a new IP ID
+      /* Insert this new ip_fraglink_s to the subchain of this node, which
+       * is ordered by fragment offset.  It lies in a hole, so no other
+       * fragment has the same offset.
        */
 
-      while (fraglink != NULL)
+      fraglink = node->frags;
+      while (fraglink != NULL && fraglink->fragoff < curfraglink->fragoff)
         {
-          /* The fragment list is ordered by fragment offset value */
-
-          if (curfraglink->fragoff <= fraglink->fragoff)
-            {
-              break;
-            }
-
           lastlink = fraglink;
           fraglink = fraglink->flink;
         }
 
-      if (fraglink == NULL)
+      curfraglink->flink = fraglink;
+      if (lastlink == NULL)
         {
-          /* This fragment offset is greater than the previous fragments,
-           * added to the last position
-           */
-
-          lastlink->flink      = curfraglink;
-
-          /* Remember I/O buffer count */
-
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
-        }
-      else if (curfraglink->fragoff == fraglink->fragoff)
-        {
-          /* Fragments with same offset value contain the same data, use the
-           * more recently arrived copy. Refer to RFC791, Section3.2, Page29.
-           * Replace and removed the old packet from the fragment list
-           */
-
-          curfraglink->flink = fraglink->flink;
-          if (lastlink == NULL)
-            {
-              node->frags = curfraglink;
-            }
-          else
-            {
-              lastlink->flink = curfraglink;
-            }
-
-          iob_free_chain(fraglink->frag);
-          kmm_free(fraglink);
+          node->frags = curfraglink;
         }
       else
         {
-          /* Insert into the fragment list */
-
-          if (lastlink == NULL)
-            {
-              /* Insert before the first node */
-
-              curfraglink->flink = node->frags;
-              node->frags = curfraglink;
-            }
-          else
-            {
-              /* Insert this node after lastlink */
-
-              curfraglink->flink = lastlink->flink;
-              lastlink->flink = curfraglink;
-            }
-
-          /* Remember I/O buffer count */
-
-          node->bufcnt += IOBUF_CNT(curfraglink->frag);
-          g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
+          lastlink->flink = curfraglink;
         }
     }
   else
     {
-      /* It's a new IP ID fragment, malloc a new node and insert it into the
-       * linked list
+      /* It's a new datagram, malloc a new node and insert it into the hash
+       * table.  Its only hole is the whole payload.
        */
 
       node = kmm_malloc(sizeof(struct ip_fragsnode_s));
       if (node == NULL)
         {
           nerr("ERROR: Failed to allocate buffer.\n");
+          kmm_free(curfraglink);
           return -ENOMEM;
         }
 
-      node->flink      = NULL;
-      node->flinkat    = NULL;
-      node->dev        = dev;
-      node->ipid       = curfraglink->ipid;
-      node->frags      = curfraglink;
-      node->tick       = clock_systime_ticks();
-      node->bufcnt     = IOBUF_CNT(curfraglink->frag);
-      g_bufoccupy     += IOBUF_CNT(curfraglink->frag);
-      node->verifyflag = 0;
-      node->outgoframe = NULL;
-
-      /* Insert this new node into linked list identified by
-       * g_assemblyhead_ipid with correct position
-       */
-
-      if (sq_peek(&g_assemblyhead_ipid) == NULL || entrylast == NULL)
+      node->flink          = NULL;
+      node->flinkat        = NULL;
+      node->dev            = dev;
+      node->key            = key;
+      node->bucket         = bucket;
+      node->nholes         = 1;
+      node->holes[0].first = 0;
+      node->holes[0].last  = IP_FRAGHOLE_INFINITY;
+      node->tick           = clock_systime_ticks();
+      node->bufcnt         = 0;
+      node->verifyflag     = 0;
+      node->outgoframe     = NULL;
+
+      ret = ip_fragin_fillhole(node, curfraglink);
+      if (ret < 0)
         {
-          sq_addfirst((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-        }
-      else
-        {
-          sq_addafter(entrylast, (FAR sq_entry_t *)node,
-                      &g_assemblyhead_ipid);
+          kmm_free(node);
+          kmm_free(curfraglink);
+          return ret;
         }
 
+      curfraglink->flink = NULL;
+      node->frags        = curfraglink;
+
+      sq_addlast((FAR sq_entry_t *)node, &g_assemblyhash[bucket]);
+
       /* Add this new node to the tail of linked list identified by
        * g_assemblyhead_time
        */
@@ -714,6 +938,11 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
       sq_addlast((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
     }
 
+  /* Remember I/O buffer count */
+
+  node->bufcnt += IOBUF_CNT(curfraglink->frag);
+  g_bufoccupy  += IOBUF_CNT(curfraglink->frag);
+
   if (curfraglink->fragoff == 0)
     {
       /* Have received the zero fragment */
@@ -730,10 +959,7 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
   /* For indexing convenience */
 
   curfraglink->fragsnode = node;
-
-  /* Check receiving status */
-
-  ip_fragin_check(node);
+  *pnode = node;
 
   /* Buffer is take away, clear original pointers in NIC */
 
@@ -1114,29 +1340,19 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop those unassembled incoming fragments belonging to this NIC */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+        container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
       if (dev == node->dev)
         {
-          if (node->frags != NULL)
-            {
-              FAR struct ip_fraglink_s *fraglink = node->frags;
-
-              while (fraglink != NULL)
-                {
-                  fraglink = ip_fragin_freelink(fraglink);
-                }
-            }
-
-          ip_frag_remnode(node);
-          kmm_free(entry);
+          ip_fragin_freenode(node);
         }
 
       entry = entrynext;
@@ -1169,39 +1385,21 @@ void ip_frag_remallfrags(void)
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop all unassembled incoming fragments */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+        container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
-      if (node->frags != NULL)
-        {
-          FAR struct ip_fraglink_s *fraglink = node->frags;
-
-          while (fraglink != NULL)
-            {
-              fraglink = ip_fragin_freelink(fraglink);
-            }
-        }
-
-      /* Because nodes managed by the two queues are the same,
-       * and g_assemblyhead_ipid will be cleared after this loop ends,
-       * so only reset g_assemblyhead_time is needed after this loop ends
-       */
-
-      sq_rem(entry, &g_assemblyhead_ipid);
-      kmm_free(entry);
+      ip_fragin_freenode(node);
 
       entry = entrynext;
     }
 
-  sq_init(&g_assemblyhead_time);
-  g_bufoccupy = 0;
-
   nxmutex_unlock(&g_ipfrag_lock);
 
   /* Drop all unsent outgoing fragments */
@@ -1243,7 +1441,9 @@ int32_t ip_fragout(FAR struct net_driver_s *dev)
       return -EINVAL;
     }
 
-  if (dev->d_iob->io_pktlen <= mtu)
+  /* A TSO segment is split by the device, see NETDEV_FEATURE_TSO */
+
+  if (dev->d_iob->io_pktlen <= mtu || NETDEV_GSOSIZE(dev) > 0)
     {
       return OK;
     }
@@ -1263,6 +1463,13 @@ int32_t ip_fragout(FAR struct net_driver_s *dev)
 
   ninfo("pkt size: %d, MTU: %d\n", dev->d_iob->io_pktlen, mtu);
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  if (NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TXCSUM))
+    {
+      ip_fragout_chksum(dev);
+    }
+#endif
+
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv4(dev->d_flags))
     {
@@ -42,6 +42,14 @@
 
 #if defined(CONFIG_NET_IPFRAG)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The end of a hole that extends to the unknown end of the datagram */
+
+#define IP_FRAGHOLE_INFINITY UINT32_MAX
+
 /****************************************************************************
  * Public types
  ****************************************************************************/
@@ -90,9 +98,31 @@ struct ip_fraglink_s
   uint32_t                   ipid;
 };
 
+/* The fields that identify the fragments of one datagram: the addresses,
+ * the protocol (IPv4 only) and the IP ID.
+ */
+
+struct ip_fragkey_s
+{
+  uint16_t                   srcaddr[8];  /* IPv4 uses the first 2 words */
+  uint16_t                   destaddr[8];
+  uint32_t                   ipid;
+  uint8_t                    isipv4;
+  uint8_t                    proto;
+};
+
+/* A range of the payload not received yet (RFC 815), bounds included */
+
+struct ip_fraghole_s
+{
+  uint32_t                   first;
+  uint32_t                   last;
+};
+
 struct ip_fragsnode_s
 {
-  /* This link is used to maintain a single-linked list of ip_fragsnode_s.
+  /* This link is used to maintain a single-linked list of ip_fragsnode_s
+   * in a bucket of the reassembly hash table.
    * Must be the first field in the structure due to flink type casting.
    */
 
@@ -108,11 +138,20 @@ struct ip_fragsnode_s
 
   FAR struct net_driver_s   *dev;
 
-  /* IP Identification (IP ID) field defined in ipv4 header or in ipv6
-   * fragment header.
+  /* The datagram: addresses, protocol and the IP Identification (IP ID)
+   * field defined in ipv4 header or in ipv6 fragment header.
    */
 
-  uint32_t                   ipid;
+  struct ip_fragkey_s        key;
+
+  /* The hash bucket the node is in */
+
+  uint16_t                   bucket;
+
+  /* The holes of the payload, none once all fragments were received */
+
+  uint8_t                    nholes;
+  struct ip_fraghole_s       holes[CONFIG_NET_IPFRAG_MAXHOLES];
 
   /* Count ticks, used by ressembly timer */
 
@@ -181,20 +220,27 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
  *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   kept in a hash table by source, destination, protocol and IP ID.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
  *   curfraglink - node of the lower-level linked list, it maintains
  *                 information of one fragment
+ *   pnode       - The location to return the node of the datagram, NULL if
+ *                 the fragment was a duplicate and has been dropped
  *
  * Returned Value:
- *   Whether queue is empty before enqueue the new node
+ *   1 if the queue was empty before (the reassembly timer must be
+ *   started), 0 if not.  A negated errno value if the fragment cannot be
+ *   queued: curfraglink is freed but the fragment is left in dev->d_iob.
+ *   A fragment that overlaps another one partially drops its whole
+ *   datagram.
  *
  ****************************************************************************/
 
-bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
-                       FAR struct ip_fraglink_s *curfraglink);
+int ip_fragin_enqueue(FAR struct net_driver_s *dev,
+                      FAR struct ip_fraglink_s *curfraglink,
+                      FAR struct ip_fragsnode_s **pnode);
 
 /****************************************************************************
  * Name: ipv4_fragin
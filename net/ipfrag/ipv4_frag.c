@@ -261,6 +261,7 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
   FAR struct ip_fragsnode_s *node;
   FAR struct ip_fraglink_s *fraginfo;
   bool restartwdog;
+  int ret;
 
   if (dev->d_len != dev->d_iob->io_pktlen)
     {
@@ -283,11 +284,16 @@ int32_t ipv4_fragin(FAR struct net_driver_s *dev)
 
   /* Need to restart reassembly worker if the original linked list is empty */
 
-  restartwdog = ip_fragin_enqueue(dev, fraginfo);
+  ret = ip_fragin_enqueue(dev, fraginfo, &node);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_ipfrag_lock);
+      return ret;
+    }
 
-  node = fraginfo->fragsnode;
+  restartwdog = ret > 0;
 
-  if (node->verifyflag & IP_FRAGVERIFY_RECVDALLFRAGS)
+  if (node != NULL && (node->verifyflag & IP_FRAGVERIFY_RECVDALLFRAGS) != 0)
     {
       /* Well, all fragments of an IP frame have been received, remove
        * node from link list first, then reassemble and dispatch to the
@@ -39,6 +39,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/mutex.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 
 #ifdef CONFIG_NET_LOCAL
 
@@ -49,6 +50,17 @@
 #define LOCAL_NPOLLWAITERS 2
 #define LOCAL_NCONTROLFDS  4
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+#  if (CONFIG_NET_LOCAL_RING_SIZE & (CONFIG_NET_LOCAL_RING_SIZE - 1)) != 0
+#    error CONFIG_NET_LOCAL_RING_SIZE must be a power of two
+#  endif
+
+#  if defined(CONFIG_NET_LOCAL_RING_HANDOFF) && \
+      CONFIG_NET_LOCAL_RING_HANDOFF > 0
+#    define LOCAL_RING_HANDOFF 1
+#  endif
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -103,6 +115,45 @@ enum local_state_s
 
 struct devif_callback_s;       /* Forward reference */
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+/* One direction of a connected stream socket.  Only the writer moves
+ * lr_tail and only the reader moves lr_head; the send and receive locks of
+ * the connections leave a single writer and a single reader, so the data
+ * moves without any other lock.
+ */
+
+struct local_ring_s
+{
+  volatile uint32_t lr_head;     /* Read index (free running) */
+  volatile uint32_t lr_tail;     /* Write index (free running) */
+  volatile bool lr_rdclosed;     /* The reading side is shut down */
+  volatile bool lr_wrclosed;     /* The writing side is shut down */
+  sem_t lr_rdsem;                /* Posted when data is written */
+  sem_t lr_wrsem;                /* Posted when data is read */
+  spinlock_t lr_lock;            /* Protects the poll waiters */
+
+  /* The poll waiters for POLLIN and for POLLOUT */
+
+  FAR struct pollfd *lr_rdfds[LOCAL_NPOLLWAITERS];
+  FAR struct pollfd *lr_wrfds[LOCAL_NPOLLWAITERS];
+#ifdef LOCAL_RING_HANDOFF
+  mutex_t lr_hofflock;           /* Serializes the handoff of a send */
+  FAR const uint8_t *lr_hoff;    /* Memory of the blocked sender */
+  size_t lr_hofflen;             /* Size of the handed off memory */
+  size_t lr_hoffpos;             /* Bytes already read from it */
+#endif
+  uint8_t lr_buf[CONFIG_NET_LOCAL_RING_SIZE];
+};
+
+/* The two rings shared by a pair of connected stream sockets */
+
+struct local_rpair_s
+{
+  uint8_t lp_crefs;              /* Connections using the pair */
+  struct local_ring_s lp_ring[2];
+};
+#endif /* CONFIG_NET_LOCAL_STREAM_RING */
+
 struct local_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -152,6 +203,15 @@ struct local_conn_s
   struct pollfd *lc_event_fds[LOCAL_NPOLLWAITERS];
   struct pollfd lc_inout_fds[2*LOCAL_NPOLLWAITERS];
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+  /* The rings that replace the FIFOs once connected */
+
+  FAR struct local_rpair_s *lc_rpair; /* The rings shared with the peer */
+  FAR struct local_ring_s *lc_rx;     /* The ring read by this side */
+  FAR struct local_ring_s *lc_tx;     /* The ring written by this side */
+  mutex_t lc_recvlock;                /* Make receiving multi-thread safe */
+#endif
+
   /* Union of fields unique to SOCK_STREAM client, server, and connected
    * peers.
    */
@@ -663,6 +723,106 @@ int local_set_pollthreshold(FAR struct local_conn_s *conn,
                             unsigned long threshold);
 #endif
 
+/****************************************************************************
+ * Name: local_ring_connect
+ *
+ * Description:
+ *   Connect two stream connections through a new pair of rings.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the rings cannot be allocated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+int local_ring_connect(FAR struct local_conn_s *conn0,
+                       FAR struct local_conn_s *conn1);
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Shut down both directions of a connection and drop its reference to
+ *   the rings, freed with the last one.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_ring_release(FAR struct local_conn_s *conn);
+
+/****************************************************************************
+ * Name: local_ring_shutdown
+ *
+ * Description:
+ *   Shut down the directions of a connection selected by 'how' (SHUT_RD,
+ *   SHUT_WR or SHUT_RDWR).
+ *
+ ****************************************************************************/
+
+void local_ring_shutdown(FAR struct local_conn_s *conn, int how);
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Write the data of 'buf', an array of 'len' I/O vectors, to the ring of
+ *   the peer.
+ *
+ * Returned Value:
+ *   The number of bytes sent; a negated errno value if none was.
+ *
+ * Assumptions:
+ *   The caller holds lc_sendlock.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn,
+                        FAR const struct iovec *buf, size_t len,
+                        int flags);
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Read up to 'len' bytes from the ring of a connection.
+ *
+ * Returned Value:
+ *   The number of bytes received, zero once the peer has shut down its
+ *   side; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                        size_t len, int flags);
+
+/****************************************************************************
+ * Name: local_ring_poll
+ *
+ * Description:
+ *   Setup or teardown the monitoring of the rings of a connection.
+ *
+ ****************************************************************************/
+
+int local_ring_poll(FAR struct local_conn_s *conn, FAR struct pollfd *fds,
+                    bool setup);
+
+/****************************************************************************
+ * Name: local_ring_ioctl
+ *
+ * Description:
+ *   Handle the FIFO ioctl commands for a connection using the rings.
+ *
+ * Returned Value:
+ *   -ENOTTY if the command is not one of the ring commands.
+ *
+ ****************************************************************************/
+
+int local_ring_ioctl(FAR struct local_conn_s *conn, int cmd,
+                     unsigned long arg);
+#endif /* CONFIG_NET_LOCAL_STREAM_RING */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
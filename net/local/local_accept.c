@@ -103,7 +103,9 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
   FAR struct local_conn_s *client;
   FAR struct local_conn_s *conn;
   FAR dq_entry_t *waiter;
+#ifndef CONFIG_NET_LOCAL_STREAM_RING
   bool nonblock = !!(flags & SOCK_NONBLOCK);
+#endif
   int ret;
 
   /* Some sanity checks */
@@ -174,6 +176,11 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               strlcpy(conn->lc_path, client->lc_path, sizeof(conn->lc_path));
               conn->lc_instance_id = client->lc_instance_id;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+              /* There is no FIFO, the rings are set up last */
+
+              ret = OK;
+#else
               /* Open the server-side write-only FIFO.  This should not
                * block.
                */
@@ -184,8 +191,10 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
                   nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
                      conn->lc_path, ret);
                 }
+#endif
             }
 
+#ifndef CONFIG_NET_LOCAL_STREAM_RING
           /* Do we have a connection?  Is the write-side FIFO opened? */
 
           if (ret == OK)
@@ -210,14 +219,24 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
           if (ret == OK)
             {
               DEBUGASSERT(conn->lc_infile.f_inode != NULL);
+            }
+#endif
 
-              /* Return the address family */
+          /* Return the address family */
 
-              if (addr != NULL)
-                {
-                  ret = local_getaddr(client, addr, addrlen);
-                }
+          if (ret == OK && addr != NULL)
+            {
+              ret = local_getaddr(client, addr, addrlen);
+            }
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+          /* Connect the client and the new connection through the rings */
+
+          if (ret == OK)
+            {
+              ret = local_ring_connect(conn, client);
             }
+#endif
 
           if (ret == OK)
             {
@@ -130,6 +130,9 @@ FAR struct local_conn_s *local_alloc(void)
 
       nxmutex_init(&conn->lc_sendlock);
       nxmutex_init(&conn->lc_polllock);
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+      nxmutex_init(&conn->lc_recvlock);
+#endif
 
 #ifdef CONFIG_NET_LOCAL_SCM
       conn->lc_cred.pid = nxsched_getpid();
@@ -175,6 +178,12 @@ void local_free(FAR struct local_conn_s *conn)
       conn->lc_peer = NULL;
     }
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+  /* Disconnect from the peer and drop the reference to the rings */
+
+  local_ring_release(conn);
+#endif
+
   net_unlock();
 
   /* Make sure that the read-only FIFO is closed */
@@ -219,6 +228,9 @@ void local_free(FAR struct local_conn_s *conn)
 
   nxmutex_destroy(&conn->lc_sendlock);
   nxmutex_destroy(&conn->lc_polllock);
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+  nxmutex_destroy(&conn->lc_recvlock);
+#endif
 
   /* And free the connection structure */
 
@@ -177,6 +177,13 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       return local_event_pollsetup(conn, fds, true);
     }
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+  if (conn->lc_rpair != NULL)
+    {
+      return local_ring_poll(conn, fds, true);
+    }
+#endif
+
   if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
     {
       fds->priv = NULL;
@@ -330,6 +337,20 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
       return local_event_pollsetup(conn, fds, false);
     }
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+  if (conn->lc_rpair != NULL)
+    {
+      /* A poll set up while connecting is in the event slots */
+
+      if (fds->priv == conn->lc_rx)
+        {
+          return local_ring_poll(conn, fds, false);
+        }
+
+      return local_event_pollsetup(conn, fds, false);
+    }
+#endif
+
   if (conn->lc_state == LOCAL_STATE_DISCONNECTED)
     {
       return OK;
@@ -233,6 +233,35 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
   size_t readlen = len;
   int ret;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+  /* A connected stream reads straight from its ring */
+
+  if (conn->lc_state == LOCAL_STATE_CONNECTED && conn->lc_rx != NULL)
+    {
+      ssize_t nread;
+
+      ret = nxmutex_lock(&conn->lc_recvlock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nread = local_ring_recv(conn, buf, len, flags);
+      nxmutex_unlock(&conn->lc_recvlock);
+
+      if (nread >= 0 && from != NULL)
+        {
+          ret = local_getaddr(conn, from, fromlen);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      return nread;
+    }
+#endif
+
   /* Verify that this is a connected peer socket */
 
   if (conn->lc_state != LOCAL_STATE_CONNECTED ||
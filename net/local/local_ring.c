@@ -0,0 +1,772 @@
+/****************************************************************************
+ * net/local/local_ring.c
+ * Ring buffer transport of connected Unix domain stream sockets
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LOCAL_RING_MASK        (CONFIG_NET_LOCAL_RING_SIZE - 1)
+#define LOCAL_RING_USED(r)     ((uint32_t)((r)->lr_tail - (r)->lr_head))
+#define LOCAL_RING_SPACE(r)    (CONFIG_NET_LOCAL_RING_SIZE - \
+                                LOCAL_RING_USED(r))
+
+#ifdef LOCAL_RING_HANDOFF
+#  define LOCAL_RING_HOFFLEN(r) \
+     ((r)->lr_hoff != NULL ? (r)->lr_hofflen - (r)->lr_hoffpos : 0)
+#else
+#  define LOCAL_RING_HOFFLEN(r) 0
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_post
+ *
+ * Description:
+ *   Wake up the waiter of a ring semaphore.  At most one wake up is kept
+ *   pending; the waiter checks the ring again anyway.
+ *
+ ****************************************************************************/
+
+static void local_ring_post(FAR sem_t *sem)
+{
+  int sval;
+
+  if (nxsem_get_value(sem, &sval) >= 0 && sval < 1)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_wait
+ *
+ * Description:
+ *   Wait for a ring semaphore for at most 'timeout' milliseconds, UINT_MAX
+ *   to wait forever.  A timeout is reported as -EAGAIN, as for the other
+ *   sockets.
+ *
+ ****************************************************************************/
+
+static int local_ring_wait(FAR sem_t *sem, unsigned int timeout)
+{
+  int ret;
+
+  if (timeout == UINT_MAX)
+    {
+      return nxsem_wait(sem);
+    }
+
+  ret = nxsem_tickwait(sem, MSEC2TICK(timeout));
+  return ret == -ETIMEDOUT ? -EAGAIN : ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_notify
+ *
+ * Description:
+ *   Notify the poll waiters of a ring.
+ *
+ ****************************************************************************/
+
+static void local_ring_notify(FAR struct local_ring_s *ring,
+                              FAR struct pollfd **fds,
+                              pollevent_t eventset)
+{
+  irqstate_t flags = spin_lock_irqsave(&ring->lr_lock);
+  poll_notify(fds, LOCAL_NPOLLWAITERS, eventset);
+  spin_unlock_irqrestore(&ring->lr_lock, flags);
+}
+
+/****************************************************************************
+ * Name: local_ring_put
+ *
+ * Description:
+ *   Copy as much of 'len' bytes at 'src' as fits in the ring.  Only called
+ *   by the writer.
+ *
+ ****************************************************************************/
+
+static size_t local_ring_put(FAR struct local_ring_s *ring,
+                             FAR const uint8_t *src, size_t len)
+{
+  uint32_t tail = ring->lr_tail;
+  uint32_t off = tail & LOCAL_RING_MASK;
+  size_t first;
+
+  len = MIN(len, LOCAL_RING_SPACE(ring));
+  first = MIN(len, CONFIG_NET_LOCAL_RING_SIZE - off);
+
+  /* Read the head before writing over the space it freed */
+
+  SEQ_DMB();
+  memcpy(&ring->lr_buf[off], src, first);
+  memcpy(ring->lr_buf, src + first, len - first);
+
+  /* Publish the data only once it is written */
+
+  SEQ_DMB();
+  ring->lr_tail = tail + len;
+  return len;
+}
+
+/****************************************************************************
+ * Name: local_ring_get
+ *
+ * Description:
+ *   Copy up to 'len' bytes of the ring to 'dest', leaving them in the ring
+ *   if 'peek'.  Only called by the reader.
+ *
+ ****************************************************************************/
+
+static size_t local_ring_get(FAR struct local_ring_s *ring,
+                             FAR uint8_t *dest, size_t len, bool peek)
+{
+  uint32_t head = ring->lr_head;
+  uint32_t off = head & LOCAL_RING_MASK;
+  size_t first;
+
+  len = MIN(len, LOCAL_RING_USED(ring));
+  first = MIN(len, CONFIG_NET_LOCAL_RING_SIZE - off);
+
+  /* Read the tail before the data it published */
+
+  SEQ_DMB();
+  memcpy(dest, &ring->lr_buf[off], first);
+  memcpy(dest + first, ring->lr_buf, len - first);
+
+  if (!peek)
+    {
+      /* Free the space only once the data is read */
+
+      SEQ_DMB();
+      ring->lr_head = head + len;
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: local_ring_gethoff
+ *
+ * Description:
+ *   Copy up to 'len' bytes straight from the memory handed off by a
+ *   blocked sender.  The ring is drained first: the sender put its earlier
+ *   data there before the handoff.
+ *
+ ****************************************************************************/
+
+#ifdef LOCAL_RING_HANDOFF
+static size_t local_ring_gethoff(FAR struct local_ring_s *ring,
+                                 FAR uint8_t *dest, size_t len, bool peek)
+{
+  size_t copied = 0;
+
+  nxmutex_lock(&ring->lr_hofflock);
+
+  if (ring->lr_hoff != NULL && LOCAL_RING_USED(ring) == 0)
+    {
+      copied = MIN(len, ring->lr_hofflen - ring->lr_hoffpos);
+      memcpy(dest, ring->lr_hoff + ring->lr_hoffpos, copied);
+
+      if (!peek)
+        {
+          ring->lr_hoffpos += copied;
+          if (ring->lr_hoffpos == ring->lr_hofflen)
+            {
+              local_ring_post(&ring->lr_wrsem);
+            }
+        }
+    }
+
+  nxmutex_unlock(&ring->lr_hofflock);
+  return copied;
+}
+
+/****************************************************************************
+ * Name: local_ring_handoff
+ *
+ * Description:
+ *   Let the reader copy 'len' bytes straight from the memory of the
+ *   sender, and wait until it has.
+ *
+ * Returned Value:
+ *   The number of bytes read by the peer; a negated errno value if none
+ *   was.
+ *
+ ****************************************************************************/
+
+static ssize_t local_ring_handoff(FAR struct local_ring_s *ring,
+                                  FAR const uint8_t *src, size_t len,
+                                  unsigned int timeout)
+{
+  size_t done;
+  int ret;
+
+  nxmutex_lock(&ring->lr_hofflock);
+  ring->lr_hoff    = src;
+  ring->lr_hofflen = len;
+  ring->lr_hoffpos = 0;
+  nxmutex_unlock(&ring->lr_hofflock);
+
+  local_ring_post(&ring->lr_rdsem);
+  local_ring_notify(ring, ring->lr_rdfds, POLLIN);
+
+  for (; ; )
+    {
+      ret = local_ring_wait(&ring->lr_wrsem, timeout);
+
+      nxmutex_lock(&ring->lr_hofflock);
+      done = ring->lr_hoffpos;
+      if (done == len || ret < 0 || ring->lr_rdclosed)
+        {
+          /* Take the memory back, the reader may not use it any more */
+
+          ring->lr_hoff = NULL;
+          nxmutex_unlock(&ring->lr_hofflock);
+          break;
+        }
+
+      nxmutex_unlock(&ring->lr_hofflock);
+    }
+
+  if (done > 0)
+    {
+      return done;
+    }
+
+  return ring->lr_rdclosed ? -EPIPE : ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: local_ring_addfds
+ *
+ * Description:
+ *   Add a poll waiter to a waiter list of a ring.
+ *
+ ****************************************************************************/
+
+static int local_ring_addfds(FAR struct local_ring_s *ring,
+                             FAR struct pollfd **list,
+                             FAR struct pollfd *fds)
+{
+  irqstate_t flags;
+  int ret = -EBUSY;
+  int i;
+
+  flags = spin_lock_irqsave(&ring->lr_lock);
+
+  for (i = 0; i < LOCAL_NPOLLWAITERS; i++)
+    {
+      if (list[i] == NULL)
+        {
+          list[i] = fds;
+          ret = OK;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&ring->lr_lock, flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_remfds
+ *
+ * Description:
+ *   Remove a poll waiter from a waiter list of a ring.
+ *
+ ****************************************************************************/
+
+static void local_ring_remfds(FAR struct local_ring_s *ring,
+                              FAR struct pollfd **list,
+                              FAR struct pollfd *fds)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = spin_lock_irqsave(&ring->lr_lock);
+
+  for (i = 0; i < LOCAL_NPOLLWAITERS; i++)
+    {
+      if (list[i] == fds)
+        {
+          list[i] = NULL;
+        }
+    }
+
+  spin_unlock_irqrestore(&ring->lr_lock, flags);
+}
+
+/****************************************************************************
+ * Name: local_ring_init
+ ****************************************************************************/
+
+static void local_ring_init(FAR struct local_ring_s *ring)
+{
+  nxsem_init(&ring->lr_rdsem, 0, 0);
+  nxsem_init(&ring->lr_wrsem, 0, 0);
+  spin_initialize(&ring->lr_lock, SP_UNLOCKED);
+#ifdef LOCAL_RING_HANDOFF
+  nxmutex_init(&ring->lr_hofflock);
+#endif
+}
+
+/****************************************************************************
+ * Name: local_ring_destroy
+ ****************************************************************************/
+
+static void local_ring_destroy(FAR struct local_ring_s *ring)
+{
+  nxsem_destroy(&ring->lr_rdsem);
+  nxsem_destroy(&ring->lr_wrsem);
+#ifdef LOCAL_RING_HANDOFF
+  nxmutex_destroy(&ring->lr_hofflock);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_connect
+ *
+ * Description:
+ *   Connect two stream connections through a new pair of rings.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the rings cannot be allocated.
+ *
+ ****************************************************************************/
+
+int local_ring_connect(FAR struct local_conn_s *conn0,
+                       FAR struct local_conn_s *conn1)
+{
+  FAR struct local_rpair_s *pair;
+
+  DEBUGASSERT(conn0->lc_rpair == NULL && conn1->lc_rpair == NULL);
+
+  pair = kmm_zalloc(sizeof(struct local_rpair_s));
+  if (pair == NULL)
+    {
+      nerr("ERROR: Failed to allocate the rings\n");
+      return -ENOMEM;
+    }
+
+  local_ring_init(&pair->lp_ring[0]);
+  local_ring_init(&pair->lp_ring[1]);
+  pair->lp_crefs = 2;
+
+  conn0->lc_rpair = pair;
+  conn0->lc_rx    = &pair->lp_ring[0];
+  conn0->lc_tx    = &pair->lp_ring[1];
+
+  conn1->lc_rpair = pair;
+  conn1->lc_rx    = &pair->lp_ring[1];
+  conn1->lc_tx    = &pair->lp_ring[0];
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_shutdown
+ *
+ * Description:
+ *   Shut down the directions of a connection selected by 'how' (SHUT_RD,
+ *   SHUT_WR or SHUT_RDWR).
+ *
+ ****************************************************************************/
+
+void local_ring_shutdown(FAR struct local_conn_s *conn, int how)
+{
+  if (conn->lc_rpair == NULL)
+    {
+      return;
+    }
+
+  if ((how & SHUT_RD) != 0)
+    {
+      /* The peer writing to this side gets EPIPE */
+
+      conn->lc_rx->lr_rdclosed = true;
+      local_ring_post(&conn->lc_rx->lr_wrsem);
+      local_ring_post(&conn->lc_rx->lr_rdsem);
+      local_ring_notify(conn->lc_rx, conn->lc_rx->lr_wrfds, POLLERR);
+      local_ring_notify(conn->lc_rx, conn->lc_rx->lr_rdfds, POLLIN);
+    }
+
+  if ((how & SHUT_WR) != 0)
+    {
+      /* The peer reads the end of the stream */
+
+      conn->lc_tx->lr_wrclosed = true;
+      local_ring_post(&conn->lc_tx->lr_rdsem);
+      local_ring_post(&conn->lc_tx->lr_wrsem);
+      local_ring_notify(conn->lc_tx, conn->lc_tx->lr_rdfds,
+                        POLLIN | POLLHUP);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Shut down both directions of a connection and drop its reference to
+ *   the rings, freed with the last one.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_ring_release(FAR struct local_conn_s *conn)
+{
+  FAR struct local_rpair_s *pair = conn->lc_rpair;
+
+  if (pair == NULL)
+    {
+      return;
+    }
+
+  local_ring_shutdown(conn, SHUT_RDWR);
+
+  conn->lc_rpair = NULL;
+  conn->lc_rx    = NULL;
+  conn->lc_tx    = NULL;
+
+  DEBUGASSERT(pair->lp_crefs > 0);
+  if (--pair->lp_crefs == 0)
+    {
+      local_ring_destroy(&pair->lp_ring[0]);
+      local_ring_destroy(&pair->lp_ring[1]);
+      kmm_free(pair);
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Write the data of 'buf', an array of 'len' I/O vectors, to the ring of
+ *   the peer.
+ *
+ * Returned Value:
+ *   The number of bytes sent; a negated errno value if none was.
+ *
+ * Assumptions:
+ *   The caller holds lc_sendlock.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn,
+                        FAR const struct iovec *buf, size_t len,
+                        int flags)
+{
+  FAR struct local_ring_s *ring = conn->lc_tx;
+  bool nonblock = _SS_ISNONBLOCK(conn->lc_conn.s_flags) ||
+                  (flags & MSG_DONTWAIT) != 0;
+  unsigned int timeout = _SO_TIMEOUT(conn->lc_conn.s_sndtimeo);
+  ssize_t total = 0;
+  ssize_t ret = OK;
+  size_t i;
+
+  for (i = 0; i < len; i++)
+    {
+      FAR const uint8_t *src = buf[i].iov_base;
+      size_t remaining = buf[i].iov_len;
+
+#ifdef LOCAL_RING_HANDOFF
+      if (!nonblock && remaining >= CONFIG_NET_LOCAL_RING_HANDOFF &&
+          !ring->lr_rdclosed && !ring->lr_wrclosed)
+        {
+          ret = local_ring_handoff(ring, src, remaining, timeout);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+
+          total += ret;
+          if ((size_t)ret < remaining)
+            {
+              return total;
+            }
+
+          continue;
+        }
+#endif
+
+      while (remaining > 0)
+        {
+          size_t copied;
+
+          if (ring->lr_rdclosed || ring->lr_wrclosed)
+            {
+              ret = -EPIPE;
+              goto errout;
+            }
+
+          copied = local_ring_put(ring, src, remaining);
+          if (copied > 0)
+            {
+              local_ring_post(&ring->lr_rdsem);
+              local_ring_notify(ring, ring->lr_rdfds, POLLIN);
+
+              src       += copied;
+              remaining -= copied;
+              total     += copied;
+              continue;
+            }
+
+          /* The ring is full, wait for the reader */
+
+          if (nonblock)
+            {
+              ret = -EAGAIN;
+              goto errout;
+            }
+
+          ret = local_ring_wait(&ring->lr_wrsem, timeout);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+        }
+    }
+
+  return total;
+
+errout:
+  return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Read up to 'len' bytes from the ring of a connection.
+ *
+ * Returned Value:
+ *   The number of bytes received, zero once the peer has shut down its
+ *   side; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR void *buf,
+                        size_t len, int flags)
+{
+  FAR struct local_ring_s *ring = conn->lc_rx;
+  bool nonblock = _SS_ISNONBLOCK(conn->lc_conn.s_flags) ||
+                  (flags & MSG_DONTWAIT) != 0;
+  unsigned int timeout = _SO_TIMEOUT(conn->lc_conn.s_rcvtimeo);
+  bool peek = (flags & MSG_PEEK) != 0;
+  size_t copied;
+  bool closed;
+  int ret;
+
+  for (; ; )
+    {
+      /* Sample the shutdown first, the data written before is then seen */
+
+      closed = ring->lr_wrclosed || ring->lr_rdclosed;
+      SEQ_DMB();
+
+      copied = local_ring_get(ring, buf, len, peek);
+#ifdef LOCAL_RING_HANDOFF
+      if (copied < len)
+        {
+          copied += local_ring_gethoff(ring, (FAR uint8_t *)buf + copied,
+                                       len - copied, peek);
+        }
+#endif
+
+      if (copied > 0)
+        {
+          if (!peek)
+            {
+              local_ring_post(&ring->lr_wrsem);
+              local_ring_notify(ring, ring->lr_wrfds, POLLOUT);
+            }
+
+          return copied;
+        }
+
+      if (closed || len == 0)
+        {
+          return 0;
+        }
+
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      ret = local_ring_wait(&ring->lr_rdsem, timeout);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_poll
+ *
+ * Description:
+ *   Setup or teardown the monitoring of the rings of a connection.
+ *
+ ****************************************************************************/
+
+int local_ring_poll(FAR struct local_conn_s *conn, FAR struct pollfd *fds,
+                    bool setup)
+{
+  FAR struct local_ring_s *rx = conn->lc_rx;
+  FAR struct local_ring_s *tx = conn->lc_tx;
+  pollevent_t eventset = 0;
+  int ret;
+
+  if (!setup)
+    {
+      local_ring_remfds(rx, rx->lr_rdfds, fds);
+      local_ring_remfds(tx, tx->lr_wrfds, fds);
+      fds->priv = NULL;
+      return OK;
+    }
+
+  /* Readers are always registered, for POLLHUP */
+
+  ret = local_ring_addfds(rx, rx->lr_rdfds, fds);
+  if (ret >= 0 && (fds->events & POLLOUT) != 0)
+    {
+      ret = local_ring_addfds(tx, tx->lr_wrfds, fds);
+      if (ret < 0)
+        {
+          local_ring_remfds(rx, rx->lr_rdfds, fds);
+        }
+    }
+
+  if (ret < 0)
+    {
+      fds->priv = NULL;
+      return ret;
+    }
+
+  fds->priv = rx;
+
+  if (LOCAL_RING_USED(rx) > 0 || LOCAL_RING_HOFFLEN(rx) > 0 ||
+      rx->lr_wrclosed || rx->lr_rdclosed)
+    {
+      eventset |= POLLIN;
+    }
+
+  if (rx->lr_wrclosed)
+    {
+      eventset |= POLLHUP;
+    }
+
+  if (tx->lr_rdclosed)
+    {
+      eventset |= POLLERR;
+    }
+  else if (LOCAL_RING_SPACE(tx) > 0 && !tx->lr_wrclosed)
+    {
+      eventset |= POLLOUT;
+    }
+
+  poll_notify(&fds, 1, eventset);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_ioctl
+ *
+ * Description:
+ *   Handle the FIFO ioctl commands for a connection using the rings.
+ *
+ * Returned Value:
+ *   -ENOTTY if the command is not one of the ring commands.
+ *
+ ****************************************************************************/
+
+int local_ring_ioctl(FAR struct local_conn_s *conn, int cmd,
+                     unsigned long arg)
+{
+  FAR int *value = (FAR int *)((uintptr_t)arg);
+
+  switch (cmd)
+    {
+      case FIONBIO:
+
+        /* The rings follow the non-blocking flag of the socket */
+
+        return OK;
+
+      case FIONREAD:
+        *value = LOCAL_RING_USED(conn->lc_rx) +
+                 LOCAL_RING_HOFFLEN(conn->lc_rx);
+        return OK;
+
+      case FIONWRITE:
+        *value = LOCAL_RING_USED(conn->lc_tx);
+        return OK;
+
+      case FIONSPACE:
+        *value = LOCAL_RING_SPACE(conn->lc_tx);
+        return OK;
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+#endif /* CONFIG_NET_LOCAL_STREAM_RING */
@@ -182,6 +182,35 @@ static ssize_t local_send(FAR struct socket *psock,
           DEBUGASSERT(buf);
           peer = psock->s_conn;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+          /* A connected stream writes straight to the ring of the peer */
+
+          if (psock->s_type == SOCK_STREAM)
+            {
+              if (peer->lc_state != LOCAL_STATE_CONNECTED ||
+                  peer->lc_tx == NULL)
+                {
+                  if (peer->lc_state == LOCAL_STATE_CONNECTING)
+                    {
+                      return -EAGAIN;
+                    }
+
+                  nerr("ERROR: not connected\n");
+                  return -ENOTCONN;
+                }
+
+              ret = nxmutex_lock(&peer->lc_sendlock);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+
+              ret = local_ring_send(peer, buf, len, flags);
+              nxmutex_unlock(&peer->lc_sendlock);
+              break;
+            }
+#endif
+
           /* Verify that this is a connected peer socket and that it has
            * opened the outgoing FIFO for write-only access.
            */
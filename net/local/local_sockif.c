@@ -820,6 +820,19 @@ static int local_ioctl(FAR struct socket *psock, int cmd, unsigned long arg)
 
   conn = psock->s_conn;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+  if (conn->lc_rpair != NULL)
+    {
+      ret = local_ring_ioctl(conn, cmd, arg);
+      if (ret != -ENOTTY)
+        {
+          return ret;
+        }
+
+      ret = OK;
+    }
+#endif
+
   switch (cmd)
     {
       case FIONBIO:
@@ -925,6 +938,23 @@ static int local_socketpair(FAR struct socket *psocks[2])
                            = -1;
 #endif
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+  /* A stream pair is connected through the rings */
+
+  if (psocks[0]->s_type == SOCK_STREAM)
+    {
+      ret = local_ring_connect(conns[0], conns[1]);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      conns[0]->lc_state = conns[1]->lc_state
+                         = LOCAL_STATE_CONNECTED;
+      return OK;
+    }
+#endif
+
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(conns[0]);
@@ -1018,6 +1048,15 @@ static int local_shutdown(FAR struct socket *psock, int how)
       case SOCK_STREAM:
         {
           FAR struct local_conn_s *conn = psock->s_conn;
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+          if (conn->lc_rpair != NULL)
+            {
+              local_ring_shutdown(conn, how);
+              return OK;
+            }
+#endif
+
           if (how & SHUT_RD)
             {
               if (conn->lc_infile.f_inode != NULL)
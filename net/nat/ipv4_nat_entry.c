@@ -32,6 +32,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/queue.h>
+#include <nuttx/net/netstats.h>
 
 #include "icmp/icmp.h"
 #include "nat/nat.h"
@@ -49,6 +50,19 @@
 #define NAT_PORT_REASSIGN_MAX 32000
 #define NAT_PORT_REASSIGN_MIN 4096
 
+/* The timer wheel has a slot for each second */
+
+#define NAT_WHEEL_SLOTS       (1 << CONFIG_NET_NAT_WHEEL_BITS)
+#define NAT_WHEEL_MASK        (NAT_WHEEL_SLOTS - 1)
+
+#ifdef CONFIG_NET_STATISTICS
+#  define NAT_STATS(f)        (g_netstats.nat.f++)
+#  define NAT_ENTRIES(n)      (g_netstats.nat.entries += (n))
+#else
+#  define NAT_STATS(f)
+#  define NAT_ENTRIES(n)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -56,6 +70,11 @@
 static DECLARE_HASHTABLE(g_table_inbound, CONFIG_NET_NAT_HASH_BITS);
 static DECLARE_HASHTABLE(g_table_outbound, CONFIG_NET_NAT_HASH_BITS);
 
+/* The entries by expiration time, and the last second the wheel expired */
+
+static dq_queue_t g_nat_wheel[NAT_WHEEL_SLOTS];
+static int32_t g_nat_wheel_time;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -283,6 +302,23 @@ static void ipv4_nat_entry_refresh(FAR struct ipv4_nat_entry *entry)
   }
 }
 
+/****************************************************************************
+ * Name: ipv4_nat_entry_schedule
+ *
+ * Description:
+ *   Put a NAT entry in the slot of the timer wheel of its expiration time.
+ *
+ * Input Parameters:
+ *   entry      - The entry to schedule.
+ *
+ ****************************************************************************/
+
+static void ipv4_nat_entry_schedule(FAR struct ipv4_nat_entry *entry)
+{
+  entry->wheel_slot = entry->expire_time & NAT_WHEEL_MASK;
+  dq_addlast(&entry->wheel_node, &g_nat_wheel[entry->wheel_slot]);
+}
+
 /****************************************************************************
  * Name: ipv4_nat_entry_create
  *
@@ -321,12 +357,15 @@ ipv4_nat_entry_create(uint8_t protocol,
   entry->local_port    = local_port;
 
   ipv4_nat_entry_refresh(entry);
+  ipv4_nat_entry_schedule(entry);
 
   hashtable_add(g_table_inbound, &entry->hash_inbound,
                 ipv4_nat_inbound_key(external_ip, external_port, protocol));
   hashtable_add(g_table_outbound, &entry->hash_outbound,
                 ipv4_nat_outbound_key(local_ip, local_port, protocol));
 
+  NAT_STATS(created);
+  NAT_ENTRIES(1);
   return entry;
 }
 
@@ -355,57 +394,72 @@ static void ipv4_nat_entry_delete(FAR struct ipv4_nat_entry *entry)
   hashtable_delete(g_table_outbound, &entry->hash_outbound,
                    ipv4_nat_outbound_key(entry->local_ip, entry->local_port,
                                          entry->protocol));
+  dq_rem(&entry->wheel_node, &g_nat_wheel[entry->wheel_slot]);
 
+  NAT_ENTRIES(-1);
   kmm_free(entry);
 }
 
 /****************************************************************************
- * Name: ipv4_nat_reclaim_entry
+ * Name: ipv4_nat_wheel_advance
  *
  * Description:
- *   Try reclaim all expired NAT entries.
- *   Only works after every CONFIG_NET_NAT_ENTRY_RECLAIM_SEC (low frequency).
+ *   Expire the NAT entries of the slots of the timer wheel for the seconds
+ *   since the last call, at most one turn of the wheel.  An entry that was
+ *   refreshed since it was scheduled moves to the slot of its new
+ *   expiration time, an entry of a later turn stays.
  *
- *   Although expired entries will be automatically reclaimed when matching
- *   inbound/outbound entries, there might be some situations that entries
- *   will be kept in memory, e.g. big hashtable with only a few connections.
+ *   The work is spread over the lookups, in proportion to the number of
+ *   entries and the time elapsed, instead of scanning all entries.
  *
- * Assumptions:
- *   NAT is initialized.
+ * Input Parameters:
+ *   current_time - The current time in seconds.
  *
  ****************************************************************************/
 
-#if CONFIG_NET_NAT_ENTRY_RECLAIM_SEC > 0
-static void ipv4_nat_reclaim_entry(int32_t current_time)
+static void ipv4_nat_wheel_advance(int32_t current_time)
 {
-  static int32_t next_reclaim_time = CONFIG_NET_NAT_ENTRY_RECLAIM_SEC;
+  int32_t steps = current_time - g_nat_wheel_time;
+  int32_t i;
 
-  if (next_reclaim_time - current_time <= 0)
+  if (steps <= 0)
     {
-      FAR hash_node_t *p;
-      FAR hash_node_t *tmp;
-      int count = 0;
-      int i;
+      return;
+    }
 
-      ninfo("INFO: Reclaiming all expired NAT entries.\n");
+  if (steps > NAT_WHEEL_SLOTS)
+    {
+      steps = NAT_WHEEL_SLOTS;
+    }
+
+  for (i = 0; i < steps; i++)
+    {
+      uint16_t slot = (current_time - i) & NAT_WHEEL_MASK;
+      FAR dq_entry_t *node;
+      FAR dq_entry_t *next;
 
-      hashtable_for_every_safe(g_table_inbound, p, tmp, i)
+      for (node = dq_peek(&g_nat_wheel[slot]); node != NULL; node = next)
         {
           FAR struct ipv4_nat_entry *entry =
-            container_of(p, struct ipv4_nat_entry, hash_inbound);
+            container_of(node, struct ipv4_nat_entry, wheel_node);
+
+          next = dq_next(node);
 
           if (entry->expire_time - current_time <= 0)
             {
+              NAT_STATS(expired);
               ipv4_nat_entry_delete(entry);
-              count++;
+            }
+          else if ((entry->expire_time & NAT_WHEEL_MASK) != slot)
+            {
+              dq_rem(node, &g_nat_wheel[slot]);
+              ipv4_nat_entry_schedule(entry);
             }
         }
-
-      ninfo("INFO: %d expired NAT entries reclaimed.\n", count);
-      next_reclaim_time = current_time + CONFIG_NET_NAT_ENTRY_RECLAIM_SEC;
     }
+
+  g_nat_wheel_time = current_time;
 }
-#endif
 
 /****************************************************************************
  * Public Functions
@@ -472,9 +526,7 @@ ipv4_nat_inbound_entry_find(uint8_t protocol, in_addr_t external_ip,
   bool skip_ip = net_ipv4addr_cmp(external_ip, INADDR_ANY);
   int32_t current_time = TICK2SEC(clock_systime_ticks());
 
-#if CONFIG_NET_NAT_ENTRY_RECLAIM_SEC > 0
-  ipv4_nat_reclaim_entry(current_time);
-#endif
+  ipv4_nat_wheel_advance(current_time);
 
   hashtable_for_every_possible_safe(g_table_inbound, p, tmp,
                   ipv4_nat_inbound_key(external_ip, external_port, protocol))
@@ -486,6 +538,7 @@ ipv4_nat_inbound_entry_find(uint8_t protocol, in_addr_t external_ip,
 
       if (entry->expire_time - current_time <= 0)
         {
+          NAT_STATS(expired);
           ipv4_nat_entry_delete(entry);
           continue;
         }
@@ -496,6 +549,7 @@ ipv4_nat_inbound_entry_find(uint8_t protocol, in_addr_t external_ip,
         {
           if (refresh)
             {
+              NAT_STATS(inhits);
               ipv4_nat_entry_refresh(entry);
             }
 
@@ -505,6 +559,7 @@ ipv4_nat_inbound_entry_find(uint8_t protocol, in_addr_t external_ip,
 
   if (refresh) /* false = a test of whether entry exists, no need to warn */
     {
+      NAT_STATS(inmisses);
       nwarn("WARNING: Failed to find IPv4 inbound NAT entry for "
             "proto=%" PRIu8 ", external=%" PRIx32 ":%" PRIu16 "\n",
             protocol, external_ip, external_port);
@@ -541,9 +596,7 @@ ipv4_nat_outbound_entry_find(FAR struct net_driver_s *dev, uint8_t protocol,
   FAR hash_node_t *tmp;
   int32_t current_time = TICK2SEC(clock_systime_ticks());
 
-#if CONFIG_NET_NAT_ENTRY_RECLAIM_SEC > 0
-  ipv4_nat_reclaim_entry(current_time);
-#endif
+  ipv4_nat_wheel_advance(current_time);
 
   hashtable_for_every_possible_safe(g_table_outbound, p, tmp,
                       ipv4_nat_outbound_key(local_ip, local_port, protocol))
@@ -555,6 +608,7 @@ ipv4_nat_outbound_entry_find(FAR struct net_driver_s *dev, uint8_t protocol,
 
       if (entry->expire_time - current_time <= 0)
         {
+          NAT_STATS(expired);
           ipv4_nat_entry_delete(entry);
           continue;
         }
@@ -564,11 +618,14 @@ ipv4_nat_outbound_entry_find(FAR struct net_driver_s *dev, uint8_t protocol,
           net_ipv4addr_cmp(entry->local_ip, local_ip) &&
           entry->local_port == local_port)
         {
+          NAT_STATS(outhits);
           ipv4_nat_entry_refresh(entry);
           return entry;
         }
     }
 
+  NAT_STATS(outmisses);
+
   if (!try_create)
     {
       return NULL;
@@ -65,6 +65,14 @@ struct ipv4_nat_entry
   uint8_t    protocol;       /* L4 protocol (TCP, UDP etc). */
 
   int32_t    expire_time;    /* The expiration time of this entry. */
+
+  /* The entry waits for its expiration in a slot of the timer wheel,
+   * chosen by the expiration time when it was scheduled.  A refresh
+   * does not move it, the wheel does when it reaches the slot.
+   */
+
+  dq_entry_t wheel_node;     /* Node in the slot of the timer wheel. */
+  uint16_t   wheel_slot;     /* The slot the entry is in. */
 };
 
 /* NAT IP/Port manipulate type, to indicate whether to manipulate source or
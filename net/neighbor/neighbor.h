@@ -27,9 +27,11 @@
  ****************************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include <net/ethernet.h>
 
+#include <nuttx/queue.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/sixlowpan.h>
@@ -37,6 +39,44 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NEIGHBOR_HASH_SIZE (1 << CONFIG_NET_IPv6_NCONF_HASHBITS)
+
+#define NEIGHBOR_REACHABLE_TICK \
+  SEC2TICK(CONFIG_NET_IPv6_NCONF_REACHABLE)
+#define NEIGHBOR_PROBE_TICK \
+  MSEC2TICK(CONFIG_NET_IPv6_NCONF_PROBE_INTERVAL)
+
+/* An entry is REACHABLE for CONFIG_NET_IPv6_NCONF_REACHABLE seconds after
+ * the mapping is confirmed, then STALE.  A STALE entry is still used, but
+ * its next use moves it to PROBE: unicast Neighbor Solicitations are sent
+ * to confirm the mapping, and the entry is removed if none is answered.
+ */
+
+#define NEIGHBOR_STATE_REACHABLE 0   /* Confirmed, or STALE if old */
+#define NEIGHBOR_STATE_PROBE     1   /* Being confirmed */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A Neighbor Table entry with its lookup state */
+
+struct neighbor_node_s
+{
+  struct neighbor_entry_s     nn_entry;  /* The entry, must be first */
+  FAR struct neighbor_node_s *nn_hnext;  /* Next node of the hash bucket */
+  dq_entry_t                  nn_node;   /* Node of the LRU or free list */
+  dq_entry_t                  nn_pnode;  /* Node of the probe list */
+  FAR struct net_driver_s    *nn_dev;    /* Device the neighbor is on */
+  uint8_t                     nn_state;  /* See NEIGHBOR_STATE_* */
+  uint8_t                     nn_probes; /* Number of probes sent */
+  clock_t                     nn_ptime;  /* Time of last probe */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -45,7 +85,23 @@
  * this table.
  */
 
-extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+extern struct neighbor_node_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
+/* The entries hashed by IPv6 address */
+
+extern FAR struct neighbor_node_s *g_neighbor_hash[NEIGHBOR_HASH_SIZE];
+
+/* The entries in use, the least recently confirmed first, the deleted
+ * entries and the entries in the PROBE state.
+ */
+
+extern dq_queue_t g_neighbor_lru;
+extern dq_queue_t g_neighbor_free;
+extern dq_queue_t g_neighbor_probe;
+
+/* The number of entries of g_neighbors ever used */
+
+extern int g_neighbor_used;
 
 /****************************************************************************
  * Public Function Prototypes
@@ -53,6 +109,82 @@ extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
 struct net_driver_s; /* Forward reference */
 
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the hash bucket of an IPv6 address.
+ *
+ ****************************************************************************/
+
+static inline unsigned int neighbor_hash(const net_ipv6addr_t ipaddr)
+{
+  uint32_t key = ((uint32_t)ipaddr[6] << 16 | ipaddr[7]) ^
+                 ((uint32_t)ipaddr[4] << 16 | ipaddr[5]);
+
+  return (uint32_t)(key * 2654435761u) >>
+         (32 - CONFIG_NET_IPv6_NCONF_HASHBITS);
+}
+
+/****************************************************************************
+ * Name: neighbor_free
+ *
+ * Description:
+ *   Remove an entry from the Neighbor Table.
+ *
+ * Input Parameters:
+ *   node - The node of the entry to remove.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void neighbor_free(FAR struct neighbor_node_s *node);
+
+/****************************************************************************
+ * Name: neighbor_confirm
+ *
+ * Description:
+ *   The mapping of an entry is confirmed: make it REACHABLE and the most
+ *   recently used entry.
+ *
+ * Input Parameters:
+ *   node - The node of the confirmed entry.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void neighbor_confirm(FAR struct neighbor_node_s *node);
+
+/****************************************************************************
+ * Name: neighbor_probe
+ *
+ * Description:
+ *   Format a unicast Neighbor Solicitation in the device buffer to confirm
+ *   the next Neighbor Table entry of the device in the PROBE state that is
+ *   due a probe.  The entries whose probes were not answered are removed.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure
+ *
+ * Returned Value:
+ *   True if a Neighbor Solicitation is ready to be sent.
+ *
+ * Assumptions
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() with the network locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_ICMPv6) && defined(CONFIG_NET_ETHERNET)
+bool neighbor_probe(FAR struct net_driver_s *dev);
+#else
+#  define neighbor_probe(d) (false)
+#endif
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
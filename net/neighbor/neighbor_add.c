@@ -31,6 +31,7 @@
 
 #include <net/if.h>
 
+#include <nuttx/nuttx.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/neighbor.h>
@@ -62,53 +63,70 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_node_s *node;
+  FAR struct neighbor_entry_s *neighbor;
+  FAR dq_entry_t *entry;
+  unsigned int hash;
   uint8_t lltype;
-  clock_t oldest_time;
-  int     oldest_ndx;
-  int     i;
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the matching entry, first unused entry, or the oldest used entry.
-   * The unused entry will have ne_time == 0 and should generate the oldest
-   * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
-   * check might be to compare ne_ipaddr with the IPv6 unspecified address.
+  /* Find the matching entry, else the first free entry, else replace the
+   * least recently confirmed entry.
    */
 
-  oldest_time = g_neighbors[0].ne_time;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  hash   = neighbor_hash(ipaddr);
+  lltype = dev->d_lltype;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (node = g_neighbor_hash[hash]; node != NULL; node = node->nn_hnext)
     {
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
+      if (node->nn_entry.ne_addr.na_lltype == lltype &&
+          net_ipv6addr_cmp(node->nn_entry.ne_ipaddr, ipaddr))
         {
-          oldest_ndx = i;
           break;
         }
+    }
 
-      if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
+  if (node != NULL)
+    {
+      neighbor_confirm(node);
+    }
+  else
+    {
+      entry = dq_remfirst(&g_neighbor_free);
+      if (entry != NULL)
         {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
+          node = container_of(entry, struct neighbor_node_s, nn_node);
+        }
+      else if (g_neighbor_used < CONFIG_NET_IPv6_NCONF_ENTRIES)
+        {
+          node = &g_neighbors[g_neighbor_used++];
+        }
+      else
+        {
+          node = container_of(dq_peek(&g_neighbor_lru),
+                              struct neighbor_node_s, nn_node);
+          neighbor_free(node);
+          dq_rem(&node->nn_node, &g_neighbor_free);
         }
-    }
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+      node->nn_hnext        = g_neighbor_hash[hash];
+      g_neighbor_hash[hash] = node;
+      node->nn_state        = NEIGHBOR_STATE_REACHABLE;
+      dq_addlast(&node->nn_node, &g_neighbor_lru);
+    }
 
-  g_neighbors[oldest_ndx].ne_time = clock_systime_ticks();
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  neighbor = &node->nn_entry;
+  neighbor->ne_time = clock_systime_ticks();
+  net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_lladdrsize(dev);
+  neighbor->ne_addr.na_lltype = lltype;
+  neighbor->ne_addr.na_llsize = netdev_lladdrsize(dev);
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+  memcpy(&neighbor->ne_addr.u, addr, neighbor->ne_addr.na_llsize);
+  node->nn_dev = dev;
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
 }
@@ -51,14 +51,26 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_node_s *node;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (node = g_neighbor_hash[neighbor_hash(ipaddr)]; node != NULL;
+       node = node->nn_hnext)
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
+      FAR struct neighbor_entry_s *neighbor = &node->nn_entry;
 
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
+          /* Remove the entry if its probes were not answered */
+
+          if (node->nn_state == NEIGHBOR_STATE_PROBE &&
+              node->nn_probes >= CONFIG_NET_IPv6_NCONF_PROBES &&
+              clock_systime_ticks() - node->nn_ptime >=
+              NEIGHBOR_PROBE_TICK)
+            {
+              neighbor_free(node);
+              break;
+            }
+
           neighbor_dumpentry("Entry found", neighbor);
           return neighbor;
         }
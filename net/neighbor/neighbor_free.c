@@ -0,0 +1,80 @@
+/****************************************************************************
+ * net/neighbor/neighbor_free.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include "neighbor/neighbor.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_free
+ *
+ * Description:
+ *   Remove an entry from the Neighbor Table.
+ *
+ * Input Parameters:
+ *   node - The node of the entry to remove.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void neighbor_free(FAR struct neighbor_node_s *node)
+{
+  FAR struct neighbor_node_s **prev;
+
+  /* Unlink the node from its hash bucket */
+
+  prev = &g_neighbor_hash[neighbor_hash(node->nn_entry.ne_ipaddr)];
+  while (*prev != NULL && *prev != node)
+    {
+      prev = &(*prev)->nn_hnext;
+    }
+
+  if (*prev != NULL)
+    {
+      *prev = node->nn_hnext;
+    }
+
+  if (node->nn_state == NEIGHBOR_STATE_PROBE)
+    {
+      dq_rem(&node->nn_pnode, &g_neighbor_probe);
+    }
+
+  dq_rem(&node->nn_node, &g_neighbor_lru);
+  dq_addlast(&node->nn_node, &g_neighbor_free);
+
+  /* The unspecified address marks the entry as unused */
+
+  memset(&node->nn_entry, 0, sizeof(node->nn_entry));
+  node->nn_hnext = NULL;
+  node->nn_dev   = NULL;
+  node->nn_state = NEIGHBOR_STATE_REACHABLE;
+}
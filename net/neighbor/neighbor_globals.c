@@ -34,7 +34,23 @@
  * this table.
  */
 
-struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+struct neighbor_node_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
+/* The entries hashed by IPv6 address */
+
+FAR struct neighbor_node_s *g_neighbor_hash[NEIGHBOR_HASH_SIZE];
+
+/* The entries in use, the least recently confirmed first, the deleted
+ * entries and the entries in the PROBE state.
+ */
+
+dq_queue_t g_neighbor_lru;
+dq_queue_t g_neighbor_free;
+dq_queue_t g_neighbor_probe;
+
+/* The number of entries of g_neighbors ever used */
+
+int g_neighbor_used;
 
 /****************************************************************************
  * Public Functions
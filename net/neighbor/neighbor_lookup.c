@@ -114,6 +114,9 @@ int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
                     FAR struct neighbor_addr_s *laddr)
 {
   FAR struct neighbor_entry_s *neighbor;
+#if defined(CONFIG_NET_ICMPv6) && defined(CONFIG_NET_ETHERNET)
+  FAR struct neighbor_node_s *node;
+#endif
   struct neighbor_table_info_s info;
 
   /* Check if the IPv6 address is already in the neighbor table. */
@@ -130,6 +133,25 @@ int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
           memcpy(laddr, &neighbor->ne_addr, sizeof(*laddr));
         }
 
+#if defined(CONFIG_NET_ICMPv6) && defined(CONFIG_NET_ETHERNET)
+      /* A STALE entry is used: confirm it with unicast Neighbor
+       * Solicitations, sent when the device polls for data.
+       */
+
+      node = (FAR struct neighbor_node_s *)neighbor;
+      if (node->nn_state == NEIGHBOR_STATE_REACHABLE &&
+          node->nn_dev->d_lltype == NET_LL_ETHERNET &&
+          clock_systime_ticks() - neighbor->ne_time >
+          NEIGHBOR_REACHABLE_TICK)
+        {
+          node->nn_state  = NEIGHBOR_STATE_PROBE;
+          node->nn_probes = 0;
+          node->nn_ptime  = clock_systime_ticks() - NEIGHBOR_PROBE_TICK;
+          dq_addlast(&node->nn_pnode, &g_neighbor_probe);
+          netdev_txnotify_dev(node->nn_dev);
+        }
+#endif
+
       /* Return success in any case meaning that a valid link layer
        * address mapping is available for the IPv6 address.
        */
@@ -0,0 +1,117 @@
+/****************************************************************************
+ * net/neighbor/neighbor_probe.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/net/icmpv6.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+
+#include "icmpv6/icmpv6.h"
+#include "utils/utils.h"
+#include "neighbor/neighbor.h"
+
+#if defined(CONFIG_NET_ICMPv6) && defined(CONFIG_NET_ETHERNET)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_probe
+ *
+ * Description:
+ *   Format a unicast Neighbor Solicitation in the device buffer to confirm
+ *   the next Neighbor Table entry of the device in the PROBE state that is
+ *   due a probe.  The entries whose probes were not answered are removed.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure
+ *
+ * Returned Value:
+ *   True if a Neighbor Solicitation is ready to be sent.
+ *
+ * Assumptions
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() with the network locked.
+ *
+ ****************************************************************************/
+
+bool neighbor_probe(FAR struct net_driver_s *dev)
+{
+  FAR struct icmpv6_neighbor_solicit_s *sol;
+  FAR struct neighbor_node_s *node;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *next;
+  clock_t now = clock_systime_ticks();
+
+  for (entry = dq_peek(&g_neighbor_probe); entry != NULL; entry = next)
+    {
+      next = dq_next(entry);
+      node = container_of(entry, struct neighbor_node_s, nn_pnode);
+
+      if (node->nn_dev != dev || now - node->nn_ptime < NEIGHBOR_PROBE_TICK)
+        {
+          continue;
+        }
+
+      if (node->nn_probes >= CONFIG_NET_IPv6_NCONF_PROBES)
+        {
+          neighbor_dumpentry("Entry expired", &node->nn_entry);
+          neighbor_free(node);
+          continue;
+        }
+
+      dev->d_len = 0;
+      if (netdev_iob_prepare(dev, false, 0) != OK)
+        {
+          return false;
+        }
+
+      /* Solicit the neighbor directly rather than its solicited-node
+       * multicast address.
+       */
+
+      icmpv6_solicit(dev, node->nn_entry.ne_ipaddr);
+      net_ipv6addr_copy(IPv6BUF->destipaddr, node->nn_entry.ne_ipaddr);
+
+      sol         = IPBUF(IPv6_HDRLEN);
+      sol->chksum = 0;
+      sol->chksum = ~icmpv6_chksum(dev, IPv6_HDRLEN);
+
+      IFF_SET_IPv6(dev->d_flags);
+
+      node->nn_probes++;
+      node->nn_ptime = now;
+      return true;
+    }
+
+  return false;
+}
+
+#endif /* CONFIG_NET_ICMPv6 && CONFIG_NET_ETHERNET */
@@ -30,6 +30,35 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: neighbor_confirm
+ *
+ * Description:
+ *   The mapping of an entry is confirmed: make it REACHABLE and the most
+ *   recently used entry.
+ *
+ * Input Parameters:
+ *   node - The node of the confirmed entry.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void neighbor_confirm(FAR struct neighbor_node_s *node)
+{
+  if (node->nn_state == NEIGHBOR_STATE_PROBE)
+    {
+      dq_rem(&node->nn_pnode, &g_neighbor_probe);
+      node->nn_state = NEIGHBOR_STATE_REACHABLE;
+    }
+
+  dq_rem(&node->nn_node, &g_neighbor_lru);
+  dq_addlast(&node->nn_node, &g_neighbor_lru);
+
+  node->nn_entry.ne_time = clock_systime_ticks();
+}
+
 /****************************************************************************
  * Name: neighbor_update
  *
@@ -53,6 +82,6 @@ void neighbor_update(const net_ipv6addr_t ipaddr)
   neighbor = neighbor_findentry(ipaddr);
   if (neighbor != NULL)
     {
-      neighbor->ne_time = clock_systime_ticks();
+      neighbor_confirm((FAR struct neighbor_node_s *)neighbor);
     }
 }
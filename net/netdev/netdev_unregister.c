@@ -36,7 +36,9 @@
 #include <nuttx/net/netdev.h>
 
 #include "utils/utils.h"
+#include "devif/devif.h"
 #include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -145,6 +147,16 @@ int netdev_unregister(FAR struct net_driver_s *dev)
           curr->flink = NULL;
         }
 
+#ifdef CONFIG_NET_IPFORWARD_FASTPATH
+      /* The cached flows may not refer to the device any longer */
+
+      ipv4_forward_flush(dev);
+#endif
+
+      /* No connection may wait for a poll of the device any longer */
+
+      devif_pend_flush(dev);
+
 #ifdef CONFIG_NETDEV_IFINDEX
       free_ifindex(dev->d_ifindex);
 #endif
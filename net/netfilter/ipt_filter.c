@@ -0,0 +1,1186 @@
+/****************************************************************************
+ * net/netfilter/ipt_filter.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
+
+#include "netfilter/iptables.h"
+
+#ifdef CONFIG_NET_IPTABLES_FILTER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The rule set of a chain is compiled into one lookup per packet field:
+ * the set of the rules that accept the value of the field, as a bitmap.
+ * The rules matching a packet are the intersection of the sets of its
+ * fields, the first of them decides.  The cost of a packet depends on the
+ * number of distinct values in the rules, not on the number of rules.
+ */
+
+#define IPT_FILTER_NWORDS   ((CONFIG_NET_IPTABLES_FILTER_MAXRULES + 31) / 32)
+
+/* The fields looked up in the sorted bounds of their values */
+
+#define IPT_FILTER_SRCIP    0
+#define IPT_FILTER_DSTIP    1
+#define IPT_FILTER_SRCPT    2
+#define IPT_FILTER_DSTPT    3
+#define IPT_FILTER_NRANGES  4
+
+/* The interface fields */
+
+#define IPT_FILTER_IN       0
+#define IPT_FILTER_OUT      1
+
+/* A field of a rule accepts one range of values, two if inverted */
+
+#define IPT_FILTER_MAXRANGES 2
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A field with 32-bit values: the values are split in intervals at the
+ * bounds of the ranges of the rules, all the values of an interval are
+ * matched by the same rules.
+ */
+
+struct ipt_filter_ranges_s
+{
+  uint16_t nbounds;          /* Number of intervals */
+  FAR uint32_t *bounds;      /* Lowest value of each interval, ascending */
+  FAR uint32_t *bitmaps;     /* The rules matching each interval */
+};
+
+/* A field with 8-bit values: each value has a class of the values matched
+ * by the same rules.
+ */
+
+struct ipt_filter_classes_s
+{
+  uint8_t map[256];          /* The class of each value */
+  FAR uint32_t *bitmaps;     /* The rules matching each class */
+};
+
+/* An interface name pattern of the rules */
+
+struct ipt_filter_iface_s
+{
+  char    name[IFNAMSIZ];
+  uint8_t mask[IFNAMSIZ];
+  bool    inv;
+};
+
+struct ipt_filter_ifaces_s
+{
+  uint16_t npatterns;
+  FAR struct ipt_filter_iface_s *patterns;
+  FAR uint32_t *bitmaps;     /* The rules of each pattern, then the rules
+                              * matching any interface */
+};
+
+/* The compiled rules of a hook */
+
+struct ipt_filter_chain_s
+{
+  uint16_t nrules;           /* Number of rules deciding a verdict */
+  uint16_t nwords;           /* Number of words of a bitmap */
+  uint8_t  policy;           /* The verdict if no rule matches */
+  FAR uint8_t *verdicts;     /* The verdict of each rule */
+  FAR uint32_t *frag;        /* The rules able to match a packet that is
+                              * not a fragment, then a fragment */
+  struct ipt_filter_ranges_s  ranges[IPT_FILTER_NRANGES];
+  struct ipt_filter_classes_s proto;
+  struct ipt_filter_classes_s tcpflags;
+  struct ipt_filter_ifaces_s  ifaces[2];
+};
+
+/* A rule while it is compiled */
+
+struct ipt_filter_range_s
+{
+  uint32_t lo;
+  uint32_t hi;
+};
+
+struct ipt_filter_rule_s
+{
+  FAR const struct ipt_entry *entry;
+  struct ipt_filter_range_s ranges[IPT_FILTER_NRANGES][IPT_FILTER_MAXRANGES];
+  uint8_t  nranges[IPT_FILTER_NRANGES];
+  uint8_t  proto;
+  bool     proto_inv;
+  bool     l4;               /* The rule matches the TCP or UDP header */
+  bool     flg;              /* The rule matches the TCP flags */
+  bool     flg_inv;
+  uint8_t  flg_mask;
+  uint8_t  flg_cmp;
+  uint8_t  verdict;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR struct ipt_filter_chain_s *g_filter_chains[NF_INET_NUMHOOKS];
+
+/* The name matched by the rules on the interface of a hook that has none */
+
+static const char g_filter_noname[IFNAMSIZ];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipt_filter_cmp
+ *
+ * Description:
+ *   Compare two bounds for qsort().
+ *
+ ****************************************************************************/
+
+static int ipt_filter_cmp(FAR const void *a, FAR const void *b)
+{
+  uint32_t x = *(FAR const uint32_t *)a;
+  uint32_t y = *(FAR const uint32_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+/****************************************************************************
+ * Name: ipt_filter_search
+ *
+ * Description:
+ *   Find the interval of a value.
+ *
+ ****************************************************************************/
+
+static int ipt_filter_search(FAR const struct ipt_filter_ranges_s *ranges,
+                             uint32_t value)
+{
+  int lo = 0;
+  int hi = ranges->nbounds - 1;
+
+  /* bounds[0] is zero, find the last bound not above the value */
+
+  while (lo < hi)
+    {
+      int mid = (lo + hi + 1) >> 1;
+
+      if (ranges->bounds[mid] <= value)
+        {
+          lo = mid;
+        }
+      else
+        {
+          hi = mid - 1;
+        }
+    }
+
+  return lo;
+}
+
+/****************************************************************************
+ * Name: ipt_filter_setrange
+ *
+ * Description:
+ *   Set the values of a field accepted by a rule to lo..hi, or to the
+ *   values out of lo..hi if inverted.
+ *
+ ****************************************************************************/
+
+static void ipt_filter_setrange(FAR struct ipt_filter_rule_s *rule,
+                                int field, uint32_t lo, uint32_t hi,
+                                bool inv)
+{
+  FAR struct ipt_filter_range_s *range = rule->ranges[field];
+  int n = 0;
+
+  if (!inv)
+    {
+      range[n].lo   = lo;
+      range[n++].hi = hi;
+    }
+  else
+    {
+      if (lo > 0)
+        {
+          range[n].lo   = 0;
+          range[n++].hi = lo - 1;
+        }
+
+      if (hi < UINT32_MAX)
+        {
+          range[n].lo   = hi + 1;
+          range[n++].hi = UINT32_MAX;
+        }
+    }
+
+  rule->nranges[field] = n;
+}
+
+/****************************************************************************
+ * Name: ipt_filter_setaddr
+ *
+ * Description:
+ *   Set the addresses accepted by a rule from an address and mask.
+ *
+ ****************************************************************************/
+
+static void ipt_filter_setaddr(FAR struct ipt_filter_rule_s *rule,
+                               int field, struct in_addr addr,
+                               struct in_addr mask, bool inv)
+{
+  uint32_t hmask = NTOHL(mask.s_addr);
+  uint32_t lo    = NTOHL(addr.s_addr) & hmask;
+
+  ipt_filter_setrange(rule, field, lo, lo | ~hmask, inv);
+}
+
+/****************************************************************************
+ * Name: ipt_filter_parse_match
+ *
+ * Description:
+ *   Parse the tcp or udp match of a rule.
+ *
+ ****************************************************************************/
+
+static int ipt_filter_parse_match(FAR struct ipt_filter_rule_s *rule,
+                                  FAR const struct xt_entry_match *match)
+{
+  FAR const struct ipt_ip *ip = &rule->entry->ip;
+  size_t datalen = match->u.match_size -
+                   offsetof(struct xt_entry_match, data);
+
+  if (strcmp(match->u.user.name, XT_TCP_MATCH) == 0)
+    {
+      FAR const struct xt_tcp *tcp = (FAR const void *)match->data;
+
+      if (datalen < sizeof(*tcp) || ip->proto != IP_PROTO_TCP ||
+          (ip->invflags & IPT_INV_PROTO) != 0 ||
+          (tcp->invflags & ~XT_TCP_INV_MASK) != 0)
+        {
+          return -EINVAL;
+        }
+
+      if (tcp->option != 0)
+        {
+          nwarn("WARNING: TCP option match not supported\n");
+          return -EOPNOTSUPP;
+        }
+
+      ipt_filter_setrange(rule, IPT_FILTER_SRCPT, tcp->spts[0],
+                          tcp->spts[1],
+                          (tcp->invflags & XT_TCP_INV_SRCPT) != 0);
+      ipt_filter_setrange(rule, IPT_FILTER_DSTPT, tcp->dpts[0],
+                          tcp->dpts[1],
+                          (tcp->invflags & XT_TCP_INV_DSTPT) != 0);
+
+      rule->flg      = tcp->flg_mask != 0 ||
+                       (tcp->invflags & XT_TCP_INV_FLAGS) != 0;
+      rule->flg_inv  = (tcp->invflags & XT_TCP_INV_FLAGS) != 0;
+      rule->flg_mask = tcp->flg_mask;
+      rule->flg_cmp  = tcp->flg_cmp;
+    }
+  else if (strcmp(match->u.user.name, XT_UDP_MATCH) == 0)
+    {
+      FAR const struct xt_udp *udp = (FAR const void *)match->data;
+
+      if (datalen < sizeof(*udp) || ip->proto != IP_PROTO_UDP ||
+          (ip->invflags & IPT_INV_PROTO) != 0 ||
+          (udp->invflags & ~XT_UDP_INV_MASK) != 0)
+        {
+          return -EINVAL;
+        }
+
+      ipt_filter_setrange(rule, IPT_FILTER_SRCPT, udp->spts[0],
+                          udp->spts[1],
+                          (udp->invflags & XT_UDP_INV_SRCPT) != 0);
+      ipt_filter_setrange(rule, IPT_FILTER_DSTPT, udp->dpts[0],
+                          udp->dpts[1],
+                          (udp->invflags & XT_UDP_INV_DSTPT) != 0);
+    }
+  else
+    {
+      nwarn("WARNING: Match %s not supported\n", match->u.user.name);
+      return -EOPNOTSUPP;
+    }
+
+  rule->l4 = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipt_filter_parse
+ *
+ * Description:
+ *   Parse an entry of a chain.
+ *
+ * Returned Value:
+ *   1 if the entry decides a verdict, 0 if it only falls through to the
+ *   next entry, a negated errno value if it cannot be compiled.
+ *
+ ****************************************************************************/
+
+static int ipt_filter_parse(FAR const struct ipt_replace *repl,
+                            FAR const struct ipt_entry *entry,
+                            FAR struct ipt_filter_rule_s *rule)
+{
+  FAR const struct ipt_ip *ip = &entry->ip;
+  FAR const struct xt_standard_target *target;
+  size_t offset;
+  int verdict;
+  int field;
+  int ret;
+
+  target = (FAR const struct xt_standard_target *)IPT_TARGET(entry);
+  if (entry->target_offset + sizeof(*target) > entry->next_offset)
+    {
+      return -EINVAL;
+    }
+
+  if (strcmp(target->target.u.user.name, XT_STANDARD_TARGET) != 0)
+    {
+      nwarn("WARNING: Target %s not supported\n",
+            target->target.u.user.name);
+      return strcmp(target->target.u.user.name, XT_ERROR_TARGET) == 0 ?
+             -EINVAL : -EOPNOTSUPP;
+    }
+
+  verdict = target->verdict;
+  if (verdict == -NF_ACCEPT - 1 || verdict == -NF_DROP - 1)
+    {
+      rule->verdict = -verdict - 1;
+    }
+  else if (verdict == (FAR const uint8_t *)entry + entry->next_offset -
+                      (FAR const uint8_t *)repl->entries)
+    {
+      /* A rule without target, only counting the matched packets */
+
+      return 0;
+    }
+  else
+    {
+      nwarn("WARNING: Jumps to user chains not supported\n");
+      return -EOPNOTSUPP;
+    }
+
+  if ((ip->flags & ~IPT_F_MASK) != 0 || (ip->flags & IPT_F_GOTO) != 0 ||
+      (ip->invflags & ~IPT_INV_MASK) != 0 ||
+      (ip->invflags & IPT_INV_TOS) != 0 || ip->proto > UINT8_MAX)
+    {
+      return -EINVAL;
+    }
+
+  rule->entry     = entry;
+  rule->proto     = ip->proto;
+  rule->proto_inv = (ip->invflags & IPT_INV_PROTO) != 0;
+  rule->l4        = false;
+  rule->flg       = false;
+
+  ipt_filter_setaddr(rule, IPT_FILTER_SRCIP, ip->src, ip->smsk,
+                     (ip->invflags & IPT_INV_SRCIP) != 0);
+  ipt_filter_setaddr(rule, IPT_FILTER_DSTIP, ip->dst, ip->dmsk,
+                     (ip->invflags & IPT_INV_DSTIP) != 0);
+
+  for (field = IPT_FILTER_SRCPT; field < IPT_FILTER_NRANGES; field++)
+    {
+      ipt_filter_setrange(rule, field, 0, UINT32_MAX, false);
+    }
+
+  /* The matches lie between the entry and its target */
+
+  offset = offsetof(struct ipt_entry, elems);
+  while (offset < entry->target_offset)
+    {
+      FAR const struct xt_entry_match *match =
+        (FAR const void *)((FAR const uint8_t *)entry + offset);
+
+      if (match->u.match_size < offsetof(struct xt_entry_match, data) ||
+          offset + match->u.match_size > entry->target_offset)
+        {
+          return -EINVAL;
+        }
+
+      ret = ipt_filter_parse_match(rule, match);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      offset += match->u.match_size;
+    }
+
+  return 1;
+}
+
+/****************************************************************************
+ * Name: ipt_filter_rangematch
+ *
+ * Description:
+ *   Check whether a rule accepts a value of a field.
+ *
+ ****************************************************************************/
+
+static bool ipt_filter_rangematch(FAR const struct ipt_filter_rule_s *rule,
+                                  int field, uint32_t value)
+{
+  int i;
+
+  for (i = 0; i < rule->nranges[field]; i++)
+    {
+      if (value >= rule->ranges[field][i].lo &&
+          value <= rule->ranges[field][i].hi)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: ipt_filter_build_ranges
+ *
+ * Description:
+ *   Build the intervals of a field with 32-bit values.
+ *
+ ****************************************************************************/
+
+static int ipt_filter_build_ranges(FAR struct ipt_filter_chain_s *chain,
+                                   FAR const struct ipt_filter_rule_s *rules,
+                                   int field)
+{
+  FAR struct ipt_filter_ranges_s *ranges = &chain->ranges[field];
+  FAR uint32_t *bounds;
+  int nbounds = 0;
+  int i;
+  int j;
+  int r;
+
+  bounds = kmm_malloc((1 + 2 * IPT_FILTER_MAXRANGES * chain->nrules) *
+                      sizeof(uint32_t));
+  if (bounds == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Collect the bounds of the ranges */
+
+  bounds[nbounds++] = 0;
+  for (r = 0; r < chain->nrules; r++)
+    {
+      for (i = 0; i < rules[r].nranges[field]; i++)
+        {
+          bounds[nbounds++] = rules[r].ranges[field][i].lo;
+          if (rules[r].ranges[field][i].hi < UINT32_MAX)
+            {
+              bounds[nbounds++] = rules[r].ranges[field][i].hi + 1;
+            }
+        }
+    }
+
+  qsort(bounds, nbounds, sizeof(uint32_t), ipt_filter_cmp);
+
+  for (i = 1, j = 1; i < nbounds; i++)
+    {
+      if (bounds[i] != bounds[j - 1])
+        {
+          bounds[j++] = bounds[i];
+        }
+    }
+
+  ranges->nbounds = j;
+  ranges->bounds  = bounds;
+  ranges->bitmaps = kmm_zalloc(j * chain->nwords * sizeof(uint32_t));
+  if (ranges->bitmaps == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* No range crosses a bound: the lowest value of an interval is matched
+   * by the same rules as the whole interval.
+   */
+
+  for (i = 0; i < ranges->nbounds; i++)
+    {
+      FAR uint32_t *bitmap = &ranges->bitmaps[i * chain->nwords];
+
+      for (r = 0; r < chain->nrules; r++)
+        {
+          if (ipt_filter_rangematch(&rules[r], field, bounds[i]))
+            {
+              bitmap[r >> 5] |= 1u << (r & 31);
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipt_filter_classmatch
+ *
+ * Description:
+ *   Check whether a rule accepts a protocol or the TCP flags.
+ *
+ ****************************************************************************/
+
+static bool ipt_filter_classmatch(FAR const struct ipt_filter_rule_s *rule,
+                                  bool proto, uint8_t value)
+{
+  if (proto)
+    {
+      return rule->proto == 0 || ((value == rule->proto) ^ rule->proto_inv);
+    }
+
+  return !rule->flg ||
+         (((value & rule->flg_mask) == rule->flg_cmp) ^ rule->flg_inv);
+}
+
+/****************************************************************************
+ * Name: ipt_filter_build_classes
+ *
+ * Description:
+ *   Build the classes of a field with 8-bit values.
+ *
+ ****************************************************************************/
+
+static int
+ipt_filter_build_classes(FAR struct ipt_filter_chain_s *chain,
+                         FAR const struct ipt_filter_rule_s *rules,
+                         FAR struct ipt_filter_classes_s *classes,
+                         bool proto)
+{
+  size_t size = chain->nwords * sizeof(uint32_t);
+  FAR uint32_t *bitmaps;
+  int nclasses = 0;
+  int value;
+  int i;
+  int r;
+
+  bitmaps = kmm_zalloc(256 * size);
+  if (bitmaps == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (value = 0; value < 256; value++)
+    {
+      FAR uint32_t *bitmap = &bitmaps[nclasses * chain->nwords];
+
+      for (r = 0; r < chain->nrules; r++)
+        {
+          if (ipt_filter_classmatch(&rules[r], proto, value))
+            {
+              bitmap[r >> 5] |= 1u << (r & 31);
+            }
+        }
+
+      /* Share the class of the values matched by the same rules */
+
+      for (i = 0; i < nclasses; i++)
+        {
+          if (memcmp(&bitmaps[i * chain->nwords], bitmap, size) == 0)
+            {
+              break;
+            }
+        }
+
+      classes->map[value] = i;
+      if (i == nclasses)
+        {
+          nclasses++;
+        }
+      else
+        {
+          memset(bitmap, 0, size);
+        }
+    }
+
+  classes->bitmaps = kmm_realloc(bitmaps, nclasses * size);
+  if (classes->bitmaps == NULL)
+    {
+      classes->bitmaps = bitmaps;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipt_filter_build_ifaces
+ *
+ * Description:
+ *   Build the interface patterns of the in or out interface.
+ *
+ ****************************************************************************/
+
+static int ipt_filter_build_ifaces(FAR struct ipt_filter_chain_s *chain,
+                                   FAR const struct ipt_filter_rule_s *rules,
+                                   int dir)
+{
+  FAR struct ipt_filter_ifaces_s *ifaces = &chain->ifaces[dir];
+  int i;
+  int r;
+
+  ifaces->patterns = kmm_malloc((chain->nrules + 1) *
+                                sizeof(struct ipt_filter_iface_s));
+  ifaces->bitmaps  = kmm_zalloc((chain->nrules + 1) * chain->nwords *
+                                sizeof(uint32_t));
+  if (ifaces->patterns == NULL || ifaces->bitmaps == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (r = 0; r < chain->nrules; r++)
+    {
+      FAR const struct ipt_ip *ip = &rules[r].entry->ip;
+      struct ipt_filter_iface_s pattern;
+      FAR uint32_t *bitmap;
+
+      memset(&pattern, 0, sizeof(pattern));
+      if (dir == IPT_FILTER_IN)
+        {
+          memcpy(pattern.name, ip->iniface, IFNAMSIZ);
+          memcpy(pattern.mask, ip->iniface_mask, IFNAMSIZ);
+          pattern.inv = (ip->invflags & IPT_INV_VIA_IN) != 0;
+        }
+      else
+        {
+          memcpy(pattern.name, ip->outiface, IFNAMSIZ);
+          memcpy(pattern.mask, ip->outiface_mask, IFNAMSIZ);
+          pattern.inv = (ip->invflags & IPT_INV_VIA_OUT) != 0;
+        }
+
+      for (i = 0; i < IFNAMSIZ && pattern.mask[i] == 0; i++);
+
+      if (i == IFNAMSIZ && !pattern.inv)
+        {
+          /* Any interface, the bitmap after the patterns */
+
+          bitmap = &ifaces->bitmaps[chain->nrules * chain->nwords];
+        }
+      else
+        {
+          for (i = 0; i < IFNAMSIZ; i++)
+            {
+              pattern.name[i] &= pattern.mask[i];
+            }
+
+          for (i = 0; i < ifaces->npatterns; i++)
+            {
+              if (memcmp(&ifaces->patterns[i], &pattern,
+                         sizeof(pattern)) == 0)
+                {
+                  break;
+                }
+            }
+
+          if (i == ifaces->npatterns)
+            {
+              ifaces->patterns[ifaces->npatterns++] = pattern;
+            }
+
+          bitmap = &ifaces->bitmaps[i * chain->nwords];
+        }
+
+      bitmap[r >> 5] |= 1u << (r & 31);
+    }
+
+  /* Move the bitmap of any interface after the last pattern */
+
+  memmove(&ifaces->bitmaps[ifaces->npatterns * chain->nwords],
+          &ifaces->bitmaps[chain->nrules * chain->nwords],
+          chain->nwords * sizeof(uint32_t));
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipt_filter_free
+ *
+ * Description:
+ *   Free a compiled chain.
+ *
+ ****************************************************************************/
+
+static void ipt_filter_free(FAR struct ipt_filter_chain_s *chain)
+{
+  int i;
+
+  if (chain == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < IPT_FILTER_NRANGES; i++)
+    {
+      kmm_free(chain->ranges[i].bounds);
+      kmm_free(chain->ranges[i].bitmaps);
+    }
+
+  for (i = 0; i < 2; i++)
+    {
+      kmm_free(chain->ifaces[i].patterns);
+      kmm_free(chain->ifaces[i].bitmaps);
+    }
+
+  kmm_free(chain->proto.bitmaps);
+  kmm_free(chain->tcpflags.bitmaps);
+  kmm_free(chain->frag);
+  kmm_free(chain->verdicts);
+  kmm_free(chain);
+}
+
+/****************************************************************************
+ * Name: ipt_filter_compile
+ *
+ * Description:
+ *   Compile the chain of a hook.
+ *
+ ****************************************************************************/
+
+static int ipt_filter_compile(FAR const struct ipt_replace *repl, int hook,
+                              FAR struct ipt_filter_chain_s **result)
+{
+  FAR struct ipt_filter_chain_s *chain;
+  FAR struct ipt_filter_rule_s *rules;
+  FAR const struct ipt_entry *entry;
+  FAR const struct xt_standard_target *policy;
+  FAR const uint8_t *base = (FAR const uint8_t *)repl->entries;
+  unsigned int offset;
+  int nrules = 0;
+  int ret;
+  int r;
+
+  /* Parse the entries from the hook entry to the underflow, the policy */
+
+  if (repl->hook_entry[hook] > repl->underflow[hook] ||
+      repl->underflow[hook] + sizeof(struct ipt_entry) > repl->size)
+    {
+      return -EINVAL;
+    }
+
+  rules = kmm_malloc(CONFIG_NET_IPTABLES_FILTER_MAXRULES * sizeof(*rules));
+  chain = kmm_zalloc(sizeof(*chain));
+  if (rules == NULL || chain == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  for (offset = repl->hook_entry[hook]; offset < repl->underflow[hook];
+       offset += entry->next_offset)
+    {
+      entry = (FAR const struct ipt_entry *)(base + offset);
+      if (entry->next_offset < sizeof(struct ipt_entry) ||
+          entry->target_offset >= entry->next_offset ||
+          offset + entry->next_offset > repl->size)
+        {
+          ret = -EINVAL;
+          goto errout;
+        }
+
+      if (nrules == CONFIG_NET_IPTABLES_FILTER_MAXRULES)
+        {
+          nwarn("WARNING: Too many rules in hook %d\n", hook);
+          ret = -ENOSPC;
+          goto errout;
+        }
+
+      ret = ipt_filter_parse(repl, entry, &rules[nrules]);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      nrules += ret;
+    }
+
+  if (offset != repl->underflow[hook])
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  entry  = (FAR const struct ipt_entry *)(base + offset);
+  policy = (FAR const struct xt_standard_target *)IPT_TARGET(entry);
+  if (strcmp(policy->target.u.user.name, XT_STANDARD_TARGET) != 0 ||
+      (policy->verdict != -NF_ACCEPT - 1 &&
+       policy->verdict != -NF_DROP - 1))
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  chain->nrules = nrules;
+  chain->nwords = (nrules + 31) / 32;
+  chain->policy = -policy->verdict - 1;
+
+  if (nrules > 0)
+    {
+      chain->verdicts = kmm_malloc(nrules);
+      chain->frag     = kmm_zalloc(2 * chain->nwords * sizeof(uint32_t));
+      if (chain->verdicts == NULL || chain->frag == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      for (r = 0; r < nrules; r++)
+        {
+          FAR const struct ipt_ip *ip = &rules[r].entry->ip;
+          bool frag = (ip->flags & IPT_F_FRAG) != 0 &&
+                      (ip->invflags & IPT_INV_FRAG) == 0;
+          bool nofrag = (ip->flags & IPT_F_FRAG) != 0 &&
+                        (ip->invflags & IPT_INV_FRAG) != 0;
+
+          chain->verdicts[r] = rules[r].verdict;
+
+          /* The fragments after the first one have no TCP or UDP header */
+
+          if (!frag)
+            {
+              chain->frag[r >> 5] |= 1u << (r & 31);
+            }
+
+          if (!nofrag && !rules[r].l4)
+            {
+              chain->frag[chain->nwords + (r >> 5)] |= 1u << (r & 31);
+            }
+        }
+
+      for (r = 0; r < IPT_FILTER_NRANGES; r++)
+        {
+          ret = ipt_filter_build_ranges(chain, rules, r);
+          if (ret < 0)
+            {
+              goto errout;
+            }
+        }
+
+      ret = ipt_filter_build_classes(chain, rules, &chain->proto, true);
+      if (ret >= 0)
+        {
+          ret = ipt_filter_build_classes(chain, rules, &chain->tcpflags,
+                                         false);
+        }
+
+      if (ret >= 0)
+        {
+          ret = ipt_filter_build_ifaces(chain, rules, IPT_FILTER_IN);
+        }
+
+      if (ret >= 0)
+        {
+          ret = ipt_filter_build_ifaces(chain, rules, IPT_FILTER_OUT);
+        }
+
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  kmm_free(rules);
+  *result = chain;
+  return OK;
+
+errout:
+  ipt_filter_free(chain);
+  kmm_free(rules);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ipt_filter_and
+ *
+ * Description:
+ *   Intersect the matching rules with a set of rules.
+ *
+ ****************************************************************************/
+
+static void ipt_filter_and(FAR uint32_t *match, FAR const uint32_t *bitmap,
+                           int nwords)
+{
+  int i;
+
+  for (i = 0; i < nwords; i++)
+    {
+      match[i] &= bitmap[i];
+    }
+}
+
+/****************************************************************************
+ * Name: ipt_filter_ifaces
+ *
+ * Description:
+ *   Intersect the matching rules with the rules accepting an interface.
+ *
+ ****************************************************************************/
+
+static void ipt_filter_ifaces(FAR const struct ipt_filter_chain_s *chain,
+                              FAR uint32_t *match, int dir,
+                              FAR struct net_driver_s *dev)
+{
+  FAR const struct ipt_filter_ifaces_s *ifaces = &chain->ifaces[dir];
+  FAR const char *name = dev != NULL ? dev->d_ifname : g_filter_noname;
+  uint32_t accept[IPT_FILTER_NWORDS];
+  int nwords = chain->nwords;
+  int i;
+  int j;
+
+  if (ifaces->npatterns == 0)
+    {
+      return;
+    }
+
+  memcpy(accept, &ifaces->bitmaps[ifaces->npatterns * nwords],
+         nwords * sizeof(uint32_t));
+
+  for (i = 0; i < ifaces->npatterns; i++)
+    {
+      FAR const struct ipt_filter_iface_s *pattern = &ifaces->patterns[i];
+
+      for (j = 0; j < IFNAMSIZ; j++)
+        {
+          if (((name[j] ^ pattern->name[j]) & pattern->mask[j]) != 0)
+            {
+              break;
+            }
+        }
+
+      if ((j == IFNAMSIZ) ^ pattern->inv)
+        {
+          for (j = 0; j < nwords; j++)
+            {
+              accept[j] |= ifaces->bitmaps[i * nwords + j];
+            }
+        }
+    }
+
+  ipt_filter_and(match, accept, nwords);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipt_filter_init
+ *
+ * Description:
+ *   Init filter table data.
+ *
+ ****************************************************************************/
+
+FAR struct ipt_replace *ipt_filter_init(void)
+{
+  return ipt_alloc_table(TABLE_NAME_FILTER, (1 << NF_INET_LOCAL_IN) |
+                                            (1 << NF_INET_FORWARD));
+}
+
+/****************************************************************************
+ * Name: ipt_filter_apply
+ *
+ * Description:
+ *   Compile the filter rules, the running rules are kept if they cannot be
+ *   compiled.
+ *
+ * Input Parameters:
+ *   repl   - The config got from user space to control filter table.
+ *
+ ****************************************************************************/
+
+int ipt_filter_apply(FAR const struct ipt_replace *repl)
+{
+  FAR struct ipt_filter_chain_s *chains[NF_INET_NUMHOOKS];
+  FAR struct ipt_filter_chain_s *old;
+  int hook;
+  int ret = OK;
+
+  memset(chains, 0, sizeof(chains));
+
+  for (hook = 0; hook < NF_INET_NUMHOOKS; hook++)
+    {
+      if ((repl->valid_hooks >> hook & 0x01) != 0)
+        {
+          ret = ipt_filter_compile(repl, hook, &chains[hook]);
+          if (ret < 0)
+            {
+              nwarn("WARNING: Failed to compile hook %d: %d\n", hook, ret);
+              break;
+            }
+        }
+    }
+
+  net_lock();
+
+  for (hook = 0; hook < NF_INET_NUMHOOKS; hook++)
+    {
+      if (ret >= 0)
+        {
+          old = g_filter_chains[hook];
+          g_filter_chains[hook] = chains[hook];
+        }
+      else
+        {
+          old = chains[hook];
+        }
+
+      ipt_filter_free(old);
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ipt_filter_ipv4
+ *
+ * Description:
+ *   Find the verdict of the filter rules of a hook on an IPv4 packet.
+ *
+ * Input Parameters:
+ *   hook   - The hook, NF_INET_LOCAL_IN or NF_INET_FORWARD.
+ *   indev  - The device the packet is received on.
+ *   outdev - The device the packet is forwarded to, NULL if none.
+ *   ipv4   - The IPv4 header of the packet.
+ *
+ * Returned Value:
+ *   NF_ACCEPT or NF_DROP.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int ipt_filter_ipv4(int hook, FAR struct net_driver_s *indev,
+                    FAR struct net_driver_s *outdev,
+                    FAR struct ipv4_hdr_s *ipv4)
+{
+  FAR const struct ipt_filter_chain_s *chain = g_filter_chains[hook];
+  uint32_t match[IPT_FILTER_NWORDS];
+  uint32_t keys[IPT_FILTER_NRANGES];
+  uint16_t hdrlen;
+  uint16_t offset;
+  uint8_t flags = 0;
+  int nwords;
+  int field;
+  int i;
+
+  if (chain == NULL || chain->nrules == 0)
+    {
+      return chain != NULL ? chain->policy : NF_ACCEPT;
+    }
+
+  nwords = chain->nwords;
+  hdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+  offset = ((ipv4->ipoffset[0] << 8) | ipv4->ipoffset[1]) & 0x1fff;
+
+  keys[IPT_FILTER_SRCIP] = NTOHL(net_ip4addr_conv32(ipv4->srcipaddr));
+  keys[IPT_FILTER_DSTIP] = NTOHL(net_ip4addr_conv32(ipv4->destipaddr));
+  keys[IPT_FILTER_SRCPT] = 0;
+  keys[IPT_FILTER_DSTPT] = 0;
+
+  /* The ports are at the same place in the TCP and UDP headers */
+
+  if (offset == 0 && (ipv4->proto == IP_PROTO_TCP ||
+                      ipv4->proto == IP_PROTO_UDP))
+    {
+      FAR const uint8_t *l4 = (FAR const uint8_t *)ipv4 + hdrlen;
+      uint16_t len = (ipv4->len[0] << 8) | ipv4->len[1];
+
+      if (len < hdrlen + (ipv4->proto == IP_PROTO_TCP ?
+                          TCP_HDRLEN : UDP_HDRLEN))
+        {
+          /* A truncated header is handled as a fragment */
+
+          offset = 1;
+        }
+      else
+        {
+          keys[IPT_FILTER_SRCPT] = (l4[0] << 8) | l4[1];
+          keys[IPT_FILTER_DSTPT] = (l4[2] << 8) | l4[3];
+          if (ipv4->proto == IP_PROTO_TCP)
+            {
+              flags = ((FAR const struct tcp_hdr_s *)l4)->flags;
+            }
+        }
+    }
+
+  memcpy(match, &chain->frag[offset != 0 ? nwords : 0],
+         nwords * sizeof(uint32_t));
+
+  for (field = 0; field < IPT_FILTER_NRANGES; field++)
+    {
+      FAR const struct ipt_filter_ranges_s *ranges = &chain->ranges[field];
+
+      i = ipt_filter_search(ranges, keys[field]);
+      ipt_filter_and(match, &ranges->bitmaps[i * nwords], nwords);
+    }
+
+  ipt_filter_and(match,
+                 &chain->proto.bitmaps[chain->proto.map[ipv4->proto] *
+                                       nwords], nwords);
+  ipt_filter_and(match,
+                 &chain->tcpflags.bitmaps[chain->tcpflags.map[flags] *
+                                          nwords], nwords);
+
+  ipt_filter_ifaces(chain, match, IPT_FILTER_IN, indev);
+  ipt_filter_ifaces(chain, match, IPT_FILTER_OUT, outdev);
+
+  /* The first matching rule decides */
+
+  for (i = 0; i < nwords; i++)
+    {
+      if (match[i] != 0)
+        {
+          return chain->verdicts[(i << 5) + ffs((int)match[i]) - 1];
+        }
+    }
+
+  return chain->policy;
+}
+
+#endif /* CONFIG_NET_IPTABLES_FILTER */
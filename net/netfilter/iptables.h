@@ -28,6 +28,7 @@
 #include <nuttx/config.h>
 
 #include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
 #include <nuttx/net/netfilter/ip_tables.h>
 
 #ifdef CONFIG_NET_IPTABLES
@@ -105,5 +106,59 @@ FAR struct ipt_replace *ipt_nat_init(void);
 int ipt_nat_apply(FAR const struct ipt_replace *repl);
 #endif
 
+/****************************************************************************
+ * Name: ipt_filter_init
+ *
+ * Description:
+ *   Init filter table data.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPTABLES_FILTER
+FAR struct ipt_replace *ipt_filter_init(void);
+#endif
+
+/****************************************************************************
+ * Name: ipt_filter_apply
+ *
+ * Description:
+ *   Compile the filter rules, the running rules are kept if they cannot be
+ *   compiled.
+ *
+ * Input Parameters:
+ *   repl   - The config got from user space to control filter table.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPTABLES_FILTER
+int ipt_filter_apply(FAR const struct ipt_replace *repl);
+#endif
+
+/****************************************************************************
+ * Name: ipt_filter_ipv4
+ *
+ * Description:
+ *   Find the verdict of the filter rules of a hook on an IPv4 packet.
+ *
+ * Input Parameters:
+ *   hook   - The hook, NF_INET_LOCAL_IN or NF_INET_FORWARD.
+ *   indev  - The device the packet is received on.
+ *   outdev - The device the packet is forwarded to, NULL if none.
+ *   ipv4   - The IPv4 header of the packet.
+ *
+ * Returned Value:
+ *   NF_ACCEPT or NF_DROP.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPTABLES_FILTER
+int ipt_filter_ipv4(int hook, FAR struct net_driver_s *indev,
+                    FAR struct net_driver_s *outdev,
+                    FAR struct ipv4_hdr_s *ipv4);
+#endif
+
 #endif /* CONFIG_NET_IPTABLES */
 #endif /* __NET_NETFILTER_IPTABLES_H */
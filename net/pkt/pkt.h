@@ -28,7 +28,11 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <poll.h>
 
+#include <netpacket/packet.h>
+
+#include <nuttx/wqueue.h>
 #include <nuttx/net/net.h>
 
 #ifdef CONFIG_NET_PKT
@@ -48,6 +52,30 @@
  * Public Type Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_NET_PKT_MMAP
+/* The memory of the rings of a packet socket, shared with the application
+ * by mmap().  It is released when neither the socket nor a mapping
+ * refers to it.
+ */
+
+struct pkt_mmap_s
+{
+  FAR uint8_t *pm_buffer;    /* The RX ring followed by the TX ring */
+  size_t       pm_len;       /* Size of the buffer */
+  int          pm_crefs;     /* The socket and the mappings */
+};
+
+/* A memory-mapped ring: TPACKET_V3 blocks for RX, frames for TX */
+
+struct pkt_ring_s
+{
+  FAR uint8_t *pr_base;      /* The first block or frame */
+  uint32_t     pr_size;      /* Size of a block or frame */
+  uint32_t     pr_num;       /* Number of blocks or frames, 0: no ring */
+  uint32_t     pr_head;      /* The current block or next frame */
+};
+#endif
+
 /* Representation of a packet socket connection */
 
 struct devif_callback_s; /* Forward reference */
@@ -70,10 +98,37 @@ struct pkt_conn_s
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the PKT read-ahead data is retained.
    *
-   * TODO: Maybe support PACKET_MMAP for further optimize.
+   * Not used when the frames are received in the RX ring.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+
+  /* The poll() waiters of the socket */
+
+  FAR struct pollfd *fds[CONFIG_NET_PKT_NPOLLWAITERS];
+
+#ifdef CONFIG_NET_PKT_MMAP
+  /* Memory-mapped rings.
+   *
+   *   rxoffset - The offset of the next frame in the current RX block, 0
+   *              if the block has no frame yet.
+   *   rxlast   - The offset of the last frame of the current RX block.
+   *   rxwork   - Closes the current RX block after rxtov msec.
+   */
+
+  FAR struct pkt_mmap_s *mmap;
+  struct pkt_ring_s      rxring;
+  struct pkt_ring_s      txring;
+  uint32_t               rxoffset;
+  uint32_t               rxlast;
+  uint32_t               rxtov;
+  uint32_t               rxpriv;  /* Size of the private area of a block */
+  uint64_t               rxseq;   /* Sequence number of the last block */
+  struct work_s          rxwork;
+  struct tpacket_stats_v3 stats;
+  uint8_t                version; /* See enum tpacket_versions */
+  bool                   losing;  /* Frames were dropped since reported */
+#endif
 };
 
 /****************************************************************************
@@ -293,6 +348,125 @@ void pkt_poll(FAR struct net_driver_s *dev, FAR struct pkt_conn_s *conn);
 ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags);
 
+/****************************************************************************
+ * Name: pkt_netpoll
+ *
+ * Description:
+ *   Setup or teardown the monitoring of the events of a packet socket.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   fds   - The structure describing the events to be monitored.
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_netpoll(FAR struct socket *psock, FAR struct pollfd *fds,
+                bool setup);
+
+/****************************************************************************
+ * Name: pkt_pollnotify
+ *
+ * Description:
+ *   Notify the poll() waiters of a packet socket of new events.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_pollnotify(FAR struct pkt_conn_s *conn, pollevent_t eventset);
+
+#ifdef CONFIG_NET_PKT_MMAP
+/****************************************************************************
+ * Name: pkt_setsockopt and pkt_getsockopt
+ *
+ * Description:
+ *   Set or get the SOL_PACKET options of a packet socket: PACKET_VERSION,
+ *   PACKET_RX_RING, PACKET_TX_RING and PACKET_STATISTICS.  Only the
+ *   TPACKET_V3 layout of the rings is supported.
+ *
+ * Returned Value:
+ *   OK on success; -ENOPROTOOPT for the options of other levels, else a
+ *   negated errno value.
+ *
+ ****************************************************************************/
+
+int pkt_setsockopt(FAR struct socket *psock, int level, int option,
+                   FAR const void *value, socklen_t value_len);
+int pkt_getsockopt(FAR struct socket *psock, int level, int option,
+                   FAR void *value, FAR socklen_t *value_len);
+
+/****************************************************************************
+ * Name: pkt_mmap
+ *
+ * Description:
+ *   Map the rings of a packet socket: the RX ring followed by the TX ring.
+ *
+ ****************************************************************************/
+
+int pkt_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Write the frame in the device buffer to the RX ring of a connection,
+ *   or drop it if the ring is full.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Send the frames of the TX ring marked TP_STATUS_SEND_REQUEST.
+ *
+ * Returned Value:
+ *   The number of bytes sent, or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct socket *psock,
+                      FAR struct net_driver_s *dev);
+
+/****************************************************************************
+ * Name: pkt_ring_pollevents
+ *
+ * Description:
+ *   Return the poll events of the rings of a connection.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+pollevent_t pkt_ring_pollevents(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release the rings of a connection.  The memory remains until it is
+ *   unmapped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -92,6 +92,7 @@ static uint16_t pkt_datahandler(FAR struct net_driver_s *dev,
   else
     {
       ninfo("Buffered %d bytes\n", dev->d_len);
+      pkt_pollnotify(conn, POLLIN);
       return dev->d_len;
     }
 
@@ -144,6 +145,16 @@ static int pkt_in(FAR struct net_driver_s *dev)
       dev->d_appdata = dev->d_buf;
       dev->d_sndlen  = 0;
 
+#ifdef CONFIG_NET_PKT_MMAP
+      /* The frames are written to the RX ring when there is one */
+
+      if (conn->rxring.pr_num > 0)
+        {
+          pkt_ring_input(dev, conn);
+          return OK;
+        }
+#endif
+
       /* Perform the application callback */
 
       flags = pkt_callback(dev, conn, PKT_NEWDATA);
@@ -0,0 +1,141 @@
+/****************************************************************************
+ * net/pkt/pkt_netpoll.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT)
+
+#include <assert.h>
+#include <errno.h>
+#include <poll.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_pollnotify
+ *
+ * Description:
+ *   Notify the poll() waiters of a packet socket of new events.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_pollnotify(FAR struct pkt_conn_s *conn, pollevent_t eventset)
+{
+  poll_notify(conn->fds, CONFIG_NET_PKT_NPOLLWAITERS, eventset);
+}
+
+/****************************************************************************
+ * Name: pkt_netpoll
+ *
+ * Description:
+ *   Setup or teardown the monitoring of the events of a packet socket.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   fds   - The structure describing the events to be monitored.
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+int pkt_netpoll(FAR struct socket *psock, FAR struct pollfd *fds,
+                bool setup)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct pollfd **slot;
+  pollevent_t eventset;
+  int i;
+
+  DEBUGASSERT(conn != NULL);
+
+  net_lock();
+
+  if (!setup)
+    {
+      /* Remove all memory of the poll setup */
+
+      slot = (FAR struct pollfd **)fds->priv;
+      if (slot != NULL)
+        {
+          *slot = NULL;
+          fds->priv = NULL;
+        }
+
+      net_unlock();
+      return OK;
+    }
+
+  /* Find an available slot */
+
+  for (i = 0; i < CONFIG_NET_PKT_NPOLLWAITERS; i++)
+    {
+      if (conn->fds[i] == NULL)
+        {
+          conn->fds[i] = fds;
+          fds->priv    = &conn->fds[i];
+          break;
+        }
+    }
+
+  if (i >= CONFIG_NET_PKT_NPOLLWAITERS)
+    {
+      net_unlock();
+      fds->priv = NULL;
+      return -EBUSY;
+    }
+
+  /* Report the events already pending */
+
+#ifdef CONFIG_NET_PKT_MMAP
+  if (conn->rxring.pr_num > 0 || conn->txring.pr_num > 0)
+    {
+      eventset = pkt_ring_pollevents(conn);
+    }
+  else
+#endif
+    {
+      eventset = POLLOUT;
+      if (!IOB_QEMPTY(&conn->readahead))
+        {
+          eventset |= POLLIN;
+        }
+    }
+
+  poll_notify(&fds, 1, eventset);
+  net_unlock();
+  return OK;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT */
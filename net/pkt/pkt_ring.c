@@ -0,0 +1,926 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_PKT_MMAP)
+
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+#include <time.h>
+
+#include <net/if_arp.h>
+#include <netpacket/packet.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "socket/socket.h"
+#include "pkt/pkt.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Block timeout used when the application requests none, msec */
+
+#define PKT_RING_TOV        8
+
+/* Layout of the blocks and frames */
+
+#define PKT_BLOCK_PRIV      TPACKET_ALIGN(sizeof(struct tpacket_block_desc))
+#define PKT_FRAME_MAC       TPACKET_ALIGN(TPACKET3_HDRLEN)
+#define PKT_FRAME_SLL       TPACKET_ALIGN(sizeof(struct tpacket3_hdr))
+#define PKT_FRAME_TXDATA    (TPACKET3_HDRLEN - sizeof(struct sockaddr_ll))
+
+#define PKT_BLOCK(c,n) \
+  ((FAR struct tpacket_block_desc *) \
+   ((c)->rxring.pr_base + (size_t)(n) * (c)->rxring.pr_size))
+#define PKT_FRAME(c,n) \
+  ((FAR struct tpacket3_hdr *) \
+   ((c)->txring.pr_base + (size_t)(n) * (c)->txring.pr_size))
+
+/* The status words are shared with the application */
+
+#define PKT_STATUS(p)       (*(FAR volatile uint32_t *)&(p))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state of a send of the TX ring */
+
+struct pkt_ring_send_s
+{
+  FAR struct pkt_conn_s       *rs_conn;   /* The connection */
+  FAR struct devif_callback_s *rs_cb;     /* Reference to callback */
+  sem_t                        rs_sem;    /* Wakes up the sender */
+  ssize_t                      rs_sent;   /* Bytes sent */
+  int                          rs_result; /* First error */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_mmap_release
+ *
+ * Description:
+ *   Drop a reference to the memory of the rings.
+ *
+ ****************************************************************************/
+
+static void pkt_mmap_release(FAR struct pkt_mmap_s *pm)
+{
+  if (--pm->pm_crefs <= 0)
+    {
+      kumm_free(pm->pm_buffer);
+      kmm_free(pm);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_munmap
+ *
+ * Description:
+ *   Remove a mapping of the rings of a packet socket.
+ *
+ ****************************************************************************/
+
+static int pkt_munmap(FAR struct task_group_s *group,
+                      FAR struct mm_map_entry_s *entry,
+                      FAR void *start, size_t length)
+{
+  /* Partial unmap is not supported */
+
+  if (start != entry->vaddr || length != entry->length)
+    {
+      return -EINVAL;
+    }
+
+  net_lock();
+  pkt_mmap_release(entry->priv.p);
+  net_unlock();
+
+  return mm_map_remove(get_group_mm(group), entry);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_retire
+ *
+ * Description:
+ *   Pass the current RX block to the application and move to the next one.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_retire(FAR struct pkt_conn_s *conn, uint32_t status)
+{
+  FAR struct tpacket_block_desc *desc;
+
+  desc = PKT_BLOCK(conn, conn->rxring.pr_head);
+  work_cancel(LPWORK, &conn->rxwork);
+
+  if (conn->losing)
+    {
+      status       |= TP_STATUS_LOSING;
+      conn->losing  = false;
+    }
+
+  /* Make the content visible before the ownership */
+
+  SEQ_DMB();
+  PKT_STATUS(desc->hdr.bh1.block_status) = TP_STATUS_USER | status;
+
+  conn->rxring.pr_head = (conn->rxring.pr_head + 1) % conn->rxring.pr_num;
+  conn->rxoffset       = 0;
+
+  pkt_pollnotify(conn, POLLIN);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_timeout
+ *
+ * Description:
+ *   Pass the current RX block to the application when it is not filled
+ *   in time.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_timeout(FAR void *arg)
+{
+  FAR struct pkt_conn_s *conn = arg;
+
+  net_lock();
+  if (conn->rxring.pr_num > 0 && conn->rxoffset != 0)
+    {
+      pkt_ring_retire(conn, TP_STATUS_BLK_TMO);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: pkt_ring_open
+ *
+ * Description:
+ *   Start to fill the current RX block if the application released it.
+ *
+ * Returned Value:
+ *   The block descriptor, or NULL if the ring is full.
+ *
+ ****************************************************************************/
+
+static FAR struct tpacket_block_desc *
+pkt_ring_open(FAR struct pkt_conn_s *conn)
+{
+  FAR struct tpacket_block_desc *desc;
+  FAR struct tpacket_hdr_v1 *bh1;
+
+  desc = PKT_BLOCK(conn, conn->rxring.pr_head);
+  bh1  = &desc->hdr.bh1;
+
+  if (PKT_STATUS(bh1->block_status) != TP_STATUS_KERNEL)
+    {
+      if (!conn->losing)
+        {
+          conn->stats.tp_freeze_q_cnt++;
+          conn->losing = true;
+        }
+
+      return NULL;
+    }
+
+  SEQ_DMB();
+
+  desc->version            = TPACKET_V3;
+  desc->offset_to_priv     = PKT_BLOCK_PRIV;
+  bh1->num_pkts            = 0;
+  bh1->offset_to_first_pkt = PKT_BLOCK_PRIV + TPACKET_ALIGN(conn->rxpriv);
+  bh1->blk_len             = bh1->offset_to_first_pkt;
+  bh1->seq_num             = ++conn->rxseq;
+
+  conn->rxoffset = bh1->offset_to_first_pkt;
+  conn->rxlast   = 0;
+
+  work_queue(LPWORK, &conn->rxwork, pkt_ring_timeout, conn,
+             MSEC2TICK(conn->rxtov));
+  return desc;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_pkttype
+ *
+ * Description:
+ *   Classify a frame for sll_pkttype.
+ *
+ ****************************************************************************/
+
+static uint8_t pkt_ring_pkttype(FAR struct pkt_conn_s *conn,
+                                FAR const struct eth_hdr_s *eth)
+{
+  static const uint8_t bcast[6] =
+  {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+  };
+
+  if (memcmp(eth->dest, conn->lmac, 6) == 0)
+    {
+      return PACKET_HOST;
+    }
+  else if (memcmp(eth->src, conn->lmac, 6) == 0)
+    {
+      return PACKET_OUTGOING;
+    }
+  else if (memcmp(eth->dest, bcast, 6) == 0)
+    {
+      return PACKET_BROADCAST;
+    }
+  else if ((eth->dest[0] & 0x01) != 0)
+    {
+      return PACKET_MULTICAST;
+    }
+
+  return PACKET_OTHERHOST;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_setup
+ *
+ * Description:
+ *   Create, resize or remove (tp_block_nr or tp_frame_nr of 0) a ring.
+ *   Both rings share one buffer, so it is reallocated, which is only
+ *   allowed while the rings are not mapped.
+ *
+ ****************************************************************************/
+
+static int pkt_ring_setup(FAR struct pkt_conn_s *conn, bool tx,
+                          FAR const struct tpacket_req3 *req)
+{
+  FAR struct pkt_mmap_s *pm = NULL;
+  struct pkt_ring_s rx = conn->rxring;
+  struct pkt_ring_s ring;
+  uint64_t rxlen;
+  uint64_t txlen;
+
+  if (conn->version != TPACKET_V3)
+    {
+      return -EINVAL;
+    }
+
+  if (conn->mmap != NULL && conn->mmap->pm_crefs > 1)
+    {
+      return -EBUSY;
+    }
+
+  /* Check the requested layout */
+
+  memset(&ring, 0, sizeof(ring));
+  if (tx)
+    {
+      ring.pr_size = req->tp_frame_size;
+      ring.pr_num  = req->tp_frame_nr;
+
+      if (ring.pr_num > 0 &&
+          (ring.pr_size % TPACKET_ALIGNMENT != 0 ||
+           ring.pr_size <= PKT_FRAME_TXDATA + ETH_HDRLEN))
+        {
+          return -EINVAL;
+        }
+    }
+  else
+    {
+      ring.pr_size = req->tp_block_size;
+      ring.pr_num  = req->tp_block_nr;
+
+      if (ring.pr_num > 0 &&
+          (ring.pr_size % TPACKET_ALIGNMENT != 0 ||
+           req->tp_sizeof_priv > UINT16_MAX ||
+           ring.pr_size <= PKT_BLOCK_PRIV +
+                           TPACKET_ALIGN(req->tp_sizeof_priv) +
+                           PKT_FRAME_MAC + ETH_HDRLEN))
+        {
+          return -EINVAL;
+        }
+    }
+
+  if (ring.pr_num == 0)
+    {
+      ring.pr_size = 0;
+    }
+
+  if (!tx)
+    {
+      rx = ring;
+    }
+
+  rxlen = (uint64_t)rx.pr_size * rx.pr_num;
+  txlen = tx ? (uint64_t)ring.pr_size * ring.pr_num :
+               (uint64_t)conn->txring.pr_size * conn->txring.pr_num;
+
+  if (rxlen + txlen > CONFIG_NET_PKT_MMAP_MAXSIZE)
+    {
+      return -ENOMEM;
+    }
+
+  /* Allocate the new buffer, the RX ring first */
+
+  if (rxlen + txlen > 0)
+    {
+      pm = kmm_zalloc(sizeof(*pm));
+      if (pm == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      pm->pm_len    = rxlen + txlen;
+      pm->pm_crefs  = 1;
+      pm->pm_buffer = kumm_zalloc(pm->pm_len);
+      if (pm->pm_buffer == NULL)
+        {
+          kmm_free(pm);
+          return -ENOMEM;
+        }
+    }
+
+  /* Replace the rings, any content is lost */
+
+  work_cancel(LPWORK, &conn->rxwork);
+  if (conn->mmap != NULL)
+    {
+      pkt_mmap_release(conn->mmap);
+    }
+
+  if (tx)
+    {
+      conn->txring = ring;
+    }
+  else
+    {
+      conn->rxring = ring;
+      conn->rxtov  = req->tp_retire_blk_tov > 0 ?
+                     req->tp_retire_blk_tov : PKT_RING_TOV;
+      conn->rxpriv = req->tp_sizeof_priv;
+    }
+
+  conn->mmap            = pm;
+  conn->rxring.pr_head  = 0;
+  conn->txring.pr_head  = 0;
+  conn->rxring.pr_base  = pm != NULL ? pm->pm_buffer : NULL;
+  conn->txring.pr_base  = pm != NULL ? pm->pm_buffer + rxlen : NULL;
+  conn->rxoffset        = 0;
+  conn->losing          = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_eventhandler
+ *
+ * Description:
+ *   Send the next requested frame of the TX ring when the device polls.
+ *
+ ****************************************************************************/
+
+static uint16_t pkt_ring_eventhandler(FAR struct net_driver_s *dev,
+                                      FAR void *pvpriv, uint16_t flags)
+{
+  FAR struct pkt_ring_send_s *state = pvpriv;
+  FAR struct pkt_conn_s *conn;
+  FAR struct tpacket3_hdr *frame;
+  uint32_t len;
+  int ret;
+
+  if (state == NULL)
+    {
+      return flags;
+    }
+
+  /* Wait for the next poll if the device buffer is busy */
+
+  if (dev->d_sndlen > 0 || (flags & PKT_NEWDATA) != 0)
+    {
+      return flags;
+    }
+
+  conn  = state->rs_conn;
+  frame = PKT_FRAME(conn, conn->txring.pr_head);
+
+  if (PKT_STATUS(frame->tp_status) == TP_STATUS_SEND_REQUEST)
+    {
+      SEQ_DMB();
+
+      len = frame->tp_len;
+      if (len == 0 || len > conn->txring.pr_size - PKT_FRAME_TXDATA)
+        {
+          PKT_STATUS(frame->tp_status) = TP_STATUS_WRONG_FORMAT;
+          if (state->rs_result == 0)
+            {
+              state->rs_result = -EINVAL;
+            }
+        }
+      else
+        {
+          ret = devif_send(dev, (FAR uint8_t *)frame + PKT_FRAME_TXDATA,
+                           len, 0);
+          if (ret <= 0)
+            {
+              state->rs_result = ret < 0 ? ret : -ENOMEM;
+              goto end_wait;
+            }
+
+          /* Make sure no ARP request overwrites this frame */
+
+          IFF_SET_NOARP(dev->d_flags);
+
+          state->rs_sent += len;
+          PKT_STATUS(frame->tp_status) = TP_STATUS_AVAILABLE;
+        }
+
+      conn->txring.pr_head = (conn->txring.pr_head + 1) %
+                             conn->txring.pr_num;
+      pkt_pollnotify(conn, POLLOUT);
+
+      /* One frame is sent per poll, ask for another poll for the rest */
+
+      frame = PKT_FRAME(conn, conn->txring.pr_head);
+      if (PKT_STATUS(frame->tp_status) == TP_STATUS_SEND_REQUEST)
+        {
+          netdev_txnotify_dev(dev);
+          return flags;
+        }
+    }
+
+end_wait:
+
+  /* Don't allow any further call backs. */
+
+  state->rs_cb->flags = 0;
+  state->rs_cb->priv  = NULL;
+  state->rs_cb->event = NULL;
+
+  nxsem_post(&state->rs_sem);
+  return flags;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_setsockopt
+ *
+ * Description:
+ *   Set the SOL_PACKET options of a packet socket.
+ *
+ ****************************************************************************/
+
+int pkt_setsockopt(FAR struct socket *psock, int level, int option,
+                   FAR const void *value, socklen_t value_len)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  int ret;
+
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  if (value == NULL)
+    {
+      return -EFAULT;
+    }
+
+  net_lock();
+  switch (option)
+    {
+      case PACKET_VERSION:
+        if (value_len < sizeof(int))
+          {
+            ret = -EINVAL;
+          }
+        else if (conn->rxring.pr_num > 0 || conn->txring.pr_num > 0)
+          {
+            ret = -EBUSY;
+          }
+        else if (*(FAR const int *)value != TPACKET_V3)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            conn->version = TPACKET_V3;
+            ret = OK;
+          }
+        break;
+
+      case PACKET_RX_RING:
+      case PACKET_TX_RING:
+        if (value_len < sizeof(struct tpacket_req3))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            ret = pkt_ring_setup(conn, option == PACKET_TX_RING, value);
+          }
+        break;
+
+      default:
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_getsockopt
+ *
+ * Description:
+ *   Get the SOL_PACKET options of a packet socket.  The statistics are
+ *   reset when read.
+ *
+ ****************************************************************************/
+
+int pkt_getsockopt(FAR struct socket *psock, int level, int option,
+                   FAR void *value, FAR socklen_t *value_len)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  int ret = OK;
+
+  if (level != SOL_PACKET)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  if (value == NULL || value_len == NULL)
+    {
+      return -EFAULT;
+    }
+
+  net_lock();
+  switch (option)
+    {
+      case PACKET_VERSION:
+        if (*value_len < sizeof(int))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            *(FAR int *)value = conn->version;
+            *value_len        = sizeof(int);
+          }
+        break;
+
+      case PACKET_STATISTICS:
+        if (*value_len < sizeof(struct tpacket_stats_v3))
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            memcpy(value, &conn->stats, sizeof(conn->stats));
+            memset(&conn->stats, 0, sizeof(conn->stats));
+            *value_len = sizeof(struct tpacket_stats_v3);
+          }
+        break;
+
+      default:
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_mmap
+ *
+ * Description:
+ *   Map the rings of a packet socket: the RX ring followed by the TX ring.
+ *
+ ****************************************************************************/
+
+int pkt_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct pkt_mmap_s *pm;
+  int ret;
+
+  net_lock();
+
+  pm = conn->mmap;
+  if (pm == NULL || map->offset != 0 || map->length == 0 ||
+      map->length > pm->pm_len)
+    {
+      net_unlock();
+      return -EINVAL;
+    }
+
+  pm->pm_crefs++;
+  net_unlock();
+
+  map->vaddr  = pm->pm_buffer;
+  map->priv.p = pm;
+  map->munmap = pkt_munmap;
+
+  ret = mm_map_add(get_current_mm(), map);
+  if (ret < 0)
+    {
+      net_lock();
+      pkt_mmap_release(pm);
+      net_unlock();
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Write the frame in the device buffer to the RX ring of a connection,
+ *   or drop it if the ring is full.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn)
+{
+  FAR struct eth_hdr_s *eth = ETHBUF;
+  FAR struct tpacket_block_desc *desc;
+  FAR struct tpacket3_hdr *hdr;
+  FAR struct sockaddr_ll *sll;
+  struct timespec ts;
+  uint32_t snaplen;
+
+  conn->stats.tp_packets++;
+
+  /* Close the current block if the frame does not fit */
+
+  desc = PKT_BLOCK(conn, conn->rxring.pr_head);
+  if (conn->rxoffset != 0 && desc->hdr.bh1.num_pkts > 0 &&
+      conn->rxoffset + PKT_FRAME_MAC + dev->d_len > conn->rxring.pr_size)
+    {
+      pkt_ring_retire(conn, 0);
+    }
+
+  if (conn->rxoffset == 0)
+    {
+      desc = pkt_ring_open(conn);
+      if (desc == NULL)
+        {
+          conn->stats.tp_drops++;
+          return;
+        }
+    }
+
+  /* A frame larger than a block is truncated */
+
+  snaplen = MIN(dev->d_len,
+                conn->rxring.pr_size - conn->rxoffset - PKT_FRAME_MAC);
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  hdr = (FAR struct tpacket3_hdr *)((FAR uint8_t *)desc + conn->rxoffset);
+  memset(hdr, 0, PKT_FRAME_MAC);
+
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_nsec    = ts.tv_nsec;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_status  = TP_STATUS_USER;
+  hdr->tp_mac     = PKT_FRAME_MAC;
+  hdr->tp_net     = PKT_FRAME_MAC + NET_LL_HDRLEN(dev);
+
+  sll = (FAR struct sockaddr_ll *)((FAR uint8_t *)hdr + PKT_FRAME_SLL);
+  sll->sll_family   = AF_PACKET;
+  sll->sll_protocol = eth->type;
+  sll->sll_ifindex  = dev->d_ifindex;
+  sll->sll_hatype   = ARPHRD_ETHER;
+  sll->sll_pkttype  = pkt_ring_pkttype(conn, eth);
+  sll->sll_halen    = 6;
+  memcpy(sll->sll_addr, eth->src, 6);
+
+  iob_copyout((FAR uint8_t *)hdr + PKT_FRAME_MAC, dev->d_iob, snaplen,
+              -NET_LL_HDRLEN(dev));
+
+  /* Link the frame to the previous one of the block */
+
+  if (conn->rxlast != 0)
+    {
+      ((FAR struct tpacket3_hdr *)((FAR uint8_t *)desc + conn->rxlast))->
+        tp_next_offset = conn->rxoffset - conn->rxlast;
+    }
+  else
+    {
+      desc->hdr.bh1.ts_first_pkt.ts_sec  = ts.tv_sec;
+      desc->hdr.bh1.ts_first_pkt.ts_nsec = ts.tv_nsec;
+    }
+
+  desc->hdr.bh1.ts_last_pkt.ts_sec  = ts.tv_sec;
+  desc->hdr.bh1.ts_last_pkt.ts_nsec = ts.tv_nsec;
+  desc->hdr.bh1.num_pkts++;
+  desc->hdr.bh1.blk_len = conn->rxoffset + PKT_FRAME_MAC + snaplen;
+
+  conn->rxlast    = conn->rxoffset;
+  conn->rxoffset += TPACKET_ALIGN(PKT_FRAME_MAC + snaplen);
+
+  /* Close the block now if no other frame fits */
+
+  if (conn->rxoffset + PKT_FRAME_MAC + ETH_HDRLEN > conn->rxring.pr_size)
+    {
+      pkt_ring_retire(conn, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_send
+ *
+ * Description:
+ *   Send the frames of the TX ring marked TP_STATUS_SEND_REQUEST.
+ *
+ * Returned Value:
+ *   The number of bytes sent, or a negated errno value.
+ *
+ ****************************************************************************/
+
+ssize_t pkt_ring_send(FAR struct socket *psock,
+                      FAR struct net_driver_s *dev)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  struct pkt_ring_send_s state;
+  FAR struct tpacket3_hdr *frame;
+  int ret = OK;
+
+  net_lock();
+
+  frame = PKT_FRAME(conn, conn->txring.pr_head);
+  if (PKT_STATUS(frame->tp_status) != TP_STATUS_SEND_REQUEST)
+    {
+      net_unlock();
+      return 0;
+    }
+
+  memset(&state, 0, sizeof(state));
+  nxsem_init(&state.rs_sem, 0, 0); /* Doesn't really fail */
+  state.rs_conn = conn;
+
+  state.rs_cb = pkt_callback_alloc(dev, conn);
+  if (state.rs_cb != NULL)
+    {
+      state.rs_cb->flags = PKT_POLL;
+      state.rs_cb->priv  = (FAR void *)&state;
+      state.rs_cb->event = pkt_ring_eventhandler;
+
+      /* Notify the device driver that new TX data is available. */
+
+      netdev_txnotify_dev(dev);
+
+      /* Wait until the frames are sent or an error occurred.
+       * net_sem_wait will also terminate if a signal is received.
+       */
+
+      ret = net_sem_wait(&state.rs_sem);
+
+      pkt_callback_free(dev, conn, state.rs_cb);
+    }
+  else
+    {
+      ret = -EBUSY;
+    }
+
+  nxsem_destroy(&state.rs_sem);
+  net_unlock();
+
+  if (state.rs_sent > 0)
+    {
+      return state.rs_sent;
+    }
+
+  return ret < 0 ? ret : state.rs_result;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_pollevents
+ *
+ * Description:
+ *   Return the poll events of the rings of a connection.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+pollevent_t pkt_ring_pollevents(FAR struct pkt_conn_s *conn)
+{
+  FAR struct tpacket_block_desc *desc;
+  FAR struct tpacket3_hdr *frame;
+  pollevent_t eventset = 0;
+  uint32_t prev;
+
+  /* Readable when the last closed block is not released yet */
+
+  if (conn->rxring.pr_num > 0)
+    {
+      prev = (conn->rxring.pr_head + conn->rxring.pr_num - 1) %
+             conn->rxring.pr_num;
+      desc = PKT_BLOCK(conn, prev);
+      if (PKT_STATUS(desc->hdr.bh1.block_status) != TP_STATUS_KERNEL)
+        {
+          eventset |= POLLIN;
+        }
+    }
+  else if (!IOB_QEMPTY(&conn->readahead))
+    {
+      eventset |= POLLIN;
+    }
+
+  /* Writable when the next frame to send is free */
+
+  if (conn->txring.pr_num > 0)
+    {
+      frame = PKT_FRAME(conn, conn->txring.pr_head);
+      if (PKT_STATUS(frame->tp_status) == TP_STATUS_AVAILABLE)
+        {
+          eventset |= POLLOUT;
+        }
+    }
+  else
+    {
+      eventset |= POLLOUT;
+    }
+
+  return eventset;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_free
+ *
+ * Description:
+ *   Release the rings of a connection.  The memory remains until it is
+ *   unmapped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_free(FAR struct pkt_conn_s *conn)
+{
+  work_cancel(LPWORK, &conn->rxwork);
+
+  if (conn->mmap != NULL)
+    {
+      pkt_mmap_release(conn->mmap);
+      conn->mmap = NULL;
+    }
+
+  memset(&conn->rxring, 0, sizeof(conn->rxring));
+  memset(&conn->txring, 0, sizeof(conn->txring));
+  conn->rxoffset = 0;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_PKT_MMAP */
@@ -164,12 +164,28 @@ end_wait:
 ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                     int flags)
 {
-  FAR const void *buf = msg->msg_iov->iov_base;
-  size_t len = msg->msg_iov->iov_len;
+  FAR const void *buf;
+  size_t len;
   FAR struct net_driver_s *dev;
   struct send_s state;
   int ret = OK;
 
+#ifdef CONFIG_NET_PKT_MMAP
+  /* With a TX ring, a send() sends the frames queued in the ring */
+
+  if (psock != NULL && psock->s_conn != NULL &&
+      ((FAR struct pkt_conn_s *)psock->s_conn)->txring.pr_num > 0)
+    {
+      dev = pkt_find_device(psock->s_conn);
+      if (dev == NULL)
+        {
+          return -ENODEV;
+        }
+
+      return pkt_ring_send(psock, dev);
+    }
+#endif
+
   /* Validity check, only single iov supported */
 
   if (msg->msg_iovlen != 1)
@@ -177,6 +193,9 @@ ssize_t pkt_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
       return -ENOTSUP;
     }
 
+  buf = msg->msg_iov->iov_base;
+  len = msg->msg_iov->iov_len;
+
   if (msg->msg_name != NULL)
     {
       /* pkt_sendto */
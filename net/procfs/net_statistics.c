@@ -59,12 +59,22 @@ static int netprocfs_checksum(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int netprocfs_tcp_dropped_1(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_tcp_dropped_2(FAR struct netprocfs_file_s *netfile);
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+static int netprocfs_tcp_dropped_3(FAR struct netprocfs_file_s *netfile);
+#endif
 #endif /* CONFIG_NET_TCP */
 static int netprocfs_prototype(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile);
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+static int netprocfs_sack(FAR struct netprocfs_file_s *netfile);
+#endif
 #endif /* CONFIG_NET_TCP */
+#if defined(CONFIG_NET_NAT) && defined(CONFIG_NET_IPv4)
+static int netprocfs_nat_entries(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_nat_lookups(FAR struct netprocfs_file_s *netfile);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -91,6 +101,9 @@ static const linegen_t g_stat_linegen[] =
 #ifdef CONFIG_NET_TCP
   netprocfs_tcp_dropped_1,
   netprocfs_tcp_dropped_2,
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+  netprocfs_tcp_dropped_3,
+#endif
 #endif /* CONFIG_NET_TCP */
 
   netprocfs_prototype,
@@ -98,7 +111,15 @@ static const linegen_t g_stat_linegen[] =
 
 #ifdef CONFIG_NET_TCP
   , netprocfs_retransmissions
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  , netprocfs_sack
+#endif
 #endif /* CONFIG_NET_TCP */
+
+#if defined(CONFIG_NET_NAT) && defined(CONFIG_NET_IPv4)
+  , netprocfs_nat_entries
+  , netprocfs_nat_lookups
+#endif
 };
 
 #define NSTAT_LINES (sizeof(g_stat_linegen) / sizeof(linegen_t))
@@ -310,6 +331,19 @@ static int netprocfs_tcp_dropped_2(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_tcp_dropped_3
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_TCP_TIMESTAMP)
+static int netprocfs_tcp_dropped_3(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "             PAWS: %04x\n",
+                  g_netstats.tcp.paws);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP_TIMESTAMP */
+
 /****************************************************************************
  * Name: netprocfs_prototype
  ****************************************************************************/
@@ -421,6 +455,66 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_sack
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_TCP_SELECTIVE_ACK)
+static int netprocfs_sack(FAR struct netprocfs_file_s *netfile)
+{
+  int len = 0;
+
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "    SACK   ");
+#ifdef CONFIG_NET_IPv4
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_IPv6
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  %04x",
+                  g_netstats.tcp.sack);
+#ifdef CONFIG_NET_UDP
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_ICMP
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+#ifdef CONFIG_NET_ICMPv6
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "  ----");
+#endif
+
+  len += snprintf(&netfile->line[len], NET_LINELEN - len, "\n");
+  return len;
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP_SELECTIVE_ACK */
+
+/****************************************************************************
+ * Name: netprocfs_nat_entries
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_NAT) && defined(CONFIG_NET_IPv4)
+static int netprocfs_nat_entries(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "NAT        Entries  %04x  Created  %04x  Expired  %04x\n",
+                  g_netstats.nat.entries, g_netstats.nat.created,
+                  g_netstats.nat.expired);
+}
+
+/****************************************************************************
+ * Name: netprocfs_nat_lookups
+ ****************************************************************************/
+
+static int netprocfs_nat_lookups(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  Lookups  In hit/miss  %04x/%04x  "
+                  "Out hit/miss  %04x/%04x\n",
+                  g_netstats.nat.inhits, g_netstats.nat.inmisses,
+                  g_netstats.nat.outhits, g_netstats.nat.outmisses);
+}
+#endif /* CONFIG_NET_NAT && CONFIG_NET_IPv4 */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -383,8 +383,9 @@ static int netprocfs_rxstatistics_header(
     FAR struct netprocfs_file_s *netfile)
 {
   DEBUGASSERT(netfile != NULL);
-  return snprintf(netfile->line, NET_LINELEN , "\tRX: %-8s %-8s %-8s\n",
-                  "Received", "Fragment", "Errors");
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\tRX: %-8s %-8s %-8s %-8s %-8s\n",
+                  "Received", "Fragment", "Errors", "Polls", "Budget");
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -402,10 +403,13 @@ static int netprocfs_rxstatistics(FAR struct netprocfs_file_s *netfile)
   dev = netfile->dev;
   stats = &dev->d_statistics;
 
-  return snprintf(netfile->line, NET_LINELEN, "\t    %08lx %08lx %08lx\n",
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\t    %08lx %08lx %08lx %08lx %08lx\n",
                   (unsigned long)stats->rx_packets,
                   (unsigned long)stats->rx_fragments,
-                  (unsigned long)stats->rx_errors);
+                  (unsigned long)stats->rx_errors,
+                  (unsigned long)stats->rx_polls,
+                  (unsigned long)stats->rx_exhausted);
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
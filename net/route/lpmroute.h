@@ -0,0 +1,104 @@
+/****************************************************************************
+ * net/route/lpmroute.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_LPMROUTE_H
+#define __NET_ROUTE_LPMROUTE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_LPM
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+struct net_driver_s; /* Forward reference */
+
+/****************************************************************************
+ * Name: net_init_lpmroute
+ *
+ * Description:
+ *   Initialize the longest prefix match index of the routing tables
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+void net_init_lpmroute(void);
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv4 and net_lpmroute_ipv6
+ *
+ * Description:
+ *   Find the router of the route with the longest prefix matching 'target'.
+ *   If 'dev' is not NULL, only the routes whose router lies on the network
+ *   of the device are considered.
+ *
+ * Input Parameters:
+ *   dev    - The device the route must use, or NULL.
+ *   target - The address on a remote network to look up.
+ *   router - The location to return the address of the router.
+ *
+ * Returned Value:
+ *   OK if a route was found; -ENOENT if there is none; -ENOSYS if the
+ *   routes cannot be indexed and the routing table must be scanned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lpmroute_ipv4(FAR struct net_driver_s *dev, in_addr_t target,
+                      FAR in_addr_t *router);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lpmroute_ipv6(FAR struct net_driver_s *dev,
+                      FAR const net_ipv6addr_t target,
+                      FAR net_ipv6addr_t router);
+#endif
+
+/****************************************************************************
+ * Name: net_flushlpm_ipv4 and net_flushlpm_ipv6
+ *
+ * Description:
+ *   Record a change of the routing table: the index is rebuilt by the next
+ *   lookup.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_flushlpm_ipv4(void);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_flushlpm_ipv6(void);
+#endif
+
+#else
+#  define net_flushlpm_ipv4()
+#  define net_flushlpm_ipv6()
+#endif /* CONFIG_ROUTE_LPM */
+#endif /* __NET_ROUTE_LPMROUTE_H */
@@ -34,6 +34,7 @@
 #include <nuttx/net/ip.h>
 
 #include "route/fileroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
@@ -82,6 +83,7 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
   /* Then append the new entry to the end of the routing table */
 
   nwritten = net_writeroute_ipv4(&fshandle, &route);
+  net_flushlpm_ipv4();
 
   net_closeroute_ipv4(&fshandle);
   return nwritten >= 0 ? 0 : (int)nwritten;
@@ -116,6 +118,7 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
   /* Then append the new entry to the end of the routing table */
 
   nwritten = net_writeroute_ipv6(&fshandle, &route);
+  net_flushlpm_ipv6();
 
   net_closeroute_ipv6(&fshandle);
   return nwritten >= 0 ? 0 : (int)nwritten;
@@ -38,6 +38,7 @@
 
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
@@ -253,6 +254,10 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
   net_flushcache_ipv4();
 #endif
 
+  /* The index of the routing table is rebuilt by the next lookup */
+
+  net_flushlpm_ipv4();
+
   /* Loop, copying each entry, to the previous entry thus removing the entry
    * to be deleted.
    */
@@ -404,6 +409,10 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
   net_flushcache_ipv6();
 #endif
 
+  /* The index of the routing table is rebuilt by the next lookup */
+
+  net_flushlpm_ipv6();
+
   /* Loop, copying each entry, to the previous entry thus removing the entry
    * to be deleted.
    */
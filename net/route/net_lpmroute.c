@@ -0,0 +1,816 @@
+/****************************************************************************
+ * net/route/net_lpmroute.c
+ * Longest prefix match index of the routing tables
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+
+#include "route/lpmroute.h"
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_LPM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+#  define LPM_MAXALEN          16
+#else
+#  define LPM_MAXALEN          4
+#endif
+
+#if (CONFIG_ROUTE_LPM_NFLOWS & (CONFIG_ROUTE_LPM_NFLOWS - 1)) != 0
+#  error CONFIG_ROUTE_LPM_NFLOWS must be a power of two
+#endif
+
+#define LPM_ALIGN(n)           (((n) + sizeof(uintptr_t) - 1) & \
+                                ~(sizeof(uintptr_t) - 1))
+#define LPM_NODESIZE(alen)     LPM_ALIGN(sizeof(struct lpm_node_s) + (alen))
+#define LPM_ENTRYSIZE(alen)    LPM_ALIGN(sizeof(struct lpm_entry_s) + (alen))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A route of a prefix */
+
+struct lpm_entry_s
+{
+  FAR struct lpm_entry_s *le_next;     /* Next route of the same prefix */
+  uint8_t le_router[1];                /* The router (alen bytes) */
+};
+
+/* A node of the path-compressed binary trie.  Nodes without routes only
+ * join two subtries that diverge at bit ln_plen.
+ */
+
+struct lpm_node_s
+{
+  FAR struct lpm_node_s *ln_child[2];  /* Subtries by the bit ln_plen */
+  FAR struct lpm_entry_s *ln_routes;   /* Routes of this prefix, if any */
+  uint8_t ln_plen;                     /* Prefix length in bits */
+  uint8_t ln_key[1];                   /* The prefix (alen bytes) */
+};
+
+/* A trie, allocated with its nodes and routes in one block.  A published
+ * trie is never modified: a change builds a new one.
+ */
+
+struct lpm_trie_s
+{
+  FAR struct lpm_node_s *lt_root;      /* The root node */
+  FAR uint8_t *lt_free;                /* Next free byte of the block */
+  FAR uint8_t *lt_end;                 /* End of the block */
+};
+
+/* The router of a recently looked up destination */
+
+#if CONFIG_ROUTE_LPM_NFLOWS > 0
+struct lpm_flow_s
+{
+  FAR struct net_driver_s *lf_dev;     /* Device constraint of the lookup */
+  uint32_t lf_gen;                     /* The trie it was found in */
+  uint8_t lf_target[LPM_MAXALEN];      /* The destination */
+  uint8_t lf_router[LPM_MAXALEN];      /* Its router */
+};
+#endif
+
+struct lpm_build_s;
+
+typedef int (*lpm_foreach_t)(FAR struct lpm_build_s *build);
+typedef bool (*lpm_filter_t)(FAR struct net_driver_s *dev,
+                             FAR const uint8_t *router);
+
+/* The index of the routing table of one address family */
+
+struct lpm_table_s
+{
+  FAR struct lpm_trie_s *lt_trie;      /* The published trie */
+  volatile uint32_t lt_changes;        /* Changes of the routing table */
+  uint32_t lt_built;                   /* Changes the trie was built at */
+  uint32_t lt_gen;                     /* Generation of the trie */
+  bool lt_usable;                      /* The routes could be indexed */
+  uint8_t lt_alen;                     /* Address length in bytes */
+  lpm_foreach_t lt_foreach;            /* Traverse the routing table */
+  lpm_filter_t lt_filter;              /* Match a router and a device */
+#if CONFIG_ROUTE_LPM_NFLOWS > 0
+  struct lpm_flow_s lt_flows[CONFIG_ROUTE_LPM_NFLOWS];
+#endif
+};
+
+/* The state of a trie being built from the routing table */
+
+struct lpm_build_s
+{
+  FAR struct lpm_table_s *lb_table;    /* The index built */
+  FAR struct lpm_trie_s *lb_trie;      /* NULL while counting the routes */
+  unsigned int lb_count;               /* Number of routes */
+  int lb_ret;                          /* First error */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static struct lpm_table_s g_lpm_ipv4;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct lpm_table_s g_lpm_ipv6;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lpm_bit
+ *
+ * Description:
+ *   Return the bit 'bit' of an address, bit 0 being the most significant.
+ *
+ ****************************************************************************/
+
+static inline int lpm_bit(FAR const uint8_t *key, int bit)
+{
+  return (key[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: lpm_common
+ *
+ * Description:
+ *   Return the number of leading bits two addresses have in common, at
+ *   most 'maxbits'.
+ *
+ ****************************************************************************/
+
+static int lpm_common(FAR const uint8_t *a, FAR const uint8_t *b,
+                      int maxbits)
+{
+  int bit;
+  int i;
+
+  for (i = 0, bit = 0; bit < maxbits; i++, bit += 8)
+    {
+      uint8_t diff = a[i] ^ b[i];
+
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              bit++;
+            }
+
+          break;
+        }
+    }
+
+  return MIN(bit, maxbits);
+}
+
+/****************************************************************************
+ * Name: lpm_prefixlen
+ *
+ * Description:
+ *   Return the prefix length of a netmask, -EINVAL if it is not contiguous.
+ *
+ ****************************************************************************/
+
+static int lpm_prefixlen(FAR const uint8_t *mask, int alen)
+{
+  int plen = 0;
+  int i;
+
+  for (i = 0; i < alen && mask[i] == 0xff; i++)
+    {
+      plen += 8;
+    }
+
+  if (i < alen)
+    {
+      uint8_t bits = mask[i];
+
+      while ((bits & 0x80) != 0)
+        {
+          bits <<= 1;
+          plen++;
+        }
+
+      if (bits != 0)
+        {
+          return -EINVAL;
+        }
+
+      for (i++; i < alen; i++)
+        {
+          if (mask[i] != 0)
+            {
+              return -EINVAL;
+            }
+        }
+    }
+
+  return plen;
+}
+
+/****************************************************************************
+ * Name: lpm_alloc
+ ****************************************************************************/
+
+static FAR void *lpm_alloc(FAR struct lpm_trie_s *trie, size_t size)
+{
+  FAR void *mem = trie->lt_free;
+
+  if (trie->lt_free + size > trie->lt_end)
+    {
+      return NULL;
+    }
+
+  trie->lt_free += size;
+  return mem;
+}
+
+/****************************************************************************
+ * Name: lpm_newnode
+ *
+ * Description:
+ *   Allocate a node for the first 'plen' bits of 'key'.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_newnode(FAR struct lpm_trie_s *trie,
+                                          int alen, FAR const uint8_t *key,
+                                          int plen)
+{
+  FAR struct lpm_node_s *node;
+  int i;
+
+  node = lpm_alloc(trie, LPM_NODESIZE(alen));
+  if (node == NULL)
+    {
+      return NULL;
+    }
+
+  node->ln_child[0] = NULL;
+  node->ln_child[1] = NULL;
+  node->ln_routes   = NULL;
+  node->ln_plen     = plen;
+
+  for (i = 0; i < alen; i++)
+    {
+      int bits = plen - 8 * i;
+
+      if (bits >= 8)
+        {
+          node->ln_key[i] = key[i];
+        }
+      else if (bits > 0)
+        {
+          node->ln_key[i] = key[i] & (uint8_t)(0xff << (8 - bits));
+        }
+      else
+        {
+          node->ln_key[i] = 0;
+        }
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: lpm_insert
+ *
+ * Description:
+ *   Add a route of prefix 'key'/'plen' to a trie being built.  The routes
+ *   of a same prefix keep the order of the routing table.
+ *
+ ****************************************************************************/
+
+static int lpm_insert(FAR struct lpm_trie_s *trie, int alen,
+                      FAR const uint8_t *key, int plen,
+                      FAR const uint8_t *router)
+{
+  FAR struct lpm_node_s **link = &trie->lt_root;
+  FAR struct lpm_entry_s **tail;
+  FAR struct lpm_entry_s *entry;
+  FAR struct lpm_node_s *node;
+
+  entry = lpm_alloc(trie, LPM_ENTRYSIZE(alen));
+  if (entry == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  entry->le_next = NULL;
+  memcpy(entry->le_router, router, alen);
+
+  while ((node = *link) != NULL)
+    {
+      int common = lpm_common(key, node->ln_key, MIN(plen, node->ln_plen));
+
+      if (common < node->ln_plen)
+        {
+          FAR struct lpm_node_s *split;
+
+          /* The prefix is shorter than the node or diverges from it: a new
+           * node takes its place, with the node below.
+           */
+
+          split = lpm_newnode(trie, alen, key, common);
+          if (split == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          split->ln_child[lpm_bit(node->ln_key, common)] = node;
+          *link = split;
+
+          if (common == plen)
+            {
+              split->ln_routes = entry;
+              return OK;
+            }
+
+          link = &split->ln_child[lpm_bit(key, common)];
+          break;
+        }
+
+      if (plen == node->ln_plen)
+        {
+          for (tail = &node->ln_routes; *tail != NULL;
+               tail = &(*tail)->le_next);
+
+          *tail = entry;
+          return OK;
+        }
+
+      link = &node->ln_child[lpm_bit(key, node->ln_plen)];
+    }
+
+  node = lpm_newnode(trie, alen, key, plen);
+  if (node == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  node->ln_routes = entry;
+  *link = node;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lpm_add
+ *
+ * Description:
+ *   Count or insert one route of the routing table.
+ *
+ * Returned Value:
+ *   Zero to continue the traversal, one to stop it on an error.
+ *
+ ****************************************************************************/
+
+static int lpm_add(FAR struct lpm_build_s *build, FAR const uint8_t *target,
+                   FAR const uint8_t *netmask, FAR const uint8_t *router)
+{
+  int alen = build->lb_table->lt_alen;
+  int plen;
+
+  plen = lpm_prefixlen(netmask, alen);
+  if (plen >= 0 && build->lb_trie != NULL)
+    {
+      plen = lpm_insert(build->lb_trie, alen, target, plen, router);
+    }
+
+  if (plen < 0)
+    {
+      build->lb_ret = plen;
+      return 1;
+    }
+
+  build->lb_count++;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: lpm_publish
+ *
+ * Description:
+ *   Replace the trie of a table.  The lookups hold the network lock, as
+ *   the replacement does, so none may still be walking the old trie.
+ *
+ ****************************************************************************/
+
+static void lpm_publish(FAR struct lpm_table_s *table,
+                        FAR struct lpm_trie_s *trie)
+{
+  FAR struct lpm_trie_s *old = table->lt_trie;
+
+  /* The trie is complete before it is visible */
+
+  SEQ_DMB();
+  table->lt_trie = trie;
+
+  /* The flows cached from the old trie are stale */
+
+  if (++table->lt_gen == 0)
+    {
+      table->lt_gen = 1;
+    }
+
+  if (old != NULL)
+    {
+      kmm_free(old);
+    }
+}
+
+/****************************************************************************
+ * Name: lpm_rebuild
+ *
+ * Description:
+ *   Build the trie of a table from its routing table.
+ *
+ ****************************************************************************/
+
+static void lpm_rebuild(FAR struct lpm_table_s *table)
+{
+  struct lpm_build_s build;
+  FAR struct lpm_trie_s *trie = NULL;
+  uint32_t changes;
+  size_t size;
+
+  /* A change made while building triggers another build */
+
+  changes = table->lt_changes;
+  table->lt_built = changes;
+  SEQ_DMB();
+
+  memset(&build, 0, sizeof(build));
+  build.lb_table = table;
+
+  /* Count the routes first, each adds at most two nodes */
+
+  table->lt_foreach(&build);
+  if (build.lb_ret >= 0)
+    {
+      size = sizeof(struct lpm_trie_s) +
+             build.lb_count * (LPM_ENTRYSIZE(table->lt_alen) +
+                               2 * LPM_NODESIZE(table->lt_alen));
+
+      trie = kmm_malloc(size);
+      if (trie == NULL)
+        {
+          build.lb_ret = -ENOMEM;
+        }
+    }
+
+  if (trie != NULL)
+    {
+      trie->lt_root = NULL;
+      trie->lt_free = (FAR uint8_t *)trie +
+                      LPM_ALIGN(sizeof(struct lpm_trie_s));
+      trie->lt_end  = (FAR uint8_t *)trie + size;
+
+      build.lb_trie  = trie;
+      build.lb_count = 0;
+      table->lt_foreach(&build);
+
+      if (build.lb_ret < 0)
+        {
+          kmm_free(trie);
+          trie = NULL;
+        }
+    }
+
+  if (build.lb_ret < 0)
+    {
+      nwarn("WARNING: Routes not indexed, scanning them: %d\n",
+            build.lb_ret);
+    }
+  else
+    {
+      ninfo("Indexed %u routes\n", build.lb_count);
+    }
+
+  lpm_publish(table, trie);
+  table->lt_usable = trie != NULL;
+}
+
+/****************************************************************************
+ * Name: lpm_hash
+ ****************************************************************************/
+
+#if CONFIG_ROUTE_LPM_NFLOWS > 0
+static unsigned int lpm_hash(FAR struct net_driver_s *dev,
+                             FAR const uint8_t *target, int alen)
+{
+  uint32_t hash = (uint32_t)(uintptr_t)dev;
+  uint32_t word;
+  int i;
+
+  for (i = 0; i < alen; i += sizeof(uint32_t))
+    {
+      memcpy(&word, target + i, sizeof(uint32_t));
+      hash = hash * 31 + word;
+    }
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  return hash & (CONFIG_ROUTE_LPM_NFLOWS - 1);
+}
+#endif
+
+/****************************************************************************
+ * Name: lpm_route
+ *
+ * Description:
+ *   Look up 'target' in the index of a routing table.
+ *
+ ****************************************************************************/
+
+static int lpm_route(FAR struct lpm_table_s *table,
+                     FAR struct net_driver_s *dev,
+                     FAR const uint8_t *target, FAR uint8_t *router)
+{
+  FAR struct lpm_trie_s *trie;
+  FAR struct lpm_node_s *node;
+  FAR const uint8_t *best = NULL;
+  int alen = table->lt_alen;
+#if CONFIG_ROUTE_LPM_NFLOWS > 0
+  FAR struct lpm_flow_s *flow;
+#endif
+
+  if (table->lt_built != table->lt_changes)
+    {
+      lpm_rebuild(table);
+    }
+
+  if (!table->lt_usable)
+    {
+      return -ENOSYS;
+    }
+
+#if CONFIG_ROUTE_LPM_NFLOWS > 0
+  flow = &table->lt_flows[lpm_hash(dev, target, alen)];
+  if (flow->lf_gen == table->lt_gen && flow->lf_dev == dev &&
+      memcmp(flow->lf_target, target, alen) == 0)
+    {
+      memcpy(router, flow->lf_router, alen);
+      return OK;
+    }
+#endif
+
+  /* Walk down the prefixes of the target, the last route found is the
+   * longest match.
+   */
+
+  trie = table->lt_trie;
+  SEQ_DMB();
+
+  for (node = trie->lt_root; node != NULL; )
+    {
+      FAR struct lpm_entry_s *entry;
+
+      if (lpm_common(target, node->ln_key, node->ln_plen) < node->ln_plen)
+        {
+          break;
+        }
+
+      for (entry = node->ln_routes; entry != NULL; entry = entry->le_next)
+        {
+          if (dev == NULL || table->lt_filter(dev, entry->le_router))
+            {
+              best = entry->le_router;
+              break;
+            }
+        }
+
+      if (node->ln_plen >= 8 * alen)
+        {
+          break;
+        }
+
+      node = node->ln_child[lpm_bit(target, node->ln_plen)];
+    }
+
+  if (best == NULL)
+    {
+      return -ENOENT;
+    }
+
+  memcpy(router, best, alen);
+
+#if CONFIG_ROUTE_LPM_NFLOWS > 0
+  flow->lf_dev = dev;
+  flow->lf_gen = table->lt_gen;
+  memcpy(flow->lf_target, target, alen);
+  memcpy(flow->lf_router, best, alen);
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lpm_add_ipv4, lpm_foreach_ipv4 and lpm_filter_ipv4
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int lpm_add_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
+{
+  return lpm_add(arg, (FAR const uint8_t *)&route->target,
+                 (FAR const uint8_t *)&route->netmask,
+                 (FAR const uint8_t *)&route->router);
+}
+
+static int lpm_foreach_ipv4(FAR struct lpm_build_s *build)
+{
+  return net_foreachroute_ipv4(lpm_add_ipv4, build);
+}
+
+static bool lpm_filter_ipv4(FAR struct net_driver_s *dev,
+                            FAR const uint8_t *router)
+{
+  in_addr_t addr;
+
+  memcpy(&addr, router, sizeof(in_addr_t));
+  return net_ipv4addr_maskcmp(addr, dev->d_ipaddr, dev->d_netmask);
+}
+#endif
+
+/****************************************************************************
+ * Name: lpm_add_ipv6, lpm_foreach_ipv6 and lpm_filter_ipv6
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+static int lpm_add_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
+{
+  return lpm_add(arg, (FAR const uint8_t *)route->target,
+                 (FAR const uint8_t *)route->netmask,
+                 (FAR const uint8_t *)route->router);
+}
+
+static int lpm_foreach_ipv6(FAR struct lpm_build_s *build)
+{
+  return net_foreachroute_ipv6(lpm_add_ipv6, build);
+}
+
+static bool lpm_filter_ipv6(FAR struct net_driver_s *dev,
+                            FAR const uint8_t *router)
+{
+  net_ipv6addr_t addr;
+
+  memcpy(addr, router, sizeof(net_ipv6addr_t));
+  return net_ipv6addr_maskcmp(addr, dev->d_ipv6addr, dev->d_ipv6netmask);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_lpmroute
+ *
+ * Description:
+ *   Initialize the longest prefix match index of the routing tables
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+void net_init_lpmroute(void)
+{
+  /* The first lookup builds the tries */
+
+#ifdef CONFIG_NET_IPv4
+  g_lpm_ipv4.lt_alen    = sizeof(in_addr_t);
+  g_lpm_ipv4.lt_changes = 1;
+  g_lpm_ipv4.lt_foreach = lpm_foreach_ipv4;
+  g_lpm_ipv4.lt_filter  = lpm_filter_ipv4;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  g_lpm_ipv6.lt_alen    = sizeof(net_ipv6addr_t);
+  g_lpm_ipv6.lt_changes = 1;
+  g_lpm_ipv6.lt_foreach = lpm_foreach_ipv6;
+  g_lpm_ipv6.lt_filter  = lpm_filter_ipv6;
+#endif
+}
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv4 and net_lpmroute_ipv6
+ *
+ * Description:
+ *   Find the router of the route with the longest prefix matching 'target'.
+ *   If 'dev' is not NULL, only the routes whose router lies on the network
+ *   of the device are considered.
+ *
+ * Input Parameters:
+ *   dev    - The device the route must use, or NULL.
+ *   target - The address on a remote network to look up.
+ *   router - The location to return the address of the router.
+ *
+ * Returned Value:
+ *   OK if a route was found; -ENOENT if there is none; -ENOSYS if the
+ *   routes cannot be indexed and the routing table must be scanned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lpmroute_ipv4(FAR struct net_driver_s *dev, in_addr_t target,
+                      FAR in_addr_t *router)
+{
+  int ret;
+
+  net_lock();
+  ret = lpm_route(&g_lpm_ipv4, dev, (FAR const uint8_t *)&target,
+                  (FAR uint8_t *)router);
+  net_unlock();
+
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lpmroute_ipv6(FAR struct net_driver_s *dev,
+                      FAR const net_ipv6addr_t target,
+                      FAR net_ipv6addr_t router)
+{
+  int ret;
+
+  net_lock();
+  ret = lpm_route(&g_lpm_ipv6, dev, (FAR const uint8_t *)target,
+                  (FAR uint8_t *)router);
+  net_unlock();
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: net_flushlpm_ipv4 and net_flushlpm_ipv6
+ *
+ * Description:
+ *   Record a change of the routing table: the index is rebuilt by the next
+ *   lookup.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_flushlpm_ipv4(void)
+{
+  net_lock();
+  g_lpm_ipv4.lt_changes++;
+  net_unlock();
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_flushlpm_ipv6(void)
+{
+  net_lock();
+  g_lpm_ipv6.lt_changes++;
+  net_unlock();
+}
+#endif
+
+#endif /* CONFIG_ROUTE_LPM */
@@ -33,6 +33,7 @@
 
 #include "netdev/netdev.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -218,6 +219,21 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
   struct route_ipv4_devmatch_s match;
   int ret;
 
+#ifdef CONFIG_ROUTE_LPM
+  /* Look up the longest prefix match in the index of the routes */
+
+  ret = net_lpmroute_ipv4(dev, target, router);
+  if (ret == -ENOENT)
+    {
+      net_ipv4addr_copy(*router, dev->d_draddr);
+    }
+
+  if (ret != -ENOSYS)
+    {
+      return;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv4_devmatch_s));
@@ -297,6 +313,21 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
   struct route_ipv6_devmatch_s match;
   int ret;
 
+#ifdef CONFIG_ROUTE_LPM
+  /* Look up the longest prefix match in the index of the routes */
+
+  ret = net_lpmroute_ipv6(dev, target, router);
+  if (ret == -ENOENT)
+    {
+      net_ipv6addr_copy(router, dev->d_ipv6draddr);
+    }
+
+  if (ret != -ENOSYS)
+    {
+      return;
+    }
+#endif
+
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv6_devmatch_s));
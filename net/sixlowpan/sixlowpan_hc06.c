@@ -101,6 +101,15 @@ struct sixlowpan_addrcontext_s
   uint8_t prefix[8];
 };
 
+/* The address context last found for the prefix of a neighbor */
+
+struct sixlowpan_ctxcache_s
+{
+  uint16_t prefix[4];
+  FAR struct sixlowpan_addrcontext_s *context;
+  bool valid;
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -118,6 +127,15 @@ struct sixlowpan_addrcontext_s
 
 static struct sixlowpan_addrcontext_s
   g_hc06_addrcontexts[CONFIG_NET_6LOWPAN_MAXADDRCONTEXT];
+
+#if CONFIG_NET_6LOWPAN_CTXCACHE > 0
+/* Address contexts found by prefix, the contexts never change once set up
+ * so nor do these.
+ */
+
+static struct sixlowpan_ctxcache_s
+  g_hc06_ctxcache[CONFIG_NET_6LOWPAN_CTXCACHE];
+#endif
 #endif
 
 /* Pointer to the byte where to write next inline field. */
@@ -231,8 +249,21 @@ static FAR struct sixlowpan_addrcontext_s *
   find_addrcontext_byprefix(FAR const net_ipv6addr_t ipaddr)
 {
 #if CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0
+  FAR struct sixlowpan_addrcontext_s *context = NULL;
+#if CONFIG_NET_6LOWPAN_CTXCACHE > 0
+  FAR struct sixlowpan_ctxcache_s *cache;
+#endif
   int i;
 
+#if CONFIG_NET_6LOWPAN_CTXCACHE > 0
+  cache = &g_hc06_ctxcache[(ipaddr[0] ^ ipaddr[1] ^ ipaddr[2] ^ ipaddr[3]) %
+                           CONFIG_NET_6LOWPAN_CTXCACHE];
+  if (cache->valid && memcmp(cache->prefix, ipaddr, 8) == 0)
+    {
+      return cache->context;
+    }
+#endif
+
   /* Remove code to avoid warnings and save flash if no address context is
    * used
    */
@@ -250,12 +281,21 @@ static FAR struct sixlowpan_addrcontext_s *
                 NTOHS(ipaddr[6]), NTOHS(ipaddr[7]),
                 g_hc06_addrcontexts[i].number);
 
-          return &g_hc06_addrcontexts[i];
+          context = &g_hc06_addrcontexts[i];
+          break;
         }
     }
-#endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
 
+#if CONFIG_NET_6LOWPAN_CTXCACHE > 0
+  memcpy(cache->prefix, ipaddr, 8);
+  cache->context = context;
+  cache->valid   = true;
+#endif
+
+  return context;
+#else
   return NULL;
+#endif /* CONFIG_NET_6LOWPAN_MAXADDRCONTEXT > 0 */
 }
 
 /****************************************************************************
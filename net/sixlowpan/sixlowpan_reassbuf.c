@@ -44,6 +44,8 @@
 
 #define NET_6LOWPAN_TIMEOUT SEC2TICK(CONFIG_NET_6LOWPAN_MAXAGE)
 
+#define NET_6LOWPAN_NHASH   CONFIG_NET_6LOWPAN_REASS_HASHSIZE
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -55,9 +57,15 @@
 
 static FAR struct sixlowpan_reassbuf_s *g_free_reass;
 
-/* This is a list of active, allocated reassemby buffers */
+/* These are the lists of active, allocated reassemby buffers, hashed by
+ * reassembly tag and fragment source.
+ */
+
+static FAR struct sixlowpan_reassbuf_s *g_active_reass[NET_6LOWPAN_NHASH];
 
-static FAR struct sixlowpan_reassbuf_s *g_active_reass;
+/* The time at which the oldest active reassembly buffer expires */
+
+static clock_t g_reass_expire;
 
 /* Pool of pre-allocated reassembly buffer structures */
 
@@ -65,9 +73,33 @@ static struct sixlowpan_reassbuf_s
               g_metadata_pool[CONFIG_NET_6LOWPAN_NREASSBUF];
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sixlowpan_reass_hash
+ *
+ * Description:
+ *   Return the index of the active list of a reassembly tag and fragment
+ *   source.
+ *
  ****************************************************************************/
 
+static unsigned int
+sixlowpan_reass_hash(uint16_t reasstag,
+                     FAR const struct netdev_varaddr_s *fragsrc)
+{
+  unsigned int hash = reasstag;
+  int i;
+
+  for (i = 0; i < fragsrc->nv_addrlen && i < RADIO_MAX_ADDRLEN; i++)
+    {
+      hash = hash * 31 + fragsrc->nv_addr[i];
+    }
+
+  return hash % NET_6LOWPAN_NHASH;
+}
+
 /****************************************************************************
  * Name: sixlowpan_compare_fragsrc
  *
@@ -104,10 +136,11 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
  * Name: sixlowpan_reass_expire
  *
  * Description:
- *   Free all expired or inactive reassembly buffers.
+ *   Free all expired or inactive reassembly buffers.  Nothing is done
+ *   until the oldest active reassembly buffer expires, unless forced.
  *
  * Input Parameters:
- *   None
+ *   force - Scan the reassembly buffers now.
  *
  * Returned Value:
  *   None
@@ -117,41 +150,59 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
  *
  ****************************************************************************/
 
-static void sixlowpan_reass_expire(void)
+static void sixlowpan_reass_expire(bool force)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
   FAR struct sixlowpan_reassbuf_s *next;
+  clock_t now = clock_systime_ticks();
   clock_t elapsed;
+  int i;
+
+  if (!force && (sclock_t)(now - g_reass_expire) < 0)
+    {
+      return;
+    }
+
+  g_reass_expire = now + NET_6LOWPAN_TIMEOUT;
 
   /* If reassembly timed out, cancel it */
 
-  for (reass = g_active_reass; reass != NULL; reass = next)
+  for (i = 0; i < NET_6LOWPAN_NHASH; i++)
     {
-      /* Needed if 'reass' is freed */
+      for (reass = g_active_reass[i]; reass != NULL; reass = next)
+        {
+          /* Needed if 'reass' is freed */
 
-      next = reass->rb_flink;
+          next = reass->rb_flink;
 
-      /* Free any inactive reassembly buffers.  This is done because the life
-       * the reassembly buffer is not cerain.
-       */
+          /* Free any inactive reassembly buffers.  This is done because the
+           * life the reassembly buffer is not cerain.
+           */
+
+          if (!reass->rb_active)
+            {
+              sixlowpan_reass_free(reass);
+              continue;
+            }
 
-      if (!reass->rb_active)
-        {
-          sixlowpan_reass_free(reass);
-        }
-      else
-        {
           /* Get the elpased time of the reassembly */
 
-          elapsed = clock_systime_ticks() - reass->rb_time;
+          elapsed = now - reass->rb_time;
 
-          /* If the reassembly has expired, then free the reassembly buffer */
+          /* If the reassembly has expired, then free the reassembly buffer,
+           * or else remember when it will.
+           */
 
           if (elapsed >= NET_6LOWPAN_TIMEOUT)
             {
               nwarn("WARNING: Reassembly timed out\n");
               sixlowpan_reass_free(reass);
             }
+          else if ((sclock_t)(reass->rb_time + NET_6LOWPAN_TIMEOUT -
+                              g_reass_expire) < 0)
+            {
+              g_reass_expire = reass->rb_time + NET_6LOWPAN_TIMEOUT;
+            }
         }
     }
 }
@@ -175,12 +226,16 @@ static void sixlowpan_reass_expire(void)
 
 static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *curr;
   FAR struct sixlowpan_reassbuf_s *prev;
 
+  head = &g_active_reass[sixlowpan_reass_hash(reass->rb_reasstag,
+                                              &reass->rb_fragsrc)];
+
   /* Find the reassembly buffer in the list of active reassembly buffers */
 
-  for (prev = NULL, curr = g_active_reass;
+  for (prev = NULL, curr = *head;
        curr != NULL && curr != reass;
        prev = curr, curr = curr->rb_flink)
     {
@@ -194,7 +249,7 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 
       if (prev == NULL)
         {
-          g_active_reass = reass->rb_flink;
+          *head = reass->rb_flink;
         }
       else
         {
@@ -279,6 +334,7 @@ FAR struct sixlowpan_reassbuf_s *
   sixlowpan_reass_allocate(uint16_t reasstag,
                            FAR const struct netdev_varaddr_s *fragsrc)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *reass;
   uint8_t pool;
 
@@ -286,7 +342,7 @@ FAR struct sixlowpan_reassbuf_s *
    * free up a pre-allocated buffer for this allocation.
    */
 
-  sixlowpan_reass_expire();
+  sixlowpan_reass_expire(g_free_reass == NULL);
 
   /* Now, try the free list first */
 
@@ -326,8 +382,16 @@ FAR struct sixlowpan_reassbuf_s *
 
       /* Add the reassembly buffer to the list of active reassembly buffers */
 
-      reass->rb_flink   = g_active_reass;
-      g_active_reass    = reass;
+      head              = &g_active_reass[sixlowpan_reass_hash(reasstag,
+                                                               fragsrc)];
+      reass->rb_flink   = *head;
+      *head             = reass;
+
+      if ((sclock_t)(reass->rb_time + NET_6LOWPAN_TIMEOUT -
+                     g_reass_expire) < 0)
+        {
+          g_reass_expire = reass->rb_time + NET_6LOWPAN_TIMEOUT;
+        }
     }
 
   return reass;
@@ -362,13 +426,14 @@ FAR struct sixlowpan_reassbuf_s *
    * to return old reassembly buffer with the same tag)
    */
 
-  sixlowpan_reass_expire();
+  sixlowpan_reass_expire(false);
 
   /* Now search for the matching reassembly buffer in the remainng, active
    * reassembly buffers.
    */
 
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+  for (reass = g_active_reass[sixlowpan_reass_hash(reasstag, fragsrc)];
+       reass != NULL; reass = reass->rb_flink)
     {
       /* In order to be a match, it must have the same reassembly tag as
        * well as source address (different sources might use the same
@@ -410,10 +475,13 @@ FAR struct sixlowpan_reassbuf_s *
 void sixlowpan_reass_free(FAR struct sixlowpan_reassbuf_s *reass)
 {
   /* First, remove the reassembly buffer from the list of active reassembly
-   * buffers.
+   * buffers.  Those provided by the driver are never in the list.
    */
 
-  sixlowpan_remove_active(reass);
+  if (reass->rb_pool != REASS_POOL_RADIO)
+    {
+      sixlowpan_remove_active(reass);
+    }
 
   /* If this is a pre-allocated reassembly buffer structure, then just put it
    * back in the free list.
@@ -150,6 +150,8 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
                            * periodic transmission of probes */
       case SO_OOBINLINE:  /* Leaves received out-of-band data inline */
       case SO_REUSEADDR:  /* Allow reuse of local addresses */
+      case SO_REUSEPORT:  /* Balance traffic among sockets on one port */
+      case SO_ZEROCOPY:   /* Allow sends by reference with MSG_ZEROCOPY */
         {
           sockopt_t optionset;
 
@@ -1,5 +1,5 @@
 /****************************************************************************
- * sched/group/group_setupstreams.c
+ * net/socket/net_mmap.c
  *
  * Licensed to the Apache Software Foundation (ASF) under one or more
  * contributor license agreements.  See the NOTICE file distributed with
@@ -24,51 +24,46 @@
 
 #include <nuttx/config.h>
 
-#include <sched.h>
-#include <fcntl.h>
 #include <assert.h>
+#include <errno.h>
 
-#include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
 
-#include "group/group.h"
-
-/* Make sure that there are file or socket descriptors in the system and
- * that some number of streams have been configured.
- */
-
-#ifdef CONFIG_FILE_STREAM
+#include "socket/socket.h"
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: group_setupstreams
+ * Name: psock_mmap
  *
  * Description:
- *   Setup streams data structures that may be used for standard C buffered
- *   I/O with underlying socket or file descriptors
+ *   The standard mmap() operation redirects operations on socket
+ *   descriptors to this function.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   map   - The mapping to setup, see mm_map_entry_s.
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
  *
  ****************************************************************************/
 
-int group_setupstreams(FAR struct task_tcb_s *tcb)
+int psock_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map)
 {
-  DEBUGASSERT(tcb && tcb->cmn.group);
+  DEBUGASSERT(psock != NULL && map != NULL);
 
-  /* fdopen to get the stdin, stdout and stderr streams. The following logic
-   * depends on the fact that the library layer will allocate FILEs in order.
-   *
-   * fd = 0 is stdin  (read-only)
-   * fd = 1 is stdout (write-only, append)
-   * fd = 2 is stderr (write-only, append)
+  /* Let the address family's mmap() method handle the operation.  Sockets
+   * are not files: never fall back to a copy of the "file" content.
    */
 
-  fs_fdopen(0, O_RDONLY,         (FAR struct tcb_s *)tcb, NULL);
-  fs_fdopen(1, O_WROK | O_CREAT, (FAR struct tcb_s *)tcb, NULL);
-  fs_fdopen(2, O_WROK | O_CREAT, (FAR struct tcb_s *)tcb, NULL);
+  DEBUGASSERT(psock->s_sockif != NULL);
+  if (psock->s_sockif->si_mmap == NULL)
+    {
+      return -ENODEV;
+    }
 
-  return OK;
+  return psock->s_sockif->si_mmap(psock, map);
 }
-
-#endif /* CONFIG_FILE_STREAM */
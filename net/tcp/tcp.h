@@ -53,6 +53,12 @@
 
 #define NET_TCP_HAVE_STACK 1
 
+/* Closed connections leave a tombstone for the rest of TIME_WAIT */
+
+#if defined(CONFIG_NET_TCP_TIMER_WHEEL) && CONFIG_NET_TCP_NTOMBSTONES > 0
+#  define NET_TCP_HAVE_TOMBSTONES 1
+#endif
+
 /* Allocate a new TCP data callback */
 
 /* These macros allocate and free callback structures used for receiving
@@ -107,6 +113,9 @@
 #define TCP_WSCALE            0x01U /* Window Scale option enabled */
 #define TCP_SACK              0x02U /* Selective ACKs enabled */
 #define TCP_CLOSE_ARRANGED    0x04U /* Connection is arranged to be freed */
+#define TCP_TSTAMP            0x20U /* Timestamps enabled */
+#define TCP_RCVBUF_LOCK       0x40U /* SO_RCVBUF set, no auto-tuning */
+#define TCP_SNDBUF_LOCK       0x80U /* SO_SNDBUF set, no auto-tuning */
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
 /* The TCP flags for congestion control */
@@ -114,12 +123,23 @@
 #define TCP_INFR              0x08U /* The flag in Fast Recovery */
 #define TCP_INFT              0x10U /* The flag in Fast Transmitted */
 
+/* The congestion control algorithms, see tcp_cc_setalgo() */
+
+#define TCP_CC_NEWRENO        0
+#define TCP_CC_CUBIC          1
+
 #endif
 
 /* The Max Range count of TCP Selective ACKs */
 
 #define TCP_SACK_RANGES_MAX   4
 
+/* The Max count of out-of-order ranges held by a connection */
+
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+#  define TCP_OFOSEGS_MAX     CONFIG_NET_TCP_OUT_OF_ORDER_SEGMENTS
+#endif
+
 /* After receiving 3 duplicate ACKs, TCP performs a retransmission
  * (RFC 5681 (3.2))
  */
@@ -129,6 +149,18 @@
 #define TCP_RTO_MAX 240 /* 120s,The unit is half a second */
 #define TCP_RTO_MIN 1   /* 0.5s */
 
+/* Size of the options carried by every segment, with TCP_TSTAMP the
+ * timestamps (RFC7323), and the clock of the timestamps (units: ms).
+ */
+
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+#  define TCP_TSOPT_LEN(conn) \
+     (((conn)->flags & TCP_TSTAMP) != 0 ? TCP_OPT_TS_ALIGNED_LEN : 0)
+#  define TCP_TSVAL()         ((uint32_t)TICK2MSEC(clock_systime_ticks()))
+#else
+#  define TCP_TSOPT_LEN(conn) 0
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -210,6 +242,9 @@ struct tcp_conn_s
 
   /* TCP-specific content follows */
 
+#if CONFIG_NET_TCP_HASH_SIZE > 0
+  sq_entry_t hnode;       /* Link in the connection hash table */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -228,7 +263,13 @@ struct tcp_conn_s
                            * variable */
   uint8_t  rto;           /* Retransmission time-out */
   uint8_t  tcpstateflags; /* TCP state and flags */
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+  dq_entry_t wnode;       /* Node in the slot of the timer wheel */
+  uint32_t wexpire;       /* Expiration time (units: half-seconds) */
+  bool     warmed;        /* True: the timer is on the wheel */
+#else
   struct   work_s work;   /* TCP timer handle */
+#endif
   bool     timeout;       /* Trigger from timer expiry */
   uint8_t  timer;         /* The retransmission timer (units: half-seconds) */
   uint8_t  nrtx;          /* The number of retransmissions for the last
@@ -254,6 +295,13 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+  uint8_t  cc_algo;       /* The congestion control algorithm, TCP_CC_* */
+#endif
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  uint32_t cubic_wmax;    /* The window at the last congestion event */
+  uint32_t cubic_k;       /* Time to grow back to cubic_wmax (units: ms) */
+  uint32_t cubic_west;    /* The window that NewReno would have */
+  clock_t  cubic_epoch;   /* Start of the growth, or 0 if none */
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -269,6 +317,16 @@ struct tcp_conn_s
 #if CONFIG_NET_RECV_BUFSIZE > 0
   int32_t  rcv_bufs;      /* Maximum amount of bytes queued in recv */
 #endif
+#if defined(CONFIG_NET_TCP_AUTOTUNE) && CONFIG_NET_RECV_BUFSIZE > 0
+  uint32_t rcvq_copied;   /* Bytes read by the user in this interval */
+  clock_t  rcvq_time;     /* Start of the interval */
+#endif
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  uint32_t zc_next;       /* Id of the next MSG_ZEROCOPY send */
+  uint32_t zc_lo;         /* Completed sends not read from the error */
+  uint32_t zc_hi;         /*   queue yet, if zc_ready */
+  bool     zc_ready;
+#endif
 #if CONFIG_NET_SEND_BUFSIZE > 0
   int32_t  snd_bufs;      /* Maximum amount of bytes queued in send */
   sem_t    snd_sem;       /* Semaphore signals send completion */
@@ -280,6 +338,9 @@ struct tcp_conn_s
   uint16_t tx_unacked;    /* Number bytes sent but not yet ACKed */
 #endif
   uint16_t flags;         /* Flags of TCP-specific options */
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+  uint32_t ts_recent;     /* The timestamp to echo to the peer */
+#endif
 #ifdef CONFIG_NET_SOLINGER
   sclock_t ltimeout;      /* Linger timeout expiration */
 #endif
@@ -303,9 +364,15 @@ struct tcp_conn_s
 
   uint8_t nofosegs;
 
-  /* This defines a out of order segment block. */
+  /* Left edge of the latest out-of-order segment, its range is reported
+   * first in SACK options (RFC 2018 section 4).
+   */
+
+  uint32_t ofoseg_recent;
 
-  struct tcp_ofoseg_s ofosegs[TCP_SACK_RANGES_MAX];
+  /* This defines a out of order segment block, sorted by left edge. */
+
+  struct tcp_ofoseg_s ofosegs[TCP_OFOSEGS_MAX];
 #endif
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
@@ -412,6 +479,9 @@ struct tcp_wrbuffer_s
                             * segment sent */
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
   uint8_t    wb_nack;      /* The number of ack count */
+#endif
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  bool       wb_zerocopy;  /* The I/O buffers refer to user memory */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
 };
@@ -1038,11 +1108,58 @@ void tcp_update_keeptimer(FAR struct tcp_conn_s *conn, int timeout);
 
 void tcp_stop_timer(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_timewait_add
+ *
+ * Description:
+ *   Keep a tombstone of a connection in the TIME_WAIT state that is being
+ *   freed: its addresses and ports, until the end of TIME_WAIT.  The
+ *   oldest tombstone is reused when all of them are taken.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection in the TIME_WAIT state
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef NET_TCP_HAVE_TOMBSTONES
+void tcp_timewait_add(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_timewait_input
+ *
+ * Description:
+ *   Handle a segment that matches no connection.  If it belongs to a
+ *   connection that left a tombstone, it is acknowledged as in the
+ *   TIME_WAIT state instead of being reset.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure containing the received segment
+ *   tcp - The TCP header of the segment
+ *
+ * Returned Value:
+ *   true if the segment was handled here.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef NET_TCP_HAVE_TOMBSTONES
+bool tcp_timewait_input(FAR struct net_driver_s *dev,
+                        FAR struct tcp_hdr_s *tcp);
+#endif
+
 /****************************************************************************
  * Name: tcp_findlistener
  *
  * Description:
- *   Return the connection listener for connections on this port (if any)
+ *   Return the connection listener for connections on this port (if any).
+ *   If several listeners share the port with SO_REUSEPORT, the remote
+ *   address in 'uaddr' and the remote port 'rport' select one of them.
  *
  * Assumptions:
  *   The network is locked
@@ -1051,11 +1168,11 @@ void tcp_stop_timer(FAR struct tcp_conn_s *conn);
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
 FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno,
+                                        uint16_t portno, uint16_t rport,
                                         uint8_t domain);
 #else
 FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno);
+                                        uint16_t portno, uint16_t rport);
 #endif
 
 /****************************************************************************
@@ -1184,6 +1301,28 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
 
 void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_ack_reply
+ *
+ * Description:
+ *   Acknowledge the received segment without a connection, the way a
+ *   connection in the TIME_WAIT state would.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure containing the received segment
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef NET_TCP_HAVE_TOMBSTONES
+void tcp_ack_reply(FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: tcp_rx_mss
  *
@@ -2189,7 +2328,8 @@ void tcp_sendbuffer_notify(FAR struct tcp_conn_s *conn);
  * Name: tcpip_hdrsize
  *
  * Description:
- *   Get the total size of L3 and L4 TCP header
+ *   Get the total size of L3 and L4 TCP header, with the options carried
+ *   by every segment of the connection
  *
  * Input Parameters:
  *   conn     The connection structure associated with the socket
@@ -2302,6 +2442,177 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_ssthresh
+ *
+ * Description:
+ *   Handle a congestion event, a loss detected by duplicate ACKs or by the
+ *   retransmission timer, and return the new slow start threshold.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   The slow start threshold to use
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_cc_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_setalgo
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name, as
+ *   done by the TCP_CONGESTION socket option.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm, "newreno" or "cubic"
+ *
+ * Returned Value:
+ *   OK, or -ENOENT if there is no such algorithm.
+ *
+ ****************************************************************************/
+
+int tcp_cc_setalgo(FAR struct tcp_conn_s *conn, FAR const char *name);
+
+/****************************************************************************
+ * Name: tcp_cc_getalgo
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of a connection.
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_getalgo(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_autotune_rcvbuf
+ *
+ * Description:
+ *   Account data read by the user.  Once per round trip, the receive
+ *   buffer is sized to twice what was read in it, so the advertised window
+ *   keeps ahead of the sender.  It only shrinks under memory pressure.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   copied - The number of bytes just read
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_AUTOTUNE) && CONFIG_NET_RECV_BUFSIZE > 0
+void tcp_autotune_rcvbuf(FAR struct tcp_conn_s *conn, size_t copied);
+#else
+#  define tcp_autotune_rcvbuf(c,n)
+#endif
+
+/****************************************************************************
+ * Name: tcp_autotune_sndbuf
+ *
+ * Description:
+ *   Size the send buffer to twice the data that may be in flight, the
+ *   smaller of the congestion and the send windows, when an ACK arrives.
+ *   It only shrinks under memory pressure.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_TCP_AUTOTUNE) && CONFIG_NET_SEND_BUFSIZE > 0
+void tcp_autotune_sndbuf(FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_autotune_sndbuf(c)
+#endif
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+struct tcp_zcsend_s;
+
+/****************************************************************************
+ * Name: tcp_zerocopy_begin
+ *
+ * Description:
+ *   Prepare a MSG_ZEROCOPY send of the user memory 'buf' of 'len' bytes.
+ *
+ * Returned Value:
+ *   The send state, NULL if it cannot be allocated: the data is then
+ *   copied.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_zcsend_s *tcp_zerocopy_begin(FAR struct tcp_conn_s *conn,
+                                            FAR const void *buf,
+                                            size_t len);
+
+/****************************************************************************
+ * Name: tcp_zerocopy_copyin
+ *
+ * Description:
+ *   Append 'len' bytes of the user memory at 'cp' to the empty write buffer
+ *   'wrb' by reference.
+ *
+ * Returned Value:
+ *   The number of bytes appended, -ENOMEM if none could be.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_zerocopy_copyin(FAR struct tcp_zcsend_s *zc,
+                        FAR struct tcp_wrbuffer_s *wrb,
+                        FAR const uint8_t *cp, size_t len);
+
+/****************************************************************************
+ * Name: tcp_zerocopy_end
+ *
+ * Description:
+ *   End a MSG_ZEROCOPY send that queued 'result' bytes.  If any were, the
+ *   send gets the next id, notified as complete once the write buffers
+ *   release the user memory.
+ *
+ ****************************************************************************/
+
+void tcp_zerocopy_end(FAR struct tcp_zcsend_s *zc, ssize_t result);
+
+/****************************************************************************
+ * Name: tcp_zerocopy_recverr
+ *
+ * Description:
+ *   Implement recvmsg(MSG_ERRQUEUE): report the range of the completed
+ *   MSG_ZEROCOPY sends in a IP_RECVERR or IPV6_RECVERR control message.
+ *
+ * Returned Value:
+ *   Zero on success, -EAGAIN if no send completed.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_zerocopy_recverr(FAR struct tcp_conn_s *conn,
+                             FAR struct msghdr *msg);
+
+#  define tcp_zerocopy_pending(c)  ((c)->zc_ready)
+#  define TCP_WBZEROCOPY(wrb)      ((wrb)->wb_zerocopy)
+#else
+#  define tcp_zerocopy_pending(c)  false
+#  define TCP_WBZEROCOPY(wrb)      false
 #endif
 
 #ifdef __cplusplus
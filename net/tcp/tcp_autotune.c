@@ -0,0 +1,212 @@
+/****************************************************************************
+ * net/tcp/tcp_autotune.c
+ * Auto-tuning of the TCP send and receive buffer sizes
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mm/iob.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest buffer the IOB pool can back, as in tcp_maxrcvwin() */
+
+#define TCP_AUTOTUNE_POOLSIZE \
+  ((CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE) * CONFIG_IOB_BUFSIZE)
+
+#if CONFIG_NET_MAX_RECV_BUFSIZE > 0
+#  define TCP_AUTOTUNE_RCVMAX \
+     MIN(CONFIG_NET_MAX_RECV_BUFSIZE, TCP_AUTOTUNE_POOLSIZE)
+#else
+#  define TCP_AUTOTUNE_RCVMAX TCP_AUTOTUNE_POOLSIZE
+#endif
+
+#if CONFIG_NET_MAX_SEND_BUFSIZE > 0
+#  define TCP_AUTOTUNE_SNDMAX \
+     MIN(CONFIG_NET_MAX_SEND_BUFSIZE, TCP_AUTOTUNE_POOLSIZE)
+#else
+#  define TCP_AUTOTUNE_SNDMAX TCP_AUTOTUNE_POOLSIZE
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_autotune_pressure
+ *
+ * Description:
+ *   Return true if the free share of the IOB pool is below the memory
+ *   pressure threshold.
+ *
+ ****************************************************************************/
+
+static bool tcp_autotune_pressure(void)
+{
+  return iob_navail(false) * 100 <
+         CONFIG_IOB_NBUFFERS * CONFIG_NET_TCP_AUTOTUNE_PRESSURE;
+}
+
+/****************************************************************************
+ * Name: tcp_autotune_resize
+ *
+ * Description:
+ *   Return the new size of a buffer for the desired size: grow while there
+ *   is no memory pressure, otherwise shrink but not below the initial size.
+ *
+ ****************************************************************************/
+
+static int32_t tcp_autotune_resize(int32_t size, uint32_t desire,
+                                   int32_t initial, int32_t maxsize)
+{
+  if (tcp_autotune_pressure())
+    {
+      if (desire < (uint32_t)size)
+        {
+          size = MAX((int32_t)desire, initial);
+        }
+    }
+  else if (desire > (uint32_t)size)
+    {
+      size = MIN(desire, (uint32_t)maxsize);
+    }
+
+  return size;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_autotune_rcvbuf
+ *
+ * Description:
+ *   Account data read by the user.  Once per round trip, the receive
+ *   buffer is sized to twice what was read in it, so the advertised window
+ *   keeps ahead of the sender.  It only shrinks under memory pressure.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   copied - The number of bytes just read
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_RECV_BUFSIZE > 0
+void tcp_autotune_rcvbuf(FAR struct tcp_conn_s *conn, size_t copied)
+{
+  clock_t interval;
+  clock_t now;
+  int32_t size;
+
+  if ((conn->flags & TCP_RCVBUF_LOCK) != 0)
+    {
+      return;
+    }
+
+  now = clock_systime_ticks();
+  conn->rcvq_copied += copied;
+
+  /* sa holds eight times the smoothed RTT in half-seconds */
+
+  interval = MAX(MSEC2TICK((conn->sa >> 3) * (MSEC_PER_SEC / 2)),
+                 MSEC2TICK(CONFIG_NET_TCP_AUTOTUNE_INTERVAL));
+  if (now - conn->rcvq_time < interval)
+    {
+      return;
+    }
+
+  size = tcp_autotune_resize(conn->rcv_bufs, 2 * conn->rcvq_copied,
+                             CONFIG_NET_RECV_BUFSIZE, TCP_AUTOTUNE_RCVMAX);
+  if (size != conn->rcv_bufs)
+    {
+      ninfo("TCP rcvbuf %" PRId32 " -> %" PRId32 "\n",
+            conn->rcv_bufs, size);
+      conn->rcv_bufs = size;
+    }
+
+  conn->rcvq_copied = 0;
+  conn->rcvq_time   = now;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_autotune_sndbuf
+ *
+ * Description:
+ *   Size the send buffer to twice the data that may be in flight, the
+ *   smaller of the congestion and the send windows, when an ACK arrives.
+ *   It only shrinks under memory pressure.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_SEND_BUFSIZE > 0
+void tcp_autotune_sndbuf(FAR struct tcp_conn_s *conn)
+{
+  uint32_t inflight = conn->snd_wnd;
+  int32_t size;
+
+  if ((conn->flags & TCP_SNDBUF_LOCK) != 0)
+    {
+      return;
+    }
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+  inflight = MIN(inflight, conn->cwnd);
+#endif
+
+  size = tcp_autotune_resize(conn->snd_bufs, 2 * inflight,
+                             CONFIG_NET_SEND_BUFSIZE, TCP_AUTOTUNE_SNDMAX);
+  if (size != conn->snd_bufs)
+    {
+      ninfo("TCP sndbuf %" PRId32 " -> %" PRId32 "\n",
+            conn->snd_bufs, size);
+      conn->snd_bufs = size;
+    }
+}
+#endif
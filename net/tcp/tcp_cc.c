@@ -24,6 +24,9 @@
  ****************************************************************************/
 
 #include <debug.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
 
 #include "tcp/tcp.h"
 
@@ -73,10 +76,246 @@
     } \
  } while(0)
 
+/* CUBIC constants (RFC9438): C = 0.4 and beta = 0.7.  The time in the
+ * cubic function is bounded so that its cube fits in 64 bits, the window
+ * has long reached its cap by then.
+ */
+
+#define CUBIC_MAX_T 300000   /* Maximum time in the cubic function (ms) */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A congestion control algorithm.  Slow start, fast retransmit and fast
+ * recovery are common to all, the algorithms differ in the window after a
+ * loss and in its growth in congestion avoidance.
+ */
+
+struct tcp_cc_ops_s
+{
+  FAR const char *name;
+
+  /* Return the slow start threshold after a loss */
+
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+
+  /* Grow cwnd in congestion avoidance, 'acked' bytes were acknowledged */
+
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static uint32_t tcp_newreno_ssthresh(FAR struct tcp_conn_s *conn);
+static void tcp_newreno_cong_avoid(FAR struct tcp_conn_s *conn,
+                                   uint32_t acked);
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+static uint32_t tcp_cubic_ssthresh(FAR struct tcp_conn_s *conn);
+static void tcp_cubic_cong_avoid(FAR struct tcp_conn_s *conn,
+                                 uint32_t acked);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Indexed by TCP_CC_* */
+
+static const struct tcp_cc_ops_s g_tcp_cc[] =
+{
+  {
+    "newreno", tcp_newreno_ssthresh, tcp_newreno_cong_avoid
+  },
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  {
+    "cubic", tcp_cubic_ssthresh, tcp_cubic_cong_avoid
+  },
+#endif
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_newreno_ssthresh
+ *
+ * Description:
+ *   ssthresh = max (FlightSize / 2, 2*SMSS), referring to rfc5681.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->tx_unacked / 2, 2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: tcp_newreno_cong_avoid
+ *
+ * Description:
+ *   cong avoid (RFC 5681):
+ *   Grow cwnd linearly by approximately maxseg per RTT using
+ *   maxseg^2 / cwnd per ACK as the increment.
+ *   If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
+ *   avoid capping cwnd.
+ *
+ ****************************************************************************/
+
+static void tcp_newreno_cong_avoid(FAR struct tcp_conn_s *conn,
+                                   uint32_t acked)
+{
+  uint32_t increase;
+
+  increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+
+  CC_CWND_INC(conn->cwnd, increase);
+  conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+  ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+}
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/****************************************************************************
+ * Name: tcp_cubic_cbrt
+ *
+ * Description:
+ *   Integer cube root, rounded down.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_cbrt(uint64_t x)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      b = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_ssthresh
+ *
+ * Description:
+ *   Remember the window at the loss as W_max, lowered with fast convergence
+ *   if it is below the previous one, and reduce by beta.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  if (conn->cwnd < conn->cubic_wmax)
+    {
+      conn->cubic_wmax = (uint32_t)((uint64_t)conn->cwnd * 17 / 20);
+    }
+  else
+    {
+      conn->cubic_wmax = conn->cwnd;
+    }
+
+  conn->cubic_epoch = 0;
+  return MAX((uint32_t)((uint64_t)conn->tx_unacked * 7 / 10),
+             2 * conn->mss);
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_cong_avoid
+ *
+ * Description:
+ *   Grow cwnd towards W(t) = C * (t - K)^3 + W_max, t being the time since
+ *   the start of the growth and K the time W(t) takes to get back to W_max,
+ *   or towards the window NewReno would have if that is larger.
+ *
+ ****************************************************************************/
+
+static void tcp_cubic_cong_avoid(FAR struct tcp_conn_s *conn,
+                                 uint32_t acked)
+{
+  clock_t now = clock_systime_ticks();
+  uint32_t increase;
+  uint32_t target;
+  uint64_t offset;
+  int64_t t;
+
+  if (conn->cubic_epoch == 0)
+    {
+      /* K = cbrt((W_max - cwnd) / C), in segments and ms */
+
+      conn->cubic_epoch = MAX(now, 1);
+      conn->cubic_west  = conn->cwnd;
+      if (conn->cwnd < conn->cubic_wmax)
+        {
+          conn->cubic_k =
+            tcp_cubic_cbrt((uint64_t)(conn->cubic_wmax - conn->cwnd) *
+                           2500000000ull / conn->mss);
+        }
+      else
+        {
+          conn->cubic_k    = 0;
+          conn->cubic_wmax = conn->cwnd;
+        }
+    }
+
+  t = (int64_t)TICK2MSEC(now - conn->cubic_epoch) - conn->cubic_k;
+  t = MIN(MAX(t, -CUBIC_MAX_T), CUBIC_MAX_T);
+
+  /* C * |t - K|^3 segments, t in ms */
+
+  offset = (uint64_t)(t < 0 ? -t : t);
+  offset = offset * offset * offset / 1000000 * 4 * conn->mss / 10000;
+  if (t < 0)
+    {
+      target = offset < conn->cubic_wmax ?
+               conn->cubic_wmax - (uint32_t)offset : 0;
+    }
+  else
+    {
+      target = (uint32_t)MIN(conn->cubic_wmax + offset, UINT32_MAX);
+    }
+
+  /* NewReno with the CUBIC reduction grows by
+   * 3 * (1 - beta) / (1 + beta) = 9 / 17 segments per RTT.
+   */
+
+  conn->cubic_west += (uint32_t)((uint64_t)conn->mss * 9 * acked /
+                                 (17 * (uint64_t)conn->cwnd));
+  target = MAX(target, conn->cubic_west);
+  target = MIN(target, conn->cwnd + conn->cwnd / 2);
+
+  /* Close (target - cwnd) / cwnd per acknowledged segment, or probe very
+   * slowly on the plateau around W_max.
+   */
+
+  if (target > conn->cwnd)
+    {
+      increase = (uint32_t)((uint64_t)(target - conn->cwnd) * acked /
+                            conn->cwnd);
+    }
+  else
+    {
+      increase = (uint32_t)((uint64_t)conn->mss * acked /
+                            (100 * (uint64_t)conn->cwnd));
+    }
+
+  CC_CWND_INC(conn->cwnd, MAX(increase, 1));
+  conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+  ninfo("update cubic cwnd to %u\n", conn->cwnd);
+}
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -116,6 +355,11 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
   conn->ssthresh = 2 * TCP_IPV4_DEFAULT_MSS;
   conn->dupacks = 0;
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  conn->cubic_wmax  = 0;
+  conn->cubic_epoch = 0;
+#endif
 }
 
 /****************************************************************************
@@ -147,7 +391,7 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+      conn->ssthresh = tcp_cc_ssthresh(conn);
       conn->cwnd = conn->ssthresh + 3 * conn->mss;
 
       conn->flags &= ~TCP_INFT;
@@ -283,19 +527,84 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
             }
           else
             {
-              /* cong avoid (RFC 5681):
-               * Grow cwnd linearly by approximately maxseg per RTT using
-               * maxseg^2 / cwnd per ACK as the increment.
-               * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
-               * avoid capping cwnd.
-               */
+              g_tcp_cc[conn->cc_algo].cong_avoid(conn, acked);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_cc_ssthresh
+ *
+ * Description:
+ *   Handle a congestion event, a loss detected by duplicate ACKs or by the
+ *   retransmission timer, and return the new slow start threshold.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   The slow start threshold to use
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
 
-              increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+uint32_t tcp_cc_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return g_tcp_cc[conn->cc_algo].ssthresh(conn);
+}
 
-              CC_CWND_INC(conn->cwnd, increase);
-              conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
-              ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
-            }
+/****************************************************************************
+ * Name: tcp_cc_setalgo
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name, as
+ *   done by the TCP_CONGESTION socket option.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - The name of the algorithm, "newreno" or "cubic"
+ *
+ * Returned Value:
+ *   OK, or -ENOENT if there is no such algorithm.
+ *
+ ****************************************************************************/
+
+int tcp_cc_setalgo(FAR struct tcp_conn_s *conn, FAR const char *name)
+{
+  int i;
+
+  for (i = 0; i < nitems(g_tcp_cc); i++)
+    {
+      if (strcmp(g_tcp_cc[i].name, name) == 0)
+        {
+          /* A new algorithm starts its growth from the current window */
+
+          net_lock();
+          conn->cc_algo = i;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+          conn->cubic_wmax  = 0;
+          conn->cubic_epoch = 0;
+#endif
+          net_unlock();
+          return OK;
         }
     }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_getalgo
+ *
+ * Description:
+ *   Return the name of the congestion control algorithm of a connection.
+ *
+ ****************************************************************************/
+
+FAR const char *tcp_cc_getalgo(FAR struct tcp_conn_s *conn)
+{
+  return g_tcp_cc[conn->cc_algo].name;
 }
@@ -56,6 +56,7 @@
 #include <arch/irq.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -70,6 +71,23 @@
 #include "icmpv6/icmpv6.h"
 #include "nat/nat.h"
 #include "netdev/netdev.h"
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Keep the connection hash table in step with the active list */
+
+#if CONFIG_NET_TCP_HASH_SIZE > 0
+#  define tcp_hash_add(conn) \
+     sq_addlast(&(conn)->hnode, tcp_hash_bucket(conn))
+#  define tcp_hash_rem(conn) \
+     sq_rem(&(conn)->hnode, tcp_hash_bucket(conn))
+#else
+#  define tcp_hash_add(conn)
+#  define tcp_hash_rem(conn)
+#endif
 
 /****************************************************************************
  * Private Data
@@ -89,10 +107,96 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+/* The connected TCP connections again, hashed by their ports and remote
+ * address, so that an incoming segment is only compared against the few
+ * connections in its bucket.
+ */
+
+#if CONFIG_NET_TCP_HASH_SIZE > 0
+static sq_queue_t g_tcp_hash[CONFIG_NET_TCP_HASH_SIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_hash
+ *
+ * Description:
+ *   Return the hash bucket of the local and remote port pair (network byte
+ *   order) and the remote address, given as 'nwords' 16-bit words.  The
+ *   local address is not hashed, it may be the wildcard address.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_TCP_HASH_SIZE > 0
+static FAR sq_queue_t *tcp_hash(uint16_t lport, uint16_t rport,
+                                FAR const uint16_t *raddr, int nwords)
+{
+  uint32_t hash = ((uint32_t)rport << 16) | lport;
+  int i;
+
+  for (i = 0; i < nwords; i++)
+    {
+      hash = hash * 31 + raddr[i];
+    }
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  return &g_tcp_hash[hash % CONFIG_NET_TCP_HASH_SIZE];
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_hash_bucket
+ *
+ * Description:
+ *   Return the hash bucket of a connection.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_TCP_HASH_SIZE > 0
+static FAR sq_queue_t *tcp_hash_bucket(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_hash(conn->lport, conn->rport,
+                      (FAR const uint16_t *)&conn->u.ipv4.raddr, 2);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_hash(conn->lport, conn->rport, conn->u.ipv6.raddr, 8);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_hash_next
+ *
+ * Description:
+ *   Return the connection that follows 'node' in its hash bucket.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_TCP_HASH_SIZE > 0
+static inline FAR struct tcp_conn_s *tcp_hash_next(FAR sq_entry_t *node)
+{
+  return node != NULL ? container_of(node, struct tcp_conn_s, hnode) : NULL;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -166,6 +270,78 @@ static FAR struct tcp_conn_s *
   return NULL;
 }
 
+/****************************************************************************
+ * Name: tcp_reuseport_bind
+ *
+ * Description:
+ *   Return true if 'conn' may bind the local port 'portno' (network byte
+ *   order) although it is in use: 'conn' and all the connections that use
+ *   the port on this address set SO_REUSEPORT and are bound to the very
+ *   same address.  Connections accepted by their listeners inherit the
+ *   option.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static bool tcp_reuseport_bind(FAR struct tcp_conn_s *conn, uint8_t domain,
+                               FAR const union ip_addr_u *ipaddr,
+                               uint16_t portno)
+{
+  FAR struct tcp_conn_s *other = NULL;
+
+  if (portno == 0 || !_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return false;
+    }
+
+  while ((other = tcp_nextconn(other)) != NULL)
+    {
+      if (other == conn || other->tcpstateflags == TCP_CLOSED ||
+          other->lport != portno
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+          || domain != other->domain
+#endif
+         )
+        {
+          continue;
+        }
+
+      if (!_SO_GETOPT(other->sconn.s_options, SO_REUSEPORT))
+        {
+          return false;
+        }
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      if (domain == PF_INET)
+#endif /* CONFIG_NET_IPv6 */
+        {
+          if (!net_ipv4addr_cmp(other->u.ipv4.laddr, ipaddr->ipv4))
+            {
+              return false;
+            }
+        }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      else
+#endif /* CONFIG_NET_IPv4 */
+        {
+          if (!net_ipv6addr_cmp(other->u.ipv6.laddr, ipaddr->ipv6))
+            {
+              return false;
+            }
+        }
+#endif /* CONFIG_NET_IPv6 */
+    }
+
+  return true;
+}
+#else
+#  define tcp_reuseport_bind(c, d, a, p) false
+#endif
+
 /****************************************************************************
  * Name: tcp_ipv4_active
  *
@@ -187,7 +363,12 @@ static inline FAR struct tcp_conn_s *
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
+#if CONFIG_NET_TCP_HASH_SIZE > 0
+  conn       = tcp_hash_next(sq_peek(tcp_hash(tcp->destport, tcp->srcport,
+                                              ip->srcipaddr, 2)));
+#else
   conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 
@@ -226,7 +407,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#if CONFIG_NET_TCP_HASH_SIZE > 0
+      conn = tcp_hash_next(conn->hnode.flink);
+#else
       conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
   return conn;
@@ -254,7 +439,12 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
+#if CONFIG_NET_TCP_HASH_SIZE > 0
+  conn       = tcp_hash_next(sq_peek(tcp_hash(tcp->destport, tcp->srcport,
+                                              ip->srcipaddr, 8)));
+#else
   conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 
@@ -293,7 +483,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#if CONFIG_NET_TCP_HASH_SIZE > 0
+      conn = tcp_hash_next(conn->hnode.flink);
+#else
       conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
   return conn;
@@ -358,9 +552,19 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   /* Verify or select a local port (network byte order) */
 
-  port = tcp_selectport(PF_INET,
-                       (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
-                       addr->sin_port);
+  if (tcp_reuseport_bind(conn, PF_INET,
+                         (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
+                         addr->sin_port))
+    {
+      port = addr->sin_port;
+    }
+  else
+    {
+      port = tcp_selectport(PF_INET,
+                            (FAR const union ip_addr_u *)
+                            &addr->sin_addr.s_addr, addr->sin_port);
+    }
+
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -457,11 +661,23 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   /* Verify or select a local port (network byte order) */
 
-  /* The port number must be unique for this address binding */
+  /* The port number must be unique for this address binding, unless the
+   * sockets share it with SO_REUSEPORT.
+   */
 
-  port = tcp_selectport(PF_INET6,
+  if (tcp_reuseport_bind(conn, PF_INET6,
+                (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
+                addr->sin6_port))
+    {
+      port = addr->sin6_port;
+    }
+  else
+    {
+      port = tcp_selectport(PF_INET6,
                 (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
                 addr->sin6_port);
+    }
+
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -812,6 +1028,9 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
       conn->keepintvl     = 2 * DSEC_PER_SEC;
       conn->keepcnt       = 3;
 #endif
+#ifdef CONFIG_NET_TCP_CC_DEFAULT_CUBIC
+      conn->cc_algo       = TCP_CC_CUBIC;
+#endif
 #if CONFIG_NET_RECV_BUFSIZE > 0
       conn->rcv_bufs      = CONFIG_NET_RECV_BUFSIZE;
 #endif
@@ -916,10 +1135,23 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       return;
     }
 
+#ifdef NET_TCP_HAVE_TOMBSTONES
+  /* The rest of TIME_WAIT only needs the addresses and ports */
+
+  if (conn->tcpstateflags == TCP_TIME_WAIT)
+    {
+      tcp_timewait_add(conn);
+    }
+#endif
+
   /* Cancel tcp timer */
 
   tcp_stop_timer(conn);
 
+  /* Nothing is to be sent for the connection any longer */
+
+  devif_unpend(&conn->sconn);
+
   /* Free remaining callbacks, actually there should be only the send
    * callback for CONFIG_NET_TCP_WRITE_BUFFERS is left.
    */
@@ -939,6 +1171,7 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_hash_rem(conn);
     }
 
   tcp_free_rx_buffers(conn);
@@ -1197,6 +1430,14 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       conn->snd_bufs         = listener->snd_bufs;
 #endif
       conn->mss              = listener->mss;
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      conn->cc_algo          = listener->cc_algo;
+#endif
+      conn->flags           |= listener->flags &
+                               (TCP_RCVBUF_LOCK | TCP_SNDBUF_LOCK);
+#ifdef CONFIG_NET_SOCKOPTS
+      conn->sconn.s_options |= listener->sconn.s_options & _SO_REUSEPORT;
+#endif
 
       /* Fill in the necessary fields for the new connection. */
 
@@ -1248,6 +1489,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_hash_add(conn);
       tcp_update_retrantimer(conn, TCP_RTO);
     }
 
@@ -1556,6 +1798,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_hash_add(conn);
   ret = OK;
 
 errout_with_lock:
@@ -206,7 +206,10 @@ static bool tcp_snd_wnd_update(FAR struct tcp_conn_s *conn,
   uint32_t seq = tcp_getsequence(tcp->seqno);
   uint16_t unscaled_wnd = ((uint16_t)tcp->wnd[0] << 8) + tcp->wnd[1];
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
-  uint32_t wnd = (uint32_t)unscaled_wnd << conn->snd_scale;
+  /* The window of a SYN segment is never scaled (RFC7323) */
+
+  uint32_t wnd = (tcp->flags & TCP_SYN) != 0 ? unscaled_wnd :
+                 (uint32_t)unscaled_wnd << conn->snd_scale;
 #else
   uint16_t wnd = unscaled_wnd;
 #endif
@@ -426,7 +429,7 @@ static void tcp_input_ofosegs(FAR struct net_driver_s *dev,
 {
   struct tcp_ofoseg_s ofoseg;
   bool rebuild;
-  int i = 0;
+  int i;
   int len;
 
   ofoseg.left =
@@ -437,7 +440,7 @@ static void tcp_input_ofosegs(FAR struct net_driver_s *dev,
    */
 
   if (tcp_ofoseg_bufsize(conn) > CONFIG_NET_TCP_OUT_OF_ORDER_BUFSIZE &&
-      ofoseg.left >= conn->ofosegs[0].left)
+      TCP_SEQ_GTE(ofoseg.left, conn->ofosegs[0].left))
     {
       return;
     }
@@ -470,20 +473,43 @@ static void tcp_input_ofosegs(FAR struct net_driver_s *dev,
 
   /* Incoming segment out of order from existing pool, add to new segment */
 
-  if (!rebuild && conn->nofosegs != TCP_SACK_RANGES_MAX)
+  if (!rebuild)
     {
-      conn->ofosegs[conn->nofosegs] = ofoseg;
-      conn->nofosegs++;
-      rebuild = true;
-    }
+      /* If the pool is full, the highest range is the furthest from the
+       * receive point, give it up for a lower segment.
+       */
 
-  /* Try Re-order ofosegs */
+      if (conn->nofosegs == TCP_OFOSEGS_MAX &&
+          TCP_SEQ_LT(ofoseg.left, conn->ofosegs[conn->nofosegs - 1].left))
+        {
+          conn->nofosegs--;
+          iob_free_chain(conn->ofosegs[conn->nofosegs].data);
+        }
 
-  if (rebuild &&
-      tcp_reorder_ofosegs(conn->nofosegs, (FAR void *)conn->ofosegs))
+      if (conn->nofosegs < TCP_OFOSEGS_MAX)
+        {
+          /* Insert in place to keep the pool sorted by left edge */
+
+          for (i = conn->nofosegs;
+               i > 0 && TCP_SEQ_LT(ofoseg.left, conn->ofosegs[i - 1].left);
+               i--)
+            {
+              conn->ofosegs[i] = conn->ofosegs[i - 1];
+            }
+
+          conn->ofosegs[i] = ofoseg;
+          conn->nofosegs++;
+          rebuild = true;
+        }
+    }
+
+  if (rebuild)
     {
-      /* Re-build out-of-order pool after re-order */
+      conn->ofoseg_recent = ofoseg.left;
 
+      /* A merged range may now reach its neighbours, coalesce them */
+
+      i = 0;
       while (i < conn->nofosegs - 1)
         {
           if (tcp_rebuild_ofosegs(conn, &conn->ofosegs[i], i + 1))
@@ -502,6 +528,17 @@ static void tcp_input_ofosegs(FAR struct net_driver_s *dev,
               i++;
             }
         }
+
+      /* Bound the memory held by the pool, the lowest range is kept as it
+       * is the one that fills the gap first.
+       */
+
+      while (conn->nofosegs > 1 &&
+             tcp_ofoseg_bufsize(conn) > CONFIG_NET_TCP_OUT_OF_ORDER_BUFSIZE)
+        {
+          conn->nofosegs--;
+          iob_free_chain(conn->ofosegs[conn->nofosegs].data);
+        }
     }
 
   for (i = 0; i < conn->nofosegs; i++)
@@ -612,6 +649,14 @@ static void tcp_parse_option(FAR struct net_driver_s *dev,
         {
           conn->flags    |= TCP_SACK;
         }
+#endif
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+      else if (opt == TCP_OPT_TS &&
+               IPDATA(tcpiplen + 1 + i) == TCP_OPT_TS_LEN)
+        {
+          conn->ts_recent = tcp_getsequence(&IPDATA(tcpiplen + 2 + i));
+          conn->flags    |= TCP_TSTAMP;
+        }
 #endif
       else
         {
@@ -631,8 +676,68 @@ static void tcp_parse_option(FAR struct net_driver_s *dev,
 
       i += IPDATA(tcpiplen + 1 + i);
     }
+
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+  /* The MSS excludes the options, the timestamps take from the payload */
+
+  if ((conn->flags & TCP_TSTAMP) != 0)
+    {
+      conn->mss -= TCP_OPT_TS_ALIGNED_LEN;
+    }
+#endif
 }
 
+/****************************************************************************
+ * Name: tcp_get_timestamp
+ *
+ * Description:
+ *   Find the timestamps option of an incoming segment
+ *
+ * Input Parameters:
+ *   tcp    - The TCP header
+ *   tsval  - Location to return the timestamp of the peer
+ *   tsecr  - Location to return our timestamp echoed by the peer
+ *
+ * Returned Value:
+ *   True if the segment has the option
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+static bool tcp_get_timestamp(FAR struct tcp_hdr_s *tcp,
+                              FAR uint32_t *tsval, FAR uint32_t *tsecr)
+{
+  int optlen = ((tcp->tcpoffset >> 4) - 5) << 2;
+  int i = 0;
+
+  while (i < optlen && tcp->optdata[i] != TCP_OPT_END)
+    {
+      if (tcp->optdata[i] == TCP_OPT_NOOP)
+        {
+          i++;
+        }
+      else if (i + 1 >= optlen || tcp->optdata[i + 1] < 2)
+        {
+          break;
+        }
+      else if (tcp->optdata[i] == TCP_OPT_TS &&
+               tcp->optdata[i + 1] == TCP_OPT_TS_LEN &&
+               i + TCP_OPT_TS_LEN <= optlen)
+        {
+          *tsval = tcp_getsequence(&tcp->optdata[i + 2]);
+          *tsecr = tcp_getsequence(&tcp->optdata[i + 6]);
+          return true;
+        }
+      else
+        {
+          i += tcp->optdata[i + 1];
+        }
+    }
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_clear_zero_probe
  *
@@ -692,11 +797,14 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   FAR struct tcp_conn_s *conn = NULL;
   FAR struct tcp_hdr_s *tcp;
   union ip_binding_u uaddr;
-  unsigned int tcpiplen;
   uint16_t tmp16;
   uint16_t flags;
   uint16_t result;
   int      len;
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+  uint32_t tsval;
+  uint32_t tsecr = 0;
+#endif
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -710,21 +818,12 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
   tcp = IPBUF(iplen);
 
-  /* Get the size of the IP header and the TCP header.
-   *
-   * REVISIT:  TCP header is *not* a constant!  It can be larger if the
-   * TCP header includes options.  The constant TCP_HDRLEN should be
-   * replaced with the macro TCP_OPT_HDRLEN(n) which will calculate the
-   * correct header length in all cases.
-   */
-
-  tcpiplen = iplen + TCP_HDRLEN;
-
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_RXCSUM) &&
+      tcp_chksum(dev) != 0xffff)
     {
-      /* Compute and check the TCP checksum. */
+      /* Compute and check the TCP checksum, unless the device did. */
 
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.tcp.drop++;
@@ -776,6 +875,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #  endif
         {
           net_ipv6addr_copy(&uaddr.ipv6.laddr, IPv6BUF->destipaddr);
+          net_ipv6addr_copy(&uaddr.ipv6.raddr, IPv6BUF->srcipaddr);
         }
 #endif
 
@@ -786,13 +886,16 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
         {
           net_ipv4addr_copy(uaddr.ipv4.laddr,
                             net_ip4addr_conv32(IPv4BUF->destipaddr));
+          net_ipv4addr_copy(uaddr.ipv4.raddr,
+                            net_ip4addr_conv32(IPv4BUF->srcipaddr));
         }
 #endif
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if ((conn = tcp_findlistener(&uaddr, tmp16, domain)) != NULL)
+      if ((conn = tcp_findlistener(&uaddr, tmp16, tcp->srcport,
+                                   domain)) != NULL)
 #else
-      if ((conn = tcp_findlistener(&uaddr, tmp16)) != NULL)
+      if ((conn = tcp_findlistener(&uaddr, tmp16, tcp->srcport)) != NULL)
 #endif
         {
           if (!tcp_backlogavailable(conn))
@@ -872,6 +975,15 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 
 reset:
 
+#ifdef NET_TCP_HAVE_TOMBSTONES
+  /* The segment may belong to a connection freed in TIME_WAIT */
+
+  if (conn == NULL && tcp_timewait_input(dev, tcp))
+    {
+      return;
+    }
+#endif
+
   /* We do not send resets in response to resets. */
 
   if ((tcp->flags & TCP_RST) != 0)
@@ -888,6 +1000,10 @@ reset:
 found:
   flags = 0;
 
+  /* An acknowledgement may open the window for data waiting to be sent */
+
+  devif_pend(&dev->d_tcppend, &conn->sconn);
+
   /* We do a very naive form of TCP reset processing; we just accept
    * any RST and kill our connection. We should in fact check if the
    * sequence number of this reset is within our advertised window
@@ -915,6 +1031,7 @@ found:
 #  endif
             {
               net_ipv6addr_copy(&uaddr.ipv6.laddr, IPv6BUF->destipaddr);
+              net_ipv6addr_copy(&uaddr.ipv6.raddr, IPv6BUF->srcipaddr);
             }
 #endif
 
@@ -925,13 +1042,16 @@ found:
             {
               net_ipv4addr_copy(uaddr.ipv4.laddr,
                                 net_ip4addr_conv32(IPv4BUF->destipaddr));
+              net_ipv4addr_copy(uaddr.ipv4.raddr,
+                                net_ip4addr_conv32(IPv4BUF->srcipaddr));
             }
 #endif
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-          listener = tcp_findlistener(&uaddr, conn->lport, domain);
+          listener = tcp_findlistener(&uaddr, conn->lport, conn->rport,
+                                      domain);
 #else
-          listener = tcp_findlistener(&uaddr, conn->lport);
+          listener = tcp_findlistener(&uaddr, conn->lport, conn->rport);
 #endif
 
           /* We must free this TCP connection structure; this connection
@@ -963,6 +1083,35 @@ found:
       goto drop;
     }
 
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+  /* PAWS (RFC7323): a segment with a timestamp older than the latest one is
+   * an old duplicate, possibly from an earlier wrap of the sequence numbers.
+   * It is dropped and ACKed.
+   */
+
+  if ((conn->flags & TCP_TSTAMP) != 0 &&
+      (tcp->flags & TCP_SYN) == 0 &&
+      tcp_get_timestamp(tcp, &tsval, &tsecr))
+    {
+      if (TCP_SEQ_LT(tsval, conn->ts_recent))
+        {
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.tcp.paws++;
+#endif
+          tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
+          return;
+        }
+
+      /* Echo the timestamp of the segment that ACKs will acknowledge */
+
+      if (TCP_SEQ_LTE(tcp_getsequence(tcp->seqno),
+                      tcp_getsequence(conn->rcvseq)))
+        {
+          conn->ts_recent = tsval;
+        }
+    }
+#endif
+
   /* Calculated the length of the data, if the application has sent
    * any data to us.
    */
@@ -1110,12 +1259,28 @@ found:
         }
 #endif
 
-      /* Do RTT estimation, unless we have done retransmissions. */
+      /* Do RTT estimation, unless we have done retransmissions.  The echo
+       * of our timestamp measures it in all cases.
+       */
 
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+      if (tsecr != 0 || conn->nrtx == 0)
+#else
       if (conn->nrtx == 0)
+#endif
         {
           signed char m;
-          m = conn->rto - conn->timer;
+
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+          if (tsecr != 0)
+            {
+              m = MIN((TCP_TSVAL() - tsecr) / (MSEC_PER_SEC / 2), INT8_MAX);
+            }
+          else
+#endif
+            {
+              m = conn->rto - conn->timer;
+            }
 
           /* This is taken directly from VJs original code in his paper */
 
@@ -1172,7 +1337,7 @@ found:
                    * E.g. a keep-alive segment.
                    */
 
-                  tcp_send(dev, conn, TCP_ACK, tcpiplen);
+                  tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
                   return;
                 }
             }
@@ -1183,7 +1348,7 @@ found:
 
               tcp_input_ofosegs(dev, conn, iplen);
 #endif
-              tcp_send(dev, conn, TCP_ACK, tcpiplen);
+              tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
               return;
             }
         }
@@ -1413,7 +1578,7 @@ found:
                 conn->sndseq_max    = tcp_getsequence(conn->sndseq) + 1;
 #endif
                 ninfo("TCP state: TCP_LAST_ACK\n");
-                tcp_send(dev, conn, TCP_FIN | TCP_ACK, tcpiplen);
+                tcp_send(dev, conn, TCP_FIN | TCP_ACK, tcpip_hdrsize(conn));
               }
             else
               {
@@ -1594,7 +1759,7 @@ found:
 
             net_incr32(conn->rcvseq, 1); /* ack FIN */
             tcp_callback(dev, conn, TCP_CLOSE);
-            tcp_send(dev, conn, TCP_ACK, tcpiplen);
+            tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
             return;
           }
         else if ((flags & TCP_ACKDATA) != 0 && conn->tx_unacked == 0)
@@ -1635,7 +1800,7 @@ found:
 
             net_incr32(conn->rcvseq, 1); /* ack FIN */
             tcp_callback(dev, conn, TCP_CLOSE);
-            tcp_send(dev, conn, TCP_ACK, tcpiplen);
+            tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
             return;
           }
 
@@ -1654,7 +1819,7 @@ found:
         goto drop;
 
       case TCP_TIME_WAIT:
-        tcp_send(dev, conn, TCP_ACK, tcpiplen);
+        tcp_send(dev, conn, TCP_ACK, tcpip_hdrsize(conn));
         return;
 
       case TCP_CLOSING:
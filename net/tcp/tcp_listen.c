@@ -53,8 +53,23 @@
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "socket/socket.h"
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The IP domain of a connection */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define tcp_conn_domain(c) ((c)->domain)
+#elif defined(CONFIG_NET_IPv4)
+#  define tcp_conn_domain(c) PF_INET
+#else
+#  define tcp_conn_domain(c) PF_INET6
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -67,11 +82,195 @@ static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_listener_match
+ *
+ * Description:
+ *   Return true if the listener 'conn' accepts connections to the local
+ *   address in 'uaddr' and the local port 'portno'.  With 'exact', the
+ *   listener must be bound to that very address, not to the wildcard one.
+ *
+ ****************************************************************************/
+
+static bool tcp_listener_match(FAR struct tcp_conn_s *conn,
+                               FAR union ip_binding_u *uaddr,
+                               uint16_t portno, uint8_t domain, bool exact)
+{
+  /* Is this slot assigned?  If so, does the connection have the same
+   * local port number?
+   */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  if (conn == NULL || conn->lport != portno || conn->domain != domain)
+#else
+  if (conn == NULL || conn->lport != portno)
+#endif
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (domain == PF_INET6)
+#  endif
+    {
+      return net_ipv6addr_cmp(conn->u.ipv6.laddr, uaddr->ipv6.laddr) ||
+             (!exact &&
+              net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr));
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      return net_ipv4addr_cmp(conn->u.ipv4.laddr, uaddr->ipv4.laddr) ||
+             (!exact && net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY));
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_reuseport_select
+ *
+ * Description:
+ *   'conn' is the first listener that accepts a connection.  If it is a
+ *   member of a SO_REUSEPORT group, the listeners bound to the same local
+ *   address and port, select the member that accepts the connection by the
+ *   hash of the remote address in 'uaddr' and the remote port 'rport'.  All
+ *   the segments of a handshake then select the same listener.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static FAR struct tcp_conn_s *
+  tcp_reuseport_select(FAR struct tcp_conn_s *conn,
+                       FAR union ip_binding_u *uaddr, uint16_t rport)
+{
+  FAR const uint16_t *raddr;
+  uint32_t hash = rport;
+  uint32_t nmembers = 0;
+  uint32_t index = 0;
+  int nwords;
+  int ndx;
+
+  if (!_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return conn;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#  endif
+    {
+      raddr  = uaddr->ipv6.raddr;
+      nwords = 8;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      raddr  = (FAR const uint16_t *)&uaddr->ipv4.raddr;
+      nwords = 2;
+    }
+#endif
+
+  for (ndx = 0; ndx < nwords; ndx++)
+    {
+      hash = hash * 31 + raddr[ndx];
+    }
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  /* Count the members, then pick the one the hash falls on */
+
+  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      FAR struct tcp_conn_s *member = tcp_listenports[ndx];
+
+      if (tcp_listener_match(member, &conn->u, conn->lport,
+                             tcp_conn_domain(conn), true) &&
+          _SO_GETOPT(member->sconn.s_options, SO_REUSEPORT))
+        {
+          nmembers++;
+        }
+    }
+
+  hash %= nmembers;
+
+  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      FAR struct tcp_conn_s *member = tcp_listenports[ndx];
+
+      if (tcp_listener_match(member, &conn->u, conn->lport,
+                             tcp_conn_domain(conn), true) &&
+          _SO_GETOPT(member->sconn.s_options, SO_REUSEPORT) &&
+          index++ == hash)
+        {
+          return member;
+        }
+    }
+
+  return conn;
+}
+#else
+#  define tcp_reuseport_select(c, u, p) (c)
+#endif
+
+/****************************************************************************
+ * Name: tcp_listen_conflict
+ *
+ * Description:
+ *   Return true if another socket already listens on the local address and
+ *   port of 'conn'.  Sockets that all set SO_REUSEPORT before they bound
+ *   the same address and port may listen together.
+ *
+ ****************************************************************************/
+
+static bool tcp_listen_conflict(FAR struct tcp_conn_s *conn)
+{
+  int ndx;
+
+  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      FAR struct tcp_conn_s *listener = tcp_listenports[ndx];
+
+      if (!tcp_listener_match(listener, &conn->u, conn->lport,
+                              tcp_conn_domain(conn), false))
+        {
+          continue;
+        }
+
+#ifdef CONFIG_NET_SOCKOPTS
+      if (_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT) &&
+          _SO_GETOPT(listener->sconn.s_options, SO_REUSEPORT) &&
+          tcp_listener_match(listener, &conn->u, conn->lport,
+                             tcp_conn_domain(conn), true))
+        {
+          continue;
+        }
+#endif
+
+      return true;
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: tcp_findlistener
  *
  * Description:
- *   Return the connection listener for connections on this port (if any)
+ *   Return the connection listener for connections on this port (if any).
+ *   If several listeners share the port with SO_REUSEPORT, the remote
+ *   address in 'uaddr' and the remote port 'rport' select one of them.
  *
  * Assumptions:
  *   This function is called from network logic with the network locked.
@@ -80,59 +279,32 @@ static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
 FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno,
+                                        uint16_t portno, uint16_t rport,
                                         uint8_t domain)
 #else
 FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno)
+                                        uint16_t portno, uint16_t rport)
 #endif
 {
   int ndx;
 
+#if !defined(CONFIG_NET_IPv4)
+  uint8_t domain = PF_INET6;
+#elif !defined(CONFIG_NET_IPv6)
+  uint8_t domain = PF_INET;
+#endif
+
   /* Examine each connection structure in each slot of the listener list */
 
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
     {
-      /* Is this slot assigned?  If so, does the connection have the same
-       * local port number?
-       */
-
       FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if (conn && conn->lport == portno && conn->domain == domain)
-#else
-      if (conn && conn->lport == portno)
-#endif
-        {
-#ifdef CONFIG_NET_IPv6
-#  ifdef CONFIG_NET_IPv4
-          if (domain == PF_INET6)
-#  endif
-            {
-              if (net_ipv6addr_cmp(conn->u.ipv6.laddr, uaddr->ipv6.laddr) ||
-                  net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr))
-                {
-                  /* Yes.. we found a listener on this port */
 
-                  return conn;
-                }
-            }
-#endif
-
-#ifdef CONFIG_NET_IPv4
-#  ifdef CONFIG_NET_IPv6
-          if (domain == PF_INET)
-#  endif
-            {
-              if (net_ipv4addr_cmp(conn->u.ipv4.laddr, uaddr->ipv4.laddr) ||
-                  net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY))
-                {
-                  /* Yes.. we found a listener on this port */
+      if (tcp_listener_match(conn, uaddr, portno, domain, false))
+        {
+          /* Yes.. we found a listener on this port */
 
-                  return conn;
-                }
-            }
-#endif
+          return tcp_reuseport_select(conn, uaddr, rport);
         }
     }
 
@@ -200,11 +372,7 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
   /* First, check if there is already a socket listening on this port */
 
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  if (tcp_islistener(&conn->u, conn->lport, conn->domain))
-#else
-  if (tcp_islistener(&conn->u, conn->lport))
-#endif
+  if (tcp_listen_conflict(conn))
     {
       /* Yes, then we must refuse this request */
 
@@ -254,12 +422,12 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno,
                     uint8_t domain)
 {
-  return tcp_findlistener(uaddr, portno, domain) != NULL;
+  return tcp_findlistener(uaddr, portno, 0, domain) != NULL;
 }
 #else
 bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno)
 {
-  return tcp_findlistener(uaddr, portno) != NULL;
+  return tcp_findlistener(uaddr, portno, 0) != NULL;
 }
 #endif
 
@@ -286,9 +454,9 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
    */
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  listener = tcp_findlistener(&conn->u, portno, conn->domain);
+  listener = tcp_findlistener(&conn->u, portno, conn->rport, conn->domain);
 #else
-  listener = tcp_findlistener(&conn->u, portno);
+  listener = tcp_findlistener(&conn->u, portno, conn->rport);
 #endif
   if (listener != NULL)
     {
@@ -157,6 +157,13 @@ static uint16_t tcp_poll_eventhandler(FAR struct net_driver_s *dev,
           eventset |= POLLOUT;
         }
 
+      /* Completed MSG_ZEROCOPY sends are read from the error queue */
+
+      if (tcp_zerocopy_pending(info->conn))
+        {
+          eventset |= POLLERR;
+        }
+
       /* Awaken the caller of poll() if requested event occurred. */
 
       poll_notify(&info->fds, 1, eventset);
@@ -274,6 +281,13 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
         {
           cb->flags |= TCP_CONNECTED;
         }
+
+#ifdef CONFIG_NETDEV_POLL_PENDING
+      if (conn->dev != NULL)
+        {
+          devif_pend(&conn->dev->d_tcppend, &conn->sconn);
+        }
+#endif
     }
 
   if ((fds->events & POLLIN) != 0)
@@ -352,6 +366,11 @@ int tcp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       eventset |= POLLWRNORM;
     }
 
+  if (tcp_zerocopy_pending(conn))
+    {
+      eventset |= POLLERR;
+    }
+
   /* Check if any requested events are already in effect */
 
   poll_notify(&fds, 1, eventset);
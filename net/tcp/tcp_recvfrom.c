@@ -752,8 +752,14 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
    * not only this particular connection.
    */
 
+  if (ret > 0)
+    {
+      tcp_autotune_rcvbuf(conn, ret);
+    }
+
   if (tcp_should_send_recvwindow(conn))
     {
+      devif_pend(&conn->dev->d_tcppend, &conn->sconn);
       netdev_txnotify_dev(conn->dev);
     }
 
@@ -101,6 +101,77 @@ static inline FAR struct tcp_hdr_s *tcp_header(FAR struct net_driver_s *dev)
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: tcp_put_timestamp
+ *
+ * Description:
+ *   Write the timestamps option, aligned by two NOOPs: the current time and
+ *   the latest timestamp received from the peer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+static void tcp_put_timestamp(FAR struct tcp_conn_s *conn,
+                              FAR uint8_t *optdata)
+{
+  optdata[0] = TCP_OPT_NOOP;
+  optdata[1] = TCP_OPT_NOOP;
+  optdata[2] = TCP_OPT_TS;
+  optdata[3] = TCP_OPT_TS_LEN;
+  tcp_setsequence(&optdata[4], TCP_TSVAL());
+  tcp_setsequence(&optdata[8], conn->ts_recent);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_put_sack
+ *
+ * Description:
+ *   Write the SACK blocks of the out-of-order pool.  The range holding the
+ *   latest segment goes first, the others follow by left edge.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+static void tcp_put_sack(FAR struct tcp_conn_s *conn,
+                         FAR uint8_t *optdata, int nsacks)
+{
+  FAR struct tcp_ofoseg_s *seg;
+  int recent = 0;
+  int i;
+  int j;
+
+  for (i = 0; i < conn->nofosegs; i++)
+    {
+      if (TCP_SEQ_GTE(conn->ofoseg_recent, conn->ofosegs[i].left) &&
+          TCP_SEQ_LT(conn->ofoseg_recent, conn->ofosegs[i].right))
+        {
+          recent = i;
+          break;
+        }
+    }
+
+  for (i = 0, j = -1; i < nsacks; j++)
+    {
+      /* Index -1 stands for the recent range, skip it later on */
+
+      if (j == recent)
+        {
+          continue;
+        }
+
+      seg = &conn->ofosegs[j < 0 ? recent : j];
+      ninfo("TCP SACK [%d]"
+            "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n", i,
+            seg->left, seg->right, TCP_SEQ_SUB(seg->right, seg->left));
+      tcp_setsequence(&optdata[4 + i * 2 * sizeof(uint32_t)], seg->left);
+      tcp_setsequence(&optdata[4 + (i * 2 + 1) * sizeof(uint32_t)],
+                      seg->right);
+      i++;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_sendcommon
  *
@@ -151,12 +222,24 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       uint32_t rcvseq = tcp_getsequence(conn->rcvseq);
       uint32_t recvwndo = tcp_get_recvwindow(dev, conn);
 
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      /* The window of a SYN segment is never scaled (RFC7323) */
+
+      if ((tcp->flags & TCP_SYN) != 0)
+        {
+          recvwndo = MIN(recvwndo, UINT16_MAX);
+        }
+#endif
+
       /* Update the Receiver Window */
 
       conn->rcv_adv = rcvseq + recvwndo;
 
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
-      recvwndo >>= conn->rcv_scale;
+      if ((tcp->flags & TCP_SYN) == 0)
+        {
+          recvwndo >>= conn->rcv_scale;
+        }
 #endif
 
       /* Set the TCP Window */
@@ -187,7 +270,8 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       /* Calculate TCP checksum. */
 
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      tcp->tcpchksum = ipv6_upperlayer_txchksum(dev, IP_PROTO_TCP,
+                                                IPv6_HDRLEN);
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.ipv6.sent++;
 #endif
@@ -207,7 +291,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       /* Calculate TCP checksum. */
 
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      tcp->tcpchksum = ipv4_upperlayer_txchksum(dev, IP_PROTO_TCP);
 #ifdef CONFIG_NET_STATISTICS
       g_netstats.ipv4.sent++;
 #endif
@@ -240,127 +324,17 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: tcp_send
- *
- * Description:
- *   Setup to send a TCP packet
- *
- * Input Parameters:
- *   dev    - The device driver structure to use in the send operation
- *   conn   - The TCP connection structure holding connection information
- *   flags  - flags to apply to the TCP header
- *   len    - length of the message (includes the length of the IP and TCP
- *            headers)
- *
- * Returned Value:
- *   None
- *
- * Assumptions:
- *   Called with the network locked.
- *
- ****************************************************************************/
-
-void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
-              uint16_t flags, uint16_t len)
-{
-  FAR struct tcp_hdr_s *tcp;
-
-  if (dev->d_iob == NULL)
-    {
-      return;
-    }
-
-  tcp        = tcp_header(dev);
-  tcp->flags = flags;
-  dev->d_len = len;
-
-#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
-  if ((conn->flags & TCP_SACK) && (flags == TCP_ACK) && conn->nofosegs > 0)
-    {
-      int optlen = conn->nofosegs * sizeof(struct tcp_sack_s);
-      int i;
-
-      tcp->optdata[0] = TCP_OPT_NOOP;
-      tcp->optdata[1] = TCP_OPT_NOOP;
-      tcp->optdata[2] = TCP_OPT_SACK;
-      tcp->optdata[3] = TCP_OPT_SACK_PERM_LEN + optlen;
-
-      optlen += 4;
-
-      for (i = 0; i < conn->nofosegs; i++)
-        {
-          ninfo("TCP SACK [%d]"
-                "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n", i,
-                conn->ofosegs[i].left, conn->ofosegs[i].right,
-                TCP_SEQ_SUB(conn->ofosegs[i].right, conn->ofosegs[i].left));
-          tcp_setsequence(&tcp->optdata[4 + i * 2 * sizeof(uint32_t)],
-                          conn->ofosegs[i].left);
-          tcp_setsequence(&tcp->optdata[4 + (i * 2 + 1) * sizeof(uint32_t)],
-                          conn->ofosegs[i].right);
-        }
-
-      dev->d_len += optlen;
-      tcp->tcpoffset = ((TCP_HDRLEN + optlen) / 4) << 4;
-    }
-  else
-#endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
-    {
-      tcp->tcpoffset = (TCP_HDRLEN / 4) << 4;
-    }
-
-  tcp_sendcommon(dev, conn, tcp);
-
-#if defined(CONFIG_NET_STATISTICS) && \
-    defined(CONFIG_NET_TCP_DEBUG_DROP_SEND)
-
-#pragma message \
-  "CONFIG_NET_TCP_DEBUG_DROP_SEND is selected, this is debug " \
-  "feature to drop the tcp send packet on the floor, " \
-  "please confirm the configuration again if you do not want " \
-  "debug the TCP stack."
-
-  /* Debug feature to drop the tcp received packet on the floor */
-
-  if ((flags & TCP_PSH) != 0)
-    {
-      if ((g_netstats.tcp.sent %
-          CONFIG_NET_TCP_DEBUG_DROP_SEND_PROBABILITY) == 0)
-        {
-          uint32_t seq = tcp_getsequence(tcp->seqno);
-
-          ninfo("TCP DROP SNDPKT: "
-                "[%d][%" PRIu32 " : %" PRIu32 " : %d]\n",
-                g_netstats.tcp.sent, seq, TCP_SEQ_ADD(seq, dev->d_sndlen),
-                dev->d_sndlen);
-
-          dev->d_len = 0;
-        }
-    }
-#endif
-}
-
-/****************************************************************************
- * Name: tcp_reset
+ * Name: tcp_reply
  *
  * Description:
- *   Send a TCP reset (no-data) message
- *
- * Input Parameters:
- *   dev    - The device driver structure to use in the send operation
- *
- * Returned Value:
- *   None
- *
- * Assumptions:
- *   Called with the network locked.
+ *   Answer the received segment in place with a no-data segment carrying
+ *   'flags': the sequence and acknowledgement numbers follow from those of
+ *   the received segment.
  *
  ****************************************************************************/
 
-void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
+static void tcp_reply(FAR struct net_driver_s *dev,
+                      FAR struct tcp_conn_s *conn, uint8_t flags)
 {
   FAR struct tcp_hdr_s *tcp;
   uint32_t ackno;
@@ -373,10 +347,6 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       return;
     }
 
-#ifdef CONFIG_NET_STATISTICS
-  g_netstats.tcp.rst++;
-#endif
-
   /* TCP setup */
 
   tcp = tcp_header(dev);
@@ -418,7 +388,7 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
   acklen        -= (tcp->tcpoffset >> 4) << 2;
 
-  tcp->flags     = TCP_RST | TCP_ACK;
+  tcp->flags     = flags;
   tcp->tcpoffset = 5 << 4;
 
   /* Flip the seqno and ackno fields in the TCP header. */
@@ -480,7 +450,8 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                         conn ? conn->sconn.ttl : IP_TTL_DEFAULT,
                         conn ? conn->sconn.s_tos : 0);
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      tcp->tcpchksum = ipv6_upperlayer_txchksum(dev, IP_PROTO_TCP,
+                                                IPv6_HDRLEN);
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -497,11 +468,172 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                         conn ? conn->sconn.s_tos : 0, NULL);
 
       tcp->tcpchksum = 0;
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      tcp->tcpchksum = ipv4_upperlayer_txchksum(dev, IP_PROTO_TCP);
     }
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_send
+ *
+ * Description:
+ *   Setup to send a TCP packet
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure to use in the send operation
+ *   conn   - The TCP connection structure holding connection information
+ *   flags  - flags to apply to the TCP header
+ *   len    - length of the message (includes the length of the IP and TCP
+ *            headers)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
+              uint16_t flags, uint16_t len)
+{
+  FAR struct tcp_hdr_s *tcp;
+
+  if (dev->d_iob == NULL)
+    {
+      return;
+    }
+
+  /* 'len' includes the options of every segment, see tcpip_hdrsize() */
+
+  tcp        = tcp_header(dev);
+  tcp->flags = flags;
+  dev->d_len = len;
+
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+  if ((conn->flags & TCP_TSTAMP) != 0)
+    {
+      tcp_put_timestamp(conn, tcp->optdata);
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_SELECTIVE_ACK
+  if ((conn->flags & TCP_SACK) && (flags == TCP_ACK) && conn->nofosegs > 0)
+    {
+      FAR uint8_t *optdata = &tcp->optdata[TCP_TSOPT_LEN(conn)];
+      int nsacks = MIN(conn->nofosegs,
+                       (TCP_MAX_HDRLEN - TCP_HDRLEN - TCP_TSOPT_LEN(conn) -
+                        4) / sizeof(struct tcp_sack_s));
+      int optlen = nsacks * sizeof(struct tcp_sack_s);
+
+      optdata[0] = TCP_OPT_NOOP;
+      optdata[1] = TCP_OPT_NOOP;
+      optdata[2] = TCP_OPT_SACK;
+      optdata[3] = TCP_OPT_SACK_PERM_LEN + optlen;
+
+      optlen += 4;
+
+      tcp_put_sack(conn, optdata, nsacks);
+
+      dev->d_len += optlen;
+      tcp->tcpoffset =
+        ((TCP_HDRLEN + TCP_TSOPT_LEN(conn) + optlen) / 4) << 4;
+    }
+  else
+#endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
+    {
+      tcp->tcpoffset = ((TCP_HDRLEN + TCP_TSOPT_LEN(conn)) / 4) << 4;
+    }
+
+  tcp_sendcommon(dev, conn, tcp);
+
+#if defined(CONFIG_NET_STATISTICS) && \
+    defined(CONFIG_NET_TCP_DEBUG_DROP_SEND)
+
+#pragma message \
+  "CONFIG_NET_TCP_DEBUG_DROP_SEND is selected, this is debug " \
+  "feature to drop the tcp send packet on the floor, " \
+  "please confirm the configuration again if you do not want " \
+  "debug the TCP stack."
+
+  /* Debug feature to drop the tcp received packet on the floor */
+
+  if ((flags & TCP_PSH) != 0)
+    {
+      if ((g_netstats.tcp.sent %
+          CONFIG_NET_TCP_DEBUG_DROP_SEND_PROBABILITY) == 0)
+        {
+          uint32_t seq = tcp_getsequence(tcp->seqno);
+
+          ninfo("TCP DROP SNDPKT: "
+                "[%d][%" PRIu32 " : %" PRIu32 " : %d]\n",
+                g_netstats.tcp.sent, seq, TCP_SEQ_ADD(seq, dev->d_sndlen),
+                dev->d_sndlen);
+
+          dev->d_len = 0;
+        }
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_reset
+ *
+ * Description:
+ *   Send a TCP reset (no-data) message
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure to use in the send operation
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_STATISTICS
+  if (dev->d_iob != NULL)
+    {
+      g_netstats.tcp.rst++;
+    }
+#endif
+
+  tcp_reply(dev, conn, TCP_RST | TCP_ACK);
+}
+
+/****************************************************************************
+ * Name: tcp_ack_reply
+ *
+ * Description:
+ *   Acknowledge the received segment without a connection, the way a
+ *   connection in the TIME_WAIT state would.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure containing the received segment
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef NET_TCP_HAVE_TOMBSTONES
+void tcp_ack_reply(FAR struct net_driver_s *dev)
+{
+  tcp_reply(dev, NULL, TCP_ACK);
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_rx_mss
  *
@@ -580,9 +712,11 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   tcp = tcp_header(dev);
 
-  /* Set the packet length for the TCP Maximum Segment Size */
+  /* Set the packet length for the TCP Maximum Segment Size, the options
+   * are added below.
+   */
 
-  dev->d_len = tcpip_hdrsize(conn);
+  dev->d_len = tcpip_hdrsize(conn) - TCP_TSOPT_LEN(conn);
 
   /* Set the packet length for the TCP Maximum Segment Size */
 
@@ -630,6 +764,14 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
     }
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+  if (tcp->flags == TCP_SYN || (conn->flags & TCP_TSTAMP))
+    {
+      tcp_put_timestamp(conn, &tcp->optdata[optlen]);
+      optlen += TCP_OPT_TS_ALIGNED_LEN;
+    }
+#endif
+
   tcp->tcpoffset         = ((TCP_HDRLEN + optlen) / 4) << 4;
   dev->d_len            += optlen;
 
@@ -657,6 +799,13 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 void tcp_send_txnotify(FAR struct socket *psock,
                        FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NETDEV_POLL_PENDING
+  if (conn->dev != NULL)
+    {
+      devif_pend(&conn->dev->d_tcppend, &conn->sconn);
+    }
+
+#endif
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -689,7 +838,8 @@ void tcp_send_txnotify(FAR struct socket *psock,
  * Name: tcpip_hdrsize
  *
  * Description:
- *   Get the total size of L3 and L4 TCP header
+ *   Get the total size of L3 and L4 TCP header, with the options carried
+ *   by every segment of the connection
  *
  * Input Parameters:
  *   conn     The connection structure associated with the socket
@@ -701,7 +851,7 @@ void tcp_send_txnotify(FAR struct socket *psock,
 
 uint16_t tcpip_hdrsize(FAR struct tcp_conn_s *conn)
 {
-  uint16_t hdrsize = sizeof(struct tcp_hdr_s);
+  uint16_t hdrsize = sizeof(struct tcp_hdr_s) + TCP_TSOPT_LEN(conn);
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
   if (conn->domain == PF_INET)
@@ -52,6 +52,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/tcp.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/netstats.h>
 
 #include "netdev/netdev.h"
 #include "devif/devif.h"
@@ -609,6 +610,13 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
                       nsacks = parse_sack(conn, tcp, ofosegs);
 
+#ifdef CONFIG_NET_STATISTICS
+                      if (nsacks > 0)
+                        {
+                          g_netstats.tcp.sack++;
+                        }
+#endif
+
                       flags |= TCP_REXMIT;
                     }
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
@@ -938,6 +946,11 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
     }
 
 #if CONFIG_NET_SEND_BUFSIZE > 0
+  if ((flags & TCP_ACKDATA) != 0)
+    {
+      tcp_autotune_sndbuf(conn);
+    }
+
   /* Notify the send buffer available if wrbbuffer drained */
 
   tcp_sendbuffer_notify(conn);
@@ -1008,12 +1021,21 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       if (TCP_SEQ_LT(seq, snd_wnd_edge))
         {
           uint32_t remaining_snd_wnd;
+          uint32_t maxlen;
           int ret;
 
+          /* A TSO device splits a larger segment at the MSS itself */
+
+          maxlen = conn->mss;
+          if (NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TSO))
+            {
+              maxlen = UINT16_MAX - tcpip_hdrsize(conn);
+            }
+
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > maxlen)
             {
-              sndlen = conn->mss;
+              sndlen = maxlen;
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1052,6 +1074,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
            * won't actually happen until the polling cycle completes).
            */
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+          dev->d_gsosize = sndlen > conn->mss ? conn->mss : 0;
+#endif
           ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen,
                                TCP_WBSENT(wrb), tcpip_hdrsize(conn));
           if (ret <= 0)
@@ -1261,6 +1286,9 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   FAR struct tcp_conn_s *conn;
   FAR struct tcp_wrbuffer_s *wrb;
   FAR const uint8_t *cp;
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  FAR struct tcp_zcsend_s *zc = NULL;
+#endif
   unsigned int timeout;
   ssize_t    result = 0;
   bool       nonblock;
@@ -1328,6 +1356,16 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
   BUF_DUMP("psock_tcp_send", buf, len);
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* With SO_ZEROCOPY, MSG_ZEROCOPY queues the user memory by reference */
+
+  if ((flags & MSG_ZEROCOPY) != 0 &&
+      _SO_GETOPT(conn->sconn.s_options, SO_ZEROCOPY))
+    {
+      zc = tcp_zerocopy_begin(conn, buf, len);
+    }
+#endif
+
   cp = buf;
   while (len > 0)
     {
@@ -1424,7 +1462,11 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
           wrb = (FAR struct tcp_wrbuffer_s *)sq_tail(&conn->write_q);
           if (wrb != NULL && TCP_WBSENT(wrb) == 0 && TCP_WBNRTX(wrb) == 0 &&
               TCP_WBPKTLEN(wrb) < max_wrb_size &&
-              (TCP_WBPKTLEN(wrb) % conn->mss) != 0)
+              (TCP_WBPKTLEN(wrb) % conn->mss) != 0 &&
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+              zc == NULL &&
+#endif
+              !TCP_WBZEROCOPY(wrb))
             {
               wrb = (FAR struct tcp_wrbuffer_s *)sq_remlast(&conn->write_q);
               ninfo("coalesce %zu bytes to wrb %p (%" PRIu16 ")\n", len, wrb,
@@ -1484,7 +1526,17 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
            * remaining data.
            */
 
-          chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+          if (zc != NULL)
+            {
+              chunk_result = tcp_zerocopy_copyin(zc, wrb, cp, chunk_len);
+            }
+          else
+#endif
+            {
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+            }
+
           if (chunk_result == -ENOMEM)
             {
               if (TCP_WBPKTLEN(wrb) > 0)
@@ -1509,7 +1561,7 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
             }
           else
             {
-              DEBUGASSERT(chunk_result == chunk_len);
+              DEBUGASSERT(chunk_result == chunk_len || TCP_WBZEROCOPY(wrb));
             }
 
           if (chunk_result > 0)
@@ -1609,6 +1661,10 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
       goto errout;
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  tcp_zerocopy_end(zc, result);
+#endif
+
   /* Return the number of bytes actually sent */
 
   return result;
@@ -1617,6 +1673,10 @@ errout_with_lock:
   net_unlock();
 
 errout:
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  tcp_zerocopy_end(zc, result);
+#endif
+
   if (result > 0)
     {
       return result;
@@ -51,6 +51,7 @@
 #include <debug.h>
 #include <time.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
@@ -77,6 +78,68 @@
 
 #define ACK_DELAY (1)
 
+/* The timer wheel has a slot for each half-second */
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+#  define TCP_WHEEL_SLOTS (1 << CONFIG_NET_TCP_TIMER_WHEEL_BITS)
+#  define TCP_WHEEL_MASK  (TCP_WHEEL_SLOTS - 1)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* What is left of a connection freed in the TIME_WAIT state */
+
+#ifdef NET_TCP_HAVE_TOMBSTONES
+struct tcp_tombstone_s
+{
+  union ip_binding_u u;   /* The addresses of the connection */
+  uint32_t expire;        /* End of TIME_WAIT (units: half-seconds) */
+  uint16_t lport;         /* The local port, in network byte order */
+  uint16_t rport;         /* The remote port, in network byte order */
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  uint8_t  domain;        /* IP domain: PF_INET or PF_INET6 */
+#endif
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+static void tcp_timer_expiry(FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+/* The connections by expiration time and their number, the last
+ * half-second the wheel expired and the work that advances it.
+ */
+
+static dq_queue_t g_tcp_wheel[TCP_WHEEL_SLOTS];
+static unsigned int g_tcp_wheel_count;
+static uint32_t g_tcp_wheel_time;
+static struct work_s g_tcp_wheel_work;
+
+/* The half-second clock of the wheel and the tick it last advanced at */
+
+static uint32_t g_tcp_wheel_clock;
+static clock_t g_tcp_wheel_ticks;
+#endif
+
+/* The tombstones, a ring in the order they were added */
+
+#ifdef NET_TCP_HAVE_TOMBSTONES
+static struct tcp_tombstone_s g_tcp_tombstones[CONFIG_NET_TCP_NTOMBSTONES];
+static unsigned int g_tcp_tombstone_head;
+static unsigned int g_tcp_tombstone_count;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -117,6 +180,115 @@ static int tcp_get_timeout(FAR struct tcp_conn_s *conn)
   return timeout;
 }
 
+/****************************************************************************
+ * Name: tcp_wheel_now
+ *
+ * Description:
+ *   Return the current time of the timer wheel (units: half-seconds).  The
+ *   clock counts whole half-seconds of system ticks, so it does not jump
+ *   when the system tick counter wraps.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+static uint32_t tcp_wheel_now(void)
+{
+  clock_t elapsed = clock_systime_ticks() - g_tcp_wheel_ticks;
+  uint32_t steps  = elapsed / TICK_PER_HSEC;
+
+  g_tcp_wheel_ticks += (clock_t)steps * TICK_PER_HSEC;
+  g_tcp_wheel_clock += steps;
+  return g_tcp_wheel_clock;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_wheel_remove
+ *
+ * Description:
+ *   Take the timer of a connection off the timer wheel.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+static void tcp_wheel_remove(FAR struct tcp_conn_s *conn)
+{
+  if (conn->warmed)
+    {
+      dq_rem(&conn->wnode, &g_tcp_wheel[conn->wexpire & TCP_WHEEL_MASK]);
+      conn->warmed = false;
+      g_tcp_wheel_count--;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_wheel_schedule
+ *
+ * Description:
+ *   Queue the work that advances the timer wheel at the start of the next
+ *   half-second of its clock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+static void tcp_wheel_schedule(void)
+{
+  clock_t elapsed = clock_systime_ticks() - g_tcp_wheel_ticks;
+  clock_t delay   = 1;
+
+  if (elapsed < TICK_PER_HSEC)
+    {
+      delay = TICK_PER_HSEC - elapsed;
+    }
+
+  work_queue(LPWORK, &g_tcp_wheel_work, tcp_timer_expiry, NULL, delay);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_wheel_start
+ *
+ * Description:
+ *   Start turning the timer wheel from 'now' if it is idle.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+static void tcp_wheel_start(uint32_t now)
+{
+  if (work_available(&g_tcp_wheel_work))
+    {
+      g_tcp_wheel_time = now;
+      tcp_wheel_schedule();
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_timewait_expire
+ *
+ * Description:
+ *   Release the tombstones whose TIME_WAIT ended and return true if some
+ *   remain.
+ *
+ ****************************************************************************/
+
+#ifdef NET_TCP_HAVE_TOMBSTONES
+static bool tcp_timewait_expire(uint32_t now)
+{
+  while (g_tcp_tombstone_count > 0 &&
+         (int32_t)(g_tcp_tombstones[g_tcp_tombstone_head].expire - now) <= 0)
+    {
+      g_tcp_tombstone_head = (g_tcp_tombstone_head + 1) %
+                             CONFIG_NET_TCP_NTOMBSTONES;
+      g_tcp_tombstone_count--;
+    }
+
+  return g_tcp_tombstone_count > 0;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_timer_expiry
  *
@@ -124,6 +296,9 @@ static int tcp_get_timeout(FAR struct tcp_conn_s *conn)
  *   Handle a TCP timer expiration for the provided TCP connection
  *   Restart a TCP timer if need to
  *
+ *   With the timer wheel, expire the connections in the slots of the
+ *   half-seconds since the last call instead; arg is not used.
+ *
  * Input Parameters:
  *   arg - The TCP "connection" to poll for TX data
  *
@@ -136,6 +311,67 @@ static int tcp_get_timeout(FAR struct tcp_conn_s *conn)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+static void tcp_timer_expiry(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn;
+  FAR dq_entry_t *node;
+  FAR dq_entry_t *next;
+  uint32_t now;
+  uint32_t steps;
+  uint32_t i;
+  bool pending;
+
+  net_lock();
+
+  now   = tcp_wheel_now();
+  steps = now - g_tcp_wheel_time;
+  if (steps > TCP_WHEEL_SLOTS)
+    {
+      steps = TCP_WHEEL_SLOTS;
+    }
+
+  for (i = 0; i < steps; i++)
+    {
+      uint32_t slot = (now - i) & TCP_WHEEL_MASK;
+
+      for (node = dq_peek(&g_tcp_wheel[slot]); node != NULL; node = next)
+        {
+          next = dq_next(node);
+          conn = container_of(node, struct tcp_conn_s, wnode);
+
+          /* Timers more than a turn away stay in the slot */
+
+          if ((int32_t)(conn->wexpire - now) <= 0)
+            {
+              tcp_wheel_remove(conn);
+              conn->timeout = true;
+              devif_pend(&conn->dev->d_tcppend, &conn->sconn);
+              netdev_txnotify_dev(conn->dev);
+            }
+        }
+    }
+
+  g_tcp_wheel_time = now;
+  pending = g_tcp_wheel_count > 0;
+
+#ifdef NET_TCP_HAVE_TOMBSTONES
+  if (tcp_timewait_expire(now))
+    {
+      pending = true;
+    }
+#endif
+
+  /* Keep turning while any timer is pending */
+
+  if (pending)
+    {
+      tcp_wheel_schedule();
+    }
+
+  net_unlock();
+}
+#else
 static void tcp_timer_expiry(FAR void *arg)
 {
   FAR struct tcp_conn_s *conn = NULL;
@@ -147,6 +383,7 @@ static void tcp_timer_expiry(FAR void *arg)
       if (conn == arg)
         {
           conn->timeout = true;
+          devif_pend(&conn->dev->d_tcppend, &conn->sconn);
           netdev_txnotify_dev(conn->dev);
           break;
         }
@@ -154,6 +391,7 @@ static void tcp_timer_expiry(FAR void *arg)
 
   net_unlock();
 }
+#endif
 
 /****************************************************************************
  * Name: tcp_xmit_probe
@@ -225,6 +463,10 @@ static void tcp_xmit_probe(FAR struct net_driver_s *dev,
 void tcp_update_timer(FAR struct tcp_conn_s *conn)
 {
   int timeout = tcp_get_timeout(conn);
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+  uint32_t expire;
+  uint32_t now;
+#endif
 
   if (timeout > 0)
     {
@@ -246,16 +488,37 @@ void tcp_update_timer(FAR struct tcp_conn_s *conn)
         }
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+      /* Round up, the timer must not expire early */
+
+      now    = tcp_wheel_now();
+      expire = now + timeout + 1;
+
+      if (conn->warmed && conn->wexpire == expire)
+        {
+          return;
+        }
+
+      tcp_wheel_remove(conn);
+
+      tcp_wheel_start(now);
+
+      conn->wexpire = expire;
+      conn->warmed  = true;
+      dq_addlast(&conn->wnode, &g_tcp_wheel[expire & TCP_WHEEL_MASK]);
+      g_tcp_wheel_count++;
+#else
       if (work_available(&conn->work) ||
           TICK2HSEC(work_timeleft(&conn->work)) != timeout)
         {
           work_queue(LPWORK, &conn->work, tcp_timer_expiry,
                      conn, HSEC2TICK(timeout));
         }
+#endif
     }
   else
     {
-      work_cancel(LPWORK, &conn->work);
+      tcp_stop_timer(conn);
     }
 }
 
@@ -333,7 +596,11 @@ void tcp_update_keeptimer(FAR struct tcp_conn_s *conn, int timeout)
 
 void tcp_stop_timer(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+  tcp_wheel_remove(conn);
+#else
   work_cancel(LPWORK, &conn->work);
+#endif
 }
 
 /****************************************************************************
@@ -531,9 +798,10 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
                   listener = tcp_findlistener(&conn->u, conn->lport,
-                                              conn->domain);
+                                              conn->rport, conn->domain);
 #else
-                  listener = tcp_findlistener(&conn->u, conn->lport);
+                  listener = tcp_findlistener(&conn->u, conn->lport,
+                                              conn->rport);
 #endif
                   if (listener != NULL)
                     {
@@ -660,8 +928,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
                     /* reset cwnd and ssthresh, refers to RFC5861. */
 
-                    conn->ssthresh =
-                                    MAX(conn->tx_unacked / 2, 2 * conn->mss);
+                    conn->ssthresh = tcp_cc_ssthresh(conn);
                     conn->cwnd = conn->mss;
 #endif
                     goto done;
@@ -834,4 +1101,153 @@ done:
   tcp_update_timer(conn);
 }
 
+/****************************************************************************
+ * Name: tcp_timewait_add
+ *
+ * Description:
+ *   Keep a tombstone of a connection in the TIME_WAIT state that is being
+ *   freed: its addresses and ports, until the end of TIME_WAIT.  The
+ *   oldest tombstone is reused when all of them are taken.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection in the TIME_WAIT state
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef NET_TCP_HAVE_TOMBSTONES
+void tcp_timewait_add(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_tombstone_s *tomb;
+  uint32_t now = tcp_wheel_now();
+
+  if (g_tcp_tombstone_count == CONFIG_NET_TCP_NTOMBSTONES)
+    {
+      g_tcp_tombstone_head = (g_tcp_tombstone_head + 1) %
+                             CONFIG_NET_TCP_NTOMBSTONES;
+      g_tcp_tombstone_count--;
+    }
+
+  tomb = &g_tcp_tombstones[(g_tcp_tombstone_head + g_tcp_tombstone_count) %
+                           CONFIG_NET_TCP_NTOMBSTONES];
+  g_tcp_tombstone_count++;
+
+  /* The tombstone lasts for what is left of TIME_WAIT */
+
+  tomb->expire = conn->warmed ? conn->wexpire :
+                 now + TCP_TIME_WAIT_TIMEOUT * HSEC_PER_SEC;
+  tomb->lport  = conn->lport;
+  tomb->rport  = conn->rport;
+  memcpy(&tomb->u, &conn->u, sizeof(tomb->u));
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  tomb->domain = conn->domain;
+#endif
+
+  tcp_wheel_start(now);
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_timewait_input
+ *
+ * Description:
+ *   Handle a segment that matches no connection.  If it belongs to a
+ *   connection that left a tombstone, it is acknowledged as in the
+ *   TIME_WAIT state instead of being reset.
+ *
+ * Input Parameters:
+ *   dev - The device driver structure containing the received segment
+ *   tcp - The TCP header of the segment
+ *
+ * Returned Value:
+ *   true if the segment was handled here.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef NET_TCP_HAVE_TOMBSTONES
+bool tcp_timewait_input(FAR struct net_driver_s *dev,
+                        FAR struct tcp_hdr_s *tcp)
+{
+  FAR struct tcp_tombstone_s *tomb;
+  unsigned int i;
+
+  for (i = 0; i < g_tcp_tombstone_count; i++)
+    {
+      tomb = &g_tcp_tombstones[(g_tcp_tombstone_head + i) %
+                               CONFIG_NET_TCP_NTOMBSTONES];
+
+      if (tcp->destport != tomb->lport || tcp->srcport != tomb->rport)
+        {
+          continue;
+        }
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      if (IFF_IS_IPv6(dev->d_flags))
+#endif
+        {
+          FAR struct ipv6_hdr_s *ip = IPv6BUF;
+
+#ifdef CONFIG_NET_IPv4
+          if (tomb->domain != PF_INET6)
+            {
+              continue;
+            }
+#endif
+
+          if (!net_ipv6addr_cmp(ip->srcipaddr, tomb->u.ipv6.raddr) ||
+              !net_ipv6addr_cmp(ip->destipaddr, tomb->u.ipv6.laddr))
+            {
+              continue;
+            }
+        }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      else
+#endif
+        {
+          FAR struct ipv4_hdr_s *ip = IPv4BUF;
+
+#ifdef CONFIG_NET_IPv6
+          if (tomb->domain != PF_INET)
+            {
+              continue;
+            }
+#endif
+
+          if (!net_ipv4addr_cmp(net_ip4addr_conv32(ip->srcipaddr),
+                                tomb->u.ipv4.raddr) ||
+              !net_ipv4addr_cmp(net_ip4addr_conv32(ip->destipaddr),
+                                tomb->u.ipv4.laddr))
+            {
+              continue;
+            }
+        }
+#endif /* CONFIG_NET_IPv4 */
+
+      /* A reset is dropped (RFC 1337), anything else is acknowledged */
+
+      if ((tcp->flags & TCP_RST) != 0)
+        {
+          dev->d_len = 0;
+        }
+      else
+        {
+          tcp_ack_reply(dev);
+        }
+
+      return true;
+    }
+
+  return false;
+}
+#endif
+
 #endif /* CONFIG_NET && CONFIG_NET_TCP */
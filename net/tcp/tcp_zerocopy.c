@@ -0,0 +1,358 @@
+/****************************************************************************
+ * net/tcp/tcp_zerocopy.c
+ * MSG_ZEROCOPY sends of user memory by reference
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "tcp/tcp.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* An external buffer has a 16-bit size, so the user memory is split in
+ * windows of this size, each one an external buffer.
+ */
+
+#define TCP_ZEROCOPY_WINDOW 32768
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tcp_zcsend_s
+{
+  FAR struct tcp_conn_s *zc_conn;  /* The sending connection */
+  FAR const uint8_t *zc_base;      /* The user memory */
+  bool     zc_queued;              /* Data queued, notify the completion */
+  uint32_t zc_id;                  /* The id of the send */
+  int      zc_pending;             /* Windows not released yet */
+  int      zc_nwin;                /* Number of windows */
+  struct iob_extbuf_s zc_win[];    /* The windows of the user memory */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_zerocopy_complete
+ *
+ * Description:
+ *   Add a completed send to the range read from the error queue.  The
+ *   sends complete in order, as the data is acknowledged in order.
+ *
+ ****************************************************************************/
+
+static void tcp_zerocopy_complete(FAR struct tcp_conn_s *conn, uint32_t id)
+{
+  if (!conn->zc_ready)
+    {
+      conn->zc_lo    = id;
+      conn->zc_ready = true;
+    }
+
+  conn->zc_hi = id;
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_release
+ *
+ * Description:
+ *   Called when the last I/O buffer that refers to a window is freed, or
+ *   when tcp_zerocopy_end() drops the reference of an unused window.  The
+ *   send completes with its last window.
+ *
+ * Assumptions:
+ *   The network is locked: the write buffers are only freed by the network
+ *   logic, the data is copied in the packets sent by the device.
+ *
+ ****************************************************************************/
+
+static void tcp_zerocopy_release(FAR struct iob_extbuf_s *ext)
+{
+  FAR struct tcp_zcsend_s *zc = ext->eb_arg;
+
+  if (--zc->zc_pending > 0)
+    {
+      return;
+    }
+
+  if (zc->zc_queued)
+    {
+      ninfo("MSG_ZEROCOPY send %" PRIu32 " complete\n", zc->zc_id);
+      tcp_zerocopy_complete(zc->zc_conn, zc->zc_id);
+    }
+
+  kmm_free(zc);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_zerocopy_begin
+ *
+ * Description:
+ *   Prepare a MSG_ZEROCOPY send of the user memory 'buf' of 'len' bytes.
+ *
+ * Returned Value:
+ *   The send state, NULL if it cannot be allocated: the data is then
+ *   copied.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_zcsend_s *tcp_zerocopy_begin(FAR struct tcp_conn_s *conn,
+                                            FAR const void *buf,
+                                            size_t len)
+{
+  FAR struct tcp_zcsend_s *zc;
+  int nwin = (len + TCP_ZEROCOPY_WINDOW - 1) / TCP_ZEROCOPY_WINDOW;
+  int i;
+
+  if (len == 0)
+    {
+      return NULL;
+    }
+
+  zc = kmm_malloc(sizeof(struct tcp_zcsend_s) +
+                  nwin * sizeof(struct iob_extbuf_s));
+  if (zc == NULL)
+    {
+      nwarn("WARNING: MSG_ZEROCOPY falls back to copying\n");
+      return NULL;
+    }
+
+  zc->zc_conn    = conn;
+  zc->zc_base    = buf;
+  zc->zc_queued  = false;
+  zc->zc_id      = 0;
+  zc->zc_pending = nwin;
+  zc->zc_nwin    = nwin;
+
+  /* The send holds the first reference of every window until
+   * tcp_zerocopy_end(), so it cannot complete before it has an id.
+   */
+
+  for (i = 0; i < nwin; i++)
+    {
+      iob_extbuf_init(&zc->zc_win[i],
+                      (FAR uint8_t *)zc->zc_base + i * TCP_ZEROCOPY_WINDOW,
+                      MIN(len - i * TCP_ZEROCOPY_WINDOW,
+                          TCP_ZEROCOPY_WINDOW),
+                      tcp_zerocopy_release, zc);
+    }
+
+  return zc;
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_copyin
+ *
+ * Description:
+ *   Append 'len' bytes of the user memory at 'cp' to the empty write buffer
+ *   'wrb' by reference.
+ *
+ * Returned Value:
+ *   The number of bytes appended, -ENOMEM if none could be.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int tcp_zerocopy_copyin(FAR struct tcp_zcsend_s *zc,
+                        FAR struct tcp_wrbuffer_s *wrb,
+                        FAR const uint8_t *cp, size_t len)
+{
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
+  size_t pos = cp - zc->zc_base;
+  size_t copied = 0;
+
+  DEBUGASSERT(TCP_WBPKTLEN(wrb) == 0);
+
+  while (copied < len)
+    {
+      FAR struct iob_s *iob;
+      int win = pos / TCP_ZEROCOPY_WINDOW;
+      uint16_t offset = pos % TCP_ZEROCOPY_WINDOW;
+      uint16_t chunk = MIN(len - copied, TCP_ZEROCOPY_WINDOW - offset);
+
+      DEBUGASSERT(win < zc->zc_nwin);
+
+      iob = iob_tryalloc_extbuf(true, &zc->zc_win[win], offset, chunk);
+      if (iob == NULL)
+        {
+          break;
+        }
+
+      if (tail == NULL)
+        {
+          head = iob;
+        }
+      else
+        {
+          tail->io_flink = iob;
+        }
+
+      tail    = iob;
+      pos    += chunk;
+      copied += chunk;
+    }
+
+  if (head == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Replace the empty I/O buffer of the write buffer.  Nothing may be
+   * copied in after the data: the tail room is user memory.
+   */
+
+  head->io_pktlen = copied;
+  iob_free_chain(wrb->wb_iob);
+  wrb->wb_iob      = head;
+  wrb->wb_zerocopy = true;
+
+  return copied;
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_end
+ *
+ * Description:
+ *   End a MSG_ZEROCOPY send that queued 'result' bytes.  If any were, the
+ *   send gets the next id, notified as complete once the write buffers
+ *   release the user memory.
+ *
+ ****************************************************************************/
+
+void tcp_zerocopy_end(FAR struct tcp_zcsend_s *zc, ssize_t result)
+{
+  int nwin;
+  int i;
+
+  if (zc == NULL)
+    {
+      return;
+    }
+
+  net_lock();
+
+  if (result > 0)
+    {
+      zc->zc_queued = true;
+      zc->zc_id     = zc->zc_conn->zc_next++;
+    }
+
+  /* Drop the references of the send, the last one frees zc */
+
+  nwin = zc->zc_nwin;
+  for (i = nwin - 1; i >= 0; i--)
+    {
+      iob_extbuf_put(&zc->zc_win[i]);
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_recverr
+ *
+ * Description:
+ *   Implement recvmsg(MSG_ERRQUEUE): report the range of the completed
+ *   MSG_ZEROCOPY sends in a IP_RECVERR or IPV6_RECVERR control message.
+ *
+ * Returned Value:
+ *   Zero on success, -EAGAIN if no send completed.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_zerocopy_recverr(FAR struct tcp_conn_s *conn,
+                             FAR struct msghdr *msg)
+{
+  struct sock_extended_err err;
+  int level = IPPROTO_IP;
+  int type = IP_RECVERR;
+  ssize_t ret = OK;
+
+  net_lock();
+
+  if (!conn->zc_ready)
+    {
+      ret = -EAGAIN;
+      goto out;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      level = IPPROTO_IPV6;
+      type  = IPV6_RECVERR;
+    }
+#endif
+
+  memset(&err, 0, sizeof(err));
+  err.ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+  err.ee_info   = conn->zc_lo;
+  err.ee_data   = conn->zc_hi;
+
+  if (cmsg_append(msg, level, type, &err, sizeof(err)) == NULL)
+    {
+      /* Keep the notification for a larger control buffer */
+
+      msg->msg_flags |= MSG_CTRUNC;
+      goto out;
+    }
+
+  msg->msg_flags |= MSG_ERRQUEUE;
+  conn->zc_ready  = false;
+
+out:
+  net_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_NET_TCP_ZEROCOPY */
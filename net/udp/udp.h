@@ -70,6 +70,8 @@
 /* Definitions for the UDP connection struct flag field */
 
 #define _UDP_FLAG_CONNECTMODE (1 << 0) /* Bit 0:  UDP connection-mode */
+#define _UDP_FLAG_GRO         (1 << 1) /* Bit 1:  Coalesce received
+                                        *         datagrams (UDP_GRO) */
 
 #define _UDP_ISCONNECTMODE(f) (((f) & _UDP_FLAG_CONNECTMODE) != 0)
 
@@ -110,6 +112,9 @@ struct udp_conn_s
 
   /* UDP-specific content follows */
 
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+  sq_entry_t hnode;       /* Link in the connection hash table */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
@@ -124,6 +129,9 @@ struct udp_conn_s
   int32_t  sndbufs;       /* Maximum amount of bytes queued in send */
   sem_t    sndsem;        /* Semaphore signals send completion */
 #endif
+#ifdef CONFIG_NET_UDP_GSO
+  uint16_t gso_size;      /* Payload size of UDP_SEGMENT datagrams, or 0 */
+#endif
 
   /* Read-ahead buffering.
    *
@@ -248,6 +256,21 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 
 FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn);
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Set the local port number (network byte order) of a connection.  A
+ *   port number of zero unbinds the connection.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno);
+#else
+#  define udp_setport(conn, portno) ((conn)->lport = (portno))
+#endif
+
 /****************************************************************************
  * Name: udp_select_port
  *
@@ -440,6 +463,35 @@ int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len);
 #endif
 
+/****************************************************************************
+ * Name: udp_getsockopt
+ *
+ * Description:
+ *   udp_getsockopt() retrieves the value for the UDP-protocol option
+ *   specified by the 'option' argument for the socket specified by the
+ *   'psock' argument.
+ *
+ *   See <netinet/udp.h> for the a complete list of values of UDP protocol
+ *   options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    identifies the option to get
+ *   value     Points to the argument value buffer
+ *   value_len The length of the argument value buffer
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_getsockopt() for
+ *   the list of possible error values.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDPPROTO_OPTIONS
+int udp_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len);
+#endif
+
 /****************************************************************************
  * Name: udp_wrbuffer_initialize
  *
@@ -711,6 +763,30 @@ uint16_t udp_callback(FAR struct net_driver_s *dev,
 ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
                            int flags);
 
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Perform the recvmmsg operation for a UDP SOCK_DGRAM: receive up to
+ *   'vlen' datagrams while holding the network lock once.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec   Receive info and buffers, msg_len is set for each datagram
+ *   vlen     The number of entries in msgvec
+ *   flags    Receive flags
+ *   timeout  Checked after each datagram, or NULL
+ *
+ * Returned Value:
+ *   On success, returns the number of datagrams received.  On  error,
+ *   -errno is returned (see recvfrom for list of errnos).
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags,
+                       FAR struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_udp_sendto
  *
@@ -740,6 +816,34 @@ ssize_t psock_udp_sendto(FAR struct socket *psock,
                          FAR const void *buf, size_t len, int flags,
                          FAR const struct sockaddr *to, socklen_t tolen);
 
+/****************************************************************************
+ * Name: psock_udp_sendmmsg
+ *
+ * Description:
+ *   Queue up to 'vlen' datagrams on the write buffers of a UDP socket while
+ *   holding the network lock once.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   The datagrams, with a single iovec each, msg_len is set for
+ *            each of them
+ *   vlen     The number of entries in msgvec
+ *   flags    Send flags
+ *
+ *   NOTE: The destination addresses were verified by inet_sendmmsg()
+ *   before this function was called.
+ *
+ * Returned Value:
+ *   On success, returns the number of datagrams queued.  On  error,
+ *   a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_WRITE_BUFFERS
+int psock_udp_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags);
+#endif
+
 /****************************************************************************
  * Name: udp_pollsetup
  *
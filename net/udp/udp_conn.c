@@ -57,6 +57,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -89,10 +90,49 @@ static mutex_t g_free_lock = NXMUTEX_INITIALIZER;
 
 static dq_queue_t g_active_udp_connections;
 
+/* The connections bound to a local port again, hashed by that port, so
+ * that an incoming datagram is only compared against the connections in
+ * its bucket.
+ */
+
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+static sq_queue_t g_udp_hash[CONFIG_NET_UDP_HASH_SIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_hash
+ *
+ * Description:
+ *   Return the hash bucket of a local port number (network byte order).
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+static inline FAR sq_queue_t *udp_hash(uint16_t portno)
+{
+  return &g_udp_hash[portno % CONFIG_NET_UDP_HASH_SIZE];
+}
+#endif
+
+/****************************************************************************
+ * Name: udp_hash_next
+ *
+ * Description:
+ *   Return the connection that follows 'node' in its hash bucket.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+static inline FAR struct udp_conn_s *udp_hash_next(FAR sq_entry_t *node)
+{
+  return node != NULL ? container_of(node, struct udp_conn_s, hnode) : NULL;
+}
+#endif
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -105,6 +145,7 @@ static dq_queue_t g_active_udp_connections;
  *   portno - The port to use in the lookup
  *   opt    - The option from another conn to match the conflict conn
  *              SO_REUSEADDR: If both sockets have this, they never confilct.
+ *              SO_REUSEPORT: If both sockets have this, they share the port.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -118,6 +159,7 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
   FAR struct udp_conn_s *conn = NULL;
 #ifdef CONFIG_NET_SOCKOPTS
   bool skip_reusable = _SO_GETOPT(opt, SO_REUSEADDR);
+  bool skip_reuseport = _SO_GETOPT(opt, SO_REUSEPORT);
 #endif
 
   /* Now search each connection structure. */
@@ -133,6 +175,15 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
         {
           continue;
         }
+
+      /* Sockets with SO_REUSEPORT share the port, udp_reuseport_select()
+       * balances the datagrams among them.
+       */
+
+      if (skip_reuseport && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+        {
+          continue;
+        }
 #endif
 
       /* If the port local port number assigned to the connections matches
@@ -173,6 +224,116 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
   return NULL;
 }
 
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   'conn' is the first connection that matches a received datagram.  If
+ *   it is a member of a SO_REUSEPORT group, the connections that follow it
+ *   and are bound to the same local address and port, select the member
+ *   that receives the datagram by the hash of its source address and port.
+ *   The datagrams of one peer then always reach the same socket.
+ *
+ * Input Parameters:
+ *   conn   - The first matching connection
+ *   rport  - The source port of the datagram (network byte order)
+ *   raddr  - The source address of the datagram, as 'nwords' 16-bit words
+ *   nwords - The number of 16-bit words in raddr
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+static bool udp_reuseport_member(FAR struct udp_conn_s *member,
+                                 FAR struct udp_conn_s *conn)
+{
+  if (member->domain != conn->domain || member->lport != conn->lport ||
+      _UDP_ISCONNECTMODE(member->flags) ||
+      !_SO_GETOPT(member->sconn.s_options, SO_REUSEPORT))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return net_ipv4addr_cmp(member->u.ipv4.laddr, conn->u.ipv4.laddr);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return net_ipv6addr_cmp(member->u.ipv6.laddr, conn->u.ipv6.laddr);
+    }
+#endif
+}
+
+static FAR struct udp_conn_s *
+  udp_reuseport_select(FAR struct udp_conn_s *conn, uint16_t rport,
+                       FAR const uint16_t *raddr, int nwords)
+{
+  FAR struct udp_conn_s *member;
+  uint32_t hash = rport;
+  uint32_t nmembers = 0;
+  int i;
+
+  if (conn == NULL || _UDP_ISCONNECTMODE(conn->flags) ||
+      !_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return conn;
+    }
+
+  for (i = 0; i < nwords; i++)
+    {
+      hash = hash * 31 + raddr[i];
+    }
+
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+
+  /* Count the members, then pick the one the hash falls on */
+
+  for (i = 0; i < 2; i++)
+    {
+      uint32_t index = 0;
+
+      member = conn;
+      while (member != NULL)
+        {
+          if (udp_reuseport_member(member, conn))
+            {
+              if (i == 0)
+                {
+                  nmembers++;
+                }
+              else if (index++ == hash % nmembers)
+                {
+                  return member;
+                }
+            }
+
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+          member = udp_hash_next(member->hnode.flink);
+#else
+          member = (FAR struct udp_conn_s *)member->sconn.node.flink;
+#endif
+        }
+    }
+
+  return conn;
+}
+#else
+#  define udp_reuseport_select(c, p, a, n) (c)
+#endif
+
 /****************************************************************************
  * Name: udp_ipv4_active
  *
@@ -195,7 +356,11 @@ static inline FAR struct udp_conn_s *
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct udp_conn_s *conn;
 
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+  conn = udp_hash_next(sq_peek(udp_hash(udp->destport)));
+#else
   conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+#endif
   while (conn)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -308,10 +473,15 @@ static inline FAR struct udp_conn_s *
 
       /* Look at the next active connection */
 
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+      conn = udp_hash_next(conn->hnode.flink);
+#else
       conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
-  return conn;
+  return udp_reuseport_select(conn, udp->srcport,
+                              (FAR const uint16_t *)ip->srcipaddr, 2);
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -334,7 +504,11 @@ static inline FAR struct udp_conn_s *
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct udp_conn_s *conn;
 
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+  conn = udp_hash_next(sq_peek(udp_hash(udp->destport)));
+#else
   conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+#endif
   while (conn != NULL)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -447,10 +621,14 @@ static inline FAR struct udp_conn_s *
 
       /* Look at the next active connection */
 
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+      conn = udp_hash_next(conn->hnode.flink);
+#else
       conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
-  return conn;
+  return udp_reuseport_select(conn, udp->srcport, ip->srcipaddr, 8);
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -684,13 +862,17 @@ void udp_free(FAR struct udp_conn_s *conn)
 
   DEBUGASSERT(conn->crefs == 0);
 
+  udp_setport(conn, 0);
   nxmutex_lock(&g_free_lock);
-  conn->lport = 0;
 
   /* Remove the connection from the active list */
 
   dq_rem(&conn->sconn.node, &g_active_udp_connections);
 
+  /* Nothing is to be sent for the connection any longer */
+
+  devif_unpend(&conn->sconn);
+
   /* Release any read-ahead buffers attached to the connection, NULL is ok */
 
   iob_free_chain(conn->readahead);
@@ -790,6 +972,36 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: udp_setport
+ *
+ * Description:
+ *   Set the local port number (network byte order) of a connection and
+ *   move the connection to the matching bucket of the hash table.  A port
+ *   number of zero unbinds the connection.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+void udp_setport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+  net_lock();
+
+  if (conn->lport != 0)
+    {
+      sq_rem(&conn->hnode, udp_hash(conn->lport));
+    }
+
+  conn->lport = portno;
+  if (portno != 0)
+    {
+      sq_addlast(&conn->hnode, udp_hash(portno));
+    }
+
+  net_unlock();
+}
+#endif
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -916,8 +1128,8 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
     {
       /* Yes.. Select any unused local port number */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
-      ret         = OK;
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
+      ret = OK;
     }
   else
     {
@@ -945,8 +1157,8 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
-          ret         = OK;
+          udp_setport(conn, portno);
+          ret = OK;
         }
       else
         {
@@ -998,7 +1210,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
     }
 
   /* Is there a remote port (rport)? */
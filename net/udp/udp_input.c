@@ -121,7 +121,10 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   dev->d_appdata = IPBUF(udpiplen);
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-  chksum = udp->udpchksum;
+  /* Check the checksum, unless the device did */
+
+  chksum = NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_RXCSUM) ?
+           0 : udp->udpchksum;
   if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
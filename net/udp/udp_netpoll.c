@@ -193,6 +193,14 @@ int udp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
   if ((fds->events & POLLOUT) != 0)
     {
       cb->flags |= UDP_POLL;
+
+#if defined(CONFIG_NETDEV_POLL_PENDING) && \
+    defined(CONFIG_NET_UDP_WRITE_BUFFERS)
+      if (conn->dev != NULL)
+        {
+          devif_pend(&conn->dev->d_udppend, &conn->sconn);
+        }
+#endif
     }
 
   if ((fds->events & POLLIN) != 0)
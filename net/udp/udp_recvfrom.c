@@ -30,6 +30,7 @@
 #include <debug.h>
 #include <assert.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
@@ -37,6 +38,7 @@
 #include <nuttx/net/ip.h>
 #include <nuttx/net/udp.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
 
 #include "netdev/netdev.h"
 #include "devif/devif.h"
@@ -153,6 +155,146 @@ static inline size_t udp_recvfrom_newdata(FAR struct net_driver_s *dev,
   return recvlen;
 }
 
+/****************************************************************************
+ * Name: udp_readahead_header
+ *
+ * Description:
+ *   Unflatten the connection information saved ahead of the datagram at
+ *   the head of the read-ahead buffer.
+ *   Layout: |datalen|ifindex|src_addr_size|src_addr|data|
+ *
+ * Returned Value:
+ *   The offset of the datagram data in the I/O buffer chain.
+ *
+ ****************************************************************************/
+
+static int udp_readahead_header(FAR struct iob_s *iob,
+                                FAR uint16_t *datalen,
+                                FAR uint8_t *ifindex,
+                                FAR uint8_t *src_addr_size,
+                                FAR uint8_t *srcaddr)
+{
+  int recvlen;
+  int offset = 0;
+
+  recvlen = iob_copyout((FAR uint8_t *)datalen, iob,
+                        sizeof(*datalen), offset);
+  offset += sizeof(*datalen);
+  DEBUGASSERT(recvlen == sizeof(*datalen));
+
+#ifdef CONFIG_NETDEV_IFINDEX
+  recvlen = iob_copyout(ifindex, iob, sizeof(*ifindex), offset);
+  offset += sizeof(*ifindex);
+  DEBUGASSERT(recvlen == sizeof(*ifindex));
+#else
+  *ifindex = 1;
+#endif
+  recvlen = iob_copyout(src_addr_size, iob,
+                        sizeof(*src_addr_size), offset);
+  offset += sizeof(*src_addr_size);
+  DEBUGASSERT(recvlen == sizeof(*src_addr_size));
+
+  recvlen = iob_copyout(srcaddr, iob, *src_addr_size, offset);
+  offset += *src_addr_size;
+  DEBUGASSERT(recvlen == *src_addr_size);
+
+  UNUSED(recvlen);
+  return offset;
+}
+
+/****************************************************************************
+ * Name: udp_readahead_pop
+ *
+ * Description:
+ *   Remove the datagram of 'len' bytes, header included, from the head of
+ *   the read-ahead buffer.
+ *
+ ****************************************************************************/
+
+static void udp_readahead_pop(FAR struct udp_conn_s *conn, int len)
+{
+  FAR struct iob_s *iob = conn->readahead;
+
+  if (len >= iob->io_pktlen)
+    {
+      iob_free_chain(iob);
+      conn->readahead = NULL;
+    }
+  else
+    {
+      conn->readahead = iob_trimhead(iob, len);
+    }
+}
+
+/****************************************************************************
+ * Name: udp_readahead_gro
+ *
+ * Description:
+ *   With UDP_GRO, append the datagrams that follow in the read-ahead buffer
+ *   to the one just received while they come from the same peer and have
+ *   its size, the last one may be shorter, and fit in the user buffer.  A
+ *   UDP_GRO control message then reports the size of the datagrams.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_GSO
+static void udp_readahead_gro(FAR struct udp_recvfrom_s *pstate,
+                              uint8_t ifindex, uint8_t src_addr_size,
+                              FAR const uint8_t *srcaddr)
+{
+  FAR struct udp_conn_s *conn = pstate->ir_conn;
+  FAR struct msghdr *msg = pstate->ir_msg;
+  FAR struct iob_s *iob;
+  size_t total = pstate->ir_recvlen;
+  int gso_size = total;
+  int nsegs = 1;
+
+  while ((iob = conn->readahead) != NULL && nsegs < UDP_MAX_SEGMENTS)
+    {
+      uint16_t datalen;
+      uint8_t next_ifindex;
+      uint8_t next_size;
+#ifdef CONFIG_NET_IPv6
+      uint8_t next_addr[sizeof(struct sockaddr_in6)];
+#else
+      uint8_t next_addr[sizeof(struct sockaddr_in)];
+#endif
+      int offset;
+
+      offset = udp_readahead_header(iob, &datalen, &next_ifindex,
+                                    &next_size, next_addr);
+      if (datalen == 0 || datalen > gso_size ||
+          total + datalen > msg->msg_iov->iov_len ||
+          next_ifindex != ifindex || next_size != src_addr_size ||
+          memcmp(next_addr, srcaddr, src_addr_size) != 0)
+        {
+          break;
+        }
+
+      total += iob_copyout((FAR uint8_t *)msg->msg_iov->iov_base + total,
+                           iob, datalen, offset);
+      udp_readahead_pop(conn, offset + datalen);
+      nsegs++;
+
+      if (datalen < gso_size)
+        {
+          break;
+        }
+    }
+
+  if (nsegs > 1)
+    {
+      ninfo("Coalesced %d datagrams of %d bytes\n", nsegs, gso_size);
+
+      pstate->ir_recvlen = total;
+      cmsg_append(msg, SOL_UDP, UDP_GRO, &gso_size, sizeof(gso_size));
+    }
+}
+#endif
+
 static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 {
   FAR struct udp_conn_s *conn = pstate->ir_conn;
@@ -167,7 +309,7 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
   if ((iob = conn->readahead) != NULL)
     {
       int recvlen;
-      int offset = 0;
+      int offset;
       uint16_t datalen;
       uint8_t src_addr_size;
       uint8_t ifindex;
@@ -177,30 +319,10 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
       uint8_t srcaddr[sizeof(struct sockaddr_in)];
 #endif
 
-      /* Unflatten saved connection information
-       * Layout: |datalen|ifindex|src_addr_size|src_addr|data|
-       */
+      /* Unflatten saved connection information */
 
-      recvlen = iob_copyout((FAR uint8_t *)&datalen, iob,
-                            sizeof(datalen), offset);
-      offset += sizeof(datalen);
-      DEBUGASSERT(recvlen == sizeof(datalen));
-
-#ifdef CONFIG_NETDEV_IFINDEX
-      recvlen = iob_copyout(&ifindex, iob, sizeof(ifindex), offset);
-      offset += sizeof(ifindex);
-      DEBUGASSERT(recvlen == sizeof(ifindex));
-#else
-      ifindex = 1;
-#endif
-      recvlen = iob_copyout(&src_addr_size, iob,
-                            sizeof(src_addr_size), offset);
-      offset += sizeof(src_addr_size);
-      DEBUGASSERT(recvlen == sizeof(src_addr_size));
-
-      recvlen = iob_copyout(srcaddr, iob, src_addr_size, offset);
-      offset += src_addr_size;
-      DEBUGASSERT(recvlen == src_addr_size);
+      offset = udp_readahead_header(iob, &datalen, &ifindex,
+                                    &src_addr_size, srcaddr);
 
       /* Copy to user */
 
@@ -231,15 +353,15 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 
       if (!(pstate->ir_flags & MSG_PEEK))
         {
-          if (offset + datalen >= iob->io_pktlen)
-            {
-              iob_free_chain(iob);
-              conn->readahead = NULL;
-            }
-          else
+          udp_readahead_pop(conn, offset + datalen);
+
+#ifdef CONFIG_NET_UDP_GSO
+          if ((conn->flags & _UDP_FLAG_GRO) != 0 && recvlen == datalen &&
+              recvlen > 0)
             {
-              conn->readahead = iob_trimhead(iob, offset + datalen);
+              udp_readahead_gro(pstate, ifindex, src_addr_size, srcaddr);
             }
+#endif
         }
     }
 }
@@ -682,4 +804,90 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_udp_recvmmsg
+ *
+ * Description:
+ *   Perform the recvmmsg operation for a UDP SOCK_DGRAM: receive up to
+ *   'vlen' datagrams while holding the network lock once.
+ *
+ * Input Parameters:
+ *   psock    Pointer to the socket structure for the SOCK_DRAM socket
+ *   msgvec   Receive info and buffers, msg_len is set for each datagram
+ *   vlen     The number of entries in msgvec
+ *   flags    Receive flags
+ *   timeout  Checked after each datagram, or NULL
+ *
+ * Returned Value:
+ *   On success, returns the number of datagrams received.  On  error,
+ *   -errno is returned (see recvfrom for list of errnos).
+ *
+ ****************************************************************************/
+
+int psock_udp_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags,
+                       FAR struct timespec *timeout)
+{
+  FAR struct msghdr *msg;
+  unsigned long msg_controllen;
+  FAR void *msg_control;
+  sclock_t ticks = 0;
+  clock_t start;
+  unsigned int i;
+  ssize_t ret = OK;
+
+  if (timeout != NULL)
+    {
+      clock_time2ticks(timeout, &ticks);
+    }
+
+  /* psock_udp_recvfrom() only takes the lock recursively, a wait for a
+   * datagram still releases it.
+   */
+
+  net_lock();
+  start = clock_systime_ticks();
+
+  for (i = 0; i < vlen; i++)
+    {
+      msg            = &msgvec[i].msg_hdr;
+      msg_control    = msg->msg_control;
+      msg_controllen = msg->msg_controllen;
+
+      ret = psock_udp_recvfrom(psock, msg, flags);
+
+      /* Recover the pointer and calculate the cmsg's true data length, as
+       * psock_recvmsg() does.
+       */
+
+      msg->msg_control    = msg_control;
+      msg->msg_controllen = msg_controllen - msg->msg_controllen;
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          flags |= MSG_DONTWAIT;
+        }
+
+      if (timeout != NULL &&
+          (sclock_t)(clock_systime_ticks() - start) >= ticks)
+        {
+          i++;
+          break;
+        }
+    }
+
+  net_unlock();
+
+  /* An error after some datagrams is reported by the next call */
+
+  return i > 0 ? (int)i : (int)ret;
+}
+
 #endif /* CONFIG_NET && CONFIG_NET_UDP */
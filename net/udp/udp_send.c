@@ -186,7 +186,7 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
            ip6_is_ipv4addr((FAR struct in6_addr *)conn->u.ipv6.raddr)))
 #endif
         {
-          udp->udpchksum = ~udp_ipv4_chksum(dev);
+          udp->udpchksum = ipv4_upperlayer_txchksum(dev, IP_PROTO_UDP);
         }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -195,7 +195,8 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       else
 #endif
         {
-          udp->udpchksum = ~udp_ipv6_chksum(dev);
+          udp->udpchksum = ipv6_upperlayer_txchksum(dev, IP_PROTO_UDP,
+                                                    IPv6_HDRLEN);
         }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -36,6 +36,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/param.h>
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -45,6 +46,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <netinet/udp.h>
 #include <arch/irq.h>
 #include <nuttx/net/net.h>
 #include <nuttx/mm/iob.h>
@@ -262,7 +264,7 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_setport(conn, HTONS(udp_select_port(conn->domain, &conn->u)));
     }
 
   /* Get the device that will handle the remote packet transfers.  This
@@ -329,6 +331,7 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
 
   /* Notify the device driver of the availability of TX data */
 
+  devif_pend(&dev->d_udppend, &conn->sconn);
   netdev_txnotify_dev(dev);
   return OK;
 }
@@ -496,6 +499,54 @@ static unsigned int udp_send_gettimeout(clock_t start, unsigned int timeout)
   return timeout;
 }
 
+/****************************************************************************
+ * Name: udp_sendto_segments
+ *
+ * Description:
+ *   Split a UDP_SEGMENT send in datagrams of gso_size bytes, the last one
+ *   may be shorter, and queue them while holding the network lock once.
+ *
+ * Returned Value:
+ *   The number of bytes queued, or a negated errno value if none was.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_GSO
+static ssize_t udp_sendto_segments(FAR struct socket *psock,
+                                   FAR const void *buf, size_t len,
+                                   int flags, FAR const struct sockaddr *to,
+                                   socklen_t tolen)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  FAR const uint8_t *ptr = buf;
+  size_t gso_size = conn->gso_size;
+  size_t sent = 0;
+  ssize_t ret = OK;
+
+  if (len > gso_size * UDP_MAX_SEGMENTS)
+    {
+      return -EINVAL;
+    }
+
+  net_lock();
+
+  while (sent < len)
+    {
+      ret = psock_udp_sendto(psock, ptr + sent, MIN(len - sent, gso_size),
+                             flags, to, tolen);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      sent += ret;
+    }
+
+  net_unlock();
+  return sent > 0 ? (ssize_t)sent : ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -549,6 +600,15 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
       return -EMSGSIZE;
     }
 
+#ifdef CONFIG_NET_UDP_GSO
+  /* With UDP_SEGMENT, a larger send is split in several datagrams */
+
+  if (conn->gso_size > 0 && len > conn->gso_size)
+    {
+      return udp_sendto_segments(psock, buf, len, flags, to, tolen);
+    }
+#endif
+
   /* If the UDP socket was previously assigned a remote peer address via
    * connect(), then as with connection-mode socket, sendto() may not be
    * used with a non-NULL destination address.  Normally send() would be
@@ -877,6 +937,64 @@ errout_with_lock:
   return ret;
 }
 
+/****************************************************************************
+ * Name: psock_udp_sendmmsg
+ *
+ * Description:
+ *   Queue up to 'vlen' datagrams on the write buffers of a UDP socket while
+ *   holding the network lock once.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   The datagrams, with a single iovec each, msg_len is set for
+ *            each of them
+ *   vlen     The number of entries in msgvec
+ *   flags    Send flags
+ *
+ *   NOTE: The destination addresses were verified by inet_sendmmsg()
+ *   before this function was called.
+ *
+ * Returned Value:
+ *   On success, returns the number of datagrams queued.  On  error,
+ *   a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int psock_udp_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                       unsigned int vlen, int flags)
+{
+  FAR struct msghdr *msg;
+  unsigned int i;
+  ssize_t ret = OK;
+
+  /* psock_udp_sendto() only takes the lock recursively, a wait for write
+   * buffers still releases it.  Only the first datagram queued on an empty
+   * write queue notifies the device, the poll then drains the others.
+   */
+
+  net_lock();
+
+  for (i = 0; i < vlen; i++)
+    {
+      msg = &msgvec[i].msg_hdr;
+      ret = psock_udp_sendto(psock, msg->msg_iov->iov_base,
+                             msg->msg_iov->iov_len, flags,
+                             msg->msg_name, msg->msg_namelen);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      msgvec[i].msg_len = ret;
+    }
+
+  net_unlock();
+
+  /* An error after some datagrams is reported by the next call */
+
+  return i > 0 ? (int)i : (int)ret;
+}
+
 /****************************************************************************
  * Name: psock_udp_cansend
  *
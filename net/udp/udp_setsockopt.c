@@ -74,7 +74,111 @@
 int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len)
 {
+#ifdef CONFIG_NET_UDP_GSO
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  int ret = OK;
+  int val;
+
+  if (value == NULL || value_len != sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+  val = *(FAR const int *)value;
+
+  net_lock();
+  switch (option)
+    {
+      case UDP_SEGMENT:
+        if (val < 0 || val > UINT16_MAX)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            conn->gso_size = val;
+          }
+        break;
+
+      case UDP_GRO:
+        if (val)
+          {
+            conn->flags |= _UDP_FLAG_GRO;
+          }
+        else
+          {
+            conn->flags &= ~_UDP_FLAG_GRO;
+          }
+        break;
+
+      default:
+        nerr("ERROR: Unrecognized UDP option: %d\n", option);
+        ret = -ENOPROTOOPT;
+        break;
+    }
+
+  net_unlock();
+  return ret;
+#else
+  return -ENOPROTOOPT;
+#endif
+}
+
+/****************************************************************************
+ * Name: udp_getsockopt
+ *
+ * Description:
+ *   udp_getsockopt() retrieves the value for the UDP-protocol option
+ *   specified by the 'option' argument for the socket specified by the
+ *   'psock' argument.
+ *
+ *   See <netinet/udp.h> for the a complete list of values of UDP protocol
+ *   options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    identifies the option to get
+ *   value     Points to the argument value buffer
+ *   value_len The length of the argument value buffer
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_getsockopt() for
+ *   the list of possible error values.
+ *
+ ****************************************************************************/
+
+int udp_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len)
+{
+#ifdef CONFIG_NET_UDP_GSO
+  FAR struct udp_conn_s *conn = psock->s_conn;
+
+  if (value == NULL || value_len == NULL || *value_len < sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+  switch (option)
+    {
+      case UDP_SEGMENT:
+        *(FAR int *)value = conn->gso_size;
+        break;
+
+      case UDP_GRO:
+        *(FAR int *)value = (conn->flags & _UDP_FLAG_GRO) != 0;
+        break;
+
+      default:
+        nerr("ERROR: Unrecognized UDP option: %d\n", option);
+        return -ENOPROTOOPT;
+    }
+
+  *value_len = sizeof(int);
+  return OK;
+#else
   return -ENOPROTOOPT;
+#endif
 }
 
 #endif /* CONFIG_NET_UDPPROTO_OPTIONS */
@@ -661,6 +661,18 @@ int usrsock_do_request(FAR struct usrsock_conn_s *conn,
   conn->resp.xid = req_head->xid;
   conn->resp.result = -EACCES;
 
+#ifdef CONFIG_NET_USRSOCK_PIPELINE
+  /* The transport has copied the request when usrsock_request() returns,
+   * so the request line is free again at once; the caller waits for the
+   * response of its own connection.
+   */
+
+  ret = usrsock_request(iov, iovcnt);
+  if (ret < 0)
+    {
+      nerr("error: usrsock request failed with %d\n", ret);
+    }
+#else
   req->ackxid = req_head->xid;
 
   ret = usrsock_request(iov, iovcnt);
@@ -676,6 +688,7 @@ int usrsock_do_request(FAR struct usrsock_conn_s *conn,
     {
       nerr("error: usrsock request failed with %d\n", ret);
     }
+#endif
 
   /* Free request line for next command. */
 
@@ -53,35 +53,71 @@
 #ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
+  FAR const uint16_t *word;
+  union
+  {
+    uint8_t  b[2];
+    uint16_t w;
+  } edge;
+
+  uint32_t acc = 0;
   uint16_t t;
+  bool odd = false;
 
-  dataptr = data;
-  last_byte = data + len - 1;
+  if (len == 0)
+    {
+      return sum;
+    }
 
-  while (dataptr < last_byte)
+  /* Sum aligned 16-bit words in the host byte order, without carry tests:
+   * 32767 words cannot overflow the 32-bit accumulator.  From an odd
+   * address the first byte is the low half of a word and the words pair
+   * the bytes the other way round, which a byte swap of the result
+   * corrects (RFC 1071, byte order independence).
+   */
+
+  if (((uintptr_t)data & 1) != 0)
     {
-      /* At least two more bytes */
+      edge.b[0] = 0;
+      edge.b[1] = *data++;
+      acc       = edge.w;
+      odd       = true;
+      len--;
+    }
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+  word = (FAR const uint16_t *)data;
+  for (; len >= 8; len -= 8, word += 4)
+    {
+      acc += (uint32_t)word[0] + word[1] + word[2] + word[3];
+    }
 
-      dataptr += 2;
+  for (; len >= 2; len -= 2)
+    {
+      acc += *word++;
     }
 
-  if (dataptr == last_byte)
+  if (len > 0)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      edge.b[0] = *(FAR const uint8_t *)word;
+      edge.b[1] = 0;
+      acc      += edge.w;
+    }
+
+  /* Fold the carries back in and return to the network byte order */
+
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+  t   = NTOHS((uint16_t)acc);
+
+  if (odd)
+    {
+      t = (uint16_t)((t << 8) | (t >> 8));
+    }
+
+  sum += t;
+  if (sum < t)
+    {
+      sum++; /* carry */
     }
 
   /* Return sum in host byte order. */
@@ -111,6 +147,10 @@ uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 #ifdef CONFIG_MM_IOB
 uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset)
 {
+  uint16_t len;
+  uint16_t t;
+  bool odd = false;
+
   /* Skip to the I/O buffer containing the data offset */
 
   while (iob != NULL && offset > iob->io_len)
@@ -125,9 +165,26 @@ uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset)
 
   while (iob != NULL)
     {
-      sum = chksum(sum, iob->io_data + iob->io_offset + offset,
-                   iob->io_len - offset);
-      iob = iob->io_flink;
+      len = iob->io_len - offset;
+      t   = chksum(0, iob->io_data + iob->io_offset + offset, len);
+
+      /* After an odd number of bytes, this buffer starts in the middle of
+       * a 16-bit word: its sum is in the swapped byte order.
+       */
+
+      if (odd)
+        {
+          t = (uint16_t)((t << 8) | (t >> 8));
+        }
+
+      sum += t;
+      if (sum < t)
+        {
+          sum++; /* carry */
+        }
+
+      odd   ^= (len & 1) != 0;
+      iob    = iob->io_flink;
       offset = 0;
     }
 
@@ -155,6 +155,80 @@ uint16_t ipv6_upperlayer_chksum(FAR struct net_driver_s *dev,
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
+/****************************************************************************
+ * Name: ipv4_upperlayer_txchksum
+ *
+ * Description:
+ *   Return the value for the checksum field of an outgoing IPv4 packet: the
+ *   complemented checksum, or only the sum of the pseudo-header if the
+ *   device computes the checksum.  The length is left out of the sum of a
+ *   TSO segment, since the device splits it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+uint16_t ipv4_upperlayer_txchksum(FAR struct net_driver_s *dev,
+                                  uint8_t proto)
+{
+#ifdef CONFIG_NETDEV_OFFLOAD
+  if (NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TXCSUM))
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+      uint16_t sum = proto;
+
+      if (dev->d_gsosize == 0)
+        {
+          sum += (((uint16_t)(ipv4->len[0]) << 8) + ipv4->len[1]) -
+                 ((ipv4->vhl & IPv4_HLMASK) << 2);
+        }
+
+      sum = chksum(sum, (FAR uint8_t *)&ipv4->srcipaddr,
+                   2 * sizeof(in_addr_t));
+      return HTONS(sum);
+    }
+#endif
+
+  return ~ipv4_upperlayer_chksum(dev, proto);
+}
+#endif /* CONFIG_NET_IPv4 */
+
+/****************************************************************************
+ * Name: ipv6_upperlayer_txchksum
+ *
+ * Description:
+ *   Return the value for the checksum field of an outgoing IPv6 packet: the
+ *   complemented checksum, or only the sum of the pseudo-header if the
+ *   device computes the checksum.  The length is left out of the sum of a
+ *   TSO segment, since the device splits it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+uint16_t ipv6_upperlayer_txchksum(FAR struct net_driver_s *dev,
+                                  uint8_t proto, unsigned int iplen)
+{
+#ifdef CONFIG_NETDEV_OFFLOAD
+  if (NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TXCSUM))
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+      uint16_t sum = proto;
+
+      if (dev->d_gsosize == 0)
+        {
+          sum += (((uint16_t)ipv6->len[0] << 8) + ipv6->len[1]) -
+                 (iplen - IPv6_HDRLEN);
+        }
+
+      sum = chksum(sum, (FAR uint8_t *)&ipv6->srcipaddr,
+                   2 * sizeof(net_ipv6addr_t));
+      return HTONS(sum);
+    }
+#endif
+
+  return ~ipv6_upperlayer_chksum(dev, proto, iplen);
+}
+#endif /* CONFIG_NET_IPv6 */
+
 /****************************************************************************
  * Name: ipv4_chksum
  *
@@ -81,6 +81,12 @@ static void addrenv_destroy(FAR void *arg)
 
   up_addrenv_destroy(&addrenv->addrenv);
 
+#ifdef CONFIG_ARCH_HAVE_ADDRENV_TEXTSHARE
+  /* Release the address environment that owns the shared .text pages */
+
+  addrenv_drop(addrenv->textenv, false);
+#endif
+
   /* Then finally release the memory */
 
   kmm_free(addrenv);
@@ -90,6 +90,14 @@ void clock_set_adjust(long long adj_usec, long long adj_count,
                       FAR long long *adj_count_old);
 #endif
 
+#ifdef CONFIG_CLOCK_VDSO
+void clock_vdso_initialize(void);
+void clock_vdso_update(void);
+#else
+#  define clock_vdso_initialize()
+#  define clock_vdso_update()
+#endif
+
 int  clock_abstime2ticks(clockid_t clockid,
                          FAR const struct timespec *abstime,
                          FAR sclock_t *ticks);
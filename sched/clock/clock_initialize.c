@@ -237,6 +237,10 @@ void clock_initialize(void)
 
 #endif
 
+  /* Export the time base to user space */
+
+  clock_vdso_initialize();
+
   sched_trace_end();
 }
 
@@ -278,6 +282,8 @@ void clock_synchronize(FAR const struct timespec *tp)
   flags = enter_critical_section();
   clock_inittime(tp);
   leave_critical_section(flags);
+
+  clock_vdso_update();
 }
 #endif
 
@@ -415,6 +421,7 @@ void clock_resynchronize(FAR struct timespec *rtc_diff)
 
 skip:
   leave_critical_section(flags);
+  clock_vdso_update();
 }
 #endif
 
@@ -487,6 +494,10 @@ void clock_timer(void)
 
           up_adj_timer_period(0);
         }
+
+      /* The time of day is slewed: keep user space in step */
+
+      clock_vdso_update();
     }
 #endif
 }
@@ -124,6 +124,8 @@ int clock_settime(clockid_t clock_id, FAR const struct timespec *tp)
 #else
       ret = clock_timekeeping_set_wall_time(tp);
 #endif
+
+      clock_vdso_update();
     }
   else
     {
@@ -34,6 +34,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
 
 #include "clock/clock.h"
 
@@ -51,6 +52,13 @@ static struct timespec g_clock_wall_time;
 static uint64_t        g_clock_last_counter;
 static uint64_t        g_clock_mask;
 static long            g_clock_adjust;
+static spinlock_t      g_clock_lock = SP_UNLOCKED;
+
+/* Writers update the wall time base with g_clock_lock held; readers only
+ * sample g_clock_seq and retry if an update raced with them.
+ */
+
+static seqcount_t      g_clock_seq = SEQCOUNT_INITIALIZER;
 
 /****************************************************************************
  * Private Functions
@@ -63,27 +71,40 @@ static long            g_clock_adjust;
 static int clock_get_current_time(FAR struct timespec *ts,
                                   FAR struct timespec *base)
 {
-  irqstate_t flags;
+  struct timespec snapshot;
   uint64_t counter;
   uint64_t offset;
   uint64_t nsec;
+  uint32_t seq;
   time_t sec;
   int ret;
 
-  flags = enter_critical_section();
+  /* Sample the counter and the time base without taking g_clock_lock so
+   * that concurrent readers on different CPUs do not serialize.  Retry if
+   * clock_update_wall_time() or clock_timekeeping_set_wall_time() ran
+   * in the meantime.
+   */
 
-  ret = up_timer_gettick(&counter);
-  if (ret < 0)
+  do
     {
-      goto errout_in_critical_section;
+      seq = read_seqbegin(&g_clock_seq);
+
+      ret = up_timer_gettick(&counter);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      offset   = (counter - g_clock_last_counter) & g_clock_mask;
+      snapshot = *base;
     }
+  while (read_seqretry(&g_clock_seq, seq));
 
-  offset = (counter - g_clock_last_counter) & g_clock_mask;
   nsec   = offset * NSEC_PER_TICK;
   sec    = nsec   / NSEC_PER_SEC;
   nsec  -= sec    * NSEC_PER_SEC;
 
-  nsec  += base->tv_nsec;
+  nsec  += snapshot.tv_nsec;
   if (nsec >= NSEC_PER_SEC)
     {
       nsec -= NSEC_PER_SEC;
@@ -91,10 +112,8 @@ static int clock_get_current_time(FAR struct timespec *ts,
     }
 
   ts->tv_nsec = nsec;
-  ts->tv_sec = base->tv_sec + sec;
+  ts->tv_sec = snapshot.tv_sec + sec;
 
-errout_in_critical_section:
-  leave_critical_section(flags);
   return ret;
 }
 
@@ -121,21 +140,25 @@ int clock_timekeeping_set_wall_time(FAR const struct timespec *ts)
   uint64_t counter;
   int ret;
 
-  flags = enter_critical_section();
+  flags = spin_lock_irqsave_subsys(&g_clock_lock);
 
   ret = up_timer_gettick(&counter);
   if (ret < 0)
     {
-      goto errout_in_critical_section;
+      goto errout_with_lock;
     }
 
+  write_seqbegin(&g_clock_seq);
+
   memcpy(&g_clock_wall_time, ts, sizeof(struct timespec));
 
   g_clock_adjust       = 0;
   g_clock_last_counter = counter;
 
-errout_in_critical_section:
-  leave_critical_section(flags);
+  write_seqend(&g_clock_seq);
+
+errout_with_lock:
+  spin_unlock_irqrestore_subsys(&g_clock_lock, flags);
   return ret;
 }
 
@@ -186,7 +209,7 @@ int adjtime(FAR const struct timeval *delta, FAR struct timeval *olddelta)
       return -1;
     }
 
-  flags = enter_critical_section();
+  flags = spin_lock_irqsave_subsys(&g_clock_lock);
 
   adjust_usec = delta->tv_sec * USEC_PER_SEC + delta->tv_usec;
 
@@ -197,7 +220,7 @@ int adjtime(FAR const struct timeval *delta, FAR struct timeval *olddelta)
 
   g_clock_adjust = adjust_usec;
 
-  leave_critical_section(flags);
+  spin_unlock_irqrestore_subsys(&g_clock_lock, flags);
 
   return OK;
 }
@@ -215,18 +238,18 @@ void clock_update_wall_time(void)
   time_t sec;
   int ret;
 
-  flags = enter_critical_section();
+  flags = spin_lock_irqsave_subsys(&g_clock_lock);
 
   ret = up_timer_gettick(&counter);
   if (ret < 0)
     {
-      goto errout_in_critical_section;
+      goto errout_with_lock;
     }
 
   offset = (counter - g_clock_last_counter) & g_clock_mask;
   if (offset == 0)
     {
-      goto errout_in_critical_section;
+      goto errout_with_lock;
     }
 
   nsec  = offset * NSEC_PER_TICK;
@@ -263,13 +286,24 @@ void clock_update_wall_time(void)
         }
     }
 
+  write_seqbegin(&g_clock_seq);
+
   g_clock_wall_time.tv_sec += sec;
   g_clock_wall_time.tv_nsec = (long)nsec;
 
   g_clock_last_counter = counter;
 
-errout_in_critical_section:
-  leave_critical_section(flags);
+  write_seqend(&g_clock_seq);
+
+  /* The time of day is slewed: keep user space in step */
+
+  if (g_clock_adjust != 0)
+    {
+      clock_vdso_update();
+    }
+
+errout_with_lock:
+  spin_unlock_irqrestore_subsys(&g_clock_lock, flags);
 }
 
 /****************************************************************************
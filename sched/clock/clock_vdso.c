@@ -0,0 +1,262 @@
+/****************************************************************************
+ * sched/clock/clock_vdso.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/mman.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock_vdso.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+#ifdef CONFIG_BUILD_KERNEL
+#  include <nuttx/addrenv.h>
+#  include <nuttx/mm/map.h>
+#  include <nuttx/pgalloc.h>
+#endif
+
+#include "clock/clock.h"
+#include "sched/sched.h"
+
+#ifdef CONFIG_CLOCK_VDSO
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The clock data page.  In the kernel build it is a page of the page pool
+ * that is mapped into the processes; in the protected build it comes from
+ * the user heap, which all user code can read.
+ */
+
+static FAR struct clock_vdso_s *g_clock_vdso;
+static spinlock_t               g_clock_vdso_lock = SP_UNLOCKED;
+
+#ifdef CONFIG_BUILD_KERNEL
+static uintptr_t                g_clock_vdso_page;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+static int clock_vdso_munmap(FAR struct task_group_s *group,
+                             FAR struct mm_map_entry_s *entry,
+                             FAR void *start, size_t length)
+{
+  FAR void *vaddr = entry->vaddr;
+  int ret;
+
+  ret = mm_map_remove(get_group_mm(group), entry);
+  if (ret < 0 || group == NULL)
+    {
+      /* With no group the process is going away with its mappings */
+
+      return ret;
+    }
+
+  vm_release_region(get_group_mm(group), vaddr, MM_PGSIZE);
+  return up_shmdt((uintptr_t)vaddr, 1);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: clock_vdso_initialize
+ *
+ * Description:
+ *   Allocate the clock data page and set its time base.  Called at the end
+ *   of clock_initialize(), once the system timer and the RTC are set up.
+ *
+ ****************************************************************************/
+
+void clock_vdso_initialize(void)
+{
+  FAR struct clock_vdso_s *vdso;
+
+#ifdef CONFIG_BUILD_KERNEL
+  g_clock_vdso_page = mm_pgalloc(1);
+  if (g_clock_vdso_page == 0)
+    {
+      serr("ERROR: Failed to allocate the clock data page\n");
+      return;
+    }
+
+  vdso = (FAR struct clock_vdso_s *)
+         up_addrenv_page_vaddr(g_clock_vdso_page);
+  memset(vdso, 0, sizeof(*vdso));
+#else
+  vdso = kumm_zalloc(sizeof(*vdso));
+  if (vdso == NULL)
+    {
+      serr("ERROR: Failed to allocate the clock data page\n");
+      return;
+    }
+#endif
+
+  vdso->cv_freq    = up_vdso_getfreq();
+  vdso->cv_counter = up_vdso_counter();
+  clock_systime_timespec(&vdso->cv_monotonic);
+
+  g_clock_vdso = vdso;
+  clock_vdso_update();
+}
+
+/****************************************************************************
+ * Name: clock_vdso_update
+ *
+ * Description:
+ *   Refresh the CLOCK_REALTIME offset of the clock data page.  Called
+ *   whenever the time of day is set or slewed.
+ *
+ ****************************************************************************/
+
+void clock_vdso_update(void)
+{
+  FAR struct clock_vdso_s *vdso = g_clock_vdso;
+  struct timespec monotonic;
+  struct timespec realtime;
+  irqstate_t flags;
+
+  if (vdso == NULL)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_clock_vdso_lock);
+
+  clock_gettime(CLOCK_REALTIME, &realtime);
+  clock_vdso_monotonic(vdso, up_vdso_counter(), &monotonic);
+  clock_timespec_subtract(&realtime, &monotonic, &realtime);
+
+  write_seqbegin(&vdso->cv_seq);
+  vdso->cv_realtime = realtime;
+  write_seqend(&vdso->cv_seq);
+
+  spin_unlock_irqrestore(&g_clock_vdso_lock, flags);
+}
+
+/****************************************************************************
+ * Name: clock_vdso_map
+ *
+ * Description:
+ *   Map the clock data page into the calling process.  Mapping it again
+ *   returns the address of the existing mapping.
+ *
+ * Returned Value:
+ *   The address of the clock data page, or NULL if there is none; the
+ *   caller then has to go through the clock_gettime() system call.
+ *
+ ****************************************************************************/
+
+FAR const struct clock_vdso_s *clock_vdso_map(void)
+{
+#ifdef CONFIG_BUILD_KERNEL
+  FAR struct tcb_s *tcb = this_task();
+  FAR struct mm_map_s *mm = get_current_mm();
+  FAR struct mm_map_entry_s *entry;
+  struct mm_map_entry_s map;
+  FAR void *vaddr = NULL;
+  int ret;
+
+  if (g_clock_vdso_page == 0 || tcb->addrenv_own == NULL)
+    {
+      return NULL;
+    }
+
+  if (mm_map_lock() < 0)
+    {
+      return NULL;
+    }
+
+  for (entry = mm_map_next(mm, NULL); entry != NULL;
+       entry = mm_map_next(mm, entry))
+    {
+      if (entry->munmap == clock_vdso_munmap)
+        {
+          vaddr = entry->vaddr;
+          goto out;
+        }
+    }
+
+  vaddr = vm_alloc_region(mm, NULL, MM_PGSIZE);
+  if (vaddr == NULL)
+    {
+      goto out;
+    }
+
+  /* Map the page and take the write permission away from the process */
+
+  ret = up_shmat(&g_clock_vdso_page, 1, (uintptr_t)vaddr);
+  if (ret < 0)
+    {
+      goto errout_with_vaddr;
+    }
+
+  ret = up_addrenv_mprot(&tcb->addrenv_own->addrenv, (uintptr_t)vaddr,
+                         MM_PGSIZE, PROT_READ);
+  if (ret < 0)
+    {
+      goto errout_with_map;
+    }
+
+  memset(&map, 0, sizeof(map));
+  map.vaddr  = vaddr;
+  map.length = MM_PGSIZE;
+  map.prot   = PROT_READ;
+  map.munmap = clock_vdso_munmap;
+
+  ret = mm_map_add(mm, &map);
+  if (ret < 0)
+    {
+      goto errout_with_map;
+    }
+
+out:
+  mm_map_unlock();
+  return vaddr;
+
+errout_with_map:
+  up_shmdt((uintptr_t)vaddr, 1);
+
+errout_with_vaddr:
+  vm_release_region(mm, vaddr, MM_PGSIZE);
+  mm_map_unlock();
+  return NULL;
+#else
+  return g_clock_vdso;
+#endif
+}
+
+#endif /* CONFIG_CLOCK_VDSO */
@@ -0,0 +1,456 @@
+/****************************************************************************
+ * sched/futex/futex.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/futex.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/queue.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/semaphore.h>
+
+#ifdef CONFIG_FUTEX_SHARED
+#  include <nuttx/arch.h>
+#  include <nuttx/pgalloc.h>
+#endif
+
+#include "sched/sched.h"
+#include "futex/futex.h"
+
+#ifdef CONFIG_FUTEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* In the flat build there is a single address space, so the address alone
+ * identifies a futex.  Otherwise the same user address may refer to
+ * different memory in different processes and the task group is part of
+ * the key.  With CONFIG_FUTEX_SHARED the key of a mapped user address is
+ * its physical address instead, so that processes sharing the page share
+ * the futex.
+ */
+
+#ifndef CONFIG_BUILD_FLAT
+#  define FUTEX_HAVE_GROUP 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The identity of a futex */
+
+struct futex_key_s
+{
+  uintptr_t addr;                   /* Virtual or physical address */
+#ifdef FUTEX_HAVE_GROUP
+  FAR struct task_group_s *group;   /* Address space of addr, if virtual */
+#endif
+};
+
+/* This structure describes one thread waiting on a futex.  It lives on the
+ * stack of the waiting thread.
+ */
+
+struct futex_waiter_s
+{
+  dq_entry_t node;                  /* Link in the hash bucket */
+  struct futex_key_s key;           /* The futex waited on */
+  pid_t pid;                        /* The waiting thread */
+  bool queued;                      /* True until woken or removed */
+  sem_t sem;                        /* The waiting thread sleeps here */
+};
+
+/* One hash bucket of waiters */
+
+struct futex_bucket_s
+{
+  dq_queue_t waiters;               /* List of struct futex_waiter_s */
+  spinlock_t lock;                  /* Protects waiters */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct futex_bucket_s g_futex_hash[CONFIG_FUTEX_NBUCKETS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxfutex_getkey
+ *
+ * Description:
+ *   Return the key of the futex at 'uaddr' in the running task.
+ *
+ ****************************************************************************/
+
+static void nxfutex_getkey(FAR volatile uint32_t *uaddr,
+                           FAR struct futex_key_s *key)
+{
+#ifdef CONFIG_FUTEX_SHARED
+  FAR struct tcb_s *rtcb = this_task();
+  uintptr_t page = 0;
+
+  if (rtcb->addrenv_own != NULL)
+    {
+      page = up_addrenv_find_page(&rtcb->addrenv_own->addrenv,
+                                  (uintptr_t)uaddr);
+    }
+
+  if (page != 0)
+    {
+      key->addr  = page | ((uintptr_t)uaddr & MM_PGMASK);
+      key->group = NULL;
+      return;
+    }
+#endif
+
+  key->addr  = (uintptr_t)uaddr;
+#ifdef FUTEX_HAVE_GROUP
+  key->group = this_task()->group;
+#endif
+}
+
+/****************************************************************************
+ * Name: nxfutex_bucket
+ *
+ * Description:
+ *   Return the hash bucket of a futex.
+ *
+ ****************************************************************************/
+
+static FAR struct futex_bucket_s *
+nxfutex_bucket(FAR const struct futex_key_s *fkey)
+{
+  uintptr_t key = fkey->addr >> 2;
+
+  key ^= key >> 7;
+  key ^= key >> 13;
+  return &g_futex_hash[key % CONFIG_FUTEX_NBUCKETS];
+}
+
+/****************************************************************************
+ * Name: nxfutex_match
+ *
+ * Description:
+ *   Return true if a waiter waits on the given futex.
+ *
+ ****************************************************************************/
+
+static inline bool nxfutex_match(FAR struct futex_waiter_s *waiter,
+                                 FAR const struct futex_key_s *key)
+{
+#ifdef FUTEX_HAVE_GROUP
+  return waiter->key.addr == key->addr && waiter->key.group == key->group;
+#else
+  return waiter->key.addr == key->addr;
+#endif
+}
+
+/****************************************************************************
+ * Name: nxfutex_wait
+ *
+ * Description:
+ *   The internal form of futex_wait().  Returns zero (OK) on success or a
+ *   negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nxfutex_wait(FAR volatile uint32_t *uaddr, uint32_t val,
+                        FAR const struct timespec *timeout)
+{
+  FAR struct futex_bucket_s *bucket;
+  struct futex_waiter_s waiter;
+  sclock_t ticks = 0;
+  irqstate_t flags;
+  int ret;
+
+  if (uaddr == NULL || ((uintptr_t)uaddr & 3) != 0)
+    {
+      return -EINVAL;
+    }
+
+  if (timeout != NULL)
+    {
+      if (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+          timeout->tv_nsec >= NSEC_PER_SEC)
+        {
+          return -EINVAL;
+        }
+
+      clock_time2ticks(timeout, &ticks);
+    }
+
+  nxfutex_getkey(uaddr, &waiter.key);
+  waiter.pid    = nxsched_gettid();
+  waiter.queued = true;
+
+  nxsem_init(&waiter.sem, 0, 0);
+  nxsem_set_protocol(&waiter.sem, SEM_PRIO_NONE);
+
+  /* Queue ourselves only if the word still holds the expected value.  The
+   * check and the insertion are atomic with respect to futex_wake(), which
+   * takes the same bucket lock.
+   */
+
+  bucket = nxfutex_bucket(&waiter.key);
+  flags  = spin_lock_irqsave(&bucket->lock);
+
+  if (*uaddr != val)
+    {
+      spin_unlock_irqrestore(&bucket->lock, flags);
+      nxsem_destroy(&waiter.sem);
+      return -EAGAIN;
+    }
+
+  dq_addlast(&waiter.node, &bucket->waiters);
+  spin_unlock_irqrestore(&bucket->lock, flags);
+
+  if (timeout != NULL)
+    {
+      ret = nxsem_tickwait(&waiter.sem, ticks);
+    }
+  else
+    {
+      ret = nxsem_wait(&waiter.sem);
+    }
+
+  if (ret < 0)
+    {
+      /* Timed out or interrupted.  If a wakeup raced with us, it has
+       * already dequeued us and will post the semaphore; consume that
+       * post before the semaphore goes away and take it as a successful
+       * wakeup.
+       */
+
+      flags = spin_lock_irqsave(&bucket->lock);
+      if (waiter.queued)
+        {
+          dq_rem(&waiter.node, &bucket->waiters);
+          spin_unlock_irqrestore(&bucket->lock, flags);
+        }
+      else
+        {
+          spin_unlock_irqrestore(&bucket->lock, flags);
+          nxsem_wait_uninterruptible(&waiter.sem);
+          ret = OK;
+        }
+    }
+
+  nxsem_destroy(&waiter.sem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxfutex_wake
+ *
+ * Description:
+ *   The internal form of futex_wake().  Returns the number of threads
+ *   woken up or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int nxfutex_wake(FAR volatile uint32_t *uaddr, int nwake)
+{
+  FAR struct futex_bucket_s *bucket;
+  FAR struct futex_waiter_s *waiter;
+  FAR dq_entry_t *next;
+  FAR dq_entry_t *curr;
+  struct futex_key_s key;
+  dq_queue_t woken;
+  irqstate_t flags;
+  int nwoken = 0;
+
+  if (uaddr == NULL || ((uintptr_t)uaddr & 3) != 0 || nwake < 0)
+    {
+      return -EINVAL;
+    }
+
+  /* Dequeue the waiters under the bucket lock, but post them only after
+   * it has been released: nxsem_post() enters the critical section, which
+   * must never be taken while holding a bucket lock.
+   */
+
+  dq_init(&woken);
+  nxfutex_getkey(uaddr, &key);
+
+  bucket = nxfutex_bucket(&key);
+  flags  = spin_lock_irqsave(&bucket->lock);
+
+  for (curr = dq_peek(&bucket->waiters);
+       curr != NULL && nwoken < nwake;
+       curr = next)
+    {
+      next   = dq_next(curr);
+      waiter = (FAR struct futex_waiter_s *)curr;
+
+      if (nxfutex_match(waiter, &key))
+        {
+          dq_rem(curr, &bucket->waiters);
+          dq_addlast(curr, &woken);
+          waiter->queued = false;
+          nwoken++;
+        }
+    }
+
+  spin_unlock_irqrestore(&bucket->lock, flags);
+
+  /* The waiter may free its record as soon as it has been posted */
+
+  while ((curr = dq_remfirst(&woken)) != NULL)
+    {
+      nxsem_post(&((FAR struct futex_waiter_s *)curr)->sem);
+    }
+
+  return nwoken;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: futex_wait
+ *
+ * Description:
+ *   Atomically check that the 32-bit word at 'uaddr' still contains 'val'
+ *   and, if so, sleep until futex_wake() is called on the same address,
+ *   the timeout expires or a signal is received.
+ *
+ * Input Parameters:
+ *   uaddr   - The address of the futex word; must be 4-byte aligned
+ *   val     - The value the caller expects the futex word to hold
+ *   timeout - The maximum relative time to wait, or NULL to wait forever
+ *
+ * Returned Value:
+ *   Zero (OK) is returned when woken up.  Otherwise -1 (ERROR) is returned
+ *   and errno is set to indicate the error.
+ *
+ ****************************************************************************/
+
+int futex_wait(FAR volatile uint32_t *uaddr, uint32_t val,
+               FAR const struct timespec *timeout)
+{
+  int ret;
+
+  ret = nxfutex_wait(uaddr, val, timeout);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: futex_wake
+ *
+ * Description:
+ *   Wake up at most 'nwake' threads waiting in futex_wait() on 'uaddr'.
+ *
+ * Input Parameters:
+ *   uaddr - The address of the futex word; must be 4-byte aligned
+ *   nwake - The maximum number of threads to wake up
+ *
+ * Returned Value:
+ *   The number of threads woken up.  Otherwise -1 (ERROR) is returned and
+ *   errno is set to indicate the error.
+ *
+ ****************************************************************************/
+
+int futex_wake(FAR volatile uint32_t *uaddr, int nwake)
+{
+  int ret;
+
+  ret = nxfutex_wake(uaddr, nwake);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxfutex_recover
+ *
+ * Description:
+ *   Remove a thread that is being deleted from any futex wait queue.  The
+ *   waiter record lives on the stack of the thread, which is about to be
+ *   freed.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread being deleted
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxfutex_recover(FAR struct tcb_s *tcb)
+{
+  FAR struct futex_waiter_s *waiter;
+  FAR dq_entry_t *curr;
+  irqstate_t flags;
+  int i;
+
+  for (i = 0; i < CONFIG_FUTEX_NBUCKETS; i++)
+    {
+      flags = spin_lock_irqsave(&g_futex_hash[i].lock);
+
+      for (curr = dq_peek(&g_futex_hash[i].waiters);
+           curr != NULL;
+           curr = dq_next(curr))
+        {
+          waiter = (FAR struct futex_waiter_s *)curr;
+          if (waiter->pid == tcb->pid)
+            {
+              dq_rem(curr, &g_futex_hash[i].waiters);
+              break;
+            }
+        }
+
+      spin_unlock_irqrestore(&g_futex_hash[i].lock, flags);
+
+      if (curr != NULL)
+        {
+          break;
+        }
+    }
+}
+
+#endif /* CONFIG_FUTEX */
@@ -121,8 +121,5 @@ void group_remove_children(FAR struct task_group_s *group);
 
 int  group_setupidlefiles(FAR struct task_tcb_s *tcb);
 int  group_setuptaskfiles(FAR struct task_tcb_s *tcb);
-#ifdef CONFIG_FILE_STREAM
-int  group_setupstreams(FAR struct task_tcb_s *tcb);
-#endif
 
 #endif /* __SCHED_GROUP_GROUP_H */
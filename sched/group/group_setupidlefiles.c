@@ -59,7 +59,6 @@
 
 int group_setupidlefiles(FAR struct task_tcb_s *tcb)
 {
-  int ret = OK;
 #if defined(CONFIG_DEV_CONSOLE) || defined(CONFIG_DEV_NULL)
   int fd;
 #endif
@@ -115,11 +114,10 @@ int group_setupidlefiles(FAR struct task_tcb_s *tcb)
 #warning file descriptors 0-2 are not opened
 #endif /* defined(CONFIG_DEV_CONSOLE) || defined(CONFIG_DEV_NULL) */
 
-  /* Allocate file/socket streams for the TCB */
+  /* The stdin, stdout and stderr streams are set up by lib_get_stream()
+   * on first use.
+   */
 
-#ifdef CONFIG_FILE_STREAM
-  ret = group_setupstreams(tcb);
-#endif
   sched_trace_end();
-  return ret;
+  return OK;
 }
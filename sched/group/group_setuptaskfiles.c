@@ -83,11 +83,9 @@ int group_setuptaskfiles(FAR struct task_tcb_s *tcb)
     }
 #endif
 
-  /* Allocate file/socket streams for the new TCB */
-
-#ifdef CONFIG_FILE_STREAM
-  ret = group_setupstreams(tcb);
-#endif
+  /* The stdin, stdout and stderr streams are set up by lib_get_stream()
+   * on first use.
+   */
 
   sched_trace_end();
   return ret;
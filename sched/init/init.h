@@ -70,6 +70,43 @@ void nx_start(void);
 int nx_smp_start(void);
 #endif
 
+/****************************************************************************
+ * Name: nx_initcall_start
+ *
+ * Description:
+ *   Start the worker threads that run the initializers registered with
+ *   initcall_register().
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_INITCALL
+void nx_initcall_start(void);
+#endif
+
+/****************************************************************************
+ * Name: nx_initcall_wait
+ *
+ * Description:
+ *   Wait until all initializers not marked INITCALL_ASYNC have completed.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_INITCALL
+void nx_initcall_wait(void);
+#endif
+
 /****************************************************************************
  * Name: nx_idle_trampoline
  *
@@ -0,0 +1,154 @@
+/****************************************************************************
+ * sched/init/nx_boottime.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/init.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/spinlock.h>
+
+#ifdef CONFIG_SCHED_BOOTTIME
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The boot log.  Entries are never removed; phases beyond the size of the
+ * log are not recorded.
+ */
+
+static struct boottime_s g_boottime[CONFIG_SCHED_BOOTTIME_NENTRIES];
+static int g_boottime_count;
+static spinlock_t g_boottime_lock;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: boottime_begin
+ *
+ * Description:
+ *   Record the start of a boot phase.
+ *
+ ****************************************************************************/
+
+void boottime_begin(FAR const char *name)
+{
+  FAR struct boottime_s *entry;
+  irqstate_t flags;
+  int depth = 0;
+  int i;
+
+  flags = spin_lock_irqsave(&g_boottime_lock);
+  if (g_boottime_count < CONFIG_SCHED_BOOTTIME_NENTRIES)
+    {
+      for (i = 0; i < g_boottime_count; i++)
+        {
+          if (!g_boottime[i].done)
+            {
+              depth++;
+            }
+        }
+
+      entry          = &g_boottime[g_boottime_count++];
+      entry->name    = name;
+      entry->depth   = depth;
+      entry->elapsed = 0;
+      entry->done    = false;
+      entry->start   = up_perf_gettime();
+    }
+
+  spin_unlock_irqrestore(&g_boottime_lock, flags);
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+  sched_note_beginex(NOTE_TAG_SCHED, name);
+#endif
+}
+
+/****************************************************************************
+ * Name: boottime_end
+ *
+ * Description:
+ *   Record the end of the most recently started, unfinished boot phase
+ *   called 'name'.
+ *
+ ****************************************************************************/
+
+void boottime_end(FAR const char *name)
+{
+  unsigned long now = up_perf_gettime();
+  FAR struct boottime_s *entry;
+  irqstate_t flags;
+  int i;
+
+  flags = spin_lock_irqsave(&g_boottime_lock);
+  for (i = g_boottime_count - 1; i >= 0; i--)
+    {
+      entry = &g_boottime[i];
+      if (!entry->done && strcmp(entry->name, name) == 0)
+        {
+          entry->elapsed = now - entry->start;
+          entry->done    = true;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_boottime_lock, flags);
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_DUMP
+  sched_note_endex(NOTE_TAG_SCHED, name);
+#endif
+}
+
+/****************************************************************************
+ * Name: boottime_get
+ *
+ * Description:
+ *   Return boot log entry 'index'.
+ *
+ ****************************************************************************/
+
+int boottime_get(int index, FAR struct boottime_s *entry)
+{
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  flags = spin_lock_irqsave(&g_boottime_lock);
+  if (index >= 0 && index < g_boottime_count)
+    {
+      *entry = g_boottime[index];
+      ret    = OK;
+    }
+
+  spin_unlock_irqrestore(&g_boottime_lock, flags);
+  return ret;
+}
+
+#endif /* CONFIG_SCHED_BOOTTIME */
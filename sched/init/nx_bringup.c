@@ -38,6 +38,7 @@
 #include <nuttx/trace.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/kthread.h>
+#include <nuttx/profile.h>
 #include <nuttx/userspace.h>
 #include <nuttx/binfmt/binfmt.h>
 
@@ -195,6 +196,13 @@ static inline void nx_workqueues(void)
 
 #endif /* CONFIG_SCHED_LPWORK */
 
+#ifdef CONFIG_SCHED_CPUWORK
+  /* Start the per-CPU worker threads */
+
+  work_start_cpu();
+
+#endif /* CONFIG_SCHED_CPUWORK */
+
 #ifdef CONFIG_LIBC_USRWORK
   /* Start the user-space work queue */
 
@@ -245,7 +253,25 @@ static inline void nx_start_application(void)
    * configured.
    */
 
+  boottime_begin("board_late_initialize");
   board_late_initialize();
+  boottime_end("board_late_initialize");
+#endif
+
+#ifdef CONFIG_BOARD_COREDUMP
+  /* Open the core dump device, which is usually registered by now */
+
+  coredump_initialize();
+#endif
+
+#ifdef CONFIG_INITCALL
+  /* Wait for the initializers that must complete before the init task
+   * runs.  The INITCALL_ASYNC ones may continue in the background.
+   */
+
+  boottime_begin("nx_initcall_wait");
+  nx_initcall_wait();
+  boottime_end("nx_initcall_wait");
 #endif
 
   posix_spawnattr_init(&attr);
@@ -443,6 +469,18 @@ int nx_bringup(void)
 
   nx_workqueues();
 
+#ifdef CONFIG_SCHED_PROFILE
+  /* Start the sampling profiler */
+
+  profile_start();
+#endif
+
+#ifdef CONFIG_INITCALL
+  /* Start running the registered initializers concurrently */
+
+  nx_initcall_start();
+#endif
+
   /* Once the operating system has been initialized, the system must be
    * started by spawning the user initialization thread of execution.  This
    * will be the first user-mode thread.
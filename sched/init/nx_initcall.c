@@ -0,0 +1,423 @@
+/****************************************************************************
+ * sched/init/nx_initcall.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/init.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+
+#include "init/init.h"
+
+#ifdef CONFIG_INITCALL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Initcall states */
+
+#define INITCALL_PENDING  0
+#define INITCALL_RUNNING  1
+#define INITCALL_DONE     2
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The registered initializers in order of registration */
+
+static FAR struct initcall_s *g_initcall_head;
+static FAR struct initcall_s *g_initcall_tail;
+
+/* g_initcall_lock protects all of the state below.  Threads that wait for
+ * a change of state count themselves in g_initcall_nsleep and sleep on
+ * g_initcall_sem; every change of state wakes them all.
+ */
+
+static mutex_t g_initcall_lock = NXMUTEX_INITIALIZER;
+static sem_t   g_initcall_sem  = SEM_INITIALIZER(0);
+static int     g_initcall_nsleep;
+
+/* Whether nx_initcall_start() was called, the number of worker threads
+ * alive, of initializers running and of non-async initializers not done.
+ */
+
+static bool    g_initcall_started;
+static int     g_initcall_nworkers;
+static int     g_initcall_nrunning;
+static int     g_initcall_nsync;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: initcall_sleep
+ *
+ * Description:
+ *   Wait for the next change of state.  Called and returns with
+ *   g_initcall_lock held.
+ *
+ ****************************************************************************/
+
+static void initcall_sleep(void)
+{
+  g_initcall_nsleep++;
+  nxmutex_unlock(&g_initcall_lock);
+  nxsem_wait_uninterruptible(&g_initcall_sem);
+  nxmutex_lock(&g_initcall_lock);
+}
+
+/****************************************************************************
+ * Name: initcall_broadcast
+ *
+ * Description:
+ *   Wake up all threads waiting in initcall_sleep()
+ *
+ ****************************************************************************/
+
+static void initcall_broadcast(void)
+{
+  for (; g_initcall_nsleep > 0; g_initcall_nsleep--)
+    {
+      nxsem_post(&g_initcall_sem);
+    }
+}
+
+/****************************************************************************
+ * Name: initcall_complete
+ *
+ * Description:
+ *   Record the result of an initializer that will not run (again).
+ *
+ ****************************************************************************/
+
+static void initcall_complete(FAR struct initcall_s *call, int result)
+{
+  call->result = result;
+  call->state  = INITCALL_DONE;
+
+  if ((call->flags & INITCALL_ASYNC) == 0)
+    {
+      g_initcall_nsync--;
+    }
+
+  if (result < 0)
+    {
+      serr("ERROR: initcall %s failed: %d\n", call->name, result);
+    }
+
+  initcall_broadcast();
+}
+
+/****************************************************************************
+ * Name: initcall_next
+ *
+ * Description:
+ *   Return the first pending initializer whose dependencies have all
+ *   completed.  An initializer with a failed dependency is completed with
+ *   -ENODEV instead.
+ *
+ ****************************************************************************/
+
+static FAR struct initcall_s *initcall_next(void)
+{
+  FAR struct initcall_s * const *dep;
+  FAR struct initcall_s *call;
+  int result;
+
+  for (call = g_initcall_head; call != NULL; call = call->flink)
+    {
+      if (call->state != INITCALL_PENDING)
+        {
+          continue;
+        }
+
+      result = OK;
+      for (dep = call->depends; dep != NULL && *dep != NULL; dep++)
+        {
+          if ((*dep)->state != INITCALL_DONE)
+            {
+              break;
+            }
+
+          if ((*dep)->result < 0)
+            {
+              result = -ENODEV;
+            }
+        }
+
+      if (dep != NULL && *dep != NULL)
+        {
+          continue;
+        }
+
+      if (result < 0)
+        {
+          initcall_complete(call, result);
+          continue;
+        }
+
+      return call;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: initcall_worker
+ *
+ * Description:
+ *   The worker thread.  It runs initializers until none are pending.
+ *
+ ****************************************************************************/
+
+static int initcall_worker(int argc, FAR char **argv)
+{
+  FAR struct initcall_s *call;
+  bool pending;
+  int ret;
+
+  nxmutex_lock(&g_initcall_lock);
+  for (; ; )
+    {
+      call = initcall_next();
+      if (call != NULL)
+        {
+          call->state = INITCALL_RUNNING;
+          g_initcall_nrunning++;
+          nxmutex_unlock(&g_initcall_lock);
+
+          sinfo("Running initcall %s\n", call->name);
+          boottime_begin(call->name);
+          ret = call->func();
+          boottime_end(call->name);
+
+          nxmutex_lock(&g_initcall_lock);
+          g_initcall_nrunning--;
+          initcall_complete(call, ret);
+          continue;
+        }
+
+      pending = false;
+      for (call = g_initcall_head; call != NULL; call = call->flink)
+        {
+          if (call->state == INITCALL_PENDING)
+            {
+              pending = true;
+
+              /* Nothing is running and nothing can run:  The dependencies
+               * of this initializer are circular or were never registered.
+               */
+
+              if (g_initcall_nrunning == 0)
+                {
+                  initcall_complete(call, -EDEADLK);
+                }
+            }
+        }
+
+      if (!pending)
+        {
+          break;
+        }
+
+      if (g_initcall_nrunning > 0)
+        {
+          initcall_sleep();
+        }
+    }
+
+  g_initcall_nworkers--;
+  nxmutex_unlock(&g_initcall_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: initcall_spawn
+ *
+ * Description:
+ *   Start another worker thread unless the pool is complete.  Called with
+ *   g_initcall_lock held.
+ *
+ ****************************************************************************/
+
+static void initcall_spawn(void)
+{
+  int pid;
+
+  if (g_initcall_nworkers < CONFIG_INITCALL_NTHREADS)
+    {
+      pid = kthread_create("initcall", CONFIG_INITCALL_PRIORITY,
+                           CONFIG_INITCALL_STACKSIZE, initcall_worker,
+                           NULL);
+      if (pid > 0)
+        {
+          g_initcall_nworkers++;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: initcall_register
+ *
+ * Description:
+ *   Register an initializer.  Initializers registered before the OS
+ *   bring-up are started together by nx_bringup(); later ones are started
+ *   at once.
+ *
+ * Input Parameters:
+ *   call - The initializer.  It must persist until it has completed.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int initcall_register(FAR struct initcall_s *call)
+{
+  DEBUGASSERT(call != NULL && call->func != NULL);
+
+  nxmutex_lock(&g_initcall_lock);
+
+  call->state  = INITCALL_PENDING;
+  call->result = OK;
+  call->flink  = NULL;
+
+  if (g_initcall_tail != NULL)
+    {
+      g_initcall_tail->flink = call;
+    }
+  else
+    {
+      g_initcall_head = call;
+    }
+
+  g_initcall_tail = call;
+
+  if ((call->flags & INITCALL_ASYNC) == 0)
+    {
+      g_initcall_nsync++;
+    }
+
+  if (g_initcall_started)
+    {
+      initcall_spawn();
+      initcall_broadcast();
+    }
+
+  nxmutex_unlock(&g_initcall_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: initcall_wait
+ *
+ * Description:
+ *   Wait for a registered initializer to complete.
+ *
+ * Input Parameters:
+ *   call - The initializer
+ *
+ * Returned Value:
+ *   The value returned by the initializer or the error that prevented it
+ *   from running.
+ *
+ ****************************************************************************/
+
+int initcall_wait(FAR struct initcall_s *call)
+{
+  int ret;
+
+  nxmutex_lock(&g_initcall_lock);
+  while (call->state != INITCALL_DONE)
+    {
+      initcall_sleep();
+    }
+
+  ret = call->result;
+  nxmutex_unlock(&g_initcall_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nx_initcall_start
+ *
+ * Description:
+ *   Start the worker threads for the initializers registered so far.
+ *   Called once by nx_bringup().
+ *
+ ****************************************************************************/
+
+void nx_initcall_start(void)
+{
+  FAR struct initcall_s *call;
+  int n = 0;
+
+  nxmutex_lock(&g_initcall_lock);
+
+  g_initcall_started = true;
+  for (call = g_initcall_head; call != NULL; call = call->flink)
+    {
+      if (n++ < CONFIG_INITCALL_NTHREADS)
+        {
+          initcall_spawn();
+        }
+    }
+
+  nxmutex_unlock(&g_initcall_lock);
+}
+
+/****************************************************************************
+ * Name: nx_initcall_wait
+ *
+ * Description:
+ *   Wait until all initializers not marked INITCALL_ASYNC have completed.
+ *   Called before the init task is started.
+ *
+ ****************************************************************************/
+
+void nx_initcall_wait(void)
+{
+  nxmutex_lock(&g_initcall_lock);
+  while (g_initcall_nsync > 0)
+    {
+      initcall_sleep();
+    }
+
+  nxmutex_unlock(&g_initcall_lock);
+}
+
+#endif /* CONFIG_INITCALL */
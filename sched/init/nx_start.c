@@ -173,7 +173,9 @@ volatile pid_t g_lastpid;
  */
 
 FAR struct tcb_s **g_pidhash;
+rwlock_t g_pidhash_lock = RW_SP_UNLOCKED;
 volatile int g_npidhash;
+int g_npids;
 
 /* This is a table of task lists.  This table is indexed by the task state
  * enumeration type (tstate_t) and provides a pointer to the associated
@@ -321,6 +323,7 @@ void nx_start(void)
   /* Boot up is complete */
 
   g_nx_initstate = OSINIT_BOOT;
+  boottime_begin("nx_start");
 
   /* Initialize RTOS Data ***************************************************/
 
@@ -387,6 +390,12 @@ void nx_start(void)
                                 TCB_FLAG_NONCANCELABLE);
 #endif
 
+#ifdef CONFIG_SCHED_TIMER_SLACK
+      /* All threads inherit their timer slack from the IDLE thread */
+
+      g_idletcb[i].cmn.timerslack = CONFIG_SCHED_TIMER_SLACK_DEFAULT;
+#endif
+
 #if CONFIG_TASK_NAME_SIZE > 0
       /* Set the IDLE task name */
 
@@ -411,7 +420,8 @@ void nx_start(void)
 #endif /* CONFIG_TASK_NAME_SIZE */
 
       /* Then add the idle task's TCB to the head of the current ready to
-       * run list.
+       * run list.  The list is empty, so nxsched_add_prioritized() simply
+       * places it at the head.
        */
 
 #ifdef CONFIG_SMP
@@ -419,7 +429,7 @@ void nx_start(void)
 #else
       tasklist = TLIST_HEAD(&g_idletcb[i].cmn);
 #endif
-      dq_addfirst((FAR dq_entry_t *)&g_idletcb[i], tasklist);
+      nxsched_add_prioritized(&g_idletcb[i].cmn, tasklist);
 
       /* Mark the idle task as the running task */
 
@@ -504,6 +514,7 @@ void nx_start(void)
 
   g_pidhash = kmm_zalloc(sizeof(*g_pidhash) * g_npidhash);
   DEBUGASSERT(g_pidhash);
+  g_npids = CONFIG_SMP_NCPUS;
 
   /* IDLE Group Initialization **********************************************/
 
@@ -569,7 +580,9 @@ void nx_start(void)
 
   /* Initialize the file system (needed to support device drivers) */
 
+  boottime_begin("fs_initialize");
   fs_initialize();
+  boottime_end("fs_initialize");
 
   /* Initialize the interrupt handling subsystem (if included) */
 
@@ -602,7 +615,9 @@ void nx_start(void)
 #ifdef CONFIG_NET
   /* Initialize the networking system */
 
+  boottime_begin("net_initialize");
   net_initialize();
+  boottime_end("net_initialize");
 #endif
 
 #ifndef CONFIG_BINFMT_DISABLE
@@ -619,11 +634,15 @@ void nx_start(void)
    * that are different for each  processor and hardware platform.
    */
 
+  boottime_begin("up_initialize");
   up_initialize();
+  boottime_end("up_initialize");
 
   /* Initialize common drivers */
 
+  boottime_begin("drivers_initialize");
   drivers_initialize();
+  boottime_end("drivers_initialize");
 
 #ifdef CONFIG_BOARD_EARLY_INITIALIZE
   /* Call the board-specific up_initialize() extension to support
@@ -631,7 +650,9 @@ void nx_start(void)
    * that cannot wait until board_late_initialize.
    */
 
+  boottime_begin("board_early_initialize");
   board_early_initialize();
+  boottime_end("board_early_initialize");
 #endif
 
   /* Hardware resources are now available */
@@ -674,7 +695,9 @@ void nx_start(void)
 
   /* Then start the other CPUs */
 
+  boottime_begin("nx_smp_start");
   DEBUGVERIFY(nx_smp_start());
+  boottime_end("nx_smp_start");
 
 #endif /* CONFIG_SMP */
 
@@ -687,6 +710,7 @@ void nx_start(void)
   /* Create initial tasks and bring-up the system */
 
   DEBUGVERIFY(nx_bringup());
+  boottime_end("nx_start");
 
   /* Enter to idleloop */
 
@@ -68,6 +68,15 @@ struct irq_info_s
 #endif
   uint32_t time;     /* Maximum execution time on this IRQ */
 #endif
+#ifdef CONFIG_SCHED_IRQMONITOR_HIST
+  /* Histograms of handler durations and of entry latencies */
+
+  uint32_t hist[CONFIG_SCHED_IRQMONITOR_NHIST];
+#ifdef CONFIG_ARCH_HAVE_IRQ_TIMESTAMP
+  uint32_t lathist[CONFIG_SCHED_IRQMONITOR_NHIST];
+  uint32_t latmax;   /* Maximum entry latency on this IRQ */
+#endif
+#endif
 };
 
 #ifdef CONFIG_SCHED_IRQMONITOR
@@ -122,6 +131,21 @@ extern volatile cpu_set_t g_cpu_irqset;
 extern volatile uint8_t g_cpu_nestcount[CONFIG_SMP_NCPUS];
 #endif
 
+#ifdef CONFIG_SCHED_IRQMONITOR_HIST
+/* Histogram buckets are powers of two of 1 << g_irq_hist_shift counts of
+ * up_perf_gettime(), that is of roughly one microsecond.
+ */
+
+extern uint8_t g_irq_hist_shift;
+
+/* Time spent in interrupt handlers by each CPU, in up_perf_gettime()
+ * counts, since g_irq_cpustart (in clock ticks).
+ */
+
+extern uint64_t g_irq_cputime[CONFIG_SMP_NCPUS];
+extern clock_t g_irq_cpustart;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -218,6 +242,19 @@ bool is_irqchain(int ndx, xcpt_t isr);
 int irqchain_attach(int ndx, xcpt_t isr, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: irq_thread_affinity
+ *
+ * Description:
+ *   Restrict the handler thread of 'irq', if it has one, to the CPUs in
+ *   'cpuset'.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_IRQ_THREAD) && defined(CONFIG_SMP)
+int irq_thread_affinity(int irq, FAR const cpu_set_t *cpuset);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,70 @@
+/****************************************************************************
+ * sched/irq/irq_affinity.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+
+#include "irq/irq.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_set_affinity
+ *
+ * Description:
+ *   Route IRQ number 'irq' to the CPUs in 'cpuset' with up_affinity_irq().
+ *   If the IRQ has a handler thread attached with irq_attach_thread(), the
+ *   thread is restricted to the same CPUs, so that all of its interrupt
+ *   load stays off the other CPUs.
+ *
+ * Input Parameters:
+ *   irq    - The IRQ number
+ *   cpuset - The CPUs that may take the interrupt
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_set_affinity(int irq, cpu_set_t cpuset)
+{
+  if ((unsigned)irq >= NR_IRQS || cpuset == 0)
+    {
+      return -EINVAL;
+    }
+
+  up_affinity_irq(irq, cpuset);
+
+#ifdef CONFIG_IRQ_THREAD
+  return irq_thread_affinity(irq, &cpuset);
+#else
+  return OK;
+#endif
+}
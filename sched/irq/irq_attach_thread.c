@@ -0,0 +1,335 @@
+/****************************************************************************
+ * sched/irq/irq_attach_thread.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+
+#include "irq/irq.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE
+#  define IRQ_THREAD_NVECTORS CONFIG_ARCH_NUSER_INTERRUPTS
+#else
+#  define IRQ_THREAD_NVECTORS NR_IRQS
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct irq_thread_s
+{
+  xcpt_t isr;       /* Top half, may be NULL */
+  xcpt_t isrthread; /* Bottom half */
+  FAR void *arg;    /* Argument of both */
+  int irq;          /* IRQ number */
+  sem_t sem;        /* Posted by the top half to wake the thread */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The handler thread of each IRQ, 0 if none */
+
+static pid_t g_irq_thread_pid[IRQ_THREAD_NVECTORS];
+static FAR struct irq_thread_s *g_irq_thread_info[IRQ_THREAD_NVECTORS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_thread_ndx
+ *
+ * Description:
+ *   Return the vector table index of 'irq', or a negated errno value.
+ *
+ ****************************************************************************/
+
+static int irq_thread_ndx(int irq)
+{
+  int ndx;
+
+  if ((unsigned)irq >= NR_IRQS)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_ARCH_MINIMAL_VECTORTABLE
+  ndx = g_irqmap[irq];
+  if ((unsigned)ndx >= CONFIG_ARCH_NUSER_INTERRUPTS)
+    {
+      return -EINVAL;
+    }
+#else
+  ndx = irq;
+#endif
+
+  return ndx;
+}
+
+/****************************************************************************
+ * Name: irq_thread_isr
+ *
+ * Description:
+ *   The handler actually attached to the IRQ.  Calls the top half, if any,
+ *   and wakes the thread when asked to.
+ *
+ ****************************************************************************/
+
+static int irq_thread_isr(int irq, FAR void *context, FAR void *arg)
+{
+  FAR struct irq_thread_s *info = arg;
+  int ret = IRQ_WAKE_THREAD;
+
+  if (info->isr != NULL)
+    {
+      ret = info->isr(irq, context, info->arg);
+    }
+  else
+    {
+      /* Nothing has quieted the device yet.  Keep the IRQ off until the
+       * thread has dealt with it, or a level triggered interrupt would
+       * never let the thread run.
+       */
+
+      up_disable_irq(irq);
+    }
+
+  if (ret == IRQ_WAKE_THREAD)
+    {
+      nxsem_post(&info->sem);
+      ret = OK;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: irq_thread_main
+ *
+ * Description:
+ *   The handler thread: runs the bottom half every time the top half
+ *   posts the semaphore.
+ *
+ ****************************************************************************/
+
+static int irq_thread_main(int argc, FAR char *argv[])
+{
+  FAR struct irq_thread_s *info;
+
+  DEBUGASSERT(argc == 2);
+  info = (FAR struct irq_thread_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
+
+  for (; ; )
+    {
+      if (nxsem_wait_uninterruptible(&info->sem) < 0)
+        {
+          continue;
+        }
+
+      info->isrthread(info->irq, NULL, info->arg);
+
+      if (info->isr == NULL)
+        {
+          up_enable_irq(info->irq);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: irq_thread_detach
+ ****************************************************************************/
+
+static int irq_thread_detach(int irq, int ndx)
+{
+  FAR struct irq_thread_s *info;
+  irqstate_t flags;
+  pid_t pid;
+
+  flags = enter_critical_section();
+  pid  = g_irq_thread_pid[ndx];
+  info = g_irq_thread_info[ndx];
+  g_irq_thread_pid[ndx]  = 0;
+  g_irq_thread_info[ndx] = NULL;
+  leave_critical_section(flags);
+
+  if (pid == 0)
+    {
+      return -ENOENT;
+    }
+
+  irqchain_detach(irq, irq_thread_isr, info);
+  kthread_delete(pid);
+
+  nxsem_destroy(&info->sem);
+  kmm_free(info);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irq_attach_thread
+ *
+ * Description:
+ *   Attach a threaded interrupt handler to IRQ number 'irq'.  'isr' runs
+ *   in interrupt context and returns IRQ_WAKE_THREAD to have 'isrthread'
+ *   run in a dedicated kernel thread of the given priority.  'isr' may be
+ *   NULL; then the IRQ is disabled on every interrupt and enabled again
+ *   once 'isrthread' has run.  Passing a NULL 'isrthread' detaches the
+ *   handler and deletes the thread.
+ *
+ *   The IRQ is not enabled here; the driver calls up_enable_irq() as it
+ *   would after irq_attach().
+ *
+ * Input Parameters:
+ *   irq        - The IRQ number
+ *   isr        - Top half, called in interrupt context; may be NULL
+ *   isrthread  - Bottom half, called in the thread
+ *   arg        - Argument passed to both
+ *   priority   - Priority of the thread
+ *   stack_size - Stack size of the thread
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int irq_attach_thread(int irq, xcpt_t isr, xcpt_t isrthread,
+                      FAR void *arg, int priority, int stack_size)
+{
+  FAR struct irq_thread_s *info;
+  FAR char *argv[2];
+  char name[16];
+  char hex[2 * sizeof(uintptr_t) + 1];
+  pid_t pid;
+  int ndx;
+  int ret;
+
+  ndx = irq_thread_ndx(irq);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  if (isrthread == NULL)
+    {
+      return irq_thread_detach(irq, ndx);
+    }
+
+  if (g_irq_thread_pid[ndx] != 0)
+    {
+      return -EBUSY;
+    }
+
+  info = kmm_zalloc(sizeof(*info));
+  if (info == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  info->isr       = isr;
+  info->isrthread = isrthread;
+  info->arg       = arg;
+  info->irq       = irq;
+  nxsem_init(&info->sem, 0, 0);
+
+  snprintf(name, sizeof(name), "irq%d", irq);
+  snprintf(hex, sizeof(hex), "%" PRIxPTR, (uintptr_t)info);
+  argv[0] = hex;
+  argv[1] = NULL;
+
+  pid = kthread_create(name, priority, stack_size, irq_thread_main, argv);
+  if (pid < 0)
+    {
+      ret = pid;
+      goto errout;
+    }
+
+  ret = irq_attach(irq, irq_thread_isr, info);
+  if (ret < 0)
+    {
+      kthread_delete(pid);
+      goto errout;
+    }
+
+  g_irq_thread_pid[ndx]  = pid;
+  g_irq_thread_info[ndx] = info;
+  return OK;
+
+errout:
+  nxsem_destroy(&info->sem);
+  kmm_free(info);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: irq_thread_affinity
+ *
+ * Description:
+ *   Restrict the handler thread of 'irq', if it has one, to the CPUs in
+ *   'cpuset'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+int irq_thread_affinity(int irq, FAR const cpu_set_t *cpuset)
+{
+  int ndx;
+
+  ndx = irq_thread_ndx(irq);
+  if (ndx < 0)
+    {
+      return ndx;
+    }
+
+  if (g_irq_thread_pid[ndx] == 0)
+    {
+      return OK;
+    }
+
+  return nxsched_set_affinity(g_irq_thread_pid[ndx], sizeof(cpu_set_t),
+                              cpuset);
+}
+#endif
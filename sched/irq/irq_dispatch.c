@@ -25,6 +25,9 @@
 #include <nuttx/config.h>
 
 #include <debug.h>
+#include <strings.h>
+#include <unistd.h>
+
 #include <nuttx/arch.h>
 #include <nuttx/irq.h>
 #include <nuttx/mm/mm.h>
@@ -68,6 +71,15 @@
      while (0)
 #endif
 
+/* IRQ_HIST - Record the duration and entry latency of this interrupt */
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HIST
+#  define IRQ_HIST(ndx, irq, start, elapsed) \
+     irq_hist(ndx, irq, start, elapsed)
+#else
+#  define IRQ_HIST(ndx, irq, start, elapsed)
+#endif
+
 /* CALL_VECTOR - Call the interrupt service routine attached to this
  * interrupt request
  */
@@ -92,6 +104,7 @@
                { \
                  g_irqvector[ndx].time = elapsed; \
                } \
+             IRQ_HIST(ndx, irq, start, elapsed); \
            } \
          if (CONFIG_SCHED_CRITMONITOR_MAXTIME_IRQ > 0 && \
              elapsed > CONFIG_SCHED_CRITMONITOR_MAXTIME_IRQ) \
@@ -106,6 +119,112 @@
      vector(irq, context, arg)
 #endif /* CONFIG_SCHED_IRQMONITOR */
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HIST
+/* Histogram buckets are powers of two of 1 << g_irq_hist_shift counts of
+ * up_perf_gettime(), that is of roughly one microsecond.  UINT8_MAX until
+ * the counter frequency is known.
+ */
+
+uint8_t g_irq_hist_shift = UINT8_MAX;
+
+/* Time spent in interrupt handlers by each CPU, in up_perf_gettime()
+ * counts, since g_irq_cpustart (in clock ticks).
+ */
+
+uint64_t g_irq_cputime[CONFIG_SMP_NCPUS];
+clock_t g_irq_cpustart;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HIST
+/****************************************************************************
+ * Name: irq_hist_bucket
+ *
+ * Description:
+ *   Return the histogram bucket of a time in up_perf_gettime() counts.
+ *   Only a shift and a count of leading zeros, no division.
+ *
+ ****************************************************************************/
+
+static inline int irq_hist_bucket(unsigned long elapsed)
+{
+  int bucket;
+
+  elapsed >>= g_irq_hist_shift;
+  bucket = elapsed != 0 ? flsl(elapsed) : 0;
+
+  return bucket < CONFIG_SCHED_IRQMONITOR_NHIST ?
+         bucket : CONFIG_SCHED_IRQMONITOR_NHIST - 1;
+}
+
+/****************************************************************************
+ * Name: irq_hist
+ *
+ * Description:
+ *   Account one run of the handler of vector table entry 'ndx'.
+ *
+ ****************************************************************************/
+
+static void irq_hist(unsigned int ndx, int irq, unsigned long start,
+                     unsigned long elapsed)
+{
+  FAR struct irq_info_s *info = &g_irqvector[ndx];
+#ifdef CONFIG_ARCH_HAVE_IRQ_TIMESTAMP
+  unsigned long raised;
+#endif
+
+  if (g_irq_hist_shift == UINT8_MAX)
+    {
+      unsigned long freq = up_perf_getfreq();
+
+      if (freq < USEC_PER_SEC)
+        {
+          return;
+        }
+
+      /* The largest power of two that is at most one microsecond */
+
+      g_irq_hist_shift = flsl(freq / USEC_PER_SEC) - 1;
+    }
+
+  info->hist[irq_hist_bucket(elapsed)]++;
+  g_irq_cputime[this_cpu()] += elapsed;
+
+#ifdef CONFIG_ARCH_HAVE_IRQ_TIMESTAMP
+  raised = up_irq_timestamp(irq);
+  if (raised != 0)
+    {
+      unsigned long latency = start - raised;
+
+      info->lathist[irq_hist_bucket(latency)]++;
+      if (latency > info->latmax)
+        {
+          info->latmax = latency;
+        }
+    }
+#endif
+
+#if CONFIG_SCHED_IRQMONITOR_NOTE > 0
+  if ((elapsed >> g_irq_hist_shift) > CONFIG_SCHED_IRQMONITOR_NOTE)
+    {
+      struct timespec ts;
+
+      up_perf_convert(elapsed, &ts);
+      sched_note_printf(NOTE_TAG_SCHED, "C|%d|irq%d|%lu", gettid(), irq,
+                        (unsigned long)(ts.tv_sec * USEC_PER_SEC +
+                                        ts.tv_nsec / NSEC_PER_USEC));
+    }
+#endif
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
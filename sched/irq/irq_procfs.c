@@ -58,15 +58,41 @@
  * may not be wide enough.
  */
 
-#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME\n"
-#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu\n"
+#define HDR_FMT "IRQ HANDLER  ARGUMENT    COUNT    RATE    TIME"
+#define IRQ_FMT "%3u %08lx %08lx %10lu %4lu.%03lu %4lu"
+
+/* With CONFIG_SCHED_IRQMONITOR_HIST each line goes on with the number of
+ * handler runs in each duration bucket, then, if the architecture reports
+ * when interrupts are raised, the maximum entry latency (usec) and the
+ * number of interrupts in each latency bucket.  The header names each
+ * bucket by its upper limit in usec.  After the last IRQ follows one line
+ * per CPU with the share of time spent in interrupt handlers:
+ *
+ *   CPU  IRQLOAD
+ *   DDD DDD.DDD%
+ */
+
+#define HIST_FMT " %6lu"
+#define LAT_FMT  " %6lu"
+#define LOAD_HDR "CPU  IRQLOAD\n"
+#define LOAD_FMT "%3d %3lu.%03lu%%\n"
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HIST
+#  ifdef CONFIG_ARCH_HAVE_IRQ_TIMESTAMP
+#    define IRQ_NHIST (2 * CONFIG_SCHED_IRQMONITOR_NHIST + 1)
+#  else
+#    define IRQ_NHIST CONFIG_SCHED_IRQMONITOR_NHIST
+#  endif
+#else
+#  define IRQ_NHIST 0
+#endif
 
 /* Determines the size of an intermediate buffer that must be large enough
  * to handle the longest line generated by this logic (plus a couple of
  * bytes).
  */
 
-#define IRQ_LINELEN 50
+#define IRQ_LINELEN (50 + 8 * IRQ_NHIST)
 
 /****************************************************************************
  * Private Types
@@ -92,6 +118,7 @@ struct irq_file_s
 
 static int     irq_callback(int irq, FAR struct irq_info_s *info,
                  FAR void *arg);
+static void    irq_output(FAR struct irq_file_s *irqfile, size_t linesize);
 
 /* File system methods */
 
@@ -148,10 +175,12 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   clock_t elapsed;
   clock_t now;
   size_t linesize;
-  size_t copysize;
   unsigned long intpart;
   unsigned long fracpart;
   unsigned long count;
+#ifdef CONFIG_SCHED_IRQMONITOR_HIST
+  int i;
+#endif
 
   DEBUGASSERT(irqfile != NULL);
 
@@ -168,6 +197,13 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
   info->lscount = 0;
 #endif
   info->time    = 0;
+#ifdef CONFIG_SCHED_IRQMONITOR_HIST
+  memset(info->hist, 0, sizeof(info->hist));
+#ifdef CONFIG_ARCH_HAVE_IRQ_TIMESTAMP
+  memset(info->lathist, 0, sizeof(info->lathist));
+  info->latmax  = 0;
+#endif
+#endif
   leave_critical_section(flags);
 
   /* Don't bother if count == 0.
@@ -245,12 +281,33 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
                       count, intpart, fracpart,
                       (unsigned long)delta.tv_nsec / 1000);
 
-  copysize  = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
-                            irqfile->remaining, &irqfile->offset);
+#ifdef CONFIG_SCHED_IRQMONITOR_HIST
+  for (i = 0; i < CONFIG_SCHED_IRQMONITOR_NHIST; i++)
+    {
+      linesize += snprintf(irqfile->line + linesize,
+                           IRQ_LINELEN - linesize, HIST_FMT,
+                           (unsigned long)copy.hist[i]);
+    }
+
+#ifdef CONFIG_ARCH_HAVE_IRQ_TIMESTAMP
+  up_perf_convert(copy.latmax, &delta);
+  linesize += snprintf(irqfile->line + linesize, IRQ_LINELEN - linesize,
+                       LAT_FMT, (unsigned long)(delta.tv_sec * 1000000 +
+                                                delta.tv_nsec / 1000));
 
-  irqfile->ncopied   += copysize;
-  irqfile->buffer    += copysize;
-  irqfile->remaining -= copysize;
+  for (i = 0; i < CONFIG_SCHED_IRQMONITOR_NHIST; i++)
+    {
+      linesize += snprintf(irqfile->line + linesize,
+                           IRQ_LINELEN - linesize, HIST_FMT,
+                           (unsigned long)copy.lathist[i]);
+    }
+#endif
+#endif
+
+  linesize += snprintf(irqfile->line + linesize, IRQ_LINELEN - linesize,
+                       "\n");
+
+  irq_output(irqfile, linesize);
 
   /* Return a non-zero value to stop the traversal if the user-provided
    * buffer is full.
@@ -266,6 +323,138 @@ static int irq_callback(int irq, FAR struct irq_info_s *info,
     }
 }
 
+/****************************************************************************
+ * Name: irq_output
+ *
+ * Description:
+ *   Copy the line in irqfile->line to the user buffer, skipping what
+ *   precedes the file offset.
+ *
+ ****************************************************************************/
+
+static void irq_output(FAR struct irq_file_s *irqfile, size_t linesize)
+{
+  size_t copysize;
+
+  copysize = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
+                           irqfile->remaining, &irqfile->offset);
+
+  irqfile->ncopied   += copysize;
+  irqfile->buffer    += copysize;
+  irqfile->remaining -= copysize;
+}
+
+#ifdef CONFIG_SCHED_IRQMONITOR_HIST
+/****************************************************************************
+ * Name: irq_hist_header
+ *
+ * Description:
+ *   Append the names of the histogram columns, the upper limit in usec of
+ *   each bucket, to the header line.
+ *
+ ****************************************************************************/
+
+static size_t irq_hist_header(FAR char *line, size_t linesize)
+{
+  struct timespec ts;
+  unsigned long usec;
+  char name[8];
+  int pass;
+  int i;
+
+  for (pass = 0; pass < IRQ_NHIST / CONFIG_SCHED_IRQMONITOR_NHIST; pass++)
+    {
+      if (pass > 0)
+        {
+          linesize += snprintf(line + linesize, IRQ_LINELEN - linesize,
+                               " %6s", "LATMAX");
+        }
+
+      for (i = 0; i < CONFIG_SCHED_IRQMONITOR_NHIST; i++)
+        {
+          if (g_irq_hist_shift == UINT8_MAX)
+            {
+              /* The counter frequency is not known yet */
+
+              snprintf(name, sizeof(name), "H%d", i);
+            }
+          else
+            {
+              up_perf_convert(1ul << (g_irq_hist_shift + i), &ts);
+              usec = ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+
+              snprintf(name, sizeof(name), "%s%lu",
+                       i < CONFIG_SCHED_IRQMONITOR_NHIST - 1 ? "<" : ">=",
+                       i < CONFIG_SCHED_IRQMONITOR_NHIST - 1 ?
+                       usec : usec / 2);
+            }
+
+          linesize += snprintf(line + linesize, IRQ_LINELEN - linesize,
+                               " %6s", name);
+        }
+    }
+
+  return linesize;
+}
+
+/****************************************************************************
+ * Name: irq_load
+ *
+ * Description:
+ *   Output the share of time each CPU spent in interrupt handlers since
+ *   the last time, and start over.
+ *
+ ****************************************************************************/
+
+static void irq_load(FAR struct irq_file_s *irqfile)
+{
+  uint64_t cputime[CONFIG_SMP_NCPUS];
+  struct timespec ts;
+  irqstate_t flags;
+  clock_t elapsed;
+  uint64_t total;
+  uint64_t busy;
+  unsigned long permille;
+  int cpu;
+
+  flags   = enter_critical_section();
+  memcpy(cputime, g_irq_cputime, sizeof(cputime));
+  memset(g_irq_cputime, 0, sizeof(g_irq_cputime));
+  elapsed = clock_systime_ticks() - g_irq_cpustart;
+  g_irq_cpustart += elapsed;
+  leave_critical_section(flags);
+
+  irq_output(irqfile, snprintf(irqfile->line, IRQ_LINELEN, LOAD_HDR));
+
+  total = (uint64_t)(elapsed ? elapsed : 1) * USEC_PER_TICK;
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      /* Convert in pieces that fit the elapsed time argument */
+
+      busy = 0;
+      while (cputime[cpu] > 0)
+        {
+          unsigned long part = cputime[cpu] > ULONG_MAX / 2 ?
+                               ULONG_MAX / 2 : (unsigned long)cputime[cpu];
+
+          up_perf_convert(part, &ts);
+          busy += (uint64_t)ts.tv_sec * USEC_PER_SEC +
+                  ts.tv_nsec / NSEC_PER_USEC;
+          cputime[cpu] -= part;
+        }
+
+      permille = busy * 100000 / total;
+      if (permille > 100000)
+        {
+          permille = 100000;
+        }
+
+      irq_output(irqfile, snprintf(irqfile->line, IRQ_LINELEN, LOAD_FMT,
+                                   cpu, permille / 1000, permille % 1000));
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: irq_open
  ****************************************************************************/
@@ -331,7 +520,6 @@ static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
 {
   FAR struct irq_file_s *irqfile;
   size_t linesize;
-  size_t copysize;
 
   finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
 
@@ -348,20 +536,27 @@ static ssize_t irq_read(FAR struct file *filep, FAR char *buffer,
 
   /* The first line to output is the header */
 
+  irqfile->ncopied = 0;
   linesize = snprintf(irqfile->line, IRQ_LINELEN, HDR_FMT);
-
-  copysize = procfs_memcpy(irqfile->line, linesize, irqfile->buffer,
-                           irqfile->remaining, &irqfile->offset);
-
-  irqfile->ncopied    = copysize;
-  irqfile->buffer    += copysize;
-  irqfile->remaining -= copysize;
+#ifdef CONFIG_SCHED_IRQMONITOR_HIST
+  linesize = irq_hist_header(irqfile->line, linesize);
+#endif
+  linesize += snprintf(irqfile->line + linesize, IRQ_LINELEN - linesize,
+                       "\n");
+  irq_output(irqfile, linesize);
 
   /* Now traverse the list of attached interrupts, generating output for
    * each.
    */
 
-  irq_foreach(irq_callback, (FAR void *)irqfile);
+  if (irq_foreach(irq_callback, (FAR void *)irqfile) == 0)
+    {
+#ifdef CONFIG_SCHED_IRQMONITOR_HIST
+      /* Then the interrupt load of each CPU */
+
+      irq_load(irqfile);
+#endif
+    }
 
   /* Update the file position */
 
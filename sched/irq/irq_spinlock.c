@@ -209,4 +209,75 @@ void spin_unlock_irqrestore_wo_note(spinlock_t *lock, irqstate_t flags)
   up_irq_restore(flags);
 }
 
+/****************************************************************************
+ * Name: read_lock_irqsave
+ *
+ * Description:
+ *   Disable local interrupts and take a reader reference on the rwlock.
+ *
+ * Input Parameters:
+ *   lock - A reference to the rwlock object.
+ *
+ * Returned Value:
+ *   An opaque, architecture-specific value that represents the state of
+ *   the interrupts prior to the call to read_lock_irqsave(lock);
+ *
+ ****************************************************************************/
+
+irqstate_t read_lock_irqsave(rwlock_t *lock)
+{
+  irqstate_t ret;
+
+  ret = up_irq_save();
+  read_lock(lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: read_unlock_irqrestore
+ *
+ * Description:
+ *   Release a reader reference and restore the interrupt state as it was
+ *   prior to the previous call to read_lock_irqsave(lock).
+ *
+ ****************************************************************************/
+
+void read_unlock_irqrestore(rwlock_t *lock, irqstate_t flags)
+{
+  read_unlock(lock);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: write_lock_irqsave
+ *
+ * Description:
+ *   Disable local interrupts and take the rwlock exclusively.
+ *
+ ****************************************************************************/
+
+irqstate_t write_lock_irqsave(rwlock_t *lock)
+{
+  irqstate_t ret;
+
+  ret = up_irq_save();
+  write_lock(lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: write_unlock_irqrestore
+ *
+ * Description:
+ *   Release the rwlock and restore the interrupt state as it was prior to
+ *   the previous call to write_lock_irqsave(lock).
+ *
+ ****************************************************************************/
+
+void write_unlock_irqrestore(rwlock_t *lock, irqstate_t flags)
+{
+  write_unlock(lock);
+  up_irq_restore(flags);
+}
+
 #endif /* CONFIG_SMP */
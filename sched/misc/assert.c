@@ -28,6 +28,7 @@
 #include <nuttx/binfmt/binfmt.h>
 #include <nuttx/board.h>
 #include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
 #include <nuttx/tls.h>
 #include <nuttx/signal.h>
 
@@ -38,6 +39,8 @@
 
 #include <assert.h>
 #include <debug.h>
+#include <elf.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <sys/utsname.h>
@@ -77,9 +80,29 @@ static uintptr_t g_last_regs[XCPTCONTEXT_REGS] aligned_data(16);
 #ifdef CONFIG_BOARD_COREDUMP
 static struct lib_syslogstream_s  g_syslogstream;
 static struct lib_hexdumpstream_s g_hexstream;
-#  ifdef CONFIG_BOARD_COREDUMP_COMPRESSION
+#  ifdef CONFIG_BOARD_COREDUMP_LZ4
+static struct lib_lz4outstream_s  g_lz4stream;
+#  elif defined(CONFIG_BOARD_COREDUMP_COMPRESSION)
 static struct lib_lzfoutstream_s  g_lzfstream;
 #  endif
+
+#  ifdef CONFIG_BOARD_COREDUMP_HEAP
+/* The allocated heap chunks, terminated by an empty region */
+
+static struct memory_region_s
+g_dumpregions[CONFIG_BOARD_COREDUMP_NREGIONS + 1];
+static size_t g_ndumpregions;
+#  endif
+
+#  ifdef CONFIG_BOARD_COREDUMP_DEVPATH
+/* The device opened by coredump_initialize(), if any */
+
+#    ifdef CONFIG_MTD
+static struct lib_mtdoutstream_s  g_mtdstream;
+#    endif
+static struct lib_blkoutstream_s  g_blkstream;
+static FAR struct lib_outstream_s *g_devstream;
+#  endif
 #endif
 
 static FAR const char *g_policy[4] =
@@ -469,6 +492,52 @@ static void dump_tasks(void)
 #endif
 }
 
+/****************************************************************************
+ * Name: dump_heapchunk
+ *
+ * Description:
+ *   Add an allocated heap chunk to the core dump regions.  Adjacent chunks
+ *   are merged.  When the regions run out, the last one is extended over
+ *   the chunks that follow it.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOARD_COREDUMP_HEAP
+static void dump_heapchunk(FAR void *mem, size_t size, bool used,
+                           FAR void *arg)
+{
+  FAR struct memory_region_s *region;
+  uintptr_t start = (uintptr_t)mem;
+
+  if (!used)
+    {
+      return;
+    }
+
+  if (g_ndumpregions > 0)
+    {
+      region = &g_dumpregions[g_ndumpregions - 1];
+      if (region->end == start ||
+          (g_ndumpregions == CONFIG_BOARD_COREDUMP_NREGIONS &&
+           region->start < start))
+        {
+          region->end = start + size;
+          return;
+        }
+
+      if (g_ndumpregions == CONFIG_BOARD_COREDUMP_NREGIONS)
+        {
+          return;
+        }
+    }
+
+  region        = &g_dumpregions[g_ndumpregions++];
+  region->start = start;
+  region->end   = start + size;
+  region->flags = PF_R | PF_W;
+}
+#endif
+
 /****************************************************************************
  * Name: dump_core
  ****************************************************************************/
@@ -476,6 +545,7 @@ static void dump_tasks(void)
 #ifdef CONFIG_BOARD_COREDUMP
 static void dump_core(pid_t pid)
 {
+  FAR struct memory_region_s *regions = NULL;
   FAR void *stream;
   int logmask;
 
@@ -483,17 +553,33 @@ static void dump_core(pid_t pid)
 
   _alert("Start coredump:\n");
 
-  /* Initialize hex output stream */
+#  ifdef CONFIG_BOARD_COREDUMP_DEVPATH
+  if (g_devstream != NULL)
+    {
+      stream = g_devstream;
+    }
+  else
+#  endif
+    {
+      /* Initialize hex output stream */
 
-  lib_syslogstream(&g_syslogstream, LOG_EMERG);
+      lib_syslogstream(&g_syslogstream, LOG_EMERG);
 
-  stream = &g_syslogstream;
+      stream = &g_syslogstream;
 
-  lib_hexdumpstream(&g_hexstream, stream);
+      lib_hexdumpstream(&g_hexstream, stream);
 
-  stream = &g_hexstream;
+      stream = &g_hexstream;
+    }
 
-#  ifdef CONFIG_BOARD_COREDUMP_COMPRESSION
+#  ifdef CONFIG_BOARD_COREDUMP_LZ4
+
+  /* Initialize LZ4 compression stream */
+
+  lib_lz4outstream(&g_lz4stream, stream);
+  stream = &g_lz4stream;
+
+#  elif defined(CONFIG_BOARD_COREDUMP_COMPRESSION)
 
   /* Initialize LZF compression stream */
 
@@ -502,9 +588,27 @@ static void dump_core(pid_t pid)
 
 #  endif
 
+#  ifdef CONFIG_BOARD_COREDUMP_HEAP
+  /* Collect the allocated heap chunks.  The heap is walked without its
+   * lock, which the crashed task may hold.
+   */
+
+  g_ndumpregions = 0;
+#    ifndef CONFIG_BUILD_KERNEL
+  mm_walk(USR_HEAP, dump_heapchunk, NULL);
+#    endif
+#    ifdef CONFIG_MM_KERNEL_HEAP
+  mm_walk(g_kmmheap, dump_heapchunk, NULL);
+#    endif
+
+  g_dumpregions[g_ndumpregions].start = 0;
+  g_dumpregions[g_ndumpregions].end   = 0;
+  regions = g_dumpregions;
+#  endif
+
   /* Do core dump */
 
-  core_dump(NULL, stream, pid);
+  core_dump(regions, stream, pid);
 
 #  ifdef CONFIG_BOARD_COREDUMP_COMPRESSION
   _alert("Finish coredump (Compression Enabled).\n");
@@ -545,6 +649,60 @@ static void dump_deadlock(void)
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: coredump_initialize
+ *
+ * Description:
+ *   Open CONFIG_BOARD_COREDUMP_DEVPATH, so that the core dump is written
+ *   there instead of the syslog.  The device cannot be opened when the
+ *   system crashes, as the crashed task may hold the locks involved.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BOARD_COREDUMP
+int coredump_initialize(void)
+{
+#  ifdef CONFIG_BOARD_COREDUMP_DEVPATH
+  int ret;
+
+  if (g_devstream != NULL)
+    {
+      return OK;
+    }
+
+  if (CONFIG_BOARD_COREDUMP_DEVPATH[0] == '\0')
+    {
+      return -ENODEV;
+    }
+
+#    ifdef CONFIG_MTD
+  ret = lib_mtdoutstream_open(&g_mtdstream, CONFIG_BOARD_COREDUMP_DEVPATH);
+  if (ret >= 0)
+    {
+      g_devstream = &g_mtdstream.public;
+      return OK;
+    }
+#    endif
+
+  ret = lib_blkoutstream_open(&g_blkstream, CONFIG_BOARD_COREDUMP_DEVPATH);
+  if (ret < 0)
+    {
+      serr("ERROR: Failed to open %s: %d\n",
+           CONFIG_BOARD_COREDUMP_DEVPATH, ret);
+      return ret;
+    }
+
+  g_devstream = &g_blkstream.public;
+  return OK;
+#  else
+  return -ENODEV;
+#  endif
+}
+#endif
+
 /****************************************************************************
  * Name: _assert
  ****************************************************************************/
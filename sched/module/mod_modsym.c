@@ -94,8 +94,17 @@ FAR const void *modsym(FAR void *handle, FAR const char *name)
 
   /* Search the symbol table for the matching symbol */
 
-  symbol = symtab_findbyname(modp->modinfo.exports, name,
-                             modp->modinfo.nexports);
+  if (modp->exphash != NULL)
+    {
+      symbol = symtab_findbyhash(modp->modinfo.exports, modp->exphash,
+                                 name, modp->modinfo.nexports);
+    }
+  else
+    {
+      symbol = symtab_findbyname(modp->modinfo.exports, name,
+                                 modp->modinfo.nexports);
+    }
+
   if (symbol == NULL)
     {
       berr("ERROR: Failed to find symbol in symbol \"%s\" in table\n", name);
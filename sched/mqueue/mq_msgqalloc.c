@@ -104,6 +104,20 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
 
       dq_init(&msgq->cmn.waitfornotempty);
       dq_init(&msgq->cmn.waitfornotfull);
+
+#ifdef CONFIG_MQ_RINGBUF
+      /* Use a lock-free ring of fixed size slots if so requested */
+
+      if (attr && (attr->mq_flags & MQ_RINGBUF) != 0)
+        {
+          int ret = nxmq_ring_alloc(msgq);
+          if (ret < 0)
+            {
+              kmm_free(msgq);
+              return ret;
+            }
+        }
+#endif
     }
   else
     {
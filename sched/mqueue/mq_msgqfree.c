@@ -66,6 +66,15 @@ void nxmq_free_msgq(FAR struct mqueue_inode_s *msgq)
       nxmq_free_msg(entry);
     }
 
+#ifdef CONFIG_MQ_RINGBUF
+  /* Messages in the ring need no deallocation, only the ring itself */
+
+  if (msgq->ring != NULL)
+    {
+      kmm_free(msgq->ring);
+    }
+#endif
+
   /* Then deallocate the message queue itself */
 
   kmm_free(msgq);
@@ -92,6 +92,23 @@ ssize_t file_mq_receive(FAR struct file *mq, FAR char *msg, size_t msglen,
 
   msgq = mq->f_inode->i_private;
 
+#ifdef CONFIG_MQ_RINGBUF
+  if (msgq->ring != NULL)
+    {
+      /* Try the lock-free path first and wait only if the queue is empty */
+
+      ret = nxmq_ring_tryreceive(msgq, msg, prio);
+      if (ret == -EAGAIN)
+        {
+          flags = enter_critical_section();
+          ret = nxmq_ring_wait_receive(msgq, mq->f_oflags, msg, prio);
+          leave_critical_section(flags);
+        }
+
+      return ret;
+    }
+#endif
+
   /* Furthermore, nxmq_wait_receive() expects to have interrupts disabled
    * because messages can be sent from interrupt level.
    */
@@ -0,0 +1,728 @@
+/****************************************************************************
+ * sched/mqueue/mq_ring.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Message queues opened with MQ_RINGBUF keep their messages in a bounded
+ * ring of fixed size slots instead of the prioritized message list.  Each
+ * slot carries a sequence number: a sender may fill the slot at position
+ * 'pos' when its sequence is 'pos', and publishes it by setting the
+ * sequence to 'pos + 1'; a receiver may drain it when the sequence is
+ * 'pos + 1', and recycles it by setting the sequence to 'pos + nslots'.
+ * Positions are claimed with a compare-and-swap, so any number of senders
+ * and receivers (including interrupt handlers) may use the ring without
+ * the critical section.  With a single sender and a single receiver the
+ * compare-and-swap never fails.
+ *
+ * The critical section is only entered to block, or when the waiter
+ * counts, poll waiters or notification show that somebody must be woken.
+ * A waiter publishes its count before it re-checks the ring, and a sender
+ * or receiver updates the ring before it reads the counts, both separated
+ * by a full memory barrier, so that one of the two always sees the other.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <mqueue.h>
+#include <poll.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/signal.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/kmalloc.h>
+
+#include "sched/sched.h"
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_RINGBUF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest ring that can be described by the int16_t maxmsgs */
+
+#define MQ_RING_MAXSLOTS 16384
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_ring_put
+ *
+ * Description:
+ *   Copy one message into the next free slot of the ring.
+ *
+ * Returned Value:
+ *   True if the message was queued; false if the ring is full.
+ *
+ ****************************************************************************/
+
+static bool nxmq_ring_put(FAR struct mqueue_ring_s *ring,
+                          FAR const char *msg, size_t msglen,
+                          unsigned int prio)
+{
+  FAR struct mqueue_slot_s *slot;
+  uint32_t pos;
+  int32_t diff;
+
+  pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+  for (; ; )
+    {
+      slot = MQ_RING_SLOT(ring, pos);
+      diff = (int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+      if (diff == 0)
+        {
+          /* The slot is free.  Try to claim it; on failure 'pos' is
+           * reloaded with the current tail.
+           */
+
+          if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1,
+                                          true, __ATOMIC_RELAXED,
+                                          __ATOMIC_RELAXED))
+            {
+              break;
+            }
+        }
+      else if (diff < 0)
+        {
+          /* The slot has not been drained since the last lap: full */
+
+          return false;
+        }
+      else
+        {
+          /* Another sender claimed this position first */
+
+          pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+  slot->priority = prio;
+  slot->msglen   = msglen;
+  memcpy(slot->mail, msg, msglen);
+
+  /* Publish the message to receivers */
+
+  __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_get
+ *
+ * Description:
+ *   Copy the oldest message out of the ring.
+ *
+ * Returned Value:
+ *   The length of the message, or -EAGAIN if the ring is empty.
+ *
+ ****************************************************************************/
+
+static ssize_t nxmq_ring_get(FAR struct mqueue_ring_s *ring,
+                             FAR char *ubuffer, FAR unsigned int *prio)
+{
+  FAR struct mqueue_slot_s *slot;
+  ssize_t msglen;
+  uint32_t pos;
+  int32_t diff;
+
+  pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+  for (; ; )
+    {
+      slot = MQ_RING_SLOT(ring, pos);
+      diff = (int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) -
+                       (pos + 1));
+      if (diff == 0)
+        {
+          if (__atomic_compare_exchange_n(&ring->head, &pos, pos + 1,
+                                          true, __ATOMIC_RELAXED,
+                                          __ATOMIC_RELAXED))
+            {
+              break;
+            }
+        }
+      else if (diff < 0)
+        {
+          /* Nothing has been published at this position yet: empty */
+
+          return -EAGAIN;
+        }
+      else
+        {
+          pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+        }
+    }
+
+  msglen = slot->msglen;
+  memcpy(ubuffer, slot->mail, msglen);
+  if (prio)
+    {
+      *prio = slot->priority;
+    }
+
+  /* Hand the slot back to senders for the next lap */
+
+  __atomic_store_n(&slot->seq, pos + ring->mask + 1, __ATOMIC_RELEASE);
+  return msglen;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_polled
+ *
+ * Description:
+ *   Return true if any poll waiter is attached to the message queue.
+ *
+ ****************************************************************************/
+
+static bool nxmq_ring_polled(FAR struct mqueue_inode_s *msgq)
+{
+#if CONFIG_FS_MQUEUE_NPOLLWAITERS > 0
+  int i;
+
+  for (i = 0; i < CONFIG_FS_MQUEUE_NPOLLWAITERS; i++)
+    {
+      if (__atomic_load_n(&msgq->fds[i], __ATOMIC_RELAXED) != NULL)
+        {
+          return true;
+        }
+    }
+#endif
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_wakeup
+ *
+ * Description:
+ *   Wake up the highest priority task waiting in the given list.
+ *
+ * Assumptions:
+ *   Called within the critical section with at least one waiter.
+ *
+ ****************************************************************************/
+
+static void nxmq_ring_wakeup(FAR dq_queue_t *list, FAR int16_t *nwait)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  FAR struct tcb_s *btcb;
+
+  btcb = (FAR struct tcb_s *)dq_remfirst(list);
+  DEBUGASSERT(btcb != NULL);
+
+  if (WDOG_ISACTIVE(&btcb->waitdog))
+    {
+      wd_cancel(&btcb->waitdog);
+    }
+
+  (*nwait)--;
+
+  /* Indicate that the wait is over. */
+
+  btcb->waitobj = NULL;
+
+  /* Add the task to ready-to-run task list and
+   * perform the context switch if one is needed
+   */
+
+  if (nxsched_add_readytorun(btcb))
+    {
+      up_switch_context(btcb, rtcb);
+    }
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_block
+ *
+ * Description:
+ *   Block the running task in the given wait list after re-checking the
+ *   ring.  'retry' is called once the waiter count has been published; if
+ *   it succeeds the task does not block.
+ *
+ * Returned Value:
+ *   One if the retry succeeded, zero if the task was woken up, or a
+ *   negated errno value if the wait was interrupted.
+ *
+ * Assumptions:
+ *   Called within the critical section.
+ *
+ ****************************************************************************/
+
+static int nxmq_ring_block(FAR struct mqueue_inode_s *msgq,
+                           FAR dq_queue_t *list, FAR int16_t *nwait,
+                           uint8_t state, CODE bool (*retry)(FAR void *),
+                           FAR void *arg)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  bool switch_needed;
+
+  rtcb->waitobj = msgq;
+  (*nwait)++;
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+  /* A sender or receiver that ran before we published the count may have
+   * missed us.  Check the ring once more before going to sleep.
+   */
+
+  if (retry(arg))
+    {
+      (*nwait)--;
+      rtcb->waitobj = NULL;
+      return 1;
+    }
+
+  /* Initialize the errcode used to communication wake-up error
+   * conditions.
+   */
+
+  rtcb->errcode = OK;
+
+  /* Make sure this is not the idle task, descheduling that
+   * isn't going to end well.
+   */
+
+  DEBUGASSERT(!is_idle_task(rtcb));
+
+  /* Remove the tcb task from the ready-to-run list. */
+
+  switch_needed = nxsched_remove_readytorun(rtcb, true);
+
+  /* Add the task to the specified blocked task list */
+
+  rtcb->task_state = state;
+  nxsched_add_prioritized(rtcb, list);
+
+  /* Now, perform the context switch if one is needed */
+
+  if (switch_needed)
+    {
+      up_switch_context(this_task(), rtcb);
+    }
+
+  return rtcb->errcode != OK ? -rtcb->errcode : 0;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_sent
+ *
+ * Description:
+ *   Account for a message that has been added to the ring and wake up
+ *   receivers, poll waiters or the notification client as needed.
+ *
+ ****************************************************************************/
+
+static void nxmq_ring_sent(FAR struct mqueue_inode_s *msgq)
+{
+  irqstate_t flags;
+  bool wasempty;
+
+  wasempty = __atomic_fetch_add(&msgq->nmsgs, 1, __ATOMIC_RELAXED) == 0;
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+  if (__atomic_load_n(&msgq->cmn.nwaitnotempty, __ATOMIC_RELAXED) <= 0 &&
+#ifndef CONFIG_DISABLE_MQUEUE_NOTIFICATION
+      __atomic_load_n(&msgq->ntpid, __ATOMIC_RELAXED) ==
+      INVALID_PROCESS_ID &&
+#endif
+      !(wasempty && nxmq_ring_polled(msgq)))
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  if (wasempty)
+    {
+      nxmq_pollnotify(msgq, POLLIN);
+    }
+
+#ifndef CONFIG_DISABLE_MQUEUE_NOTIFICATION
+  if (msgq->ntpid != INVALID_PROCESS_ID)
+    {
+      struct sigevent event;
+      pid_t pid;
+
+      /* Remove the message notification data from the message queue. */
+
+      memcpy(&event, &msgq->ntevent, sizeof(struct sigevent));
+      pid = msgq->ntpid;
+
+      /* Detach the notification */
+
+      memset(&msgq->ntevent, 0, sizeof(struct sigevent));
+      msgq->ntpid = INVALID_PROCESS_ID;
+
+      /* Notification the client */
+
+      DEBUGVERIFY(nxsig_notification(pid, &event,
+                                     SI_MESGQ, &msgq->ntwork));
+    }
+#endif
+
+  if (msgq->cmn.nwaitnotempty > 0)
+    {
+      nxmq_ring_wakeup(MQ_WNELIST(msgq->cmn), &msgq->cmn.nwaitnotempty);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_received
+ *
+ * Description:
+ *   Account for a message that has been removed from the ring and wake up
+ *   senders or poll waiters as needed.
+ *
+ ****************************************************************************/
+
+static void nxmq_ring_received(FAR struct mqueue_inode_s *msgq)
+{
+  irqstate_t flags;
+  bool wasfull;
+
+  wasfull = __atomic_fetch_sub(&msgq->nmsgs, 1, __ATOMIC_RELAXED) ==
+            msgq->maxmsgs;
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+  if (__atomic_load_n(&msgq->cmn.nwaitnotfull, __ATOMIC_RELAXED) <= 0 &&
+      !(wasfull && nxmq_ring_polled(msgq)))
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  if (wasfull)
+    {
+      nxmq_pollnotify(msgq, POLLOUT);
+    }
+
+  if (msgq->cmn.nwaitnotfull > 0)
+    {
+      nxmq_ring_wakeup(MQ_WNFLIST(msgq->cmn), &msgq->cmn.nwaitnotfull);
+    }
+
+  leave_critical_section(flags);
+}
+
+/* Retry callbacks for nxmq_ring_block() */
+
+struct nxmq_ring_sendarg_s
+{
+  FAR struct mqueue_ring_s *ring;
+  FAR const char *msg;
+  size_t msglen;
+  unsigned int prio;
+};
+
+struct nxmq_ring_rcvarg_s
+{
+  FAR struct mqueue_ring_s *ring;
+  FAR char *ubuffer;
+  FAR unsigned int *prio;
+  ssize_t ret;
+};
+
+static bool nxmq_ring_retrysend(FAR void *arg)
+{
+  FAR struct nxmq_ring_sendarg_s *sarg = arg;
+
+  return nxmq_ring_put(sarg->ring, sarg->msg, sarg->msglen, sarg->prio);
+}
+
+static bool nxmq_ring_retryreceive(FAR void *arg)
+{
+  FAR struct nxmq_ring_rcvarg_s *rarg = arg;
+
+  rarg->ret = nxmq_ring_get(rarg->ring, rarg->ubuffer, rarg->prio);
+  return rarg->ret >= 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_ring_alloc
+ *
+ * Description:
+ *   Allocate the slot ring of a message queue opened with MQ_RINGBUF.  The
+ *   maximum number of messages is rounded up to a power of two.
+ *
+ * Input Parameters:
+ *   msgq - The message queue; maxmsgs and maxmsgsize must be set
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the queue is too large or -ENOSPC if
+ *   the ring cannot be allocated.
+ *
+ ****************************************************************************/
+
+int nxmq_ring_alloc(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct mqueue_ring_s *ring;
+  uint32_t nslots;
+  uint32_t i;
+  size_t slotsize;
+
+  if (msgq->maxmsgs < 1 || msgq->maxmsgs > MQ_RING_MAXSLOTS)
+    {
+      return -EINVAL;
+    }
+
+  for (nslots = 1; nslots < msgq->maxmsgs; nslots <<= 1);
+
+  slotsize = offsetof(struct mqueue_slot_s, mail) + msgq->maxmsgsize;
+  slotsize = (slotsize + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
+
+  ring = kmm_malloc(sizeof(struct mqueue_ring_s) + nslots * slotsize);
+  if (ring == NULL)
+    {
+      return -ENOSPC;
+    }
+
+  ring->head     = 0;
+  ring->tail     = 0;
+  ring->mask     = nslots - 1;
+  ring->slotsize = slotsize;
+
+  for (i = 0; i < nslots; i++)
+    {
+      MQ_RING_SLOT(ring, i)->seq = i;
+    }
+
+  msgq->maxmsgs = nslots;
+  msgq->ring    = ring;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_trysend
+ *
+ * Description:
+ *   Add a message to a ring buffer message queue without blocking and
+ *   without entering the critical section unless a waiter must be woken.
+ *   This may be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   msgq   - Message queue descriptor
+ *   msg    - Message to send
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) on success or -EAGAIN if the queue is full.
+ *
+ ****************************************************************************/
+
+int nxmq_ring_trysend(FAR struct mqueue_inode_s *msgq,
+                      FAR const char *msg, size_t msglen,
+                      unsigned int prio)
+{
+  if (!nxmq_ring_put(msgq->ring, msg, msglen, prio))
+    {
+      return -EAGAIN;
+    }
+
+  nxmq_ring_sent(msgq);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_wait_send
+ *
+ * Description:
+ *   Add a message to a ring buffer message queue, waiting for the queue
+ *   to become non-full unless O_NONBLOCK is set.
+ *
+ * Input Parameters:
+ *   msgq   - Message queue descriptor
+ *   oflags - flags from user set
+ *   msg    - Message to send
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure (EAGAIN,
+ *   EINTR, ETIMEDOUT or ECANCELED) as for nxmq_wait_send().
+ *
+ * Assumptions:
+ *   Executes within a critical section established by the caller, which
+ *   is also responsible for any timeout watchdog.
+ *
+ ****************************************************************************/
+
+int nxmq_ring_wait_send(FAR struct mqueue_inode_s *msgq, int oflags,
+                        FAR const char *msg, size_t msglen,
+                        unsigned int prio)
+{
+  struct nxmq_ring_sendarg_s sarg;
+  int ret;
+
+#ifdef CONFIG_CANCELLATION_POINTS
+  if (check_cancellation_point())
+    {
+      return -ECANCELED;
+    }
+#endif
+
+  sarg.ring   = msgq->ring;
+  sarg.msg    = msg;
+  sarg.msglen = msglen;
+  sarg.prio   = prio;
+
+  while (!nxmq_ring_put(msgq->ring, msg, msglen, prio))
+    {
+      if ((oflags & O_NONBLOCK) != 0)
+        {
+          return -EAGAIN;
+        }
+
+      ret = nxmq_ring_block(msgq, MQ_WNFLIST(msgq->cmn),
+                            &msgq->cmn.nwaitnotfull,
+                            TSTATE_WAIT_MQNOTFULL,
+                            nxmq_ring_retrysend, &sarg);
+      if (ret < 0)
+        {
+          return ret;
+        }
+      else if (ret > 0)
+        {
+          break;
+        }
+    }
+
+  nxmq_ring_sent(msgq);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_tryreceive
+ *
+ * Description:
+ *   Remove the oldest message from a ring buffer message queue without
+ *   blocking and without entering the critical section unless a waiter
+ *   must be woken.
+ *
+ * Input Parameters:
+ *   msgq    - Message queue descriptor
+ *   ubuffer - The user buffer; at least maxmsgsize bytes
+ *   prio    - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message or -EAGAIN if the queue is empty.
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_ring_tryreceive(FAR struct mqueue_inode_s *msgq,
+                             FAR char *ubuffer, FAR unsigned int *prio)
+{
+  ssize_t ret;
+
+  ret = nxmq_ring_get(msgq->ring, ubuffer, prio);
+  if (ret >= 0)
+    {
+      nxmq_ring_received(msgq);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_wait_receive
+ *
+ * Description:
+ *   Remove the oldest message from a ring buffer message queue, waiting
+ *   for a message unless O_NONBLOCK is set.
+ *
+ * Input Parameters:
+ *   msgq    - Message queue descriptor
+ *   oflags  - flags from user set
+ *   ubuffer - The user buffer; at least maxmsgsize bytes
+ *   prio    - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   The length of the message; a negated errno value on failure (EAGAIN,
+ *   EINTR, ETIMEDOUT or ECANCELED) as for nxmq_wait_receive().
+ *
+ * Assumptions:
+ *   Executes within a critical section established by the caller, which
+ *   is also responsible for any timeout watchdog.
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_ring_wait_receive(FAR struct mqueue_inode_s *msgq, int oflags,
+                               FAR char *ubuffer, FAR unsigned int *prio)
+{
+  struct nxmq_ring_rcvarg_s rarg;
+  int ret;
+
+#ifdef CONFIG_CANCELLATION_POINTS
+  if (check_cancellation_point())
+    {
+      return -ECANCELED;
+    }
+#endif
+
+  rarg.ring    = msgq->ring;
+  rarg.ubuffer = ubuffer;
+  rarg.prio    = prio;
+
+  while ((rarg.ret = nxmq_ring_get(msgq->ring, ubuffer, prio)) < 0)
+    {
+      if ((oflags & O_NONBLOCK) != 0)
+        {
+          return -EAGAIN;
+        }
+
+      ret = nxmq_ring_block(msgq, MQ_WNELIST(msgq->cmn),
+                            &msgq->cmn.nwaitnotempty,
+                            TSTATE_WAIT_MQNOTEMPTY,
+                            nxmq_ring_retryreceive, &rarg);
+      if (ret < 0)
+        {
+          return ret;
+        }
+      else if (ret > 0)
+        {
+          break;
+        }
+    }
+
+  nxmq_ring_received(msgq);
+  return rarg.ret;
+}
+
+#endif /* CONFIG_MQ_RINGBUF */
@@ -88,6 +88,26 @@ int file_mq_send(FAR struct file *mq, FAR const char *msg, size_t msglen,
 
   msgq = mq->f_inode->i_private;
 
+#ifdef CONFIG_MQ_RINGBUF
+  if (msgq->ring != NULL)
+    {
+      /* Try the lock-free path first.  Only a full queue needs the
+       * critical section, to wait for space.  An interrupt handler cannot
+       * wait and gets EAGAIN.
+       */
+
+      ret = nxmq_ring_trysend(msgq, msg, msglen, prio);
+      if (ret == -EAGAIN && !up_interrupt_context())
+        {
+          flags = enter_critical_section();
+          ret = nxmq_ring_wait_send(msgq, mq->f_oflags, msg, msglen, prio);
+          leave_critical_section(flags);
+        }
+
+      return ret;
+    }
+#endif
+
   /* Allocate a message structure:
    * - Immediately if we are called from an interrupt handler.
    * - Immediately if the message queue is not full, or
@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <assert.h>
 #include <errno.h>
@@ -97,6 +98,58 @@ static void nxmq_rcvtimeout(wdparm_t pid)
   leave_critical_section(flags);
 }
 
+/****************************************************************************
+ * Name: nxmq_ring_timedreceive
+ *
+ * Description:
+ *   The part of file_mq_timedreceive() for message queues opened with
+ *   MQ_RINGBUF.  The critical section and the timeout are only used if the
+ *   queue is empty.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_RINGBUF
+static ssize_t nxmq_ring_timedreceive(FAR struct file *mq,
+                                      FAR struct mqueue_inode_s *msgq,
+                                      FAR char *msg, FAR unsigned int *prio,
+                                      FAR const struct timespec *abstime)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  irqstate_t flags;
+  sclock_t ticks;
+  ssize_t ret;
+
+  ret = nxmq_ring_tryreceive(msgq, msg, prio);
+  if (ret != -EAGAIN || (mq->f_oflags & O_NONBLOCK) != 0)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+
+  ret = clock_abstime2ticks(CLOCK_REALTIME, abstime, &ticks);
+  if (ret == OK && ticks <= 0)
+    {
+      ret = ETIMEDOUT;
+    }
+
+  if (ret != OK)
+    {
+      leave_critical_section(flags);
+      return -ret;
+    }
+
+  wd_start_slack(&rtcb->waitdog, ticks, nxsched_timerslack(rtcb),
+                 nxmq_rcvtimeout, nxsched_gettid());
+
+  ret = nxmq_ring_wait_receive(msgq, mq->f_oflags, msg, prio);
+
+  wd_cancel(&rtcb->waitdog);
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -163,6 +216,13 @@ ssize_t file_mq_timedreceive(FAR struct file *mq, FAR char *msg,
 
   msgq = mq->f_inode->i_private;
 
+#ifdef CONFIG_MQ_RINGBUF
+  if (msgq->ring != NULL)
+    {
+      return nxmq_ring_timedreceive(mq, msgq, msg, prio, abstime);
+    }
+#endif
+
   /* Furthermore, nxmq_wait_receive() expects to have interrupts disabled
    * because messages can be sent from interrupt level.
    */
@@ -202,8 +262,8 @@ ssize_t file_mq_timedreceive(FAR struct file *mq, FAR char *msg,
 
       /* Start the watchdog */
 
-      wd_start(&rtcb->waitdog, ticks,
-               nxmq_rcvtimeout, nxsched_gettid());
+      wd_start_slack(&rtcb->waitdog, ticks, nxsched_timerslack(rtcb),
+                     nxmq_rcvtimeout, nxsched_gettid());
     }
 
   /* Get the message from the message queue */
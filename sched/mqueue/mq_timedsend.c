@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <mqueue.h>
 #include <assert.h>
@@ -96,6 +97,68 @@ static void nxmq_sndtimeout(wdparm_t pid)
   leave_critical_section(flags);
 }
 
+/****************************************************************************
+ * Name: nxmq_ring_timedsend
+ *
+ * Description:
+ *   The part of file_mq_timedsend() for message queues opened with
+ *   MQ_RINGBUF.  The critical section and the timeout are only used if the
+ *   queue is full.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_RINGBUF
+static int nxmq_ring_timedsend(FAR struct file *mq,
+                               FAR struct mqueue_inode_s *msgq,
+                               FAR const char *msg, size_t msglen,
+                               unsigned int prio,
+                               FAR const struct timespec *abstime)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  irqstate_t flags;
+  sclock_t ticks;
+  int ret;
+
+  ret = nxmq_ring_trysend(msgq, msg, msglen, prio);
+  if (ret != -EAGAIN || (mq->f_oflags & O_NONBLOCK) != 0)
+    {
+      return ret;
+    }
+
+  /* The message queue is full... We are going to wait.  Now we must have a
+   * valid time value.
+   */
+
+  if (!abstime || abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+
+  ret = clock_abstime2ticks(CLOCK_REALTIME, abstime, &ticks);
+  if (ret == OK && ticks <= 0)
+    {
+      ret = ETIMEDOUT;
+    }
+
+  if (ret != OK)
+    {
+      leave_critical_section(flags);
+      return -ret;
+    }
+
+  wd_start_slack(&rtcb->waitdog, ticks, nxsched_timerslack(rtcb),
+                 nxmq_sndtimeout, nxsched_gettid());
+
+  ret = nxmq_ring_wait_send(msgq, mq->f_oflags, msg, msglen, prio);
+
+  wd_cancel(&rtcb->waitdog);
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -165,6 +228,13 @@ int file_mq_timedsend(FAR struct file *mq, FAR const char *msg,
 
   msgq = mq->f_inode->i_private;
 
+#ifdef CONFIG_MQ_RINGBUF
+  if (msgq->ring != NULL)
+    {
+      return nxmq_ring_timedsend(mq, msgq, msg, msglen, prio, abstime);
+    }
+#endif
+
   /* Disable interruption */
 
   flags = enter_critical_section();
@@ -245,7 +315,8 @@ int file_mq_timedsend(FAR struct file *mq, FAR const char *msg,
 
   /* Start the watchdog and begin the wait for MQ not full */
 
-  wd_start(&rtcb->waitdog, ticks, nxmq_sndtimeout, nxsched_gettid());
+  wd_start_slack(&rtcb->waitdog, ticks, nxsched_timerslack(rtcb),
+                 nxmq_sndtimeout, nxsched_gettid());
 
   /* And wait for the message queue to be non-empty */
 
@@ -73,6 +73,40 @@ struct mqueue_msg_s
   char mail[MQ_MAX_BYTES]; /* Message data */
 };
 
+#ifdef CONFIG_MQ_RINGBUF
+/* This structure describes one slot of a ring buffer message queue.  The
+ * slot is followed by maxmsgsize bytes of message data.
+ */
+
+struct mqueue_slot_s
+{
+  uint32_t seq;            /* Sequence number of the slot */
+  uint8_t priority;        /* Priority of message */
+#if MQ_MAX_BYTES < 256
+  uint8_t msglen;          /* Message data length */
+#else
+  uint16_t msglen;         /* Message data length */
+#endif
+  char mail[1];            /* Message data */
+};
+
+/* This structure describes the lock-free ring of a message queue opened
+ * with MQ_RINGBUF.  The slots follow the structure in memory.
+ */
+
+struct mqueue_ring_s
+{
+  uint32_t head;           /* Position of the next message to receive */
+  uint32_t tail;           /* Position of the next message to send */
+  uint32_t mask;           /* Number of slots minus one */
+  uint16_t slotsize;       /* Size of one slot in bytes */
+};
+
+#define MQ_RING_SLOT(r,p) \
+  ((FAR struct mqueue_slot_s *)((FAR uint8_t *)((r) + 1) + \
+                                ((p) & (r)->mask) * (r)->slotsize))
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -140,6 +174,22 @@ int nxmq_do_send(FAR struct mqueue_inode_s *msgq,
                  FAR struct mqueue_msg_s *mqmsg,
                  FAR const char *msg, size_t msglen, unsigned int prio);
 
+/* mq_ring.c ****************************************************************/
+
+#ifdef CONFIG_MQ_RINGBUF
+int nxmq_ring_alloc(FAR struct mqueue_inode_s *msgq);
+int nxmq_ring_trysend(FAR struct mqueue_inode_s *msgq,
+                      FAR const char *msg, size_t msglen,
+                      unsigned int prio);
+int nxmq_ring_wait_send(FAR struct mqueue_inode_s *msgq, int oflags,
+                        FAR const char *msg, size_t msglen,
+                        unsigned int prio);
+ssize_t nxmq_ring_tryreceive(FAR struct mqueue_inode_s *msgq,
+                             FAR char *ubuffer, FAR unsigned int *prio);
+ssize_t nxmq_ring_wait_receive(FAR struct mqueue_inode_s *msgq, int oflags,
+                               FAR char *ubuffer, FAR unsigned int *prio);
+#endif
+
 /* mq_recover.c *************************************************************/
 
 void nxmq_recover(FAR struct tcb_s *tcb);
@@ -37,7 +37,6 @@
 #include <nuttx/sched.h>
 #include <nuttx/arch.h>
 #include <nuttx/semaphore.h>
-#include <nuttx/kmalloc.h>
 #include <nuttx/pthread.h>
 
 #include "sched/sched.h"
@@ -209,7 +208,7 @@ int nx_pthread_create(pthread_trampoline_t trampoline, FAR pthread_t *thread,
   /* Allocate a TCB for the new task. */
 
   ptcb = (FAR struct pthread_tcb_s *)
-            kmm_zalloc(sizeof(struct pthread_tcb_s));
+            nxsched_alloc_tcb(TCB_FLAG_TTYPE_PTHREAD, attr->stacksize);
   if (!ptcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
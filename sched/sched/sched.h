@@ -58,6 +58,22 @@
 
 #define is_idle_task(t)          ((t)->pid < CONFIG_SMP_NCPUS)
 
+/* Whether nxsched_release_tcb() leaves the stack of a thread of type
+ * 'ttype' to nxsched_free_tcb(), so that the stack can be reused with the
+ * pooled TCB.
+ */
+
+#ifdef CONFIG_BUILD_KERNEL
+#  define nxsched_keep_stack(ttype) false
+#elif !defined(CONFIG_DISABLE_PTHREAD) && CONFIG_PTHREAD_TCB_POOLSIZE > 0
+#  define nxsched_keep_stack(ttype) \
+     ((CONFIG_TASK_TCB_POOLSIZE > 0 && (ttype) == TCB_FLAG_TTYPE_TASK) || \
+      (ttype) == TCB_FLAG_TTYPE_PTHREAD)
+#else
+#  define nxsched_keep_stack(ttype) \
+     (CONFIG_TASK_TCB_POOLSIZE > 0 && (ttype) == TCB_FLAG_TTYPE_TASK)
+#endif
+
 /* This macro returns the running task which may different from this_task()
  * during interrupt level context switches.
  */
@@ -65,6 +81,33 @@
 #define running_task() \
   (up_interrupt_context() ? g_running_tasks[this_cpu()] : this_task())
 
+/* These macros identify SCHED_DEADLINE threads and implement the earliest
+ * deadline first ordering among deadline threads of the same priority.
+ */
+
+#ifdef CONFIG_SCHED_DEADLINE
+#  define nxsched_is_deadline(t) \
+     (((t)->flags & TCB_FLAG_POLICY_MASK) == TCB_FLAG_SCHED_DEADLINE)
+#  define nxsched_deadline_before(a, b) \
+     (nxsched_is_deadline(a) && nxsched_is_deadline(b) && \
+      (a)->sched_priority == (b)->sched_priority && \
+      (sclock_t)((a)->deadline.abs_deadline - \
+                 (b)->deadline.abs_deadline) < 0)
+#else
+#  define nxsched_is_deadline(t)        (false)
+#  define nxsched_deadline_before(a, b) (false)
+#endif
+
+/* This macro returns the timer slack of a thread in clock ticks, rounded
+ * down so that a timed wait never expires later than the slack permits.
+ */
+
+#ifdef CONFIG_SCHED_TIMER_SLACK
+#  define nxsched_timerslack(t)  ((sclock_t)((t)->timerslack / NSEC_PER_TICK))
+#else
+#  define nxsched_timerslack(t)  (0)
+#endif
+
 /* List attribute flags */
 
 #define TLIST_ATTR_PRIORITIZED   (1 << 0) /* Bit 0: List is prioritized */
@@ -224,8 +267,19 @@ extern volatile pid_t g_lastpid;
  */
 
 extern FAR struct tcb_s **g_pidhash;
+
+/* Protects g_pidhash.  Lookups take it as readers so that they do not
+ * serialize against each other; PID assignment, release and the growth of
+ * the table take it as a writer.
+ */
+
+extern rwlock_t g_pidhash_lock;
 extern volatile int g_npidhash;
 
+/* The number of entries of g_pidhash in use */
+
+extern int g_npids;
+
 /* This is a table of task lists.  This table is indexed by the task stat
  * enumeration type (tstate_t) and provides a pointer to the associated
  * static task list (if there is one) as well as a a set of attribute flags
@@ -336,6 +390,12 @@ void nxsched_remove_blocked(FAR struct tcb_s *btcb);
 int  nxsched_set_priority(FAR struct tcb_s *tcb, int sched_priority);
 bool nxsched_reprioritize_rtr(FAR struct tcb_s *tcb, int priority);
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+bool nxsched_rtr_add(FAR struct tcb_s *tcb);
+void nxsched_rtr_remove(FAR struct tcb_s *tcb);
+void nxsched_rtr_setpriority(FAR struct tcb_s *tcb, int priority);
+#endif
+
 /* Priority inheritance support */
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
@@ -376,6 +436,16 @@ uint32_t nxsched_process_sporadic(FAR struct tcb_s *tcb, uint32_t ticks,
 void nxsched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE
+int  nxsched_start_deadline(FAR struct tcb_s *tcb, uint32_t runtime,
+                            uint32_t deadline, uint32_t period,
+                            bool replace);
+void nxsched_stop_deadline(FAR struct tcb_s *tcb);
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb);
+uint32_t nxsched_process_deadline(FAR struct tcb_s *tcb, uint32_t ticks,
+                                  bool noswitches);
+#endif
+
 #ifdef CONFIG_SIG_SIGSTOP_ACTION
 void nxsched_suspend(FAR struct tcb_s *tcb);
 #endif
@@ -386,6 +456,15 @@ FAR struct tcb_s *this_task(void);
 int  nxsched_select_cpu(cpu_set_t affinity);
 int  nxsched_pause_cpu(FAR struct tcb_s *tcb);
 
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+FAR struct tcb_s *nxsched_steal_task(int cpu, uint8_t minprio,
+                                     FAR dq_queue_t **list);
+#endif
+
+#ifdef CONFIG_SMP_CALL
+void nxsched_smp_resched(int cpu);
+#endif
+
 #  define nxsched_islocked_global() spin_islocked(&g_cpu_schedlock)
 #  define nxsched_islocked_tcb(tcb) nxsched_islocked_global()
 
@@ -413,6 +492,22 @@ void nxsched_resume_critmon(FAR struct tcb_s *tcb);
 void nxsched_suspend_critmon(FAR struct tcb_s *tcb);
 #endif
 
+/* High-resolution thread statistics */
+
+#ifdef CONFIG_SCHED_STATS
+void nxsched_wakeup_stats(FAR struct tcb_s *tcb);
+void nxsched_resume_stats(FAR struct tcb_s *tcb);
+void nxsched_suspend_stats(FAR struct tcb_s *tcb);
+#endif
+
+/* Per-thread hardware performance counters */
+
+#ifdef CONFIG_SCHED_PERFCOUNT
+void nxsched_resume_perfcount(FAR struct tcb_s *tcb);
+void nxsched_suspend_perfcount(FAR struct tcb_s *tcb);
+void nxsched_tick_perfcount(void);
+#endif
+
 /* TCB operations */
 
 bool nxsched_verify_tcb(FAR struct tcb_s *tcb);
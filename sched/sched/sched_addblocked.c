@@ -67,6 +67,12 @@ void nxsched_add_blocked(FAR struct tcb_s *btcb, tstate_t task_state)
 
   btcb->task_state = task_state;
 
+#ifdef CONFIG_SCHED_STATS
+  /* Not a wakeup if the task was only moved between blocked lists */
+
+  btcb->stat_waking = false;
+#endif
+
   /* Add the TCB to the blocked task list associated with this state. */
 
   tasklist = TLIST_BLOCKED(btcb);
@@ -73,12 +73,24 @@ bool nxsched_add_prioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 
   DEBUGASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  /* The ready-to-run list is indexed by priority, no search is needed */
+
+  if (list == &g_readytorun)
+    {
+      return nxsched_rtr_add(tcb);
+    }
+#endif
+
   /* Search the list to find the location to insert the new Tcb.
    * Each is list is maintained in descending sched_priority order.
+   * SCHED_DEADLINE threads of equal priority are kept in order of
+   * ascending absolute deadline.
    */
 
   for (next = (FAR struct tcb_s *)list->head;
-       (next && sched_priority <= next->sched_priority);
+       (next && sched_priority <= next->sched_priority &&
+        !nxsched_deadline_before(tcb, next));
        next = next->flink);
 
   /* Add the tcb to the spot found in the list.  Check if the tcb
@@ -76,7 +76,9 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
    * also disabled.
    */
 
-  if (rtcb->lockcount > 0 && rtcb->sched_priority < btcb->sched_priority)
+  if (rtcb->lockcount > 0 &&
+      (rtcb->sched_priority < btcb->sched_priority ||
+       nxsched_deadline_before(btcb, rtcb)))
     {
       /* Yes.  Preemption would occur!  Add the new ready-to-run task to the
        * g_pendingtasks task list for now.
@@ -206,7 +208,9 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   else
     {
       task_state = TSTATE_TASK_READYTORUN;
+#ifndef CONFIG_SMP_PERCPU_RUNQUEUE
       cpu        = 0;  /* CPU does not matter */
+#endif
     }
 
   /* If the selected state is TSTATE_TASK_RUNNING, then we would like to
@@ -244,11 +248,55 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
        * Add the task to the ready-to-run (but not running) task list
        */
 
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+      /* Queue the task on this CPU if its affinity permits, otherwise on
+       * the CPU selected above.  The priority of the task does not exceed
+       * the priority of the task running on either CPU so it cannot become
+       * the head of the queue.
+       */
+
+      if (CPU_ISSET(me, &btcb->affinity))
+        {
+          cpu = me;
+        }
+
+      /* The other CPU does not need to be paused while its queue is
+       * modified:  The head of the queue does not change and all other
+       * entries are only accessed within the critical section, as when
+       * tasks are stolen.
+       */
+
+      switched = nxsched_add_prioritized(btcb, &g_assignedtasks[cpu]);
+      DEBUGASSERT(!switched);
+      UNUSED(switched);
+
+      btcb->cpu        = cpu;
+      btcb->task_state = TSTATE_TASK_ASSIGNED;
+#else
       nxsched_add_prioritized(btcb, &g_readytorun);
 
       btcb->task_state = TSTATE_TASK_READYTORUN;
+#endif
       doswitch         = false;
     }
+#ifdef CONFIG_SMP_CALL
+  else if (task_state == TSTATE_TASK_RUNNING && cpu != me &&
+           (btcb->flags & TCB_FLAG_CPU_LOCKED) == 0)
+    {
+      /* The new task should preempt the task running on another CPU.
+       * Rather than pausing that CPU to change the head of its assigned
+       * task list, leave the task in the g_readytorun list and ask the
+       * CPU to switch to it from its own inter-processor interrupt.  Any
+       * other CPU that becomes free in the meantime may also take it.
+       */
+
+      nxsched_add_prioritized(btcb, &g_readytorun);
+      btcb->task_state = TSTATE_TASK_READYTORUN;
+
+      nxsched_smp_resched(cpu);
+      doswitch = false;
+    }
+#endif
   else /* (task_state == TSTATE_TASK_ASSIGNED || task_state == TSTATE_TASK_RUNNING) */
     {
       /* If we are modifying some assigned task list other than our own, we
@@ -323,6 +371,15 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
               DEBUGASSERT(next->cpu == cpu);
               next->task_state = TSTATE_TASK_ASSIGNED;
             }
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+          else if (!nxsched_islocked_global())
+            {
+              /* The preempted task stays queued on this CPU */
+
+              DEBUGASSERT(next->cpu == cpu);
+              next->task_state = TSTATE_TASK_ASSIGNED;
+            }
+#endif
           else
             {
               /* Remove the task from the assigned task list */
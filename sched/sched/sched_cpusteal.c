@@ -0,0 +1,105 @@
+/****************************************************************************
+ * sched/sched/sched_cpusteal.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <sched.h>
+#include <assert.h>
+
+#include <nuttx/queue.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name:  nxsched_steal_task
+ *
+ * Description:
+ *   Search the ready-to-run queues of all other CPUs for the highest
+ *   priority task that is waiting (i.e., not running), that is not locked
+ *   to its CPU and whose affinity permits it to run on 'cpu'.
+ *
+ *   Each queue is prioritized and its head is the running task, so the
+ *   search of a queue starts at the second entry and stops as soon as the
+ *   priority drops to the best candidate found so far.
+ *
+ * Input Parameters:
+ *   cpu     - The CPU that is looking for work
+ *   minprio - Only tasks with a priority strictly greater than this value
+ *             are considered
+ *   list    - The location to return the queue holding the task found
+ *
+ * Returned Value:
+ *   The TCB of the task found or NULL if there is no such task.  The TCB
+ *   is not removed from its queue.
+ *
+ * Assumptions:
+ *   Called from within a critical section.  The other CPUs are not paused:
+ *   Only the head of their queues, which is never stolen, is accessed
+ *   outside of the critical section.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_steal_task(int cpu, uint8_t minprio,
+                                     FAR dq_queue_t **list)
+{
+  FAR struct tcb_s *best = NULL;
+  FAR struct tcb_s *tcb;
+  int i;
+
+  DEBUGASSERT(list != NULL);
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (i == cpu || g_assignedtasks[i].head == NULL)
+        {
+          continue;
+        }
+
+      for (tcb = ((FAR struct tcb_s *)g_assignedtasks[i].head)->flink;
+           tcb != NULL && tcb->sched_priority > minprio;
+           tcb = tcb->flink)
+        {
+          if ((tcb->flags & TCB_FLAG_CPU_LOCKED) == 0 &&
+              CPU_ISSET(cpu, &tcb->affinity))
+            {
+              /* This is the best candidate of this queue.  Any better
+               * candidate in the remaining queues must have a higher
+               * priority.
+               */
+
+              best    = tcb;
+              minprio = tcb->sched_priority;
+              *list   = &g_assignedtasks[i];
+              break;
+            }
+        }
+    }
+
+  return best;
+}
@@ -0,0 +1,308 @@
+/****************************************************************************
+ * sched/sched/sched_deadline.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+#include <sys/param.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/clock.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_DEADLINE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bandwidth is accounted in fixed point with DL_BW_SHIFT fractional bits */
+
+#define DL_BW_SHIFT   20
+#define DL_BW_ONE     (UINT64_C(1) << DL_BW_SHIFT)
+#define DL_BW_LIMIT   (DL_BW_ONE * CONFIG_SCHED_DEADLINE_MAXUTIL / 100)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The sum of runtime / period over all SCHED_DEADLINE threads */
+
+static uint64_t g_dl_bandwidth;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_deadline_bw
+ *
+ * Description:
+ *   Return the fixed point bandwidth of a deadline server.
+ *
+ ****************************************************************************/
+
+static inline uint64_t nxsched_deadline_bw(uint32_t runtime,
+                                           uint32_t period)
+{
+  return ((uint64_t)runtime << DL_BW_SHIFT) / period;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_start_deadline
+ *
+ * Description:
+ *   Admit a thread to the SCHED_DEADLINE class and start its first server
+ *   period.  The caller is responsible for setting the policy bits of the
+ *   TCB on success.
+ *
+ * Input Parameters:
+ *   tcb      - The TCB of the thread
+ *   runtime  - Execution budget per period in clock ticks
+ *   deadline - Deadline relative to the start of each period in clock ticks
+ *   period   - Server period in clock ticks
+ *   replace  - True if the thread already has a deadline server whose
+ *              bandwidth is being replaced
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure:
+ *
+ *   EINVAL The parameters do not satisfy runtime <= deadline <= period.
+ *   EBUSY  Admitting the thread would exceed CONFIG_SCHED_DEADLINE_MAXUTIL.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+int nxsched_start_deadline(FAR struct tcb_s *tcb, uint32_t runtime,
+                           uint32_t deadline, uint32_t period,
+                           bool replace)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+  uint64_t total = g_dl_bandwidth;
+
+  if (runtime < 1 || runtime > deadline || deadline > period ||
+      period > INT32_MAX)
+    {
+      return -EINVAL;
+    }
+
+  /* Admission control: the total bandwidth must stay within the limit */
+
+  if (replace)
+    {
+      total -= nxsched_deadline_bw(dl->runtime, dl->period);
+    }
+
+  total += nxsched_deadline_bw(runtime, period);
+  if (total > DL_BW_LIMIT)
+    {
+      return -EBUSY;
+    }
+
+  g_dl_bandwidth   = total;
+
+  dl->runtime      = runtime;
+  dl->deadline     = deadline;
+  dl->period       = period;
+  dl->abs_deadline = clock_systime_ticks() + deadline;
+  tcb->timeslice   = runtime;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_stop_deadline
+ *
+ * Description:
+ *   Release the bandwidth reserved by a SCHED_DEADLINE thread.  This is
+ *   called when the thread changes policy or exits.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_stop_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+
+  DEBUGASSERT(g_dl_bandwidth >=
+              nxsched_deadline_bw(dl->runtime, dl->period));
+
+  g_dl_bandwidth -= nxsched_deadline_bw(dl->runtime, dl->period);
+}
+
+/****************************************************************************
+ * Name: nxsched_wakeup_deadline
+ *
+ * Description:
+ *   Apply the constant bandwidth server wake-up rule when a SCHED_DEADLINE
+ *   thread leaves the blocked state.  If the remaining budget could not be
+ *   consumed before the current deadline without exceeding the reserved
+ *   bandwidth, a new server period is started now.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_wakeup_deadline(FAR struct tcb_s *tcb)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+  clock_t now = clock_systime_ticks();
+  sclock_t laxity = (sclock_t)(dl->abs_deadline - now);
+
+  if (laxity <= 0 ||
+      (uint64_t)tcb->timeslice * dl->period >=
+      (uint64_t)laxity * dl->runtime)
+    {
+      dl->abs_deadline = now + dl->deadline;
+      tcb->timeslice   = dl->runtime;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_process_deadline
+ *
+ * Description:
+ *   Charge the running SCHED_DEADLINE thread for the elapsed ticks.  When
+ *   the budget is exhausted, the budget is replenished and the deadline is
+ *   postponed by one period.  If another deadline thread now has an
+ *   earlier deadline, it preempts the current thread.
+ *
+ * Input Parameters:
+ *   tcb        - The TCB of the currently executing task.
+ *   ticks      - The number of ticks that have elapsed on the interval
+ *                timer.
+ *   noswitches - True: Can't do context switches now.
+ *
+ * Returned Value:
+ *   The number of ticks remaining in the budget of the thread.  The value
+ *   one is returned if the budget is exhausted but the action had to be
+ *   deferred because context switches are not possible now.
+ *
+ * Assumptions:
+ *   - Interrupts are disabled
+ *   - The task associated with TCB uses the SCHED_DEADLINE policy
+ *
+ ****************************************************************************/
+
+uint32_t nxsched_process_deadline(FAR struct tcb_s *tcb, uint32_t ticks,
+                                  bool noswitches)
+{
+  FAR struct deadline_s *dl = &tcb->deadline;
+  FAR struct tcb_s *rtcb;
+
+  DEBUGASSERT(tcb != NULL);
+
+  /* Charge the budget, ignoring any excess beyond what remains */
+
+  tcb->timeslice -= MIN(tcb->timeslice, ticks);
+  if (tcb->timeslice > 0)
+    {
+      return tcb->timeslice;
+    }
+
+  /* Defer if we cannot reschedule now; we will be called again soon */
+
+  if (noswitches || nxsched_islocked_tcb(tcb))
+    {
+      return 1;
+    }
+
+  /* Start the next server period: replenish the budget and postpone the
+   * deadline.
+   */
+
+  tcb->timeslice    = dl->runtime;
+  dl->abs_deadline += dl->period;
+
+  /* If the next deadline thread in the ready-to-run list now has the
+   * earlier deadline, requeue this thread behind it.
+   */
+
+  if (tcb->flink != NULL && nxsched_deadline_before(tcb->flink, tcb))
+    {
+      rtcb = this_task();
+      if (nxsched_reprioritize_rtr(tcb, tcb->sched_priority))
+        {
+          up_switch_context(this_task(), rtcb);
+        }
+    }
+
+  return tcb->timeslice;
+}
+
+/****************************************************************************
+ * Name: nxsched_deadline_utilization
+ *
+ * Description:
+ *   Return the CPU bandwidth reserved by all SCHED_DEADLINE threads in
+ *   percent of one CPU, rounded up.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The reserved bandwidth in percent.
+ *
+ ****************************************************************************/
+
+unsigned int nxsched_deadline_utilization(void)
+{
+  irqstate_t flags;
+  uint64_t bw;
+
+  flags = enter_critical_section();
+  bw = g_dl_bandwidth;
+  leave_critical_section(flags);
+
+  return (unsigned int)((bw * 100 + DL_BW_ONE - 1) >> DL_BW_SHIFT);
+}
+
+#endif /* CONFIG_SCHED_DEADLINE */
@@ -73,9 +73,11 @@
 bool nxsched_merge_pending(void)
 {
   FAR struct tcb_s *ptcb;
+#ifndef CONFIG_SCHED_READYTORUN_BITMAP
   FAR struct tcb_s *pnext;
-  FAR struct tcb_s *rtcb;
   FAR struct tcb_s *rprev;
+#endif
+  FAR struct tcb_s *rtcb;
   bool ret = false;
 
   /* Initialize the inner search loop */
@@ -89,6 +91,28 @@ bool nxsched_merge_pending(void)
 
   if (rtcb->lockcount == 0)
     {
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+      /* The ready-to-run list is indexed by priority so each pending TCB
+       * can simply be inserted in constant time.
+       */
+
+      while ((ptcb = (FAR struct tcb_s *)
+                     dq_remfirst(&g_pendingtasks)) != NULL)
+        {
+          if (nxsched_rtr_add(ptcb))
+            {
+              /* ptcb was added at the head of the ready-to-run list */
+
+              ptcb->flink->task_state = TSTATE_TASK_READYTORUN;
+              ptcb->task_state        = TSTATE_TASK_RUNNING;
+              ret                     = true;
+            }
+          else
+            {
+              ptcb->task_state        = TSTATE_TASK_READYTORUN;
+            }
+        }
+#else
       for (ptcb = (FAR struct tcb_s *)g_pendingtasks.head;
            ptcb;
            ptcb = pnext)
@@ -105,7 +129,8 @@ bool nxsched_merge_pending(void)
            */
 
           for (;
-               (rtcb && ptcb->sched_priority <= rtcb->sched_priority);
+               (rtcb && ptcb->sched_priority <= rtcb->sched_priority &&
+                !nxsched_deadline_before(ptcb, rtcb));
                rtcb = rtcb->flink)
             {
             }
@@ -153,6 +178,7 @@ bool nxsched_merge_pending(void)
 
       g_pendingtasks.head = NULL;
       g_pendingtasks.tail = NULL;
+#endif
     }
 
   return ret;
@@ -0,0 +1,296 @@
+/****************************************************************************
+ * sched/sched/sched_perfcount.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/perfcount.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PERFCOUNT
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The free running counters of one CPU */
+
+struct perfcount_cpu_s
+{
+  bool started;                     /* up_pmu_start() was called */
+  uint32_t valid;                   /* Events that this CPU counts */
+  uint32_t base[PERFCOUNT_NEVENTS]; /* When the running thread was charged */
+  uint32_t last[PERFCOUNT_NEVENTS]; /* At the last perfcount_sample() */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct perfcount_cpu_s g_perfcount_cpu[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: perfcount_charge
+ *
+ * Description:
+ *   Add the events counted on this CPU since the last charge to 'tcb',
+ *   which is the thread running on this CPU.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void perfcount_charge(FAR struct perfcount_cpu_s *cpu,
+                             FAR struct tcb_s *tcb)
+{
+  uint32_t now[PERFCOUNT_NEVENTS];
+  int i;
+
+  if (!cpu->started)
+    {
+      return;
+    }
+
+  up_pmu_read(now);
+
+  for (i = 0; i < PERFCOUNT_NEVENTS; i++)
+    {
+      if ((cpu->valid & (1 << i)) != 0)
+        {
+          tcb->perf_count[i] += now[i] - cpu->base[i];
+          cpu->base[i]        = now[i];
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_resume_perfcount
+ *
+ * Description:
+ *   Called when a thread resumes execution.  Starts counting the events of
+ *   the thread, and starts the counters of this CPU the first time.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_resume_perfcount(FAR struct tcb_s *tcb)
+{
+  FAR struct perfcount_cpu_s *cpu = &g_perfcount_cpu[this_cpu()];
+
+  if (!cpu->started)
+    {
+      cpu->valid   = up_pmu_start();
+      cpu->started = true;
+      up_pmu_read(cpu->last);
+    }
+
+  up_pmu_read(cpu->base);
+}
+
+/****************************************************************************
+ * Name: nxsched_suspend_perfcount
+ *
+ * Description:
+ *   Called when a thread suspends execution.  Charges the events counted
+ *   while it ran.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_suspend_perfcount(FAR struct tcb_s *tcb)
+{
+  perfcount_charge(&g_perfcount_cpu[this_cpu()], tcb);
+}
+
+/****************************************************************************
+ * Name: nxsched_tick_perfcount
+ *
+ * Description:
+ *   Called on each system tick to charge the running thread, so that a
+ *   thread that runs for a long time without a context switch does not
+ *   let the 32-bit counters wrap more than once.
+ *
+ * Assumptions:
+ *   Called from the timer interrupt handler.
+ *
+ ****************************************************************************/
+
+void nxsched_tick_perfcount(void)
+{
+  perfcount_charge(&g_perfcount_cpu[this_cpu()], running_task());
+}
+
+/****************************************************************************
+ * Name: perfcount_read
+ *
+ * Description:
+ *   Return the events counted while the thread perf->pid ran.  The count
+ *   of a thread that is running on another CPU does not include its
+ *   current time slice.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ESRCH if there is no such thread.
+ *
+ ****************************************************************************/
+
+int perfcount_read(FAR struct perfcount_s *perf)
+{
+  FAR struct perfcount_cpu_s *cpu;
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  cpu = &g_perfcount_cpu[this_cpu()];
+  tcb = perf->pid == 0 ? this_task() : nxsched_get_tcb(perf->pid);
+  if (tcb == NULL)
+    {
+      leave_critical_section(flags);
+      return -ESRCH;
+    }
+
+  if (tcb == this_task())
+    {
+      perfcount_charge(cpu, tcb);
+    }
+
+  perf->pid   = tcb->pid;
+  perf->valid = cpu->valid;
+  memcpy(perf->count, tcb->perf_count, sizeof(perf->count));
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: perfcount_reset
+ *
+ * Description:
+ *   Clear the counters of the thread 'pid', or of the caller if 'pid' is
+ *   zero.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ESRCH if there is no such thread.
+ *
+ ****************************************************************************/
+
+int perfcount_reset(pid_t pid)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  tcb = pid == 0 ? this_task() : nxsched_get_tcb(pid);
+  if (tcb == NULL)
+    {
+      leave_critical_section(flags);
+      return -ESRCH;
+    }
+
+  if (tcb == this_task())
+    {
+      perfcount_charge(&g_perfcount_cpu[this_cpu()], tcb);
+    }
+
+  memset(tcb->perf_count, 0, sizeof(tcb->perf_count));
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: perfcount_sample
+ *
+ * Description:
+ *   Return the events counted on this CPU since the previous call on this
+ *   CPU.  This is meant for a sampling profiler, which calls it from its
+ *   timer interrupt to weight each sample.
+ *
+ * Input Parameters:
+ *   delta - Receives PERFCOUNT_NEVENTS counts; those not counted are zero
+ *
+ * Returned Value:
+ *   The mask of the valid entries of delta, zero if the counters of this
+ *   CPU have not been started yet.
+ *
+ ****************************************************************************/
+
+uint32_t perfcount_sample(FAR uint32_t *delta)
+{
+  FAR struct perfcount_cpu_s *cpu;
+  uint32_t now[PERFCOUNT_NEVENTS];
+  irqstate_t flags;
+  int i;
+
+  memset(delta, 0, PERFCOUNT_NEVENTS * sizeof(uint32_t));
+
+  flags = enter_critical_section();
+
+  cpu = &g_perfcount_cpu[this_cpu()];
+  if (!cpu->started)
+    {
+      leave_critical_section(flags);
+      return 0;
+    }
+
+  up_pmu_read(now);
+
+  for (i = 0; i < PERFCOUNT_NEVENTS; i++)
+    {
+      if ((cpu->valid & (1 << i)) != 0)
+        {
+          delta[i]     = now[i] - cpu->last[i];
+          cpu->last[i] = now[i];
+        }
+    }
+
+  leave_critical_section(flags);
+  return cpu->valid;
+}
+
+#endif /* CONFIG_SCHED_PERFCOUNT */
@@ -0,0 +1,392 @@
+/****************************************************************************
+ * sched/sched/sched_profile.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/perfcount.h>
+#include <nuttx/profile.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PROFILE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* From interrupt context, up_backtrace() reports the frames of the
+ * interrupt handler before the interrupted program counter.  This many
+ * extra frames are unwound to reach past them.
+ */
+
+#define PROFILE_BTEXTRA 8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The most recent samples of one CPU */
+
+struct profile_ring_s
+{
+  uint32_t head;                    /* Number of samples ever taken */
+  struct profile_sample_s samples[CONFIG_SCHED_PROFILE_NSAMPLES];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct profile_hot_s g_profile_hot[CONFIG_SCHED_PROFILE_NHOT];
+static struct profile_ring_s g_profile_ring[CONFIG_SMP_NCPUS];
+static uint32_t g_profile_total;
+static struct wdog_s g_profile_wdog;
+static bool g_profile_running;
+
+/* Protects the tables above */
+
+static spinlock_t g_profile_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: profile_hash
+ ****************************************************************************/
+
+static inline uintptr_t profile_hash(uintptr_t pc)
+{
+  uintptr_t key = pc >> 1;
+
+  key ^= key >> 11;
+  key ^= key >> 17;
+  return key;
+}
+
+/****************************************************************************
+ * Name: profile_count
+ *
+ * Description:
+ *   Count one sample of 'pc', claiming a free entry if 'pc' has not been
+ *   seen before.  The sample is only counted in the total if the table is
+ *   full.
+ *
+ * Assumptions:
+ *   g_profile_lock is held.
+ *
+ ****************************************************************************/
+
+static void profile_count(uintptr_t pc)
+{
+  FAR struct profile_hot_s *hot;
+  uintptr_t index = profile_hash(pc);
+  int i;
+
+  g_profile_total++;
+
+  for (i = 0; i < CONFIG_SCHED_PROFILE_NHOT; i++, index++)
+    {
+      hot = &g_profile_hot[index % CONFIG_SCHED_PROFILE_NHOT];
+
+      if (hot->pc == pc)
+        {
+          hot->count++;
+          return;
+        }
+
+      if (hot->count == 0)
+        {
+          hot->pc    = pc;
+          hot->count = 1;
+          return;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: profile_backtrace
+ *
+ * Description:
+ *   Record the callers of the interrupted program counter.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_PROFILE_BTDEPTH > 0
+static void profile_backtrace(FAR struct profile_sample_s *sample)
+{
+  FAR void *bt[CONFIG_SCHED_PROFILE_BTDEPTH + PROFILE_BTEXTRA];
+  int first = 0;
+  int n;
+  int i;
+
+  n = up_backtrace(NULL, bt, CONFIG_SCHED_PROFILE_BTDEPTH + PROFILE_BTEXTRA,
+                   0);
+
+  /* Skip the interrupt handler, up to and including the sampled program
+   * counter.  Keep everything if the port did not report it.
+   */
+
+  for (i = 0; i < n; i++)
+    {
+      if ((uintptr_t)bt[i] == sample->pc)
+        {
+          first = i + 1;
+          break;
+        }
+    }
+
+  n -= first;
+  if (n > CONFIG_SCHED_PROFILE_BTDEPTH)
+    {
+      n = CONFIG_SCHED_PROFILE_BTDEPTH;
+    }
+
+  sample->depth = n > 0 ? n : 0;
+  memcpy(sample->bt, &bt[first], sample->depth * sizeof(FAR void *));
+}
+#endif
+
+/****************************************************************************
+ * Name: profile_timer
+ *
+ * Description:
+ *   Sample the context interrupted by the system timer on this CPU.
+ *
+ ****************************************************************************/
+
+static void profile_timer(wdparm_t arg)
+{
+  FAR struct profile_ring_s *ring;
+  FAR struct profile_sample_s *sample;
+#ifdef CONFIG_SCHED_PERFCOUNT
+  uint32_t events[PERFCOUNT_NEVENTS];
+#endif
+  irqstate_t flags;
+  uintptr_t pc;
+
+  pc = up_getusrpc(NULL);
+  if (pc != 0)
+    {
+#ifdef CONFIG_SCHED_PERFCOUNT
+      /* Weight the sample with the events since the previous one */
+
+      perfcount_sample(events);
+#endif
+
+      flags  = spin_lock_irqsave_wo_note(&g_profile_lock);
+
+      ring   = &g_profile_ring[this_cpu()];
+      sample = &ring->samples[ring->head % CONFIG_SCHED_PROFILE_NSAMPLES];
+      ring->head++;
+
+      sample->pc  = pc;
+      sample->pid = this_task()->pid;
+#ifdef CONFIG_SCHED_PERFCOUNT
+      memcpy(sample->events, events, sizeof(events));
+#endif
+#if CONFIG_SCHED_PROFILE_BTDEPTH > 0
+      profile_backtrace(sample);
+#endif
+
+      profile_count(pc);
+      spin_unlock_irqrestore_wo_note(&g_profile_lock, flags);
+    }
+
+  if (g_profile_running)
+    {
+      wd_start(&g_profile_wdog, CONFIG_SCHED_PROFILE_INTERVAL,
+               profile_timer, 0);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: profile_start
+ *
+ * Description:
+ *   Start sampling every CONFIG_SCHED_PROFILE_INTERVAL system ticks.  This
+ *   is done at boot; it is only needed after profile_stop().
+ *
+ ****************************************************************************/
+
+void profile_start(void)
+{
+  irqstate_t flags = enter_critical_section();
+
+  if (!g_profile_running)
+    {
+      g_profile_running = true;
+      wd_start(&g_profile_wdog, CONFIG_SCHED_PROFILE_INTERVAL,
+               profile_timer, 0);
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: profile_stop
+ *
+ * Description:
+ *   Stop sampling.  The samples taken so far are kept.
+ *
+ ****************************************************************************/
+
+void profile_stop(void)
+{
+  irqstate_t flags = enter_critical_section();
+
+  g_profile_running = false;
+  wd_cancel(&g_profile_wdog);
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: profile_reset
+ *
+ * Description:
+ *   Discard all samples taken so far.
+ *
+ ****************************************************************************/
+
+void profile_reset(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave_wo_note(&g_profile_lock);
+  memset(g_profile_hot, 0, sizeof(g_profile_hot));
+  memset(g_profile_ring, 0, sizeof(g_profile_ring));
+  g_profile_total = 0;
+  spin_unlock_irqrestore_wo_note(&g_profile_lock, flags);
+}
+
+/****************************************************************************
+ * Name: profile_foreach_hot
+ *
+ * Description:
+ *   Call 'handler' with a snapshot of the sample count of every program
+ *   counter hit so far.  The handler is called without any lock held.
+ *
+ * Input Parameters:
+ *   handler - The function to call for each entry
+ *   arg     - An opaque argument passed to the handler
+ *
+ * Returned Value:
+ *   The total number of samples.  Samples whose program counter did not
+ *   fit into the table are counted here but not reported.
+ *
+ ****************************************************************************/
+
+uint32_t profile_foreach_hot(profile_hot_handler_t handler, FAR void *arg)
+{
+  struct profile_hot_s hot;
+  irqstate_t flags;
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_PROFILE_NHOT; i++)
+    {
+      flags = spin_lock_irqsave_wo_note(&g_profile_lock);
+      memcpy(&hot, &g_profile_hot[i], sizeof(struct profile_hot_s));
+      spin_unlock_irqrestore_wo_note(&g_profile_lock, flags);
+
+      if (hot.count != 0)
+        {
+          handler(&hot, arg);
+        }
+    }
+
+  return g_profile_total;
+}
+
+/****************************************************************************
+ * Name: profile_foreach_sample
+ *
+ * Description:
+ *   Call 'handler' with a snapshot of the most recent samples of each CPU,
+ *   oldest first.  The handler is called without any lock held.
+ *
+ * Input Parameters:
+ *   handler - The function to call for each sample
+ *   arg     - An opaque argument passed to the handler
+ *
+ ****************************************************************************/
+
+void profile_foreach_sample(profile_sample_handler_t handler, FAR void *arg)
+{
+  FAR struct profile_ring_s *ring;
+  struct profile_sample_s sample;
+  irqstate_t flags;
+  uint32_t head;
+  uint32_t seq;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      ring = &g_profile_ring[cpu];
+      head = ring->head;
+      seq  = head > CONFIG_SCHED_PROFILE_NSAMPLES ?
+             head - CONFIG_SCHED_PROFILE_NSAMPLES : 0;
+
+      for (; seq < head; seq++)
+        {
+          flags = spin_lock_irqsave_wo_note(&g_profile_lock);
+
+          /* Stop if the ring was reset, skip overwritten samples */
+
+          if (ring->head < head)
+            {
+              spin_unlock_irqrestore_wo_note(&g_profile_lock, flags);
+              break;
+            }
+
+          if (ring->head - seq > CONFIG_SCHED_PROFILE_NSAMPLES)
+            {
+              spin_unlock_irqrestore_wo_note(&g_profile_lock, flags);
+              continue;
+            }
+
+          memcpy(&sample,
+                 &ring->samples[seq % CONFIG_SCHED_PROFILE_NSAMPLES],
+                 sizeof(struct profile_sample_s));
+          spin_unlock_irqrestore_wo_note(&g_profile_lock, flags);
+
+          handler(cpu, &sample, arg);
+        }
+    }
+}
+
+#endif /* CONFIG_SCHED_PROFILE */
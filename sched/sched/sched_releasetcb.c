@@ -49,6 +49,7 @@
 static void nxsched_releasepid(pid_t pid)
 {
   irqstate_t flags = enter_critical_section();
+  irqstate_t write_flags;
   int hash_ndx = PIDHASH(pid);
 
 #ifdef CONFIG_SCHED_CPULOAD
@@ -64,7 +65,10 @@ static void nxsched_releasepid(pid_t pid)
    * following action is atomic
    */
 
+  write_flags = write_lock_irqsave(&g_pidhash_lock);
   g_pidhash[hash_ndx] = NULL;
+  write_unlock_irqrestore(&g_pidhash_lock, write_flags);
+  g_npids--;
 
   leave_critical_section(flags);
 }
@@ -122,9 +126,11 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
           nxsched_releasepid(tcb->pid);
         }
 
-      /* Delete the thread's stack if one has been allocated */
+      /* Delete the thread's stack if one has been allocated.  The stack
+       * may instead be kept with the TCB for reuse.
+       */
 
-      if (tcb->stack_alloc_ptr)
+      if (tcb->stack_alloc_ptr && !nxsched_keep_stack(ttype))
         {
           up_release_stack(tcb, ttype);
         }
@@ -163,7 +169,7 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       /* And, finally, release the TCB itself */
 
-      kmm_free(tcb);
+      nxsched_free_tcb(tcb, ttype);
     }
 
   return ret;
@@ -72,6 +72,21 @@ void nxsched_remove_blocked(FAR struct tcb_s *btcb)
 
   btcb->waitobj = NULL;
 
+#ifdef CONFIG_SCHED_STATS
+  /* Start measuring the wakeup latency */
+
+  nxsched_wakeup_stats(btcb);
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* A deadline thread may need a new server period after sleeping */
+
+  if (nxsched_is_deadline(btcb))
+    {
+      nxsched_wakeup_deadline(btcb);
+    }
+#endif
+
   /* Make sure the TCB's state corresponds to not being in
    * any list
    */
@@ -91,7 +91,12 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb, bool merge)
    * is always the g_readytorun list.
    */
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  UNUSED(tasklist);
+  nxsched_rtr_remove(rtcb);
+#else
   dq_rem((FAR dq_entry_t *)rtcb, tasklist);
+#endif
 
   /* Since the TCB is not in any list, it is now invalid */
 
@@ -163,6 +168,12 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb, bool merge)
     {
       FAR struct tcb_s *nxttcb;
       FAR struct tcb_s *rtrtcb = NULL;
+      FAR dq_queue_t *rtrlist = &g_readytorun;
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+      FAR struct tcb_s *stltcb;
+      FAR dq_queue_t *stllist;
+      uint8_t minprio;
+#endif
       int me;
 
       /* There must always be at least one task in the list (the IDLE task)
@@ -209,7 +220,44 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb, bool merge)
           for (rtrtcb = (FAR struct tcb_s *)g_readytorun.head;
                rtrtcb != NULL && !CPU_ISSET(cpu, &rtrtcb->affinity);
                rtrtcb = rtrtcb->flink);
+
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+          /* Steal a task from the queue of another CPU if it has a higher
+           * priority than any task that this CPU could otherwise run.
+           */
+
+          minprio = nxttcb->sched_priority;
+          if (rtrtcb != NULL && rtrtcb->sched_priority > minprio)
+            {
+              minprio = rtrtcb->sched_priority;
+            }
+
+          stltcb = nxsched_steal_task(cpu, minprio, &stllist);
+          if (stltcb != NULL)
+            {
+              rtrtcb  = stltcb;
+              rtrlist = stllist;
+            }
+#endif
+        }
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+      else
+        {
+          /* Tasks that are not locked to this CPU may not start while the
+           * scheduler is locked.  Move them to the pending task list so
+           * that they are restarted when the scheduler is unlocked.  The
+           * IDLE task is locked to this CPU so the loop always terminates.
+           */
+
+          while ((nxttcb->flags & TCB_FLAG_CPU_LOCKED) == 0)
+            {
+              dq_rem((FAR dq_entry_t *)nxttcb, tasklist);
+              nxsched_add_prioritized(nxttcb, &g_pendingtasks);
+              nxttcb->task_state = TSTATE_TASK_PENDING;
+              nxttcb = (FAR struct tcb_s *)tasklist->head;
+            }
         }
+#endif
 
       /* Did we find a task in the g_readytorun list?  Which task should
        * we use?  We decide strictly by the priority of the two tasks:
@@ -222,10 +270,11 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb, bool merge)
         {
           /* The TCB rtrtcb has the higher priority and it can be run on
            * target CPU. Remove that task (rtrtcb) from the g_readytorun
-           * list and add to the head of the g_assignedtasks[cpu] list.
+           * list (or from the queue of the CPU it was stolen from) and add
+           * to the head of the g_assignedtasks[cpu] list.
            */
 
-          dq_rem((FAR dq_entry_t *)rtrtcb, &g_readytorun);
+          dq_rem((FAR dq_entry_t *)rtrtcb, rtrlist);
           dq_addfirst((FAR dq_entry_t *)rtrtcb, tasklist);
 
           rtrtcb->cpu = cpu;
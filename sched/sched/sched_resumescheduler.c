@@ -71,6 +71,12 @@ void nxsched_resume_scheduler(FAR struct tcb_s *tcb)
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_resume_critmon(tcb);
 #endif
+#ifdef CONFIG_SCHED_STATS
+  nxsched_resume_stats(tcb);
+#endif
+#ifdef CONFIG_SCHED_PERFCOUNT
+  nxsched_resume_perfcount(tcb);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_resume(tcb);
 #endif
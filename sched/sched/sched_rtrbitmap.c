@@ -0,0 +1,280 @@
+/****************************************************************************
+ * sched/sched/sched_rtrbitmap.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/queue.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define RTR_NPRIORITIES  (SCHED_PRIORITY_MAX + 1)
+#define RTR_NWORDS       ((RTR_NPRIORITIES + 31) >> 5)
+
+#define RTR_WORD(p)      ((p) >> 5)
+#define RTR_BIT(p)       (UINT32_C(1) << ((p) & 31))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* One bit for each priority level that has at least one TCB in the
+ * g_readytorun list.
+ */
+
+static uint32_t g_rtr_bitmap[RTR_NWORDS];
+
+/* The last TCB of each priority level in the g_readytorun list.  New TCBs
+ * of the same priority are inserted just after this entry so that FIFO
+ * ordering is preserved within a priority level.
+ */
+
+static FAR struct tcb_s *g_rtr_tail[RTR_NPRIORITIES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_rtr_higher
+ *
+ * Description:
+ *   Find the lowest, non-empty priority level that is strictly higher than
+ *   the provided priority.  At most RTR_NWORDS words of the bitmap are
+ *   examined so the search time is bounded.
+ *
+ * Input Parameters:
+ *   priority - The reference priority
+ *
+ * Returned Value:
+ *   The priority level found or -1 if there is no higher priority TCB in
+ *   the g_readytorun list.
+ *
+ ****************************************************************************/
+
+static int nxsched_rtr_higher(int priority)
+{
+  uint32_t word;
+  int index;
+
+  if (++priority >= RTR_NPRIORITIES)
+    {
+      return -1;
+    }
+
+  index = RTR_WORD(priority);
+  word  = g_rtr_bitmap[index] & ~(RTR_BIT(priority) - 1);
+
+  while (word == 0)
+    {
+      if (++index >= RTR_NWORDS)
+        {
+          return -1;
+        }
+
+      word = g_rtr_bitmap[index];
+    }
+
+  return (index << 5) + ffs((int)word) - 1;
+}
+
+/****************************************************************************
+ * Name: nxsched_rtr_link
+ *
+ * Description:
+ *   Account for a TCB that has just been placed in the g_readytorun list.
+ *
+ ****************************************************************************/
+
+static void nxsched_rtr_link(FAR struct tcb_s *tcb)
+{
+  int priority = tcb->sched_priority;
+  FAR struct tcb_s *tail = g_rtr_tail[priority];
+
+  if (tail == NULL)
+    {
+      /* First TCB at this priority level */
+
+      g_rtr_tail[priority] = tcb;
+      g_rtr_bitmap[RTR_WORD(priority)] |= RTR_BIT(priority);
+    }
+  else if (tcb->blink == tail)
+    {
+      /* The TCB was appended after the previous last TCB of the level */
+
+      g_rtr_tail[priority] = tcb;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_rtr_unlink
+ *
+ * Description:
+ *   Account for a TCB that is about to be removed from the g_readytorun
+ *   list.  This must be called while the TCB is still linked.
+ *
+ ****************************************************************************/
+
+static void nxsched_rtr_unlink(FAR struct tcb_s *tcb)
+{
+  int priority = tcb->sched_priority;
+  FAR struct tcb_s *prev;
+
+  if (g_rtr_tail[priority] == tcb)
+    {
+      prev = tcb->blink;
+      if (prev != NULL && prev->sched_priority == priority)
+        {
+          g_rtr_tail[priority] = prev;
+        }
+      else
+        {
+          /* That was the only TCB at this priority level */
+
+          g_rtr_tail[priority] = NULL;
+          g_rtr_bitmap[RTR_WORD(priority)] &= ~RTR_BIT(priority);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_rtr_add
+ *
+ * Description:
+ *   Add a TCB to the g_readytorun list in constant time.  The TCB is placed
+ *   after all TCBs of the same or higher priority.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to add to the g_readytorun list
+ *
+ * Returned Value:
+ *   true if the head of the list has changed.
+ *
+ * Assumptions:
+ *   Same as nxsched_add_prioritized().
+ *
+ ****************************************************************************/
+
+bool nxsched_rtr_add(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *prev;
+  int priority;
+
+  DEBUGASSERT(tcb->sched_priority >= SCHED_PRIORITY_MIN);
+
+  /* Insert after the last TCB of the same priority or, if there is none,
+   * after the last TCB of the next higher, non-empty priority level.
+   */
+
+  prev = g_rtr_tail[tcb->sched_priority];
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* SCHED_DEADLINE threads are ordered by deadline within their level */
+
+  while (prev != NULL && nxsched_deadline_before(tcb, prev))
+    {
+      prev = prev->blink;
+    }
+
+  if (prev == NULL && g_rtr_tail[tcb->sched_priority] == NULL)
+#else
+  if (prev == NULL)
+#endif
+    {
+      priority = nxsched_rtr_higher(tcb->sched_priority);
+      if (priority >= 0)
+        {
+          prev = g_rtr_tail[priority];
+        }
+    }
+
+  if (prev == NULL)
+    {
+      dq_addfirst((FAR dq_entry_t *)tcb, &g_readytorun);
+    }
+  else
+    {
+      dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)tcb,
+                  &g_readytorun);
+    }
+
+  nxsched_rtr_link(tcb);
+  return prev == NULL;
+}
+
+/****************************************************************************
+ * Name: nxsched_rtr_remove
+ *
+ * Description:
+ *   Remove a TCB from the g_readytorun list in constant time.
+ *
+ * Input Parameters:
+ *   tcb - Points to the TCB to remove from the g_readytorun list
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_rtr_remove(FAR struct tcb_s *tcb)
+{
+  nxsched_rtr_unlink(tcb);
+  dq_rem((FAR dq_entry_t *)tcb, &g_readytorun);
+}
+
+/****************************************************************************
+ * Name: nxsched_rtr_setpriority
+ *
+ * Description:
+ *   Change the priority of a TCB in the g_readytorun list without moving
+ *   it.  The caller must assure that the TCB's position is still correct
+ *   for the new priority (for example, it remains at the head of the list).
+ *
+ * Input Parameters:
+ *   tcb      - Points to the TCB in the g_readytorun list
+ *   priority - The new priority of the TCB
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_rtr_setpriority(FAR struct tcb_s *tcb, int priority)
+{
+  nxsched_rtr_unlink(tcb);
+  tcb->sched_priority = (uint8_t)priority;
+  nxsched_rtr_link(tcb);
+}
@@ -167,7 +167,11 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
           /* Change the task priority */
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+          nxsched_rtr_setpriority(tcb, sched_priority);
+#else
           tcb->sched_priority = (uint8_t)sched_priority;
+#endif
         }
       else
         {
@@ -186,7 +190,11 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
     {
       /* Change the task priority */
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+      nxsched_rtr_setpriority(tcb, sched_priority);
+#else
       tcb->sched_priority = (uint8_t)sched_priority;
+#endif
     }
 }
 
@@ -72,6 +72,7 @@
  *
  *   EINVAL The scheduling policy is not one of the recognized policies.
  *   ESRCH  The task whose ID is pid could not be found.
+ *   EBUSY  A SCHED_DEADLINE request failed admission control.
  *
  ****************************************************************************/
 
@@ -80,6 +81,10 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 {
   FAR struct tcb_s *tcb;
   irqstate_t flags;
+  int priority = param->sched_priority;
+#ifdef CONFIG_SCHED_DEADLINE
+  uint16_t oldpolicy;
+#endif
   int ret;
 
   /* Check for supported scheduling policy */
@@ -91,16 +96,27 @@ int nxsched_set_scheduler(pid_t pid, int policy,
 #endif
 #ifdef CONFIG_SCHED_SPORADIC
       && policy != SCHED_SPORADIC
+#endif
+#ifdef CONFIG_SCHED_DEADLINE
+      && policy != SCHED_DEADLINE
 #endif
      )
     {
       return -EINVAL;
     }
 
+#ifdef CONFIG_SCHED_DEADLINE
+  /* All deadline threads share the same priority */
+
+  if (policy == SCHED_DEADLINE)
+    {
+      priority = CONFIG_SCHED_DEADLINE_PRIORITY;
+    }
+#endif
+
   /* Verify that the requested priority is in the valid range */
 
-  if (param->sched_priority < SCHED_PRIORITY_MIN ||
-      param->sched_priority > SCHED_PRIORITY_MAX)
+  if (priority < SCHED_PRIORITY_MIN || priority > SCHED_PRIORITY_MAX)
     {
       return -EINVAL;
     }
@@ -129,6 +145,9 @@ int nxsched_set_scheduler(pid_t pid, int policy,
   /* Further, disable timer interrupts while we set up scheduling policy. */
 
   flags = enter_critical_section();
+#ifdef CONFIG_SCHED_DEADLINE
+  oldpolicy   = tcb->flags & TCB_FLAG_POLICY_MASK;
+#endif
   tcb->flags &= ~TCB_FLAG_POLICY_MASK;
   switch (policy)
     {
@@ -147,7 +166,8 @@ int nxsched_set_scheduler(pid_t pid, int policy,
           /* Save the FIFO scheduling parameters */
 
           tcb->flags     |= TCB_FLAG_SCHED_FIFO;
-#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC)
+#if CONFIG_RR_INTERVAL > 0 || defined(CONFIG_SCHED_SPORADIC) || \
+    defined(CONFIG_SCHED_DEADLINE)
           tcb->timeslice  = 0;
 #endif
         }
@@ -264,17 +284,75 @@ int nxsched_set_scheduler(pid_t pid, int policy,
         }
         break;
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+      case SCHED_DEADLINE:
+        {
+          sclock_t runtime;
+          sclock_t deadline;
+          sclock_t period;
+
+          /* Convert timespec values to system clock ticks */
+
+          clock_time2ticks(&param->sched_dl_runtime, &runtime);
+          clock_time2ticks(&param->sched_dl_deadline, &deadline);
+          clock_time2ticks(&param->sched_dl_period, &period);
+
+          /* A zero deadline defaults to the period and vice versa */
+
+          if (deadline <= 0)
+            {
+              deadline = period;
+            }
+
+          if (period <= 0)
+            {
+              period = deadline;
+            }
+
+          if (runtime < 1 || deadline > INT32_MAX || period > INT32_MAX)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              ret = nxsched_start_deadline(tcb, runtime, deadline, period,
+                                           oldpolicy ==
+                                           TCB_FLAG_SCHED_DEADLINE);
+            }
+
+          if (ret < 0)
+            {
+              /* Keep the previous policy and reservation */
+
+              tcb->flags |= oldpolicy;
+              goto errout_with_irq;
+            }
+
+          tcb->flags |= TCB_FLAG_SCHED_DEADLINE;
+        }
+        break;
+#endif
+    }
+
+#ifdef CONFIG_SCHED_DEADLINE
+  /* Release the bandwidth of a deadline thread that changed policy */
+
+  if (oldpolicy == TCB_FLAG_SCHED_DEADLINE && policy != SCHED_DEADLINE)
+    {
+      nxsched_stop_deadline(tcb);
     }
+#endif
 
   leave_critical_section(flags);
 
   /* Set the new priority */
 
-  ret = nxsched_reprioritize(tcb, param->sched_priority);
+  ret = nxsched_reprioritize(tcb, priority);
   sched_unlock();
   return ret;
 
-#ifdef CONFIG_SCHED_SPORADIC
+#if defined(CONFIG_SCHED_SPORADIC) || defined(CONFIG_SCHED_DEADLINE)
 errout_with_irq:
   leave_critical_section(flags);
   sched_unlock();
@@ -0,0 +1,437 @@
+/****************************************************************************
+ * sched/sched/sched_smp.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/queue.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SMP_CALL
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This wraps the function of a synchronous call so that the caller can
+ * tell when the function has returned on every target CPU.
+ */
+
+struct smp_call_wait_s
+{
+  nxsched_smp_call_t func;  /* The caller's function */
+  FAR void *arg;            /* The caller's argument */
+  int pending;              /* Targets that have not yet returned */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The per-CPU request queues.  Each is a lock-free stack that any CPU may
+ * push onto but that only the owning CPU empties.
+ */
+
+static FAR struct smp_call_node_s *g_smp_call_queue[CONFIG_SMP_NCPUS];
+
+/* The per-CPU reschedule requests used by nxsched_smp_resched() */
+
+static struct smp_call_data_s g_smp_resched[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_smp_call_push
+ *
+ * Description:
+ *   Push a request node onto the queue of 'cpu'.
+ *
+ * Returned Value:
+ *   True if the queue was empty.  Only then must the CPU be interrupted;
+ *   otherwise an interrupt is already pending for the batch.
+ *
+ ****************************************************************************/
+
+static bool nxsched_smp_call_push(int cpu, FAR struct smp_call_node_s *node)
+{
+  FAR struct smp_call_node_s *head;
+
+  head = __atomic_load_n(&g_smp_call_queue[cpu], __ATOMIC_RELAXED);
+  do
+    {
+      node->flink = head;
+    }
+  while (!__atomic_compare_exchange_n(&g_smp_call_queue[cpu], &head, node,
+                                      true, __ATOMIC_RELEASE,
+                                      __ATOMIC_RELAXED));
+
+  return head == NULL;
+}
+
+/****************************************************************************
+ * Name: nxsched_smp_call_wait
+ *
+ * Description:
+ *   Run the function of a synchronous call and report its completion.
+ *
+ ****************************************************************************/
+
+static int nxsched_smp_call_wait(FAR void *arg)
+{
+  FAR struct smp_call_wait_s *wait = arg;
+  int ret;
+
+  ret = wait->func(wait->arg);
+  __atomic_fetch_sub(&wait->pending, 1, __ATOMIC_RELEASE);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxsched_smp_resched_handler
+ *
+ * Description:
+ *   Run on a CPU that was asked to reschedule by nxsched_smp_resched().
+ *   Take the highest priority task waiting in the g_readytorun list that
+ *   may run on this CPU and that has a higher priority than the task
+ *   running here.
+ *
+ ****************************************************************************/
+
+static int nxsched_smp_resched_handler(FAR void *arg)
+{
+  FAR struct tcb_s *rtcb;
+  FAR struct tcb_s *btcb;
+  irqstate_t flags;
+  int me;
+
+  flags = enter_critical_section();
+
+  me   = this_cpu();
+  rtcb = current_task(me);
+
+  for (btcb = (FAR struct tcb_s *)g_readytorun.head;
+       btcb != NULL && btcb->sched_priority > rtcb->sched_priority;
+       btcb = btcb->flink)
+    {
+      if (CPU_ISSET(me, &btcb->affinity))
+        {
+          /* The task may still go to another CPU if that CPU now runs
+           * a lower priority task than this one.
+           */
+
+          dq_rem((FAR dq_entry_t *)btcb, &g_readytorun);
+          if (nxsched_add_readytorun(btcb))
+            {
+              up_switch_context(this_task(), rtcb);
+            }
+
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_smp_call_init
+ *
+ * Description:
+ *   Initialize a request for nxsched_smp_call_async().
+ *
+ * Input Parameters:
+ *   data - The request to initialize
+ *   func - The function to run on each target CPU
+ *   arg  - The argument passed to 'func'
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_smp_call_init(FAR struct smp_call_data_s *data,
+                           nxsched_smp_call_t func, FAR void *arg)
+{
+  int cpu;
+
+  data->func      = func;
+  data->arg       = arg;
+  data->remaining = 0;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      data->node[cpu].flink = NULL;
+      data->node[cpu].data  = data;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_smp_call_async
+ *
+ * Description:
+ *   Queue a request to run a function on each CPU in 'cpuset' and return
+ *   without waiting.  The calling CPU, if present, is removed from
+ *   'cpuset'.
+ *
+ * Input Parameters:
+ *   cpuset - The set of CPUs to run the function on
+ *   data   - The request initialized by nxsched_smp_call_init()
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  -EBUSY is returned if 'data' is
+ *   still queued from a previous call.
+ *
+ ****************************************************************************/
+
+int nxsched_smp_call_async(cpu_set_t cpuset,
+                           FAR struct smp_call_data_s *data)
+{
+  irqstate_t flags;
+  cpu_set_t ipiset;
+  int expected = 0;
+  int ret = OK;
+  int cpu;
+
+  /* Keep this CPU from changing under us */
+
+  flags = up_irq_save();
+
+  CPU_CLR(this_cpu(), &cpuset);
+  if (CPU_COUNT(&cpuset) == 0)
+    {
+      goto out;
+    }
+
+  /* Claim the request.  The count must be set before the first node is
+   * visible to a target CPU.
+   */
+
+  if (!__atomic_compare_exchange_n(&data->remaining, &expected,
+                                   CPU_COUNT(&cpuset), false,
+                                   __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+    {
+      ret = -EBUSY;
+      goto out;
+    }
+
+  CPU_ZERO(&ipiset);
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (CPU_ISSET(cpu, &cpuset) &&
+          nxsched_smp_call_push(cpu, &data->node[cpu]))
+        {
+          CPU_SET(cpu, &ipiset);
+        }
+    }
+
+  /* One interrupt per CPU whose queue was empty */
+
+  if (CPU_COUNT(&ipiset) > 0)
+    {
+      up_send_smp_call(ipiset);
+    }
+
+out:
+  up_irq_restore(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxsched_smp_call
+ *
+ * Description:
+ *   Run 'func' on each CPU in 'cpuset' and wait until it has completed on
+ *   all of them.
+ *
+ * Input Parameters:
+ *   cpuset - The set of CPUs to run the function on
+ *   func   - The function to run
+ *   arg    - The argument passed to 'func'
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int nxsched_smp_call(cpu_set_t cpuset, nxsched_smp_call_t func,
+                     FAR void *arg)
+{
+  struct smp_call_data_s data;
+  struct smp_call_wait_s wait;
+  irqstate_t flags;
+  bool local;
+  int ret;
+  int me;
+
+  DEBUGASSERT(func != NULL && !up_interrupt_context());
+
+  /* Stay on this CPU until the local call has been made */
+
+  sched_lock();
+
+  me    = this_cpu();
+  local = CPU_ISSET(me, &cpuset);
+  CPU_CLR(me, &cpuset);
+
+  wait.func    = func;
+  wait.arg     = arg;
+  wait.pending = CPU_COUNT(&cpuset);
+
+  nxsched_smp_call_init(&data, nxsched_smp_call_wait, &wait);
+  ret = nxsched_smp_call_async(cpuset, &data);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (local)
+    {
+      flags = up_irq_save();
+      func(arg);
+      up_irq_restore(flags);
+    }
+
+  while (__atomic_load_n(&wait.pending, __ATOMIC_ACQUIRE) > 0)
+    {
+    }
+
+errout:
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxsched_smp_call_handler
+ *
+ * Description:
+ *   This is the handler of the inter-processor interrupt raised by
+ *   up_send_smp_call().  It runs every request queued for this CPU in the
+ *   order in which they were queued.
+ *
+ * Input Parameters:
+ *   Standard interrupt handling
+ *
+ * Returned Value:
+ *   Zero (OK) is always returned.
+ *
+ ****************************************************************************/
+
+int nxsched_smp_call_handler(int irq, FAR void *context, FAR void *arg)
+{
+  FAR struct smp_call_node_s *node;
+  FAR struct smp_call_node_s *next;
+  FAR struct smp_call_node_s *list = NULL;
+  FAR struct smp_call_data_s *data;
+  nxsched_smp_call_t func;
+  FAR void *funcarg;
+
+  /* Take the whole batch.  Requests queued from now on raise a new
+   * interrupt.
+   */
+
+  node = __atomic_exchange_n(&g_smp_call_queue[this_cpu()], NULL,
+                             __ATOMIC_ACQUIRE);
+
+  /* The queue is a stack; reverse it to run the requests in order */
+
+  while (node != NULL)
+    {
+      next        = node->flink;
+      node->flink = list;
+      list        = node;
+      node        = next;
+    }
+
+  while (list != NULL)
+    {
+      node    = list;
+      list    = node->flink;
+      data    = node->data;
+      func    = data->func;
+      funcarg = data->arg;
+
+      /* Release the request before running it so that the function may
+       * queue the same request again.
+       */
+
+      __atomic_fetch_sub(&data->remaining, 1, __ATOMIC_RELEASE);
+      func(funcarg);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_smp_resched
+ *
+ * Description:
+ *   Ask 'cpu' to switch to a higher priority task that was left in the
+ *   g_readytorun list for it.  This replaces pausing 'cpu' in order to
+ *   change the head of its g_assignedtasks[] list from another CPU.
+ *
+ * Input Parameters:
+ *   cpu - The CPU that should reschedule
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_smp_resched(int cpu)
+{
+  FAR struct smp_call_data_s *data = &g_smp_resched[cpu];
+  cpu_set_t cpuset;
+
+  if (data->func == NULL)
+    {
+      nxsched_smp_call_init(data, nxsched_smp_resched_handler, NULL);
+    }
+
+  /* -EBUSY means a request is already queued and not yet started.  It
+   * will see the new task too.
+   */
+
+  CPU_ZERO(&cpuset);
+  CPU_SET(cpu, &cpuset);
+  nxsched_smp_call_async(cpuset, data);
+}
+
+#endif /* CONFIG_SMP_CALL */
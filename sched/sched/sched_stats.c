@@ -0,0 +1,172 @@
+/****************************************************************************
+ * sched/sched/sched_stats.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_STATS
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* System-wide wakeup latency histogram and maximum (usec) */
+
+uint32_t g_schedlat_hist[CONFIG_SCHED_STATS_NHIST];
+uint32_t g_schedlat_max;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_stats_bucket
+ *
+ * Description:
+ *   Return the histogram bucket of a latency in microseconds.
+ *
+ ****************************************************************************/
+
+static inline int nxsched_stats_bucket(uint32_t usec)
+{
+  int bucket = usec != 0 ? fls(usec) : 0;
+
+  return bucket < CONFIG_SCHED_STATS_NHIST ?
+         bucket : CONFIG_SCHED_STATS_NHIST - 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_wakeup_stats
+ *
+ * Description:
+ *   Called when a thread leaves a blocked state.  The wakeup latency is
+ *   measured from now until the thread actually runs.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_wakeup_stats(FAR struct tcb_s *tcb)
+{
+  tcb->stat_wakeup = up_perf_gettime();
+  tcb->stat_waking = true;
+}
+
+/****************************************************************************
+ * Name: nxsched_resume_stats
+ *
+ * Description:
+ *   Called when a thread resumes execution.  Completes a pending wakeup
+ *   latency measurement.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_resume_stats(FAR struct tcb_s *tcb)
+{
+  unsigned long current = up_perf_gettime();
+  uint64_t usec;
+  uint32_t latency;
+
+  tcb->stat_start = current;
+
+  if (!tcb->stat_waking)
+    {
+      return;
+    }
+
+  tcb->stat_waking = false;
+
+  usec    = (uint64_t)(current - tcb->stat_wakeup) * USEC_PER_SEC /
+            up_perf_getfreq();
+  latency = usec < UINT32_MAX ? (uint32_t)usec : UINT32_MAX;
+
+  tcb->stat_wakeups++;
+  tcb->stat_lathist[nxsched_stats_bucket(latency)]++;
+  if (latency > tcb->stat_latmax)
+    {
+      tcb->stat_latmax = latency;
+    }
+
+  /* The idle threads never wait, so this only ever counts real work */
+
+  g_schedlat_hist[nxsched_stats_bucket(latency)]++;
+  if (latency > g_schedlat_max)
+    {
+      g_schedlat_max = latency;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_suspend_stats
+ *
+ * Description:
+ *   Called when a thread suspends execution.  Accounts the run time and
+ *   classifies the switch as voluntary (the thread blocked) or involuntary
+ *   (the thread was preempted while still ready-to-run).
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_suspend_stats(FAR struct tcb_s *tcb)
+{
+  tcb->stat_runtime += up_perf_gettime() - tcb->stat_start;
+
+  /* A thread that is still ready-to-run (or pending a preemption unlock)
+   * was preempted.  Otherwise it blocked or exited.
+   */
+
+  if (tcb->task_state >= TSTATE_TASK_PENDING &&
+      tcb->task_state <= LAST_READY_TO_RUN_STATE)
+    {
+      tcb->stat_involuntary++;
+    }
+  else
+    {
+      tcb->stat_voluntary++;
+    }
+}
+
+#endif /* CONFIG_SCHED_STATS */
@@ -73,6 +73,12 @@ void nxsched_suspend_scheduler(FAR struct tcb_s *tcb)
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_suspend_critmon(tcb);
 #endif
+#ifdef CONFIG_SCHED_STATS
+  nxsched_suspend_stats(tcb);
+#endif
+#ifdef CONFIG_SCHED_PERFCOUNT
+  nxsched_suspend_perfcount(tcb);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_suspend(tcb);
 #endif
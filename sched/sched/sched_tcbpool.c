@@ -0,0 +1,293 @@
+/****************************************************************************
+ * sched/sched/sched_tcbpool.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_DISABLE_PTHREAD
+#  undef  CONFIG_PTHREAD_TCB_POOLSIZE
+#  define CONFIG_PTHREAD_TCB_POOLSIZE 0
+#endif
+
+#if CONFIG_TASK_TCB_POOLSIZE > 0 || CONFIG_PTHREAD_TCB_POOLSIZE > 0
+#  define HAVE_TCB_POOL
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The TCBs of exited threads of one type, linked through their flink
+ * field.
+ */
+
+#ifdef HAVE_TCB_POOL
+struct tcbpool_s
+{
+  FAR struct tcb_s *head;
+  int count;
+  int limit;
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef HAVE_TCB_POOL
+static struct tcbpool_s g_taskpool =
+{
+  NULL, 0, CONFIG_TASK_TCB_POOLSIZE
+};
+
+#  if CONFIG_PTHREAD_TCB_POOLSIZE > 0
+static struct tcbpool_s g_pthreadpool =
+{
+  NULL, 0, CONFIG_PTHREAD_TCB_POOLSIZE
+};
+#  endif
+
+static spinlock_t g_tcbpool_lock;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_tcbsize
+ ****************************************************************************/
+
+static size_t nxsched_tcbsize(uint8_t ttype)
+{
+#ifndef CONFIG_DISABLE_PTHREAD
+  if (ttype == TCB_FLAG_TTYPE_PTHREAD)
+    {
+      return sizeof(struct pthread_tcb_s);
+    }
+#endif
+
+  return sizeof(struct task_tcb_s);
+}
+
+/****************************************************************************
+ * Name: nxsched_tcbpool
+ *
+ * Description:
+ *   Return the pool for TCBs of type 'ttype', or NULL if they are not
+ *   pooled.  Kernel threads are not pooled because their stacks come from
+ *   another heap.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_TCB_POOL
+static FAR struct tcbpool_s *nxsched_tcbpool(uint8_t ttype)
+{
+  if (ttype == TCB_FLAG_TTYPE_TASK && g_taskpool.limit > 0)
+    {
+      return &g_taskpool;
+    }
+
+#  if CONFIG_PTHREAD_TCB_POOLSIZE > 0
+  if (ttype == TCB_FLAG_TTYPE_PTHREAD)
+    {
+      return &g_pthreadpool;
+    }
+#  endif
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_alloc_tcb
+ *
+ * Description:
+ *   Allocate a zeroed TCB for a new thread.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_alloc_tcb(uint8_t ttype, size_t stack_size)
+{
+  FAR struct tcb_s *tcb = NULL;
+#ifdef HAVE_TCB_POOL
+  FAR struct tcbpool_s *pool;
+  FAR struct tcb_s *prev = NULL;
+  FAR struct tcb_s *best = NULL;
+  FAR struct tcb_s *bestprev = NULL;
+  FAR void *stack;
+  size_t stacksize;
+  irqstate_t flags;
+
+  pool = nxsched_tcbpool(ttype);
+  if (pool != NULL)
+    {
+      /* Prefer a TCB that holds a stack of the requested size; otherwise
+       * take the most recently released one.
+       */
+
+      flags = spin_lock_irqsave(&g_tcbpool_lock);
+      for (tcb = pool->head; tcb != NULL; prev = tcb, tcb = tcb->flink)
+        {
+          if (tcb->stack_alloc_ptr != NULL &&
+              tcb->adj_stack_size == stack_size)
+            {
+              best     = tcb;
+              bestprev = prev;
+              break;
+            }
+        }
+
+      if (best == NULL)
+        {
+          best = pool->head;
+        }
+
+      if (best != NULL)
+        {
+          if (bestprev != NULL)
+            {
+              bestprev->flink = best->flink;
+            }
+          else
+            {
+              pool->head = best->flink;
+            }
+
+          pool->count--;
+        }
+
+      spin_unlock_irqrestore(&g_tcbpool_lock, flags);
+    }
+
+  tcb = best;
+  if (tcb != NULL)
+    {
+      /* Keep the stack of the previous owner, if any */
+
+      stack     = tcb->stack_alloc_ptr;
+      stacksize = tcb->adj_stack_size;
+
+      memset(tcb, 0, nxsched_tcbsize(ttype));
+      tcb->flags = ttype;
+
+      if (stack != NULL)
+        {
+          tcb->stack_alloc_ptr = stack;
+          tcb->stack_base_ptr  = stack;
+          tcb->adj_stack_size  = stacksize;
+          tcb->flags          |= TCB_FLAG_FREE_STACK;
+        }
+
+      return tcb;
+    }
+#endif
+
+  tcb = kmm_zalloc_attr(nxsched_tcbsize(ttype), MM_FAST);
+  if (tcb != NULL)
+    {
+      tcb->flags = ttype;
+    }
+
+  return tcb;
+}
+
+/****************************************************************************
+ * Name: nxsched_free_tcb
+ *
+ * Description:
+ *   Release a TCB allocated by nxsched_alloc_tcb(), or a TCB whose
+ *   resources have been released by nxsched_release_tcb().
+ *
+ ****************************************************************************/
+
+void nxsched_free_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
+{
+#ifdef HAVE_TCB_POOL
+  FAR struct tcbpool_s *pool;
+  irqstate_t flags;
+#endif
+
+#ifdef CONFIG_BUILD_KERNEL
+  /* The stack of a user thread lies in its address environment, which
+   * may be gone by now.  nxsched_release_tcb() has already dealt with it.
+   */
+
+  if (ttype != TCB_FLAG_TTYPE_KERNEL)
+    {
+      tcb->stack_alloc_ptr = NULL;
+      tcb->flags          &= ~TCB_FLAG_FREE_STACK;
+    }
+#endif
+
+#ifdef HAVE_TCB_POOL
+  pool = nxsched_tcbpool(ttype);
+  if (pool != NULL)
+    {
+      /* Only a stack that the TCB owns may go with it */
+
+      if (tcb->stack_alloc_ptr != NULL &&
+          (tcb->flags & TCB_FLAG_FREE_STACK) == 0)
+        {
+          up_release_stack(tcb, ttype);
+        }
+
+      flags = spin_lock_irqsave(&g_tcbpool_lock);
+      if (pool->count < pool->limit)
+        {
+          tcb->flink = pool->head;
+          pool->head = tcb;
+          pool->count++;
+          spin_unlock_irqrestore(&g_tcbpool_lock, flags);
+          return;
+        }
+
+      spin_unlock_irqrestore(&g_tcbpool_lock, flags);
+    }
+#endif
+
+  if (tcb->stack_alloc_ptr != NULL)
+    {
+      up_release_stack(tcb, ttype);
+    }
+
+  kmm_free(tcb);
+}
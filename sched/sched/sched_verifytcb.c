@@ -68,12 +68,5 @@ bool nxsched_verify_tcb(FAR struct tcb_s *tcb)
    * information available.
    */
 
-  irqstate_t flags;
-  bool valid;
-
-  flags = enter_critical_section();
-  valid = tcb == g_pidhash[PIDHASH(tcb->pid)];
-  leave_critical_section(flags);
-
-  return valid;
+  return tcb == nxsched_get_tcb(tcb->pid);
 }
@@ -0,0 +1,311 @@
+/****************************************************************************
+ * sched/semaphore/lockstat.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/lockstat.h>
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A mutex or spinlock that is currently held */
+
+struct lockstat_held_s
+{
+  FAR const void *lock;             /* Address of the held lock */
+  FAR struct lockstat_s *stat;      /* Entry charged with the hold time */
+  unsigned long start;              /* up_perf_gettime() at acquisition */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct lockstat_s g_lockstat[CONFIG_SCHED_LOCKSTAT_NENTRIES];
+static struct lockstat_held_s g_lockstat_held[CONFIG_SCHED_LOCKSTAT_NHELD];
+static uint32_t g_lockstat_dropped;
+
+/* Protects the tables above.  Only the uninstrumented spinlock interfaces
+ * may be used here since spin_lock() itself reports to this module.
+ */
+
+static spinlock_t g_lockstat_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lockstat_hash
+ ****************************************************************************/
+
+static inline uintptr_t lockstat_hash(FAR const void *lock,
+                                      FAR void *caller)
+{
+  uintptr_t key = ((uintptr_t)lock >> 2) ^ ((uintptr_t)caller >> 1);
+
+  key ^= key >> 11;
+  key ^= key >> 17;
+  return key;
+}
+
+/****************************************************************************
+ * Name: lockstat_lookup
+ *
+ * Description:
+ *   Find the entry of a (lock, caller) pair, claiming a free one if the
+ *   pair has not been seen before.  Returns NULL if the table is full.
+ *
+ * Assumptions:
+ *   g_lockstat_lock is held.
+ *
+ ****************************************************************************/
+
+static FAR struct lockstat_s *lockstat_lookup(FAR const void *lock,
+                                              uint8_t type,
+                                              FAR void *caller)
+{
+  FAR struct lockstat_s *stat;
+  uintptr_t index = lockstat_hash(lock, caller);
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_LOCKSTAT_NENTRIES; i++, index++)
+    {
+      stat = &g_lockstat[index % CONFIG_SCHED_LOCKSTAT_NENTRIES];
+
+      if (stat->lock == lock && stat->caller == caller)
+        {
+          return stat;
+        }
+
+      if (stat->lock == NULL)
+        {
+          stat->lock   = lock;
+          stat->caller = caller;
+          stat->type   = type;
+          return stat;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lockstat_acquire
+ *
+ * Description:
+ *   Record a successful acquisition of a lock.  For mutexes and spinlocks
+ *   the hold time is measured until the matching lockstat_release().
+ *
+ * Input Parameters:
+ *   lock      - The address of the lock
+ *   type      - The type of the lock, one of LOCKSTAT_*
+ *   caller    - The call site, normally LOCKSTAT_CALLER()
+ *   start     - up_perf_gettime() when the acquisition was started
+ *   contended - True if the lock was not immediately available
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void lockstat_acquire(FAR const void *lock, uint8_t type,
+                      FAR void *caller, unsigned long start,
+                      bool contended)
+{
+  FAR struct lockstat_held_s *held;
+  FAR struct lockstat_s *stat;
+  unsigned long now = up_perf_gettime();
+  unsigned long wait = now - start;
+  irqstate_t flags;
+  uintptr_t index;
+  int i;
+
+  flags = spin_lock_irqsave_wo_note(&g_lockstat_lock);
+
+  stat = lockstat_lookup(lock, type, caller);
+  if (stat == NULL)
+    {
+      g_lockstat_dropped++;
+      goto out;
+    }
+
+  stat->acquires++;
+  stat->waittotal += wait;
+  if (contended)
+    {
+      stat->contended++;
+    }
+
+  if (wait > stat->waitmax)
+    {
+      stat->waitmax = wait;
+    }
+
+  /* Semaphores are signalled rather than released by their holder, so
+   * only the wait time is meaningful for them.
+   */
+
+  if (type == LOCKSTAT_SEM)
+    {
+      goto out;
+    }
+
+  index = lockstat_hash(lock, NULL);
+  for (i = 0; i < CONFIG_SCHED_LOCKSTAT_NHELD; i++, index++)
+    {
+      held = &g_lockstat_held[index % CONFIG_SCHED_LOCKSTAT_NHELD];
+      if (held->lock == NULL)
+        {
+          held->lock  = lock;
+          held->stat  = stat;
+          held->start = now;
+          break;
+        }
+    }
+
+out:
+  spin_unlock_irqrestore_wo_note(&g_lockstat_lock, flags);
+}
+
+/****************************************************************************
+ * Name: lockstat_release
+ *
+ * Description:
+ *   Record the release of a mutex or spinlock and account its hold time.
+ *
+ * Input Parameters:
+ *   lock - The address of the lock
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void lockstat_release(FAR const void *lock)
+{
+  FAR struct lockstat_held_s *held;
+  unsigned long now = up_perf_gettime();
+  unsigned long hold;
+  irqstate_t flags;
+  uintptr_t index;
+  int i;
+
+  flags = spin_lock_irqsave_wo_note(&g_lockstat_lock);
+
+  index = lockstat_hash(lock, NULL);
+  for (i = 0; i < CONFIG_SCHED_LOCKSTAT_NHELD; i++, index++)
+    {
+      held = &g_lockstat_held[index % CONFIG_SCHED_LOCKSTAT_NHELD];
+      if (held->lock == lock)
+        {
+          hold = now - held->start;
+
+          held->stat->holds++;
+          held->stat->holdtotal += hold;
+          if (hold > held->stat->holdmax)
+            {
+              held->stat->holdmax = hold;
+            }
+
+          held->lock = NULL;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore_wo_note(&g_lockstat_lock, flags);
+}
+
+/****************************************************************************
+ * Name: lockstat_foreach
+ *
+ * Description:
+ *   Call 'handler' with a snapshot of every recorded (lock, caller) pair.
+ *   The handler is called without any lock held.
+ *
+ * Input Parameters:
+ *   handler - The function to call for each entry
+ *   arg     - An opaque argument passed to the handler
+ *
+ * Returned Value:
+ *   The number of events dropped because the table was full.
+ *
+ ****************************************************************************/
+
+uint32_t lockstat_foreach(lockstat_handler_t handler, FAR void *arg)
+{
+  struct lockstat_s stat;
+  irqstate_t flags;
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_LOCKSTAT_NENTRIES; i++)
+    {
+      flags = spin_lock_irqsave_wo_note(&g_lockstat_lock);
+      memcpy(&stat, &g_lockstat[i], sizeof(struct lockstat_s));
+      spin_unlock_irqrestore_wo_note(&g_lockstat_lock, flags);
+
+      if (stat.lock != NULL)
+        {
+          handler(&stat, arg);
+        }
+    }
+
+  return g_lockstat_dropped;
+}
+
+/****************************************************************************
+ * Name: lockstat_reset
+ *
+ * Description:
+ *   Discard all statistics collected so far.  Locks that are currently
+ *   held are not measured on release.
+ *
+ ****************************************************************************/
+
+void lockstat_reset(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave_wo_note(&g_lockstat_lock);
+  memset(g_lockstat, 0, sizeof(g_lockstat));
+  memset(g_lockstat_held, 0, sizeof(g_lockstat_held));
+  g_lockstat_dropped = 0;
+  spin_unlock_irqrestore_wo_note(&g_lockstat_lock, flags);
+}
+
+#endif /* CONFIG_SCHED_LOCKSTAT */
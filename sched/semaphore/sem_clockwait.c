@@ -159,7 +159,8 @@ int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
 
   /* Start the watchdog */
 
-  wd_start(&rtcb->waitdog, ticks, nxsem_timeout, nxsched_gettid());
+  wd_start_slack(&rtcb->waitdog, ticks, nxsched_timerslack(rtcb),
+                 nxsem_timeout, nxsched_gettid());
 
   /* Now perform the blocking wait.  If nxsem_wait() fails, the
    * negated errno value will be returned below.
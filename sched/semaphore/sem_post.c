@@ -78,6 +78,17 @@ int nxsem_post(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL);
 
+#ifdef NXSEM_FASTPATH
+  /* Give the count without the critical section if nobody is waiting and
+   * no holder needs to be released.
+   */
+
+  if (nxsem_fastpath_ok(sem) && nxsem_count_tryinc(sem))
+    {
+      return OK;
+    }
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because sem_post() may be called from an interrupt
    * handler.
@@ -113,8 +124,7 @@ int nxsem_post(FAR sem_t *sem)
    */
 
   nxsem_release_holder(sem);
-  sem_count++;
-  sem->semcount = sem_count;
+  sem_count = nxsem_count_add(sem, 1);
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
   /* Don't let any unblocked tasks run until we complete any priority
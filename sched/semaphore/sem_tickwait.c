@@ -105,7 +105,8 @@ int nxsem_tickwait(FAR sem_t *sem, uint32_t delay)
 
   /* Start the watchdog with interrupts still disabled */
 
-  wd_start(&rtcb->waitdog, delay, nxsem_timeout, nxsched_gettid());
+  wd_start_slack(&rtcb->waitdog, delay, nxsched_timerslack(rtcb),
+                 nxsem_timeout, nxsched_gettid());
 
   /* Now perform the blocking wait */
 
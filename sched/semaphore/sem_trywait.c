@@ -76,6 +76,23 @@ int nxsem_trywait(FAR sem_t *sem)
   DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask() ||
               up_interrupt_context());
 
+#ifdef NXSEM_FASTPATH
+  /* Take an uncontended count without the critical section if no holder
+   * needs to be recorded.
+   */
+
+  if (nxsem_fastpath_ok(sem))
+    {
+      if (!nxsem_count_trydec(sem))
+        {
+          return -EAGAIN;
+        }
+
+      rtcb->waitobj = NULL;
+      return OK;
+    }
+#endif
+
   /* The following operations must be performed with interrupts disabled
    * because sem_post() may be called from an interrupt handler.
    */
@@ -84,11 +101,10 @@ int nxsem_trywait(FAR sem_t *sem)
 
   /* If the semaphore is available, give it to the requesting task */
 
-  if (sem->semcount > 0)
+  if (nxsem_count_trydec(sem))
     {
       /* It is, let the task take the semaphore */
 
-      sem->semcount--;
       nxsem_add_holder(sem);
       rtcb->waitobj = NULL;
       ret = OK;
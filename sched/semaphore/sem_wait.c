@@ -32,10 +32,34 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/cancelpt.h>
+#include <nuttx/lockstat.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Mutexes are reported by nxmutex_lock(), which knows the real caller and
+ * also measures the hold time.
+ */
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+#  define nxsem_lockstat(sem, start, contended) \
+     do \
+       { \
+         if (((sem)->flags & SEM_TYPE_MUTEX) == 0) \
+           { \
+             lockstat_acquire(sem, LOCKSTAT_SEM, LOCKSTAT_CALLER(), \
+                              start, contended); \
+           } \
+       } \
+     while (0)
+#else
+#  define nxsem_lockstat(sem, start, contended)
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -74,12 +98,29 @@ int nxsem_wait(FAR sem_t *sem)
   irqstate_t flags;
   bool switch_needed;
   int ret;
+#ifdef CONFIG_SCHED_LOCKSTAT
+  unsigned long start = up_perf_gettime();
+  bool contended = false;
+#endif
 
   /* This API should not be called from interrupt handlers & idleloop */
 
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
   DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask());
 
+#ifdef NXSEM_FASTPATH
+  /* Take an uncontended count without the critical section if no holder
+   * needs to be recorded.
+   */
+
+  if (nxsem_fastpath_ok(sem) && nxsem_count_trydec(sem))
+    {
+      rtcb->waitobj = NULL;
+      nxsem_lockstat(sem, start, false);
+      return OK;
+    }
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -89,13 +130,12 @@ int nxsem_wait(FAR sem_t *sem)
 
   /* Make sure we were supplied with a valid semaphore. */
 
-  /* Check if the lock is available */
+  /* Take a count.  The lock was available if the count was positive. */
 
-  if (sem->semcount > 0)
+  if (nxsem_count_add(sem, -1) >= 0)
     {
-      /* It is, let the task take the semaphore. */
+      /* It was, let the task take the semaphore. */
 
-      sem->semcount--;
       nxsem_add_holder(sem);
       rtcb->waitobj = NULL;
       ret = OK;
@@ -117,9 +157,13 @@ int nxsem_wait(FAR sem_t *sem)
 
       DEBUGASSERT(rtcb->waitobj == NULL);
 
-      /* Handle the POSIX semaphore (but don't set the owner yet) */
+#ifdef CONFIG_SCHED_LOCKSTAT
+      contended = true;
+#endif
 
-      sem->semcount--;
+      /* The POSIX semaphore count was already decremented above (but
+       * don't set the owner yet).
+       */
 
       /* Save the waited on semaphore in the TCB */
 
@@ -217,6 +261,12 @@ int nxsem_wait(FAR sem_t *sem)
     }
 
   leave_critical_section(flags);
+
+  if (ret == OK)
+    {
+      nxsem_lockstat(sem, start, contended);
+    }
+
   return ret;
 }
 
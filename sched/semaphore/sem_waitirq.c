@@ -99,7 +99,7 @@ void nxsem_wait_irq(FAR struct tcb_s *wtcb, int errcode)
    * place.
    */
 
-  sem->semcount++;
+  nxsem_count_add(sem, 1);
 
   /* Remove task from waiting list */
 
@@ -91,6 +91,101 @@ void nxsem_release_all(FAR struct tcb_s *stcb);
 #  define nxsem_release_all(stcb)
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_fastpath_ok
+ *
+ * Description:
+ *   Return true if counts on this semaphore may be taken and given without
+ *   the critical section.  That is not possible for semaphores that track
+ *   their holders for priority inheritance.
+ *
+ ****************************************************************************/
+
+#ifdef NXSEM_FASTPATH
+static inline bool nxsem_fastpath_ok(FAR sem_t *sem)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  return (sem->flags & SEM_PRIO_MASK) == SEM_PRIO_NONE;
+#else
+  return true;
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: nxsem_count_trydec
+ *
+ * Description:
+ *   Atomically take one count if the semaphore count is positive.
+ *
+ * Returned Value:
+ *   true if a count was taken; false if the semaphore was not available.
+ *
+ ****************************************************************************/
+
+static inline bool nxsem_count_trydec(FAR sem_t *sem)
+{
+  int16_t count = sem->semcount;
+
+#ifdef NXSEM_FASTPATH
+  while (count > 0)
+    {
+      if (__atomic_compare_exchange_n(&sem->semcount, &count, count - 1,
+                                      false, __ATOMIC_ACQUIRE,
+                                      __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+
+  return false;
+#else
+  if (count > 0)
+    {
+      sem->semcount = count - 1;
+      return true;
+    }
+
+  return false;
+#endif
+}
+
+/****************************************************************************
+ * Name: nxsem_count_tryinc
+ *
+ * Description:
+ *   Atomically give one count if no thread is waiting on the semaphore and
+ *   the count would not overflow.
+ *
+ * Returned Value:
+ *   true if the count was given; false if the caller must take the slow
+ *   path.
+ *
+ ****************************************************************************/
+
+#ifdef NXSEM_FASTPATH
+static inline bool nxsem_count_tryinc(FAR sem_t *sem)
+{
+  int16_t count = sem->semcount;
+
+  while (count >= 0 && count < SEM_VALUE_MAX)
+    {
+      if (__atomic_compare_exchange_n(&sem->semcount, &count, count + 1,
+                                      false, __ATOMIC_RELEASE,
+                                      __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
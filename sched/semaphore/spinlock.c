@@ -28,7 +28,9 @@
 #include <sched.h>
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/spinlock.h>
+#include <nuttx/lockstat.h>
 #include <nuttx/sched_note.h>
 #include <arch/irq.h>
 
@@ -36,6 +38,233 @@
 
 #ifdef CONFIG_SPINLOCK
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Serializes ticket and rwlock updates on architectures where the lock
+ * word cannot be updated with a lock-free compare-and-swap.  Only the
+ * short update is done under this lock; waiting for the lock itself
+ * happens outside of it.
+ */
+
+static volatile spinlock_t g_cmpxchg_guard = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cmpxchg_guard_enter / cmpxchg_guard_leave
+ *
+ * Description:
+ *   Take and release g_cmpxchg_guard with local interrupts disabled, using
+ *   only the architecture up_testset() primitive.
+ *
+ ****************************************************************************/
+
+static inline irqstate_t cmpxchg_guard_enter(void)
+{
+  irqstate_t flags = up_irq_save();
+
+  while (up_testset(&g_cmpxchg_guard) == SP_LOCKED)
+    {
+      SP_DSB();
+    }
+
+  return flags;
+}
+
+static inline void cmpxchg_guard_leave(irqstate_t flags)
+{
+  SP_DMB();
+  g_cmpxchg_guard = SP_UNLOCKED;
+  SP_DSB();
+  up_irq_restore(flags);
+}
+
+#ifdef CONFIG_TICKET_SPINLOCK
+
+/****************************************************************************
+ * Name: spin_cmpxchg
+ *
+ * Description:
+ *   Atomically replace the value of the spinlock word with 'newval' if it
+ *   still holds 'oldval'.  Lock-free atomics are used when the toolchain
+ *   provides them for spinlock_t; otherwise the update falls back to the
+ *   architecture up_testset() primitive.
+ *
+ * Input Parameters:
+ *   lock   - A reference to the spinlock object.
+ *   oldval - The expected current value.
+ *   newval - The value to store.
+ *
+ * Returned Value:
+ *   true if the value was replaced; false otherwise.
+ *
+ ****************************************************************************/
+
+static inline bool spin_cmpxchg(FAR volatile spinlock_t *lock,
+                                spinlock_t oldval, spinlock_t newval)
+{
+  irqstate_t flags;
+  bool ret = false;
+
+#ifdef CONFIG_HAVE_ATOMICS
+  if (__atomic_always_lock_free(sizeof(spinlock_t), 0))
+    {
+      return __atomic_compare_exchange_n(lock, &oldval, newval, false,
+                                         __ATOMIC_ACQ_REL,
+                                         __ATOMIC_RELAXED);
+    }
+#endif
+
+  flags = cmpxchg_guard_enter();
+
+  if (*lock == oldval)
+    {
+      *lock = newval;
+      ret = true;
+    }
+
+  cmpxchg_guard_leave(flags);
+  return ret;
+}
+
+#endif /* CONFIG_TICKET_SPINLOCK */
+
+/****************************************************************************
+ * Name: rwlock_cmpxchg
+ *
+ * Description:
+ *   Atomically replace the value of the rwlock word with 'newval' if it
+ *   still holds 'oldval'.
+ *
+ * Returned Value:
+ *   true if the value was replaced; false otherwise.
+ *
+ ****************************************************************************/
+
+static inline bool rwlock_cmpxchg(FAR volatile rwlock_t *lock,
+                                  rwlock_t oldval, rwlock_t newval)
+{
+  irqstate_t flags;
+  bool ret = false;
+
+#ifdef CONFIG_HAVE_ATOMICS
+  if (__atomic_always_lock_free(sizeof(rwlock_t), 0))
+    {
+      return __atomic_compare_exchange_n(lock, &oldval, newval, false,
+                                         __ATOMIC_ACQ_REL,
+                                         __ATOMIC_RELAXED);
+    }
+#endif
+
+  flags = cmpxchg_guard_enter();
+
+  if (*lock == oldval)
+    {
+      *lock = newval;
+      ret = true;
+    }
+
+  cmpxchg_guard_leave(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: spin_acquire
+ *
+ * Description:
+ *   Spin until the lock is owned by the caller.  With ticket spinlocks the
+ *   caller draws a ticket and then only reads the lock word until its
+ *   ticket is served, so waiters are granted the lock in FIFO order and do
+ *   not keep stealing the cache line from the holder.
+ *
+ ****************************************************************************/
+
+static inline void spin_acquire(FAR volatile spinlock_t *lock)
+{
+#ifdef CONFIG_TICKET_SPINLOCK
+  spinlock_t oldval;
+  spinlock_t ticket;
+
+  do
+    {
+      oldval = *lock;
+      ticket = SP_TICKET_NEXT(oldval);
+    }
+  while (!spin_cmpxchg(lock, oldval,
+                       (oldval & ~SP_TICKET_MASK) |
+                       SP_TICKET_NEXT(ticket + 1)));
+
+  while (SP_TICKET_OWNER(*lock) != ticket)
+    {
+      SP_DSB();
+      SP_WFE();
+    }
+#else
+  while (up_testset(lock) == SP_LOCKED)
+    {
+      SP_DSB();
+      SP_WFE();
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: spin_tryacquire
+ *
+ * Description:
+ *   Take the lock only if it is free.  A ticket is drawn only if it would
+ *   be served immediately.
+ *
+ ****************************************************************************/
+
+static inline bool spin_tryacquire(FAR volatile spinlock_t *lock)
+{
+#ifdef CONFIG_TICKET_SPINLOCK
+  spinlock_t oldval = *lock;
+
+  if (SP_TICKET_NEXT(oldval) != SP_TICKET_OWNER(oldval))
+    {
+      return false;
+    }
+
+  return spin_cmpxchg(lock, oldval, (oldval & ~SP_TICKET_MASK) |
+                                    SP_TICKET_NEXT(oldval + 1));
+#else
+  return up_testset(lock) == SP_UNLOCKED;
+#endif
+}
+
+/****************************************************************************
+ * Name: spin_release
+ *
+ * Description:
+ *   Release the lock, handing it to the next ticket holder if there is one.
+ *
+ ****************************************************************************/
+
+static inline void spin_release(FAR volatile spinlock_t *lock)
+{
+#ifdef CONFIG_TICKET_SPINLOCK
+  spinlock_t oldval;
+  spinlock_t owner;
+
+  do
+    {
+      oldval = *lock;
+      owner  = SP_TICKET_OWNER(oldval) + 1;
+    }
+  while (!spin_cmpxchg(lock, oldval,
+                       SP_TICKET_NEXT(oldval) |
+                       (SP_TICKET_NEXT(owner) << SP_TICKET_SHIFT)));
+#else
+  *lock = SP_UNLOCKED;
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -71,11 +300,23 @@ void spin_lock(FAR volatile spinlock_t *lock)
   sched_note_spinlock(this_task(), lock, NOTE_SPINLOCK_LOCK);
 #endif
 
-  while (up_testset(lock) == SP_LOCKED)
+#ifdef CONFIG_SCHED_LOCKSTAT
+  if (!spin_tryacquire(lock))
     {
-      SP_DSB();
-      SP_WFE();
+      unsigned long start = up_perf_gettime();
+
+      spin_acquire(lock);
+      lockstat_acquire((FAR const void *)lock, LOCKSTAT_SPINLOCK,
+                       LOCKSTAT_CALLER(), start, true);
+    }
+  else
+    {
+      lockstat_acquire((FAR const void *)lock, LOCKSTAT_SPINLOCK,
+                       LOCKSTAT_CALLER(), up_perf_gettime(), false);
     }
+#else
+  spin_acquire(lock);
+#endif
 
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   /* Notify that we have the spinlock */
@@ -109,11 +350,7 @@ void spin_lock(FAR volatile spinlock_t *lock)
 
 void spin_lock_wo_note(FAR volatile spinlock_t *lock)
 {
-  while (up_testset(lock) == SP_LOCKED)
-    {
-      SP_DSB();
-      SP_WFE();
-    }
+  spin_acquire(lock);
 
   SP_DMB();
 }
@@ -145,7 +382,7 @@ spinlock_t spin_trylock(FAR volatile spinlock_t *lock)
   sched_note_spinlock(this_task(), lock, NOTE_SPINLOCK_LOCK);
 #endif
 
-  if (up_testset(lock) == SP_LOCKED)
+  if (!spin_tryacquire(lock))
     {
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
       /* Notify that we abort for a spinlock */
@@ -156,6 +393,11 @@ spinlock_t spin_trylock(FAR volatile spinlock_t *lock)
       return SP_LOCKED;
     }
 
+#ifdef CONFIG_SCHED_LOCKSTAT
+  lockstat_acquire((FAR const void *)lock, LOCKSTAT_SPINLOCK,
+                   LOCKSTAT_CALLER(), up_perf_gettime(), false);
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
   /* Notify that we have the spinlock */
 
@@ -189,7 +431,7 @@ spinlock_t spin_trylock(FAR volatile spinlock_t *lock)
 
 spinlock_t spin_trylock_wo_note(FAR volatile spinlock_t *lock)
 {
-  if (up_testset(lock) == SP_LOCKED)
+  if (!spin_tryacquire(lock))
     {
       SP_DSB();
       return SP_LOCKED;
@@ -225,8 +467,12 @@ void spin_unlock(FAR volatile spinlock_t *lock)
   sched_note_spinlock(this_task(), lock, NOTE_SPINLOCK_UNLOCK);
 #endif
 
+#ifdef CONFIG_SCHED_LOCKSTAT
+  lockstat_release((FAR const void *)lock);
+#endif
+
   SP_DMB();
-  *lock = SP_UNLOCKED;
+  spin_release(lock);
   SP_DSB();
   SP_SEV();
 }
@@ -255,7 +501,7 @@ void spin_unlock(FAR volatile spinlock_t *lock)
 void spin_unlock_wo_note(FAR volatile spinlock_t *lock)
 {
   SP_DMB();
-  *lock = SP_UNLOCKED;
+  spin_release(lock);
   SP_DSB();
   SP_SEV();
 }
@@ -384,4 +630,164 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
 }
 #endif
 
+/****************************************************************************
+ * Name: read_lock
+ *
+ * Description:
+ *   Spin until no writer holds the lock, then take a reader reference.
+ *
+ * Input Parameters:
+ *   lock - A reference to the rwlock object to lock.
+ *
+ * Returned Value:
+ *   None.  The caller holds a reader reference upon return.
+ *
+ ****************************************************************************/
+
+void read_lock(FAR volatile rwlock_t *lock)
+{
+  while (!read_trylock(lock))
+    {
+      SP_DSB();
+      SP_WFE();
+    }
+}
+
+/****************************************************************************
+ * Name: read_trylock
+ *
+ * Description:
+ *   Take a reader reference only if no writer holds the lock.
+ *
+ * Input Parameters:
+ *   lock - A reference to the rwlock object to lock.
+ *
+ * Returned Value:
+ *   true if a reader reference was taken; false otherwise.
+ *
+ ****************************************************************************/
+
+bool read_trylock(FAR volatile rwlock_t *lock)
+{
+  rwlock_t oldval;
+
+  do
+    {
+      oldval = *lock;
+      if (oldval == RW_SP_WRITE_LOCKED)
+        {
+          return false;
+        }
+    }
+  while (!rwlock_cmpxchg(lock, oldval, oldval + 1));
+
+  SP_DMB();
+  return true;
+}
+
+/****************************************************************************
+ * Name: read_unlock
+ *
+ * Description:
+ *   Release a reader reference taken with read_lock() or read_trylock().
+ *
+ * Input Parameters:
+ *   lock - A reference to the rwlock object to unlock.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void read_unlock(FAR volatile rwlock_t *lock)
+{
+  rwlock_t oldval;
+
+  SP_DMB();
+
+  do
+    {
+      oldval = *lock;
+      DEBUGASSERT(oldval > 0);
+    }
+  while (!rwlock_cmpxchg(lock, oldval, oldval - 1));
+
+  SP_DSB();
+  SP_SEV();
+}
+
+/****************************************************************************
+ * Name: write_lock
+ *
+ * Description:
+ *   Spin until neither readers nor a writer hold the lock, then take it
+ *   exclusively.
+ *
+ * Input Parameters:
+ *   lock - A reference to the rwlock object to lock.
+ *
+ * Returned Value:
+ *   None.  The caller holds the lock exclusively upon return.
+ *
+ ****************************************************************************/
+
+void write_lock(FAR volatile rwlock_t *lock)
+{
+  while (!write_trylock(lock))
+    {
+      SP_DSB();
+      SP_WFE();
+    }
+}
+
+/****************************************************************************
+ * Name: write_trylock
+ *
+ * Description:
+ *   Take the lock exclusively only if it is free.
+ *
+ * Input Parameters:
+ *   lock - A reference to the rwlock object to lock.
+ *
+ * Returned Value:
+ *   true if the lock was taken; false otherwise.
+ *
+ ****************************************************************************/
+
+bool write_trylock(FAR volatile rwlock_t *lock)
+{
+  if (*lock != RW_SP_UNLOCKED ||
+      !rwlock_cmpxchg(lock, RW_SP_UNLOCKED, RW_SP_WRITE_LOCKED))
+    {
+      return false;
+    }
+
+  SP_DMB();
+  return true;
+}
+
+/****************************************************************************
+ * Name: write_unlock
+ *
+ * Description:
+ *   Release a lock taken with write_lock() or write_trylock().
+ *
+ * Input Parameters:
+ *   lock - A reference to the rwlock object to unlock.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void write_unlock(FAR volatile rwlock_t *lock)
+{
+  DEBUGASSERT(*lock == RW_SP_WRITE_LOCKED);
+
+  SP_DMB();
+  *lock = RW_SP_UNLOCKED;
+  SP_DSB();
+  SP_SEV();
+}
+
 #endif /* CONFIG_SPINLOCK */
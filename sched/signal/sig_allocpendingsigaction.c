@@ -55,6 +55,7 @@ FAR sigq_t *nxsig_alloc_pendingsigaction(void)
     {
       /* Try to get the pending signal action structure from the free list */
 
+      flags = spin_lock_irqsave_subsys(&g_sigpending_spin);
       sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingaction);
 
       /* If so, then try the special list of structures reserved for
@@ -65,6 +66,8 @@ FAR sigq_t *nxsig_alloc_pendingsigaction(void)
         {
           sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingirqaction);
         }
+
+      spin_unlock_irqrestore_subsys(&g_sigpending_spin, flags);
     }
 
   /* If we were not called from an interrupt handler, then we are
@@ -75,9 +78,9 @@ FAR sigq_t *nxsig_alloc_pendingsigaction(void)
     {
       /* Try to get the pending signal action structure from the free list */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave_subsys(&g_sigpending_spin);
       sigq = (FAR sigq_t *)sq_remfirst(&g_sigpendingaction);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore_subsys(&g_sigpending_spin, flags);
 
       /* Check if we got one. */
 
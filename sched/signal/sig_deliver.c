@@ -61,6 +61,9 @@ void nxsig_deliver(FAR struct tcb_s *stcb)
   int16_t saved_errcode = stcb->errcode;
 
   FAR sigq_t *sigq;
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+  sigq_t      timersigq;
+#endif
   sigset_t    savesigprocmask;
   sigset_t    newsigprocmask;
   sigset_t    tmpset1;
@@ -107,7 +110,23 @@ void nxsig_deliver(FAR struct tcb_s *stcb)
        * signal in the sigpostedq
        */
 
-      sq_addlast((FAR sq_entry_t *)sigq, &(stcb->sigpostedq));
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+      if (sigq->type == SIG_ALLOC_TIMER)
+        {
+          /* Give a timer's own entry back at once, so that the timer can
+           * queue its next expiration, or be deleted, while the handler
+           * runs.  The copy is not posted.
+           */
+
+          memcpy(&timersigq, sigq, sizeof(sigq_t));
+          sigq->tcb = NULL;
+          sigq      = &timersigq;
+        }
+      else
+#endif
+        {
+          sq_addlast((FAR sq_entry_t *)sigq, &(stcb->sigpostedq));
+        }
 
       /* Save a copy of the old sigprocmask and install the new
        * (temporary) sigprocmask.  The new sigprocmask is the union
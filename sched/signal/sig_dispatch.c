@@ -52,14 +52,16 @@
  * Name: nxsig_queue_action
  *
  * Description:
- *   Queue a signal action for delivery to a task.
+ *   Queue a signal action for delivery to a task.  'prealloc', if not
+ *   NULL, is an idle entry that is used instead of allocating one.
  *
  * Returned Value:
  *   Returns 0 (OK) on success or a negated errno value on failure.
  *
  ****************************************************************************/
 
-static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
+static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info,
+                              FAR sigq_t *prealloc)
 {
   FAR sigactq_t *sigact;
   FAR sigq_t    *sigq;
@@ -84,7 +86,7 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
        * unable to allocate memory for the signal data.
        */
 
-      sigq = nxsig_alloc_pendingsigaction();
+      sigq = prealloc != NULL ? prealloc : nxsig_alloc_pendingsigaction();
       if (!sigq)
         {
           ret = -ENOMEM;
@@ -100,13 +102,23 @@ static int nxsig_queue_action(FAR struct tcb_s *stcb, siginfo_t *info)
               sigaddset(&sigq->mask, info->si_signo);
             }
 
-          memcpy(&sigq->info, info, sizeof(siginfo_t));
+          if (&sigq->info != info)
+            {
+              memcpy(&sigq->info, info, sizeof(siginfo_t));
+            }
 
           /* Put it at the end of the pending signals list */
 
           flags = enter_critical_section();
           sq_addlast((FAR sq_entry_t *)sigq, &(stcb->sigpendactionq));
 
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+          if (sigq->type == SIG_ALLOC_TIMER)
+            {
+              sigq->tcb = stcb;
+            }
+#endif
+
           /* Then schedule execution of the signal handling action on the
            * recipient's thread. SMP related handling will be done in
            * up_schedule_sigaction()
@@ -140,6 +152,7 @@ static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
     {
       /* Try to get the pending signal structure from the free list */
 
+      flags = spin_lock_irqsave_subsys(&g_sigpending_spin);
       sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingsignal);
       if (!sigpend)
         {
@@ -150,6 +163,8 @@ static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
 
           sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingirqsignal);
         }
+
+      spin_unlock_irqrestore_subsys(&g_sigpending_spin, flags);
     }
 
   /* If we were not called from an interrupt handler, then we are
@@ -160,9 +175,9 @@ static FAR sigpendq_t *nxsig_alloc_pendingsignal(void)
     {
       /* Try to get the pending signal structure from the free list */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave_subsys(&g_sigpending_spin);
       sigpend = (FAR sigpendq_t *)sq_remfirst(&g_sigpendingsignal);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore_subsys(&g_sigpending_spin, flags);
 
       /* Check if we got one. */
 
@@ -296,32 +311,16 @@ static void nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: nxsig_tcbdispatch
+ * Name: nxsig_tcbdispatch_internal
  *
  * Description:
- *   All signals received the task (whatever the source) go through this
- *   function to be processed. This function is responsible for:
- *
- *   - Determining if the signal is blocked.
- *   - Queuing and dispatching signal actions
- *   - Unblocking tasks that are waiting for signals
- *   - Queuing pending signals.
- *
- *   This function will deliver the signal to the task associated with
- *   the specified TCB. This function should *not* typically be used
- *   to dispatch signals since it will *not* follow the group signal
- *   deliver algorithms.
- *
- * Returned Value:
- *   Returns 0 (OK) on success or a negated errno value on failure.
+ *   The common part of nxsig_tcbdispatch() and nxsig_tcbdispatch_sigq().
  *
  ****************************************************************************/
 
-int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info)
+static int nxsig_tcbdispatch_internal(FAR struct tcb_s *stcb,
+                                      FAR siginfo_t *info,
+                                      FAR sigq_t *prealloc)
 {
   FAR struct tcb_s *rtcb = this_task();
   irqstate_t flags;
@@ -447,7 +446,7 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info)
     {
       /* Queue any sigaction's requested by this task. */
 
-      ret = nxsig_queue_action(stcb, info);
+      ret = nxsig_queue_action(stcb, info, prealloc);
 
       /* Deliver of the signal must be performed in a critical section */
 
@@ -561,6 +560,60 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info)
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsig_tcbdispatch
+ *
+ * Description:
+ *   All signals received the task (whatever the source) go through this
+ *   function to be processed. This function is responsible for:
+ *
+ *   - Determining if the signal is blocked.
+ *   - Queuing and dispatching signal actions
+ *   - Unblocking tasks that are waiting for signals
+ *   - Queuing pending signals.
+ *
+ *   This function will deliver the signal to the task associated with
+ *   the specified TCB. This function should *not* typically be used
+ *   to dispatch signals since it will *not* follow the group signal
+ *   deliver algorithms.
+ *
+ * Returned Value:
+ *   Returns 0 (OK) on success or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxsig_tcbdispatch(FAR struct tcb_s *stcb, FAR siginfo_t *info)
+{
+  return nxsig_tcbdispatch_internal(stcb, info, NULL);
+}
+
+/****************************************************************************
+ * Name: nxsig_tcbdispatch_sigq
+ *
+ * Description:
+ *   Like nxsig_tcbdispatch(), but if a signal action is queued, it uses the
+ *   preallocated SIG_ALLOC_TIMER entry 'sigq' instead of allocating one.
+ *   The signal is described by sigq->info.  sigq->tcb is set while the
+ *   entry is queued; the caller must not reuse the entry until it is NULL
+ *   again.
+ *
+ * Returned Value:
+ *   Returns 0 (OK) on success or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+int nxsig_tcbdispatch_sigq(FAR struct tcb_s *stcb, FAR sigq_t *sigq)
+{
+  DEBUGASSERT(sigq->type == SIG_ALLOC_TIMER && sigq->tcb == NULL);
+  return nxsig_tcbdispatch_internal(stcb, &sigq->info, sigq);
+}
+#endif
+
 /****************************************************************************
  * Name: nxsig_dispatch
  *
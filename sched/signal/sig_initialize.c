@@ -68,6 +68,10 @@ sq_queue_t  g_sigpendingsignal;
 
 sq_queue_t  g_sigpendingirqsignal;
 
+/* g_sigpending_spin protects the pending signal/action free lists */
+
+spinlock_t  g_sigpending_spin = SP_UNLOCKED;
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -28,6 +28,7 @@
 #include <string.h>
 #include <signal.h>
 #include <assert.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <nuttx/signal.h>
@@ -108,7 +109,8 @@ int nxsig_notification(pid_t pid, FAR struct sigevent *event,
 
   /* Notify client via a signal? */
 
-  if (event->sigev_notify == SIGEV_SIGNAL)
+  if (event->sigev_notify == SIGEV_SIGNAL ||
+      event->sigev_notify == SIGEV_THREAD_ID)
     {
 #ifdef CONFIG_SCHED_HAVE_PARENT
       FAR struct tcb_s *rtcb = this_task();
@@ -133,7 +135,22 @@ int nxsig_notification(pid_t pid, FAR struct sigevent *event,
 
       memcpy(&info.si_value, &event->sigev_value, sizeof(union sigval));
 
-      /* Send the signal */
+      /* Send the signal to the thread named by the event, if any, rather
+       * than to any thread of the task group.
+       */
+
+      if (event->sigev_notify == SIGEV_THREAD_ID)
+        {
+          FAR struct tcb_s *stcb;
+
+          stcb = nxsched_get_tcb(event->sigev_notify_thread_id);
+          if (stcb == NULL)
+            {
+              return -ESRCH;
+            }
+
+          return nxsig_tcbdispatch(stcb, &info);
+        }
 
       return nxsig_dispatch(pid, &info);
     }
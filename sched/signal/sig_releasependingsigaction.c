@@ -53,12 +53,12 @@ void nxsig_release_pendingsigaction(FAR sigq_t *sigq)
   if (sigq->type == SIG_ALLOC_FIXED)
     {
       /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers.
+       * list from interrupt handlers and other CPUs.
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave_subsys(&g_sigpending_spin);
       sq_addlast((FAR sq_entry_t *)sigq, &g_sigpendingaction);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore_subsys(&g_sigpending_spin, flags);
     }
 
   /* If this is a message pre-allocated for interrupts,
@@ -68,12 +68,12 @@ void nxsig_release_pendingsigaction(FAR sigq_t *sigq)
   else if (sigq->type == SIG_ALLOC_IRQ)
     {
       /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers.
+       * list from interrupt handlers and other CPUs.
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave_subsys(&g_sigpending_spin);
       sq_addlast((FAR sq_entry_t *)sigq, &g_sigpendingirqaction);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore_subsys(&g_sigpending_spin, flags);
     }
 
   /* Otherwise, deallocate it.  Note:  interrupt handlers
@@ -85,4 +85,15 @@ void nxsig_release_pendingsigaction(FAR sigq_t *sigq)
     {
       kmm_free(sigq);
     }
+
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+  /* A timer's own entry is just given back to the timer */
+
+  else if (sigq->type == SIG_ALLOC_TIMER)
+    {
+      flags = enter_critical_section();
+      sigq->tcb = NULL;
+      leave_critical_section(flags);
+    }
+#endif
 }
@@ -61,12 +61,12 @@ void nxsig_release_pendingsignal(FAR sigpendq_t *sigpend)
   if (sigpend->type == SIG_ALLOC_FIXED)
     {
       /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers.
+       * list from interrupt handlers and other CPUs.
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave_subsys(&g_sigpending_spin);
       sq_addlast((FAR sq_entry_t *)sigpend, &g_sigpendingsignal);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore_subsys(&g_sigpending_spin, flags);
     }
 
   /* If this is a message pre-allocated for interrupts,
@@ -76,12 +76,12 @@ void nxsig_release_pendingsignal(FAR sigpendq_t *sigpend)
   else if (sigpend->type == SIG_ALLOC_IRQ)
     {
       /* Make sure we avoid concurrent access to the free
-       * list from interrupt handlers.
+       * list from interrupt handlers and other CPUs.
        */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave_subsys(&g_sigpending_spin);
       sq_addlast((FAR sq_entry_t *)sigpend, &g_sigpendingirqsignal);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore_subsys(&g_sigpending_spin, flags);
     }
 
   /* Otherwise, deallocate it.  Note:  interrupt handlers
@@ -37,6 +37,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/signal.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/queue.h>
@@ -127,6 +128,22 @@ static void nxsig_timeout(wdparm_t arg)
 #endif
 }
 
+/****************************************************************************
+ * Name: nxsig_hrtimeout
+ *
+ * Description:
+ *   A timeout shorter than one tick elapsed while waiting for signals.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static uint64_t nxsig_hrtimeout(FAR struct hrtimer_s *timer, FAR void *arg)
+{
+  nxsig_timeout((wdparm_t)(uintptr_t)arg);
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -241,6 +258,9 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
   FAR struct tcb_s *rtcb = this_task();
   sigset_t intersection;
   FAR sigpendq_t *sigpend;
+#ifdef CONFIG_HRTIMER
+  struct hrtimer_s hrtimer;
+#endif
   irqstate_t flags;
   sclock_t waitticks;
   bool switch_needed;
@@ -339,10 +359,23 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
               rtcb->sigwaitmask = *set;
 
-              /* Start the watchdog */
+#ifdef CONFIG_HRTIMER
+              /* A timeout shorter than one tick needs not be rounded up
+               * to the tick, use a high resolution timer for it.
+               */
+
+              memset(&hrtimer, 0, sizeof(hrtimer));
+              if (timeout->tv_sec > 0 || timeout->tv_nsec >= NSEC_PER_TICK ||
+                  hrtimer_start(&hrtimer, timeout->tv_nsec,
+                                nxsig_hrtimeout, rtcb) < 0)
+#endif
+                {
+                  /* Start the watchdog */
 
-              wd_start(&rtcb->waitdog, waitticks,
-                       nxsig_timeout, (uintptr_t)rtcb);
+                  wd_start_slack(&rtcb->waitdog, waitticks,
+                                 nxsched_timerslack(rtcb),
+                                 nxsig_timeout, (uintptr_t)rtcb);
+                }
 
               /* Now wait for either the signal or the watchdog, but
                * first, make sure this is not the idle task,
@@ -369,6 +402,9 @@ int nxsig_timedwait(FAR const sigset_t *set, FAR struct siginfo *info,
 
               /* We no longer need the watchdog */
 
+#ifdef CONFIG_HRTIMER
+              hrtimer_cancel(&hrtimer);
+#endif
               wd_cancel(&rtcb->waitdog);
             }
           else
@@ -33,6 +33,7 @@
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -56,7 +57,8 @@ enum sigalloc_e
 {
   SIG_ALLOC_FIXED = 0,  /* pre-allocated; never freed */
   SIG_ALLOC_DYN,        /* dynamically allocated; free when unused */
-  SIG_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  SIG_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  SIG_ALLOC_TIMER       /* Embedded in a POSIX timer; never freed */
 };
 
 /* The following defines the sigaction queue entry */
@@ -98,6 +100,10 @@ struct sigq_s
                                   * the signal-catching function executes */
   siginfo_t info;                /* Signal information */
   uint8_t   type;                /* (Used to manage allocations) */
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+  FAR struct tcb_s *tcb;         /* SIG_ALLOC_TIMER: The recipient while the
+                                  * entry is queued, NULL otherwise */
+#endif
 };
 typedef struct sigq_s sigq_t;
 
@@ -135,6 +141,12 @@ extern sq_queue_t  g_sigpendingsignal;
 
 extern sq_queue_t  g_sigpendingirqsignal;
 
+/* g_sigpending_spin protects the four pending signal/action free lists
+ * above.
+ */
+
+extern spinlock_t  g_sigpending_spin;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -168,6 +180,10 @@ int                nxsig_default_initialize(FAR struct tcb_s *tcb);
 int                nxsig_tcbdispatch(FAR struct tcb_s *stcb,
                                      FAR siginfo_t *info);
 int                nxsig_dispatch(pid_t pid, FAR siginfo_t *info);
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+int                nxsig_tcbdispatch_sigq(FAR struct tcb_s *stcb,
+                                          FAR sigq_t *sigq);
+#endif
 
 /* sig_cleanup.c */
 
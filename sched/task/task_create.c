@@ -30,7 +30,6 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
-#include <nuttx/kmalloc.h>
 #include <nuttx/sched.h>
 #include <nuttx/kthread.h>
 
@@ -81,24 +80,20 @@ int nxthread_create(FAR const char *name, uint8_t ttype, int priority,
 
   /* Allocate a TCB for the new task. */
 
-  tcb = kmm_zalloc(sizeof(struct task_tcb_s));
+  tcb = (FAR struct task_tcb_s *)nxsched_alloc_tcb(ttype, stack_size);
   if (!tcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
       return -ENOMEM;
     }
 
-  /* Setup the task type */
-
-  tcb->cmn.flags = ttype;
-
   /* Initialize the task */
 
   ret = nxtask_init(tcb, name, priority, stack_addr, stack_size,
                     entry, argv, envp);
   if (ret < OK)
     {
-      kmm_free(tcb);
+      nxsched_free_tcb(&tcb->cmn, ttype);
       return ret;
     }
 
@@ -132,9 +132,14 @@ FAR struct task_tcb_s *nxtask_setup_fork(start_t retaddr)
         }
     }
 
-  /* Allocate a TCB for the child task. */
+  /* Allocate a TCB for the child task.  The child gets a stack of the
+   * same size as the parent's.
+   */
+
+  stack_size = (uintptr_t)ptcb->stack_base_ptr -
+               (uintptr_t)ptcb->stack_alloc_ptr + ptcb->adj_stack_size;
 
-  child = kmm_zalloc(sizeof(struct task_tcb_s));
+  child = (FAR struct task_tcb_s *)nxsched_alloc_tcb(ttype, stack_size);
   if (!child)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -168,9 +173,6 @@ FAR struct task_tcb_s *nxtask_setup_fork(start_t retaddr)
 
   /* Allocate the stack for the TCB */
 
-  stack_size = (uintptr_t)ptcb->stack_base_ptr -
-               (uintptr_t)ptcb->stack_alloc_ptr + ptcb->adj_stack_size;
-
   ret = up_create_stack(&child->cmn, stack_size, ttype);
   if (ret < OK)
     {
@@ -50,6 +50,7 @@
  * Returned Value:
  *   The returned value may depend on the specific command.  For PR_SET_NAME
  *   and PR_GET_NAME, the returned value of 0 indicates successful operation.
+ *   PR_GET_TIMERSLACK returns the timer slack of the calling thread.
  *   On any failure, -1 is retruend and the errno value is set appropriately.
  *
  *     EINVAL The value of 'option' is not recognized.
@@ -63,6 +64,9 @@ int prctl(int option, ...)
 {
   va_list ap;
   int errcode;
+#if CONFIG_TASK_NAME_SIZE > 0 || defined(CONFIG_SCHED_TIMER_SLACK)
+  int ret = OK;
+#endif
 
   va_start(ap, option);
   switch (option)
@@ -146,19 +150,42 @@ int prctl(int option, ...)
         goto errout;
 #endif
 
+      case PR_SET_TIMERSLACK:
+      case PR_GET_TIMERSLACK:
+#ifdef CONFIG_SCHED_TIMER_SLACK
+        {
+          FAR struct tcb_s *rtcb = this_task();
+
+          if (option == PR_SET_TIMERSLACK)
+            {
+              unsigned long slack = va_arg(ap, unsigned long);
+
+              /* A slack of zero restores the default value */
+
+              rtcb->timerslack = slack > 0 ? slack :
+                                 CONFIG_SCHED_TIMER_SLACK_DEFAULT;
+            }
+          else
+            {
+              ret = (int)rtcb->timerslack;
+            }
+        }
+        break;
+#else
+        serr("ERROR: Option not enabled: %d\n", option);
+        errcode = ENOSYS;
+        goto errout;
+#endif
+
       default:
         serr("ERROR: Unrecognized option: %d\n", option);
         errcode = EINVAL;
         goto errout;
     }
 
-  /* Not reachable unless CONFIG_TASK_NAME_SIZE is > 0.  NOTE: This might
-   * change if additional commands are supported.
-   */
-
-#if CONFIG_TASK_NAME_SIZE > 0
+#if CONFIG_TASK_NAME_SIZE > 0 || defined(CONFIG_SCHED_TIMER_SLACK)
   va_end(ap);
-  return OK;
+  return ret;
 #endif
 
 errout:
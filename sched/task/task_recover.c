@@ -30,6 +30,7 @@
 #include <nuttx/wdog.h>
 #include <nuttx/sched.h>
 
+#include "futex/futex.h"
 #include "semaphore/semaphore.h"
 #include "wdog/wdog.h"
 #include "mqueue/mqueue.h"
@@ -78,6 +79,12 @@ void nxtask_recover(FAR struct tcb_s *tcb)
 
   nxsem_recover(tcb);
 
+#ifdef CONFIG_FUTEX
+  /* Remove the thread from any futex wait queue */
+
+  nxfutex_recover(tcb);
+#endif
+
 #if !defined(CONFIG_DISABLE_MQUEUE) || !defined(CONFIG_DISABLE_MQUEUE_SYSV)
   /* Handle cases where the thread was waiting for a message queue event */
 
@@ -92,4 +99,13 @@ void nxtask_recover(FAR struct tcb_s *tcb)
       DEBUGVERIFY(nxsched_stop_sporadic(tcb));
     }
 #endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+  if (nxsched_is_deadline(tcb))
+    {
+      /* Release the reserved deadline bandwidth */
+
+      nxsched_stop_deadline(tcb);
+    }
+#endif
 }
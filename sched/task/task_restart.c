@@ -139,7 +139,17 @@ static int nxtask_restart(pid_t pid)
   tasklist = TLIST_HEAD(&tcb->cmn);
 #endif
 
-  dq_rem((FAR dq_entry_t *)tcb, tasklist);
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+  if (tasklist == &g_readytorun)
+    {
+      nxsched_rtr_remove(&tcb->cmn);
+    }
+  else
+#endif
+    {
+      dq_rem((FAR dq_entry_t *)tcb, tasklist);
+    }
+
   tcb->cmn.task_state = TSTATE_TASK_INVALID;
 
   /* Deallocate anything left in the TCB's signal queues */
@@ -65,6 +65,57 @@ static const char g_noname[] = "<noname>";
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: nxtask_grow_pidhash
+ *
+ * Description:
+ *   Replace g_pidhash with a table of twice the size.  Every live PID maps
+ *   to a distinct entry of the larger table, since entries that collide
+ *   there would already have collided in the smaller one.
+ *
+ * Input Parameters:
+ *   pidhash - A zeroed table of 2 * g_npidhash entries
+ *
+ * Returned Value:
+ *   The table replaced, to be freed by the caller.  No lookup can still be
+ *   reading it once this function returns.
+ *
+ * Assumptions:
+ *   Called within the critical section.
+ *
+ ****************************************************************************/
+
+static FAR struct tcb_s **nxtask_grow_pidhash(FAR struct tcb_s **pidhash)
+{
+  FAR struct tcb_s **oldhash = g_pidhash;
+  int npidhash = g_npidhash;
+  irqstate_t write_flags;
+  int hash_ndx;
+  int i;
+
+  for (i = 0; i < npidhash; i++)
+    {
+      if (oldhash[i] != NULL)
+        {
+          hash_ndx = oldhash[i]->pid & (2 * npidhash - 1);
+          DEBUGASSERT(pidhash[hash_ndx] == NULL);
+          pidhash[hash_ndx] = oldhash[i];
+        }
+    }
+
+  /* Publish the new table and its size together.  Lookups hold
+   * g_pidhash_lock as readers, so none is left on the old table once the
+   * write lock has been taken.
+   */
+
+  write_flags = write_lock_irqsave(&g_pidhash_lock);
+  g_pidhash  = pidhash;
+  g_npidhash = 2 * npidhash;
+  write_unlock_irqrestore(&g_pidhash_lock, write_flags);
+
+  return oldhash;
+}
+
 /****************************************************************************
  * Name: nxtask_assign_pid
  *
@@ -75,32 +126,66 @@ static const char g_noname[] = "<noname>";
  *   tcb - TCB of task
  *
  * Returned Value:
- *   OK on success; ERROR on failure (errno is not set)
+ *   OK on success; -ENOMEM if the PID table is full and cannot be grown.
  *
  ****************************************************************************/
 
 static int nxtask_assign_pid(FAR struct tcb_s *tcb)
 {
-  FAR struct tcb_s **pidhash;
+  FAR struct tcb_s **pidhash = NULL;
+  FAR struct tcb_s **retired = NULL;
+  irqstate_t write_flags;
+  irqstate_t flags;
   pid_t next_pid;
-  int   hash_ndx;
-  void *temp;
-  int   i;
-
-  /* NOTE:
-   * ERROR means that the g_pidhash[] table is completely full.
-   * We cannot allow another task to be started.
-   */
+  int npidhash = 0;
+  int hash_ndx;
+  int i;
 
   /* Protect the following operation with a critical section
    * because g_pidhash is accessed from an interrupt context
    */
 
-  irqstate_t flags = enter_critical_section();
+  flags = enter_critical_section();
+
+  /* Keep the table at most half full so that the search for a free entry
+   * below ends after about two probes.  The larger table is allocated
+   * outside of the critical section; if another task grew the table in
+   * the meantime, the allocation is dropped and the check repeated.
+   */
 
-  /* We'll try every allowable pid */
+  while (2 * (g_npids + 1) > g_npidhash)
+    {
+      if (pidhash != NULL && npidhash == 2 * g_npidhash)
+        {
+          retired = nxtask_grow_pidhash(pidhash);
+          pidhash = NULL;
+          continue;
+        }
 
-retry:
+      npidhash = 2 * g_npidhash;
+      leave_critical_section(flags);
+
+      kmm_free(retired);
+      retired = NULL;
+
+      kmm_free(pidhash);
+      pidhash = kmm_zalloc(npidhash * sizeof(*pidhash));
+
+      flags = enter_critical_section();
+
+      if (pidhash == NULL)
+        {
+          /* Carry on with a fuller table if there is any room left */
+
+          if (g_npids < g_npidhash)
+            {
+              break;
+            }
+
+          leave_critical_section(flags);
+          return -ENOMEM;
+        }
+    }
 
   /* Get the next process ID candidate */
 
@@ -124,51 +209,26 @@ retry:
         {
           /* Assign this PID to the task */
 
+          write_flags = write_lock_irqsave(&g_pidhash_lock);
           g_pidhash[hash_ndx] = tcb;
           tcb->pid = next_pid;
+          write_unlock_irqrestore(&g_pidhash_lock, write_flags);
           g_lastpid = next_pid;
-
-          leave_critical_section(flags);
-          return OK;
+          g_npids++;
+          break;
         }
 
       next_pid++;
     }
 
-  /* If we get here, then the g_pidhash[] table is completely full.
-   * We will alloc new space and copy original g_pidhash to it to
-   * expand space.
-   */
+  DEBUGASSERT(i < g_npidhash);
+  leave_critical_section(flags);
 
-  pidhash = kmm_zalloc(g_npidhash * 2 * sizeof(*pidhash));
-  if (pidhash == NULL)
-    {
-      leave_critical_section(flags);
-      return -ENOMEM;
-    }
-
-  g_npidhash *= 2;
-
-  /* All original pid and hash_ndx are mismatch,
-   * so we need to rebuild their relationship
-   */
-
-  for (i = 0; i < g_npidhash / 2; i++)
-    {
-      hash_ndx = PIDHASH(g_pidhash[i]->pid);
-      DEBUGASSERT(pidhash[hash_ndx] == NULL);
-      pidhash[hash_ndx] = g_pidhash[i];
-    }
-
-  /* Release resource for original g_pidhash, using new g_pidhash */
-
-  temp = g_pidhash;
-  g_pidhash = pidhash;
-  kmm_free(temp);
-
-  /* Let's try every allowable pid again */
+  /* Free an allocation lost to a concurrent growth and the replaced table */
 
-  goto retry;
+  kmm_free(pidhash);
+  kmm_free(retired);
+  return OK;
 }
 
 /****************************************************************************
@@ -438,6 +498,12 @@ static int nxthread_setup_scheduler(FAR struct tcb_s *tcb, int priority,
 
       tcb->sigprocmask = rtcb->sigprocmask;
 
+#ifdef CONFIG_SCHED_TIMER_SLACK
+      /* The timer slack is inherited from the parent thread as well */
+
+      tcb->timerslack = rtcb->timerslack;
+#endif
+
       /* Initialize the task state.  It does not get a valid state
        * until it is activated.
        */
@@ -88,24 +88,21 @@ static int nxtask_spawn_create(FAR const char *name, int priority,
 
   /* Allocate a TCB for the new task. */
 
-  tcb = kmm_zalloc(sizeof(struct task_tcb_s));
+  tcb = (FAR struct task_tcb_s *)
+          nxsched_alloc_tcb(TCB_FLAG_TTYPE_TASK, stack_size);
   if (tcb == NULL)
     {
       serr("ERROR: Failed to allocate TCB\n");
       return -ENOMEM;
     }
 
-  /* Setup the task type */
-
-  tcb->cmn.flags = TCB_FLAG_TTYPE_TASK;
-
   /* Initialize the task */
 
   ret = nxtask_init(tcb, name, priority, stack_addr, stack_size,
                     entry, argv, envp);
   if (ret < OK)
     {
-      kmm_free(tcb);
+      nxsched_free_tcb(&tcb->cmn, TCB_FLAG_TTYPE_TASK);
       return ret;
     }
 
@@ -32,8 +32,11 @@
 
 #include <nuttx/compiler.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/wdog.h>
 
+#include "signal/signal.h"
+
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
 
 /****************************************************************************
@@ -60,6 +63,8 @@ struct posix_timer_s
   struct wdog_s    pt_wdog;        /* The watchdog that provides the timing */
   struct sigevent  pt_event;       /* Notification information */
   struct sigwork_s pt_work;
+  sigq_t           pt_sigq;        /* Signal action queued on expiration */
+  int              pt_overrun;     /* Expirations while pt_sigq was queued */
 };
 
 /****************************************************************************
@@ -79,6 +84,10 @@ extern volatile sq_queue_t g_freetimers;
 
 extern volatile sq_queue_t g_alloctimers;
 
+/* g_locktimers protects g_freetimers and g_alloctimers */
+
+extern spinlock_t g_locktimers;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -34,6 +34,7 @@
 #include <nuttx/wdog.h>
 #include <nuttx/kmalloc.h>
 
+#include "sched/sched.h"
 #include "timer/timer.h"
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
@@ -59,10 +60,10 @@ static FAR struct posix_timer_s *timer_allocate(void)
   /* Try to get a preallocated timer from the free list */
 
 #if CONFIG_PREALLOC_TIMERS > 0
-  flags = enter_critical_section();
+  flags = spin_lock_irqsave_subsys(&g_locktimers);
   ret   = (FAR struct posix_timer_s *)
     sq_remfirst((FAR sq_queue_t *)&g_freetimers);
-  leave_critical_section(flags);
+  spin_unlock_irqrestore_subsys(&g_locktimers, flags);
 
   /* Did we get one? */
 
@@ -87,13 +88,14 @@ static FAR struct posix_timer_s *timer_allocate(void)
       /* Initialize the timer structure */
 
       memset(ret, 0, sizeof(struct posix_timer_s));
-      ret->pt_flags = pt_flags;
+      ret->pt_flags     = pt_flags;
+      ret->pt_sigq.type = SIG_ALLOC_TIMER;
 
       /* And add it to the end of the list of allocated timers */
 
-      flags = enter_critical_section();
+      flags = spin_lock_irqsave_subsys(&g_locktimers);
       sq_addlast((FAR sq_entry_t *)ret, (FAR sq_queue_t *)&g_alloctimers);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore_subsys(&g_locktimers, flags);
     }
 
   return ret;
@@ -165,6 +167,20 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
       return ERROR;
     }
 
+  /* A thread targeted by SIGEV_THREAD_ID must belong to the caller */
+
+  if (evp != NULL && evp->sigev_notify == SIGEV_THREAD_ID)
+    {
+      FAR struct tcb_s *stcb;
+
+      stcb = nxsched_get_tcb(evp->sigev_notify_thread_id);
+      if (stcb == NULL || stcb->group != this_task()->group)
+        {
+          set_errno(EINVAL);
+          return ERROR;
+        }
+    }
+
   /* Allocate a timer instance to contain the watchdog */
 
   ret = timer_allocate();
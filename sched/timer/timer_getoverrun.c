@@ -75,9 +75,15 @@
 
 int timer_getoverrun(timer_t timerid)
 {
-  UNUSED(timerid);
-  set_errno(ENOSYS);
-  return ERROR;
+  FAR struct posix_timer_s *timer = timer_gethandle(timerid);
+
+  if (timer == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  return timer->pt_overrun;
 }
 
 #endif /* CONFIG_DISABLE_POSIX_TIMERS */
@@ -64,6 +64,10 @@ volatile sq_queue_t g_freetimers;
 
 volatile sq_queue_t g_alloctimers;
 
+/* g_locktimers protects g_freetimers and g_alloctimers */
+
+spinlock_t g_locktimers = SP_UNLOCKED;
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -129,22 +133,53 @@ void timer_initialize(void)
 void timer_deleteall(pid_t pid)
 {
   FAR struct posix_timer_s *timer;
+  FAR struct posix_timer_s *prev;
   FAR struct posix_timer_s *next;
+  sq_queue_t owned;
   irqstate_t flags;
 
-  flags = enter_critical_section();
-  for (timer = (FAR struct posix_timer_s *)g_alloctimers.head;
+  /* timer_release() takes g_locktimers itself, so the lock cannot be held
+   * across the call.  Move the timers of the thread to a list of our own
+   * first, then release each of them exactly once.  A timer that is being
+   * expired by timer_timeout() on another CPU still holds a reference and
+   * is freed when that reference is dropped; timer_timeout() cannot find
+   * it again through timer_gethandle() as it is no longer allocated.
+   */
+
+  sq_init(&owned);
+
+  flags = spin_lock_irqsave_subsys(&g_locktimers);
+  for (prev = NULL, timer = (FAR struct posix_timer_s *)g_alloctimers.head;
        timer != NULL;
        timer = next)
     {
       next = timer->flink;
-      if (timer->pt_owner == pid)
+      if (timer->pt_owner != pid)
         {
-          timer_delete((timer_t)timer);
+          prev = timer;
+        }
+      else
+        {
+          if (prev == NULL)
+            {
+              sq_remfirst((FAR sq_queue_t *)&g_alloctimers);
+            }
+          else
+            {
+              sq_remafter((FAR sq_entry_t *)prev,
+                          (FAR sq_queue_t *)&g_alloctimers);
+            }
+
+          sq_addlast((FAR sq_entry_t *)timer, &owned);
         }
     }
 
-  leave_critical_section(flags);
+  spin_unlock_irqrestore_subsys(&g_locktimers, flags);
+
+  while ((timer = (FAR struct posix_timer_s *)sq_remfirst(&owned)) != NULL)
+    {
+      timer_release(timer);
+    }
 }
 
 /****************************************************************************
@@ -171,7 +206,7 @@ FAR struct posix_timer_s *timer_gethandle(timer_t timerid)
 
   if (timerid != NULL)
     {
-      intflags = enter_critical_section();
+      intflags = spin_lock_irqsave_subsys(&g_locktimers);
 
       sq_for_every(&g_alloctimers, entry)
         {
@@ -182,7 +217,7 @@ FAR struct posix_timer_s *timer_gethandle(timer_t timerid)
             }
         }
 
-      leave_critical_section(intflags);
+      spin_unlock_irqrestore_subsys(&g_locktimers, intflags);
     }
 
   return timer;
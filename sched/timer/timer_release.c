@@ -54,7 +54,7 @@ static inline void timer_free(struct posix_timer_s *timer)
 
   /* Remove the timer from the allocated list */
 
-  flags = enter_critical_section();
+  flags = spin_lock_irqsave_subsys(&g_locktimers);
   sq_rem((FAR sq_entry_t *)timer, (FAR sq_queue_t *)&g_alloctimers);
 
   /* Return it to the free list if it is one of the preallocated timers */
@@ -63,14 +63,14 @@ static inline void timer_free(struct posix_timer_s *timer)
   if ((timer->pt_flags & PT_FLAGS_PREALLOCATED) != 0)
     {
       sq_addlast((FAR sq_entry_t *)timer, (FAR sq_queue_t *)&g_freetimers);
-      leave_critical_section(flags);
+      spin_unlock_irqrestore_subsys(&g_locktimers, flags);
     }
   else
 #endif
     {
       /* Otherwise, return it to the heap */
 
-      leave_critical_section(flags);
+      spin_unlock_irqrestore_subsys(&g_locktimers, flags);
       kmm_free(timer);
     }
 }
@@ -102,6 +102,8 @@ static inline void timer_free(struct posix_timer_s *timer)
 
 int timer_release(FAR struct posix_timer_s *timer)
 {
+  irqstate_t flags;
+
   /* Some sanity checks */
 
   if (timer == NULL)
@@ -127,6 +129,18 @@ int timer_release(FAR struct posix_timer_s *timer)
 
   nxsig_cancel_notification(&timer->pt_work);
 
+  /* Withdraw the signal action that is still queued for the timer */
+
+  flags = enter_critical_section();
+  if (timer->pt_sigq.tcb != NULL)
+    {
+      sq_rem((FAR sq_entry_t *)&timer->pt_sigq,
+             &timer->pt_sigq.tcb->sigpendactionq);
+      timer->pt_sigq.tcb = NULL;
+    }
+
+  leave_critical_section(flags);
+
   /* Release the timer structure */
 
   timer_free(timer);
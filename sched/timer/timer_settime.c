@@ -29,10 +29,12 @@
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
+#include <limits.h>
 
 #include <nuttx/irq.h>
 
 #include "clock/clock.h"
+#include "sched/sched.h"
 #include "timer/timer.h"
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
@@ -70,8 +72,80 @@ static void timer_timeout(wdparm_t itimer);
 
 static inline void timer_signotify(FAR struct posix_timer_s *timer)
 {
-  DEBUGVERIFY(nxsig_notification(timer->pt_owner, &timer->pt_event,
-                                 SI_TIMER, &timer->pt_work));
+  FAR struct sigevent *event = &timer->pt_event;
+  FAR struct tcb_s *stcb = NULL;
+  irqstate_t flags;
+
+  if (event->sigev_notify != SIGEV_SIGNAL &&
+      event->sigev_notify != SIGEV_THREAD_ID)
+    {
+      DEBUGVERIFY(nxsig_notification(timer->pt_owner, event, SI_TIMER,
+                                     &timer->pt_work));
+      return;
+    }
+
+  flags = enter_critical_section();
+
+  /* Only one signal is queued for a timer at a time.  The expirations in
+   * the meantime are counted as overruns.
+   */
+
+  if (timer->pt_sigq.tcb != NULL)
+    {
+      if (timer->pt_overrun < DELAYTIMER_MAX)
+        {
+          timer->pt_overrun++;
+        }
+
+      leave_critical_section(flags);
+      return;
+    }
+
+  /* Find the recipient.  A signal for a task group with several members
+   * is routed by nxsig_notification() instead.
+   */
+
+  if (event->sigev_notify == SIGEV_THREAD_ID)
+    {
+      stcb = nxsched_get_tcb(event->sigev_notify_thread_id);
+    }
+  else
+    {
+      stcb = nxsched_get_tcb(timer->pt_owner);
+#ifdef HAVE_GROUP_MEMBERS
+      if (stcb != NULL && stcb->group->tg_nmembers > 1)
+        {
+          stcb = NULL;
+        }
+#endif
+    }
+
+  if (stcb != NULL)
+    {
+      /* Queue the timer's own entry, so that nothing is allocated */
+
+      timer->pt_overrun             = 0;
+      timer->pt_sigq.info.si_signo  = event->sigev_signo;
+      timer->pt_sigq.info.si_code   = SI_TIMER;
+      timer->pt_sigq.info.si_errno  = OK;
+#ifdef CONFIG_SCHED_HAVE_PARENT
+      timer->pt_sigq.info.si_pid    = timer->pt_owner;
+      timer->pt_sigq.info.si_status = OK;
+#endif
+      timer->pt_sigq.info.si_value  = event->sigev_value;
+
+      nxsig_tcbdispatch_sigq(stcb, &timer->pt_sigq);
+      leave_critical_section(flags);
+      return;
+    }
+
+  leave_critical_section(flags);
+
+  if (event->sigev_notify == SIGEV_SIGNAL)
+    {
+      DEBUGVERIFY(nxsig_notification(timer->pt_owner, event, SI_TIMER,
+                                     &timer->pt_work));
+    }
 }
 
 /****************************************************************************
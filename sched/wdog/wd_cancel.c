@@ -39,6 +39,116 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wd_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the active watchdogs and mark it
+ *   inactive.
+ *
+ * Input Parameters:
+ *   wdog - The active watchdog to remove.
+ *
+ * Returned Value:
+ *   True if the next expiration has changed, so that the interval timer
+ *   has to be reassessed.
+ *
+ * Assumptions:
+ *   g_wdspinlock is held.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+bool wd_remove(FAR struct wdog_s *wdog)
+{
+  bool changed = false;
+#ifdef CONFIG_SCHED_TICKLESS
+  clock_t before;
+  clock_t after;
+  bool had;
+  bool has;
+
+  had = wd_wheel_next(&before);
+#endif
+
+  /* Unlink the watchdog from its wheel slot */
+
+  wd_wheel_remove(wdog);
+
+#ifdef CONFIG_SCHED_TICKLESS
+  /* Reassess the interval timer only if the next expiration that it
+   * was programmed for has changed.
+   */
+
+  has     = wd_wheel_next(&after);
+  changed = had != has || (has && before != after);
+#endif
+
+  /* Mark the watchdog inactive */
+
+  wdog->func = NULL;
+  return changed;
+}
+#else
+bool wd_remove(FAR struct wdog_s *wdog)
+{
+  FAR struct wdog_s *curr;
+  FAR struct wdog_s *prev;
+
+  /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
+   * to do this because there are additional operations that need to be
+   * done.
+   */
+
+  prev = NULL;
+  curr = (FAR struct wdog_s *)g_wdactivelist.head;
+
+  while ((curr) && (curr != wdog))
+    {
+      prev = curr;
+      curr = curr->next;
+    }
+
+  /* Check if the watchdog was found in the list.  If not, then an OS
+   * error has occurred because the watchdog is marked active!
+   */
+
+  DEBUGASSERT(curr);
+
+  /* If there is a watchdog in the timer queue after the one that
+   * is being canceled, then it inherits the remaining ticks.
+   */
+
+  if (curr->next)
+    {
+      curr->next->lag += curr->lag;
+    }
+
+  /* Now, remove the watchdog from the timer queue */
+
+  if (prev)
+    {
+      /* Remove the watchdog from mid- or end-of-queue */
+
+      sq_remafter((FAR sq_entry_t *)prev, &g_wdactivelist);
+    }
+  else
+    {
+      /* Remove the watchdog at the head of the queue */
+
+      sq_remfirst(&g_wdactivelist);
+    }
+
+  /* Mark the watchdog inactive */
+
+  wdog->func = NULL;
+
+  /* The interval timer has to be reassessed if the head changed */
+
+  return prev == NULL;
+}
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
+
 /****************************************************************************
  * Name: wd_cancel
  *
@@ -46,6 +156,9 @@
  *   This function cancels a currently running watchdog timer. Watchdog
  *   timers may be canceled from the interrupt level.
  *
+ *   If the watchdog function is running on another CPU, this function
+ *   waits for it to return.
+ *
  * Input Parameters:
  *   wdog - ID of the watchdog to cancel.
  *
@@ -57,16 +170,22 @@
 
 int wd_cancel(FAR struct wdog_s *wdog)
 {
-  FAR struct wdog_s *curr;
-  FAR struct wdog_s *prev;
   irqstate_t flags;
+  bool reassess = false;
   int ret = -EINVAL;
+#ifdef CONFIG_SCHED_TICKLESS
+  irqstate_t tflags;
+
+  /* The interval timer is still protected by the critical section */
+
+  tflags = enter_critical_section();
+#endif
 
   /* Prohibit timer interactions with the timer queue until the
    * cancellation is complete
    */
 
-  flags = enter_critical_section();
+  flags = spin_lock_irqsave_subsys(&g_wdspinlock);
 
   /* Make sure that the watchdog is initialized (non-NULL) and is still
    * active.
@@ -74,65 +193,43 @@ int wd_cancel(FAR struct wdog_s *wdog)
 
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
-      /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
-       * to do this because there are additional operations that need to be
-       * done.
-       */
+      reassess = wd_remove(wdog);
 
-      prev = NULL;
-      curr = (FAR struct wdog_s *)g_wdactivelist.head;
-
-      while ((curr) && (curr != wdog))
-        {
-          prev = curr;
-          curr = curr->next;
-        }
-
-      /* Check if the watchdog was found in the list.  If not, then an OS
-       * error has occurred because the watchdog is marked active!
-       */
-
-      DEBUGASSERT(curr);
-
-      /* If there is a watchdog in the timer queue after the one that
-       * is being canceled, then it inherits the remaining ticks.
-       */
-
-      if (curr->next)
-        {
-          curr->next->lag += curr->lag;
-        }
-
-      /* Now, remove the watchdog from the timer queue */
-
-      if (prev)
-        {
-          /* Remove the watchdog from mid- or end-of-queue */
-
-          sq_remafter((FAR sq_entry_t *)prev, &g_wdactivelist);
-        }
-      else
-        {
-          /* Remove the watchdog at the head of the queue */
+      /* Return success */
 
-          sq_remfirst(&g_wdactivelist);
+      ret = OK;
+    }
 
-          /* Reassess the interval timer that will generate the next
-           * interval event.
-           */
+  spin_unlock_irqrestore_subsys(&g_wdspinlock, flags);
 
-          nxsched_reassess_timer();
-        }
+#ifdef CONFIG_SCHED_TICKLESS
+  /* Reassess the interval timer that will generate the next interval
+   * event.
+   */
 
-      /* Mark the watchdog inactive */
+  if (reassess)
+    {
+      nxsched_reassess_timer();
+    }
 
-      wdog->func = NULL;
+  leave_critical_section(tflags);
+#else
+  UNUSED(reassess);
 
-      /* Return success */
+#  ifdef CONFIG_SMP
+  /* wd_timer() runs the watchdog functions within the critical section.
+   * If this one is running on another CPU, pass through the critical
+   * section to wait for it to return, as wd_cancel() did when it entered
+   * the critical section itself.
+   */
 
-      ret = OK;
+  if (wdog != NULL && g_wdrunning == wdog)
+    {
+      flags = enter_critical_section();
+      leave_critical_section(flags);
     }
+#  endif
+#endif
 
-  leave_critical_section(flags);
   return ret;
 }
@@ -24,6 +24,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
+
 #include <nuttx/wdog.h>
 #include <nuttx/irq.h>
 
@@ -56,9 +58,17 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
 
   /* Verify the wdog */
 
-  flags = enter_critical_section();
+  flags = spin_lock_irqsave_subsys(&g_wdspinlock);
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+      /* The expiration time is absolute, just subtract the current time */
+
+      sclock_t delay = wdog->expired - clock_systime_ticks();
+
+      spin_unlock_irqrestore_subsys(&g_wdspinlock, flags);
+      return delay > 0 ? delay : 0;
+#else
       /* Traverse the watchdog list accumulating lag times until we find the
        * wdog that we are looking for
        */
@@ -74,12 +84,72 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
           if (curr == wdog)
             {
               delay -= wd_elapse();
-              leave_critical_section(flags);
+              spin_unlock_irqrestore_subsys(&g_wdspinlock, flags);
               return delay;
             }
         }
+#endif
     }
 
-  leave_critical_section(flags);
+  spin_unlock_irqrestore_subsys(&g_wdspinlock, flags);
   return 0;
 }
+
+/****************************************************************************
+ * Name: wd_nextexpiry
+ *
+ * Description:
+ *   This function returns the time remaining before the next active
+ *   watchdog timer expires.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the next watchdog expires.
+ *   Zero means that a watchdog is already due.  A negative value means
+ *   that no watchdog is active.
+ *
+ ****************************************************************************/
+
+sclock_t wd_nextexpiry(void)
+{
+  sclock_t delay = 0;
+  irqstate_t flags;
+  bool active = false;
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  clock_t next;
+#endif
+
+  flags = spin_lock_irqsave_subsys(&g_wdspinlock);
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  /* The wheel may report a cascade point ahead of the real expiration;
+   * that only makes the result conservative.
+   */
+
+  if (wd_wheel_next(&next))
+    {
+      delay  = next - clock_systime_ticks();
+      active = true;
+    }
+#else
+  /* The list is ordered, the head holds the lag of the next expiration */
+
+  if (g_wdactivelist.head != NULL)
+    {
+      delay = ((FAR struct wdog_s *)g_wdactivelist.head)->lag -
+              wd_elapse();
+      active = true;
+    }
+#endif
+
+  spin_unlock_irqrestore_subsys(&g_wdspinlock, flags);
+
+  if (!active)
+    {
+      return -1;
+    }
+
+  return delay > 0 ? delay : 0;
+}
@@ -37,7 +37,9 @@
  * this linked list are removed and the function is called.
  */
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 sq_queue_t g_wdactivelist;
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
@@ -47,6 +49,16 @@ sq_queue_t g_wdactivelist;
 clock_t g_wdtickbase;
 #endif
 
+/* Protects the active watchdogs, see wdog.h for the lock order */
+
+spinlock_t g_wdspinlock = SP_UNLOCKED;
+
+/* The watchdog whose function wd_timer() is running */
+
+#ifdef CONFIG_SMP
+FAR struct wdog_s *volatile g_wdrunning;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
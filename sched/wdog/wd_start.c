@@ -69,6 +69,12 @@
 #  define CALL_FUNC(func, arg) func(arg)
 #endif
 
+#ifdef CONFIG_SMP
+#  define wd_setrunning(wdog) (g_wdrunning = (wdog))
+#else
+#  define wd_setrunning(wdog)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -88,15 +94,52 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
 static inline void wd_expiration(void)
 {
   FAR struct wdog_s *wdog;
+  irqstate_t flags;
   wdentry_t func;
+  wdparm_t arg;
+
+  /* Process every watchdog whose expiration time has been reached */
+
+  flags = spin_lock_irqsave_subsys(&g_wdspinlock);
+  while ((wdog = wd_wheel_pop(wd_now())) != NULL)
+    {
+      /* Indicate that the watchdog is no longer active. */
+
+      func = wdog->func;
+      arg  = wdog->arg;
+      wdog->func = NULL;
+      wd_setrunning(wdog);
+      up_setpicbase(wdog->picbase);
+
+      spin_unlock_irqrestore_subsys(&g_wdspinlock, flags);
+
+      /* Execute the watchdog function */
+
+      CALL_FUNC(func, arg);
+
+      flags = spin_lock_irqsave_subsys(&g_wdspinlock);
+    }
+
+  wd_setrunning(NULL);
+  spin_unlock_irqrestore_subsys(&g_wdspinlock, flags);
+}
+#else
+static inline void wd_expiration(void)
+{
+  FAR struct wdog_s *wdog;
+  irqstate_t flags;
+  wdentry_t func;
+  wdparm_t arg;
 
   /* Process the watchdog at the head of the list as well as any
    * other watchdogs that became ready to run at this time
    */
 
+  flags = spin_lock_irqsave_subsys(&g_wdspinlock);
   while (g_wdactivelist.head &&
         ((FAR struct wdog_s *)g_wdactivelist.head)->lag <= 0)
     {
@@ -116,14 +159,24 @@ static inline void wd_expiration(void)
       /* Indicate that the watchdog is no longer active. */
 
       func = wdog->func;
+      arg  = wdog->arg;
       wdog->func = NULL;
+      wd_setrunning(wdog);
+      up_setpicbase(wdog->picbase);
+
+      spin_unlock_irqrestore_subsys(&g_wdspinlock, flags);
 
       /* Execute the watchdog function */
 
-      up_setpicbase(wdog->picbase);
-      CALL_FUNC(func, wdog->arg);
+      CALL_FUNC(func, arg);
+
+      flags = spin_lock_irqsave_subsys(&g_wdspinlock);
     }
+
+  wd_setrunning(NULL);
+  spin_unlock_irqrestore_subsys(&g_wdspinlock, flags);
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -168,10 +221,15 @@ static inline void wd_expiration(void)
 int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
              wdentry_t wdentry, wdparm_t arg)
 {
+#ifndef CONFIG_WDOG_TIMER_WHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
   FAR struct wdog_s *next;
   sclock_t now;
+#endif
+#ifdef CONFIG_SCHED_TICKLESS
+  irqstate_t tflags;
+#endif
   irqstate_t flags;
 
   /* Verify the wdog and setup parameters */
@@ -181,16 +239,28 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
       return -EINVAL;
     }
 
+#ifdef CONFIG_SCHED_TICKLESS
+  /* Cancel the interval timer that drives the timing events.  This will
+   * cause wd_timer to be called which update the delay value for the first
+   * time at the head of the timer list (there is a possibility that it
+   * could even remove it).  The interval timer is still protected by the
+   * critical section.
+   */
+
+  tflags = enter_critical_section();
+  nxsched_cancel_timer();
+#endif
+
   /* Check if the watchdog has been started. If so, stop it.
    * NOTE:  There is a race condition here... the caller may receive
    * the watchdog between the time that wd_start is called and
-   * the critical section is established.
+   * g_wdspinlock is taken.
    */
 
-  flags = enter_critical_section();
+  flags = spin_lock_irqsave_subsys(&g_wdspinlock);
   if (WDOG_ISACTIVE(wdog))
     {
-      wd_cancel(wdog);
+      wd_remove(wdog);
     }
 
   /* Save the data in the watchdog structure */
@@ -223,16 +293,24 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
       delay--;
     }
 
-#ifdef CONFIG_SCHED_TICKLESS
-  /* Cancel the interval timer that drives the timing events.  This will
-   * cause wd_timer to be called which update the delay value for the first
-   * time at the head of the timer list (there is a possibility that it
-   * could even remove it).
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  /* If no watchdog is active, the wheel (and, in the tick-less case, the
+   * tick base) may be stale.  Re-synchronize them with the current time.
    */
 
-  nxsched_cancel_timer();
+  if (wd_wheel_empty())
+    {
+#ifdef CONFIG_SCHED_TICKLESS
+      g_wdtickbase = clock_systime_ticks();
 #endif
+      wd_wheel_reset(wd_now());
+    }
 
+  /* Add the watchdog to the wheel slot matching its expiration time */
+
+  wdog->expired = wd_now() + delay;
+  wd_wheel_add(wdog);
+#else
   /* Do the easy case first -- when the watchdog timer queue is empty. */
 
   if (g_wdactivelist.head == NULL)
@@ -326,6 +404,9 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
   /* Put the lag into the watchdog structure and mark it as active. */
 
   wdog->lag = delay;
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
+
+  spin_unlock_irqrestore_subsys(&g_wdspinlock, flags);
 
 #ifdef CONFIG_SCHED_TICKLESS
   /* Resume the interval timer that will generate the next interval event.
@@ -334,12 +415,59 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
    */
 
   nxsched_resume_timer();
+  leave_critical_section(tflags);
 #endif
 
-  leave_critical_section(flags);
   return OK;
 }
 
+/****************************************************************************
+ * Name: wd_start_slack
+ *
+ * Description:
+ *   Start a watchdog timer like wd_start(), but allow the expiration to be
+ *   deferred by up to 'slack' ticks.  The absolute expiration time is
+ *   rounded up to the largest power-of-two tick boundary that does not
+ *   exceed the slack window, so that timers started at nearby times with
+ *   similar slack expire on the same tick and are serviced by a single
+ *   timer interrupt.
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   delay    - Delay count in clock ticks
+ *   slack    - Maximum additional delay in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is return to
+ *   indicate the nature of any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TIMER_SLACK
+int wd_start_slack(FAR struct wdog_s *wdog, sclock_t delay, sclock_t slack,
+                   wdentry_t wdentry, wdparm_t arg)
+{
+  if (slack > 0 && delay > 0)
+    {
+      clock_t target = clock_systime_ticks() + delay;
+      clock_t align = 1;
+
+      /* Find the largest power of two with (align - 1) <= slack */
+
+      while (align <= ((clock_t)slack + 1) / 2)
+        {
+          align <<= 1;
+        }
+
+      delay += ((target + align - 1) & ~(align - 1)) - target;
+    }
+
+  return wd_start(wdog, delay, wdentry, arg);
+}
+#endif
+
 /****************************************************************************
  * Name: wd_timer
  *
@@ -366,15 +494,68 @@ int wd_start(FAR struct wdog_s *wdog, sclock_t delay,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_SCHED_TICKLESS
+#if defined(CONFIG_WDOG_TIMER_WHEEL) && defined(CONFIG_SCHED_TICKLESS)
+unsigned int wd_timer(int ticks, bool noswitches)
+{
+  irqstate_t flags;
+  clock_t next = 0;
+  sclock_t delay;
+  bool active;
+
+  /* Advance the tick base by the elapsed interval */
+
+  flags = spin_lock_irqsave_subsys(&g_wdspinlock);
+  g_wdtickbase += ticks;
+  spin_unlock_irqrestore_subsys(&g_wdspinlock, flags);
+
+  /* Run the watchdogs that are due, unless context switches are not
+   * permitted now;  they will then be run on the next call.
+   */
+
+  if (!noswitches)
+    {
+      wd_expiration();
+    }
+
+  /* Return the delay until the wheel needs to be processed again */
+
+  flags  = spin_lock_irqsave_subsys(&g_wdspinlock);
+  active = wd_wheel_next(&next);
+  delay  = next - g_wdtickbase;
+  spin_unlock_irqrestore_subsys(&g_wdspinlock, flags);
+
+  if (!active)
+    {
+      return 0;
+    }
+
+  return delay > 1 ? (unsigned int)delay : 1;
+}
+
+#elif defined(CONFIG_WDOG_TIMER_WHEEL)
+void wd_timer(void)
+{
+  /* Run the watchdogs that are due at the current system tick.  The
+   * unlocked check only skips the common case of an empty wheel.
+   */
+
+  if (!wd_wheel_empty())
+    {
+      wd_expiration();
+    }
+}
+
+#elif defined(CONFIG_SCHED_TICKLESS)
 unsigned int wd_timer(int ticks, bool noswitches)
 {
   FAR struct wdog_s *wdog;
   unsigned int ret;
+  irqstate_t flags;
   int decr;
 
   /* Check if there are any active watchdogs to process */
 
+  flags = spin_lock_irqsave_subsys(&g_wdspinlock);
   wdog = (FAR struct wdog_s *)g_wdactivelist.head;
   while (wdog != NULL && ticks > 0)
     {
@@ -391,6 +572,8 @@ unsigned int wd_timer(int ticks, bool noswitches)
       wdog = wdog->next;
     }
 
+  spin_unlock_irqrestore_subsys(&g_wdspinlock, flags);
+
   /* Check if the watchdog at the head of the list is ready to run */
 
   if (!noswitches)
@@ -400,12 +583,14 @@ unsigned int wd_timer(int ticks, bool noswitches)
 
   /* Update clock tickbase */
 
+  flags = spin_lock_irqsave_subsys(&g_wdspinlock);
   g_wdtickbase += ticks;
 
   /* Return the delay for the next watchdog to expire */
 
   ret = g_wdactivelist.head ?
         MAX(((FAR struct wdog_s *)g_wdactivelist.head)->lag, 1) : 0;
+  spin_unlock_irqrestore_subsys(&g_wdspinlock, flags);
 
   /* Return the delay for the next watchdog to expire */
 
@@ -415,16 +600,26 @@ unsigned int wd_timer(int ticks, bool noswitches)
 #else
 void wd_timer(void)
 {
+  irqstate_t flags;
+  bool active;
+
   /* Check if there are any active watchdogs to process */
 
-  if (g_wdactivelist.head)
+  flags  = spin_lock_irqsave_subsys(&g_wdspinlock);
+  active = g_wdactivelist.head != NULL;
+  if (active)
     {
       /* There are.  Decrement the lag counter */
 
       --(((FAR struct wdog_s *)g_wdactivelist.head)->lag);
+    }
 
-      /* Check if the watchdog at the head of the list is ready to run */
+  spin_unlock_irqrestore_subsys(&g_wdspinlock, flags);
 
+  /* Check if the watchdog at the head of the list is ready to run */
+
+  if (active)
+    {
       wd_expiration();
     }
 }
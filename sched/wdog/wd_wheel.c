@@ -0,0 +1,473 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The wheel has WHEEL_LEVELS levels of WHEEL_SLOTS slots each.  A slot in
+ * level n spans 2^(WHEEL_BITS * n) ticks, so the wheel covers delays of up
+ * to 2^(WHEEL_BITS * WHEEL_LEVELS) ticks.  Longer delays are parked in the
+ * last slot reachable at the top level and re-inserted when cascaded.
+ */
+
+#define WHEEL_BITS         6
+#define WHEEL_SLOTS        (1 << WHEEL_BITS)
+#define WHEEL_MASK         (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS       5
+#define WHEEL_NWORDS       (WHEEL_SLOTS / 32)
+
+#define WHEEL_SHIFT(l)     (WHEEL_BITS * (l))
+#define WHEEL_INDEX(t, l)  (((t) >> WHEEL_SHIFT(l)) & WHEEL_MASK)
+#define WHEEL_RANGE(l)     ((clock_t)1 << WHEEL_SHIFT(l))
+#define WHEEL_MAXDELAY     (WHEEL_RANGE(WHEEL_LEVELS) - 1)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The slot lists.  Each list is unordered; watchdogs are linked through
+ * 'next' and 'pprev' so that they can be removed in constant time.
+ */
+
+static FAR struct wdog_s *g_wdwheel[WHEEL_LEVELS][WHEEL_SLOTS];
+
+/* One bit for each non-empty slot, used to find the next expiration
+ * without visiting every slot.
+ */
+
+static uint32_t g_wdwheel_bitmap[WHEEL_LEVELS][WHEEL_NWORDS];
+
+/* Watchdogs whose time has come but whose callbacks have not run yet */
+
+static FAR struct wdog_s *g_wdwheel_expired;
+
+/* The next tick to be processed and the number of active watchdogs */
+
+static clock_t g_wdwheel_cursor;
+static unsigned int g_wdwheel_count;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_link / wd_wheel_unlink
+ ****************************************************************************/
+
+static inline void wd_wheel_link(FAR struct wdog_s **head,
+                                 FAR struct wdog_s *wdog)
+{
+  wdog->next  = *head;
+  wdog->pprev = head;
+
+  if (*head != NULL)
+    {
+      (*head)->pprev = &wdog->next;
+    }
+
+  *head = wdog;
+}
+
+static inline void wd_wheel_unlink(FAR struct wdog_s *wdog)
+{
+  *wdog->pprev = wdog->next;
+
+  if (wdog->next != NULL)
+    {
+      wdog->next->pprev = wdog->pprev;
+    }
+
+  wdog->next  = NULL;
+  wdog->pprev = NULL;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Place the watchdog in the slot that matches its distance from the
+ *   wheel cursor.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+  clock_t expired = wdog->expired;
+  clock_t delta = expired - g_wdwheel_cursor;
+  int level;
+  int index;
+
+  if ((sclock_t)delta < 0)
+    {
+      /* Already due (only possible while expirations are deferred) */
+
+      expired = g_wdwheel_cursor;
+      delta = 0;
+    }
+  else if (delta > WHEEL_MAXDELAY)
+    {
+      expired = g_wdwheel_cursor + WHEEL_MAXDELAY;
+      delta = WHEEL_MAXDELAY;
+    }
+
+  for (level = 0; level < WHEEL_LEVELS - 1; level++)
+    {
+      if (delta < WHEEL_RANGE(level + 1))
+        {
+          break;
+        }
+    }
+
+  index = WHEEL_INDEX(expired, level);
+
+  wd_wheel_link(&g_wdwheel[level][index], wdog);
+  g_wdwheel_bitmap[level][index >> 5] |= (uint32_t)1 << (index & 31);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_slot_emptied
+ *
+ * Description:
+ *   Clear the bitmap bit of the slot that 'link' belongs to if that slot
+ *   has become empty.  'link' may also be the expired list head.
+ *
+ ****************************************************************************/
+
+static inline void wd_wheel_slot_emptied(FAR struct wdog_s **link)
+{
+  FAR struct wdog_s **first = &g_wdwheel[0][0];
+  int slot;
+
+  if (link >= first && link < first + WHEEL_LEVELS * WHEEL_SLOTS &&
+      *link == NULL)
+    {
+      slot = link - first;
+      g_wdwheel_bitmap[slot / WHEEL_SLOTS][(slot & WHEEL_MASK) >> 5] &=
+        ~((uint32_t)1 << (slot & 31));
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Re-insert all watchdogs in one slot of a coarse level; they will land
+ *   in finer levels now that they are closer to expiration.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(int level, int index)
+{
+  FAR struct wdog_s *wdog = g_wdwheel[level][index];
+  FAR struct wdog_s *next;
+
+  g_wdwheel[level][index] = NULL;
+  g_wdwheel_bitmap[level][index >> 5] &= ~((uint32_t)1 << (index & 31));
+
+  while (wdog != NULL)
+    {
+      next = wdog->next;
+      wd_wheel_insert(wdog);
+      wdog = next;
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_advance
+ *
+ * Description:
+ *   Process the tick at the cursor:  cascade coarse slots when the finer
+ *   level wraps, move the due level 0 slot to the expired list and advance
+ *   the cursor.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_advance(void)
+{
+  FAR struct wdog_s *wdog;
+  int index = WHEEL_INDEX(g_wdwheel_cursor, 0);
+  int level;
+
+  if (index == 0)
+    {
+      for (level = 1; level < WHEEL_LEVELS; level++)
+        {
+          int lindex = WHEEL_INDEX(g_wdwheel_cursor, level);
+
+          wd_wheel_cascade(level, lindex);
+          if (lindex != 0)
+            {
+              break;
+            }
+        }
+    }
+
+  wdog = g_wdwheel[0][index];
+  if (wdog != NULL)
+    {
+      DEBUGASSERT(g_wdwheel_expired == NULL);
+
+      g_wdwheel[0][index] = NULL;
+      g_wdwheel_bitmap[0][index >> 5] &= ~((uint32_t)1 << (index & 31));
+
+      g_wdwheel_expired = wdog;
+      wdog->pprev = &g_wdwheel_expired;
+    }
+
+  g_wdwheel_cursor++;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_findslot
+ *
+ * Description:
+ *   Return the distance (0..WHEEL_SLOTS-1) from 'index' to the next
+ *   non-empty slot of 'level', searching forward and wrapping, or -1 if
+ *   the level is empty.
+ *
+ ****************************************************************************/
+
+static int wd_wheel_findslot(int level, int index)
+{
+  FAR uint32_t *bitmap = g_wdwheel_bitmap[level];
+  int word = index >> 5;
+  int i;
+  int bit;
+
+  /* Remainder of the starting word */
+
+  bit = ffs(bitmap[word] & ~(((uint32_t)1 << (index & 31)) - 1));
+  if (bit != 0)
+    {
+      return (word << 5) + bit - 1 - index;
+    }
+
+  /* The remaining words, wrapping around to the start word */
+
+  for (i = 1; i <= WHEEL_NWORDS; i++)
+    {
+      int w = (word + i) % WHEEL_NWORDS;
+
+      bit = ffs(bitmap[w]);
+      if (bit != 0)
+        {
+          return (((w << 5) + bit - 1 - index) & WHEEL_MASK);
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_reset
+ *
+ * Description:
+ *   Re-synchronize the wheel with the current time.  This may only be
+ *   called while no watchdog is active.
+ *
+ ****************************************************************************/
+
+void wd_wheel_reset(clock_t now)
+{
+  DEBUGASSERT(g_wdwheel_count == 0);
+  g_wdwheel_cursor = now + 1;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_empty
+ ****************************************************************************/
+
+bool wd_wheel_empty(void)
+{
+  return g_wdwheel_count == 0;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Add an inactive watchdog to the wheel.  wdog->expired holds the
+ *   absolute expiration time.
+ *
+ ****************************************************************************/
+
+void wd_wheel_add(FAR struct wdog_s *wdog)
+{
+  wd_wheel_insert(wdog);
+  g_wdwheel_count++;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the wheel (or from the expired list).
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+  FAR struct wdog_s **link = wdog->pprev;
+
+  DEBUGASSERT(link != NULL && g_wdwheel_count > 0);
+
+  wd_wheel_unlink(wdog);
+  wd_wheel_slot_emptied(link);
+  g_wdwheel_count--;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_pop
+ *
+ * Description:
+ *   Advance the wheel up to 'now' and return the next watchdog whose
+ *   expiration time has been reached, removing it from the wheel.
+ *
+ * Returned Value:
+ *   The expired watchdog or NULL if no more watchdogs are due.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_pop(clock_t now)
+{
+  FAR struct wdog_s *wdog;
+
+  for (; ; )
+    {
+      wdog = g_wdwheel_expired;
+      if (wdog != NULL)
+        {
+          wd_wheel_unlink(wdog);
+          g_wdwheel_count--;
+          return wdog;
+        }
+
+      if ((sclock_t)(now - g_wdwheel_cursor) < 0)
+        {
+          return NULL;
+        }
+
+      if (g_wdwheel_count == 0)
+        {
+          g_wdwheel_cursor = now + 1;
+          return NULL;
+        }
+
+      wd_wheel_advance();
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the earliest time at which the wheel needs to be processed:
+ *   either the expiration of the next level 0 watchdog or the time at
+ *   which the next non-empty coarse slot is cascaded, whichever is first.
+ *
+ * Input Parameters:
+ *   next - Location to return the absolute time
+ *
+ * Returned Value:
+ *   false if there are no active watchdogs.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR clock_t *next)
+{
+  clock_t cursor = g_wdwheel_cursor;
+  clock_t earliest = 0;
+  bool found = false;
+  int level;
+
+  if (g_wdwheel_count == 0)
+    {
+      return false;
+    }
+
+  if (g_wdwheel_expired != NULL)
+    {
+      *next = cursor - 1;
+      return true;
+    }
+
+  for (level = 0; level < WHEEL_LEVELS; level++)
+    {
+      clock_t base = cursor >> WHEEL_SHIFT(level);
+      int index = WHEEL_INDEX(cursor, level);
+      clock_t when;
+      int first = 0;
+      int dist;
+
+      /* Level 0 slots expire exactly at their tick.  A coarse slot is
+       * visited when the cursor becomes aligned to its boundary, so the
+       * current coarse slot is only still to be visited if the cursor sits
+       * on that boundary now.  Otherwise its contents belong to the next
+       * revolution and the search starts at the following slot.
+       */
+
+      if (level > 0 && (cursor & (WHEEL_RANGE(level) - 1)) != 0)
+        {
+          first = 1;
+        }
+
+      dist = wd_wheel_findslot(level, (index + first) & WHEEL_MASK);
+      if (dist < 0)
+        {
+          continue;
+        }
+
+      when = (base + dist + first) << WHEEL_SHIFT(level);
+
+      if (!found || (sclock_t)(when - earliest) < 0)
+        {
+          earliest = when;
+          found = true;
+        }
+    }
+
+  DEBUGASSERT(found);
+  *next = earliest;
+  return found;
+}
+
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
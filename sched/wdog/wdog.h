@@ -33,6 +33,7 @@
 #include <nuttx/compiler.h>
 #include <nuttx/clock.h>
 #include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/wdog.h>
 
 /****************************************************************************
@@ -56,6 +57,24 @@
 #  define wd_elapse() (0)
 #endif
 
+/****************************************************************************
+ * Name: wd_now
+ *
+ * Description:
+ *   The time base that watchdog expiration times are relative to when the
+ *   timer wheel is used:  the tick base of the last wd_timer() call in the
+ *   tick-less case or the system tick count otherwise.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+#  ifdef CONFIG_SCHED_TICKLESS
+#    define wd_now() g_wdtickbase
+#  else
+#    define wd_now() clock_systime_ticks()
+#  endif
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -73,7 +92,9 @@ extern "C"
  * this linked list are removed and the function is called.
  */
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 extern sq_queue_t g_wdactivelist;
+#endif
 
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
@@ -83,6 +104,25 @@ extern sq_queue_t g_wdactivelist;
 extern clock_t g_wdtickbase;
 #endif
 
+/* g_wdspinlock protects the active watchdogs (g_wdactivelist or the timer
+ * wheel) and g_wdtickbase in place of the global critical section.
+ *
+ * Lock order:  if the critical section is held as well, it is entered
+ * first.  g_wdspinlock is never held while entering the critical section,
+ * while running a watchdog function or while calling the nxsched_*_timer()
+ * interfaces, which call back into wd_timer().  The watchdog functions
+ * still run within the critical section, and so does the tick-less
+ * interval timer handling in wd_start() and wd_cancel().
+ */
+
+extern spinlock_t g_wdspinlock;
+
+/* The watchdog whose function wd_timer() is running, see wd_cancel() */
+
+#ifdef CONFIG_SMP
+extern FAR struct wdog_s *volatile g_wdrunning;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -141,6 +181,46 @@ void wd_timer(void);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+/****************************************************************************
+ * Name: wd_remove
+ *
+ * Description:
+ *   Remove an active watchdog from the active watchdogs and mark it
+ *   inactive.
+ *
+ * Input Parameters:
+ *   wdog - The active watchdog to remove.
+ *
+ * Returned Value:
+ *   True if the next expiration has changed, so that the interval timer
+ *   has to be reassessed.
+ *
+ * Assumptions:
+ *   g_wdspinlock is held.
+ *
+ ****************************************************************************/
+
+bool wd_remove(FAR struct wdog_s *wdog);
+
+/****************************************************************************
+ * Name: wd_wheel_*
+ *
+ * Description:
+ *   The hierarchical timer wheel that holds the active watchdogs when
+ *   CONFIG_WDOG_TIMER_WHEEL is selected (see wd_wheel.c).  All of these
+ *   must be called with g_wdspinlock held.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+void wd_wheel_reset(clock_t now);
+bool wd_wheel_empty(void);
+void wd_wheel_add(FAR struct wdog_s *wdog);
+void wd_wheel_remove(FAR struct wdog_s *wdog);
+FAR struct wdog_s *wd_wheel_pop(clock_t now);
+bool wd_wheel_next(FAR clock_t *next);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,378 @@
+/****************************************************************************
+ * sched/wqueue/kwork_cpu.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/queue.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/kthread.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/semaphore.h>
+
+#include "sched/sched.h"
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_SCHED_CPUWORK
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The state of the per-CPU work queues */
+
+struct cpu_wqueue_s g_cpuwork[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cpu_queue_work
+ *
+ * Description:
+ *   Append work to a per-CPU queue.  The worker is only woken when the
+ *   queue goes from empty to non-empty; work queued while the worker is
+ *   already draining the queue is picked up in the same pass.
+ *
+ * Assumptions:
+ *   work->worker and work->arg have been set up and the work is not
+ *   currently queued.
+ *
+ ****************************************************************************/
+
+static void cpu_queue_work(FAR struct cpu_wqueue_s *wqueue,
+                           FAR struct work_s *work)
+{
+  irqstate_t flags;
+  bool wake;
+
+  flags = spin_lock_irqsave(&wqueue->lock);
+  wake  = dq_empty(&wqueue->q);
+  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+  spin_unlock_irqrestore(&wqueue->lock, flags);
+
+  if (wake)
+    {
+      nxsem_post(&wqueue->sem);
+    }
+}
+
+/****************************************************************************
+ * Name: cpu_work_timer_expiry
+ ****************************************************************************/
+
+static void cpu_work_timer_expiry(wdparm_t arg)
+{
+  FAR struct work_s *work = (FAR struct work_s *)arg;
+
+  cpu_queue_work(&g_cpuwork[work->cpu], work);
+}
+
+/****************************************************************************
+ * Name: cpu_work_qcancel
+ *
+ * Description:
+ *   Remove work from a per-CPU queue or stop its delay timer.
+ *
+ * Assumptions:
+ *   Called within the critical section so that the delay timer cannot
+ *   expire concurrently.
+ *
+ ****************************************************************************/
+
+static int cpu_work_qcancel(FAR struct cpu_wqueue_s *wqueue,
+                            FAR struct work_s *work)
+{
+  int ret = -ENOENT;
+
+  spin_lock(&wqueue->lock);
+  if (work->worker != NULL)
+    {
+      if (WDOG_ISACTIVE(&work->u.timer))
+        {
+          wd_cancel(&work->u.timer);
+        }
+      else
+        {
+          dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+        }
+
+      work->worker = NULL;
+      ret = OK;
+    }
+
+  spin_unlock(&wqueue->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cpu_work_thread
+ *
+ * Description:
+ *   The worker thread of one per-CPU work queue.  All pending work is
+ *   drained on each wakeup.
+ *
+ ****************************************************************************/
+
+static int cpu_work_thread(int argc, FAR char *argv[])
+{
+  FAR struct cpu_wqueue_s *wqueue;
+  FAR struct work_s *work;
+  worker_t worker;
+  irqstate_t flags;
+  FAR void *arg;
+
+  wqueue = &g_cpuwork[atoi(argv[1])];
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&wqueue->lock);
+      while ((work = (FAR struct work_s *)dq_remfirst(&wqueue->q)) != NULL)
+        {
+          /* Extract the work description and mark it as no longer queued
+           * before dropping the lock.
+           */
+
+          worker       = work->worker;
+          arg          = work->arg;
+          work->worker = NULL;
+
+          spin_unlock_irqrestore(&wqueue->lock, flags);
+          worker(arg);
+          flags = spin_lock_irqsave(&wqueue->lock);
+        }
+
+      spin_unlock_irqrestore(&wqueue->lock, flags);
+
+      /* Sleep until the queue becomes non-empty again */
+
+      nxsem_wait_uninterruptible(&wqueue->sem);
+    }
+
+  return OK; /* To keep some compilers happy */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue kernel-mode work to be performed by the worker thread bound to
+ *   the specified CPU.  The semantics are otherwise identical to
+ *   work_queue().
+ *
+ * Input Parameters:
+ *   cpu    - The CPU whose work queue is used
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_queue_cpu(int cpu, FAR struct work_s *work, worker_t worker,
+                   FAR void *arg, clock_t delay)
+{
+  FAR struct cpu_wqueue_s *wqueue;
+  irqstate_t flags;
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS || worker == NULL)
+    {
+      return -EINVAL;
+    }
+
+  wqueue = &g_cpuwork[cpu];
+
+  /* Fast path: immediate work that is not already pending only needs the
+   * lock of the target queue.
+   */
+
+  if (delay == 0)
+    {
+      flags = spin_lock_irqsave(&wqueue->lock);
+      if (work->worker == NULL)
+        {
+          bool wake = dq_empty(&wqueue->q);
+
+          work->worker = worker;
+          work->arg    = arg;
+          work->cpu    = cpu;
+          dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+          spin_unlock_irqrestore(&wqueue->lock, flags);
+
+          if (wake)
+            {
+              nxsem_post(&wqueue->sem);
+            }
+
+          return OK;
+        }
+
+      spin_unlock_irqrestore(&wqueue->lock, flags);
+    }
+
+  /* Otherwise, cancel any pending instance and (re)start the work within
+   * the critical section that also protects the delay timers.
+   */
+
+  flags = enter_critical_section();
+
+  if (work->worker != NULL)
+    {
+      cpu_work_qcancel(&g_cpuwork[work->cpu], work);
+    }
+
+  work->worker = worker;
+  work->arg    = arg;
+  work->cpu    = cpu;
+
+  if (delay == 0)
+    {
+      cpu_queue_work(wqueue, work);
+    }
+  else
+    {
+      wd_start(&work->u.timer, delay, cpu_work_timer_expiry,
+               (wdparm_t)work);
+    }
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: work_cancel_cpu
+ *
+ * Description:
+ *   Cancel work previously queued with work_queue_cpu().
+ *
+ * Input Parameters:
+ *   cpu    - The CPU whose work queue was used
+ *   work   - The previously queued work structure to cancel
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ *   -ENOENT - There is no such work queued.
+ *   -EINVAL - An invalid CPU was specified
+ *
+ ****************************************************************************/
+
+int work_cancel_cpu(int cpu, FAR struct work_s *work)
+{
+  irqstate_t flags;
+  int ret;
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  ret = cpu_work_qcancel(&g_cpuwork[cpu], work);
+  leave_critical_section(flags);
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: work_start_cpu
+ *
+ * Description:
+ *   Start one worker thread bound to each CPU for the per-CPU work queues.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+int work_start_cpu(void)
+{
+  FAR char *argv[2];
+  char args[8];
+  cpu_set_t cpuset;
+  int cpu;
+  int pid;
+
+  sinfo("Starting per-CPU kernel worker threads\n");
+
+  argv[0] = args;
+  argv[1] = NULL;
+
+  /* Don't permit any of the threads to run until they are bound */
+
+  sched_lock();
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      FAR struct cpu_wqueue_s *wqueue = &g_cpuwork[cpu];
+
+      dq_init(&wqueue->q);
+      nxsem_init(&wqueue->sem, 0, 0);
+      spin_initialize(&wqueue->lock, SP_UNLOCKED);
+
+      snprintf(args, sizeof(args), "%d", cpu);
+      pid = kthread_create(CPUWORKNAME, CONFIG_SCHED_CPUWORKPRIORITY,
+                           CONFIG_SCHED_CPUWORKSTACKSIZE,
+                           cpu_work_thread, argv);
+
+      DEBUGASSERT(pid > 0);
+      if (pid < 0)
+        {
+          serr("ERROR: work_start_cpu %d failed: %d\n", cpu, pid);
+          sched_unlock();
+          return pid;
+        }
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpu, &cpuset);
+      nxsched_set_affinity(pid, sizeof(cpu_set_t), &cpuset);
+
+      wqueue->worker[0].pid = pid;
+      wqueue->nthreads      = 1;
+    }
+
+  sched_unlock();
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_CPUWORK */
@@ -71,6 +71,13 @@
 #  define CALL_WORKER(worker, arg) worker(arg)
 #endif
 
+/* Does the low priority pool grow on demand? */
+
+#if defined(CONFIG_SCHED_LPWORK) && \
+    CONFIG_SCHED_LPNTHREADS_MAX > CONFIG_SCHED_LPNTHREADS
+#  define LPWORK_DYNAMIC 1
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -97,10 +104,106 @@ struct lp_wqueue_s g_lpwork =
 
 #endif /* CONFIG_SCHED_LPWORK */
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef LPWORK_DYNAMIC
+/* True while a low priority worker is creating an additional worker */
+
+static bool g_lpwork_growing;
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef LPWORK_DYNAMIC
+static int work_thread_spawn(FAR const char *name, int priority,
+                             int stack_size,
+                             FAR struct kwork_wqueue_s *wqueue);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: work_lpwork_needgrow
+ *
+ * Description:
+ *   Check if the low priority pool should be grown: more work is pending,
+ *   no worker thread is idle waiting for it, and the pool has not yet
+ *   reached CONFIG_SCHED_LPNTHREADS_MAX.  If so, the right to grow the
+ *   pool is claimed by the caller.
+ *
+ * Assumptions:
+ *   Called from a worker thread within the critical section.
+ *
+ ****************************************************************************/
+
+#ifdef LPWORK_DYNAMIC
+static bool work_lpwork_needgrow(FAR struct kwork_wqueue_s *wqueue)
+{
+  int sem_count;
+
+  if (wqueue != (FAR struct kwork_wqueue_s *)&g_lpwork ||
+      g_lpwork_growing ||
+      g_lpwork.nthreads >= CONFIG_SCHED_LPNTHREADS_MAX ||
+      dq_empty(&g_lpwork.q))
+    {
+      return false;
+    }
+
+  /* A negative count means that some worker is already waiting */
+
+  nxsem_get_value(&g_lpwork.sem, &sem_count);
+  if (sem_count < 0)
+    {
+      return false;
+    }
+
+  g_lpwork_growing = true;
+  return true;
+}
+
+/****************************************************************************
+ * Name: work_lpwork_grow
+ *
+ * Description:
+ *   Add one worker thread to the low priority pool.
+ *
+ * Assumptions:
+ *   Called from a worker thread outside of the critical section after
+ *   work_lpwork_needgrow() returned true.
+ *
+ ****************************************************************************/
+
+static void work_lpwork_grow(void)
+{
+  irqstate_t flags;
+  int pid;
+
+  pid = work_thread_spawn(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY,
+                          CONFIG_SCHED_LPWORKSTACKSIZE,
+                          (FAR struct kwork_wqueue_s *)&g_lpwork);
+
+  flags = enter_critical_section();
+  if (pid > 0)
+    {
+      g_lpwork.worker[g_lpwork.nthreads].pid = pid;
+      g_lpwork.nthreads++;
+    }
+  else
+    {
+      swarn("WARNING: Failed to grow the lpwork pool: %d\n", pid);
+    }
+
+  g_lpwork_growing = false;
+  leave_critical_section(flags);
+}
+#endif
+
 /****************************************************************************
  * Name: work_thread
  *
@@ -130,6 +233,9 @@ static int work_thread(int argc, FAR char *argv[])
   worker_t worker;
   irqstate_t flags;
   FAR void *arg;
+#ifdef LPWORK_DYNAMIC
+  bool grow;
+#endif
 
   wqueue = (FAR struct kwork_wqueue_s *)
            ((uintptr_t)strtoul(argv[1], NULL, 16));
@@ -168,11 +274,27 @@ static int work_thread(int argc, FAR char *argv[])
 
           work->worker = NULL;
 
+#ifdef LPWORK_DYNAMIC
+          /* If more work is backing up behind this one and every worker
+           * is busy, add another worker to the pool.
+           */
+
+          grow = work_lpwork_needgrow(wqueue);
+#endif
+
           /* Do the work.  Re-enable interrupts while the work is being
            * performed... we don't have any idea how long this will take!
            */
 
           leave_critical_section(flags);
+
+#ifdef LPWORK_DYNAMIC
+          if (grow)
+            {
+              work_lpwork_grow();
+            }
+#endif
+
           CALL_WORKER(worker, arg);
           flags = enter_critical_section();
         }
@@ -190,6 +312,38 @@ static int work_thread(int argc, FAR char *argv[])
   return OK; /* To keep some compilers happy */
 }
 
+/****************************************************************************
+ * Name: work_thread_spawn
+ *
+ * Description:
+ *   Create one worker thread that services the provided work queue.
+ *
+ * Input Parameters:
+ *   name       - Name of the new task
+ *   priority   - Priority of the new task
+ *   stack_size - size (in bytes) of the stack needed
+ *   wqueue     - Work queue instance
+ *
+ * Returned Value:
+ *   The task ID of the new thread on success; a negated errno value is
+ *   returned on failure.
+ *
+ ****************************************************************************/
+
+static int work_thread_spawn(FAR const char *name, int priority,
+                             int stack_size,
+                             FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR char *argv[2];
+  char args[32];
+
+  snprintf(args, sizeof(args), "%p", wqueue);
+  argv[0] = args;
+  argv[1] = NULL;
+
+  return kthread_create(name, priority, stack_size, work_thread, argv);
+}
+
 /****************************************************************************
  * Name: work_thread_create
  *
@@ -213,15 +367,9 @@ static int work_thread_create(FAR const char *name, int priority,
                               int stack_size, int nthread,
                               FAR struct kwork_wqueue_s *wqueue)
 {
-  FAR char *argv[2];
-  char args[32];
   int wndx;
   int pid;
 
-  snprintf(args, sizeof(args), "%p", wqueue);
-  argv[0] = args;
-  argv[1] = NULL;
-
   /* Don't permit any of the threads to run until we have fully initialized
    * g_hpwork and g_lpwork.
    */
@@ -230,8 +378,7 @@ static int work_thread_create(FAR const char *name, int priority,
 
   for (wndx = 0; wndx < nthread; wndx++)
     {
-      pid = kthread_create(name, priority, stack_size,
-                           work_thread, argv);
+      pid = work_thread_spawn(name, priority, stack_size, wqueue);
 
       DEBUGASSERT(pid > 0);
       if (pid < 0)
@@ -242,6 +389,7 @@ static int work_thread_create(FAR const char *name, int priority,
         }
 
       wqueue->worker[wndx].pid  = pid;
+      wqueue->nthreads          = wndx + 1;
     }
 
   sched_unlock();
@@ -272,14 +420,12 @@ static int work_thread_create(FAR const char *name, int priority,
 void work_foreach(int qid, work_foreach_t handler, FAR void *arg)
 {
   FAR struct kwork_wqueue_s *wqueue;
-  int nthread;
   int wndx;
 
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
       wqueue  = (FAR struct kwork_wqueue_s *)&g_hpwork;
-      nthread = CONFIG_SCHED_HPNTHREADS;
     }
   else
 #endif
@@ -287,7 +433,6 @@ void work_foreach(int qid, work_foreach_t handler, FAR void *arg)
   if (qid == LPWORK)
     {
       wqueue  = (FAR struct kwork_wqueue_s *)&g_lpwork;
-      nthread = CONFIG_SCHED_LPNTHREADS;
     }
   else
 #endif
@@ -295,7 +440,7 @@ void work_foreach(int qid, work_foreach_t handler, FAR void *arg)
       return;
     }
 
-  for (wndx = 0; wndx < nthread; wndx++)
+  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
     {
       handler(wqueue->worker[wndx].pid, arg);
     }
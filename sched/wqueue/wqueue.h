@@ -32,6 +32,7 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
@@ -43,6 +44,13 @@
 
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
+#define CPUWORKNAME "cpuwork"
+
+/* The low priority pool may grow on demand up to this many threads */
+
+#ifndef CONFIG_SCHED_LPNTHREADS_MAX
+#  define CONFIG_SCHED_LPNTHREADS_MAX CONFIG_SCHED_LPNTHREADS
+#endif
 
 /****************************************************************************
  * Public Type Definitions
@@ -61,6 +69,7 @@ struct kwork_wqueue_s
 {
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
+  uint8_t           nthreads;  /* Number of worker threads started */
   struct kworker_s  worker[1]; /* Describes a worker thread */
 };
 
@@ -73,6 +82,7 @@ struct hp_wqueue_s
 {
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
+  uint8_t           nthreads;  /* Number of worker threads started */
 
   /* Describes each thread in the high priority queue's thread pool */
 
@@ -89,10 +99,30 @@ struct lp_wqueue_s
 {
   struct dq_queue_s q;         /* The queue of pending work */
   sem_t             sem;       /* The counting semaphore of the wqueue */
+  uint8_t           nthreads;  /* Number of worker threads started */
 
-  /* Describes each thread in the low priority queue's thread pool */
+  /* Describes each thread in the low priority queue's thread pool.  The
+   * pool starts with CONFIG_SCHED_LPNTHREADS threads and may grow up to
+   * CONFIG_SCHED_LPNTHREADS_MAX.
+   */
 
-  struct kworker_s  worker[CONFIG_SCHED_LPNTHREADS];
+  struct kworker_s  worker[CONFIG_SCHED_LPNTHREADS_MAX];
+};
+#endif
+
+/* This structure defines the state of one per-CPU work queue.  The list is
+ * protected by its own spinlock rather than by the global critical section
+ * so that work queued on different CPUs does not contend.
+ */
+
+#ifdef CONFIG_SCHED_CPUWORK
+struct cpu_wqueue_s
+{
+  struct dq_queue_s q;         /* The queue of pending work */
+  sem_t             sem;       /* Posted when the queue becomes non-empty */
+  uint8_t           nthreads;  /* Number of worker threads started */
+  struct kworker_s  worker[1]; /* Describes the worker thread */
+  spinlock_t        lock;      /* Protects q */
 };
 #endif
 
@@ -112,6 +142,12 @@ extern struct hp_wqueue_s g_hpwork;
 extern struct lp_wqueue_s g_lpwork;
 #endif
 
+#ifdef CONFIG_SCHED_CPUWORK
+/* The state of the per-CPU work queues. */
+
+extern struct cpu_wqueue_s g_cpuwork[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -154,6 +190,24 @@ int work_start_highpri(void);
 int work_start_lowpri(void);
 #endif
 
+/****************************************************************************
+ * Name: work_start_cpu
+ *
+ * Description:
+ *   Start one worker thread bound to each CPU for the per-CPU work queues.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUWORK
+int work_start_cpu(void);
+#endif
+
 /****************************************************************************
  * Name: work_initialize_notifier
  *
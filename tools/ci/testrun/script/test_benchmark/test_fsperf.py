@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+# encoding: utf-8
+import re
+import time
+
+import pytest
+from utils.common import getCommandOutput, saveBenchmark
+
+pytestmark = [pytest.mark.benchmark, pytest.mark.sim]
+
+# The file systems of sim:fsperf: FAT on a RAM disk, littlefs on the RAM
+# MTD and tmpfs.  romfs is read-only and only read.
+RAMDISK = "/dev/ram3"
+MOUNTS = {
+    "vfat": "/mnt/fat",
+    "littlefs": "/mnt/lfs",
+    "tmpfs": "/tmp",
+}
+ROMFS_FILE = "/etc/init.d/rcS"
+FILESIZE = 256 * 1024
+BLOCKSIZES = [512, 4096, 16384]
+
+# dd reports its own time when it can, otherwise the command is timed here
+DDTIME = re.compile(r"(\d+)\s+bytes.*?(\d+)\s+usec")
+
+
+def timed(p, cmd, timeout=120):
+    """Run 'cmd' and return its duration in microseconds."""
+    start = time.monotonic()
+    output = getCommandOutput(p, cmd, timeout)
+    elapsed = int((time.monotonic() - start) * 1e6)
+    if output is None:
+        return None
+
+    match = DDTIME.search(output)
+    if match is not None:
+        return int(match.group(2))
+    return elapsed
+
+
+def throughput(nbytes, usec):
+    """KiB/s, or None if the command failed."""
+    if not usec:
+        return None
+    return nbytes * 1e6 / 1024 / usec
+
+
+def mount_all(p):
+    getCommandOutput(p, "mkrd -m 3 -s 512 2048")
+    getCommandOutput(p, "mkfatfs %s" % RAMDISK)
+    getCommandOutput(p, "mkdir %s" % MOUNTS["vfat"])
+    getCommandOutput(p, "mount -t vfat %s %s" % (RAMDISK, MOUNTS["vfat"]))
+
+
+def test_sequential(p):
+    mount_all(p)
+    result = {}
+    for fs, mount in MOUNTS.items():
+        path = "%s/fsperf.bin" % mount
+        result[fs] = {}
+        for bs in BLOCKSIZES:
+            count = FILESIZE // bs
+            write = timed(
+                p, "dd if=/dev/zero of=%s bs=%d count=%d" % (path, bs, count)
+            )
+            read = timed(
+                p, "dd if=%s of=/dev/null bs=%d count=%d" % (path, bs, count)
+            )
+            getCommandOutput(p, "rm %s" % path)
+            result[fs][str(bs)] = {
+                "write_kbps": throughput(FILESIZE, write),
+                "read_kbps": throughput(FILESIZE, read),
+            }
+
+    usec = timed(p, "dd if=%s of=/dev/null bs=512" % ROMFS_FILE)
+    result["romfs"] = {"read_usec": usec}
+
+    assert any(
+        v["write_kbps"] is not None
+        for fs in MOUNTS
+        for v in result[fs].values()
+    )
+    saveBenchmark(p, "fs_sequential", result)
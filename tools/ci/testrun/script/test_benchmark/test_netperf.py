@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+# encoding: utf-8
+import re
+
+import pytest
+from utils.common import getCommandOutput, saveBenchmark
+
+pytestmark = [pytest.mark.benchmark, pytest.mark.sim, pytest.mark.qemu]
+
+# The stack is measured over the loopback device, so that no driver or
+# host network is involved
+HOST = "127.0.0.1"
+DURATION = 5
+MSGSIZES = [64, 256, 1024, 1460, 8192]
+PINGCOUNT = 200
+
+BANDWIDTH = re.compile(r"([\d.]+)\s*([KMG]?)bits/sec")
+RTT = re.compile(r"time=([\d.]+)\s*ms")
+SCALE = {"": 1e-6, "K": 1e-3, "M": 1.0, "G": 1e3}
+
+
+def parse_bandwidth(output):
+    """Average the interval reports of iperf, in Mbits/sec."""
+    values = [float(v) * SCALE[u] for v, u in BANDWIDTH.findall(output)]
+    if not values:
+        return None
+    return sum(values) / len(values)
+
+
+def percentile(values, pct):
+    values = sorted(values)
+    index = min(len(values) - 1, int(round(pct / 100.0 * (len(values) - 1))))
+    return values[index]
+
+
+def run_iperf(p, udp):
+    """Measure the throughput for each message size."""
+    proto = " -u" if udp else ""
+    result = {}
+
+    getCommandOutput(p, "iperf -s%s &" % proto)
+    for size in MSGSIZES:
+        output = getCommandOutput(
+            p,
+            "iperf -c %s%s -l %d -t %d -i 1" % (HOST, proto, size, DURATION),
+            DURATION * 4,
+        )
+        if output is not None:
+            result[str(size)] = parse_bandwidth(output)
+
+    getCommandOutput(p, "iperf -a")
+    return result
+
+
+def test_tcp_throughput(p):
+    result = run_iperf(p, False)
+    assert any(v is not None for v in result.values())
+    saveBenchmark(p, "tcp_throughput", result)
+
+
+def test_udp_throughput(p):
+    result = run_iperf(p, True)
+    assert any(v is not None for v in result.values())
+    saveBenchmark(p, "udp_throughput", result)
+
+
+def test_latency(p):
+    output = getCommandOutput(p, "ping -c %d -i 10 %s" % (PINGCOUNT, HOST), 120)
+    assert output is not None
+    rtts = [float(v) for v in RTT.findall(output)]
+    assert rtts
+    result = {
+        "count": len(rtts),
+        "p50": percentile(rtts, 50),
+        "p90": percentile(rtts, 90),
+        "p99": percentile(rtts, 99),
+        "max": max(rtts),
+    }
+    saveBenchmark(p, "icmp_latency", result)
@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+# encoding: utf-8
+import re
+
+import pytest
+from utils.common import getCommandOutput, saveBenchmark
+
+pytestmark = [pytest.mark.benchmark, pytest.mark.sim]
+
+# A result row: the name of the case followed by its figures
+ROW = re.compile(r"^\s*([A-Za-z][\w-]*)((?:\s+\d+(?:\.\d+)?)+)\s*$")
+
+
+def parse_table(output):
+    """Turn the table printed by a benchmark into {case: {column: value}}.
+
+    The columns are named after the last header line, i.e. the last line
+    that has as many words as a row has figures plus the case name.
+    """
+    header = []
+    result = {}
+    for line in output.splitlines():
+        match = ROW.match(line)
+        if match is None:
+            words = line.split()
+            if len(words) > 1:
+                header = [w.lower() for w in words[1:]]
+            continue
+
+        figures = [float(f) for f in match.group(2).split()]
+        names = header
+        if len(names) != len(figures):
+            names = ["value%d" % i for i in range(len(figures))]
+        result[match.group(1)] = dict(zip(names, figures))
+
+    return result
+
+
+def test_osperf(p):
+    output = getCommandOutput(p, "osperf", 600)
+    assert output is not None
+    result = parse_table(output)
+    assert result
+    saveBenchmark(p, "osperf", result)
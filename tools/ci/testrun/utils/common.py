@@ -1,5 +1,6 @@
 #!/usr/bin/env python3
 
+import json
 import os
 import re
 import subprocess
@@ -323,6 +324,76 @@ def getLog(filename, str1, str2):
         return l1
 
 
+# run a command on nsh and return what it printed
+def getCommandOutput(p, cmd, timeout=10):
+    p.process.buffer = b""
+    p.process.sendline(cmd)
+    try:
+        p.process.expect(p.PROMPT, timeout=timeout)
+    except (pexpect.TIMEOUT, pexpect.EOF):
+        print("Debug: '%s' did not complete" % cmd)
+        return None
+
+    return p.process.before.decode(errors="ignore")
+
+
+# save a benchmark result as JSON next to the log, one file per run
+def saveBenchmark(p, name, result):
+    path = os.path.join(
+        p.log_path,
+        "{}_{}_{}.json".format(p.board, name, time.strftime("%Y%m%d_%H%M%S")),
+    )
+    with open(path, "w") as f:
+        json.dump({"board": p.board, "benchmark": name, "result": result}, f)
+    print("benchmark result: %s" % path)
+
+    baseline = os.environ.get("NUTTX_BENCHMARK_BASELINE")
+    if baseline:
+        checkBenchmark(p, name, result, baseline)
+    return path
+
+
+def flattenBenchmark(result, prefix=""):
+    """Turn the nested figures of a result into {"case/figure": value}."""
+    flat = {}
+    for key, value in result.items():
+        if isinstance(value, dict):
+            flat.update(flattenBenchmark(value, "%s%s/" % (prefix, key)))
+        elif isinstance(value, (int, float)):
+            flat["%s%s" % (prefix, key)] = float(value)
+    return flat
+
+
+def checkBenchmark(p, name, result, baseline):
+    """Compare a result with <baseline>/<board>_<name>.json.
+
+    With CONFIG_SIM_VIRTUAL_TIME the simulator gives the same figures on
+    every run, so any figure that moved by more than
+    NUTTX_BENCHMARK_TOLERANCE (default 2%) is reported and fails the test:
+    either the code got slower or the baseline needs to be updated.
+    """
+    path = os.path.join(baseline, "{}_{}.json".format(p.board, name))
+    if not os.path.exists(path):
+        print("benchmark baseline: %s not found, skipped" % path)
+        return
+
+    with open(path, "r") as f:
+        expected = flattenBenchmark(json.load(f)["result"])
+
+    tolerance = float(os.environ.get("NUTTX_BENCHMARK_TOLERANCE", "0.02"))
+    changed = []
+    for key, value in flattenBenchmark(result).items():
+        base = expected.get(key)
+        if base is None:
+            continue
+        if abs(value - base) > tolerance * max(abs(base), 1e-9):
+            changed.append("%s: %g -> %g" % (key, base, value))
+
+    for line in changed:
+        print("benchmark changed: %s" % line)
+    assert not changed, "%s differs from %s" % (name, path)
+
+
 def rmfile(p, core, file):
     if p.core == core:
         p.sendCommand("rm -r" + file)
@@ -91,16 +91,18 @@
 #define FILE_MODEFLAGS     (NUTTX_IFREG | NUTTX_IRUSR | NUTTX_IRGRP | NUTTX_IROTH)
 
 #define CROMFS_MAGIC       0x4d4f5243
-#define CROMFS_BLOCKSIZE   512
+#define CROMFS_BLOCKSIZE   512        /* Default block size */
+#define CROMFS_MAX_BLOCKSIZE 32768    /* Block lengths are 16-bits */
 
-#define LZF_BUFSIZE        512
 #define LZF_HLOG           13
 #define LZF_HSIZE          (1 << LZF_HLOG)
 
 #define LZF_TYPE0_HDR      0
 #define LZF_TYPE1_HDR      1
+#define LZ4_TYPE2_HDR      2
 #define LZF_TYPE0_HDR_SIZE 5
 #define LZF_TYPE1_HDR_SIZE 7
+#define LZ4_TYPE2_HDR_SIZE 7
 
 #define LZF_FRST(p)        (((p[0]) << 8) | p[1])
 #define LZF_NEXT(v,p)      (((v) << 8) | p[2])
@@ -110,6 +112,15 @@
 #define LZF_MAX_OFF        (1 << LZF_HLOG)
 #define LZF_MAX_REF        ((1 << 8) + (1 << 3))
 
+#define LZ4_HLOG           12
+#define LZ4_HSIZE          (1 << LZ4_HLOG)
+#define LZ4_HASH(p)        ((get_uint32(p) * 2654435761u) >> (32 - LZ4_HLOG))
+
+#define LZ4_MIN_MATCH      4   /* Shortest match */
+#define LZ4_LAST_LITERALS  5   /* The last bytes of a block are literals */
+#define LZ4_MF_LIMIT       12  /* No match starts in the last bytes */
+#define LZ4_MAX_DISTANCE   65535
+
 #define HEX_PER_LINE       8
 
 /****************************************************************************
@@ -158,7 +169,7 @@ struct cromfs_node_s
 struct lzf_header_s       /* Common data header */
 {
   uint8_t lzf_magic[2];   /* [0]='Z', [1]='V' */
-  uint8_t lzf_type;       /* LZF_TYPE0_HDR or LZF_TYPE1_HDR */
+  uint8_t lzf_type;       /* LZF_TYPE0_HDR, LZF_TYPE1_HDR or LZ4_TYPE2_HDR */
 };
 
 struct lzf_type0_header_s /* Uncompressed data header */
@@ -176,29 +187,31 @@ struct lzf_type1_header_s /* Compressed data header */
   uint8_t lzf_ulen[2];    /* Uncompressed data length (big-endian) */
 };
 
-/* LZF data buffer */
+/* LZF data buffer.  LZ4 blocks use the same layout as the compressed LZF
+ * header with type LZ4_TYPE2_HDR.
+ */
 
 union lzf_result_u
 {
   struct
   {
     uint8_t lzf_magic[2];     /* [0]='Z', [1]='V' */
-    uint8_t lzf_type;         /* LZF_TYPE0_HDR or LZF_TYPE1_HDR */
+    uint8_t lzf_type;         /* LZF_TYPE0_HDR, 1 or LZ4_TYPE2_HDR */
   } cmn;                      /* Common data header */
   struct
   {
     uint8_t lzf_magic[2];     /* [0]='Z', [1]='V' */
     uint8_t lzf_type;         /* LZF_TYPE0_HDR */
     uint8_t lzf_len[2];       /* Data length (big-endian) */
-    uint8_t lzf_buffer[LZF_BUFSIZE];
+    uint8_t lzf_buffer[CROMFS_MAX_BLOCKSIZE];
   } uncompressed;             /* Uncompressed data header */
   struct
   {
     uint8_t lzf_magic[2];     /* [0]='Z', [1]='V' */
-    uint8_t lzf_type;         /* LZF_TYPE1_HDR */
+    uint8_t lzf_type;         /* LZF_TYPE1_HDR or LZ4_TYPE2_HDR */
     uint8_t lzf_clen[2];      /* Compressed data length (big-endian) */
     uint8_t lzf_ulen[2];      /* Uncompressed data length (big-endian) */
-    uint8_t lzf_buffer[LZF_BUFSIZE + 16];
+    uint8_t lzf_buffer[CROMFS_MAX_BLOCKSIZE + 16];
   } compressed;
 };
 
@@ -206,6 +219,10 @@ union lzf_result_u
 
 static uint8_t *g_lzf_hashtab[LZF_HSIZE];
 
+/* LZ4 hash table, offsets from the start of the block plus one */
+
+static uint32_t g_lz4_hashtab[LZ4_HSIZE];
+
 /* Type of the callback from traverse_directory() */
 
 typedef int (*traversal_callback_t)(const char *dirpath, const char *name,
@@ -219,6 +236,12 @@ static char *g_progname;       /* Name of this program */
 static char *g_dirname;        /* Source directory path */
 static char *g_outname;        /* Output file path */
 
+static bool g_lz4;             /* Compress with LZ4 instead of LZF */
+
+/* Uncompressed size of a data block */
+
+static unsigned int g_blocksize = CROMFS_BLOCKSIZE;
+
 static FILE *g_outstream;      /* Main output stream */
 static FILE *g_tmpstream;      /* Temporary file output stream */
 
@@ -273,6 +296,12 @@ static void dump_hexbuffer(FILE *stream, const void *buffer,
 static void dump_nextline(FILE *stream);
 static size_t lzf_compress(const uint8_t *inbuffer, unsigned int inlen,
                            union lzf_result_u *result);
+static inline uint32_t get_uint32(const uint8_t *ptr);
+static bool lz4_sequence(uint8_t **outptr, const uint8_t *outend,
+                         const uint8_t *literals, size_t litlen,
+                         unsigned int offset, size_t matchlen);
+static size_t lz4_compress(const uint8_t *inbuffer, unsigned int inlen,
+                           union lzf_result_u *result);
 static uint16_t get_mode(mode_t mode);
 #ifdef HOST_TGTSWAP
 static inline uint16_t tgt_uint16(uint16_t a);
@@ -301,7 +330,15 @@ static int  traverse_directory(const char *dirpath,
 
 static void show_usage(void)
 {
-  fprintf(stderr, "USAGE: %s <dir-path> <out-file>\n", g_progname);
+  fprintf(stderr, "USAGE: %s [-z lzf|lz4] [-b <block-size>] "
+          "<dir-path> <out-file>\n", g_progname);
+  fprintf(stderr, "\nWhere:\n");
+  fprintf(stderr, "  -z selects the compression (default lzf).  "
+          "LZ4 needs\n");
+  fprintf(stderr, "     CONFIG_FS_CROMFS_LZ4 in the target.\n");
+  fprintf(stderr, "  -b is the uncompressed size of a data block, %d..%d\n",
+          CROMFS_BLOCKSIZE, CROMFS_MAX_BLOCKSIZE);
+  fprintf(stderr, "     (default %d).\n", CROMFS_BLOCKSIZE);
   exit(1);
 }
 
@@ -528,7 +565,7 @@ static size_t lzf_compress(const uint8_t *inbuffer, unsigned int inlen,
   const uint8_t *inptr  = inbuffer;
         uint8_t *outptr = result->compressed.lzf_buffer;
   const uint8_t *inend  = inptr + inlen;
-        uint8_t *outend = outptr + LZF_BUFSIZE;
+        uint8_t *outend = outptr + inlen;
   const uint8_t *ref;
   uintptr_t off;
   ssize_t cs;
@@ -808,6 +845,179 @@ genhdr:
   return retlen;
 }
 
+static inline uint32_t get_uint32(const uint8_t *ptr)
+{
+  return (uint32_t)ptr[0] | (uint32_t)ptr[1] << 8 |
+         (uint32_t)ptr[2] << 16 | (uint32_t)ptr[3] << 24;
+}
+
+static bool lz4_sequence(uint8_t **outptr, const uint8_t *outend,
+                         const uint8_t *literals, size_t litlen,
+                         unsigned int offset, size_t matchlen)
+{
+  uint8_t *op = *outptr;
+  uint8_t *token;
+  size_t len;
+
+  /* Worst case: token, literal run, offset and the length extensions */
+
+  if ((size_t)(outend - op) < 1 + litlen + litlen / 255 + 1 + 2 +
+                              matchlen / 255 + 1)
+    {
+      return false;
+    }
+
+  token = op++;
+  if (litlen >= 15)
+    {
+      *token = 15 << 4;
+      for (len = litlen - 15; len >= 255; len -= 255)
+        {
+          *op++ = 255;
+        }
+
+      *op++ = len;
+    }
+  else
+    {
+      *token = litlen << 4;
+    }
+
+  memcpy(op, literals, litlen);
+  op += litlen;
+
+  /* A sequence without a match ends the block */
+
+  if (matchlen > 0)
+    {
+      *op++ = offset & 0xff;
+      *op++ = offset >> 8;
+
+      len = matchlen - LZ4_MIN_MATCH;
+      if (len >= 15)
+        {
+          *token |= 15;
+          for (len -= 15; len >= 255; len -= 255)
+            {
+              *op++ = 255;
+            }
+
+          *op++ = len;
+        }
+      else
+        {
+          *token |= len;
+        }
+    }
+
+  *outptr = op;
+  return true;
+}
+
+static size_t lz4_compress(const uint8_t *inbuffer, unsigned int inlen,
+                           union lzf_result_u *result)
+{
+  const uint8_t *inptr  = inbuffer;
+  const uint8_t *anchor = inbuffer;
+  const uint8_t *inend  = inbuffer + inlen;
+        uint8_t *outptr = result->compressed.lzf_buffer;
+        uint8_t *outend = outptr + inlen;
+  const uint8_t *ref;
+  unsigned int hval;
+  size_t matchlen;
+  size_t retlen;
+  ssize_t cs;
+
+  /* Greedy match search: the encoder only has to produce a valid block,
+   * the target decoder is the same for any encoder.
+   */
+
+  memset(g_lz4_hashtab, 0, sizeof(g_lz4_hashtab));
+
+  if (inlen >= LZ4_MF_LIMIT)
+    {
+      while (inptr <= inend - LZ4_MF_LIMIT)
+        {
+          hval = LZ4_HASH(inptr);
+          ref  = g_lz4_hashtab[hval] > 0 ?
+                 inbuffer + g_lz4_hashtab[hval] - 1 : NULL;
+          g_lz4_hashtab[hval] = inptr - inbuffer + 1;
+
+          if (ref == NULL || inptr - ref > LZ4_MAX_DISTANCE ||
+              memcmp(ref, inptr, LZ4_MIN_MATCH) != 0)
+            {
+              inptr++;
+              continue;
+            }
+
+          /* The match must end before the last literals */
+
+          matchlen = LZ4_MIN_MATCH;
+          while (inptr + matchlen < inend - LZ4_LAST_LITERALS &&
+                 ref[matchlen] == inptr[matchlen])
+            {
+              matchlen++;
+            }
+
+          if (!lz4_sequence(&outptr, outend, anchor, inptr - anchor,
+                            inptr - ref, matchlen))
+            {
+              cs = 0;
+              goto genhdr;
+            }
+
+          inptr += matchlen;
+          anchor = inptr;
+        }
+    }
+
+  /* The remaining bytes are the literals of the last sequence */
+
+  if (!lz4_sequence(&outptr, outend, anchor, inend - anchor, 0, 0))
+    {
+      cs = 0;
+      goto genhdr;
+    }
+
+  cs = outptr - (uint8_t *)result->compressed.lzf_buffer;
+  if (cs >= inlen)
+    {
+      cs = 0;
+    }
+
+genhdr:
+  if (cs > 0)
+    {
+      /* Write compressed header */
+
+      result->compressed.lzf_magic[0]   = 'Z';
+      result->compressed.lzf_magic[1]   = 'V';
+      result->compressed.lzf_type       = LZ4_TYPE2_HDR;
+      result->compressed.lzf_clen[0]    = cs >> 8;
+      result->compressed.lzf_clen[1]    = cs & 0xff;
+      result->compressed.lzf_ulen[0]    = inlen >> 8;
+      result->compressed.lzf_ulen[1]    = inlen & 0xff;
+      retlen                            = cs + LZ4_TYPE2_HDR_SIZE;
+    }
+  else
+    {
+      /* Write uncompressed header */
+
+      result->uncompressed.lzf_magic[0] = 'Z';
+      result->uncompressed.lzf_magic[1] = 'V';
+      result->uncompressed.lzf_type     = LZF_TYPE0_HDR;
+      result->uncompressed.lzf_len[0]   = inlen >> 8;
+      result->uncompressed.lzf_len[1]   = inlen & 0xff;
+
+      /* Copy uncompressed data into the result buffer */
+
+      memcpy(result->uncompressed.lzf_buffer, inbuffer, inlen);
+      retlen                            = inlen + LZF_TYPE0_HDR_SIZE;
+    }
+
+  return retlen;
+}
+
 static uint16_t get_mode(mode_t mode)
 {
   uint16_t ret = 0;
@@ -987,12 +1197,12 @@ static void gen_file(const char *path, const char *name, mode_t mode,
                      bool lastentry)
 {
   struct cromfs_node_s node;
-  union lzf_result_u result;
+  static union lzf_result_u result;
+  static uint8_t iobuffer[CROMFS_MAX_BLOCKSIZE];
   uint32_t nodeoffs = g_offset;
   FILE *save_tmpstream = g_tmpstream;
   FILE *outstream;
   FILE *instream;
-  uint8_t iobuffer[LZF_BUFSIZE];
   size_t nread;
   size_t ntotal;
   size_t blklen;
@@ -1030,14 +1240,22 @@ static void gen_file(const char *path, const char *name, mode_t mode,
     {
       /* Read the next chunk from the file */
 
-      nread = fread(iobuffer, 1, LZF_BUFSIZE, instream);
+      nread = fread(iobuffer, 1, g_blocksize, instream);
       if (nread > 0)
         {
           uint16_t clen;
 
           /* Compress the chunk */
 
-          blklen = lzf_compress(iobuffer, nread, &result);
+          if (g_lz4)
+            {
+              blklen = lz4_compress(iobuffer, nread, &result);
+            }
+          else
+            {
+              blklen = lzf_compress(iobuffer, nread, &result);
+            }
+
           if (result.cmn.lzf_type == LZF_TYPE0_HDR)
             {
               clen = nread;
@@ -1250,22 +1468,60 @@ static int traverse_directory(const char *dirpath,
 int main(int argc, char **argv, char **envp)
 {
   struct cromfs_volume_s vol;
+  char *endptr;
   char *ptr;
   int result;
+  int option;
 
   /* Verify arguments */
 
   ptr = strrchr(argv[0], '/');
   g_progname = ptr == NULL ? argv[0] : ptr + 1;
 
-  if (argc != 3)
+  while ((option = getopt(argc, argv, "b:z:h")) > 0)
+    {
+      switch (option)
+        {
+          case 'b':
+            g_blocksize = strtoul(optarg, &endptr, 0);
+            if (*endptr != '\0' || g_blocksize < CROMFS_BLOCKSIZE ||
+                g_blocksize > CROMFS_MAX_BLOCKSIZE)
+              {
+                fprintf(stderr, "Invalid block size: %s\n", optarg);
+                show_usage();
+              }
+            break;
+
+          case 'z':
+            if (strcmp(optarg, "lz4") == 0)
+              {
+                g_lz4 = true;
+              }
+            else if (strcmp(optarg, "lzf") == 0)
+              {
+                g_lz4 = false;
+              }
+            else
+              {
+                fprintf(stderr, "Unknown compression: %s\n", optarg);
+                show_usage();
+              }
+            break;
+
+          case 'h':
+          default:
+            show_usage();
+        }
+    }
+
+  if (argc - optind != 2)
     {
       fprintf(stderr, "Unexpected number of arguments\n");
       show_usage();
     }
 
-  g_dirname  = argv[1];
-  g_outname  = argv[2];
+  g_dirname  = argv[optind];
+  g_outname  = argv[optind + 1];
 
   verify_directory();
   verify_outfile();
@@ -1319,7 +1575,7 @@ int main(int argc, char **argv, char **envp)
   vol.cv_nblocks  = TGT_UINT16(g_nblocks);
   vol.cv_root     = TGT_UINT32(sizeof(struct cromfs_volume_s));
   vol.cv_fsize    = TGT_UINT32(g_offset);
-  vol.cv_bsize    = TGT_UINT32(CROMFS_BLOCKSIZE);
+  vol.cv_bsize    = TGT_UINT32(g_blocksize);
 
   dump_hexbuffer(g_outstream, &vol, sizeof(struct cromfs_volume_s));
   dump_nextline(g_outstream);
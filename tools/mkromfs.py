@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+############################################################################
+# tools/mkromfs.py
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+############################################################################
+
+# Generate a ROMFS image with the entries of every directory sorted by name,
+# as expected by CONFIG_FS_ROMFS_SORTED_DIRS.  The image layout is the one
+# produced by genromfs: "." and ".." start each directory, the root "." is
+# the root directory header and all other "." and ".." are hard links.
+
+import argparse
+import os
+import stat
+import struct
+import sys
+
+ROMFS_ALIGN = 16
+
+RFNEXT_HARDLINK = 0
+RFNEXT_DIRECTORY = 1
+RFNEXT_FILE = 2
+RFNEXT_EXEC = 8
+
+
+def align(value, alignment=ROMFS_ALIGN):
+    return (value + alignment - 1) & ~(alignment - 1)
+
+
+def padded_name(name):
+    name = name.encode() + b"\0"
+    return name + b"\0" * (align(len(name)) - len(name))
+
+
+def checksum(data):
+    words = struct.unpack(">%dI" % (len(data) // 4), data)
+    return (-sum(words)) & 0xFFFFFFFF
+
+
+class Node(object):
+    def __init__(self, name, path, mode, parent=None):
+        self.name = name
+        self.path = path
+        self.mode = mode
+        self.parent = parent
+        self.children = []
+        self.offset = 0
+        self.data = b""
+
+    def header_size(self):
+        return 16 + len(padded_name(self.name))
+
+
+class RomfsImage(object):
+    def __init__(self, volname, dataalign):
+        self.volname = volname
+        self.dataalign = dataalign
+        self.image = bytearray()
+
+    def scan(self, path, name=".", parent=None):
+        st = os.lstat(path)
+        node = Node(name, path, st.st_mode, parent)
+        if stat.S_ISDIR(st.st_mode):
+            dot = Node(".", path, 0, node)
+            dotdot = Node("..", path, 0, node)
+            node.children = [dot, dotdot]
+
+            # Byte order is the order that romfs_nodeinfo_search() and the
+            # sorted directory scan compare names in.
+
+            entries = sorted(os.listdir(path), key=lambda n: n.encode())
+            for entry in entries:
+                child = os.path.join(path, entry)
+                if os.path.islink(child):
+                    print("Skipping symbolic link %s" % child, file=sys.stderr)
+                    continue
+
+                node.children.append(self.scan(child, entry, node))
+
+        elif stat.S_ISREG(st.st_mode):
+            with open(path, "rb") as fp:
+                node.data = fp.read()
+
+        return node
+
+    def place_dir(self, node, offset):
+        # The root directory has no header of its own, its "." stands in
+        # for it.  A subdirectory header is placed by its parent, and its
+        # entries follow the entries of the parent.
+
+        dot, dotdot = node.children[0], node.children[1]
+        dot.offset = offset
+        offset += dot.header_size()
+        dotdot.offset = offset
+        offset += dotdot.header_size()
+        for child in node.children[2:]:
+            if self.dataalign > ROMFS_ALIGN and stat.S_ISREG(child.mode):
+                start = align(offset + child.header_size(), self.dataalign)
+                offset = start - child.header_size()
+
+            child.offset = offset
+            offset += child.header_size() + align(len(child.data))
+
+        for child in node.children[2:]:
+            if stat.S_ISDIR(child.mode):
+                offset = self.place_dir(child, offset)
+
+        return offset
+
+    def header(self, node, nexthdr, kind, info, size):
+        hdr = struct.pack(">IIII", nexthdr | kind, info, size, 0)
+        hdr += padded_name(node.name)
+        csum = checksum(hdr)
+        return hdr[:12] + struct.pack(">I", csum) + hdr[16:]
+
+    def emit_dir(self, node, root):
+        children = node.children
+        for i, child in enumerate(children):
+            nexthdr = children[i + 1].offset if i + 1 < len(children) else 0
+            if child.name == "." and root:
+                kind, info, size = RFNEXT_DIRECTORY, child.offset, 0
+            elif child.name == ".":
+                kind, info, size = RFNEXT_HARDLINK, node.offset, 0
+            elif child.name == "..":
+                parent = node.parent if node.parent else node
+                if parent.parent is None:
+                    target = parent.children[0].offset
+                else:
+                    target = parent.offset
+
+                kind, info, size = RFNEXT_HARDLINK, target, 0
+            elif stat.S_ISDIR(child.mode):
+                kind, info, size = RFNEXT_DIRECTORY, child.children[0].offset, 0
+            else:
+                kind = RFNEXT_FILE
+                if child.mode & stat.S_IXUSR:
+                    kind |= RFNEXT_EXEC
+
+                info, size = 0, len(child.data)
+
+            hdr = self.header(child, nexthdr, kind, info, size)
+            self.write(child.offset, hdr + child.data)
+
+        for child in children[2:]:
+            if stat.S_ISDIR(child.mode):
+                self.emit_dir(child, False)
+
+    def write(self, offset, data):
+        if len(self.image) < offset + len(data):
+            self.image.extend(b"\0" * (offset + len(data) - len(self.image)))
+
+        self.image[offset : offset + len(data)] = data
+
+    def build(self, rootdir):
+        root = self.scan(rootdir)
+        volhdr = 16 + len(padded_name(self.volname))
+        end = self.place_dir(root, volhdr)
+        self.emit_dir(root, True)
+
+        # genromfs pads the image to 1 KiB
+
+        size = align(end, 1024)
+        self.write(size - 1, b"\0")
+        self.write(0, b"-rom1fs-" + struct.pack(">II", size, 0))
+        self.write(16, padded_name(self.volname))
+
+        span = min(512, size)
+        csum = checksum(bytes(self.image[:span]))
+        self.write(12, struct.pack(">I", csum))
+        return bytes(self.image)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Generate a ROMFS image with sorted directories"
+    )
+    parser.add_argument("-d", "--dir", required=True, help="source directory")
+    parser.add_argument("-f", "--file", required=True, help="output image")
+    parser.add_argument("-V", "--volume", default="NuttX", help="volume name")
+    parser.add_argument(
+        "-a",
+        "--align",
+        type=int,
+        default=ROMFS_ALIGN,
+        help="alignment of file data, a power of two (for XIP use)",
+    )
+    args = parser.parse_args()
+
+    if args.align < ROMFS_ALIGN or args.align & (args.align - 1):
+        parser.error("alignment must be a power of two >= 16")
+
+    image = RomfsImage(args.volume, args.align).build(args.dir)
+    with open(args.file, "wb") as fp:
+        fp.write(image)
+
+
+if __name__ == "__main__":
+    main()
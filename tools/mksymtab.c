@@ -23,6 +23,7 @@
  ****************************************************************************/
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -43,12 +44,23 @@
  * Private Types
  ****************************************************************************/
 
+/* One symbol of a hashed symbol table */
+
+struct hashsym_s
+{
+  char *name;
+  char *cond;
+  uint32_t hash;
+  int index;
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 static const char *g_hdrfiles[MAX_HEADER_FILES];
 static int nhdrfiles;
+static uint32_t g_nbuckets;
 
 /****************************************************************************
  * Private Functions
@@ -59,7 +71,8 @@ static void show_usage(const char *progname)
   fprintf(stderr,
     "USAGE:\n");
   fprintf(stderr,
-    "%s [-d] <cvs-file> <symtab-file> [<symtab-name> [<nsymbols-name>]]\n\n",
+    "%s [-d] [-h] <cvs-file> <symtab-file> [<symtab-name> "
+    "[<nsymbols-name>]]\n\n",
     progname);
   fprintf(stderr,
     "Where:\n\n");
@@ -79,6 +92,10 @@ static void show_usage(const char *progname)
     "                   Default: \"%s\"\n", NSYMBOLS_NAME);
   fprintf(stderr,
     "  -d              : Enable debug output\n");
+  fprintf(stderr,
+    "  -h              : Order the table by hash and also generate its\n");
+  fprintf(stderr,
+    "                    hash index <symtab-name>_hash\n");
   exit(EXIT_FAILURE);
 }
 
@@ -116,6 +133,155 @@ static void add_hdrfile(const char *hdrfile)
     }
 }
 
+/* The GNU ELF hash function.  This must match symtab_hash(). */
+
+static uint32_t symbol_hash(const char *name)
+{
+  uint32_t hash = 5381;
+
+  for (; *name != '\0'; name++)
+    {
+      hash = (hash << 5) + hash + (uint8_t)*name;
+    }
+
+  return hash;
+}
+
+/* Order symbols by hash bucket, keeping the input order within a bucket */
+
+static int compare_bucket(const void *arg1, const void *arg2)
+{
+  const struct hashsym_s *sym1 = arg1;
+  const struct hashsym_s *sym2 = arg2;
+  uint32_t bucket1 = sym1->hash % g_nbuckets;
+  uint32_t bucket2 = sym2->hash % g_nbuckets;
+
+  if (bucket1 != bucket2)
+    {
+      return bucket1 < bucket2 ? -1 : 1;
+    }
+
+  return sym1->index - sym2->index;
+}
+
+/* Output the symbol table ordered by hash bucket followed by its hash
+ * index.  A symbol whose condition is false is replaced by an entry with
+ * an empty name so that the index stays valid in every configuration.
+ */
+
+static void output_hashed(FILE *instream, FILE *outstream,
+                          const char *symtab, const char *nsymbols)
+{
+  struct hashsym_s *syms = NULL;
+  uint32_t bucket;
+  char *ptr;
+  int nsyms = 0;
+  int i;
+  int j;
+
+  /* Read all of the symbols */
+
+  while ((ptr = read_line(instream)) != NULL)
+    {
+      int nargs = parse_csvline(ptr);
+      if (nargs < PARM1_INDEX)
+        {
+          fprintf(stderr, "Only %d arguments found: %s\n", nargs, g_line);
+          exit(EXIT_FAILURE);
+        }
+
+      syms = realloc(syms, sizeof(struct hashsym_s) * (nsyms + 1));
+      if (syms == NULL)
+        {
+          fprintf(stderr, "ERROR: Out of memory\n");
+          exit(EXIT_FAILURE);
+        }
+
+      syms[nsyms].name  = strdup(g_parm[NAME_INDEX]);
+      syms[nsyms].cond  = strdup(g_parm[COND_INDEX]);
+      syms[nsyms].hash  = symbol_hash(g_parm[NAME_INDEX]);
+      syms[nsyms].index = nsyms;
+      nsyms++;
+    }
+
+  /* Two symbols per bucket on average, as the GNU linker does */
+
+  g_nbuckets = nsyms / 2 + 1;
+  if (nsyms > 0)
+    {
+      qsort(syms, nsyms, sizeof(struct hashsym_s), compare_bucket);
+    }
+
+  /* The symbol table itself */
+
+  fprintf(outstream, "\nconst struct symtab_s %s[] =\n", symtab);
+  fprintf(outstream, "{\n");
+
+  for (i = 0; i < nsyms; i++)
+    {
+      if (strlen(syms[i].cond) > 0)
+        {
+          fprintf(outstream, "#if %s\n", syms[i].cond);
+          fprintf(outstream, "  { \"%s\", (FAR const void *)%s },\n",
+                  syms[i].name, syms[i].name);
+          fprintf(outstream, "#else\n");
+          fprintf(outstream, "  { \"\", NULL },\n");
+          fprintf(outstream, "#endif\n");
+        }
+      else
+        {
+          fprintf(outstream, "  { \"%s\", (FAR const void *)%s },\n",
+                  syms[i].name, syms[i].name);
+        }
+    }
+
+  fprintf(outstream, "};\n\n");
+  fprintf(outstream, "int %s = %d;\n\n", nsymbols, nsyms);
+
+  /* The start of each bucket */
+
+  fprintf(outstream, "static const uint32_t %s_buckets[] =\n{\n", symtab);
+  for (bucket = 0, j = 0; bucket <= g_nbuckets; bucket++)
+    {
+      while (j < nsyms && syms[j].hash % g_nbuckets < bucket)
+        {
+          j++;
+        }
+
+      fprintf(outstream, "  %d,\n", j);
+    }
+
+  fprintf(outstream, "};\n\n");
+
+  /* The hash of each symbol */
+
+  fprintf(outstream, "static const uint32_t %s_hashes[] =\n{\n", symtab);
+  for (i = 0; i < nsyms; i++)
+    {
+      fprintf(outstream, "  0x%08lx,\n", (unsigned long)syms[i].hash);
+    }
+
+  if (nsyms == 0)
+    {
+      fprintf(outstream, "  0\n");
+    }
+
+  fprintf(outstream, "};\n\n");
+
+  fprintf(outstream, "const struct symtab_hash_s %s_hash =\n{\n", symtab);
+  fprintf(outstream, "  %lu, %s_buckets, %s_hashes\n",
+          (unsigned long)g_nbuckets, symtab, symtab);
+  fprintf(outstream, "};\n");
+
+  for (i = 0; i < nsyms; i++)
+    {
+      free(syms[i].name);
+      free(syms[i].cond);
+    }
+
+  free(syms);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -130,6 +296,7 @@ int main(int argc, char **argv, char **envp)
   char *finalterm;
   char *ptr;
   bool cond;
+  bool hashed;
   FILE *instream;
   FILE *outstream;
   int ch;
@@ -140,8 +307,9 @@ int main(int argc, char **argv, char **envp)
   symtab   = SYMTAB_NAME;
   nsymbols = NSYMBOLS_NAME;
   g_debug  = false;
+  hashed   = false;
 
-  while ((ch = getopt(argc, argv, ":d")) > 0)
+  while ((ch = getopt(argc, argv, ":dh")) > 0)
     {
       switch (ch)
         {
@@ -149,6 +317,10 @@ int main(int argc, char **argv, char **envp)
             g_debug = true;
             break;
 
+          case 'h' :
+            hashed = true;
+            break;
+
           case '?' :
             fprintf(stderr, "Unrecognized option: %c\n", optopt);
             show_usage(argv[0]);
@@ -254,6 +426,16 @@ int main(int argc, char **argv, char **envp)
       fprintf(outstream, "#include <%s>\n", g_hdrfiles[i]);
     }
 
+  /* A hashed table is output separately */
+
+  if (hashed)
+    {
+      output_hashed(instream, outstream, symtab, nsymbols);
+      fclose(instream);
+      fclose(outstream);
+      return EXIT_SUCCESS;
+    }
+
   /* Now the symbol table itself */
 
   fprintf(outstream, "\nconst struct symtab_s %s[] =\n", symtab);
@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+# tools/profile.py
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+import argparse
+import bisect
+import re
+import subprocess
+from collections import Counter
+
+program_description = """
+This program symbolizes a copy of /proc/profile (CONFIG_SCHED_PROFILE)
+with the symbols of the nuttx ELF file.  It prints the hottest functions
+and, with --folded, the recent samples as folded stacks that flamegraph.pl
+accepts.  With CONFIG_SCHED_PERFCOUNT, --weight charges each recent sample
+with the hardware events counted since the previous one instead.
+"""
+
+# The order of the e= field of the samples, see PERFCOUNT_* in
+# include/nuttx/perfcount.h
+
+EVENTS = ["cycles", "instructions", "cache-misses", "branch-misses"]
+
+
+class symbols:
+    def __init__(self, elffile, prefix):
+        out = subprocess.run(
+            [prefix + "nm", "-n", "-C", elffile],
+            check=True,
+            capture_output=True,
+            text=True,
+        ).stdout
+        self.addrs = []
+        self.names = []
+        for line in out.splitlines():
+            fields = line.split(" ", 2)
+            if len(fields) == 3 and fields[0] and fields[1] in ("t", "T", "w", "W"):
+                self.addrs.append(int(fields[0], 16))
+                self.names.append(fields[2])
+
+    def lookup(self, addr):
+        # Thumb code addresses have the low bit set
+
+        index = bisect.bisect_right(self.addrs, addr & ~1) - 1
+        if index < 0:
+            return "0x%x" % addr
+        return self.names[index]
+
+
+def parse_profile(filename):
+    hot = Counter()
+    samples = []
+    total = 0
+    section = "hot"
+
+    with open(filename, "r") as f:
+        for line in f:
+            fields = line.split()
+            if not fields:
+                continue
+            if fields[0] == "Total:":
+                total = int(fields[1])
+                section = "samples"
+                continue
+            if fields[0] in ("COUNT", "CPU"):
+                continue
+            if section == "hot":
+                hot[int(fields[1], 16)] += int(fields[0])
+            else:
+                addrs = [int(a, 16) for a in fields[2:] if re.match("0x", a)]
+                events = [0] * len(EVENTS)
+                if fields[-1].startswith("e="):
+                    events = [int(e) for e in fields[-1][2:].split(",")]
+                samples.append((addrs, events))
+
+    return hot, samples, total
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=program_description, formatter_class=argparse.RawTextHelpFormatter
+    )
+    parser.add_argument("-e", "--elffile", help="the nuttx ELF file", required=True)
+    parser.add_argument("-p", "--prefix", help="toolchain prefix", default="")
+    parser.add_argument("-n", "--top", help="functions to print", type=int, default=30)
+    parser.add_argument(
+        "--folded", action="store_true", help="print the samples as folded stacks"
+    )
+    parser.add_argument(
+        "-w",
+        "--weight",
+        choices=["samples"] + EVENTS,
+        default="samples",
+        help="weight the recent samples with a hardware event",
+    )
+    parser.add_argument("profile", help="a copy of /proc/profile")
+    args = parser.parse_args()
+
+    syms = symbols(args.elffile, args.prefix)
+    hot, samples, total = parse_profile(args.profile)
+
+    def weight(events):
+        if args.weight == "samples":
+            return 1
+        return events[EVENTS.index(args.weight)]
+
+    if args.folded:
+        stacks = Counter()
+        for addrs, events in samples:
+            frames = [syms.lookup(a) for a in addrs]
+            stacks[";".join(reversed(frames))] += weight(events)
+        for stack, count in stacks.items():
+            print("%s %d" % (stack, count))
+        return
+
+    functions = Counter()
+    if args.weight == "samples":
+        for pc, count in hot.items():
+            functions[syms.lookup(pc)] += count
+        counted = sum(functions.values())
+        print("%d samples, %d outside the table" % (total, total - counted))
+    else:
+        for addrs, events in samples:
+            if addrs:
+                functions[syms.lookup(addrs[0])] += weight(events)
+        total = sum(functions.values())
+        print("%d %s in %d recent samples" % (total, args.weight, len(samples)))
+
+    for name, count in functions.most_common(args.top):
+        print("%10d %6.2f%% %s" % (count, 100.0 * count / max(total, 1), name))
+
+
+if __name__ == "__main__":
+    main()
@@ -462,27 +462,7 @@ void bt_buf_release(FAR struct bt_buf_s *buf)
 #ifdef CONFIG_WIRELESS_BLUETOOTH_HOST
   if (type == BT_ACL_IN)
     {
-      FAR struct bt_hci_cp_host_num_completed_packets_s *cp;
-      FAR struct bt_hci_handle_count_s *hc;
-
-      wlinfo("Reporting completed packet for handle %u\n", handle);
-
-      buf = bt_hci_cmd_create(BT_HCI_OP_HOST_NUM_COMPLETED_PACKETS,
-                              sizeof(*cp) + sizeof(*hc));
-      if (buf == NULL)
-        {
-          wlerr("ERROR: Unable to allocate new HCI command\n");
-          return;
-        }
-
-      cp              = bt_buf_extend(buf, sizeof(*cp));
-      cp->num_handles = BT_HOST2LE16(1);
-
-      hc              = bt_buf_extend(buf, sizeof(*hc));
-      hc->handle      = BT_HOST2LE16(handle);
-      hc->count       = BT_HOST2LE16(1);
-
-      bt_hci_cmd_send(BT_HCI_OP_HOST_NUM_COMPLETED_PACKETS, buf);
+      bt_hci_acl_completed(handle);
     }
 #endif
 }
@@ -114,6 +114,16 @@ static FAR struct bt_bufferlist_s g_hp_rxlist;
 static struct work_s g_lp_work;
 static struct work_s g_hp_work;
 
+#ifdef CONFIG_WIRELESS_BLUETOOTH_HOST
+/* The ACL buffers released since the controller was last told, per
+ * connection handle.  They are reported in one Host Number Of Completed
+ * Packets command rather than one command per buffer.
+ */
+
+static struct bt_hci_handle_count_s g_credits[CONFIG_BLUETOOTH_MAX_CONN];
+static struct work_s g_credit_work;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -230,6 +240,111 @@ static void bt_disconnected(FAR struct bt_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: hci_send_credits
+ *
+ * Description:
+ *   Return the released ACL buffers to the controller.
+ *
+ * Input Parameters:
+ *   credits - The buffer count per connection handle, in host order
+ *   nhandles - The number of entries in 'credits'
+ *
+ ****************************************************************************/
+
+static void hci_send_credits(FAR const struct bt_hci_handle_count_s *credits,
+                             int nhandles)
+{
+  FAR struct bt_hci_cp_host_num_completed_packets_s *cp;
+  FAR struct bt_hci_handle_count_s *hc;
+  FAR struct bt_buf_s *buf;
+  int i;
+
+  buf = bt_hci_cmd_create(BT_HCI_OP_HOST_NUM_COMPLETED_PACKETS,
+                          sizeof(*cp) + nhandles * sizeof(*hc));
+  if (buf == NULL)
+    {
+      wlerr("ERROR: Unable to allocate new HCI command\n");
+      return;
+    }
+
+  cp              = bt_buf_extend(buf, sizeof(*cp));
+  cp->num_handles = nhandles;
+
+  for (i = 0; i < nhandles; i++)
+    {
+      wlinfo("Reporting %u completed packets for handle %u\n",
+             credits[i].count, credits[i].handle);
+
+      hc         = bt_buf_extend(buf, sizeof(*hc));
+      hc->handle = BT_HOST2LE16(credits[i].handle);
+      hc->count  = BT_HOST2LE16(credits[i].count);
+    }
+
+  bt_hci_cmd_send(BT_HCI_OP_HOST_NUM_COMPLETED_PACKETS, buf);
+}
+
+/****************************************************************************
+ * Name: hci_credit_work
+ *
+ * Description:
+ *   Report the ACL buffers released since the last report.  This runs on
+ *   the low priority work queue behind hci_rx_work(), so that the buffers
+ *   of a whole batch of received packets are reported at once.
+ *
+ ****************************************************************************/
+
+static void hci_credit_work(FAR void *arg)
+{
+  struct bt_hci_handle_count_s credits[CONFIG_BLUETOOTH_MAX_CONN];
+  irqstate_t flags;
+  int nhandles = 0;
+  int i;
+
+  flags = spin_lock_irqsave(NULL);
+  for (i = 0; i < CONFIG_BLUETOOTH_MAX_CONN; i++)
+    {
+      if (g_credits[i].count > 0)
+        {
+          credits[nhandles++] = g_credits[i];
+          g_credits[i].count  = 0;
+        }
+    }
+
+  spin_unlock_irqrestore(NULL, flags);
+
+  if (nhandles > 0)
+    {
+      hci_send_credits(credits, nhandles);
+    }
+}
+
+/****************************************************************************
+ * Name: hci_drop_credits
+ *
+ * Description:
+ *   Forget the credits of a disconnected handle.  The controller reclaims
+ *   its buffers when the link is lost.
+ *
+ ****************************************************************************/
+
+static void hci_drop_credits(uint16_t handle)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = spin_lock_irqsave(NULL);
+  for (i = 0; i < CONFIG_BLUETOOTH_MAX_CONN; i++)
+    {
+      if (g_credits[i].handle == handle)
+        {
+          g_credits[i].count = 0;
+        }
+    }
+
+  spin_unlock_irqrestore(NULL, flags);
+}
+
 static void hci_acl(FAR struct bt_buf_s *buf)
 {
   FAR struct bt_hci_acl_hdr_s *hdr = (FAR void *)buf->data;
@@ -645,6 +760,8 @@ static void hci_disconn_complete(FAR struct bt_buf_s *buf)
       return;
     }
 
+  hci_drop_credits(handle);
+
   conn = bt_conn_lookup_handle(handle);
   if (!conn)
     {
@@ -677,6 +794,64 @@ static void hci_disconn_complete(FAR struct bt_buf_s *buf)
     }
 }
 
+/****************************************************************************
+ * Name: le_conn_tune
+ *
+ * Description:
+ *   Ask the controller to use the largest data channel PDUs and the 2M PHY
+ *   on a new connection, when it supports them.  The peer may refuse
+ *   either; the connection then keeps working as before.
+ *
+ ****************************************************************************/
+
+static void le_conn_tune(uint16_t handle)
+{
+#ifdef CONFIG_BLUETOOTH_LE_DATA_LEN
+  if ((g_btdev.le_features[0] & BT_HCI_LE_DATA_LEN_EXT) != 0)
+    {
+      FAR struct bt_hci_cp_le_set_data_len_s *cp;
+      FAR struct bt_buf_s *buf;
+
+      buf = bt_hci_cmd_create(BT_HCI_OP_LE_SET_DATA_LEN, sizeof(*cp));
+      if (buf != NULL)
+        {
+          cp            = bt_buf_extend(buf, sizeof(*cp));
+          cp->handle    = BT_HOST2LE16(handle);
+          cp->tx_octets = BT_HOST2LE16(BT_HCI_LE_MAX_TX_OCTETS);
+          cp->tx_time   = BT_HOST2LE16(BT_HCI_LE_MAX_TX_TIME);
+
+          bt_hci_cmd_send(BT_HCI_OP_LE_SET_DATA_LEN, buf);
+        }
+    }
+#endif
+
+#ifdef CONFIG_BLUETOOTH_LE_2M_PHY
+  if ((g_btdev.le_features[1] & BT_HCI_LE_2M_PHY) != 0)
+    {
+      FAR struct bt_hci_cp_le_set_phy_s *cp;
+      FAR struct bt_buf_s *buf;
+
+      buf = bt_hci_cmd_create(BT_HCI_OP_LE_SET_PHY, sizeof(*cp));
+      if (buf != NULL)
+        {
+          cp           = bt_buf_extend(buf, sizeof(*cp));
+          cp->handle   = BT_HOST2LE16(handle);
+          cp->all_phys = 0;
+          cp->tx_phys  = BT_HCI_LE_PHY_2M;
+          cp->rx_phys  = BT_HCI_LE_PHY_2M;
+          cp->phy_opts = 0;
+
+          bt_hci_cmd_send(BT_HCI_OP_LE_SET_PHY, buf);
+        }
+    }
+#endif
+
+#if !defined(CONFIG_BLUETOOTH_LE_DATA_LEN) && \
+    !defined(CONFIG_BLUETOOTH_LE_2M_PHY)
+  UNUSED(handle);
+#endif
+}
+
 static void le_conn_complete(FAR struct bt_buf_s *buf)
 {
   FAR struct bt_hci_evt_le_conn_complete_s *evt = (FAR void *)buf->data;
@@ -737,6 +912,7 @@ static void le_conn_complete(FAR struct bt_buf_s *buf)
 
   bt_conn_set_state(conn, BT_CONN_CONNECTED);
 
+  le_conn_tune(handle);
   bt_l2cap_connected(conn);
 
   if (evt->role == BT_HCI_ROLE_SLAVE)
@@ -1323,6 +1499,52 @@ static int hci_initialize(void)
   le_read_buffer_size_complete(rsp);
   bt_buf_release(rsp);
 
+#ifdef CONFIG_BLUETOOTH_LE_DATA_LEN
+  /* Make the largest data channel PDUs the default for new connections */
+
+  if ((g_btdev.le_features[0] & BT_HCI_LE_DATA_LEN_EXT) != 0)
+    {
+      FAR struct bt_hci_cp_le_write_default_data_len_s *dl;
+
+      buf = bt_hci_cmd_create(BT_HCI_OP_LE_WRITE_DEFAULT_DATA_LEN,
+                              sizeof(*dl));
+      if (buf == NULL)
+        {
+          wlerr("ERROR:  Failed to create buffer\n");
+          return -ENOBUFS;
+        }
+
+      dl                = bt_buf_extend(buf, sizeof(*dl));
+      dl->max_tx_octets = BT_HOST2LE16(BT_HCI_LE_MAX_TX_OCTETS);
+      dl->max_tx_time   = BT_HOST2LE16(BT_HCI_LE_MAX_TX_TIME);
+
+      bt_hci_cmd_send_sync(BT_HCI_OP_LE_WRITE_DEFAULT_DATA_LEN, buf, NULL);
+    }
+#endif
+
+#ifdef CONFIG_BLUETOOTH_LE_2M_PHY
+  /* Prefer the 2M PHY when the controller picks one by itself */
+
+  if ((g_btdev.le_features[1] & BT_HCI_LE_2M_PHY) != 0)
+    {
+      FAR struct bt_hci_cp_le_set_default_phy_s *phy;
+
+      buf = bt_hci_cmd_create(BT_HCI_OP_LE_SET_DEFAULT_PHY, sizeof(*phy));
+      if (buf == NULL)
+        {
+          wlerr("ERROR:  Failed to create buffer\n");
+          return -ENOBUFS;
+        }
+
+      phy           = bt_buf_extend(buf, sizeof(*phy));
+      phy->all_phys = 0;
+      phy->tx_phys  = BT_HCI_LE_PHY_2M;
+      phy->rx_phys  = BT_HCI_LE_PHY_2M;
+
+      bt_hci_cmd_send_sync(BT_HCI_OP_LE_SET_DEFAULT_PHY, buf, NULL);
+    }
+#endif
+
   buf = bt_hci_cmd_create(BT_HCI_OP_SET_EVENT_MASK, sizeof(*ev));
   if (buf == NULL)
     {
@@ -1693,12 +1915,13 @@ void bt_driver_unregister(FAR struct bt_driver_s *btdev)
 }
 
 /****************************************************************************
- * Name: bt_receive
+ * Name: bt_receive_buf
  *
  * Description:
- *   Called by the Bluetooth low-level driver when new data is received from
- *   the radio.  This may be called from the low-level driver and is part of
- *   the driver interface prototyped in
+ *   Called by the Bluetooth low-level driver when new data has been received
+ *   from the radio into a buffer obtained from bt_buf_alloc().  The stack
+ *   takes over the buffer, so that the data is not copied again.  This is
+ *   part of the driver interface prototyped in
  *   include/nuttx/wireless/bluetooth/bt_driver.h
  *
  *   NOTE:  This function will defer all real work to the low or to the high
@@ -1706,37 +1929,29 @@ void bt_driver_unregister(FAR struct bt_driver_s *btdev)
  *   from interrupt handling logic.
  *
  * Input Parameters:
- *   buf - An instance of the buffer structure providing the received frame.
+ *   btdev - An instance of the low-level driver interface structure.
+ *   buf   - The buffer holding the received HCI packet, without its H4
+ *           header.  It is released by this function in any case.
  *
  * Returned Value:
- *  None
+ *   Zero (OK) on success; a negated errno value on failure.
  *
  ****************************************************************************/
 
-int bt_receive(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
-               FAR void *data, size_t len)
+int bt_receive_buf(FAR struct bt_driver_s *btdev, FAR struct bt_buf_s *buf)
 {
   FAR struct bt_hci_evt_hdr_s *hdr;
-  struct bt_buf_s *buf;
   int ret;
 
-  wlinfo("data %p len %zu\n", data, len);
+  wlinfo("buf %p type %u len %u\n", buf, buf->type, buf->len);
 
   /* Critical command complete/status events use the high priority work
    * queue.
    */
 
-  buf = bt_buf_alloc(type, NULL, BLUETOOTH_H4_HDRLEN);
-  if (buf == NULL)
+  if (buf->type != BT_ACL_IN)
     {
-      return -ENOMEM;
-    }
-
-  memcpy(bt_buf_extend(buf, len), data, len);
-
-  if (type != BT_ACL_IN)
-    {
-      if (type != BT_EVT)
+      if (buf->type != BT_EVT)
         {
           wlerr("ERROR: Invalid buf type %u\n", buf->type);
           bt_buf_release(buf);
@@ -1795,8 +2010,105 @@ int bt_receive(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
   return OK;
 }
 
+/****************************************************************************
+ * Name: bt_receive
+ *
+ * Description:
+ *   Called by the Bluetooth low-level driver when new data is received from
+ *   the radio.  This may be called from the low-level driver and is part of
+ *   the driver interface prototyped in
+ *   include/nuttx/wireless/bluetooth/bt_driver.h
+ *
+ *   The data is copied into a new buffer.  Drivers that can receive into
+ *   a buffer from bt_buf_alloc() should use bt_receive_buf() instead.
+ *
+ * Input Parameters:
+ *   btdev - An instance of the low-level driver interface structure.
+ *   type  - The type of the HCI packet.
+ *   data  - The HCI packet, without its H4 header.
+ *   len   - The length of the HCI packet.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int bt_receive(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
+               FAR void *data, size_t len)
+{
+  FAR struct bt_buf_s *buf;
+
+  wlinfo("data %p len %zu\n", data, len);
+
+  buf = bt_buf_alloc(type, NULL, BLUETOOTH_H4_HDRLEN);
+  if (buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(bt_buf_extend(buf, len), data, len);
+  return bt_receive_buf(btdev, buf);
+}
+
 #ifdef CONFIG_WIRELESS_BLUETOOTH_HOST
 
+/****************************************************************************
+ * Name: bt_hci_acl_completed
+ *
+ * Description:
+ *   Account for a received ACL buffer that the host has released.  The
+ *   buffers released meanwhile are returned to the controller together
+ *   by hci_credit_work().
+ *
+ * Input Parameters:
+ *   handle - The connection handle the buffer was received on
+ *
+ ****************************************************************************/
+
+void bt_hci_acl_completed(uint16_t handle)
+{
+  irqstate_t flags;
+  int slot = -1;
+  int i;
+
+  flags = spin_lock_irqsave(NULL);
+  for (i = 0; i < CONFIG_BLUETOOTH_MAX_CONN; i++)
+    {
+      if (g_credits[i].count > 0 && g_credits[i].handle == handle)
+        {
+          slot = i;
+          break;
+        }
+      else if (g_credits[i].count == 0 && slot < 0)
+        {
+          slot = i;
+        }
+    }
+
+  if (slot >= 0)
+    {
+      g_credits[slot].handle = handle;
+      g_credits[slot].count++;
+    }
+
+  spin_unlock_irqrestore(NULL, flags);
+
+  if (slot < 0)
+    {
+      struct bt_hci_handle_count_s credit;
+
+      /* More handles than connections, report this one by itself */
+
+      credit.handle = handle;
+      credit.count  = 1;
+      hci_send_credits(&credit, 1);
+    }
+  else if (work_available(&g_credit_work))
+    {
+      work_queue(LPWORK, &g_credit_work, hci_credit_work, NULL, 0);
+    }
+}
+
 /****************************************************************************
  * Name: bt_hci_cmd_create
  *
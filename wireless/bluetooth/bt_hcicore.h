@@ -455,6 +455,23 @@ int bt_le_scan_update(void);
  ****************************************************************************/
 
 void bt_conn_cb_register(FAR struct bt_conn_cb_s *cb);
+
+/****************************************************************************
+ * Name: bt_hci_acl_completed
+ *
+ * Description:
+ *   Account for a received ACL buffer released by the host.  The released
+ *   buffers are reported to the controller in batches.
+ *
+ * Input Parameters:
+ *   handle - The connection handle the buffer was received on
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void bt_hci_acl_completed(uint16_t handle);
 #else
 
 /****************************************************************************
@@ -488,4 +505,16 @@ void bt_hci_cb_register(FAR struct bt_hci_cb_s *cb);
 int bt_receive(FAR struct bt_driver_s *btdev, enum bt_buf_type_e type,
                FAR void *data, size_t len);
 
+/****************************************************************************
+ * Name: bt_receive_buf
+ *
+ * Description:
+ *   Called by the Bluetooth low-level driver when new data has been
+ *   received into a buffer from bt_buf_alloc().  The buffer is passed on
+ *   without copying it and is released by the stack.
+ *
+ ****************************************************************************/
+
+int bt_receive_buf(FAR struct bt_driver_s *btdev, FAR struct bt_buf_s *buf);
+
 #endif /* __WIRELESS_BLUETOOTH_BT_HDICORE_H */
@@ -1253,6 +1253,7 @@ int bt_netdev_register(FAR struct bt_driver_s *btdev)
   radio->r_properties = btnet_properties;  /* Return radio properties */
 
   btdev->receive      = bt_receive;
+  btdev->receive_buf  = bt_receive_buf;
 
   /* Associate the driver in with the Bluetooth stack.
    *